@@ -157,6 +157,9 @@ The full list of options mlpack allows:
  - ARMA_EXTRA_DEBUG=(ON/OFF): compile with extra Armadillo debugging symbols
        (default OFF)
  - BUILD_TESTS=(ON/OFF): compile the \c mlpack_test program (default ON)
+ - BUILD_BENCHMARKS=(ON/OFF): compile the \c mlpack_benchmarks program, if
+       Google Benchmark is found; \c make \c run_benchmarks runs it and writes
+       the results to \c benchmarks.json (default OFF)
  - BUILD_CLI_EXECUTABLES=(ON/OFF): compile the mlpack command-line executables
        (i.e. \c mlpack_knn, \c mlpack_kfn, \c mlpack_logistic_regression, etc.)
        (default ON)
@@ -186,6 +189,9 @@ The full list of options mlpack allows:
        of CXXFLAGS (default OFF)
  - USE_OPENMP=(ON/OFF): if ON, then use OpenMP if the compiler supports it; if
        OFF, OpenMP support is manually disabled (default ON)
+ - TRACK_MEMORY=(ON/OFF): if ON, count the memory allocated by Armadillo and
+       the trees, and report the peak memory of each timer with --verbose; this
+       slows down allocations (default OFF)
 
 Each option can be specified to CMake with the '-D' flag.  Other tools can also
 be used to configure CMake, but those are not documented here.
@@ -0,0 +1,43 @@
+/**
+ * @file benchmarks/benchmark_data.hpp
+ *
+ * Synthetic datasets for the benchmarks, so that they are reproducible and
+ * don't need any data file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_DATA_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_DATA_HPP
+
+#include <mlpack/core.hpp>
+
+/**
+ * Generate a dataset of Gaussian clusters (with unit variance, and centers
+ * drawn uniformly in [0, 10]^d).  The same arguments always give the same
+ * dataset, and the random seed of mlpack is reset by this function.
+ *
+ * @param dimensionality Dimensionality of the points.
+ * @param points Number of points.
+ * @param clusters Number of clusters.
+ * @param seed Random seed.
+ */
+inline arma::mat SyntheticData(const size_t dimensionality,
+                               const size_t points,
+                               const size_t clusters = 10,
+                               const size_t seed = 42)
+{
+  mlpack::math::RandomSeed(seed);
+
+  const arma::mat centers = 10.0 * arma::randu<arma::mat>(dimensionality,
+      clusters);
+  arma::mat data = arma::randn<arma::mat>(dimensionality, points);
+  for (size_t i = 0; i < points; ++i)
+    data.col(i) += centers.col(i % clusters);
+
+  return data;
+}
+
+#endif
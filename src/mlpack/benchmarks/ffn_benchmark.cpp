@@ -0,0 +1,99 @@
+/**
+ * @file benchmarks/ffn_benchmark.cpp
+ *
+ * Benchmarks of the forward and backward passes of feedforward networks, for
+ * several layer types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <benchmark/benchmark.h>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+/**
+ * Create a network made of a linear layer with 100 inputs and 200 outputs, the
+ * given layer type, and a linear layer with 10 outputs, with random inputs and
+ * targets for a batch of the given size.
+ */
+template<typename LayerType>
+static void CreateNetwork(FFN<MeanSquaredError<>>& model,
+                          arma::mat& input,
+                          arma::mat& target,
+                          const size_t batchSize)
+{
+  input = SyntheticData(100, batchSize);
+  target = arma::randu<arma::mat>(10, batchSize);
+
+  model.Add<Linear<>>(100, 200);
+  model.Add<LayerType>();
+  model.Add<Linear<>>(200, 10);
+  model.ResetParameters();
+}
+
+/**
+ * Forward pass of a batch of state.range(0) points.
+ */
+template<typename LayerType>
+static void FFNForward(benchmark::State& state)
+{
+  FFN<MeanSquaredError<>> model;
+  arma::mat input, target, output;
+  CreateNetwork<LayerType>(model, input, target, state.range(0));
+
+  for (auto _ : state)
+  {
+    model.Forward(input, output);
+    benchmark::DoNotOptimize(output.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Forward and backward pass (with the computation of the gradient) of a batch
+ * of state.range(0) points.
+ */
+template<typename LayerType>
+static void FFNForwardBackward(benchmark::State& state)
+{
+  FFN<MeanSquaredError<>> model;
+  arma::mat input, target, output, gradient;
+  CreateNetwork<LayerType>(model, input, target, state.range(0));
+
+  for (auto _ : state)
+  {
+    model.Forward(input, output);
+    model.Backward(input, target, gradient);
+    benchmark::DoNotOptimize(gradient.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(FFNForward, IdentityLayer<>)->Arg(1)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(FFNForward, SigmoidLayer<>)->Arg(1)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(FFNForward, TanHLayer<>)->Arg(1)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(FFNForward, ReLULayer<>)->Arg(1)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(FFNForward, LeakyReLU<>)->Arg(1)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(FFNForward, Dropout<>)->Arg(1)->Arg(32)->Arg(256);
+
+BENCHMARK_TEMPLATE(FFNForwardBackward, IdentityLayer<>)->Arg(1)->Arg(32)
+    ->Arg(256);
+BENCHMARK_TEMPLATE(FFNForwardBackward, SigmoidLayer<>)->Arg(1)->Arg(32)
+    ->Arg(256);
+BENCHMARK_TEMPLATE(FFNForwardBackward, TanHLayer<>)->Arg(1)->Arg(32)
+    ->Arg(256);
+BENCHMARK_TEMPLATE(FFNForwardBackward, ReLULayer<>)->Arg(1)->Arg(32)
+    ->Arg(256);
+BENCHMARK_TEMPLATE(FFNForwardBackward, LeakyReLU<>)->Arg(1)->Arg(32)
+    ->Arg(256);
+BENCHMARK_TEMPLATE(FFNForwardBackward, Dropout<>)->Arg(1)->Arg(32)->Arg(256);
@@ -0,0 +1,87 @@
+/**
+ * @file benchmarks/io_benchmark.cpp
+ *
+ * Benchmarks of CSV loading and of model saving and loading.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <benchmark/benchmark.h>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Load a CSV file of state.range(0) points in 10 dimensions.
+ */
+static void CSVLoad(benchmark::State& state)
+{
+  const std::string filename = "benchmark_data.csv";
+  data::Save(filename, SyntheticData(10, state.range(0)), true);
+
+  arma::mat data;
+  for (auto _ : state)
+  {
+    data::Load(filename, data, true);
+    benchmark::DoNotOptimize(data.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::remove(filename.c_str());
+}
+
+BENCHMARK(CSVLoad)->RangeMultiplier(10)->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Save a kd-tree KNN model on state.range(0) points in 10 dimensions (the
+ * dataset and the tree are saved), in the format given by the extension.
+ */
+static void ModelSave(benchmark::State& state, const std::string& extension)
+{
+  const std::string filename = "benchmark_model." + extension;
+  KNN knn(SyntheticData(10, state.range(0)));
+
+  for (auto _ : state)
+    data::Save(filename, "knn", knn, true);
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::remove(filename.c_str());
+}
+
+/**
+ * Load a kd-tree KNN model on state.range(0) points in 10 dimensions, from a
+ * file in the format given by the extension.
+ */
+static void ModelLoad(benchmark::State& state, const std::string& extension)
+{
+  const std::string filename = "benchmark_model." + extension;
+  {
+    KNN knn(SyntheticData(10, state.range(0)));
+    data::Save(filename, "knn", knn, true);
+  }
+
+  for (auto _ : state)
+  {
+    KNN knn;
+    data::Load(filename, "knn", knn, true);
+    benchmark::DoNotOptimize(knn.ReferenceSet().memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::remove(filename.c_str());
+}
+
+BENCHMARK_CAPTURE(ModelSave, binary, std::string("bin"))->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ModelSave, xml, std::string("xml"))->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ModelLoad, binary, std::string("bin"))->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ModelLoad, xml, std::string("xml"))->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
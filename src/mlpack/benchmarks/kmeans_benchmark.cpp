@@ -0,0 +1,62 @@
+/**
+ * @file benchmarks/kmeans_benchmark.cpp
+ *
+ * Benchmarks of each k-means step type (Lloyd iteration strategy).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/naive_kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+#include <benchmark/benchmark.h>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kmeans;
+using namespace mlpack::metric;
+
+/**
+ * Run 10 iterations of k-means with 20 clusters on state.range(0) points in 10
+ * dimensions, from the same initial centroids each time.  The time includes
+ * the setup of the step type (tree building, for instance), as in a real
+ * clustering.
+ */
+template<template<class, class> class LloydStepType>
+static void KMeansSteps(benchmark::State& state)
+{
+  const arma::mat data = SyntheticData(10, state.range(0), 20);
+  const arma::mat initialCentroids = data.cols(0, 19);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> kmeans(10);
+  arma::mat centroids;
+  for (auto _ : state)
+  {
+    centroids = initialCentroids;
+    kmeans.Cluster(data, 20, centroids, true);
+    benchmark::DoNotOptimize(centroids.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(KMeansSteps, NaiveKMeans)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansSteps, ElkanKMeans)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansSteps, HamerlyKMeans)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansSteps, PellegMooreKMeans)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansSteps, DefaultDualTreeKMeans)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansSteps, MiniBatchKMeans)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
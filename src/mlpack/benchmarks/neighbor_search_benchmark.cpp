@@ -0,0 +1,80 @@
+/**
+ * @file benchmarks/neighbor_search_benchmark.cpp
+ *
+ * Benchmarks of dual-tree k-nearest-neighbor search and range search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+#include <benchmark/benchmark.h>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+using namespace mlpack::tree;
+using namespace mlpack::metric;
+
+/**
+ * Dual-tree search of the 5 nearest neighbors of state.range(0) query points
+ * among as many reference points, in 3 dimensions.  The reference tree is
+ * built beforehand; the query tree is built by each search.
+ */
+template<template<typename, typename, typename> class TreeType>
+static void KNNDualTree(benchmark::State& state)
+{
+  const arma::mat referenceSet = SyntheticData(3, state.range(0));
+  const arma::mat querySet = SyntheticData(3, state.range(0), 10, 43);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(referenceSet);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (auto _ : state)
+  {
+    knn.Search(querySet, 5, neighbors, distances);
+    benchmark::DoNotOptimize(distances.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(KNNDualTree, KDTree)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNDualTree, BallTree)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KNNDualTree, StandardCoverTree)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Dual-tree range search with radius 0.5 of state.range(0) query points among
+ * as many reference points, in 3 dimensions.
+ */
+template<template<typename, typename, typename> class TreeType>
+static void RangeSearchDualTree(benchmark::State& state)
+{
+  const arma::mat referenceSet = SyntheticData(3, state.range(0));
+  const arma::mat querySet = SyntheticData(3, state.range(0), 10, 43);
+
+  RangeSearch<EuclideanDistance, arma::mat, TreeType> rangeSearch(
+      referenceSet);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  for (auto _ : state)
+  {
+    rangeSearch.Search(querySet, math::Range(0.0, 0.5), neighbors, distances);
+    benchmark::DoNotOptimize(distances.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(RangeSearchDualTree, KDTree)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(RangeSearchDualTree, BallTree)->RangeMultiplier(10)
+    ->Range(1000, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,49 @@
+/**
+ * @file benchmarks/tree_benchmark.cpp
+ *
+ * Benchmarks of tree building.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include <benchmark/benchmark.h>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::metric;
+
+/**
+ * Build a tree on a 3-dimensional dataset of state.range(0) points.
+ */
+template<typename TreeType>
+static void TreeBuild(benchmark::State& state)
+{
+  const arma::mat data = SyntheticData(3, state.range(0));
+  for (auto _ : state)
+  {
+    TreeType tree(data);
+    benchmark::DoNotOptimize(tree.NumDescendants());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(TreeBuild, KDTree<EuclideanDistance, EmptyStatistic,
+    arma::mat>)->RangeMultiplier(10)->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(TreeBuild, BallTree<EuclideanDistance, EmptyStatistic,
+    arma::mat>)->RangeMultiplier(10)->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(TreeBuild, StandardCoverTree<EuclideanDistance,
+    EmptyStatistic, arma::mat>)->RangeMultiplier(10)->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(TreeBuild, RTree<EuclideanDistance, EmptyStatistic,
+    arma::mat>)->RangeMultiplier(10)->Range(1000, 10000)
+    ->Unit(benchmark::kMillisecond);
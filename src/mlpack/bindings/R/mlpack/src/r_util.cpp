@@ -16,18 +16,32 @@
 using namespace mlpack;
 using namespace Rcpp;
 
+// Transpose an Armadillo matrix straight into the memory of a new R matrix,
+// with a single copy.
 template<typename eT>
-bool inline inplace_transpose(arma::Mat<eT>& X)
+NumericMatrix transpose_to_r(const arma::Mat<eT>& X)
 {
-  try
+  NumericMatrix output(X.n_cols, X.n_rows);
+  double* outputMem = output.begin();
+  for (size_t i = 0; i < X.n_cols; ++i)
   {
-    X = arma::trans(X);
-    return false;
-  }
-  catch (std::bad_alloc&)
-  {
-    return true;
+    const eT* col = X.colptr(i);
+    for (size_t j = 0; j < X.n_rows; ++j)
+      outputMem[i + j * X.n_cols] = (double) col[j];
   }
+
+  return output;
+}
+
+// Matrices of doubles use the blocked transpose of Armadillo, through an alias
+// of the R matrix.
+NumericMatrix transpose_to_r(const arma::mat& X)
+{
+  NumericMatrix output(X.n_cols, X.n_rows);
+  arma::mat alias(output.begin(), X.n_cols, X.n_rows, false, true);
+  alias = X.t();
+
+  return output;
 }
 
 // Call IO::RestoreSettings() for a given program name.
@@ -92,6 +106,8 @@ void IO_SetParamVecInt(const std::string& paramName,
 void IO_SetParamMat(const std::string& paramName,
                     const arma::mat& paramValue)
 {
+  // paramValue is a view of the memory of the R matrix, so the transpose is
+  // the only copy.
   IO::GetParam<arma::mat>(paramName) = paramValue.t();
   IO::SetPassed(paramName);
 }
@@ -205,18 +221,16 @@ const std::vector<int>& IO_GetParamVecInt(const std::string& paramName)
 
 // Call IO::GetParam<arma::mat>().
 // [[Rcpp::export]]
-const arma::mat& IO_GetParamMat(const std::string& paramName)
+NumericMatrix IO_GetParamMat(const std::string& paramName)
 {
-  inplace_transpose(IO::GetParam<arma::mat>(paramName));
-  return std::move(IO::GetParam<arma::mat>(paramName));
+  return transpose_to_r(IO::GetParam<arma::mat>(paramName));
 }
 
 // Call IO::GetParam<arma::Mat<size_t>>().
 // [[Rcpp::export]]
-const arma::Mat<size_t>& IO_GetParamUMat(const std::string& paramName)
+NumericMatrix IO_GetParamUMat(const std::string& paramName)
 {
-  inplace_transpose(IO::GetParam<arma::Mat<size_t>>(paramName));
-  return std::move(IO::GetParam<arma::Mat<size_t>>(paramName));
+  return transpose_to_r(IO::GetParam<arma::Mat<size_t>>(paramName));
 }
 
 // Call IO::GetParam<arma::rowvec>().
@@ -254,14 +268,14 @@ List IO_GetParamMatWithInfo(const std::string& paramName)
   const data::DatasetInfo& d = std::get<0>(
       IO::GetParam<std::tuple<data::DatasetInfo, arma::mat>>(paramName));
   const arma::mat& m = std::get<1>(
-      IO::GetParam<std::tuple<data::DatasetInfo, arma::mat>>(paramName)).t();
+      IO::GetParam<std::tuple<data::DatasetInfo, arma::mat>>(paramName));
 
   LogicalVector dims(d.Dimensionality());
   for (size_t i = 0; i < d.Dimensionality(); ++i)
     dims[i] = (d.Type(i) == data::Datatype::numeric) ? false : true;
 
   return List::create (Rcpp::Named("Info") = std::move(dims),
-                       Rcpp::Named("Data") = std::move(m));
+                       Rcpp::Named("Data") = transpose_to_r(m));
 }
 
 // Enable verbose output.
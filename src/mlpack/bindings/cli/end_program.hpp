@@ -64,6 +64,16 @@ inline void EndProgram()
       Log::Info << "  " << it2.first << ": ";
       IO::GetSingleton().timer.PrintTimer(it2.first);
     }
+
+#ifdef MLPACK_TRACK_MEMORY
+    Log::Info << "Program memory (peak: " << MemoryTracker::Peak()
+        << " bytes):" << std::endl;
+    for (auto& it2 : IO::GetSingleton().timer.GetAllTimers())
+    {
+      Log::Info << "  " << it2.first << ": ";
+      IO::GetSingleton().timer.PrintMemory(it2.first);
+    }
+#endif
   }
 
   // Lastly clean up any memory.  If we are holding any pointers, then we "own"
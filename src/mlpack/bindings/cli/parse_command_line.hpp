@@ -28,6 +28,10 @@ PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_FLAG("server", "Run as a server: read one request per line of standard "
+    "input, with options given as on the command line, and answer each with a "
+    "line containing 'OK' or an error.  Input models given on the command line "
+    "are only loaded once.", "");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -129,7 +133,11 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
-  // Now, issue an error if we forgot any required options.
+  // Now, issue an error if we forgot any required options.  In server mode,
+  // they may be given by each request instead.
+  if (IO::HasParam("server"))
+    return;
+
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
   {
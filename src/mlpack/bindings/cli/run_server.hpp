@@ -0,0 +1,219 @@
+/**
+ * @file bindings/cli/run_server.hpp
+ *
+ * Run a command-line program as a server that answers many requests, so that
+ * input models are only loaded once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_RUN_SERVER_HPP
+#define MLPACK_BINDINGS_CLI_RUN_SERVER_HPP
+
+#include <mlpack/core.hpp>
+
+#include "third_party/CLI/CLI11.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Parse the options of one server request, given in the same syntax as on the
+ * command line, on top of the current parameters.  The options in `fixed`
+ * (the input models that are kept loaded) may not be given again.
+ *
+ * @param line Options of the request.
+ * @param fixed Names of the parameters that may not be given.
+ */
+inline void ParseRequest(const std::string& line,
+                         const std::set<std::string>& fixed)
+{
+  CLI::App app;
+  app.set_help_flag();
+
+  std::map<std::string, util::ParamData>& parameters = IO::Parameters();
+  for (auto& it : parameters)
+  {
+    util::ParamData& d = it.second;
+    IO::GetSingleton().functionMap[d.tname]["AddToCLI11"](d, NULL, (void*)
+        &app);
+  }
+
+  try
+  {
+    app.parse(line, false);
+  }
+  catch (const CLI::ParseError& pe)
+  {
+    throw std::invalid_argument(pe.what());
+  }
+
+  for (auto& it : parameters)
+  {
+    util::ParamData& d = it.second;
+    std::string cliName;
+    IO::GetSingleton().functionMap[d.tname]["MapParameterName"](d, NULL,
+        (void*) &cliName);
+    cliName = "--" + cliName;
+
+    if (fixed.count(it.first) && app.count(cliName))
+    {
+      throw std::invalid_argument("option " + cliName + " was given when the "
+          "server was started and cannot be changed");
+    }
+
+    if (d.required && !d.wasPassed)
+    {
+      throw std::invalid_argument("required option " + cliName + " is "
+          "undefined");
+    }
+  }
+
+  Log::Info.ignoreInput = !IO::HasParam("verbose");
+}
+
+/**
+ * Save the outputs of a server request.
+ */
+inline void SaveRequestOutput()
+{
+  IO::GetSingleton().timer.StopAllTimers();
+
+  std::map<std::string, util::ParamData>& parameters = IO::Parameters();
+  for (auto& it : parameters)
+  {
+    util::ParamData& d = it.second;
+    if (!d.input)
+      IO::GetSingleton().functionMap[d.tname]["OutputParam"](d, NULL, NULL);
+  }
+}
+
+/**
+ * Free the models allocated by a server request, except the given ones (the
+ * input models that the server keeps).
+ *
+ * @param kept Addresses of the models that must not be freed.
+ */
+inline void FreeRequestMemory(const std::set<void*>& kept)
+{
+  // As in EndProgram(), the same pointer may be held twice; also, an output
+  // model may be one of the kept input models.
+  std::set<void*> freed(kept);
+  std::map<std::string, util::ParamData>& parameters = IO::Parameters();
+  for (auto& it : parameters)
+  {
+    util::ParamData& d = it.second;
+
+    void* result;
+    IO::GetSingleton().functionMap[d.tname]["GetAllocatedMemory"](d, NULL,
+        (void*) &result);
+    if (result != NULL && freed.count(result) == 0)
+    {
+      IO::GetSingleton().functionMap[d.tname]["DeleteAllocatedMemory"](d,
+          NULL, NULL);
+      freed.insert(result);
+    }
+  }
+}
+
+/**
+ * Run the program as a server.  The options given on the command line are
+ * used by every request; each line of standard input is then one request,
+ * whose options are given in the same syntax as on the command line, e.g.
+ *
+ * @code
+ * $ mlpack_knn --input_model_file model.bin --server
+ * --query_file q1.csv --k 5 --neighbors_file n1.csv
+ * --query_file q2.csv --k 3 --neighbors_file n2.csv
+ * @endcode
+ *
+ * The input models of the command line are loaded by the first request and
+ * kept for the following ones (so, if the program modifies them, the changes
+ * are seen by the next requests); the other inputs are loaded for each
+ * request.  After each request, the outputs are saved and a line with "OK",
+ * or "ERROR: " followed by the message, is printed to standard output.
+ *
+ * @param mlpackMain The program to run for each request.
+ */
+inline void RunServer(void (*mlpackMain)())
+{
+  std::map<std::string, util::ParamData>& parameters = IO::Parameters();
+  const std::map<std::string, util::ParamData> initial = parameters;
+
+  std::set<std::string> fixed;
+  std::set<void*> kept;
+
+  std::string line;
+  while (std::getline(std::cin, line))
+  {
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+
+    // Go back to the options of the command line, but keep the loaded input
+    // models.
+    for (auto& it : parameters)
+    {
+      if (fixed.count(it.first) == 0)
+        it.second = initial.at(it.first);
+    }
+
+    std::string error;
+    try
+    {
+      ParseRequest(line, fixed);
+
+      IO::GetSingleton().timer.Reset();
+      Timer::Start("total_time");
+
+      mlpackMain();
+      SaveRequestOutput();
+    }
+    catch (const std::exception& e)
+    {
+      error = e.what();
+    }
+
+    // Find the input models of the command line that are now loaded, so that
+    // they are kept for the next requests.
+    for (auto& it : parameters)
+    {
+      util::ParamData& d = it.second;
+      if (!d.input || !initial.at(it.first).wasPassed ||
+          fixed.count(it.first))
+        continue;
+
+      void* result;
+      IO::GetSingleton().functionMap[d.tname]["GetAllocatedMemory"](d, NULL,
+          (void*) &result);
+      if (result != NULL)
+      {
+        fixed.insert(it.first);
+        kept.insert(result);
+      }
+    }
+
+    FreeRequestMemory(kept);
+
+    if (error.empty())
+      std::cout << "OK" << std::endl;
+    else
+      std::cout << "ERROR: " << error << std::endl;
+  }
+
+  // Free the kept models too.
+  for (auto& it : parameters)
+  {
+    if (fixed.count(it.first) == 0)
+      it.second = initial.at(it.first);
+  }
+  FreeRequestMemory(std::set<void*>());
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -41,55 +41,67 @@ func DataAndInfo() *matrixWithInfo {
   }
 }
 
-// Allocates a C memory Pointer via cgo and registers the finalizer
-// in order to free the C memory once the input has been registered in Go.
+// Gets the C memory pointer of an mlpack output via cgo.  The memory must be
+// given to Go with toGoMemory().
 func (m *mlpackArma) allocArmaPtrMat(identifier string) {
   m.mem = C.mlpackArmaPtrMat(C.CString(identifier))
   runtime.KeepAlive(m)
 }
 
-// Allocates a C memory Pointer via cgo and registers the finalizer
-// in order to free the C memory once the input has been registered in Go.
+// Gets the C memory pointer of an mlpack output via cgo.  The memory must be
+// given to Go with toGoMemory().
 func (m *mlpackArma) allocArmaPtrUmat(identifier string) {
   m.mem = C.mlpackArmaPtrUmat(C.CString(identifier))
   runtime.KeepAlive(m)
 }
 
-// Allocates a C memory Pointer via cgo and registers the finalizer
-// in order to free the C memory once the input has been registered in Go.
+// Gets the C memory pointer of an mlpack output via cgo.  The memory must be
+// given to Go with toGoMemory().
 func (m *mlpackArma) allocArmaPtrRow(identifier string) {
   m.mem = C.mlpackArmaPtrRow(C.CString(identifier))
   runtime.KeepAlive(m)
 }
 
-// Allocates a C memory Pointer via cgo and registers the finalizer
-// in order to free the C memory once the input has been registered in Go.
+// Gets the C memory pointer of an mlpack output via cgo.  The memory must be
+// given to Go with toGoMemory().
 func (m *mlpackArma) allocArmaPtrUrow(identifier string) {
   m.mem = C.mlpackArmaPtrUrow(C.CString(identifier))
   runtime.KeepAlive(m)
 }
 
-// Allocates a C memory Pointer via cgo and registers the finalizer
-// in order to free the C memory once the input has been registered in Go.
+// Gets the C memory pointer of an mlpack output via cgo.  The memory must be
+// given to Go with toGoMemory().
 func (m *mlpackArma) allocArmaPtrCol(identifier string) {
   m.mem = C.mlpackArmaPtrCol(C.CString(identifier))
   runtime.KeepAlive(m)
 }
 
-// Allocates a C memory Pointer via cgo and registers the finalizer
-// in order to free the C memory once the input has been registered in Go.
+// Gets the C memory pointer of an mlpack output via cgo.  The memory must be
+// given to Go with toGoMemory().
 func (m *mlpackArma) allocArmaPtrUcol(identifier string) {
   m.mem = C.mlpackArmaPtrUcol(C.CString(identifier))
   runtime.KeepAlive(m)
 }
 
-// Allocates a C memory Pointer via cgo and registers the finalizer
-// in order to free the C memory once the input has been registered in Go.
+// Gets the C memory pointer of an mlpack output via cgo.  The memory must be
+// given to Go with toGoMemory().
 func (m *mlpackArma) allocArmaPtrMatWithInfo(identifier string) {
   m.mem = C.mlpackArmaPtrMatWithInfoPtr(C.CString(identifier))
   runtime.KeepAlive(m)
 }
 
+// Copies the C memory of an mlpack output into memory managed by Go, and frees
+// the C memory.  Go's garbage collector can't own memory allocated by C (and
+// Gonum views of the output would not keep it alive), so this is the only copy
+// of the output.
+func (m *mlpackArma) toGoMemory(array []float64) []float64 {
+  data := make([]float64, len(array))
+  copy(data, array)
+  C.mlpackFreeArmaMemory(m.mem)
+  m.mem = nil
+  return data
+}
+
 // Passes a Gonum matrix to C by using the underlying data from the Gonum matrix.
 func gonumToArmaMat(identifier string, m *mat.Dense) {
   // Get the number of elements in the Armadillo column.
@@ -231,7 +243,7 @@ func (m *mlpackArma) armaToGonumMat(identifier string) *mat.Dense {
   // Convert pointer to slice of data, to then pass it to a gonum matrix.
   array := (*[1<<30 - 1]float64)(m.mem)
   if array != nil {
-    data := array[:e]
+    data := m.toGoMemory(array[:e])
 
     // Initialize result matrix.
     output := mat.NewDense(r, c, data)
@@ -256,7 +268,7 @@ func (m *mlpackArma) armaToGonumArray(identifier string) (int, int, []float64){
   // Convert pointer to slice of data, to then pass it to a gonum matrix.
   array := (*[1<<30 - 1]float64)(m.mem)
 
-  data := array[:e]
+  data := m.toGoMemory(array[:e])
   return r, c, data
 }
 
@@ -274,7 +286,7 @@ func (m *mlpackArma) armaToGonumUmat(identifier string) *mat.Dense {
   // Convert pointer to slice of data, to then pass it to a gonum matrix.
   array := (*[1<<30 - 1]float64)(m.mem)
   if array != nil {
-    data := array[:e]
+    data := m.toGoMemory(array[:e])
 
     // Initialize result matrix.
     output := mat.NewDense(r, c, data)
@@ -297,7 +309,7 @@ func (m *mlpackArma) armaToGonumRow(identifier string) *mat.Dense{
   // Convert pointer to slice of data, to then pass it to a gonum matrix.
   array := (*[1<<30 - 1]float64)(m.mem)
   if array != nil {
-    data := array[:e]
+    data := m.toGoMemory(array[:e])
 
     // Initialize result matrix.
     output := mat.NewDense(e, 1, data)
@@ -320,7 +332,7 @@ func (m *mlpackArma) armaToGonumUrow(identifier string) *mat.Dense {
   // Convert pointer to slice of data, to then pass it to a gonum matrix.
   array := (*[1<<30 - 1]float64)(m.mem)
   if array != nil {
-    data := array[:e]
+    data := m.toGoMemory(array[:e])
 
     // Initialize result matrix.
     output := mat.NewDense(e, 1, data)
@@ -341,7 +353,7 @@ func (m *mlpackArma) armaToGonumCol(identifier string) *mat.Dense {
   // Convert pointer to slice of data, to then pass it to a gonum matrix.
   array := (*[1<<30 - 1]float64)(m.mem)
   if array != nil {
-    data := array[:e]
+    data := m.toGoMemory(array[:e])
 
     // Initialize result matrix.
     output := mat.NewDense(1, e, data)
@@ -363,7 +375,7 @@ func (m *mlpackArma) armaToGonumUcol(identifier string) *mat.Dense {
   // Convert pointer to slice of data, to then pass it to a gonum matrix.
   array := (*[1<<30 - 1]float64)(m.mem)
   if array != nil {
-    data := array[:e]
+    data := m.toGoMemory(array[:e])
 
     // Initialize result matrix.
     output := mat.NewDense(1, e, data)
@@ -386,7 +398,7 @@ func (m *mlpackArma) armaToGonumMatWithInfo(identifier string) *mat.Dense {
   matarray := (*[1<<30 - 1]float64)(m.mem)
 
   if matarray != nil {
-    data := matarray[:e]
+    data := m.toGoMemory(matarray[:e])
 
     // Initialize result matrix.
     output := mat.NewDense(r, c, data)
@@ -337,6 +337,14 @@ void* mlpackArmaPtrMatWithInfoPtr(const char* identifier)
   return ptr;
 }
 
+/**
+ * Free the memory returned by one of the mlpackArmaPtr functions.
+ */
+void mlpackFreeArmaMemory(void* ptr)
+{
+  arma::memory::release(ptr);
+}
+
 } // extern "C"
 
 } // namespace util
@@ -175,6 +175,11 @@ int mlpackArmaMatWithInfoCols(const char* identifier);
  */
 void* mlpackArmaPtrMatWithInfoPtr(const char* identifier);
 
+/**
+ * Free the memory returned by one of the mlpackArmaPtr functions.
+ */
+void mlpackFreeArmaMemory(void* ptr);
+
 #if defined(__cplusplus) || defined(c_plusplus)
 }
 #endif
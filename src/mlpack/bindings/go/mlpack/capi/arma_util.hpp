@@ -19,14 +19,17 @@
 namespace mlpack {
 
 /**
- * Return the matrix's allocated memory pointer, unless the matrix is using its
- * internal preallocated memory, in which case we copy that and return a
- * pointer to the memory we just made.
+ * Return the matrix's allocated memory pointer, and give the memory to the
+ * caller, which must free it with mlpackFreeArmaMemory().  If the matrix does
+ * not own its memory (because it uses its internal preallocated memory, or
+ * because it is an alias of the memory of a Go input), we copy that and return
+ * a pointer to the memory we just made.
  */
 template<typename T>
 inline typename T::elem_type* GetMemory(T& m)
 {
-  if (m.mem && m.n_elem <= arma::arma_config::mat_prealloc)
+  if (m.mem && (m.n_elem <= arma::arma_config::mat_prealloc ||
+      m.mem_state != 0))
   {
     // We need to allocate new memory.
     typename T::elem_type* mem =
@@ -16,6 +16,29 @@
 
 using namespace mlpack;
 
+/**
+ * Give the memory of the given Armadillo object to the caller, which must free
+ * it with IO_FreeMemory().  If the object does not own its memory (because it
+ * uses its preallocated memory, or because it is an alias of the memory of a
+ * Julia input), the memory is copied.
+ */
+template<typename T>
+typename T::elem_type* GetMemory(T& m)
+{
+  if (m.n_elem <= arma::arma_config::mat_prealloc || m.mem_state != 0)
+  {
+    typename T::elem_type* mem =
+        arma::memory::acquire<typename T::elem_type>(m.n_elem);
+    arma::arrayops::copy(mem, m.memptr(), m.n_elem);
+    return mem;
+  }
+  else
+  {
+    arma::access::rw(m.mem_state) = 1;
+    return m.memptr();
+  }
+}
+
 extern "C" {
 
 /**
@@ -299,25 +322,11 @@ size_t IO_GetParamMatCols(const char* paramName)
 /**
  * Get the memory pointer for a matrix parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 double* IO_GetParamMat(const char* paramName)
 {
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  arma::mat& mat = IO::GetParam<arma::mat>(paramName);
-  if (mat.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something that we can give back to Julia.
-    double* newMem = new double[mat.n_elem];
-    arma::arrayops::copy(newMem, mat.mem, mat.n_elem);
-    return newMem; // We believe Julia will free it.  Hopefully we are right.
-  }
-  else
-  {
-    arma::access::rw(mat.mem_state) = 1;
-    return mat.memptr();
-  }
+  return GetMemory(IO::GetParam<arma::mat>(paramName));
 }
 
 /**
@@ -339,27 +348,11 @@ size_t IO_GetParamUMatCols(const char* paramName)
 /**
  * Get the memory pointer for an unsigned matrix parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 size_t* IO_GetParamUMat(const char* paramName)
 {
-  arma::Mat<size_t>& mat = IO::GetParam<arma::Mat<size_t>>(paramName);
-
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  if (mat.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something that we can give back to Julia.
-    size_t* newMem = new size_t[mat.n_elem];
-    arma::arrayops::copy(newMem, mat.mem, mat.n_elem);
-    // We believe Julia will free it.  Hopefully we are right.
-    return newMem;
-  }
-  else
-  {
-    arma::access::rw(mat.mem_state) = 1;
-    return mat.memptr();
-  }
+  return GetMemory(IO::GetParam<arma::Mat<size_t>>(paramName));
 }
 
 /**
@@ -373,25 +366,11 @@ size_t IO_GetParamColRows(const char* paramName)
 /**
  * Get the memory pointer for a column vector parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 double* IO_GetParamCol(const char* paramName)
 {
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  arma::vec& vec = IO::GetParam<arma::vec>(paramName);
-  if (vec.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something we can give back to Julia.
-    double* newMem = new double[vec.n_elem];
-    arma::arrayops::copy(newMem, vec.mem, vec.n_elem);
-    return newMem; // We believe Julia will free it.  Hopefully we are right.
-  }
-  else
-  {
-    arma::access::rw(vec.mem_state) = 1;
-    return vec.memptr();
-  }
+  return GetMemory(IO::GetParam<arma::vec>(paramName));
 }
 
 /**
@@ -405,27 +384,11 @@ size_t IO_GetParamUColRows(const char* paramName)
 /**
  * Get the memory pointer for an unsigned column vector parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 size_t* IO_GetParamUCol(const char* paramName)
 {
-  arma::Col<size_t>& vec = IO::GetParam<arma::Col<size_t>>(paramName);
-
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  if (vec.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something we can give back to Julia.
-    size_t* newMem = new size_t[vec.n_elem];
-    arma::arrayops::copy(newMem, vec.mem, vec.n_elem);
-    // We believe Julia will free it.  Hopefully we are right.
-    return newMem;
-  }
-  else
-  {
-    arma::access::rw(vec.mem_state) = 1;
-    return vec.memptr();
-  }
+  return GetMemory(IO::GetParam<arma::Col<size_t>>(paramName));
 }
 
 /**
@@ -439,25 +402,11 @@ size_t IO_GetParamRowCols(const char* paramName)
 /**
  * Get the memory pointer for a row parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 double* IO_GetParamRow(const char* paramName)
 {
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  arma::rowvec& vec = IO::GetParam<arma::rowvec>(paramName);
-  if (vec.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something we can give back to Julia.
-    double* newMem = new double[vec.n_elem];
-    arma::arrayops::copy(newMem, vec.mem, vec.n_elem);
-    return newMem;
-  }
-  else
-  {
-    arma::access::rw(vec.mem_state) = 1;
-    return vec.memptr();
-  }
+  return GetMemory(IO::GetParam<arma::rowvec>(paramName));
 }
 
 /**
@@ -471,26 +420,11 @@ size_t IO_GetParamURowCols(const char* paramName)
 /**
  * Get the memory pointer for a row parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 size_t* IO_GetParamURow(const char* paramName)
 {
-  arma::Row<size_t>& vec = IO::GetParam<arma::Row<size_t>>(paramName);
-
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  if (vec.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something we can give back to Julia.
-    size_t* newMem = new size_t[vec.n_elem];
-    arma::arrayops::copy(newMem, vec.mem, vec.n_elem);
-    return newMem;
-  }
-  else
-  {
-    arma::access::rw(vec.mem_state) = 1;
-    return vec.memptr();
-  }
+  return GetMemory(IO::GetParam<arma::Row<size_t>>(paramName));
 }
 
 /**
@@ -530,25 +464,20 @@ bool* IO_GetParamMatWithInfoBoolPtr(const char* paramName)
 
 /**
  * Get a pointer to the memory of the matrix.  The calling function is expected
- * to own the memory.
+ * to own the memory, and free it with IO_FreeMemory().
  */
 double* IO_GetParamMatWithInfoPtr(const char* paramName)
 {
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  arma::mat& m = std::get<1>(
-      IO::GetParam<std::tuple<data::DatasetInfo, arma::mat>>(paramName));
-  if (m.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    double* newMem = new double[m.n_elem];
-    arma::arrayops::copy(newMem, m.mem, m.n_elem);
-    return newMem;
-  }
-  else
-  {
-    arma::access::rw(m.mem_state) = 1;
-    return m.memptr();
-  }
+  return GetMemory(std::get<1>(
+      IO::GetParam<std::tuple<data::DatasetInfo, arma::mat>>(paramName)));
+}
+
+/**
+ * Free memory given to Julia by one of the functions above.
+ */
+void IO_FreeMemory(void* memptr)
+{
+  arma::memory::release(memptr);
 }
 
 /**
@@ -176,7 +176,7 @@ size_t IO_GetParamMatCols(const char* paramName);
 /**
  * Get the memory pointer for a matrix parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 double* IO_GetParamMat(const char* paramName);
 
@@ -193,7 +193,7 @@ size_t IO_GetParamUMatCols(const char* paramName);
 /**
  * Get the memory pointer for an unsigned matrix parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 size_t* IO_GetParamUMat(const char* paramName);
 
@@ -205,7 +205,7 @@ size_t IO_GetParamColRows(const char* paramName);
 /**
  * Get the memory pointer for a column vector parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 double* IO_GetParamCol(const char* paramName);
 
@@ -217,7 +217,7 @@ size_t IO_GetParamUColRows(const char* paramName);
 /**
  * Get the memory pointer for an unsigned column vector parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 size_t* IO_GetParamUCol(const char* paramName);
 
@@ -229,7 +229,7 @@ size_t IO_GetParamRowCols(const char* paramName);
 /**
  * Get the memory pointer for a row parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 double* IO_GetParamRow(const char* paramName);
 
@@ -241,7 +241,7 @@ size_t IO_GetParamURowCols(const char* paramName);
 /**
  * Get the memory pointer for a row parameter.
  * Note that this will assume that whatever is calling will take ownership of
- * the memory!
+ * the memory, and free it with IO_FreeMemory()!
  */
 size_t* IO_GetParamURow(const char* paramName);
 
@@ -264,10 +264,15 @@ bool* IO_GetParamMatWithInfoBoolPtr(const char* paramName);
 
 /**
  * Get a pointer to the memory of the matrix.  The calling function is expected
- * to own the memory.
+ * to own the memory, and free it with IO_FreeMemory().
  */
 double* IO_GetParamMatWithInfoPtr(const char* paramName);
 
+/**
+ * Free memory given to Julia by one of the functions above.
+ */
+void IO_FreeMemory(void* memptr);
+
 /**
  * Enable verbose output.
  */
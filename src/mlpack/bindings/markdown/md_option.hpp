@@ -62,7 +62,9 @@ class MDOption
     data.loaded = false;
     // Several options from Python and CLI bindings are persistent.
     if (identifier == "verbose" || identifier == "copy_all_inputs" ||
-        identifier == "help" || identifier == "info" || identifier == "version")
+        identifier == "n_threads" || identifier == "help" ||
+        identifier == "info" || identifier == "version" ||
+        identifier == "server")
       data.persistent = true;
     else
       data.persistent = false;
@@ -72,7 +74,8 @@ class MDOption
     data.value = boost::any(defaultValue);
 
     // Restore the parameters for this program.
-    if (identifier != "verbose" && identifier != "copy_all_inputs")
+    if (identifier != "verbose" && identifier != "copy_all_inputs" &&
+        identifier != "n_threads")
       IO::RestoreSettings(bindingName, false);
 
     // Set the function pointers that we'll need.  Most of these simply delegate
@@ -96,7 +99,9 @@ class MDOption
     // Add the option.
     IO::Add(std::move(data));
     if (identifier != "verbose" && identifier != "copy_all_inputs" &&
-        identifier != "help" && identifier != "info" && identifier != "version")
+        identifier != "n_threads" && identifier != "help" &&
+        identifier != "info" && identifier != "version" &&
+        identifier != "server")
       IO::StoreSettings(bindingName);
     IO::ClearSettings();
   }
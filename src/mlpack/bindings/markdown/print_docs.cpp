@@ -118,11 +118,12 @@ void PrintDocs(const std::string& bindingName,
         continue;
 
       // There are some special options that don't exist in some languages.
-      if (languages[i] != "python" && it->second.name == "copy_all_inputs")
+      if (languages[i] != "python" && (it->second.name == "copy_all_inputs" ||
+          it->second.name == "n_threads"))
         continue;
       if (languages[i] != "cli" &&
           (it->second.name == "help" || it->second.name == "info" ||
-           it->second.name == "version"))
+           it->second.name == "version" || it->second.name == "server"))
         continue;
 
       // Print name, type, description, default.
@@ -150,8 +151,10 @@ void PrintDocs(const std::string& bindingName,
       string desc = boost::replace_all_copy(it->second.desc, "|", "\\|");
       cout << desc; // just a string
       // Print whether or not it's a "special" language-only parameter.
-      if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+      if (it->second.name == "copy_all_inputs" ||
+          it->second.name == "n_threads" || it->second.name == "help" ||
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "server")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(languages[i]) << " binding.</span>";
@@ -198,8 +201,10 @@ void PrintDocs(const std::string& bindingName,
       cout << ParamType(it->second) << " | ";
       cout << it->second.desc;
       // Print whether or not it's a "special" language-only parameter.
-      if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+      if (it->second.name == "copy_all_inputs" ||
+          it->second.name == "n_threads" || it->second.name == "help" ||
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "server")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(languages[i]) << " binding.</span>";
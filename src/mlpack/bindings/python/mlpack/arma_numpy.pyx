@@ -7,7 +7,9 @@ and numpy objects without actually copying memory.  Note that if a numpy matrix
 is converted to an Armadillo object, then the Armadillo object will "own" the
 matrix and free the memory upon destruction (and the numpy object will no longer
 "own" the matrix).  Similarly, if an Armadillo object is converted to a numpy
-object, then the numpy object will "own" the matrix.
+object, then the numpy object will "own" the matrix: its base is a capsule that
+frees the memory with Armadillo when the numpy object is destroyed, so no copy
+is needed (on Windows too, where numpy and Armadillo may not share a heap).
 
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
@@ -42,13 +44,15 @@ cdef extern from "<mlpack/bindings/python/mlpack/arma_util.hpp>":
   size_t* GetMemory(arma.Mat[size_t]& m)
   size_t* GetMemory(arma.Col[size_t]& m)
   size_t* GetMemory(arma.Row[size_t]& m)
+  object MemoryCapsule[T](T* memory)
 
 cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
                                       bool takeOwnership) except +:
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
@@ -68,7 +72,8 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -93,15 +98,14 @@ cdef numpy.ndarray[numpy.double_t, ndim=2] mat_to_numpy_d(arma.Mat[double]& X) \
   cdef numpy.npy_intp dims[2]
   dims[0] = <numpy.npy_intp> X.n_cols
   dims[1] = <numpy.npy_intp> X.n_rows
+  cdef double* memory = GetMemory(X)
   cdef numpy.ndarray[numpy.double_t, ndim=2] output = \
-      numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+      numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_DOUBLE, memory)
 
   # Transfer memory ownership, if needed.
-  if GetMemState[arma.Mat[double]](X) == 0 and not isWin:
+  if GetMemState[arma.Mat[double]](X) == 0:
     SetMemState[arma.Mat[double]](X, 1)
-    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+    numpy.set_array_base(output, MemoryCapsule[double](memory))
 
   return output
 
@@ -114,15 +118,14 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=2] mat_to_numpy_s(arma.Mat[size_t]& X) \
   cdef numpy.npy_intp dims[2]
   dims[0] = <numpy.npy_intp> X.n_cols
   dims[1] = <numpy.npy_intp> X.n_rows
+  cdef size_t* memory = GetMemory(X)
   cdef numpy.ndarray[numpy.npy_intp, ndim=2] output = \
-      numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_INTP, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+      numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_INTP, memory)
 
   # Transfer memory ownership, if needed.
-  if GetMemState[arma.Mat[size_t]](X) == 0 and not isWin:
+  if GetMemState[arma.Mat[size_t]](X) == 0:
     SetMemState[arma.Mat[size_t]](X, 1)
-    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+    numpy.set_array_base(output, MemoryCapsule[size_t](memory))
 
   return output
 
@@ -132,7 +135,8 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -154,7 +158,8 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -177,15 +182,14 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] row_to_numpy_d(arma.Row[double]& X) \
   """
   # Extract dimensions.
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
+  cdef double* memory = GetMemory(X)
   cdef numpy.ndarray[numpy.double_t, ndim=1] output = \
-      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, memory)
 
   # Transfer memory ownership, if needed.
-  if GetMemState[arma.Row[double]](X) == 0 and not isWin:
+  if GetMemState[arma.Row[double]](X) == 0:
     SetMemState[arma.Row[double]](X, 1)
-    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+    numpy.set_array_base(output, MemoryCapsule[double](memory))
 
   return output
 
@@ -197,15 +201,14 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] row_to_numpy_s(arma.Row[size_t]& X) \
 #  print("called row_to_numpy_s()\n")
   # Extract dimensions.
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
+  cdef size_t* memory = GetMemory(X)
   cdef numpy.ndarray[numpy.npy_intp, ndim=1] output = \
-      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, memory)
 
   # Transfer memory ownership, if needed.
-  if GetMemState[arma.Row[size_t]](X) == 0 and not isWin:
+  if GetMemState[arma.Row[size_t]](X) == 0:
     SetMemState[arma.Row[size_t]](X, 1)
-    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+    numpy.set_array_base(output, MemoryCapsule[size_t](memory))
 
   return output
 
@@ -215,7 +218,8 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -237,7 +241,8 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -260,15 +265,14 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] col_to_numpy_d(arma.Col[double]& X) \
   """
   # Extract dimension.
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
+  cdef double* memory = GetMemory(X)
   cdef numpy.ndarray[numpy.double_t, ndim=1] output = \
-      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_DOUBLE, memory)
 
   # Transfer memory ownership, if needed.
-  if GetMemState[arma.Col[double]](X) == 0 and not isWin:
+  if GetMemState[arma.Col[double]](X) == 0:
     SetMemState[arma.Col[double]](X, 1)
-    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+    numpy.set_array_base(output, MemoryCapsule[double](memory))
 
   return output
 
@@ -279,14 +283,13 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] col_to_numpy_s(arma.Col[size_t]& X) \
   """
   # Extract dimension.
   cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
+  cdef size_t* memory = GetMemory(X)
   cdef numpy.ndarray[numpy.npy_intp, ndim=1] output = \
-      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, GetMemory(X))
-  if isWin:
-    output = output.copy(order="C")
+      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_INTP, memory)
 
   # Transfer memory ownership, if needed.
-  if GetMemState[arma.Col[size_t]](X) == 0 and not isWin:
+  if GetMemState[arma.Col[size_t]](X) == 0:
     SetMemState[arma.Col[size_t]](X, 1)
-    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+    numpy.set_array_base(output, MemoryCapsule[size_t](memory))
 
   return output
@@ -12,6 +12,9 @@
 #ifndef MLPACK_BINDINGS_PYTHON_CYTHON_ARMA_UTIL_HPP
 #define MLPACK_BINDINGS_PYTHON_CYTHON_ARMA_UTIL_HPP
 
+// Include Python first, as it requires.
+#include <Python.h>
+
 // Include Armadillo via mlpack.
 #include <mlpack/core.hpp>
 
@@ -60,4 +63,28 @@ inline typename T::elem_type* GetMemory(T& m)
   }
 }
 
+/**
+ * Free the Armadillo memory held by the given capsule.  This is the destructor
+ * of the capsules made by MemoryCapsule().
+ */
+template<typename T>
+void ReleaseMemoryCapsule(PyObject* capsule)
+{
+  T* memory = (T*) PyCapsule_GetPointer(capsule, "mlpack.arma_memory");
+  arma::memory::release(memory);
+}
+
+/**
+ * Wrap memory allocated by Armadillo in a capsule that frees it with
+ * Armadillo when it is destroyed.  The capsule is used as the base of a numpy
+ * array that holds the memory, so that the memory is given to numpy without a
+ * copy and is still freed by the allocator that made it.
+ */
+template<typename T>
+PyObject* MemoryCapsule(T* memory)
+{
+  return PyCapsule_New((void*) memory, "mlpack.arma_memory",
+      ReleaseMemoryCapsule<T>);
+}
+
 #endif
@@ -0,0 +1,17 @@
+#!/usr/bin/env python
+"""
+io_lock.py: lock around calls to mlpack programs.
+
+The parameters of every mlpack binding are held by mlpack::IO, which is shared
+by the whole process, so only one binding may run at a time.  Each binding
+holds this lock for the whole call; since the bindings release the GIL while
+the mlpack program runs, other Python threads can still run in the meantime.
+
+mlpack is free software; you may redistribute it and/or modify it under the
+terms of the 3-clause BSD license.  You should have received a copy of the
+3-clause BSD license along with mlpack.  If not, see
+http://www.opensource.org/licenses/BSD-3-Clause for more information.
+"""
+import threading
+
+io_lock = threading.RLock()
@@ -16,6 +16,10 @@
 #include <mlpack/core/util/io.hpp>
 #include <mlpack/core/data/dataset_mapper.hpp>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace util {
 
@@ -163,6 +167,24 @@ inline void EnableTimers()
   Timer::EnableTiming();
 }
 
+/**
+ * Set the number of OpenMP threads used by the calling thread, and return the
+ * previous number, so that it can be restored after the call.  If numThreads
+ * is 0, the number of threads is not changed.
+ */
+inline int SetNumThreads(const int numThreads)
+{
+  // The bindings are compiled with the OpenMP flags, but without HAS_OPENMP.
+  #ifdef _OPENMP
+    const int previous = omp_get_max_threads();
+    if (numThreads > 0)
+      omp_set_num_threads(numThreads);
+    return previous;
+  #else
+    return numThreads;
+  #endif
+}
+
 } // namespace util
 } // namespace mlpack
 
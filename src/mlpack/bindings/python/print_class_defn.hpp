@@ -63,8 +63,11 @@ void PrintClassDefn(
    * cdef class <ModelType>Type:
    *   cdef <ModelType>* modelptr
    *
-   *   def __cinit__(self):
-   *     self.modelptr = new <ModelType>()
+   *   def __cinit__(self, cbool allocate=True):
+   *     if allocate:
+   *       self.modelptr = new <ModelType>()
+   *     else:
+   *       self.modelptr = NULL
    *
    *   def __dealloc__(self):
    *     del self.modelptr
@@ -82,8 +85,11 @@ void PrintClassDefn(
   std::cout << "cdef class " << strippedType << "Type:" << std::endl;
   std::cout << "  cdef " << printedType << "* modelptr" << std::endl;
   std::cout << std::endl;
-  std::cout << "  def __cinit__(self):" << std::endl;
-  std::cout << "    self.modelptr = new " << printedType << "()" << std::endl;
+  std::cout << "  def __cinit__(self, cbool allocate=True):" << std::endl;
+  std::cout << "    if allocate:" << std::endl;
+  std::cout << "      self.modelptr = new " << printedType << "()" << std::endl;
+  std::cout << "    else:" << std::endl;
+  std::cout << "      self.modelptr = NULL" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __dealloc__(self):" << std::endl;
   std::cout << "    del self.modelptr" << std::endl;
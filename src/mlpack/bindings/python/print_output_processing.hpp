@@ -184,10 +184,14 @@ void PrintOutputProcessing(
     /**
      * This gives us code like:
      *
-     * result = ModelType()
+     * result = ModelType(False)
      * (<ModelType?> result).modelptr = GetParamPtr[Model]('name')
+     *
+     * The wrapper takes the model that the program produced, so it must not
+     * allocate a model of its own.
      */
-    std::cout << prefix << "result = " << strippedType << "Type()" << std::endl;
+    std::cout << prefix << "result = " << strippedType << "Type(False)"
+        << std::endl;
     std::cout << prefix << "(<" << strippedType << "Type?> result).modelptr = "
         << "GetParamPtr[" << strippedType << "]('" << d.name << "')"
         << std::endl;
@@ -206,7 +210,7 @@ void PrintOutputProcessing(
       if (data.input && data.cppType == d.cppType && data.required)
       {
         std::cout << prefix << "if (<" << strippedType
-            << "Type> result).modelptr" << d.name << " == (<" << strippedType
+            << "Type> result).modelptr == (<" << strippedType
             << "Type> " << data.name << ").modelptr:" << std::endl;
         std::cout << prefix << "  (<" << strippedType
             << "Type> result).modelptr = <" << strippedType << "*> 0"
@@ -218,7 +222,7 @@ void PrintOutputProcessing(
         std::cout << prefix << "if " << data.name << " is not None:"
             << std::endl;
         std::cout << prefix << "  if (<" << strippedType
-            << "Type> result).modelptr" << d.name << " == (<" << strippedType
+            << "Type> result).modelptr == (<" << strippedType
             << "Type> " << data.name << ").modelptr:" << std::endl;
         std::cout << prefix << "    (<" << strippedType
             << "Type> result).modelptr = <" << strippedType << "*> 0"
@@ -232,11 +236,11 @@ void PrintOutputProcessing(
     /**
      * This gives us code like:
      *
-     * result['name'] = ModelType()
+     * result['name'] = ModelType(False)
      * (<ModelType?> result['name']).modelptr = GetParamPtr[Model]('name'))
      */
     std::cout << prefix << "result['" << d.name << "'] = " << strippedType
-        << "Type()" << std::endl;
+        << "Type(False)" << std::endl;
     std::cout << prefix << "(<" << strippedType << "Type?> result['" << d.name
         << "']).modelptr = GetParamPtr[" << strippedType << "]('" << d.name
         << "')" << std::endl;
@@ -78,8 +78,9 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "from io cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
   cout << "from io cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
-      << "ResetTimers, EnableTimers" << endl;
+      << "ResetTimers, EnableTimers, SetNumThreads" << endl;
   cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
+  cout << "from io_lock import io_lock" << endl;
   cout << "from serialization cimport SerializeIn, SerializeOut" << endl;
   cout << endl;
   cout << "import numpy as np" << endl;
@@ -185,24 +186,28 @@ void PrintPYX(const util::BindingDetails& doc,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
+  // Only one mlpack program may run at a time, since the parameters are held
+  // by IO, which is shared by all bindings.  Hold the lock for the whole call.
+  cout << "  with io_lock:" << endl;
+
   // Reset any timers and disable backtraces.
-  cout << "  ResetTimers()" << endl;
-  cout << "  EnableTimers()" << endl;
-  cout << "  DisableBacktrace()" << endl;
-  cout << "  DisableVerbose()" << endl;
+  cout << "    ResetTimers()" << endl;
+  cout << "    EnableTimers()" << endl;
+  cout << "    DisableBacktrace()" << endl;
+  cout << "    DisableVerbose()" << endl;
 
   // Restore the parameters.
-  cout << "  IO.RestoreSettings(\"" << doc.programName << "\")"
+  cout << "    IO.RestoreSettings(\"" << doc.programName << "\")"
       << endl;
 
   // Determine whether or not we need to copy parameters.
-  cout << "  if isinstance(copy_all_inputs, bool):" << endl;
-  cout << "    if copy_all_inputs:" << endl;
-  cout << "      SetParam[cbool](<const string> 'copy_all_inputs', "
+  cout << "    if isinstance(copy_all_inputs, bool):" << endl;
+  cout << "      if copy_all_inputs:" << endl;
+  cout << "        SetParam[cbool](<const string> 'copy_all_inputs', "
       << "copy_all_inputs)" << endl;
-  cout << "      IO.SetPassed(<const string> 'copy_all_inputs')" << endl;
-  cout << "  else:" << endl;
-  cout << "    raise TypeError(" <<"\"'copy_all_inputs\' must have type "
+  cout << "        IO.SetPassed(<const string> 'copy_all_inputs')" << endl;
+  cout << "    else:" << endl;
+  cout << "      raise TypeError(" <<"\"'copy_all_inputs\' must have type "
       << "\'bool'!\")" << endl;
   cout << endl;
 
@@ -211,43 +216,50 @@ void PrintPYX(const util::BindingDetails& doc,
   {
     util::ParamData& d = parameters.at(inputOptions[i]);
 
-    size_t indent = 2;
+    size_t indent = 4;
     IO::GetSingleton().functionMap[d.tname]["PrintInputProcessing"](d,
         (void*) &indent, NULL);
   }
 
   // Set all output options as passed.
-  cout << "  # Mark all output options as passed." << endl;
+  cout << "    # Mark all output options as passed." << endl;
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     util::ParamData& d = parameters.at(outputOptions[i]);
-    cout << "  IO.SetPassed(<const string> '" << d.name << "')" << endl;
+    cout << "    IO.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
-  // Call the method.
-  cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  // Call the method without the GIL, so that other Python threads can run in
+  // the meantime, and with the requested number of OpenMP threads.
+  cout << "    # Call the mlpack program." << endl;
+  cout << "    previous_n_threads = SetNumThreads(IO.GetParam[int]("
+      << "'n_threads'))" << endl;
+  cout << "    try:" << endl;
+  cout << "      with nogil:" << endl;
+  cout << "        mlpackMain()" << endl;
+  cout << "    finally:" << endl;
+  cout << "      SetNumThreads(previous_n_threads)" << endl;
 
   // Do any output processing and return.
-  cout << "  # Initialize result dictionary." << endl;
-  cout << "  result = {}" << endl;
+  cout << "    # Initialize result dictionary." << endl;
+  cout << "    result = {}" << endl;
   cout << endl;
 
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     util::ParamData& d = parameters.at(outputOptions[i]);
 
-    std::tuple<size_t, bool> t = std::make_tuple(2, false);
+    std::tuple<size_t, bool> t = std::make_tuple(4, false);
     IO::GetSingleton().functionMap[d.tname]["PrintOutputProcessing"](d,
         (void*) &t, NULL);
   }
 
   // Clear the parameters.
   cout << endl;
-  cout << "  IO.ClearSettings()" << endl;
+  cout << "    IO.ClearSettings()" << endl;
   cout << endl;
 
-  cout << "  return result" << endl;
+  cout << "    return result" << endl;
 }
 
 } // namespace python
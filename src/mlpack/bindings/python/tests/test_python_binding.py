@@ -13,6 +13,7 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -37,6 +38,32 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output['int_out'], 13)
     self.assertEqual(output['double_out'], 5.0)
 
+  def testRunBindingThreads(self):
+    """
+    Test that the binding gives the expected output when it is called from
+    several Python threads at once, with a given number of OpenMP threads.
+    """
+    outputs = [None] * 8
+    def run(i):
+      outputs[i] = test_python_binding(string_in='hello',
+                                       int_in=i,
+                                       double_in=4.0,
+                                       mat_req_in=[[1.0]],
+                                       col_req_in=[1.0],
+                                       flag1=True,
+                                       n_threads=1)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(8):
+      self.assertEqual(outputs[i]['string_out'], 'hello2')
+      self.assertEqual(outputs[i]['int_out'], i + 1)
+      self.assertEqual(outputs[i]['double_out'], 5.0)
+
   def testRunBindingNoFlag(self):
     """
     If we forget the mandatory flag, we should get wrong results.
@@ -207,6 +234,31 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(100):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
+  def testNumpyMatrixOutputNoCopy(self):
+    """
+    The matrix we get back should hold the memory that mlpack allocated, freed
+    through a capsule, and not a copy of it.
+    """
+    x = np.random.rand(100, 5);
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 matrix_in=x)
+
+    self.assertFalse(output['matrix_out'].flags.owndata)
+    self.assertTrue(output['matrix_out'].flags.c_contiguous)
+    self.assertEqual(type(output['matrix_out'].base).__name__, 'PyCapsule')
+
+    # The memory must stay valid once the other outputs are gone.
+    m = output['matrix_out']
+    del output
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j, i], m[j, i])
+
   def testPandasSeriesMatrix(self):
     """
     Test that we can pass pandas.Series as input parameter.
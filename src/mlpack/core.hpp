@@ -73,6 +73,8 @@
 #include <mlpack/core/util/deprecated.hpp>
 #include <mlpack/core/data/load.hpp>
 #include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/checkpoint_writer.hpp>
+#include <mlpack/core/data/model_archive.hpp>
 #include <mlpack/core/data/normalize_labels.hpp>
 #include <mlpack/core/math/clamp.hpp>
 #include <mlpack/core/math/random.hpp>
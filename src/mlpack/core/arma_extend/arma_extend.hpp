@@ -36,6 +36,14 @@
     #endif
 #endif
 
+// If memory tracking is enabled, Armadillo allocates and frees memory through
+// the MemoryTracker.
+#ifdef MLPACK_TRACK_MEMORY
+  #include <mlpack/core/util/memory_tracker.hpp>
+  #define ARMA_ALIEN_MEM_ALLOC_FUNCTION mlpack::MemoryTracker::Allocate
+  #define ARMA_ALIEN_MEM_FREE_FUNCTION mlpack::MemoryTracker::Free
+#endif
+
 // Force definition of old HDF5 API.  Thanks to Mike Roberts for helping find
 // this workaround.
 #if !defined(H5_USE_110_API)
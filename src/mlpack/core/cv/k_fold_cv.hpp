@@ -15,6 +15,8 @@
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/cv_base.hpp>
 
+#include <exception>
+
 namespace mlpack {
 namespace cv {
 
@@ -169,7 +171,10 @@ class KFoldCV
           const bool shuffle = true);
 
   /**
-   * Run k-fold cross-validation.
+   * Run k-fold cross-validation.  Each fold draws its random numbers (from
+   * math::Random() and the like) from its own random object, seeded from the
+   * global one, so the result for a given math::RandomSeed() does not depend on
+   * whether the folds are run in parallel (see Parallel()).
    *
    * @param args Arguments for MLAlgorithm (in addition to the passed
    *     ones in the constructor).
@@ -180,6 +185,25 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get the fraction of each training subset that Evaluate() trains on.
+  double TrainingFraction() const { return trainingFraction; }
+  /**
+   * Modify the fraction of each training subset that Evaluate() trains on (the
+   * validation subsets are not changed).  This is used by budget-aware
+   * hyper-parameter tuning (see hpt::SuccessiveHalving); the default is 1.
+   */
+  double& TrainingFraction() { return trainingFraction; }
+
+  //! Get whether Evaluate() trains and evaluates the folds in parallel.
+  bool Parallel() const { return parallel; }
+  /**
+   * Modify whether Evaluate() trains and evaluates the folds in parallel, with
+   * OpenMP (the number of threads can be set with OMP_NUM_THREADS).  Training
+   * an MLAlgorithm must then not modify shared state, and the log output of
+   * the folds is interleaved.  The default is false.
+   */
+  bool& Parallel() { return parallel; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -222,6 +246,12 @@ class KFoldCV
   //! The size of each bin in terms of data points.
   size_t binSize;
 
+  //! The fraction of each training subset to train on.
+  double trainingFraction;
+
+  //! Whether to train and evaluate the folds in parallel.
+  bool parallel;
+
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
@@ -270,6 +300,15 @@ class KFoldCV
            typename = void>
   double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
+  /**
+   * Call the given function with the index of each fold, in parallel if
+   * parallel is true (the first exception thrown is then rethrown after all
+   * the folds).  Fold i draws its random numbers from stream i of a seed drawn
+   * from the global random object (see math::RandomTaskScope).
+   */
+  template<typename FoldFunctionType>
+  void ForEachFold(const FoldFunctionType& foldFunction);
+
   /**
    * Calculate the index of the first column of the ith validation subset.
    *
@@ -278,6 +317,12 @@ class KFoldCV
    */
   inline size_t ValidationSubsetFirstCol(const size_t i);
 
+  /**
+   * Calculate the number of points of the ith training subset to train on
+   * (taking the training fraction into account).
+   */
+  inline size_t TrainingSubsetSize(const size_t i);
+
   /**
    * Get the ith training subset from a variable of a matrix type.
    */
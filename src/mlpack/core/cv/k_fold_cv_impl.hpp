@@ -135,7 +135,9 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    trainingFraction(1.0),
+    parallel(false)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +168,9 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    trainingFraction(1.0),
+    parallel(false)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -246,13 +250,20 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
-  size_t numInvalidScores = 0;
-  for (size_t i = 0; i < k; ++i)
+  // The subsets are aliases of the extended data, so no data is copied.
+  ForEachFold([&](const size_t i)
   {
     MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
         GetTrainingSubset(ys, i), args...);
     evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
         GetValidationSubset(ys, i));
+    if (i == k - 1)
+      modelPtr.reset(new MLAlgorithm(std::move(model)));
+  });
+
+  size_t numInvalidScores = 0;
+  for (size_t i = 0; i < k; ++i)
+  {
     if (std::isnan(evaluations(i)) || std::isinf(evaluations(i)))
     {
       ++numInvalidScores;
@@ -260,8 +271,6 @@ double KFoldCV<MLAlgorithm,
           << "a score of " << evaluations(i) << "; ignoring when computing "
           << "the average score." << std::endl;
     }
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
   if (numInvalidScores == k)
@@ -288,7 +297,7 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
-  for (size_t i = 0; i < k; ++i)
+  ForEachFold([&](const size_t i)
   {
     MLAlgorithm&& model = (weights.n_elem > 0) ?
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
@@ -299,11 +308,64 @@ double KFoldCV<MLAlgorithm,
         GetValidationSubset(ys, i));
     if (i == k - 1)
       modelPtr.reset(new MLAlgorithm(std::move(model)));
-  }
+  });
 
   return arma::mean(evaluations);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename FoldFunctionType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::ForEachFold(const FoldFunctionType& foldFunction)
+{
+  // One seed is drawn for all the folds, so the results don't depend on the
+  // order in which the folds are run, or on the thread that runs them.
+  const uint64_t seed = math::RandomTaskSeed();
+
+  if (!parallel)
+  {
+    for (size_t i = 0; i < k; ++i)
+    {
+      math::RandomTaskScope randomScope(seed, i);
+      foldFunction(i);
+    }
+
+    return;
+  }
+
+  // The folds are independent, so they can be trained and evaluated in
+  // parallel.
+  std::exception_ptr error;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
+  {
+    math::RandomTaskScope randomScope(seed, i);
+    try
+    {
+      foldFunction((size_t) i);
+    }
+    catch (...)
+    {
+      // Exceptions can't leave the parallel region; pass on the first one.
+      #pragma omp critical
+      {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -371,6 +433,30 @@ size_t KFoldCV<MLAlgorithm,
   return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainingSubsetSize(const size_t i)
+{
+  // If this is not the first fold, we have to handle it a little bit
+  // differently, since the last fold may contain slightly more than 'binSize'
+  // points.
+  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
+      (k - 1) * binSize;
+
+  if (trainingFraction >= 1.0)
+    return subsetSize;
+
+  return std::max((size_t) std::ceil(trainingFraction * subsetSize),
+      (size_t) 1);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -385,12 +471,7 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
     arma::Mat<ElementType>& m,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
-
+  const size_t subsetSize = TrainingSubsetSize(i);
   return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
       false, true);
 }
@@ -409,12 +490,7 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
     arma::Row<ElementType>& r,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
-
+  const size_t subsetSize = TrainingSubsetSize(i);
   return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
 }
 
@@ -211,6 +211,15 @@ class SimpleCV
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
+  //! Get the fraction of the training set that Evaluate() trains on.
+  double TrainingFraction() const { return trainingFraction; }
+  /**
+   * Modify the fraction of the training set that Evaluate() trains on (the
+   * validation set is not changed).  This is used by budget-aware
+   * hyper-parameter tuning (see hpt::SuccessiveHalving); the default is 1.
+   */
+  double& TrainingFraction() { return trainingFraction; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -240,6 +249,9 @@ class SimpleCV
   //! The pointer to the last trained model.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! The fraction of the training set to train on.
+  double trainingFraction;
+
   /**
    * Assert data consistency and initialize fields required for running
    * cross-validation.
@@ -269,6 +281,12 @@ class SimpleCV
    */
   size_t CalculateAndAssertNumberOfTrainingPoints(const double validationSize);
 
+  /**
+   * Calculate the index of the last training point to train on (taking the
+   * training fraction into account).
+   */
+  size_t LastTrainingCol();
+
   /**
    * Get the specified submatrix without coping the data.
    */
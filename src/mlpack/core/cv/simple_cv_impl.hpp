@@ -143,7 +143,8 @@ SimpleCV<MLAlgorithm,
                                 PIT&& ys) :
     base(std::move(base)),
     xs(std::forward<MIT>(xs)),
-    ys(std::forward<PIT>(ys))
+    ys(std::forward<PIT>(ys)),
+    trainingFraction(1.0)
 {
   Base::AssertDataConsistency(this->xs, this->ys);
 
@@ -243,6 +244,24 @@ size_t SimpleCV<MLAlgorithm,
   return trainingPoints;
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t SimpleCV<MLAlgorithm,
+                Metric,
+                MatType,
+                PredictionsType,
+                WeightsType>::LastTrainingCol()
+{
+  if (trainingFraction >= 1.0)
+    return trainingXs.n_cols - 1;
+
+  return std::max((size_t) std::ceil(trainingFraction * trainingXs.n_cols),
+      (size_t) 1) - 1;
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -293,7 +312,9 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  const size_t lastCol = LastTrainingCol();
+  modelPtr.reset(new MLAlgorithm(base.Train(GetSubset(trainingXs, 0, lastCol),
+      GetSubset(trainingYs, 0, lastCol), args...)));
 
   return Metric::Evaluate(*modelPtr, validationXs, validationYs);
 }
@@ -310,12 +331,14 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
+  const size_t lastCol = LastTrainingCol();
   if (trainingWeights.n_elem > 0)
-    modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, trainingWeights, args...)));
+    modelPtr.reset(new MLAlgorithm(base.Train(GetSubset(trainingXs, 0, lastCol),
+        GetSubset(trainingYs, 0, lastCol),
+        GetSubset(trainingWeights, 0, lastCol), args...)));
   else
-    modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, args...)));
+    modelPtr.reset(new MLAlgorithm(base.Train(GetSubset(trainingXs, 0, lastCol),
+        GetSubset(trainingYs, 0, lastCol), args...)));
 
   return Metric::Evaluate(*modelPtr, validationXs, validationYs);
 }
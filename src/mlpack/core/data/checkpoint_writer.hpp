@@ -0,0 +1,179 @@
+/**
+ * @file core/data/checkpoint_writer.hpp
+ *
+ * Definition of the CheckpointWriter class, which saves models on a
+ * background thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHECKPOINT_WRITER_HPP
+#define MLPACK_CORE_DATA_CHECKPOINT_WRITER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <thread>
+
+#include "format.hpp"
+#include "save.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The CheckpointWriter saves models with data::Save() on a background thread,
+ * so that a long computation (such as the training of a model) is only blocked
+ * while the model is copied, and not while it is serialized and written.
+ *
+ * Save() takes a snapshot of the model (a copy, or a model moved into it) and
+ * returns at once; the snapshot is then written on the background thread.  At
+ * most one snapshot is written at a time: Save() first waits for the previous
+ * one, so there are never more than two copies of the model (the live one and
+ * the one being written).  The snapshot is written to a temporary file next to
+ * the given file, which is renamed once it is complete, so the file always
+ * holds a complete checkpoint, even if the program is stopped while writing.
+ *
+ * Errors of the background thread are rethrown by the next call to Wait() or
+ * Save().
+ *
+ * @code
+ * data::CheckpointWriter writer;
+ * for (size_t i = 0; i < rounds; ++i)
+ * {
+ *   // ... train the model for a while ...
+ *   writer.Save("model.mlb", "model", model);
+ * }
+ * writer.Wait();
+ * @endcode
+ */
+class CheckpointWriter
+{
+ public:
+  /**
+   * Create the writer.
+   *
+   * @param f Format of the checkpoints; if format::autodetect, the format is
+   *     given by the extension of the file.
+   */
+  CheckpointWriter(const format f = format::autodetect) : f(f)
+  {
+    /* Nothing to do here. */
+  }
+
+  //! A CheckpointWriter cannot be copied.
+  CheckpointWriter(const CheckpointWriter& other) = delete;
+  //! A CheckpointWriter cannot be copied.
+  CheckpointWriter& operator=(const CheckpointWriter& other) = delete;
+
+  /**
+   * Wait for the snapshot being written.  An error of the background thread
+   * can't be rethrown here, so it is printed to Log::Warn.
+   */
+  ~CheckpointWriter()
+  {
+    try
+    {
+      Wait();
+    }
+    catch (std::exception& e)
+    {
+      Log::Warn << "CheckpointWriter: " << e.what() << std::endl;
+    }
+  }
+
+  /**
+   * Write the given snapshot of a model to the given file on the background
+   * thread, after the previous snapshot has been written.  The snapshot is
+   * taken by value: pass the model to copy it, or std::move() a snapshot that
+   * is not needed anymore.
+   *
+   * @param filename File to write the snapshot to.
+   * @param name Name of the model in the file (see data::Save()).
+   * @param snapshot The snapshot of the model.
+   */
+  template<typename T>
+  void Save(const std::string& filename, const std::string& name, T snapshot)
+  {
+    Wait();
+
+    std::shared_ptr<T> model = std::make_shared<T>(std::move(snapshot));
+    const std::string partialFilename = PartialFilename(filename);
+    const format fileFormat = f;
+    thread = std::thread([this, model, filename, partialFilename, name,
+        fileFormat]()
+    {
+      try
+      {
+        data::Save(partialFilename, name, *model, true, fileFormat);
+        if (std::rename(partialFilename.c_str(), filename.c_str()) != 0)
+        {
+          // Some platforms do not replace an existing file.
+          std::remove(filename.c_str());
+          if (std::rename(partialFilename.c_str(), filename.c_str()) != 0)
+          {
+            throw std::runtime_error("CheckpointWriter: could not rename '" +
+                partialFilename + "' to '" + filename + "'!");
+          }
+        }
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+    });
+  }
+
+  /**
+   * Wait for the snapshot being written, if any.  If writing it failed, the
+   * error is rethrown.
+   */
+  void Wait()
+  {
+    if (thread.joinable())
+      thread.join();
+
+    if (error)
+    {
+      std::exception_ptr e = error;
+      error = nullptr;
+      std::rethrow_exception(e);
+    }
+  }
+
+  //! Get the format of the checkpoints.
+  format Format() const { return f; }
+  //! Modify the format of the checkpoints.
+  format& Format() { return f; }
+
+ private:
+  /**
+   * Get the name of the temporary file of the given file: ".partial" is added
+   * before the extension, so that the format can still be detected from it.
+   */
+  static std::string PartialFilename(const std::string& filename)
+  {
+    const size_t dot = filename.rfind('.');
+    const size_t slash = filename.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+      return filename + ".partial";
+
+    return filename.substr(0, dot) + ".partial" + filename.substr(dot);
+  }
+
+  //! The format of the checkpoints.
+  format f;
+  //! The thread writing the snapshot.
+  std::thread thread;
+  //! The error of the last snapshot, if any.
+  std::exception_ptr error;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file core/data/chunked_loader.hpp
+ *
+ * Definition of the ChunkedLoader class, which reads a dataset from a file a
+ * fixed number of points at a time, so that datasets larger than memory can be
+ * processed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_LOADER_HPP
+#define MLPACK_CORE_DATA_CHUNKED_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+#include "load_csv.hpp"
+#include "load_arff.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The ChunkedLoader class reads a dataset from a file in blocks of a fixed
+ * number of points (columns), so that only one block has to be held in memory
+ * at a time.  Concatenating the blocks gives the same matrix that data::Load()
+ * would give (with the same transpose parameter), and the DatasetInfo that is
+ * built along the way holds the same mappings.
+ *
+ * The following formats are supported:
+ *
+ *  - CSV, TSV and text files (.csv, .tsv, .txt), with one point per line
+ *    (transpose = true only).  Unless a DatasetInfo is given, a first pass over
+ *    the file finds the categorical dimensions, as data::Load() does.
+ *  - ARFF files (.arff), with one point per line (transpose = true only).  The
+ *    types of the dimensions are given by the header.
+ *  - Armadillo binary files (.bin, with the same element type as the loader).
+ *  - HDF5 files (.h5, .hdf5, .hdf, .he5) written by Armadillo, when Armadillo
+ *    was compiled with HDF5 support.
+ *
+ * The mappings of the categorical values are created as the blocks are read,
+ * and are kept from one epoch to the next, so the same value is always given
+ * the same mapping.  To load a test set with the mappings of a training set,
+ * pass the DatasetInfo of the training set to the constructor; the types of
+ * the dimensions are then taken from it, and a value that is not a number in a
+ * numeric dimension is an error.
+ *
+ * @code
+ * data::ChunkedLoader<double> loader("dataset.csv", 10000);
+ * arma::mat chunk;
+ * while (loader.Next(chunk))
+ * {
+ *   // Use the chunk; loader.Info() holds the mappings.
+ * }
+ * @endcode
+ *
+ * Errors are reported by throwing std::runtime_error (or std::invalid_argument
+ * for invalid parameters).
+ *
+ * @tparam eT Type of the elements of the chunks.
+ */
+template<typename eT = double>
+class ChunkedLoader
+{
+ public:
+  /**
+   * Open the given file, finding the types of its dimensions.
+   *
+   * @param filename File to read.
+   * @param chunkSize Maximum number of points of each chunk.
+   * @param transpose Whether to transpose the file (see data::Load()).
+   */
+  ChunkedLoader(const std::string& filename,
+                const size_t chunkSize,
+                const bool transpose = true);
+
+  /**
+   * Open the given file, using the types of the dimensions and the mappings
+   * of the given DatasetInfo.
+   *
+   * @param filename File to read.
+   * @param info DatasetInfo with the types and mappings to use.
+   * @param chunkSize Maximum number of points of each chunk.
+   * @param transpose Whether to transpose the file (see data::Load()).
+   */
+  ChunkedLoader(const std::string& filename,
+                const DatasetInfo& info,
+                const size_t chunkSize,
+                const bool transpose = true);
+
+  //! Close the file.
+  ~ChunkedLoader();
+
+  //! A ChunkedLoader cannot be copied.
+  ChunkedLoader(const ChunkedLoader& other) = delete;
+  //! A ChunkedLoader cannot be copied.
+  ChunkedLoader& operator=(const ChunkedLoader& other) = delete;
+
+  /**
+   * Read the next chunk of points; the last chunk may hold fewer than
+   * ChunkSize() points.
+   *
+   * @param chunk Matrix to read the points into.
+   * @return false (and leave the chunk empty) if all the points were read.
+   */
+  bool Next(arma::Mat<eT>& chunk);
+
+  //! Go back to the first point of the file.  The mappings are kept.
+  void Reset();
+
+  //! Get the DatasetInfo with the types and the mappings of the dimensions.
+  const DatasetInfo& Info() const { return info; }
+
+  //! Get the number of dimensions of the points.
+  size_t Dimensionality() const { return info.Dimensionality(); }
+  //! Get the number of points of the file.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the maximum number of points of each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+
+ private:
+  //! The kinds of files that can be read.
+  enum FileType
+  {
+    TextFile,
+    ARFFFile,
+    BinaryFile,
+    HDF5File
+  };
+
+  /**
+   * Open the file and find its dimensions; if findTypes is true, the types of
+   * the dimensions are found too (for text files).
+   */
+  void Open(const bool findTypes);
+
+  //! Read the next chunk of a CSV, TSV or text file.
+  size_t NextText(arma::Mat<eT>& chunk);
+  //! Read the next chunk of an ARFF file.
+  size_t NextARFF(arma::Mat<eT>& chunk);
+  //! Read the next chunk of an Armadillo binary file.
+  size_t NextBinary(arma::Mat<eT>& chunk);
+  //! Read the next chunk of an HDF5 file.
+  size_t NextHDF5(arma::Mat<eT>& chunk);
+
+  //! The name of the file.
+  std::string filename;
+  //! The kind of file.
+  FileType fileType;
+  //! The maximum number of points of each chunk.
+  size_t chunkSize;
+  //! Whether the file is transposed.
+  bool transpose;
+  //! The types and the mappings of the dimensions.
+  DatasetInfo info;
+  //! If true, the types of the dimensions were given by the user.
+  bool fixedTypes;
+
+  //! The number of points of the file.
+  size_t numPoints;
+  //! The index of the next point to read.
+  size_t position;
+
+  //! The parser of a text file.
+  std::unique_ptr<LoadCSV> csv;
+  //! The values of the current line of a text file.
+  std::vector<std::string> values;
+
+  //! The stream of an ARFF or binary file.
+  std::ifstream stream;
+  //! The position of the first point in the stream.
+  std::streampos dataStart;
+  //! The number of lines of the header of an ARFF file.
+  size_t headerLines;
+  //! The number of the next line of an ARFF file.
+  size_t lineNumber;
+  //! The categories listed by the header of an ARFF file.
+  std::map<size_t, std::vector<std::string>> categoryStrings;
+
+  //! The number of rows of a binary or HDF5 matrix.
+  size_t nRows;
+  //! The number of columns of a binary or HDF5 matrix.
+  size_t nCols;
+
+  #ifdef ARMA_USE_HDF5
+  //! The HDF5 file.
+  hid_t hdf5File;
+  //! The dataset of the HDF5 file.
+  hid_t hdf5Dataset;
+  #endif
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "chunked_loader_impl.hpp"
+
+#endif
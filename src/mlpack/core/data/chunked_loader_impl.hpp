@@ -0,0 +1,516 @@
+/**
+ * @file core/data/chunked_loader_impl.hpp
+ *
+ * Implementation of the ChunkedLoader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_LOADER_IMPL_HPP
+#define MLPACK_CORE_DATA_CHUNKED_LOADER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "chunked_loader.hpp"
+
+#include <boost/algorithm/string/trim.hpp>
+#include "extension.hpp"
+
+namespace mlpack {
+namespace data {
+
+#ifdef ARMA_USE_HDF5
+namespace details {
+
+//! Get the HDF5 type of the elements of a chunk, so that HDF5 converts the
+//! values of the file to it.
+template<typename eT>
+hid_t HDF5NativeType()
+{
+  if (std::is_same<eT, double>::value)
+    return H5T_NATIVE_DOUBLE;
+  if (std::is_same<eT, float>::value)
+    return H5T_NATIVE_FLOAT;
+
+  if (std::is_integral<eT>::value)
+  {
+    const bool isSigned = std::is_signed<eT>::value;
+    switch (sizeof(eT))
+    {
+      case 1: return isSigned ? H5T_NATIVE_INT8 : H5T_NATIVE_UINT8;
+      case 2: return isSigned ? H5T_NATIVE_INT16 : H5T_NATIVE_UINT16;
+      case 4: return isSigned ? H5T_NATIVE_INT32 : H5T_NATIVE_UINT32;
+      case 8: return isSigned ? H5T_NATIVE_INT64 : H5T_NATIVE_UINT64;
+    }
+  }
+
+  throw std::invalid_argument("ChunkedLoader: HDF5 files can't be read into "
+      "matrices of this element type!");
+}
+
+} // namespace details
+#endif
+
+template<typename eT>
+ChunkedLoader<eT>::ChunkedLoader(const std::string& filename,
+                                 const size_t chunkSize,
+                                 const bool transpose) :
+    filename(filename),
+    fileType(TextFile),
+    chunkSize(chunkSize),
+    transpose(transpose),
+    fixedTypes(false),
+    numPoints(0),
+    position(0),
+    headerLines(0),
+    lineNumber(0),
+    nRows(0),
+    nCols(0)
+{
+  Open(true);
+}
+
+template<typename eT>
+ChunkedLoader<eT>::ChunkedLoader(const std::string& filename,
+                                 const DatasetInfo& info,
+                                 const size_t chunkSize,
+                                 const bool transpose) :
+    filename(filename),
+    fileType(TextFile),
+    chunkSize(chunkSize),
+    transpose(transpose),
+    info(info),
+    fixedTypes(true),
+    numPoints(0),
+    position(0),
+    headerLines(0),
+    lineNumber(0),
+    nRows(0),
+    nCols(0)
+{
+  Open(false);
+}
+
+template<typename eT>
+ChunkedLoader<eT>::~ChunkedLoader()
+{
+  #ifdef ARMA_USE_HDF5
+  if (hdf5Dataset >= 0)
+    H5Dclose(hdf5Dataset);
+  if (hdf5File >= 0)
+    H5Fclose(hdf5File);
+  #endif
+}
+
+template<typename eT>
+void ChunkedLoader<eT>::Open(const bool findTypes)
+{
+  #ifdef ARMA_USE_HDF5
+  hdf5File = -1;
+  hdf5Dataset = -1;
+  #endif
+
+  if (chunkSize == 0)
+  {
+    throw std::invalid_argument("ChunkedLoader::ChunkedLoader(): the chunk "
+        "size must be positive!");
+  }
+
+  const std::string extension = Extension(filename);
+  if (extension == "csv" || extension == "tsv" || extension == "txt")
+    fileType = TextFile;
+  else if (extension == "arff")
+    fileType = ARFFFile;
+  else if (extension == "bin")
+    fileType = BinaryFile;
+  else if (extension == "h5" || extension == "hdf5" || extension == "hdf" ||
+      extension == "he5")
+    fileType = HDF5File;
+  else
+  {
+    throw std::runtime_error("ChunkedLoader::ChunkedLoader(): unable to "
+        "detect type of '" + filename + "'; incorrect extension?");
+  }
+
+  if ((fileType == TextFile || fileType == ARFFFile) && !transpose)
+  {
+    throw std::invalid_argument("ChunkedLoader::ChunkedLoader(): the points "
+        "of '" + filename + "' are its lines, so it must be transposed!");
+  }
+
+  if (fileType == TextFile)
+  {
+    csv.reset(new LoadCSV(filename));
+
+    // Take a pass over the file to count the points and check the number of
+    // values of each line; this also finds the types of the dimensions, as
+    // data::Load() does, if they were not given.
+    size_t dimensionality = info.Dimensionality();
+    while (csv->NextLine(values))
+    {
+      if (numPoints == 0 && findTypes)
+      {
+        dimensionality = values.size();
+        info = DatasetInfo(dimensionality);
+      }
+      else if (numPoints == 0 && values.size() != dimensionality)
+      {
+        std::ostringstream oss;
+        oss << "ChunkedLoader::ChunkedLoader(): given DatasetInfo has "
+            << "dimensionality " << dimensionality << ", but '" << filename
+            << "' has dimensionality " << values.size() << "!";
+        throw std::invalid_argument(oss.str());
+      }
+
+      if (values.size() != dimensionality)
+      {
+        std::ostringstream oss;
+        oss << "ChunkedLoader::ChunkedLoader(): wrong number of dimensions ("
+            << values.size() << ") on line " << numPoints << " of '"
+            << filename << "'; should be " << dimensionality
+            << " dimensions.";
+        throw std::runtime_error(oss.str());
+      }
+
+      if (findTypes)
+      {
+        for (size_t d = 0; d < dimensionality; ++d)
+          info.template MapFirstPass<eT>(values[d], d);
+      }
+
+      ++numPoints;
+    }
+
+    csv->Rewind();
+  }
+  else if (fileType == ARFFFile)
+  {
+    stream.open(filename, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("ChunkedLoader::ChunkedLoader(): cannot open "
+          "file '" + filename + "'!");
+    }
+
+    LoadARFFHeader<eT>(stream, info, categoryStrings, headerLines);
+    dataStart = stream.tellg();
+
+    // Count the points; empty lines and comments are skipped.
+    std::string line;
+    while (std::getline(stream, line))
+    {
+      boost::trim(line);
+      if (!line.empty() && line[0] != '%')
+        ++numPoints;
+    }
+
+    stream.clear();
+    stream.seekg(dataStart);
+    lineNumber = headerLines;
+  }
+  else
+  {
+    if (fileType == BinaryFile)
+    {
+      stream.open(filename, std::ios::in | std::ios::binary);
+      if (!stream.is_open())
+      {
+        throw std::runtime_error("ChunkedLoader::ChunkedLoader(): cannot open "
+            "file '" + filename + "'!");
+      }
+
+      // Read the header written by Armadillo; the elements must have the type
+      // of the chunks, since they are read as they are.
+      std::string header;
+      stream >> header >> nRows >> nCols;
+      stream.get();
+      if (!stream.good() ||
+          header != arma::diskio::gen_bin_header(arma::Mat<eT>()))
+      {
+        throw std::runtime_error("ChunkedLoader::ChunkedLoader(): '" +
+            filename + "' is not an Armadillo binary file with elements of the "
+            "type of the loader!");
+      }
+
+      dataStart = stream.tellg();
+    }
+    else
+    {
+      #ifdef ARMA_USE_HDF5
+      hdf5File = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      if (hdf5File < 0)
+      {
+        throw std::runtime_error("ChunkedLoader::ChunkedLoader(): cannot open "
+            "file '" + filename + "'!");
+      }
+
+      // These are the names Armadillo looks for, in the same order.
+      const char* names[] = { "dataset", "value", "data" };
+      for (size_t i = 0; i < 3 && hdf5Dataset < 0; ++i)
+      {
+        if (H5Lexists(hdf5File, names[i], H5P_DEFAULT) > 0)
+          hdf5Dataset = H5Dopen(hdf5File, names[i], H5P_DEFAULT);
+      }
+
+      int rank = -1;
+      hsize_t dims[2] = { 0, 0 };
+      if (hdf5Dataset >= 0)
+      {
+        const hid_t space = H5Dget_space(hdf5Dataset);
+        rank = H5Sget_simple_extent_ndims(space);
+        if (rank == 2)
+          H5Sget_simple_extent_dims(space, dims, NULL);
+        H5Sclose(space);
+      }
+
+      if (rank != 2)
+      {
+        // The destructor won't be called, so close the file here.
+        if (hdf5Dataset >= 0)
+          H5Dclose(hdf5Dataset);
+        H5Fclose(hdf5File);
+        throw std::runtime_error("ChunkedLoader::ChunkedLoader(): '" +
+            filename + "' does not hold a matrix saved by Armadillo!");
+      }
+
+      // HDF5 stores the matrix in row-major order, so the first dimension of
+      // the dataset is the number of columns.
+      nCols = (size_t) dims[0];
+      nRows = (size_t) dims[1];
+      #else
+      throw std::runtime_error("ChunkedLoader::ChunkedLoader(): attempted to "
+          "load '" + filename + "' as HDF5 data, but Armadillo was compiled "
+          "without HDF5 support!");
+      #endif
+    }
+
+    const size_t dimensionality = transpose ? nCols : nRows;
+    numPoints = transpose ? nRows : nCols;
+    if (findTypes)
+    {
+      info = DatasetInfo(dimensionality);
+    }
+    else if (info.Dimensionality() != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "ChunkedLoader::ChunkedLoader(): given DatasetInfo has "
+          << "dimensionality " << info.Dimensionality() << ", but '"
+          << filename << "' has dimensionality " << dimensionality << "!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+}
+
+template<typename eT>
+bool ChunkedLoader<eT>::Next(arma::Mat<eT>& chunk)
+{
+  if (position == numPoints)
+  {
+    chunk.clear();
+    return false;
+  }
+
+  size_t points = 0;
+  switch (fileType)
+  {
+    case TextFile:
+      points = NextText(chunk);
+      break;
+    case ARFFFile:
+      points = NextARFF(chunk);
+      break;
+    case BinaryFile:
+      points = NextBinary(chunk);
+      break;
+    case HDF5File:
+      points = NextHDF5(chunk);
+      break;
+  }
+
+  position += points;
+  return true;
+}
+
+template<typename eT>
+void ChunkedLoader<eT>::Reset()
+{
+  position = 0;
+  if (fileType == TextFile)
+  {
+    csv->Rewind();
+  }
+  else if (fileType == ARFFFile)
+  {
+    stream.clear();
+    stream.seekg(dataStart);
+    lineNumber = headerLines;
+  }
+}
+
+template<typename eT>
+size_t ChunkedLoader<eT>::NextText(arma::Mat<eT>& chunk)
+{
+  const size_t points = std::min(chunkSize, numPoints - position);
+  chunk.set_size(info.Dimensionality(), points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    if (!csv->NextLine(values) || values.size() != info.Dimensionality())
+    {
+      throw std::runtime_error("ChunkedLoader::Next(): '" + filename + "' "
+          "was modified after it was opened!");
+    }
+
+    for (size_t d = 0; d < values.size(); ++d)
+    {
+      if (info.Type(d) == Datatype::categorical)
+      {
+        chunk(d, i) = info.template MapString<eT>(values[d], d);
+        continue;
+      }
+
+      // The mapping of a numeric dimension can't change, since the previous
+      // chunks have been read as numbers already.
+      std::stringstream token;
+      token << values[d];
+      eT val;
+      token >> val;
+      if (token.fail() || !token.eof())
+      {
+        std::ostringstream oss;
+        oss << "ChunkedLoader::Next(): value '" << values[d] << "' of point "
+            << (position + i) << " is not a number, but dimension " << d
+            << " is numeric!";
+        throw std::runtime_error(oss.str());
+      }
+
+      chunk(d, i) = val;
+    }
+  }
+
+  return points;
+}
+
+template<typename eT>
+size_t ChunkedLoader<eT>::NextARFF(arma::Mat<eT>& chunk)
+{
+  const size_t points = std::min(chunkSize, numPoints - position);
+  chunk.set_size(info.Dimensionality(), points);
+
+  std::string line;
+  size_t i = 0;
+  while (i < points && std::getline(stream, line))
+  {
+    ++lineNumber;
+    boost::trim(line);
+    if (line.empty() || line[0] == '%')
+      continue;
+
+    if (line[0] == '{')
+      throw std::runtime_error("cannot yet parse sparse ARFF data");
+
+    LoadARFFDataLine(line, lineNumber, info, categoryStrings,
+        chunk.colptr(i++));
+  }
+
+  if (i < points)
+  {
+    throw std::runtime_error("ChunkedLoader::Next(): '" + filename + "' "
+        "was modified after it was opened!");
+  }
+
+  return points;
+}
+
+template<typename eT>
+size_t ChunkedLoader<eT>::NextBinary(arma::Mat<eT>& chunk)
+{
+  const size_t points = std::min(chunkSize, numPoints - position);
+  if (!transpose)
+  {
+    // The points are the columns of the matrix, which are contiguous.
+    chunk.set_size(nRows, points);
+    stream.seekg(dataStart + std::streamoff(position * nRows * sizeof(eT)));
+    stream.read(reinterpret_cast<char*>(chunk.memptr()),
+        std::streamsize(chunk.n_elem * sizeof(eT)));
+  }
+  else
+  {
+    // The points are the rows of the matrix, so read their part of each
+    // column.
+    arma::Mat<eT> rows(points, nCols);
+    for (size_t j = 0; j < nCols; ++j)
+    {
+      stream.seekg(dataStart +
+          std::streamoff((j * nRows + position) * sizeof(eT)));
+      stream.read(reinterpret_cast<char*>(rows.colptr(j)),
+          std::streamsize(points * sizeof(eT)));
+    }
+
+    chunk = rows.t();
+  }
+
+  if (!stream.good())
+  {
+    throw std::runtime_error("ChunkedLoader::Next(): could not read from '" +
+        filename + "'!");
+  }
+
+  return points;
+}
+
+template<typename eT>
+size_t ChunkedLoader<eT>::NextHDF5(arma::Mat<eT>& chunk)
+{
+  const size_t points = std::min(chunkSize, numPoints - position);
+
+  #ifdef ARMA_USE_HDF5
+  // In the (row-major) dataset, the columns of the matrix are the rows.
+  hsize_t offset[2], count[2];
+  if (!transpose)
+  {
+    offset[0] = position;
+    offset[1] = 0;
+    count[0] = points;
+    count[1] = nRows;
+  }
+  else
+  {
+    offset[0] = 0;
+    offset[1] = position;
+    count[0] = nCols;
+    count[1] = points;
+  }
+
+  const hid_t fileSpace = H5Dget_space(hdf5Dataset);
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL, count, NULL);
+  const hid_t memorySpace = H5Screate_simple(2, count, NULL);
+
+  // A row-major block of the dataset is a column-major block of the matrix.
+  arma::Mat<eT> block(count[1], count[0]);
+  const herr_t status = H5Dread(hdf5Dataset, details::HDF5NativeType<eT>(),
+      memorySpace, fileSpace, H5P_DEFAULT, block.memptr());
+  H5Sclose(memorySpace);
+  H5Sclose(fileSpace);
+
+  if (status < 0)
+  {
+    throw std::runtime_error("ChunkedLoader::Next(): could not read from '" +
+        filename + "'!");
+  }
+
+  if (transpose)
+    chunk = block.t();
+  else
+    chunk = std::move(block);
+  #else
+  chunk.clear();
+  #endif
+
+  return points;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,264 @@
+/**
+ * @file core/data/compact_dataset_mapper.hpp
+ *
+ * Specialization of the DatasetMapper class for CompactIncrementPolicy, which
+ * stores the mappings of each dimension in a CompactStringMap.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COMPACT_DATASET_MAPPER_HPP
+#define MLPACK_CORE_DATA_COMPACT_DATASET_MAPPER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+#include "compact_string_map.hpp"
+#include "map_policies/compact_increment_policy.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Specialization of DatasetMapper for CompactIncrementPolicy.  It has the same
+ * interface and gives the same mappings as a DatasetInfo, but the strings of
+ * each categorical dimension are interned in a CompactStringMap, so that
+ * dimensions with millions of distinct values take little memory, are mapped
+ * quickly, and are serialized as a few contiguous blocks.  The only
+ * differences are that UnmapString() returns the string by value, and that
+ * each dimension can hold at most 2^32 - 1 distinct values.
+ */
+template<>
+class DatasetMapper<CompactIncrementPolicy, std::string>
+{
+ public:
+  //! The type of the mapped values.
+  using MappedType = CompactIncrementPolicy::MappedType;
+
+  /**
+   * Create the DatasetMapper object with the given dimensionality.
+   */
+  explicit DatasetMapper(const size_t dimensionality = 0) :
+      types(dimensionality, Datatype::numeric)
+  { }
+
+  /**
+   * Create the DatasetMapper object with the given policy and dimensionality.
+   */
+  explicit DatasetMapper(CompactIncrementPolicy& policy,
+                         const size_t dimensionality = 0) :
+      types(dimensionality, Datatype::numeric),
+      policy(std::move(policy))
+  { }
+
+  /**
+   * Set the dimensionality of an existing DatasetMapper object.  This resets
+   * all mappings (but not the policy).
+   *
+   * @param dimensionality New dimensionality.
+   */
+  void SetDimensionality(const size_t dimensionality)
+  {
+    types = std::vector<Datatype>(dimensionality, Datatype::numeric);
+    maps.clear();
+  }
+
+  /**
+   * Preprocessing: during a first pass of the data, find the dimensions that
+   * are categorical.
+   *
+   * @param input Input to map.
+   * @param dimension Dimension to map for.
+   */
+  template<typename T>
+  void MapFirstPass(const std::string& input, const size_t dimension)
+  {
+    policy.template MapFirstPass<T>(input, dimension, types);
+  }
+
+  /**
+   * Given the input and the dimension to which it belongs, return its numeric
+   * mapping.  If no mapping yet exists, the input is added to the map of the
+   * dimension.
+   *
+   * @tparam T Numeric type to map to (int/double/float/etc.).
+   * @param input Input to find/create mapping for.
+   * @param dimension Index of the dimension of the string.
+   */
+  template<typename T>
+  T MapString(const std::string& input, const size_t dimension)
+  {
+    return policy.template MapString<std::vector<CompactStringMap>, T>(input,
+        dimension, maps, types);
+  }
+
+  /**
+   * Return the input that corresponds to a given value in a given dimension.
+   * If the value is not a valid mapping in the given dimension, a
+   * std::invalid_argument is thrown.  Each value has a single unmapping, so
+   * unmappingIndex must be 0.
+   *
+   * @param value Mapped value for input.
+   * @param dimension Dimension to unmap string from.
+   * @param unmappingIndex Index of non-unique unmapping (must be 0).
+   */
+  template<typename T>
+  std::string UnmapString(const T value,
+                          const size_t dimension,
+                          const size_t unmappingIndex = 0) const
+  {
+    if (!IsMapping(value, dimension))
+    {
+      std::ostringstream oss;
+      oss << "DatasetMapper<CompactIncrementPolicy>::UnmapString(): value '"
+          << value << "' unknown for dimension " << dimension;
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (unmappingIndex != 0)
+    {
+      std::ostringstream oss;
+      oss << "DatasetMapper<CompactIncrementPolicy>::UnmapString(): value '"
+          << value << "' only has 1 unmapping, but unmappingIndex is "
+          << unmappingIndex << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    const boost::string_view str = maps[dimension].String((uint32_t) value);
+    return std::string(str.data(), str.size());
+  }
+
+  /**
+   * Get the number of possible unmappings for a value in a given dimension:
+   * 1 if the value is a mapping, and 0 otherwise.
+   */
+  template<typename T>
+  size_t NumUnmappings(const T value, const size_t dimension) const
+  {
+    return IsMapping(value, dimension) ? 1 : 0;
+  }
+
+  /**
+   * Return the value that corresponds to a given input in a given dimension.
+   * If the input is not mapped in the given dimension, a std::invalid_argument
+   * is thrown.
+   *
+   * @param input Mapped input for value.
+   * @param dimension Dimension to unmap input from.
+   */
+  MappedType UnmapValue(const std::string& input, const size_t dimension) const
+  {
+    uint32_t code = CompactStringMap::NotFound;
+    if (dimension < maps.size())
+      code = maps[dimension].Find(input);
+    if (code == CompactStringMap::NotFound)
+    {
+      std::ostringstream oss;
+      oss << "DatasetMapper<CompactIncrementPolicy>::UnmapValue(): input '"
+          << input << "' unknown for dimension " << dimension;
+      throw std::invalid_argument(oss.str());
+    }
+
+    return code;
+  }
+
+  //! Return the type of a given dimension (numeric or categorical).
+  Datatype Type(const size_t dimension) const
+  {
+    if (dimension >= types.size())
+    {
+      std::ostringstream oss;
+      oss << "requested type of dimension " << dimension << ", but dataset "
+          << "only has " << types.size() << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+
+    return types[dimension];
+  }
+
+  //! Modify the type of a given dimension (be careful!).
+  Datatype& Type(const size_t dimension)
+  {
+    if (dimension >= types.size())
+      types.resize(dimension + 1, Datatype::numeric);
+
+    return types[dimension];
+  }
+
+  /**
+   * Get the number of mappings for a particular dimension.  If the dimension
+   * is numeric, then this will return 0.
+   */
+  size_t NumMappings(const size_t dimension) const
+  {
+    return (dimension < maps.size()) ? maps[dimension].Size() : 0;
+  }
+
+  //! Get the dimensionality of the DatasetMapper object.
+  size_t Dimensionality() const { return types.size(); }
+
+  //! Get the map of the strings of the given dimension (it may be empty).
+  const CompactStringMap& Map(const size_t dimension) const
+  {
+    static const CompactStringMap empty;
+    return (dimension < maps.size()) ? maps[dimension] : empty;
+  }
+
+  //! Release the memory reserved by the maps for strings that were not added.
+  void ShrinkToFit()
+  {
+    for (size_t i = 0; i < maps.size(); ++i)
+      maps[i].ShrinkToFit();
+  }
+
+  /**
+   * Serialize the dataset information.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(types);
+    ar & BOOST_SERIALIZATION_NVP(maps);
+  }
+
+  //! Return the policy of the mapper.
+  const CompactIncrementPolicy& Policy() const { return policy; }
+  //! Modify the policy of the mapper (be careful!).
+  CompactIncrementPolicy& Policy() { return policy; }
+  //! Modify (Replace) the policy of the mapper with a new policy.
+  void Policy(CompactIncrementPolicy&& policy)
+  {
+    this->policy = std::forward<CompactIncrementPolicy>(policy);
+  }
+
+ private:
+  //! Get whether the given value is a mapping of the given dimension.
+  template<typename T>
+  bool IsMapping(const T value, const size_t dimension) const
+  {
+    // NaN fails all the comparisons.
+    const double code = (double) value;
+    return dimension < maps.size() && code >= 0.0 &&
+        code < (double) maps[dimension].Size() && code == std::floor(code);
+  }
+
+  //! Types of each dimension.
+  std::vector<Datatype> types;
+
+  //! The map of the strings of each dimension; dimensions past the end of the
+  //! vector have no mappings.
+  std::vector<CompactStringMap> maps;
+
+  //! The policy that maps the strings.
+  CompactIncrementPolicy policy;
+};
+
+//! A DatasetInfo that stores its mappings compactly.
+using CompactDatasetInfo = DatasetMapper<data::CompactIncrementPolicy>;
+
+} // namespace data
+} // namespace mlpack
+
+#endif
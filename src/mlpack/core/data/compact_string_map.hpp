@@ -0,0 +1,215 @@
+/**
+ * @file core/data/compact_string_map.hpp
+ *
+ * Definition of the CompactStringMap class, which maps many distinct strings to
+ * consecutive 32-bit codes with little memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COMPACT_STRING_MAP_HPP
+#define MLPACK_CORE_DATA_COMPACT_STRING_MAP_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The CompactStringMap class interns strings: each distinct string gets the
+ * next 32-bit code (0, 1, 2, ...), and the string of a code can be retrieved.
+ * Unlike a std::unordered_map<std::string, size_t> with a reverse
+ * std::vector<std::string>, which take two allocations and about 100 bytes of
+ * overhead per string, the strings are stored one after another in a single
+ * pool of characters with the offset of each one, and the codes are found with
+ * an open-addressing hash table of 32-bit codes (with linear probing), for
+ * about 8 + 6 bytes of overhead per string.  The pool and the offsets are
+ * serialized as two contiguous blocks; the hash table is rebuilt on loading.
+ *
+ * @code
+ * CompactStringMap map;
+ * const uint32_t code = map.Insert("some id"); // 0.
+ * map.Find("some id"); // Returns 0.
+ * map.Find("other id"); // Returns CompactStringMap::NotFound.
+ * map.String(code); // Returns "some id".
+ * @endcode
+ */
+class CompactStringMap
+{
+ public:
+  //! The code returned by Find() for strings that are not in the map.
+  static constexpr uint32_t NotFound = std::numeric_limits<uint32_t>::max();
+
+  //! Create an empty map.
+  CompactStringMap() : offsets(1, 0), numStrings(0) { }
+
+  /**
+   * Get the code of the given string, or NotFound if it isn't in the map.
+   *
+   * @param str String to look for.
+   */
+  uint32_t Find(const boost::string_view str) const
+  {
+    if (slots.empty())
+      return NotFound;
+
+    const size_t mask = slots.size() - 1;
+    for (size_t slot = Slot(Hash(str)); ; slot = (slot + 1) & mask)
+    {
+      const uint32_t code = slots[slot];
+      if (code == NotFound || String(code) == str)
+        return code;
+    }
+  }
+
+  /**
+   * Get the code of the given string, adding it to the map with the next code
+   * if it isn't in the map yet.  Throws std::length_error if the map already
+   * holds the maximum number of strings (2^32 - 1).
+   *
+   * @param str String to look for or add.
+   */
+  uint32_t Insert(const boost::string_view str)
+  {
+    // Keep the load factor of the table under 3/4.
+    if (4 * (numStrings + 1) > 3 * slots.size())
+      Rehash(std::max((size_t) 16, 2 * slots.size()));
+
+    const size_t mask = slots.size() - 1;
+    size_t slot = Slot(Hash(str));
+    for (; slots[slot] != NotFound; slot = (slot + 1) & mask)
+    {
+      if (String(slots[slot]) == str)
+        return slots[slot];
+    }
+
+    if (numStrings == NotFound)
+    {
+      throw std::length_error("CompactStringMap::Insert(): cannot hold more "
+          "than 2^32 - 1 strings");
+    }
+
+    pool.insert(pool.end(), str.begin(), str.end());
+    offsets.push_back(pool.size());
+    slots[slot] = (uint32_t) numStrings;
+    return (uint32_t) numStrings++;
+  }
+
+  /**
+   * Get the string of the given code, which must be less than Size().  The
+   * view is valid until the next call to Insert().
+   *
+   * @param code Code of the string.
+   */
+  boost::string_view String(const uint32_t code) const
+  {
+    return boost::string_view(pool.data() + offsets[code],
+        offsets[code + 1] - offsets[code]);
+  }
+
+  //! Get the number of strings in the map.
+  size_t Size() const { return numStrings; }
+
+  //! Remove all the strings.
+  void Clear()
+  {
+    pool.clear();
+    offsets.assign(1, 0);
+    slots.clear();
+    numStrings = 0;
+  }
+
+  //! Release the memory reserved for strings that were not added.
+  void ShrinkToFit()
+  {
+    pool.shrink_to_fit();
+    offsets.shrink_to_fit();
+  }
+
+  //! Get the number of bytes used by the map (without the object itself).
+  size_t MemoryUsage() const
+  {
+    return pool.capacity() + offsets.capacity() * sizeof(uint64_t) +
+        slots.capacity() * sizeof(uint32_t);
+  }
+
+  /**
+   * Serialize the map: only the pool and the offsets are stored.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(pool);
+    ar & BOOST_SERIALIZATION_NVP(offsets);
+
+    if (Archive::is_loading::value)
+    {
+      if (offsets.empty() || offsets.back() != pool.size())
+      {
+        throw std::runtime_error("CompactStringMap::serialize(): the offsets "
+            "of the strings do not match the size of the pool");
+      }
+
+      numStrings = offsets.size() - 1;
+      size_t size = 16;
+      while (4 * numStrings > 3 * size)
+        size *= 2;
+      Rehash(numStrings == 0 ? 0 : size);
+    }
+  }
+
+ private:
+  //! Hash the given string (64-bit FNV-1a).
+  static uint64_t Hash(const boost::string_view str)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+      hash ^= (unsigned char) str[i];
+      hash *= 1099511628211ULL;
+    }
+
+    return hash;
+  }
+
+  //! Get the first slot of the given hash.
+  size_t Slot(const uint64_t hash) const
+  {
+    return (size_t) (hash ^ (hash >> 32)) & (slots.size() - 1);
+  }
+
+  //! Rebuild the table with the given number of slots (a power of 2).
+  void Rehash(const size_t size)
+  {
+    slots.assign(size, (uint32_t) NotFound);
+    if (size == 0)
+      return;
+
+    const size_t mask = size - 1;
+    for (size_t code = 0; code < numStrings; ++code)
+    {
+      size_t slot = Slot(Hash(String((uint32_t) code)));
+      while (slots[slot] != NotFound)
+        slot = (slot + 1) & mask;
+      slots[slot] = (uint32_t) code;
+    }
+  }
+
+  //! The characters of all the strings, one after another.
+  std::vector<char> pool;
+  //! The offset of each string in the pool, and the size of the pool.
+  std::vector<uint64_t> offsets;
+  //! The hash table: the code of the string in each slot, or NotFound.
+  std::vector<uint32_t> slots;
+  //! The number of strings.
+  size_t numStrings;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -200,4 +200,7 @@ using DatasetInfo = DatasetMapper<data::IncrementPolicy>;
 
 #include "dataset_mapper_impl.hpp"
 
+// Include the specialization for CompactIncrementPolicy.
+#include "compact_dataset_mapper.hpp"
+
 #endif
@@ -22,7 +22,9 @@ enum format
   autodetect,
   text,
   xml,
-  binary
+  binary,
+  fast_binary,
+  compressed_binary
 };
 
 } // namespace data
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_CUSTOM_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "missing_values.hpp"
 
 namespace mlpack {
 namespace data {
@@ -71,6 +72,29 @@ class CustomImputation
     }
   }
 
+  /**
+   * Replace the missing values of each of the given dimensions with the
+   * user-defined custom value, in parallel.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions of the mapped values.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::CheckImputationDimensions(input, mappedValues, dimensions,
+        columnMajor);
+
+    details::FillMissing(input, mappedValues, dimensions,
+        std::vector<double>(dimensions.size(), (double) customValue),
+        columnMajor);
+  }
+
  private:
   //! A user-defined value that the user wants to replace missing values with.
   T customValue;
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_LISTWISE_DELETION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "missing_values.hpp"
 
 namespace mlpack {
 namespace data {
@@ -66,6 +67,54 @@ class ListwiseDeletion
       input = input.rows(arma::uvec(colsToKeep));
     }
   }
+
+  /**
+   * Remove each point (column, or row if the input is not columnMajor) that
+   * has a missing value in any of the given dimensions.  The points are checked
+   * in parallel.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions of the mapped values.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::CheckImputationDimensions(input, mappedValues, dimensions,
+        columnMajor);
+
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<char> keep(numPoints, 1);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+    {
+      for (size_t d = 0; d < dimensions.size(); ++d)
+      {
+        const T value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (details::IsMissing(value, mappedValues[d]))
+        {
+          keep[i] = 0;
+          break;
+        }
+      }
+    }
+
+    std::vector<arma::uword> toKeep;
+    for (size_t i = 0; i < numPoints; ++i)
+      if (keep[i])
+        toKeep.push_back(i);
+
+    if (columnMajor)
+      input = input.cols(arma::uvec(toKeep));
+    else
+      input = input.rows(arma::uvec(toKeep));
+  }
 }; // class ListwiseDeletion
 
 } // namespace data
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MEAN_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "missing_values.hpp"
 
 namespace mlpack {
 namespace data {
@@ -96,6 +97,94 @@ class MeanImputation
       input(target.first, target.second) = mean;
     }
   }
+
+  /**
+   * Replace the missing values of each of the given dimensions with the mean
+   * of the dimension, in one pass over the input to compute all the means and
+   * one pass to replace the values.  Both passes are parallelized with OpenMP.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions of the mapped values.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::CheckImputationDimensions(input, mappedValues, dimensions,
+        columnMajor);
+
+    std::vector<double> sums(dimensions.size(), 0.0);
+    std::vector<size_t> elems(dimensions.size(), 0);
+    if (columnMajor)
+    {
+      // Each chunk of points is summed by one thread.
+      const size_t numChunks = details::ImputationChunks(input.n_cols);
+      std::vector<std::vector<double>> chunkSums(numChunks,
+          std::vector<double>(dimensions.size(), 0.0));
+      std::vector<std::vector<size_t>> chunkElems(numChunks,
+          std::vector<size_t>(dimensions.size(), 0));
+
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+      {
+        const size_t begin = c * input.n_cols / numChunks;
+        const size_t end = (c + 1) * input.n_cols / numChunks;
+        for (size_t i = begin; i < end; ++i)
+        {
+          for (size_t d = 0; d < dimensions.size(); ++d)
+          {
+            const T value = input(dimensions[d], i);
+            if (!details::IsMissing(value, mappedValues[d]))
+            {
+              chunkSums[c][d] += value;
+              ++chunkElems[c][d];
+            }
+          }
+        }
+      }
+
+      for (size_t c = 0; c < numChunks; ++c)
+      {
+        for (size_t d = 0; d < dimensions.size(); ++d)
+        {
+          sums[d] += chunkSums[c][d];
+          elems[d] += chunkElems[c][d];
+        }
+      }
+    }
+    else
+    {
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+      {
+        const T* column = input.colptr(dimensions[d]);
+        for (size_t i = 0; i < input.n_rows; ++i)
+        {
+          if (!details::IsMissing(column[i], mappedValues[d]))
+          {
+            sums[d] += column[i];
+            ++elems[d];
+          }
+        }
+      }
+    }
+
+    std::vector<double> means(dimensions.size());
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      if (elems[d] == 0)
+        Log::Fatal << "it is impossible to calculate mean; no valid elements in "
+            << "dimension " << dimensions[d] << std::endl;
+
+      means[d] = sums[d] / elems[d];
+    }
+
+    details::FillMissing(input, mappedValues, dimensions, means, columnMajor);
+  }
 }; // class MeanImputation
 
 } // namespace data
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MEDIAN_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "missing_values.hpp"
 
 namespace mlpack {
 namespace data {
@@ -85,6 +86,73 @@ class MedianImputation
        input(target.first, target.second) = median;
     }
   }
+
+  /**
+   * Replace the missing values of each of the given dimensions with the median
+   * of the dimension.  The medians of the dimensions are computed in parallel
+   * (each with a linear-time selection on the valid values of the dimension),
+   * then the values are replaced in parallel.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions of the mapped values.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::CheckImputationDimensions(input, mappedValues, dimensions,
+        columnMajor);
+
+    std::vector<double> medians(dimensions.size());
+    std::vector<char> empty(dimensions.size(), 0);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+      std::vector<double> elemsToKeep;
+      elemsToKeep.reserve(numPoints);
+      for (size_t i = 0; i < numPoints; ++i)
+      {
+        const T value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (!details::IsMissing(value, mappedValues[d]))
+          elemsToKeep.push_back(value);
+      }
+
+      if (elemsToKeep.empty())
+      {
+        empty[d] = 1;
+        continue;
+      }
+
+      // As arma::median(), take the average of the two middle values if there
+      // is an even number of values.
+      const size_t half = elemsToKeep.size() / 2;
+      std::nth_element(elemsToKeep.begin(), elemsToKeep.begin() + half,
+          elemsToKeep.end());
+      medians[d] = elemsToKeep[half];
+      if (elemsToKeep.size() % 2 == 0)
+      {
+        const double lower = *std::max_element(elemsToKeep.begin(),
+            elemsToKeep.begin() + half);
+        medians[d] = lower + (medians[d] - lower) / 2.0;
+      }
+    }
+
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      if (empty[d])
+        Log::Fatal << "it is impossible to calculate median; no valid elements "
+            << "in dimension " << dimensions[d] << std::endl;
+    }
+
+    details::FillMissing(input, mappedValues, dimensions, medians, columnMajor);
+  }
 }; // class MedianImputation
 
 } // namespace data
@@ -0,0 +1,138 @@
+/**
+ * @file core/data/imputation_methods/missing_values.hpp
+ *
+ * Utilities shared by the imputation strategies to find and replace the missing
+ * values of several dimensions at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MISSING_VALUES_HPP
+#define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MISSING_VALUES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! Return whether the given value is missing.
+template<typename T>
+inline bool IsMissing(const T& value, const T& mappedValue)
+{
+  return value == mappedValue || std::isnan(value);
+}
+
+/**
+ * Make sure that there is one mapped value per dimension, and that each
+ * dimension exists and is given once; otherwise, throw std::invalid_argument.
+ *
+ * @param input Matrix that contains the mapped values.
+ * @param mappedValues Value to get rid of, for each dimension.
+ * @param dimensions Indices of the dimensions.
+ * @param columnMajor Whether the dimensions are the rows of the input.
+ */
+template<typename T>
+void CheckImputationDimensions(const arma::Mat<T>& input,
+                               const std::vector<T>& mappedValues,
+                               const std::vector<size_t>& dimensions,
+                               const bool columnMajor)
+{
+  if (mappedValues.size() != dimensions.size())
+  {
+    std::ostringstream oss;
+    oss << "Impute(): " << mappedValues.size() << " mapped values were given "
+        << "for " << dimensions.size() << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t numDimensions = columnMajor ? input.n_rows : input.n_cols;
+  for (size_t d = 0; d < dimensions.size(); ++d)
+  {
+    if (dimensions[d] >= numDimensions)
+    {
+      std::ostringstream oss;
+      oss << "Impute(): dimension " << dimensions[d] << " does not exist; the "
+          << "input has " << numDimensions << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  std::vector<size_t> sorted(dimensions);
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+    throw std::invalid_argument("Impute(): a dimension was given twice");
+}
+
+/**
+ * Get the number of chunks to split the points into to process them in
+ * parallel.
+ */
+inline size_t ImputationChunks(const size_t numPoints)
+{
+  #ifdef HAS_OPENMP
+  return std::max((size_t) 1, std::min((size_t) omp_get_max_threads(),
+      numPoints));
+  #else
+  (void) numPoints;
+  return 1;
+  #endif
+}
+
+/**
+ * Replace the missing values of each of the given dimensions with the given
+ * value of the dimension.  The points are processed in parallel if the
+ * dimensions are the rows of the input, and the dimensions are processed in
+ * parallel otherwise, so that each thread reads contiguous memory.
+ *
+ * @param input Matrix that contains the mapped values.
+ * @param mappedValues Value to get rid of, for each dimension.
+ * @param dimensions Indices of the dimensions.
+ * @param values Value to replace the missing values of each dimension with.
+ * @param columnMajor Whether the dimensions are the rows of the input.
+ */
+template<typename T>
+void FillMissing(arma::Mat<T>& input,
+                 const std::vector<T>& mappedValues,
+                 const std::vector<size_t>& dimensions,
+                 const std::vector<double>& values,
+                 const bool columnMajor)
+{
+  if (columnMajor)
+  {
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t d = 0; d < dimensions.size(); ++d)
+      {
+        if (IsMissing(input(dimensions[d], i), mappedValues[d]))
+          input(dimensions[d], i) = values[d];
+      }
+    }
+  }
+  else
+  {
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      T* column = input.colptr(dimensions[d]);
+      for (size_t i = 0; i < input.n_rows; ++i)
+      {
+        if (IsMissing(column[i], mappedValues[d]))
+          column[i] = values[d];
+      }
+    }
+  }
+}
+
+} // namespace details
+} // namespace data
+} // namespace mlpack
+
+#endif
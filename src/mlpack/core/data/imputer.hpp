@@ -65,6 +65,31 @@ class Imputer
     strategy.Impute(input, mappedValue, dimension, columnMajor);
   }
 
+  /**
+  * Given an input dataset, replace missing values of all the given dimensions
+  * with given imputation strategy, at once.  The strategies of mlpack compute
+  * the statistics of all the dimensions in one pass over the input, and
+  * replace the values in parallel, so this is much faster than calling
+  * Impute() for each dimension.  The strategy must implement the overload of
+  * Impute() that takes a vector of mapped values and a vector of dimensions.
+  *
+  * @param input Input dataset to apply imputation.
+  * @param missingValue User defined missing value; it can be anything.
+  * @param dimensions Dimensions to apply the imputation to.
+  */
+  void Impute(arma::Mat<T>& input,
+              const std::string& missingValue,
+              const std::vector<size_t>& dimensions)
+  {
+    std::vector<T> mappedValues(dimensions.size());
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      mappedValues[i] = static_cast<T>(mapper.UnmapValue(missingValue,
+          dimensions[i]));
+    }
+    strategy.Impute(input, mappedValues, dimensions, columnMajor);
+  }
+
   //! Get the strategy.
   const StrategyType& Strategy() const { return strategy; }
 
@@ -41,11 +41,24 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack mapped matrix (see MappedMatrix), denoted by .mlpk
+ *  - Apache Parquet (see LoadParquet()), denoted by .parquet, if mlpack was
+ *    compiled with Apache Arrow support
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
  *
+ * A .mlpk file is not read, but memory-mapped: the matrix uses the mapped
+ * memory directly (see LoadMapped()), so loading takes no time, whatever the
+ * size of the matrix.  These files hold the matrix as it is in memory, so they
+ * are never transposed.
+ *
+ * Each row of a .parquet file is a point, as with the text formats.  Only
+ * numeric columns can be loaded by this overload; use the overload that takes
+ * a DatasetInfo to load string columns as categorical dimensions, or call
+ * LoadParquet() directly to read only some columns or some row groups.
+ *
  * If the parameter 'fatal' is set to true, a std::runtime_error exception will
  * be thrown if the matrix does not load successfully.  The parameter
  * 'transpose' controls whether or not the matrix is transposed after loading.
@@ -261,6 +274,13 @@ bool Load(const std::string& filename,
  * The DatasetMapper object passed to this function will be re-created, so any
  * mappings from previous loads will be lost.
  *
+ * A .mlpk file (see MappedMatrix) is memory-mapped, without transposing it,
+ * and the DatasetInfo stored with the matrix is restored; only DatasetInfo
+ * objects can be used with these files.
+ *
+ * The string columns of a .parquet file are loaded as categorical dimensions
+ * (see LoadParquet()).
+ *
  * @param filename Name of file to load.
  * @param matrix Matrix to load contents of file into.
  * @param info DatasetMapper object to populate with mappings and data types.
@@ -332,9 +352,20 @@ extern template bool Load<double, IncrementPolicy>(
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - fast binary, denoted by .mlb
+ *  - compressed fast binary, denoted by .mlbz
+ *
+ * The fast binary formats hold a boost binary archive after a header with the
+ * version of the format, and are read and written through large buffers, with
+ * the memory of matrices copied in bulk; they are much faster than the text
+ * and xml formats for large models.  The compressed format compresses the
+ * archive with zstd, and is only available if mlpack was compiled with zstd
+ * support (the USE_ZSTD CMake option).  Like binary files, fast binary files
+ * are not portable between platforms.
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary',
+ * 'format::fast_binary', and 'format::compressed_binary'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -387,12 +418,86 @@ bool Load(const std::vector<std::string>& files,
           ImageInfo& info,
           const bool fatal = false);
 
+/**
+ * How LoadImageBatch() fits the images to the size given by the ImageInfo.
+ */
+enum ImageResizeMode
+{
+  //! The images must already have the given size.
+  NoResize,
+  //! The images are resized to the given size, ignoring their aspect ratio.
+  StretchResize,
+  //! The largest centered window of each image with the aspect ratio of the
+  //! given size is resized to the given size.
+  CenterCropResize
+};
+
+/**
+ * Load a batch of image files into the columns of the given matrix, in
+ * parallel when mlpack is compiled with OpenMP.  Each image is decoded,
+ * resized if needed, and normalized straight into its column, so memory is
+ * only needed for the output (and one decoded image per thread).
+ *
+ * The size of the images is given by info.Width() and info.Height(); if either
+ * is 0, the size of the first image is used.  Each image is loaded with
+ * info.Channels() channels (1 to 4: gray, gray and alpha, RGB, or RGBA),
+ * whatever the number of channels of the file.  The pixels are stored in the
+ * same order as with Load(), and each value is normalized to
+ *
+ *   (scale * pixel - mean[channel]) / stddev[channel],
+ *
+ * where the mean and the standard deviation can be left empty (no centering
+ * or no scaling).
+ *
+ * @param files Names of the image files.
+ * @param matrix Matrix to load the images into, one image per column.
+ * @param info Size and number of channels of the images.
+ * @param resizeMode How to fit the images that have another size.
+ * @param scale Factor to multiply the pixel values by.
+ * @param mean Value to subtract from each channel (empty, or one per channel).
+ * @param stddev Value to divide each channel by (empty, or one per channel).
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadImageBatch(const std::vector<std::string>& files,
+                    arma::Mat<eT>& matrix,
+                    ImageInfo& info,
+                    const ImageResizeMode resizeMode = NoResize,
+                    const double scale = 1.0,
+                    const arma::vec& mean = arma::vec(),
+                    const arma::vec& stddev = arma::vec(),
+                    const bool fatal = false);
+
 // Implementation found in load_image.cpp.
 bool LoadImage(const std::string& filename,
                arma::Mat<unsigned char>& matrix,
                ImageInfo& info,
                const bool fatal = false);
 
+/**
+ * Load one image file into the given buffer, which must hold info.Width() *
+ * info.Height() * info.Channels() values, resizing it if needed.  This does
+ * not log anything, so that it can be called from many threads; in case of
+ * failure, false is returned and the reason is given in the error string.
+ * Implementation found in load_image.cpp.
+ */
+bool LoadImage(const std::string& filename,
+               unsigned char* buffer,
+               const ImageInfo& info,
+               const ImageResizeMode resizeMode,
+               std::string& error);
+
+/**
+ * Read the size of an image file without decoding it.  In case of failure,
+ * false is returned and the reason is given in the error string.
+ * Implementation found in load_image.cpp.
+ */
+bool ReadImageSize(const std::string& filename,
+                   size_t& width,
+                   size_t& height,
+                   std::string& error);
+
 } // namespace data
 } // namespace mlpack
 
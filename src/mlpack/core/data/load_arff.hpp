@@ -54,6 +54,43 @@ void LoadARFF(const std::string& filename,
               arma::Mat<eT>& matrix,
               DatasetMapper<PolicyType>& info);
 
+/**
+ * Read the header of an ARFF file from the given stream, up to and including
+ * the @data line, and set up the given DatasetInfo object with the types of the
+ * dimensions and the categories that the header lists, as LoadARFF() does.
+ * This is used to read the @data section one line at a time.
+ *
+ * @param ifs Stream to read the header from.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing.
+ * @param categoryStrings Filled with the categories listed by the header for
+ *     each dimension that lists them.
+ * @param headerLines Set to the number of lines of the header.
+ */
+template<typename eT, typename PolicyType>
+void LoadARFFHeader(std::istream& ifs,
+                    DatasetMapper<PolicyType>& info,
+                    std::map<size_t, std::vector<std::string>>& categoryStrings,
+                    size_t& headerLines);
+
+/**
+ * Parse one (trimmed) line of the @data section of an ARFF file into the given
+ * column, using the types and the categories given by LoadARFFHeader().  An
+ * exception is thrown if the line can't be parsed.
+ *
+ * @param line Line to parse.
+ * @param lineNumber Number of the line in the file, for error messages.
+ * @param info DatasetInfo object set up by LoadARFFHeader().
+ * @param categoryStrings Categories given by LoadARFFHeader().
+ * @param column Memory to write the Dimensionality() values of the line to.
+ */
+template<typename eT, typename PolicyType>
+void LoadARFFDataLine(
+    const std::string& line,
+    const size_t lineNumber,
+    DatasetMapper<PolicyType>& info,
+    const std::map<size_t, std::vector<std::string>>& categoryStrings,
+    eT* column);
+
 } // namespace data
 } // namespace mlpack
 
@@ -22,27 +22,16 @@ namespace mlpack {
 namespace data {
 
 template<typename eT, typename PolicyType>
-void LoadARFF(const std::string& filename,
-              arma::Mat<eT>& matrix,
-              DatasetMapper<PolicyType>& info)
+void LoadARFFHeader(std::istream& ifs,
+                    DatasetMapper<PolicyType>& info,
+                    std::map<size_t, std::vector<std::string>>& categoryStrings,
+                    size_t& headerLines)
 {
-  // First, open the file.
-  std::ifstream ifs;
-  ifs.open(filename, std::ios::in | std::ios::binary);
-
-  // if file is not open throw an error (file not found).
-  if (!ifs.is_open())
-  {
-    Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
-  }
-
+  categoryStrings.clear();
   std::string line;
   size_t dimensionality = 0;
-  // We'll store a vector of strings representing categories to be mapped, if
-  // needed.
-  std::map<size_t, std::vector<std::string>> categoryStrings;
   std::vector<bool> types;
-  size_t headerLines = 0;
+  headerLines = 0;
   while (ifs.good())
   {
     // Read the next line, then strip whitespace from either side.
@@ -175,6 +164,118 @@ void LoadARFF(const std::string& filename,
       info.template MapString<eT>(str, (*it).first);
     }
   }
+}
+
+template<typename eT, typename PolicyType>
+void LoadARFFDataLine(
+    const std::string& line,
+    const size_t lineNumber,
+    DatasetMapper<PolicyType>& info,
+    const std::map<size_t, std::vector<std::string>>& categoryStrings,
+    eT* column)
+{
+  // Tokenize the line.
+  typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+  boost::escaped_list_separator<char> sep("\\", ",", "\"");
+  Tokenizer tok(line, sep);
+
+  size_t col = 0;
+  std::stringstream token;
+  for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+  {
+    // Check that we are not too many columns in.
+    if (col >= info.Dimensionality())
+    {
+      std::stringstream error;
+      error << "Too many columns in line " << lineNumber << ".";
+      throw std::runtime_error(error.str());
+    }
+
+    // What should this token be?
+    if (info.Type(col) == Datatype::categorical)
+    {
+      // Strip spaces before mapping.
+      std::string token = *it;
+      boost::trim(token);
+      const size_t currentNumMappings = info.NumMappings(col);
+      const eT result = info.template MapString<eT>(token, col);
+
+      // If the set of categories was pre-specified, then we must crash if
+      // this was not one of those categories.
+      if (categoryStrings.count(col) > 0 &&
+          currentNumMappings < info.NumMappings(col))
+      {
+        std::stringstream error;
+        error << "Parse error at line " << lineNumber << " token "
+            << col << ": category \"" << token << "\" not in the set of known"
+            << " categories for this dimension (";
+        for (size_t i = 0; i < categoryStrings.at(col).size() - 1; ++i)
+          error << "\"" << categoryStrings.at(col)[i] << "\", ";
+        error << "\"" << categoryStrings.at(col).back() << "\").";
+        throw std::runtime_error(error.str());
+      }
+
+      column[col] = result;
+    }
+    else if (info.Type(col) == Datatype::numeric)
+    {
+      // Attempt to read as numeric.
+      token.clear();
+      token.str(*it);
+
+      eT val = eT(0);
+      token >> val;
+
+      if (token.fail())
+      {
+        // Check for NaN or inf.
+        if (!IsNaNInf(val, token.str()))
+        {
+          // Okay, it's not NaN or inf.  If it's '?', we issue a specific
+          // error, otherwise we issue a general error.
+          std::stringstream error;
+          std::string tokenStr = token.str();
+          boost::trim(tokenStr);
+          if (tokenStr == "?")
+            error << "Missing values ('?') not supported, ";
+          else
+            error << "Parse error ";
+          error << "at line " << lineNumber << " token " << col
+              << ": \"" << tokenStr << "\".";
+          throw std::runtime_error(error.str());
+        }
+      }
+
+      // If we made it to here, we have a value.
+      column[col] = val;
+    }
+
+    ++col;
+  }
+}
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  // First, open the file.
+  std::ifstream ifs;
+  ifs.open(filename, std::ios::in | std::ios::binary);
+
+  // if file is not open throw an error (file not found).
+  if (!ifs.is_open())
+  {
+    Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+  }
+
+  std::string line;
+  // We'll store a vector of strings representing categories to be mapped, if
+  // needed.
+  std::map<size_t, std::vector<std::string>> categoryStrings;
+  size_t headerLines = 0;
+  LoadARFFHeader<eT>(ifs, info, categoryStrings, headerLines);
+  const size_t dimensionality = info.Dimensionality();
 
   // We need to find out how many lines of data are in the file.
   std::streampos pos = ifs.tellg();
@@ -211,85 +312,8 @@ void LoadARFF(const std::string& filename,
     if (line[0] == '{')
       throw std::runtime_error("cannot yet parse sparse ARFF data");
 
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
-
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
-    {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
-      {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
-      }
-
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
-      {
-        // Strip spaces before mapping.
-        std::string token = *it;
-        boost::trim(token);
-        const size_t currentNumMappings = info.NumMappings(col);
-        const eT result = info.template MapString<eT>(token, col);
-
-        // If the set of categories was pre-specified, then we must crash if
-        // this was not one of those categories.
-        if (categoryStrings.count(col) > 0 &&
-            currentNumMappings < info.NumMappings(col))
-        {
-          std::stringstream error;
-          error << "Parse error at line " << (headerLines + row) << " token "
-              << col << ": category \"" << token << "\" not in the set of known"
-              << " categories for this dimension (";
-          for (size_t i = 0; i < categoryStrings.at(col).size() - 1; ++i)
-            error << "\"" << categoryStrings.at(col)[i] << "\", ";
-          error << "\"" << categoryStrings.at(col).back() << "\").";
-          throw std::runtime_error(error.str());
-        }
-
-        // We load transposed.
-        matrix(col, row) = result;
-      }
-      else if (info.Type(col) == Datatype::numeric)
-      {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
-
-        eT val = eT(0);
-        token >> val;
-
-        if (token.fail())
-        {
-          // Check for NaN or inf.
-          if (!IsNaNInf(val, token.str()))
-          {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
-          }
-        }
-
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
-      }
-
-      ++col;
-    }
+    LoadARFFDataLine(line, headerLines + row, info, categoryStrings,
+        matrix.colptr(row));
     ++row;
   }
 }
@@ -12,6 +12,13 @@
  */
 #include "load_csv.hpp"
 
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 using namespace boost::spirit;
 
 namespace mlpack {
@@ -71,6 +78,98 @@ LoadCSV::LoadCSV(const std::string& file) :
   }
 }
 
+LoadCSV::FileContents::FileContents(const std::string& filename) :
+    data(NULL),
+    size(0),
+    mapping(NULL)
+{
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  struct stat fileInfo;
+  if (fd >= 0 && fstat(fd, &fileInfo) == 0 && fileInfo.st_size > 0)
+  {
+    size = (size_t) fileInfo.st_size;
+    mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      mapping = NULL;
+    }
+    else
+    {
+      #ifdef MADV_SEQUENTIAL
+      madvise(mapping, size, MADV_SEQUENTIAL);
+      #endif
+      data = static_cast<const char*>(mapping);
+    }
+  }
+  if (fd >= 0)
+    close(fd);
+
+  if (mapping != NULL)
+    return;
+#endif
+
+  // The file could not be mapped, so read it into memory instead.
+  std::ifstream stream(filename, std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.seekg(0, std::ios::end);
+  buffer.resize((size_t) stream.tellg());
+  stream.seekg(0, std::ios::beg);
+  stream.read(buffer.data(), buffer.size());
+
+  data = buffer.data();
+  size = buffer.size();
+}
+
+LoadCSV::FileContents::~FileContents()
+{
+#ifndef _WIN32
+  if (mapping != NULL)
+    munmap(mapping, size);
+#endif
+}
+
+bool LoadCSV::NextLine(std::vector<std::string>& values)
+{
+  std::string line;
+  if (!std::getline(inFile, line))
+    return false;
+
+  // Remove whitespace from either side.
+  boost::trim(line);
+
+  values.clear();
+  auto addValue = [&values](const iter_type& iter)
+  {
+    std::string str(iter.begin(), iter.end());
+    boost::trim(str);
+    values.push_back(std::move(str));
+  };
+
+  const bool canParse = qi::parse(line.begin(), line.end(),
+      stringRule[addValue] % delimiterRule);
+  if (!canParse)
+  {
+    std::ostringstream oss;
+    oss << "LoadCSV::NextLine(): parsing error on line '" << line << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  return true;
+}
+
+void LoadCSV::Rewind()
+{
+  inFile.clear();
+  inFile.seekg(0, std::ios::beg);
+}
+
 void LoadCSV::CheckOpen()
 {
   if (!inFile.is_open())
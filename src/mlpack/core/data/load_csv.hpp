@@ -24,6 +24,7 @@
 #include "extension.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "map_policies/increment_policy.hpp"
 
 namespace mlpack {
 namespace data {
@@ -46,24 +47,50 @@ class LoadCSV
    * Load the file into the given matrix with the given DatasetMapper object.
    * Throws exceptions on errors.
    *
+   * When the DatasetMapper uses IncrementPolicy (as DatasetInfo does) or
+   * CompactIncrementPolicy, the file is first loaded by a faster parser that
+   * memory-maps it, splits it into chunks of lines, and parses the chunks in
+   * parallel.  The result is
+   * the same as with the boost::spirit parser, which is used for the other
+   * policies, and for the files the fast parser does not handle (quoted
+   * fields, and malformed files, so that errors are reported the same way).
+   *
    * @param inout Matrix to load into.
    * @param infoSet DatasetMapper to use while loading.
    * @param transpose If true, the matrix should be transposed on loading
    *     (default).
+   * @param parallel If false, only the boost::spirit parser is used.
    */
   template<typename T, typename PolicyType>
   void Load(arma::Mat<T> &inout,
             DatasetMapper<PolicyType> &infoSet,
-            const bool transpose = true)
+            const bool transpose = true,
+            const bool parallel = true)
   {
     CheckOpen();
 
+    if (parallel && ParallelParse(inout, infoSet, transpose))
+      return;
+
     if (transpose)
       TransposeParse(inout, infoSet);
     else
       NonTransposeParse(inout, infoSet);
   }
 
+  /**
+   * Read the next line of the file and split it into its (trimmed) values, with
+   * the same rules as Load(), so that a file can be read one line at a time.
+   * Throws std::runtime_error if the line can't be parsed.
+   *
+   * @param values Filled with the values of the line.
+   * @return false if the end of the file was reached.
+   */
+  bool NextLine(std::vector<std::string>& values);
+
+  //! Go back to the start of the file, so that NextLine() reads the first line.
+  void Rewind();
+
   /**
    * Peek at the file to determine the number of rows and columns in the matrix,
    * assuming a non-transposed matrix.  This will also take a first pass over
@@ -207,6 +234,129 @@ class LoadCSV
  private:
   using iter_type = boost::iterator_range<std::string::iterator>;
 
+  /**
+   * The contents of a file, memory-mapped when possible, and read into memory
+   * otherwise.
+   */
+  class FileContents
+  {
+   public:
+    //! Map (or read) the given file; throws std::runtime_error on failure.
+    FileContents(const std::string& filename);
+
+    //! Unmap the file.
+    ~FileContents();
+
+    //! The contents can't be copied.
+    FileContents(const FileContents&) = delete;
+    //! The contents can't be copied.
+    FileContents& operator=(const FileContents&) = delete;
+
+    //! Get the contents of the file.
+    const char* Data() const { return data; }
+    //! Get the size of the file.
+    size_t Size() const { return size; }
+
+   private:
+    //! The contents of the file.
+    const char* data;
+    //! The size of the file.
+    size_t size;
+    //! The mapping of the file, if it was mapped.
+    void* mapping;
+    //! The contents of the file, if it could not be mapped.
+    std::vector<char> buffer;
+  };
+
+  /**
+   * The parallel parser can only be used with IncrementPolicy (and
+   * CompactIncrementPolicy), whose mappings can be reproduced from the tokens
+   * found by each thread; for other policies this does nothing and returns
+   * false.
+   */
+  template<typename T, typename PolicyType>
+  bool ParallelParse(arma::Mat<T>& /* inout */,
+                     DatasetMapper<PolicyType>& /* infoSet */,
+                     const bool /* transpose */)
+  {
+    return false;
+  }
+
+  /**
+   * Parse the file in parallel: the file is memory-mapped and split into one
+   * chunk of whole lines per thread.  Each thread parses the numbers of its
+   * lines straight into the matrix, and notes the dimensions that hold values
+   * that are not numbers.  Then, if there are any, the values of those
+   * (categorical) dimensions are collected by each thread in the order they
+   * are found, and passed to the DatasetMapper one chunk after another, so the
+   * mappings are the same as if the file was parsed by a single thread.
+   *
+   * Returns false (and leaves the DatasetMapper untouched) if the file can't be
+   * handled by this parser: if it holds quotes, carriage returns inside lines,
+   * or lines with the wrong number of values.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to load with.
+   * @param transpose If true, the matrix should be transposed on loading.
+   */
+  template<typename T>
+  bool ParallelParse(arma::Mat<T>& inout,
+                     DatasetMapper<IncrementPolicy>& infoSet,
+                     const bool transpose)
+  {
+    return ParallelIncrementParse(inout, infoSet, transpose);
+  }
+
+  /**
+   * Parse the file in parallel, as for IncrementPolicy; CompactIncrementPolicy
+   * gives the same mappings.
+   */
+  template<typename T>
+  bool ParallelParse(arma::Mat<T>& inout,
+                     DatasetMapper<CompactIncrementPolicy>& infoSet,
+                     const bool transpose)
+  {
+    return ParallelIncrementParse(inout, infoSet, transpose);
+  }
+
+  //! The parallel parser for IncrementPolicy and CompactIncrementPolicy.
+  template<typename T, typename PolicyType>
+  bool ParallelIncrementParse(arma::Mat<T>& inout,
+                              DatasetMapper<PolicyType>& infoSet,
+                              const bool transpose);
+
+  /**
+   * Split the given line into its (trimmed) values, as the boost::spirit rules
+   * do, and call the given function with the index, start and end of each
+   * value.  Returns the number of values, or -1 if the line holds characters
+   * that only the boost::spirit parser handles.
+   *
+   * @param begin Start of the line.
+   * @param end End of the line (not including the newline).
+   * @param delimiter The delimiter of the values (',', '\t', or ' ' for runs of
+   *     spaces).
+   * @param f Function to call on each value.
+   */
+  template<typename FunctionType>
+  static long SplitLine(const char* begin,
+                        const char* end,
+                        const char delimiter,
+                        FunctionType&& f);
+
+  /**
+   * Convert the given value to a number, with the same result that a
+   * stringstream extraction would give.  Decimal numbers of up to 19
+   * significant digits with small exponents are converted without a
+   * stringstream, when T is float or double.  Returns false if the value is not
+   * a number.
+   *
+   * @param begin Start of the value.
+   * @param end End of the value.
+   * @param value The converted number.
+   */
+  template<typename T>
+  static bool ParseNumber(const char* begin, const char* end, T& value);
+
   /**
    * Check whether or not the file has successfully opened; throw an exception
    * if not.
@@ -373,4 +523,7 @@ class LoadCSV
 } // namespace data
 } // namespace mlpack
 
+// Include implementation of the parallel parser.
+#include "load_csv_impl.hpp"
+
 #endif
@@ -0,0 +1,435 @@
+/**
+ * @file core/data/load_csv_impl.hpp
+ *
+ * Implementation of the parallel parser of LoadCSV.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_csv.hpp"
+
+#include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+//! The characters removed by boost::trim() (in the default locale).
+inline bool IsCSVSpace(const char c)
+{
+  return (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+      c == '\r');
+}
+
+template<typename T, typename PolicyType>
+bool LoadCSV::ParallelIncrementParse(arma::Mat<T>& inout,
+                                     DatasetMapper<PolicyType>& infoSet,
+                                     const bool transpose)
+{
+  // Mapping every value is done by the boost::spirit parser; the policy is
+  // only kept by the DatasetMapper in the transposed case.
+  if (transpose && infoSet.Policy().ForceAllMappings())
+    return false;
+
+  const FileContents file(filename);
+  const char* data = file.Data();
+  const size_t size = file.Size();
+  if (size == 0)
+    return false;
+
+  const char delimiter = (extension == "csv") ? ',' :
+      ((extension == "txt") ? ' ' : '\t');
+
+  // Calls f(begin, end) on each line in [begin, end), which must start at the
+  // start of a line; the lines are counted the same way std::getline() counts
+  // them.
+  auto forEachLine = [data, size](const size_t begin, const size_t end,
+      const std::function<void(const char*, const char*)>& f)
+  {
+    const char* p = data + begin;
+    const char* chunkEnd = data + end;
+    while (p < chunkEnd)
+    {
+      const char* lineEnd = static_cast<const char*>(
+          std::memchr(p, '\n', chunkEnd - p));
+      if (lineEnd == NULL)
+        lineEnd = chunkEnd;
+
+      f(p, lineEnd);
+      p = lineEnd + 1;
+    }
+  };
+
+  // The number of values of each line is given by the first line.
+  const char* firstLineEnd = static_cast<const char*>(
+      std::memchr(data, '\n', size));
+  const long numFieldsLong = SplitLine(data,
+      (firstLineEnd == NULL) ? data + size : firstLineEnd, delimiter,
+      [](const size_t, const char*, const char*) { });
+  if (numFieldsLong <= 0)
+    return false;
+  const size_t numFields = (size_t) numFieldsLong;
+
+  #ifdef HAS_OPENMP
+  const size_t numChunks = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), size));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  // Split the file into chunks of whole lines; a chunk starts right after a
+  // newline.  Some chunks may be empty.
+  std::vector<size_t> bounds(numChunks + 1, size);
+  bounds[0] = 0;
+  for (size_t c = 1; c < numChunks; ++c)
+  {
+    const size_t start = std::max(bounds[c - 1], c * size / numChunks);
+    const char* newline = static_cast<const char*>(
+        std::memchr(data + start, '\n', size - start));
+    bounds[c] = (newline == NULL) ? size : (size_t) (newline - data) + 1;
+  }
+
+  // Count the lines of each chunk, so that each chunk knows the index of its
+  // first line.
+  std::vector<size_t> lineOffsets(numChunks + 1, 0);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    size_t numLines = 0;
+    forEachLine(bounds[c], bounds[c + 1],
+        [&numLines](const char*, const char*) { ++numLines; });
+    lineOffsets[c + 1] = numLines;
+  }
+  for (size_t c = 0; c < numChunks; ++c)
+    lineOffsets[c + 1] += lineOffsets[c];
+  const size_t numLines = lineOffsets[numChunks];
+
+  // The dimensions are the values of each line when transposing, and the
+  // lines otherwise.
+  const size_t numDimensions = transpose ? numFields : numLines;
+  if (transpose)
+    inout.set_size(numFields, numLines);
+  else
+    inout.set_size(numLines, numFields);
+
+  // Parse the numbers straight into the matrix, and find the dimensions with
+  // values that are not numbers.  When transposing, each chunk keeps its own
+  // flags; otherwise each line (dimension) belongs to a single chunk.
+  std::vector<std::vector<char>> chunkCategorical(transpose ? numChunks : 1,
+      std::vector<char>(numDimensions, 0));
+  std::vector<char> chunkFailed(numChunks, 0);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    std::vector<char>& categorical = chunkCategorical[transpose ? c : 0];
+    size_t line = lineOffsets[c];
+    forEachLine(bounds[c], bounds[c + 1],
+        [&](const char* begin, const char* end)
+    {
+      if (chunkFailed[c])
+        return;
+
+      const long numValues = SplitLine(begin, end, delimiter,
+          [&](const size_t field, const char* valueBegin, const char* valueEnd)
+      {
+        if (field >= numFields)
+          return;
+
+        const size_t dim = transpose ? field : line;
+        T& value = transpose ? inout(field, line) : inout(line, field);
+        if (!ParseNumber(valueBegin, valueEnd, value))
+          categorical[dim] = 1;
+      });
+
+      // Leave the errors to the boost::spirit parser.
+      if (numValues != (long) numFields)
+        chunkFailed[c] = 1;
+
+      ++line;
+    });
+  }
+
+  for (size_t c = 0; c < numChunks; ++c)
+    if (chunkFailed[c])
+      return false;
+
+  std::vector<char>& categorical = chunkCategorical[0];
+  for (size_t c = 1; c < chunkCategorical.size(); ++c)
+    for (size_t d = 0; d < numDimensions; ++d)
+      categorical[d] |= chunkCategorical[c][d];
+
+  // Initialize the DatasetMapper as the boost::spirit parser does.
+  if (transpose)
+    infoSet.SetDimensionality(numDimensions);
+  else
+    infoSet = DatasetMapper<PolicyType>(numDimensions);
+
+  bool anyCategorical = false;
+  for (size_t d = 0; d < numDimensions; ++d)
+  {
+    if (categorical[d])
+    {
+      infoSet.Type(d) = Datatype::categorical;
+      anyCategorical = true;
+    }
+  }
+
+  if (!anyCategorical)
+    return true;
+
+  // Every value of a categorical dimension is mapped.  Each chunk collects the
+  // distinct values of each categorical dimension in the order they are
+  // found, and the positions of the values in the matrix.
+  typedef std::unordered_map<boost::string_view, size_t,
+      boost::hash<boost::string_view>> ValueMap;
+  std::vector<std::vector<std::pair<size_t, boost::string_view>>>
+      chunkValues(numChunks);
+  std::vector<std::vector<std::pair<size_t, size_t>>> chunkPositions(
+      numChunks);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    std::unordered_map<size_t, ValueMap> ids;
+    size_t line = lineOffsets[c];
+    forEachLine(bounds[c], bounds[c + 1],
+        [&](const char* begin, const char* end)
+    {
+      // When not transposing, the whole line is a single dimension.
+      if (!transpose && !categorical[line])
+      {
+        ++line;
+        return;
+      }
+
+      SplitLine(begin, end, delimiter,
+          [&](const size_t field, const char* valueBegin, const char* valueEnd)
+      {
+        const size_t dim = transpose ? field : line;
+        if (!categorical[dim])
+          return;
+
+        const boost::string_view value(valueBegin, valueEnd - valueBegin);
+        ValueMap& dimIds = ids[dim];
+        ValueMap::const_iterator it = dimIds.find(value);
+        size_t id;
+        if (it == dimIds.end())
+        {
+          id = chunkValues[c].size();
+          dimIds[value] = id;
+          chunkValues[c].push_back(std::make_pair(dim, value));
+        }
+        else
+        {
+          id = it->second;
+        }
+
+        const size_t position = transpose ? field + line * numFields :
+            line + field * numLines;
+        chunkPositions[c].push_back(std::make_pair(position, id));
+      });
+
+      ++line;
+    });
+  }
+
+  // Map the values one chunk after another, so the mappings are the same as
+  // with a single thread.
+  std::vector<std::vector<T>> chunkMappings(numChunks);
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    chunkMappings[c].resize(chunkValues[c].size());
+    for (size_t j = 0; j < chunkValues[c].size(); ++j)
+    {
+      const boost::string_view value = chunkValues[c][j].second;
+      chunkMappings[c][j] = infoSet.template MapString<T>(
+          std::string(value.data(), value.size()), chunkValues[c][j].first);
+    }
+  }
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    for (size_t j = 0; j < chunkPositions[c].size(); ++j)
+    {
+      inout[chunkPositions[c][j].first] =
+          chunkMappings[c][chunkPositions[c][j].second];
+    }
+  }
+
+  return true;
+}
+
+template<typename FunctionType>
+long LoadCSV::SplitLine(const char* begin,
+                        const char* end,
+                        const char delimiter,
+                        FunctionType&& f)
+{
+  // Remove whitespace from either side.
+  while (begin < end && IsCSVSpace(*begin))
+    ++begin;
+  while (end > begin && IsCSVSpace(*(end - 1)))
+    --end;
+
+  long numValues = 0;
+  const char* valueBegin = begin;
+  for (const char* p = begin; ; ++p)
+  {
+    if (p == end || *p == delimiter)
+    {
+      // The values are trimmed too.
+      const char* valueEnd = p;
+      while (valueBegin < valueEnd && IsCSVSpace(*valueBegin))
+        ++valueBegin;
+      while (valueEnd > valueBegin && IsCSVSpace(*(valueEnd - 1)))
+        --valueEnd;
+
+      f((size_t) numValues++, valueBegin, valueEnd);
+      if (p == end)
+        break;
+
+      // Any number of spaces separates the values of a text file.
+      if (delimiter == ' ')
+      {
+        while (p + 1 < end && *(p + 1) == ' ')
+          ++p;
+      }
+
+      valueBegin = p + 1;
+    }
+    else if (*p == '"' || *p == '\'' || *p == '\r' ||
+        (delimiter == ' ' && *p == ','))
+    {
+      // Quoted values and carriage returns are left to boost::spirit, and so
+      // are commas in text files, where they stop the parse of the line.
+      return -1;
+    }
+  }
+
+  return numValues;
+}
+
+template<typename T>
+bool LoadCSV::ParseNumber(const char* begin, const char* end, T& value)
+{
+  if (std::is_same<T, double>::value || std::is_same<T, float>::value)
+  {
+    // Read [+-]digits[.digits][(e|E)[+-]digits] as an integer mantissa and a
+    // power of ten.  If the mantissa and the power of ten are both exact in T,
+    // a single multiplication or division rounds correctly (this is Clinger's
+    // fast path), giving the same result as a stringstream.
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+      negative = (*(p++) == '-');
+
+    uint64_t mantissa = 0;
+    size_t significantDigits = 0;
+    long exponent = 0;
+    bool anyDigits = false;
+    bool fastPath = true;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+    {
+      anyDigits = true;
+      if (mantissa == 0 && *p == '0')
+        continue;
+      if (++significantDigits > 19)
+        fastPath = false;
+      mantissa = 10 * mantissa + (*p - '0');
+    }
+
+    if (p < end && *p == '.')
+    {
+      for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
+      {
+        anyDigits = true;
+        --exponent;
+        if (mantissa == 0 && *p == '0')
+          continue;
+        if (++significantDigits > 19)
+          fastPath = false;
+        mantissa = 10 * mantissa + (*p - '0');
+      }
+    }
+
+    if (anyDigits && p < end && (*p == 'e' || *p == 'E'))
+    {
+      ++p;
+      bool negativeExponent = false;
+      if (p < end && (*p == '+' || *p == '-'))
+        negativeExponent = (*(p++) == '-');
+
+      long exponentValue = 0;
+      size_t exponentDigits = 0;
+      for (; p < end && *p >= '0' && *p <= '9'; ++p)
+      {
+        if (++exponentDigits > 6)
+          fastPath = false;
+        else
+          exponentValue = 10 * exponentValue + (*p - '0');
+      }
+
+      if (exponentDigits == 0)
+        fastPath = false;
+      exponent += negativeExponent ? -exponentValue : exponentValue;
+    }
+
+    if (fastPath && anyDigits && p == end)
+    {
+      static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+          1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+          1e18, 1e19, 1e20, 1e21, 1e22 };
+      const uint64_t maxMantissa = std::is_same<T, double>::value ?
+          (uint64_t(1) << 53) : (uint64_t(1) << 24);
+      const long maxExponent = std::is_same<T, double>::value ? 22 : 10;
+
+      if (mantissa == 0)
+      {
+        value = negative ? -T(0) : T(0);
+        return true;
+      }
+
+      if (mantissa <= maxMantissa && exponent >= -maxExponent &&
+          exponent <= maxExponent)
+      {
+        T result = T(mantissa);
+        if (exponent < 0)
+          result /= T(powers[-exponent]);
+        else
+          result *= T(powers[exponent]);
+
+        value = negative ? -result : result;
+        return true;
+      }
+    }
+  }
+
+  // Attempt to convert the value via a stringstream, as IncrementPolicy does.
+  std::stringstream token;
+  token << std::string(begin, end);
+  T val;
+  token >> val;
+
+  if (token.fail() || !token.eof())
+    return false;
+
+  value = val;
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -20,6 +20,7 @@
 #define STB_IMAGE_IMPLEMENTATION
 
 #include <stb_image.h>
+#include <cstring>
 
 namespace mlpack {
 namespace data {
@@ -96,6 +97,136 @@ bool LoadImage(const std::string& filename,
   return true;
 }
 
+/**
+ * Resize the given interleaved image to the size given by the ImageInfo with
+ * bilinear interpolation.  With CenterCropResize, the largest window of the
+ * source image with the aspect ratio of the output is used, centered.
+ */
+static void ResizeImage(const unsigned char* image,
+                        const size_t width,
+                        const size_t height,
+                        const size_t channels,
+                        unsigned char* output,
+                        const ImageInfo& info,
+                        const ImageResizeMode resizeMode)
+{
+  const size_t outWidth = info.Width();
+  const size_t outHeight = info.Height();
+
+  // The window of the source image that covers the output.
+  double windowWidth = (double) width;
+  double windowHeight = (double) height;
+  if (resizeMode == CenterCropResize)
+  {
+    const double ratio = std::min((double) width / outWidth,
+        (double) height / outHeight);
+    windowWidth = ratio * outWidth;
+    windowHeight = ratio * outHeight;
+  }
+  const double x0 = (width - windowWidth) / 2.0;
+  const double y0 = (height - windowHeight) / 2.0;
+  const double xStep = windowWidth / outWidth;
+  const double yStep = windowHeight / outHeight;
+
+  for (size_t y = 0; y < outHeight; ++y)
+  {
+    // Sample at the centers of the output pixels.
+    const double sy = std::min(std::max(y0 + (y + 0.5) * yStep - 0.5, 0.0),
+        (double) (height - 1));
+    const size_t y1 = (size_t) sy;
+    const size_t y2 = std::min(y1 + 1, height - 1);
+    const double fy = sy - y1;
+
+    for (size_t x = 0; x < outWidth; ++x)
+    {
+      const double sx = std::min(std::max(x0 + (x + 0.5) * xStep - 0.5, 0.0),
+          (double) (width - 1));
+      const size_t x1 = (size_t) sx;
+      const size_t x2 = std::min(x1 + 1, width - 1);
+      const double fx = sx - x1;
+
+      for (size_t c = 0; c < channels; ++c)
+      {
+        const double top = (1 - fx) * image[(y1 * width + x1) * channels + c] +
+            fx * image[(y1 * width + x2) * channels + c];
+        const double bottom = (1 - fx) *
+            image[(y2 * width + x1) * channels + c] +
+            fx * image[(y2 * width + x2) * channels + c];
+        output[(y * outWidth + x) * channels + c] =
+            (unsigned char) std::lround((1 - fy) * top + fy * bottom);
+      }
+    }
+  }
+}
+
+bool LoadImage(const std::string& filename,
+               unsigned char* buffer,
+               const ImageInfo& info,
+               const ImageResizeMode resizeMode,
+               std::string& error)
+{
+  if (!ImageFormatSupported(filename))
+  {
+    error = "file type " + Extension(filename) + " not supported";
+    return false;
+  }
+
+  int width, height, fileChannels;
+  unsigned char* image = stbi_load(filename.c_str(), &width, &height,
+      &fileChannels, (int) info.Channels());
+  if (!image)
+  {
+    error = stbi_failure_reason();
+    return false;
+  }
+
+  const size_t dimension = info.Width() * info.Height() * info.Channels();
+  if ((size_t) width == info.Width() && (size_t) height == info.Height())
+  {
+    std::memcpy(buffer, image, dimension);
+  }
+  else if (resizeMode == NoResize)
+  {
+    std::ostringstream oss;
+    oss << "image is " << width << " x " << height << ", but " << info.Width()
+        << " x " << info.Height() << " was expected";
+    error = oss.str();
+    free(image);
+    return false;
+  }
+  else
+  {
+    ResizeImage(image, width, height, info.Channels(), buffer, info,
+        resizeMode);
+  }
+
+  free(image);
+  return true;
+}
+
+bool ReadImageSize(const std::string& filename,
+                   size_t& width,
+                   size_t& height,
+                   std::string& error)
+{
+  if (!ImageFormatSupported(filename))
+  {
+    error = "file type " + Extension(filename) + " not supported";
+    return false;
+  }
+
+  int tempWidth, tempHeight, tempChannels;
+  if (!stbi_info(filename.c_str(), &tempWidth, &tempHeight, &tempChannels))
+  {
+    error = stbi_failure_reason();
+    return false;
+  }
+
+  width = tempWidth;
+  height = tempHeight;
+  return true;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -123,6 +254,27 @@ bool LoadImage(const std::string& /* filename */,
   return false;
 }
 
+bool LoadImage(const std::string& /* filename */,
+               unsigned char* /* buffer */,
+               const ImageInfo& /* info */,
+               const ImageResizeMode /* resizeMode */,
+               std::string& error)
+{
+  error = "mlpack was not compiled with STB support, so images cannot be "
+      "loaded";
+  return false;
+}
+
+bool ReadImageSize(const std::string& /* filename */,
+                   size_t& /* width */,
+                   size_t& /* height */,
+                   std::string& error)
+{
+  error = "mlpack was not compiled with STB support, so images cannot be "
+      "loaded";
+  return false;
+}
+
 } // namespace data
 } // namespace mlpack
 
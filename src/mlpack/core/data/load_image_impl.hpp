@@ -1,96 +1,192 @@
-/**
+/**
  * @file core/data/load_image_impl.hpp
- * @author Mehul Kumar Nirala
- *
- * An image loading utility implementation.
- *
- * mlpack is free software; you may redistribute it and/or modify it under the
- * terms of the 3-clause BSD license.  You should have received a copy of the
- * 3-clause BSD license along with mlpack.  If not, see
- * http://www.opensource.org/licenses/BSD-3-Clause for more information.
- */
-
-#ifndef MLPACK_CORE_DATA_LOAD_IMAGE_IMPL_HPP
-#define MLPACK_CORE_DATA_LOAD_IMAGE_IMPL_HPP
-
-// In case it hasn't been included yet.
-#include "load.hpp"
-
-namespace mlpack {
-namespace data {
-
-// Image loading API.
-template<typename eT>
-bool Load(const std::string& filename,
-          arma::Mat<eT>& matrix,
-          ImageInfo& info,
-          const bool fatal)
-{
-  Timer::Start("loading_image");
-
-  // STB loads into unsigned char matrices, so we may have to convert once
-  // loaded.
-  arma::Mat<unsigned char> tempMatrix;
-  const bool result = LoadImage(filename, tempMatrix, info, fatal);
-
-  // If fatal is true, then the program will have already thrown an exception.
-  if (!result)
-  {
-    Timer::Stop("loading_image");
-    return false;
-  }
-
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tempMatrix);
-  Timer::Stop("loading_image");
-  return true;
-}
-
-// Image loading API for multiple files.
-template<typename eT>
-bool Load(const std::vector<std::string>& files,
-          arma::Mat<eT>& matrix,
-          ImageInfo& info,
-          const bool fatal)
-{
-  if (files.size() == 0)
-  {
-    std::ostringstream oss;
-    oss << "Load(): vector of image files is empty." << std::endl;
-
-    if (fatal)
-      Log::Fatal << oss.str();
-    else
-      Log::Warn << oss.str();
-
-    return false;
-  }
-
-  arma::Mat<unsigned char> img;
-  bool status = LoadImage(files[0], img, info, fatal);
-
-  if (!status)
-    return false;
-
-  // Decide matrix dimension using the image height and width.
-  arma::Mat<unsigned char> tmpMatrix(
-      info.Width() * info.Height() * info.Channels(), files.size());
-  tmpMatrix.col(0) = img;
-
-  for (size_t i = 1; i < files.size() ; ++i)
-  {
-    arma::Mat<unsigned char> colImg(tmpMatrix.colptr(i), tmpMatrix.n_rows, 1,
-        false, true);
-    status = LoadImage(files[i], colImg, info, fatal);
-
-    if (!status)
-      return false;
-  }
-
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tmpMatrix);
-  return true;
-}
-
-} // namespace data
-} // namespace mlpack
-
-#endif
+ * @author Mehul Kumar Nirala
+ *
+ * An image loading utility implementation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_CORE_DATA_LOAD_IMAGE_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_IMAGE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load.hpp"
+
+namespace mlpack {
+namespace data {
+
+// Image loading API.
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const bool fatal)
+{
+  Timer::Start("loading_image");
+
+  // STB loads into unsigned char matrices, so we may have to convert once
+  // loaded.
+  arma::Mat<unsigned char> tempMatrix;
+  const bool result = LoadImage(filename, tempMatrix, info, fatal);
+
+  // If fatal is true, then the program will have already thrown an exception.
+  if (!result)
+  {
+    Timer::Stop("loading_image");
+    return false;
+  }
+
+  matrix = arma::conv_to<arma::Mat<eT>>::from(tempMatrix);
+  Timer::Stop("loading_image");
+  return true;
+}
+
+// Image loading API for multiple files.
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const bool fatal)
+{
+  // The images must all have the size of the first one, and are loaded in
+  // grayscale or RGB.
+  info.Width() = 0;
+  info.Height() = 0;
+  if (info.Channels() != 1)
+    info.Channels() = 3;
+
+  return LoadImageBatch(files, matrix, info, NoResize, 1.0, arma::vec(),
+      arma::vec(), fatal);
+}
+
+template<typename eT>
+bool LoadImageBatch(const std::vector<std::string>& files,
+                    arma::Mat<eT>& matrix,
+                    ImageInfo& info,
+                    const ImageResizeMode resizeMode,
+                    const double scale,
+                    const arma::vec& mean,
+                    const arma::vec& stddev,
+                    const bool fatal)
+{
+  std::ostringstream oss;
+  if (files.size() == 0)
+  {
+    oss << "Load(): vector of image files is empty." << std::endl;
+  }
+  else if (info.Channels() == 0 || info.Channels() > 4)
+  {
+    oss << "LoadImageBatch(): images can have 1 to 4 channels, not "
+        << info.Channels() << "." << std::endl;
+  }
+  else if ((mean.n_elem != 0 && mean.n_elem != info.Channels()) ||
+           (stddev.n_elem != 0 && stddev.n_elem != info.Channels()))
+  {
+    oss << "LoadImageBatch(): the mean and the standard deviation must be "
+        << "empty or have one value per channel (" << info.Channels() << ")."
+        << std::endl;
+  }
+
+  // Take the size of the first image, if no size was given.
+  std::string error;
+  if (oss.str().empty() && (info.Width() == 0 || info.Height() == 0) &&
+      !ReadImageSize(files[0], info.Width(), info.Height(), error))
+  {
+    oss << "Load(): failed to load image '" << files[0] << "': " << error
+        << std::endl;
+  }
+
+  if (!oss.str().empty())
+  {
+    if (fatal)
+      Log::Fatal << oss.str();
+    else
+      Log::Warn << oss.str();
+
+    return false;
+  }
+
+  Timer::Start("loading_image");
+
+  const size_t channels = info.Channels();
+  const size_t dimension = info.Width() * info.Height() * channels;
+  matrix.set_size(dimension, files.size());
+
+  // Unsigned char images can be decoded right into the matrix when they are
+  // not normalized.
+  const bool direct = std::is_same<eT, unsigned char>::value &&
+      scale == 1.0 && mean.n_elem == 0 && stddev.n_elem == 0;
+
+  // The first image that could not be loaded, if any.
+  size_t failed = files.size();
+
+  #pragma omp parallel
+  {
+    std::vector<unsigned char> buffer(direct ? 0 : dimension);
+    std::string imageError;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) files.size(); ++i)
+    {
+      unsigned char* pixels = direct ? (unsigned char*) matrix.colptr(i) :
+          buffer.data();
+      if (!LoadImage(files[i], pixels, info, resizeMode, imageError))
+      {
+        #pragma omp critical
+        {
+          if ((size_t) i < failed)
+          {
+            failed = i;
+            error = imageError;
+          }
+        }
+        continue;
+      }
+
+      if (!direct)
+      {
+        eT* column = matrix.colptr(i);
+        for (size_t j = 0; j < dimension; ++j)
+        {
+          const size_t c = j % channels;
+          double value = scale * pixels[j];
+          if (mean.n_elem != 0)
+            value -= mean[c];
+          if (stddev.n_elem != 0)
+            value /= stddev[c];
+          column[j] = (eT) value;
+        }
+      }
+    }
+  }
+
+  Timer::Stop("loading_image");
+
+  if (failed < files.size())
+  {
+    matrix.reset();
+    if (fatal)
+    {
+      Log::Fatal << "Load(): failed to load image '" << files[failed] << "': "
+          << error << std::endl;
+    }
+    else
+    {
+      Log::Warn << "Load(): failed to load image '" << files[failed] << "': "
+          << error << std::endl;
+    }
+
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
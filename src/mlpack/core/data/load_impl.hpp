@@ -27,6 +27,8 @@
 #include <boost/algorithm/string.hpp>
 
 #include "load_arff.hpp"
+#include "load_parquet.hpp"
+#include "mapped_matrix.hpp"
 
 namespace mlpack {
 namespace data {
@@ -114,6 +116,60 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  if (extension == "mlpk")
+  {
+    Log::Info << "Memory-mapping '" << filename << "'.  " << std::flush;
+    try
+    {
+      LoadMapped(filename, matrix);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols
+        << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+
+  if (extension == "parquet")
+  {
+    Log::Info << "Loading '" << filename << "' as Parquet data.  "
+        << std::flush;
+    try
+    {
+      LoadParquet(filename, matrix);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_cols << " x " << matrix.n_rows
+        << ".\n";
+    Timer::Stop("loading_data");
+
+    // Each row of the file is a point, so un-transpose if necessary.
+    if (!transpose)
+      return inplace_transpose(matrix, fatal);
+
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
@@ -362,6 +418,56 @@ bool Load(const std::string& filename,
       return false;
     }
   }
+  else if (extension == "mlpk")
+  {
+    Log::Info << "Memory-mapping '" << filename << "'.  " << std::flush;
+    try
+    {
+      LoadMapped(filename, matrix, info);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    // The matrix is never transposed.
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols
+        << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+  else if (extension == "parquet")
+  {
+    Log::Info << "Loading '" << filename << "' as Parquet data.  "
+        << std::flush;
+    try
+    {
+      LoadParquet(filename, matrix, info);
+
+      // Each row of the file is a point, so un-transpose if necessary.
+      if (!transpose)
+      {
+        Timer::Stop("loading_data");
+        return inplace_transpose(matrix, fatal);
+      }
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+  }
   else if (extension == "arff")
   {
     Log::Info << "Loading '" << filename << "' as ARFF dataset.  "
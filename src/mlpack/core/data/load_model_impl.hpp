@@ -19,6 +19,7 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "model_stream.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -49,6 +50,10 @@ bool Load(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "mlb")
+      f = format::fast_binary;
+    else if (extension == "mlbz")
+      f = format::compressed_binary;
     else
     {
       if (fatal)
@@ -62,6 +67,31 @@ bool Load(const std::string& filename,
     }
   }
 
+  // The fast binary formats read the file through their own stream buffer;
+  // whether the file is compressed is given by its header.
+  if (f == format::fast_binary || f == format::compressed_binary)
+  {
+    try
+    {
+      ModelInputBuffer buffer(filename);
+      boost::archive::binary_iarchive ar(buffer);
+      ar >> boost::serialization::make_nvp(name.c_str(), t);
+
+      return true;
+    }
+    catch (std::exception& e)
+    {
+      if (fatal)
+        Log::Fatal << "Unable to load object '" << name << "' from '"
+            << filename << "': " << e.what() << std::endl;
+      else
+        Log::Warn << "Unable to load object '" << name << "' from '"
+            << filename << "': " << e.what() << std::endl;
+
+      return false;
+    }
+  }
+
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
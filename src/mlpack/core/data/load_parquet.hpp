@@ -0,0 +1,98 @@
+/**
+ * @file core/data/load_parquet.hpp
+ *
+ * Load a dataset from an Apache Parquet file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_PARQUET_HPP
+#define MLPACK_CORE_DATA_LOAD_PARQUET_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A utility function to load a Parquet file as numeric features.  Each row of
+ * the file is a point, so the given matrix has one row per column of the file
+ * and one column per row of the file (as data::Load() gives with transpose =
+ * true).  Boolean, integer and floating-point columns are supported; a null
+ * value is loaded as NaN.  An exception is thrown if a column is of any other
+ * type; use the overload that takes a DatasetInfo to load string columns.
+ *
+ * Only the given columns are read, in the given order, so the other columns of
+ * the file are never decoded.  The rows can be streamed by reading a few row
+ * groups at a time (see ParquetNumRowGroups()).  When mlpack is compiled with
+ * OpenMP, the row groups are read in parallel.
+ *
+ * This is only available if mlpack was compiled with Apache Arrow support (the
+ * USE_ARROW CMake option); otherwise, std::runtime_error is thrown.
+ *
+ * @param filename Name of Parquet file to load.
+ * @param matrix Matrix to load data into.
+ * @param columns Names of the columns to read; if empty, all the columns are
+ *     read.
+ * @param firstRowGroup Index of the first row group to read.
+ * @param numRowGroups Number of row groups to read; 0 reads all the row groups
+ *     from firstRowGroup to the end of the file.
+ */
+template<typename eT>
+void LoadParquet(const std::string& filename,
+                 arma::Mat<eT>& matrix,
+                 const std::vector<std::string>& columns =
+                     std::vector<std::string>(),
+                 const size_t firstRowGroup = 0,
+                 const size_t numRowGroups = 0);
+
+/**
+ * A utility function to load a Parquet file as numeric and categorical
+ * features, using the DatasetInfo structure for mapping.  The numeric columns
+ * are loaded as with LoadParquet(filename, matrix); the string columns are
+ * categorical, and their values are mapped with the given DatasetInfo.  An
+ * exception will be thrown upon failure.
+ *
+ * As with LoadARFF(), a pre-existing DatasetInfo object can be passed in, but
+ * if its dimensionality does not match the number of columns read, a
+ * std::invalid_argument exception will be thrown.  Since the mappings are
+ * kept, the same DatasetInfo should be given when a file is read a few row
+ * groups at a time, or when a test set is loaded after a training set.
+ *
+ * @param filename Name of Parquet file to load.
+ * @param matrix Matrix to load data into.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing
+ *     from another call to LoadParquet().
+ * @param columns Names of the columns to read; if empty, all the columns are
+ *     read.
+ * @param firstRowGroup Index of the first row group to read.
+ * @param numRowGroups Number of row groups to read; 0 reads all the row groups
+ *     from firstRowGroup to the end of the file.
+ */
+template<typename eT, typename PolicyType>
+void LoadParquet(const std::string& filename,
+                 arma::Mat<eT>& matrix,
+                 DatasetMapper<PolicyType>& info,
+                 const std::vector<std::string>& columns =
+                     std::vector<std::string>(),
+                 const size_t firstRowGroup = 0,
+                 const size_t numRowGroups = 0);
+
+/**
+ * Get the number of row groups of the given Parquet file.  Throws
+ * std::runtime_error if the file can't be read.
+ *
+ * @param filename Name of Parquet file.
+ */
+inline size_t ParquetNumRowGroups(const std::string& filename);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_parquet_impl.hpp"
+
+#endif
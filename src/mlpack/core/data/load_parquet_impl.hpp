@@ -0,0 +1,475 @@
+/**
+ * @file core/data/load_parquet_impl.hpp
+ *
+ * Load a dataset from an Apache Parquet file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_PARQUET_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_PARQUET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_parquet.hpp"
+
+#ifdef HAS_ARROW
+  #include <arrow/api.h>
+  #include <arrow/io/file.h>
+  #include <arrow/util/config.h>
+  #include <parquet/arrow/reader.h>
+#endif
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+#ifdef HAS_ARROW
+
+//! Open the given Parquet file, throwing std::runtime_error on failure.
+inline std::unique_ptr<parquet::arrow::FileReader> OpenParquet(
+    const std::string& filename)
+{
+  arrow::Result<std::shared_ptr<arrow::io::ReadableFile>> file =
+      arrow::io::ReadableFile::Open(filename);
+  if (!file.ok())
+  {
+    throw std::runtime_error("Cannot open file '" + filename + "': " +
+        file.status().ToString());
+  }
+
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+#if ARROW_VERSION_MAJOR >= 19
+  arrow::Result<std::unique_ptr<parquet::arrow::FileReader>> result =
+      parquet::arrow::OpenFile(*file, arrow::default_memory_pool());
+  if (!result.ok())
+  {
+    throw std::runtime_error("Cannot read Parquet file '" + filename + "': " +
+        result.status().ToString());
+  }
+  reader = std::move(*result);
+#else
+  const arrow::Status status = parquet::arrow::OpenFile(*file,
+      arrow::default_memory_pool(), &reader);
+  if (!status.ok())
+  {
+    throw std::runtime_error("Cannot read Parquet file '" + filename + "': " +
+        status.ToString());
+  }
+#endif
+
+  // The row groups are read in parallel, so each reader uses one thread.
+  reader->set_use_threads(false);
+  return reader;
+}
+
+//! Return whether the given Arrow type is loaded as a numeric dimension.
+inline bool IsParquetNumeric(const arrow::DataType& type)
+{
+  switch (type.id())
+  {
+    case arrow::Type::BOOL:
+    case arrow::Type::INT8:
+    case arrow::Type::INT16:
+    case arrow::Type::INT32:
+    case arrow::Type::INT64:
+    case arrow::Type::UINT8:
+    case arrow::Type::UINT16:
+    case arrow::Type::UINT32:
+    case arrow::Type::UINT64:
+    case arrow::Type::FLOAT:
+    case arrow::Type::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//! Return whether the given Arrow type is loaded as a categorical dimension.
+inline bool IsParquetString(const arrow::DataType& type)
+{
+  if (type.id() == arrow::Type::DICTIONARY)
+  {
+    return IsParquetString(
+        *static_cast<const arrow::DictionaryType&>(type).value_type());
+  }
+
+  return (type.id() == arrow::Type::STRING ||
+          type.id() == arrow::Type::LARGE_STRING);
+}
+
+//! Copy the values of a numeric array, with the given stride.
+template<typename ArrowType, typename eT>
+void CopyParquetValues(const arrow::Array& array,
+                       eT* out,
+                       const size_t stride)
+{
+  typedef typename arrow::TypeTraits<ArrowType>::ArrayType ArrayType;
+  const ArrayType& values = static_cast<const ArrayType&>(array);
+  for (int64_t i = 0; i < values.length(); ++i)
+  {
+    out[i * stride] = values.IsNull(i) ? std::numeric_limits<eT>::quiet_NaN() :
+        (eT) values.Value(i);
+  }
+}
+
+//! Copy the values of a numeric column, with the given stride.
+template<typename eT>
+void CopyParquetColumn(const arrow::ChunkedArray& column,
+                       eT* out,
+                       const size_t stride)
+{
+  for (int c = 0; c < column.num_chunks(); ++c)
+  {
+    const arrow::Array& array = *column.chunk(c);
+    switch (array.type_id())
+    {
+      case arrow::Type::BOOL:
+        CopyParquetValues<arrow::BooleanType>(array, out, stride); break;
+      case arrow::Type::INT8:
+        CopyParquetValues<arrow::Int8Type>(array, out, stride); break;
+      case arrow::Type::INT16:
+        CopyParquetValues<arrow::Int16Type>(array, out, stride); break;
+      case arrow::Type::INT32:
+        CopyParquetValues<arrow::Int32Type>(array, out, stride); break;
+      case arrow::Type::INT64:
+        CopyParquetValues<arrow::Int64Type>(array, out, stride); break;
+      case arrow::Type::UINT8:
+        CopyParquetValues<arrow::UInt8Type>(array, out, stride); break;
+      case arrow::Type::UINT16:
+        CopyParquetValues<arrow::UInt16Type>(array, out, stride); break;
+      case arrow::Type::UINT32:
+        CopyParquetValues<arrow::UInt32Type>(array, out, stride); break;
+      case arrow::Type::UINT64:
+        CopyParquetValues<arrow::UInt64Type>(array, out, stride); break;
+      case arrow::Type::FLOAT:
+        CopyParquetValues<arrow::FloatType>(array, out, stride); break;
+      case arrow::Type::DOUBLE:
+        CopyParquetValues<arrow::DoubleType>(array, out, stride); break;
+      default:
+        throw std::runtime_error("unsupported column type " +
+            array.type()->ToString());
+    }
+
+    out += array.length() * stride;
+  }
+}
+
+//! Append the values of a string array; a null value is an empty string.
+template<typename ArrayType>
+void CopyParquetStrings(const arrow::Array& array,
+                        std::vector<std::string>& out)
+{
+  const ArrayType& values = static_cast<const ArrayType&>(array);
+  for (int64_t i = 0; i < values.length(); ++i)
+    out.push_back(values.IsNull(i) ? std::string() : values.GetString(i));
+}
+
+//! Append the values of a string or dictionary-encoded string array.
+inline void CopyParquetStrings(const arrow::Array& array,
+                               std::vector<std::string>& out)
+{
+  if (array.type_id() == arrow::Type::DICTIONARY)
+  {
+    const arrow::DictionaryArray& dictArray =
+        static_cast<const arrow::DictionaryArray&>(array);
+    std::vector<std::string> dictionary;
+    CopyParquetStrings(*dictArray.dictionary(), dictionary);
+    for (int64_t i = 0; i < dictArray.length(); ++i)
+    {
+      out.push_back(dictArray.IsNull(i) ? std::string() :
+          dictionary[dictArray.GetValueIndex(i)]);
+    }
+  }
+  else if (array.type_id() == arrow::Type::LARGE_STRING)
+  {
+    CopyParquetStrings<arrow::LargeStringArray>(array, out);
+  }
+  else
+  {
+    CopyParquetStrings<arrow::StringArray>(array, out);
+  }
+}
+
+/**
+ * Find the indices of the given columns in the schema of the file (all the
+ * columns if none are given).
+ */
+inline std::vector<int> ParquetColumnIndices(
+    const parquet::arrow::FileReader& reader,
+    const arrow::Schema& schema,
+    const std::vector<std::string>& columns,
+    const std::string& filename)
+{
+  // The row groups are read by leaf column index, which is the index of the
+  // field only if no field is nested.
+  if (reader.parquet_reader()->metadata()->num_columns() !=
+      schema.num_fields())
+  {
+    throw std::runtime_error("data::LoadParquet(): nested columns of '" +
+        filename + "' are not supported");
+  }
+
+  std::vector<int> indices;
+  if (columns.empty())
+  {
+    for (int i = 0; i < schema.num_fields(); ++i)
+      indices.push_back(i);
+  }
+  else
+  {
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+      const int index = schema.GetFieldIndex(columns[i]);
+      if (index == -1)
+      {
+        throw std::runtime_error("data::LoadParquet(): column '" + columns[i] +
+            "' not found in '" + filename + "'");
+      }
+
+      indices.push_back(index);
+    }
+  }
+
+  return indices;
+}
+
+#endif
+
+/**
+ * Load the given columns and row groups of a Parquet file.  If allowStrings is
+ * false, string columns are an error.
+ */
+template<typename eT, typename PolicyType>
+void LoadParquet(const std::string& filename,
+                 arma::Mat<eT>& matrix,
+                 DatasetMapper<PolicyType>& info,
+                 const std::vector<std::string>& columns,
+                 const size_t firstRowGroup,
+                 const size_t numRowGroups,
+                 const bool allowStrings)
+{
+#ifdef HAS_ARROW
+  std::unique_ptr<parquet::arrow::FileReader> reader = OpenParquet(filename);
+
+  std::shared_ptr<arrow::Schema> schema;
+  const arrow::Status status = reader->GetSchema(&schema);
+  if (!status.ok())
+  {
+    throw std::runtime_error("Cannot read the schema of '" + filename + "': " +
+        status.ToString());
+  }
+
+  const std::vector<int> indices = ParquetColumnIndices(*reader, *schema,
+      columns, filename);
+  const size_t dimensionality = indices.size();
+
+  // Find the type of each dimension.
+  std::vector<size_t> categoricalDims;
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    const std::shared_ptr<arrow::Field> field = schema->field(indices[d]);
+    if (IsParquetString(*field->type()) && allowStrings)
+    {
+      categoricalDims.push_back(d);
+    }
+    else if (!IsParquetNumeric(*field->type()))
+    {
+      throw std::runtime_error("data::LoadParquet(): column '" +
+          field->name() + "' of '" + filename + "' has unsupported type " +
+          field->type()->ToString());
+    }
+  }
+
+  // Reset the DatasetInfo object, if needed.
+  if (info.Dimensionality() == 0)
+  {
+    info = DatasetMapper<PolicyType>(dimensionality);
+  }
+  else if (info.Dimensionality() != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadParquet(): given DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but data has dimensionality "
+        << dimensionality;
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t d = 0; d < dimensionality; ++d)
+    info.Type(d) = Datatype::numeric;
+  for (size_t i = 0; i < categoricalDims.size(); ++i)
+    info.Type(categoricalDims[i]) = Datatype::categorical;
+
+  // Find the row groups to read, and where their rows go in the matrix.
+  const size_t totalRowGroups = (size_t) reader->num_row_groups();
+  if (firstRowGroup > totalRowGroups)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadParquet(): first row group " << firstRowGroup
+        << " is past the end of '" << filename << "', which has "
+        << totalRowGroups << " row groups";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t lastRowGroup = (numRowGroups == 0) ? totalRowGroups :
+      std::min(totalRowGroups, firstRowGroup + numRowGroups);
+  const size_t groups = lastRowGroup - firstRowGroup;
+
+  std::vector<size_t> offsets(groups + 1, 0);
+  for (size_t g = 0; g < groups; ++g)
+  {
+    offsets[g + 1] = offsets[g] + (size_t)
+        reader->parquet_reader()->metadata()->RowGroup(firstRowGroup + g)->
+        num_rows();
+  }
+
+  matrix.set_size(dimensionality, offsets[groups]);
+
+  // Each chunk of row groups is read by a reader of its own.  The numeric
+  // columns go straight into the matrix; the values of the categorical columns
+  // are kept, to be mapped in order afterwards.
+  #ifdef HAS_OPENMP
+  const size_t numChunks = std::max((size_t) 1, std::min(
+      (size_t) omp_get_max_threads(), groups));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  std::vector<std::vector<std::vector<std::string>>> strings(groups,
+      std::vector<std::vector<std::string>>(categoricalDims.size()));
+  std::vector<std::string> errors(numChunks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = c * groups / numChunks;
+    const size_t end = (c + 1) * groups / numChunks;
+    if (begin == end)
+      continue;
+
+    try
+    {
+      std::unique_ptr<parquet::arrow::FileReader> chunkReader =
+          OpenParquet(filename);
+
+      for (size_t g = begin; g < end; ++g)
+      {
+        std::shared_ptr<arrow::Table> table;
+        const arrow::Status readStatus = chunkReader->ReadRowGroup(
+            (int) (firstRowGroup + g), indices, &table);
+        if (!readStatus.ok())
+          throw std::runtime_error(readStatus.ToString());
+
+        if ((size_t) table->num_rows() != offsets[g + 1] - offsets[g])
+          throw std::runtime_error("row group has the wrong number of rows");
+
+        size_t cat = 0;
+        for (size_t d = 0; d < dimensionality; ++d)
+        {
+          const arrow::ChunkedArray& column = *table->column((int) d);
+          if (cat < categoricalDims.size() && categoricalDims[cat] == d)
+          {
+            std::vector<std::string>& values = strings[g][cat];
+            values.reserve(offsets[g + 1] - offsets[g]);
+            for (int k = 0; k < column.num_chunks(); ++k)
+              CopyParquetStrings(*column.chunk(k), values);
+            ++cat;
+          }
+          else if (offsets[g + 1] > offsets[g])
+          {
+            CopyParquetColumn(column, matrix.colptr(offsets[g]) + d,
+                dimensionality);
+          }
+        }
+      }
+    }
+    catch (std::exception& e)
+    {
+      std::ostringstream oss;
+      oss << "data::LoadParquet(): cannot read row groups "
+          << (firstRowGroup + begin) << " to " << (firstRowGroup + end - 1)
+          << " of '" << filename << "': " << e.what();
+      errors[c] = oss.str();
+    }
+  }
+
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    if (!errors[c].empty())
+      throw std::runtime_error(errors[c]);
+  }
+
+  // Map the categorical values in the order of the file, so that the mappings
+  // are the same as with a serial load.
+  for (size_t g = 0; g < groups; ++g)
+  {
+    for (size_t i = 0; i < categoricalDims.size(); ++i)
+    {
+      const size_t d = categoricalDims[i];
+      const std::vector<std::string>& values = strings[g][i];
+      for (size_t j = 0; j < values.size(); ++j)
+        matrix(d, offsets[g] + j) = info.template MapString<eT>(values[j], d);
+    }
+
+    // Release the strings of the row group as soon as they are mapped.
+    std::vector<std::vector<std::string>>().swap(strings[g]);
+  }
+#else
+  // Avoid warnings about unused parameters.
+  (void) matrix;
+  (void) info;
+  (void) columns;
+  (void) firstRowGroup;
+  (void) numRowGroups;
+  (void) allowStrings;
+
+  throw std::runtime_error("Cannot load '" + filename + "' as Parquet data: "
+      "mlpack was compiled without Apache Arrow support");
+#endif
+}
+
+} // namespace details
+
+template<typename eT>
+void LoadParquet(const std::string& filename,
+                 arma::Mat<eT>& matrix,
+                 const std::vector<std::string>& columns,
+                 const size_t firstRowGroup,
+                 const size_t numRowGroups)
+{
+  DatasetInfo info;
+  details::LoadParquet(filename, matrix, info, columns, firstRowGroup,
+      numRowGroups, false);
+}
+
+template<typename eT, typename PolicyType>
+void LoadParquet(const std::string& filename,
+                 arma::Mat<eT>& matrix,
+                 DatasetMapper<PolicyType>& info,
+                 const std::vector<std::string>& columns,
+                 const size_t firstRowGroup,
+                 const size_t numRowGroups)
+{
+  details::LoadParquet(filename, matrix, info, columns, firstRowGroup,
+      numRowGroups, true);
+}
+
+inline size_t ParquetNumRowGroups(const std::string& filename)
+{
+#ifdef HAS_ARROW
+  return (size_t) details::OpenParquet(filename)->num_row_groups();
+#else
+  throw std::runtime_error("Cannot read '" + filename + "' as Parquet data: "
+      "mlpack was compiled without Apache Arrow support");
+#endif
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file core/data/map_policies/compact_increment_policy.hpp
+ *
+ * Increment mapping policy for the compact DatasetMapper.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAP_POLICIES_COMPACT_INCREMENT_POLICY_HPP
+#define MLPACK_CORE_DATA_MAP_POLICIES_COMPACT_INCREMENT_POLICY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/map_policies/increment_policy.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * CompactIncrementPolicy maps strings to incrementing integers, exactly like
+ * IncrementPolicy, but the DatasetMapper that uses it stores the mappings of
+ * each dimension in a CompactStringMap instead of a pair of hash maps, with
+ * 32-bit codes.  This is meant for categorical dimensions with very many
+ * distinct values (such as identifiers), where the mappings of a DatasetInfo
+ * take much more memory than the data itself.
+ *
+ * @code
+ * arma::mat data;
+ * data::CompactDatasetInfo info;
+ * data::Load("events.csv", data, info);
+ * @endcode
+ */
+class CompactIncrementPolicy : public IncrementPolicy
+{
+ public:
+  CompactIncrementPolicy(const bool forceAllMappings = false) :
+      IncrementPolicy(forceAllMappings) { }
+
+  // typedef of MappedType
+  using MappedType = uint32_t;
+
+  /**
+   * Given the input and the dimension to which it belongs, and the maps and
+   * types given by the DatasetMapper class, returns its numeric mapping.  If no
+   * mapping yet exists, the input is added to the map of the given dimension.
+   *
+   * @tparam MapType Type of the vector of CompactStringMaps of the dimensions.
+   * @param input Input to find/create mapping for.
+   * @param dimension Index of the dimension of the input.
+   * @param maps Maps of the dimensions given by the DatasetMapper.
+   * @param types Vector containing the type information about each dimensions.
+   */
+  template<typename MapType, typename T>
+  T MapString(const std::string& input,
+              const size_t dimension,
+              MapType& maps,
+              std::vector<Datatype>& types)
+  {
+    // If we are in a categorical dimension we already know we need to map.
+    if (types[dimension] == Datatype::numeric && !ForceAllMappings())
+    {
+      // Check if this input needs to be mapped or if it can be read directly
+      // as a number.
+      std::stringstream token;
+      token << input;
+      T val;
+      token >> val;
+
+      if (!token.fail() && token.eof())
+        return val;
+
+      // Otherwise, we must map.
+    }
+
+    if (dimension >= maps.size())
+      maps.resize(dimension + 1);
+
+    const size_t numMappings = maps[dimension].Size();
+    const uint32_t code = maps[dimension].Insert(input);
+
+    // Change type of the feature to categorical on the first mapping.
+    if (numMappings == 0)
+      types[dimension] = Datatype::categorical;
+
+    return T(code);
+  }
+}; // class CompactIncrementPolicy
+
+} // namespace data
+} // namespace mlpack
+
+#endif
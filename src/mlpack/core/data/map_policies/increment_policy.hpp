@@ -142,6 +142,9 @@ class IncrementPolicy
     }
   }
 
+  //! Get whether all tokens are mapped, even if they can be read as numbers.
+  bool ForceAllMappings() const { return forceAllMappings; }
+
  private:
   // Whether or not we should map all tokens.
   bool forceAllMappings;
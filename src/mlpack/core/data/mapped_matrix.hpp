@@ -0,0 +1,203 @@
+/**
+ * @file core/data/mapped_matrix.hpp
+ *
+ * Definition of the MappedMatrix class, which memory-maps a dense matrix that
+ * was written to disk in a raw, binary layout.  Any number of processes can map
+ * the same file, so they share a single copy of the matrix in the page cache.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A dense matrix that is memory-mapped from a file.  The file holds a small
+ * header (with the element type and the dimensions of the matrix), optionally
+ * followed by a serialized DatasetInfo with the types and the mappings of the
+ * dimensions, and then by the elements of the matrix in column-major order,
+ * starting at a page boundary.  It is written with MappedMatrix::Save(), or
+ * with data::Save() and the extension .mlpk; data::Load() maps these files
+ * instead of reading them (see LoadMapped()).
+ *
+ * The file is mapped privately: the pages are shared with every other process
+ * that maps the same file until they are written to, and writes are never
+ * carried back to the file.  Because of this, the matrix can be used through
+ * an Armadillo alias:
+ *
+ * @code
+ * data::MappedMatrix<double>::Save("dataset.bin", dataset);
+ *
+ * data::MappedMatrix<double> mapped("dataset.bin");
+ * arma::mat alias;
+ * mapped.Alias(alias);
+ * @endcode
+ *
+ * The MappedMatrix must outlive every alias of its memory.  Errors are reported
+ * by throwing std::runtime_error.  Memory mapping is only available on POSIX
+ * systems.
+ *
+ * @tparam eT Type of the elements of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  /**
+   * Memory-map the matrix stored in the given file.
+   *
+   * @param filename File written by MappedMatrix::Save().
+   */
+  MappedMatrix(const std::string& filename);
+
+  //! Unmap the file.
+  ~MappedMatrix();
+
+  //! A MappedMatrix cannot be copied.
+  MappedMatrix(const MappedMatrix& other) = delete;
+  //! A MappedMatrix cannot be copied.
+  MappedMatrix& operator=(const MappedMatrix& other) = delete;
+
+  /**
+   * Write the given matrix to the given file, in the layout expected by the
+   * MappedMatrix constructor.  An existing file will be overwritten; note that
+   * this must not be done while the file is mapped.
+   *
+   * @param filename File to write the matrix to.
+   * @param matrix Matrix to write.
+   */
+  static void Save(const std::string& filename, const arma::Mat<eT>& matrix);
+
+  /**
+   * Write the given matrix to the given file, along with the given DatasetInfo,
+   * which is restored when the file is mapped.  An existing file will be
+   * overwritten; note that this must not be done while the file is mapped.
+   *
+   * @param filename File to write the matrix to.
+   * @param matrix Matrix to write.
+   * @param info Types and mappings of the dimensions of the matrix.
+   */
+  static void Save(const std::string& filename,
+                   const arma::Mat<eT>& matrix,
+                   const DatasetInfo& info);
+
+  /**
+   * Make the given matrix an alias of the mapped memory.  Any memory the
+   * matrix owned is released.
+   *
+   * @param matrix Matrix to turn into an alias.
+   */
+  void Alias(arma::Mat<eT>& matrix);
+
+  /**
+   * Turn the given alias of mapped memory back into an empty matrix.  The
+   * mapped memory itself is not affected.
+   *
+   * @param matrix Alias to clear.
+   */
+  static void Unalias(arma::Mat<eT>& matrix);
+
+  //! Get the name of the mapped file.
+  const std::string& Filename() const { return filename; }
+  //! Get the number of rows of the mapped matrix.
+  size_t NRows() const { return nRows; }
+  //! Get the number of columns of the mapped matrix.
+  size_t NCols() const { return nCols; }
+  //! Get a pointer to the elements of the mapped matrix.
+  eT* Memory() const { return memory; }
+  //! Get whether the file holds a DatasetInfo.
+  bool HasInfo() const { return hasInfo; }
+  //! Get the DatasetInfo held by the file (if HasInfo() is true).
+  const DatasetInfo& Info() const { return info; }
+
+ private:
+  //! Write the matrix, and the DatasetInfo if it is given.
+  static void Save(const std::string& filename,
+                   const arma::Mat<eT>& matrix,
+                   const DatasetInfo* info);
+
+  //! The size of the header of the file; the DatasetInfo follows it.
+  static const size_t headerSize = 64;
+
+  //! The name of the mapped file.
+  std::string filename;
+  //! The start of the mapping.
+  void* mapping;
+  //! The length of the mapping, in bytes.
+  size_t mappingSize;
+  //! The number of rows of the matrix.
+  size_t nRows;
+  //! The number of columns of the matrix.
+  size_t nCols;
+  //! The elements of the matrix (inside the mapping).
+  eT* memory;
+  //! Whether the file holds a DatasetInfo.
+  bool hasInfo;
+  //! The DatasetInfo held by the file.
+  DatasetInfo info;
+};
+
+/**
+ * Memory-map the given file, written by MappedMatrix::Save(), and make the
+ * given matrix use the mapped memory, without copying it.  The matrix behaves
+ * like any other matrix: if it is resized, it gets memory of its own, and
+ * writing to it never changes the file.  The mapping is kept until
+ * ReleaseMapped() is called on the matrix (or the program exits); a mapping the
+ * matrix used before is released.
+ *
+ * Throws std::runtime_error if the file can't be mapped.
+ *
+ * @param filename File to map.
+ * @param matrix Matrix to make use of the mapped memory.
+ */
+template<typename eT>
+void LoadMapped(const std::string& filename, arma::Mat<eT>& matrix);
+
+/**
+ * Memory-map the given file, like LoadMapped(filename, matrix), and restore the
+ * DatasetInfo stored with the matrix.  If the file holds no DatasetInfo, all
+ * the dimensions are numeric.
+ *
+ * @param filename File to map.
+ * @param matrix Matrix to make use of the mapped memory.
+ * @param info DatasetInfo to restore.
+ */
+template<typename eT>
+void LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                DatasetInfo& info);
+
+/**
+ * Only a DatasetInfo can be stored in a mapped matrix file, so this throws
+ * std::invalid_argument.
+ */
+template<typename eT, typename PolicyType>
+void LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                DatasetMapper<PolicyType>& info);
+
+/**
+ * Release the mapping used by the given matrix, which must have been given to
+ * LoadMapped() and still use the mapped memory; the matrix is left empty.
+ * Returns false (and leaves the matrix alone) otherwise.
+ *
+ * @param matrix Matrix using mapped memory.
+ */
+template<typename eT>
+bool ReleaseMapped(arma::Mat<eT>& matrix);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
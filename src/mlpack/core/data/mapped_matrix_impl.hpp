@@ -0,0 +1,381 @@
+/**
+ * @file core/data/mapped_matrix_impl.hpp
+ *
+ * Implementation of the MappedMatrix class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+namespace mlpack {
+namespace data {
+
+namespace mapped_matrix_detail {
+
+//! The magic string at the start of the mapped matrix files of the first
+//! version, which had no element type, DatasetInfo or data offset.
+static const char magic[8] = { 'M', 'L', 'P', 'K', 'M', 'A', 'P', '1' };
+//! The magic string at the start of the mapped matrix files.
+static const char magicV2[8] = { 'M', 'L', 'P', 'K', 'M', 'A', 'P', '2' };
+
+//! The header of a mapped matrix file.  The first version of the format ends
+//! after nCols.
+struct Header
+{
+  char magic[8];
+  uint64_t elemSize;
+  uint64_t nRows;
+  uint64_t nCols;
+  uint64_t elemType;
+  uint64_t dataOffset;
+  uint64_t infoSize;
+};
+
+//! Get the code of the element type: the kind of number ('f', 'i' or 'u')
+//! followed by its size in bytes.
+template<typename eT>
+uint64_t ElemType()
+{
+  const uint64_t kind = std::is_floating_point<eT>::value ? 'f' :
+      (std::is_signed<eT>::value ? 'i' : 'u');
+  return (kind << 8) | sizeof(eT);
+}
+
+//! Get the alignment of the elements in the file.
+inline size_t PageSize()
+{
+#ifndef _WIN32
+  const long pageSize = sysconf(_SC_PAGESIZE);
+  if (pageSize > 0)
+    return (size_t) pageSize;
+#endif
+  return 4096;
+}
+
+//! The matrices given to LoadMapped(), and their mappings.
+template<typename eT>
+struct Registry
+{
+  std::mutex mutex;
+  std::map<const eT*, std::unique_ptr<MappedMatrix<eT>>> mappings;
+
+  static Registry& Get()
+  {
+    static Registry registry;
+    return registry;
+  }
+};
+
+} // namespace mapped_matrix_detail
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename) :
+    filename(filename),
+    mapping(NULL),
+    mappingSize(0),
+    nRows(0),
+    nCols(0),
+    memory(NULL),
+    hasInfo(false)
+{
+#ifdef _WIN32
+  throw std::runtime_error("MappedMatrix: memory-mapping '" + filename +
+      "' is not supported on Windows");
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("MappedMatrix: cannot open file '" + filename +
+        "' for reading");
+  }
+
+  struct stat fileInfo;
+  mapped_matrix_detail::Header header;
+  if (fstat(fd, &fileInfo) != 0 ||
+      (size_t) fileInfo.st_size < headerSize ||
+      pread(fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header))
+  {
+    close(fd);
+    throw std::runtime_error("MappedMatrix: cannot read header of '" +
+        filename + "'");
+  }
+
+  const bool firstVersion = (std::memcmp(header.magic,
+      mapped_matrix_detail::magic, sizeof(header.magic)) == 0);
+  if (!firstVersion && std::memcmp(header.magic,
+      mapped_matrix_detail::magicV2, sizeof(header.magic)) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("MappedMatrix: '" + filename + "' is not a "
+        "mapped matrix file");
+  }
+
+  if (firstVersion)
+  {
+    // Only the size of the elements was stored, and they follow the header.
+    header.elemType = mapped_matrix_detail::ElemType<eT>();
+    header.dataOffset = headerSize;
+    header.infoSize = 0;
+  }
+
+  if (header.elemSize != sizeof(eT) ||
+      header.elemType != mapped_matrix_detail::ElemType<eT>())
+  {
+    close(fd);
+    std::ostringstream oss;
+    oss << "MappedMatrix: '" << filename << "' holds elements of "
+        << header.elemSize << " bytes (of type code " << header.elemType
+        << "), but elements of " << sizeof(eT) << " bytes (of type code "
+        << mapped_matrix_detail::ElemType<eT>() << ") were requested";
+    throw std::runtime_error(oss.str());
+  }
+
+  nRows = header.nRows;
+  nCols = header.nCols;
+  mappingSize = header.dataOffset + nRows * nCols * sizeof(eT);
+  if ((size_t) fileInfo.st_size < mappingSize ||
+      header.dataOffset < headerSize + header.infoSize)
+  {
+    close(fd);
+    throw std::runtime_error("MappedMatrix: '" + filename + "' is truncated");
+  }
+
+  if (header.infoSize > 0)
+  {
+    std::string serializedInfo(header.infoSize, '\0');
+    if (pread(fd, &serializedInfo[0], header.infoSize, headerSize) !=
+        (ssize_t) header.infoSize)
+    {
+      close(fd);
+      throw std::runtime_error("MappedMatrix: cannot read the DatasetInfo of '" +
+          filename + "'");
+    }
+
+    try
+    {
+      std::istringstream stream(serializedInfo);
+      boost::archive::text_iarchive ar(stream);
+      DatasetInfo& datasetInfo = info;
+      ar >> BOOST_SERIALIZATION_NVP(datasetInfo);
+    }
+    catch (std::exception& e)
+    {
+      close(fd);
+      throw std::runtime_error("MappedMatrix: cannot read the DatasetInfo of '" +
+          filename + "': " + e.what());
+    }
+
+    hasInfo = true;
+  }
+
+  // A private mapping shares the pages of the page cache with every other
+  // process that maps the file, until a page is written to.
+  mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    mapping = NULL;
+    throw std::runtime_error("MappedMatrix: cannot memory-map '" + filename +
+        "'");
+  }
+
+  memory = reinterpret_cast<eT*>(static_cast<char*>(mapping) +
+      header.dataOffset);
+#endif
+}
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+#ifndef _WIN32
+  if (mapping)
+    munmap(mapping, mappingSize);
+#endif
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Save(const std::string& filename,
+                            const arma::Mat<eT>& matrix)
+{
+  Save(filename, matrix, (const DatasetInfo*) NULL);
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Save(const std::string& filename,
+                            const arma::Mat<eT>& matrix,
+                            const DatasetInfo& info)
+{
+  if (info.Dimensionality() != matrix.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MappedMatrix::Save(): the DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but the matrix has " << matrix.n_rows
+        << " rows";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Save(filename, matrix, &info);
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Save(const std::string& filename,
+                            const arma::Mat<eT>& matrix,
+                            const DatasetInfo* info)
+{
+  std::string serializedInfo;
+  if (info)
+  {
+    std::ostringstream oss;
+    {
+      const DatasetInfo& datasetInfo = *info;
+      boost::archive::text_oarchive ar(oss);
+      ar << BOOST_SERIALIZATION_NVP(datasetInfo);
+    }
+    serializedInfo = oss.str();
+  }
+
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("MappedMatrix::Save(): cannot open file '" +
+        filename + "' for writing");
+  }
+
+  // The elements start at a page boundary, after the header and the
+  // DatasetInfo.
+  const size_t pageSize = mapped_matrix_detail::PageSize();
+  const size_t dataOffset = ((headerSize + serializedInfo.size() + pageSize -
+      1) / pageSize) * pageSize;
+
+  mapped_matrix_detail::Header header;
+  std::memcpy(header.magic, mapped_matrix_detail::magicV2,
+      sizeof(header.magic));
+  header.elemSize = sizeof(eT);
+  header.nRows = matrix.n_rows;
+  header.nCols = matrix.n_cols;
+  header.elemType = mapped_matrix_detail::ElemType<eT>();
+  header.dataOffset = dataOffset;
+  header.infoSize = serializedInfo.size();
+
+  std::vector<char> padding(dataOffset, 0);
+  std::memcpy(padding.data(), &header, sizeof(header));
+  std::memcpy(padding.data() + headerSize, serializedInfo.data(),
+      serializedInfo.size());
+  stream.write(padding.data(), dataOffset);
+  stream.write(reinterpret_cast<const char*>(matrix.memptr()),
+      matrix.n_elem * sizeof(eT));
+
+  if (!stream.good())
+  {
+    throw std::runtime_error("MappedMatrix::Save(): error writing to '" +
+        filename + "'");
+  }
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Alias(arma::Mat<eT>& matrix)
+{
+  // Armadillo has no way to rebind an existing matrix to auxiliary memory, so
+  // destroy it (releasing any memory it owns) and construct the alias in place.
+  typedef arma::Mat<eT> MatType;
+  matrix.~MatType();
+  new (&matrix) MatType(memory, nRows, nCols, false, true);
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Unalias(arma::Mat<eT>& matrix)
+{
+  // A strict alias cannot be resized, so it has to be reconstructed too.
+  typedef arma::Mat<eT> MatType;
+  matrix.~MatType();
+  new (&matrix) MatType();
+}
+
+template<typename eT>
+void LoadMapped(const std::string& filename, arma::Mat<eT>& matrix)
+{
+  DatasetInfo info;
+  LoadMapped(filename, matrix, info);
+}
+
+template<typename eT>
+void LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                DatasetInfo& info)
+{
+  std::unique_ptr<MappedMatrix<eT>> mapped(new MappedMatrix<eT>(filename));
+  info = mapped->HasInfo() ? mapped->Info() : DatasetInfo(mapped->NRows());
+
+  // Release the mapping the matrix used before, if any.
+  ReleaseMapped(matrix);
+
+  // As in Alias(), the matrix is reconstructed in place; but the alias is not
+  // strict, so the matrix gets memory of its own if it is resized.
+  typedef arma::Mat<eT> MatType;
+  matrix.~MatType();
+  if (mapped->NRows() * mapped->NCols() == 0)
+  {
+    new (&matrix) MatType(mapped->NRows(), mapped->NCols());
+    return;
+  }
+
+  new (&matrix) MatType(mapped->Memory(), mapped->NRows(), mapped->NCols(),
+      false, false);
+
+  mapped_matrix_detail::Registry<eT>& registry =
+      mapped_matrix_detail::Registry<eT>::Get();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.mappings[mapped->Memory()] = std::move(mapped);
+}
+
+template<typename eT, typename PolicyType>
+void LoadMapped(const std::string& /* filename */,
+                arma::Mat<eT>& /* matrix */,
+                DatasetMapper<PolicyType>& /* info */)
+{
+  throw std::invalid_argument("LoadMapped(): mapped matrix files can only "
+      "hold a DatasetInfo!");
+}
+
+template<typename eT>
+bool ReleaseMapped(arma::Mat<eT>& matrix)
+{
+  mapped_matrix_detail::Registry<eT>& registry =
+      mapped_matrix_detail::Registry<eT>::Get();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  typename std::map<const eT*, std::unique_ptr<MappedMatrix<eT>>>::iterator
+      it = registry.mappings.find(matrix.memptr());
+  if (it == registry.mappings.end())
+    return false;
+
+  MappedMatrix<eT>::Unalias(matrix);
+  registry.mappings.erase(it);
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
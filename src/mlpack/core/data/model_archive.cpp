@@ -0,0 +1,336 @@
+/**
+ * @file core/data/model_archive.cpp
+ *
+ * Implementation of the ModelArchiveWriter and ModelArchive classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "model_archive.hpp"
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <cstring>
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+namespace {
+
+//! The magic string at the start of the files.
+const char archiveMagic[8] = { 'M', 'L', 'P', 'K', 'A', 'R', 'C', '\0' };
+//! The current version of the format.
+const uint32_t archiveVersion = 1;
+//! The alignment of the header and of the components.
+const uint64_t archiveAlignment = 64;
+
+//! The header of a model archive.
+struct ArchiveHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t tocOffset;
+  uint64_t numEntries;
+};
+
+//! Write the given value to the given stream.
+void WriteValue(std::ofstream& stream, const uint64_t value)
+{
+  stream.write((const char*) &value, sizeof(value));
+}
+
+//! Read a value of the table of contents, or throw if it is truncated.
+uint64_t ReadValue(const char* memory, const size_t end, size_t& position,
+                   const std::string& filename)
+{
+  uint64_t value;
+  if (end - position < sizeof(value))
+  {
+    throw std::runtime_error("ModelArchive: the table of contents of '" +
+        filename + "' is truncated");
+  }
+
+  std::memcpy(&value, memory + position, sizeof(value));
+  position += sizeof(value);
+  return value;
+}
+
+} // namespace
+
+ModelArchiveWriter::ModelArchiveWriter(const std::string& filename) :
+    filename(filename),
+    finished(false)
+{
+  stream.open(filename, std::ofstream::out | std::ofstream::binary |
+      std::ofstream::trunc);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("ModelArchiveWriter: cannot open file '" +
+        filename + "' for writing");
+  }
+
+  // The header is written by Finish(); until then the file is not a valid
+  // archive.
+  const std::vector<char> header(archiveAlignment, '\0');
+  stream.write(header.data(), header.size());
+}
+
+ModelArchiveEntry& ModelArchiveWriter::StartEntry(const std::string& name,
+                                                  const uint64_t kind)
+{
+  if (finished)
+  {
+    throw std::invalid_argument("ModelArchiveWriter: cannot add '" + name +
+        "' to '" + filename + "' after Finish()");
+  }
+
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    if (entries[i].name == name)
+    {
+      throw std::invalid_argument("ModelArchiveWriter: '" + filename +
+          "' already holds a component named '" + name + "'");
+    }
+  }
+
+  // Align the component, so that matrices can be used in place.
+  const uint64_t position = (uint64_t) stream.tellp();
+  const uint64_t padding = (archiveAlignment - position % archiveAlignment) %
+      archiveAlignment;
+  const std::vector<char> zeros(padding, '\0');
+  stream.write(zeros.data(), zeros.size());
+
+  ModelArchiveEntry entry;
+  entry.name = name;
+  entry.offset = position + padding;
+  entry.size = 0;
+  entry.kind = kind;
+  entry.nRows = 0;
+  entry.nCols = 0;
+  entry.elemType = 0;
+  entries.push_back(entry);
+  return entries.back();
+}
+
+void ModelArchiveWriter::EndEntry()
+{
+  ModelArchiveEntry& entry = entries.back();
+  const std::streamoff position = stream.tellp();
+  if (stream.fail() || position < 0)
+  {
+    throw std::runtime_error("ModelArchiveWriter: cannot write '" +
+        entry.name + "' to '" + filename + "'");
+  }
+
+  entry.size = (uint64_t) position - entry.offset;
+}
+
+void ModelArchiveWriter::Finish()
+{
+  if (finished)
+    return;
+
+  const uint64_t tocOffset = (uint64_t) stream.tellp();
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    const ModelArchiveEntry& entry = entries[i];
+    WriteValue(stream, entry.name.size());
+    stream.write(entry.name.data(), entry.name.size());
+    WriteValue(stream, entry.offset);
+    WriteValue(stream, entry.size);
+    WriteValue(stream, entry.kind);
+    WriteValue(stream, entry.nRows);
+    WriteValue(stream, entry.nCols);
+    WriteValue(stream, entry.elemType);
+  }
+
+  ArchiveHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, archiveMagic, sizeof(archiveMagic));
+  header.version = archiveVersion;
+  header.tocOffset = tocOffset;
+  header.numEntries = entries.size();
+  stream.seekp(0);
+  stream.write((const char*) &header, sizeof(header));
+
+  stream.close();
+  finished = true;
+  if (stream.fail())
+  {
+    throw std::runtime_error("ModelArchiveWriter: cannot write file '" +
+        filename + "'");
+  }
+}
+
+ModelArchive::ModelArchive(const std::string& filename) :
+    filename(filename),
+    memory(NULL),
+    memorySize(0),
+    mapped(false)
+{
+#ifdef _WIN32
+  // Without mmap, the whole file is read into memory.
+  std::ifstream stream(filename, std::ifstream::in | std::ifstream::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("ModelArchive: cannot open file '" + filename +
+        "' for reading");
+  }
+
+  stream.seekg(0, std::ios::end);
+  memorySize = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+  memory = new char[std::max(memorySize, (size_t) 1)];
+  stream.read(memory, memorySize);
+  if (!stream)
+  {
+    delete[] memory;
+    throw std::runtime_error("ModelArchive: cannot read file '" + filename +
+        "'");
+  }
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("ModelArchive: cannot open file '" + filename +
+        "' for reading");
+  }
+
+  struct stat fileInfo;
+  if (fstat(fd, &fileInfo) != 0 ||
+      (size_t) fileInfo.st_size < sizeof(ArchiveHeader))
+  {
+    close(fd);
+    throw std::runtime_error("ModelArchive: '" + filename + "' is not a model "
+        "archive");
+  }
+
+  // A private mapping shares the pages of the page cache with every other
+  // process that maps the file, until a page is written to.
+  memorySize = (size_t) fileInfo.st_size;
+  void* mapping = mmap(NULL, memorySize, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+      fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    throw std::runtime_error("ModelArchive: cannot memory-map '" + filename +
+        "'");
+  }
+  memory = static_cast<char*>(mapping);
+  mapped = true;
+#endif
+
+  try
+  {
+    ArchiveHeader header;
+    if (memorySize < sizeof(header))
+    {
+      throw std::runtime_error("ModelArchive: '" + filename + "' is not a "
+          "model archive");
+    }
+    std::memcpy(&header, memory, sizeof(header));
+
+    if (std::memcmp(header.magic, archiveMagic, sizeof(archiveMagic)) != 0)
+    {
+      throw std::runtime_error("ModelArchive: '" + filename + "' is not a "
+          "model archive (or it was not finished)");
+    }
+
+    if (header.version > archiveVersion)
+    {
+      std::ostringstream oss;
+      oss << "ModelArchive: '" << filename << "' was saved in version "
+          << header.version << " of the mlpack model archive format, but only "
+          << "versions up to " << archiveVersion << " can be loaded; a newer "
+          << "version of mlpack is needed";
+      throw std::runtime_error(oss.str());
+    }
+
+    if (header.tocOffset > memorySize)
+    {
+      throw std::runtime_error("ModelArchive: '" + filename + "' is "
+          "truncated");
+    }
+
+    size_t position = header.tocOffset;
+    for (uint64_t i = 0; i < header.numEntries; ++i)
+    {
+      ModelArchiveEntry entry;
+      const uint64_t nameSize = ReadValue(memory, memorySize, position,
+          filename);
+      if (memorySize - position < nameSize)
+      {
+        throw std::runtime_error("ModelArchive: the table of contents of '" +
+            filename + "' is truncated");
+      }
+      entry.name.assign(memory + position, nameSize);
+      position += nameSize;
+
+      entry.offset = ReadValue(memory, memorySize, position, filename);
+      entry.size = ReadValue(memory, memorySize, position, filename);
+      entry.kind = ReadValue(memory, memorySize, position, filename);
+      entry.nRows = ReadValue(memory, memorySize, position, filename);
+      entry.nCols = ReadValue(memory, memorySize, position, filename);
+      entry.elemType = ReadValue(memory, memorySize, position, filename);
+
+      if (entry.offset > header.tocOffset ||
+          entry.size > header.tocOffset - entry.offset)
+      {
+        throw std::runtime_error("ModelArchive: component '" + entry.name +
+            "' of '" + filename + "' is out of the file");
+      }
+
+      if (!indices.insert(std::make_pair(entry.name, entries.size())).second)
+      {
+        throw std::runtime_error("ModelArchive: '" + filename + "' holds "
+            "several components named '" + entry.name + "'");
+      }
+      entries.push_back(entry);
+    }
+  }
+  catch (...)
+  {
+#ifdef _WIN32
+    delete[] memory;
+#else
+    munmap(memory, memorySize);
+#endif
+    throw;
+  }
+}
+
+ModelArchive::~ModelArchive()
+{
+#ifdef _WIN32
+  delete[] memory;
+#else
+  if (mapped)
+    munmap(memory, memorySize);
+#endif
+}
+
+bool ModelArchive::Contains(const std::string& name) const
+{
+  return indices.count(name) > 0;
+}
+
+const ModelArchiveEntry& ModelArchive::Entry(const std::string& name) const
+{
+  std::unordered_map<std::string, size_t>::const_iterator it =
+      indices.find(name);
+  if (it == indices.end())
+  {
+    throw std::invalid_argument("ModelArchive: '" + filename + "' holds no "
+        "component named '" + name + "'");
+  }
+
+  return entries[it->second];
+}
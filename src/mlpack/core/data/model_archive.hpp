@@ -0,0 +1,227 @@
+/**
+ * @file core/data/model_archive.hpp
+ *
+ * Definition of the ModelArchiveWriter and ModelArchive classes, which write
+ * and read model archives: files holding several named components (serialized
+ * objects or raw matrices) with a table of contents, so that each component
+ * can be loaded on its own.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MODEL_ARCHIVE_HPP
+#define MLPACK_CORE_DATA_MODEL_ARCHIVE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <unordered_map>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * An entry of the table of contents of a model archive.
+ */
+struct ModelArchiveEntry
+{
+  //! The kinds of entries.
+  enum Kind
+  {
+    //! A boost binary archive of an object.
+    SERIALIZED = 0,
+    //! The elements of a matrix, stored by column.
+    MATRIX = 1
+  };
+
+  //! The name of the component.
+  std::string name;
+  //! The offset of the component in the file.
+  uint64_t offset;
+  //! The size of the component, in bytes.
+  uint64_t size;
+  //! The kind of the component.
+  uint64_t kind;
+  //! The number of rows of a matrix.
+  uint64_t nRows;
+  //! The number of columns of a matrix.
+  uint64_t nCols;
+  //! The element type code of a matrix (see MappedMatrix).
+  uint64_t elemType;
+};
+
+/**
+ * The ModelArchiveWriter writes a model archive.  A model archive starts with
+ * a header that holds the magic string "MLPKARC", the version of the format
+ * and the offset of the table of contents; the components follow, each aligned
+ * to 64 bytes, and the table of contents (the name, offset, size and kind of
+ * each component) ends the file.  Each component is either a boost binary
+ * archive of an object, or the raw elements of a matrix, which can be used in
+ * place from the mapped file.  Like boost binary archives, the files are not
+ * portable between platforms with different endianness or type sizes.
+ *
+ * @code
+ * data::ModelArchiveWriter writer("model.mla");
+ * writer.Add("info", datasetInfo);
+ * writer.Add("forest", forest);
+ * writer.AddMatrix("centroids", centroids);
+ * writer.Finish();
+ * @endcode
+ */
+class ModelArchiveWriter
+{
+ public:
+  /**
+   * Open the given file and reserve the header.  Throws std::runtime_error if
+   * the file can't be opened.
+   *
+   * @param filename File to write.
+   */
+  ModelArchiveWriter(const std::string& filename);
+
+  //! A ModelArchiveWriter cannot be copied.
+  ModelArchiveWriter(const ModelArchiveWriter& other) = delete;
+  //! A ModelArchiveWriter cannot be copied.
+  ModelArchiveWriter& operator=(const ModelArchiveWriter& other) = delete;
+
+  /**
+   * Serialize the given object as a new component.  Throws
+   * std::invalid_argument if a component already has this name, and
+   * std::runtime_error if the file can't be written.
+   *
+   * @param name Name of the component.
+   * @param object Object to serialize.
+   */
+  template<typename T>
+  void Add(const std::string& name, const T& object);
+
+  /**
+   * Write the elements of the given matrix as a new component, which
+   * ModelArchive::LoadMatrix() can use in place.
+   *
+   * @param name Name of the component.
+   * @param matrix Matrix to write.
+   */
+  template<typename eT>
+  void AddMatrix(const std::string& name, const arma::Mat<eT>& matrix);
+
+  /**
+   * Write the table of contents and the header, and close the file.  No
+   * component can be added afterwards.
+   */
+  void Finish();
+
+  //! Get the entries written so far.
+  const std::vector<ModelArchiveEntry>& Entries() const { return entries; }
+
+ private:
+  //! Pad the file to the alignment of the components, and start an entry.
+  ModelArchiveEntry& StartEntry(const std::string& name, const uint64_t kind);
+  //! Record the size of the last entry, and check that the file was written.
+  void EndEntry();
+
+  //! The name of the file.
+  std::string filename;
+  //! The file.
+  std::ofstream stream;
+  //! The entries written so far.
+  std::vector<ModelArchiveEntry> entries;
+  //! Whether Finish() was called.
+  bool finished;
+};
+
+/**
+ * The ModelArchive class reads a model archive written by ModelArchiveWriter.
+ * Only the header and the table of contents are read when the archive is
+ * opened; the file is memory-mapped (or read into memory on platforms without
+ * mmap), and each component is deserialized from the mapped memory when it is
+ * loaded, so a program can load only the components it needs, when it needs
+ * them.  Load() and LoadMatrix() can be called from several threads at once.
+ *
+ * @code
+ * data::ModelArchive archive("model.mla");
+ * data::DatasetInfo info;
+ * archive.Load("info", info);
+ * @endcode
+ */
+class ModelArchive
+{
+ public:
+  /**
+   * Open and map the given archive, and read its table of contents.  Throws
+   * std::runtime_error if the file can't be read, if it is not a model
+   * archive, if it is truncated, or if it was written by a newer version of
+   * mlpack.
+   *
+   * @param filename File to read.
+   */
+  ModelArchive(const std::string& filename);
+
+  //! Unmap the file.
+  ~ModelArchive();
+
+  //! A ModelArchive cannot be copied.
+  ModelArchive(const ModelArchive& other) = delete;
+  //! A ModelArchive cannot be copied.
+  ModelArchive& operator=(const ModelArchive& other) = delete;
+
+  //! Get whether the archive holds a component of the given name.
+  bool Contains(const std::string& name) const;
+
+  /**
+   * Get the entry of the component of the given name; throws
+   * std::invalid_argument if there is none.
+   */
+  const ModelArchiveEntry& Entry(const std::string& name) const;
+
+  //! Get the entries of all the components, in the order they were written.
+  const std::vector<ModelArchiveEntry>& Entries() const { return entries; }
+
+  /**
+   * Deserialize the given component into the given object.  Throws
+   * std::invalid_argument if there is no such component, and
+   * std::runtime_error if it can't be deserialized.
+   *
+   * @param name Name of the component.
+   * @param object Object to deserialize into.
+   */
+  template<typename T>
+  void Load(const std::string& name, T& object) const;
+
+  /**
+   * Make the given matrix an alias of the elements of the given matrix
+   * component, in the mapped memory: nothing is copied, and the pages are
+   * only read from the file when they are accessed.  The alias is only valid
+   * while the archive exists.  Writing to the alias does not change the file.
+   *
+   * @param name Name of the component.
+   * @param matrix Matrix to turn into an alias.
+   */
+  template<typename eT>
+  void LoadMatrix(const std::string& name, arma::Mat<eT>& matrix) const;
+
+  //! Get the name of the file.
+  const std::string& Filename() const { return filename; }
+
+ private:
+  //! The name of the file.
+  std::string filename;
+  //! The start of the mapping (or of the memory holding the file).
+  char* memory;
+  //! The size of the file.
+  size_t memorySize;
+  //! Whether the memory is a mapping (otherwise it was allocated).
+  bool mapped;
+  //! The entries of the components.
+  std::vector<ModelArchiveEntry> entries;
+  //! The index of each entry, by name.
+  std::unordered_map<std::string, size_t> indices;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "model_archive_impl.hpp"
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file core/data/model_archive_impl.hpp
+ *
+ * Implementation of the templated methods of ModelArchiveWriter and
+ * ModelArchive.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MODEL_ARCHIVE_IMPL_HPP
+#define MLPACK_CORE_DATA_MODEL_ARCHIVE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "model_archive.hpp"
+#include "mapped_matrix.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+namespace mlpack {
+namespace data {
+
+namespace model_archive_detail {
+
+//! A stream buffer that reads a component from the memory of the archive.
+class MemoryBuffer : public std::streambuf
+{
+ public:
+  MemoryBuffer(char* begin, const size_t size)
+  {
+    setg(begin, begin, begin + size);
+  }
+};
+
+} // namespace model_archive_detail
+
+template<typename T>
+void ModelArchiveWriter::Add(const std::string& name, const T& object)
+{
+  StartEntry(name, ModelArchiveEntry::SERIALIZED);
+  {
+    boost::archive::binary_oarchive ar(stream);
+    ar << boost::serialization::make_nvp(name.c_str(), object);
+  }
+  EndEntry();
+}
+
+template<typename eT>
+void ModelArchiveWriter::AddMatrix(const std::string& name,
+                                   const arma::Mat<eT>& matrix)
+{
+  ModelArchiveEntry& entry = StartEntry(name, ModelArchiveEntry::MATRIX);
+  entry.nRows = matrix.n_rows;
+  entry.nCols = matrix.n_cols;
+  entry.elemType = mapped_matrix_detail::ElemType<eT>();
+  stream.write(reinterpret_cast<const char*>(matrix.memptr()),
+      matrix.n_elem * sizeof(eT));
+  EndEntry();
+}
+
+template<typename T>
+void ModelArchive::Load(const std::string& name, T& object) const
+{
+  const ModelArchiveEntry& entry = Entry(name);
+  if (entry.kind != ModelArchiveEntry::SERIALIZED)
+  {
+    throw std::invalid_argument("ModelArchive::Load(): '" + name + "' in '" +
+        filename + "' is a matrix; use LoadMatrix()");
+  }
+
+  try
+  {
+    model_archive_detail::MemoryBuffer buffer(memory + entry.offset,
+        entry.size);
+    boost::archive::binary_iarchive ar(buffer);
+    ar >> boost::serialization::make_nvp(name.c_str(), object);
+  }
+  catch (std::exception& e)
+  {
+    throw std::runtime_error("ModelArchive::Load(): cannot load '" + name +
+        "' from '" + filename + "': " + e.what());
+  }
+}
+
+template<typename eT>
+void ModelArchive::LoadMatrix(const std::string& name,
+                              arma::Mat<eT>& matrix) const
+{
+  const ModelArchiveEntry& entry = Entry(name);
+  if (entry.kind != ModelArchiveEntry::MATRIX ||
+      entry.elemType != mapped_matrix_detail::ElemType<eT>())
+  {
+    throw std::invalid_argument("ModelArchive::LoadMatrix(): '" + name +
+        "' in '" + filename + "' is not a matrix of the requested element "
+        "type");
+  }
+
+  if (entry.nRows * entry.nCols * sizeof(eT) != entry.size)
+  {
+    throw std::runtime_error("ModelArchive::LoadMatrix(): '" + name + "' in '" +
+        filename + "' is corrupted");
+  }
+
+  // Armadillo has no way to rebind an existing matrix to auxiliary memory, so
+  // destroy it (releasing any memory it owns) and construct the alias in place.
+  typedef arma::Mat<eT> MatType;
+  matrix.~MatType();
+  new (&matrix) MatType(reinterpret_cast<eT*>(memory + entry.offset),
+      entry.nRows, entry.nCols, false, true);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
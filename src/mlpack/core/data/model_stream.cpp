@@ -0,0 +1,351 @@
+/**
+ * @file core/data/model_stream.cpp
+ *
+ * Implementation of the stream buffers that read and write models in mlpack's
+ * fast binary model format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "model_stream.hpp"
+
+#include <cstring>
+
+#ifdef HAS_ZSTD
+  #include <zstd.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+namespace {
+
+//! The magic string at the start of the files.
+const char modelMagic[8] = { 'M', 'L', 'P', 'K', 'M', 'D', 'L', '\0' };
+//! The current version of the format.
+const uint32_t modelVersion = 1;
+//! The flag telling that the archive is compressed with zstd.
+const uint32_t modelCompressedFlag = 1;
+//! The size of the buffers.
+const size_t modelBufferSize = 1 << 20;
+
+} // namespace
+
+ModelOutputBuffer::ModelOutputBuffer(const std::string& filename,
+                                     const bool compress,
+                                     const int compressionLevel) :
+    filename(filename),
+    compress(compress),
+    buffer(modelBufferSize),
+    context(NULL)
+{
+  #ifndef HAS_ZSTD
+  if (compress)
+  {
+    throw std::runtime_error("Cannot save '" + filename + "' with compression: "
+        "mlpack was not compiled with zstd support (see the USE_ZSTD CMake "
+        "option)");
+  }
+  // Avoid unused parameter warnings.
+  (void) compressionLevel;
+  #endif
+
+  stream.open(filename, std::ofstream::out | std::ofstream::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("Unable to open file '" + filename + "'");
+
+  const uint32_t flags = compress ? modelCompressedFlag : 0;
+  stream.write(modelMagic, sizeof(modelMagic));
+  stream.write((const char*) &modelVersion, sizeof(modelVersion));
+  stream.write((const char*) &flags, sizeof(flags));
+
+  #ifdef HAS_ZSTD
+  if (compress)
+  {
+    ZSTD_CStream* cstream = ZSTD_createCStream();
+    context = cstream;
+    const size_t result = (cstream == NULL) ? 0 :
+        ZSTD_initCStream(cstream, compressionLevel);
+    if (cstream == NULL || ZSTD_isError(result))
+    {
+      ZSTD_freeCStream(cstream);
+      context = NULL;
+      throw std::runtime_error("Unable to initialize the compression of '" +
+          filename + "'");
+    }
+    compressed.resize(ZSTD_CStreamOutSize());
+  }
+  #endif
+
+  setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+ModelOutputBuffer::~ModelOutputBuffer()
+{
+  #ifdef HAS_ZSTD
+  if (context != NULL)
+    ZSTD_freeCStream((ZSTD_CStream*) context);
+  #endif
+}
+
+void ModelOutputBuffer::Finish()
+{
+  FlushBuffer();
+
+  #ifdef HAS_ZSTD
+  if (compress)
+  {
+    ZSTD_CStream* cstream = (ZSTD_CStream*) context;
+    size_t remaining = 1;
+    while (remaining != 0)
+    {
+      ZSTD_outBuffer out = { compressed.data(), compressed.size(), 0 };
+      remaining = ZSTD_endStream(cstream, &out);
+      if (ZSTD_isError(remaining))
+      {
+        throw std::runtime_error("Unable to compress '" + filename + "': " +
+            ZSTD_getErrorName(remaining));
+      }
+      stream.write(compressed.data(), out.pos);
+    }
+  }
+  #endif
+
+  stream.close();
+  if (stream.fail())
+    throw std::runtime_error("Unable to write file '" + filename + "'");
+}
+
+ModelOutputBuffer::int_type ModelOutputBuffer::overflow(int_type c)
+{
+  FlushBuffer();
+  if (!traits_type::eq_int_type(c, traits_type::eof()))
+  {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+
+  return traits_type::not_eof(c);
+}
+
+std::streamsize ModelOutputBuffer::xsputn(const char* s, std::streamsize n)
+{
+  const size_t size = (size_t) n;
+  if (size <= (size_t) (epptr() - pptr()))
+  {
+    std::memcpy(pptr(), s, size);
+    pbump((int) size);
+  }
+  else
+  {
+    // Write the buffer, then buffer the block if it is small, or write it
+    // directly otherwise.
+    FlushBuffer();
+    if (size < buffer.size())
+    {
+      std::memcpy(pptr(), s, size);
+      pbump((int) size);
+    }
+    else
+    {
+      Write(s, size);
+    }
+  }
+
+  return n;
+}
+
+int ModelOutputBuffer::sync()
+{
+  FlushBuffer();
+  return 0;
+}
+
+void ModelOutputBuffer::FlushBuffer()
+{
+  if (pptr() != pbase())
+    Write(pbase(), (size_t) (pptr() - pbase()));
+  setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+void ModelOutputBuffer::Write(const char* data, const size_t size)
+{
+  #ifdef HAS_ZSTD
+  if (compress)
+  {
+    ZSTD_CStream* cstream = (ZSTD_CStream*) context;
+    ZSTD_inBuffer in = { data, size, 0 };
+    while (in.pos < in.size)
+    {
+      ZSTD_outBuffer out = { compressed.data(), compressed.size(), 0 };
+      const size_t result = ZSTD_compressStream(cstream, &out, &in);
+      if (ZSTD_isError(result))
+      {
+        throw std::runtime_error("Unable to compress '" + filename + "': " +
+            ZSTD_getErrorName(result));
+      }
+      stream.write(compressed.data(), out.pos);
+    }
+  }
+  else
+  #endif
+  {
+    stream.write(data, size);
+  }
+
+  if (stream.fail())
+    throw std::runtime_error("Unable to write file '" + filename + "'");
+}
+
+ModelInputBuffer::ModelInputBuffer(const std::string& filename) :
+    filename(filename),
+    compressed(false),
+    buffer(modelBufferSize),
+    inputPosition(0),
+    inputSize(0),
+    context(NULL)
+{
+  stream.open(filename, std::ifstream::in | std::ifstream::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("Unable to open file '" + filename + "'");
+
+  char magic[sizeof(modelMagic)];
+  uint32_t version = 0, flags = 0;
+  stream.read(magic, sizeof(magic));
+  stream.read((char*) &version, sizeof(version));
+  stream.read((char*) &flags, sizeof(flags));
+  if (!stream || std::memcmp(magic, modelMagic, sizeof(magic)) != 0)
+  {
+    throw std::runtime_error("'" + filename + "' is not an mlpack binary model "
+        "file");
+  }
+
+  if (version > modelVersion)
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' was saved in version " << version << " of the "
+        << "mlpack binary model format, but only versions up to "
+        << modelVersion << " can be loaded; a newer version of mlpack is "
+        << "needed";
+    throw std::runtime_error(oss.str());
+  }
+
+  compressed = (flags & modelCompressedFlag) != 0;
+  if (compressed)
+  {
+    #ifdef HAS_ZSTD
+    ZSTD_DStream* dstream = ZSTD_createDStream();
+    context = dstream;
+    const size_t result = (dstream == NULL) ? 0 : ZSTD_initDStream(dstream);
+    if (dstream == NULL || ZSTD_isError(result))
+    {
+      ZSTD_freeDStream(dstream);
+      context = NULL;
+      throw std::runtime_error("Unable to initialize the decompression of '" +
+          filename + "'");
+    }
+    input.resize(ZSTD_DStreamInSize());
+    #else
+    throw std::runtime_error("Cannot load '" + filename + "': it is "
+        "compressed, but mlpack was not compiled with zstd support (see the "
+        "USE_ZSTD CMake option)");
+    #endif
+  }
+
+  setg(buffer.data(), buffer.data(), buffer.data());
+}
+
+ModelInputBuffer::~ModelInputBuffer()
+{
+  #ifdef HAS_ZSTD
+  if (context != NULL)
+    ZSTD_freeDStream((ZSTD_DStream*) context);
+  #endif
+}
+
+ModelInputBuffer::int_type ModelInputBuffer::underflow()
+{
+  if (gptr() < egptr())
+    return traits_type::to_int_type(*gptr());
+
+  const size_t size = Read(buffer.data(), buffer.size());
+  setg(buffer.data(), buffer.data(), buffer.data() + size);
+  if (size == 0)
+    return traits_type::eof();
+
+  return traits_type::to_int_type(*gptr());
+}
+
+std::streamsize ModelInputBuffer::xsgetn(char* s, std::streamsize n)
+{
+  size_t size = (size_t) n;
+  size_t done = 0;
+
+  // First take what is left in the buffer.
+  const size_t available = std::min(size, (size_t) (egptr() - gptr()));
+  std::memcpy(s, gptr(), available);
+  gbump((int) available);
+  done += available;
+
+  // Large blocks are read directly; smaller blocks go through the buffer.
+  if (size - done >= buffer.size())
+  {
+    done += Read(s + done, size - done);
+  }
+  else
+  {
+    while (done < size)
+    {
+      if (traits_type::eq_int_type(underflow(), traits_type::eof()))
+        break;
+
+      const size_t count = std::min(size - done, (size_t) (egptr() - gptr()));
+      std::memcpy(s + done, gptr(), count);
+      gbump((int) count);
+      done += count;
+    }
+  }
+
+  return (std::streamsize) done;
+}
+
+size_t ModelInputBuffer::Read(char* data, const size_t size)
+{
+  #ifdef HAS_ZSTD
+  if (compressed)
+  {
+    ZSTD_DStream* dstream = (ZSTD_DStream*) context;
+    ZSTD_outBuffer out = { data, size, 0 };
+    while (out.pos < out.size)
+    {
+      if (inputPosition == inputSize)
+      {
+        stream.read(input.data(), input.size());
+        inputSize = (size_t) stream.gcount();
+        inputPosition = 0;
+      }
+
+      // At the end of the file, the decompressor may still hold output.
+      const size_t previous = out.pos;
+      ZSTD_inBuffer in = { input.data(), inputSize, inputPosition };
+      const size_t result = ZSTD_decompressStream(dstream, &out, &in);
+      inputPosition = in.pos;
+      if (ZSTD_isError(result))
+      {
+        throw std::runtime_error("Unable to decompress '" + filename + "': " +
+            ZSTD_getErrorName(result));
+      }
+
+      if (inputSize == 0 && out.pos == previous)
+        break;
+    }
+
+    return out.pos;
+  }
+  #endif
+
+  stream.read(data, size);
+  return (size_t) stream.gcount();
+}
@@ -0,0 +1,151 @@
+/**
+ * @file core/data/model_stream.hpp
+ *
+ * Definition of the stream buffers that read and write models in mlpack's fast
+ * binary model format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MODEL_STREAM_HPP
+#define MLPACK_CORE_DATA_MODEL_STREAM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A file in the fast binary model format starts with a header that holds the
+ * magic string "MLPKMDL", the version of the format and flags (telling whether
+ * the rest of the file is compressed with zstd); the rest of the file is a
+ * boost binary archive.  Like boost binary archives, the files are not
+ * portable between platforms with different endianness or type sizes.
+ *
+ * The archive is written through a large buffer, and the large blocks that
+ * the archive writes (such as the memory of Armadillo matrices, which is
+ * written in a single call) bypass the buffer, so they are written to the file
+ * (or compressed) without being copied.
+ */
+class ModelOutputBuffer : public std::streambuf
+{
+ public:
+  /**
+   * Open the given file and write the header.  Throws std::runtime_error if
+   * the file can't be opened, or if compression is requested but mlpack was
+   * not compiled with zstd support.
+   *
+   * @param filename File to write.
+   * @param compress Whether to compress the archive with zstd.
+   * @param compressionLevel zstd compression level.
+   */
+  ModelOutputBuffer(const std::string& filename,
+                    const bool compress,
+                    const int compressionLevel = 3);
+
+  //! Close the file, if Finish() was not called.
+  ~ModelOutputBuffer();
+
+  //! A ModelOutputBuffer cannot be copied.
+  ModelOutputBuffer(const ModelOutputBuffer& other) = delete;
+  //! A ModelOutputBuffer cannot be copied.
+  ModelOutputBuffer& operator=(const ModelOutputBuffer& other) = delete;
+
+  /**
+   * Write everything that is left in the buffer, end the compressed stream and
+   * close the file.  This must be called once the archive is destroyed; throws
+   * std::runtime_error if the file could not be written.
+   */
+  void Finish();
+
+ protected:
+  //! Flush the buffer to make room for the given character.
+  int_type overflow(int_type c);
+  //! Write the given characters.
+  std::streamsize xsputn(const char* s, std::streamsize n);
+  //! Flush the buffer.
+  int sync();
+
+ private:
+  //! Write the buffered characters, and empty the buffer.
+  void FlushBuffer();
+  //! Write (or compress and write) the given block.
+  void Write(const char* data, const size_t size);
+
+  //! The name of the file.
+  std::string filename;
+  //! The file.
+  std::ofstream stream;
+  //! Whether the archive is compressed.
+  bool compress;
+  //! The buffer of the archive.
+  std::vector<char> buffer;
+  //! The buffer for the compressed data.
+  std::vector<char> compressed;
+  //! The zstd compression context, if the archive is compressed.
+  void* context;
+};
+
+/**
+ * The ModelInputBuffer class reads the archive of a file in the fast binary
+ * model format (see ModelOutputBuffer), decompressing it if needed.  Large
+ * blocks are read (or decompressed) directly into the memory of the archive.
+ */
+class ModelInputBuffer : public std::streambuf
+{
+ public:
+  /**
+   * Open the given file and read its header.  Throws std::runtime_error if the
+   * file can't be opened, if it is not in the fast binary model format, if it
+   * was written by a newer version of mlpack, or if it is compressed but mlpack
+   * was not compiled with zstd support.
+   *
+   * @param filename File to read.
+   */
+  ModelInputBuffer(const std::string& filename);
+
+  //! Close the file.
+  ~ModelInputBuffer();
+
+  //! A ModelInputBuffer cannot be copied.
+  ModelInputBuffer(const ModelInputBuffer& other) = delete;
+  //! A ModelInputBuffer cannot be copied.
+  ModelInputBuffer& operator=(const ModelInputBuffer& other) = delete;
+
+  //! Get whether the archive is compressed.
+  bool Compressed() const { return compressed; }
+
+ protected:
+  //! Refill the buffer.
+  int_type underflow();
+  //! Read the given number of characters.
+  std::streamsize xsgetn(char* s, std::streamsize n);
+
+ private:
+  //! Read (or read and decompress) up to the given number of characters.
+  size_t Read(char* data, const size_t size);
+
+  //! The name of the file.
+  std::string filename;
+  //! The file.
+  std::ifstream stream;
+  //! Whether the archive is compressed.
+  bool compressed;
+  //! The buffer of the archive.
+  std::vector<char> buffer;
+  //! The buffer for the compressed data.
+  std::vector<char> input;
+  //! The position of the next compressed character in the input buffer.
+  size_t inputPosition;
+  //! The number of compressed characters in the input buffer.
+  size_t inputSize;
+  //! The zstd decompression context, if the archive is compressed.
+  void* context;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
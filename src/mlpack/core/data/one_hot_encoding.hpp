@@ -47,6 +47,21 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     const arma::Col<size_t>& indices,
                     arma::Mat<eT>& output);
 
+/**
+ * Overloaded function for the above function, which outputs a sparse matrix,
+ * so that dimensions with many categories can be encoded without allocating
+ * the dense encoded matrix.  The entries of each point are found in parallel,
+ * and the sparse matrix is built at once from them.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded sparse matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output);
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a DatasetInfo object and outputs a matrix.
@@ -62,6 +77,21 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     arma::Mat<eT>& output,
                     const data::DatasetInfo& datasetInfo);
 
+/**
+ * Overloaded function for the above function, which takes a matrix as input
+ * and also a DatasetInfo object and outputs a sparse matrix.
+ * This function encodes all the dimensions marked `Datatype::categorical`
+ * in the data::DatasetInfo.
+ *
+ * @param input Input dataset to be encoded.
+ * @param output Encoded sparse matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo);
+
 } // namespace data
 } // namespace mlpack
 
@@ -65,6 +65,69 @@ void OneHotEncoding(const RowType& labelsIn,
   labelMap.clear();
 }
 
+namespace details {
+
+/**
+ * Find the mappings of the values of the dimensions to encode, and the offset
+ * of each dimension of the input in the encoded matrix.  The values of each
+ * dimension are mapped in the order in which they first appear; the dimensions
+ * are mapped in parallel when mlpack is compiled with OpenMP.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param mappings Set to the mapping of the values of each dimension (empty for
+ *     the dimensions that are not encoded).
+ * @param encoded Set to whether each dimension is encoded.
+ * @param offsets Set to the first row of each dimension in the encoded matrix;
+ *     the last element is the number of rows of the encoded matrix.
+ */
+template<typename eT>
+void OneHotEncodingMappings(
+    const arma::Mat<eT>& input,
+    const arma::Col<size_t>& indices,
+    std::vector<std::unordered_map<eT, size_t>>& mappings,
+    std::vector<char>& encoded,
+    arma::Col<size_t>& offsets)
+{
+  encoded.assign(input.n_rows, 0);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "OneHotEncoding(): dimension " << indices[i] << " cannot be "
+          << "encoded, because the input has only " << input.n_rows
+          << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+    encoded[indices[i]] = 1;
+  }
+
+  std::vector<size_t> dimensions;
+  for (size_t row = 0; row < input.n_rows; ++row)
+    if (encoded[row])
+      dimensions.push_back(row);
+
+  mappings.clear();
+  mappings.resize(input.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+  {
+    const size_t row = dimensions[d];
+    std::unordered_map<eT, size_t>& mapping = mappings[row];
+    for (size_t col = 0; col < input.n_cols; ++col)
+      mapping.insert(std::make_pair(input(row, col), mapping.size()));
+  }
+
+  offsets.set_size(input.n_rows + 1);
+  offsets[0] = 0;
+  for (size_t row = 0; row < input.n_rows; ++row)
+    offsets[row + 1] = offsets[row] + (encoded[row] ? mappings[row].size() : 1);
+}
+
+} // namespace details
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a vector of indices to encode and outputs a matrix.
@@ -86,61 +149,98 @@ void OneHotEncoding(const arma::Mat<eT>& input,
     return;
   }
 
-  // First, we need to compute the size of the output matrix.
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  std::vector<char> encoded;
+  arma::Col<size_t> offsets;
+  details::OneHotEncodingMappings(input, indices, mappings, encoded, offsets);
 
-  // This vector will eventually hold the offsets for each dimension in the
-  // one-hot encoded matrix, but first it will just hold the counts of
-  // dimensions for each dimension.
-  arma::Col<size_t> dimensionOffsets(input.n_rows, arma::fill::ones);
-  // This will hold the mappings from a value that should be one-hot encoded to
-  // the index of the dimension it should take.
-  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
-  for (size_t i = 0; i < indices.n_elem; ++i)
-  {
-    dimensionOffsets[indices[i]] = 0;
-    mappings.insert(
-        std::make_pair(indices[i], std::unordered_map<eT, size_t>()));
-  }
+  // Now, initialize the output matrix to the right size, and encode each point.
+  output.zeros(offsets[input.n_rows], input.n_cols);
 
-  for (size_t col = 0; col < input.n_cols; ++col)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      if (mappings.count(row) != 0)
-      {
-        // We have to one-hot encode this point.
-        if (mappings[row].count(input(row, col)) == 0)
-          mappings[row][input(row, col)] = dimensionOffsets[row]++;
-      }
+      if (encoded[row])
+        output(offsets[row] + mappings[row].at(input(row, col)), col) = eT(1);
+      else
+        output(offsets[row], col) = input(row, col); // No need for encoding.
     }
   }
+}
+
+/**
+ * Overloaded function for the above function, which outputs a sparse matrix,
+ * so that dimensions with many categories can be encoded without allocating
+ * the dense encoded matrix.  The entries of each point are found in parallel,
+ * and the sparse matrix is built at once from them.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded sparse matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output)
+{
+  // Handle the edge case where there is nothing to encode.
+  if (indices.n_elem == 0)
+  {
+    output = arma::SpMat<eT>(input);
+    return;
+  }
 
-  // Turn the dimension counts into offsets.  Note that the last element is the
-  // total number of dimensions, and the first element is the offset for
-  // dimension *2* (not 1).
-  for (size_t i = 1; i < dimensionOffsets.n_elem; ++i)
-    dimensionOffsets[i] += dimensionOffsets[i - 1];
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  std::vector<char> encoded;
+  arma::Col<size_t> offsets;
+  details::OneHotEncodingMappings(input, indices, mappings, encoded, offsets);
 
-  // Now, initialize the output matrix to the right size.
-  output.zeros(dimensionOffsets[dimensionOffsets.n_elem - 1], input.n_cols);
+  // Count the nonzero entries of each point: one for each encoded dimension,
+  // and one for each nonzero value of the other dimensions.
+  arma::uvec colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
+  {
+    size_t nonzeros = 0;
+    for (size_t row = 0; row < input.n_rows; ++row)
+      if (encoded[row] || input(row, col) != eT(0))
+        ++nonzeros;
+    colPtrs[col + 1] = nonzeros;
+  }
 
-  // Finally, one-hot encode the matrix.
   for (size_t col = 0; col < input.n_cols; ++col)
+    colPtrs[col + 1] += colPtrs[col];
+
+  // Fill the entries of each point; the rows are increasing within each
+  // column, since the offsets of the dimensions are.
+  arma::uvec rowIndices(colPtrs[input.n_cols]);
+  arma::Col<eT> values(colPtrs[input.n_cols]);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
+    size_t position = colPtrs[col];
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      const size_t dimOffset = (row == 0) ? 0 : dimensionOffsets[row - 1];
-      if (mappings.count(row) != 0)
+      if (encoded[row])
       {
-        output(dimOffset + mappings[row][input(row, col)], col) = eT(1);
+        rowIndices[position] = offsets[row] + mappings[row].at(input(row, col));
+        values[position++] = eT(1);
       }
-      else
+      else if (input(row, col) != eT(0))
       {
-        // No need for one-hot encoding.
-        output(dimOffset, col) = input(row, col);
+        rowIndices[position] = offsets[row];
+        values[position++] = input(row, col);
       }
     }
   }
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, values, offsets[input.n_rows],
+      input.n_cols);
 }
 
 /**
@@ -169,6 +269,32 @@ void OneHotEncoding(const arma::Mat<eT>& input,
   OneHotEncoding(input, arma::Col<size_t>(indices), output);
 }
 
+/**
+ * Overloaded function for the above function, which takes a matrix as input
+ * and also a DatasetInfo object and outputs a sparse matrix.
+ * This function encodes all the dimensions marked `Datatype::categorical`
+ * in the data::DatasetInfo.
+ *
+ * @param input Input dataset to be encoded.
+ * @param output Encoded sparse matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      indices.push_back(i);
+    }
+  }
+  OneHotEncoding(input, arma::Col<size_t>(indices), output);
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -0,0 +1,216 @@
+/**
+ * @file core/data/reorder.hpp
+ *
+ * Reorder the points of a dataset along a space-filling curve (Morton or
+ * Hilbert order), so that points that are close in space are close in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_REORDER_HPP
+#define MLPACK_CORE_DATA_REORDER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+//! The space-filling curves the points of a dataset can be ordered along.
+enum CurveType
+{
+  //! The Z-order curve: the bits of the coordinates are interleaved.  This is
+  //! the order of the addresses of the UB tree (see core/tree/address.hpp).
+  MORTON,
+  //! The Hilbert curve, which never jumps between distant cells, so that it
+  //! keeps consecutive points closer than the Z-order curve does.
+  HILBERT
+};
+
+/**
+ * Compute the key of each point of the given dataset along the given curve.
+ * Each dimension is scaled to its range in the dataset and quantized to
+ * min(32, 64 / d) bits (with d the number of dimensions, up to 64: further
+ * dimensions are ignored), and the key is the position of the quantized point
+ * along the curve, on 64 bits.
+ *
+ * @param dataset Dataset to compute the keys of (one point per column).
+ * @param curve The space-filling curve.
+ * @return The key of each point.
+ */
+template<typename eT>
+std::vector<uint64_t> CurveKeys(const arma::Mat<eT>& dataset,
+                                const CurveType curve)
+{
+  std::vector<uint64_t> keys(dataset.n_cols, 0);
+  if (dataset.n_elem == 0)
+    return keys;
+
+  const size_t dims = std::min((size_t) dataset.n_rows, (size_t) 64);
+  const size_t bits = std::min((size_t) 32, 64 / dims);
+  const double maxCoordinate = std::ldexp(1.0, (int) bits) - 1.0;
+
+  // The range of each dimension.
+  arma::Col<eT> lo = arma::min(dataset.rows(0, dims - 1), 1);
+  arma::Col<eT> hi = arma::max(dataset.rows(0, dims - 1), 1);
+  arma::vec scale(dims);
+  for (size_t d = 0; d < dims; ++d)
+  {
+    const double range = (double) hi[d] - (double) lo[d];
+    scale[d] = (range > 0.0 && std::isfinite(range)) ?
+        maxCoordinate / range : 0.0;
+  }
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    uint64_t x[64];
+    for (size_t d = 0; d < dims; ++d)
+    {
+      const double c = ((double) dataset(d, i) - (double) lo[d]) * scale[d];
+      // NaNs are put at 0.
+      x[d] = (c > 0.0) ? (uint64_t) std::min(c + 0.5, maxCoordinate) : 0;
+    }
+
+    if (curve == HILBERT && dims > 1)
+    {
+      // Turn the coordinates into the "transposed" Hilbert index (J. Skilling,
+      // "Programming the Hilbert curve", 2004): once interleaved, their bits
+      // are the position of the point along the curve.
+      const uint64_t m = (uint64_t) 1 << (bits - 1);
+      for (uint64_t q = m; q > 1; q >>= 1)
+      {
+        const uint64_t p = q - 1;
+        for (size_t d = 0; d < dims; ++d)
+        {
+          if (x[d] & q)
+          {
+            x[0] ^= p;
+          }
+          else
+          {
+            const uint64_t t = (x[0] ^ x[d]) & p;
+            x[0] ^= t;
+            x[d] ^= t;
+          }
+        }
+      }
+
+      // Gray encoding.
+      for (size_t d = 1; d < dims; ++d)
+        x[d] ^= x[d - 1];
+      uint64_t t = 0;
+      for (uint64_t q = m; q > 1; q >>= 1)
+        if (x[dims - 1] & q)
+          t ^= q - 1;
+      for (size_t d = 0; d < dims; ++d)
+        x[d] ^= t;
+    }
+
+    // Interleave the bits, starting with the most significant ones.
+    uint64_t key = 0;
+    for (size_t b = bits; b > 0; --b)
+      for (size_t d = 0; d < dims; ++d)
+        key = (key << 1) | ((x[d] >> (b - 1)) & 1);
+    keys[i] = key;
+  }
+
+  return keys;
+}
+
+/**
+ * Get the order of the points of the given dataset along the given
+ * space-filling curve, without moving them: element i of the result is the
+ * index of the i'th point along the curve.  Points with the same key keep
+ * their order.
+ *
+ * @param dataset Dataset to order (one point per column).
+ * @param curve The space-filling curve.
+ * @return The permutation of the points.
+ */
+template<typename eT>
+arma::uvec CurveOrder(const arma::Mat<eT>& dataset,
+                      const CurveType curve = HILBERT)
+{
+  const std::vector<uint64_t> keys = CurveKeys(dataset, curve);
+
+  std::vector<std::pair<uint64_t, arma::uword>> order(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    order[i] = std::make_pair(keys[i], (arma::uword) i);
+  std::sort(order.begin(), order.end());
+
+  arma::uvec permutation(keys.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    permutation[i] = order[i].second;
+
+  return permutation;
+}
+
+/**
+ * Reorder the points of the given dataset along the given space-filling
+ * curve, so that points close to each other in space are stored close to each
+ * other in memory.  This makes the algorithms that visit the points by
+ * neighborhood (k-means, GMMs, DBSCAN, kernel methods, and the construction
+ * and traversal of trees) access memory with much better locality.  The
+ * permutation is returned, so that results computed on the reordered dataset
+ * can be put back in the original order:
+ *
+ * @code
+ * arma::mat dataset = ...;
+ * arma::uvec permutation = data::Reorder(dataset);
+ * arma::Row<size_t> assignments;
+ * kmeans.Cluster(dataset, clusters, assignments);
+ *
+ * // The assignment of each point, in the original order.
+ * arma::Row<size_t> originalAssignments(assignments.n_elem);
+ * originalAssignments.cols(permutation) = assignments;
+ * @endcode
+ *
+ * @param dataset Dataset to reorder in place (one point per column).
+ * @param curve The space-filling curve.
+ * @return The permutation: point i of the reordered dataset is point
+ *     permutation[i] of the original dataset.
+ */
+template<typename eT>
+arma::uvec Reorder(arma::Mat<eT>& dataset, const CurveType curve = HILBERT)
+{
+  const arma::uvec permutation = CurveOrder(dataset, curve);
+  dataset = dataset.cols(permutation);
+  return permutation;
+}
+
+/**
+ * Reorder the points of the given dataset along the given space-filling
+ * curve, like Reorder(dataset, curve), and the labels (or responses) of the
+ * points in the same way.
+ *
+ * @param dataset Dataset to reorder in place (one point per column).
+ * @param labels Labels or responses to reorder (one column per point).
+ * @param curve The space-filling curve.
+ * @return The permutation: point i of the reordered dataset is point
+ *     permutation[i] of the original dataset.
+ */
+template<typename eT, typename LabelsType>
+arma::uvec Reorder(arma::Mat<eT>& dataset,
+                   LabelsType& labels,
+                   const CurveType curve = HILBERT)
+{
+  if (labels.n_cols != dataset.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "data::Reorder(): the dataset has " << dataset.n_cols << " points, "
+        << "but there are " << labels.n_cols << " labels";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const arma::uvec permutation = CurveOrder(dataset, curve);
+  dataset = dataset.cols(permutation);
+  labels = labels.cols(permutation);
+  return permutation;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -39,6 +39,9 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
+ *  - mlpack mapped matrix (see MappedMatrix), denoted by .mlpk; the matrix is
+ *    saved as it is in memory (never transposed), so that data::Load() can
+ *    memory-map it
  *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
@@ -101,9 +104,20 @@ bool Save(const std::string& filename,
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - fast binary, denoted by .mlb
+ *  - compressed fast binary, denoted by .mlbz
+ *
+ * The fast binary formats hold a boost binary archive after a header with the
+ * version of the format, and are read and written through large buffers, with
+ * the memory of matrices copied in bulk; they are much faster than the text
+ * and xml formats for large models.  The compressed format compresses the
+ * archive with zstd, and is only available if mlpack was compiled with zstd
+ * support (the USE_ZSTD CMake option).  Like binary files, fast binary files
+ * are not portable between platforms.
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary',
+ * 'format::fast_binary', and 'format::compressed_binary'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -15,6 +15,8 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "mapped_matrix.hpp"
+#include "model_stream.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -64,6 +66,28 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  if (extension == "mlpk")
+  {
+    // The matrix is written as it is in memory, so it can be mapped.
+    try
+    {
+      MappedMatrix<eT>::Save(filename, matrix);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   // Catch errors opening the file.
   std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
@@ -332,20 +356,51 @@ bool Save(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "mlb")
+      f = format::fast_binary;
+    else if (extension == "mlbz")
+      f = format::compressed_binary;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/txt)" << std::endl;
+            << " extension? (allowed: xml/bin/txt/mlb/mlbz)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/txt)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/txt/mlb/mlbz)"
             << std::endl;
 
       return false;
     }
   }
 
+  // The fast binary formats write the file through their own stream buffer.
+  if (f == format::fast_binary || f == format::compressed_binary)
+  {
+    try
+    {
+      ModelOutputBuffer buffer(filename, f == format::compressed_binary);
+      {
+        boost::archive::binary_oarchive ar(buffer);
+        ar << boost::serialization::make_nvp(name.c_str(), t);
+      }
+      buffer.Finish();
+
+      return true;
+    }
+    catch (std::exception& e)
+    {
+      if (fatal)
+        Log::Fatal << "Unable to save object '" << name << "' to '" << filename
+            << "': " << e.what() << std::endl;
+      else
+        Log::Warn << "Unable to save object '" << name << "' to '" << filename
+            << "': " << e.what() << std::endl;
+
+      return false;
+    }
+  }
+
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_MAX_ABS_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "scaling_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -54,8 +55,24 @@ class MaxAbsScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features on one more chunk of the dataset, updating the
+   * statistics of the chunks given since the last call to Fit(), so that a
+   * dataset too large for memory can be fitted one chunk at a time.  The
+   * statistics are not serialized, so after loading, fitting starts over.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = arma::max(arma::abs(itemMin), arma::abs(itemMax));
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -76,8 +93,9 @@ class MaxAbsScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = input.each_col() / scale;
+    // The output can be the input, to scale a dataset in place.
+    TransformElements(input, output, [this](const double x, const size_t i)
+        { return x / scale[i]; });
   }
 
   /**
@@ -89,8 +107,8 @@ class MaxAbsScaler
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = input.each_col() % scale;
+    TransformElements(input, output, [this](const double x, const size_t i)
+        { return x * scale[i]; });
   }
 
   //! Get the Min row vector.
@@ -114,6 +132,8 @@ class MaxAbsScaler
   arma::vec itemMax;
   // Vector which is used to scale up each feature.
   arma::vec scale;
+  // Statistics of the chunks given to PartialFit().
+  ScalingStatistics statistics;
 }; // class MaxAbsScaler
 
 } // namespace data
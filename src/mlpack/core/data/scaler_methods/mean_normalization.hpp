@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_MEAN_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "scaling_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -54,9 +55,25 @@ class MeanNormalization
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features on one more chunk of the dataset, updating the
+   * statistics of the chunks given since the last call to Fit(), so that a
+   * dataset too large for memory can be fitted one chunk at a time.  The
+   * statistics are not serialized, so after loading, fitting starts over.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    itemMean = statistics.Mean();
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = itemMax - itemMin;
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -77,8 +94,9 @@ class MeanNormalization
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / scale;
+    // The output can be the input, to scale a dataset in place.
+    TransformElements(input, output, [this](const double x, const size_t i)
+        { return (x - itemMean[i]) / scale[i]; });
   }
 
   /**
@@ -90,8 +108,8 @@ class MeanNormalization
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() % scale).each_col() + itemMean;
+    TransformElements(input, output, [this](const double x, const size_t i)
+        { return x * scale[i] + itemMean[i]; });
   }
 
   //! Get the Mean row vector.
@@ -121,6 +139,8 @@ class MeanNormalization
   arma::vec itemMax;
   // Vector which is used to scale up each feature.
   arma::vec scale;
+  // Statistics of the chunks given to PartialFit().
+  ScalingStatistics statistics;
 }; // class MeanNormalization
 
 } // namespace data
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "scaling_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -73,8 +74,24 @@ class MinMaxScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features on one more chunk of the dataset, updating the
+   * statistics of the chunks given since the last call to Fit(), so that a
+   * dataset too large for memory can be fitted one chunk at a time.  The
+   * statistics are not serialized, so after loading, fitting starts over.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = itemMax - itemMin;
     // Handle zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -99,8 +116,9 @@ class MinMaxScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
           " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() % scale).each_col() + scalerowmin;
+    // The output can be the input, to scale a dataset in place.
+    TransformElements(input, output, [this](const double x, const size_t i)
+        { return x * scale[i] + scalerowmin[i]; });
   }
 
   /**
@@ -112,8 +130,8 @@ class MinMaxScaler
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() - scalerowmin).each_col() / scale;
+    TransformElements(input, output, [this](const double x, const size_t i)
+        { return (x - scalerowmin[i]) / scale[i]; });
   }
 
   //! Get the Min row vector.
@@ -151,6 +169,8 @@ class MinMaxScaler
   double scaleMax;
   // Column vector of scalemin
   arma::vec scalerowmin;
+  // Statistics of the chunks given to PartialFit().
+  ScalingStatistics statistics;
 }; // class MinMaxScaler
 
 } // namespace data
@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/lin_alg.hpp>
 #include <mlpack/core/math/ccov.hpp>
+#include "scaling_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -52,7 +53,7 @@ class PCAWhitening
    *
    * @param eps Regularization parameter.
    */
-  PCAWhitening(double eps = 0.00005)
+  PCAWhitening(double eps = 0.00005) : statistics(true)
   {
     epsilon = eps;
     // Ensure scaleMin is smaller than scaleMax.
@@ -70,10 +71,25 @@ class PCAWhitening
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features on one more chunk of the dataset, updating the
+   * statistics of the chunks given since the last call to Fit(), so that a
+   * dataset too large for memory can be fitted one chunk at a time.  The
+   * statistics are not serialized, so after loading, fitting starts over.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    itemMean = statistics.Mean();
     // Get eigenvectors and eigenvalues of covariance of input matrix.
-    eig_sym(eigenValues, eigenVectors, mlpack::math::ColumnCovariance(
-        input.each_col() - itemMean));
+    eig_sym(eigenValues, eigenVectors, statistics.Covariance(true));
     eigenValues += epsilon;
   }
 
@@ -91,10 +107,9 @@ class PCAWhitening
       throw std::runtime_error("Call Fit() before Transform(), please"
           " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean);
-    output = arma::diagmat(1.0 / (arma::sqrt(eigenValues))) * eigenVectors.t()
-        * output;
+    // The output can be the input, to whiten a dataset in place.
+    TransformCentered(input, output, arma::diagmat(1.0 /
+        (arma::sqrt(eigenValues))) * eigenVectors.t(), itemMean);
   }
 
   /**
@@ -138,6 +153,8 @@ class PCAWhitening
   double epsilon;
   // Vector which hold the eigenvalues.
   arma::vec eigenValues;
+  // Statistics of the chunks given to PartialFit().
+  ScalingStatistics statistics;
 }; // class PCAWhitening
 
 } // namespace data
@@ -0,0 +1,329 @@
+/**
+ * @file core/data/scaler_methods/scaling_statistics.hpp
+ *
+ * Definition of the ScalingStatistics class, which accumulates the statistics
+ * that the scalers need in one pass over the data, and of helpers to transform
+ * a dataset without temporaries of its size.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_SCALING_STATISTICS_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_SCALING_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The ScalingStatistics class accumulates the count, the mean, the sum of
+ * squared deviations from the mean, the minimum and the maximum of each
+ * dimension of a dataset (and, optionally, the matrix of the sums of the
+ * products of the deviations, for the covariance), one chunk of points at a
+ * time.
+ *
+ * The points are processed in blocks that fit in the cache: the statistics of
+ * each block are computed with two passes over the block, and are merged into
+ * the running statistics with the pairwise update of Chan et al.:
+ *
+ * @code
+ * @techreport{chan1979updating,
+ *   title={Updating Formulae and a Pairwise Algorithm for Computing Sample
+ *       Variances},
+ *   author={Chan, T.F. and Golub, G.H. and LeVeque, R.J.},
+ *   institution={Stanford University},
+ *   number={STAN-CS-79-773},
+ *   year={1979}
+ * }
+ * @endcode
+ *
+ * so the data is only read once, and no temporary the size of the data is
+ * created.  When mlpack is compiled with OpenMP, the columns of each chunk are
+ * split between the threads, and the statistics of the threads are merged in
+ * order.
+ */
+class ScalingStatistics
+{
+ public:
+  /**
+   * Create empty statistics.
+   *
+   * @param covariance Whether to accumulate the covariance of the dimensions.
+   */
+  ScalingStatistics(const bool covariance = false) :
+      covariance(covariance),
+      count(0)
+  { }
+
+  /**
+   * Add the points of the given matrix (one per column) to the statistics.
+   * Throws std::invalid_argument if the dimensionality of the points is not
+   * the dimensionality of the points added before.
+   *
+   * @param input Points to add.
+   */
+  template<typename MatType>
+  void Update(const MatType& input)
+  {
+    if (count > 0 && input.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "ScalingStatistics::Update(): the points have " << input.n_rows
+          << " dimensions, but the points added before have " << mean.n_elem
+          << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (input.n_cols == 0)
+      return;
+
+    #ifdef HAS_OPENMP
+    const size_t numChunks = std::max((size_t) 1, std::min(
+        (size_t) omp_get_max_threads(), (size_t) input.n_cols / BlockSize(
+        input.n_rows)));
+    #else
+    const size_t numChunks = 1;
+    #endif
+
+    std::vector<ScalingStatistics> chunks(numChunks,
+        ScalingStatistics(covariance));
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t begin = c * input.n_cols / numChunks;
+      const size_t end = (c + 1) * input.n_cols / numChunks;
+      const size_t blockSize = BlockSize(input.n_rows);
+      for (size_t b = begin; b < end; b += blockSize)
+      {
+        chunks[c].UpdateBlock(arma::conv_to<arma::mat>::from(
+            input.cols(b, std::min(b + blockSize, end) - 1)));
+      }
+    }
+
+    for (size_t c = 0; c < numChunks; ++c)
+      Merge(chunks[c]);
+  }
+
+  /**
+   * Merge the given statistics into these statistics, as if the points of the
+   * other statistics had been added.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const ScalingStatistics& other)
+  {
+    if (other.count == 0)
+      return;
+
+    if (covariance && !other.covariance)
+    {
+      throw std::invalid_argument("ScalingStatistics::Merge(): the merged "
+          "statistics have no covariance");
+    }
+
+    if (count == 0)
+    {
+      const bool keepCovariance = covariance;
+      *this = other;
+      covariance = keepCovariance;
+      if (!covariance)
+        comoment.reset();
+      return;
+    }
+
+    if (other.mean.n_elem != mean.n_elem)
+    {
+      throw std::invalid_argument("ScalingStatistics::Merge(): the "
+          "statistics have different dimensionalities");
+    }
+
+    const double total = (double) (count + other.count);
+    const arma::vec delta = other.mean - mean;
+    const double weight = ((double) count) * ((double) other.count) / total;
+
+    mean += delta * (((double) other.count) / total);
+    m2 += other.m2 + arma::square(delta) * weight;
+    if (covariance)
+      comoment += other.comoment + (delta * delta.t()) * weight;
+    min = arma::min(min, other.min);
+    max = arma::max(max, other.max);
+    count += other.count;
+  }
+
+  //! Forget all the points.
+  void Reset()
+  {
+    count = 0;
+    mean.reset();
+    m2.reset();
+    min.reset();
+    max.reset();
+    comoment.reset();
+  }
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the mean of each dimension.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the minimum of each dimension.
+  const arma::vec& Min() const { return min; }
+  //! Get the maximum of each dimension.
+  const arma::vec& Max() const { return max; }
+
+  /**
+   * Get the variance of each dimension.
+   *
+   * @param unbiased If true, divide by the number of points minus one (if there
+   *     is more than one point); otherwise, divide by the number of points.
+   */
+  arma::vec Variance(const bool unbiased = false) const
+  {
+    return m2 / Normalizer(unbiased);
+  }
+
+  /**
+   * Get the covariance matrix of the dimensions; the statistics must have been
+   * created with covariance = true.
+   *
+   * @param unbiased If true, divide by the number of points minus one (if there
+   *     is more than one point); otherwise, divide by the number of points.
+   */
+  arma::mat Covariance(const bool unbiased = false) const
+  {
+    if (!covariance)
+    {
+      throw std::invalid_argument("ScalingStatistics::Covariance(): the "
+          "covariance was not accumulated");
+    }
+
+    return comoment / Normalizer(unbiased);
+  }
+
+ private:
+  //! Get the number of columns of the blocks, so that a block takes ~256kB.
+  static size_t BlockSize(const size_t dimensionality)
+  {
+    return std::max((size_t) 1, (size_t) 32768 /
+        std::max((size_t) 1, dimensionality));
+  }
+
+  //! Get the value to divide the sums of squared deviations by.
+  double Normalizer(const bool unbiased) const
+  {
+    return (unbiased && count > 1) ? (double) (count - 1) :
+        (double) std::max(count, (size_t) 1);
+  }
+
+  //! Add a block of points, reading it twice.
+  void UpdateBlock(const arma::mat& block)
+  {
+    ScalingStatistics blockStatistics(covariance);
+    blockStatistics.count = block.n_cols;
+    blockStatistics.mean = arma::mean(block, 1);
+    blockStatistics.min = arma::min(block, 1);
+    blockStatistics.max = arma::max(block, 1);
+
+    const arma::mat centered = block.each_col() - blockStatistics.mean;
+    blockStatistics.m2 = arma::sum(arma::square(centered), 1);
+    if (covariance)
+      blockStatistics.comoment = centered * centered.t();
+
+    Merge(blockStatistics);
+  }
+
+  //! Whether the covariance is accumulated.
+  bool covariance;
+  //! The number of points.
+  size_t count;
+  //! The mean of each dimension.
+  arma::vec mean;
+  //! The sum of the squared deviations from the mean of each dimension.
+  arma::vec m2;
+  //! The minimum of each dimension.
+  arma::vec min;
+  //! The maximum of each dimension.
+  arma::vec max;
+  //! The sums of the products of the deviations from the mean.
+  arma::mat comoment;
+};
+
+/**
+ * Apply the given function to each element of the input, writing the result
+ * to the output.  The output can be the input itself, to transform a dataset
+ * in place.  The columns are processed in parallel when mlpack is compiled
+ * with OpenMP.
+ *
+ * @param input Dense matrix to transform.
+ * @param output Matrix to write the result to; can be the input.
+ * @param f Function of the value of an element and of its row.
+ */
+template<typename MatType, typename FunctionType>
+void TransformElements(const MatType& input,
+                       MatType& output,
+                       const FunctionType& f)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (&input != &output)
+    output.set_size(input.n_rows, input.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+  {
+    const ElemType* in = input.colptr(j);
+    ElemType* out = output.colptr(j);
+    for (size_t i = 0; i < input.n_rows; ++i)
+      out[i] = (ElemType) f((double) in[i], i);
+  }
+}
+
+/**
+ * Compute transformation * (input - mean) block by block, writing the result
+ * to the output, so that the only temporaries are the size of a block.  The
+ * output can be the input itself, if the transformation is square.
+ *
+ * @param input Dense matrix to transform.
+ * @param output Matrix to write the result to; can be the input.
+ * @param transformation Matrix to multiply the centered points by.
+ * @param mean Vector to subtract from the points.
+ */
+template<typename MatType>
+void TransformCentered(const MatType& input,
+                       MatType& output,
+                       const arma::mat& transformation,
+                       const arma::vec& mean)
+{
+  if (&input == &output && transformation.n_rows != input.n_rows)
+  {
+    throw std::invalid_argument("TransformCentered(): the output can only be "
+        "the input for square transformations");
+  }
+
+  const size_t nCols = input.n_cols;
+  if (&input != &output)
+    output.set_size(transformation.n_rows, nCols);
+
+  // Each block takes ~256kB; the multiplications are parallelized by BLAS.
+  const size_t blockSize = std::max((size_t) 1, (size_t) 32768 /
+      std::max((size_t) 1, (size_t) input.n_rows));
+  for (size_t b = 0; b < nCols; b += blockSize)
+  {
+    const size_t end = std::min(b + blockSize, nCols) - 1;
+    arma::mat block = arma::conv_to<arma::mat>::from(input.cols(b, end));
+    block.each_col() -= mean;
+    output.cols(b, end) = arma::conv_to<MatType>::from(transformation * block);
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_STANDARD_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "scaling_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -55,8 +56,24 @@ class StandardScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemStdDev = arma::stddev(input, 1, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features on one more chunk of the dataset, updating the
+   * statistics of the chunks given since the last call to Fit(), so that a
+   * dataset too large for memory can be fitted one chunk at a time.  The
+   * statistics are not serialized, so after loading, fitting starts over.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    itemMean = statistics.Mean();
+    itemStdDev = arma::sqrt(statistics.Variance());
     // Handle zeros in scale vector.
     itemStdDev.for_each([](arma::vec::elem_type& val) { val =
         (val == 0) ? 1 : val; });
@@ -76,8 +93,9 @@ class StandardScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / itemStdDev;
+    // The output can be the input, to scale a dataset in place.
+    TransformElements(input, output, [this](const double x, const size_t i)
+        { return (x - itemMean[i]) / itemStdDev[i]; });
   }
 
   /**
@@ -89,8 +107,8 @@ class StandardScaler
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() % itemStdDev).each_col() + itemMean;
+    TransformElements(input, output, [this](const double x, const size_t i)
+        { return x * itemStdDev[i] + itemMean[i]; });
   }
 
   //! Get the mean row vector.
@@ -110,6 +128,8 @@ class StandardScaler
   arma::vec itemMean;
   // Vector which holds standard devation of each feature.
   arma::vec itemStdDev;
+  // Statistics of the chunks given to PartialFit().
+  ScalingStatistics statistics;
 }; // class StandardScaler
 
 } // namespace data
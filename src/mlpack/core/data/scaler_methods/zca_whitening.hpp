@@ -65,6 +65,19 @@ class ZCAWhitening
     pca.Fit(input);
   }
 
+  /**
+   * Function to fit features on one more chunk of the dataset, updating the
+   * statistics of the chunks given since the last call to Fit() (see
+   * PCAWhitening::PartialFit()).
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    pca.PartialFit(input);
+  }
+
   /**
    * Function for ZCA whitening.
    *
@@ -74,8 +87,16 @@ class ZCAWhitening
   template<typename MatType>
   void Transform(const MatType& input, MatType& output)
   {
-    pca.Transform(input, output);
-    output = pca.EigenVectors() * output;
+    if (pca.EigenValues().is_empty() || pca.EigenVectors().is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+          " refer to the documentation.");
+    }
+
+    // The output can be the input, to whiten a dataset in place.
+    TransformCentered(input, output, pca.EigenVectors() * arma::diagmat(1.0 /
+        (arma::sqrt(pca.EigenValues()))) * pca.EigenVectors().t(),
+        pca.ItemMean());
   }
 
   /**
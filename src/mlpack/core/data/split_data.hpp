@@ -14,6 +14,7 @@
 #define MLPACK_CORE_DATA_SPLIT_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
 namespace mlpack {
 namespace data {
@@ -70,13 +71,15 @@ void Split(const arma::Mat<T>& input,
         0, input.n_cols - 1, input.n_cols));
     if (trainSize > 0)
     {
-      trainData = input.cols(order.subvec(0, trainSize - 1));
-      trainLabel = inputLabel.cols(order.subvec(0, trainSize - 1));
+      const arma::uvec trainOrder = order.subvec(0, trainSize - 1);
+      math::GatherColumns(input, trainOrder, trainData);
+      math::GatherColumns(inputLabel, trainOrder, trainLabel);
     }
     if (trainSize < input.n_cols)
     {
-    testData = input.cols(order.subvec(trainSize, input.n_cols - 1));
-    testLabel = inputLabel.cols(order.subvec(trainSize, input.n_cols - 1));
+      const arma::uvec testOrder = order.subvec(trainSize, input.n_cols - 1);
+      math::GatherColumns(input, testOrder, testData);
+      math::GatherColumns(inputLabel, testOrder, testLabel);
     }
   }
   else
@@ -135,10 +138,16 @@ void Split(const arma::Mat<T>& input,
         0, input.n_cols - 1, input.n_cols));
 
     if (trainSize > 0)
-      trainData = input.cols(order.subvec(0, trainSize - 1));
+    {
+      math::GatherColumns(input, arma::uvec(order.subvec(0, trainSize - 1)),
+          trainData);
+    }
 
     if (trainSize < input.n_cols)
-      testData = input.cols(order.subvec(trainSize, input.n_cols - 1));
+    {
+      math::GatherColumns(input,
+          arma::uvec(order.subvec(trainSize, input.n_cols - 1)), testData);
+    }
   }
   else
   {
@@ -224,6 +233,100 @@ Split(const arma::Mat<T>& input,
                          std::move(testData));
 }
 
+/**
+ * Split the indices of the points of a dataset into the indices of a training
+ * set and of a test set, as Split() would, without copying any data.  The
+ * points can then be used through views, such as input.cols(trainIndices),
+ * or copied with math::GatherColumns(), which is parallel; an optimizer can
+ * also visit the points in the order of the indices.
+ *
+ * @code
+ * arma::uvec trainIndices, testIndices;
+ * SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+ * @endcode
+ *
+ * @param numPoints Number of points of the dataset.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ */
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio,
+                         const bool shuffleData = true)
+{
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  trainIndices = (trainSize > 0) ? arma::uvec(order.subvec(0, trainSize - 1)) :
+      arma::uvec();
+  testIndices = (trainSize < numPoints) ?
+      arma::uvec(order.subvec(trainSize, numPoints - 1)) : arma::uvec();
+}
+
+/**
+ * Given an input dataset and labels, split them into a training set and a test
+ * set in place: the points (and labels) are shuffled in place if shuffleData
+ * is true, so that the training set is made of the first columns and the test
+ * set of the last columns.  No copy of the dataset is made; the two sets can be
+ * used through views, such as input.cols(0, trainSize - 1).
+ *
+ * @code
+ * const size_t trainSize = SplitInPlace(input, label, 0.3);
+ * // Use input.cols(0, trainSize - 1) for training...
+ * @endcode
+ *
+ * @param input Input dataset to split.
+ * @param inputLabel Input labels to split.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ * @return The number of points of the training set.
+ */
+template<typename T, typename U>
+size_t SplitInPlace(arma::Mat<T>& input,
+                    arma::Row<U>& inputLabel,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  if (shuffleData)
+    math::ShuffleDataInPlace(input, inputLabel);
+
+  return input.n_cols - static_cast<size_t>(input.n_cols * testRatio);
+}
+
+/**
+ * Given an input dataset, split it into a training set and a test set in
+ * place, as SplitInPlace(input, inputLabel, testRatio, shuffleData) does.
+ *
+ * @param input Input dataset to split.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true).
+ * @return The number of points of the training set.
+ */
+template<typename T>
+size_t SplitInPlace(arma::Mat<T>& input,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  if (shuffleData)
+  {
+    const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+        input.n_cols - 1, input.n_cols));
+    math::PermuteColumns(input, ordering);
+  }
+
+  return input.n_cols - static_cast<size_t>(input.n_cols * testRatio);
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -0,0 +1,143 @@
+/**
+ * @file core/data/string_arena.hpp
+ *
+ * Definition of the StringArena class, which stores many small strings in a
+ * few large blocks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STRING_ARENA_HPP
+#define MLPACK_CORE_DATA_STRING_ARENA_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
+#include <cstring>
+#include <memory>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The StringArena class copies strings into large blocks of memory and returns
+ * views of the copies.  Since a block is allocated only when the previous one
+ * is full, storing many short strings (such as the tokens of a dictionary)
+ * takes a few allocations instead of one per string.  The strings can only be
+ * released all at once, with Clear().
+ *
+ * The views stay valid until the arena is cleared or destroyed; moving the
+ * arena does not invalidate them, since the blocks themselves do not move.
+ */
+class StringArena
+{
+ public:
+  /**
+   * Create an empty arena.
+   *
+   * @param blockSize Size of the blocks, in bytes.  Strings longer than the
+   *     block size get a block of their own.
+   */
+  StringArena(const size_t blockSize = 65536) :
+      blockSize(std::max(blockSize, (size_t) 1)),
+      used(0),
+      capacity(0)
+  { }
+
+  //! The views of the strings belong to the arena, so it can't be copied.
+  StringArena(const StringArena&) = delete;
+  //! The views of the strings belong to the arena, so it can't be copied.
+  StringArena& operator=(const StringArena&) = delete;
+
+  //! Take the blocks of the given arena, leaving it empty.
+  StringArena(StringArena&& other) :
+      blockSize(other.blockSize),
+      blocks(std::move(other.blocks)),
+      used(other.used),
+      capacity(other.capacity)
+  {
+    other.Clear();
+  }
+
+  //! Take the blocks of the given arena, leaving it empty.
+  StringArena& operator=(StringArena&& other)
+  {
+    if (this != &other)
+    {
+      blockSize = other.blockSize;
+      blocks = std::move(other.blocks);
+      used = other.used;
+      capacity = other.capacity;
+      other.Clear();
+    }
+
+    return *this;
+  }
+
+  /**
+   * Copy the given string into the arena and return a view of the copy.
+   *
+   * @param str String to store.
+   */
+  boost::string_view Add(const boost::string_view str)
+  {
+    if (str.empty())
+      return boost::string_view();
+
+    if (str.size() > capacity - used)
+    {
+      // Long strings get a block of their own, so the current block can still
+      // be filled with short strings.
+      if (str.size() > blockSize)
+      {
+        blocks.emplace_back(new char[str.size()]);
+        std::memcpy(blocks.back().get(), str.data(), str.size());
+        const char* copy = blocks.back().get();
+        // Keep the current block at the end of the list.
+        if (blocks.size() > 1)
+          std::swap(blocks[blocks.size() - 1], blocks[blocks.size() - 2]);
+
+        return boost::string_view(copy, str.size());
+      }
+
+      blocks.emplace_back(new char[blockSize]);
+      used = 0;
+      capacity = blockSize;
+    }
+
+    char* copy = blocks.back().get() + used;
+    std::memcpy(copy, str.data(), str.size());
+    used += str.size();
+
+    return boost::string_view(copy, str.size());
+  }
+
+  //! Release all the strings of the arena.
+  void Clear()
+  {
+    blocks.clear();
+    used = 0;
+    capacity = 0;
+  }
+
+  //! Get the number of blocks allocated by the arena.
+  size_t NumBlocks() const { return blocks.size(); }
+  //! Get the size of the blocks.
+  size_t BlockSize() const { return blockSize; }
+
+ private:
+  //! The size of the blocks.
+  size_t blockSize;
+  //! The blocks of memory; the last one is the one being filled.
+  std::vector<std::unique_ptr<char[]>> blocks;
+  //! The number of bytes used in the last block.
+  size_t used;
+  //! The size of the last block (0 if there are no blocks).
+  size_t capacity;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -97,7 +97,9 @@ class StringEncoding
    *
    * If the output type is either arma::mat or arma::sp_mat then the function
    * writes it in the column-major order. If the output type is 2D std::vector
-   * then the function writes it in the row major order.
+   * then the function writes it in the row major order.  Policies that hash
+   * the tokens (such as HashingEncodingPolicy) don't use the dictionary, only
+   * support arma::mat and arma::sp_mat, and encode the strings in parallel.
    *
    * @tparam OutputType Type of the output container. The function supports
    *                    the following types: arma::mat, arma::sp_mat,
@@ -202,6 +204,77 @@ class StringEncoding
                     typename std::enable_if<StringEncodingPolicyTraits<
                         PolicyType>::onePassEncoding>::type* = 0);
 
+  /**
+   * A helper function to encode the given text and write the result to
+   * the given sparse matrix, for policies that hash the tokens instead of
+   * using the dictionary.  The items are encoded in parallel, and written in
+   * the column-major order.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   * @tparam PolicyType The type of the encoding policy. It has to be
+   *                    equal to EncodingPolicyType.
+   * @tparam ElemType Type of the output values.
+   *
+   * @param input Corpus of text to encode.
+   * @param output Output matrix to store the result.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object.
+   */
+  template<typename TokenizerType, typename PolicyType, typename ElemType>
+  void EncodeHelper(const std::vector<std::string>& input,
+                    arma::SpMat<ElemType>& output,
+                    const TokenizerType& tokenizer,
+                    PolicyType& policy,
+                    typename std::enable_if<StringEncodingPolicyTraits<
+                        PolicyType>::hashedEncoding>::type* = 0);
+
+  /**
+   * A helper function to encode the given text and write the result to
+   * the given dense matrix, for policies that hash the tokens instead of using
+   * the dictionary.  The items are encoded in parallel, and written in the
+   * column-major order.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   * @tparam PolicyType The type of the encoding policy. It has to be
+   *                    equal to EncodingPolicyType.
+   * @tparam ElemType Type of the output values.
+   *
+   * @param input Corpus of text to encode.
+   * @param output Output matrix to store the result.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object.
+   */
+  template<typename TokenizerType, typename PolicyType, typename ElemType>
+  void EncodeHelper(const std::vector<std::string>& input,
+                    arma::Mat<ElemType>& output,
+                    const TokenizerType& tokenizer,
+                    PolicyType& policy,
+                    typename std::enable_if<StringEncodingPolicyTraits<
+                        PolicyType>::hashedEncoding>::type* = 0);
+
+  /**
+   * Extract the tokens of the given strings, add the new ones to the
+   * dictionary, and get the label of every token.  The strings are split into
+   * one contiguous chunk per thread, and each thread collects the distinct
+   * tokens of its chunk in a dictionary of its own.  Then the distinct tokens
+   * of the chunks are added to the dictionary in order, so the labels are the
+   * same as if the strings were processed one after another, and the
+   * dictionary sees each distinct token of a chunk only once.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   *
+   * @param input Corpus of text to encode.
+   * @param tokenizer The tokenizer object; it is called from several threads.
+   * @param labels The labels of the tokens of all the strings.
+   * @param offsets The labels of the tokens of the i-th string are
+   *     labels[offsets[i]] to labels[offsets[i + 1] - 1].
+   */
+  template<typename TokenizerType>
+  void LabelTokens(const std::vector<std::string>& input,
+                   const TokenizerType& tokenizer,
+                   std::vector<size_t>& labels,
+                   std::vector<size_t>& offsets);
+
  private:
   //! The encoding policy object.
   EncodingPolicyType encodingPolicy;
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
+#include <mlpack/core/data/string_arena.hpp>
 #include <unordered_map>
 #include <deque>
 #include <array>
@@ -106,6 +107,9 @@ class StringEncodingDictionary
 
 /*
  * Specialization of the StringEncodingDictionary class for boost::string_view.
+ * The tokens are copied into a StringArena, so adding a token doesn't allocate
+ * a string of its own; TokenViews() gives the tokens as views of the arena, and
+ * Tokens() gives copies of them as strings.
  */
 template<>
 class StringEncodingDictionary<boost::string_view>
@@ -124,11 +128,13 @@ class StringEncodingDictionary<boost::string_view>
   StringEncodingDictionary() = default;
 
   //! Copy the class from the given object.
-  StringEncodingDictionary(const StringEncodingDictionary& other) :
-      tokens(other.tokens)
+  StringEncodingDictionary(const StringEncodingDictionary& other)
   {
-    for (const std::string& token : tokens)
-      mapping[token] = other.mapping.at(token);
+    for (const boost::string_view token : other.tokenViews)
+    {
+      tokenViews.push_back(arena.Add(token));
+      mapping[tokenViews.back()] = other.mapping.at(token);
+    }
   }
 
   //! Standard move constructor.
@@ -137,11 +143,16 @@ class StringEncodingDictionary<boost::string_view>
   //! Copy the class from the given object.
   StringEncodingDictionary& operator=(const StringEncodingDictionary& other)
   {
-    tokens = other.tokens;
-    mapping.clear();
+    if (this == &other)
+      return *this;
 
-    for (const std::string& token : tokens)
-      mapping[token] = other.mapping.at(token);
+    Clear();
+
+    for (const boost::string_view token : other.tokenViews)
+    {
+      tokenViews.push_back(arena.Add(token));
+      mapping[tokenViews.back()] = other.mapping.at(token);
+    }
 
     return *this;
   }
@@ -169,11 +180,11 @@ class StringEncodingDictionary<boost::string_view>
    */
   size_t AddToken(const boost::string_view token)
   {
-    tokens.emplace_back(token);
+    tokenViews.push_back(arena.Add(token));
 
     size_t size = mapping.size();
 
-    mapping[tokens.back()] = ++size;
+    mapping[tokenViews.back()] = ++size;
 
     return size;
   }
@@ -196,13 +207,33 @@ class StringEncodingDictionary<boost::string_view>
   void Clear()
   {
     mapping.clear();
+    tokenViews.clear();
     tokens.clear();
+    arena.Clear();
+  }
+
+  /**
+   * Get the tokens, in the order they were added.  The strings are copied from
+   * the arena the first time they are requested, so this is slower than
+   * TokenViews() and must not be called by several threads at once.
+   */
+  const std::deque<std::string>& Tokens() const
+  {
+    CopyTokens();
+    return tokens;
+  }
+  //! Modify the tokens.  The dictionary itself is not affected by the changes.
+  std::deque<std::string>& Tokens()
+  {
+    CopyTokens();
+    return tokens;
   }
 
-  //! Get the tokens.
-  const std::deque<std::string>& Tokens() const { return tokens; }
-  //! Modify the tokens.
-  std::deque<std::string>& Tokens() { return tokens; }
+  //! Get the tokens, in the order they were added, as views of the arena.
+  const std::deque<boost::string_view>& TokenViews() const
+  {
+    return tokenViews;
+  }
 
   //! Get the mapping.
   const MapType& Mapping() const { return mapping; }
@@ -215,38 +246,58 @@ class StringEncodingDictionary<boost::string_view>
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */)
   {
-    size_t numTokens = tokens.size();
+    size_t numTokens = tokenViews.size();
 
     ar & BOOST_SERIALIZATION_NVP(numTokens);
 
     if (Archive::is_loading::value)
     {
-      tokens.resize(numTokens);
+      Clear();
 
-      for (std::string& token : tokens)
+      for (size_t i = 0; i < numTokens; ++i)
       {
+        std::string token;
         ar & BOOST_SERIALIZATION_NVP(token);
 
         size_t tokenValue = 0;
         ar & BOOST_SERIALIZATION_NVP(tokenValue);
-        mapping[token] = tokenValue;
+
+        tokenViews.push_back(arena.Add(token));
+        mapping[tokenViews.back()] = tokenValue;
       }
     }
     if (Archive::is_saving::value)
     {
-      for (std::string& token : tokens)
+      for (const boost::string_view tokenView : tokenViews)
       {
+        std::string token(tokenView.data(), tokenView.size());
         ar & BOOST_SERIALIZATION_NVP(token);
 
-        size_t tokenValue = mapping.at(token);
+        size_t tokenValue = mapping.at(tokenView);
         ar & BOOST_SERIALIZATION_NVP(tokenValue);
       }
     }
   }
 
  private:
-  //! The tokens that the dictionary stores.
-  std::deque<std::string> tokens;
+  //! Copy the tokens that were added since the last call into the strings.
+  void CopyTokens() const
+  {
+    if (tokens.size() > tokenViews.size())
+      tokens.clear();
+
+    for (size_t i = tokens.size(); i < tokenViews.size(); ++i)
+      tokens.emplace_back(tokenViews[i].data(), tokenViews[i].size());
+  }
+
+  //! The memory that holds the tokens.
+  StringArena arena;
+
+  //! The tokens that the dictionary stores, as views of the arena.
+  std::deque<boost::string_view> tokenViews;
+
+  //! Copies of the tokens, made by Tokens().
+  mutable std::deque<std::string> tokens;
 
   //! The mapping itself.
   MapType mapping;
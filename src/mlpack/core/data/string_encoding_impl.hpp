@@ -17,6 +17,10 @@
 #include "string_encoding.hpp"
 #include <type_traits>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace data {
 
@@ -105,94 +109,268 @@ EncodeHelper(const std::vector<std::string>& input,
              const TokenizerType& tokenizer,
              PolicyType& policy)
 {
+  static_assert(!StringEncodingPolicyTraits<PolicyType>::hashedEncoding,
+      "Policies that hash the tokens only support arma::mat and arma::sp_mat "
+      "outputs.");
+
+  std::vector<size_t> labels, offsets;
+  LabelTokens(input, tokenizer, labels, offsets);
+
   size_t numColumns = 0;
 
   policy.Reset();
 
-  // The first pass adds the extracted tokens to the dictionary.
+  // The first pass collects the statistics of the tokens.
   for (size_t i = 0; i < input.size(); ++i)
   {
-    boost::string_view strView(input[i]);
-    auto token = tokenizer(strView);
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      policy.PreprocessToken(i, j - offsets[i], labels[j]);
 
-    static_assert(
-        std::is_same<typename std::remove_reference<decltype(token)>::type,
-                     typename std::remove_reference<typename DictionaryType::
-                        TokenType>::type>::value,
-        "The dictionary token type doesn't match the return value type "
-        "of the tokenizer.");
+    numColumns = std::max(numColumns, offsets[i + 1] - offsets[i]);
+  }
 
-    size_t numTokens = 0;
+  policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
 
-    while (!tokenizer.IsTokenEmpty(token))
-    {
-      if (!dictionary.HasToken(token))
-        dictionary.AddToken(std::move(token));
+  // The second pass writes the encoded values to the output.
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      policy.Encode(output, labels[j], i, j - offsets[i]);
+  }
+}
 
-      policy.PreprocessToken(i, numTokens, dictionary.Value(token));
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType, typename PolicyType, typename ElemType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::
+EncodeHelper(const std::vector<std::string>& input,
+             std::vector<std::vector<ElemType>>& output,
+             const TokenizerType& tokenizer,
+             PolicyType& policy,
+             typename std::enable_if<StringEncodingPolicyTraits<
+                 PolicyType>::onePassEncoding>::type*)
+{
+  std::vector<size_t> labels, offsets;
+  LabelTokens(input, tokenizer, labels, offsets);
 
-      token = tokenizer(strView);
-      numTokens++;
-    }
+  policy.Reset();
 
-    numColumns = std::max(numColumns, numTokens);
-  }
+  // The loop below writes the encoded values of each string at once.
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    output.emplace_back();
 
-  policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      policy.Encode(output.back(), labels[j]);
+  }
+}
 
-  // The second pass writes the encoded values to the output.
-  for (size_t i = 0; i < input.size(); ++i)
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType, typename PolicyType, typename ElemType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::
+EncodeHelper(const std::vector<std::string>& input,
+             arma::SpMat<ElemType>& output,
+             const TokenizerType& tokenizer,
+             PolicyType& policy,
+             typename std::enable_if<StringEncodingPolicyTraits<
+                 PolicyType>::hashedEncoding>::type*)
+{
+  // Each string is encoded on its own, so the strings are split over the
+  // threads.  The entries of each column are collected, sorted by row, and
+  // the entries with the same row are added up.
+  std::vector<std::vector<std::pair<arma::uword, ElemType>>> columns(
+      input.size());
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) input.size(); ++i)
   {
+    std::vector<std::pair<arma::uword, ElemType>>& column = columns[i];
+
     boost::string_view strView(input[i]);
     auto token = tokenizer(strView);
-    size_t numTokens = 0;
-
+    size_t row;
+    ElemType value;
     while (!tokenizer.IsTokenEmpty(token))
     {
-      policy.Encode(output, dictionary.Value(token), i, numTokens);
+      policy.Encode(token, row, value);
+      column.emplace_back(arma::uword(row), value);
       token = tokenizer(strView);
-      numTokens++;
+    }
+
+    std::sort(column.begin(), column.end(),
+        [](const std::pair<arma::uword, ElemType>& a,
+           const std::pair<arma::uword, ElemType>& b)
+        {
+          return a.first < b.first;
+        });
+
+    // Merge the entries of the same row, and drop the ones that cancel out.
+    size_t last = 0;
+    for (size_t j = 0; j < column.size(); ++j)
+    {
+      if (last > 0 && column[last - 1].first == column[j].first)
+        column[last - 1].second += column[j].second;
+      else
+        column[last++] = column[j];
+
+      if (column[last - 1].second == ElemType(0))
+        --last;
+    }
+    column.resize(last);
+  }
+
+  // Now assemble the matrix in the compressed sparse column format.
+  arma::uvec colPointers(input.size() + 1);
+  colPointers[0] = 0;
+  for (size_t i = 0; i < input.size(); ++i)
+    colPointers[i + 1] = colPointers[i] + columns[i].size();
+
+  arma::uvec rowIndices(colPointers[input.size()]);
+  arma::Col<ElemType> values(colPointers[input.size()]);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) input.size(); ++i)
+  {
+    for (size_t j = 0; j < columns[i].size(); ++j)
+    {
+      rowIndices[colPointers[i] + j] = columns[i][j].first;
+      values[colPointers[i] + j] = columns[i][j].second;
     }
   }
+
+  output = arma::SpMat<ElemType>(rowIndices, colPointers, values,
+      policy.NumFeatures(), input.size());
 }
 
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename TokenizerType, typename PolicyType, typename ElemType>
 void StringEncoding<EncodingPolicyType, DictionaryType>::
 EncodeHelper(const std::vector<std::string>& input,
-             std::vector<std::vector<ElemType>>& output,
+             arma::Mat<ElemType>& output,
              const TokenizerType& tokenizer,
              PolicyType& policy,
              typename std::enable_if<StringEncodingPolicyTraits<
-                 PolicyType>::onePassEncoding>::type*)
+                 PolicyType>::hashedEncoding>::type*)
 {
-  policy.Reset();
+  output.zeros(policy.NumFeatures(), input.size());
 
-  // The loop below extracts the tokens and writes the encoded values
-  // at once.
-  for (size_t i = 0; i < input.size(); ++i)
+  // Each string is encoded into its own column, so the strings are split over
+  // the threads.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) input.size(); ++i)
   {
     boost::string_view strView(input[i]);
     auto token = tokenizer(strView);
+    size_t row;
+    ElemType value;
+    while (!tokenizer.IsTokenEmpty(token))
+    {
+      policy.Encode(token, row, value);
+      output(row, i) += value;
+      token = tokenizer(strView);
+    }
+  }
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::LabelTokens(
+    const std::vector<std::string>& input,
+    const TokenizerType& tokenizer,
+    std::vector<size_t>& labels,
+    std::vector<size_t>& offsets)
+{
+  using TokenType = typename std::remove_reference<
+      typename DictionaryType::TokenType>::type;
 
-    static_assert(
-        std::is_same<typename std::remove_reference<decltype(token)>::type,
-                     typename std::remove_reference<typename DictionaryType::
-                        TokenType>::type>::value,
-        "The dictionary token type doesn't match the return value type "
-        "of the tokenizer.");
+  static_assert(
+      std::is_same<typename std::remove_reference<decltype(
+                       tokenizer(std::declval<boost::string_view&>()))>::type,
+                   TokenType>::value,
+      "The dictionary token type doesn't match the return value type "
+      "of the tokenizer.");
 
-    output.emplace_back();
+  #ifdef HAS_OPENMP
+  const size_t numChunks = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), input.size()));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  // Each chunk gets a dictionary of its own, the distinct tokens of the chunk
+  // in the order they were found, and the labels of its tokens in that
+  // dictionary.  The tokens are views of the input whenever the tokenizer
+  // returns views, so they are not copied.
+  std::vector<DictionaryType> chunkDictionaries(numChunks);
+  std::vector<std::vector<TokenType>> chunkTokens(numChunks);
+  std::vector<std::vector<size_t>> chunkLabels(numChunks);
+
+  // For now, offsets[i + 1] holds the number of tokens of the i-th string.
+  offsets.assign(input.size() + 1, 0);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = c * input.size() / numChunks;
+    const size_t end = (c + 1) * input.size() / numChunks;
+    DictionaryType& chunkDictionary = chunkDictionaries[c];
 
-    while (!tokenizer.IsTokenEmpty(token))
+    for (size_t i = begin; i < end; ++i)
+    {
+      boost::string_view strView(input[i]);
+      auto token = tokenizer(strView);
+      size_t numTokens = 0;
+
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        if (chunkDictionary.HasToken(token))
+        {
+          chunkLabels[c].push_back(chunkDictionary.Value(token));
+        }
+        else
+        {
+          chunkTokens[c].push_back(token);
+          chunkLabels[c].push_back(chunkDictionary.AddToken(std::move(token)));
+        }
+
+        token = tokenizer(strView);
+        numTokens++;
+      }
+
+      offsets[i + 1] = numTokens;
+    }
+  }
+
+  // Add the distinct tokens of each chunk to the dictionary, in order, and
+  // find the label of each of them in the dictionary.
+  std::vector<std::vector<size_t>> chunkToDictionary(numChunks);
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    chunkToDictionary[c].resize(chunkTokens[c].size() + 1);
+    for (size_t j = 0; j < chunkTokens[c].size(); ++j)
     {
+      TokenType& token = chunkTokens[c][j];
       if (dictionary.HasToken(token))
-        policy.Encode(output[i], dictionary.Value(token));
+        chunkToDictionary[c][j + 1] = dictionary.Value(token);
       else
-        policy.Encode(output[i], dictionary.AddToken(std::move(token)));
-
-      token = tokenizer(strView);
+        chunkToDictionary[c][j + 1] = dictionary.AddToken(std::move(token));
     }
+
+    // The chunk dictionary is not needed anymore.
+    chunkDictionaries[c].Clear();
+  }
+
+  for (size_t i = 0; i < input.size(); ++i)
+    offsets[i + 1] += offsets[i];
+
+  labels.resize(offsets[input.size()]);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    // The labels of a chunk are contiguous, since its strings are.
+    const size_t begin = offsets[c * input.size() / numChunks];
+    for (size_t j = 0; j < chunkLabels[c].size(); ++j)
+      labels[begin + j] = chunkToDictionary[c][chunkLabels[c][j]];
   }
 }
 
@@ -0,0 +1,216 @@
+/**
+ * @file core/data/string_encoding_policies/hashing_encoding_policy.hpp
+ *
+ * Definition of the HashingEncodingPolicy class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STR_ENCODING_POLICIES_HASHING_ENCODING_POLICY_HPP
+#define MLPACK_CORE_DATA_STR_ENCODING_POLICIES_HASHING_ENCODING_POLICY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
+#include <mlpack/core/data/string_encoding_policies/policy_traits.hpp>
+#include <mlpack/core/data/string_encoding.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Definition of the HashingEncodingPolicy class.
+ *
+ * HashingEncodingPolicy is used as a helper class for StringEncoding.  It
+ * implements the hashing trick of Weinberger et al.:
+ *
+ * @code
+ * @inproceedings{weinberger2009feature,
+ *   title={Feature Hashing for Large Scale Multitask Learning},
+ *   author={Weinberger, K. and Dasgupta, A. and Langford, J. and Smola, A. and
+ *       Attenberg, J.},
+ *   booktitle={Proceedings of the 26th Annual International Conference on
+ *       Machine Learning (ICML '09)},
+ *   pages={1113--1120},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * The encoder maps each dataset item to a vector of a fixed size N: each token
+ * is hashed, and the coordinate given by the hash modulo N is incremented (or,
+ * if signed hashing is used, incremented or decremented depending on another
+ * bit of the hash, so that the collisions cancel out in expectation).  So, like
+ * BagOfWordsEncodingPolicy, the output holds the token counts of each item,
+ * but no dictionary is built: the memory used does not depend on the number of
+ * distinct tokens, the encoding of an item does not depend on the other items,
+ * and the items are encoded in parallel when OpenMP is available.  The
+ * dictionary of the StringEncoding object stays empty.
+ *
+ * The encoder writes data in the column-major order, to an arma::sp_mat or an
+ * arma::mat.  The hash only depends on the bytes of the token and the seed, so
+ * the encoding is the same on every platform.
+ *
+ * @code
+ * HashingEncoding<SplitByAnyOf::TokenType> encoder(1 << 20);
+ * arma::sp_mat output;
+ * encoder.Encode(documents, output, SplitByAnyOf(" .,\t\n"));
+ * @endcode
+ */
+class HashingEncodingPolicy
+{
+ public:
+  /**
+   * Create the policy.
+   *
+   * @param numFeatures The size N of the encoded vectors.
+   * @param signedHash Whether to use a bit of the hash as the sign of the
+   *     values.
+   * @param seed Seed of the hash function.
+   */
+  HashingEncodingPolicy(const size_t numFeatures = (1 << 20),
+                        const bool signedHash = true,
+                        const size_t seed = 0) :
+      numFeatures(numFeatures),
+      signedHash(signedHash),
+      seed(seed)
+  {
+    if (numFeatures == 0)
+    {
+      throw std::invalid_argument("HashingEncodingPolicy::"
+          "HashingEncodingPolicy(): the number of features must be positive!");
+    }
+  }
+
+  /**
+   * Get the coordinate and the value that the given token adds to the encoded
+   * vector of its item.
+   *
+   * @tparam TokenType Type of the token.
+   * @tparam ElemType Type of the output values.
+   *
+   * @param token The token to encode.
+   * @param row The coordinate of the token.
+   * @param value The value of the token (1, or -1 with signed hashing).
+   */
+  template<typename TokenType, typename ElemType>
+  void Encode(const TokenType& token, size_t& row, ElemType& value) const
+  {
+    const uint64_t hash = Hash(token);
+
+    row = (size_t) (hash % numFeatures);
+    // The sign is given by the highest bit of the hash.
+    value = (signedHash && (hash >> 63)) ? ElemType(-1) : ElemType(1);
+  }
+
+  //! Get the size of the encoded vectors.
+  size_t NumFeatures() const { return numFeatures; }
+  //! Modify the size of the encoded vectors.
+  size_t& NumFeatures() { return numFeatures; }
+
+  //! Get whether signed hashing is used.
+  bool SignedHash() const { return signedHash; }
+  //! Modify whether signed hashing is used.
+  bool& SignedHash() { return signedHash; }
+
+  //! Get the seed of the hash function.
+  size_t Seed() const { return seed; }
+  //! Modify the seed of the hash function.
+  size_t& Seed() { return seed; }
+
+  /**
+   * Serialize the class to the given archive.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numFeatures);
+    ar & BOOST_SERIALIZATION_NVP(signedHash);
+    ar & BOOST_SERIALIZATION_NVP(seed);
+  }
+
+ private:
+  //! Hash the bytes of a string token.
+  uint64_t Hash(const boost::string_view& token) const
+  {
+    return HashBytes(token.data(), token.size());
+  }
+
+  //! Hash the bytes of an integral token (such as a character).
+  template<typename TokenType>
+  typename std::enable_if<std::is_integral<TokenType>::value, uint64_t>::type
+  Hash(const TokenType token) const
+  {
+    // Use the value in a fixed width and byte order.
+    const uint64_t value = (uint64_t) token;
+    char bytes[8];
+    for (size_t i = 0; i < 8; ++i)
+      bytes[i] = (char) ((value >> (8 * i)) & 0xFF);
+
+    return HashBytes(bytes, 8);
+  }
+
+  /**
+   * The 64-bit FNV-1a hash of the given bytes, started from the seed, followed
+   * by the finalizer of MurmurHash3 so that all the bits of the result depend
+   * on all the bytes.
+   */
+  uint64_t HashBytes(const char* bytes, const size_t size) const
+  {
+    uint64_t hash = 14695981039346656037ULL ^ (uint64_t) seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+      hash ^= (uint64_t) (unsigned char) bytes[i];
+      hash *= 1099511628211ULL;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+  }
+
+  //! The size of the encoded vectors.
+  size_t numFeatures;
+  //! Whether to use a bit of the hash as the sign of the values.
+  bool signedHash;
+  //! The seed of the hash function.
+  size_t seed;
+};
+
+/**
+ * The specialization provides some information about the hashing encoding
+ * policy.
+ */
+template<>
+struct StringEncodingPolicyTraits<HashingEncodingPolicy>
+{
+  /**
+   * Indicates if the policy is able to encode the token at once without
+   * any information about other tokens as well as the total tokens count.
+   */
+  static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy encodes the tokens by hashing them, without a
+   * dictionary.
+   */
+  static const bool hashedEncoding = true;
+};
+
+/**
+ * A convenient alias for the StringEncoding class with HashingEncodingPolicy
+ * and the default dictionary for the given token type (which stays empty).
+ *
+ * @tparam TokenType Type of the tokens.
+ */
+template<typename TokenType>
+using HashingEncoding = StringEncoding<HashingEncodingPolicy,
+                                       StringEncodingDictionary<TokenType>>;
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -31,6 +31,12 @@ struct StringEncodingPolicyTraits
    * any information about other tokens as well as the total tokens count.
    */
   static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy encodes the tokens by hashing them, without a
+   * dictionary.
+   */
+  static const bool hashedEncoding = false;
 };
 
 } // namespace data
@@ -42,8 +42,8 @@ double DiagonalGaussianDistribution::LogProbability(
 {
   const size_t k = observation.n_elem;
   const arma::vec diff = observation - mean;
-  const arma::vec logExponent = diff.t() * arma::diagmat(invCov) * diff;
-  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * logExponent(0);
+  const double logExponent = arma::dot(arma::square(diff), invCov);
+  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * logExponent;
 }
 
 void DiagonalGaussianDistribution::LogProbability(
@@ -57,10 +57,12 @@ void DiagonalGaussianDistribution::LogProbability(
   arma::mat diffs = observations.each_col() - mean;
 
   // Calculates log of exponent equation in multivariate Gaussian
-  // distribution. We use only diagonal part for faster computation.
-  arma::vec logExponents = -0.5 * arma::trans(diffs % diffs) * invCov;
+  // distribution. We use only diagonal part for faster computation; the
+  // product is taken from the left so that the squared differences do not have
+  // to be transposed.
+  const arma::rowvec logExponents = -0.5 * invCov.t() * arma::square(diffs);
 
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents.t();
 }
 
 arma::vec DiagonalGaussianDistribution::Random() const
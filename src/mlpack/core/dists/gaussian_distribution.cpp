@@ -76,6 +76,21 @@ double GaussianDistribution::LogProbability(const arma::vec& observation) const
   return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
 }
 
+void GaussianDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
+{
+  // Column i of 'diffs' is the difference between x.col(i) and the mean.
+  arma::mat diffs = x.each_col() - mean;
+
+  // Since cov = LL^T, the quadratic form diff^T cov^-1 diff is the squared
+  // norm of L^-1 diff.  Solving with the triangular factor for all the columns
+  // at once is cheaper than multiplying by the inverse, and only the diagonal
+  // of the product is computed.
+  const arma::mat z = arma::solve(arma::trimatl(covLower), diffs);
+  logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov -
+      0.5 * arma::sum(arma::square(z), 0).t();
+}
+
 arma::vec GaussianDistribution::Random() const
 {
   return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
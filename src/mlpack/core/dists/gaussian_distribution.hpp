@@ -90,38 +90,22 @@ class GaussianDistribution
    */
   void Probability(const arma::mat& x, arma::vec& probabilities) const
   {
-    probabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; ++i)
-    {
-      probabilities(i) = Probability(x.unsafe_col(i));
-    }
+    arma::vec logProbabilities;
+    LogProbability(x, logProbabilities);
+    probabilities = arma::exp(logProbabilities);
   }
 
   /**
    * Returns the Log probability of the given matrix. These values are stored
-   * in logProbabilities.
+   * in logProbabilities.  The quadratic forms of all the observations are
+   * computed at once, with a triangular solve against the cached Cholesky
+   * factor of the covariance.
    *
    * @param x List of observations.
    * @param logProbabilities Output log probabilities for each input
    *     observation.
    */
-  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
-  {
-    // Column i of 'diffs' is the difference between x.col(i) and the mean.
-    arma::mat diffs = x;
-    diffs.each_col() -= mean;
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.  We can
-    // calculate the right hand part of the equation (instead of the left side)
-    // so that later we are referencing columns, not rows -- that is faster.
-    const arma::mat rhs = -0.5 * invCov * diffs;
-    arma::vec logExponents(diffs.n_cols); // We will now fill this.
-    for (size_t i = 0; i < diffs.n_cols; ++i)
-      logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
-
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-      logExponents;
-  }
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
   /**
    * Return a randomly generated observation according to the probability
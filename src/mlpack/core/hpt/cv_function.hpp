@@ -73,6 +73,19 @@ class CVFunction
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation with the bound and passed parameters, training on
+   * the given fraction of the training data (see TrainingFraction() in
+   * cv::KFoldCV and cv::SimpleCV).  This is used by budget-aware
+   * optimizers such as SuccessiveHalving.  Only the models trained with the
+   * full budget are considered for the best model.
+   *
+   * @param parameters Arguments (rather than the bound arguments) that should
+   *     be passed into the Evaluate method of the CVType object.
+   * @param budget Fraction (between 0 and 1) of the training data to use.
+   */
+  double Evaluate(const arma::mat& parameters, const double budget);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -125,6 +138,9 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! Whether the current evaluation uses all the training data.
+  bool fullBudget;
+
   /**
    * Collect all arguments and run cross-validation.
    */
@@ -55,7 +55,8 @@ CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::CVFunction(
     boundArgs(args...),
     bestObjective(std::numeric_limits<double>::max()),
     relativeDelta(relativeDelta),
-    minDelta(minDelta)
+    minDelta(minDelta),
+    fullBudget(true)
 { /* Nothing left to do. */ }
 
 template<typename CVType,
@@ -68,6 +69,43 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
   return Evaluate<0, 0>(parameters);
 }
 
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+    const arma::mat& parameters,
+    const double budget)
+{
+  if (budget <= 0.0 || budget > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "CVFunction::Evaluate(): budget must be in (0, 1], but " << budget
+        << " was given";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const double oldFraction = cv.TrainingFraction();
+  cv.TrainingFraction() = budget;
+  fullBudget = (budget == 1.0);
+
+  double objective;
+  try
+  {
+    objective = Evaluate<0, 0>(parameters);
+  }
+  catch (...)
+  {
+    cv.TrainingFraction() = oldFraction;
+    fullBudget = true;
+    throw;
+  }
+
+  cv.TrainingFraction() = oldFraction;
+  fullBudget = true;
+  return objective;
+}
+
 template<typename CVType,
          typename MLAlgorithm,
          size_t TotalArgs,
@@ -120,9 +158,10 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
   double objective = cv.Evaluate(args...);
 
   // Change the best model if we have got a better score, or if we probably
-  // have not assigned any valid (trained) model yet.
-  if (bestObjective > objective ||
-      bestObjective == std::numeric_limits<double>::max())
+  // have not assigned any valid (trained) model yet.  Models trained on a part
+  // of the training data are not comparable, so they are not kept.
+  if (fullBudget && (bestObjective > objective ||
+      bestObjective == std::numeric_limits<double>::max()))
   {
     bestObjective = objective;
     bestModel = std::move(cv.Model());
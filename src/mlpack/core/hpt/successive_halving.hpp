@@ -0,0 +1,127 @@
+/**
+ * @file core/hpt/successive_halving.hpp
+ *
+ * Successive halving, a budget-aware search over a grid of hyper-parameters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace hpt {
+
+/**
+ * Successive halving searches the same grid as ens::GridSearch, but evaluates
+ * the configurations with a growing budget and drops the worst ones early:
+ * all the configurations are first evaluated with a small fraction of the
+ * training data, the best 1 / eta of them are evaluated again with eta times
+ * more data, and so on until the survivors are evaluated with all the training
+ * data.  For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{jamieson2016non,
+ *   title={Non-stochastic Best Arm Identification and Hyperparameter
+ *       Optimization},
+ *   author={Jamieson, K. and Talwalkar, A.},
+ *   booktitle={Proceedings of the 19th International Conference on Artificial
+ *       Intelligence and Statistics (AISTATS 2016)},
+ *   pages={240--248},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * Successive halving is the inner loop of Hyperband, which runs it several
+ * times with different minimum budgets.
+ *
+ * SuccessiveHalving can be used as the optimizer of HyperParameterTuner, with
+ * the KFoldCV and SimpleCV cross-validation strategies; as with GridSearch,
+ * all the hyper-parameters that are not fixed must be given as collections of
+ * values.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, SimpleCV, SuccessiveHalving> hpt(0.2, data,
+ *     responses);
+ * hpt.Optimizer().MinBudget() = 1.0 / 27;
+ * std::tie(lambda1, lambda2) = hpt.Optimize(Fixed(true), Fixed(false),
+ *     lambda1Set, lambda2Set);
+ * @endcode
+ *
+ * The function to optimize must provide the following method, which returns
+ * the objective of the given parameters when using the given fraction of the
+ * training data (see CVFunction):
+ *
+ * @code
+ * double Evaluate(const arma::mat& parameters, const double budget);
+ * @endcode
+ */
+class SuccessiveHalving
+{
+ public:
+  /**
+   * Create the successive halving optimizer.
+   *
+   * @param minBudget Fraction (between 0 and 1) of the training data used in
+   *     the first round.
+   * @param eta Factor by which the budget grows (and the number of
+   *     configurations shrinks) at each round.
+   * @param maxConfigurations Number of configurations of the grid to draw at
+   *     random and evaluate in the first round; if 0, all the configurations
+   *     of the grid are evaluated.
+   */
+  SuccessiveHalving(const double minBudget = 1.0 / 9,
+                    const double eta = 3.0,
+                    const size_t maxConfigurations = 0);
+
+  /**
+   * Find the best configuration of the grid.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Matrix to store the best configuration in.
+   * @param categoricalDimensions Whether each dimension is categorical (all of
+   *     them must be).
+   * @param numCategories Number of values of each dimension.
+   * @return Objective of the best configuration, with the full budget.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function,
+                  arma::mat& bestParameters,
+                  const std::vector<bool>& categoricalDimensions,
+                  const arma::Row<size_t>& numCategories);
+
+  //! Get the fraction of the training data used in the first round.
+  double MinBudget() const { return minBudget; }
+  //! Modify the fraction of the training data used in the first round.
+  double& MinBudget() { return minBudget; }
+
+  //! Get the factor by which the budget grows at each round.
+  double Eta() const { return eta; }
+  //! Modify the factor by which the budget grows at each round.
+  double& Eta() { return eta; }
+
+  //! Get the number of configurations evaluated in the first round.
+  size_t MaxConfigurations() const { return maxConfigurations; }
+  //! Modify the number of configurations evaluated in the first round.
+  size_t& MaxConfigurations() { return maxConfigurations; }
+
+ private:
+  //! The fraction of the training data used in the first round.
+  double minBudget;
+  //! The factor by which the budget grows at each round.
+  double eta;
+  //! The number of configurations evaluated in the first round.
+  size_t maxConfigurations;
+};
+
+} // namespace hpt
+} // namespace mlpack
+
+// Include implementation.
+#include "successive_halving_impl.hpp"
+
+#endif
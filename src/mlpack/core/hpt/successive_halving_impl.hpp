@@ -0,0 +1,131 @@
+/**
+ * @file core/hpt/successive_halving_impl.hpp
+ *
+ * Implementation of successive halving.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_IMPL_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "successive_halving.hpp"
+
+namespace mlpack {
+namespace hpt {
+
+inline SuccessiveHalving::SuccessiveHalving(const double minBudget,
+                                            const double eta,
+                                            const size_t maxConfigurations) :
+    minBudget(minBudget),
+    eta(eta),
+    maxConfigurations(maxConfigurations)
+{ /* Nothing left to do. */ }
+
+template<typename FunctionType>
+double SuccessiveHalving::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories)
+{
+  if (minBudget <= 0.0 || minBudget > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "SuccessiveHalving::Optimize(): minimum budget must be in (0, 1], "
+        << "but " << minBudget << " was given";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (eta <= 1.0)
+  {
+    std::ostringstream oss;
+    oss << "SuccessiveHalving::Optimize(): eta must be greater than 1, but "
+        << eta << " was given";
+    throw std::invalid_argument(oss.str());
+  }
+
+  size_t numConfigurations = 1;
+  for (size_t d = 0; d < categoricalDimensions.size(); ++d)
+  {
+    if (!categoricalDimensions[d])
+    {
+      std::ostringstream oss;
+      oss << "SuccessiveHalving::Optimize(): dimension " << d << " is not "
+          << "categorical; all hyper-parameters must be given as collections "
+          << "of values";
+      throw std::invalid_argument(oss.str());
+    }
+
+    numConfigurations *= numCategories[d];
+  }
+
+  // Enumerate the grid (one configuration per column), or draw a part of it.
+  arma::uvec indices;
+  if (maxConfigurations > 0 && maxConfigurations < numConfigurations)
+    indices = arma::sort(arma::randperm(numConfigurations, maxConfigurations));
+  else
+    indices = arma::regspace<arma::uvec>(0, numConfigurations - 1);
+
+  // The configurations are in lexicographic order, so that ties are broken as
+  // with nested loops over the values.
+  const size_t dimensionality = categoricalDimensions.size();
+  arma::mat candidates(dimensionality, indices.n_elem);
+  for (size_t c = 0; c < indices.n_elem; ++c)
+  {
+    size_t index = indices[c];
+    for (size_t d = dimensionality; d > 0; --d)
+    {
+      candidates(d - 1, c) = (double) (index % numCategories[d - 1]);
+      index /= numCategories[d - 1];
+    }
+  }
+
+  // The budget grows from minBudget to 1 by a factor of eta at each round.
+  const size_t numRounds = (size_t) std::floor(std::log(1.0 / minBudget) /
+      std::log(eta) + 1e-10) + 1;
+
+  for (size_t round = 0; round < numRounds; ++round)
+  {
+    const bool lastRound = (round == numRounds - 1);
+    const double budget = lastRound ? 1.0 :
+        minBudget * std::pow(eta, (double) round);
+
+    arma::vec objectives(candidates.n_cols);
+    for (size_t c = 0; c < candidates.n_cols; ++c)
+    {
+      const arma::mat parameters = candidates.col(c);
+      objectives[c] = function.Evaluate(parameters, budget);
+
+      // Invalid objectives are the worst.
+      if (std::isnan(objectives[c]))
+        objectives[c] = std::numeric_limits<double>::infinity();
+    }
+
+    Log::Info << "SuccessiveHalving: evaluated " << candidates.n_cols
+        << " configurations with budget " << budget << "." << std::endl;
+
+    const arma::uvec order = arma::stable_sort_index(objectives);
+    if (lastRound)
+    {
+      bestParameters = candidates.col(order[0]);
+      return objectives[order[0]];
+    }
+
+    // Keep the best configurations for the next round.
+    const size_t numKept = std::max((size_t) std::floor(candidates.n_cols /
+        eta), (size_t) 1);
+    candidates = candidates.cols(arma::sort(order.head(numKept)));
+  }
+
+  // This is never reached, since there is always at least one round.
+  return std::numeric_limits<double>::infinity();
+}
+
+} // namespace hpt
+} // namespace mlpack
+
+#endif
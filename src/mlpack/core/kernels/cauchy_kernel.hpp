@@ -62,10 +62,20 @@ class CauchyKernel
    * @return K(a, b).
    */
   template<typename VecTypeA, typename VecTypeB>
-  double Evaluate(const VecTypeA& a, const VecTypeB& b)
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
   {
-    return 1 / (1 + (
-        std::pow(metric::EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
+    return Evaluate(metric::EuclideanDistance::Evaluate(a, b));
+  }
+
+  /**
+   * Evaluation of the Cauchy kernel given the distance between two points.
+   *
+   * @param t The distance between the two points.
+   * @return K(t).
+   */
+  double Evaluate(const double t) const
+  {
+    return 1 / (1 + std::pow(t / bandwidth, 2));
   }
 
   /**
@@ -89,6 +99,10 @@ class KernelTraits<CauchyKernel>
  public:
   //! The Cauchy kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Cauchy kernel only depends on the distance between points.
+  static const bool UsesEuclideanDistance = true;
+  //! The Cauchy kernel does not depend on the dot product only.
+  static const bool UsesDotProduct = false;
 };
 
 } // namespace kernel
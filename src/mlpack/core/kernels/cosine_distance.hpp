@@ -56,6 +56,10 @@ class KernelTraits<CosineDistance>
 
   //! The cosine kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The batch evaluation of the kernel is not specialized.
+  static const bool UsesEuclideanDistance = false;
+  //! The batch evaluation of the kernel is not specialized.
+  static const bool UsesDotProduct = false;
 };
 
 } // namespace kernel
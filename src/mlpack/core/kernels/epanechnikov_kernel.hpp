@@ -89,6 +89,9 @@ class EpanechnikovKernel
    */
   double Normalizer(const size_t dimension);
 
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+
   /**
    * Serialize the kernel.
    */
@@ -111,6 +114,10 @@ class KernelTraits<EpanechnikovKernel>
   static const bool IsNormalized = true;
   //! The Epanechnikov kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Epanechnikov kernel only depends on the distance between points.
+  static const bool UsesEuclideanDistance = true;
+  //! The Epanechnikov kernel does not depend on the dot product only.
+  static const bool UsesDotProduct = false;
 };
 
 } // namespace kernel
@@ -171,6 +171,10 @@ class KernelTraits<GaussianKernel>
   static const bool IsNormalized = true;
   //! The Gaussian kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Gaussian kernel only depends on the distance between points.
+  static const bool UsesEuclideanDistance = true;
+  //! The Gaussian kernel does not depend on the dot product only.
+  static const bool UsesDotProduct = false;
 };
 
 } // namespace kernel
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_HYPERBOLIC_TANGENT_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -57,9 +58,21 @@ class HyperbolicTangentKernel
    * @return K(a, b).
    */
   template<typename VecTypeA, typename VecTypeB>
-  double Evaluate(const VecTypeA& a, const VecTypeB& b)
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
   {
-    return tanh(scale * arma::dot(a, b) + offset);
+    return EvaluateDotProduct(arma::dot(a, b));
+  }
+
+  /**
+   * Evaluate the hyperbolic tangent kernel given the dot product of two
+   * vectors.
+   *
+   * @param dotProduct Dot product of the two vectors.
+   * @return K(a, b).
+   */
+  double EvaluateDotProduct(const double dotProduct) const
+  {
+    return tanh(scale * dotProduct + offset);
   }
 
   //! Get scale factor.
@@ -85,6 +98,21 @@ class HyperbolicTangentKernel
   double offset;
 };
 
+//! Kernel traits for the hyperbolic tangent kernel.
+template<>
+class KernelTraits<HyperbolicTangentKernel>
+{
+ public:
+  //! The hyperbolic tangent kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The hyperbolic tangent kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The hyperbolic tangent kernel does not depend on the distance only.
+  static const bool UsesEuclideanDistance = false;
+  //! The hyperbolic tangent kernel only depends on the dot product.
+  static const bool UsesDotProduct = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
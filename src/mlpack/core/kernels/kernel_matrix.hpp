@@ -0,0 +1,99 @@
+/**
+ * @file core/kernels/kernel_matrix.hpp
+ *
+ * Batch evaluation of a kernel between every pair of points of two sets.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Evaluate the kernel between every point of a and every point of b, so that
+ * output(i, j) = K(a.col(i), b.col(j)).  The evaluation is specialized with
+ * KernelTraits:
+ *
+ *  - if the kernel only depends on the dot product (UsesDotProduct), the dot
+ *    products are computed with a single matrix product, and the kernel is
+ *    applied to them in parallel;
+ *  - if the kernel only depends on the Euclidean distance
+ *    (UsesEuclideanDistance), the squared distances are computed as
+ *    ||a||^2 + ||b||^2 - 2 a^T b with a single matrix product, and the kernel
+ *    is applied to the distances in parallel;
+ *  - otherwise, Evaluate() is called for each pair of points in parallel (for
+ *    only half of the pairs if a and b are the same matrix).
+ *
+ * Note that the distances computed by the matrix product are less accurate than
+ * the distances computed directly for points that are very close to each other
+ * (the error is relative to the norm of the points); the distance of a point
+ * to itself is exactly zero when a and b are the same matrix.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points (one point per column).
+ * @param b Second set of points (one point per column).
+ * @param output Matrix to store the kernel evaluations in.
+ */
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& output,
+                  const typename std::enable_if<
+                      KernelTraits<KernelType>::UsesDotProduct>::type* = 0);
+
+//! Evaluate the kernel between every point of a and every point of b, for
+//! kernels that only depend on the Euclidean distance.
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& output,
+                  const typename std::enable_if<
+                      !KernelTraits<KernelType>::UsesDotProduct &&
+                      KernelTraits<KernelType>::UsesEuclideanDistance>::type*
+                      = 0);
+
+//! Evaluate the kernel between every point of a and every point of b, for
+//! kernels that have no faster batch evaluation.
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& output,
+                  const typename std::enable_if<
+                      !KernelTraits<KernelType>::UsesDotProduct &&
+                      !KernelTraits<KernelType>::UsesEuclideanDistance>::type*
+                      = 0);
+
+/**
+ * Evaluate the kernel between every pair of points of data, so that
+ * output(i, j) = K(data.col(i), data.col(j)).
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points (one point per column).
+ * @param output Matrix to store the kernel evaluations in.
+ */
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& data,
+                  arma::mat& output)
+{
+  KernelMatrix(kernel, data, data, output);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file core/kernels/kernel_matrix_impl.hpp
+ *
+ * Implementation of the batch evaluation of kernels.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "kernel_matrix.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& output,
+                  const typename std::enable_if<
+                      KernelTraits<KernelType>::UsesDotProduct>::type*)
+{
+  output = a.t() * b;
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) output.n_cols; ++j)
+  {
+    double* column = output.colptr(j);
+    for (size_t i = 0; i < output.n_rows; ++i)
+      column[i] = kernel.EvaluateDotProduct(column[i]);
+  }
+}
+
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& output,
+                  const typename std::enable_if<
+                      !KernelTraits<KernelType>::UsesDotProduct &&
+                      KernelTraits<KernelType>::UsesEuclideanDistance>::type*)
+{
+  const bool same = (&a == &b);
+  const arma::rowvec aNorms = arma::sum(arma::square(a), 0);
+  const arma::rowvec bNorms = same ? aNorms : arma::rowvec(
+      arma::sum(arma::square(b), 0));
+
+  output = a.t() * b;
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) output.n_cols; ++j)
+  {
+    double* column = output.colptr(j);
+    for (size_t i = 0; i < output.n_rows; ++i)
+    {
+      // Rounding may make the squared distance slightly negative.
+      const double squaredDistance = (same && i == (size_t) j) ? 0.0 :
+          std::max(aNorms[i] + bNorms[j] - 2.0 * column[i], 0.0);
+      column[i] = kernel.Evaluate(std::sqrt(squaredDistance));
+    }
+  }
+}
+
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& output,
+                  const typename std::enable_if<
+                      !KernelTraits<KernelType>::UsesDotProduct &&
+                      !KernelTraits<KernelType>::UsesEuclideanDistance>::type*)
+{
+  output.set_size(a.n_cols, b.n_cols);
+
+  // Kernels are symmetric, so if a and b are the same matrix, only the upper
+  // triangle is evaluated.  The columns then have different costs.
+  const bool same = (&a == &b);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    const size_t end = same ? (size_t) j + 1 : a.n_cols;
+    for (size_t i = 0; i < end; ++i)
+      output(i, j) = kernel.Evaluate(a.unsafe_col(i), b.unsafe_col(j));
+  }
+
+  if (same)
+    output = arma::symmatu(output);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -36,6 +36,18 @@ class KernelTraits
    * If true, then the kernel include a squared distance, ||x - y||^2 .
    */
   static const bool UsesSquaredDistance = false;
+
+  /**
+   * If true, then the kernel only depends on the Euclidean distance
+   * ||x - y||, and provides Evaluate(distance).
+   */
+  static const bool UsesEuclideanDistance = false;
+
+  /**
+   * If true, then the kernel only depends on the dot product x^T y, and
+   * provides EvaluateDotProduct(dotProduct).
+   */
+  static const bool UsesDotProduct = false;
 };
 
 } // namespace kernel
@@ -117,6 +117,10 @@ class KernelTraits<LaplacianKernel>
   static const bool IsNormalized = true;
   //! The Laplacian kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The Laplacian kernel only depends on the distance between points.
+  static const bool UsesEuclideanDistance = true;
+  //! The Laplacian kernel does not depend on the dot product only.
+  static const bool UsesDotProduct = false;
 };
 
 } // namespace kernel
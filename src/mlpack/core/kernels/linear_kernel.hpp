@@ -15,6 +15,7 @@
 #define MLPACK_CORE_KERNELS_LINEAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -55,11 +56,38 @@ class LinearKernel
     return arma::dot(a, b);
   }
 
+  /**
+   * Evaluate the linear kernel given the dot product of two vectors (this is
+   * the dot product itself).
+   *
+   * @param dotProduct Dot product of the two vectors.
+   * @return K(a, b).
+   */
+  static double EvaluateDotProduct(const double dotProduct)
+  {
+    return dotProduct;
+  }
+
   //! Serialize the kernel (it has no members... do nothing).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
+//! Kernel traits for the linear kernel.
+template<>
+class KernelTraits<LinearKernel>
+{
+ public:
+  //! The linear kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The linear kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The linear kernel does not depend on the distance only.
+  static const bool UsesEuclideanDistance = false;
+  //! The linear kernel only depends on the dot product.
+  static const bool UsesDotProduct = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_POLYNOMIAL_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -54,7 +55,18 @@ class PolynomialKernel
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b) const
   {
-    return pow((arma::dot(a, b) + offset), degree);
+    return EvaluateDotProduct(arma::dot(a, b));
+  }
+
+  /**
+   * Evaluate the polynomial kernel given the dot product of two vectors.
+   *
+   * @param dotProduct Dot product of the two vectors.
+   * @return K(a, b).
+   */
+  double EvaluateDotProduct(const double dotProduct) const
+  {
+    return pow((dotProduct + offset), degree);
   }
 
   //! Get the degree of the polynomial.
@@ -82,6 +94,21 @@ class PolynomialKernel
   double offset;
 };
 
+//! Kernel traits for the polynomial kernel.
+template<>
+class KernelTraits<PolynomialKernel>
+{
+ public:
+  //! The polynomial kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The polynomial kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The polynomial kernel does not depend on the distance only.
+  static const bool UsesEuclideanDistance = false;
+  //! The polynomial kernel only depends on the dot product.
+  static const bool UsesDotProduct = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
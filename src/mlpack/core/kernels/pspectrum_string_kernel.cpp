@@ -19,6 +19,147 @@ using namespace std;
 using namespace mlpack;
 using namespace mlpack::kernel;
 
+namespace {
+
+//! The number of symbols of the substrings: the 36 alphanumeric characters,
+//! and one code for the other characters.
+const uint64_t alphabetSize = 37;
+
+//! Substrings of at most this length have distinct codes in 64 bits.
+const size_t maxExactLength = 12;
+
+//! Get the code of a character: 1 to 36 for alphanumeric characters (ignoring
+//! case), and 0 for the others.
+inline uint64_t CharacterCode(const char c)
+{
+  if (c >= '0' && c <= '9')
+    return uint64_t(c - '0') + 1;
+  else if (c >= 'a' && c <= 'z')
+    return uint64_t(c - 'a') + 11;
+  else if (c >= 'A' && c <= 'Z')
+    return uint64_t(c - 'A') + 11;
+  else
+    return 0;
+}
+
+/**
+ * Compute the code of the substring of the given length (at most
+ * maxExactLength) at each position of the string, as a base-37 number, with a
+ * rolling computation.
+ */
+void RollingCodes(const std::string& str,
+                  const size_t length,
+                  std::vector<uint64_t>& codes)
+{
+  codes.clear();
+  if (str.length() < length)
+    return;
+
+  // The empty substring is at every position.
+  codes.resize(str.length() - length + 1, 0);
+  if (length == 0)
+    return;
+
+  uint64_t highest = 1;
+  for (size_t j = 1; j < length; ++j)
+    highest *= alphabetSize;
+
+  uint64_t code = 0;
+  for (size_t j = 0; j < length; ++j)
+    code = code * alphabetSize + CharacterCode(str[j]);
+  codes[0] = code;
+
+  for (size_t start = 1; start < codes.size(); ++start)
+  {
+    code = (code - CharacterCode(str[start - 1]) * highest) * alphabetSize +
+        CharacterCode(str[start + length - 1]);
+    codes[start] = code;
+  }
+}
+
+//! Mix the bits of a 64-bit number (the finalizer of SplitMix64).
+inline uint64_t Mix(uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/**
+ * Compute the sorted codes of the distinct alphanumeric substrings of length p
+ * of the string, and the number of times each one appears.
+ */
+void SubstringCodes(const std::string& str,
+                    const size_t p,
+                    std::vector<uint64_t>& codes,
+                    std::vector<size_t>& counts)
+{
+  codes.clear();
+  counts.clear();
+  if (str.length() < p)
+    return;
+
+  // The number of characters that are not alphanumeric before each position.
+  std::vector<size_t> invalid(str.length() + 1, 0);
+  for (size_t j = 0; j < str.length(); ++j)
+    invalid[j + 1] = invalid[j] + ((CharacterCode(str[j]) == 0) ? 1 : 0);
+
+  // Longer substrings are split in chunks of maxExactLength characters (and a
+  // shorter last chunk), whose codes are hashed together.
+  const size_t chunks = p / maxExactLength;
+  const size_t remainder = p % maxExactLength;
+  std::vector<uint64_t> chunkCodes, remainderCodes;
+  if (p <= maxExactLength)
+  {
+    RollingCodes(str, p, remainderCodes);
+  }
+  else
+  {
+    RollingCodes(str, maxExactLength, chunkCodes);
+    RollingCodes(str, remainder, remainderCodes);
+  }
+
+  std::vector<uint64_t> allCodes;
+  allCodes.reserve(str.length() - p + 1);
+  for (size_t start = 0; start + p <= str.length(); ++start)
+  {
+    // Only consider substrings with alphanumerics.
+    if (invalid[start + p] != invalid[start])
+      continue;
+
+    if (p <= maxExactLength)
+    {
+      allCodes.push_back(remainderCodes[start]);
+    }
+    else
+    {
+      uint64_t code = 0;
+      for (size_t c = 0; c < chunks; ++c)
+        code = Mix(code + chunkCodes[start + c * maxExactLength]);
+      if (remainder > 0)
+        code = Mix(code + remainderCodes[start + chunks * maxExactLength]);
+      allCodes.push_back(code);
+    }
+  }
+
+  // Count the occurrences of each distinct code.
+  std::sort(allCodes.begin(), allCodes.end());
+  for (size_t j = 0; j < allCodes.size(); ++j)
+  {
+    if (j == 0 || allCodes[j] != allCodes[j - 1])
+    {
+      codes.push_back(allCodes[j]);
+      counts.push_back(1);
+    }
+    else
+    {
+      ++counts.back();
+    }
+  }
+}
+
+} // namespace
+
 /**
  * Initialize the PSpectrumStringKernel with the given string datasets.  For
  * more information on this, see the general class documentation.
@@ -38,6 +179,9 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
 
   // Resize for number of datasets.
   counts.resize(datasets.size());
+  codes.resize(datasets.size());
+  codeCounts.resize(datasets.size());
+  offsets.resize(datasets.size());
 
   for (size_t dataset = 0; dataset < datasets.size(); ++dataset)
   {
@@ -45,9 +189,12 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
 
     // Resize for number of strings in dataset.
     counts[dataset].resize(set.size());
+    std::vector<std::vector<uint64_t>> stringCodes(set.size());
+    std::vector<std::vector<size_t>> stringCounts(set.size());
 
     // Inspect each string in the dataset.
-    for (size_t index = 0; index < set.size(); ++index)
+    #pragma omp parallel for
+    for (omp_size_t index = 0; index < (omp_size_t) set.size(); ++index)
     {
       // Convenience references.
       const std::string& str = set[index];
@@ -80,6 +227,27 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
           ++mapping[sub];
         }
       }
+
+      SubstringCodes(str, p, stringCodes[index], stringCounts[index]);
+    }
+
+    // Concatenate the codes of the strings.
+    offsets[dataset].resize(set.size() + 1);
+    offsets[dataset][0] = 0;
+    for (size_t index = 0; index < set.size(); ++index)
+    {
+      offsets[dataset][index + 1] = offsets[dataset][index] +
+          stringCodes[index].size();
+    }
+
+    codes[dataset].reserve(offsets[dataset][set.size()]);
+    codeCounts[dataset].reserve(offsets[dataset][set.size()]);
+    for (size_t index = 0; index < set.size(); ++index)
+    {
+      codes[dataset].insert(codes[dataset].end(), stringCodes[index].begin(),
+          stringCodes[index].end());
+      codeCounts[dataset].insert(codeCounts[dataset].end(),
+          stringCounts[index].begin(), stringCounts[index].end());
     }
   }
 
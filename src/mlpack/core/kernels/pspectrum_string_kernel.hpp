@@ -60,7 +60,15 @@ namespace kernel {
  * build a kd-tree on strings, because the BinarySpaceTree<> class will split
  * the data according to the fake data matrix -- resulting in a meaningless
  * tree.  This kernel was originally written for the FastMKS method; so, at the
- * very least, it will work with that.
+ * very least, it will work with that.  It also works with KernelPCA (with the
+ * naive kernel rule), since kernel::KernelMatrix() only calls Evaluate().
+ *
+ * At construction time, the distinct substrings of each string are encoded as
+ * integers and stored in sorted flat arrays, so that Evaluate() is a merge of
+ * two arrays of integers.  Each alphanumeric character is one of 36 symbols
+ * (case is ignored), so substrings of up to 12 characters have distinct codes
+ * in 64 bits; longer substrings are hashed, so two different substrings have a
+ * (very small, about 2^-64) chance to be counted as the same.
  */
 class PSpectrumStringKernel
 {
@@ -89,7 +97,10 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
-  //! Access the lists of substrings.
+  /**
+   * Access the lists of substrings.  These are not used by Evaluate(), which
+   * uses the codes of the substrings computed at construction time.
+   */
   const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
   { return counts; }
   //! Modify the lists of substrings.
@@ -106,6 +117,15 @@ class PSpectrumStringKernel
   //! is not wonderful...
   std::vector<std::vector<std::map<std::string, int> > > counts;
 
+  //! The sorted codes of the distinct substrings of each string of each
+  //! dataset: the codes of string i of dataset d are codes[d][j] for j in
+  //! [offsets[d][i], offsets[d][i + 1]).
+  std::vector<std::vector<uint64_t>> codes;
+  //! The number of times each substring of codes appears in its string.
+  std::vector<std::vector<size_t>> codeCounts;
+  //! The position of the codes of each string of each dataset.
+  std::vector<std::vector<size_t>> offsets;
+
   //! The value of p to use in calculation.
   size_t p;
 };
@@ -36,39 +36,39 @@ template<typename VecType>
 double PSpectrumStringKernel::Evaluate(const VecType& a,
                                        const VecType& b) const
 {
-  // Get the map of substrings for the two strings we are interested in.
-  const std::map<std::string, int>& aMap = counts[a[0]][a[1]];
-  const std::map<std::string, int>& bMap = counts[b[0]][b[1]];
+  // Get the codes of the substrings of the two strings we are interested in.
+  const size_t aDataset = (size_t) a[0];
+  const size_t bDataset = (size_t) b[0];
+  size_t aIndex = offsets[aDataset][(size_t) a[1]];
+  size_t bIndex = offsets[bDataset][(size_t) b[1]];
+  const size_t aEnd = offsets[aDataset][(size_t) a[1] + 1];
+  const size_t bEnd = offsets[bDataset][(size_t) b[1] + 1];
+  const uint64_t* aCodes = codes[aDataset].data();
+  const uint64_t* bCodes = codes[bDataset].data();
 
   double eval = 0;
 
-  // Loop through the two maps (which, when iterated through, are sorted
-  // alphabetically).
-  std::map<std::string, int>::const_iterator aIt = aMap.begin();
-  std::map<std::string, int>::const_iterator bIt = bMap.begin();
-
-  while ((aIt != aMap.end()) && (bIt != bMap.end()))
+  // Loop through the two lists of codes, which are sorted.
+  while ((aIndex < aEnd) && (bIndex < bEnd))
   {
-    // Compare alphabetically (this is how std::map is ordered).
-    int result = (*aIt).first.compare((*bIt).first);
-
-    if (result == 0) // The same substring.
+    if (aCodes[aIndex] == bCodes[bIndex]) // The same substring.
     {
-      eval += ((*aIt).second * (*bIt).second);
+      eval += double(codeCounts[aDataset][aIndex]) *
+          double(codeCounts[bDataset][bIndex]);
 
       // Now increment both.
-      ++aIt;
-      ++bIt;
+      ++aIndex;
+      ++bIndex;
     }
-    else if (result > 0)
+    else if (aCodes[aIndex] > bCodes[bIndex])
     {
-      // aIt is "ahead" of bIt (alphabetically); so increment bIt to "catch up".
-      ++bIt;
+      // aIndex is "ahead" of bIndex; so increment bIndex to "catch up".
+      ++bIndex;
     }
     else
     {
-      // bIt is "ahead" of aIt (alphabetically); so increment aIt to "catch up".
-      ++aIt;
+      // bIndex is "ahead" of aIndex; so increment aIndex to "catch up".
+      ++aIndex;
     }
   }
 
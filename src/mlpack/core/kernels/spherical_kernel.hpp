@@ -127,6 +127,10 @@ class KernelTraits<SphericalKernel>
   static const bool IsNormalized = true;
   //! The spherical kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The Spherical kernel only depends on the distance between points.
+  static const bool UsesEuclideanDistance = true;
+  //! The Spherical kernel does not depend on the dot product only.
+  static const bool UsesDotProduct = false;
 };
 
 } // namespace kernel
@@ -112,6 +112,10 @@ class KernelTraits<TriangularKernel>
   static const bool IsNormalized = true;
   //! The triangular kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The Triangular kernel only depends on the distance between points.
+  static const bool UsesEuclideanDistance = true;
+  //! The Triangular kernel does not depend on the dot product only.
+  static const bool UsesDotProduct = false;
 };
 
 } // namespace kernel
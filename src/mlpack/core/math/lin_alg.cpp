@@ -277,3 +277,73 @@ void mlpack::math::SymKronId(const arma::mat& A, arma::mat& op)
     }
   }
 }
+
+/**
+ * Compute a * b for a sparse matrix a.  Each column of the output only depends
+ * on the same column of b, so the columns are computed independently.
+ */
+void mlpack::math::SparseMultiply(const arma::sp_mat& a,
+                                  const arma::mat& b,
+                                  arma::mat& output)
+{
+  if (a.n_cols != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "SparseMultiply(): incompatible matrix dimensions: " << a.n_rows
+        << "x" << a.n_cols << " and " << b.n_rows << "x" << b.n_cols;
+    throw std::invalid_argument(oss.str());
+  }
+
+  a.sync();
+  output.zeros(a.n_rows, b.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    double* out = output.colptr(j);
+    const double* in = b.colptr(j);
+    for (size_t c = 0; c < a.n_cols; ++c)
+    {
+      const double factor = in[c];
+      if (factor == 0.0)
+        continue;
+
+      for (size_t k = a.col_ptrs[c]; k < a.col_ptrs[c + 1]; ++k)
+        out[a.row_indices[k]] += a.values[k] * factor;
+    }
+  }
+}
+
+/**
+ * Compute a^T * b for a sparse matrix a.  Row c of the output is the product of
+ * column c of a with b, so the columns of a are processed independently.
+ */
+void mlpack::math::SparseTransMultiply(const arma::sp_mat& a,
+                                       const arma::mat& b,
+                                       arma::mat& output)
+{
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "SparseTransMultiply(): incompatible matrix dimensions: "
+        << a.n_cols << "x" << a.n_rows << " and " << b.n_rows << "x"
+        << b.n_cols;
+    throw std::invalid_argument(oss.str());
+  }
+
+  a.sync();
+  output.zeros(a.n_cols, b.n_cols);
+
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (omp_size_t c = 0; c < (omp_size_t) a.n_cols; ++c)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      const double* in = b.colptr(j);
+      double sum = 0.0;
+      for (size_t k = a.col_ptrs[c]; k < a.col_ptrs[c + 1]; ++k)
+        sum += a.values[k] * in[a.row_indices[k]];
+      output(c, j) = sum;
+    }
+  }
+}
@@ -117,6 +117,32 @@ inline size_t SvecIndex(size_t i, size_t j, size_t n);
  */
 void SymKronId(const arma::mat& A, arma::mat& op);
 
+/**
+ * Compute output = A * B, where A is a sparse matrix and B a dense matrix.  A is
+ * never densified; the columns of the output are computed in parallel with
+ * OpenMP (if available).
+ *
+ * @param a Sparse matrix.
+ * @param b Dense matrix with a.n_cols rows.
+ * @param output Matrix to store a * b in.
+ */
+void SparseMultiply(const arma::sp_mat& a,
+                    const arma::mat& b,
+                    arma::mat& output);
+
+/**
+ * Compute output = A^T * B, where A is a sparse matrix and B a dense matrix,
+ * without forming the transpose of A.  The rows of the output (the columns of
+ * A) are computed in parallel with OpenMP (if available).
+ *
+ * @param a Sparse matrix.
+ * @param b Dense matrix with a.n_rows rows.
+ * @param output Matrix to store a^T * b in.
+ */
+void SparseTransMultiply(const arma::sp_mat& a,
+                         const arma::mat& b,
+                         arma::mat& output);
+
 /**
  * Signum function.
  * Return 1 if x>0; return 0 if x=0; return -1 if x<0.
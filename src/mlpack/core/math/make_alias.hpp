@@ -42,6 +42,23 @@ arma::Mat<ElemType> MakeAlias(arma::Mat<ElemType>& input,
       strict);
 }
 
+/**
+ * Make an alias of the given number of rows and columns of the memory of a
+ * dense matrix, starting at the given offset (in elements).  If strict is true,
+ * then the alias cannot be resized or pointed at new memory.
+ */
+template<typename ElemType>
+arma::Mat<ElemType> MakeAlias(arma::Mat<ElemType>& input,
+                              const size_t offset,
+                              const size_t rows,
+                              const size_t cols,
+                              const bool strict = true)
+{
+  // Use the advanced constructor.
+  return arma::Mat<ElemType>(input.memptr() + offset, rows, cols, false,
+      strict);
+}
+
 /**
  * Make an alias of a dense row.  If strict is true, then the alias cannot be
  * resized or pointed at new memory.
@@ -123,6 +140,36 @@ void ClearAlias(arma::SpMat<ElemType>& /* mat */)
   // Nothing to do.
 }
 
+#ifdef HAS_BANDICOOT
+
+/**
+ * Make an alias of a Bandicoot matrix, whose memory is on the GPU.  Bandicoot
+ * aliases cannot be resized, so the strict parameter is ignored.
+ */
+template<typename ElemType>
+coot::Mat<ElemType> MakeAlias(coot::Mat<ElemType>& input,
+                              const bool /* strict */ = true)
+{
+  return coot::Mat<ElemType>(input.get_dev_mem(false), input.n_rows,
+      input.n_cols);
+}
+
+/**
+ * Make an alias of the given number of rows and columns of the memory of a
+ * Bandicoot matrix, starting at the given offset (in elements).  The strict
+ * parameter is ignored.
+ */
+template<typename ElemType>
+coot::Mat<ElemType> MakeAlias(coot::Mat<ElemType>& input,
+                              const size_t offset,
+                              const size_t rows,
+                              const size_t cols,
+                              const bool /* strict */ = true)
+{
+  return coot::Mat<ElemType>(input.get_dev_mem(false) + offset, rows, cols);
+}
+
+#endif
 
 } // namespace math
 } // namespace mlpack
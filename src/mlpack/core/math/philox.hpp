@@ -0,0 +1,180 @@
+/**
+ * @file core/math/philox.hpp
+ *
+ * A counter-based random number generator (Philox4x32-10), which gives
+ * independent, reproducible streams of random numbers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PHILOX_HPP
+#define MLPACK_CORE_MATH_PHILOX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The Philox4x32-10 counter-based random number generator, described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{salmon2011parallel,
+ *   title={Parallel Random Numbers: As Easy as 1, 2, 3},
+ *   author={Salmon, J.K. and Moraes, M.A. and Dror, R.O. and Shaw, D.E.},
+ *   booktitle={Proceedings of the 2011 International Conference for High
+ *       Performance Computing, Networking, Storage and Analysis (SC '11)},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The n-th block of four random numbers is a bijection of the counter n, keyed
+ * by the seed, so the generator has no state other than the seed, the stream
+ * and the counter.  Each (seed, stream) pair gives an independent sequence of
+ * 2^64 blocks; so, to get reproducible results in parallel code, give each
+ * thread (or better, each task) its own stream:
+ *
+ * @code
+ * #pragma omp parallel for
+ * for (omp_size_t i = 0; i < n; ++i)
+ * {
+ *   math::Philox generator(seed, i);
+ *   std::normal_distribution<> dist;
+ *   double x = dist(generator);
+ *   ...
+ * }
+ * @endcode
+ *
+ * This class satisfies the requirements of UniformRandomBitGenerator, so it can
+ * be used with the distributions and algorithms of the standard library.
+ */
+class Philox
+{
+ public:
+  //! The type of the generated random numbers.
+  typedef uint32_t result_type;
+
+  /**
+   * Create the generator for the given seed and stream.
+   *
+   * @param seed Seed of the generator.
+   * @param stream Index of the stream of random numbers.
+   */
+  Philox(const uint64_t seed = 0, const uint64_t stream = 0)
+  {
+    Seed(seed, stream);
+  }
+
+  /**
+   * Reset the generator to the beginning of the given seed and stream.
+   *
+   * @param seed Seed of the generator.
+   * @param stream Index of the stream of random numbers.
+   */
+  void Seed(const uint64_t seed, const uint64_t stream = 0)
+  {
+    key[0] = (uint32_t) seed;
+    key[1] = (uint32_t) (seed >> 32);
+    this->stream = stream;
+    counter = 0;
+    position = 4;
+  }
+
+  //! Get the next random number.
+  result_type operator()()
+  {
+    if (position == 4)
+    {
+      Block(counter++, output);
+      position = 0;
+    }
+
+    return output[position++];
+  }
+
+  /**
+   * Skip the given number of random numbers, in constant time.
+   *
+   * @param n Number of random numbers to skip.
+   */
+  void Discard(const uint64_t n)
+  {
+    const uint64_t total = (uint64_t) position + n;
+    if (total < 4)
+    {
+      position = (size_t) total;
+      return;
+    }
+
+    // The current block is already used, so skip the remaining blocks.
+    counter += (total - 4) / 4;
+    Block(counter++, output);
+    position = (size_t) ((total - 4) % 4);
+  }
+
+  //! Get the smallest value that can be generated.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest value that can be generated.
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+ private:
+  //! Compute the block of four random numbers for the given counter.
+  void Block(const uint64_t blockCounter, uint32_t* block) const
+  {
+    uint32_t c[4] = { (uint32_t) blockCounter,
+                      (uint32_t) (blockCounter >> 32),
+                      (uint32_t) stream,
+                      (uint32_t) (stream >> 32) };
+    uint32_t k[2] = { key[0], key[1] };
+
+    for (size_t round = 0; round < 10; ++round)
+    {
+      if (round > 0)
+      {
+        k[0] += 0x9E3779B9;
+        k[1] += 0xBB67AE85;
+      }
+
+      const uint64_t product0 = (uint64_t) 0xD2511F53 * c[0];
+      const uint64_t product1 = (uint64_t) 0xCD9E8D57 * c[2];
+      const uint32_t next[4] = {
+          (uint32_t) (product1 >> 32) ^ c[1] ^ k[0],
+          (uint32_t) product1,
+          (uint32_t) (product0 >> 32) ^ c[3] ^ k[1],
+          (uint32_t) product0 };
+      c[0] = next[0];
+      c[1] = next[1];
+      c[2] = next[2];
+      c[3] = next[3];
+    }
+
+    block[0] = c[0];
+    block[1] = c[1];
+    block[2] = c[2];
+    block[3] = c[3];
+  }
+
+  //! The key (the seed).
+  uint32_t key[2];
+  //! The index of the stream.
+  uint64_t stream;
+  //! The counter of the next block.
+  uint64_t counter;
+  //! The current block of random numbers.
+  uint32_t output[4];
+  //! The position of the next random number in the current block.
+  size_t position;
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file core/math/quantile_sketch.cpp
+ *
+ * Implementation of the QuantileSketch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "quantile_sketch.hpp"
+
+namespace mlpack {
+namespace math {
+
+QuantileSketch::QuantileSketch(const size_t k) :
+    k(k),
+    count(0),
+    levels(1),
+    offsets(1, 0)
+{
+  if (k < 2)
+  {
+    throw std::invalid_argument("QuantileSketch: the capacity must be at "
+        "least 2");
+  }
+
+  levels[0].reserve(k);
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other)
+{
+  if (other.k != k)
+  {
+    throw std::invalid_argument("QuantileSketch::Merge(): the sketches must "
+        "have the same capacity");
+  }
+
+  if (other.levels.size() > levels.size())
+  {
+    levels.resize(other.levels.size());
+    offsets.resize(other.levels.size(), 0);
+  }
+
+  for (size_t l = 0; l < other.levels.size(); ++l)
+  {
+    levels[l].insert(levels[l].end(), other.levels[l].begin(),
+        other.levels[l].end());
+  }
+  count += other.count;
+
+  Compress();
+}
+
+double QuantileSketch::Quantile(const double q) const
+{
+  if (count == 0)
+  {
+    throw std::invalid_argument("QuantileSketch::Quantile(): the sketch is "
+        "empty");
+  }
+
+  if (q < 0.0 || q > 1.0)
+  {
+    throw std::invalid_argument("QuantileSketch::Quantile(): the quantile "
+        "must be between 0 and 1");
+  }
+
+  // The position of the quantile among the sorted values.
+  const double position = q * (count - 1);
+
+  if (levels.size() == 1)
+  {
+    // Nothing was compacted, so the quantile is exact.
+    std::vector<double> values(levels[0]);
+    const size_t lower = (size_t) std::floor(position);
+    const size_t upper = std::min(lower + 1, values.size() - 1);
+    std::nth_element(values.begin(), values.begin() + lower, values.end());
+    const double lowerValue = values[lower];
+    if (upper == lower || position == (double) lower)
+      return lowerValue;
+
+    // The next value is the smallest of the values after the lower one.
+    const double upperValue = *std::min_element(values.begin() + upper,
+        values.end());
+    return lowerValue + (position - lower) * (upperValue - lowerValue);
+  }
+
+  // Each value of level l stands for 2^l values of the stream.
+  std::vector<std::pair<double, size_t>> weighted;
+  weighted.reserve(Size());
+  for (size_t l = 0; l < levels.size(); ++l)
+  {
+    for (size_t i = 0; i < levels[l].size(); ++i)
+      weighted.push_back(std::make_pair(levels[l][i], size_t(1) << l));
+  }
+  std::sort(weighted.begin(), weighted.end());
+
+  // Find the first value whose cumulative weight covers the position.
+  size_t cumulative = 0;
+  for (size_t i = 0; i < weighted.size(); ++i)
+  {
+    cumulative += weighted[i].second;
+    if ((double) cumulative > position)
+      return weighted[i].first;
+  }
+
+  return weighted.back().first;
+}
+
+size_t QuantileSketch::Size() const
+{
+  size_t size = 0;
+  for (size_t l = 0; l < levels.size(); ++l)
+    size += levels[l].size();
+  return size;
+}
+
+void QuantileSketch::Compress()
+{
+  for (size_t l = 0; l < levels.size(); ++l)
+  {
+    if (levels[l].size() < k)
+      continue;
+
+    if (l + 1 == levels.size())
+    {
+      levels.push_back(std::vector<double>());
+      offsets.push_back(0);
+    }
+
+    // An odd value out stays in this level; every other one of the remaining
+    // values moves to the next level, with twice the weight.
+    std::vector<double>& level = levels[l];
+    std::sort(level.begin(), level.end());
+    const size_t numPairs = level.size() / 2;
+    const size_t offset = offsets[l];
+    offsets[l] = 1 - offsets[l];
+
+    std::vector<double>& next = levels[l + 1];
+    for (size_t i = 0; i < numPairs; ++i)
+      next.push_back(level[2 * i + offset]);
+
+    if (level.size() % 2 == 1)
+      level[0] = level.back();
+    level.resize(level.size() % 2);
+  }
+}
+
+} // namespace math
+} // namespace mlpack
@@ -0,0 +1,123 @@
+/**
+ * @file core/math/quantile_sketch.hpp
+ *
+ * Definition of the QuantileSketch class, a mergeable summary of a stream of
+ * values that answers quantile queries in a small amount of memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_QUANTILE_SKETCH_HPP
+#define MLPACK_CORE_MATH_QUANTILE_SKETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * QuantileSketch summarizes a stream of values in one pass with a hierarchy of
+ * compactors, as in the KLL sketch:
+ *
+ * @code
+ * @inproceedings{karnin2016optimal,
+ *   title={Optimal Quantile Approximation in Streams},
+ *   author={Karnin, Z. and Lang, K. and Liberty, E.},
+ *   booktitle={Proceedings of the 57th Annual IEEE Symposium on Foundations
+ *       of Computer Science (FOCS '16)},
+ *   pages={71--78},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * The values are added to the compactor of level 0.  When the compactor of a
+ * level holds k values, they are sorted and every other one (starting with the
+ * first or the second, alternately) is moved to the next level, where each
+ * value stands for twice as many values of the stream.  So the sketch holds
+ * O(k log(n / k)) values, and the rank of the returned quantiles is off by
+ * O(n log(n / k) / k) at most.  The offsets are alternated deterministically,
+ * so that the results do not depend on a random seed.
+ *
+ * Two sketches (for instance of two parts of a dataset, summarized in
+ * parallel) can be merged into a sketch of all the values.  Until a compaction
+ * happens (that is, for fewer than k values), the quantiles are exact.
+ */
+class QuantileSketch
+{
+ public:
+  /**
+   * Create an empty sketch.
+   *
+   * @param k Capacity of each compactor (at least 2); the error decreases as
+   *     1 / k.
+   */
+  QuantileSketch(const size_t k = 1024);
+
+  //! Add a value to the sketch.
+  void Insert(const double value)
+  {
+    levels[0].push_back(value);
+    ++count;
+    if (levels[0].size() >= k)
+      Compress();
+  }
+
+  /**
+   * Add the values summarized by the given sketch to this sketch.  The two
+   * sketches must have the same capacity.
+   *
+   * @param other Sketch to merge.
+   */
+  void Merge(const QuantileSketch& other);
+
+  /**
+   * Get the q-quantile of the values (interpolated between the two closest
+   * values, as arma::median() does, when the sketch is exact).  An exception
+   * is thrown if the sketch is empty.
+   *
+   * @param q Quantile to find, between 0 and 1.
+   */
+  double Quantile(const double q) const;
+
+  //! Get the median of the values.
+  double Median() const { return Quantile(0.5); }
+
+  //! Get the number of values summarized by the sketch.
+  size_t Count() const { return count; }
+
+  //! Get the number of values held by the sketch.
+  size_t Size() const;
+
+  //! Get the capacity of each compactor.
+  size_t K() const { return k; }
+
+  //! Serialize the sketch.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(k);
+    ar & BOOST_SERIALIZATION_NVP(count);
+    ar & BOOST_SERIALIZATION_NVP(levels);
+    ar & BOOST_SERIALIZATION_NVP(offsets);
+  }
+
+ private:
+  //! Compact the full levels.
+  void Compress();
+
+  //! Capacity of each compactor.
+  size_t k;
+  //! Number of values summarized by the sketch.
+  size_t count;
+  //! The values of each level; a value of level l stands for 2^l values.
+  std::vector<std::vector<double>> levels;
+  //! The offset of the next compaction of each level (0 or 1).
+  std::vector<size_t> offsets;
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -8,6 +8,7 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <cstddef>
 #include <random>
 #include <mlpack/mlpack_export.hpp>
 
@@ -20,6 +21,10 @@ MLPACK_EXPORT std::mt19937 randGen;
 MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
+// Seed of the per-thread random objects.
+MLPACK_EXPORT size_t randThreadSeed = 0;
+// Number of times the seed has been set.
+MLPACK_EXPORT size_t randThreadSeedVersion = 0;
 
 } // namespace math
 } // namespace mlpack
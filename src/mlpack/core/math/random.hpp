@@ -13,8 +13,13 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/mlpack_export.hpp>
+#include <mlpack/core/math/philox.hpp>
 #include <random>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
 
@@ -29,6 +34,11 @@ extern MLPACK_EXPORT std::mt19937 randGen;
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+// Seed of the per-thread random objects.
+extern MLPACK_EXPORT size_t randThreadSeed;
+// Number of times the seed has been set; the per-thread random objects are
+// reseeded when it changes.
+extern MLPACK_EXPORT size_t randThreadSeedVersion;
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
@@ -41,6 +51,8 @@ inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
     randGen.seed((uint32_t) seed);
+    randThreadSeed = seed;
+    ++randThreadSeedVersion;
     #if (BINDING_TYPE == BINDING_TYPE_R)
       // To suppress Found ‘srand’, possibly from ‘srand’ (C).
       (void) seed;
@@ -65,6 +77,8 @@ inline void FixedRandomSeed()
 {
   const static size_t seed = rand();
   randGen.seed((uint32_t) seed);
+  randThreadSeed = seed;
+  ++randThreadSeedVersion;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
@@ -72,16 +86,259 @@ inline void FixedRandomSeed()
 inline void CustomRandomSeed(const size_t seed)
 {
   randGen.seed((uint32_t) seed);
+  randThreadSeed = seed;
+  ++randThreadSeedVersion;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
 #endif
 
 /**
- * Generates a uniform random number between 0 and 1.
+ * Get the random object of the task run by the calling thread, or NULL if the
+ * thread is not in a RandomTaskScope.
+ */
+inline Philox*& TaskRandGen()
+{
+  static thread_local Philox* generator = NULL;
+  return generator;
+}
+
+/**
+ * Get the random object of the calling thread.  Unlike randGen, it can be used
+ * concurrently from OpenMP regions: each thread has its own counter-based
+ * generator, whose stream is the index of the thread in the OpenMP team and
+ * whose key is the seed given to RandomSeed().  So the results are
+ * reproducible for a given seed and number of threads, as long as each thread
+ * is given the same work (e.g. with a static schedule).  To be independent of
+ * the number of threads, use a RandomTaskScope per task instead.  In a
+ * RandomTaskScope, the random object of the task is returned.
+ */
+inline Philox& ThreadRandGen()
+{
+  if (TaskRandGen() != NULL)
+    return *TaskRandGen();
+
+  static thread_local Philox generator;
+  static thread_local size_t version = std::numeric_limits<size_t>::max();
+  static thread_local size_t threadIndex = 0;
+
+  size_t currentThreadIndex = 0;
+  #ifdef HAS_OPENMP
+    currentThreadIndex = (size_t) omp_get_thread_num();
+  #endif
+
+  if (version != randThreadSeedVersion || threadIndex != currentThreadIndex)
+  {
+    generator.Seed(randThreadSeed, currentThreadIndex);
+    version = randThreadSeedVersion;
+    threadIndex = currentThreadIndex;
+  }
+
+  return generator;
+}
+
+/**
+ * Get whether the random functions draw from ThreadRandGen() (in a
+ * RandomTaskScope or in an OpenMP parallel region) instead of randGen.
+ */
+inline bool UseThreadRandGen()
+{
+  if (TaskRandGen() != NULL)
+    return true;
+
+  #ifdef HAS_OPENMP
+    return omp_in_parallel();
+  #else
+    return false;
+  #endif
+}
+
+/**
+ * Draw a 64-bit seed for the random objects of a group of tasks, from
+ * ThreadRandGen() if UseThreadRandGen() is true and from randGen otherwise.
+ */
+inline uint64_t RandomTaskSeed()
+{
+  if (UseThreadRandGen())
+  {
+    Philox& generator = ThreadRandGen();
+    return ((uint64_t) generator() << 32) | generator();
+  }
+
+  return ((uint64_t) randGen() << 32) | randGen();
+}
+
+/**
+ * While an object of this class exists, the random functions of this file
+ * (Random(), RandInt(), RandNormal(), RandVector(), ...) called from the
+ * calling thread draw from a Philox generator with the given seed and stream,
+ * instead of randGen or the random object of the thread.  So a task gives the
+ * same results whichever thread runs it, and whether or not it runs in a
+ * parallel region: draw one seed with RandomTaskSeed() before the loop over
+ * the tasks, and open a scope at the start of each task, with the index of the
+ * task as the stream.
+ *
+ * @code
+ * const uint64_t seed = math::RandomTaskSeed();
+ * #pragma omp parallel for schedule(dynamic)
+ * for (omp_size_t i = 0; i < (omp_size_t) numTasks; ++i)
+ * {
+ *   math::RandomTaskScope randomScope(seed, i);
+ *   // ...
+ * }
+ * @endcode
+ *
+ * Scopes can be nested; the random object of the enclosing scope is used again
+ * when a scope ends.  Armadillo's random functions (arma::randu() and so on)
+ * are not affected.
+ */
+class RandomTaskScope
+{
+ public:
+  /**
+   * Open the scope.
+   *
+   * @param seed Seed of the random object of the task.
+   * @param stream Stream of the random object (usually the index of the task).
+   */
+  RandomTaskScope(const uint64_t seed, const uint64_t stream) :
+      generator(seed, stream),
+      previous(TaskRandGen())
+  {
+    TaskRandGen() = &generator;
+  }
+
+  //! Close the scope.
+  ~RandomTaskScope() { TaskRandGen() = previous; }
+
+  //! A RandomTaskScope cannot be copied.
+  RandomTaskScope(const RandomTaskScope& other) = delete;
+  //! A RandomTaskScope cannot be copied.
+  RandomTaskScope& operator=(const RandomTaskScope& other) = delete;
+
+ private:
+  //! The random object of the task.
+  Philox generator;
+  //! The random object of the enclosing scope, if any.
+  Philox* previous;
+};
+
+/**
+ * Fill the given vector with uniform random numbers in the specified range,
+ * drawn from the given random object.
+ *
+ * @param v Vector to fill (its size is not changed).
+ * @param generator Random object to use.
+ * @param lo Lower bound of the random numbers.
+ * @param hi Upper bound of the random numbers.
+ */
+template<typename VecType, typename GeneratorType>
+inline void RandVector(VecType& v,
+                       GeneratorType& generator,
+                       const double lo = 0.0,
+                       const double hi = 1.0)
+{
+  std::uniform_real_distribution<> dist(lo, hi);
+  typename VecType::elem_type* values = v.memptr();
+  for (size_t i = 0; i < v.n_elem; ++i)
+    values[i] = (typename VecType::elem_type) dist(generator);
+}
+
+/**
+ * Fill the given vector with uniform random numbers in the specified range,
+ * drawn from the random object of the calling thread (see ThreadRandGen()), so
+ * this can be called from OpenMP regions.
+ *
+ * @param v Vector to fill (its size is not changed).
+ * @param lo Lower bound of the random numbers.
+ * @param hi Upper bound of the random numbers.
+ */
+template<typename VecType>
+inline void RandVector(VecType& v, const double lo = 0.0, const double hi = 1.0)
+{
+  RandVector(v, ThreadRandGen(), lo, hi);
+}
+
+/**
+ * Fill the given vector with normally distributed random numbers with the
+ * specified mean and standard deviation, drawn from the given random object.
+ *
+ * @param v Vector to fill (its size is not changed).
+ * @param generator Random object to use.
+ * @param mean Mean of distribution.
+ * @param stddev Standard deviation of distribution.
+ */
+template<typename VecType, typename GeneratorType>
+inline void RandNormalVector(VecType& v,
+                             GeneratorType& generator,
+                             const double mean = 0.0,
+                             const double stddev = 1.0)
+{
+  std::normal_distribution<> dist(mean, stddev);
+  typename VecType::elem_type* values = v.memptr();
+  for (size_t i = 0; i < v.n_elem; ++i)
+    values[i] = (typename VecType::elem_type) dist(generator);
+}
+
+/**
+ * Fill the given matrix with a random Bernoulli mask: each element is set to
+ * the given value with probability 1 - ratio, and to 0 otherwise (this is the
+ * mask of dropout layers).  Only one 32-bit random integer is drawn per
+ * element, which is much cheaper than comparing uniform random numbers with
+ * the ratio.  The elements are filled in blocks, in parallel if OpenMP is
+ * available; each block has its own Philox stream, whose seed is drawn once
+ * with RandomTaskSeed(), so the mask does not depend on the number of threads.
+ *
+ * @param mask Matrix to fill (its size is not changed).
+ * @param ratio Probability of setting an element to 0.
+ * @param value Value of the other elements.
+ */
+template<typename MatType>
+inline void RandMask(MatType& mask,
+                     const double ratio,
+                     const typename MatType::elem_type value = 1)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (ratio <= 0.0)
+  {
+    mask.fill(value);
+    return;
+  }
+  else if (ratio >= 1.0)
+  {
+    mask.zeros();
+    return;
+  }
+
+  // An element is kept if its random integer is at least the threshold.
+  const uint64_t threshold = (uint64_t) (ratio * 4294967296.0);
+
+  const uint64_t seed = RandomTaskSeed();
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (mask.n_elem + blockSize - 1) / blockSize;
+  ElemType* values = mask.memptr();
+
+  #pragma omp parallel for schedule(static) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    Philox generator(seed, (uint64_t) b);
+    const size_t end = std::min(mask.n_elem, ((size_t) b + 1) * blockSize);
+    for (size_t i = (size_t) b * blockSize; i < end; ++i)
+      values[i] = ((uint64_t) generator() >= threshold) ? value : ElemType(0);
+  }
+}
+
+/**
+ * Generates a uniform random number between 0 and 1.  Inside an OpenMP
+ * parallel region or a RandomTaskScope, the number is drawn from the random
+ * object of the calling thread (see ThreadRandGen()) instead of the global one.
  */
 inline double Random()
 {
+  if (UseThreadRandGen())
+    return std::uniform_real_distribution<>(0.0, 1.0)(ThreadRandGen());
+
   return randUniformDist(randGen);
 }
 
@@ -90,7 +347,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * Random();
 }
 
 /**
@@ -109,7 +366,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * Random());
 }
 
 /**
@@ -117,15 +374,20 @@ inline int RandInt(const int hiExclusive)
  */
 inline int RandInt(const int lo, const int hiExclusive)
 {
-  return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+  return lo + (int) std::floor((double) (hiExclusive - lo) * Random());
 }
 
 /**
  * Generates a normally distributed random number with mean 0 and variance 1.
+ * Inside an OpenMP parallel region or a RandomTaskScope, the number is drawn
+ * from the random object of the calling thread (see ThreadRandGen()) instead of
+ * the global one.
  */
 inline double RandNormal()
 {
+  if (UseThreadRandGen())
+    return std::normal_distribution<>(0.0, 1.0)(ThreadRandGen());
+
   return randNormalDist(randGen);
 }
 
@@ -138,7 +400,7 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormal() + mean;
 }
 
 /**
@@ -179,6 +441,46 @@ inline void ObtainDistinctSamples(const size_t loInclusive,
   }
 }
 
+/**
+ * Obtains no more than maxNumSamples distinct samples, each in
+ * [loInclusive, hiExclusive), drawn from the given random object.  Unlike the
+ * overload above, this can be called from several threads at once, each with
+ * its own random object.  The samples are sorted.
+ *
+ * @param loInclusive The lower bound (inclusive).
+ * @param hiExclusive The high bound (exclusive).
+ * @param maxNumSamples The maximum number of samples to obtain.
+ * @param distinctSamples The samples that will be obtained.
+ * @param generator Random object to use.
+ */
+template<typename GeneratorType>
+inline void ObtainDistinctSamples(const size_t loInclusive,
+                                  const size_t hiExclusive,
+                                  const size_t maxNumSamples,
+                                  arma::uvec& distinctSamples,
+                                  GeneratorType& generator)
+{
+  const size_t samplesRangeSize = hiExclusive - loInclusive;
+
+  if (samplesRangeSize > maxNumSamples)
+  {
+    // Draw the samples with replacement and keep the distinct ones; this only
+    // needs memory for the samples, not for the whole range.
+    std::uniform_int_distribution<size_t> dist(0, samplesRangeSize - 1);
+    arma::uvec samples(maxNumSamples);
+    for (size_t i = 0; i < maxNumSamples; ++i)
+      samples[i] = loInclusive + dist(generator);
+
+    distinctSamples = (maxNumSamples == 0) ? samples : arma::unique(samples);
+  }
+  else
+  {
+    distinctSamples.set_size(samplesRangeSize);
+    for (size_t i = 0; i < samplesRangeSize; ++i)
+      distinctSamples[i] = loInclusive + i;
+  }
+}
+
 } // namespace math
 } // namespace mlpack
 
@@ -14,15 +14,157 @@
 
 #include <mlpack/prereqs.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace math {
 
+/**
+ * Reorder the columns of the given dense matrix in place, so that column i
+ * becomes the column that was at index ordering[i].  The permutation is done
+ * by following its cycles, so only one column is buffered, instead of a copy
+ * of the whole matrix.  Throws std::invalid_argument if the ordering is not a
+ * permutation of the columns.
+ *
+ * @param matrix Matrix to reorder.
+ * @param ordering Permutation of the column indices.
+ */
+template<typename MatType>
+void PermuteColumns(MatType& matrix, const arma::uvec& ordering)
+{
+  if (ordering.n_elem != matrix.n_cols)
+  {
+    throw std::invalid_argument("PermuteColumns(): the ordering must have one "
+        "element per column");
+  }
+
+  // Check the ordering before moving anything, so that an invalid ordering
+  // leaves the matrix as it was.
+  std::vector<bool> visited(matrix.n_cols, false);
+  for (size_t i = 0; i < ordering.n_elem; ++i)
+  {
+    if (ordering[i] >= matrix.n_cols || visited[ordering[i]])
+    {
+      throw std::invalid_argument("PermuteColumns(): the ordering is not a "
+          "permutation");
+    }
+    visited[ordering[i]] = true;
+  }
+
+  typedef typename MatType::elem_type ElemType;
+  const size_t nRows = matrix.n_rows;
+  std::fill(visited.begin(), visited.end(), false);
+  std::vector<ElemType> buffer(nRows);
+  for (size_t start = 0; start < matrix.n_cols; ++start)
+  {
+    if (visited[start])
+      continue;
+
+    std::copy(matrix.colptr(start), matrix.colptr(start) + nRows,
+        buffer.begin());
+    size_t i = start;
+    while (true)
+    {
+      visited[i] = true;
+      const size_t next = ordering[i];
+      if (next == start)
+        break;
+
+      std::copy(matrix.colptr(next), matrix.colptr(next) + nRows,
+          matrix.colptr(i));
+      i = next;
+    }
+    std::copy(buffer.begin(), buffer.end(), matrix.colptr(i));
+  }
+}
+
+/**
+ * Copy the columns of the given dense matrix with the given indices into the
+ * output, in parallel when mlpack is compiled with OpenMP.  This is the same
+ * as output = input.cols(indices); the output can be the input.  Throws
+ * std::invalid_argument if an index is not the index of a column.
+ *
+ * @param input Matrix to copy the columns of.
+ * @param indices Indices of the columns to copy.
+ * @param output Matrix to copy the columns into.
+ */
+template<typename MatType>
+void GatherColumns(const MatType& input,
+                   const arma::uvec& indices,
+                   MatType& output)
+{
+  if (indices.n_elem > 0 && indices.max() >= input.n_cols)
+  {
+    throw std::invalid_argument("GatherColumns(): index out of bounds");
+  }
+
+  if (&input == &output)
+  {
+    MatType gathered;
+    GatherColumns(input, indices, gathered);
+    output = std::move(gathered);
+    return;
+  }
+
+  const size_t nRows = input.n_rows;
+  output.set_size(nRows, indices.n_elem);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) indices.n_elem; ++i)
+  {
+    std::copy(input.colptr(indices[i]), input.colptr(indices[i]) + nRows,
+        output.colptr(i));
+  }
+}
+
+/**
+ * Set output to input.cols(ordering), in place if the output is the input.
+ * This is used by ShuffleData().
+ */
+template<typename MatType>
+void ShuffleColumns(const MatType& input,
+                    const arma::uvec& ordering,
+                    MatType& output)
+{
+  if (&input == &output)
+    PermuteColumns(output, ordering);
+  else
+    GatherColumns(input, ordering, output);
+}
+
+/**
+ * Shuffle a dense dataset and associated labels (or responses) in place.  This
+ * is the same as ShuffleData(points, labels, points, labels).
+ *
+ * @param points Dataset to shuffle.
+ * @param labels Labels to shuffle along with the points.
+ */
+template<typename MatType, typename LabelsType>
+void ShuffleDataInPlace(MatType& points, LabelsType& labels)
+{
+  if (points.n_cols != labels.n_cols)
+  {
+    throw std::invalid_argument("ShuffleDataInPlace(): the points and the "
+        "labels must have the same number of columns");
+  }
+
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      points.n_cols - 1, points.n_cols));
+
+  PermuteColumns(points, ordering);
+  PermuteColumns(labels, ordering);
+}
+
 /**
  * Shuffle a dataset and associated labels (or responses).  It is expected that
  * inputPoints and inputLabels have the same number of columns (so, be sure that
  * inputLabels, if it is a vector, is a row vector).
  *
- * Shuffled data will be output into outputPoints and outputLabels.
+ * Shuffled data will be output into outputPoints and outputLabels.  If the
+ * outputs are the inputs, the data is shuffled in place (see
+ * PermuteColumns()), without a copy.
  */
 template<typename MatType, typename LabelsType>
 void ShuffleData(const MatType& inputPoints,
@@ -36,8 +178,8 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
+  ShuffleColumns(inputPoints, ordering, outputPoints);
+  ShuffleColumns(inputLabels, ordering, outputLabels);
 }
 
 /**
@@ -154,7 +296,8 @@ void ShuffleData(const MatType& inputPoints,
  * vector).
  *
  * Shuffled data will be output into outputPoints and outputLabels and
- * outputWeights.
+ * outputWeights.  If the outputs are the inputs, the data is shuffled in place
+ * (see PermuteColumns()), without a copy.
  */
 template<typename MatType, typename LabelsType, typename WeightsType>
 void ShuffleData(const MatType& inputPoints,
@@ -170,9 +313,9 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
-  outputWeights = inputWeights.cols(ordering);
+  ShuffleColumns(inputPoints, ordering, outputPoints);
+  ShuffleColumns(inputLabels, ordering, outputLabels);
+  ShuffleColumns(inputWeights, ordering, outputWeights);
 }
 
 /**
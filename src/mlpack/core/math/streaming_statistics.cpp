@@ -0,0 +1,131 @@
+/**
+ * @file core/math/streaming_statistics.cpp
+ *
+ * Implementation of the StreamingStatistics class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "streaming_statistics.hpp"
+
+namespace mlpack {
+namespace math {
+
+StreamingStatistics::StreamingStatistics(const size_t dimensionality,
+                                         const size_t sketchSize) :
+    count(0),
+    sketchSize(sketchSize),
+    moments(dimensionality),
+    sketches(dimensionality, QuantileSketch(sketchSize))
+{
+  // Nothing to do.
+}
+
+void StreamingStatistics::Merge(const StreamingStatistics& other)
+{
+  if (other.moments.size() != moments.size() ||
+      other.sketchSize != sketchSize)
+  {
+    throw std::invalid_argument("StreamingStatistics::Merge(): the "
+        "dimensionality and the sketch size must be the same");
+  }
+
+  for (size_t d = 0; d < moments.size(); ++d)
+  {
+    moments[d].Merge(other.moments[d]);
+    sketches[d].Merge(other.sketches[d]);
+  }
+  count += other.count;
+}
+
+double StreamingStatistics::Variance(const size_t d,
+                                     const bool population) const
+{
+  const double n = (double) moments[d].count;
+  return moments[d].m2 / (population ? n : n - 1);
+}
+
+double StreamingStatistics::Skewness(const size_t d,
+                                     const bool population) const
+{
+  const double n = (double) moments[d].count;
+  const double s3 = std::pow(Stddev(d, population), 3);
+  if (population)
+    return moments[d].m3 / (n * s3);
+  else
+    return n * moments[d].m3 / ((n - 1) * (n - 2) * s3);
+}
+
+double StreamingStatistics::Kurtosis(const size_t d,
+                                     const bool population) const
+{
+  const double n = (double) moments[d].count;
+  if (population)
+    return n * moments[d].m4 / std::pow(moments[d].m2, 2) - 3;
+
+  const double s4 = std::pow(Stddev(d, false), 4);
+  const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+  const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+  return normC * (moments[d].m4 / s4) - norm3;
+}
+
+void StreamingStatistics::Moments::Insert(const double value)
+{
+  const double n1 = (double) count;
+  ++count;
+  const double n = (double) count;
+
+  const double delta = value - mean;
+  const double deltaN = delta / n;
+  const double deltaN2 = deltaN * deltaN;
+  const double term = delta * deltaN * n1;
+
+  mean += deltaN;
+  m4 += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2 -
+      4 * deltaN * m3;
+  m3 += term * deltaN * (n - 2) - 3 * deltaN * m2;
+  m2 += term;
+
+  min = std::min(min, value);
+  max = std::max(max, value);
+}
+
+void StreamingStatistics::Moments::Merge(const Moments& other)
+{
+  if (other.count == 0)
+    return;
+
+  if (count == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  const double na = (double) count;
+  const double nb = (double) other.count;
+  const double n = na + nb;
+  const double delta = other.mean - mean;
+  const double delta2 = delta * delta;
+
+  // The moments of higher order use the lower-order moments of both sides
+  // before they are merged.
+  const double newM4 = m4 + other.m4 + delta2 * delta2 * na * nb *
+      (na * na - na * nb + nb * nb) / (n * n * n) + 6 * delta2 *
+      (na * na * other.m2 + nb * nb * m2) / (n * n) + 4 * delta *
+      (na * other.m3 - nb * m3) / n;
+  const double newM3 = m3 + other.m3 + delta2 * delta * na * nb * (na - nb) /
+      (n * n) + 3 * delta * (na * other.m2 - nb * m2) / n;
+  m2 += other.m2 + delta2 * na * nb / n;
+  m3 = newM3;
+  m4 = newM4;
+  mean += delta * nb / n;
+  count += other.count;
+
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+}
+
+} // namespace math
+} // namespace mlpack
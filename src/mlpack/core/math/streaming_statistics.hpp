@@ -0,0 +1,184 @@
+/**
+ * @file core/math/streaming_statistics.hpp
+ *
+ * Definition of the StreamingStatistics class, which computes descriptive
+ * statistics of each dimension of a dataset in one pass over its points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_STREAMING_STATISTICS_HPP
+#define MLPACK_CORE_MATH_STREAMING_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "quantile_sketch.hpp"
+
+namespace mlpack {
+namespace math {
+
+/**
+ * StreamingStatistics accumulates the count, the mean, the central moments of
+ * order 2 to 4, the minimum, the maximum and a QuantileSketch of each
+ * dimension of a dataset, so that the variance, the skewness, the kurtosis and
+ * the median can be computed after one pass over the points.  The dataset can
+ * be given in chunks of points (for instance from a data::ChunkedLoader), and
+ * two objects that accumulated different points can be merged; the moments
+ * are updated and merged with the numerically stable formulas of
+ *
+ * @code
+ * @techreport{pebay2008formulas,
+ *   title={Formulas for Robust, One-Pass Parallel Computation of Covariances
+ *       and Arbitrary-Order Statistical Moments},
+ *   author={P{\'e}bay, P.},
+ *   institution={Sandia National Laboratories},
+ *   number={SAND2008-6212},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Update() handles each dimension, and each block of BlockSize points of each
+ * dimension, in parallel if OpenMP is available; the blocks of a dimension are
+ * then merged in order, so the results do not depend on the number of
+ * threads.  The median is exact for fewer points than the capacity of the
+ * sketches, and approximate otherwise.
+ *
+ * @code
+ * data::ChunkedLoader<double> loader("dataset.csv", 100000);
+ * math::StreamingStatistics stats(loader.Dimensionality());
+ * arma::mat chunk;
+ * while (loader.Next(chunk))
+ *   stats.Update(chunk);
+ * @endcode
+ */
+class StreamingStatistics
+{
+ public:
+  /**
+   * Create the object for the given number of dimensions, with no points.
+   *
+   * @param dimensionality Number of dimensions of the points.
+   * @param sketchSize Capacity of the compactors of the quantile sketches.
+   */
+  StreamingStatistics(const size_t dimensionality = 0,
+                      const size_t sketchSize = 1024);
+
+  /**
+   * Add the given points (the columns of the matrix) to the statistics.
+   *
+   * @param points Points to add.
+   */
+  template<typename MatType>
+  void Update(const MatType& points);
+
+  /**
+   * Add the points accumulated by the given object to the statistics.  The
+   * two objects must have the same dimensionality and sketch size.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const StreamingStatistics& other);
+
+  //! Get the number of dimensions.
+  size_t Dimensionality() const { return moments.size(); }
+  //! Get the number of points.
+  size_t Count() const { return count; }
+
+  //! Get the mean of the given dimension.
+  double Mean(const size_t d) const { return moments[d].mean; }
+  //! Get the minimum of the given dimension.
+  double Min(const size_t d) const { return moments[d].min; }
+  //! Get the maximum of the given dimension.
+  double Max(const size_t d) const { return moments[d].max; }
+  //! Get the median of the given dimension.
+  double Median(const size_t d) const { return sketches[d].Median(); }
+  //! Get the q-quantile of the given dimension.
+  double Quantile(const size_t d, const double q) const
+  {
+    return sketches[d].Quantile(q);
+  }
+
+  /**
+   * Get the variance of the given dimension.
+   *
+   * @param d Dimension.
+   * @param population If true, the points are the whole population;
+   *     otherwise, they are a sample, and the unbiased estimate is returned.
+   */
+  double Variance(const size_t d, const bool population = false) const;
+
+  //! Get the standard deviation of the given dimension (see Variance()).
+  double Stddev(const size_t d, const bool population = false) const
+  {
+    return std::sqrt(Variance(d, population));
+  }
+
+  /**
+   * Get the skewness of the given dimension.
+   *
+   * @param d Dimension.
+   * @param population If false, the sample skewness (adjusted for the bias)
+   *     is returned.
+   */
+  double Skewness(const size_t d, const bool population = false) const;
+
+  /**
+   * Get the excess kurtosis of the given dimension.
+   *
+   * @param d Dimension.
+   * @param population If false, the sample excess kurtosis (adjusted for the
+   *     bias) is returned.
+   */
+  double Kurtosis(const size_t d, const bool population = false) const;
+
+  //! The number of points of each dimension that are accumulated by one task
+  //! of Update().
+  static const size_t BlockSize = 65536;
+
+ private:
+  //! The moments of one dimension.
+  struct Moments
+  {
+    Moments() :
+        count(0),
+        mean(0.0),
+        m2(0.0),
+        m3(0.0),
+        m4(0.0),
+        min(DBL_MAX),
+        max(-DBL_MAX)
+    { }
+
+    //! Add a value.
+    void Insert(const double value);
+    //! Add the values accumulated by other.
+    void Merge(const Moments& other);
+
+    //! Number of values.
+    size_t count;
+    //! Mean of the values.
+    double mean;
+    //! Sums of the powers 2 to 4 of the deviations from the mean.
+    double m2, m3, m4;
+    //! Minimum and maximum of the values.
+    double min, max;
+  };
+
+  //! Number of points.
+  size_t count;
+  //! Capacity of the compactors of the sketches.
+  size_t sketchSize;
+  //! The moments of each dimension.
+  std::vector<Moments> moments;
+  //! The quantile sketch of each dimension.
+  std::vector<QuantileSketch> sketches;
+};
+
+} // namespace math
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_statistics_impl.hpp"
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file core/math/streaming_statistics_impl.hpp
+ *
+ * Implementation of the template functions of the StreamingStatistics class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_STREAMING_STATISTICS_IMPL_HPP
+#define MLPACK_CORE_MATH_STREAMING_STATISTICS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_statistics.hpp"
+
+namespace mlpack {
+namespace math {
+
+template<typename MatType>
+void StreamingStatistics::Update(const MatType& points)
+{
+  if (points.n_rows != moments.size())
+  {
+    std::ostringstream oss;
+    oss << "StreamingStatistics::Update(): the points have " << points.n_rows
+        << " dimensions, but " << moments.size() << " were expected";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (points.n_cols == 0)
+    return;
+
+  // Each block of each dimension is accumulated separately.
+  const size_t numBlocks = (points.n_cols + BlockSize - 1) / BlockSize;
+  const size_t numTasks = numBlocks * points.n_rows;
+  std::vector<Moments> blockMoments(numTasks);
+  std::vector<QuantileSketch> blockSketches(numTasks,
+      QuantileSketch(sketchSize));
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) numTasks; ++t)
+  {
+    const size_t d = (size_t) t / numBlocks;
+    const size_t begin = ((size_t) t % numBlocks) * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) points.n_cols);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double value = (double) points(d, i);
+      blockMoments[t].Insert(value);
+      blockSketches[t].Insert(value);
+    }
+  }
+
+  // Merge the blocks of each dimension in order.
+  #pragma omp parallel for
+  for (omp_size_t d = 0; d < (omp_size_t) points.n_rows; ++d)
+  {
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      moments[d].Merge(blockMoments[d * numBlocks + b]);
+      sketches[d].Merge(blockSketches[d * numBlocks + b]);
+    }
+  }
+
+  count += points.n_cols;
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
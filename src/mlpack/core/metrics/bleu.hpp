@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <unordered_map>
+
 namespace mlpack {
 namespace metric {
 
@@ -94,6 +96,11 @@ class BLEU
    * calculates other BLEU metrics (brevity penalty, translation length, reference
    * length, ratio and precisions) which can be accessed by their corresponding
    * accessor methods.
+   *
+   * The n-grams are counted in hash tables keyed on views of the paragraphs
+   * (no n-gram is copied), and the paragraphs are split across threads if
+   * OpenMP is available, so large corpora can be scored quickly.  The words
+   * must be hashable with std::hash.
    */
   template <typename ReferenceCorpusType, typename TranslationCorpusType>
   ElemType Evaluate(const ReferenceCorpusType& referenceCorpus,
@@ -129,13 +136,48 @@ class BLEU
 
  private:
   /**
-   * Extracts all the n-grams.
+   * An n-gram of a paragraph, given by the position of its first word and its
+   * order, with its hash.  Two n-grams are equal if they have the same words.
+   */
+  template <typename WordVector>
+  struct NGram
+  {
+    typename WordVector::const_iterator begin;
+    size_t order;
+    size_t hash;
+
+    bool operator==(const NGram& other) const
+    {
+      return order == other.order && hash == other.hash &&
+          std::equal(begin, std::next(begin, order), other.begin);
+    }
+  };
+
+  //! Hash an NGram with its precomputed hash.
+  template <typename WordVector>
+  struct NGramHash
+  {
+    size_t operator()(const NGram<WordVector>& ngram) const
+    {
+      return ngram.hash;
+    }
+  };
+
+  //! A table of counts of n-grams.
+  template <typename WordVector>
+  using NGramCounts = std::unordered_map<NGram<WordVector>, size_t,
+      NGramHash<WordVector>>;
+
+  /**
+   * Counts all the n-grams of order 1 to maxOrder of a paragraph.
    *
    * @tparam WordVector Type of the tokenized vector.
    * @param segment Tokenized sequence represented in form of vector.
+   * @param counts Table to store the counts in (it is cleared first).
    */
   template <typename WordVector>
-  std::map<WordVector, size_t> GetNGrams(const WordVector& segment);
+  void CountNGrams(const WordVector& segment,
+                   NGramCounts<WordVector>& counts) const;
 
   //! Locally-stored value of maximum length of tokens in n-grams.
   size_t maxOrder;
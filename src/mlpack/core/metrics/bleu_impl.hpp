@@ -15,6 +15,10 @@
 // In case it hasn't been included.
 #include "bleu.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace metric {
 
@@ -29,20 +33,32 @@ BLEU<ElemType, PrecisionType>::BLEU(const size_t maxOrder) :
 
 template <typename ElemType, typename PrecisionType>
 template <typename WordVector>
-std::map<WordVector, size_t> BLEU<ElemType, PrecisionType>::GetNGrams(
-    const WordVector& segment)
+void BLEU<ElemType, PrecisionType>::CountNGrams(
+    const WordVector& segment,
+    NGramCounts<WordVector>& counts) const
 {
-  std::map<WordVector, size_t> ngramsCount;
-  for (size_t order = 1; order < maxOrder + 1; ++order)
+  counts.clear();
+
+  std::hash<typename WordVector::value_type> wordHash;
+  std::vector<size_t> wordHashes;
+  wordHashes.reserve(segment.size());
+  for (const auto& word : segment)
+    wordHashes.push_back(wordHash(word));
+
+  auto it = segment.cbegin();
+  for (size_t i = 0; i < wordHashes.size(); ++i, ++it)
   {
-    for (size_t i = 0; i + order < segment.size() + 1; ++i)
+    // The hash of each n-gram starting at i is obtained from the hash of the
+    // (n - 1)-gram, as boost::hash_combine() does.
+    size_t hash = 0;
+    for (size_t order = 1; order < maxOrder + 1 &&
+        i + order < wordHashes.size() + 1; ++order)
     {
-      WordVector seq = WordVector(segment.cbegin() + i,
-                                  segment.cbegin() + i + order);
-      ngramsCount[seq]++;
+      hash ^= wordHashes[i + order - 1] + 0x9e3779b9 + (hash << 6) +
+          (hash >> 2);
+      ++counts[NGram<WordVector>{ it, order, hash }];
     }
   }
-  return ngramsCount;
 }
 
 template <typename ElemType, typename PrecisionType>
@@ -55,85 +71,122 @@ ElemType BLEU<ElemType, PrecisionType>::Evaluate(
   // WordVector is a string container type.
   // Also, TranslationCorpusType is an array of such containers.
   typedef typename TranslationCorpusType::value_type WordVector;
+  typedef typename ReferenceCorpusType::value_type ReferenceType;
 
-  // matchesByOrder: It catches how many times sequence of a particular order
-  // is encountered in both reference corpus and translation corpus.
-  std::vector<size_t> matchesByOrder(maxOrder, 0);
-
-  // possibleMatchesByOrder: It tracks how many possible matches can be in the
-  // translation corpus.
-  std::vector<size_t> possibleMatchesByOrder(maxOrder, 0);
-
-  // referenceLength: It is the sum of minimum length of the paragraph from
-  // various documents.
-  // translationLength: It is the sum of length of each paragraphs.
-  referenceLength = 0, translationLength = 0;
-
+  // Gather the pairs of references and translations, so that they can be
+  // split across threads.
+  std::vector<const ReferenceType*> references;
+  std::vector<const WordVector*> translations;
   auto refIt = referenceCorpus.cbegin();
   auto trIt = translationCorpus.cbegin();
   for (; refIt != referenceCorpus.cend() && trIt != translationCorpus.cend();
       ++refIt, ++trIt)
   {
-    size_t min = std::numeric_limits<size_t>::max();
-    for (const auto& t : *refIt)
-    {
-      if (min > t.size())
-      {
-        min = t.size();
-      }
-    }
+    references.push_back(&(*refIt));
+    translations.push_back(&(*trIt));
+  }
 
-    if (min == std::numeric_limits<size_t>::max())
-      min = 0;
+  // Split the paragraphs into one block per thread.  Each block counts its
+  // matches with its own hash tables, and the counts are summed afterwards.
+  #ifdef HAS_OPENMP
+  const size_t numBlocks = std::max((size_t) 1, std::min(
+      (size_t) omp_get_max_threads(), translations.size()));
+  #else
+  const size_t numBlocks = 1;
+  #endif
 
-    referenceLength += min;
-    translationLength += trIt->size();
+  // blockMatches: It catches how many times sequence of a particular order
+  // is encountered in both reference corpus and translation corpus.
+  // blockPossibleMatches: It tracks how many possible matches can be in the
+  // translation corpus.
+  std::vector<std::vector<size_t>> blockMatches(numBlocks,
+      std::vector<size_t>(maxOrder, 0));
+  std::vector<std::vector<size_t>> blockPossibleMatches(numBlocks,
+      std::vector<size_t>(maxOrder, 0));
+  std::vector<size_t> blockReferenceLengths(numBlocks, 0);
+  std::vector<size_t> blockTranslationLengths(numBlocks, 0);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = ((size_t) b * translations.size()) / numBlocks;
+    const size_t end = (((size_t) b + 1) * translations.size()) / numBlocks;
 
     // mergedRefNGramCounts: It accumulates all the similar n-grams from
     // various references or documents, so that there is no repetition of
     // any key (sequence of order n).
-    std::map<WordVector, size_t> mergedRefNGramCounts;
-    for (const auto& t : *refIt)
+    NGramCounts<WordVector> mergedRefNGramCounts;
+    NGramCounts<WordVector> ngrams;
+    for (size_t p = begin; p < end; ++p)
     {
-      // ngram: It holds the n-grams of each document/reference.
-      const std::map<WordVector, size_t> ngrams = GetNGrams(t);
-      for (auto it = ngrams.cbegin(); it != ngrams.cend(); ++it)
+      const WordVector& translation = *translations[p];
+
+      size_t min = std::numeric_limits<size_t>::max();
+      for (const auto& t : *references[p])
       {
-        mergedRefNGramCounts[it->first] = std::max(it->second,
-            mergedRefNGramCounts[it->first]);
+        if (min > t.size())
+        {
+          min = t.size();
+        }
       }
-    }
-    // translationNGramCounts: It extracts the n-grams of the generated text
-    // sequence.
-    const std::map<WordVector, size_t> translationNGramCounts
-        = GetNGrams(*trIt);
-
-    // overlap: It holds those keys (sequence of order n) which are common to
-    // reference corpus and translation corpus.
-    std::map<WordVector, size_t> overlap;
-    for (auto it = translationNGramCounts.cbegin();
-         it != translationNGramCounts.cend();
-         ++it)
-    {
-      auto mergedIt = mergedRefNGramCounts.find(it->first);
-      if (mergedIt != mergedRefNGramCounts.end())
+
+      if (min == std::numeric_limits<size_t>::max())
+        min = 0;
+
+      blockReferenceLengths[b] += min;
+      blockTranslationLengths[b] += translation.size();
+
+      mergedRefNGramCounts.clear();
+      for (const auto& t : *references[p])
       {
-        // If the key (sequence of order n) is present in both translation
-        // corpus as well as reference corpus, then the minimum number of
-        // counts it has occurred in any is considered.
-        overlap[it->first] = std::min(mergedIt->second, it->second);
+        // ngrams: It holds the n-grams of each document/reference.
+        CountNGrams(t, ngrams);
+        for (auto it = ngrams.cbegin(); it != ngrams.cend(); ++it)
+        {
+          size_t& count = mergedRefNGramCounts[it->first];
+          count = std::max(it->second, count);
+        }
       }
-    }
 
-    for (auto it = overlap.cbegin(); it != overlap.cend(); ++it)
-    {
-      matchesByOrder[it->first.size() - 1] += it->second;
+      // Now ngrams holds the n-grams of the generated text sequence.  If an
+      // n-gram is present in both the translation and the references, then
+      // the minimum number of counts it has occurred in any is considered.
+      CountNGrams(translation, ngrams);
+      for (auto it = ngrams.cbegin(); it != ngrams.cend(); ++it)
+      {
+        auto mergedIt = mergedRefNGramCounts.find(it->first);
+        if (mergedIt != mergedRefNGramCounts.end())
+        {
+          blockMatches[b][it->first.order - 1] +=
+              std::min(mergedIt->second, it->second);
+        }
+      }
+
+      for (size_t order = 1; order < maxOrder + 1; ++order)
+      {
+        if (order < translation.size() + 1)
+        {
+          blockPossibleMatches[b][order - 1] +=
+              translation.size() - order + 1;
+        }
+      }
     }
+  }
 
-    for (size_t order = 1; order < maxOrder + 1; ++order)
+  // referenceLength: It is the sum of minimum length of the paragraph from
+  // various documents.
+  // translationLength: It is the sum of length of each paragraphs.
+  referenceLength = 0, translationLength = 0;
+  std::vector<size_t> matchesByOrder(maxOrder, 0);
+  std::vector<size_t> possibleMatchesByOrder(maxOrder, 0);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    referenceLength += blockReferenceLengths[b];
+    translationLength += blockTranslationLengths[b];
+    for (size_t i = 0; i < maxOrder; ++i)
     {
-      if (order < trIt->size() + 1)
-        possibleMatchesByOrder[order - 1] += trIt->size() - order + 1;
+      matchesByOrder[i] += blockMatches[b][i];
+      possibleMatchesByOrder[i] += blockPossibleMatches[b][i];
     }
   }
 
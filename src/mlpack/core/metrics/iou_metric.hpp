@@ -59,11 +59,40 @@ class IoU
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the Intersection over Union metric between each bounding box of
+   * a and each bounding box of b (one bounding box per column), with the same
+   * convention as the two-vector overload.  The boxes are checked and
+   * converted once, and the columns of the result are computed in parallel,
+   * if OpenMP is available.
+   *
+   * @tparam MatTypeA Type of first matrix.
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of bounding boxes.
+   * @param b Second set of bounding boxes.
+   * @param ious Matrix to store the IoU of box i of a and box j of b in, at
+   *     (i, j).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::Mat<typename MatTypeA::elem_type>& ious);
+
   static const bool useCoordinates = UseCoordinates;
 
   //! Serialize the metric.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Check the given bounding boxes and convert them to the {x0, y0, x1, y1}
+   * representation, with their areas.
+   */
+  template<typename MatType>
+  static void Corners(const MatType& boxes,
+                      arma::Mat<typename MatType::elem_type>& corners,
+                      arma::Col<typename MatType::elem_type>& areas);
 }; // class IoU
 
 } // namespace metric
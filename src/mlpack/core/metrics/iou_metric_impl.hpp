@@ -64,6 +64,80 @@ typename VecTypeA::elem_type IoU<UseCoordinates>::Evaluate(
   return interSectionArea / (1.0 * ((a(2) + 1) * (a(3) + 1) + (b(2) + 1) *
       (b(3) + 1) - interSectionArea));
 }
+template<bool UseCoordinates>
+template<typename MatTypeA, typename MatTypeB>
+void IoU<UseCoordinates>::Evaluate(
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::Mat<typename MatTypeA::elem_type>& ious)
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  arma::Mat<ElemType> cornersA, cornersB;
+  arma::Col<ElemType> areasA, areasB;
+  Corners(a, cornersA, areasA);
+  Corners(arma::conv_to<arma::Mat<ElemType>>::from(b), cornersB, areasB);
+
+  ious.set_size(a.n_cols, b.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    const ElemType bx0 = cornersB(0, j), by0 = cornersB(1, j);
+    const ElemType bx1 = cornersB(2, j), by1 = cornersB(3, j);
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const ElemType interSectionArea =
+          std::max(ElemType(0), std::min(cornersA(2, i), bx1) -
+          std::max(cornersA(0, i), bx0) + 1) *
+          std::max(ElemType(0), std::min(cornersA(3, i), by1) -
+          std::max(cornersA(1, i), by0) + 1);
+      ious(i, j) = interSectionArea / (areasA[i] + areasB[j] -
+          interSectionArea);
+    }
+  }
+}
+
+template<bool UseCoordinates>
+template<typename MatType>
+void IoU<UseCoordinates>::Corners(
+    const MatType& boxes,
+    arma::Mat<typename MatType::elem_type>& corners,
+    arma::Col<typename MatType::elem_type>& areas)
+{
+  Log::Assert(boxes.n_rows == 4, "Incorrect shape for bounding boxes. They \
+      must contain 4 elements either be {x0, y0, x1, y1} or {x0, y0, h, w}. \
+      Refer to the documentation for more information.");
+
+  corners = boxes;
+  if (UseCoordinates)
+  {
+    // Check the correctness of bounding boxes.
+    for (size_t i = 0; i < boxes.n_cols; ++i)
+    {
+      if (boxes(0, i) >= boxes(2, i) || boxes(1, i) >= boxes(3, i))
+      {
+        Log::Fatal << "Check the correctness of bounding boxes i.e. " <<
+            "{x0, y0} must represent lower left coordinates and " <<
+            "{x1, y1} must represent upper right coordinates of bounding" <<
+            "box." << std::endl;
+      }
+    }
+  }
+  else
+  {
+    Log::Assert(arma::all(boxes.row(2) > 0) && arma::all(boxes.row(3) > 0),
+        "Height and width of bounding boxes must be greater than zero.");
+
+    // Change height - width representation to coordinate represention.
+    corners.row(2) += corners.row(0);
+    corners.row(3) += corners.row(1);
+  }
+
+  areas = ((corners.row(2) - corners.row(0) + 1) %
+      (corners.row(3) - corners.row(1) + 1)).t();
+}
+
 template<bool UseCoordinates>
 template<typename Archive>
 void IoU<UseCoordinates>::serialize(
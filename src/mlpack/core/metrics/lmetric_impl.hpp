@@ -18,16 +18,46 @@
 namespace mlpack {
 namespace metric {
 
-// Unspecialized implementation.  This should almost never be used...
+/**
+ * Computes x^Power by repeated squaring, unrolled at compile time, so that the
+ * generic LMetric is a loop of multiplications that the compiler can vectorize
+ * instead of a call to std::pow() for each dimension.
+ */
+template<int Power>
+struct IntegerPower
+{
+  template<typename ElemType>
+  static ElemType Apply(const ElemType x)
+  {
+    const ElemType half = IntegerPower<Power / 2>::Apply(x);
+    return (Power % 2 == 0) ? half * half : half * half * x;
+  }
+};
+
+template<>
+struct IntegerPower<1>
+{
+  template<typename ElemType>
+  static ElemType Apply(const ElemType x) { return x; }
+};
+
+// Unspecialized implementation, for powers other than 1, 2 and infinity.
 template<int Power, bool TakeRoot>
 template<typename VecTypeA, typename VecTypeB>
 typename VecTypeA::elem_type LMetric<Power, TakeRoot>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  typename VecTypeA::elem_type sum = 0;
+  typedef typename VecTypeA::elem_type ElemType;
+
+  ElemType sum = 0;
   for (size_t i = 0; i < a.n_elem; ++i)
-    sum += std::pow(fabs(a[i] - b[i]), Power);
+  {
+    // This is also correct for unsigned types.
+    const ElemType ai = a[i];
+    const ElemType bi = b[i];
+    sum += IntegerPower<Power>::Apply((ai > bi) ? (ai - bi) : (bi - ai));
+  }
 
   if (!TakeRoot) // The compiler should optimize this correctly at compile-time.
     return sum;
@@ -73,30 +103,16 @@ typename VecTypeA::elem_type LMetric<2, false>::Evaluate(
   return accu(arma::square(a - b));
 }
 
-// L3-metric specialization (not very likely to be used, but just in case).
-template<>
-template<typename VecTypeA, typename VecTypeB>
-typename VecTypeA::elem_type LMetric<3, true>::Evaluate(
-    const VecTypeA& a,
-    const VecTypeB& b)
-{
-  typename VecTypeA::elem_type sum = 0;
-  for (size_t i = 0; i < a.n_elem; ++i)
-    sum += std::pow(fabs(a[i] - b[i]), 3.0);
-
-  return std::pow(arma::accu(arma::pow(arma::abs(a - b), 3.0)), 1.0 / 3.0);
-}
-
+// L-infinity (Chebyshev distance) specializations; the root doesn't matter.
 template<>
 template<typename VecTypeA, typename VecTypeB>
-typename VecTypeA::elem_type LMetric<3, false>::Evaluate(
+typename VecTypeA::elem_type LMetric<INT_MAX, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(arma::pow(arma::abs(a - b), 3.0));
+  return arma::as_scalar(arma::max(arma::abs(a - b)));
 }
 
-// L-infinity (Chebyshev distance) specialization
 template<>
 template<typename VecTypeA, typename VecTypeB>
 typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
@@ -37,10 +37,25 @@ namespace metric {
  *
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
- * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * decomposing Q = L^T L, and then multiplying the data by L; Transform() does
+ * this.  The Euclidean distance between transformed points is then the
+ * Mahalanobis distance between the original points (or the squared Euclidean
+ * distance, if TakeRoot is false), so the default KDTree and the fast Euclidean
+ * distance kernels can be used:
+ *
+ * @code
+ * MahalanobisDistance<> md(covariance);
+ * arma::mat transformedReference, transformedQuery;
+ * md.Transform(referenceSet, transformedReference);
+ * md.Transform(querySet, transformedQuery);
+ *
+ * KNN knn(std::move(transformedReference));
+ * knn.Search(transformedQuery, k, neighbors, distances);
+ * @endcode
+ *
+ * If you still wish to use the KNN class with a custom distance anyway, you
+ * will need to use a different tree type than the default KDTree, which only
+ * works with the LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -96,6 +111,29 @@ class MahalanobisDistance
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Compute a factor L of the covariance matrix, such that Q = L^T L.  A
+   * Cholesky decomposition is used if Q is positive definite; otherwise (if Q
+   * is only positive semidefinite, as metrics learned by LMNN or NCA may be),
+   * L is computed from the eigendecomposition of Q, with negative eigenvalues
+   * (rounding errors) set to 0.
+   *
+   * @param factor Matrix to store L in.
+   */
+  void Factor(arma::mat& factor) const;
+
+  /**
+   * Transform the given points by a factor L of the covariance matrix (see
+   * Factor()), so that the Euclidean distance between two transformed points is
+   * the Mahalanobis distance between the original points.  The factor is
+   * computed once for all the points.
+   *
+   * @param input Points to transform (one point per column).
+   * @param output Matrix to store the transformed points in.
+   */
+  template<typename MatType>
+  void Transform(const MatType& input, MatType& output) const;
+
   /**
    * Access the covariance matrix.
    *
@@ -47,6 +47,44 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   return sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Factor(arma::mat& factor) const
+{
+  // arma::chol() gives an upper triangular R such that Q = R^T R.
+  if (arma::chol(factor, covariance))
+    return;
+
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, covariance))
+  {
+    Log::Fatal << "MahalanobisDistance::Factor(): eigendecomposition of the "
+        << "covariance matrix failed!" << std::endl;
+  }
+
+  // Q = V diag(lambda) V^T, so L = diag(sqrt(lambda)) V^T.
+  eigenvalues.transform([](double x) { return std::sqrt(std::max(x, 0.0)); });
+  factor = eigenvectors.t();
+  factor.each_col() %= eigenvalues;
+}
+
+template<bool TakeRoot>
+template<typename MatType>
+void MahalanobisDistance<TakeRoot>::Transform(const MatType& input,
+                                              MatType& output) const
+{
+  if (covariance.n_rows == 0)
+  {
+    // An unset covariance matrix is the identity.
+    output = input;
+    return;
+  }
+
+  arma::mat factor;
+  Factor(factor);
+  output = arma::conv_to<MatType>::from(factor) * input;
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
@@ -44,7 +44,11 @@ class NMS
   NMS() { /* Nothing to do here. */ }
 
   /**
-   * Performs non-maximal suppression.
+   * Performs non-maximal suppression.  The boxes are sorted by decreasing
+   * confidence score, and for each box, a bit mask of the lower scoring boxes
+   * it suppresses is computed, 64 boxes per word (in parallel, if OpenMP is
+   * available).  The boxes are then selected greedily, in a single pass that
+   * only combines the masks.
    *
    * @param boundingBoxes Column major representation of bounding boxes
    *                      i.e. Each column corresponds to a different bounding
@@ -70,6 +74,28 @@ class NMS
                        OutputType& selectedIndices,
                        const double threshold = 0.5);
 
+  /**
+   * Performs non-maximal suppression on each of a batch of images, in
+   * parallel if OpenMP is available.
+   *
+   * @param boundingBoxes Bounding boxes of each image (see the single image
+   *                      overload).
+   * @param confidenceScores Confidence scores of the bounding boxes of each
+   *                         image.
+   * @param selectedIndices Selected indices of each image are stored here.
+   * @param threshold Threshold used to discard all overlapping bounding boxes
+   *                  that have IoU greater than the threshold.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename OutputType
+  >
+  static void Evaluate(const std::vector<BoundingBoxesType>& boundingBoxes,
+                       const std::vector<ConfidenceScoreType>& confidenceScores,
+                       std::vector<OutputType>& selectedIndices,
+                       const double threshold = 0.5);
+
   static const bool useCoordinates = UseCoordinates;
 
   //! Serialize the metric.
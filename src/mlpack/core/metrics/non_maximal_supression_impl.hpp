@@ -35,93 +35,109 @@ void NMS<UseCoordinates>::Evaluate(
       box either in {x1, y1, x2, y2} or {x1, y1, h, w} format.\
       Refer to the documentation for more information.");
 
-  Log::Assert(confidenceScores.n_cols != boundingBoxes.n_cols, "Each \
+  Log::Assert(confidenceScores.n_elem == boundingBoxes.n_cols, "Each \
       bounding box must correspond to atleast and only 1 bounding box. \
-      Found " + std::to_string(confidenceScores.n_cols) + " confidence \
+      Found " + std::to_string(confidenceScores.n_elem) + " confidence \
       scores for " + std::to_string(boundingBoxes.n_cols) + " bounding boxes.");
 
-  // Clear selected bounding boxes.
-  selectedIndices.clear();
+  const size_t n = boundingBoxes.n_cols;
 
-  // Obtain Sorted indices for bounding boxes according to
-  // their confidence scores.
-  arma::ucolvec sortedIndices = arma::sort_index(confidenceScores);
-
-  // Pre-Compute area of each bounding box.
-  arma::mat area;
-  if (UseCoordinates)
-  {
-    area = (boundingBoxes.row(2) - boundingBoxes.row(0)) %
-        (boundingBoxes.row(3) - boundingBoxes.row(1));
-  }
-  else
+  // Sort the bounding boxes by decreasing confidence score, and convert them
+  // to the coordinate representation.
+  const arma::uvec sortedIndices = arma::stable_sort_index(confidenceScores,
+      "descend");
+  arma::mat corners(4, n);
+  arma::vec area(n);
+  for (size_t k = 0; k < n; ++k)
   {
-    area = boundingBoxes.row(2) % boundingBoxes.row(3);
+    const size_t i = sortedIndices[k];
+    corners(0, k) = boundingBoxes(0, i);
+    corners(1, k) = boundingBoxes(1, i);
+    corners(2, k) = boundingBoxes(2, i);
+    corners(3, k) = boundingBoxes(3, i);
+    if (!UseCoordinates)
+    {
+      // Change height - width representation to coordinate represention.
+      corners(2, k) += corners(0, k);
+      corners(3, k) += corners(1, k);
+    }
+    area[k] = (corners(2, k) - corners(0, k)) *
+        (corners(3, k) - corners(1, k));
   }
 
-  while (sortedIndices.n_elem > 0)
-  {
-    size_t selectedIndex = sortedIndices(sortedIndices.n_elem - 1);
-
-    // Choose the box with the largest probability.
-    selectedIndices.insert_rows(0, arma::uvec(1).fill(selectedIndex));
+  // Bit l % 64 of word l / 64 of the mask of box k is set if box k suppresses
+  // box l (l > k in the sorted order), i.e. if their IoU is greater than the
+  // threshold.
+  const size_t words = (n + 63) / 64;
+  std::vector<uint64_t> masks(n * words, 0);
 
-    // Check if there are other bounding boxes to compare with.
-    if (sortedIndices.n_elem == 1)
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t k = 0; k < (omp_size_t) n; ++k)
+  {
+    const double x1 = corners(0, k), y1 = corners(1, k);
+    const double x2 = corners(2, k), y2 = corners(3, k);
+    for (size_t w = (k + 1) / 64; w < words; ++w)
     {
-      break;
+      uint64_t word = 0;
+      const size_t end = std::min(n, 64 * (w + 1));
+      for (size_t l = std::max((size_t) k + 1, 64 * w); l < end; ++l)
+      {
+        const double intersectionArea =
+            std::max(0.0, std::min(x2, corners(2, l)) -
+            std::max(x1, corners(0, l))) *
+            std::max(0.0, std::min(y2, corners(3, l)) -
+            std::max(y1, corners(1, l)));
+        if (intersectionArea > threshold * (area[k] + area[l] -
+            intersectionArea))
+        {
+          word |= ((uint64_t) 1) << (l - 64 * w);
+        }
+      }
+      masks[k * words + w] = word;
     }
+  }
 
-    // Remove the last index.
-    sortedIndices = sortedIndices(arma::span(0, sortedIndices.n_rows - 2),
-        arma::span());
-
-    // Get x and y coordinates for remaining bounding boxes.
-    BoundingBoxesType x2 = boundingBoxes.submat(arma::uvec(1).fill(2),
-        sortedIndices);
-
-    BoundingBoxesType x1 = boundingBoxes.submat(arma::uvec(1).fill(0),
-        sortedIndices);;
-
-    BoundingBoxesType y2 = boundingBoxes.submat(arma::uvec(1).fill(3),
-        sortedIndices);
-
-    BoundingBoxesType y1 = boundingBoxes.submat(arma::uvec(1).fill(1),
-        sortedIndices);
-
-    size_t selectedX2 = boundingBoxes(2, selectedIndex);
-    size_t selectedY2 = boundingBoxes(3, selectedIndex);
-    size_t selectedX1 = boundingBoxes(0, selectedIndex);
-    size_t selectedY1 = boundingBoxes(1, selectedIndex);
+  // Select the boxes greedily: a box is kept if no kept box suppresses it.
+  std::vector<uint64_t> suppressed(words, 0);
+  std::vector<size_t> selected;
+  for (size_t k = 0; k < n; ++k)
+  {
+    if ((suppressed[k / 64] >> (k % 64)) & 1)
+      continue;
 
-    if (!UseCoordinates)
-    {
-      // Change height - width representation to coordinate represention.
-      x2 = x2 + x1;
-      y2 = y2 + y1;
-      selectedX2 = selectedX2 + selectedX1;
-      selectedY2 = selectedY2 + selectedY1;
-    }
+    selected.push_back(sortedIndices[k]);
+    for (size_t w = k / 64; w < words; ++w)
+      suppressed[w] |= masks[k * words + w];
+  }
 
-    // Calculate points of intersection between the bounding box with
-    // highest confidence score and remaining bounding boxes.
-    x2 = arma::clamp(x2, DBL_MIN, selectedX2);
-    y2 = arma::clamp(y2, DBL_MIN, selectedY2);
-    x1 = arma::clamp(x1, selectedX1, DBL_MAX);
-    y1 = arma::clamp(y1, selectedY1, DBL_MAX);
+  selectedIndices.set_size(selected.size());
+  for (size_t i = 0; i < selected.size(); ++i)
+    selectedIndices[i] = selected[i];
+}
 
-    BoundingBoxesType intersectionArea = arma::clamp(x2 - x1, 0.0, DBL_MAX) %
-          arma::clamp(y2 - y1, 0.0, DBL_MAX);
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::Evaluate(
+    const std::vector<BoundingBoxesType>& boundingBoxes,
+    const std::vector<ConfidenceScoreType>& confidenceScores,
+    std::vector<OutputType>& selectedIndices,
+    const double threshold)
+{
+  Log::Assert(confidenceScores.size() == boundingBoxes.size(), "There must \
+      be one set of confidence scores for each set of bounding boxes.");
 
-    // Calculate IoU of remaining boxes with the last bounding box with
-    // the highest confidence score.
-    BoundingBoxesType calculateIoU = intersectionArea /
-        (area(sortedIndices).t() - intersectionArea + area(selectedIndex));
+  selectedIndices.resize(boundingBoxes.size());
 
-    sortedIndices = sortedIndices(arma::find(calculateIoU <= threshold));
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) boundingBoxes.size(); ++i)
+  {
+    Evaluate(boundingBoxes[i], confidenceScores[i], selectedIndices[i],
+        threshold);
   }
-
-  selectedIndices = arma::flipud(selectedIndices);
 }
 
 template<bool UseCoordinates>
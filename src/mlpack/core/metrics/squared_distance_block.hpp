@@ -0,0 +1,168 @@
+/**
+ * @file core/metrics/squared_distance_block.hpp
+ *
+ * Computation of a whole block of squared Euclidean distances at once, with
+ * the expansion ||a - b||^2 = ||a||^2 + ||b||^2 - 2 a^T b, for dense and sparse
+ * matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_SQUARED_DISTANCE_BLOCK_HPP
+#define MLPACK_CORE_METRICS_SQUARED_DISTANCE_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * Compute the squared Euclidean distance between every column of a and every
+ * column of b, so that distances(i, j) holds the distance between a.col(i) and
+ * b.col(j).  The distances are computed as ||a||^2 + ||b||^2 - 2 a^T b, so most
+ * of the work is done by a single matrix multiplication (a BLAS gemm() call).
+ *
+ * This is not exact: cancellation makes small distances between large vectors
+ * inaccurate.  To limit this, both sets are centered on the mean of b first,
+ * and the returned value is a bound on the absolute error of every element of
+ * distances.  Callers that need exact distances can use the block to discard
+ * pairs that certainly do not matter, and evaluate the rest exactly.
+ *
+ * @param a First set of points (one per column).
+ * @param b Second set of points (one per column).
+ * @param distances Output: matrix of squared distances, of size a.n_cols by
+ *     b.n_cols.
+ * @return Bound on the absolute error of each computed squared distance.
+ */
+template<typename MatType>
+typename MatType::elem_type SquaredDistanceBlock(
+    const MatType& a,
+    const MatType& b,
+    arma::Mat<typename MatType::elem_type>& distances)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef arma::Mat<ElemType> DenseMatType;
+  typedef arma::Col<ElemType> ColType;
+  typedef arma::Row<ElemType> RowType;
+
+  // Center both sets, so that the norms are on the scale of the blocks rather
+  // than on the scale of the whole dataset.
+  const ColType center = arma::mean(b, 1);
+  const DenseMatType centeredA = a.each_col() - center;
+  const DenseMatType centeredB = b.each_col() - center;
+
+  const ColType aNorms = arma::sum(arma::square(centeredA), 0).t();
+  const RowType bNorms = arma::sum(arma::square(centeredB), 0);
+
+  distances = -2 * centeredA.t() * centeredB;
+  distances.each_col() += aNorms;
+  distances.each_row() += bNorms;
+
+  // Rounding can make distances between (nearly) identical points negative.
+  distances.transform([](const ElemType d) { return std::max(d, ElemType(0)); });
+
+  // The error of each dot product is bounded by (dims + 2) * epsilon times the
+  // norms involved; be generous with the constant.
+  const ElemType normBound = (aNorms.n_elem == 0 ? 0 : aNorms.max()) +
+      (bNorms.n_elem == 0 ? 0 : bNorms.max());
+  return 4 * (a.n_rows + 4) * std::numeric_limits<ElemType>::epsilon() *
+      normBound;
+}
+
+/**
+ * Compute the squared Euclidean distance between every column of the sparse
+ * matrix a and every column of the sparse matrix b, like the overload above.
+ * The sets are not centered, since that would make them dense: the norms of the
+ * points are computed from their nonzero values, and the dot products with a
+ * single sparse matrix product, so the cost depends on the number of nonzero
+ * values rather than on the dimensionality.  (Sparse data like TF-IDF vectors
+ * usually have small norms, so the error bound stays small.)
+ *
+ * @param a First set of points (one per column).
+ * @param b Second set of points (one per column).
+ * @param distances Output: matrix of squared distances, of size a.n_cols by
+ *     b.n_cols.
+ * @return Bound on the absolute error of each computed squared distance.
+ */
+template<typename ElemType>
+ElemType SquaredDistanceBlock(
+    const arma::SpMat<ElemType>& a,
+    const arma::SpMat<ElemType>& b,
+    arma::Mat<ElemType>& distances)
+{
+  const arma::Mat<ElemType> aNorms(arma::sum(arma::square(a), 0));
+  const arma::Mat<ElemType> bNorms(arma::sum(arma::square(b), 0));
+
+  distances = arma::Mat<ElemType>(arma::SpMat<ElemType>(a.t() * b));
+  distances *= -2;
+  distances.each_col() += arma::Col<ElemType>(aNorms.t());
+  distances.each_row() += arma::Row<ElemType>(bNorms);
+
+  // Rounding can make distances between (nearly) identical points negative.
+  distances.transform([](const ElemType d) { return std::max(d, ElemType(0)); });
+
+  const ElemType normBound = (aNorms.n_elem == 0 ? 0 : aNorms.max()) +
+      (bNorms.n_elem == 0 ? 0 : bNorms.max());
+  return 4 * (a.n_rows + 4) * std::numeric_limits<ElemType>::epsilon() *
+      normBound;
+}
+
+/**
+ * Copy the given columns of a dense matrix into a new matrix, to form a block
+ * for SquaredDistanceBlock().
+ *
+ * @param data Matrix to take the columns of.
+ * @param indices Indices of the columns to take.
+ */
+template<typename ElemType>
+arma::Mat<ElemType> GatherColumns(const arma::Mat<ElemType>& data,
+                                  const std::vector<size_t>& indices)
+{
+  return data.cols(arma::conv_to<arma::uvec>::from(indices));
+}
+
+/**
+ * Copy the given columns of a sparse matrix into a new sparse matrix, to form a
+ * block for SquaredDistanceBlock().  The new matrix is built from the nonzero
+ * values of the columns all at once, which is much faster than assigning the
+ * columns one by one.
+ *
+ * @param data Matrix to take the columns of.
+ * @param indices Indices of the columns to take.
+ */
+template<typename ElemType>
+arma::SpMat<ElemType> GatherColumns(const arma::SpMat<ElemType>& data,
+                                    const std::vector<size_t>& indices)
+{
+  std::vector<arma::uword> rows, cols;
+  std::vector<ElemType> values;
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    typename arma::SpMat<ElemType>::const_iterator it =
+        data.begin_col(indices[i]);
+    for (; it != data.end_col(indices[i]); ++it)
+    {
+      rows.push_back(it.row());
+      cols.push_back(i);
+      values.push_back(*it);
+    }
+  }
+
+  arma::umat locations(2, values.size());
+  for (size_t j = 0; j < values.size(); ++j)
+  {
+    locations(0, j) = rows[j];
+    locations(1, j) = cols[j];
+  }
+
+  // The locations are already sorted by column, and then by row.
+  return arma::SpMat<ElemType>(locations, arma::Col<ElemType>(values),
+      data.n_rows, indices.size(), false, false);
+}
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -12,8 +12,10 @@
 #define MLPACK_CORE_TREE_BINARY_SPACE_TREE_BINARY_SPACE_TREE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <unordered_map>
 
 #include "../statistic.hpp"
+#include "../split_traits.hpp"
 #include "midpoint_split.hpp"
 
 namespace mlpack {
@@ -59,6 +61,9 @@ class BinarySpaceTree
   //! The type of element held in MatType.
   typedef typename MatType::elem_type ElemType;
 
+  //! Count the memory of the nodes, if memory tracking is enabled.
+  MLPACK_TRACK_ALLOCATIONS
+
   typedef SplitType<BoundType<MetricType>, MatType> Split;
 
  private:
@@ -88,6 +93,11 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If the tree has been compacted and we are the root, this holds every
+  //! other node of the tree, in depth-first order.
+  BinarySpaceTree* nodeBlock;
+  //! The number of nodes in nodeBlock.
+  size_t nodeBlockSize;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -102,6 +112,11 @@ class BinarySpaceTree
   template<typename RuleType>
   class BreadthFirstDualTreeTraverser;
 
+  //! A task-parallel dual-tree traverser for binary space trees; see
+  //! parallel_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  class ParallelDualTreeTraverser;
+
   /**
    * Construct this as the root node of a binary space tree using the given
    * dataset.  This will copy the input matrix; if you don't want this, consider
@@ -278,6 +293,18 @@ class BinarySpaceTree
    */
   BinarySpaceTree(const BinarySpaceTree& other);
 
+  /**
+   * Create a binary space tree with the same structure as a tree with another
+   * statistic type, by copying its nodes and its dataset; the statistics are
+   * then computed for this tree.  This takes linear time, so it is much faster
+   * than building the tree again (see tree::TreeCache).
+   *
+   * @param other Tree to copy the structure of.
+   */
+  template<typename OtherStatisticType>
+  explicit BinarySpaceTree(const BinarySpaceTree<MetricType, OtherStatisticType,
+      MatType, BoundType, SplitType>& other);
+
   /**
    * Move constructor for a BinarySpaceTree; possess all the members of the
    * given tree.
@@ -315,6 +342,108 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Move every node of the tree (except the root itself) into one contiguous
+   * block of memory, in depth-first (pre-order) order.  A depth-first
+   * traversal then walks through memory mostly sequentially, instead of
+   * chasing pointers across the heap.  Nothing else about the tree changes,
+   * so all traversers can be used as before.
+   *
+   * This can only be called on the root of the tree, and pointers or
+   * references to any other node of the tree are invalidated.  Statistics that
+   * hold pointers to tree nodes are not updated, so this should be called
+   * before any such statistics are computed.  Copying, serializing, or loading
+   * a tree gives a tree that is not compacted.
+   */
+  void Compact();
+
+  //! Return whether or not the nodes of the tree are stored in one block.
+  bool IsCompact() const { return nodeBlock != NULL; }
+
+  /**
+   * Insert the given points into the tree.  Each point is added to the leaf
+   * found by following GetNearestChild() down from the root, and the bounds of
+   * the leaf and of its ancestors are widened to hold it.  The tree is then
+   * rebalanced lazily: only the leaves that end up with more than maxLeafSize
+   * points are split again, and the rest of the tree keeps its structure.
+   * (Trees whose split type cannot split a node on its own, like the UB tree,
+   * are rebuilt entirely; see SplitTraits.)
+   *
+   * The dataset is rebuilt once for all the given points, so that the points of
+   * each node stay contiguous; this takes time linear in the size of the
+   * dataset, and moves points of the dataset around.  The statistics of every
+   * node are recomputed.
+   *
+   * This can only be called on the root of a tree that is not compacted, and
+   * pointers or references to nodes and to the columns of the dataset may be
+   * invalidated.
+   *
+   * @param points Points to insert.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void Insert(const MatType& points, const size_t maxLeafSize = 20);
+
+  /**
+   * Insert the given points into the tree, like the overload above, and update
+   * the given mapping of the points of the dataset.  The inserted points get
+   * the indices oldFromNew.size(), oldFromNew.size() + 1, and so on, as if they
+   * had been appended to the original dataset.
+   *
+   * @param points Points to insert.
+   * @param oldFromNew Vector holding, for every point of the dataset, its index
+   *      in the original dataset (as filled by the tree constructor).
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void Insert(const MatType& points,
+              std::vector<size_t>& oldFromNew,
+              const size_t maxLeafSize = 20);
+
+  /**
+   * Remove the points at the given columns of the dataset from the tree.  The
+   * bounds of the nodes are left as they are (they still hold all the remaining
+   * points).  Nodes that hold maxLeafSize points or fewer become leaves, and
+   * nodes with an empty child are split again from scratch.  (Like with
+   * Insert(), UB trees are rebuilt entirely.)
+   *
+   * This can only be called on the root of a tree that is not compacted, and
+   * pointers or references to nodes and to the columns of the dataset may be
+   * invalidated.
+   *
+   * @param points Columns of the dataset to remove.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void Delete(const std::vector<size_t>& points, const size_t maxLeafSize = 20);
+
+  /**
+   * Remove the points at the given columns of the dataset from the tree, like
+   * the overload above, and update the given mapping of the points of the
+   * dataset.  The original indices of the remaining points are renumbered as
+   * if the removed points had been shed from the original dataset.
+   *
+   * @param points Columns of the dataset to remove.
+   * @param oldFromNew Vector holding, for every point of the dataset, its index
+   *      in the original dataset (as filled by the tree constructor).
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void Delete(const std::vector<size_t>& points,
+              std::vector<size_t>& oldFromNew,
+              const size_t maxLeafSize = 20);
+
+  /**
+   * Update the tree after the given columns of the dataset were modified in
+   * place (through Dataset()), keeping the structure of the tree: the bound,
+   * the distances and the statistic of each node that holds one of the given
+   * points are recomputed, and the other nodes are left as they are.  This is
+   * much cheaper than building the tree again when few points moved, but the
+   * tree may search much more slowly than a new tree if the points moved far.
+   * (The bounds of UB trees become simple hyperrectangles.)
+   *
+   * This can only be called on the root of a tree.
+   *
+   * @param points Columns of the dataset that were modified.
+   */
+  void Refit(const std::vector<size_t>& points);
+
   //! Return the bound object for this node.
   const BoundType<MetricType>& Bound() const { return bound; }
   //! Return the bound object for this node.
@@ -508,8 +637,20 @@ class BinarySpaceTree
   void Center(arma::vec& center) const { bound.Center(center); }
 
  private:
+  //! Whether or not the children of a node can be built in parallel: this needs
+  //! a thread-safe split type, and a dense matrix (the columns of a sparse
+  //! matrix cannot be swapped concurrently).
+  static const bool parallelBuild =
+      SplitTraits<SplitType<BoundType<MetricType>, MatType>>::IsThreadSafe &&
+      arma::is_Mat<MatType>::value;
+  //! The number of points a node must hold for its children to be built in
+  //! parallel.
+  static const size_t parallelBuildSize = 20000;
+
   /**
    * Splits the current node, assigning its left and right children recursively.
+   * If the split type allows it, the children of large nodes are built in
+   * parallel with OpenMP tasks.
    *
    * @param maxLeafSize Maximum number of points held in a leaf.
    * @param splitter Instantiated SplitType object.
@@ -546,6 +687,84 @@ class BinarySpaceTree
    */
   void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
 
+  /**
+   * Delete the children of this node (and the block holding them, if the tree
+   * was compacted), and set them to NULL.
+   */
+  void FreeChildren();
+
+  /**
+   * Throw std::invalid_argument if this node cannot be modified, because it is
+   * not the root of the tree or the tree is compacted.
+   *
+   * @param method Name of the calling method, for the error message.
+   */
+  void CheckModifiable(const std::string& method) const;
+
+  /**
+   * Insert the given points; oldFromNew may be NULL.  See Insert().
+   */
+  void InsertPoints(const MatType& points,
+                    std::vector<size_t>* oldFromNew,
+                    const size_t maxLeafSize);
+
+  /**
+   * Remove the points at the given columns; oldFromNew may be NULL.  See
+   * Delete().
+   */
+  void DeletePoints(const std::vector<size_t>& points,
+                    std::vector<size_t>* oldFromNew,
+                    const size_t maxLeafSize);
+
+  /**
+   * Move this node so that it starts at the given column, adding the new points
+   * of the given leaves, and append the columns the node will hold (in the
+   * dataset joined with the new points) to the given order.
+   *
+   * @param newBegin New index of the first point of this node.
+   * @param leafPoints New points to add to each leaf.
+   * @param numPoints Number of points of the dataset before the insertion.
+   * @param order Columns of the dataset joined with the new points, in their
+   *      new order.
+   */
+  void PlaceInsertedPoints(
+      const size_t newBegin,
+      const std::unordered_map<BinarySpaceTree*, std::vector<size_t>>&
+          leafPoints,
+      const size_t numPoints,
+      std::vector<arma::uword>& order);
+
+  /**
+   * Shrink the range of points of this node and its descendants, given the
+   * number of removed points before every column of the dataset.
+   *
+   * @param removedBefore removedBefore[i] is the number of removed points in
+   *      the columns before column i.
+   */
+  void RemovePointRanges(const std::vector<size_t>& removedBefore);
+
+  /**
+   * After points were inserted or removed, split the leaves that are too large,
+   * turn small nodes into leaves, split again the nodes with an empty child,
+   * and recompute the distances and statistics of every node.
+   *
+   * @param oldFromNew Mapping to update when points are moved (may be NULL).
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void RepairNode(std::vector<size_t>* oldFromNew, const size_t maxLeafSize);
+
+  /**
+   * Recompute the bound, the distances and the statistic of this node and its
+   * descendants if they hold a modified point.  See Refit().
+   *
+   * @param modified modified[i] is true if column i of the dataset was
+   *      modified.
+   * @param force If true, recompute the bound of this node even if it holds no
+   *      modified point (its children are still only refit if needed).
+   * @return Whether the bound of this node was recomputed.
+   */
+  bool RefitNode(const std::vector<bool>& modified, const bool force);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -16,6 +16,7 @@
 
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <stack>
 
 namespace mlpack {
 namespace tree {
@@ -39,7 +40,9 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -67,7 +70,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -101,7 +106,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -136,7 +143,9 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -164,7 +173,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -198,7 +209,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -237,7 +250,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -266,7 +281,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -300,7 +317,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +361,9 @@ BinarySpaceTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -379,6 +400,69 @@ BinarySpaceTree(
   }
 }
 
+/**
+ * Create a binary space tree with the structure of a tree with another
+ * statistic type.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename OtherStatisticType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    const BinarySpaceTree<MetricType, OtherStatisticType, MatType, BoundType,
+        SplitType>& other) :
+    left(NULL),
+    right(NULL),
+    parent(NULL),
+    begin(other.Begin()),
+    count(other.Count()),
+    bound(other.Bound()),
+    parentDistance(other.ParentDistance()),
+    furthestDescendantDistance(other.FurthestDescendantDistance()),
+    minimumBoundDistance(other.MinimumBoundDistance()),
+    // Copy matrix, but only if we are the root.
+    dataset((other.Parent() == NULL) ? new MatType(other.Dataset()) : NULL),
+    nodeBlock(NULL),
+    nodeBlockSize(0)
+{
+  // Create left and right children (if any).
+  if (other.Left())
+  {
+    left = new BinarySpaceTree(*other.Left());
+    left->Parent() = this;
+  }
+
+  if (other.Right())
+  {
+    right = new BinarySpaceTree(*other.Right());
+    right->Parent() = this;
+  }
+
+  // Once the whole tree is copied, the root propagates the matrix and computes
+  // the statistics, which may depend on both.
+  if (other.Parent() == NULL)
+  {
+    std::vector<BinarySpaceTree*> nodes(1, this);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      nodes[i]->dataset = dataset;
+      if (nodes[i]->left)
+        nodes.push_back(nodes[i]->left);
+      if (nodes[i]->right)
+        nodes.push_back(nodes[i]->right);
+    }
+
+    // Children come after their parents in the list, so going backwards
+    // computes the statistics from the bottom up, like the constructors do.
+    for (size_t i = nodes.size(); i > 0; --i)
+      nodes[i - 1]->stat = StatisticType(*nodes[i - 1]);
+  }
+}
+
 /**
  * Copy assignment operator: copy the given other tree.
  */
@@ -398,8 +482,7 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  FreeChildren();
 
   left = NULL;
   right = NULL;
@@ -470,8 +553,7 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  FreeChildren();
 
   parent = other.Parent();
   left = other.Left();
@@ -484,6 +566,8 @@ operator=(BinarySpaceTree&& other)
   furthestDescendantDistance = other.FurthestDescendantDistance();
   minimumBoundDistance = other.MinimumBoundDistance();
   dataset = other.dataset;
+  nodeBlock = other.nodeBlock;
+  nodeBlockSize = other.nodeBlockSize;
 
   other.left = NULL;
   other.right = NULL;
@@ -494,6 +578,14 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.nodeBlock = NULL;
+  other.nodeBlockSize = 0;
+
+  // Set new parent.
+  if (left)
+    left->parent = this;
+  if (right)
+    right->parent = this;
 
   return *this;
 }
@@ -520,7 +612,9 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    nodeBlock(other.nodeBlock),
+    nodeBlockSize(other.nodeBlockSize)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -533,6 +627,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.nodeBlock = NULL;
+  other.nodeBlockSize = 0;
 
   // Set new parent.
   if (left)
@@ -576,14 +672,519 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  FreeChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
     delete dataset;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact()
+{
+  if (parent)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Compact(): can only be "
+        "called on the root of a tree");
+  }
+
+  if (nodeBlock || !left)
+    return; // Nothing to do.
+
+  // Collect the descendants of the root in depth-first order.
+  std::vector<BinarySpaceTree*> nodes;
+  std::stack<BinarySpaceTree*> stack;
+  stack.push(right);
+  stack.push(left);
+  while (!stack.empty())
+  {
+    BinarySpaceTree* node = stack.top();
+    stack.pop();
+    nodes.push_back(node);
+
+    if (node->right)
+      stack.push(node->right);
+    if (node->left)
+      stack.push(node->left);
+  }
+
+  BinarySpaceTree* block = static_cast<BinarySpaceTree*>(
+      ::operator new(nodes.size() * sizeof(BinarySpaceTree)));
+#ifdef MLPACK_TRACK_MEMORY
+  MemoryTracker::Record(nodes.size() * sizeof(BinarySpaceTree));
+#endif
+
+  // Parents come before their children in depth-first order, so when a node is
+  // moved its parent is already in the block (the move constructor pointed the
+  // old children at the new parent), and only the parent's child pointer must
+  // be updated.
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    BinarySpaceTree* node = ::new (block + i) BinarySpaceTree(
+        std::move(*nodes[i]));
+
+    if (node->parent->left == nodes[i])
+      node->parent->left = node;
+    else
+      node->parent->right = node;
+
+    // The moved-from node holds nothing anymore.
+    delete nodes[i];
+  }
+
+  nodeBlock = block;
+  nodeBlockSize = nodes.size();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    FreeChildren()
+{
+  if (nodeBlock)
+  {
+    // The nodes in the block must not delete their children themselves.
+    for (size_t i = 0; i < nodeBlockSize; ++i)
+    {
+      nodeBlock[i].left = NULL;
+      nodeBlock[i].right = NULL;
+      nodeBlock[i].~BinarySpaceTree();
+    }
+
+    ::operator delete(nodeBlock);
+#ifdef MLPACK_TRACK_MEMORY
+    MemoryTracker::Release(nodeBlockSize * sizeof(BinarySpaceTree));
+#endif
+    nodeBlock = NULL;
+    nodeBlockSize = 0;
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Insert(const MatType& points, const size_t maxLeafSize)
+{
+  InsertPoints(points, NULL, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Insert(const MatType& points,
+           std::vector<size_t>& oldFromNew,
+           const size_t maxLeafSize)
+{
+  InsertPoints(points, &oldFromNew, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Delete(const std::vector<size_t>& points, const size_t maxLeafSize)
+{
+  DeletePoints(points, NULL, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Delete(const std::vector<size_t>& points,
+           std::vector<size_t>& oldFromNew,
+           const size_t maxLeafSize)
+{
+  DeletePoints(points, &oldFromNew, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Refit(const std::vector<size_t>& points)
+{
+  if (parent)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Refit(): can only be called "
+        "on the root of a tree");
+  }
+
+  std::vector<bool> modified(dataset->n_cols, false);
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    if (points[i] >= dataset->n_cols)
+    {
+      std::ostringstream oss;
+      oss << "BinarySpaceTree::Refit(): point " << points[i] << " is not in "
+          << "the tree (the dataset has " << dataset->n_cols << " points)";
+      throw std::invalid_argument(oss.str());
+    }
+
+    modified[points[i]] = true;
+  }
+
+  RefitNode(modified, false);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RefitNode(const std::vector<bool>& modified, const bool force)
+{
+  bool refit = force;
+  if (IsLeaf())
+  {
+    for (size_t i = begin; (i < begin + count) && !refit; ++i)
+      refit = modified[i];
+  }
+  else
+  {
+    // The bound of the right child may depend on the bound of the left child
+    // (see UpdateBound()), so it is recomputed when the left one is.
+    const bool leftRefit = left->RefitNode(modified, false);
+    const bool rightRefit = right->RefitNode(modified, leftRefit);
+    refit = refit || leftRefit || rightRefit;
+  }
+
+  if (!refit)
+    return false;
+
+  bound = BoundType<MetricType>(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (!IsLeaf())
+  {
+    arma::vec center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+    right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+  }
+
+  stat = StatisticType(*this);
+  return true;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    CheckModifiable(const std::string& method) const
+{
+  if (parent)
+  {
+    throw std::invalid_argument("BinarySpaceTree::" + method + "(): can only "
+        "be called on the root of a tree");
+  }
+
+  if (nodeBlock)
+  {
+    throw std::invalid_argument("BinarySpaceTree::" + method + "(): cannot "
+        "modify a compacted tree");
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    InsertPoints(const MatType& points,
+                 std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize)
+{
+  CheckModifiable("Insert");
+
+  if (points.n_rows != dataset->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "BinarySpaceTree::Insert(): dimensionality of points ("
+        << points.n_rows << ") does not match dimensionality of tree ("
+        << dataset->n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (points.n_cols == 0)
+    return;
+
+  // Find the leaf that each new point goes to.
+  std::unordered_map<BinarySpaceTree*, std::vector<size_t>> leafPoints;
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BinarySpaceTree* node = this;
+    while (!node->IsLeaf())
+    {
+      node = (node->GetNearestChild(points.col(i)) == 0) ? node->left :
+          node->right;
+    }
+
+    leafPoints[node].push_back(i);
+  }
+
+  // Rebuild the dataset, so that the new points of each leaf directly follow
+  // its old points.
+  const size_t numPoints = dataset->n_cols;
+  std::vector<arma::uword> order;
+  order.reserve(numPoints + points.n_cols);
+  PlaceInsertedPoints(0, leafPoints, numPoints, order);
+
+  const arma::uvec orderCols(order);
+  *dataset = MatType(arma::join_rows(*dataset, points)).cols(orderCols);
+
+  if (oldFromNew)
+  {
+    // The new points get the indices that follow the old ones.
+    std::vector<size_t> newOldFromNew(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+      newOldFromNew[i] = (order[i] < numPoints) ? (*oldFromNew)[order[i]] :
+          oldFromNew->size() + (order[i] - numPoints);
+    }
+    *oldFromNew = std::move(newOldFromNew);
+  }
+
+  // Widen the bounds of the leaves that received points, and of their
+  // ancestors.
+  typename std::unordered_map<BinarySpaceTree*,
+      std::vector<size_t>>::const_iterator it;
+  for (it = leafPoints.begin(); it != leafPoints.end(); ++it)
+  {
+    const size_t last = it->first->begin + it->first->count - 1;
+    const size_t first = last + 1 - it->second.size();
+    for (BinarySpaceTree* node = it->first; node != NULL; node = node->parent)
+      node->bound |= dataset->cols(first, last);
+  }
+
+  RepairNode(oldFromNew, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeletePoints(const std::vector<size_t>& points,
+                 std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize)
+{
+  CheckModifiable("Delete");
+
+  const size_t numPoints = dataset->n_cols;
+  std::vector<bool> removed(numPoints, false);
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    if (points[i] >= numPoints)
+    {
+      std::ostringstream oss;
+      oss << "BinarySpaceTree::Delete(): point " << points[i] << " is not in "
+          << "the tree (the dataset has " << numPoints << " points)";
+      throw std::invalid_argument(oss.str());
+    }
+
+    removed[points[i]] = true;
+  }
+
+  std::vector<size_t> removedBefore(numPoints + 1, 0);
+  for (size_t i = 0; i < numPoints; ++i)
+    removedBefore[i + 1] = removedBefore[i] + (removed[i] ? 1 : 0);
+
+  if (removedBefore[numPoints] == 0)
+    return;
+
+  RemovePointRanges(removedBefore);
+
+  std::vector<arma::uword> kept;
+  kept.reserve(numPoints - removedBefore[numPoints]);
+  for (size_t i = 0; i < numPoints; ++i)
+    if (!removed[i])
+      kept.push_back(i);
+
+  const arma::uvec keptCols(kept);
+  *dataset = MatType(dataset->cols(keptCols));
+
+  if (oldFromNew)
+  {
+    // Renumber the original indices as if the removed points were shed from
+    // the original dataset.
+    std::vector<size_t> removedOld;
+    removedOld.reserve(removedBefore[numPoints]);
+    for (size_t i = 0; i < numPoints; ++i)
+      if (removed[i])
+        removedOld.push_back((*oldFromNew)[i]);
+    std::sort(removedOld.begin(), removedOld.end());
+
+    std::vector<size_t> newOldFromNew(kept.size());
+    for (size_t i = 0; i < kept.size(); ++i)
+    {
+      const size_t oldIndex = (*oldFromNew)[kept[i]];
+      newOldFromNew[i] = oldIndex - (std::lower_bound(removedOld.begin(),
+          removedOld.end(), oldIndex) - removedOld.begin());
+    }
+    *oldFromNew = std::move(newOldFromNew);
+  }
+
+  RepairNode(oldFromNew, maxLeafSize);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    PlaceInsertedPoints(
+        const size_t newBegin,
+        const std::unordered_map<BinarySpaceTree*, std::vector<size_t>>&
+            leafPoints,
+        const size_t numPoints,
+        std::vector<arma::uword>& order)
+{
+  if (IsLeaf())
+  {
+    for (size_t i = begin; i < begin + count; ++i)
+      order.push_back(i);
+
+    typename std::unordered_map<BinarySpaceTree*,
+        std::vector<size_t>>::const_iterator it = leafPoints.find(this);
+    if (it != leafPoints.end())
+    {
+      for (size_t i = 0; i < it->second.size(); ++i)
+        order.push_back(numPoints + it->second[i]);
+      count += it->second.size();
+    }
+  }
+  else
+  {
+    left->PlaceInsertedPoints(newBegin, leafPoints, numPoints, order);
+    right->PlaceInsertedPoints(newBegin + left->count, leafPoints, numPoints,
+        order);
+    count = left->count + right->count;
+  }
+
+  begin = newBegin;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RemovePointRanges(const std::vector<size_t>& removedBefore)
+{
+  const size_t end = begin + count;
+  count -= removedBefore[end] - removedBefore[begin];
+  begin -= removedBefore[begin];
+
+  if (left)
+    left->RemovePointRanges(removedBefore);
+  if (right)
+    right->RemovePointRanges(removedBefore);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RepairNode(std::vector<size_t>* oldFromNew, const size_t maxLeafSize)
+{
+  // If the split type cannot split a node on its own, the whole tree is built
+  // again (RepairNode() is first called on the root).
+  const bool rebuild = !SplitTraits<Split>::SplitsAnyNode ||
+      (IsLeaf() ? (count > maxLeafSize) :
+      (count <= maxLeafSize || left->count == 0 || right->count == 0));
+
+  if (rebuild)
+  {
+    // Build this part of the tree again.  The bound is reset, because the
+    // split must only see the points that are actually held.
+    FreeChildren();
+    bound = BoundType<MetricType>(dataset->n_rows);
+
+    SplitType<BoundType<MetricType>, MatType> splitter;
+    if (oldFromNew)
+      SplitNode(*oldFromNew, maxLeafSize, splitter);
+    else
+      SplitNode(maxLeafSize, splitter);
+  }
+  else if (!IsLeaf())
+  {
+    left->RepairNode(oldFromNew, maxLeafSize);
+    right->RepairNode(oldFromNew, maxLeafSize);
+
+    furthestDescendantDistance = 0.5 * bound.Diameter();
+
+    arma::vec center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+    right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+  }
+  else
+  {
+    furthestDescendantDistance = 0.5 * bound.Diameter();
+  }
+
+  stat = StatisticType(*this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -868,6 +1469,22 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
               SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+  #ifdef HAS_OPENMP
+    // The children of large nodes are built in parallel, as OpenMP tasks.  The
+    // root opens the parallel region that runs them, unless we are already in
+    // one.
+    if (parallelBuild && parent == NULL && count >= parallelBuildSize &&
+        omp_get_max_threads() > 1 && omp_get_level() == 0)
+    {
+      #pragma omp parallel
+      {
+        #pragma omp single
+        SplitNode(maxLeafSize, splitter);
+      }
+      return;
+    }
+  #endif
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -903,11 +1520,15 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
+  // by calling their constructors (which perform this splitting process).  The
+  // left child of a large node is built by another thread, if one is free.
+  #pragma omp task shared(splitter) if (parallelBuild && \
+      count >= parallelBuildSize)
   left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
       maxLeafSize);
   right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
       splitter, maxLeafSize);
+  #pragma omp taskwait
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -935,6 +1556,22 @@ SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
           SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+  #ifdef HAS_OPENMP
+    // The children of large nodes are built in parallel, as OpenMP tasks.  The
+    // root opens the parallel region that runs them, unless we are already in
+    // one.
+    if (parallelBuild && parent == NULL && count >= parallelBuildSize &&
+        omp_get_max_threads() > 1 && omp_get_level() == 0)
+    {
+      #pragma omp parallel
+      {
+        #pragma omp single
+        SplitNode(oldFromNew, maxLeafSize, splitter);
+      }
+      return;
+    }
+  #endif
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -971,11 +1608,15 @@ SplitNode(std::vector<size_t>& oldFromNew,
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
+  // by calling their constructors (which perform this splitting process).  The
+  // left child of a large node is built by another thread, if one is free.
+  #pragma omp task shared(oldFromNew, splitter) if (parallelBuild && \
+      count >= parallelBuildSize)
   left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
       splitter, maxLeafSize);
   right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
       oldFromNew, splitter, maxLeafSize);
+  #pragma omp taskwait
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -1049,7 +1690,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    nodeBlock(NULL),
+    nodeBlockSize(0)
 {
   // Nothing to do.
 }
@@ -1070,10 +1713,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    FreeChildren();
     if (!parent)
       delete dataset;
 
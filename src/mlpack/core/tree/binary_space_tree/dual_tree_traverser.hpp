@@ -17,6 +17,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/tree/traversal_statistics.hpp>
+
 #include "binary_space_tree.hpp"
 
 namespace mlpack {
@@ -67,7 +69,21 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the statistics updated by the traversal (NULL if none).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics updated by the traversal (NULL if none).
+  TraversalStatistics*& Statistics() { return statistics; }
+
  private:
+  /**
+   * Finish the visit of a node combination, and if it is the outermost one,
+   * record the scores and prunes of the traversal in the statistics.
+   *
+   * @param initialScores Number of scores when the visit started.
+   * @param initialPrunes Number of prunes when the visit started.
+   */
+  void EndVisit(const size_t initialScores, const size_t initialPrunes);
+
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
 
@@ -86,6 +102,12 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! The statistics updated by the traversal, if any.
+  TraversalStatistics* statistics;
+
+  //! The current level of the recursion.
+  size_t level;
 };
 
 } // namespace tree
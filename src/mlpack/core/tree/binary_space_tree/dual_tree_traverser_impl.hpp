@@ -17,6 +17,8 @@
 // In case it hasn't been included yet.
 #include "dual_tree_traverser.hpp"
 
+#include <mlpack/core/tree/leaf_base_cases.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -33,7 +35,9 @@ DualTreeTraverser<RuleType>::DualTreeTraverser(RuleType& rule) :
     numPrunes(0),
     numVisited(0),
     numScores(0),
-    numBaseCases(0)
+    numBaseCases(0),
+    statistics(NULL),
+    level(0)
 { /* Nothing to do. */ }
 
 template<typename MetricType,
@@ -53,6 +57,14 @@ DualTreeTraverser<RuleType>::Traverse(
   // Increment the visit counter.
   ++numVisited;
 
+  // Record the visit.  The outermost call also records the scores and prunes
+  // of the whole traversal, in EndVisit().
+  const size_t initialScores = numScores;
+  const size_t initialPrunes = numPrunes;
+  if (statistics)
+    statistics->Visit(level);
+  ++level;
+
   // Store the current traversal info.
   traversalInfo = rule.TraversalInfo();
 
@@ -60,10 +72,14 @@ DualTreeTraverser<RuleType>::Traverse(
   if (queryNode.Parent() == NULL && referenceNode.Parent() == NULL)
   {
     const double rootScore = rule.Score(queryNode, referenceNode);
+    if (statistics)
+      statistics->Add(1, 0);
+
     // If root score is DBL_MAX, don't recurse.
     if (rootScore == DBL_MAX)
     {
       ++numPrunes;
+      EndVisit(initialScores, initialPrunes);
       return;
     }
   }
@@ -71,24 +87,16 @@ DualTreeTraverser<RuleType>::Traverse(
   // If both are leaves, we must evaluate the base case.
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
-    // Loop through each of the points in each node.
-    const size_t queryEnd = queryNode.Begin() + queryNode.Count();
-    const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-    for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
-    {
-      // See if we need to investigate this point (this function should be
-      // implemented for the single-tree recursion too).  Restore the traversal
-      // information first.
-      rule.TraversalInfo() = traversalInfo;
-      const double childScore = rule.Score(query, referenceNode);
-
-      if (childScore == DBL_MAX)
-        continue; // We can't improve this particular point.
+    // Evaluate the base cases of every query point that can't be pruned, as a
+    // single block if the rules support it.
+    const size_t leafBaseCases = LeafBaseCases(rule, queryNode, referenceNode,
+        traversalInfo);
+    numBaseCases += leafBaseCases;
 
-      for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-        rule.BaseCase(query, ref);
-
-      numBaseCases += referenceNode.Count();
+    if (statistics)
+    {
+      statistics->LeafCombination(queryNode.Count(), referenceNode.Count(),
+          leafBaseCases);
     }
   }
   else if (((!queryNode.IsLeaf()) && referenceNode.IsLeaf()) ||
@@ -350,6 +358,24 @@ DualTreeTraverser<RuleType>::Traverse(
       }
     }
   }
+
+  EndVisit(initialScores, initialPrunes);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+DualTreeTraverser<RuleType>::EndVisit(const size_t initialScores,
+                                      const size_t initialPrunes)
+{
+  --level;
+  if (statistics && level == 0)
+    statistics->Add(numScores - initialScores, numPrunes - initialPrunes);
 }
 
 } // namespace tree
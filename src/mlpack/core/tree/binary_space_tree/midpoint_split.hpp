@@ -17,6 +17,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/perform_split.hpp>
+#include <mlpack/core/tree/split_traits.hpp>
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -74,8 +75,8 @@ class MidpointSplit
                              const size_t count,
                              const SplitInfo& splitInfo)
   {
-    return split::PerformSplit<MatType, MidpointSplit>(data, begin, count,
-        splitInfo);
+    return split::ParallelPerformSplit<MatType, MidpointSplit>(data, begin,
+        count, splitInfo);
   }
 
   /**
@@ -99,8 +100,8 @@ class MidpointSplit
                              const SplitInfo& splitInfo,
                              std::vector<size_t>& oldFromNew)
   {
-    return split::PerformSplit<MatType, MidpointSplit>(data, begin, count,
-        splitInfo, oldFromNew);
+    return split::ParallelPerformSplit<MatType, MidpointSplit>(data, begin,
+        count, splitInfo, oldFromNew);
   }
 
   /**
@@ -117,6 +118,17 @@ class MidpointSplit
   }
 };
 
+/**
+ * The midpoint split only uses the points of the node being split, so nodes can
+ * be split in parallel.
+ */
+template<typename BoundType, typename MatType>
+struct SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+  static const bool IsThreadSafe = true;
+  static const bool SplitsAnyNode = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,132 @@
+/**
+ * @file core/tree/binary_space_tree/parallel_dual_tree_traverser.hpp
+ *
+ * Defines the ParallelDualTreeTraverser for the BinarySpaceTree tree type.
+ * This is a nested class of BinarySpaceTree which splits the query tree into
+ * disjoint subtrees and traverses each of them against the reference tree in
+ * parallel, using OpenMP, with a depth-first DualTreeTraverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "binary_space_tree.hpp"
+#include "dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A task-parallel dual-tree traverser for binary space trees.  The query tree
+ * is descended to the given task depth, and every query node at that depth (or
+ * every leaf above it) becomes an independent task that is traversed against
+ * the whole reference tree with the usual depth-first DualTreeTraverser.
+ *
+ * Each thread traverses its tasks with its own copy of the rules object, made
+ * with the copy constructor of RuleType after the root combination has been
+ * scored.  The results are never merged back: a copy must store the results
+ * of the query points in place, in the storage of the original rules, as
+ * NeighborSearchRules (whose copies share the candidate lists),
+ * RangeSearchRules, KDERules (whose densities are shared) and
+ * emst::ParallelDTBRules (whose copies share the candidate edge of each
+ * point) do.  Since the query subtrees of the tasks are disjoint, each thread
+ * only writes the results of its own query points, and the statistics of its
+ * own query nodes.  The number of base cases and scores of each copy is added
+ * to the original rules object, so RuleType must also provide modifiable
+ * BaseCases() and Scores() accessors.
+ *
+ * If mlpack is compiled without OpenMP, the tasks are simply run one after the
+ * other.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType>::ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser with the given rule set.  If
+   * taskDepth is 0, a depth is chosen such that each thread receives several
+   * tasks.
+   *
+   * @param rule Rules to use for the traversal.
+   * @param taskDepth Depth of the query tree at which tasks are created.
+   */
+  ParallelDualTreeTraverser(RuleType& rule, const size_t taskDepth = 0);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(BinarySpaceTree& queryNode, BinarySpaceTree& referenceNode);
+
+  //! Get the depth of the query tree at which tasks are created.
+  size_t TaskDepth() const { return taskDepth; }
+  //! Modify the depth of the query tree at which tasks are created.
+  size_t& TaskDepth() { return taskDepth; }
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  //! Collect the roots of the query subtrees that will become tasks.
+  void CollectTasks(BinarySpaceTree& queryNode,
+                    const size_t depth,
+                    std::vector<BinarySpaceTree*>& tasks) const;
+
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The depth of the query tree at which tasks are created.
+  size_t taskDepth;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
@@ -0,0 +1,180 @@
+/**
+ * @file core/tree/binary_space_tree/parallel_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelDualTreeTraverser for BinarySpaceTree.  The
+ * query tree is split into disjoint subtrees which are each traversed against
+ * the reference tree in parallel.  The trees must be the same type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::ParallelDualTreeTraverser(
+    RuleType& rule,
+    const size_t taskDepth) :
+    rule(rule),
+    taskDepth(taskDepth),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{
+  if (this->taskDepth == 0)
+  {
+    // Create roughly eight tasks per thread so that dynamic scheduling can
+    // balance unevenly-sized query subtrees.
+    #ifdef HAS_OPENMP
+      const size_t threads = omp_get_max_threads();
+    #else
+      const size_t threads = 1;
+    #endif
+
+    this->taskDepth = 3;
+    while ((size_t(1) << (this->taskDepth - 3)) < threads)
+      ++this->taskDepth;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::Traverse(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  std::vector<BinarySpaceTree*> tasks;
+  CollectTasks(queryNode, 0, tasks);
+
+  // If there is only one task, there is nothing to run in parallel.
+  if (tasks.size() == 1)
+  {
+    DualTreeTraverser<RuleType> traverser(rule);
+    traverser.Traverse(queryNode, referenceNode);
+
+    numPrunes += traverser.NumPrunes();
+    numVisited += traverser.NumVisited();
+    numScores += traverser.NumScores();
+    numBaseCases += traverser.NumBaseCases();
+    return;
+  }
+
+  ++numVisited;
+
+  // If both nodes are root nodes, score them before splitting the work, just
+  // like the serial traverser would.
+  if (queryNode.Parent() == NULL && referenceNode.Parent() == NULL)
+  {
+    const double rootScore = rule.Score(queryNode, referenceNode);
+    ++numScores;
+
+    // If root score is DBL_MAX, don't recurse.
+    if (rootScore == DBL_MAX)
+    {
+      ++numPrunes;
+      return;
+    }
+  }
+
+  // Every task starts from the same traversal information.
+  const typename RuleType::TraversalInfoType traversalInfo =
+      rule.TraversalInfo();
+
+  size_t prunes = 0, visited = 0, scores = 0, baseCases = 0;
+
+  #pragma omp parallel reduction(+:prunes, visited, scores, baseCases)
+  {
+    // Each thread works with its own copy of the rules, which stores its
+    // results in place; the query subtrees of the tasks are disjoint, so the
+    // copies never write the results of the same query points.
+    RuleType threadRule(rule);
+    threadRule.BaseCases() = 0;
+    threadRule.Scores() = 0;
+
+    DualTreeTraverser<RuleType> traverser(threadRule);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+    {
+      // The serial traversal would score each subtree against the reference
+      // node before descending into it.
+      threadRule.TraversalInfo() = traversalInfo;
+      ++scores;
+      if (threadRule.Score(*tasks[i], referenceNode) == DBL_MAX)
+      {
+        ++prunes;
+        continue;
+      }
+
+      traverser.Traverse(*tasks[i], referenceNode);
+    }
+
+    #pragma omp critical(ParallelDualTreeTraverserCounts)
+    {
+      rule.BaseCases() += threadRule.BaseCases();
+      rule.Scores() += threadRule.Scores();
+    }
+
+    prunes += traverser.NumPrunes();
+    visited += traverser.NumVisited();
+    scores += traverser.NumScores();
+    baseCases += traverser.NumBaseCases();
+  }
+
+  numPrunes += prunes;
+  numVisited += visited;
+  numScores += scores;
+  numBaseCases += baseCases;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::CollectTasks(
+    BinarySpaceTree& queryNode,
+    const size_t depth,
+    std::vector<BinarySpaceTree*>& tasks) const
+{
+  if (depth >= taskDepth || queryNode.IsLeaf())
+  {
+    tasks.push_back(&queryNode);
+    return;
+  }
+
+  CollectTasks(*queryNode.Left(), depth + 1, tasks);
+  CollectTasks(*queryNode.Right(), depth + 1, tasks);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
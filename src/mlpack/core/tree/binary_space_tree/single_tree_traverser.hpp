@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/tree/traversal_statistics.hpp>
+
 #include "binary_space_tree.hpp"
 
 namespace mlpack {
@@ -51,12 +53,31 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Modify the number of prunes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the statistics updated by the traversal (NULL if none).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics updated by the traversal (NULL if none).
+  TraversalStatistics*& Statistics() { return statistics; }
+
  private:
+  /**
+   * Finish the visit of a node, and if it is the outermost one, record the
+   * prunes of the traversal in the statistics.
+   *
+   * @param initialPrunes Number of prunes when the visit started.
+   */
+  void EndVisit(const size_t initialPrunes);
+
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! The statistics updated by the traversal, if any.
+  TraversalStatistics* statistics;
+
+  //! The current level of the recursion.
+  size_t level;
 };
 
 } // namespace tree
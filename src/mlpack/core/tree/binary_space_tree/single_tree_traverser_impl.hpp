@@ -32,7 +32,9 @@ template<typename RuleType>
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 SingleTreeTraverser<RuleType>::SingleTreeTraverser(RuleType& rule) :
     rule(rule),
-    numPrunes(0)
+    numPrunes(0),
+    statistics(NULL),
+    level(0)
 { /* Nothing to do. */ }
 
 template<typename MetricType,
@@ -48,12 +50,25 @@ SingleTreeTraverser<RuleType>::Traverse(
     BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
         referenceNode)
 {
+  // Record the visit.  The outermost call also records the prunes of the whole
+  // traversal, in EndVisit().
+  const size_t initialPrunes = numPrunes;
+  if (statistics)
+    statistics->Visit(level);
+  ++level;
+
   // If we are a leaf, run the base case as necessary.
   if (referenceNode.IsLeaf())
   {
     const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
     for (size_t i = referenceNode.Begin(); i < refEnd; ++i)
       rule.BaseCase(queryIndex, i);
+
+    if (statistics)
+    {
+      statistics->LeafCombination(1, referenceNode.Count(),
+          referenceNode.Count());
+    }
   }
   else
   {
@@ -61,10 +76,14 @@ SingleTreeTraverser<RuleType>::Traverse(
     if (referenceNode.Parent() == NULL)
     {
       const double rootScore = rule.Score(queryIndex, referenceNode);
+      if (statistics)
+        statistics->Add(1, 0);
+
       // If root score is DBL_MAX, don't recurse into that node.
       if (rootScore == DBL_MAX)
       {
         ++numPrunes;
+        EndVisit(initialPrunes);
         return;
       }
     }
@@ -72,6 +91,8 @@ SingleTreeTraverser<RuleType>::Traverse(
     // If either score is DBL_MAX, we do not recurse into that node.
     double leftScore = rule.Score(queryIndex, *referenceNode.Left());
     double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+    if (statistics)
+      statistics->Add(2, 0);
 
     if (leftScore < rightScore)
     {
@@ -121,6 +142,23 @@ SingleTreeTraverser<RuleType>::Traverse(
       }
     }
   }
+
+  EndVisit(initialPrunes);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SingleTreeTraverser<RuleType>::EndVisit(const size_t initialPrunes)
+{
+  --level;
+  if (statistics && level == 0)
+    statistics->Add(0, numPrunes - initialPrunes);
 }
 
 } // namespace tree
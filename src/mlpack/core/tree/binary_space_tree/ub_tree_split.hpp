@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "../address.hpp"
+#include "../split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -111,6 +112,18 @@ class UBTreeSplit
   }
 };
 
+/**
+ * The UB tree split computes the addresses of all the points when the root is
+ * split, and uses them for every other node, so nodes cannot be split on their
+ * own or in parallel.
+ */
+template<typename BoundType, typename MatType>
+struct SplitTraits<UBTreeSplit<BoundType, MatType>>
+{
+  static const bool IsThreadSafe = false;
+  static const bool SplitsAnyNode = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
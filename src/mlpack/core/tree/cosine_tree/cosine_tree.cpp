@@ -14,6 +14,10 @@
 
 #include <boost/math/distributions/normal.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -25,24 +29,19 @@ CosineTree::CosineTree(const arma::mat& dataset) :
     numColumns(dataset.n_cols),
     localDataset(false)
 {
-  // Initialize sizes of column indices and l2 norms.
-  indices.resize(numColumns);
-  l2NormsSquared.zeros(numColumns);
-
   // Set indices and calculate squared norms of the columns.
+  indices.resize(numColumns);
   for (size_t i = 0; i < numColumns; ++i)
-  {
     indices[i] = i;
-    double l2Norm = arma::norm(dataset.col(i), 2);
-    l2NormsSquared(i) = l2Norm * l2Norm;
-  }
+  l2NormsSquared = arma::sum(arma::square(dataset), 0).t();
 
   // Frobenius norm of columns in the node.
   frobNormSquared = arma::accu(l2NormsSquared);
 
-  // Calculate centroid of columns in the node.
-  CalculateCentroid();
+  // The root contains all the columns, so its centroid is the mean column.
+  centroid = arma::mean(dataset, 1);
 
+  CalculateDistribution();
   splitPointIndex = ColumnSampleLS();
 }
 
@@ -72,6 +71,7 @@ CosineTree::CosineTree(CosineTree& parentNode,
   // Calculate centroid of columns in the node.
   CalculateCentroid();
 
+  CalculateDistribution();
   splitPointIndex = ColumnSampleLS();
 }
 
@@ -163,6 +163,7 @@ CosineTree::CosineTree(const CosineTree& other) :
     right(NULL),
     indices(other.indices),
     l2NormsSquared(other.l2NormsSquared),
+    cDistribution(other.cDistribution),
     centroid(other.centroid),
     basisVector(other.basisVector),
     splitPointIndex(other.SplitPointIndex()),
@@ -229,6 +230,7 @@ CosineTree& CosineTree::operator=(const CosineTree& other)
   right = other.Right();
   indices = other.indices;
   l2NormsSquared = other.l2NormsSquared;
+  cDistribution = other.cDistribution;
   centroid = other.centroid;
   basisVector = other.basisVector;
   splitPointIndex = other.SplitPointIndex();
@@ -283,6 +285,7 @@ CosineTree::CosineTree(CosineTree&& other) :
     right(other.right),
     indices(std::move(other.indices)),
     l2NormsSquared(std::move(other.l2NormsSquared)),
+    cDistribution(std::move(other.cDistribution)),
     centroid(std::move(other.centroid)),
     basisVector(std::move(other.basisVector)),
     splitPointIndex(other.splitPointIndex),
@@ -329,6 +332,7 @@ CosineTree& CosineTree::operator=(CosineTree&& other)
   right = other.Right();
   indices = std::move(other.indices);
   l2NormsSquared = std::move(other.l2NormsSquared);
+  cDistribution = std::move(other.cDistribution);
   centroid = std::move(other.centroid);
   basisVector = std::move(other.basisVector);
   splitPointIndex = other.SplitPointIndex();
@@ -372,29 +376,13 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
 {
-  // Set new basis vector to centroid.
-  newBasisVector = centroid;
-
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.end(); ++i)
-  {
-    currentNode = *i;
-
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
-
-  // If additional basis vector is passed, take it into account.
-  if (addBasisVector)
-  {
-    double projection = arma::dot(*addBasisVector, centroid);
-    newBasisVector -= *addBasisVector * projection;
-  }
+  // For every vector in the current basis (and the additional basis vector,
+  // if it is passed), remove its projection from the centroid.  The basis
+  // vectors are gathered in a matrix so that all the projections are computed
+  // at once.
+  arma::mat queueBasis;
+  QueueBasis(treeQueue, queueBasis, addBasisVector);
+  newBasisVector = centroid - queueBasis * (queueBasis.t() * centroid);
 
   // Normalize the modified centroid vector.
   if (arma::norm(newBasisVector, 2))
@@ -417,53 +405,26 @@ double CosineTree::MonteCarloError(CosineTree* node,
   // Get pointer to the original dataset.
   const arma::mat& dataset = node->GetDataset();
 
-  // Initialize weighted projection magnitudes as zeros.
+  // Weighted projection magnitudes of the samples.
   arma::vec weightedMagnitudes;
-  weightedMagnitudes.zeros(numSamples);
 
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
+  // Gather the current basis, with the two additional vectors if they are
+  // both passed, and the sampled columns, so that the projections of all the
+  // samples onto the existing subspace are computed with a single product.
+  arma::mat queueBasis;
   if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
+    QueueBasis(treeQueue, queueBasis, addBasisVector1, addBasisVector2);
   else
-    projectionSize = treeQueue.size();
-
-  // For each sample, calculate the weighted projection onto the current basis.
-  for (size_t i = 0; i < numSamples; ++i)
-  {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); ++j, ++k)
-    {
-      currentNode = *j;
+    QueueBasis(treeQueue, queueBasis);
 
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
-    {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
-    }
+  const arma::mat samples = dataset.cols(
+      arma::conv_to<arma::uvec>::from(sampledIndices));
+  const arma::mat projections = queueBasis.t() * samples;
 
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
-
-    // Calculate the weighted projection magnitude.
-    weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
-  }
+  // Calculate the weighted projection magnitudes (the squared norms of the
+  // projections).
+  weightedMagnitudes = arma::sum(arma::square(projections), 0).t() /
+      probabilities;
 
   // Compute mean and standard deviation of the weighted samples.
   double mu = arma::mean(weightedMagnitudes);
@@ -488,20 +449,28 @@ double CosineTree::MonteCarloError(CosineTree* node,
 
 void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
 {
-  // Initialize basis as matrix of zeros.
-  basis.zeros(dataset->n_rows, treeQueue.size());
+  // Transfer basis vectors from the queue to the basis matrix.
+  QueueBasis(treeQueue, basis);
+}
 
-  // Variables for iterating through the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
+void CosineTree::QueueBasis(const CosineNodeQueue& treeQueue,
+                            arma::mat& queueBasis,
+                            const arma::vec* addBasisVector1,
+                            const arma::vec* addBasisVector2) const
+{
+  const size_t numExtra = (addBasisVector1 ? 1 : 0) +
+      (addBasisVector2 ? 1 : 0);
+  queueBasis.set_size(dataset->n_rows, treeQueue.size() + numExtra);
 
-  // Transfer basis vectors from the queue to the basis matrix.
   size_t j = 0;
+  CosineNodeQueue::const_iterator i = treeQueue.begin();
   for ( ; i != treeQueue.end(); ++i, ++j)
-  {
-    currentNode = *i;
-    basis.col(j) = currentNode->BasisVector();
-  }
+    queueBasis.col(j) = (*i)->BasisVector();
+
+  if (addBasisVector1)
+    queueBasis.col(j++) = *addBasisVector1;
+  if (addBasisVector2)
+    queueBasis.col(j) = *addBasisVector2;
 }
 
 void CosineTree::CosineNodeSplit()
@@ -545,17 +514,6 @@ void CosineTree::ColumnSamplesLS(std::vector<size_t>& sampledIndices,
                                  arma::vec& probabilities,
                                  size_t numSamples)
 {
-  // Initialize the cumulative distribution vector size.
-  arma::vec cDistribution;
-  cDistribution.zeros(numColumns + 1);
-
-  // Calculate cumulative length-squared distribution for the node.
-  for (size_t i = 0; i < numColumns; ++i)
-  {
-    cDistribution(i + 1) = cDistribution(i) +
-        (l2NormsSquared(i) / frobNormSquared);
-  }
-
   // Initialize sizes of the 'sampledIndices' and 'probabilities' vectors.
   sampledIndices.resize(numSamples);
   probabilities.zeros(numSamples);
@@ -581,17 +539,6 @@ size_t CosineTree::ColumnSampleLS()
     return 0;
   }
 
-  // Initialize the cumulative distribution vector size.
-  arma::vec cDistribution;
-  cDistribution.zeros(numColumns + 1);
-
-  // Calculate cumulative length-squared distribution for the node.
-  for (size_t i = 0; i < numColumns; ++i)
-  {
-    cDistribution(i + 1) = cDistribution(i) +
-        (l2NormsSquared(i) / frobNormSquared);
-  }
-
   // Generate a random value for sampling.
   double randValue = arma::randu();
   size_t start = 0, end = numColumns;
@@ -600,6 +547,18 @@ size_t CosineTree::ColumnSampleLS()
   return BinarySearch(cDistribution, randValue, start, end);
 }
 
+void CosineTree::CalculateDistribution()
+{
+  // The cumulative length-squared distribution is computed once, since the
+  // error of the root is estimated with new samples after every split.
+  cDistribution.zeros(numColumns + 1);
+  for (size_t i = 0; i < numColumns; ++i)
+  {
+    cDistribution(i + 1) = cDistribution(i) +
+        (l2NormsSquared(i) / frobNormSquared);
+  }
+}
+
 size_t CosineTree::BinarySearch(arma::vec& cDistribution,
                                 double value,
                                 size_t start,
@@ -633,33 +592,61 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; ++i)
+  // If the norm of the split point is zero, all the cosines are zero.
+  if (l2NormsSquared(splitPointIndex) == 0)
+    return;
+
+  // The norms of the columns are known, so each cosine only takes a dot
+  // product.
+  const arma::vec splitPoint = dataset->col(indices[splitPointIndex]) /
+      std::sqrt(l2NormsSquared(splitPointIndex));
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; ++i)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
-    {
-      cosines(i) = 0;
-    }
-    else
+    if (l2NormsSquared(i) != 0)
     {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset->col(indices[splitPointIndex]),
-                                  dataset->col(indices[i])));
+      cosines(i) = std::abs(arma::dot(splitPoint, dataset->col(indices[i]))) /
+          std::sqrt(l2NormsSquared(i));
     }
   }
+
+  // The cosine of the split point with itself is exactly 1, so that it is not
+  // taken as the maximum cosine.
+  cosines(splitPointIndex) = 1.0;
 }
 
 void CosineTree::CalculateCentroid()
 {
-  // Initialize centroid as vector of zeros.
-  centroid.zeros(dataset->n_rows);
-
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; ++i)
+  // Split the columns into one block per thread; the sums of the blocks are
+  // computed in parallel, and then added in order, so the result does not
+  // depend on the scheduling.
+  #ifdef HAS_OPENMP
+  const size_t numBlocks = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), numColumns / MinChunkSize));
+  #else
+  const size_t numBlocks = 1;
+  #endif
+
+  std::vector<arma::vec> blockSums(numBlocks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    centroid += dataset->col(indices[i]);
+    const size_t begin = ((size_t) b * numColumns) / numBlocks;
+    const size_t end = (((size_t) b + 1) * numColumns) / numBlocks;
+
+    blockSums[b].zeros(dataset->n_rows);
+    for (size_t i = begin; i < end; ++i)
+      blockSums[b] += dataset->col(indices[i]);
   }
+
+  // Calculate centroid of columns in the node.
+  centroid.zeros(dataset->n_rows);
+  for (size_t b = 0; b < numBlocks; ++b)
+    centroid += blockSums[b];
   centroid /= numColumns;
 }
 
@@ -149,8 +149,8 @@ class CosineTree
 
   /**
    * Sample 'numSamples' points from the Length-Squared distribution of the
-   * cosine node. The function uses 'l2NormsSquared' to calculate the cumulative
-   * probability distribution of the column vectors. The sampling is based on a
+   * cosine node. The function uses the cumulative probability distribution of
+   * the column vectors computed by the constructor. The sampling is based on a
    * randomly generated values in the range [0, 1].
    */
   void ColumnSamplesLS(std::vector<size_t>& sampledIndices,
@@ -158,9 +158,9 @@ class CosineTree
 
   /**
    * Sample a point from the Length-Squared distribution of the cosine node. The
-   * function uses 'l2NormsSquared' to calculate the cumulative probability
-   * distribution of the column vectors. The sampling is based on a randomly
-   * generated value in the range [0, 1].
+   * function uses the cumulative probability distribution of the column vectors
+   * computed by the constructor. The sampling is based on a randomly generated
+   * value in the range [0, 1].
    */
   size_t ColumnSampleLS();
 
@@ -191,6 +191,7 @@ class CosineTree
   /**
    * Calculate centroid of the columns present in the node. The calculated
    * centroid is used as a basis vector for the cosine tree being constructed.
+   * The columns are summed in parallel, if OpenMP is available.
    */
   void CalculateCentroid();
 
@@ -258,6 +259,8 @@ class CosineTree
   std::vector<size_t> indices;
   //! L2-norm squared of columns in the node.
   arma::vec l2NormsSquared;
+  //! Cumulative Length-Squared distribution of columns in the node.
+  arma::vec cDistribution;
   //! Centroid of columns of input matrix in the node.
   arma::vec centroid;
   //! Orthonormalized basis vector of the node.
@@ -272,6 +275,30 @@ class CosineTree
   double frobNormSquared;
   //! If true, we own the dataset and need to destroy it in the destructor.
   bool localDataset;
+
+  //! The minimum number of columns summed by each thread in
+  //! CalculateCentroid().
+  static const size_t MinChunkSize = 1024;
+
+  /**
+   * Calculate the cumulative Length-Squared distribution of the columns in the
+   * node from 'l2NormsSquared'.
+   */
+  void CalculateDistribution();
+
+  /**
+   * Gather the basis vectors of the nodes in the queue, followed by the given
+   * additional basis vectors (if any), as the columns of a matrix.
+   *
+   * @param treeQueue Priority queue of cosine nodes.
+   * @param queueBasis Matrix to store the basis vectors in.
+   * @param addBasisVector1 Address to first additional basis vector.
+   * @param addBasisVector2 Address to second additional basis vector.
+   */
+  void QueueBasis(const CosineNodeQueue& treeQueue,
+                  arma::mat& queueBasis,
+                  const arma::vec* addBasisVector1 = NULL,
+                  const arma::vec* addBasisVector2 = NULL) const;
 };
 
 class CompareCosineNode
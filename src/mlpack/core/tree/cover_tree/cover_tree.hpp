@@ -18,6 +18,8 @@
 #include "../statistic.hpp"
 #include "first_point_is_root.hpp"
 
+#include <deque>
+
 namespace mlpack {
 namespace tree {
 
@@ -104,6 +106,9 @@ class CoverTree
   //! The type held by the matrix type.
   typedef typename MatType::elem_type ElemType;
 
+  //! Count the memory of the nodes, if memory tracking is enabled.
+  MLPACK_TRACK_ALLOCATIONS
+
   /**
    * Create the cover tree with the given dataset and given base.
    * The dataset will not be modified during the building procedure (unlike
@@ -462,13 +467,53 @@ class CoverTree
   MetricType* metric;
 
   /**
-   * Create the children for this node.
+   * Buffers that are reused while the tree is built, so that building a node
+   * does not allocate memory once the buffers have grown large enough.
+   */
+  struct BuildBuffers
+  {
+    //! The point sets of the children being built, for each level of the
+    //! recursion (a deque, so that adding levels keeps the others in place).
+    std::deque<arma::Col<size_t>> indices;
+    //! The distances of the point sets, for each level of the recursion.
+    std::deque<arma::vec> distances;
+    //! For each point of the dataset, whether it was used by the last child.
+    std::vector<bool> used;
+  };
+
+  /**
+   * Construct a child cover tree node, as with the public constructor, using
+   * the given buffers for the point sets of its children.
+   *
+   * @param buffers Buffers to use for the point sets of the children.
+   * @param depth Depth of this node in the recursion.
+   */
+  CoverTree(const MatType& dataset,
+            const ElemType base,
+            const size_t pointIndex,
+            const int scale,
+            CoverTree* parent,
+            const ElemType parentDistance,
+            arma::Col<size_t>& indices,
+            arma::vec& distances,
+            size_t nearSetSize,
+            size_t& farSetSize,
+            size_t& usedSetSize,
+            MetricType& metric,
+            BuildBuffers& buffers,
+            const size_t depth);
+
+  /**
+   * Create the children for this node.  The point sets of the children are
+   * stored in the buffers of the given depth of the recursion.
    */
   void CreateChildren(arma::Col<size_t>& indices,
                       arma::vec& distances,
                       size_t nearSetSize,
                       size_t& farSetSize,
-                      size_t& usedSetSize);
+                      size_t& usedSetSize,
+                      BuildBuffers& buffers,
+                      const size_t depth);
 
   /**
    * Fill the vector of distances with the distances between the point specified
@@ -529,6 +574,15 @@ class CoverTree
                       const size_t childUsedSetSize,
                       const size_t farSetSize);
 
+  /**
+   * Move the points used by a child (the childUsedSetSize points after the
+   * childFarSetSize first points of childIndices) from the near and far sets
+   * to the used set.
+   *
+   * @param used Flags of the points of the dataset, all false, used to find
+   *     the points of the child in a single pass (they are all false again
+   *     afterwards).
+   */
   void MoveToUsedSet(arma::Col<size_t>& indices,
                      arma::vec& distances,
                      size_t& nearSetSize,
@@ -536,7 +590,8 @@ class CoverTree
                      size_t& usedSetSize,
                      arma::Col<size_t>& childIndices,
                      const size_t childFarSetSize,
-                     const size_t childUsedSetSize);
+                     const size_t childUsedSetSize,
+                     std::vector<bool>& used);
   size_t PruneFarSet(arma::Col<size_t>& indices,
                      arma::vec& distances,
                      const ElemType bound,
@@ -15,6 +15,7 @@
 // In case it hasn't already been included.
 #include "cover_tree.hpp"
 
+#include <algorithm>
 #include <queue>
 #include <string>
 
@@ -85,8 +86,9 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   // Create the children.
   size_t farSetSize = 0;
   size_t usedSetSize = 0;
+  BuildBuffers buffers;
   CreateChildren(indices, distances, dataset.n_cols - 1, farSetSize,
-      usedSetSize);
+      usedSetSize, buffers, 0);
 
   // If we ended up creating only one child, remove the implicit node.
   while (children.size() == 1)
@@ -180,8 +182,9 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   // Create the children.
   size_t farSetSize = 0;
   size_t usedSetSize = 0;
+  BuildBuffers buffers;
   CreateChildren(indices, distances, dataset.n_cols - 1, farSetSize,
-      usedSetSize);
+      usedSetSize, buffers, 0);
 
   // If we ended up creating only one child, remove the implicit node.
   while (children.size() == 1)
@@ -276,8 +279,9 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   // Create the children.
   size_t farSetSize = 0;
   size_t usedSetSize = 0;
+  BuildBuffers buffers;
   CreateChildren(indices, distances, dataset->n_cols - 1, farSetSize,
-      usedSetSize);
+      usedSetSize, buffers, 0);
 
   // If we ended up creating only one child, remove the implicit node.
   while (children.size() == 1)
@@ -371,8 +375,9 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   // Create the children.
   size_t farSetSize = 0;
   size_t usedSetSize = 0;
+  BuildBuffers buffers;
   CreateChildren(indices, distances, dataset->n_cols - 1, farSetSize,
-      usedSetSize);
+      usedSetSize, buffers, 0);
 
   // If we ended up creating only one child, remove the implicit node.
   while (children.size() == 1)
@@ -460,7 +465,57 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   }
 
   // Otherwise, create the children.
-  CreateChildren(indices, distances, nearSetSize, farSetSize, usedSetSize);
+  BuildBuffers buffers;
+  CreateChildren(indices, distances, nearSetSize, farSetSize, usedSetSize,
+      buffers, 0);
+}
+
+// Construct a child node during the construction of the tree.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
+    const MatType& dataset,
+    const ElemType base,
+    const size_t pointIndex,
+    const int scale,
+    CoverTree* parent,
+    const ElemType parentDistance,
+    arma::Col<size_t>& indices,
+    arma::vec& distances,
+    size_t nearSetSize,
+    size_t& farSetSize,
+    size_t& usedSetSize,
+    MetricType& metric,
+    BuildBuffers& buffers,
+    const size_t depth) :
+    dataset(&dataset),
+    point(pointIndex),
+    scale(scale),
+    base(base),
+    numDescendants(0),
+    parent(parent),
+    parentDistance(parentDistance),
+    furthestDescendantDistance(0),
+    localMetric(false),
+    localDataset(false),
+    metric(&metric),
+    distanceComps(0)
+{
+  // If the size of the near set is 0, this is a leaf.
+  if (nearSetSize == 0)
+  {
+    this->scale = INT_MIN;
+    numDescendants = 1;
+    return;
+  }
+
+  // Otherwise, create the children.
+  CreateChildren(indices, distances, nearSetSize, farSetSize, usedSetSize,
+      buffers, depth);
 }
 
 // Manually create a cover tree node.
@@ -1138,7 +1193,9 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
     arma::vec& distances,
     size_t nearSetSize,
     size_t& farSetSize,
-    size_t& usedSetSize)
+    size_t& usedSetSize,
+    BuildBuffers& buffers,
+    const size_t depth)
 {
   // Determine the next scale level.  This should be the first level where there
   // are any points in the far set.  So, if we know the maximum distance in the
@@ -1156,7 +1213,8 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
     // This should not modify farSetSize or usedSetSize.
     size_t tempSize = 0;
     children.push_back(new CoverTree(*dataset, base, point, INT_MIN, this, 0,
-        indices, distances, 0, tempSize, usedSetSize, *metric));
+        indices, distances, 0, tempSize, usedSetSize, *metric, buffers,
+        depth + 1));
     distanceComps += children.back()->DistanceComps();
 
     // Every point in the near set should be a leaf.
@@ -1165,7 +1223,7 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
       // farSetSize and usedSetSize will not be modified.
       children.push_back(new CoverTree(*dataset, base, indices[i],
           INT_MIN, this, distances[i], indices, distances, 0, tempSize,
-          usedSetSize, *metric));
+          usedSetSize, *metric, buffers, depth + 1));
       distanceComps += children.back()->DistanceComps();
       usedSetSize++;
     }
@@ -1197,7 +1255,7 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
   size_t childUsedSetSize = 0;
   children.push_back(new CoverTree(*dataset, base, point, nextScale, this, 0,
       indices, distances, childNearSetSize, childFarSetSize, childUsedSetSize,
-      *metric));
+      *metric, buffers, depth + 1));
   // Don't double-count the self-child (so, subtract one).
   numDescendants += children[0]->NumDescendants();
 
@@ -1255,7 +1313,7 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
       size_t childNearSetSize = 0;
       children.push_back(new CoverTree(*dataset, base, indices[0], nextScale,
           this, distances[0], indices, distances, childNearSetSize, farSetSize,
-          usedSetSize, *metric));
+          usedSetSize, *metric, buffers, depth + 1));
       distanceComps += children.back()->DistanceComps();
       numDescendants += children.back()->NumDescendants();
 
@@ -1268,12 +1326,24 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
       break;
     }
 
-    // Create the near and far set indices and distance vectors.  We don't fill
-    // in the self-point, yet.
-    arma::Col<size_t> childIndices(nearSetSize + farSetSize);
+    // Create the near and far set indices and distance vectors.  They are
+    // kept in the buffers of this level of the recursion: the children of this
+    // node are built one after the other, and their own children use the
+    // buffers of the next levels.  We don't fill in the self-point, yet.
+    if (buffers.indices.size() <= depth)
+    {
+      buffers.indices.resize(depth + 1);
+      buffers.distances.resize(depth + 1);
+    }
+    arma::Col<size_t>& childIndices = buffers.indices[depth];
+    arma::vec& childDistances = buffers.distances[depth];
+    if (childIndices.n_elem < nearSetSize + farSetSize)
+    {
+      childIndices.set_size(nearSetSize + farSetSize);
+      childDistances.set_size(nearSetSize + farSetSize);
+    }
     childIndices.rows(0, (nearSetSize + farSetSize - 2)) = indices.rows(1,
         nearSetSize + farSetSize - 1);
-    arma::vec childDistances(nearSetSize + farSetSize);
 
     // Build distances for the child.
     ComputeDistances(indices[0], childIndices, childDistances, nearSetSize
@@ -1297,7 +1367,7 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
     childUsedSetSize = 1; // Mark self point as used.
     children.push_back(new CoverTree(*dataset, base, indices[0], nextScale,
         this, distances[0], childIndices, childDistances, childNearSetSize,
-        childFarSetSize, childUsedSetSize, *metric));
+        childFarSetSize, childUsedSetSize, *metric, buffers, depth + 1));
     numDescendants += children.back()->NumDescendants();
 
     // Remove any implicit nodes.
@@ -1311,7 +1381,7 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
     // For each point in the childUsed set, we must move that point to the used
     // set in our own vector.
     MoveToUsedSet(indices, distances, nearSetSize, farSetSize, usedSetSize,
-        childIndices, childFarSetSize, childUsedSetSize);
+        childIndices, childFarSetSize, childUsedSetSize, buffers.used);
   }
 
   // Calculate furthest descendant.
@@ -1392,8 +1462,32 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                      const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  The children of a node have to be built one after the other
+  // (each child takes points away from the ones that follow it), but the
+  // distance computations near the root are over most of the dataset, so
+  // large point sets are handled in parallel.
   distanceComps += pointSetSize;
+  #ifdef HAS_OPENMP
+    if (pointSetSize >= 10000 && omp_get_max_threads() > 1)
+    {
+      // Evaluate() may modify the metric (for instance the kernel of an
+      // IPMetric), so each thread uses its own copy.
+      #pragma omp parallel
+      {
+        MetricType threadMetric(*metric);
+
+        #pragma omp for
+        for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
+        {
+          distances[i] = threadMetric.Evaluate(dataset->col(pointIndex),
+              dataset->col(indices[i]));
+        }
+      }
+
+      return;
+    }
+  #endif
+
   for (size_t i = 0; i < pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
@@ -1414,53 +1508,19 @@ size_t CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                  const size_t childUsedSetSize,
                  const size_t farSetSize)
 {
-  // We'll use low-level memcpy calls ourselves, just to ensure it's done
-  // quickly and the way we want it to be.  Unfortunately this takes up more
-  // memory than one-element swaps, but there's not a great way around that.
-  const size_t bufferSize = std::min(farSetSize, childUsedSetSize);
-  const size_t bigCopySize = std::max(farSetSize, childUsedSetSize);
-
-  // Sanity check: there is no need to sort if the buffer size is going to be
-  // zero.
-  if (bufferSize == 0)
-    return (childFarSetSize + farSetSize);
-
-  size_t* indicesBuffer = new size_t[bufferSize];
-  ElemType* distancesBuffer = new ElemType[bufferSize];
-
-  // The start of the memory region to copy to the buffer.
-  const size_t bufferFromLocation = ((bufferSize == farSetSize) ?
-      (childFarSetSize + childUsedSetSize) : childFarSetSize);
-  // The start of the memory region to move directly to the new place.
-  const size_t directFromLocation = ((bufferSize == farSetSize) ?
-      childFarSetSize : (childFarSetSize + childUsedSetSize));
-  // The destination to copy the buffer back to.
-  const size_t bufferToLocation = ((bufferSize == farSetSize) ?
-      childFarSetSize : (childFarSetSize + farSetSize));
-  // The destination of the directly moved memory region.
-  const size_t directToLocation = ((bufferSize == farSetSize) ?
-      (childFarSetSize + farSetSize) : childFarSetSize);
-
-  // Copy the smaller piece to the buffer.
-  memcpy(indicesBuffer, indices.memptr() + bufferFromLocation,
-      sizeof(size_t) * bufferSize);
-  memcpy(distancesBuffer, distances.memptr() + bufferFromLocation,
-      sizeof(ElemType) * bufferSize);
-
-  // Now move the other memory.
-  memmove(indices.memptr() + directToLocation,
-      indices.memptr() + directFromLocation, sizeof(size_t) * bigCopySize);
-  memmove(distances.memptr() + directToLocation,
-      distances.memptr() + directFromLocation, sizeof(ElemType) * bigCopySize);
-
-  // Now copy the temporary memory to the right place.
-  memcpy(indices.memptr() + bufferToLocation, indicesBuffer,
-      sizeof(size_t) * bufferSize);
-  memcpy(distances.memptr() + bufferToLocation, distancesBuffer,
-      sizeof(ElemType) * bufferSize);
-
-  delete[] indicesBuffer;
-  delete[] distancesBuffer;
+  // The childUsedSet and farSet regions are swapped with a rotation, in place,
+  // so that no buffer has to be allocated.  There is nothing to do if either
+  // of them is empty.
+  if (childUsedSetSize > 0 && farSetSize > 0)
+  {
+    const size_t begin = childFarSetSize;
+    const size_t middle = childFarSetSize + childUsedSetSize;
+    const size_t end = middle + farSetSize;
+    std::rotate(indices.memptr() + begin, indices.memptr() + middle,
+        indices.memptr() + end);
+    std::rotate(distances.memptr() + begin, distances.memptr() + middle,
+        distances.memptr() + end);
+  }
 
   // This returns the complete size of the far set.
   return (childFarSetSize + farSetSize);
@@ -1480,92 +1540,85 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                   size_t& usedSetSize,
                   arma::Col<size_t>& childIndices,
                   const size_t childFarSetSize, // childNearSetSize is 0 here.
-                  const size_t childUsedSetSize)
+                  const size_t childUsedSetSize,
+                  std::vector<bool>& used)
 {
   const size_t originalSum = nearSetSize + farSetSize + usedSetSize;
 
+  // Mark the points used by the child, so that each point of the near and far
+  // sets is checked in constant time.
+  if (used.size() < dataset->n_cols)
+    used.resize(dataset->n_cols, false);
+  for (size_t j = 0; j < childUsedSetSize; ++j)
+    used[childIndices[childFarSetSize + j]] = true;
+
   // Loop across the set.  We will swap points as we need.  It should be noted
   // that farSetSize and nearSetSize may change with each iteration of this loop
   // (depending on if we make a swap or not).
-  size_t startChildUsedSet = 0; // Where to start in the child set.
   for (size_t i = 0; i < nearSetSize; ++i)
   {
     // Discover if this point was in the child's used set.
-    for (size_t j = startChildUsedSet; j < childUsedSetSize; ++j)
+    if (!used[indices[i]])
+      continue;
+
+    // We have found a point; a swap is necessary.
+    used[indices[i]] = false;
+
+    // Since this point is from the near set, to preserve the near set, we must
+    // do a swap.
+    if (farSetSize > 0)
     {
-      if (childIndices[childFarSetSize + j] == indices[i])
+      if ((nearSetSize - 1) != i)
       {
-        // We have found a point; a swap is necessary.
+        // In this case it must be a three-way swap.
+        size_t tempIndex = indices[nearSetSize + farSetSize - 1];
+        ElemType tempDist = distances[nearSetSize + farSetSize - 1];
 
-        // Since this point is from the near set, to preserve the near set, we
-        // must do a swap.
-        if (farSetSize > 0)
-        {
-          if ((nearSetSize - 1) != i)
-          {
-            // In this case it must be a three-way swap.
-            size_t tempIndex = indices[nearSetSize + farSetSize - 1];
-            ElemType tempDist = distances[nearSetSize + farSetSize - 1];
-
-            size_t tempNearIndex = indices[nearSetSize - 1];
-            ElemType tempNearDist = distances[nearSetSize - 1];
-
-            indices[nearSetSize + farSetSize - 1] = indices[i];
-            distances[nearSetSize + farSetSize - 1] = distances[i];
-
-            indices[nearSetSize - 1] = tempIndex;
-            distances[nearSetSize - 1] = tempDist;
-
-            indices[i] = tempNearIndex;
-            distances[i] = tempNearDist;
-          }
-          else
-          {
-            // We can do a two-way swap.
-            size_t tempIndex = indices[nearSetSize + farSetSize - 1];
-            ElemType tempDist = distances[nearSetSize + farSetSize - 1];
-
-            indices[nearSetSize + farSetSize - 1] = indices[i];
-            distances[nearSetSize + farSetSize - 1] = distances[i];
-
-            indices[i] = tempIndex;
-            distances[i] = tempDist;
-          }
-        }
-        else if ((nearSetSize - 1) != i)
-        {
-          // A two-way swap is possible.
-          size_t tempIndex = indices[nearSetSize + farSetSize - 1];
-          ElemType tempDist = distances[nearSetSize + farSetSize - 1];
+        size_t tempNearIndex = indices[nearSetSize - 1];
+        ElemType tempNearDist = distances[nearSetSize - 1];
 
-          indices[nearSetSize + farSetSize - 1] = indices[i];
-          distances[nearSetSize + farSetSize - 1] = distances[i];
+        indices[nearSetSize + farSetSize - 1] = indices[i];
+        distances[nearSetSize + farSetSize - 1] = distances[i];
 
-          indices[i] = tempIndex;
-          distances[i] = tempDist;
-        }
-        else
-        {
-          // No swap is necessary.
-        }
+        indices[nearSetSize - 1] = tempIndex;
+        distances[nearSetSize - 1] = tempDist;
 
-        // We don't need to do a complete preservation of the child index set,
-        // but we want to make sure we only loop over points we haven't seen.
-        // So increment the child counter by 1 and move a point if we need.
-        if (j != startChildUsedSet)
-        {
-          childIndices[childFarSetSize + j] = childIndices[childFarSetSize +
-              startChildUsedSet];
-        }
+        indices[i] = tempNearIndex;
+        distances[i] = tempNearDist;
+      }
+      else
+      {
+        // We can do a two-way swap.
+        size_t tempIndex = indices[nearSetSize + farSetSize - 1];
+        ElemType tempDist = distances[nearSetSize + farSetSize - 1];
 
-        // Update all counters from the swaps we have done.
-        ++startChildUsedSet;
-        --nearSetSize;
-        --i; // Since we moved a point out of the near set we must step back.
+        indices[nearSetSize + farSetSize - 1] = indices[i];
+        distances[nearSetSize + farSetSize - 1] = distances[i];
 
-        break; // Break out of this for loop; back to the first one.
+        indices[i] = tempIndex;
+        distances[i] = tempDist;
       }
     }
+    else if ((nearSetSize - 1) != i)
+    {
+      // A two-way swap is possible.
+      size_t tempIndex = indices[nearSetSize + farSetSize - 1];
+      ElemType tempDist = distances[nearSetSize + farSetSize - 1];
+
+      indices[nearSetSize + farSetSize - 1] = indices[i];
+      distances[nearSetSize + farSetSize - 1] = distances[i];
+
+      indices[i] = tempIndex;
+      distances[i] = tempDist;
+    }
+    else
+    {
+      // No swap is necessary.
+    }
+
+    // Update all counters from the swaps we have done.
+    --nearSetSize;
+    --i; // Since we moved a point out of the near set we must step back.
   }
 
   // Now loop over the far set.  This loop is different because we only require
@@ -1574,36 +1627,25 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   for (size_t i = 0; i < farSetSize; ++i)
   {
     // Discover if this point was in the child's used set.
-    for (size_t j = startChildUsedSet; j < childUsedSetSize; ++j)
-    {
-      if (childIndices[childFarSetSize + j] == indices[i + nearSetSize])
-      {
-        // We have found a point to swap.
+    if (!used[indices[i + nearSetSize]])
+      continue;
 
-        // Perform the swap.
-        size_t tempIndex = indices[nearSetSize + farSetSize - 1];
-        ElemType tempDist = distances[nearSetSize + farSetSize - 1];
+    // We have found a point to swap.
+    used[indices[i + nearSetSize]] = false;
 
-        indices[nearSetSize + farSetSize - 1] = indices[nearSetSize + i];
-        distances[nearSetSize + farSetSize - 1] = distances[nearSetSize + i];
+    // Perform the swap.
+    size_t tempIndex = indices[nearSetSize + farSetSize - 1];
+    ElemType tempDist = distances[nearSetSize + farSetSize - 1];
 
-        indices[nearSetSize + i] = tempIndex;
-        distances[nearSetSize + i] = tempDist;
+    indices[nearSetSize + farSetSize - 1] = indices[nearSetSize + i];
+    distances[nearSetSize + farSetSize - 1] = distances[nearSetSize + i];
 
-        if (j != startChildUsedSet)
-        {
-          childIndices[childFarSetSize + j] = childIndices[childFarSetSize +
-              startChildUsedSet];
-        }
-
-        // Update all counters from the swaps we have done.
-        ++startChildUsedSet;
-        --farSetSize;
-        --i;
+    indices[nearSetSize + i] = tempIndex;
+    distances[nearSetSize + i] = tempDist;
 
-        break; // Break out of this for loop; back to the first one.
-      }
-    }
+    // Update all counters from the swaps we have done.
+    --farSetSize;
+    --i;
   }
 
   // Update used set size.
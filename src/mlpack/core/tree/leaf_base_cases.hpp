@@ -0,0 +1,112 @@
+/**
+ * @file core/tree/leaf_base_cases.hpp
+ *
+ * Evaluation of all the base cases between a query leaf and a reference leaf,
+ * either one pair at a time or, if the rules support it, as one block.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_LEAF_BASE_CASES_HPP
+#define MLPACK_CORE_TREE_LEAF_BASE_CASES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_ANY_METHOD_FORM(BaseCaseBlock, HasBaseCaseBlock);
+
+/**
+ * Evaluate the base cases between the points of the given query leaf and the
+ * points of the given reference leaf, for trees whose nodes hold a contiguous
+ * range [Begin(), Begin() + Count()) of points.  Each query point is first
+ * scored against the reference node (after the given traversal information is
+ * restored), and the points that are not pruned are then passed to the rules
+ * in one call to
+ *
+ * @code
+ * void BaseCaseBlock(const std::vector<size_t>& queryIndices,
+ *                    const size_t referenceBegin,
+ *                    const size_t referenceEnd);
+ * @endcode
+ *
+ * so that the rules can compute all the distances of the block at once.  Rules
+ * without a BaseCaseBlock() method are handled by the overload below.
+ *
+ * @return The number of base cases that were evaluated.
+ */
+template<typename RuleType, typename TreeType>
+size_t LeafBaseCases(
+    RuleType& rule,
+    TreeType& queryNode,
+    TreeType& referenceNode,
+    const typename RuleType::TraversalInfoType& traversalInfo,
+    const typename std::enable_if_t<HasBaseCaseBlock<RuleType>::value>* = 0)
+{
+  const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+  std::vector<size_t> queryIndices;
+  queryIndices.reserve(queryNode.Count());
+  for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+  {
+    rule.TraversalInfo() = traversalInfo;
+    if (rule.Score(query, referenceNode) != DBL_MAX)
+      queryIndices.push_back(query);
+  }
+
+  if (!queryIndices.empty())
+  {
+    rule.BaseCaseBlock(queryIndices, referenceNode.Begin(),
+        referenceNode.Begin() + referenceNode.Count());
+  }
+
+  return queryIndices.size() * referenceNode.Count();
+}
+
+/**
+ * Evaluate the base cases between the points of the given query leaf and the
+ * points of the given reference leaf one pair at a time, for rules that do not
+ * have a BaseCaseBlock() method.
+ *
+ * @return The number of base cases that were evaluated.
+ */
+template<typename RuleType, typename TreeType>
+size_t LeafBaseCases(
+    RuleType& rule,
+    TreeType& queryNode,
+    TreeType& referenceNode,
+    const typename RuleType::TraversalInfoType& traversalInfo,
+    const typename std::enable_if_t<!HasBaseCaseBlock<RuleType>::value>* = 0)
+{
+  size_t numBaseCases = 0;
+
+  // Loop through each of the points in each node.
+  const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+  const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+  for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+  {
+    // See if we need to investigate this point (this function should be
+    // implemented for the single-tree recursion too).  Restore the traversal
+    // information first.
+    rule.TraversalInfo() = traversalInfo;
+    const double childScore = rule.Score(query, referenceNode);
+
+    if (childScore == DBL_MAX)
+      continue; // We can't improve this particular point.
+
+    for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+      rule.BaseCase(query, ref);
+
+    numBaseCases += referenceNode.Count();
+  }
+
+  return numBaseCases;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -30,6 +30,9 @@ class Octree
   //! The type of element held in MatType.
   typedef typename MatType::elem_type ElemType;
 
+  //! Count the memory of the nodes, if memory tracking is enabled.
+  MLPACK_TRACK_ALLOCATIONS
+
   //! A single-tree traverser; see single_tree_traverser.hpp.
   template<typename RuleType>
   class SingleTreeTraverser;
@@ -38,6 +41,11 @@ class Octree
   template<typename RuleType>
   class DualTreeTraverser;
 
+  //! A task-parallel dual-tree traverser; see
+  //! parallel_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  class ParallelDualTreeTraverser;
+
  private:
   //! The children held by this node.
   std::vector<Octree*> children;
@@ -413,9 +421,16 @@ class Octree
   friend class boost::serialization::access;
 
  private:
+  //! Whether or not the children of a node can be built in parallel: the
+  //! columns of a sparse matrix cannot be swapped concurrently.
+  static const bool parallelBuild = arma::is_Mat<MatType>::value;
+  //! The number of points a node must hold for its children to be built in
+  //! parallel.
+  static const size_t parallelBuildSize = 20000;
+
   /**
    * Split the node, using the given center and the given maximum width of this
-   * node.
+   * node.  The children of large nodes are built in parallel with OpenMP tasks.
    *
    * @param center Center of the node.
    * @param width Width of the current node.
@@ -427,7 +442,8 @@ class Octree
 
   /**
    * Split the node, using the given center and the given maximum width of this
-   * node, and fill the mappings vector.
+   * node, and fill the mappings vector.  The children of large nodes are built
+   * in parallel with OpenMP tasks.
    *
    * @param center Center of the node.
    * @param width Width of the current node.
@@ -755,6 +755,22 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   if (count <= maxLeafSize)
     return;
 
+  #ifdef HAS_OPENMP
+    // The children of large nodes are built in parallel, as OpenMP tasks.  The
+    // root opens the parallel region that runs them, unless we are already in
+    // one.
+    if (parallelBuild && parent == NULL && count >= parallelBuildSize &&
+        omp_get_max_threads() > 1 && omp_get_level() == 0)
+    {
+      #pragma omp parallel
+      {
+        #pragma omp single
+        SplitNode(center, width, maxLeafSize);
+      }
+      return;
+    }
+  #endif
+
   // This will hold the index of the first point in each child.
   arma::Col<size_t> childBegins(((size_t) 1 << dataset->n_rows) + 1);
   childBegins[0] = begin;
@@ -781,8 +797,8 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     // all points belonging to children of index 2^(d - 1) and above will be on
     // the right side.
     typename SplitType::SplitInfo s(d, center);
-    const size_t firstRight = split::PerformSplit<MatType, SplitType>(*dataset,
-        childBegin, childCount, s);
+    const size_t firstRight = split::ParallelPerformSplit<MatType, SplitType>(
+        *dataset, childBegin, childCount, s);
 
     // We can set the first index of the right child.  The first index of the
     // left child is already set.
@@ -819,29 +835,41 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     }
   }
 
-  // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
+  // Now that the dataset is reordered, we can create the children.  If a child
+  // has no points, don't create it.
+  std::vector<size_t> childIndices;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+    if (childBegins[i + 1] - childBegins[i] > 0)
+      childIndices.push_back(i);
+
+  // The children of a large node are built by other threads, if any are free.
+  children.resize(childIndices.size(), NULL);
+  const double childWidth = width / 2.0;
+  for (size_t c = 0; c < childIndices.size(); ++c)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
+    const size_t i = childIndices[c];
+    const size_t childCount = childBegins[i + 1] - childBegins[i];
 
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
+    #pragma omp task shared(center, childBegins) \
+        firstprivate(c, i, childCount) \
+        if (parallelBuild && childCount >= parallelBuildSize)
     {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
-    }
+      // Create the correct center.
+      arma::vec childCenter(center.n_elem);
+      for (size_t d = 0; d < center.n_elem; ++d)
+      {
+        // Is the dimension "right" (1) or "left" (0)?
+        if (((i >> d) & 1) == 0)
+          childCenter[d] = center[d] - childWidth;
+        else
+          childCenter[d] = center[d] + childWidth;
+      }
 
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], childCenter, childWidth,
-        maxLeafSize));
+      children[c] = new Octree(this, childBegins[i], childCount, childCenter,
+          childWidth, maxLeafSize);
+    }
   }
+  #pragma omp taskwait
 }
 
 //! Split the node, and store mappings.
@@ -857,6 +885,22 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   if (count <= maxLeafSize)
     return;
 
+  #ifdef HAS_OPENMP
+    // The children of large nodes are built in parallel, as OpenMP tasks.  The
+    // root opens the parallel region that runs them, unless we are already in
+    // one.
+    if (parallelBuild && parent == NULL && count >= parallelBuildSize &&
+        omp_get_max_threads() > 1 && omp_get_level() == 0)
+    {
+      #pragma omp parallel
+      {
+        #pragma omp single
+        SplitNode(center, width, oldFromNew, maxLeafSize);
+      }
+      return;
+    }
+  #endif
+
   // This will hold the index of the first point in each child.
   arma::Col<size_t> childBegins(((size_t) 1 << dataset->n_rows) + 1);
   childBegins[0] = begin;
@@ -883,8 +927,8 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     // all points belonging to children of index 2^(d - 1) and above will be on
     // the right side.
     typename SplitType::SplitInfo s(d, center);
-    const size_t firstRight = split::PerformSplit<MatType, SplitType>(*dataset,
-        childBegin, childCount, s, oldFromNew);
+    const size_t firstRight = split::ParallelPerformSplit<MatType, SplitType>(
+        *dataset, childBegin, childCount, s, oldFromNew);
 
     // We can set the first index of the right child.  The first index of the
     // left child is already set.
@@ -921,29 +965,41 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     }
   }
 
-  // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
+  // Now that the dataset is reordered, we can create the children.  If a child
+  // has no points, don't create it.
+  std::vector<size_t> childIndices;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+    if (childBegins[i + 1] - childBegins[i] > 0)
+      childIndices.push_back(i);
+
+  // The children of a large node are built by other threads, if any are free.
+  children.resize(childIndices.size(), NULL);
+  const double childWidth = width / 2.0;
+  for (size_t c = 0; c < childIndices.size(); ++c)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
+    const size_t i = childIndices[c];
+    const size_t childCount = childBegins[i + 1] - childBegins[i];
 
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
+    #pragma omp task shared(center, childBegins, oldFromNew) \
+        firstprivate(c, i, childCount) \
+        if (parallelBuild && childCount >= parallelBuildSize)
     {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
-    }
+      // Create the correct center.
+      arma::vec childCenter(center.n_elem);
+      for (size_t d = 0; d < center.n_elem; ++d)
+      {
+        // Is the dimension "right" (1) or "left" (0)?
+        if (((i >> d) & 1) == 0)
+          childCenter[d] = center[d] - childWidth;
+        else
+          childCenter[d] = center[d] + childWidth;
+      }
 
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
-        childWidth, maxLeafSize));
+      children[c] = new Octree(this, childBegins[i], childCount, oldFromNew,
+          childCenter, childWidth, maxLeafSize);
+    }
   }
+  #pragma omp taskwait
 }
 
 } // namespace tree
@@ -0,0 +1,130 @@
+/**
+ * @file core/tree/octree/parallel_dual_tree_traverser.hpp
+ *
+ * Defines the ParallelDualTreeTraverser for the Octree.  This is a nested
+ * class of Octree which splits the query tree into disjoint subtrees and
+ * traverses each of them against the reference tree in parallel, using OpenMP,
+ * with the depth-first DualTreeTraverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_OCTREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_OCTREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "octree.hpp"
+#include "dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A task-parallel dual-tree traverser for octrees.  The query tree is descended
+ * to the given task depth, and every query node at that depth (or every leaf
+ * above it) becomes an independent task that is traversed against the whole
+ * reference tree with the usual depth-first DualTreeTraverser.  This works
+ * like BinarySpaceTree::ParallelDualTreeTraverser, and has the same
+ * requirements on RuleType: a copy constructor, modifiable BaseCases() and
+ * Scores() accessors, and
+ *
+ * @code
+ * void Merge(const RuleType& other, const std::vector<TreeType*>& queryNodes);
+ * @endcode
+ *
+ * to merge the results of the copy of the rules used by each thread back into
+ * the original rules object.
+ *
+ * Each node of an octree has up to 2^d children, so if the task depth is 0 it
+ * is chosen when the traversal starts, from the dimensionality of the data,
+ * such that each thread receives several tasks.
+ *
+ * If mlpack is compiled without OpenMP, the tasks are simply run one after the
+ * other.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType>
+template<typename RuleType>
+class Octree<MetricType, StatisticType, MatType>::ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser with the given rule set.
+   *
+   * @param rule Rules to use for the traversal.
+   * @param taskDepth Depth of the query tree at which tasks are created, or 0
+   *     to choose it automatically.
+   */
+  ParallelDualTreeTraverser(RuleType& rule, const size_t taskDepth = 0);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(Octree& queryNode, Octree& referenceNode);
+
+  //! Get the depth of the query tree at which tasks are created (0 means it
+  //! is chosen automatically).
+  size_t TaskDepth() const { return taskDepth; }
+  //! Modify the depth of the query tree at which tasks are created.
+  size_t& TaskDepth() { return taskDepth; }
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  //! Collect the roots of the query subtrees that will become tasks.
+  void CollectTasks(Octree& queryNode,
+                    const size_t depth,
+                    const size_t maxDepth,
+                    std::vector<Octree*>& tasks) const;
+
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The depth of the query tree at which tasks are created.
+  size_t taskDepth;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_OCTREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
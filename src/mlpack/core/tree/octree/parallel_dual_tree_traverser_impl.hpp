@@ -0,0 +1,165 @@
+/**
+ * @file core/tree/octree/parallel_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelDualTreeTraverser for the Octree.  The query
+ * tree is split into disjoint subtrees which are each traversed against the
+ * reference tree in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_OCTREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_OCTREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType, typename StatisticType, typename MatType>
+template<typename RuleType>
+Octree<MetricType, StatisticType, MatType>::
+ParallelDualTreeTraverser<RuleType>::ParallelDualTreeTraverser(
+    RuleType& rule,
+    const size_t taskDepth) :
+    rule(rule),
+    taskDepth(taskDepth),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename StatisticType, typename MatType>
+template<typename RuleType>
+void Octree<MetricType, StatisticType, MatType>::
+ParallelDualTreeTraverser<RuleType>::Traverse(Octree& queryNode,
+                                              Octree& referenceNode)
+{
+  size_t maxDepth = taskDepth;
+  if (maxDepth == 0)
+  {
+    // Each level multiplies the number of nodes by up to 2^d; go deep enough
+    // to have roughly eight tasks per thread, so that dynamic scheduling can
+    // balance unevenly-sized query subtrees.
+    #ifdef HAS_OPENMP
+      const size_t threads = omp_get_max_threads();
+    #else
+      const size_t threads = 1;
+    #endif
+
+    const size_t dims = std::max((size_t) queryNode.Dataset().n_rows,
+        (size_t) 1);
+    maxDepth = 1;
+    while (maxDepth * dims < 64 &&
+        (size_t(1) << (maxDepth * dims)) < 8 * threads)
+      ++maxDepth;
+  }
+
+  std::vector<Octree*> tasks;
+  CollectTasks(queryNode, 0, maxDepth, tasks);
+
+  // If there is only one task, there is nothing to run in parallel.
+  if (tasks.size() == 1)
+  {
+    DualTreeTraverser<RuleType> traverser(rule);
+    traverser.Traverse(queryNode, referenceNode);
+
+    numPrunes += traverser.NumPrunes();
+    numVisited += traverser.NumVisited();
+    numScores += traverser.NumScores();
+    numBaseCases += traverser.NumBaseCases();
+    return;
+  }
+
+  ++numVisited;
+
+  // If both nodes are root nodes, score them before splitting the work, just
+  // like the serial traverser would.
+  if (queryNode.Parent() == NULL && referenceNode.Parent() == NULL)
+  {
+    const double rootScore = rule.Score(queryNode, referenceNode);
+    ++numScores;
+
+    // If root score is DBL_MAX, don't recurse.
+    if (rootScore == DBL_MAX)
+    {
+      ++numPrunes;
+      return;
+    }
+  }
+
+  // Every task starts from the same traversal information.
+  const typename RuleType::TraversalInfoType traversalInfo =
+      rule.TraversalInfo();
+
+  size_t prunes = 0, visited = 0, scores = 0, baseCases = 0;
+
+  #pragma omp parallel reduction(+:prunes, visited, scores, baseCases)
+  {
+    // Each thread works with its own copy of the rules; the query subtrees of
+    // the tasks are disjoint, so the copies never touch the same query points.
+    RuleType threadRule(rule);
+    threadRule.BaseCases() = 0;
+    threadRule.Scores() = 0;
+
+    DualTreeTraverser<RuleType> traverser(threadRule);
+    std::vector<Octree*> threadTasks;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+    {
+      threadRule.TraversalInfo() = traversalInfo;
+      traverser.Traverse(*tasks[i], referenceNode);
+      threadTasks.push_back(tasks[i]);
+    }
+
+    // The implicit barrier of the loop above guarantees that every thread has
+    // copied the rules before any results are merged back.
+    #pragma omp critical(OctreeParallelDualTreeTraverserMerge)
+    {
+      rule.Merge(threadRule, threadTasks);
+      rule.BaseCases() += threadRule.BaseCases();
+      rule.Scores() += threadRule.Scores();
+    }
+
+    prunes += traverser.NumPrunes();
+    visited += traverser.NumVisited();
+    scores += traverser.NumScores();
+    baseCases += traverser.NumBaseCases();
+  }
+
+  numPrunes += prunes;
+  numVisited += visited;
+  numScores += scores;
+  numBaseCases += baseCases;
+}
+
+template<typename MetricType, typename StatisticType, typename MatType>
+template<typename RuleType>
+void Octree<MetricType, StatisticType, MatType>::
+ParallelDualTreeTraverser<RuleType>::CollectTasks(
+    Octree& queryNode,
+    const size_t depth,
+    const size_t maxDepth,
+    std::vector<Octree*>& tasks) const
+{
+  if (depth >= maxDepth || queryNode.IsLeaf())
+  {
+    tasks.push_back(&queryNode);
+    return;
+  }
+
+  for (size_t i = 0; i < queryNode.NumChildren(); ++i)
+    CollectTasks(queryNode.Child(i), depth + 1, maxDepth, tasks);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_OCTREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
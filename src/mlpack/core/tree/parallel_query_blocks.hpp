@@ -0,0 +1,113 @@
+/**
+ * @file core/tree/parallel_query_blocks.hpp
+ *
+ * A utility that runs a per-query search (naive or single-tree) over blocks of
+ * query points in parallel, giving each thread its own copy of the rules.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_QUERY_BLOCKS_HPP
+#define MLPACK_CORE_TREE_PARALLEL_QUERY_BLOCKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Split the query points [0, numQueries) into contiguous blocks and call
+ *
+ * @code
+ * search(threadRules, begin, end);
+ * @endcode
+ *
+ * for each block, where begin and end delimit the query indices of the block.
+ * The blocks are distributed over OpenMP threads with dynamic scheduling, and
+ * each thread uses its own copy of the given rules (made with the copy
+ * constructor of RuleType).  When a thread is done, the results of each of its
+ * blocks are merged back into the given rules with
+ *
+ * @code
+ * void Merge(const RuleType& other, const size_t begin, const size_t end);
+ * @endcode
+ *
+ * and the number of base cases and scores of the copy is added to the given
+ * rules, so RuleType must provide modifiable BaseCases() and Scores()
+ * accessors.  After this function returns, the given rules hold the same kind
+ * of results as if search(rules, 0, numQueries) had been called.
+ *
+ * If parallel is false (or there is only one query point), search() is simply
+ * called once with the given rules and no copy is made.  Note that each thread
+ * keeps a full copy of the rules, so the memory used by the rules grows with
+ * the number of threads, unless the copies share the results of the original
+ * (like the copies of NeighborSearchRules, for which Merge() does nothing).
+ *
+ * @param rules Rules to use for the search; these will hold the results.
+ * @param numQueries Number of query points.
+ * @param parallel Whether or not to process the blocks in parallel.
+ * @param search Function that performs the search for one block.
+ */
+template<typename RuleType, typename BlockSearchType>
+void ParallelQueryBlocks(RuleType& rules,
+                         const size_t numQueries,
+                         const bool parallel,
+                         BlockSearchType&& search)
+{
+  if (!parallel || numQueries < 2)
+  {
+    search(rules, 0, numQueries);
+    return;
+  }
+
+  #ifdef HAS_OPENMP
+    const size_t threads = omp_get_max_threads();
+  #else
+    const size_t threads = 1;
+  #endif
+
+  // Use several blocks per thread so that dynamic scheduling can balance query
+  // points whose searches have very different costs.
+  const size_t blockSize = std::max((size_t) 1,
+      (numQueries + 8 * threads - 1) / (8 * threads));
+  const size_t numBlocks = (numQueries + blockSize - 1) / blockSize;
+
+  #pragma omp parallel
+  {
+    RuleType threadRules(rules);
+    threadRules.BaseCases() = 0;
+    threadRules.Scores() = 0;
+    std::vector<size_t> threadBlocks;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, numQueries);
+      search(threadRules, begin, end);
+      threadBlocks.push_back(b);
+    }
+
+    // The implicit barrier of the loop above guarantees that every thread has
+    // copied the rules before any results are merged back.
+    #pragma omp critical(ParallelQueryBlocksMerge)
+    {
+      for (size_t i = 0; i < threadBlocks.size(); ++i)
+      {
+        const size_t begin = threadBlocks[i] * blockSize;
+        const size_t end = std::min(begin + blockSize, numQueries);
+        rules.Merge(threadRules, begin, end);
+      }
+
+      rules.BaseCases() += threadRules.BaseCases();
+      rules.Scores() += threadRules.Scores();
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
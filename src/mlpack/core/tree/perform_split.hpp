@@ -152,6 +152,186 @@ size_t PerformSplit(MatType& data,
   return left;
 }
 
+namespace detail {
+
+/**
+ * Return whether the tasks of a split can run on several threads, that is,
+ * whether we are in an active OpenMP parallel region.
+ */
+inline bool SplitInParallel()
+{
+  #ifdef HAS_OPENMP
+    return omp_in_parallel() && omp_get_num_threads() > 1;
+  #else
+    return false;
+  #endif
+}
+
+/**
+ * The implementation of both ParallelPerformSplit() overloads; oldFromNew may
+ * be NULL.
+ */
+template<typename MatType, typename SplitType>
+size_t ParallelPerformSplit(MatType& data,
+                            const size_t begin,
+                            const size_t count,
+                            const typename SplitType::SplitInfo& splitInfo,
+                            std::vector<size_t>* oldFromNew)
+{
+  // The number of points of each block that is partitioned on its own.  This
+  // does not depend on the number of threads, so the resulting order of the
+  // points does not either.
+  const size_t blockSize = 8192;
+  const size_t end = begin + count;
+  const size_t numBlocks = (count + blockSize - 1) / blockSize;
+
+  // First partition every block independently.
+  std::vector<size_t> leftCounts(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    #pragma omp task shared(data, splitInfo, leftCounts) firstprivate(b)
+    {
+      const size_t blockBegin = begin + b * blockSize;
+      const size_t blockCount = std::min(blockSize, end - blockBegin);
+      if (oldFromNew == NULL)
+      {
+        leftCounts[b] = PerformSplit<MatType, SplitType>(data, blockBegin,
+            blockCount, splitInfo) - blockBegin;
+      }
+      else
+      {
+        leftCounts[b] = PerformSplit<MatType, SplitType>(data, blockBegin,
+            blockCount, splitInfo, *oldFromNew) - blockBegin;
+      }
+    }
+  }
+  #pragma omp taskwait
+
+  size_t splitCol = begin;
+  for (size_t b = 0; b < numBlocks; ++b)
+    splitCol += leftCounts[b];
+
+  // Now the points on the wrong side of splitCol form a few ranges: the right
+  // points of the blocks before splitCol, and the left points of the blocks
+  // after it.  There are as many of each, so they can be swapped pairwise.
+  std::vector<std::pair<size_t, size_t>> rightRanges, leftRanges;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t blockBegin = begin + b * blockSize;
+    const size_t blockEnd = std::min(blockBegin + blockSize, end);
+    const size_t blockSplit = blockBegin + leftCounts[b];
+
+    if (blockSplit < std::min(blockEnd, splitCol))
+    {
+      rightRanges.push_back(std::make_pair(blockSplit,
+          std::min(blockEnd, splitCol)));
+    }
+    if (std::max(blockBegin, splitCol) < blockSplit)
+    {
+      leftRanges.push_back(std::make_pair(std::max(blockBegin, splitCol),
+          blockSplit));
+    }
+  }
+
+  // Swap the misplaced points in pieces of at most blockSize pairs, each of
+  // which lies inside one range of each list.
+  size_t r = 0, l = 0;
+  size_t first = rightRanges.empty() ? 0 : rightRanges[0].first;
+  size_t second = leftRanges.empty() ? 0 : leftRanges[0].first;
+  while (r < rightRanges.size() && l < leftRanges.size())
+  {
+    const size_t length = std::min(std::min(rightRanges[r].second - first,
+        leftRanges[l].second - second), blockSize);
+
+    #pragma omp task shared(data) firstprivate(first, second, length)
+    for (size_t i = 0; i < length; ++i)
+    {
+      data.swap_cols(first + i, second + i);
+      if (oldFromNew != NULL)
+        std::swap((*oldFromNew)[first + i], (*oldFromNew)[second + i]);
+    }
+
+    first += length;
+    second += length;
+    if (first == rightRanges[r].second && ++r < rightRanges.size())
+      first = rightRanges[r].first;
+    if (second == leftRanges[l].second && ++l < leftRanges.size())
+      second = leftRanges[l].first;
+  }
+  #pragma omp taskwait
+
+  return splitCol;
+}
+
+} // namespace detail
+
+/**
+ * This function produces the same split as PerformSplit(), but large nodes are
+ * split block by block: each block is partitioned on its own, and then the
+ * points that are on the wrong side of the split column are swapped.  Each of
+ * these steps is made of OpenMP tasks, which run in parallel when the function
+ * is called inside a parallel region of several threads (for instance, while a
+ * BinarySpaceTree is built in parallel).
+ *
+ * The points that end up on each side of the split column are the same as with
+ * PerformSplit(), but their order may differ; it does not depend on the number
+ * of threads, as long as there are several.  Outside of a parallel region (or
+ * with one thread, or without OpenMP), and for small nodes and sparse matrices
+ * (which cannot have their columns swapped concurrently), the split is simply
+ * done with PerformSplit(), so the points are in the usual serial order.
+ *
+ * @param data The dataset used by the binary space tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ */
+template<typename MatType, typename SplitType>
+size_t ParallelPerformSplit(MatType& data,
+                            const size_t begin,
+                            const size_t count,
+                            const typename SplitType::SplitInfo& splitInfo)
+{
+  if (!arma::is_Mat<MatType>::value || count < 65536 ||
+      !detail::SplitInParallel())
+    return PerformSplit<MatType, SplitType>(data, begin, count, splitInfo);
+
+  return detail::ParallelPerformSplit<MatType, SplitType>(data, begin, count,
+      splitInfo, NULL);
+}
+
+/**
+ * This function produces the same split as PerformSplit(), and takes care of
+ * the indices like the corresponding PerformSplit() overload does.  Large
+ * nodes of dense matrices are split block by block with OpenMP tasks; see the
+ * overload above for details.
+ *
+ * @param data The dataset used by the binary space tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ * @param oldFromNew Vector which will be filled with the old positions for
+ *    each new point.
+ */
+template<typename MatType, typename SplitType>
+size_t ParallelPerformSplit(MatType& data,
+                            const size_t begin,
+                            const size_t count,
+                            const typename SplitType::SplitInfo& splitInfo,
+                            std::vector<size_t>& oldFromNew)
+{
+  if (!arma::is_Mat<MatType>::value || count < 65536 ||
+      !detail::SplitInParallel())
+  {
+    return PerformSplit<MatType, SplitType>(data, begin, count, splitInfo,
+        oldFromNew);
+  }
+
+  return detail::ParallelPerformSplit<MatType, SplitType>(data, begin, count,
+      splitInfo, &oldFromNew);
+}
+
 } // namespace split
 } // namespace tree
 } // namespace mlpack
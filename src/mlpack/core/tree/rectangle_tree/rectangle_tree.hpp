@@ -20,6 +20,8 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "x_tree_auxiliary_information.hpp"
+#include "discrete_hilbert_value.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -62,6 +64,10 @@ class RectangleTree
   typedef MatType Mat;
   //! The element type held by the matrix type.
   typedef typename MatType::elem_type ElemType;
+
+  //! Count the memory of the nodes, if memory tracking is enabled.
+  MLPACK_TRACK_ALLOCATIONS
+
   //! The auxiliary information type held by the tree.
   typedef AuxiliaryInformationType<RectangleTree> AuxiliaryInformation;
  private:
@@ -127,13 +133,16 @@ class RectangleTree
    *      have.
    * @param firstDataIndex The index of the first data point.  UNUSED UNLESS WE
    *      ADD SUPPORT FOR HAVING A "CENTERAL" DATA MATRIX.
+   * @param bulkLoad If true, build the tree from all the points at once
+   *      instead of inserting them one at a time (see BulkLoad()).
    */
   RectangleTree(const MatType& data,
                 const size_t maxLeafSize = 20,
                 const size_t minLeafSize = 8,
                 const size_t maxNumChildren = 5,
                 const size_t minNumChildren = 2,
-                const size_t firstDataIndex = 0);
+                const size_t firstDataIndex = 0,
+                const bool bulkLoad = false);
 
   /**
    * Construct this as the root node of a rectangle tree type using the given
@@ -148,13 +157,16 @@ class RectangleTree
    *      have.
    * @param firstDataIndex The index of the first data point.  UNUSED UNLESS WE
    *      ADD SUPPORT FOR HAVING A "CENTERAL" DATA MATRIX.
+   * @param bulkLoad If true, build the tree from all the points at once
+   *      instead of inserting them one at a time (see BulkLoad()).
    */
   RectangleTree(MatType&& data,
                 const size_t maxLeafSize = 20,
                 const size_t minLeafSize = 8,
                 const size_t maxNumChildren = 5,
                 const size_t minNumChildren = 2,
-                const size_t firstDataIndex = 0);
+                const size_t firstDataIndex = 0,
+                const bool bulkLoad = false);
 
   /**
    * Construct this as an empty node with the specified parent.  Copying the
@@ -564,6 +576,76 @@ class RectangleTree
    */
   void BuildStatistics(RectangleTree* node);
 
+  //! Whether the nodes of this tree can be packed directly when bulk loading.
+  //! The Hilbert R tree and the R++ tree keep auxiliary information that is
+  //! only maintained by insertions, so they are bulk loaded by inserting the
+  //! points in Hilbert order instead.
+  static constexpr bool CanPack =
+      std::is_same<AuxiliaryInformation,
+                   NoAuxiliaryInformation<RectangleTree>>::value ||
+      std::is_same<AuxiliaryInformation,
+                   XTreeAuxiliaryInformation<RectangleTree>>::value;
+
+  /**
+   * Build the tree from the points firstIndex, ..., Dataset().n_cols - 1 with
+   * sort-tile-recursive packing: the height of the tree is the smallest one
+   * that can hold all the points, and the points of each node are tiled into
+   * as few children as possible (sorting them along each dimension in turn),
+   * so that the nodes are (nearly) full, and the children of a node don't
+   * overlap.  This takes O(n log n) time.
+   *
+   * The fill of every node stays above MinLeafSize() and MinNumChildren() as
+   * long as they are at most half of MaxLeafSize() and MaxNumChildren(), as
+   * is required anyway for the splits.
+   *
+   * @param firstIndex Index of the first point to add to the tree.
+   */
+  void BulkLoad(const size_t firstIndex, const std::true_type /* canPack */);
+
+  /**
+   * Build the tree from the points firstIndex, ..., Dataset().n_cols - 1 by
+   * inserting them in increasing order of their Hilbert values, so that each
+   * point goes next to the previous one.  This is used for the trees whose
+   * auxiliary information can't be set up by packing.
+   *
+   * @param firstIndex Index of the first point to add to the tree.
+   */
+  void BulkLoad(const size_t firstIndex, const std::false_type /* canPack */);
+
+  /**
+   * Make this node hold the given points, building a subtree of the given
+   * height under it.
+   *
+   * @param indices Indices of the points being bulk loaded.
+   * @param first Index (in indices) of the first point of this node.
+   * @param last Index (in indices) after the last point of this node.
+   * @param height Height of the subtree (0 for a leaf).
+   */
+  void PackNode(std::vector<size_t>& indices,
+                const size_t first,
+                const size_t last,
+                const size_t height);
+
+  /**
+   * Split the given points into numGroups tiles of (nearly) equal size: the
+   * points are cut into slices along dimension dim, and each slice is tiled
+   * recursively along the next dimensions.  The end of each tile (in indices)
+   * is appended to tileEnds.
+   *
+   * @param indices Indices of the points being bulk loaded.
+   * @param first Index (in indices) of the first point to tile.
+   * @param last Index (in indices) after the last point to tile.
+   * @param numTiles Number of tiles to make.
+   * @param dim Dimension along which to cut the points.
+   * @param tileEnds Vector to store the end of each tile in.
+   */
+  void TilePoints(std::vector<size_t>& indices,
+                  const size_t first,
+                  const size_t last,
+                  const size_t numTiles,
+                  const size_t dim,
+                  std::vector<size_t>& tileEnds) const;
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -52,7 +52,8 @@ RectangleTree(const MatType& data,
               const size_t minLeafSize,
               const size_t maxNumChildren,
               const size_t minNumChildren,
-              const size_t firstDataIndex) :
+              const size_t firstDataIndex,
+              const bool bulkLoad) :
     maxNumChildren(maxNumChildren),
     minNumChildren(minNumChildren),
     numChildren(0),
@@ -70,11 +71,18 @@ RectangleTree(const MatType& data,
     points(maxLeafSize + 1), // Add one to make splitting the node simpler.
     auxiliaryInfo(this)
 {
-  // For now, just insert the points in order.
-  RectangleTree* root = this;
+  if (bulkLoad)
+  {
+    BulkLoad(firstDataIndex, std::integral_constant<bool, CanPack>());
+  }
+  else
+  {
+    // For now, just insert the points in order.
+    RectangleTree* root = this;
 
-  for (size_t i = firstDataIndex; i < data.n_cols; ++i)
-    root->InsertPoint(i);
+    for (size_t i = firstDataIndex; i < data.n_cols; ++i)
+      root->InsertPoint(i);
+  }
 
   // Initialize statistic recursively after tree construction is complete.
   BuildStatistics(this);
@@ -93,7 +101,8 @@ RectangleTree(MatType&& data,
               const size_t minLeafSize,
               const size_t maxNumChildren,
               const size_t minNumChildren,
-              const size_t firstDataIndex) :
+              const size_t firstDataIndex,
+              const bool bulkLoad) :
     maxNumChildren(maxNumChildren),
     minNumChildren(minNumChildren),
     numChildren(0),
@@ -111,11 +120,18 @@ RectangleTree(MatType&& data,
     points(maxLeafSize + 1), // Add one to make splitting the node simpler.
     auxiliaryInfo(this)
 {
-  // For now, just insert the points in order.
-  RectangleTree* root = this;
+  if (bulkLoad)
+  {
+    BulkLoad(firstDataIndex, std::integral_constant<bool, CanPack>());
+  }
+  else
+  {
+    // For now, just insert the points in order.
+    RectangleTree* root = this;
 
-  for (size_t i = firstDataIndex; i < dataset->n_cols; ++i)
-    root->InsertPoint(i);
+    for (size_t i = firstDataIndex; i < dataset->n_cols; ++i)
+      root->InsertPoint(i);
+  }
 
   // Initialize statistic recursively after tree construction is complete.
   BuildStatistics(this);
@@ -420,6 +436,190 @@ RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
     delete dataset;
 }
 
+/**
+ * Build the whole tree at once with sort-tile-recursive packing.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoad(const size_t firstIndex, const std::true_type /* canPack */)
+{
+  const size_t numPoints = (firstIndex < dataset->n_cols) ?
+      dataset->n_cols - firstIndex : 0;
+
+  // Find the smallest height at which the tree can hold all the points.
+  size_t height = 0;
+  size_t capacity = maxLeafSize;
+  while (capacity < numPoints)
+  {
+    capacity *= maxNumChildren;
+    ++height;
+  }
+
+  std::vector<size_t> indices(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    indices[i] = firstIndex + i;
+
+  PackNode(indices, 0, numPoints, height);
+}
+
+/**
+ * Build the tree by inserting the points in Hilbert order.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoad(const size_t firstIndex, const std::false_type /* canPack */)
+{
+  typedef DiscreteHilbertValue<ElemType> HilbertValue;
+  typedef arma::Col<typename HilbertValue::HilbertElemType> HilbertValueVec;
+
+  const size_t numPoints = (firstIndex < dataset->n_cols) ?
+      dataset->n_cols - firstIndex : 0;
+
+  // Calculate each Hilbert value only once.
+  std::vector<HilbertValueVec> values(numPoints);
+  std::vector<size_t> indices(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    values[i] = HilbertValue::CalculateValue(dataset->col(firstIndex + i));
+    indices[i] = i;
+  }
+
+  std::sort(indices.begin(), indices.end(),
+      [&values](const size_t a, const size_t b)
+      {
+        return HilbertValue::CompareValues(values[a], values[b]) < 0;
+      });
+
+  for (size_t i = 0; i < numPoints; ++i)
+    InsertPoint(firstIndex + indices[i]);
+}
+
+/**
+ * Make this node hold the given points, packing them into a subtree of the
+ * given height.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    PackNode(std::vector<size_t>& indices,
+             const size_t first,
+             const size_t last,
+             const size_t height)
+{
+  numDescendants = last - first;
+
+  if (height == 0)
+  {
+    for (size_t i = first; i < last; ++i)
+    {
+      points[count++] = indices[i];
+      bound |= dataset->col(indices[i]);
+    }
+
+    return;
+  }
+
+  // Use as few children as possible; each child subtree is one level shorter.
+  size_t childCapacity = maxLeafSize;
+  for (size_t h = 1; h < height; ++h)
+    childCapacity *= maxNumChildren;
+  const size_t numTiles = (last - first + childCapacity - 1) / childCapacity;
+
+  std::vector<size_t> tileEnds;
+  TilePoints(indices, first, last, numTiles, 0, tileEnds);
+
+  size_t tileBegin = first;
+  for (size_t i = 0; i < tileEnds.size(); ++i)
+  {
+    RectangleTree* child = new RectangleTree(this);
+    children[numChildren++] = child;
+    child->PackNode(indices, tileBegin, tileEnds[i], height - 1);
+    bound |= child->Bound();
+    tileBegin = tileEnds[i];
+  }
+}
+
+/**
+ * Split the given points into tiles of (nearly) equal size.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    TilePoints(std::vector<size_t>& indices,
+               const size_t first,
+               const size_t last,
+               const size_t numTiles,
+               const size_t dim,
+               std::vector<size_t>& tileEnds) const
+{
+  if (numTiles == 1)
+  {
+    tileEnds.push_back(last);
+    return;
+  }
+
+  // Cut the points into about numTiles^(1 / remaining dimensions) slices, so
+  // that the tiles are about as wide along each dimension.  Along the last
+  // dimension, each slice is a tile.
+  const size_t dims = dataset->n_rows;
+  size_t numSlices = numTiles;
+  if (dim + 1 < dims)
+  {
+    numSlices = (size_t) std::ceil(std::pow((double) numTiles,
+        1.0 / (double) (dims - dim)));
+    numSlices = std::min(std::max(numSlices, (size_t) 2), numTiles);
+  }
+
+  // Each slice gets an equal share of the tiles, and a number of points in
+  // proportion.  Only the slice boundaries need to be in order.
+  const MatType& data = *dataset;
+  const size_t numPoints = last - first;
+  size_t sliceBegin = first;
+  size_t tilesBefore = 0;
+  for (size_t s = 0; s < numSlices; ++s)
+  {
+    const size_t sliceTiles = (numTiles * (s + 1)) / numSlices -
+        (numTiles * s) / numSlices;
+    tilesBefore += sliceTiles;
+    const size_t sliceEnd = first + (numPoints * tilesBefore) / numTiles;
+
+    if (sliceEnd < last)
+    {
+      std::nth_element(indices.begin() + sliceBegin, indices.begin() + sliceEnd,
+          indices.begin() + last, [&data, dim](const size_t a, const size_t b)
+          {
+            return data(dim, a) < data(dim, b);
+          });
+    }
+
+    TilePoints(indices, sliceBegin, sliceEnd, sliceTiles,
+        std::min(dim + 1, dims - 1), tileEnds);
+    sliceBegin = sliceEnd;
+  }
+}
+
 /**
  * Deletes this node but leaves the children untouched.  Needed for when we
  * split nodes and remove nodes (inserting and deleting points).
@@ -53,6 +53,31 @@ class SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
                 SpillTree& referenceNode,
                 const bool bruteForce = false);
 
+  /**
+   * Traverse the tree with the given query points at once.  Each query point
+   * visits the same nodes as with Traverse(queryIndex, referenceNode), but the
+   * query points that reach the same leaf are compared with its points in one
+   * call to
+   *
+   * @code
+   * void IndexedBaseCaseBlock(const std::vector<size_t>& queryIndices,
+   *                           const std::vector<size_t>& referenceIndices);
+   * @endcode
+   *
+   * so that the rules can compute all the distances of the leaf at once.  This
+   * is most useful for defeatist search, where most query points only descend
+   * into one child of each node.
+   *
+   * @param queryIndices The indices of the points in the query set which are
+   *     being used as query points.
+   * @param referenceNode The tree node to be traversed.
+   * @param bruteForce If true, then do a brute-force search on the reference
+   *     node instead of traversing any further.
+   */
+  void Traverse(const std::vector<size_t>& queryIndices,
+                SpillTree& referenceNode,
+                const bool bruteForce = false);
+
   //! Get the number of prunes.
   size_t NumPrunes() const { return numPrunes; }
   //! Modify the number of prunes.
@@ -130,6 +130,108 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
   }
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType, bool Defeatist>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
+    const std::vector<size_t>& queryIndices,
+    SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>&
+        referenceNode,
+    const bool bruteForce)
+{
+  if (queryIndices.empty())
+    return;
+
+  // If we have too few points, then we need to backtrack up one level and
+  // brute-force search.
+  if (!bruteForce && Defeatist &&
+      (referenceNode.NumDescendants() < rule.MinimumBaseCases()) &&
+      (referenceNode.Parent() != NULL) &&
+      (referenceNode.Parent()->Overlap()))
+  {
+    Traverse(queryIndices, *referenceNode.Parent(), true);
+  }
+  else if (referenceNode.IsLeaf() || bruteForce)
+  {
+    std::vector<size_t> referenceIndices(referenceNode.NumDescendants());
+    for (size_t i = 0; i < referenceIndices.size(); ++i)
+      referenceIndices[i] = referenceNode.Descendant(i);
+
+    rule.IndexedBaseCaseBlock(queryIndices, referenceIndices);
+  }
+  else if (Defeatist && referenceNode.Overlap())
+  {
+    // If referenceNode is a overlapping node we do defeatist search: split the
+    // query points between the children they descend into.
+    std::vector<size_t> childQueries[2];
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+    {
+      const size_t bestChild = rule.GetBestChild(queryIndices[i],
+          referenceNode);
+      childQueries[bestChild].push_back(queryIndices[i]);
+    }
+    numPrunes += queryIndices.size();
+
+    Traverse(childQueries[0], *referenceNode.Left());
+    Traverse(childQueries[1], *referenceNode.Right());
+  }
+  else
+  {
+    // Split the query points between the ones that visit the left child first
+    // and the ones that visit the right child first (ties go to the left, like
+    // in the single point traversal), and keep the score of the other child.
+    std::vector<size_t> firstQueries[2];
+    std::vector<double> secondScores[2];
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+    {
+      const size_t queryIndex = queryIndices[i];
+      const double leftScore = rule.Score(queryIndex, *referenceNode.Left());
+      const double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+
+      if (leftScore == DBL_MAX && rightScore == DBL_MAX)
+      {
+        numPrunes += 2; // Pruned both left and right.
+      }
+      else if (leftScore <= rightScore)
+      {
+        firstQueries[0].push_back(queryIndex);
+        secondScores[0].push_back(rightScore);
+      }
+      else
+      {
+        firstQueries[1].push_back(queryIndex);
+        secondScores[1].push_back(leftScore);
+      }
+    }
+
+    for (size_t first = 0; first < 2; ++first)
+    {
+      SpillTree& firstChild = referenceNode.Child(first);
+      SpillTree& secondChild = referenceNode.Child(1 - first);
+      Traverse(firstQueries[first], firstChild);
+
+      // Is it still valid to recurse to the other child?
+      std::vector<size_t> secondQueries;
+      for (size_t i = 0; i < firstQueries[first].size(); ++i)
+      {
+        const size_t queryIndex = firstQueries[first][i];
+        if (rule.Rescore(queryIndex, secondChild, secondScores[first][i]) !=
+            DBL_MAX)
+          secondQueries.push_back(queryIndex);
+        else
+          ++numPrunes;
+      }
+
+      Traverse(secondQueries, secondChild);
+    }
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -77,6 +77,10 @@ class SpillTree
   typedef MatType Mat;
   //! The type of element held in MatType.
   typedef typename MatType::elem_type ElemType;
+
+  //! Count the memory of the nodes, if memory tracking is enabled.
+  MLPACK_TRACK_ALLOCATIONS
+
   //! The bound type.
   typedef typename HyperplaneType<MetricType>::BoundType BoundType;
 
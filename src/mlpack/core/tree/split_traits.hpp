@@ -0,0 +1,46 @@
+/**
+ * @file core/tree/split_traits.hpp
+ *
+ * A class for template metaprogramming traits for the split types of the
+ * BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A class to obtain compile-time traits about SplitType classes.  If you are
+ * writing your own SplitType class, you should make a template specialization
+ * in order to set the values correctly.
+ *
+ * @see BoundTraits, TreeTraits
+ */
+template<typename SplitType>
+struct SplitTraits
+{
+  //! If true, then different nodes can be split at the same time by different
+  //! threads: SplitNode() and PerformSplit() only touch the points of the node
+  //! they are given, and use no global state (such as the random number
+  //! generator).  This allows the BinarySpaceTree to build its children in
+  //! parallel.  This defaults to false.
+  static const bool IsThreadSafe = false;
+
+  //! If true, then any node of a tree can be split again on its own, with a
+  //! new SplitType object; this allows the BinarySpaceTree to rebuild only the
+  //! parts of the tree that changed when points are inserted or removed.  If
+  //! false, SplitNode() relies on state that is set up when the root is split,
+  //! so the whole tree has to be rebuilt.  This defaults to true.
+  static const bool SplitsAnyNode = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
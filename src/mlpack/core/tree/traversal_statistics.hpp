@@ -0,0 +1,259 @@
+/**
+ * @file core/tree/traversal_statistics.hpp
+ *
+ * Statistics about a tree traversal (node combinations visited at each level,
+ * prunes, base cases, leaf occupancy and bound tightness), which can be
+ * collected by the traversers to help choosing the tree type and leaf size.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/log.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * TraversalStatistics holds statistics about one or more tree traversals.
+ * Collecting them is opt-in: a traverser that supports it (for now, the
+ * single-tree and dual-tree traversers of BinarySpaceTree) only updates the
+ * object that was given to its Statistics() member, which is NULL by default,
+ * so the traversal costs a single pointer test per visit otherwise.
+ *
+ * @code
+ * KDTree<EuclideanDistance, EmptyStatistic, arma::mat>::DualTreeTraverser<
+ *     RuleType> traverser(rules);
+ * TraversalStatistics statistics;
+ * traverser.Statistics() = &statistics;
+ * traverser.Traverse(queryTree, referenceTree);
+ * statistics.Print();
+ * @endcode
+ *
+ * The collected statistics are:
+ *
+ *  - the number of node combinations visited at each level of the recursion
+ *    (for a single-tree traversal, the level is the depth of the reference
+ *    node);
+ *  - the number of node combinations that were scored and pruned, and the
+ *    prune rate (the fraction of the scored combinations that were pruned);
+ *  - the number of base cases;
+ *  - the number of leaf combinations that were reached, and the average number
+ *    of query and reference points in their leaves;
+ *  - the bound tightness: the fraction of the point pairs of the reached leaf
+ *    combinations for which a base case was evaluated.  When it is low, most
+ *    of the points of the leaves are pruned one at a time, so the node bounds
+ *    are loose compared to the point bounds (smaller leaves or a tree with
+ *    tighter bounds may help).
+ */
+class TraversalStatistics
+{
+ public:
+  //! Create the statistics, with all the counters set to zero.
+  TraversalStatistics() { Reset(); }
+
+  //! Set all the counters to zero.
+  void Reset()
+  {
+    numVisited.clear();
+    numScores = 0;
+    numPrunes = 0;
+    numBaseCases = 0;
+    numLeafCombinations = 0;
+    numQueryLeafPoints = 0;
+    numReferenceLeafPoints = 0;
+    numLeafPointPairs = 0;
+  }
+
+  /**
+   * Record the visit of a node combination.
+   *
+   * @param level Level of the recursion of the visit (0 for the roots).
+   */
+  void Visit(const size_t level)
+  {
+    if (level >= numVisited.size())
+      numVisited.resize(level + 1, 0);
+    ++numVisited[level];
+  }
+
+  /**
+   * Record node combinations that were scored and pruned.
+   *
+   * @param scores Number of scored node combinations.
+   * @param prunes Number of pruned node combinations.
+   */
+  void Add(const size_t scores, const size_t prunes)
+  {
+    numScores += scores;
+    numPrunes += prunes;
+  }
+
+  /**
+   * Record a reached leaf combination.
+   *
+   * @param queryPoints Number of points in the query leaf (1 for a single-tree
+   *     traversal).
+   * @param referencePoints Number of points in the reference leaf.
+   * @param baseCases Number of base cases that were evaluated for the leaves.
+   */
+  void LeafCombination(const size_t queryPoints,
+                       const size_t referencePoints,
+                       const size_t baseCases)
+  {
+    ++numLeafCombinations;
+    numQueryLeafPoints += queryPoints;
+    numReferenceLeafPoints += referencePoints;
+    numLeafPointPairs += queryPoints * referencePoints;
+    numBaseCases += baseCases;
+  }
+
+  //! Add the statistics of another traversal (of a part of the same search,
+  //! for instance).
+  TraversalStatistics& operator+=(const TraversalStatistics& other)
+  {
+    if (other.numVisited.size() > numVisited.size())
+      numVisited.resize(other.numVisited.size(), 0);
+    for (size_t i = 0; i < other.numVisited.size(); ++i)
+      numVisited[i] += other.numVisited[i];
+
+    numScores += other.numScores;
+    numPrunes += other.numPrunes;
+    numBaseCases += other.numBaseCases;
+    numLeafCombinations += other.numLeafCombinations;
+    numQueryLeafPoints += other.numQueryLeafPoints;
+    numReferenceLeafPoints += other.numReferenceLeafPoints;
+    numLeafPointPairs += other.numLeafPointPairs;
+    return *this;
+  }
+
+  //! Get the number of node combinations visited at each level.
+  const std::vector<size_t>& NumVisited() const { return numVisited; }
+  //! Get the number of scored node combinations.
+  size_t NumScores() const { return numScores; }
+  //! Get the number of pruned node combinations.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Get the number of base cases.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Get the number of reached leaf combinations.
+  size_t NumLeafCombinations() const { return numLeafCombinations; }
+
+  //! Get the fraction of the scored node combinations that were pruned.
+  double PruneRate() const
+  {
+    return (numScores == 0) ? 0.0 :
+        std::min((double) numPrunes / numScores, 1.0);
+  }
+
+  //! Get the average number of points in the reached query leaves.
+  double AverageQueryLeafSize() const
+  {
+    return (numLeafCombinations == 0) ? 0.0 :
+        (double) numQueryLeafPoints / numLeafCombinations;
+  }
+
+  //! Get the average number of points in the reached reference leaves.
+  double AverageReferenceLeafSize() const
+  {
+    return (numLeafCombinations == 0) ? 0.0 :
+        (double) numReferenceLeafPoints / numLeafCombinations;
+  }
+
+  //! Get the fraction of the point pairs of the reached leaf combinations for
+  //! which a base case was evaluated.
+  double BoundTightness() const
+  {
+    return (numLeafPointPairs == 0) ? 0.0 :
+        (double) numBaseCases / numLeafPointPairs;
+  }
+
+  //! Print the statistics to Log::Info (if any visit was recorded).
+  void Print() const
+  {
+    if (numVisited.empty())
+      return;
+
+    Log::Info << "Traversal statistics:" << std::endl;
+    Log::Info << "  node combinations visited per level:";
+    for (size_t i = 0; i < numVisited.size(); ++i)
+      Log::Info << " " << numVisited[i];
+    Log::Info << std::endl;
+    Log::Info << "  " << numScores << " node combinations scored, "
+        << numPrunes << " pruned (prune rate " << PruneRate() << ")."
+        << std::endl;
+    Log::Info << "  " << numBaseCases << " base cases in "
+        << numLeafCombinations << " leaf combinations (average leaf occupancy "
+        << AverageQueryLeafSize() << " query points, "
+        << AverageReferenceLeafSize() << " reference points)." << std::endl;
+    Log::Info << "  bound tightness " << BoundTightness() << " (fraction of "
+        << "the leaf point pairs that were evaluated)." << std::endl;
+  }
+
+ private:
+  //! The number of node combinations visited at each level.
+  std::vector<size_t> numVisited;
+  //! The number of scored node combinations.
+  size_t numScores;
+  //! The number of pruned node combinations.
+  size_t numPrunes;
+  //! The number of base cases.
+  size_t numBaseCases;
+  //! The number of reached leaf combinations.
+  size_t numLeafCombinations;
+  //! The total number of points in the reached query leaves.
+  size_t numQueryLeafPoints;
+  //! The total number of points in the reached reference leaves.
+  size_t numReferenceLeafPoints;
+  //! The total number of point pairs of the reached leaf combinations.
+  size_t numLeafPointPairs;
+};
+
+/**
+ * Give the given statistics to the given traverser, if it supports collecting
+ * them (this overload) and if they were requested, i.e. if Log::Info is
+ * printed (with the --verbose option of the command-line programs, for
+ * instance).
+ */
+template<typename TraverserType>
+auto CollectTraversalStatistics(TraverserType& traverser,
+                                TraversalStatistics& statistics,
+                                const int /* preferred */)
+    -> decltype(traverser.Statistics() = &statistics, void())
+{
+  if (!Log::Info.ignoreInput)
+    traverser.Statistics() = &statistics;
+}
+
+/**
+ * Traversers that do not support collecting statistics are left as they are.
+ */
+template<typename TraverserType>
+void CollectTraversalStatistics(TraverserType& /* traverser */,
+                                TraversalStatistics& /* statistics */,
+                                const long /* fallback */)
+{ }
+
+/**
+ * Give the given statistics to the given traverser, if it supports collecting
+ * them and if they were requested, i.e. if Log::Info is printed (with the
+ * --verbose option of the command-line programs, for instance).
+ *
+ * @param traverser Traverser that will update the statistics.
+ * @param statistics Statistics to update.
+ */
+template<typename TraverserType>
+void CollectTraversalStatistics(TraverserType& traverser,
+                                TraversalStatistics& statistics)
+{
+  CollectTraversalStatistics(traverser, statistics, 0);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
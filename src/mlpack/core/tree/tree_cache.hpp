@@ -0,0 +1,198 @@
+/**
+ * @file core/tree/tree_cache.hpp
+ *
+ * A cache of trees built on the same datasets, so that several algorithms can
+ * share one tree instead of each building its own.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TREE_CACHE_HPP
+#define MLPACK_CORE_TREE_TREE_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/statistic.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <typeindex>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The type of the tree that holds the structure of trees of type TreeType in a
+ * TreeCache.  By default, this is TreeType itself: a tree is built for each
+ * statistic type.
+ */
+template<typename TreeType>
+struct TreeStructure
+{
+  typedef TreeType Type;
+};
+
+/**
+ * A BinarySpaceTree can be copied to another statistic type (which is much
+ * faster than building it), so its structure is built once with
+ * EmptyStatistic.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+struct TreeStructure<BinarySpaceTree<MetricType, StatisticType, MatType,
+    BoundType, SplitType>>
+{
+  typedef BinarySpaceTree<MetricType, EmptyStatistic, MatType, BoundType,
+      SplitType> Type;
+};
+
+/**
+ * TreeCache holds trees built on datasets, so that algorithms run one after
+ * the other on the same reference set (for instance KNN, then RangeSearch,
+ * DBSCAN or KDE) share one tree build instead of each building (and owning)
+ * its own.  The trees are keyed on the identity of the dataset (its address
+ * and its size), the type of the tree and the leaf size.
+ *
+ * The algorithms use different statistic types in the nodes of their trees.
+ * For trees that support it (every BinarySpaceTree, such as the kd-tree and
+ * the ball tree), the structure of the tree is built once, and the first
+ * request for a tree with a given statistic type copies the structure and
+ * computes the statistics, which takes linear time; later requests for the
+ * same tree type get the same tree.  Other trees are built once for each
+ * statistic type.
+ *
+ * The trees are given as reference-counted handles (std::shared_ptr), so a
+ * tree stays valid as long as a handle to it exists, even if it is dropped
+ * from the cache.  The algorithms take the tree without copying it or taking
+ * ownership of it:
+ *
+ * @code
+ * extern arma::mat data;
+ * TreeCache cache;
+ * std::vector<size_t> oldFromNew;
+ *
+ * typedef neighbor::KNN::Tree KNNTree;
+ * std::shared_ptr<KNNTree> knnTree = cache.Get<KNNTree>(data, oldFromNew);
+ * neighbor::KNN knn;
+ * knn.Train(knnTree.get(), oldFromNew);
+ *
+ * typedef range::RangeSearch<>::Tree RSTree;
+ * std::shared_ptr<RSTree> rsTree = cache.Get<RSTree>(data, oldFromNew);
+ * range::RangeSearch<> rs;
+ * rs.Train(rsTree.get(), oldFromNew);
+ * @endcode
+ *
+ * Each cached tree holds its own copy of the dataset.  The cache does not look
+ * at the contents of the dataset: if it is modified (or destroyed and another
+ * one is created at the same address), the trees built on it must be dropped
+ * with Erase() first.  The cache is not thread-safe.
+ */
+class TreeCache
+{
+ public:
+  /**
+   * Get a tree of type TreeType built on the given dataset, building it if it
+   * is not in the cache yet.
+   *
+   * @param dataset Dataset the tree is built on.
+   * @param oldFromNew Vector to store the mapping of the points of the tree's
+   *     dataset to the points of the given dataset (empty if the tree does not
+   *     rearrange the dataset).
+   * @param leafSize Maximum leaf size of the tree (only used for trees that
+   *     rearrange the dataset, like BinarySpaceTree and Octree).
+   * @return A handle to the tree.
+   */
+  template<typename TreeType>
+  std::shared_ptr<TreeType> Get(const typename TreeType::Mat& dataset,
+                                std::vector<size_t>& oldFromNew,
+                                const size_t leafSize = 20);
+
+  /**
+   * Drop all the trees built on the given dataset from the cache.  Handles to
+   * these trees stay valid.
+   *
+   * @param dataset Dataset whose trees should be dropped.
+   */
+  template<typename MatType>
+  void Erase(const MatType& dataset);
+
+  //! Drop all the trees from the cache.  Handles to the trees stay valid.
+  void Clear() { entries.clear(); }
+
+  //! Get the number of tree structures in the cache.
+  size_t Size() const { return entries.size(); }
+
+ private:
+  //! The key of a tree structure: the address and the size of the dataset, the
+  //! leaf size and the type of the structure.
+  typedef std::tuple<const void*, size_t, size_t, size_t, std::type_index>
+      Key;
+
+  //! The trees built on one structure.
+  struct Entry
+  {
+    //! The mapping of the points of the trees' datasets to the dataset.
+    std::vector<size_t> oldFromNew;
+    //! The tree holding the structure.
+    std::shared_ptr<void> structure;
+    //! The trees with each statistic type, keyed on their type.
+    std::map<std::type_index, std::shared_ptr<void>> trees;
+  };
+
+  //! Build a tree that rearranges the dataset.
+  template<typename TreeType>
+  static TreeType* BuildTree(
+      const typename TreeType::Mat& dataset,
+      std::vector<size_t>& oldFromNew,
+      const size_t leafSize,
+      const typename std::enable_if_t<
+          TreeTraits<TreeType>::RearrangesDataset>* = 0);
+
+  //! Build a tree that does not rearrange the dataset.
+  template<typename TreeType>
+  static TreeType* BuildTree(
+      const typename TreeType::Mat& dataset,
+      std::vector<size_t>& oldFromNew,
+      const size_t leafSize,
+      const typename std::enable_if_t<
+          !TreeTraits<TreeType>::RearrangesDataset>* = 0);
+
+  //! The tree has the type of the structure: use the structure itself.
+  template<typename TreeType, typename StructureType>
+  static std::shared_ptr<void> Convert(
+      const std::shared_ptr<StructureType>& structure,
+      const typename std::enable_if_t<
+          std::is_same<TreeType, StructureType>::value>* = 0)
+  {
+    return structure;
+  }
+
+  //! Copy the structure to a tree with another statistic type.
+  template<typename TreeType, typename StructureType>
+  static std::shared_ptr<void> Convert(
+      const std::shared_ptr<StructureType>& structure,
+      const typename std::enable_if_t<
+          !std::is_same<TreeType, StructureType>::value>* = 0)
+  {
+    return std::make_shared<TreeType>(*structure);
+  }
+
+  //! The cached trees.
+  std::map<Key, Entry> entries;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "tree_cache_impl.hpp"
+
+#endif
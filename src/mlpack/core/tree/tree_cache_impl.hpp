@@ -0,0 +1,94 @@
+/**
+ * @file core/tree/tree_cache_impl.hpp
+ *
+ * Implementation of TreeCache.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TREE_CACHE_IMPL_HPP
+#define MLPACK_CORE_TREE_TREE_CACHE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "tree_cache.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+std::shared_ptr<TreeType> TreeCache::Get(
+    const typename TreeType::Mat& dataset,
+    std::vector<size_t>& oldFromNew,
+    const size_t leafSize)
+{
+  typedef typename TreeStructure<TreeType>::Type StructureType;
+
+  // The leaf size does not matter for trees that do not rearrange the dataset.
+  const Key key(&dataset, dataset.n_rows, dataset.n_cols,
+      TreeTraits<StructureType>::RearrangesDataset ? leafSize : 0,
+      std::type_index(typeid(StructureType)));
+
+  typename std::map<Key, Entry>::iterator it = entries.find(key);
+  if (it == entries.end())
+  {
+    // Build the tree before adding the entry, in case it throws.
+    Entry entry;
+    entry.structure.reset(BuildTree<StructureType>(dataset, entry.oldFromNew,
+        leafSize));
+    it = entries.insert(std::make_pair(key, std::move(entry))).first;
+  }
+
+  Entry& entry = it->second;
+  std::shared_ptr<void>& tree = entry.trees[std::type_index(typeid(TreeType))];
+  if (!tree)
+  {
+    tree = Convert<TreeType>(
+        std::static_pointer_cast<StructureType>(entry.structure));
+  }
+
+  oldFromNew = entry.oldFromNew;
+  return std::static_pointer_cast<TreeType>(tree);
+}
+
+template<typename MatType>
+void TreeCache::Erase(const MatType& dataset)
+{
+  typename std::map<Key, Entry>::iterator it = entries.begin();
+  while (it != entries.end())
+  {
+    if (std::get<0>(it->first) == (const void*) &dataset)
+      it = entries.erase(it);
+    else
+      ++it;
+  }
+}
+
+template<typename TreeType>
+TreeType* TreeCache::BuildTree(
+    const typename TreeType::Mat& dataset,
+    std::vector<size_t>& oldFromNew,
+    const size_t leafSize,
+    const typename std::enable_if_t<
+        TreeTraits<TreeType>::RearrangesDataset>*)
+{
+  return new TreeType(dataset, oldFromNew, leafSize);
+}
+
+template<typename TreeType>
+TreeType* TreeCache::BuildTree(
+    const typename TreeType::Mat& dataset,
+    std::vector<size_t>& oldFromNew,
+    const size_t /* leafSize */,
+    const typename std::enable_if_t<
+        !TreeTraits<TreeType>::RearrangesDataset>*)
+{
+  oldFromNew.clear();
+  return new TreeType(dataset);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
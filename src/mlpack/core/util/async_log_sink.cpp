@@ -0,0 +1,142 @@
+/**
+ * @file core/util/async_log_sink.cpp
+ *
+ * Implementation of the AsyncLogSink class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "async_log_sink.hpp"
+
+#include <chrono>
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+AsyncLogSink::AsyncLogSink() :
+    pendingSize(0),
+    writing(false),
+    flushRequested(false),
+    running(false),
+    stopping(false),
+    flushInterval(100),
+    capacity(1 << 20)
+{
+  /* Nothing to do. */
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+  Stop();
+}
+
+void AsyncLogSink::Start(const size_t flushInterval, const size_t capacity)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (running)
+    return;
+
+  this->flushInterval = flushInterval;
+  this->capacity = capacity;
+  running = true;
+  stopping = false;
+  thread = std::thread(&AsyncLogSink::Run, this);
+}
+
+void AsyncLogSink::Stop()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!running || stopping)
+      return;
+
+    stopping = true;
+  }
+
+  wakeUp.notify_all();
+  thread.join();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  running = false;
+  stopping = false;
+}
+
+bool AsyncLogSink::Running() const
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  return running;
+}
+
+void AsyncLogSink::Write(std::ostream& destination, const std::string& text)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!running)
+  {
+    // Keep the text in order with what the background thread wrote last.
+    written.wait(lock, [this]() { return pending.empty() && !writing; });
+    destination.write(text.data(), text.size());
+    if (text.find('\n') != std::string::npos)
+      destination.flush();
+    return;
+  }
+
+  // Wait for the background thread if the buffer is full.
+  if (pendingSize >= capacity)
+  {
+    wakeUp.notify_all();
+    written.wait(lock, [this]() { return pendingSize < capacity; });
+  }
+
+  if (pending.empty() || pending.back().first != &destination)
+    pending.push_back(std::make_pair(&destination, std::string()));
+  pending.back().second += text;
+  pendingSize += text.size();
+}
+
+void AsyncLogSink::Flush()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (pending.empty() && !writing)
+    return;
+
+  flushRequested = true;
+  wakeUp.notify_all();
+  written.wait(lock, [this]() { return pending.empty() && !writing; });
+}
+
+void AsyncLogSink::Run()
+{
+  std::vector<std::pair<std::ostream*, std::string>> batch;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    wakeUp.wait_for(lock, std::chrono::milliseconds(flushInterval), [this]()
+        { return stopping || flushRequested || pendingSize >= capacity; });
+
+    batch.swap(pending);
+    pendingSize = 0;
+    flushRequested = false;
+    writing = true;
+    const bool finish = stopping;
+    lock.unlock();
+
+    // Let the writers that waited for room go on while the text is written.
+    written.notify_all();
+
+    for (size_t i = 0; i < batch.size(); ++i)
+      batch[i].first->write(batch[i].second.data(), batch[i].second.size());
+    for (size_t i = 0; i < batch.size(); ++i)
+      batch[i].first->flush();
+    batch.clear();
+
+    lock.lock();
+    writing = false;
+    written.notify_all();
+
+    // Stop() only returns once everything given before it was written.
+    if (finish && pending.empty())
+      break;
+  }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file core/util/async_log_sink.hpp
+ *
+ * Definition of the AsyncLogSink class, which writes the output of the Log
+ * streams on a background thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_ASYNC_LOG_SINK_HPP
+#define MLPACK_CORE_UTIL_ASYNC_LOG_SINK_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The AsyncLogSink buffers the text written by PrefixedOutStream objects and
+ * writes it to their destination streams on a background thread, so that a
+ * program that logs a lot (for instance once per iteration of an optimizer)
+ * only pays for formatting the text, and not for writing and flushing the
+ * destination stream.  The buffer is written every flushInterval milliseconds,
+ * or as soon as it holds capacity bytes; writers then wait for the background
+ * thread, so the buffer never grows beyond capacity (plus one message).  The
+ * text of all destinations is written in the order it was given.
+ *
+ * Until Start() is called (and after Stop()), the sink writes the text
+ * directly to the destination, as if there was no sink.
+ *
+ * The mlpack::Log streams share the sink Log::Sink:
+ *
+ * @code
+ * Log::Sink.Start();
+ * // ... the output of Log::Info, Log::Warn, Log::Debug is written in the
+ * // background ...
+ * Log::Sink.Flush(); // Before writing directly to std::cout, for instance.
+ * @endcode
+ *
+ * Log::Fatal flushes the sink before it throws, and the sink is flushed when
+ * it is destroyed at the end of the program; output that has not been written
+ * yet is only lost if the program is killed or aborted.
+ */
+class AsyncLogSink
+{
+ public:
+  //! Create the sink; it writes the text directly until Start() is called.
+  AsyncLogSink();
+
+  //! Stop the background thread, after writing all the text.
+  ~AsyncLogSink();
+
+  //! An AsyncLogSink cannot be copied.
+  AsyncLogSink(const AsyncLogSink& other) = delete;
+  //! An AsyncLogSink cannot be copied.
+  AsyncLogSink& operator=(const AsyncLogSink& other) = delete;
+
+  /**
+   * Start the background thread.  Does nothing if it is already running.
+   *
+   * @param flushInterval Number of milliseconds between two writes of the
+   *     buffer.
+   * @param capacity Number of bytes of the buffer; the buffer is written as
+   *     soon as it is full.
+   */
+  void Start(const size_t flushInterval = 100,
+             const size_t capacity = 1 << 20);
+
+  /**
+   * Write all the buffered text and stop the background thread; the text is
+   * then written directly again.  Does nothing if the thread is not running.
+   */
+  void Stop();
+
+  //! Get whether the background thread is running.
+  bool Running() const;
+
+  /**
+   * Add the given text to the buffer, to be written to the given stream (or
+   * write it directly if the background thread is not running).
+   *
+   * @param destination Stream to write the text to.
+   * @param text Text to write.
+   */
+  void Write(std::ostream& destination, const std::string& text);
+
+  //! Wait until all the text given so far has been written and flushed.
+  void Flush();
+
+ private:
+  //! The loop of the background thread.
+  void Run();
+
+  //! The text waiting to be written, by destination.
+  std::vector<std::pair<std::ostream*, std::string>> pending;
+  //! The number of bytes of pending.
+  size_t pendingSize;
+  //! Whether the background thread is writing text taken from pending.
+  bool writing;
+  //! Whether Flush() is waiting for the background thread.
+  bool flushRequested;
+
+  //! Whether the background thread is running.
+  bool running;
+  //! Whether Stop() asked the background thread to finish.
+  bool stopping;
+  //! The number of milliseconds between two writes.
+  size_t flushInterval;
+  //! The number of bytes of text after which the buffer is written.
+  size_t capacity;
+
+  //! The mutex protecting all the members.
+  mutable std::mutex mutex;
+  //! Wakes the background thread up before the end of the interval.
+  std::condition_variable wakeUp;
+  //! Signals the writers that the buffer was written.
+  std::condition_variable written;
+  //! The background thread.
+  std::thread thread;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
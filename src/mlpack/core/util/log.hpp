@@ -51,7 +51,12 @@ namespace mlpack {
  * mode.  Messages to Log::Info will only be shown when the --verbose flag is
  * given to the program (or rather, the IO class).
  *
- * @see PrefixedOutStream, NullOutStream, IO
+ * By default, the messages are written to the console as they are given.  A
+ * program that logs a lot can have them written on a background thread
+ * instead, with Log::Sink.Start(); Log::Sink.Flush() waits until everything
+ * was written.
+ *
+ * @see PrefixedOutStream, NullOutStream, AsyncLogSink, IO
  */
 class Log
 {
@@ -89,6 +94,10 @@ class Log
   //! Prints fatal messages prefixed with [FATAL], then terminates the program.
   static MLPACK_EXPORT util::PrefixedOutStream Fatal;
 
+  //! Writes the output of the other streams on a background thread, once
+  //! started.
+  static MLPACK_EXPORT util::AsyncLogSink Sink;
+
   //! Reference to cout, if necessary.
   static std::ostream& cout;
 };
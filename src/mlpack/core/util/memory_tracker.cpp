@@ -0,0 +1,182 @@
+/**
+ * @file core/util/memory_tracker.cpp
+ *
+ * Implementation of the MemoryTracker class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "memory_tracker.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_MSC_VER)
+  #include <malloc.h>
+#endif
+
+using namespace mlpack;
+using namespace std;
+
+namespace {
+
+//! The counts of the tracker.
+struct TrackerState
+{
+  TrackerState() : current(0), peak(0) { }
+
+  //! A mutex for modifying the counts.
+  mutex stateMutex;
+  //! The size of each block allocated with Allocate().
+  unordered_map<const void*, size_t> sizes;
+  //! The number of bytes in use.
+  size_t current;
+  //! The peak of the number of bytes in use.
+  size_t peak;
+  //! The peak of each open scope.
+  vector<size_t> scopePeaks;
+  //! Whether or not each slot of scopePeaks is used.
+  vector<bool> scopeUsed;
+};
+
+// Armadillo frees the memory of global matrices after main() returns, so the
+// state is never destroyed.
+TrackerState& State()
+{
+  static TrackerState* state = new TrackerState();
+  return *state;
+}
+
+// Add bytes to the count (the mutex must be held).
+void Add(TrackerState& s, const size_t bytes)
+{
+  s.current += bytes;
+  s.peak = std::max(s.peak, s.current);
+  for (size_t i = 0; i < s.scopePeaks.size(); ++i)
+  {
+    if (s.scopeUsed[i])
+      s.scopePeaks[i] = std::max(s.scopePeaks[i], s.current);
+  }
+}
+
+// Remove bytes from the count (the mutex must be held).
+void Remove(TrackerState& s, const size_t bytes)
+{
+  // Don't wrap around if more is released than was recorded.
+  s.current -= std::min(s.current, bytes);
+}
+
+} // namespace
+
+void* MemoryTracker::Allocate(const size_t bytes)
+{
+  // Use the same alignment as Armadillo's allocator.
+  const size_t alignment = (bytes >= 1024) ? 32 : 16;
+
+  void* memory = NULL;
+  #if defined(_MSC_VER)
+    memory = _aligned_malloc(bytes, alignment);
+  #else
+    if (posix_memalign(&memory, alignment, bytes) != 0)
+      memory = NULL;
+  #endif
+
+  if (memory == NULL)
+    return NULL;
+
+  TrackerState& s = State();
+  lock_guard<mutex> lock(s.stateMutex);
+  s.sizes[memory] = bytes;
+  Add(s, bytes);
+  return memory;
+}
+
+void MemoryTracker::Free(void* memory)
+{
+  if (memory == NULL)
+    return;
+
+  {
+    TrackerState& s = State();
+    lock_guard<mutex> lock(s.stateMutex);
+    unordered_map<const void*, size_t>::iterator it = s.sizes.find(memory);
+    if (it != s.sizes.end())
+    {
+      Remove(s, it->second);
+      s.sizes.erase(it);
+    }
+  }
+
+  #if defined(_MSC_VER)
+    _aligned_free(memory);
+  #else
+    free(memory);
+  #endif
+}
+
+void MemoryTracker::Record(const size_t bytes)
+{
+  TrackerState& s = State();
+  lock_guard<mutex> lock(s.stateMutex);
+  Add(s, bytes);
+}
+
+void MemoryTracker::Release(const size_t bytes)
+{
+  TrackerState& s = State();
+  lock_guard<mutex> lock(s.stateMutex);
+  Remove(s, bytes);
+}
+
+size_t MemoryTracker::Current()
+{
+  TrackerState& s = State();
+  lock_guard<mutex> lock(s.stateMutex);
+  return s.current;
+}
+
+size_t MemoryTracker::Peak()
+{
+  TrackerState& s = State();
+  lock_guard<mutex> lock(s.stateMutex);
+  return s.peak;
+}
+
+size_t MemoryTracker::BeginScope()
+{
+  TrackerState& s = State();
+  lock_guard<mutex> lock(s.stateMutex);
+
+  // Reuse a free slot if there is one; there are only as many slots as there
+  // are timers running at the same time.
+  const size_t scope = std::find(s.scopeUsed.begin(), s.scopeUsed.end(),
+      false) - s.scopeUsed.begin();
+  if (scope == s.scopeUsed.size())
+  {
+    s.scopeUsed.push_back(true);
+    s.scopePeaks.push_back(s.current);
+  }
+  else
+  {
+    s.scopeUsed[scope] = true;
+    s.scopePeaks[scope] = s.current;
+  }
+
+  return scope;
+}
+
+size_t MemoryTracker::EndScope(const size_t scope)
+{
+  TrackerState& s = State();
+  lock_guard<mutex> lock(s.stateMutex);
+  if (scope >= s.scopeUsed.size() || !s.scopeUsed[scope])
+    return 0;
+
+  s.scopeUsed[scope] = false;
+  return s.scopePeaks[scope];
+}
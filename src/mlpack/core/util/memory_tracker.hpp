@@ -0,0 +1,127 @@
+/**
+ * @file core/util/memory_tracker.hpp
+ *
+ * Tracking of the memory allocated by Armadillo and by the trees, so that the
+ * timers can report the memory used by each phase of a method.
+ *
+ * This file is included before Armadillo (see arma_extend.hpp), so it must
+ * only depend on the standard library.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_MEMORY_TRACKER_HPP
+#define MLPACK_CORE_UTIL_MEMORY_TRACKER_HPP
+
+#include <cstddef>
+#include <new>
+
+namespace mlpack {
+
+/**
+ * MemoryTracker counts the bytes in use by the memory allocations it is told
+ * about, and the peak of that count.  It is only fed when mlpack is built with
+ * the TRACK_MEMORY CMake option (which defines MLPACK_TRACK_MEMORY):
+ *
+ *  - Armadillo allocates the memory of its matrices with Allocate() and
+ *    frees it with Free() (through ARMA_ALIEN_MEM_ALLOC_FUNCTION and
+ *    ARMA_ALIEN_MEM_FREE_FUNCTION, set in arma_extend.hpp).
+ *  - The nodes of the trees are allocated with class-specific new and delete
+ *    operators (see MLPACK_TRACK_ALLOCATIONS) which call Record() and
+ *    Release().
+ *
+ * Each run of a timer opens a scope with BeginScope() and closes it with
+ * EndScope(), which gives the peak of the memory in use during the run; the
+ * timers report it along with the durations (see Timers::WriteJSON() and the
+ * --verbose option of the command-line programs).  Scopes may overlap freely,
+ * in one or several threads, but the count is for the whole process.
+ *
+ * All the counts are updated under one mutex, so memory tracking slows down
+ * programs that allocate a lot of small matrices; it is meant for finding
+ * which phase of a method uses the most memory, not for production builds.
+ * Memory allocated by code compiled without MLPACK_TRACK_MEMORY is not
+ * counted, but can still be freed by code compiled with it.
+ */
+class MemoryTracker
+{
+ public:
+  /**
+   * Allocate the given number of bytes, aligned for Armadillo, and count them.
+   * The memory must be freed with Free().  Returns NULL if the allocation
+   * fails.
+   *
+   * @param bytes Number of bytes to allocate.
+   */
+  static void* Allocate(const size_t bytes);
+
+  /**
+   * Free the given memory, allocated with Allocate() or (if it was not
+   * counted) with Armadillo's default allocator.
+   *
+   * @param memory Memory to free.
+   */
+  static void Free(void* memory);
+
+  /**
+   * Count the given number of bytes, allocated by other means.
+   *
+   * @param bytes Number of bytes allocated.
+   */
+  static void Record(const size_t bytes);
+
+  /**
+   * Stop counting the given number of bytes, counted with Record().
+   *
+   * @param bytes Number of bytes freed.
+   */
+  static void Release(const size_t bytes);
+
+  //! Get the number of bytes in use.
+  static size_t Current();
+
+  //! Get the peak of the number of bytes in use.
+  static size_t Peak();
+
+  /**
+   * Open a scope, whose peak starts at the current number of bytes in use.
+   * Returns an identifier to give to EndScope().
+   */
+  static size_t BeginScope();
+
+  /**
+   * Close the given scope, and return the peak of the number of bytes in use
+   * since it was opened.
+   *
+   * @param scope Identifier of the scope, returned by BeginScope().
+   */
+  static size_t EndScope(const size_t scope);
+};
+
+} // namespace mlpack
+
+/**
+ * Declare class-specific new and delete operators that count the memory of
+ * the objects of the class with MemoryTracker, if mlpack is built with the
+ * TRACK_MEMORY CMake option; otherwise, nothing is declared.  Objects created
+ * with placement new must use the global form (::new).
+ */
+#ifdef MLPACK_TRACK_MEMORY
+  #define MLPACK_TRACK_ALLOCATIONS \
+    static void* operator new(std::size_t bytes) \
+    { \
+      void* object = ::operator new(bytes); \
+      mlpack::MemoryTracker::Record(bytes); \
+      return object; \
+    } \
+    static void operator delete(void* object, std::size_t bytes) \
+    { \
+      mlpack::MemoryTracker::Release(bytes); \
+      ::operator delete(object); \
+    }
+#else
+  #define MLPACK_TRACK_ALLOCATIONS
+#endif
+
+#endif
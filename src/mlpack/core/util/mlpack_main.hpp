@@ -91,6 +91,7 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/run_server.hpp>
 
 static void mlpackMain(); // This is typically defined after this include.
 
@@ -98,6 +99,14 @@ int main(int argc, char** argv)
 {
   // Parse the command-line options; put them into CLI.
   mlpack::bindings::cli::ParseCommandLine(argc, argv);
+
+  // In server mode, run the program once for each request instead.
+  if (mlpack::IO::HasParam("server"))
+  {
+    mlpack::bindings::cli::RunServer(&mlpackMain);
+    return 0;
+  }
+
   // Enable timing.
   mlpack::Timer::EnableTiming();
 
@@ -230,6 +239,8 @@ PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
     " copied before the method is run.  This is useful for debugging problems "
     "where the input parameters are being modified by the algorithm, but can "
     "slow down the code.", "");
+PARAM_INT_IN("n_threads", "Number of OpenMP threads to use for this call; if "
+    "0, the default number of threads is used.", "", 0);
 
 // Nothing else needs to be defined---the binding will use mlpackMain() as-is.
 
@@ -479,12 +490,18 @@ PARAM_FLAG("verbose", "Display informational messages and the full list of "
 PARAM_FLAG("help", "Default help info.", "h");
 PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_FLAG("server", "Run as a server: read one request per line of standard "
+    "input, with options given as on the command line, and answer each with a "
+    "line containing 'OK' or an error.  Input models given on the command line "
+    "are only loaded once.", "");
 
 // Python-specific parameters.
 PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
     " copied before the method is run.  This is useful for debugging problems "
     "where the input parameters are being modified by the algorithm, but can "
     "slow down the code.", "");
+PARAM_INT_IN("n_threads", "Number of OpenMP threads to use for this call; if "
+    "0, the default number of threads is used.", "", 0);
 
 #else
 
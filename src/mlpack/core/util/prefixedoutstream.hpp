@@ -15,6 +15,10 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <sstream>
+
+#include "async_log_sink.hpp"
+
 namespace mlpack {
 namespace util {
 
@@ -42,6 +46,20 @@ namespace util {
  *
  * These objects are used for the mlpack::Log levels (DEBUG, INFO, WARN, and
  * FATAL).
+ *
+ * The text of each call to operator<< is formatted first, with the flags,
+ * precision, width and fill of the destination, and then written at once,
+ * either directly or through an AsyncLogSink, which writes it on a background
+ * thread; stream manipulators only change the formatting state of the
+ * destination (or flush it, through the sink).  A stream that ignores its
+ * input (and is not fatal) only formats text, characters and manipulators, to
+ * know where its lines end, so disabled log levels cost little; arguments
+ * that are expensive to compute should still be guarded, as in
+ *
+ * @code
+ * if (!Log::Info.ignoreInput)
+ *   Log::Info << "Objective: " << ExpensiveObjective() << "." << std::endl;
+ * @endcode
  */
 class PrefixedOutStream
 {
@@ -56,15 +74,18 @@ class PrefixedOutStream
    *     printing a newline.
    * @param backtrace If true, attempt to print a backtrace (will only be
    *     done if HAS_BFD_DL is defined).
+   * @param sink If not NULL, the output is written through this sink.
    */
   PrefixedOutStream(std::ostream& destination,
                     const char* prefix,
                     bool ignoreInput = false,
                     bool fatal = false,
-                    bool backtrace = true) :
+                    bool backtrace = true,
+                    AsyncLogSink* sink = NULL) :
       destination(destination),
       ignoreInput(ignoreInput),
       backtrace(backtrace),
+      sink(sink),
       prefix(prefix),
       // We want the first call to operator<< to prefix the prefix so we set
       // carriageReturned to true.
@@ -122,6 +143,9 @@ class PrefixedOutStream
   //! defined.
   bool backtrace;
 
+  //! The sink the output is written through, if not NULL.
+  AsyncLogSink* sink;
+
  private:
   /**
    * Conducts the base logic required in all the operator << overloads.  Mostly
@@ -152,9 +176,42 @@ class PrefixedOutStream
   BaseLogic(const T& val);
 
   /**
-   * Output the prefix, but only if we need to and if we are allowed to.
+   * Track whether the given value, which is not printed, ends a line, so that
+   * the prefix is still written when the stream stops ignoring its input.
+   * Text, characters and manipulators are formatted to know it; other values
+   * (numbers, for instance) are assumed not to end a line.
+   *
+   * @tparam T The type of the data that is ignored.
+   * @param val The data that is ignored.
+   */
+  template<typename T>
+  void IgnoreLogic(const T& val);
+
+  /**
+   * Apply the formatting state of the given stream, to which a manipulator was
+   * written, to the destination, and flush the destination if the manipulator
+   * was std::flush.  Nothing is written to the destination directly while the
+   * sink may be writing to it.
+   *
+   * @param convert The stream the manipulator was written to.
+   * @param flush Whether to flush the destination.
+   */
+  inline void Manipulate(const std::ostringstream& convert, const bool flush);
+
+  /**
+   * Add the prefix to the given text, but only if we need to.
+   */
+  inline void PrefixIfNeeded(std::string& text);
+
+  /**
+   * Write the given text to the destination (or to the sink), unless the
+   * input is ignored.
+   *
+   * @param text The text to write.
+   * @param newlined Whether the text holds a newline, after which the
+   *     destination is flushed.
    */
-  inline void PrefixIfNeeded();
+  inline void Write(const std::string& text, const bool newlined);
 
   //! Contains the prefix we must prepend to each line.
   std::string prefix;
@@ -38,41 +38,55 @@ template<typename T>
 typename std::enable_if<!arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // Nothing is printed, so unless we have to terminate after a newline, there
+  // is no need to format anything but what may end a line.
+  if (ignoreInput && !fatal)
+  {
+    IgnoreLogic(val);
+    return;
+  }
+
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
   std::string line;
+  // The output of this call, written at once at the end.
+  std::string text;
 
   // If we need to, output the prefix.
-  PrefixIfNeeded();
+  PrefixIfNeeded(text);
 
   std::ostringstream convert;
-  // Sync flags and precision with destination stream
-  convert.setf(destination.flags());
+  // Sync flags, precision, width and fill with destination stream.  The width
+  // only applies to the next output, so it is reset on the destination.
+  convert.flags(destination.flags());
   convert.precision(destination.precision());
+  convert.fill(destination.fill());
+  convert.width(destination.width());
+  destination.width(0);
   convert << val;
 
   if (convert.fail())
   {
-    PrefixIfNeeded();
-    if (!ignoreInput)
-    {
-      destination << "Failed type conversion to string for output; output not "
-          "shown." << std::endl;
-      newlined = true;
-    }
+    PrefixIfNeeded(text);
+    text += "Failed type conversion to string for output; output not shown.\n";
+    newlined = true;
   }
   else
   {
     line = convert.str();
 
     // If the length of the casted thing was 0, it may have been a stream
-    // manipulator, so send it directly to the stream and don't ask questions.
+    // manipulator, so give its formatting state to the destination.
     if (line.length() == 0)
     {
       // The prefix cannot be necessary at this point.
+      Write(text, false);
       if (!ignoreInput) // Only if the user wants it.
-        destination << val;
+      {
+        Manipulate(convert,
+            std::is_same<T, std::ostream& (*)(std::ostream&)>::value);
+      }
 
       return;
     }
@@ -82,14 +96,9 @@ PrefixedOutStream::BaseLogic(const T& val)
     size_t pos = 0;
     while ((nl = line.find('\n', pos)) != std::string::npos)
     {
-      PrefixIfNeeded();
-
-      // Only output if the user wants it.
-      if (!ignoreInput)
-      {
-        destination << line.substr(pos, nl - pos);
-        destination << std::endl;
-      }
+      PrefixIfNeeded(text);
+      text.append(line, pos, nl - pos);
+      text += '\n';
 
       newlined = true; // Ensure this is set for the fatal exception if needed.
       carriageReturned = true; // Regardless of whether or not we display it.
@@ -99,17 +108,15 @@ PrefixedOutStream::BaseLogic(const T& val)
 
     if (pos != line.length()) // We need to display the rest.
     {
-      PrefixIfNeeded();
-      if (!ignoreInput)
-        destination << line.substr(pos);
+      PrefixIfNeeded(text);
+      text.append(line, pos, std::string::npos);
     }
   }
 
   // If we displayed a newline and we need to throw afterwards, do that.
   if (fatal && newlined)
   {
-    if (!ignoreInput)
-      destination << std::endl;
+    text += '\n';
 
     // Print a backtrace, if we can.
 #ifdef HAS_BFD_DL
@@ -122,13 +129,9 @@ PrefixedOutStream::BaseLogic(const T& val)
       std::string btLine = bt.ToString();
       while ((nl = btLine.find('\n', pos)) != std::string::npos)
       {
-        PrefixIfNeeded();
-
-        if (!ignoreInput)
-        {
-          destination << btLine.substr(pos, nl - pos);
-          destination << std::endl;
-        }
+        PrefixIfNeeded(text);
+        text.append(btLine, pos, nl - pos);
+        text += '\n';
 
         carriageReturned = true; // Regardless of whether or not we display it.
 
@@ -137,8 +140,15 @@ PrefixedOutStream::BaseLogic(const T& val)
     }
 #endif
 
+    // Everything logged so far has to be written before terminating.
+    Write(text, true);
+    if (sink)
+      sink->Flush();
+
     throw std::runtime_error("fatal error; see Log::Fatal output");
   }
+
+  Write(text, newlined);
 }
 
 // For Armadillo types.
@@ -146,6 +156,14 @@ template<typename T>
 typename std::enable_if<arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // Nothing is printed, so unless we have to terminate after a newline, there
+  // is no need to format anything; Armadillo objects always end a line.
+  if (ignoreInput && !fatal)
+  {
+    carriageReturned = true;
+    return;
+  }
+
   // Extract printable object from the input.
   const arma::Mat<typename T::elem_type>& printVal(val);
 
@@ -153,9 +171,11 @@ PrefixedOutStream::BaseLogic(const T& val)
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
   std::string line;
+  // The output of this call, written at once at the end.
+  std::string text;
 
   // If we need to, output the prefix.
-  PrefixIfNeeded();
+  PrefixIfNeeded(text);
 
   std::ostringstream convert;
 
@@ -187,26 +207,20 @@ PrefixedOutStream::BaseLogic(const T& val)
 
   if (convert.fail())
   {
-    PrefixIfNeeded();
-    if (!ignoreInput)
-    {
-      destination << "Failed type conversion to string for output; output not "
-          "shown." << std::endl;
-      newlined = true;
-    }
+    PrefixIfNeeded(text);
+    text += "Failed type conversion to string for output; output not shown.\n";
+    newlined = true;
   }
   else
   {
     line = convert.str();
 
-    // If the length of the casted thing was 0, it may have been a stream
-    // manipulator, so send it directly to the stream and don't ask questions.
+    // An Armadillo object is not a stream manipulator, so there is nothing
+    // else to write.
     if (line.length() == 0)
     {
       // The prefix cannot be necessary at this point.
-      if (!ignoreInput) // Only if the user wants it.
-        destination << val;
-
+      Write(text, false);
       return;
     }
 
@@ -215,14 +229,9 @@ PrefixedOutStream::BaseLogic(const T& val)
     size_t pos = 0;
     while ((nl = line.find('\n', pos)) != std::string::npos)
     {
-      PrefixIfNeeded();
-
-      // Only output if the user wants it.
-      if (!ignoreInput)
-      {
-        destination << line.substr(pos, nl - pos);
-        destination << std::endl;
-      }
+      PrefixIfNeeded(text);
+      text.append(line, pos, nl - pos);
+      text += '\n';
 
       newlined = true; // Ensure this is set for the fatal exception if needed.
       carriageReturned = true; // Regardless of whether or not we display it.
@@ -232,21 +241,19 @@ PrefixedOutStream::BaseLogic(const T& val)
 
     if (pos != line.length()) // We need to display the rest.
     {
-      PrefixIfNeeded();
-      if (!ignoreInput)
-        destination << line.substr(pos);
+      PrefixIfNeeded(text);
+      text.append(line, pos, std::string::npos);
     }
   }
 
   // If we displayed a newline and we need to throw afterwards, do that.
   if (fatal && newlined)
   {
-    if (!ignoreInput)
-      destination << std::endl;
+    text += '\n';
 
     // Print a backtrace, if we can.
 #ifdef HAS_BFD_DL
-    if (fatal && !ignoreInput)
+    if (fatal && !ignoreInput && backtrace)
     {
       size_t nl;
       size_t pos = 0;
@@ -255,13 +262,9 @@ PrefixedOutStream::BaseLogic(const T& val)
       std::string btLine = bt.ToString();
       while ((nl = btLine.find('\n', pos)) != std::string::npos)
       {
-        PrefixIfNeeded();
-
-        if (!ignoreInput)
-        {
-          destination << btLine.substr(pos, nl - pos);
-          destination << std::endl;
-        }
+        PrefixIfNeeded(text);
+        text.append(btLine, pos, nl - pos);
+        text += '\n';
 
         carriageReturned = true; // Regardless of whether or not we display it.
 
@@ -270,23 +273,93 @@ PrefixedOutStream::BaseLogic(const T& val)
     }
 #endif
 
+    // Everything logged so far has to be written before terminating.
+    Write(text, true);
+    if (sink)
+      sink->Flush();
+
     throw std::runtime_error("fatal error; see Log::Fatal output");
   }
+
+  Write(text, newlined);
+}
+
+template<typename T>
+void PrefixedOutStream::IgnoreLogic(const T& val)
+{
+  // Text and manipulators are cheap to format (and a streambuf would be
+  // consumed).
+  const bool isText = std::is_convertible<const T&, std::string>::value ||
+      std::is_same<T, char>::value ||
+      (std::is_pointer<T>::value &&
+       std::is_function<typename std::remove_pointer<T>::type>::value);
+  if (!isText)
+  {
+    carriageReturned = false;
+    return;
+  }
+
+  std::ostringstream convert;
+  convert << val;
+  const std::string line = convert.str();
+  if (!line.empty())
+    carriageReturned = (line[line.length() - 1] == '\n');
 }
 
 // This is an inline function (that is why it is here and not in .cc).
-void PrefixedOutStream::PrefixIfNeeded()
+void PrefixedOutStream::Manipulate(const std::ostringstream& convert,
+                                   const bool flush)
+{
+  // The sink writes and flushes the destination on its own thread, which also
+  // reads its flags; the precision, fill and width are only used here.
+  if (sink && convert.flags() != destination.flags())
+    sink->Flush();
+
+  destination.flags(convert.flags());
+  destination.precision(convert.precision());
+  destination.fill(convert.fill());
+  destination.width(convert.width());
+
+  // Flushing goes through the sink too, if it is writing in the background.
+  if (flush)
+  {
+    if (sink && sink->Running())
+      sink->Flush();
+    else
+      destination.flush();
+  }
+}
+
+// This is an inline function (that is why it is here and not in .cc).
+void PrefixedOutStream::PrefixIfNeeded(std::string& text)
 {
   // If we need to, output a prefix.
   if (carriageReturned)
   {
-    if (!ignoreInput) // But only if we are allowed to.
-      destination << prefix;
-
+    text += prefix;
     carriageReturned = false; // Denote that the prefix has been displayed.
   }
 }
 
+// This is an inline function (that is why it is here and not in .cc).
+void PrefixedOutStream::Write(const std::string& text, const bool newlined)
+{
+  // Only output if the user wants it.
+  if (ignoreInput || text.empty())
+    return;
+
+  if (sink)
+  {
+    sink->Write(destination, text);
+  }
+  else
+  {
+    destination.write(text.data(), text.size());
+    if (newlined)
+      destination.flush();
+  }
+}
+
 } // namespace util
 } // namespace mlpack
 
@@ -31,16 +31,22 @@ using namespace mlpack::util;
   #define BASH_CLEAR ""
 #endif
 
+// The sink is defined first, so that it is destroyed (and flushed) after the
+// streams.
+AsyncLogSink Log::Sink;
+
 #ifdef DEBUG
 PrefixedOutStream Log::Debug = PrefixedOutStream(MLPACK_COUT_STREAM,
-    BASH_CYAN "[DEBUG] " BASH_CLEAR);
+    BASH_CYAN "[DEBUG] " BASH_CLEAR, false, false, true, &Log::Sink);
 #else
 NullOutStream Log::Debug = NullOutStream();
 #endif
 
 PrefixedOutStream Log::Info = PrefixedOutStream(MLPACK_COUT_STREAM,
-    BASH_GREEN "[INFO ] " BASH_CLEAR, true /* unless --verbose */, false);
+    BASH_GREEN "[INFO ] " BASH_CLEAR, true /* unless --verbose */, false, true,
+    &Log::Sink);
 PrefixedOutStream Log::Warn = PrefixedOutStream(MLPACK_COUT_STREAM,
-    BASH_YELLOW "[WARN ] " BASH_CLEAR, false, false);
+    BASH_YELLOW "[WARN ] " BASH_CLEAR, false, false, true, &Log::Sink);
 PrefixedOutStream Log::Fatal = PrefixedOutStream(MLPACK_CERR_STREAM,
-    BASH_RED "[FATAL] " BASH_CLEAR, false, true /* fatal */);
+    BASH_RED "[FATAL] " BASH_CLEAR, false, true /* fatal */, true,
+    &Log::Sink);
@@ -15,7 +15,11 @@
 #include "io.hpp"
 #include "log.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
 #include <map>
+#include <sstream>
 #include <string>
 
 using namespace mlpack;
@@ -64,18 +68,148 @@ void Timer::ResetAll()
   IO::GetSingleton().timer.Reset();
 }
 
+// Add a run to the statistics of a timer.
+void TimerStats::Add(const microseconds run, uint64_t& state)
+{
+  total += run;
+  ++count;
+  if (count == 1 || run < min)
+    min = run;
+  if (count == 1 || run > max)
+    max = run;
+
+  // Keep a uniform sample of the runs (reservoir sampling).
+  if (samples.size() < MaxSamples)
+  {
+    samples.push_back(run);
+  }
+  else
+  {
+    // xorshift64*.
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    const uint64_t j = (state * 2685821657736338717ULL) % count;
+    if (j < MaxSamples)
+      samples[j] = run;
+  }
+}
+
+// Add the memory used by a run to the statistics of a timer.
+void TimerStats::AddMemory(const size_t peak, const int64_t retained)
+{
+  peakBytes = std::max(peakBytes, peak);
+  retainedBytes += retained;
+}
+
+// Merge the statistics of a timer in another thread.
+void TimerStats::Merge(const TimerStats& other)
+{
+  if (other.count == 0)
+    return;
+
+  peakBytes = std::max(peakBytes, other.peakBytes);
+  retainedBytes += other.retainedBytes;
+
+  min = (count == 0) ? other.min : std::min(min, other.min);
+  max = (count == 0) ? other.max : std::max(max, other.max);
+  total += other.total;
+  count += other.count;
+  samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+}
+
+// Estimate a percentile of the runs, with the nearest-rank method.
+microseconds TimerStats::Percentile(const double p) const
+{
+  if (samples.empty())
+    return microseconds(0);
+
+  std::vector<microseconds> sorted(samples);
+  std::sort(sorted.begin(), sorted.end());
+  const size_t rank = (size_t) std::ceil(p / 100.0 * sorted.size());
+  return sorted[std::min(std::max(rank, (size_t) 1), sorted.size()) - 1];
+}
+
+// Each Timers object gets a unique identifier, so that the cache of each
+// thread cannot confuse a destroyed object with a new one at the same address.
+static std::atomic<size_t> timersCount(0);
+
+Timers::Timers() :
+    id(timersCount++),
+    generation(0),
+    epoch(high_resolution_clock::now()),
+    enabled(false),
+    tracing(false)
+{
+  // Nothing to do.
+}
+
+// Get the timers of a thread.  The current thread looks its own timers up in
+// a thread-local cache, so that the global mutex is not taken when timers are
+// started and stopped in hot loops.
+shared_ptr<Timers::ThreadTimers> Timers::GetThreadTimers(const thread::id& tid)
+{
+  struct CacheEntry
+  {
+    size_t generation;
+    shared_ptr<ThreadTimers> timers;
+  };
+  thread_local map<size_t, CacheEntry> cache;
+
+  const bool current = (tid == this_thread::get_id());
+  if (current)
+  {
+    map<size_t, CacheEntry>::const_iterator it = cache.find(id);
+    if (it != cache.end() && it->second.generation == generation)
+      return it->second.timers;
+  }
+
+  lock_guard<mutex> lock(timersMutex);
+  shared_ptr<ThreadTimers>& t = threadTimers[tid];
+  if (!t)
+  {
+    t = make_shared<ThreadTimers>();
+    t->index = threadTimers.size() - 1;
+    t->state = 0x9E3779B97F4A7C15ULL + t->index;
+  }
+
+  if (current)
+    cache[id] = CacheEntry { generation, t };
+
+  return t;
+}
+
 // Reset a Timers object.
 void Timers::Reset()
 {
   lock_guard<mutex> lock(timersMutex);
-  timers.clear();
-  timerStartTime.clear();
+#ifdef MLPACK_TRACK_MEMORY
+  // Close the memory scopes of the running timers, so that their slots can be
+  // reused.
+  for (auto& it : threadTimers)
+  {
+    lock_guard<mutex> threadLock(it.second->mutex);
+    for (auto& it2 : it.second->memoryScopes)
+      MemoryTracker::EndScope(it2.second.scope);
+  }
+#endif
+  threadTimers.clear();
+  ++generation;
+  epoch = high_resolution_clock::now();
 }
 
 map<string, microseconds> Timers::GetAllTimers()
 {
-  // Make a copy of the timer.
+  // Make a copy of the timers, summing over all threads.
   lock_guard<mutex> lock(timersMutex);
+  map<string, microseconds> timers;
+  for (auto& it : threadTimers)
+  {
+    lock_guard<mutex> threadLock(it.second->mutex);
+    for (auto& it2 : it.second->stats)
+      timers[it2.first] += it2.second.total;
+  }
+
   return timers;
 }
 
@@ -84,17 +218,49 @@ microseconds Timers::GetTimer(const string& timerName)
   if (!enabled)
     return microseconds(0);
 
+  return GetStats(timerName).total;
+}
+
+TimerStats Timers::GetStats(const string& timerName)
+{
+  lock_guard<mutex> lock(timersMutex);
+  TimerStats stats;
+  for (auto& it : threadTimers)
+  {
+    lock_guard<mutex> threadLock(it.second->mutex);
+    map<string, TimerStats>::const_iterator it2 =
+        it.second->stats.find(timerName);
+    if (it2 != it.second->stats.end())
+      stats.Merge(it2->second);
+  }
+
+  return stats;
+}
+
+map<string, TimerStats> Timers::GetPathStats()
+{
   lock_guard<mutex> lock(timersMutex);
-  return timers[timerName];
+  map<string, TimerStats> stats;
+  for (auto& it : threadTimers)
+  {
+    lock_guard<mutex> threadLock(it.second->mutex);
+    for (auto& it2 : it.second->pathStats)
+      stats[it2.first].Merge(it2.second);
+  }
+
+  return stats;
 }
 
 bool Timers::GetState(const string& timerName,
                       const thread::id& threadId)
 {
   lock_guard<mutex> lock(timersMutex);
-  if (timerStartTime.count(threadId) == 0)
+  if (threadTimers.count(threadId) == 0)
     return 0;
-  return (timerStartTime[threadId].count(timerName) > 0);
+
+  ThreadTimers& t = *threadTimers[threadId];
+  lock_guard<mutex> threadLock(t.mutex);
+  return (t.startTime.count(timerName) > 0);
 }
 
 void Timers::PrintTimer(const string& timerName)
@@ -157,19 +323,48 @@ void Timers::PrintTimer(const string& timerName)
   Log::Info << endl;
 }
 
+// Format a number of bytes with a binary unit.
+static string FormatBytes(const double bytes)
+{
+  const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+  double value = bytes;
+  size_t unit = 0;
+  while (std::abs(value) >= 1024 && unit < 4)
+  {
+    value /= 1024;
+    ++unit;
+  }
+
+  ostringstream oss;
+  if (unit == 0)
+    oss << (int64_t) value << " " << units[unit];
+  else
+    oss << fixed << setprecision(1) << value << " " << units[unit];
+  return oss.str();
+}
+
+void Timers::PrintMemory(const string& timerName)
+{
+  const TimerStats stats = GetStats(timerName);
+  Log::Info << FormatBytes((double) stats.peakBytes) << " peak, "
+      << FormatBytes((double) stats.retainedBytes) << " retained" << endl;
+}
+
 void Timers::StopAllTimers()
 {
-  // Terminate the program timers.  Don't use StopTimer() since that modifies
-  // the map and would invalidate our iterators.
   lock_guard<mutex> lock(timersMutex);
 
   high_resolution_clock::time_point currTime = high_resolution_clock::now();
-  for (auto it : timerStartTime)
-    for (auto it2 : it.second)
-      timers[it2.first] += duration_cast<microseconds>(currTime - it2.second);
+  for (auto& it : threadTimers)
+  {
+    ThreadTimers& t = *it.second;
+    lock_guard<mutex> threadLock(t.mutex);
 
-  // If all timers are stopped, we can clear the maps.
-  timerStartTime.clear();
+    // Stop the innermost timers first.  Don't iterate over the list of running
+    // timers, since Stop() modifies it.
+    while (!t.running.empty())
+      Stop(t, t.running.back(), currTime);
+  }
 }
 
 void Timers::StartTimer(const string& timerName,
@@ -179,10 +374,10 @@ void Timers::StartTimer(const string& timerName,
   if (!enabled)
     return;
 
-  lock_guard<mutex> lock(timersMutex);
+  shared_ptr<ThreadTimers> t = GetThreadTimers(threadId);
+  lock_guard<mutex> lock(t->mutex);
 
-  if ((timerStartTime.count(threadId) > 0) &&
-      (timerStartTime[threadId].count(timerName)))
+  if (t->startTime.count(timerName))
   {
     ostringstream error;
     error << "Timer::Start(): timer '" << timerName
@@ -190,15 +385,21 @@ void Timers::StartTimer(const string& timerName,
     throw runtime_error(error.str());
   }
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
-
-  // If the timer is added for the first time.
-  if (timers.count(timerName) == 0)
-  {
-    timers[timerName] = (microseconds) 0;
-  }
-
-  timerStartTime[threadId][timerName] = currTime;
+  // The path of the timer goes through the timers running in this thread.
+  string path;
+  for (size_t i = 0; i < t->running.size(); ++i)
+    path += t->running[i] + "/";
+  path += timerName;
+
+  // If the timer is added for the first time, it is listed with no runs.
+  t->stats[timerName];
+  t->paths[timerName] = path;
+  t->running.push_back(timerName);
+#ifdef MLPACK_TRACK_MEMORY
+  t->memoryScopes[timerName] = MemoryScope { MemoryTracker::BeginScope(),
+      MemoryTracker::Current() };
+#endif
+  t->startTime[timerName] = high_resolution_clock::now();
 }
 
 void Timers::StopTimer(const string& timerName,
@@ -208,10 +409,12 @@ void Timers::StopTimer(const string& timerName,
   if (!enabled)
     return;
 
-  lock_guard<mutex> lock(timersMutex);
+  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+
+  shared_ptr<ThreadTimers> t = GetThreadTimers(threadId);
+  lock_guard<mutex> lock(t->mutex);
 
-  if ((timerStartTime.count(threadId) == 0) ||
-      (timerStartTime[threadId].count(timerName) == 0))
+  if (t->startTime.count(timerName) == 0)
   {
     ostringstream error;
     error << "Timer::Stop(): no timer with name '" << timerName
@@ -219,14 +422,136 @@ void Timers::StopTimer(const string& timerName,
     throw runtime_error(error.str());
   }
 
-  high_resolution_clock::time_point currTime = high_resolution_clock::now();
+  Stop(*t, timerName, currTime);
+}
 
-  // Calculate the delta time.
-  timers[timerName] += duration_cast<microseconds>(currTime -
-      timerStartTime[threadId][timerName]);
+void Timers::Stop(ThreadTimers& t,
+                  const string& timerName,
+                  const high_resolution_clock::time_point& currTime)
+{
+  const high_resolution_clock::time_point startTime = t.startTime[timerName];
+  const microseconds run = duration_cast<microseconds>(currTime - startTime);
+
+  t.stats[timerName].Add(run, t.state);
+  const string& path = t.paths[timerName];
+  t.pathStats[path].Add(run, t.state);
+
+#ifdef MLPACK_TRACK_MEMORY
+  const MemoryScope& scope = t.memoryScopes[timerName];
+  const size_t peak = MemoryTracker::EndScope(scope.scope);
+  const int64_t retained = (int64_t) MemoryTracker::Current() -
+      (int64_t) scope.start;
+  t.stats[timerName].AddMemory(peak, retained);
+  t.pathStats[path].AddMemory(peak, retained);
+  t.memoryScopes.erase(timerName);
+#endif
+
+  if (tracing)
+  {
+    t.events.push_back(TraceEvent { timerName,
+        duration_cast<microseconds>(startTime - epoch), run });
+  }
 
   // Remove the entries.
-  timerStartTime[threadId].erase(timerName);
-  if (timerStartTime[threadId].empty())
-    timerStartTime.erase(threadId);
+  t.startTime.erase(timerName);
+  t.paths.erase(timerName);
+  t.running.erase(std::find(t.running.begin(), t.running.end(), timerName));
+}
+
+// Write a string as a JSON string.
+static void WriteJSONString(ostream& stream, const string& str)
+{
+  stream << '"';
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+      stream << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+// Write the statistics of a timer as a JSON object.
+static void WriteJSONStats(ostream& stream, const TimerStats& stats)
+{
+  stream << "{\"total\": " << stats.total.count()
+      << ", \"count\": " << stats.count
+      << ", \"min\": " << stats.min.count()
+      << ", \"max\": " << stats.max.count()
+      << ", \"p50\": " << stats.Percentile(50).count()
+      << ", \"p90\": " << stats.Percentile(90).count()
+      << ", \"p99\": " << stats.Percentile(99).count();
+#ifdef MLPACK_TRACK_MEMORY
+  stream << ", \"peak_bytes\": " << stats.peakBytes
+      << ", \"retained_bytes\": " << stats.retainedBytes;
+#endif
+  stream << "}";
+}
+
+void Timers::WriteJSON(ostream& stream)
+{
+  // Collect the statistics of each timer by name.
+  map<string, TimerStats> stats;
+  {
+    lock_guard<mutex> lock(timersMutex);
+    for (auto& it : threadTimers)
+    {
+      lock_guard<mutex> threadLock(it.second->mutex);
+      for (auto& it2 : it.second->stats)
+        stats[it2.first].Merge(it2.second);
+    }
+  }
+  const map<string, TimerStats> pathStats = GetPathStats();
+
+  stream << "{" << endl << "  \"timers\": {";
+  for (auto it = stats.begin(); it != stats.end(); ++it)
+  {
+    stream << (it == stats.begin() ? "" : ",") << endl << "    ";
+    WriteJSONString(stream, it->first);
+    stream << ": ";
+    WriteJSONStats(stream, it->second);
+  }
+  stream << endl << "  }," << endl << "  \"paths\": {";
+  for (auto it = pathStats.begin(); it != pathStats.end(); ++it)
+  {
+    stream << (it == pathStats.begin() ? "" : ",") << endl << "    ";
+    WriteJSONString(stream, it->first);
+    stream << ": ";
+    WriteJSONStats(stream, it->second);
+  }
+  stream << endl << "  }";
+#ifdef MLPACK_TRACK_MEMORY
+  stream << "," << endl << "  \"memory\": {\"current_bytes\": "
+      << MemoryTracker::Current() << ", \"peak_bytes\": "
+      << MemoryTracker::Peak() << "}";
+#endif
+  stream << endl << "}" << endl;
+}
+
+void Timers::WriteTrace(ostream& stream)
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  // Each run is a complete ("X") event; the viewer nests the runs of each
+  // thread by their times.
+  stream << "{\"traceEvents\": [";
+  bool first = true;
+  for (auto& it : threadTimers)
+  {
+    ThreadTimers& t = *it.second;
+    lock_guard<mutex> threadLock(t.mutex);
+    for (const TraceEvent& e : t.events)
+    {
+      stream << (first ? "" : ",") << endl << "  {\"name\": ";
+      WriteJSONString(stream, e.name);
+      stream << ", \"ph\": \"X\", \"ts\": " << e.start.count()
+          << ", \"dur\": " << e.duration.count() << ", \"pid\": 0, "
+          << "\"tid\": " << t.index << "}";
+      first = false;
+    }
+  }
+  stream << endl << "]}" << endl;
 }
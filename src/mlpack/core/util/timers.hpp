@@ -21,6 +21,12 @@
 #include <mutex>
 #include <list>
 #include <atomic>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include <vector>
+
+#include "memory_tracker.hpp"
 
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
@@ -94,11 +100,107 @@ class Timer
   static void ResetAll();
 };
 
+/**
+ * Start a timer when constructed and stop it when destroyed, so that a scope
+ * can be timed even when it is left by an exception:
+ *
+ * @code
+ * {
+ *   ScopedTimer t("tree_building");
+ *   ...
+ * }
+ * @endcode
+ */
+class ScopedTimer
+{
+ public:
+  /**
+   * Start the given timer.
+   *
+   * @param name Name of timer to be started.
+   */
+  ScopedTimer(const std::string& name) : name(name) { Timer::Start(name); }
+
+  //! Stop the timer.
+  ~ScopedTimer()
+  {
+    try
+    {
+      Timer::Stop(name);
+    }
+    catch (...)
+    {
+      // The timers were reset while this one was running.
+    }
+  }
+
+ private:
+  //! The name of the timer.
+  std::string name;
+};
+
+/**
+ * Statistics of the runs of a timer.  The percentiles are estimated from a
+ * uniform sample of at most MaxSamples runs (per thread), so that timers in
+ * hot loops use bounded memory.
+ */
+struct TimerStats
+{
+  //! The maximum number of runs kept per thread to estimate the percentiles.
+  static const size_t MaxSamples = 1024;
+
+  TimerStats() :
+      total(0), count(0), min(0), max(0), peakBytes(0), retainedBytes(0) { }
+
+  /**
+   * Add a run of the timer.
+   *
+   * @param run Duration of the run.
+   * @param state State of the random number generator used for the sample.
+   */
+  void Add(const std::chrono::microseconds run, uint64_t& state);
+
+  /**
+   * Add the memory used by a run of the timer (see MemoryTracker).
+   *
+   * @param peak Peak of the number of bytes in use during the run.
+   * @param retained Number of bytes in use at the end of the run minus the
+   *     number of bytes in use at its start.
+   */
+  void AddMemory(const size_t peak, const int64_t retained);
+
+  //! Add the runs of the given statistics (from another thread).
+  void Merge(const TimerStats& other);
+
+  /**
+   * Estimate the given percentile of the durations of the runs.
+   *
+   * @param p Percentile, between 0 and 100.
+   */
+  std::chrono::microseconds Percentile(const double p) const;
+
+  //! Total duration of the runs.
+  std::chrono::microseconds total;
+  //! Number of runs.
+  size_t count;
+  //! Shortest run.
+  std::chrono::microseconds min;
+  //! Longest run.
+  std::chrono::microseconds max;
+  //! Sample of the durations of the runs.
+  std::vector<std::chrono::microseconds> samples;
+  //! Peak of the number of bytes in use during the runs (only counted if
+  //! mlpack is built with memory tracking; see MemoryTracker).
+  size_t peakBytes;
+  //! Number of bytes allocated during the runs and not freed at their end.
+  int64_t retainedBytes;
+};
+
 class Timers
 {
  public:
   //! Default to disabled.
-  Timers() : enabled(false) { }
+  Timers();
 
   /**
    * Returns a copy of all the timers used via this interface.
@@ -127,6 +229,15 @@ class Timers
    */
   void PrintTimer(const std::string& timerName);
 
+  /**
+   * Prints the peak number of bytes in use during the runs of the specified
+   * timer, and the number of bytes they allocated and did not free.  These are
+   * only counted if mlpack is built with memory tracking (see MemoryTracker).
+   *
+   * @param timerName The name of the timer in question.
+   */
+  void PrintMemory(const std::string& timerName);
+
   /**
    * Initializes a timer, available like a normal value specified on
    * the command line.  Timers are of type timeval.  If a timer is started, then
@@ -162,22 +273,121 @@ class Timers
    */
   void StopAllTimers();
 
+  /**
+   * Returns the statistics (number of runs, minimum, maximum, percentiles) of
+   * the timer specified, over all threads.
+   *
+   * @param timerName The name of the timer in question.
+   */
+  TimerStats GetStats(const std::string& timerName);
+
+  /**
+   * Returns the statistics of the timers by path: a timer started while other
+   * timers are running in the same thread is a child of them, and its path is
+   * e.g. "total_time/tree_building".
+   */
+  std::map<std::string, TimerStats> GetPathStats();
+
+  /**
+   * Write the statistics of all the timers, by name and by path, as JSON.  All
+   * durations are in microseconds.  If mlpack is built with memory tracking,
+   * the peak and retained bytes of each timer, and the current and peak bytes
+   * in use by the process, are written too.
+   *
+   * @param stream Stream to write to.
+   */
+  void WriteJSON(std::ostream& stream);
+
+  /**
+   * Write the runs of the timers recorded while tracing was enabled in the
+   * Chrome trace event format, which can be opened with chrome://tracing or
+   * Perfetto.
+   *
+   * @param stream Stream to write to.
+   */
+  void WriteTrace(std::ostream& stream);
+
   //! Modify whether or not timing is enabled.
   std::atomic<bool>& Enabled() { return enabled; }
   //! Get whether or not timing is enabled.
   bool Enabled() const { return enabled; }
 
+  //! Modify whether or not each run is recorded for WriteTrace().
+  std::atomic<bool>& Tracing() { return tracing; }
+  //! Get whether or not each run is recorded for WriteTrace().
+  bool Tracing() const { return tracing; }
+
  private:
-  //! A map of all the timers that are being tracked.
-  std::map<std::string, std::chrono::microseconds> timers;
-  //! A mutex for modifying the timers.
+  //! A run of a timer, recorded for WriteTrace().
+  struct TraceEvent
+  {
+    //! The name of the timer.
+    std::string name;
+    //! The start of the run, since the creation of the timers.
+    std::chrono::microseconds start;
+    //! The duration of the run.
+    std::chrono::microseconds duration;
+  };
+
+  //! The memory scope of a running timer (see MemoryTracker).
+  struct MemoryScope
+  {
+    //! The identifier of the scope.
+    size_t scope;
+    //! The number of bytes in use when the timer was started.
+    size_t start;
+  };
+
+  //! The timers of one thread.  Only that thread modifies them, so their
+  //! mutex is only contended while the timers are read.
+  struct ThreadTimers
+  {
+    //! The index of the thread, in order of first use.
+    size_t index;
+    //! A mutex for modifying the timers of the thread.
+    std::mutex mutex;
+    //! The starting values of the running timers.
+    std::map<std::string, std::chrono::high_resolution_clock::time_point>
+        startTime;
+    //! The names of the running timers, in the order they were started.
+    std::vector<std::string> running;
+    //! The paths of the running timers.
+    std::map<std::string, std::string> paths;
+    //! The statistics of the timers, by name.
+    std::map<std::string, TimerStats> stats;
+    //! The statistics of the timers, by path.
+    std::map<std::string, TimerStats> pathStats;
+    //! The memory scopes of the running timers.
+    std::map<std::string, MemoryScope> memoryScopes;
+    //! The runs recorded while tracing.
+    std::vector<TraceEvent> events;
+    //! The state of the random number generator for the samples of runs.
+    uint64_t state;
+  };
+
+  //! Get the timers of the given thread, creating them if needed.
+  std::shared_ptr<ThreadTimers> GetThreadTimers(const std::thread::id& id);
+
+  //! Stop the given running timer of a thread (whose mutex must be held).
+  void Stop(ThreadTimers& t,
+            const std::string& timerName,
+            const std::chrono::high_resolution_clock::time_point& currTime);
+
+  //! A mutex for modifying the map of the timers of each thread.
   std::mutex timersMutex;
-  //! A map for the starting values of the timers.
-  std::map<std::thread::id, std::map<std::string,
-      std::chrono::high_resolution_clock::time_point>> timerStartTime;
+  //! The timers of each thread.
+  std::map<std::thread::id, std::shared_ptr<ThreadTimers>> threadTimers;
+  //! A unique identifier of these timers, for the cache of each thread.
+  const size_t id;
+  //! Incremented by Reset(), which invalidates the cache of each thread.
+  std::atomic<size_t> generation;
+  //! The time the timers were created or reset, for WriteTrace().
+  std::chrono::high_resolution_clock::time_point epoch;
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
+  //! Whether or not each run is recorded.
+  std::atomic<bool> tracing;
 };
 
 } // namespace mlpack
@@ -150,8 +150,16 @@ class AdaBoost
                const size_t iterations = 100,
                const double tolerance = 1e-6);
 
+  //! The number of points classified at once by each thread in Classify().
+  static const size_t BlockSize = 1024;
+
   /**
-   * Classify the given test points.
+   * Classify the given test points.  The points are split into blocks of
+   * BlockSize points, which are classified in parallel when OpenMP is
+   * available; each block is classified by every weak learner in turn, and
+   * the weighted votes are accumulated for the whole block.  The votes are
+   * accumulated in the element type of the given probability matrix, so an
+   * arma::fmat can be passed to halve its memory.
    *
    * @param test Testing data.
    * @param predictedLabels Vector in which the predicted labels of the test
@@ -159,9 +167,10 @@ class AdaBoost
    * @param probabilities matrix to store the predicted class probabilities for
    *      each point in the test set.
    */
+  template<typename ProbabilityType>
   void Classify(const MatType& test,
                 arma::Row<size_t>& predictedLabels,
-                arma::mat& probabilities);
+                arma::Mat<ProbabilityType>& probabilities);
 
   /**
    * Classify the given test points.
@@ -87,13 +87,6 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
-
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
   arma::mat D(numClasses, data.n_cols);
@@ -102,9 +95,6 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // Weights are stored in this row vector.
   arma::rowvec weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
-
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; ++i)
   {
@@ -120,14 +110,12 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     weights = arma::sum(D);
 
     // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
-    w.Classify(tempData, predictedLabels);
-
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
+    WeakLearnerType w(other, data, labels, numClasses, weights);
+    w.Classify(data, predictedLabels);
 
     // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; ++j) // instead of D, ht
+    #pragma omp parallel for reduction(+:rt)
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; ++j)
     {
       if (predictedLabels(j) == labels(j))
         rt += arma::accu(D.col(j));
@@ -156,41 +144,19 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; ++j)
+    // Now start modifying the weights: the weights of the points that were
+    // classified correctly shrink, and the others grow.
+    const double expo = exp(alphat);
+    #pragma omp parallel for reduction(+:zt)
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; ++j)
     {
-      const double expo = exp(alphat);
       if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
+        D.col(j) /= expo;
       else
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
+        D.col(j) *= expo;
+
+      // We calculate zt, the normalization constant.
+      zt += arma::accu(D.col(j));
     }
 
     // Normalize D.
@@ -220,34 +186,38 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
  * Classify the given test points.
  */
 template<typename WeakLearnerType, typename MatType>
+template<typename ProbabilityType>
 void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels,
-    arma::mat& probabilities)
+    arma::Mat<ProbabilityType>& probabilities)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-
   probabilities.zeros(numClasses, test.n_cols);
-  predictedLabels.set_size(test.n_cols);
 
-  for (size_t i = 0; i < wl.size(); ++i)
+  // Each block of points is classified by all the weak learners, so the block
+  // stays in cache while the votes are accumulated.
+  const size_t numBlocks = (test.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) test.n_cols);
+    const MatType block = test.cols(begin, end - 1);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; ++j)
-      probabilities(tempPredictedLabels(j), j) += alpha[i];
-  }
-
-  arma::colvec pRow;
-  arma::uword maxIndex = 0;
+    arma::Row<size_t> blockLabels;
+    for (size_t i = 0; i < wl.size(); ++i)
+    {
+      wl[i].Classify(block, blockLabels);
 
-  for (size_t i = 0; i < predictedLabels.n_cols; ++i)
-  {
-    probabilities.col(i) /= arma::accu(probabilities.col(i));
-    pRow = probabilities.unsafe_col(i);
-    pRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+      for (size_t j = 0; j < blockLabels.n_elem; ++j)
+        probabilities(blockLabels[j], begin + j) += (ProbabilityType) alpha[i];
+    }
   }
+
+  // Normalize the votes of each point, and take the class with the most.
+  probabilities.each_row() /= arma::sum(probabilities, 0);
+  predictedLabels = arma::conv_to<arma::Row<size_t>>::from(
+      arma::index_max(probabilities, 0));
 }
 
 /**
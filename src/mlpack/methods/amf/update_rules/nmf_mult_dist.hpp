@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIST_UPDATE_RULES_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -35,6 +36,10 @@ namespace amf {
  * This is a multiplicative rule that ensures that the Frobenius norm
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ is non-increasing between subsequent
  * iterations. Both of the update rules for W and H are defined in this file.
+ *
+ * When V is sparse, the products with V are computed in parallel over the
+ * nonzero elements of V only (see math::SparseMultiply()), so that the cost of
+ * an update is linear in the number of nonzero elements of V.
  */
 class NMFMultiplicativeDistanceUpdate
 {
@@ -71,7 +76,24 @@ class NMFMultiplicativeDistanceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    W = (W % (V * H.t())) / (W * H * H.t());
+    W = (W % (V * H.t())) / (W * (H * H.t()));
+  }
+
+  /**
+   * The update rule for the basis matrix W, for sparse V (see the other
+   * overload of WUpdate()).  W H is never formed.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  inline static void WUpdate(const arma::sp_mat& V,
+                             arma::mat& W,
+                             const arma::mat& H)
+  {
+    arma::mat vht;
+    math::SparseMultiply(V, H.t(), vht);
+    W = (W % vht) / (W * (H * H.t()));
   }
 
   /**
@@ -93,7 +115,24 @@ class NMFMultiplicativeDistanceUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = (H % (W.t() * V)) / (W.t() * W * H);
+    H = (H % (W.t() * V)) / ((W.t() * W) * H);
+  }
+
+  /**
+   * The update rule for the encoding matrix H, for sparse V (see the other
+   * overload of HUpdate()).  W H is never formed.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  inline static void HUpdate(const arma::sp_mat& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    arma::mat vtw;
+    math::SparseTransMultiply(V, W, vtw);
+    H = (H % vtw.t()) / ((W.t() * W) * H);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIV_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -41,9 +42,12 @@ namespace amf {
  * is non-increasing between subsequent iterations. Both of the update rules
  * for W and H are defined in this file.
  *
- * This set of update rules is not meant to work with sparse matrices.  Using
- * sparse matrices often causes NaNs in the output, so other choices of update
- * rules are better in that situation.
+ * When V is sparse, \f$ V_{ij} / (W H)_{ij} \f$ is only computed at the
+ * nonzero elements of V (the other terms of the sums are zero), in parallel
+ * over the columns of V, so that the cost of an update is linear in the number
+ * of nonzero elements of V and W H is never formed.  Note that sparse matrices
+ * can still cause NaNs in the output if an element of W H at a nonzero element
+ * of V becomes zero.
  */
 class NMFMultiplicativeDivergenceUpdate
 {
@@ -149,9 +153,87 @@ class NMFMultiplicativeDivergenceUpdate
     }
   }
 
+  /**
+   * The update rule for the basis matrix W, for sparse V (see the other
+   * overload of WUpdate()).
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  inline static void WUpdate(const arma::sp_mat& V,
+                             arma::mat& W,
+                             const arma::mat& H)
+  {
+    // The numerator is (V / (W H)) H^T, where the division is only done at the
+    // nonzero elements of V.
+    arma::mat numerator;
+    math::SparseMultiply(Ratios(V, W, H), H.t(), numerator);
+
+    W %= numerator.each_row() / arma::trans(arma::sum(H, 1));
+  }
+
+  /**
+   * The update rule for the encoding matrix H, for sparse V (see the other
+   * overload of HUpdate()).
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to updated.
+   */
+  inline static void HUpdate(const arma::sp_mat& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    // The numerator is W^T (V / (W H)), where the division is only done at the
+    // nonzero elements of V.
+    arma::mat ratiosTW;
+    math::SparseTransMultiply(Ratios(V, W, H), W, ratiosTW);
+    const arma::mat numerator = ratiosTW.t();
+
+    H %= numerator.each_col() / arma::trans(arma::sum(W, 0));
+  }
+
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  /**
+   * Compute the sparse matrix that holds V_{ij} / (W H)_{ij} at each nonzero
+   * element of V.  The columns are computed in parallel.
+   */
+  static arma::sp_mat Ratios(const arma::sp_mat& V,
+                             const arma::mat& W,
+                             const arma::mat& H)
+  {
+    V.sync();
+    arma::vec values(V.n_nonzero);
+
+    // Rows of W are accessed, so use its transpose for contiguous memory.
+    const arma::mat wt = W.t();
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+    {
+      const double* h = H.colptr(j);
+      for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+      {
+        const double* w = wt.colptr(V.row_indices[k]);
+        double wh = 0.0;
+        for (size_t a = 0; a < wt.n_rows; ++a)
+          wh += w[a] * h[a];
+
+        values[k] = V.values[k] / wh;
+      }
+    }
+
+    const arma::uvec rowIndices(const_cast<arma::uword*>(V.row_indices),
+        V.n_nonzero, false, true);
+    const arma::uvec colPtrs(const_cast<arma::uword*>(V.col_ptrs),
+        V.n_cols + 1, false, true);
+    return arma::sp_mat(rowIndices, colPtrs, values, V.n_rows, V.n_cols);
+  }
 };
 
 } // namespace amf
@@ -0,0 +1,272 @@
+/**
+ * @file methods/amf/update_rules/weighted_als.hpp
+ *
+ * Weighted alternating least squares update rule for sparse ratings, for
+ * explicit and implicit feedback.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements alternating least squares for sparse rating matrices:
+ * the nonzero elements of V are the observed ratings, and each row of W (and
+ * each column of H) is the solution of a small regularized least squares
+ * problem that only involves the observed ratings of the row (or column).
+ *
+ * With explicit feedback, the update rule minimizes
+ *
+ * \f[
+ * \sum_{(i, j) observed} (V_{ij} - w_i^T h_j)^2 +
+ *     \lambda (\sum_i n_i \| w_i \|^2 + \sum_j n_j \| h_j \|^2)
+ * \f]
+ *
+ * where \f$ n_i \f$ is the number of ratings of row i, as in the following
+ * paper:
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-scale Parallel Collaborative Filtering for the Netflix
+ *       Prize},
+ *   author={Zhou, Y. and Wilkinson, D. and Schreiber, R. and Pan, R.},
+ *   booktitle={Algorithmic Aspects in Information and Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * With implicit feedback, every element of V is an observation: the preference
+ * \f$ p_{ij} \f$ is 1 if \f$ V_{ij} > 0 \f$ and 0 otherwise, with confidence
+ * \f$ c_{ij} = 1 + \alpha V_{ij} \f$, and the update rule minimizes
+ *
+ * \f[
+ * \sum_{i, j} c_{ij} (p_{ij} - w_i^T h_j)^2 +
+ *     \lambda (\sum_i \| w_i \|^2 + \sum_j \| h_j \|^2)
+ * \f]
+ *
+ * as in the following paper:
+ *
+ * @code
+ * @inproceedings{hu2008collaborative,
+ *   title={Collaborative Filtering for Implicit Feedback Datasets},
+ *   author={Hu, Y. and Koren, Y. and Volinsky, C.},
+ *   booktitle={Proceedings of the 8th IEEE International Conference on Data
+ *       Mining (ICDM '08)},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * The Gram matrix of the fixed factors is computed once per update, so that
+ * the system of each row (or column) only costs the number of its ratings
+ * times the squared rank; the systems are solved with a Cholesky
+ * decomposition.  When mlpack is compiled with OpenMP, the rows of W (and the
+ * columns of H) are solved in parallel.  Implicit feedback expects
+ * non-negative values (such as counts), so it should not be used with a
+ * normalization that centers the ratings.
+ */
+class WeightedALSUpdate
+{
+ public:
+  /**
+   * Create the update rule with the given parameters.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether the ratings are implicit feedback.
+   * @param alpha Confidence scale of implicit feedback.
+   */
+  WeightedALSUpdate(const double lambda = 0.05,
+                    const bool implicit = false,
+                    const double alpha = 40.0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Store the transpose of the ratings, so that the ratings of each row of V
+   * can be read contiguously.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank Rank of the decomposition.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    ratingsT = arma::sp_mat(dataset).t();
+    ratingsT.sync();
+  }
+
+  /**
+   * The update rule for the basis matrix W: each row of W is the solution of
+   * the least squares problem of the ratings of the row of V.  V must be the
+   * matrix that was given to Initialize().
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    arma::mat factors(H.n_rows, ratingsT.n_cols);
+    Solve(ratingsT, H, factors);
+    W = factors.t();
+  }
+
+  /**
+   * The update rule for the encoding matrix H: each column of H is the solution
+   * of the least squares problem of the ratings of the column of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    const arma::sp_mat& ratings = Sparse(V);
+    ratings.sync();
+    H.set_size(W.n_cols, ratings.n_cols);
+    Solve(ratings, W.t(), H);
+  }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the ratings are implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the ratings are implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence scale of implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scale of implicit feedback.
+  double& Alpha() { return alpha; }
+
+  //! Serialize the update rule.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(implicit);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+  }
+
+ private:
+  //! Sparse matrices are used as they are.
+  static const arma::sp_mat& Sparse(const arma::sp_mat& V) { return V; }
+
+  //! Other matrices are converted; their zeros are not observed.
+  template<typename MatType>
+  static arma::sp_mat Sparse(const MatType& V) { return arma::sp_mat(V); }
+
+  /**
+   * Solve the least squares problem of each column of the ratings, given the
+   * fixed factors (one column per row of the ratings).
+   *
+   * @param ratings Ratings to solve the problems of, one column per problem.
+   * @param fixed Fixed factors.
+   * @param factors Matrix to store the solutions in, one column per problem.
+   */
+  void Solve(const arma::sp_mat& ratings,
+             const arma::mat& fixed,
+             arma::mat& factors) const
+  {
+    const size_t rank = fixed.n_rows;
+
+    // With implicit feedback, every element contributes to the system, so we
+    // start from the Gram matrix and only add the contribution of the
+    // confidence of the observed ratings.
+    arma::mat gram;
+    if (implicit)
+      gram = fixed * fixed.t();
+
+    #pragma omp parallel
+    {
+      arma::mat a(rank, rank);
+      arma::vec b(rank);
+      arma::mat r;
+      arma::vec x, y;
+
+      #pragma omp for schedule(dynamic, 64)
+      for (omp_size_t j = 0; j < (omp_size_t) ratings.n_cols; ++j)
+      {
+        if (implicit)
+          a = gram;
+        else
+          a.zeros();
+        b.zeros();
+
+        size_t count = 0;
+        arma::sp_mat::const_col_iterator it = ratings.begin_col(j);
+        for (; it != ratings.end_col(j); ++it)
+        {
+          const double* f = fixed.colptr(it.row());
+          const double value = (*it);
+          const double weight = implicit ? alpha * value : 1.0;
+          const double target = implicit ? 1.0 + alpha * value : value;
+          for (size_t k = 0; k < rank; ++k)
+          {
+            b[k] += target * f[k];
+            for (size_t l = 0; l < rank; ++l)
+              a(l, k) += weight * f[l] * f[k];
+          }
+          ++count;
+        }
+
+        if (!implicit && count == 0)
+        {
+          // Without any rating, the regularization gives a zero vector.
+          factors.col(j).zeros();
+          continue;
+        }
+
+        a.diag() += implicit ? lambda : lambda * count;
+
+        // The system is symmetric positive definite (if lambda is positive),
+        // but fall back to a general solver if the decomposition fails.  We
+        // can't throw from the parallel region, so a system that can't be
+        // solved at all gives a zero vector.
+        const bool solved = arma::chol(r, a) &&
+            arma::solve(y, arma::trimatl(r.t()), b) &&
+            arma::solve(x, arma::trimatu(r), y);
+        if (!solved && !arma::solve(x, a, b))
+          x.zeros(rank);
+
+        factors.col(j) = x;
+      }
+    }
+  }
+
+  //! The regularization parameter.
+  double lambda;
+  //! Whether the ratings are implicit feedback.
+  bool implicit;
+  //! The confidence scale of implicit feedback.
+  double alpha;
+  //! The transpose of the ratings.
+  arma::sp_mat ratingsT;
+}; // class WeightedALSUpdate
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
@@ -71,7 +71,7 @@ class IdentityFunction
   template<typename InputVecType, typename OutputVecType>
   static void Deriv(const InputVecType& y, OutputVecType& x)
   {
-    x.ones(arma::size(y));
+    x.ones(y.n_rows, y.n_cols);
   }
 
   /**
@@ -58,7 +58,7 @@ class LogisticFunction
   template<typename InputVecType, typename OutputVecType>
   static void Fn(const InputVecType& x, OutputVecType& y)
   {
-    y = (1.0 / (1 + arma::exp(-x)));
+    y = (1.0 / (1 + exp(-x)));
   }
 
   /**
@@ -62,11 +62,11 @@ class RectifierFunction
    * @param x Input data.
    * @param y The resulting output activation.
    */
-  template<typename eT>
-  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  template<typename InputType, typename OutputType>
+  static void Fn(const InputType& x, OutputType& y)
   {
     y.zeros(x.n_rows, x.n_cols);
-    y = arma::max(y, x);
+    y = max(y, x);
   }
 
   /**
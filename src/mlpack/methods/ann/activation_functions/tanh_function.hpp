@@ -49,7 +49,7 @@ class TanhFunction
   template<typename InputVecType, typename OutputVecType>
   static void Fn(const InputVecType& x, OutputVecType& y)
   {
-    y = arma::tanh(x);
+    y = tanh(x);
   }
 
   /**
@@ -72,7 +72,7 @@ class TanhFunction
   template<typename InputVecType, typename OutputVecType>
   static void Deriv(const InputVecType& y, OutputVecType& x)
   {
-    x = 1 - arma::pow(y, 2);
+    x = 1 - square(y);
   }
 
   /**
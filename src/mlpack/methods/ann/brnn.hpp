@@ -292,6 +292,23 @@ class BRNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  //! Get the number of steps of each truncated backpropagation through time
+  //! window (0 means the whole sequence).
+  size_t BPTTWindow() const { return bpttWindow; }
+  //! Modify the number of steps of each truncated backpropagation through time
+  //! window (0 means the whole sequence).  The error of each direction is then
+  //! not backpropagated from one window into the previous one (in the order
+  //! of that direction); the state is carried across the windows.
+  size_t& BPTTWindow() { return bpttWindow; }
+
+  //! Get whether only the outputs of the recurrent layers are stored for the
+  //! backward pass.
+  bool CheckpointActivations() const { return checkpointActivations; }
+  //! Modify whether only the outputs of the recurrent layers are stored for
+  //! the backward pass; the outputs of the other layers are then recomputed
+  //! (see RNN::CheckpointActivations()).
+  bool& CheckpointActivations() { return checkpointActivations; }
+
   //! Get the matrix of responses to the input data points.
   const arma::cube& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -399,6 +416,14 @@ class BRNN
   //! The current evaluation mode (training or testing).
   bool deterministic;
 
+  //! The number of steps of each truncated BPTT window (0 for the whole
+  //! sequence).
+  size_t bpttWindow;
+
+  //! Whether only the outputs of the recurrent layers are stored for the
+  //! backward pass.
+  bool checkpointActivations;
+
   //! The current gradient for the gradient pass for forward RNN.
   arma::mat forwardGradient;
 
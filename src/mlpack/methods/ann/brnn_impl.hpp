@@ -54,6 +54,8 @@ BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     single(single),
     numFunctions(0),
     deterministic(true),
+    bpttWindow(0),
+    checkpointActivations(false),
     forwardRNN(rho, single, outputLayer, initializeRule),
     backwardRNN(rho, single, outputLayer, initializeRule)
 {
@@ -414,6 +416,10 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   forwardRNN.ResetCells();
   backwardRNN.ResetCells();
+  forwardRNN.checkpointActivations = checkpointActivations;
+  backwardRNN.checkpointActivations = checkpointActivations;
+  forwardRNN.TruncateBackward();
+  backwardRNN.TruncateBackward();
   size_t networkSize = backwardRNN.network.size();
 
   // Forward propogation from both directions.
@@ -427,13 +433,8 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
         predictors.slice(rho - seqNum - 1).colptr(begin),
         predictors.n_rows, batchSize, false, true));
 
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          forwardRNNOutputParameter), forwardRNN.network[l]);
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          backwardRNNOutputParameter), backwardRNN.network[l]);
-    }
+    forwardRNN.SaveOutputs(forwardRNNOutputParameter);
+    backwardRNN.SaveOutputs(backwardRNNOutputParameter);
     boost::apply_visitor(SaveOutputParameterVisitor(results1),
         forwardRNN.network.back());
     boost::apply_visitor(SaveOutputParameterVisitor(results2),
@@ -522,13 +523,18 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
-    forwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
+    // The error of the later steps is not backpropagated past the start of
+    // their truncated BPTT window.
+    if (bpttWindow != 0 && seqNum > 0 && (rho - seqNum) % bpttWindow == 0)
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          forwardRNNOutputParameter),
-          forwardRNN.network[networkSize - 1 - l]);
+      forwardRNN.TruncateBackward();
     }
+
+    forwardGradient.zeros();
+    forwardRNN.LoadOutputs(arma::mat(
+        predictors.slice(rho - seqNum - 1).colptr(begin),
+        predictors.n_rows, batchSize, false, true),
+        forwardRNNOutputParameter);
     boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
         outputParameterVisitor, forwardRNN.network.back()),
         allDelta[rho - seqNum - 1], delta, 0),
@@ -561,13 +567,17 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
-    backwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
+    // The backward RNN runs over the sequence in reverse, so its windows start
+    // at the end of the sequence.
+    if (bpttWindow != 0 && seqNum > 0 && (rho - seqNum) % bpttWindow == 0)
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          backwardRNNOutputParameter),
-          backwardRNN.network[networkSize - 1 - l]);
+      backwardRNN.TruncateBackward();
     }
+
+    backwardGradient.zeros();
+    backwardRNN.LoadOutputs(arma::mat(predictors.slice(seqNum).colptr(begin),
+        predictors.n_rows, batchSize, false, true),
+        backwardRNNOutputParameter);
     boost::apply_visitor(BackwardVisitor(
         boost::apply_visitor(outputParameterVisitor,
         backwardRNN.network.back()),
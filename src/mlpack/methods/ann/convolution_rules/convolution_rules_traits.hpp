@@ -0,0 +1,42 @@
+/**
+ * @file methods/ann/convolution_rules/convolution_rules_traits.hpp
+ *
+ * This provides the ConvolutionRuleTraits class, a template class to get
+ * information about various convolution rules.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_CONVOLUTION_RULES_TRAITS_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_CONVOLUTION_RULES_TRAITS_HPP
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * This is a template class that can provide information about various
+ * convolution rules.  By default, this class will provide the weakest possible
+ * assumptions on the convolution rule, and each convolution rule should
+ * override values as necessary.  If a convolution rule doesn't need to
+ * override a value, then there's no need to write a ConvolutionRuleTraits
+ * specialization for that class.
+ */
+template<typename ConvolutionRuleType>
+class ConvolutionRuleTraits
+{
+ public:
+  /**
+   * This is true if the rule has a MapConvolution() function, which convolves
+   * all the input maps of a point with all the filters of a layer at once, and
+   * sums the results over the input maps; the layers then call it instead of
+   * convolving each pair of maps separately.
+   */
+  static const bool HasMapConvolution = false;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
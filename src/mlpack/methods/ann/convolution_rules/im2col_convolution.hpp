@@ -0,0 +1,368 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution as a matrix product: the patches of the
+ * input are unrolled into the columns of a matrix (im2col), which is
+ * multiplied with the filters by BLAS.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+#include "convolution_rules_traits.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by unrolling each patch of the
+ * input that the filter is applied to into a column of a matrix (im2col), so
+ * that the convolution is one matrix product, computed by BLAS.  This class
+ * allows specification of the type of the border type. The convolution can be
+ * computed with the valid border type of the full border type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * The results are the same as those of NaiveConvolution.  The largest gain is
+ * with MapConvolution(), which the Convolution and AtrousConvolution layers
+ * call to convolve all the input maps of a point with all the filters in a
+ * single matrix product.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    output.set_size(
+        (input.n_rows - (filter.n_rows - 1) * dilationW - 1) / dW + 1,
+        (input.n_cols - (filter.n_cols - 1) * dilationH - 1) / dH + 1);
+
+    arma::Mat<eT> patches;
+    Im2Col(input.memptr(), input.n_rows, input.n_cols, 1, filter.n_rows,
+        filter.n_cols, output.n_rows, output.n_cols, dW, dH, dilationW,
+        dilationH, patches);
+
+    // Each column of the patches gives one element of the output.
+    const arma::Row<eT> filterRow(const_cast<eT*>(filter.memptr()),
+        filter.n_elem, false, true);
+    arma::Row<eT> outputRow(output.memptr(), output.n_elem, false, true);
+    outputRow = filterRow * patches;
+  }
+
+  /*
+   * Perform a convolution (full mode).  The input is zero-padded like
+   * NaiveConvolution does, and the valid convolution of the padded input is
+   * computed.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; ++i)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; ++i)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad filter and input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Convolve each of the input maps with its filter for each of the output
+   * maps, and sum the results over the input maps (valid mode).  Filter slice
+   * o * input.n_slices + m is applied to input map m for output map o, which is
+   * the layout of the weights of the Convolution layer.  All the patches of
+   * all the input maps are unrolled into one matrix, so the whole convolution
+   * is a single matrix product.
+   *
+   * @param input Input maps, one per slice.
+   * @param filter Filters, input.n_slices for each output map.
+   * @param output Output maps, one per slice.  If it already has the right
+   *     size, its memory is used.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  MapConvolution(const arma::Cube<eT>& input,
+                 const arma::Cube<eT>& filter,
+                 arma::Cube<eT>& output,
+                 const size_t dW = 1,
+                 const size_t dH = 1,
+                 const size_t dilationW = 1,
+                 const size_t dilationH = 1)
+  {
+    const size_t outputMaps = filter.n_slices / input.n_slices;
+    output.set_size(
+        (input.n_rows - (filter.n_rows - 1) * dilationW - 1) / dW + 1,
+        (input.n_cols - (filter.n_cols - 1) * dilationH - 1) / dH + 1,
+        outputMaps);
+
+    arma::Mat<eT> patches;
+    Im2Col(input.memptr(), input.n_rows, input.n_cols, input.n_slices,
+        filter.n_rows, filter.n_cols, output.n_rows, output.n_cols, dW, dH,
+        dilationW, dilationH, patches);
+
+    // The filters of each output map are contiguous, so they are the columns
+    // of a matrix, and so are the output maps.
+    const arma::Mat<eT> filterMat(const_cast<eT*>(filter.memptr()),
+        filter.n_rows * filter.n_cols * input.n_slices, outputMaps, false,
+        true);
+    arma::Mat<eT> outputMat(output.memptr(), output.n_rows * output.n_cols,
+        outputMaps, false, true);
+    outputMat = patches.t() * filterMat;
+  }
+
+  /**
+   * Unroll the patches of the given input maps that a filter of the given size
+   * is applied to into the columns of a matrix.  Column i + j * outputRows
+   * holds the patch of output element (i, j): for each map, the elements of
+   * the patch in column-major order.
+   *
+   * @param input Memory of the input maps, stored one after the other.
+   * @param inputRows Number of rows of each input map.
+   * @param inputCols Number of columns of each input map.
+   * @param maps Number of input maps.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param outputRows Number of rows of the output.
+   * @param outputCols Number of columns of the output.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param patches Matrix to store the patches in.
+   */
+  template<typename eT>
+  static void Im2Col(const eT* input,
+                     const size_t inputRows,
+                     const size_t inputCols,
+                     const size_t maps,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     arma::Mat<eT>& patches)
+  {
+    patches.set_size(filterRows * filterCols * maps, outputRows * outputCols);
+
+    eT* patchPtr = patches.memptr();
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        for (size_t m = 0; m < maps; ++m)
+        {
+          const eT* mapPtr = input + m * inputRows * inputCols;
+          for (size_t kj = 0; kj < filterCols; ++kj)
+          {
+            const eT* inputPtr = mapPtr + (j * dH + kj * dilationH) *
+                inputRows + i * dW;
+            for (size_t ki = 0; ki < filterRows; ++ki, inputPtr += dilationW)
+              *patchPtr++ = *inputPtr;
+          }
+        }
+      }
+    }
+  }
+};  // class Im2ColConvolution
+
+//! The valid Im2ColConvolution can convolve all the maps of a layer at once.
+template<>
+class ConvolutionRuleTraits<Im2ColConvolution<ValidConvolution> >
+{
+ public:
+  static const bool HasMapConvolution = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,501 @@
+/**
+ * @file methods/ann/convolution_rules/winograd_convolution.hpp
+ *
+ * Implementation of the convolution with 3x3 filters using the Winograd
+ * minimal filtering algorithm F(2x2, 3x3).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_WINOGRAD_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_WINOGRAD_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+#include "convolution_rules_traits.hpp"
+#include "im2col_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution with a 3x3 filter using the
+ * Winograd minimal filtering algorithm F(2x2, 3x3), as described by Lavin and
+ * Gray in "Fast Algorithms for Convolutional Neural Networks" (2016).  The
+ * output is computed in 2x2 tiles; each tile takes 16 multiplications in the
+ * transformed domain instead of 36, and with MapConvolution() the
+ * multiplications of all the maps are 16 matrix products.  Other filter
+ * sizes, strides and dilations are computed with Im2ColConvolution.  This
+ * class allows specification of the type of the border type. The convolution
+ * can be computed with the valid border type of the full border type
+ * (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * The results are those of NaiveConvolution, up to rounding errors.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class WinogradConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    if (!UseWinograd(input.n_rows, input.n_cols, filter.n_rows, filter.n_cols,
+        dW, dH, dilationW, dilationH))
+    {
+      Im2ColConvolution<ValidConvolution>::Convolution(input, filter, output,
+          dW, dH, dilationW, dilationH);
+      return;
+    }
+
+    output.set_size(input.n_rows - 2, input.n_cols - 2);
+    const size_t tileRows = (output.n_rows + 1) / 2;
+    const size_t tileCols = (output.n_cols + 1) / 2;
+
+    // The tiles at the edges may need a row or a column of zeros.
+    arma::Mat<eT> inputPadded;
+    const arma::Mat<eT>& tiledInput = PadInput(input, tileRows, tileCols,
+        inputPadded);
+
+    eT u[16], v[16], y[4];
+    TransformFilter(filter.memptr(), u);
+    for (size_t tj = 0; tj < tileCols; ++tj)
+    {
+      for (size_t ti = 0; ti < tileRows; ++ti)
+      {
+        TransformInput(tiledInput.colptr(2 * tj) + 2 * ti, tiledInput.n_rows,
+            v);
+        for (size_t k = 0; k < 16; ++k)
+          v[k] *= u[k];
+
+        TransformOutput(v, y);
+        StoreTile(y, 2 * ti, 2 * tj, output.memptr(), output.n_rows,
+            output.n_cols);
+      }
+    }
+  }
+
+  /*
+   * Perform a convolution (full mode).  The input is zero-padded like
+   * NaiveConvolution does, and the valid convolution of the padded input is
+   * computed.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; ++i)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; ++i)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad filter and input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    WinogradConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Convolve each of the input maps with its filter for each of the output
+   * maps, and sum the results over the input maps (valid mode).  Filter slice
+   * o * input.n_slices + m is applied to input map m for output map o, which is
+   * the layout of the weights of the Convolution layer.  For each of the 16
+   * elements of the transformed tiles, the products for all tiles, input maps
+   * and output maps are one matrix product.
+   *
+   * @param input Input maps, one per slice.
+   * @param filter Filters, input.n_slices for each output map.
+   * @param output Output maps, one per slice.  If it already has the right
+   *     size, its memory is used.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  MapConvolution(const arma::Cube<eT>& input,
+                 const arma::Cube<eT>& filter,
+                 arma::Cube<eT>& output,
+                 const size_t dW = 1,
+                 const size_t dH = 1,
+                 const size_t dilationW = 1,
+                 const size_t dilationH = 1)
+  {
+    if (!UseWinograd(input.n_rows, input.n_cols, filter.n_rows, filter.n_cols,
+        dW, dH, dilationW, dilationH))
+    {
+      Im2ColConvolution<ValidConvolution>::MapConvolution(input, filter,
+          output, dW, dH, dilationW, dilationH);
+      return;
+    }
+
+    const size_t maps = input.n_slices;
+    const size_t outputMaps = filter.n_slices / maps;
+    output.set_size(input.n_rows - 2, input.n_cols - 2, outputMaps);
+    const size_t tileRows = (output.n_rows + 1) / 2;
+    const size_t tileCols = (output.n_cols + 1) / 2;
+    const size_t tiles = tileRows * tileCols;
+
+    eT t[16];
+
+    // Transform the filters: element k of the transformed filter of input map
+    // m for output map o is transformedFilter(m, o, k).
+    arma::Cube<eT> transformedFilter(maps, outputMaps, 16);
+    for (size_t o = 0; o < outputMaps; ++o)
+    {
+      for (size_t m = 0; m < maps; ++m)
+      {
+        TransformFilter(filter.slice_memptr(o * maps + m), t);
+        for (size_t k = 0; k < 16; ++k)
+          transformedFilter.at(m, o, k) = t[k];
+      }
+    }
+
+    // Transform the tiles of each input map.
+    arma::Cube<eT> transformedInput(tiles, maps, 16);
+    arma::Mat<eT> inputPadded;
+    for (size_t m = 0; m < maps; ++m)
+    {
+      const arma::Mat<eT> map(const_cast<eT*>(input.slice_memptr(m)),
+          input.n_rows, input.n_cols, false, true);
+      const arma::Mat<eT>& tiledInput = PadInput(map, tileRows, tileCols,
+          inputPadded);
+
+      for (size_t tj = 0, tile = 0; tj < tileCols; ++tj)
+      {
+        for (size_t ti = 0; ti < tileRows; ++ti, ++tile)
+        {
+          TransformInput(tiledInput.colptr(2 * tj) + 2 * ti,
+              tiledInput.n_rows, t);
+          for (size_t k = 0; k < 16; ++k)
+            transformedInput.at(tile, m, k) = t[k];
+        }
+      }
+    }
+
+    // Multiply and sum over the input maps in the transformed domain.
+    arma::Cube<eT> transformedOutput(tiles, outputMaps, 16);
+    for (size_t k = 0; k < 16; ++k)
+    {
+      transformedOutput.slice(k) = transformedInput.slice(k) *
+          transformedFilter.slice(k);
+    }
+
+    eT y[4];
+    for (size_t o = 0; o < outputMaps; ++o)
+    {
+      for (size_t tj = 0, tile = 0; tj < tileCols; ++tj)
+      {
+        for (size_t ti = 0; ti < tileRows; ++ti, ++tile)
+        {
+          for (size_t k = 0; k < 16; ++k)
+            t[k] = transformedOutput.at(tile, o, k);
+
+          TransformOutput(t, y);
+          StoreTile(y, 2 * ti, 2 * tj, output.slice_memptr(o), output.n_rows,
+              output.n_cols);
+        }
+      }
+    }
+  }
+
+ private:
+  //! Return whether F(2x2, 3x3) applies to the given convolution.
+  static bool UseWinograd(const size_t inputRows,
+                          const size_t inputCols,
+                          const size_t filterRows,
+                          const size_t filterCols,
+                          const size_t dW,
+                          const size_t dH,
+                          const size_t dilationW,
+                          const size_t dilationH)
+  {
+    return filterRows == 3 && filterCols == 3 && dW == 1 && dH == 1 &&
+        dilationW == 1 && dilationH == 1 && inputRows >= 3 && inputCols >= 3;
+  }
+
+  //! Return the input, or a copy of it padded with zeros to cover the given
+  //! number of tiles.
+  template<typename eT>
+  static const arma::Mat<eT>& PadInput(const arma::Mat<eT>& input,
+                                       const size_t tileRows,
+                                       const size_t tileCols,
+                                       arma::Mat<eT>& inputPadded)
+  {
+    if (input.n_rows == 2 * tileRows + 2 && input.n_cols == 2 * tileCols + 2)
+      return input;
+
+    inputPadded.zeros(2 * tileRows + 2, 2 * tileCols + 2);
+    inputPadded.submat(0, 0, input.n_rows - 1, input.n_cols - 1) = input;
+    return inputPadded;
+  }
+
+  //! Compute the transformed filter G g G^T of a 3x3 filter g; all matrices
+  //! are in column-major order.
+  template<typename eT>
+  static void TransformFilter(const eT* g, eT* u)
+  {
+    eT t[12];
+    for (size_t c = 0; c < 3; ++c)
+    {
+      const eT* col = g + 3 * c;
+      t[4 * c] = col[0];
+      t[4 * c + 1] = (col[0] + col[1] + col[2]) / 2;
+      t[4 * c + 2] = (col[0] - col[1] + col[2]) / 2;
+      t[4 * c + 3] = col[2];
+    }
+
+    for (size_t r = 0; r < 4; ++r)
+    {
+      u[r] = t[r];
+      u[4 + r] = (t[r] + t[4 + r] + t[8 + r]) / 2;
+      u[8 + r] = (t[r] - t[4 + r] + t[8 + r]) / 2;
+      u[12 + r] = t[8 + r];
+    }
+  }
+
+  //! Compute the transformed tile B^T d B of the 4x4 input tile d, whose
+  //! columns are ld elements apart.
+  template<typename eT>
+  static void TransformInput(const eT* d, const size_t ld, eT* v)
+  {
+    eT t[16];
+    for (size_t c = 0; c < 4; ++c)
+    {
+      const eT* col = d + c * ld;
+      t[4 * c] = col[0] - col[2];
+      t[4 * c + 1] = col[1] + col[2];
+      t[4 * c + 2] = col[2] - col[1];
+      t[4 * c + 3] = col[1] - col[3];
+    }
+
+    for (size_t r = 0; r < 4; ++r)
+    {
+      v[r] = t[r] - t[8 + r];
+      v[4 + r] = t[4 + r] + t[8 + r];
+      v[8 + r] = t[8 + r] - t[4 + r];
+      v[12 + r] = t[4 + r] - t[12 + r];
+    }
+  }
+
+  //! Compute the 2x2 output tile A^T m A of the transformed product m.
+  template<typename eT>
+  static void TransformOutput(const eT* m, eT* y)
+  {
+    eT t[8];
+    for (size_t c = 0; c < 4; ++c)
+    {
+      const eT* col = m + 4 * c;
+      t[2 * c] = col[0] + col[1] + col[2];
+      t[2 * c + 1] = col[1] - col[2] - col[3];
+    }
+
+    for (size_t r = 0; r < 2; ++r)
+    {
+      y[r] = t[r] + t[2 + r] + t[4 + r];
+      y[2 + r] = t[2 + r] - t[4 + r] - t[6 + r];
+    }
+  }
+
+  //! Store the part of a 2x2 output tile that is inside the output.
+  template<typename eT>
+  static void StoreTile(const eT* y,
+                        const size_t row,
+                        const size_t col,
+                        eT* output,
+                        const size_t outputRows,
+                        const size_t outputCols)
+  {
+    for (size_t c = 0; c < 2 && col + c < outputCols; ++c)
+      for (size_t r = 0; r < 2 && row + r < outputRows; ++r)
+        output[row + r + (col + c) * outputRows] = y[r + 2 * c];
+  }
+};  // class WinogradConvolution
+
+//! The valid WinogradConvolution can convolve all the maps of a layer at once.
+template<>
+class ConvolutionRuleTraits<WinogradConvolution<ValidConvolution> >
+{
+ public:
+  static const bool HasMapConvolution = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file methods/ann/data_loader/callback_source.hpp
+ *
+ * Definition of the CallbackSource class, which produces the chunks of a
+ * dataset with user-given functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_LOADER_CALLBACK_SOURCE_HPP
+#define MLPACK_METHODS_ANN_DATA_LOADER_CALLBACK_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <functional>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A data source for the PrefetchLoader that gets its chunks from a function,
+ * for datasets that are generated, read from a database, or stored in a
+ * format that data::Load() doesn't handle.  The next function fills the
+ * predictors and the responses of the next chunk and returns true, or returns
+ * false when the epoch is over; the reset function (if given) is called at the
+ * start of each epoch, with whether the epoch should be shuffled.  Both
+ * functions are called from the thread of the loader, never at the same time.
+ *
+ * For an RNN, InputType and OutputType are arma::cube, with one column per
+ * sequence.
+ *
+ * @code
+ * size_t chunk = 0;
+ * CallbackSource<> source(
+ *     [&](arma::mat& x, arma::mat& y) { return ReadChunk(chunk++, x, y); },
+ *     [&](const bool) { chunk = 0; });
+ * PrefetchLoader<CallbackSource<> > loader(std::move(source));
+ * @endcode
+ *
+ * @tparam InputDataType Type of the predictors of a chunk.
+ * @tparam OutputDataType Type of the responses of a chunk.
+ */
+template<typename InputDataType = arma::mat,
+         typename OutputDataType = arma::mat>
+class CallbackSource
+{
+ public:
+  //! The type of the predictors of a chunk.
+  typedef InputDataType InputType;
+  //! The type of the responses of a chunk.
+  typedef OutputDataType OutputType;
+
+  //! The type of the function that produces the next chunk.
+  typedef std::function<bool(InputType&, OutputType&)> NextFunction;
+  //! The type of the function that starts a new epoch.
+  typedef std::function<void(const bool)> ResetFunction;
+
+  /**
+   * Create the source from the given functions.
+   *
+   * @param next Function that produces the next chunk of the epoch.
+   * @param reset Function that starts a new epoch (optional).
+   */
+  CallbackSource(NextFunction next, ResetFunction reset = ResetFunction()) :
+      next(std::move(next)),
+      reset(std::move(reset))
+  {
+    /* Nothing to do here. */
+  }
+
+  /**
+   * Start a new epoch.
+   *
+   * @param generator Random number generator (unused; the reset function
+   *     should use its own generator).
+   * @param shuffle Whether the epoch should be shuffled.
+   */
+  void Reset(std::mt19937& /* generator */, const bool shuffle)
+  {
+    if (reset)
+      reset(shuffle);
+  }
+
+  /**
+   * Produce the next chunk of the epoch.
+   *
+   * @param predictors Object to store the predictors of the chunk into.
+   * @param responses Object to store the responses of the chunk into.
+   * @return false if the epoch is over.
+   */
+  bool Next(InputType& predictors, OutputType& responses)
+  {
+    return next(predictors, responses);
+  }
+
+ private:
+  //! The function that produces the next chunk.
+  NextFunction next;
+  //! The function that starts a new epoch.
+  ResetFunction reset;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
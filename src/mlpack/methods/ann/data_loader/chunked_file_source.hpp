@@ -0,0 +1,136 @@
+/**
+ * @file methods/ann/data_loader/chunked_file_source.hpp
+ *
+ * Definition of the ChunkedFileSource class, which reads a dataset that is
+ * split over several files, one chunk at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_LOADER_CHUNKED_FILE_SOURCE_HPP
+#define MLPACK_METHODS_ANN_DATA_LOADER_CHUNKED_FILE_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A data source for the PrefetchLoader that reads a dataset stored as several
+ * pairs of predictor and response files, in any format that data::Load()
+ * supports.  Each pair of files is one chunk, so only the chunks that are in
+ * the queue of the loader are held in memory.  When the epoch is shuffled, the
+ * order of the chunks is shuffled; the loader shuffles the points inside each
+ * chunk.
+ *
+ * @code
+ * ChunkedFileSource source({ "x0.csv", "x1.csv" }, { "y0.csv", "y1.csv" });
+ * PrefetchLoader<ChunkedFileSource> loader(std::move(source));
+ * model.Train(loader, optimizer, 10);
+ * @endcode
+ */
+class ChunkedFileSource
+{
+ public:
+  //! The type of the predictors of a chunk.
+  typedef arma::mat InputType;
+  //! The type of the responses of a chunk.
+  typedef arma::mat OutputType;
+
+  /**
+   * Create the source from the given list of files.  The i'th response file
+   * holds the responses of the points in the i'th predictor file.
+   *
+   * @param predictorFiles Files holding the predictors of each chunk.
+   * @param responseFiles Files holding the responses of each chunk.
+   * @param transpose Whether to transpose the files when loading them (see
+   *     data::Load()).
+   */
+  ChunkedFileSource(std::vector<std::string> predictorFiles,
+                    std::vector<std::string> responseFiles,
+                    const bool transpose = true) :
+      predictorFiles(std::move(predictorFiles)),
+      responseFiles(std::move(responseFiles)),
+      transpose(transpose),
+      position(0)
+  {
+    if (this->predictorFiles.size() != this->responseFiles.size())
+    {
+      std::ostringstream oss;
+      oss << "ChunkedFileSource::ChunkedFileSource(): the number of predictor "
+          << "files (" << this->predictorFiles.size() << ") does not match the "
+          << "number of response files (" << this->responseFiles.size()
+          << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    order.resize(this->predictorFiles.size());
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+  }
+
+  /**
+   * Start a new epoch.
+   *
+   * @param generator Random number generator used to shuffle the chunks.
+   * @param shuffle Whether to visit the chunks in a random order.
+   */
+  void Reset(std::mt19937& generator, const bool shuffle)
+  {
+    position = 0;
+    if (shuffle)
+      std::shuffle(order.begin(), order.end(), generator);
+  }
+
+  /**
+   * Load the next chunk of the epoch.  An exception is thrown if a file can't
+   * be loaded.
+   *
+   * @param predictors Matrix to load the predictors of the chunk into.
+   * @param responses Matrix to load the responses of the chunk into.
+   * @return false if the epoch is over.
+   */
+  bool Next(arma::mat& predictors, arma::mat& responses)
+  {
+    if (position == order.size())
+      return false;
+
+    const size_t chunk = order[position++];
+    data::Load(predictorFiles[chunk], predictors, true, transpose);
+    data::Load(responseFiles[chunk], responses, true, transpose);
+
+    if (predictors.n_cols != responses.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "ChunkedFileSource::Next(): '" << predictorFiles[chunk] << "' has "
+          << predictors.n_cols << " points, but '" << responseFiles[chunk]
+          << "' has " << responses.n_cols << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    return true;
+  }
+
+  //! Get the number of chunks.
+  size_t NumChunks() const { return order.size(); }
+
+ private:
+  //! The files holding the predictors of each chunk.
+  std::vector<std::string> predictorFiles;
+  //! The files holding the responses of each chunk.
+  std::vector<std::string> responseFiles;
+  //! Whether to transpose the files when loading them.
+  bool transpose;
+  //! The order in which the chunks are visited in this epoch.
+  std::vector<size_t> order;
+  //! The position of the next chunk in the order.
+  size_t position;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * @file methods/ann/data_loader/image_source.hpp
+ *
+ * Definition of the ImageSource class, which reads a set of image files in
+ * batches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_LOADER_IMAGE_SOURCE_HPP
+#define MLPACK_METHODS_ANN_DATA_LOADER_IMAGE_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load.hpp>
+#include <mlpack/core/data/image_info.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A data source for the PrefetchLoader that reads a list of image files with
+ * data::Load(), batchSize images at a time, so that the decoded images of the
+ * whole dataset never have to fit in memory.  All the images must have the
+ * same size.  The responses are given as a matrix with one column per image
+ * (for instance the class of each image), and are kept in memory.  When the
+ * epoch is shuffled, each batch is drawn from the whole list of images.
+ *
+ * @code
+ * std::vector<std::string> files = { "cat0.png", "dog0.png", ... };
+ * arma::mat labels = { { 1, 2, ... } };
+ * ImageSource source(files, labels, 256, data::ImageInfo(32, 32, 3));
+ * PrefetchLoader<ImageSource> loader(std::move(source));
+ * model.Train(loader, optimizer, 10);
+ * @endcode
+ */
+class ImageSource
+{
+ public:
+  //! The type of the predictors of a batch.
+  typedef arma::mat InputType;
+  //! The type of the responses of a batch.
+  typedef arma::mat OutputType;
+
+  /**
+   * Create the source from the given list of images.
+   *
+   * @param files Files holding the images.
+   * @param responses Responses of the images, one column per image.
+   * @param batchSize Number of images to load at once.
+   * @param info Information about the images (see data::Load()).
+   */
+  ImageSource(std::vector<std::string> files,
+              arma::mat responses,
+              const size_t batchSize,
+              const data::ImageInfo& info = data::ImageInfo()) :
+      files(std::move(files)),
+      responses(std::move(responses)),
+      batchSize(batchSize),
+      info(info),
+      position(0)
+  {
+    if (this->files.size() != this->responses.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "ImageSource::ImageSource(): the number of images ("
+          << this->files.size() << ") does not match the number of responses ("
+          << this->responses.n_cols << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (batchSize == 0)
+    {
+      throw std::invalid_argument("ImageSource::ImageSource(): the batch size "
+          "must be positive!");
+    }
+
+    order.set_size(this->files.size());
+    for (size_t i = 0; i < order.n_elem; ++i)
+      order[i] = i;
+  }
+
+  /**
+   * Start a new epoch.
+   *
+   * @param generator Random number generator used to shuffle the images.
+   * @param shuffle Whether to visit the images in a random order.
+   */
+  void Reset(std::mt19937& generator, const bool shuffle)
+  {
+    position = 0;
+    if (shuffle)
+      std::shuffle(order.begin(), order.end(), generator);
+  }
+
+  /**
+   * Load the next batch of images of the epoch.  An exception is thrown if an
+   * image can't be loaded.
+   *
+   * @param predictors Matrix to load the images into, one column per image.
+   * @param batchResponses Matrix to store the responses of the images into.
+   * @return false if the epoch is over.
+   */
+  bool Next(arma::mat& predictors, arma::mat& batchResponses)
+  {
+    if (position == files.size())
+      return false;
+
+    const size_t last = std::min(position + batchSize, files.size());
+    const arma::uvec indices = order.subvec(position, last - 1);
+    position = last;
+
+    std::vector<std::string> batchFiles(indices.n_elem);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      batchFiles[i] = files[indices[i]];
+
+    data::Load(batchFiles, predictors, info, true);
+    batchResponses = responses.cols(indices);
+    return true;
+  }
+
+  //! Get the number of images.
+  size_t NumImages() const { return files.size(); }
+
+  //! Get the information about the images.
+  const data::ImageInfo& Info() const { return info; }
+
+ private:
+  //! The files holding the images.
+  std::vector<std::string> files;
+  //! The responses of the images.
+  arma::mat responses;
+  //! The number of images to load at once.
+  size_t batchSize;
+  //! Information about the images.
+  data::ImageInfo info;
+  //! The order in which the images are visited in this epoch.
+  arma::uvec order;
+  //! The position of the next image in the order.
+  size_t position;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
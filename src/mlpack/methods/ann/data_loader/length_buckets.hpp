@@ -0,0 +1,61 @@
+/**
+ * @file methods/ann/data_loader/length_buckets.hpp
+ *
+ * A sampler that orders variable-length sequences so that the consecutive
+ * batches taken by an optimizer hold sequences of similar lengths.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_LOADER_LENGTH_BUCKETS_HPP
+#define MLPACK_METHODS_ANN_DATA_LOADER_LENGTH_BUCKETS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Get a random ordering of the sequences of the given lengths where the
+ * sequences are grouped by length: the sequences are shuffled, split into
+ * buckets of the given number of sequences, and the sequences of each bucket
+ * are sorted by decreasing length.  Any batch of consecutive sequences then
+ * holds sequences of similar lengths (within a bucket, the first sequence of
+ * the batch is the longest one), so little computation is spent on padding,
+ * while the order of the buckets is still random from one epoch to the next.
+ *
+ * @param lengths The number of steps of each sequence.
+ * @param bucketSize The number of sequences of each bucket (0 sorts all the
+ *     sequences together).
+ * @return The ordering: element i is the index of the i'th sequence.
+ */
+inline arma::uvec BucketOrdering(const arma::Row<size_t>& lengths,
+                                 const size_t bucketSize)
+{
+  arma::uvec ordering;
+  if (lengths.n_elem == 0)
+    return ordering;
+
+  ordering = arma::shuffle(arma::linspace<arma::uvec>(0, lengths.n_elem - 1,
+      lengths.n_elem));
+
+  const size_t step = (bucketSize == 0) ? lengths.n_elem : bucketSize;
+  for (size_t begin = 0; begin < ordering.n_elem; begin += step)
+  {
+    const size_t end = std::min(begin + step, (size_t) ordering.n_elem);
+    std::stable_sort(ordering.begin() + begin, ordering.begin() + end,
+        [&lengths](const arma::uword a, const arma::uword b)
+        {
+          return lengths[a] > lengths[b];
+        });
+  }
+
+  return ordering;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
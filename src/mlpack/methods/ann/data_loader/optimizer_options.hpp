@@ -0,0 +1,76 @@
+/**
+ * @file methods/ann/data_loader/optimizer_options.hpp
+ *
+ * Helpers to set the options of an ensmallen optimizer that matter when it is
+ * run once per chunk of a streamed dataset, for optimizers that have them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_LOADER_OPTIMIZER_OPTIONS_HPP
+#define MLPACK_METHODS_ANN_DATA_LOADER_OPTIMIZER_OPTIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Set the maximum number of iterations of the optimizer, and return the
+ * previous value.
+ */
+template<typename OptimizerType>
+typename std::enable_if<
+    HasMaxIterations<OptimizerType, size_t&(OptimizerType::*)()>::value,
+    size_t>::type
+SwapMaxIterations(OptimizerType& optimizer, const size_t maxIterations)
+{
+  const size_t previous = optimizer.MaxIterations();
+  optimizer.MaxIterations() = maxIterations;
+  return previous;
+}
+
+//! The optimizer has no maximum number of iterations; do nothing.
+template<typename OptimizerType>
+typename std::enable_if<
+    !HasMaxIterations<OptimizerType, size_t&(OptimizerType::*)()>::value,
+    size_t>::type
+SwapMaxIterations(OptimizerType& /* optimizer */,
+                  const size_t /* maxIterations */)
+{
+  return 0;
+}
+
+/**
+ * Set whether the optimizer resets the state of its update policy (for
+ * instance the moment estimates of Adam) when Optimize() is called, and return
+ * the previous value.
+ */
+template<typename OptimizerType>
+typename std::enable_if<
+    HasResetPolicy<OptimizerType, bool&(OptimizerType::*)()>::value,
+    bool>::type
+SwapResetPolicy(OptimizerType& optimizer, const bool resetPolicy)
+{
+  const bool previous = optimizer.ResetPolicy();
+  optimizer.ResetPolicy() = resetPolicy;
+  return previous;
+}
+
+//! The optimizer has no update policy to reset; do nothing.
+template<typename OptimizerType>
+typename std::enable_if<
+    !HasResetPolicy<OptimizerType, bool&(OptimizerType::*)()>::value,
+    bool>::type
+SwapResetPolicy(OptimizerType& /* optimizer */, const bool /* resetPolicy */)
+{
+  return true;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
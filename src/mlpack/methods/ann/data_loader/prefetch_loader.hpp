@@ -0,0 +1,197 @@
+/**
+ * @file methods/ann/data_loader/prefetch_loader.hpp
+ *
+ * Definition of the PrefetchLoader class, which reads and shuffles the next
+ * chunks of a dataset on a background thread while the network trains on the
+ * current one.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_LOADER_PREFETCH_LOADER_HPP
+#define MLPACK_METHODS_ANN_DATA_LOADER_PREFETCH_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "chunked_file_source.hpp"
+#include "image_source.hpp"
+#include "callback_source.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A loader that streams a dataset to FFN::Train() or RNN::Train() in chunks,
+ * so that datasets that don't fit in memory can be trained on.  A background
+ * thread reads the next chunks from the source, shuffles the points of each
+ * chunk, and keeps up to QueueSize() chunks ready, so that reading the data
+ * overlaps with training.  The thread goes on into the next epoch when the
+ * current one is read, so there is no stall at the start of an epoch either.
+ * Only the chunks in the queue and the chunk being trained on are held in
+ * memory.
+ *
+ * The source must provide:
+ *
+ * @code
+ * typedef ... InputType;  // Type of the predictors of a chunk.
+ * typedef ... OutputType; // Type of the responses of a chunk.
+ *
+ * // Start a new epoch, visiting the chunks in a random order if shuffle is
+ * // true.
+ * void Reset(std::mt19937& generator, const bool shuffle);
+ *
+ * // Read the next chunk of the epoch, or return false if it is over.
+ * bool Next(InputType& predictors, OutputType& responses);
+ * @endcode
+ *
+ * ChunkedFileSource, ImageSource and CallbackSource are available.  The source
+ * is only used by the background thread while it is running.  An exception
+ * thrown by the source is rethrown by Next(), once the chunks read before it
+ * have been returned.
+ *
+ * @code
+ * PrefetchLoader<ChunkedFileSource> loader(ChunkedFileSource(
+ *     { "x0.csv", "x1.csv" }, { "y0.csv", "y1.csv" }));
+ *
+ * arma::mat x, y;
+ * while (loader.Next(x, y))
+ * {
+ *   // ... use the chunk ...
+ * }
+ * @endcode
+ *
+ * @tparam SourceType Type of the source of the chunks.
+ */
+template<typename SourceType>
+class PrefetchLoader
+{
+ public:
+  //! The type of the predictors of a chunk.
+  typedef typename SourceType::InputType InputType;
+  //! The type of the responses of a chunk.
+  typedef typename SourceType::OutputType OutputType;
+
+  /**
+   * Create the loader.  The background thread is started by the first call to
+   * Next().
+   *
+   * @param source Source of the chunks.
+   * @param queueSize Maximum number of chunks to read ahead.
+   * @param shuffle Whether to shuffle the chunks and the points in each chunk.
+   */
+  PrefetchLoader(SourceType source,
+                 const size_t queueSize = 2,
+                 const bool shuffle = true);
+
+  //! Stop the background thread.
+  ~PrefetchLoader();
+
+  // The thread refers to this object, so it can't be copied or moved.
+  PrefetchLoader(const PrefetchLoader&) = delete;
+  PrefetchLoader& operator=(const PrefetchLoader&) = delete;
+
+  /**
+   * Get the next chunk of the current epoch.  When the epoch is over, false is
+   * returned, and the next call returns the first chunk of the next epoch.
+   *
+   * @param predictors Object to move the predictors of the chunk into.
+   * @param responses Object to move the responses of the chunk into.
+   * @return false if the epoch is over.
+   */
+  bool Next(InputType& predictors, OutputType& responses);
+
+  /**
+   * Stop the background thread and discard the chunks that were read ahead.
+   * The next call to Next() starts the thread again, at the start of a new
+   * epoch.
+   */
+  void Reset();
+
+  //! Get the source.  It must not be modified while the thread is running.
+  const SourceType& Source() const { return source; }
+  //! Modify the source.  This calls Reset().
+  SourceType& Source() { Reset(); return source; }
+
+  //! Get the maximum number of chunks read ahead.
+  size_t QueueSize() const { return queueSize; }
+
+  //! Get whether the chunks are shuffled.
+  bool Shuffle() const { return shuffle; }
+
+ private:
+  //! A chunk in the queue; an empty chunk with last set marks the end of an
+  //! epoch.
+  struct Chunk
+  {
+    InputType predictors;
+    OutputType responses;
+    bool last;
+  };
+
+  //! Read chunks into the queue until Reset() is called; run by the thread.
+  void Work();
+
+  //! Add the given chunk to the queue, waiting for room; return false if the
+  //! thread was stopped.
+  bool Push(Chunk&& chunk);
+
+  //! Reorder the points (columns) of the given matrix.
+  template<typename eT>
+  static void ShuffleColumns(arma::Mat<eT>& data, const arma::uvec& ordering);
+
+  //! Reorder the sequences (columns) of the given cube, as used by the RNN.
+  template<typename eT>
+  static void ShuffleColumns(arma::Cube<eT>& data, const arma::uvec& ordering);
+
+  //! The source of the chunks.
+  SourceType source;
+
+  //! The maximum number of chunks read ahead.
+  size_t queueSize;
+
+  //! Whether to shuffle the chunks and their points.
+  bool shuffle;
+
+  //! The random number generator used by the thread.
+  std::mt19937 generator;
+
+  //! The background thread.
+  std::thread thread;
+
+  //! The chunks that were read ahead.
+  std::deque<Chunk> queue;
+
+  //! Protects the queue, stop, done and error.
+  std::mutex mutex;
+
+  //! Signalled when a chunk is added to the queue or the thread is done.
+  std::condition_variable notEmpty;
+
+  //! Signalled when a chunk is taken from the queue or the thread is stopped.
+  std::condition_variable notFull;
+
+  //! Set to ask the thread to stop.
+  bool stop;
+
+  //! Set when the thread has stopped on its own (because of an error).
+  bool done;
+
+  //! The exception thrown by the source, if any.
+  std::exception_ptr error;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "prefetch_loader_impl.hpp"
+
+#endif
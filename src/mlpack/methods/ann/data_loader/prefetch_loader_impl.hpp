@@ -0,0 +1,181 @@
+/**
+ * @file methods/ann/data_loader/prefetch_loader_impl.hpp
+ *
+ * Implementation of the PrefetchLoader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_LOADER_PREFETCH_LOADER_IMPL_HPP
+#define MLPACK_METHODS_ANN_DATA_LOADER_PREFETCH_LOADER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "prefetch_loader.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename SourceType>
+PrefetchLoader<SourceType>::PrefetchLoader(SourceType source,
+                                           const size_t queueSize,
+                                           const bool shuffle) :
+    source(std::move(source)),
+    queueSize(queueSize),
+    shuffle(shuffle),
+    generator((uint32_t) math::RandInt(std::numeric_limits<int>::max())),
+    stop(false),
+    done(false)
+{
+  if (queueSize == 0)
+  {
+    throw std::invalid_argument("PrefetchLoader::PrefetchLoader(): the queue "
+        "size must be positive!");
+  }
+}
+
+template<typename SourceType>
+PrefetchLoader<SourceType>::~PrefetchLoader()
+{
+  Reset();
+}
+
+template<typename SourceType>
+bool PrefetchLoader<SourceType>::Next(InputType& predictors,
+                                      OutputType& responses)
+{
+  if (!thread.joinable())
+  {
+    stop = false;
+    done = false;
+    error = nullptr;
+    thread = std::thread(&PrefetchLoader::Work, this);
+  }
+
+  Chunk chunk;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [this]() { return !queue.empty() || done; });
+
+    if (queue.empty())
+    {
+      // The thread stopped because the source threw; it is restarted by the
+      // next call.
+      std::exception_ptr e = error;
+      error = nullptr;
+      lock.unlock();
+      thread.join();
+      std::rethrow_exception(e);
+    }
+
+    chunk = std::move(queue.front());
+    queue.pop_front();
+  }
+  notFull.notify_one();
+
+  if (chunk.last)
+    return false;
+
+  predictors = std::move(chunk.predictors);
+  responses = std::move(chunk.responses);
+  return true;
+}
+
+template<typename SourceType>
+void PrefetchLoader<SourceType>::Reset()
+{
+  if (!thread.joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    stop = true;
+  }
+  notFull.notify_all();
+  thread.join();
+
+  queue.clear();
+}
+
+template<typename SourceType>
+void PrefetchLoader<SourceType>::Work()
+{
+  try
+  {
+    while (true)
+    {
+      source.Reset(generator, shuffle);
+
+      Chunk chunk;
+      chunk.last = false;
+      while (source.Next(chunk.predictors, chunk.responses))
+      {
+        if (shuffle && chunk.predictors.n_cols > 1)
+        {
+          arma::uvec ordering(chunk.predictors.n_cols);
+          for (size_t i = 0; i < ordering.n_elem; ++i)
+            ordering[i] = i;
+          std::shuffle(ordering.begin(), ordering.end(), generator);
+
+          ShuffleColumns(chunk.predictors, ordering);
+          ShuffleColumns(chunk.responses, ordering);
+        }
+
+        if (!Push(std::move(chunk)))
+          return;
+
+        chunk = Chunk();
+        chunk.last = false;
+      }
+
+      chunk.last = true;
+      if (!Push(std::move(chunk)))
+        return;
+    }
+  }
+  catch (...)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    error = std::current_exception();
+    done = true;
+    notEmpty.notify_all();
+  }
+}
+
+template<typename SourceType>
+bool PrefetchLoader<SourceType>::Push(Chunk&& chunk)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  notFull.wait(lock, [this]() { return stop || queue.size() < queueSize; });
+  if (stop)
+    return false;
+
+  queue.push_back(std::move(chunk));
+  notEmpty.notify_one();
+  return true;
+}
+
+template<typename SourceType>
+template<typename eT>
+void PrefetchLoader<SourceType>::ShuffleColumns(arma::Mat<eT>& data,
+                                                const arma::uvec& ordering)
+{
+  data = data.cols(ordering);
+}
+
+template<typename SourceType>
+template<typename eT>
+void PrefetchLoader<SourceType>::ShuffleColumns(arma::Cube<eT>& data,
+                                                const arma::uvec& ordering)
+{
+  for (size_t s = 0; s < data.n_slices; ++s)
+    data.slice(s) = data.slice(s).cols(ordering);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @file methods/ann/distributed/distributed_function.hpp
+ *
+ * Definition of the DistributedFunction class, which wraps the function that
+ * each process optimizes so that the objectives and the gradients are averaged
+ * over all the processes.  This is only available if mlpack was built with MPI
+ * (USE_MPI).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DISTRIBUTED_DISTRIBUTED_FUNCTION_HPP
+#define MLPACK_METHODS_ANN_DISTRIBUTED_DISTRIBUTED_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_MPI
+
+#include "ring_allreduce.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The DistributedFunction wraps a separable function (such as an FFN) that a
+ * process evaluates on its own shard of the data.  Every evaluation of the
+ * objective or of the gradient is averaged over all the processes of the
+ * communicator, with a ring allreduce for the gradient, so that the optimizer
+ * of each process sees exactly the same values and takes exactly the same
+ * steps.
+ *
+ * All the processes must therefore evaluate the function the same number of
+ * times: the number of functions is the smallest number of points of the
+ * shards, and the points of the larger shards past it are not used in an
+ * epoch (shuffling changes which ones).
+ *
+ * @tparam FunctionType Type of the function evaluated by each process.
+ */
+template<typename FunctionType>
+class DistributedFunction
+{
+ public:
+  /**
+   * Wrap the given function.  This must be called by all the processes of the
+   * communicator.
+   *
+   * @param function The function evaluated on the shard of this process.
+   * @param comm The communicator of the processes.
+   * @param bucketSize The maximum number of elements of the gradient reduced
+   *     at once.
+   */
+  DistributedFunction(FunctionType& function,
+                      MPI_Comm comm,
+                      const size_t bucketSize) :
+      function(function),
+      comm(comm),
+      bucketSize(bucketSize)
+  {
+    MPI_Comm_size(comm, &processes);
+
+    unsigned long long localFunctions = function.NumFunctions();
+    unsigned long long minFunctions;
+    MPI_Allreduce(&localFunctions, &minFunctions, 1, MPI_UNSIGNED_LONG_LONG,
+        MPI_MIN, comm);
+    numFunctions = minFunctions;
+  }
+
+  //! Return the number of functions, the same on all processes.
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Shuffle the points of the shard of this process.
+  void Shuffle() { function.Shuffle(); }
+
+  /**
+   * Evaluate the objective over the whole shards.
+   *
+   * @param parameters The parameters.
+   */
+  double Evaluate(const arma::mat& parameters)
+  {
+    return Average(function.Evaluate(parameters));
+  }
+
+  /**
+   * Evaluate the objective on the given batch of each shard.
+   *
+   * @param parameters The parameters.
+   * @param begin The first point of the batch.
+   * @param batchSize The number of points of the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize)
+  {
+    return Average(function.Evaluate(parameters, begin, batchSize));
+  }
+
+  /**
+   * Evaluate the objective and the gradient over the whole shards.
+   *
+   * @param parameters The parameters.
+   * @param gradient Matrix to store the averaged gradient into.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters, GradType& gradient)
+  {
+    const double objective = function.EvaluateWithGradient(parameters,
+        gradient);
+    AverageGradient(gradient);
+    return Average(objective);
+  }
+
+  /**
+   * Evaluate the objective and the gradient on the given batch of each shard.
+   *
+   * @param parameters The parameters.
+   * @param begin The first point of the batch.
+   * @param gradient Matrix to store the averaged gradient into.
+   * @param batchSize The number of points of the batch.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              GradType& gradient,
+                              const size_t batchSize)
+  {
+    const double objective = function.EvaluateWithGradient(parameters, begin,
+        gradient, batchSize);
+    AverageGradient(gradient);
+    return Average(objective);
+  }
+
+  /**
+   * Evaluate the gradient on the given batch of each shard.
+   *
+   * @param parameters The parameters.
+   * @param begin The first point of the batch.
+   * @param gradient Matrix to store the averaged gradient into.
+   * @param batchSize The number of points of the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize)
+  {
+    function.Gradient(parameters, begin, gradient, batchSize);
+    AverageGradient(gradient);
+  }
+
+  //! Get the wrapped function.
+  FunctionType& Function() { return function; }
+
+ private:
+  //! Average the given value over the processes.
+  double Average(const double value) const
+  {
+    double local = value, sum;
+    MPI_Allreduce(&local, &sum, 1, MPI_DOUBLE, MPI_SUM, comm);
+    return sum / processes;
+  }
+
+  //! Average the given gradient over the processes, in place.
+  template<typename GradType>
+  void AverageGradient(GradType& gradient)
+  {
+    RingAllReduce(gradient.memptr(), gradient.n_elem, comm, bucketSize,
+        buffer);
+    gradient /= processes;
+  }
+
+  //! The function evaluated on the shard of this process.
+  FunctionType& function;
+
+  //! The communicator of the processes.
+  MPI_Comm comm;
+
+  //! The number of processes.
+  int processes;
+
+  //! The smallest number of points of the shards.
+  size_t numFunctions;
+
+  //! The maximum number of elements of the gradient reduced at once.
+  size_t bucketSize;
+
+  //! The receive buffer of the allreduce.
+  std::vector<double> buffer;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif // HAS_MPI
+
+#endif
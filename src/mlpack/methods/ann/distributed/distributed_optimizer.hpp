@@ -0,0 +1,136 @@
+/**
+ * @file methods/ann/distributed/distributed_optimizer.hpp
+ *
+ * Definition of the DistributedOptimizer class, which wraps an ensmallen
+ * optimizer to train a model on several MPI processes with synchronous data
+ * parallelism.  This is only available if mlpack was built with MPI
+ * (USE_MPI).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DISTRIBUTED_DISTRIBUTED_OPTIMIZER_HPP
+#define MLPACK_METHODS_ANN_DISTRIBUTED_DISTRIBUTED_OPTIMIZER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_MPI
+
+#include "distributed_function.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The DistributedOptimizer trains a model on all the processes of an MPI
+ * communicator at once.  Each process holds its own shard of the training data
+ * and runs the wrapped optimizer on it; the parameters of the process with
+ * rank 0 are broadcast to the others when the optimization starts, and, at
+ * every step, the objectives and the gradients of the batches of all the
+ * processes are averaged (see DistributedFunction), so that all the processes
+ * take the same steps and keep the same parameters.  A step thus uses
+ * batchSize points of each process.
+ *
+ * The gradients are summed with a ring allreduce, in buckets of BucketSize()
+ * elements, so that the traffic of each process doesn't grow with the number
+ * of processes.
+ *
+ * It can be passed to FFN::Train() in place of the optimizer it wraps.  MPI
+ * must have been initialized by the program, and all the processes must call
+ * Train() with the same model and the same optimizer settings:
+ *
+ * @code
+ * MPI_Init(&argc, &argv);
+ * int rank, processes;
+ * MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+ * MPI_Comm_size(MPI_COMM_WORLD, &processes);
+ *
+ * // Each process loads its own shard of the dataset.
+ * arma::mat x, y;
+ * data::Load("x_" + std::to_string(rank) + ".csv", x, true);
+ * data::Load("y_" + std::to_string(rank) + ".csv", y, true);
+ *
+ * FFN<NegativeLogLikelihood<> > model;
+ * // ... add layers ...
+ * DistributedOptimizer<ens::Adam> optimizer(ens::Adam(0.001, 64));
+ * model.Train(x, y, optimizer);
+ *
+ * if (rank == 0)
+ *   data::Save("model.bin", "model", model);
+ * MPI_Finalize();
+ * @endcode
+ *
+ * @tparam OptimizerType Type of the wrapped ensmallen optimizer.
+ */
+template<typename OptimizerType>
+class DistributedOptimizer
+{
+ public:
+  /**
+   * Wrap the given optimizer.
+   *
+   * @param optimizer The optimizer run by each process.
+   * @param comm The communicator of the processes.
+   * @param bucketSize The maximum number of elements of the gradient reduced
+   *     (or of the parameters broadcast) at once.
+   */
+  DistributedOptimizer(OptimizerType optimizer = OptimizerType(),
+                       MPI_Comm comm = MPI_COMM_WORLD,
+                       const size_t bucketSize = 1 << 22);
+
+  /**
+   * Optimize the given function, starting from the given parameters of the
+   * process with rank 0.  This must be called by all the processes of the
+   * communicator.
+   *
+   * @param function The function to optimize on the shard of this process.
+   * @param parameters The starting point; it is overwritten by the result.
+   * @param callbacks Callbacks for the wrapped optimizer.
+   * @return The objective of the final point, averaged over the processes.
+   */
+  template<typename FunctionType, typename MatType, typename... CallbackTypes>
+  typename MatType::elem_type Optimize(FunctionType& function,
+                                       MatType& parameters,
+                                       CallbackTypes&&... callbacks);
+
+  //! Get the wrapped optimizer.
+  const OptimizerType& Optimizer() const { return optimizer; }
+  //! Modify the wrapped optimizer.
+  OptimizerType& Optimizer() { return optimizer; }
+
+  //! Get the communicator of the processes.
+  MPI_Comm Comm() const { return comm; }
+
+  //! Get the maximum number of elements reduced at once.
+  size_t BucketSize() const { return bucketSize; }
+  //! Modify the maximum number of elements reduced at once.
+  size_t& BucketSize() { return bucketSize; }
+
+  //! Get the rank of this process.
+  int Rank() const;
+
+  //! Get the number of processes.
+  int Processes() const;
+
+ private:
+  //! The wrapped optimizer.
+  OptimizerType optimizer;
+
+  //! The communicator of the processes.
+  MPI_Comm comm;
+
+  //! The maximum number of elements reduced at once.
+  size_t bucketSize;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_optimizer_impl.hpp"
+
+#endif // HAS_MPI
+
+#endif
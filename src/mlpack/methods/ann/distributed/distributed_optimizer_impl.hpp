@@ -0,0 +1,98 @@
+/**
+ * @file methods/ann/distributed/distributed_optimizer_impl.hpp
+ *
+ * Implementation of the DistributedOptimizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DISTRIBUTED_DISTRIBUTED_OPTIMIZER_IMPL_HPP
+#define MLPACK_METHODS_ANN_DISTRIBUTED_DISTRIBUTED_OPTIMIZER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_optimizer.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OptimizerType>
+DistributedOptimizer<OptimizerType>::DistributedOptimizer(
+    OptimizerType optimizer,
+    MPI_Comm comm,
+    const size_t bucketSize) :
+    optimizer(std::move(optimizer)),
+    comm(comm),
+    bucketSize(bucketSize)
+{
+  if (bucketSize == 0)
+  {
+    throw std::invalid_argument("DistributedOptimizer::DistributedOptimizer(): "
+        "the bucket size must be positive!");
+  }
+}
+
+template<typename OptimizerType>
+template<typename FunctionType, typename MatType, typename... CallbackTypes>
+typename MatType::elem_type DistributedOptimizer<OptimizerType>::Optimize(
+    FunctionType& function,
+    MatType& parameters,
+    CallbackTypes&&... callbacks)
+{
+  static_assert(std::is_same<typename MatType::elem_type, double>::value,
+      "DistributedOptimizer: the parameters must be a matrix of doubles.");
+
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if (!initialized)
+  {
+    throw std::logic_error("DistributedOptimizer::Optimize(): MPI must be "
+        "initialized with MPI_Init() first!");
+  }
+
+  // All the processes must have the same number of parameters, or the
+  // collective operations below would not match.
+  unsigned long long localSize = parameters.n_elem, minSize, maxSize;
+  MPI_Allreduce(&localSize, &minSize, 1, MPI_UNSIGNED_LONG_LONG, MPI_MIN,
+      comm);
+  MPI_Allreduce(&localSize, &maxSize, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX,
+      comm);
+  if (minSize != maxSize)
+  {
+    std::ostringstream oss;
+    oss << "DistributedOptimizer::Optimize(): the processes have different "
+        << "numbers of parameters (from " << minSize << " to " << maxSize
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Start all the processes from the parameters of the first one.
+  BucketBroadcast(parameters.memptr(), parameters.n_elem, comm, bucketSize);
+
+  DistributedFunction<FunctionType> distributedFunction(function, comm,
+      bucketSize);
+  return optimizer.Optimize(distributedFunction, parameters,
+      std::forward<CallbackTypes>(callbacks)...);
+}
+
+template<typename OptimizerType>
+int DistributedOptimizer<OptimizerType>::Rank() const
+{
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  return rank;
+}
+
+template<typename OptimizerType>
+int DistributedOptimizer<OptimizerType>::Processes() const
+{
+  int processes;
+  MPI_Comm_size(comm, &processes);
+  return processes;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
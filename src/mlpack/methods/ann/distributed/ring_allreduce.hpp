@@ -0,0 +1,129 @@
+/**
+ * @file methods/ann/distributed/ring_allreduce.hpp
+ *
+ * A bucketed ring allreduce and a bucketed broadcast of a buffer of doubles
+ * over MPI, used by the DistributedOptimizer.  This is only available if mlpack
+ * was built with MPI (USE_MPI).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DISTRIBUTED_RING_ALLREDUCE_HPP
+#define MLPACK_METHODS_ANN_DISTRIBUTED_RING_ALLREDUCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_MPI
+
+#include <mpi.h>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Sum the given buffer over all the processes of the communicator, in place,
+ * with the ring algorithm: the buffer is split into one segment per process,
+ * each segment is summed while it travels once around the ring
+ * (reduce-scatter), and the sums are then passed around the ring again
+ * (allgather).  Each process sends and receives about 2 * n doubles in total,
+ * whatever the number of processes, and every process ends with exactly the
+ * same sums.
+ *
+ * The buffer is processed in buckets of at most bucketSize elements, which
+ * bounds the size of the messages and of the receive buffer.
+ *
+ * @param data The buffer to sum.
+ * @param n The number of elements of the buffer.
+ * @param comm The communicator of the processes.
+ * @param bucketSize The maximum number of elements reduced at once.
+ * @param buffer Receive buffer (resized as needed).
+ */
+inline void RingAllReduce(double* data,
+                          const size_t n,
+                          MPI_Comm comm,
+                          const size_t bucketSize,
+                          std::vector<double>& buffer)
+{
+  int rank, processes;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &processes);
+  if (processes == 1 || n == 0)
+    return;
+
+  const size_t p = processes;
+  const int next = (rank + 1) % processes;
+  const int previous = (rank + processes - 1) % processes;
+
+  for (size_t bucket = 0; bucket < n; bucket += bucketSize)
+  {
+    double* bucketData = data + bucket;
+    const size_t bucketElements = std::min(bucketSize, n - bucket);
+
+    // The bounds of the segment of each process in the bucket.
+    std::vector<size_t> bounds(p + 1);
+    for (size_t k = 0; k <= p; ++k)
+      bounds[k] = k * bucketElements / p;
+    buffer.resize(bucketElements / p + 1);
+
+    // Reduce-scatter: after p - 1 steps, each process holds the sum of the
+    // segment that follows its own.
+    for (size_t s = 0; s < p - 1; ++s)
+    {
+      const size_t send = (rank + p - s) % p;
+      const size_t receive = (rank + 2 * p - s - 1) % p;
+
+      MPI_Sendrecv(bucketData + bounds[send],
+          (int) (bounds[send + 1] - bounds[send]), MPI_DOUBLE, next, 0,
+          buffer.data(), (int) (bounds[receive + 1] - bounds[receive]),
+          MPI_DOUBLE, previous, 0, comm, MPI_STATUS_IGNORE);
+
+      for (size_t i = bounds[receive]; i < bounds[receive + 1]; ++i)
+        bucketData[i] += buffer[i - bounds[receive]];
+    }
+
+    // Allgather: pass the summed segments around the ring.
+    for (size_t s = 0; s < p - 1; ++s)
+    {
+      const size_t send = (rank + p + 1 - s) % p;
+      const size_t receive = (rank + p - s) % p;
+
+      MPI_Sendrecv(bucketData + bounds[send],
+          (int) (bounds[send + 1] - bounds[send]), MPI_DOUBLE, next, 1,
+          bucketData + bounds[receive],
+          (int) (bounds[receive + 1] - bounds[receive]), MPI_DOUBLE, previous,
+          1, comm, MPI_STATUS_IGNORE);
+    }
+  }
+}
+
+/**
+ * Broadcast the given buffer from the given process to all the processes of
+ * the communicator, in buckets of at most bucketSize elements.
+ *
+ * @param data The buffer to broadcast.
+ * @param n The number of elements of the buffer.
+ * @param comm The communicator of the processes.
+ * @param bucketSize The maximum number of elements sent at once.
+ * @param root The process that holds the buffer to send.
+ */
+inline void BucketBroadcast(double* data,
+                            const size_t n,
+                            MPI_Comm comm,
+                            const size_t bucketSize,
+                            const int root = 0)
+{
+  for (size_t bucket = 0; bucket < n; bucket += bucketSize)
+  {
+    MPI_Bcast(data + bucket, (int) std::min(bucketSize, n - bucket),
+        MPI_DOUBLE, root, comm);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif // HAS_MPI
+
+#endif
@@ -13,7 +13,8 @@
 #ifndef MLPACK_METHODS_ANN_FFN_HPP
 #define MLPACK_METHODS_ANN_FFN_HPP
 
-#include <mlpack/prereqs.hpp>
+#include <mlpack/core.hpp>
+#include <memory>
 
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
@@ -26,6 +27,10 @@
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "layer_fusion.hpp"
+#include "layer_profiler.hpp"
+#include "magnitude_pruning.hpp"
+#include "data_loader/prefetch_loader.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -163,6 +168,79 @@ class FFN
                arma::mat responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the feedforward network on the given sparse input data (such as
+   * one-hot or bag-of-words features) using the given optimizer.  The batches
+   * are given to the first layer as sparse matrices; layers that support it
+   * (see LayerTraits::SupportsSparseInput, e.g. Linear and Lookup) compute
+   * their forward pass and gradient from the non-zero elements only, and the
+   * other layers are given a dense copy of each batch.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Sparse input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(arma::sp_mat predictors,
+               arma::mat responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on the given sparse input data, with the
+   * RMSProp optimizer by default.  See the overload above.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Sparse input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  double Train(arma::sp_mat predictors,
+               arma::mat responses,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on a dataset streamed in chunks by the given
+   * loader, for the given number of epochs, so that the whole dataset never
+   * has to be in memory.  The optimizer is run once on each chunk, with its
+   * maximum number of iterations set to the size of the chunk, so each epoch
+   * is one pass over the dataset; the state of its update policy is kept from
+   * one chunk to the next.  The loader already shuffles the points, so calls
+   * to Shuffle() by the optimizer don't copy the chunk again.  Any callbacks
+   * are run for every chunk.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization, if there are any.
+   *
+   * @tparam SourceType Type of the source of the loader.
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param loader Loader that gives the chunks of the dataset.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param epochs Number of passes over the dataset.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The sum of the final objectives of the chunks of the last epoch.
+   */
+  template<typename SourceType, typename OptimizerType,
+           typename... CallbackTypes>
+  double Train(PrefetchLoader<SourceType>& loader,
+               OptimizerType& optimizer,
+               const size_t epochs,
+               CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -176,6 +254,36 @@ class FFN
    */
   void Predict(arma::mat predictors, arma::mat& results);
 
+  /**
+   * Predict the responses to a given set of predictors, forwarding batchSize
+   * points through the network at once.  The predictors are not copied: each
+   * batch is an alias of the columns of the given matrix, so this can also be
+   * called on an aliased view of a caller-owned buffer.  If results already
+   * has the right size, its memory is reused, and the outputs of the layers
+   * are kept between calls, so repeated calls with the same batch size do not
+   * allocate.  The results must not alias the predictors.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               const size_t batchSize);
+
+  /**
+   * Predict the responses to a given set of sparse predictors, forwarding
+   * batchSize points through the network at once.  Each batch is given to the
+   * first layer as a sparse matrix.
+   *
+   * @param predictors Sparse input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(const arma::sp_mat& predictors,
+               arma::mat& results,
+               const size_t batchSize);
+
   /**
    * Evaluate the feedforward network with the given predictors and responses.
    * This functions is usually used to monitor progress while training.
@@ -324,11 +432,71 @@ class FFN
   //! Modify the matrix of data points (predictors).
   arma::mat& Predictors() { return predictors; }
 
+  //! Get the sparse matrix of data points, when the network is trained on
+  //! sparse data (it is empty otherwise).
+  const arma::sp_mat& SparsePredictors() const { return sparsePredictors; }
+
+  //! Get whether each batch is split across OpenMP threads during training.
+  bool Parallel() const { return parallel; }
+  //! Modify whether each batch is split across OpenMP threads during training.
+  //! Each thread then evaluates its part of the batch with its own copy of the
+  //! layers, which shares the parameters of the network, and the gradients
+  //! of the parts are summed.  The output layer is still evaluated on the
+  //! whole batch, so losses that average over the points are not scaled by
+  //! the number of threads.  Layers that keep state between batches (like the
+  //! running statistics of BatchNorm) then only update that state in the
+  //! copies.
+  bool& Parallel() { return parallel; }
+
+  //! Get the profiler of the layers of the network.
+  const LayerProfiler& Profiler() const { return profiler; }
+  //! Modify the profiler of the layers of the network.  It is disabled by
+  //! default; see LayerProfiler.
+  LayerProfiler& Profiler() { return profiler; }
+
   /**
    * Reset the module infomration (weights/parameters).
    */
   void ResetParameters();
 
+  /**
+   * Fuse the layers of the trained network for faster inference: BatchNorm
+   * layers that follow a Linear or a Convolution layer are folded into its
+   * weights, and sigmoid, tanh and ReLU activations that follow a Linear layer
+   * are applied in the output loop of a FusedLinear layer (see LayerFusion).
+   * The predictions of the network are unchanged, but since the BatchNorm
+   * layers are folded using their running statistics, the network should not
+   * be trained with the batch normalization afterwards.
+   */
+  void Fuse();
+
+  /**
+   * Prune the Linear layers of the network by magnitude: the given fraction of
+   * the weights of each layer with the smallest absolute value is set to zero
+   * (see MagnitudePruning).  The network can then be retrained with the
+   * KeepPruned callback and the returned mask, which keeps the pruned weights
+   * at zero, and the pruned layers can be replaced with sparse layers with
+   * Sparsify().
+   *
+   * @param sparsity The fraction of the weights of each layer to set to zero,
+   *     in [0, 1).
+   * @param mask Matrix to store the mask of the weights that are kept (zero for
+   *     the pruned weights and one for the others).
+   */
+  void Prune(const double sparsity, arma::mat& mask);
+
+  /**
+   * Replace the Linear layers of the network whose fraction of zero weights is
+   * at least minSparsity (after Prune()) with SparseLinear layers, which only
+   * store and multiply the non-zero weights.  The predictions of the network
+   * are unchanged, but the weights of the replaced layers are fixed, so the
+   * network should only be used for inference afterwards.
+   *
+   * @param minSparsity The minimum fraction of zero weights of the layers to
+   *     replace.
+   */
+  void Sparsify(const double minSparsity = 0.5);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -402,6 +570,44 @@ class FFN
    */
   void ResetData(arma::mat predictors, arma::mat responses);
 
+  /**
+   * Prepare the network for the given sparse data.
+   *
+   * @param predictors Sparse input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(arma::sp_mat predictors, arma::mat responses);
+
+  /**
+   * Run the Forward() function of the first layer on the given input.
+   *
+   * @param input The input of the network.
+   */
+  template<typename InputType>
+  void ForwardFirstLayer(const InputType& input);
+
+  /**
+   * Run the sparse Forward() function of the first layer on the given input.
+   *
+   * @param input The sparse input of the network.
+   */
+  void ForwardFirstLayer(const arma::sp_mat& input);
+
+  /**
+   * Run the Gradient() function of the first layer on the given input.
+   *
+   * @param input The input of the network.
+   */
+  template<typename InputType>
+  void GradientFirstLayer(const InputType& input);
+
+  /**
+   * Run the sparse Gradient() function of the first layer on the given input.
+   *
+   * @param input The sparse input of the network.
+   */
+  void GradientFirstLayer(const arma::sp_mat& input);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -426,6 +632,84 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Run the forward and backward pass for the given points, store the
+   * gradient in the given matrix, and return the objective.
+   *
+   * @param inputs The input points.
+   * @param targets The responses of the input points.
+   * @param gradient Matrix to output the gradient into.
+   */
+  template<typename InputType, typename TargetType>
+  double ForwardBackward(const InputType& inputs,
+                         const TargetType& targets,
+                         arma::mat& gradient);
+
+  /**
+   * Compute the loss of the output layer for the output of the network, and
+   * store the error of the output layer, in one pass if the output layer has
+   * a ForwardBackward() function.
+   *
+   * @param output The output of the network for the current points.
+   * @param targets The responses of the current points.
+   */
+  template<typename TargetType, typename T = OutputLayerType>
+  typename std::enable_if<HasForwardBackwardCheck<T, double(T::*)(
+      const arma::mat&, const arma::mat&, arma::mat&)>::value, double>::type
+  OutputLayerForwardBackward(const arma::mat& output,
+                             const TargetType& targets);
+
+  //! Compute the loss and the error of an output layer without a
+  //! ForwardBackward() function.
+  template<typename TargetType, typename T = OutputLayerType>
+  typename std::enable_if<!HasForwardBackwardCheck<T, double(T::*)(
+      const arma::mat&, const arma::mat&, arma::mat&)>::value, double>::type
+  OutputLayerForwardBackward(const arma::mat& output,
+                             const TargetType& targets);
+
+  /**
+   * Evaluate the objective and gradient of the given batch by splitting it
+   * across the workers (one per thread), and summing their gradients.  The
+   * output layer is evaluated on the outputs of the whole batch.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to output the gradient into.
+   * @param batchSize Number of points in the batch.
+   * @param threads Number of threads to use.
+   */
+  double ParallelEvaluateWithGradient(const size_t begin,
+                                      arma::mat& gradient,
+                                      const size_t batchSize,
+                                      const size_t threads);
+
+  /**
+   * Make sure that there are the given number of workers, each a copy of the
+   * layers whose weights are aliases of the parameters of this network.  The
+   * workers are rebuilt if the layers or the parameters have changed.
+   *
+   * @param threads Number of workers.
+   */
+  void ResetWorkers(const size_t threads);
+
+  /**
+   * Move the outputs and the deltas of the layers into one block of memory,
+   * sized for the current batch size.  Since the layers then assign results of
+   * the same size to them, the following batches of the same size are
+   * computed without allocating these matrices again.
+   *
+   * @param batchSize The number of points of the current batch.
+   */
+  void ResetArena(const size_t batchSize);
+
+  /**
+   * Copy the given matrix to the given memory and make it an alias of that
+   * memory, then advance the memory pointer past it.
+   *
+   * @param matrix The matrix to move.
+   * @param memory Pointer to the memory to move it to.
+   */
+  static void MoveToArena(arma::mat& matrix, double*& memory);
+
   /**
    * Swap the content of this network with given network.
    *
@@ -455,6 +739,10 @@ class FFN
   //! The matrix of data points (predictors).
   arma::mat predictors;
 
+  //! The sparse matrix of data points, used instead of predictors when the
+  //! network is trained on sparse data.
+  arma::sp_mat sparsePredictors;
+
   //! The matrix of responses to the input data points.
   arma::mat responses;
 
@@ -509,6 +797,30 @@ class FFN
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! Whether to split each batch across threads during training.
+  bool parallel;
+
+  //! Whether the network is being trained on chunks from a PrefetchLoader,
+  //! which are already shuffled.
+  bool streaming;
+
+  //! The profiler of the layers.
+  LayerProfiler profiler;
+
+  //! The networks used by the threads in parallel mode; each holds its own
+  //! layers, which share the parameters of this network.
+  std::vector<std::unique_ptr<FFN> > workers;
+
+  //! The memory that the outputs and the deltas of the layers alias during
+  //! training.  (A std::vector keeps its memory when it is moved.)
+  std::vector<double> arena;
+
+  //! The batch size that the arena was sized for.
+  size_t arenaBatchSize;
+
+  //! The number of layers that the arena was sized for.
+  size_t arenaLayers;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
@@ -22,6 +22,10 @@
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/set_input_height_visitor.hpp"
 #include "visitor/set_input_width_visitor.hpp"
+#include "visitor/sparse_forward_visitor.hpp"
+#include "visitor/sparse_gradient_visitor.hpp"
+
+#include "data_loader/optimizer_options.hpp"
 
 #include <boost/serialization/variant.hpp>
 
@@ -39,7 +43,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(false)
+    deterministic(false),
+    parallel(false),
+    streaming(false),
+    profiler("ffn"),
+    arenaBatchSize(0),
+    arenaLayers(0)
 {
   /* Nothing to do here. */
 }
@@ -58,7 +67,26 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
     arma::mat predictors, arma::mat responses)
 {
   numFunctions = responses.n_cols;
+  workers.clear();
   this->predictors = std::move(predictors);
+  this->sparsePredictors = arma::sp_mat();
+  this->responses = std::move(responses);
+  this->deterministic = false;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
+    arma::sp_mat predictors, arma::mat responses)
+{
+  numFunctions = responses.n_cols;
+  workers.clear();
+  this->predictors.reset();
+  this->sparsePredictors = std::move(predictors);
   this->responses = std::move(responses);
   this->deterministic = false;
   ResetDeterministic();
@@ -149,6 +177,112 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   return out;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+      arma::sp_mat predictors,
+      arma::mat responses,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->responses.n_cols);
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    arma::sp_mat predictors,
+    arma::mat responses,
+    CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  OptimizerType optimizer;
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->responses.n_cols);
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename SourceType, typename OptimizerType,
+         typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    PrefetchLoader<SourceType>& loader,
+    OptimizerType& optimizer,
+    const size_t epochs,
+    CallbackTypes&&... callbacks)
+{
+  // Start at the beginning of an epoch.
+  loader.Reset();
+
+  sparsePredictors = arma::sp_mat();
+  this->deterministic = false;
+  ResetDeterministic();
+  streaming = true;
+
+  // Save the options of the optimizer that are changed for each chunk.
+  const size_t maxIterations = SwapMaxIterations(optimizer, 0);
+  const bool resetPolicy = SwapResetPolicy(optimizer, true);
+
+  Timer::Start("ffn_optimization");
+  double out = 0.0;
+  size_t chunks = 0;
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    out = 0.0;
+    while (loader.Next(predictors, responses))
+    {
+      numFunctions = responses.n_cols;
+      if (numFunctions == 0)
+        continue;
+
+      if (!reset)
+        ResetParameters();
+
+      // Make one pass over the chunk, and keep the state of the optimizer for
+      // the next one.
+      SwapMaxIterations(optimizer, numFunctions);
+      out += optimizer.Optimize(*this, parameter, callbacks...);
+      if (++chunks == 1)
+        SwapResetPolicy(optimizer, false);
+    }
+  }
+  Timer::Stop("ffn_optimization");
+
+  SwapMaxIterations(optimizer, maxIterations);
+  SwapResetPolicy(optimizer, resetPolicy);
+  streaming = false;
+
+  // Don't keep reading chunks that won't be used.
+  loader.Reset();
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename PredictorsType, typename ResponsesType>
@@ -194,7 +328,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
     const TargetsType& targets,
     GradientsType& gradients)
 {
-  double res = outputLayer.Forward(boost::apply_visitor(
+  double res = OutputLayerForwardBackward(boost::apply_visitor(
       outputParameterVisitor, network.back()), targets);
 
   for (size_t i = 0; i < network.size(); ++i)
@@ -202,9 +336,6 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
     res += boost::apply_visitor(lossVisitor, network[i]);
   }
 
-  outputLayer.Backward(boost::apply_visitor(outputParameterVisitor,
-      network.back()), targets, error);
-
   gradients = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
 
   Backward();
@@ -219,6 +350,20 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     arma::mat predictors, arma::mat& results)
 {
+  Predict(predictors, results, 1);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    const arma::mat& predictors, arma::mat& results, const size_t batchSize)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("FFN::Predict(): the batch size must be "
+        "greater than 0");
+  }
+
   if (parameter.is_empty())
     ResetParameters();
 
@@ -228,21 +373,70 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
+
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - begin);
+
+    // The layers only read their input, so the batch can alias the
+    // predictors.
+    Forward(arma::mat(const_cast<double*>(predictors.colptr(begin)),
+        predictors.n_rows, effectiveBatchSize, false, true));
 
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network.back());
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(begin, begin + effectiveBatchSize - 1) = output;
+  }
+}
 
-  for (size_t i = 1; i < predictors.n_cols; ++i)
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    const arma::sp_mat& predictors, arma::mat& results, const size_t batchSize)
+{
+  if (batchSize == 0)
   {
-    Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true));
+    throw std::invalid_argument("FFN::Predict(): the batch size must be "
+        "greater than 0");
+  }
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
+
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize,
+        size_t(predictors.n_cols)) - 1;
+
+    Forward(arma::sp_mat(predictors.cols(begin, end)));
+
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
         network.back());
-    results.col(i) = resultsTemp.col(0);
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(begin, end) = output;
   }
 }
 
@@ -280,7 +474,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     const arma::mat& parameters)
 {
   double res = 0;
-  for (size_t i = 0; i < predictors.n_cols; ++i)
+  for (size_t i = 0; i < responses.n_cols; ++i)
     res += Evaluate(parameters, i, 1, true);
 
   return res;
@@ -303,7 +497,11 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(predictors.cols(begin, begin + batchSize - 1));
+  if (!sparsePredictors.is_empty())
+    Forward(arma::sp_mat(sparsePredictors.cols(begin, begin + batchSize - 1)));
+  else
+    Forward(predictors.cols(begin, begin + batchSize - 1));
+
   double res = outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor, network.back()),
       responses.cols(begin, begin + batchSize - 1));
@@ -331,7 +529,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
 EvaluateWithGradient(const arma::mat& parameters, GradType& gradient)
 {
   double res = 0;
-  for (size_t i = 0; i < predictors.n_cols; ++i)
+  for (size_t i = 0; i < responses.n_cols; ++i)
     res += EvaluateWithGradient(parameters, i, gradient, 1);
 
   return res;
@@ -364,28 +562,200 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(predictors.cols(begin, begin + batchSize - 1));
-  double res = outputLayer.Forward(
-      boost::apply_visitor(outputParameterVisitor, network.back()),
-      responses.cols(begin, begin + batchSize - 1));
+  #ifdef HAS_OPENMP
+  // Only split batches that give each thread at least one point, and not when
+  // we are already inside a parallel region.
+  const size_t threads = std::min((size_t) omp_get_max_threads(), batchSize);
+  if (parallel && threads > 1 && omp_get_level() == 0)
+    return ParallelEvaluateWithGradient(begin, gradient, batchSize, threads);
+  #endif
+
+  if (!sparsePredictors.is_empty())
+  {
+    return ForwardBackward(arma::sp_mat(sparsePredictors.cols(begin,
+        begin + batchSize - 1)), responses.cols(begin, begin + batchSize - 1),
+        gradient);
+  }
+
+  return ForwardBackward(predictors.cols(begin, begin + batchSize - 1),
+      responses.cols(begin, begin + batchSize - 1), gradient);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType, typename TargetType>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ForwardBackward(const InputType& inputs,
+                const TargetType& targets,
+                arma::mat& gradient)
+{
+  Forward(inputs);
+  double res = OutputLayerForwardBackward(boost::apply_visitor(
+      outputParameterVisitor, network.back()), targets);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
     res += boost::apply_visitor(lossVisitor, network[i]);
   }
 
-  outputLayer.Backward(
-      boost::apply_visitor(outputParameterVisitor, network.back()),
-      responses.cols(begin, begin + batchSize - 1),
-      error);
-
   Backward();
   ResetGradients(gradient);
-  Gradient(predictors.cols(begin, begin + batchSize - 1));
+  Gradient(inputs);
+
+  if (inputs.n_cols != arenaBatchSize || network.size() != arenaLayers)
+    ResetArena(inputs.n_cols);
 
   return res;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename TargetType, typename T>
+typename std::enable_if<HasForwardBackwardCheck<T, double(T::*)(
+    const arma::mat&, const arma::mat&, arma::mat&)>::value, double>::type
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+OutputLayerForwardBackward(const arma::mat& output,
+                           const TargetType& targets)
+{
+  return outputLayer.ForwardBackward(output, targets, error);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename TargetType, typename T>
+typename std::enable_if<!HasForwardBackwardCheck<T, double(T::*)(
+    const arma::mat&, const arma::mat&, arma::mat&)>::value, double>::type
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+OutputLayerForwardBackward(const arma::mat& output,
+                           const TargetType& targets)
+{
+  const double res = outputLayer.Forward(output, targets);
+  outputLayer.Backward(output, targets, error);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ParallelEvaluateWithGradient(const size_t begin,
+                             arma::mat& gradient,
+                             const size_t batchSize,
+                             const size_t threads)
+{
+  ResetWorkers(threads);
+
+  // Each worker takes a contiguous part of the batch, and runs the layers
+  // forward on it.
+  #pragma omp parallel for num_threads(threads) schedule(static)
+  for (omp_size_t t = 0; t < (omp_size_t) threads; ++t)
+  {
+    const size_t first = begin + t * batchSize / threads;
+    const size_t last = begin + (t + 1) * batchSize / threads - 1;
+
+    if (!sparsePredictors.is_empty())
+      workers[t]->Forward(arma::sp_mat(sparsePredictors.cols(first, last)));
+    else
+      workers[t]->Forward(predictors.cols(first, last));
+  }
+
+  // The output layer is evaluated on the whole batch, since losses that are
+  // averaged over the points (like MeanSquaredError) would otherwise be
+  // scaled by the number of workers.
+  arma::mat output;
+  for (size_t t = 0; t < threads; ++t)
+  {
+    const arma::mat& workerOutput = boost::apply_visitor(
+        outputParameterVisitor, workers[t]->network.back());
+    if (t == 0)
+      output.set_size(workerOutput.n_rows, batchSize);
+
+    output.cols(t * batchSize / threads, (t + 1) * batchSize / threads - 1) =
+        workerOutput;
+  }
+
+  double res = OutputLayerForwardBackward(output,
+      responses.cols(begin, begin + batchSize - 1));
+  for (size_t t = 0; t < threads; ++t)
+  {
+    for (size_t i = 0; i < network.size(); ++i)
+      res += boost::apply_visitor(lossVisitor, workers[t]->network[i]);
+  }
+
+  // Each worker then backpropagates the error of its part of the batch and
+  // computes its gradient in its own matrix.
+  #pragma omp parallel for num_threads(threads) schedule(static)
+  for (omp_size_t t = 0; t < (omp_size_t) threads; ++t)
+  {
+    const size_t first = begin + t * batchSize / threads;
+    const size_t last = begin + (t + 1) * batchSize / threads - 1;
+
+    FFN& worker = *workers[t];
+    worker.error = error.cols(first - begin, last - begin);
+    worker.gradient.zeros(parameter.n_rows, parameter.n_cols);
+    worker.Backward();
+    worker.ResetGradients(worker.gradient);
+    if (!sparsePredictors.is_empty())
+      worker.Gradient(arma::sp_mat(sparsePredictors.cols(first, last)));
+    else
+      worker.Gradient(predictors.cols(first, last));
+
+    if (last - first + 1 != worker.arenaBatchSize ||
+        worker.network.size() != worker.arenaLayers)
+    {
+      worker.ResetArena(last - first + 1);
+    }
+  }
+
+  for (size_t t = 0; t < threads; ++t)
+    gradient += workers[t]->gradient;
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ResetWorkers(const size_t threads)
+{
+  // The weights of the workers alias the parameters, so they are still valid
+  // if the parameters were not reallocated.
+  if (workers.size() == threads &&
+      workers[0]->network.size() == network.size() &&
+      workers[0]->parameter.memptr() == parameter.memptr() &&
+      workers[0]->parameter.n_elem == parameter.n_elem)
+  {
+    return;
+  }
+
+  workers.clear();
+  for (size_t t = 0; t < threads; ++t)
+  {
+    std::unique_ptr<FFN> worker(new FFN(outputLayer, initializeRule));
+    worker->width = width;
+    worker->height = height;
+    worker->reset = reset;
+
+    for (size_t i = 0; i < network.size(); ++i)
+      worker->network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+
+    worker->parameter = arma::mat(parameter.memptr(), parameter.n_rows,
+        parameter.n_cols, false, false);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < worker->network.size(); ++i)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor(worker->parameter,
+          offset), worker->network[i]);
+
+      boost::apply_visitor(resetVisitor, worker->network[i]);
+    }
+
+    worker->ResetDeterministic();
+    workers.push_back(std::move(worker));
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
@@ -401,6 +771,37 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
+  // The chunks given by a PrefetchLoader are shuffled by its thread.
+  if (streaming)
+    return;
+
+  if (!sparsePredictors.is_empty())
+  {
+    // math::ShuffleData() expects a vector of labels with sparse data, so the
+    // responses are reordered here; the i'th point moves to ordering[i].
+    const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+        responses.n_cols - 1, responses.n_cols));
+
+    arma::umat locations(2, sparsePredictors.n_nonzero);
+    arma::vec values(sparsePredictors.n_nonzero);
+    size_t index = 0;
+    for (arma::sp_mat::const_iterator it = sparsePredictors.begin();
+         it != sparsePredictors.end(); ++it, ++index)
+    {
+      locations(0, index) = it.row();
+      locations(1, index) = ordering[it.col()];
+      values[index] = (*it);
+    }
+
+    sparsePredictors = arma::sp_mat(locations, values, sparsePredictors.n_rows,
+        sparsePredictors.n_cols, true);
+
+    arma::mat newResponses(responses.n_rows, responses.n_cols);
+    newResponses.cols(ordering) = responses;
+    responses = std::move(newResponses);
+    return;
+  }
+
   math::ShuffleData(predictors, responses, predictors, responses);
 }
 
@@ -417,6 +818,49 @@ void FFN<OutputLayerType, InitializationRuleType,
   networkInit.Initialize(network, parameter);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Fuse()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  LayerFusion<CustomLayers...>::Fuse(network, parameter);
+
+  // The workers hold copies of the old layers.
+  workers.clear();
+  ResetDeterministic();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Prune(const double sparsity, arma::mat& mask)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // The weights are pruned in place, so the workers (whose weights alias the
+  // parameters) are still valid.
+  MagnitudePruning<CustomLayers...>::Prune(network, parameter, sparsity, mask);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Sparsify(const double minSparsity)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  MagnitudePruning<CustomLayers...>::Sparsify(network, parameter, minSparsity);
+
+  // The workers hold copies of the old layers.
+  workers.clear();
+  ResetDeterministic();
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -440,15 +884,56 @@ void FFN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ResetArena(const size_t batchSize)
+{
+  size_t size = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    size += boost::apply_visitor(outputParameterVisitor, network[i]).n_elem +
+        boost::apply_visitor(deltaVisitor, network[i]).n_elem;
+  }
+
+  // The matrices may alias the old arena, so it is only released once they
+  // have all been moved.
+  std::vector<double> newArena(size);
+  double* memory = newArena.data();
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    MoveToArena(boost::apply_visitor(outputParameterVisitor, network[i]),
+        memory);
+    MoveToArena(boost::apply_visitor(deltaVisitor, network[i]), memory);
+  }
+
+  arena.swap(newArena);
+  arenaBatchSize = batchSize;
+  arenaLayers = network.size();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+MoveToArena(arma::mat& matrix, double*& memory)
+{
+  if (matrix.is_empty())
+    return;
+
+  std::copy(matrix.begin(), matrix.end(), memory);
+  matrix = arma::mat(memory, matrix.n_rows, matrix.n_cols, false, false);
+  memory += matrix.n_elem;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
-  boost::apply_visitor(ForwardVisitor(input,
-      boost::apply_visitor(outputParameterVisitor, network.front())),
-      network.front());
+  profiler.Start(0, LayerProfiler::FORWARD);
+  ForwardFirstLayer(input);
+  profiler.Stop(0, LayerProfiler::FORWARD, network.front());
 
   if (!reset)
   {
@@ -474,9 +959,11 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
+    profiler.Start(i, LayerProfiler::FORWARD);
     boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])), network[i]);
+    profiler.Stop(i, LayerProfiler::FORWARD, network[i]);
 
     if (!reset)
     {
@@ -498,21 +985,66 @@ void FFN<OutputLayerType, InitializationRuleType,
     reset = true;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ForwardFirstLayer(const InputType& input)
+{
+  boost::apply_visitor(ForwardVisitor(input,
+      boost::apply_visitor(outputParameterVisitor, network.front())),
+      network.front());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ForwardFirstLayer(const arma::sp_mat& input)
+{
+  boost::apply_visitor(SparseForwardVisitor(input,
+      boost::apply_visitor(outputParameterVisitor, network.front())),
+      network.front());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::GradientFirstLayer(const InputType& input)
+{
+  boost::apply_visitor(GradientVisitor(input,
+      boost::apply_visitor(deltaVisitor, network[1])), network.front());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::GradientFirstLayer(const arma::sp_mat& input)
+{
+  boost::apply_visitor(SparseGradientVisitor(input,
+      boost::apply_visitor(deltaVisitor, network[1])), network.front());
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  profiler.Start(network.size() - 1, LayerProfiler::BACKWARD);
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
       outputParameterVisitor, network.back()), error,
       boost::apply_visitor(deltaVisitor, network.back())), network.back());
+  profiler.Stop(network.size() - 1, LayerProfiler::BACKWARD, network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
+    profiler.Start(network.size() - i, LayerProfiler::BACKWARD);
     boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[network.size() - i]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i + 1]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i])),
         network[network.size() - i]);
+    profiler.Stop(network.size() - i, LayerProfiler::BACKWARD,
+        network[network.size() - i]);
   }
 }
 
@@ -522,19 +1054,24 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
-  boost::apply_visitor(GradientVisitor(input,
-      boost::apply_visitor(deltaVisitor, network[1])), network.front());
+  profiler.Start(0, LayerProfiler::GRADIENT);
+  GradientFirstLayer(input);
+  profiler.Stop(0, LayerProfiler::GRADIENT, network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
+    profiler.Start(i, LayerProfiler::GRADIENT);
     boost::apply_visitor(GradientVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(deltaVisitor, network[i + 1])), network[i]);
+    profiler.Stop(i, LayerProfiler::GRADIENT, network[i]);
   }
 
+  profiler.Start(network.size() - 1, LayerProfiler::GRADIENT);
   boost::apply_visitor(GradientVisitor(boost::apply_visitor(
       outputParameterVisitor, network[network.size() - 2]), error),
       network[network.size() - 1]);
+  profiler.Stop(network.size() - 1, LayerProfiler::GRADIENT, network.back());
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -564,6 +1101,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
   // Be sure to clear other layers before loading.
   if (Archive::is_loading::value)
   {
+    workers.clear();
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
@@ -605,6 +1143,7 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(reset, network.reset);
   std::swap(this->network, network.network);
   std::swap(predictors, network.predictors);
+  std::swap(sparsePredictors, network.sparsePredictors);
   std::swap(responses, network.responses);
   std::swap(parameter, network.parameter);
   std::swap(numFunctions, network.numFunctions);
@@ -614,6 +1153,13 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(parallel, network.parallel);
+  std::swap(streaming, network.streaming);
+  std::swap(profiler, network.profiler);
+  std::swap(workers, network.workers);
+  std::swap(arena, network.arena);
+  std::swap(arenaBatchSize, network.arenaBatchSize);
+  std::swap(arenaLayers, network.arenaLayers);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -626,6 +1172,7 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(network.height),
     reset(network.reset),
     predictors(network.predictors),
+    sparsePredictors(network.sparsePredictors),
     responses(network.responses),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
@@ -634,7 +1181,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    parallel(network.parallel),
+    streaming(false),
+    profiler(network.profiler),
+    arenaBatchSize(0),
+    arenaLayers(0)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -654,6 +1206,7 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(network.height),
     reset(network.reset),
     predictors(std::move(network.predictors)),
+    sparsePredictors(std::move(network.sparsePredictors)),
     responses(std::move(network.responses)),
     parameter(std::move(network.parameter)),
     numFunctions(network.numFunctions),
@@ -662,9 +1215,16 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    parallel(network.parallel),
+    streaming(false),
+    profiler(std::move(network.profiler)),
+    arena(std::move(network.arena)),
+    arenaBatchSize(network.arenaBatchSize),
+    arenaLayers(network.arenaLayers)
 {
   this->network = std::move(network.network);
+  this->workers = std::move(network.workers);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -326,6 +326,17 @@ class GAN
   //! Modify the matrix of data points (predictors).
   arma::mat& Predictors() { return predictors; }
 
+  //! Get whether the discriminator passes over the real and the generated
+  //! points of each batch run in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the discriminator passes over the real and the generated
+  //! points of each batch run in parallel (with OpenMP).  The real points are
+  //! then evaluated by a copy of the layers of the discriminator, which shares
+  //! its parameters, so layers that keep state between batches (like the
+  //! running statistics of BatchNorm) only update that state from the
+  //! generated points.
+  bool& Parallel() { return parallel; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -337,6 +348,19 @@ class GAN
   */
   void ResetDeterministic();
 
+  /**
+   * Evaluate the discriminator on the real points of the batch that starts at
+   * the given index and on the current output of the generator, whose
+   * responses must already be set, and store the sum of their gradients in
+   * gradientDiscriminator.  The generated points are evaluated last by the
+   * discriminator itself, so that its state can be used to backpropagate
+   * into the generator.
+   *
+   * @param i Index of the first real point of the batch.
+   * @return The sum of the objectives of the real and the generated points.
+   */
+  double EvaluateDiscriminator(const size_t i);
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
@@ -397,6 +421,8 @@ class GAN
   arma::mat gradientGenerator;
   //! The current evaluation mode (training or testing).
   bool deterministic;
+  //! Whether the real and the generated points are evaluated in parallel.
+  bool parallel;
   //! To keep track of number of generator weights in total weights.
   size_t genWeights;
   //! To keep track of number of discriminator weights in total weights.
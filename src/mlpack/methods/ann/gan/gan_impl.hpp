@@ -56,6 +56,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     lambda(lambda),
     reset(false),
     deterministic(false),
+    parallel(false),
     genWeights(0),
     discWeights(0)
 {
@@ -92,6 +93,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     numFunctions(network.numFunctions),
     noise(network.noise),
     deterministic(network.deterministic),
+    parallel(network.parallel),
     genWeights(network.genWeights),
     discWeights(network.discWeights)
 {
@@ -125,6 +127,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     numFunctions(network.numFunctions),
     noise(std::move(network.noise)),
     deterministic(network.deterministic),
+    parallel(network.parallel),
     genWeights(network.genWeights),
     discWeights(network.discWeights)
 {
@@ -266,11 +269,8 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
 
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(noise);
-
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.Forward(predictors.cols(numFunctions,
-      numFunctions + batchSize - 1));
+  discriminator.Forward(boost::apply_visitor(outputParameterVisitor,
+      generator.network.back()));
   responses.cols(numFunctions, numFunctions + batchSize - 1) =
       arma::zeros(1, batchSize);
 
@@ -335,21 +335,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
+  // The generated points are fed to the discriminator straight from the
+  // output of the generator.
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(noise);
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).zeros();
 
-  // Get the gradients of the Generator.
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
-  gradientDiscriminator += noiseGradientDiscriminator;
+  // Get the gradients of the Discriminator.
+  double res = EvaluateDiscriminator(i);
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
@@ -367,10 +360,9 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     generator.error = boost::apply_visitor(deltaVisitor,
         discriminator.network[1]);
 
-    generator.Predictors() = noise;
     generator.Backward();
     generator.ResetGradients(gradientGenerator);
-    generator.Gradient(generator.Predictors().cols(0, batchSize - 1));
+    generator.Gradient(noise);
 
     gradientGenerator *= multiplier;
   }
@@ -479,6 +471,57 @@ ResetDeterministic()
   this->generator.ResetDeterministic();
 }
 
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+double GAN<Model, InitializationRuleType, Noise, PolicyType>::
+EvaluateDiscriminator(const size_t i)
+{
+  const arma::mat& generatedData = boost::apply_visitor(outputParameterVisitor,
+      generator.network.back());
+  currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
+      predictors.n_rows, batchSize, false, false);
+
+  double res = 0.0;
+  double generatedRes = 0.0;
+
+  #ifdef HAS_OPENMP
+  if (parallel && omp_get_level() == 0)
+  {
+    // The real points are evaluated by a copy of the layers, so that the
+    // layers of the discriminator keep the state of the generated points.
+    discriminator.ResetWorkers(1);
+    Model& realDiscriminator = *discriminator.workers[0];
+
+    #pragma omp parallel sections num_threads(2)
+    {
+      #pragma omp section
+      res = realDiscriminator.ForwardBackward(currentInput,
+          responses.cols(i, i + batchSize - 1), gradientDiscriminator);
+
+      #pragma omp section
+      generatedRes = discriminator.ForwardBackward(generatedData,
+          responses.cols(numFunctions, numFunctions + batchSize - 1),
+          noiseGradientDiscriminator);
+    }
+  }
+  else
+  #endif
+  {
+    res = discriminator.ForwardBackward(currentInput,
+        responses.cols(i, i + batchSize - 1), gradientDiscriminator);
+    generatedRes = discriminator.ForwardBackward(generatedData,
+        responses.cols(numFunctions, numFunctions + batchSize - 1),
+        noiseGradientDiscriminator);
+  }
+
+  gradientDiscriminator += noiseGradientDiscriminator;
+  return res + generatedRes;
+}
+
 template<
   typename Model,
   typename InitializationRuleType,
@@ -58,11 +58,8 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
 
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(noise);
-
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.Forward(predictors.cols(numFunctions,
-      numFunctions + batchSize - 1));
+  discriminator.Forward(boost::apply_visitor(outputParameterVisitor,
+      generator.network.back()));
   responses.cols(numFunctions, numFunctions + batchSize - 1) =
       -arma::ones(1, batchSize);
 
@@ -127,21 +124,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
+  // The generated points are fed to the discriminator straight from the
+  // output of the generator.
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(noise);
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).fill(-1.0);
 
-  // Get the gradients of the Generator.
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
-  gradientDiscriminator += noiseGradientDiscriminator;
+  // Get the gradients of the Discriminator.
+  double res = EvaluateDiscriminator(i);
   gradientDiscriminator = arma::clamp(gradientDiscriminator,
       -clippingParameter, clippingParameter);
 
@@ -161,10 +151,9 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     generator.error = boost::apply_visitor(deltaVisitor,
         discriminator.network[1]);
 
-    generator.Predictors() = noise;
     generator.Backward();
     generator.ResetGradients(gradientGenerator);
-    generator.Gradient(generator.Predictors().cols(0, batchSize - 1));
+    generator.Gradient(noise);
 
     gradientGenerator *= multiplier;
   }
@@ -58,14 +58,11 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
       discriminator.network.back())), std::move(currentTarget));
 
   noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  generator.Forward(noise);
 
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
+  const arma::mat& generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  discriminator.Forward(std::move(predictors.cols(numFunctions,
-      numFunctions + batchSize - 1)));
+  discriminator.Forward(generatedData);
   responses.cols(numFunctions, numFunctions + batchSize - 1) =
       -arma::ones(1, batchSize);
 
@@ -144,30 +141,25 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
       predictors.n_rows, batchSize, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
   noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
+  generator.Forward(noise);
+  const arma::mat& generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
 
-  // Gradient Penalty is calculated here.
+  // Gradient Penalty is calculated here.  The interpolated points are the only
+  // ones that are copied into the predictors.
   double epsilon = math::Random();
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).fill(-1.0);
   discriminator.Gradient(discriminator.parameter, numFunctions,
       normGradientDiscriminator, batchSize);
-  res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
+  double res = lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1,
+      2);
 
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
-  gradientDiscriminator += noiseGradientDiscriminator;
+  // Get the gradients of the Discriminator; the generated points are fed to it
+  // straight from the output of the generator.
+  res += EvaluateDiscriminator(i);
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
@@ -185,10 +177,9 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     generator.error = boost::apply_visitor(deltaVisitor,
         discriminator.network[1]);
 
-    generator.Predictors() = noise;
     generator.Backward();
     generator.ResetGradients(gradientGenerator);
-    generator.Gradient(generator.Predictors().cols(0, batchSize - 1));
+    generator.Gradient(noise);
 
     gradientGenerator *= multiplier;
   }
@@ -19,6 +19,8 @@
 // In case it hasn't yet been included.
 #include "alpha_dropout.hpp"
 
+#include <mlpack/core/math/random.hpp>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -49,8 +51,8 @@ void AlphaDropout<InputDataType, OutputDataType>::Forward(
     // Set values to alphaDash with probability ratio.  Then apply affine
     // transformation so as to keep mean and variance of outputs to their
     // original values.
-    mask = arma::randu< arma::Mat<eT> >(input.n_rows, input.n_cols);
-    mask.transform( [&](double val) { return (val > ratio); } );
+    mask.set_size(input.n_rows, input.n_cols);
+    math::RandMask(mask, ratio);
     output = (input % mask + alphaDash * (1 - mask)) * a + b;
   }
 }
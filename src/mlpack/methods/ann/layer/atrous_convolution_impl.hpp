@@ -213,6 +213,35 @@ void AtrousConvolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
+  const bool padded = padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+      padding.PadHTop() != 0 || padding.PadHBottom() != 0;
+  ForwardConvolution(padded ? inputPaddedTemp : inputTemp,
+      std::integral_constant<bool, ConvolutionRuleTraits<
+      ForwardConvolutionRule>::HasMapConvolution>());
+
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+    outputTemp.slice(outMap) += bias(outMap % outSize);
+
+  outputWidth = outputTemp.n_rows;
+  outputHeight = outputTemp.n_cols;
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+void AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::cube& input,
+                      const std::false_type /* hasMapConvolution */)
+{
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -224,30 +253,45 @@ void AtrousConvolution<
 
     for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
     {
-      arma::Mat<eT> convOutput;
-
-      if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
-          padding.PadHTop() != 0 || padding.PadHBottom() != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight, dilationWidth, dilationHeight);
-      }
-      else
-      {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight, dilationWidth, dilationHeight);
-      }
+      arma::mat convOutput;
+      ForwardConvolutionRule::Convolution(input.slice(inMap +
+          batchCount * inSize), weight.slice(outMapIdx), convOutput,
+          strideWidth, strideHeight, dilationWidth, dilationHeight);
 
       outputTemp.slice(outMap) += convOutput;
     }
-
-    outputTemp.slice(outMap) += bias(outMap % outSize);
   }
+}
 
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+void AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::cube& input,
+                      const std::true_type /* hasMapConvolution */)
+{
+  // Convolve all the input maps of each point with all the filters at once;
+  // the maps of the point are aliased, so the results are written directly
+  // into outputTemp.
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const arma::cube inputMaps(const_cast<double*>(input.slice_memptr(i *
+        inSize)), input.n_rows, input.n_cols, inSize, false, true);
+    arma::cube outputMaps(outputTemp.slice_memptr(i * outSize),
+        outputTemp.n_rows, outputTemp.n_cols, outSize, false, true);
+
+    ForwardConvolutionRule::MapConvolution(inputMaps, weight, outputMaps,
+        strideWidth, strideHeight, dilationWidth, dilationHeight);
+  }
 }
 
 template<
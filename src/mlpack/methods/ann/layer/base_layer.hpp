@@ -95,12 +95,12 @@ class BaseLayer
    * @param gy The backpropagated error.
    * @param g The calculated gradient.
    */
-  template<typename eT>
-  void Backward(const arma::Mat<eT>& input,
-                const arma::Mat<eT>& gy,
-                arma::Mat<eT>& g)
+  template<typename InputType, typename ErrorType, typename OutputType>
+  void Backward(const InputType& input,
+                const ErrorType& gy,
+                OutputType& g)
   {
-    arma::Mat<eT> derivative;
+    OutputType derivative;
     ActivationFunction::Deriv(input, derivative);
     g = gy % derivative;
   }
@@ -227,10 +227,7 @@ class BatchNorm
   OutputDataType outputParameter;
 
   //! Locally-stored normalized input.
-  arma::cube normalized;
-
-  //! Locally-stored zero mean input.
-  arma::cube inputMean;
+  OutputDataType normalized;
 }; // class BatchNorm
 
 } // namespace ann
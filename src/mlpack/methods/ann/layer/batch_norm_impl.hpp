@@ -99,40 +99,54 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
           " greater than 1 to fix the warning." << std::endl;
     }
 
-    // Input corresponds to output from convolution layer.
-    // Use a cube for simplicity.
-    arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
-        inputSize, size, batchSize, false, false);
-
-    // Initialize output to same size and values for convenience.
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
-        inputSize, size, batchSize, false, false);
-    outputTemp = inputTemp;
-
-    // Calculate mean and variance over all channels.
-    mean = arma::mean(arma::mean(inputTemp, 2), 0);
-    variance = arma::mean(arma::mean(arma::pow(
-        inputTemp.each_slice() - arma::repmat(mean,
-        inputSize, 1), 2), 2), 0);
-
-    outputTemp.each_slice() -= arma::repmat(mean, inputSize, 1);
-
-    // Used in backward propagation.
-    inputMean.set_size(arma::size(inputTemp));
-    inputMean = outputTemp;
-
-    // Normalize output.
-    outputTemp.each_slice() /= arma::sqrt(arma::repmat(variance,
-        inputSize, 1) + eps);
-
-    // Re-used in backward propagation.
-    normalized.set_size(arma::size(inputTemp));
-    normalized = outputTemp;
+    // Compute the mean and the variance of each channel in a single pass over
+    // the input.  The statistics of each contiguous block of a channel (one
+    // per point) are merged into those of the previous blocks with the update
+    // of Chan et al., a blocked form of Welford's algorithm, which stays
+    // accurate when the mean is large compared to the variance.
+    mean.zeros(1, size);
+    variance.zeros(1, size);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      for (size_t c = 0; c < size; ++c)
+      {
+        const eT* block = input.colptr(i) + c * inputSize;
+        double blockMean = 0.0;
+        for (size_t j = 0; j < inputSize; ++j)
+          blockMean += block[j];
+        blockMean /= inputSize;
+
+        double blockM2 = 0.0;
+        for (size_t j = 0; j < inputSize; ++j)
+          blockM2 += (block[j] - blockMean) * (block[j] - blockMean);
+
+        const double seen = (double) (i * inputSize);
+        const double total = seen + inputSize;
+        const double delta = blockMean - mean[c];
+        mean[c] += delta * inputSize / total;
+        variance[c] += blockM2 + delta * delta * seen * inputSize / total;
+      }
+    }
+    variance /= (double) (inputSize * batchSize);
 
-    outputTemp.each_slice() %= arma::repmat(gamma.t(),
-        inputSize, 1);
-    outputTemp.each_slice() += arma::repmat(beta.t(),
-        inputSize, 1);
+    // Normalize, scale and shift the input in a second pass.  Only the
+    // normalized input is kept for the backward pass.
+    const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
+    normalized.set_size(arma::size(input));
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      for (size_t c = 0; c < size; ++c)
+      {
+        const eT* in = input.colptr(i) + c * inputSize;
+        eT* norm = normalized.colptr(i) + c * inputSize;
+        eT* out = output.colptr(i) + c * inputSize;
+        for (size_t j = 0; j < inputSize; ++j)
+        {
+          norm[j] = (in[j] - mean[c]) * stdInv[c];
+          out[j] = gamma[c] * norm[j] + beta[c];
+        }
+      }
+    }
 
     count += 1;
     averageFactor = average ? 1.0 / count : momentum;
@@ -150,19 +164,20 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
   }
   else
   {
-    // Normalize the input and scale and shift the output.
-    output = input;
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
-        input.n_rows / size, size, batchSize, false, false);
-
-    outputTemp.each_slice() -= arma::repmat(runningMean.t(),
-        input.n_rows / size, 1);
-    outputTemp.each_slice() /= arma::sqrt(arma::repmat(runningVariance.t(),
-        input.n_rows / size, 1) + eps);
-    outputTemp.each_slice() %= arma::repmat(gamma.t(),
-        input.n_rows / size, 1);
-    outputTemp.each_slice() += arma::repmat(beta.t(),
-        input.n_rows / size, 1);
+    // Normalize the input and scale and shift the output, with a single
+    // affine map per channel.
+    const arma::mat scale = gamma / arma::sqrt(runningVariance + eps);
+    const arma::mat shift = beta - runningMean % scale;
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      for (size_t c = 0; c < size; ++c)
+      {
+        const eT* in = input.colptr(i) + c * inputSize;
+        eT* out = output.colptr(i) + c * inputSize;
+        for (size_t j = 0; j < inputSize; ++j)
+          out[j] = in[j] * scale[c] + shift[c];
+      }
+    }
   }
 }
 
@@ -173,35 +188,47 @@ void BatchNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& gy,
     arma::Mat<eT>& g)
 {
+  const size_t inputSize = input.n_rows / size;
+  const double m = (double) (inputSize * input.n_cols);
   const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
 
+  // Sum dl / dxhat and dl / dxhat * xhat over each channel, where
+  // dl / dxhat = dl / dy * gamma.
+  arma::vec sumNorm(size, arma::fill::zeros);
+  arma::vec sumNormXhat(size, arma::fill::zeros);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t c = 0; c < size; ++c)
+    {
+      const eT* error = gy.colptr(i) + c * inputSize;
+      const eT* norm = normalized.colptr(i) + c * inputSize;
+      for (size_t j = 0; j < inputSize; ++j)
+      {
+        sumNorm[c] += error[j];
+        sumNormXhat[c] += error[j] * norm[j];
+      }
+    }
+  }
+  sumNorm %= gamma;
+  sumNormXhat %= gamma;
+
+  // dl / dx = stdInv * (dl / dxhat - mean(dl / dxhat) -
+  //     xhat * mean(dl / dxhat * xhat)).
   g.set_size(arma::size(input));
-  arma::cube gyTemp(const_cast<arma::Mat<eT>&>(gy).memptr(),
-      input.n_rows / size, size, input.n_cols, false, false);
-  arma::cube gTemp(const_cast<arma::Mat<eT>&>(g).memptr(),
-      input.n_rows / size, size, input.n_cols, false, false);
-
-  // Step 1: dl / dxhat.
-  arma::cube norm = gyTemp.each_slice() % arma::repmat(gamma.t(),
-      input.n_rows / size, 1);
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  arma::mat temp = arma::sum(norm % inputMean, 2);
-  arma::mat vars = temp % arma::repmat(arma::pow(stdInv, 3),
-      input.n_rows / size, 1) * -0.5;
-
-  // Step 3: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  gTemp = (norm.each_slice() % arma::repmat(stdInv,
-      input.n_rows / size, 1) +
-      (inputMean.each_slice() % vars * 2)) / input.n_cols;
-
-  // Step 4: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  arma::mat normTemp = arma::sum(norm.each_slice() %
-      arma::repmat(-stdInv, input.n_rows / size, 1) , 2) /
-      input.n_cols;
-  gTemp.each_slice() += normTemp;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t c = 0; c < size; ++c)
+    {
+      const eT* error = gy.colptr(i) + c * inputSize;
+      const eT* norm = normalized.colptr(i) + c * inputSize;
+      eT* out = g.colptr(i) + c * inputSize;
+      for (size_t j = 0; j < inputSize; ++j)
+      {
+        out[j] = stdInv[c] * (gamma[c] * error[j] - sumNorm[c] / m -
+            norm[j] * sumNormXhat[c] / m);
+      }
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -211,17 +238,23 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.set_size(size + size, 1);
-  arma::cube errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
-      error.n_rows / size, size, error.n_cols, false, false);
-
-  // Step 5: dl / dy * xhat.
-  arma::mat temp = arma::sum(arma::sum(normalized % errorTemp, 0), 2);
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = temp.t();
-
-  // Step 6: dl / dy.
-  temp = arma::sum(arma::sum(errorTemp, 0), 2);
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) = temp.t();
+  const size_t inputSize = error.n_rows / size;
+  gradient.zeros(size + size, 1);
+  for (size_t i = 0; i < error.n_cols; ++i)
+  {
+    for (size_t c = 0; c < size; ++c)
+    {
+      const eT* errorBlock = error.colptr(i) + c * inputSize;
+      const eT* norm = normalized.colptr(i) + c * inputSize;
+      for (size_t j = 0; j < inputSize; ++j)
+      {
+        // Step 5: dl / dy * xhat.
+        gradient[c] += errorBlock[j] * norm[j];
+        // Step 6: dl / dy.
+        gradient[size + c] += errorBlock[j];
+      }
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
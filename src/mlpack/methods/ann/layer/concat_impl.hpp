@@ -114,23 +114,35 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
     }
   }
 
-  output = boost::apply_visitor(outputParameterVisitor, network.front());
+  // The output is allocated once (or reused), and the output of each layer is
+  // copied once into its rows.
+  size_t outRows = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    outRows += boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_rows;
+  }
 
-  // Reshape output to incorporate the channels.
-  output.reshape(output.n_rows / channels, output.n_cols * channels);
+  const size_t outCols = boost::apply_visitor(outputParameterVisitor,
+      network.front()).n_cols;
+  output.set_size(outRows, outCols);
 
-  for (size_t i = 1; i < network.size(); ++i)
+  // View the output and the output of each layer with the channels as
+  // columns, and vertically concatenate the outputs of the layers.
+  arma::Mat<eT> outputTmp(output.memptr(), outRows / channels,
+      outCols * channels, false, true);
+  size_t rowCount = 0;
+  for (size_t i = 0; i < network.size(); ++i)
   {
-    arma::Mat<eT> out = boost::apply_visitor(outputParameterVisitor,
+    const arma::Mat<eT>& out = boost::apply_visitor(outputParameterVisitor,
         network[i]);
+    const arma::Mat<eT> outTmp(const_cast<eT*>(out.memptr()),
+        out.n_rows / channels, out.n_cols * channels, false, true);
 
-    out.reshape(out.n_rows / channels, out.n_cols * channels);
-
-    // Vertically concatentate output from each layer.
-    output = arma::join_cols(output, out);
+    if (outTmp.n_rows > 0)
+      outputTmp.rows(rowCount, rowCount + outTmp.n_rows - 1) = outTmp;
+    rowCount += outTmp.n_rows;
   }
-  // Reshape output to its original shape.
-  output.reshape(output.n_rows * channels, output.n_cols / channels);
 }
 
 template<typename InputDataType, typename OutputDataType,
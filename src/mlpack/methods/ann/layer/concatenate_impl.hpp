@@ -39,8 +39,13 @@ void Concatenate<InputDataType, OutputDataType>::Forward(
         << "to the number of columns of input matrix." << std::endl;
   }
 
+  // Reuse the memory of the output, and copy the input and the concat matrix
+  // into their rows.
   inRows = input.n_rows;
-  output = arma::join_cols(input, concat);
+  output.set_size(input.n_rows + concat.n_rows, input.n_cols);
+  output.rows(0, inRows - 1) = input;
+  if (concat.n_rows > 0)
+    output.rows(inRows, output.n_rows - 1) = concat;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -18,6 +18,9 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/winograd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/convolution_rules_traits.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer_types.hpp"
@@ -260,6 +263,25 @@ class Convolution
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Convolve the given input with the filters into outputTemp, one pair of
+   * input and output maps at a time.  The bias is not added.
+   *
+   * @param input The (padded) input maps of the batch.
+   */
+  void ForwardConvolution(const arma::cube& input,
+                          const std::false_type /* hasMapConvolution */);
+
+  /**
+   * Convolve the given input with the filters into outputTemp, all the maps of
+   * each point at once, with ForwardConvolutionRule::MapConvolution().  The
+   * bias is not added.
+   *
+   * @param input The (padded) input maps of the batch.
+   */
+  void ForwardConvolution(const arma::cube& input,
+                          const std::true_type /* hasMapConvolution */);
+
   /*
    * Return the convolution output size.
    *
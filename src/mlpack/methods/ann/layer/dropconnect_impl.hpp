@@ -17,6 +17,8 @@
 // In case it hasn't yet been included.
 #include "dropconnect.hpp"
 
+#include <mlpack/core/math/random.hpp>
+
 #include "../visitor/delete_visitor.hpp"
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
@@ -67,15 +69,15 @@ void DropConnect<InputDataType, OutputDataType>::Forward(
 
     // Scale with input / (1 - ratio) and set values to zero with
     // probability ratio.
-    mask = arma::randu<arma::Mat<eT> >(denoise.n_rows, denoise.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
+    mask.set_size(denoise.n_rows, denoise.n_cols);
+    math::RandMask(mask, ratio);
 
     arma::mat tmp = denoise % mask;
     boost::apply_visitor(ParametersSetVisitor(tmp), baseLayer);
 
     boost::apply_visitor(ForwardVisitor(input, output), baseLayer);
 
-    output = output * scale;
+    output *= scale;
   }
 }
 
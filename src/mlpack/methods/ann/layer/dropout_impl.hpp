@@ -16,6 +16,8 @@
 // In case it hasn't yet been included.
 #include "dropout.hpp"
 
+#include <mlpack/core/math/random.hpp>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -45,8 +47,8 @@ void Dropout<InputDataType, OutputDataType>::Forward(
   {
     // Scale with input / (1 - ratio) and set values to zero with probability
     // 'ratio'.
-    mask = arma::randu<arma::Mat<eT> >(input.n_rows, input.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
+    mask.set_size(input.n_rows, input.n_cols);
+    math::RandMask(mask, ratio);
     output = input % mask * scale;
   }
 }
@@ -0,0 +1,250 @@
+/**
+ * @file methods/ann/layer/embedding_bag.hpp
+ *
+ * Definition of the EmbeddingBag class, which pools the embeddings of bags of
+ * tokens and updates only the rows of the embedding table that were used.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_EMBEDDING_BAG_HPP
+#define MLPACK_METHODS_ANN_LAYER_EMBEDDING_BAG_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+namespace mlpack {
+namespace ann /* Artificial Neural Network. */ {
+
+/**
+ * The EmbeddingBag layer looks up the embeddings of a bag of tokens and pools
+ * them into one vector, by summing or averaging them.  Like Lookup, it is
+ * always the first layer of the network.
+ *
+ * The input can be a matrix of shape (maxBagSize, batchSize), where each column
+ * holds the (1-based) tokens of one bag; the bags may have different lengths,
+ * and the unused entries at the end of a column are set to 0.  The input can
+ * also be a sparse matrix of shape (vocabSize, batchSize), where the value of
+ * each non-zero entry is the weight of the token in the bag.  The output has
+ * shape (embeddingSize, batchSize); the output of an empty bag is zero.
+ *
+ * Unlike Lookup, the embedding table is not part of the parameters of the
+ * network, because the gradient of the network is a dense vector the size of
+ * all of its parameters, and that is too large for tables with millions of
+ * rows.  Instead, Gradient() computes the gradient of the rows of the table
+ * that appear in the batch only (see TouchedRows() and RowGradients()), and
+ * takes a stochastic gradient descent step with the given step size on these
+ * rows.  If the step size is 0, the table isn't changed, and the row gradients
+ * can be used to update Table() by hand.  The optimizer given to FFN::Train()
+ * updates the other layers of the network as usual.
+ *
+ * Since the table is updated when the gradient is computed, the layer should be
+ * trained with an optimizer that computes the gradient once per step (such as
+ * SGD or Adam), and not with FFN::Parallel(), whose workers hold copies of the
+ * layer.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class EmbeddingBag
+{
+ public:
+  /**
+   * Create the EmbeddingBag object.  The table is initialized with small
+   * random values.
+   *
+   * @param vocabSize The size of the vocabulary.
+   * @param embeddingSize The length of each embedding vector.
+   * @param mean Whether to average the embeddings of a bag instead of summing
+   *     them.
+   * @param stepSize Step size of the update of the touched rows of the table.
+   */
+  EmbeddingBag(const size_t vocabSize = 0,
+               const size_t embeddingSize = 0,
+               const bool mean = false,
+               const double stepSize = 0.01);
+
+  /**
+   * Pool the embeddings of each bag (column) of tokens of the input.
+   *
+   * @param input Tokens of the bags, 0 marking an unused entry.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Pool the embeddings of each bag (column) of a sparse input of shape
+   * (vocabSize, batchSize), weighted by the values of the entries.
+   *
+   * @param input Sparse input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::SpMat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * The EmbeddingBag layer has to be the first layer of the network, so the
+   * backward pass is not defined.
+   *
+   * @param * (input) The propagated input activation.
+   * @param * (gy) The backpropagated error.
+   * @param * (g) The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& /* gy */,
+                arma::Mat<eT>& /* g */);
+
+  /**
+   * Compute the gradient of the rows of the table that appear in the input,
+   * and update them.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param * (gradient) The gradient of the parameters (unused, since the
+   *     layer has none).
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& /* gradient */);
+
+  /**
+   * Compute the gradient of the rows of the table that appear in the sparse
+   * input, and update them.
+   *
+   * @param input The sparse input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param * (gradient) The gradient of the parameters (unused, since the
+   *     layer has none).
+   */
+  template<typename eT>
+  void Gradient(const arma::SpMat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& /* gradient */);
+
+  //! Get the parameters.  This is always empty; see Table().
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.  This is always empty; see Table().
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the embedding table, one column per token.
+  OutputDataType const& Table() const { return table; }
+  //! Modify the embedding table, one column per token.
+  OutputDataType& Table() { return table; }
+
+  //! Get the tokens (0-based rows of the table) touched by the last gradient.
+  arma::uvec const& TouchedRows() const { return touchedRows; }
+
+  //! Get the gradient of the touched rows, one column per touched row.
+  OutputDataType const& RowGradients() const { return rowGradients; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the size of the vocabulary.
+  size_t VocabSize() const { return vocabSize; }
+
+  //! Get the length of each embedding vector.
+  size_t EmbeddingSize() const { return embeddingSize; }
+
+  //! Get whether the embeddings of a bag are averaged.
+  bool Mean() const { return mean; }
+  //! Modify whether the embeddings of a bag are averaged.
+  bool& Mean() { return mean; }
+
+  //! Get the step size of the update of the table.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size of the update of the table.
+  double& StepSize() { return stepSize; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Map the given (token, error column, weight) entries to the touched rows,
+  //! accumulate their gradients and update the table.
+  template<typename eT>
+  void UpdateRows(const std::vector<size_t>& tokens,
+                  const std::vector<size_t>& columns,
+                  const std::vector<eT>& scales,
+                  const arma::Mat<eT>& error);
+
+  //! Locally-stored size of the vocabulary.
+  size_t vocabSize;
+
+  //! Locally-stored length of each embedding vector.
+  size_t embeddingSize;
+
+  //! Whether the embeddings of a bag are averaged.
+  bool mean;
+
+  //! The step size of the update of the table.
+  double stepSize;
+
+  //! Locally-stored embedding table.
+  OutputDataType table;
+
+  //! Locally-stored (empty) weight object.
+  OutputDataType weights;
+
+  //! The rows of the table touched by the last gradient.
+  arma::uvec touchedRows;
+
+  //! The gradient of the touched rows.
+  OutputDataType rowGradients;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored (empty) gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class EmbeddingBag
+
+// The EmbeddingBag layer can take a sparse input.
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<EmbeddingBag<InputDataType, OutputDataType> >
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool SupportsSparseInput = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "embedding_bag_impl.hpp"
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ * @file methods/ann/layer/embedding_bag_impl.hpp
+ *
+ * Implementation of the EmbeddingBag class, which pools the embeddings of bags
+ * of tokens and updates only the rows of the embedding table that were used.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_EMBEDDING_BAG_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_EMBEDDING_BAG_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "embedding_bag.hpp"
+
+#include <unordered_map>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+EmbeddingBag<InputDataType, OutputDataType>::EmbeddingBag(
+    const size_t vocabSize,
+    const size_t embeddingSize,
+    const bool mean,
+    const double stepSize) :
+    vocabSize(vocabSize),
+    embeddingSize(embeddingSize),
+    mean(mean),
+    stepSize(stepSize)
+{
+  table.randn(embeddingSize, vocabSize);
+  if (embeddingSize > 0)
+    table *= 1.0 / std::sqrt((double) embeddingSize);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void EmbeddingBag<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  output.zeros(embeddingSize, input.n_cols);
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    size_t count = 0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      const size_t token = (size_t) input(j, i);
+      if (token == 0)
+        continue;
+
+      if (token > vocabSize)
+      {
+        std::ostringstream oss;
+        oss << "EmbeddingBag::Forward(): token " << token << " is larger than "
+            << "the size of the vocabulary (" << vocabSize << ")!";
+        throw std::out_of_range(oss.str());
+      }
+
+      output.col(i) += table.col(token - 1);
+      ++count;
+    }
+
+    if (mean && count > 0)
+      output.col(i) /= count;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void EmbeddingBag<InputDataType, OutputDataType>::Forward(
+    const arma::SpMat<eT>& input, arma::Mat<eT>& output)
+{
+  output = table * input;
+
+  if (mean)
+  {
+    arma::Row<eT> counts(input.n_cols, arma::fill::zeros);
+    for (typename arma::SpMat<eT>::const_iterator it = input.begin();
+         it != input.end(); ++it)
+    {
+      ++counts[it.col()];
+    }
+
+    counts.elem(arma::find(counts == 0)).ones();
+    output.each_row() /= counts;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void EmbeddingBag<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */,
+    const arma::Mat<eT>& /* gy */,
+    arma::Mat<eT>& /* g */)
+{
+  Log::Fatal << "EmbeddingBag cannot be used as an intermediate layer."
+      << std::endl;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void EmbeddingBag<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& /* gradient */)
+{
+  std::vector<size_t> tokens, columns;
+  std::vector<eT> scales;
+  tokens.reserve(input.n_elem);
+  columns.reserve(input.n_elem);
+  scales.reserve(input.n_elem);
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t first = tokens.size();
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      const size_t token = (size_t) input(j, i);
+      if (token == 0)
+        continue;
+
+      tokens.push_back(token - 1);
+      columns.push_back(i);
+      scales.push_back(1);
+    }
+
+    if (mean && tokens.size() > first)
+    {
+      const eT scale = 1.0 / (tokens.size() - first);
+      for (size_t k = first; k < tokens.size(); ++k)
+        scales[k] = scale;
+    }
+  }
+
+  UpdateRows(tokens, columns, scales, error);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void EmbeddingBag<InputDataType, OutputDataType>::Gradient(
+    const arma::SpMat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& /* gradient */)
+{
+  std::vector<size_t> tokens, columns;
+  std::vector<eT> scales;
+  tokens.reserve(input.n_nonzero);
+  columns.reserve(input.n_nonzero);
+  scales.reserve(input.n_nonzero);
+
+  arma::Row<eT> counts(input.n_cols, arma::fill::zeros);
+  for (typename arma::SpMat<eT>::const_iterator it = input.begin();
+       it != input.end(); ++it)
+  {
+    tokens.push_back(it.row());
+    columns.push_back(it.col());
+    scales.push_back(*it);
+    ++counts[it.col()];
+  }
+
+  if (mean)
+  {
+    for (size_t k = 0; k < scales.size(); ++k)
+      scales[k] /= counts[columns[k]];
+  }
+
+  UpdateRows(tokens, columns, scales, error);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void EmbeddingBag<InputDataType, OutputDataType>::UpdateRows(
+    const std::vector<size_t>& tokens,
+    const std::vector<size_t>& columns,
+    const std::vector<eT>& scales,
+    const arma::Mat<eT>& error)
+{
+  // Give each distinct token a column of the row gradients, in the order of
+  // their first appearance.
+  std::unordered_map<size_t, size_t> positions;
+  std::vector<size_t> entryPositions(tokens.size());
+  std::vector<size_t> rows;
+  for (size_t k = 0; k < tokens.size(); ++k)
+  {
+    std::pair<std::unordered_map<size_t, size_t>::iterator, bool> result =
+        positions.insert(std::make_pair(tokens[k], rows.size()));
+    if (result.second)
+      rows.push_back(tokens[k]);
+
+    entryPositions[k] = result.first->second;
+  }
+
+  touchedRows = arma::conv_to<arma::uvec>::from(rows);
+  rowGradients.zeros(embeddingSize, rows.size());
+  for (size_t k = 0; k < tokens.size(); ++k)
+    rowGradients.col(entryPositions[k]) += scales[k] * error.col(columns[k]);
+
+  if (stepSize != 0)
+  {
+    for (size_t k = 0; k < rows.size(); ++k)
+      table.col(rows[k]) -= stepSize * rowGradients.col(k);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void EmbeddingBag<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(vocabSize);
+  ar & BOOST_SERIALIZATION_NVP(embeddingSize);
+  ar & BOOST_SERIALIZATION_NVP(mean);
+  ar & BOOST_SERIALIZATION_NVP(stepSize);
+  ar & BOOST_SERIALIZATION_NVP(table);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -33,6 +33,11 @@ namespace ann /** Artificial Neural Network. */ {
  * h &=& o \cdot tanh(c)
  * @f}
  *
+ * All the gates of a step are computed by a single matrix product of the
+ * weights with the stacked input, bias and previous output, and the
+ * activations, the cell update and the output are then computed in one pass
+ * over the gates; the backward pass and the gradient are fused in the same way.
+ *
  * Note that FastLSTM network layer does not use peephole connections between
  * the cell and gates.
  *
@@ -121,6 +126,13 @@ class FastLSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Drop the error carried back from the later time steps, so that the next
+   * call to Backward() starts a new truncated BPTT window.  The state of the
+   * cell is kept.
+   */
+  void TruncateBackward();
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -172,17 +184,16 @@ class FastLSTM
 
  private:
   /**
-   * This speeds up the sigmoid operation by using an approximation.
+   * Stack the given input, a row of ones and the output of the previous step
+   * into the gate input workspace, so that they can be multiplied with all the
+   * weights at once.
    *
-   * @param input The input data.
-   * @param sigmoid The matrix to store the sigmoid approximation into.
+   * @param input The input of the step.
+   * @param step The first column of the output of the previous step in the
+   *     output parameters.
    */
-  template<typename InputType, typename OutputType>
-  void FastSigmoid(const InputType& input, OutputType& sigmoids)
-  {
-    for (size_t i = 0; i < input.n_elem; ++i)
-      sigmoids(i) = FastSigmoid(input(i));
-  }
+  template<typename InputType>
+  void GateInput(const InputType& input, const size_t step);
 
   /**
    * Sigmoid approximation for the given sample.
@@ -272,6 +283,14 @@ class FastLSTM
   //! Bias between the input and gate.
   OutputDataType input2GateBias;
 
+  //! All the weights of the gates, as one matrix; the columns hold the input
+  //! to gate weights, the bias and the output to gate weights.
+  OutputDataType gateWeight;
+
+  //! Locally-stored input, row of ones and previous output of the current
+  //! step.
+  OutputDataType gateInput;
+
   //! Locally-stored gate parameter.
   OutputDataType gate;
 
@@ -60,6 +60,12 @@ void FastLSTM<InputDataType, OutputDataType>::Reset()
   // (linear no bias layer) using the overall layer parameter matrix.
   output2GateWeight = OutputDataType(weights.memptr() + input2GateWeight.n_elem
       + input2GateBias.n_elem, 4 * outSize, outSize, false, false);
+
+  // The three blocks are consecutive columns of the same matrix, so the gates
+  // can be computed by a single product with the stacked input, bias and
+  // previous output.
+  gateWeight = OutputDataType(weights.memptr(), 4 * outSize,
+      inSize + 1 + outSize, false, false);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -109,6 +115,13 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::TruncateBackward()
+{
+  prevError.zeros();
+  forgetGateError.zeros();
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename InputType, typename OutputType>
 void FastLSTM<InputDataType, OutputDataType>::Forward(
@@ -123,50 +136,48 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
-  gate.cols(forwardStep, forwardStep + batchStep) = input2GateWeight * input +
-      output2GateWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  gate.cols(forwardStep, forwardStep + batchStep).each_col() += input2GateBias;
-
-  arma::subview<double> sigmoidOut = gateActivation.cols(forwardStep,
-      forwardStep + batchStep);
-  FastSigmoid(
-      gate.submat(0, forwardStep, 3 * outSize - 1, forwardStep + batchStep),
-      sigmoidOut);
-
-  stateActivation.cols(forwardStep, forwardStep + batchStep) = arma::tanh(
-      gate.submat(3 * outSize, forwardStep, 4 * outSize - 1,
-      forwardStep + batchStep));
-
-  // Update the cell: cmul1 + cmul2
-  // where cmul1 is input gate * hidden state and
-  // cmul2 is forget gate * cell (prevCell).
-  if (forwardStep == 0)
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-  else
+  // Compute all the gates of the batch with one product, directly into the
+  // workspace of the current step.
+  GateInput(input, forwardStep);
+  OutputDataType gateStep(gate.colptr(forwardStep), 4 * outSize, batchSize,
+      false, true);
+  gateStep = gateWeight * gateInput;
+
+  // Apply the activations and update the cell and the output in a single pass
+  // over the gates, instead of one pass per expression.
+  for (size_t j = forwardStep; j <= forwardStep + batchStep; ++j)
   {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep) +
-        gateActivation.submat(2 * outSize, forwardStep, 3 * outSize - 1,
-        forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
+    const ElemType* gatePtr = gate.colptr(j);
+    ElemType* gateActivationPtr = gateActivation.colptr(j);
+    ElemType* stateActivationPtr = stateActivation.colptr(j);
+    ElemType* cellPtr = cell.colptr(j);
+    ElemType* cellActivationPtr = cellActivation.colptr(j);
+    ElemType* outputPtr = outParameter.colptr(j + batchSize);
+    const ElemType* prevCellPtr = (forwardStep == 0) ? NULL :
+        cell.colptr(j - batchSize);
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      const ElemType inputGate = FastSigmoid(gatePtr[k]);
+      const ElemType outputGate = FastSigmoid(gatePtr[outSize + k]);
+      const ElemType forgetGate = FastSigmoid(gatePtr[2 * outSize + k]);
+      const ElemType state = std::tanh(gatePtr[3 * outSize + k]);
+
+      gateActivationPtr[k] = inputGate;
+      gateActivationPtr[outSize + k] = outputGate;
+      gateActivationPtr[2 * outSize + k] = forgetGate;
+      stateActivationPtr[k] = state;
+
+      // Update the cell: input gate * hidden state + forget gate * prevCell.
+      cellPtr[k] = inputGate * state;
+      if (prevCellPtr)
+        cellPtr[k] += forgetGate * prevCellPtr[k];
+
+      cellActivationPtr[k] = std::tanh(cellPtr[k]);
+      outputPtr[k] = cellActivationPtr[k] * outputGate;
+    }
   }
 
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
-
-  outParameter.cols(forwardStep + batchSize,
-      forwardStep + batchSize + batchStep) = cellActivation.cols(
-      forwardStep, forwardStep + batchStep) % gateActivation.submat(
-      outSize, forwardStep, 2 * outSize - 1, forwardStep + batchStep);
-
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
 
@@ -193,51 +204,49 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
         false);
   }
 
-  cellActivationError = gyLocal % gateActivation.submat(outSize,
-      backwardStep - batchStep, 2 * outSize - 1, backwardStep) %
-      (1 - arma::pow(cellActivation.cols(backwardStep - batchStep,
-      backwardStep), 2));
-
-  if (gradientStepIdx > 0)
-    cellActivationError += forgetGateError;
-
-  forgetGateError = gateActivation.submat(2 * outSize,
-      backwardStep - batchStep, 3 * outSize - 1, backwardStep) %
-      cellActivationError;
+  if (gradientStepIdx == 0)
+    forgetGateError.set_size(outSize, batchSize);
+  cellActivationError.set_size(outSize, batchSize);
 
-  if (backwardStep > batchStep)
+  // Compute the error of the cell and of each gate in a single pass.
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) =
-        cell.cols((backwardStep - batchSize) - batchStep,
-        (backwardStep - batchSize)) % cellActivationError %
-        gateActivation.submat(2 * outSize, backwardStep - batchStep,
-        3 * outSize - 1, backwardStep) % (1.0 - gateActivation.submat(
-        2 * outSize, backwardStep - batchStep, 3 * outSize - 1, backwardStep));
-  }
-  else
-  {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep).zeros();
+    const size_t step = backwardStep - batchStep + j;
+    const ElemType* gyPtr = gyLocal.colptr(j);
+    const ElemType* gateActivationPtr = gateActivation.colptr(step);
+    const ElemType* stateActivationPtr = stateActivation.colptr(step);
+    const ElemType* cellActivationPtr = cellActivation.colptr(step);
+    const ElemType* prevCellPtr = (backwardStep > batchStep) ?
+        cell.colptr(step - batchSize) : NULL;
+    ElemType* cellActivationErrorPtr = cellActivationError.colptr(j);
+    ElemType* forgetGateErrorPtr = forgetGateError.colptr(j);
+    ElemType* errorPtr = prevError.colptr(j);
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      const ElemType inputGate = gateActivationPtr[k];
+      const ElemType outputGate = gateActivationPtr[outSize + k];
+      const ElemType forgetGate = gateActivationPtr[2 * outSize + k];
+      const ElemType state = stateActivationPtr[k];
+      const ElemType cellActivationValue = cellActivationPtr[k];
+
+      ElemType cellError = gyPtr[k] * outputGate *
+          (1 - cellActivationValue * cellActivationValue);
+      if (gradientStepIdx > 0)
+        cellError += forgetGateErrorPtr[k];
+
+      cellActivationErrorPtr[k] = cellError;
+      forgetGateErrorPtr[k] = forgetGate * cellError;
+
+      errorPtr[k] = state * cellError * inputGate * (1.0 - inputGate);
+      errorPtr[outSize + k] = cellActivationValue * gyPtr[k] * outputGate *
+          (1.0 - outputGate);
+      errorPtr[2 * outSize + k] = prevCellPtr ? prevCellPtr[k] * cellError *
+          forgetGate * (1.0 - forgetGate) : 0;
+      errorPtr[3 * outSize + k] = inputGate * cellError * (1 - state * state);
+    }
   }
 
-  prevError.submat(0, 0, outSize - 1, batchStep) =
-      stateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellActivationError % gateActivation.submat(
-      0, backwardStep - batchStep, outSize - 1, backwardStep) %
-      (1.0 - gateActivation.submat(
-      0, backwardStep - batchStep, outSize - 1, backwardStep));
-
-  prevError.submat(3 * outSize, 0, 4 * outSize - 1, batchStep) =
-      gateActivation.submat(0, backwardStep - batchStep,
-      outSize - 1, backwardStep) % cellActivationError % (1 - arma::pow(
-      stateActivation.cols(backwardStep - batchStep, backwardStep), 2));
-
-  prevError.submat(outSize, 0, 2 * outSize - 1, batchStep) =
-      cellActivation.cols(backwardStep - batchStep,
-      backwardStep) % gyLocal % gateActivation.submat(
-       outSize, backwardStep - batchStep, 2 * outSize - 1, backwardStep) %
-      (1.0 - gateActivation.submat(
-      outSize, backwardStep - batchStep, 2 * outSize - 1, backwardStep));
-
   g = input2GateWeight.t() * prevError;
 
   backwardStep -= batchSize;
@@ -256,17 +265,12 @@ void FastLSTM<InputDataType, OutputDataType>::Gradient(
     const ErrorType& /* error */,
     GradientType& gradient)
 {
-  // Gradient of the input to gate layer.
-  gradient.submat(0, 0, input2GateWeight.n_elem - 1, 0) =
-      arma::vectorise(prevError * input.t());
-
-  gradient.submat(input2GateWeight.n_elem, 0, input2GateWeight.n_elem +
-      input2GateBias.n_elem - 1, 0) = arma::sum(prevError, 1);
-
-  // Gradient of the output to gate layer.
-  gradient.submat(input2GateWeight.n_elem + input2GateBias.n_elem, 0,
-      gradient.n_elem - 1, 0) = arma::vectorise(prevError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
+  // The gradients of the input to gate weights, the bias and the output to
+  // gate weights are consecutive columns, so they are one product.
+  GateInput(input, gradientStep - batchStep);
+  OutputDataType gradientMat(gradient.memptr(), 4 * outSize,
+      inSize + 1 + outSize, false, true);
+  gradientMat = prevError * gateInput.t();
 
   if (gradientStep > batchStep)
   {
@@ -278,6 +282,18 @@ void FastLSTM<InputDataType, OutputDataType>::Gradient(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType>
+void FastLSTM<InputDataType, OutputDataType>::GateInput(
+    const InputType& input, const size_t step)
+{
+  gateInput.set_size(inSize + 1 + outSize, batchSize);
+  gateInput.rows(0, inSize - 1) = input;
+  gateInput.row(inSize).ones();
+  gateInput.rows(inSize + 1, inSize + outSize) = outParameter.cols(step,
+      step + batchStep);
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void FastLSTM<InputDataType, OutputDataType>::serialize(
@@ -0,0 +1,117 @@
+/**
+ * @file methods/ann/layer/fused_linear_impl.hpp
+ *
+ * Implementation of the FusedLinear layer class, a Linear layer followed by an
+ * activation function that is applied in the same pass over the output.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fused_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear() :
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear(
+    const size_t inSize,
+    const size_t outSize) :
+    inSize(inSize),
+    outSize(outSize)
+{
+  weights.set_size(outSize * inSize + outSize, 1);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Reset()
+{
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
+      outSize, 1, false, false);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  output = weight * input;
+
+  // Add the bias and apply the activation function while the column is still
+  // in the cache.
+  for (size_t i = 0; i < output.n_cols; ++i)
+  {
+    eT* outputPtr = output.colptr(i);
+    for (size_t j = 0; j < output.n_rows; ++j)
+      outputPtr[j] = ActivationFunction::Fn(outputPtr[j] + bias[j]);
+  }
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  arma::Mat<eT> derivative;
+  ActivationFunction::Deriv(input, derivative);
+  g = weight.t() * (gy % derivative);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  // The first layer of a network is never given the backward pass, so the
+  // error before the activation function is computed again here.
+  arma::Mat<eT> derivative;
+  ActivationFunction::Deriv(outputParameter, derivative);
+  const arma::Mat<eT> layerError = error % derivative;
+
+  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+      layerError * input.t());
+  gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
+      arma::sum(layerError, 1);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+template<typename Archive>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+
+  // This is inefficient, but we have to allocate this memory so that
+  // WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+    weights.set_size(outSize * inSize + outSize, 1);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,361 @@
+/**
+ * @file methods/ann/layer/grouped_convolution.hpp
+ *
+ * Definition of the GroupedConvolution module class, which implements grouped,
+ * depthwise and pointwise convolutions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_GROUPED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_GROUPED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the GroupedConvolution class.  The input maps and the
+ * output maps are split into the given number of groups, and each output map
+ * only depends on the input maps of its group, so the layer has groups times
+ * fewer weights than a Convolution layer of the same size.  With one group,
+ * the layer is a plain convolution; with one group per input map, it is a
+ * depthwise convolution (each input map is convolved with its own filters,
+ * outSize / inSize of them); a depthwise convolution followed by a 1x1
+ * convolution is a depthwise-separable convolution, as in MobileNet.
+ *
+ * Each case has its own kernel:
+ *
+ *  - depthwise convolutions are computed directly, one filter element at a
+ *    time over whole rows of the map, which the compiler vectorizes;
+ *  - pointwise (1x1, stride 1, unpadded) convolutions are a matrix product of
+ *    the input maps of each group with its filters;
+ *  - the other convolutions unroll the patches of the input maps of each group
+ *    (im2col) and multiply them with the filters of the group.
+ *
+ * The filters and the input are laid out like those of the Convolution layer:
+ * the filters of output map o are the slices o * (inSize / groups) to
+ * (o + 1) * (inSize / groups) - 1 of Weight(), and the maps are correlated with
+ * the filters, as NaiveConvolution does.  So with one group, the layer gives
+ * the results of Convolution for the same weights.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class GroupedConvolution
+{
+ public:
+  //! Create the GroupedConvolution object.
+  GroupedConvolution();
+
+  /**
+   * Create the GroupedConvolution object using the specified number of input
+   * maps, output maps, groups, filter size, stride and padding parameter.
+   * Throws std::invalid_argument if the numbers of input and output maps are
+   * not multiples of the number of groups.
+   *
+   * @param inSize The number of input maps.
+   * @param outSize The number of output maps.
+   * @param groups The number of groups (inSize for a depthwise convolution).
+   * @param kernelWidth Width of the filter/kernel.
+   * @param kernelHeight Height of the filter/kernel.
+   * @param strideWidth Stride of filter application in the x direction.
+   * @param strideHeight Stride of filter application in the y direction.
+   * @param padW Padding width of the input, on each side.
+   * @param padH Padding height of the input, on each side.
+   * @param inputWidth The width of the input data.
+   * @param inputHeight The height of the input data.
+   */
+  GroupedConvolution(const size_t inSize,
+                     const size_t outSize,
+                     const size_t groups,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     const size_t strideWidth = 1,
+                     const size_t strideHeight = 1,
+                     const size_t padW = 0,
+                     const size_t padH = 0,
+                     const size_t inputWidth = 0,
+                     const size_t inputHeight = 0);
+
+  /*
+   * Set the weight and bias term.
+   */
+  void Reset();
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards through f. Using the results from the feed
+   * forward pass.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the weight of the layer.
+  arma::cube const& Weight() const { return weight; }
+  //! Modify the weight of the layer.
+  arma::cube& Weight() { return weight; }
+
+  //! Get the bias of the layer.
+  arma::mat const& Bias() const { return bias; }
+  //! Modify the bias of the layer.
+  arma::mat& Bias() { return bias; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the input width.
+  size_t InputWidth() const { return inputWidth; }
+  //! Modify input the width.
+  size_t& InputWidth() { return inputWidth; }
+
+  //! Get the input height.
+  size_t InputHeight() const { return inputHeight; }
+  //! Modify the input height.
+  size_t& InputHeight() { return inputHeight; }
+
+  //! Get the output width.
+  size_t OutputWidth() const { return outputWidth; }
+  //! Modify the output width.
+  size_t& OutputWidth() { return outputWidth; }
+
+  //! Get the output height.
+  size_t OutputHeight() const { return outputHeight; }
+  //! Modify the output height.
+  size_t& OutputHeight() { return outputHeight; }
+
+  //! Get the input size.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the output size.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the number of groups.
+  size_t Groups() const { return groups; }
+
+  //! Get the kernel width.
+  size_t KernelWidth() const { return kernelWidth; }
+
+  //! Get the kernel height.
+  size_t KernelHeight() const { return kernelHeight; }
+
+  //! Get the stride width.
+  size_t StrideWidth() const { return strideWidth; }
+
+  //! Get the stride height.
+  size_t StrideHeight() const { return strideHeight; }
+
+  //! Get the padding width.
+  size_t PadW() const { return padW; }
+
+  //! Get the padding height.
+  size_t PadH() const { return padH; }
+
+  //! Get whether the layer is a depthwise convolution (one input map per
+  //! group).
+  bool Depthwise() const { return inSize == groups; }
+
+  //! Get whether the layer is a pointwise convolution (1x1 filters, stride 1
+  //! and no padding).
+  bool Pointwise() const
+  {
+    return kernelWidth == 1 && kernelHeight == 1 && strideWidth == 1 &&
+        strideHeight == 1 && padW == 0 && padH == 0;
+  }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Convolve the maps of one group of one point with the filters of the
+   * group, directly for a depthwise convolution.  The output maps must be
+   * zero.
+   *
+   * @param input The (padded) input map of the group.
+   * @param filters The filters of the output maps of the group.
+   * @param output The output maps of the group.
+   */
+  template<typename eT>
+  void DepthwiseForward(const eT* input, const eT* filters, eT* output) const;
+
+  /**
+   * Backpropagate the error of the output maps of one group of one point to
+   * its (padded) input map, for a depthwise convolution.
+   *
+   * @param error The error of the output maps of the group.
+   * @param filters The filters of the output maps of the group.
+   * @param g The error of the (padded) input map, which is added to.
+   */
+  template<typename eT>
+  void DepthwiseBackward(const eT* error, const eT* filters, eT* g) const;
+
+  /**
+   * Add the gradient of the filters of one group of one point, for a
+   * depthwise convolution.
+   *
+   * @param input The (padded) input map of the group.
+   * @param error The error of the output maps of the group.
+   * @param gradient The gradient of the filters of the group, added to.
+   */
+  template<typename eT>
+  void DepthwiseGradient(const eT* input,
+                         const eT* error,
+                         eT* gradient) const;
+
+  /**
+   * Add each column of the given patches to the maps of the given (padded)
+   * input error; this is the transposition of Im2ColConvolution::Im2Col().
+   *
+   * @param patches The errors of the patches, one per output element.
+   * @param g The error of the (padded) input maps of the group, added to.
+   */
+  template<typename eT>
+  void Col2Im(const arma::Mat<eT>& patches, eT* g) const;
+
+  //! Get the width of the padded input.
+  size_t PaddedWidth() const { return inputWidth + 2 * padW; }
+  //! Get the height of the padded input.
+  size_t PaddedHeight() const { return inputHeight + 2 * padH; }
+
+  //! Locally-stored number of input channels.
+  size_t inSize;
+
+  //! Locally-stored number of output channels.
+  size_t outSize;
+
+  //! Locally-stored number of groups.
+  size_t groups;
+
+  //! Locally-stored number of input units.
+  size_t batchSize;
+
+  //! Locally-stored filter/kernel width.
+  size_t kernelWidth;
+
+  //! Locally-stored filter/kernel height.
+  size_t kernelHeight;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t strideWidth;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t strideHeight;
+
+  //! Locally-stored padding width, on each side.
+  size_t padW;
+
+  //! Locally-stored padding height, on each side.
+  size_t padH;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! Locally-stored weight object.
+  arma::cube weight;
+
+  //! Locally-stored bias term object.
+  arma::mat bias;
+
+  //! Locally-stored input width.
+  size_t inputWidth;
+
+  //! Locally-stored input height.
+  size_t inputHeight;
+
+  //! Locally-stored output width.
+  size_t outputWidth;
+
+  //! Locally-stored output height.
+  size_t outputHeight;
+
+  //! Locally-stored padded input of the last forward pass.
+  arma::mat inputPadded;
+
+  //! Locally-stored error of the padded input.
+  arma::mat gPadded;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class GroupedConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "grouped_convolution_impl.hpp"
+
+#endif
@@ -0,0 +1,466 @@
+/**
+ * @file methods/ann/layer/grouped_convolution_impl.hpp
+ *
+ * Implementation of the GroupedConvolution module class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_GROUPED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_GROUPED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "grouped_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+GroupedConvolution<InputDataType, OutputDataType>::GroupedConvolution() :
+    inSize(0),
+    outSize(0),
+    groups(1),
+    batchSize(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padW(0),
+    padH(0),
+    inputWidth(0),
+    inputHeight(0),
+    outputWidth(0),
+    outputHeight(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+GroupedConvolution<InputDataType, OutputDataType>::GroupedConvolution(
+    const size_t inSize,
+    const size_t outSize,
+    const size_t groups,
+    const size_t kernelWidth,
+    const size_t kernelHeight,
+    const size_t strideWidth,
+    const size_t strideHeight,
+    const size_t padW,
+    const size_t padH,
+    const size_t inputWidth,
+    const size_t inputHeight) :
+    inSize(inSize),
+    outSize(outSize),
+    groups(groups),
+    batchSize(0),
+    kernelWidth(kernelWidth),
+    kernelHeight(kernelHeight),
+    strideWidth(strideWidth),
+    strideHeight(strideHeight),
+    padW(padW),
+    padH(padH),
+    inputWidth(inputWidth),
+    inputHeight(inputHeight),
+    outputWidth(0),
+    outputHeight(0)
+{
+  if (groups == 0 || inSize % groups != 0 || outSize % groups != 0)
+  {
+    std::ostringstream oss;
+    oss << "GroupedConvolution::GroupedConvolution(): the numbers of input "
+        << "maps (" << inSize << ") and output maps (" << outSize << ") must "
+        << "be multiples of the number of groups (" << groups << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  weights.set_size((outSize * (inSize / groups) * kernelWidth * kernelHeight) +
+      outSize, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void GroupedConvolution<InputDataType, OutputDataType>::Reset()
+{
+  weight = arma::cube(weights.memptr(), kernelWidth, kernelHeight,
+      outSize * (inSize / groups), false, false);
+  bias = arma::mat(weights.memptr() + weight.n_elem, outSize, 1, false,
+      false);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void GroupedConvolution<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  batchSize = input.n_cols;
+  outputWidth = (PaddedWidth() - kernelWidth) / strideWidth + 1;
+  outputHeight = (PaddedHeight() - kernelHeight) / strideHeight + 1;
+
+  const size_t inMaps = inSize / groups;
+  const size_t outMaps = outSize / groups;
+  const size_t inMapSize = PaddedWidth() * PaddedHeight();
+  const size_t outMapSize = outputWidth * outputHeight;
+  const size_t filterSize = kernelWidth * kernelHeight * inMaps;
+
+  // Pad the input maps, if needed; the padded input is kept for Gradient().
+  const eT* inputMemory = input.memptr();
+  if (padW != 0 || padH != 0)
+  {
+    inputPadded.zeros(inMapSize * inSize, batchSize);
+    for (size_t m = 0; m < inSize * batchSize; ++m)
+    {
+      const arma::Mat<eT> map(const_cast<eT*>(input.memptr()) + m *
+          inputWidth * inputHeight, inputWidth, inputHeight, false, true);
+      arma::Mat<eT> paddedMap(inputPadded.memptr() + m * inMapSize,
+          PaddedWidth(), PaddedHeight(), false, true);
+      paddedMap.submat(padW, padH, padW + inputWidth - 1,
+          padH + inputHeight - 1) = map;
+    }
+    inputMemory = inputPadded.memptr();
+  }
+
+  output.zeros(outMapSize * outSize, batchSize);
+
+  arma::Mat<eT> patches;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    for (size_t group = 0; group < groups; ++group)
+    {
+      const eT* groupInput = inputMemory + (i * inSize + group * inMaps) *
+          inMapSize;
+      const eT* groupFilters = weights.memptr() + group * outMaps * filterSize;
+      eT* groupOutput = output.colptr(i) + group * outMaps * outMapSize;
+
+      if (Depthwise())
+      {
+        DepthwiseForward(groupInput, groupFilters, groupOutput);
+        continue;
+      }
+
+      // The filters of each output map are contiguous, so they are the
+      // columns of a matrix, and so are the output maps.
+      const arma::Mat<eT> filterMat(const_cast<eT*>(groupFilters), filterSize,
+          outMaps, false, true);
+      arma::Mat<eT> outputMat(groupOutput, outMapSize, outMaps, false, true);
+      if (Pointwise())
+      {
+        // Each row of the input maps is the patch of one output element.
+        const arma::Mat<eT> inputMat(const_cast<eT*>(groupInput), inMapSize,
+            inMaps, false, true);
+        outputMat = inputMat * filterMat;
+      }
+      else
+      {
+        Im2ColConvolution<ValidConvolution>::Im2Col(groupInput, PaddedWidth(),
+            PaddedHeight(), inMaps, kernelWidth, kernelHeight, outputWidth,
+            outputHeight, strideWidth, strideHeight, 1, 1, patches);
+        outputMat = patches.t() * filterMat;
+      }
+    }
+
+    for (size_t o = 0; o < outSize; ++o)
+    {
+      arma::Col<eT> outputMap(output.colptr(i) + o * outMapSize, outMapSize,
+          false, true);
+      outputMap += bias(o);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void GroupedConvolution<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  const size_t inMaps = inSize / groups;
+  const size_t outMaps = outSize / groups;
+  const size_t inMapSize = PaddedWidth() * PaddedHeight();
+  const size_t outMapSize = outputWidth * outputHeight;
+  const size_t filterSize = kernelWidth * kernelHeight * inMaps;
+  const bool padded = (padW != 0 || padH != 0);
+
+  // The error of the padded input is computed, and then cropped.
+  eT* gMemory;
+  if (padded)
+  {
+    gPadded.zeros(inMapSize * inSize, batchSize);
+    gMemory = gPadded.memptr();
+  }
+  else
+  {
+    g.zeros(inMapSize * inSize, batchSize);
+    gMemory = g.memptr();
+  }
+
+  arma::Mat<eT> patches;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    for (size_t group = 0; group < groups; ++group)
+    {
+      const eT* groupError = gy.colptr(i) + group * outMaps * outMapSize;
+      const eT* groupFilters = weights.memptr() + group * outMaps * filterSize;
+      eT* groupG = gMemory + (i * inSize + group * inMaps) * inMapSize;
+
+      if (Depthwise())
+      {
+        DepthwiseBackward(groupError, groupFilters, groupG);
+        continue;
+      }
+
+      const arma::Mat<eT> filterMat(const_cast<eT*>(groupFilters), filterSize,
+          outMaps, false, true);
+      const arma::Mat<eT> errorMat(const_cast<eT*>(groupError), outMapSize,
+          outMaps, false, true);
+      if (Pointwise())
+      {
+        arma::Mat<eT> gMat(groupG, inMapSize, inMaps, false, true);
+        gMat = errorMat * filterMat.t();
+      }
+      else
+      {
+        patches = filterMat * errorMat.t();
+        Col2Im(patches, groupG);
+      }
+    }
+  }
+
+  if (padded)
+  {
+    g.set_size(inputWidth * inputHeight * inSize, batchSize);
+    for (size_t m = 0; m < inSize * batchSize; ++m)
+    {
+      const arma::Mat<eT> paddedMap(gPadded.memptr() + m * inMapSize,
+          PaddedWidth(), PaddedHeight(), false, true);
+      arma::Mat<eT> map(g.memptr() + m * inputWidth * inputHeight,
+          inputWidth, inputHeight, false, true);
+      map = paddedMap.submat(padW, padH, padW + inputWidth - 1,
+          padH + inputHeight - 1);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void GroupedConvolution<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  const size_t inMaps = inSize / groups;
+  const size_t outMaps = outSize / groups;
+  const size_t inMapSize = PaddedWidth() * PaddedHeight();
+  const size_t outMapSize = outputWidth * outputHeight;
+  const size_t filterSize = kernelWidth * kernelHeight * inMaps;
+
+  // The padded input was kept by Forward().
+  const eT* inputMemory = (padW != 0 || padH != 0) ? inputPadded.memptr() :
+      input.memptr();
+
+  gradient.zeros(weights.n_elem, 1);
+
+  arma::Mat<eT> patches;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    for (size_t group = 0; group < groups; ++group)
+    {
+      const eT* groupInput = inputMemory + (i * inSize + group * inMaps) *
+          inMapSize;
+      const eT* groupError = error.colptr(i) + group * outMaps * outMapSize;
+      eT* groupGradient = gradient.memptr() + group * outMaps * filterSize;
+
+      if (Depthwise())
+      {
+        DepthwiseGradient(groupInput, groupError, groupGradient);
+        continue;
+      }
+
+      const arma::Mat<eT> errorMat(const_cast<eT*>(groupError), outMapSize,
+          outMaps, false, true);
+      arma::Mat<eT> gradientMat(groupGradient, filterSize, outMaps, false,
+          true);
+      if (Pointwise())
+      {
+        const arma::Mat<eT> inputMat(const_cast<eT*>(groupInput), inMapSize,
+            inMaps, false, true);
+        gradientMat += inputMat.t() * errorMat;
+      }
+      else
+      {
+        Im2ColConvolution<ValidConvolution>::Im2Col(groupInput, PaddedWidth(),
+            PaddedHeight(), inMaps, kernelWidth, kernelHeight, outputWidth,
+            outputHeight, strideWidth, strideHeight, 1, 1, patches);
+        gradientMat += patches * errorMat;
+      }
+    }
+
+    // The gradient of the bias of each output map is the sum of its error.
+    const arma::Mat<eT> errorMaps(const_cast<eT*>(error.colptr(i)),
+        outMapSize, outSize, false, true);
+    gradient.rows(weight.n_elem, weight.n_elem + outSize - 1) +=
+        arma::sum(errorMaps, 0).t();
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void GroupedConvolution<InputDataType, OutputDataType>::DepthwiseForward(
+    const eT* input, const eT* filters, eT* output) const
+{
+  const size_t paddedWidth = PaddedWidth();
+  for (size_t o = 0; o < outSize / groups; ++o)
+  {
+    const eT* filter = filters + o * kernelWidth * kernelHeight;
+    eT* outputMap = output + o * outputWidth * outputHeight;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      eT* outputCol = outputMap + j * outputWidth;
+      for (size_t kj = 0; kj < kernelHeight; ++kj)
+      {
+        const eT* inputCol = input + (j * strideHeight + kj) * paddedWidth;
+        for (size_t ki = 0; ki < kernelWidth; ++ki)
+        {
+          // Add one element of the filter times a row of the input to the
+          // output column.
+          const eT w = filter[kj * kernelWidth + ki];
+          const eT* inputPtr = inputCol + ki;
+          if (strideWidth == 1)
+          {
+            for (size_t i = 0; i < outputWidth; ++i)
+              outputCol[i] += w * inputPtr[i];
+          }
+          else
+          {
+            for (size_t i = 0; i < outputWidth; ++i)
+              outputCol[i] += w * inputPtr[i * strideWidth];
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void GroupedConvolution<InputDataType, OutputDataType>::DepthwiseBackward(
+    const eT* error, const eT* filters, eT* g) const
+{
+  const size_t paddedWidth = PaddedWidth();
+  for (size_t o = 0; o < outSize / groups; ++o)
+  {
+    const eT* filter = filters + o * kernelWidth * kernelHeight;
+    const eT* errorMap = error + o * outputWidth * outputHeight;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const eT* errorCol = errorMap + j * outputWidth;
+      for (size_t kj = 0; kj < kernelHeight; ++kj)
+      {
+        eT* gCol = g + (j * strideHeight + kj) * paddedWidth;
+        for (size_t ki = 0; ki < kernelWidth; ++ki)
+        {
+          const eT w = filter[kj * kernelWidth + ki];
+          eT* gPtr = gCol + ki;
+          if (strideWidth == 1)
+          {
+            for (size_t i = 0; i < outputWidth; ++i)
+              gPtr[i] += w * errorCol[i];
+          }
+          else
+          {
+            for (size_t i = 0; i < outputWidth; ++i)
+              gPtr[i * strideWidth] += w * errorCol[i];
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void GroupedConvolution<InputDataType, OutputDataType>::DepthwiseGradient(
+    const eT* input, const eT* error, eT* gradient) const
+{
+  const size_t paddedWidth = PaddedWidth();
+  for (size_t o = 0; o < outSize / groups; ++o)
+  {
+    eT* filterGradient = gradient + o * kernelWidth * kernelHeight;
+    const eT* errorMap = error + o * outputWidth * outputHeight;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const eT* errorCol = errorMap + j * outputWidth;
+      for (size_t kj = 0; kj < kernelHeight; ++kj)
+      {
+        const eT* inputCol = input + (j * strideHeight + kj) * paddedWidth;
+        for (size_t ki = 0; ki < kernelWidth; ++ki)
+        {
+          const eT* inputPtr = inputCol + ki;
+          eT sum = 0;
+          for (size_t i = 0; i < outputWidth; ++i)
+            sum += inputPtr[i * strideWidth] * errorCol[i];
+          filterGradient[kj * kernelWidth + ki] += sum;
+        }
+      }
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void GroupedConvolution<InputDataType, OutputDataType>::Col2Im(
+    const arma::Mat<eT>& patches, eT* g) const
+{
+  const size_t inMaps = inSize / groups;
+  const size_t inMapSize = PaddedWidth() * PaddedHeight();
+
+  // Walk the patches in the order Im2Col() wrote them.
+  const eT* patchPtr = patches.memptr();
+  for (size_t j = 0; j < outputHeight; ++j)
+  {
+    for (size_t i = 0; i < outputWidth; ++i)
+    {
+      for (size_t m = 0; m < inMaps; ++m)
+      {
+        eT* mapPtr = g + m * inMapSize;
+        for (size_t kj = 0; kj < kernelHeight; ++kj)
+        {
+          eT* gPtr = mapPtr + (j * strideHeight + kj) * PaddedWidth() +
+              i * strideWidth;
+          for (size_t ki = 0; ki < kernelWidth; ++ki)
+            *gPtr++ += *patchPtr++;
+        }
+      }
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void GroupedConvolution<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(groups);
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(kernelWidth);
+  ar & BOOST_SERIALIZATION_NVP(kernelHeight);
+  ar & BOOST_SERIALIZATION_NVP(strideWidth);
+  ar & BOOST_SERIALIZATION_NVP(strideHeight);
+  ar & BOOST_SERIALIZATION_NVP(padW);
+  ar & BOOST_SERIALIZATION_NVP(padH);
+  ar & BOOST_SERIALIZATION_NVP(inputWidth);
+  ar & BOOST_SERIALIZATION_NVP(inputHeight);
+  ar & BOOST_SERIALIZATION_NVP(outputWidth);
+  ar & BOOST_SERIALIZATION_NVP(outputHeight);
+
+  if (Archive::is_loading::value)
+  {
+    weights.set_size((outSize * (inSize / groups) * kernelWidth *
+        kernelHeight) + outSize, 1);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -116,6 +116,13 @@ class GRU
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Drop the error carried back from the later time steps, so that the next
+   * call to Backward() starts a new truncated BPTT window.  The state of the
+   * cell is kept.
+   */
+  void TruncateBackward();
+
   //! The value of the deterministic parameter.
   bool Deterministic() const { return deterministic; }
   //! Modify the value of the deterministic parameter.
@@ -377,6 +377,12 @@ void GRU<InputDataType, OutputDataType>::ResetCell(const size_t /* size */)
   backwardStep = 0;
 }
 
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::TruncateBackward()
+{
+  boost::apply_visitor(deltaVisitor, output2GateModule).zeros();
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void GRU<InputDataType, OutputDataType>::serialize(
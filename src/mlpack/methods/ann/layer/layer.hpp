@@ -31,9 +31,12 @@
 #include "dropconnect.hpp"
 #include "dropout.hpp"
 #include "elu.hpp"
+#include "embedding_bag.hpp"
 #include "fast_lstm.hpp"
 #include "flexible_relu.hpp"
+#include "fused_linear.hpp"
 #include "glimpse.hpp"
+#include "grouped_convolution.hpp"
 #include "gru.hpp"
 #include "hard_tanh.hpp"
 #include "hardshrink.hpp"
@@ -65,6 +68,7 @@
 #include "select.hpp"
 #include "sequential.hpp"
 #include "softshrink.hpp"
+#include "sparse_linear.hpp"
 #include "softmax.hpp"
 #include "spatial_dropout.hpp"
 #include "subview.hpp"
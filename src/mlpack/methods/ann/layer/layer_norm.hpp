@@ -190,9 +190,6 @@ class LayerNorm
 
   //! Locally-stored normalized input.
   OutputDataType normalized;
-
-  //! Locally-stored zero mean input.
-  OutputDataType inputMean;
 }; // class LayerNorm
 
 } // namespace ann
@@ -59,20 +59,37 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  mean = arma::mean(input, 0);
-  variance = arma::var(input, 1, 0);
-
-  // Normalize the input.
-  output = input.each_row() - mean;
-  inputMean = output;
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  // Scale and shift the output.
-  output.each_col() %= gamma;
-  output.each_col() += beta;
+  // Compute the mean and the variance of each point, then normalize, scale
+  // and shift it, while its column is still in cache.  Only the normalized
+  // input is kept for the backward pass.
+  mean.set_size(1, input.n_cols);
+  variance.set_size(1, input.n_cols);
+  normalized.set_size(arma::size(input));
+  output.set_size(arma::size(input));
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const eT* in = input.colptr(i);
+    double columnMean = 0.0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+      columnMean += in[j];
+    columnMean /= input.n_rows;
+
+    double columnM2 = 0.0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+      columnM2 += (in[j] - columnMean) * (in[j] - columnMean);
+
+    mean[i] = columnMean;
+    variance[i] = columnM2 / input.n_rows;
+
+    const double stdInv = 1.0 / std::sqrt(variance[i] + eps);
+    eT* norm = normalized.colptr(i);
+    eT* out = output.colptr(i);
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      norm[j] = (in[j] - columnMean) * stdInv;
+      out[j] = gamma[j] * norm[j] + beta[j];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -80,23 +97,29 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // dl / dxhat.
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / input.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += arma::sum(norm.each_row() % -stdInv, 0) / input.n_rows;
+  g.set_size(arma::size(input));
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const eT* error = gy.colptr(i);
+    const eT* norm = normalized.colptr(i);
+
+    // Sum dl / dxhat and dl / dxhat * xhat, where dl / dxhat = dl / dy * gamma.
+    double sumNorm = 0.0, sumNormXhat = 0.0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      sumNorm += gamma[j] * error[j];
+      sumNormXhat += gamma[j] * error[j] * norm[j];
+    }
+    sumNorm /= input.n_rows;
+    sumNormXhat /= input.n_rows;
+
+    // dl / dx = stdInv * (dl / dxhat - mean(dl / dxhat) -
+    //     xhat * mean(dl / dxhat * xhat)).
+    const double stdInv = 1.0 / std::sqrt(variance[i] + eps);
+    eT* out = g.colptr(i);
+    for (size_t j = 0; j < input.n_rows; ++j)
+      out[j] = stdInv * (gamma[j] * error[j] - sumNorm - norm[j] * sumNormXhat);
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
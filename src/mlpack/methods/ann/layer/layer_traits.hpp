@@ -53,6 +53,13 @@ class LayerTraits
    * This is true if the layer is a connection layer.
    **/
   static const bool IsConnection = false;
+
+  /*
+   * This is true if the layer has Forward() and Gradient() overloads that
+   * take a sparse input (arma::sp_mat), so it can be the first layer of a
+   * network trained on sparse data.
+   **/
+  static const bool SupportsSparseInput = false;
 };
 
 // This gives us a HasGradientCheck<T, U> type (where U is a function pointer)
@@ -88,6 +95,11 @@ HAS_MEM_FUNC(Reset, HasResetCheck);
 // we can use with SFINAE to catch when a type has a ResetCell() function.
 HAS_MEM_FUNC(ResetCell, HasResetCellCheck);
 
+// This gives us a HasTruncateBackwardCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a
+// TruncateBackward() function.
+HAS_MEM_FUNC(TruncateBackward, HasTruncateBackwardCheck);
+
 // This gives us a HasRewardCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Reward() function.
 HAS_MEM_FUNC(Reward, HasRewardCheck);
@@ -108,6 +120,11 @@ HAS_MEM_FUNC(Rho, HasRho);
 // can use with SFINAE to catch when a type has a Loss() function.
 HAS_MEM_FUNC(Loss, HasLoss);
 
+// This gives us a HasForwardBackwardCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when an output layer has a
+// ForwardBackward() function.
+HAS_MEM_FUNC(ForwardBackward, HasForwardBackwardCheck);
+
 // This gives us a HasRunCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Run() function.
 HAS_MEM_FUNC(Run, HasRunCheck);
@@ -120,6 +137,10 @@ HAS_MEM_FUNC(Bias, HasBiasCheck);
 // we can use with SFINAE to catch when a type has a MaxIterations() function.
 HAS_MEM_FUNC(MaxIterations, HasMaxIterations);
 
+// This gives us a HasResetPolicy<T, U> type (where U is a function pointer) we
+// can use with SFINAE to catch when a type has a ResetPolicy() function.
+HAS_MEM_FUNC(ResetPolicy, HasResetPolicy);
+
 } // namespace ann
 } // namespace mlpack
 
@@ -24,6 +24,7 @@
 #include <mlpack/methods/ann/layer/concatenate.hpp>
 #include <mlpack/methods/ann/layer/dropout.hpp>
 #include <mlpack/methods/ann/layer/elu.hpp>
+#include <mlpack/methods/ann/layer/embedding_bag.hpp>
 #include <mlpack/methods/ann/layer/hard_tanh.hpp>
 #include <mlpack/methods/ann/layer/join.hpp>
 #include <mlpack/methods/ann/layer/layer_norm.hpp>
@@ -72,6 +73,8 @@ namespace ann {
 template<typename InputDataType, typename OutputDataType> class BatchNorm;
 template<typename InputDataType, typename OutputDataType> class DropConnect;
 template<typename InputDataType, typename OutputDataType> class Glimpse;
+template<typename InputDataType, typename OutputDataType>
+class GroupedConvolution;
 template<typename InputDataType, typename OutputDataType> class LayerNorm;
 template<typename InputDataType, typename OutputDataType> class LSTM;
 template<typename InputDataType, typename OutputDataType> class GRU;
@@ -90,6 +93,11 @@ template<typename InputDataType,
          typename Activation>
 class RBF;
 
+template<typename ActivationFunction,
+         typename InputDataType,
+         typename OutputDataType>
+class FusedLinear;
+
 template<typename InputDataType,
          typename OutputDataType,
          typename RegularizerType>
@@ -99,6 +107,10 @@ template<typename InputDataType,
          typename OutputDataType>
 class NoisyLinear;
 
+template<typename InputDataType,
+         typename OutputDataType>
+class SparseLinear;
+
 template<typename InputDataType,
          typename OutputDataType,
          typename RegularizerType>
@@ -234,7 +246,13 @@ using MoreTypes = boost::variant<
         VirtualBatchNorm<arma::mat, arma::mat>*,
         RBF<arma::mat, arma::mat, GaussianFunction>*,
         BaseLayer<GaussianFunction, arma::mat, arma::mat>*,
-        PositionalEncoding<arma::mat, arma::mat>*
+        PositionalEncoding<arma::mat, arma::mat>*,
+        FusedLinear<LogisticFunction, arma::mat, arma::mat>*,
+        FusedLinear<TanhFunction, arma::mat, arma::mat>*,
+        FusedLinear<RectifierFunction, arma::mat, arma::mat>*,
+        EmbeddingBag<arma::mat, arma::mat>*,
+        GroupedConvolution<arma::mat, arma::mat>*,
+        SparseLinear<arma::mat, arma::mat>*
 >;
 
 template <typename... CustomLayers>
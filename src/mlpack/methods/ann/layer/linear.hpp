@@ -14,9 +14,11 @@
 #define MLPACK_METHODS_ANN_LAYER_LINEAR_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
 
 #include "layer_types.hpp"
+#include "layer_traits.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -25,6 +27,10 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Linear layer class. The Linear class represents a
  * single layer of a neural network.
  *
+ * The dense passes only use the Armadillo API, so the layer can also hold
+ * matrices of a library with the same API, such as Bandicoot's coot::Mat on
+ * the GPU (see StaticFFN).
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -64,8 +70,19 @@ class Linear
    * @param input Input data used for evaluating the specified function.
    * @param output Resulting output activation.
    */
+  template<typename InputType, typename OutputType>
+  void Forward(const InputType& input, OutputType& output);
+
+  /**
+   * Forward pass for a sparse input, such as one-hot or bag-of-words
+   * features.  The cost is proportional to the number of non-zero elements of
+   * the input, instead of its number of rows.
+   *
+   * @param input Sparse input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
   template<typename eT>
-  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+  void Forward(const arma::SpMat<eT>& input, arma::Mat<eT>& output);
 
   /**
    * Ordinary feed backward pass of a neural network, calculating the function
@@ -76,10 +93,10 @@ class Linear
    * @param gy The backpropagated error.
    * @param g The calculated gradient.
    */
-  template<typename eT>
-  void Backward(const arma::Mat<eT>& /* input */,
-                const arma::Mat<eT>& gy,
-                arma::Mat<eT>& g);
+  template<typename InputType, typename ErrorType, typename OutputType>
+  void Backward(const InputType& /* input */,
+                const ErrorType& gy,
+                OutputType& g);
 
   /*
    * Calculate the gradient using the output delta and the input activation.
@@ -88,8 +105,21 @@ class Linear
    * @param error The calculated error.
    * @param gradient The calculated gradient.
    */
+  template<typename InputType, typename ErrorType, typename GradientType>
+  void Gradient(const InputType& input,
+                const ErrorType& error,
+                GradientType& gradient);
+
+  /**
+   * Calculate the gradient for a sparse input.  Only the columns of the weight
+   * gradient for the non-zero rows of the input are accumulated.
+   *
+   * @param input The sparse input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
   template<typename eT>
-  void Gradient(const arma::Mat<eT>& input,
+  void Gradient(const arma::SpMat<eT>& input,
                 const arma::Mat<eT>& error,
                 arma::Mat<eT>& gradient);
 
@@ -172,6 +202,20 @@ class Linear
   RegularizerType regularizer;
 }; // class Linear
 
+// The Linear layer can take a sparse input.
+template<typename InputDataType, typename OutputDataType,
+         typename RegularizerType>
+class LayerTraits<Linear<InputDataType, OutputDataType, RegularizerType> >
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool SupportsSparseInput = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
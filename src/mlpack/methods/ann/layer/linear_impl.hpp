@@ -45,16 +45,15 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
-  bias = arma::mat(weights.memptr() + weight.n_elem,
-      outSize, 1, false, false);
+  weight = math::MakeAlias(weights, 0, outSize, inSize, false);
+  bias = math::MakeAlias(weights, outSize * inSize, outSize, 1, false);
 }
 
 template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
-template<typename eT>
+template<typename InputType, typename OutputType>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Forward(
-    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+    const InputType& input, OutputType& output)
 {
   output = weight * input;
   output.each_col() += bias;
@@ -63,22 +62,58 @@ void Linear<InputDataType, OutputDataType, RegularizerType>::Forward(
 template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 template<typename eT>
+void Linear<InputDataType, OutputDataType, RegularizerType>::Forward(
+    const arma::SpMat<eT>& input, arma::Mat<eT>& output)
+{
+  // Armadillo only visits the non-zero elements of the input here.
+  output = weight * input;
+  output.each_col() += bias;
+}
+
+template<typename InputDataType, typename OutputDataType,
+    typename RegularizerType>
+template<typename InputType, typename ErrorType, typename OutputType>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Backward(
-    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+    const InputType& /* input */, const ErrorType& gy, OutputType& g)
 {
   g = weight.t() * gy;
 }
 
+template<typename InputDataType, typename OutputDataType,
+    typename RegularizerType>
+template<typename InputType, typename ErrorType, typename GradientType>
+void Linear<InputDataType, OutputDataType, RegularizerType>::Gradient(
+    const InputType& input,
+    const ErrorType& error,
+    GradientType& gradient)
+{
+  // The calls are unqualified, so that they are found in the namespace of the
+  // matrix type (arma or coot).
+  gradient.submat(0, 0, weight.n_elem - 1, 0) = vectorise(error * input.t());
+  gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) = sum(error, 1);
+  regularizer.Evaluate(weights, gradient);
+}
+
 template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 template<typename eT>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Gradient(
-    const arma::Mat<eT>& input,
+    const arma::SpMat<eT>& input,
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
-      error * input.t());
+  arma::Mat<eT> weightGradient(gradient.memptr(), outSize, inSize, false,
+      true);
+  weightGradient.zeros();
+
+  // Each non-zero input (i, j) adds input(i, j) * error.col(j) to the i'th
+  // column of the weight gradient.
+  for (typename arma::SpMat<eT>::const_iterator it = input.begin();
+       it != input.end(); ++it)
+  {
+    weightGradient.col(it.row()) += (*it) * error.col(it.col());
+  }
+
   gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
       arma::sum(error, 1);
   regularizer.Evaluate(weights, gradient);
@@ -60,10 +60,10 @@ class LogSoftMax
    * @param gy The backpropagated error.
    * @param g The calculated gradient.
    */
-  template<typename eT>
-  void Backward(const arma::Mat<eT>& input,
-                const arma::Mat<eT>& gy,
-                arma::Mat<eT>& g);
+  template<typename InputType, typename ErrorType, typename GradientType>
+  void Backward(const InputType& input,
+                const ErrorType& gy,
+                GradientType& g);
 
   //! Get the output parameter.
   OutputDataType& OutputParameter() const { return outputParameter; }
@@ -82,6 +82,20 @@ class LogSoftMax
   void serialize(Archive& /* ar */, const unsigned int /* version */);
 
  private:
+  //! Compute the output with a fast approximation of exp(), element by
+  //! element.
+  template<typename InputType, typename OutputType>
+  static void Forward(const InputType& input,
+                      OutputType& output,
+                      std::true_type /* isArmaType */);
+
+  //! Compute the output with matrix operations only, for matrix types whose
+  //! elements are slow to access one by one (for instance, on the GPU).
+  template<typename InputType, typename OutputType>
+  static void Forward(const InputType& input,
+                      OutputType& output,
+                      std::false_type /* isArmaType */);
+
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -29,7 +29,19 @@ template<typename InputType, typename OutputType>
 void LogSoftMax<InputDataType, OutputDataType>::Forward(
     const InputType& input, OutputType& output)
 {
-  arma::mat maxInput = arma::repmat(arma::max(input), input.n_rows, 1);
+  Forward(input, output, std::integral_constant<bool,
+      arma::is_arma_type<InputType>::value>());
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename OutputType>
+void LogSoftMax<InputDataType, OutputDataType>::Forward(
+    const InputType& input,
+    OutputType& output,
+    std::true_type /* isArmaType */)
+{
+  arma::Mat<typename InputType::elem_type> maxInput = arma::repmat(
+      arma::max(input), input.n_rows, 1);
   output = (maxInput - input);
 
   // Approximation of the base-e exponential function. The acuracy however is
@@ -62,13 +74,26 @@ void LogSoftMax<InputDataType, OutputDataType>::Forward(
 }
 
 template<typename InputDataType, typename OutputDataType>
-template<typename eT>
+template<typename InputType, typename OutputType>
+void LogSoftMax<InputDataType, OutputDataType>::Forward(
+    const InputType& input,
+    OutputType& output,
+    std::false_type /* isArmaType */)
+{
+  // Subtract the maximum of each column before exp() to avoid overflow.
+  const OutputType maxInput = repmat(max(input), input.n_rows, 1);
+  output = input - maxInput;
+  output -= repmat(log(sum(exp(output))), input.n_rows, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename ErrorType, typename GradientType>
 void LogSoftMax<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>& input,
-    const arma::Mat<eT>& gy,
-    arma::Mat<eT>& g)
+    const InputType& input,
+    const ErrorType& gy,
+    GradientType& g)
 {
-  g = arma::exp(input) + gy;
+  g = exp(input) + gy;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -29,6 +29,11 @@ namespace ann /* Artificial Neural Network. */ {
  * The input shape : (sequenceLength, batchSize).
  * The output shape : (embeddingSize, sequenceLength, batchSize).
  *
+ * The input can also be a sparse matrix of shape (vocabSize, batchSize), such
+ * as one-hot or bag-of-words counts; the output is then the sum of the
+ * embeddings of the tokens of each column, weighted by their values, with shape
+ * (embeddingSize, batchSize).
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -59,6 +64,15 @@ class Lookup
   template<typename eT>
   void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
 
+  /**
+   * Forward pass for a sparse input of shape (vocabSize, batchSize).
+   *
+   * @param input Sparse input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::SpMat<eT>& input, arma::Mat<eT>& output);
+
   /**
    * Ordinary feed backward pass of a neural network, calculating the function
    * f(x) by propagating x backwards trough f. Using the results from the feed
@@ -85,6 +99,19 @@ class Lookup
                 const arma::Mat<eT>& error,
                 arma::Mat<eT>& gradient);
 
+  /**
+   * Calculate the gradient for a sparse input.  Only the embeddings of the
+   * tokens that appear in the input are accumulated.
+   *
+   * @param input The sparse input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::SpMat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& gradient);
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -137,6 +164,19 @@ class Lookup
   OutputDataType outputParameter;
 }; // class Lookup
 
+// The Lookup layer can take a sparse input.
+template<typename InputDataType, typename OutputDataType>
+class LayerTraits<Lookup<InputDataType, OutputDataType> >
+{
+ public:
+  static const bool IsBinary = false;
+  static const bool IsOutputLayer = false;
+  static const bool IsBiasLayer = false;
+  static const bool IsLSTMLayer = false;
+  static const bool IsConnection = false;
+  static const bool SupportsSparseInput = true;
+};
+
 // Alias for using as embedding layer.
 template<typename MatType = arma::mat>
 using Embedding = Lookup<MatType, MatType>;
@@ -49,6 +49,14 @@ void Lookup<InputDataType, OutputDataType>::Forward(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void Lookup<InputDataType, OutputDataType>::Forward(
+    const arma::SpMat<eT>& input, arma::Mat<eT>& output)
+{
+  output = weights * input;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void Lookup<InputDataType, OutputDataType>::Backward(
@@ -82,6 +90,23 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void Lookup<InputDataType, OutputDataType>::Gradient(
+    const arma::SpMat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  gradient.set_size(arma::size(weights));
+  gradient.zeros();
+
+  for (typename arma::SpMat<eT>::const_iterator it = input.begin();
+       it != input.end(); ++it)
+  {
+    gradient.col(it.row()) += (*it) * error.col(it.col());
+  }
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void Lookup<InputDataType, OutputDataType>::serialize(
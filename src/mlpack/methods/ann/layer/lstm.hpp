@@ -128,6 +128,13 @@ class LSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Drop the error carried back from the later time steps, so that the next
+   * call to Backward() starts a new truncated BPTT window.  The state of the
+   * cell is kept.
+   */
+  void TruncateBackward();
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -93,6 +93,13 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::TruncateBackward()
+{
+  prevError.zeros();
+  inputCellError.zeros();
+}
+
 template<typename InputDataType, typename OutputDataType>
 void LSTM<InputDataType, OutputDataType>::Reset()
 {
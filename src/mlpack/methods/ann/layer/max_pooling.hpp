@@ -222,6 +222,91 @@ class MaxPooling
     }
   }
 
+  //! Return whether the windows tile the input without overlapping, so that
+  //! the NonOverlapping*() kernels can be used.
+  bool NonOverlapping() const
+  {
+    return floor && strideWidth == kernelWidth &&
+        strideHeight == kernelHeight && kernelWidth * kernelHeight <= 256;
+  }
+
+  /**
+   * Apply pooling to the input when the windows don't overlap.  The columns of
+   * the input are read contiguously, and the position of the maximum in each
+   * window (in column-major order, so that ties are broken like
+   * MaxPoolingRule) is stored in one byte.  KW and KH are the size of the
+   * window if it is known at compile time, or 0.
+   *
+   * @param input The input to be apply the pooling rule.
+   * @param output The pooled result.
+   * @param windowIndices The position of the maximum in each window (unused
+   *     in deterministic mode).
+   */
+  template<size_t KW, size_t KH, typename eT>
+  void NonOverlappingPooling(const arma::Mat<eT>& input,
+                             arma::Mat<eT>& output,
+                             arma::Mat<unsigned char>& windowIndices)
+  {
+    const size_t kw = (KW == 0) ? kernelWidth : KW;
+    const size_t kh = (KH == 0) ? kernelHeight : KH;
+
+    for (size_t j = 0; j < output.n_cols; ++j)
+    {
+      eT* out = output.colptr(j);
+      unsigned char* argmax = deterministic ? NULL : windowIndices.colptr(j);
+
+      for (size_t c = 0; c < kh; ++c)
+      {
+        const eT* in = input.colptr(j * kh + c);
+        for (size_t i = 0; i < output.n_rows; ++i)
+        {
+          const eT* window = in + i * kw;
+          size_t r = 0;
+          if (c == 0)
+          {
+            out[i] = window[0];
+            if (!deterministic)
+              argmax[i] = 0;
+            r = 1;
+          }
+
+          for (; r < kw; ++r)
+          {
+            if (window[r] > out[i])
+            {
+              out[i] = window[r];
+              if (!deterministic)
+                argmax[i] = (unsigned char) (c * kw + r);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Apply unpooling to the error when the windows don't overlap.
+   *
+   * @param error The backward error.
+   * @param output The unpooled result.
+   * @param windowIndices The position of the maximum in each window.
+   */
+  template<typename eT>
+  void NonOverlappingUnpooling(const arma::Mat<eT>& error,
+                               arma::Mat<eT>& output,
+                               const arma::Mat<unsigned char>& windowIndices)
+  {
+    for (size_t j = 0; j < error.n_cols; ++j)
+    {
+      for (size_t i = 0; i < error.n_rows; ++i)
+      {
+        const size_t position = windowIndices(i, j);
+        output(i * kernelWidth + position % kernelWidth,
+            j * kernelHeight + position / kernelWidth) += error(i, j);
+      }
+    }
+  }
+
   //! Locally-stored width of the pooling window.
   size_t kernelWidth;
 
@@ -296,6 +381,10 @@ class MaxPooling
 
   //! Locally-stored pooling indicies.
   std::vector<arma::cube> poolingIndices;
+
+  //! Locally-stored position of the maximum in each window, when the windows
+  //! don't overlap.
+  std::vector<arma::Cube<unsigned char> > windowIndices;
 }; // class MaxPooling
 
 } // namespace ann
@@ -78,36 +78,73 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
-
-  if (!deterministic)
-  {
-    poolingIndices.push_back(outputTemp);
-  }
-
-  if (!reset)
+  if (NonOverlapping())
   {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
+    outputTemp.set_size(outputWidth, outputHeight, batchSize * inSize);
 
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
+    arma::Mat<unsigned char> unused;
+    if (!deterministic)
+    {
+      windowIndices.push_back(arma::Cube<unsigned char>(outputWidth,
+          outputHeight, batchSize * inSize));
+    }
 
-    reset = true;
+    for (size_t s = 0; s < inputTemp.n_slices; s++)
+    {
+      arma::Mat<unsigned char>& sliceIndices = deterministic ? unused :
+          windowIndices.back().slice(s);
+
+      if (kernelWidth == 2 && kernelHeight == 2)
+      {
+        NonOverlappingPooling<2, 2>(inputTemp.slice(s), outputTemp.slice(s),
+            sliceIndices);
+      }
+      else if (kernelWidth == 3 && kernelHeight == 3)
+      {
+        NonOverlappingPooling<3, 3>(inputTemp.slice(s), outputTemp.slice(s),
+            sliceIndices);
+      }
+      else
+      {
+        NonOverlappingPooling<0, 0>(inputTemp.slice(s), outputTemp.slice(s),
+            sliceIndices);
+      }
+    }
   }
-
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
+  else
   {
+    outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
+        batchSize * inSize);
+
     if (!deterministic)
     {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
+      poolingIndices.push_back(outputTemp);
+    }
+
+    if (!reset)
+    {
+      size_t elements = inputWidth * inputHeight;
+      indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
+          elements);
+
+      indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth,
+          inputHeight);
+
+      reset = true;
     }
-    else
+
+    for (size_t s = 0; s < inputTemp.n_slices; s++)
     {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
+      if (!deterministic)
+      {
+        PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
+          poolingIndices.back().slice(s));
+      }
+      else
+      {
+        PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
+            inputTemp.slice(s));
+      }
     }
   }
 
@@ -130,13 +167,26 @@ void MaxPooling<InputDataType, OutputDataType>::Backward(
   gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
       inputTemp.n_cols, inputTemp.n_slices);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  if (NonOverlapping())
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    for (size_t s = 0; s < mappedError.n_slices; s++)
+    {
+      NonOverlappingUnpooling(mappedError.slice(s), gTemp.slice(s),
+          windowIndices.back().slice(s));
+    }
+
+    windowIndices.pop_back();
   }
+  else
+  {
+    for (size_t s = 0; s < mappedError.n_slices; s++)
+    {
+      Unpooling(mappedError.slice(s), gTemp.slice(s),
+          poolingIndices.back().slice(s));
+    }
 
-  poolingIndices.pop_back();
+    poolingIndices.pop_back();
+  }
 
   g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
@@ -203,6 +203,72 @@ class MeanPooling
     }
   }
 
+  //! Return whether the windows tile the input without overlapping, so that
+  //! the NonOverlapping*() kernels can be used.
+  bool NonOverlapping() const
+  {
+    return floor && strideWidth == kernelWidth && strideHeight == kernelHeight;
+  }
+
+  /**
+   * Apply pooling to the input when the windows don't overlap, reading the
+   * columns of the input contiguously.  KW and KH are the size of the window
+   * if it is known at compile time, or 0.
+   *
+   * @param input The input to be apply the pooling rule.
+   * @param output The pooled result (initially zero).
+   */
+  template<size_t KW, size_t KH, typename eT>
+  void NonOverlappingPooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  {
+    const size_t kw = (KW == 0) ? kernelWidth : KW;
+    const size_t kh = (KH == 0) ? kernelHeight : KH;
+
+    for (size_t j = 0; j < output.n_cols; ++j)
+    {
+      eT* out = output.colptr(j);
+      for (size_t c = 0; c < kh; ++c)
+      {
+        const eT* in = input.colptr(j * kh + c);
+        for (size_t i = 0; i < output.n_rows; ++i)
+        {
+          const eT* window = in + i * kw;
+          for (size_t r = 0; r < kw; ++r)
+            out[i] += window[r];
+        }
+      }
+    }
+
+    output *= 1.0 / (kw * kh);
+  }
+
+  /**
+   * Apply unpooling to the error when the windows don't overlap: each element
+   * of a window gets an equal share of the error of the window.
+   *
+   * @param error The backward error.
+   * @param output The unpooled result.
+   */
+  template<typename eT>
+  void NonOverlappingUnpooling(const arma::Mat<eT>& error,
+                               arma::Mat<eT>& output)
+  {
+    const eT scale = 1.0 / (kernelWidth * kernelHeight);
+    for (size_t j = 0; j < error.n_cols; ++j)
+    {
+      for (size_t c = 0; c < kernelHeight; ++c)
+      {
+        eT* out = output.colptr(j * kernelHeight + c);
+        for (size_t i = 0; i < error.n_rows; ++i)
+        {
+          const eT share = scale * error(i, j);
+          for (size_t r = 0; r < kernelWidth; ++r)
+            out[i * kernelWidth + r] = share;
+        }
+      }
+    }
+  }
+
   //! Locally-stored width of the pooling window.
   size_t kernelWidth;
 
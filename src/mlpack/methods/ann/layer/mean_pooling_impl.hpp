@@ -83,8 +83,23 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
   outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
       batchSize * inSize);
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
+  if (NonOverlapping())
+  {
+    for (size_t s = 0; s < inputTemp.n_slices; s++)
+    {
+      if (kernelWidth == 2 && kernelHeight == 2)
+        NonOverlappingPooling<2, 2>(inputTemp.slice(s), outputTemp.slice(s));
+      else if (kernelWidth == 3 && kernelHeight == 3)
+        NonOverlappingPooling<3, 3>(inputTemp.slice(s), outputTemp.slice(s));
+      else
+        NonOverlappingPooling<0, 0>(inputTemp.slice(s), outputTemp.slice(s));
+    }
+  }
+  else
+  {
+    for (size_t s = 0; s < inputTemp.n_slices; s++)
+      Pooling(inputTemp.slice(s), outputTemp.slice(s));
+  }
 
   output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
       batchSize);
@@ -109,7 +124,10 @@ void MeanPooling<InputDataType, OutputDataType>::Backward(
 
   for (size_t s = 0; s < mappedError.n_slices; s++)
   {
-    Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
+    if (NonOverlapping())
+      NonOverlappingUnpooling(mappedError.slice(s), gTemp.slice(s));
+    else
+      Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
   }
 
   g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
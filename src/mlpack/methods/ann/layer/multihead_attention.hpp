@@ -48,6 +48,18 @@ namespace ann /** Artificial Neural Network. */ {
  * of shape `(embedDim * tgtSeqLen, batchSize)`. The embeddings are stored
  * consequently.
  *
+ * In deterministic mode (i.e. for inference) the attention is computed block
+ * by block over the source sequence with a streaming softmax, so the
+ * (tgtSeqLen, srcSeqLen) matrix of scores of a head is never stored; only
+ * (tgtSeqLen, BlockSize()) scores are held at once.
+ *
+ * For incremental decoding, UseCache() makes the layer keep the projected keys
+ * and values of all the previous calls to Forward(), so that each call only
+ * has to project the new source positions: the query of each call attends to
+ * the cached positions and to its own srcSeqLen new positions.  The masks are
+ * not applied when the cache is used (the cache itself only holds the past),
+ * and Backward() and Gradient() can't be used.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -156,6 +168,34 @@ class MultiheadAttention
   //! Modify the Key Padding Mask.
   OutputDataType& KeyPaddingMask() { return keyPaddingMask; }
 
+  //! Get the value of the deterministic parameter.
+  bool Deterministic() const { return deterministic; }
+  //! Modify the value of the deterministic parameter.
+  bool& Deterministic() { return deterministic; }
+
+  //! Get the number of source positions of each block of the streaming
+  //! attention.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of source positions of each block of the streaming
+  //! attention.
+  size_t& BlockSize() { return blockSize; }
+
+  //! Get whether the keys and values of previous calls are cached.
+  bool UseCache() const { return useCache; }
+  //! Modify whether the keys and values of previous calls are cached.
+  bool& UseCache() { return useCache; }
+
+  //! Get the number of source positions held in the cache.
+  size_t CacheSize() const { return cacheSize; }
+
+  //! Empty the cache of keys and values, to start a new sequence.
+  void ResetCache()
+  {
+    keyCache.reset();
+    valueCache.reset();
+    cacheSize = 0;
+  }
+
   //! Get the output parameter.
   OutputDataType const& OutputParameter() const { return outputParameter; }
   //! Modify the output parameter.
@@ -180,6 +220,32 @@ class MultiheadAttention
   //! Element Type of the input.
   typedef typename OutputDataType::elem_type ElemType;
 
+  /**
+   * Compute the attention output of one head with a streaming softmax over
+   * blocks of the source positions: the maximum and the sum of the
+   * exponentials of the scores of each target position are updated block by
+   * block, and the partial output is rescaled whenever the maximum changes.
+   *
+   * @param query The projected query, of shape (tgtSeqLen, headDim).
+   * @param key The projected keys, of shape (headDim, length).
+   * @param value The projected values, of shape (headDim, length).
+   * @param mask Whether to apply the attention and key padding masks.
+   * @param output The attention output, of shape (tgtSeqLen, headDim).
+   */
+  void StreamingAttention(const arma::Mat<ElemType>& query,
+                          const arma::Mat<ElemType>& key,
+                          const arma::Mat<ElemType>& value,
+                          const bool mask,
+                          arma::Mat<ElemType>& output);
+
+  //! Normalize each row of the given scores with the softmax function.
+  static void RowSoftmax(arma::Mat<ElemType>& scores);
+
+  //! Backpropagate the given error through RowSoftmax(), in place, given its
+  //! output.
+  static void RowSoftmaxBackward(const arma::Mat<ElemType>& output,
+                                 arma::Mat<ElemType>& error);
+
   //! Target sequence length.
   size_t tgtSeqLen;
 
@@ -243,8 +309,25 @@ class MultiheadAttention
   //! Locally-stored attention output weight to be fed to last linear layer.
   arma::Cube<ElemType> attnOut;
 
-  //! Softmax layer to represent the probabilities of next sequence.
-  Softmax<InputDataType, OutputDataType> softmax;
+  //! Locally-stored projected keys of the previous calls, of shape
+  //! (headDim, capacity, numHeads * batchSize).
+  arma::Cube<ElemType> keyCache;
+
+  //! Locally-stored projected values of the previous calls, of shape
+  //! (headDim, capacity, numHeads * batchSize).
+  arma::Cube<ElemType> valueCache;
+
+  //! Number of source positions held in the cache.
+  size_t cacheSize;
+
+  //! If true the keys and values of the previous calls are cached.
+  bool useCache;
+
+  //! If true the streaming attention is used.
+  bool deterministic;
+
+  //! Number of source positions of each block of the streaming attention.
+  size_t blockSize;
 
   //! Locally-stored delta object.
   OutputDataType delta;
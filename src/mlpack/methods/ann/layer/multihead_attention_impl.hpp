@@ -29,7 +29,11 @@ MultiheadAttention() :
     srcSeqLen(0),
     embedDim(0),
     numHeads(0),
-    headDim(0)
+    headDim(0),
+    cacheSize(0),
+    useCache(false),
+    deterministic(false),
+    blockSize(64)
 {
   // Nothing to do here.
 }
@@ -45,7 +49,11 @@ MultiheadAttention(
     tgtSeqLen(tgtSeqLen),
     srcSeqLen(srcSeqLen),
     embedDim(embedDim),
-    numHeads(numHeads)
+    numHeads(numHeads),
+    cacheSize(0),
+    useCache(false),
+    deterministic(false),
+    blockSize(64)
 {
   if (embedDim % numHeads != 0)
   {
@@ -95,6 +103,18 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
     Log::Fatal << "Incorrect input dimensions!" << std::endl;
   }
 
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
+  }
+
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
+  }
+
   const size_t batchSize = input.n_cols;
 
   // shape of output : (embedDim * tgtSeqLen, batchSize).
@@ -139,43 +159,95 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   kProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
   vProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
 
-  // Calculate the scores i.e. perform the matrix multiplication operation
-  // on qProj and kProj. Here score = qProj . kProj'
-  scores = math::MultiplyCube2Cube(qProj, kProj, false, true);
-
-  // Apply the attention mask if provided. The attention mask is used to black-
-  // out future sequences and generally used in Encoder-Decoder attention.
-  // The attention mask has elements 0 or -infinity.
-  // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
-  if (!attnMask.is_empty())
-  {
-    if (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen)
-      Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
-    scores.each_slice() += attnMask;
-  }
-
-  // Apply the key padding mask when provided. It blacks-out any particular
-  // word in the sequence.
-  // The key padding mask has elements 0 or -infinity.
-  // The shape of keyPaddingMask : (1, srcSeqLen).
-  if (!keyPaddingMask.is_empty())
+  if (deterministic || useCache)
   {
-    if (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen)
-        Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
-    scores.each_slice() += arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+    if (blockSize == 0)
+      Log::Fatal << "The block size must be greater than 0." << std::endl;
+
+    if (useCache)
+    {
+      // Start a new cache if the batch size has changed.
+      if (keyCache.n_slices != numHeads * batchSize)
+      {
+        keyCache.set_size(headDim, srcSeqLen, numHeads * batchSize);
+        valueCache.set_size(headDim, srcSeqLen, numHeads * batchSize);
+        cacheSize = 0;
+      }
+
+      // Double the capacity of the cache when it is full, so that appending is
+      // amortized constant time.
+      if (cacheSize + srcSeqLen > keyCache.n_cols)
+      {
+        const size_t capacity = std::max(2 * (size_t) keyCache.n_cols,
+            cacheSize + srcSeqLen);
+        keyCache.resize(headDim, capacity, numHeads * batchSize);
+        valueCache.resize(headDim, capacity, numHeads * batchSize);
+      }
+
+      for (size_t i = 0; i < numHeads * batchSize; ++i)
+      {
+        keyCache.slice(i).cols(cacheSize, cacheSize + srcSeqLen - 1) =
+            arma::trans(kProj.slice(i));
+        valueCache.slice(i).cols(cacheSize, cacheSize + srcSeqLen - 1) =
+            arma::trans(vProj.slice(i));
+      }
+      cacheSize += srcSeqLen;
+    }
+
+    // Compute the attention output of each head without storing the scores.
+    // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
+    attnOut.set_size(tgtSeqLen, headDim, numHeads * batchSize);
+    for (size_t i = 0; i < numHeads * batchSize; ++i)
+    {
+      arma::Mat<ElemType> headOut(attnOut.slice_memptr(i), tgtSeqLen, headDim,
+          false, true);
+      if (useCache)
+      {
+        StreamingAttention(qProj.slice(i),
+            arma::Mat<ElemType>(keyCache.slice_memptr(i), headDim, cacheSize,
+            false, true),
+            arma::Mat<ElemType>(valueCache.slice_memptr(i), headDim, cacheSize,
+            false, true), false, headOut);
+      }
+      else
+      {
+        StreamingAttention(qProj.slice(i),
+            arma::Mat<ElemType>(arma::trans(kProj.slice(i))),
+            arma::Mat<ElemType>(arma::trans(vProj.slice(i))), true, headOut);
+      }
+    }
   }
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  else
   {
-    softmax.Forward(scores.slice(i), softmax.OutputParameter());
-    scores.slice(i) = softmax.OutputParameter();
+    // Calculate the scores i.e. perform the matrix multiplication operation
+    // on qProj and kProj. Here score = qProj . kProj'
+    scores = math::MultiplyCube2Cube(qProj, kProj, false, true);
+
+    // Apply the attention mask if provided. The attention mask is used to
+    // black-out future sequences and generally used in Encoder-Decoder
+    // attention. The attention mask has elements 0 or -infinity.
+    // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
+    if (!attnMask.is_empty())
+      scores.each_slice() += attnMask;
+
+    // Apply the key padding mask when provided. It blacks-out any particular
+    // word in the sequence.
+    // The key padding mask has elements 0 or -infinity.
+    // The shape of keyPaddingMask : (1, srcSeqLen).
+    if (!keyPaddingMask.is_empty())
+      scores.each_slice() += arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+
+    // Each target position attends to the source positions, so the scores
+    // are normalized over each row.
+    for (size_t i = 0; i < numHeads * batchSize; ++i)
+      RowSoftmax(scores.slice(i));
+
+    // Calculate the attention output i.e. matrix multiplication of softmax
+    // output and vProj.
+    // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
+    attnOut = math::MultiplyCube2Cube(scores, vProj, false, false);
   }
 
-  // Calculate the attention output i.e. matrix multiplication of softmax
-  // output and vProj.
-  // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
-  attnOut = math::MultiplyCube2Cube(scores, vProj, false, false);
-
   // Now we will concatenate output of all the heads i.e. we will reshape
   // attnOut to (tgtSeqLen, embedDim, batchSize).
   attnOut.reshape(tgtSeqLen, embedDim, batchSize);
@@ -246,7 +318,7 @@ Backward(const arma::Mat<eT>& /* input */,
   for (size_t i = 0; i < numHeads * batchSize; ++i)
   {
     // We will perform backpropagation of softmax over each slice of gyTemp.
-    softmax.Backward(scores.slice(i), gyTemp.slice(i), gyTemp.slice(i));
+    RowSoftmaxBackward(scores.slice(i), gyTemp.slice(i));
   }
 
   // Obtain backpropagated error of key.
@@ -377,7 +449,7 @@ Gradient(const arma::Mat<eT>& input,
     // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
     // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
     // The new shape of errorTemp remain same.
-    softmax.Backward(scores.slice(i), errorTemp.slice(i), errorTemp.slice(i));
+    RowSoftmaxBackward(scores.slice(i), errorTemp.slice(i));
   }
 
   // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
@@ -430,6 +502,73 @@ Gradient(const arma::Mat<eT>& input,
   regularizer.Evaluate(weights, gradient);
 }
 
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+StreamingAttention(const arma::Mat<ElemType>& query,
+                   const arma::Mat<ElemType>& key,
+                   const arma::Mat<ElemType>& value,
+                   const bool mask,
+                   arma::Mat<ElemType>& output)
+{
+  arma::Col<ElemType> rowMax(query.n_rows);
+  rowMax.fill(std::numeric_limits<ElemType>::lowest());
+  arma::Col<ElemType> rowSum(query.n_rows, arma::fill::zeros);
+  output.zeros();
+
+  arma::Mat<ElemType> block;
+  for (size_t begin = 0; begin < key.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) key.n_cols) - 1;
+
+    // The shape of block : (tgtSeqLen, end - begin + 1).
+    block = query * key.cols(begin, end);
+    if (mask && !attnMask.is_empty())
+      block += attnMask.cols(begin, end);
+    if (mask && !keyPaddingMask.is_empty())
+      block.each_row() += keyPaddingMask.cols(begin, end);
+
+    // Rescale what has been accumulated so far to the new maximum of each row.
+    const arma::Col<ElemType> newMax = arma::max(rowMax,
+        arma::Col<ElemType>(arma::max(block, 1)));
+    const arma::Col<ElemType> scale = arma::exp(rowMax - newMax);
+
+    block.each_col() -= newMax;
+    block = arma::exp(block);
+
+    rowSum = rowSum % scale + arma::sum(block, 1);
+    output.each_col() %= scale;
+    output += block * arma::trans(value.cols(begin, end));
+    rowMax = newMax;
+  }
+
+  output.each_col() /= rowSum;
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+RowSoftmax(arma::Mat<ElemType>& scores)
+{
+  const arma::Col<ElemType> rowMax = arma::max(scores, 1);
+  scores.each_col() -= rowMax;
+  scores = arma::exp(scores);
+
+  const arma::Col<ElemType> rowSum = arma::sum(scores, 1);
+  scores.each_col() /= rowSum;
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+RowSoftmaxBackward(const arma::Mat<ElemType>& output,
+                   arma::Mat<ElemType>& error)
+{
+  const arma::Col<ElemType> dot = arma::sum(error % output, 1);
+  error.each_col() -= dot;
+  error %= output;
+}
+
 template <typename InputDataType, typename OutputDataType,
           typename RegularizerType>
 template <typename Archive>
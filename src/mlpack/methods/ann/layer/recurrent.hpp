@@ -108,6 +108,12 @@ class Recurrent
                 const arma::Mat<eT>& error,
                 arma::Mat<eT>& /* gradient */);
 
+  /*
+   * Drop the error carried back from the later time steps, so that the next
+   * call to Backward() starts a new truncated BPTT window.
+   */
+  void TruncateBackward();
+
   //! Get the model modules.
   std::vector<LayerTypes<CustomLayers...> >& Model() { return network; }
 
@@ -252,6 +252,17 @@ void Recurrent<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   }
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+void Recurrent<InputDataType, OutputDataType,
+               CustomLayers...>::TruncateBackward()
+{
+  if (!recurrentError.is_empty())
+  {
+    recurrentError.zeros();
+  }
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename Archive>
@@ -0,0 +1,152 @@
+/**
+ * @file methods/ann/layer/sparse_linear.hpp
+ *
+ * Definition of the SparseLinear layer class, a Linear layer whose weights are
+ * mostly zero (after pruning) and are stored in a sparse format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SPARSE_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_SPARSE_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the SparseLinear layer class.  The layer computes Wx + b,
+ * like a Linear layer, but only the non-zero weights are stored, in compressed
+ * sparse row format (that is, the transpose of the weight matrix is stored as
+ * an arma::sp_mat), so that each output unit is a sparse dot product of a
+ * contiguous row of the weights with the input.  The outputs are computed in
+ * parallel over the points of the batch (or over the output units for a
+ * single point).
+ *
+ * The layer is usually created by FFN::Sparsify() from a Linear layer whose
+ * weights were pruned with FFN::Prune() (see MagnitudePruning).  Its weights
+ * are fixed: they are not part of the parameters of the network, and only the
+ * error is backpropagated through the layer.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SparseLinear
+{
+ public:
+  //! Create the SparseLinear object.
+  SparseLinear();
+
+  /**
+   * Create the SparseLinear layer object with the given weights and bias (of a
+   * Linear layer).  The weights that are zero are not stored.
+   *
+   * @param weight The weights of the layer (outSize x inSize).
+   * @param bias The bias of the layer (outSize x 1).
+   */
+  SparseLinear(const arma::mat& weight, const arma::mat& bias);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input size.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the output size.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the transpose of the weights of the layer (inSize x outSize).
+  const arma::sp_mat& TransposedWeight() const { return transposedWeight; }
+
+  //! Get the bias of the layer.
+  OutputDataType const& Bias() const { return bias; }
+
+  //! Get the number of non-zero weights of the layer.
+  size_t NonZeros() const { return transposedWeight.n_nonzero; }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Compute the output unit of the given row of the weights for the given
+  //! input point.
+  template<typename eT>
+  eT RowProduct(const size_t row, const eT* input) const;
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! The transpose of the weights, whose columns are the rows of the weights.
+  arma::sp_mat transposedWeight;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SparseLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_linear_impl.hpp"
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file methods/ann/layer/sparse_linear_impl.hpp
+ *
+ * Implementation of the SparseLinear layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SPARSE_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_SPARSE_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "sparse_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SparseLinear<InputDataType, OutputDataType>::SparseLinear() :
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+SparseLinear<InputDataType, OutputDataType>::SparseLinear(
+    const arma::mat& weight,
+    const arma::mat& bias) :
+    inSize(weight.n_cols),
+    outSize(weight.n_rows),
+    transposedWeight(weight.t()),
+    bias(bias)
+{
+  if (bias.n_elem != outSize)
+  {
+    throw std::invalid_argument("SparseLinear: the bias must have one element "
+        "for each row of the weights");
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+eT SparseLinear<InputDataType, OutputDataType>::RowProduct(
+    const size_t row,
+    const eT* input) const
+{
+  const arma::uword* rowIndices = transposedWeight.row_indices;
+  const double* values = transposedWeight.values;
+
+  eT sum = bias[row];
+  for (size_t k = transposedWeight.col_ptrs[row];
+       k < transposedWeight.col_ptrs[row + 1]; ++k)
+  {
+    sum += values[k] * input[rowIndices[k]];
+  }
+
+  return sum;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SparseLinear<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  output.set_size(outSize, input.n_cols);
+
+  if (input.n_cols == 1)
+  {
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) outSize; ++j)
+      output[j] = RowProduct((size_t) j, input.memptr());
+  }
+  else
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      const eT* inputPtr = input.colptr(i);
+      eT* outputPtr = output.colptr(i);
+      for (size_t j = 0; j < outSize; ++j)
+        outputPtr[j] = RowProduct(j, inputPtr);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SparseLinear<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  g = transposedWeight * gy;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SparseLinear<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(transposedWeight);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
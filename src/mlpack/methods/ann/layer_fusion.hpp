@@ -0,0 +1,88 @@
+/**
+ * @file methods/ann/layer_fusion.hpp
+ *
+ * Definition of the LayerFusion class, which merges layers of a trained feed
+ * forward network for faster inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSION_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/reset_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * This class merges consecutive layers of a network into single layers that
+ * compute the same function in deterministic mode, so that the output of the
+ * network takes fewer passes over memory to compute.  Two fusions are made:
+ *
+ *  - A BatchNorm layer that follows a Linear or a Convolution layer is folded
+ *    into the weights and the bias of that layer: its running statistics and
+ *    its scale and shift are per output unit (or per output map) affine
+ *    transformations, which can be applied to the weights instead of the
+ *    output.
+ *  - A Linear layer followed by a SigmoidLayer, a TanHLayer or a ReLULayer
+ *    (possibly after folding a BatchNorm layer) is replaced by a FusedLinear
+ *    layer, which applies the activation function while adding the bias.
+ *
+ * The weights of the fused network are moved into a new parameter matrix.
+ * Since the BatchNorm layers are folded using their running statistics, the
+ * fused network should only be used for inference (or fine-tuned without the
+ * batch normalization).  Layers that hold other layers are not looked into.
+ */
+template<typename... CustomLayers>
+class LayerFusion
+{
+ public:
+  /**
+   * Fuse the layers of the given network, and store the weights of the
+   * resulting network in the given parameter.
+   *
+   * @param network The layers of the network; the fused layers are deleted.
+   * @param parameter The weights of the network, aliased by the layers.
+   */
+  static void Fuse(std::vector<LayerTypes<CustomLayers...> >& network,
+                   arma::mat& parameter);
+
+ private:
+  //! Fold the given BatchNorm layer into the given Linear layer.  Returns
+  //! false if the size of the BatchNorm layer doesn't match.
+  static bool FoldBatchNorm(Linear<>& layer, const BatchNorm<>& batchNorm);
+
+  //! Fold the given BatchNorm layer into the given Convolution layer.  Returns
+  //! false if the size of the BatchNorm layer doesn't match.
+  static bool FoldBatchNorm(Convolution<>& layer, const BatchNorm<>& batchNorm);
+
+  //! Compute the scale and the shift that the given BatchNorm layer applies to
+  //! each of its units in deterministic mode.
+  static void BatchNormTransform(const BatchNorm<>& batchNorm,
+                                 arma::vec& scale,
+                                 arma::vec& shift);
+
+  //! Replace the given Linear layer and the given layer by a FusedLinear
+  //! layer, if the given layer is an activation that can be fused.  Returns
+  //! false otherwise.
+  static bool FuseActivation(LayerTypes<CustomLayers...>& layer,
+                             const LayerTypes<CustomLayers...>& activation);
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_fusion_impl.hpp"
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file methods/ann/layer_fusion_impl.hpp
+ *
+ * Implementation of the LayerFusion class, which merges layers of a trained
+ * feed forward network for faster inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_fusion.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename... CustomLayers>
+void LayerFusion<CustomLayers...>::Fuse(
+    std::vector<LayerTypes<CustomLayers...> >& network,
+    arma::mat& parameter)
+{
+  // The offset of the weights of each layer in the parameter.
+  WeightSizeVisitor weightSizeVisitor;
+  std::vector<size_t> offsets(network.size(), 0);
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    offsets[i] = offsets[i - 1] + boost::apply_visitor(weightSizeVisitor,
+        network[i - 1]);
+  }
+
+  // The weights of the folded layers are updated in place, so the weights of
+  // each layer of the fused network are still a block of the parameter; it
+  // only has to be found which block.
+  std::vector<LayerTypes<CustomLayers...> > fusedNetwork;
+  std::vector<size_t> fusedOffsets;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    fusedOffsets.push_back(offsets[i]);
+    LayerTypes<CustomLayers...> layer = network[i];
+
+    if (i + 1 < network.size())
+    {
+      BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i + 1]);
+      Linear<>** linear = boost::get<Linear<>*>(&layer);
+      Convolution<>** convolution = boost::get<Convolution<>*>(&layer);
+      if (batchNorm && ((linear && FoldBatchNorm(**linear, **batchNorm)) ||
+          (convolution && FoldBatchNorm(**convolution, **batchNorm))))
+      {
+        delete *batchNorm;
+        ++i;
+      }
+    }
+
+    if (i + 1 < network.size() && FuseActivation(layer, network[i + 1]))
+      ++i;
+
+    fusedNetwork.push_back(layer);
+  }
+
+  arma::mat fusedParameter;
+  for (size_t i = 0; i < fusedNetwork.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor,
+        fusedNetwork[i]);
+    if (weights > 0)
+    {
+      fusedParameter = arma::join_cols(fusedParameter,
+          parameter.rows(fusedOffsets[i], fusedOffsets[i] + weights - 1));
+    }
+  }
+
+  // Some layers (like BatchNorm) initialize their weights when they are reset,
+  // so the weights are only copied in after.
+  network = std::move(fusedNetwork);
+  parameter.set_size(fusedParameter.n_elem, 1);
+  ResetVisitor resetVisitor;
+  for (size_t i = 0, offset = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(parameter, offset),
+        network[i]);
+
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+  parameter = fusedParameter;
+}
+
+template<typename... CustomLayers>
+bool LayerFusion<CustomLayers...>::FoldBatchNorm(Linear<>& layer,
+                                                 const BatchNorm<>& batchNorm)
+{
+  if (batchNorm.InputSize() != layer.OutputSize())
+    return false;
+
+  arma::vec scale, shift;
+  BatchNormTransform(batchNorm, scale, shift);
+
+  layer.Weight().each_col() %= scale;
+  layer.Bias() = layer.Bias() % scale + shift;
+  return true;
+}
+
+template<typename... CustomLayers>
+bool LayerFusion<CustomLayers...>::FoldBatchNorm(Convolution<>& layer,
+                                                 const BatchNorm<>& batchNorm)
+{
+  if (batchNorm.InputSize() != layer.OutputSize())
+    return false;
+
+  arma::vec scale, shift;
+  BatchNormTransform(batchNorm, scale, shift);
+
+  // The filters of output map o are the slices o * inSize to
+  // (o + 1) * inSize - 1.
+  const size_t inSize = layer.InputSize();
+  for (size_t o = 0; o < layer.OutputSize(); ++o)
+    layer.Weight().slices(o * inSize, (o + 1) * inSize - 1) *= scale[o];
+
+  layer.Bias() = layer.Bias() % scale + shift;
+  return true;
+}
+
+template<typename... CustomLayers>
+void LayerFusion<CustomLayers...>::BatchNormTransform(
+    const BatchNorm<>& batchNorm,
+    arma::vec& scale,
+    arma::vec& shift)
+{
+  // The weights of the layer hold gamma, then beta.
+  const size_t size = batchNorm.InputSize();
+  const arma::mat& weights = batchNorm.Parameters();
+
+  // gamma * (x - mean) / sqrt(variance + eps) + beta = scale * x + shift.
+  scale = weights.rows(0, size - 1) / arma::sqrt(batchNorm.TrainingVariance() +
+      batchNorm.Epsilon());
+  shift = weights.rows(size, 2 * size - 1) - scale %
+      batchNorm.TrainingMean();
+}
+
+template<typename... CustomLayers>
+bool LayerFusion<CustomLayers...>::FuseActivation(
+    LayerTypes<CustomLayers...>& layer,
+    const LayerTypes<CustomLayers...>& activation)
+{
+  if (!boost::get<Linear<>*>(&layer))
+    return false;
+
+  Linear<>* linear = boost::get<Linear<>*>(layer);
+  const size_t inSize = linear->InputSize();
+  const size_t outSize = linear->OutputSize();
+  if (boost::get<SigmoidLayer<>*>(&activation))
+  {
+    delete boost::get<SigmoidLayer<>*>(activation);
+    layer = new FusedLinear<LogisticFunction>(inSize, outSize);
+  }
+  else if (boost::get<TanHLayer<>*>(&activation))
+  {
+    delete boost::get<TanHLayer<>*>(activation);
+    layer = new FusedLinear<TanhFunction>(inSize, outSize);
+  }
+  else if (boost::get<ReLULayer<>*>(&activation))
+  {
+    delete boost::get<ReLULayer<>*>(activation);
+    layer = new FusedLinear<RectifierFunction>(inSize, outSize);
+  }
+  else
+  {
+    return false;
+  }
+
+  delete linear;
+  return true;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
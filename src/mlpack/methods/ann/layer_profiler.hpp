@@ -0,0 +1,260 @@
+/**
+ * @file methods/ann/layer_profiler.hpp
+ *
+ * Definition of the LayerProfiler class, which records the time spent in each
+ * layer of a network, and of the ProfilerReport callback, which prints it
+ * during training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+#define MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/timers.hpp>
+
+#include <array>
+#include <chrono>
+
+#include "visitor/delta_visitor.hpp"
+#include "visitor/output_parameter_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The LayerProfiler records, for each layer of an FFN or an RNN and for each of
+ * the forward, backward and gradient passes, the number of calls, the wall time
+ * spent in the layer, an estimate of the number of floating point operations,
+ * and the number of bytes of the matrices that the layer writes.  It is
+ * disabled by default; once enabled with Enabled(), the network reports every
+ * pass of every layer to it.
+ *
+ * The operation count is an estimate: a layer with weights is counted as a
+ * dense product with them (two operations per weight and per point), and a
+ * layer without weights as one operation per element of its output (or its
+ * delta).  The bytes are those of the output (forward), the delta (backward),
+ * and the gradient of the weights (gradient) of the layer.
+ *
+ * Each pass of each layer is also timed with the mlpack Timer, under the name
+ * "<name>_layer<i>_<pass>" (for instance "ffn_layer2_forward"), so it appears
+ * with the other timers when timing is enabled (see Timer::EnableTiming()).
+ *
+ * @code
+ * FFN<> model;
+ * // ... add layers ...
+ * model.Profiler().Enabled() = true;
+ * model.Train(x, y, optimizer, ProfilerReport(model.Profiler()));
+ * std::cout << model.Profiler().Report();
+ * @endcode
+ *
+ * The networks used by the threads of FFN::Parallel() are not profiled.
+ */
+class LayerProfiler
+{
+ public:
+  //! The passes of a layer that are profiled.
+  enum Pass
+  {
+    FORWARD = 0,
+    BACKWARD = 1,
+    GRADIENT = 2
+  };
+
+  //! The statistics of one pass of one layer.
+  struct Record
+  {
+    Record() : calls(0), time(0), flops(0), bytes(0) { }
+
+    //! The number of calls.
+    size_t calls;
+    //! The total wall time of the calls.
+    std::chrono::nanoseconds time;
+    //! The estimated number of floating point operations of the calls.
+    double flops;
+    //! The bytes of the matrices written by the calls.
+    double bytes;
+  };
+
+  /**
+   * Create the profiler.
+   *
+   * @param name Prefix of the names of the timers.
+   * @param enabled Whether to record the passes of the layers.
+   */
+  LayerProfiler(const std::string& name = "ffn", const bool enabled = false) :
+      name(name),
+      enabled(enabled)
+  {
+    /* Nothing to do here. */
+  }
+
+  /**
+   * Start timing the given pass of the given layer.  This does nothing if the
+   * profiler is disabled.
+   *
+   * @param layer Index of the layer in the network.
+   * @param pass The pass of the layer.
+   */
+  void Start(const size_t layer, const Pass pass)
+  {
+    if (!enabled)
+      return;
+
+    StartTimer(layer, pass);
+  }
+
+  /**
+   * Stop timing the given pass of the given layer, and record it.  This does
+   * nothing if the profiler is disabled.
+   *
+   * @param layer Index of the layer in the network.
+   * @param pass The pass of the layer.
+   * @param layerType The layer, used to estimate the operations and the bytes.
+   */
+  template<typename LayerType>
+  void Stop(const size_t layer, const Pass pass, LayerType& layerType)
+  {
+    if (!enabled)
+      return;
+
+    StopTimer(layer, pass, layerType);
+  }
+
+  //! Get the statistics of the given pass of the given layer.
+  const Record& Get(const size_t layer, const Pass pass) const;
+
+  //! Get the number of layers that have been recorded.
+  size_t NumLayers() const { return records.size(); }
+
+  //! Forget the recorded statistics.
+  void Reset() { records.clear(); }
+
+  /**
+   * Return a table of the recorded statistics of each layer, with the share of
+   * the total time taken by each pass.
+   */
+  std::string Report() const;
+
+  //! Get whether the passes of the layers are recorded.
+  bool Enabled() const { return enabled; }
+  //! Modify whether the passes of the layers are recorded.
+  bool& Enabled() { return enabled; }
+
+  //! Get the prefix of the names of the timers.
+  const std::string& Name() const { return name; }
+
+ private:
+  //! Start the timer of the given pass of the given layer.
+  void StartTimer(const size_t layer, const Pass pass);
+
+  //! Stop the timer of the given pass of the given layer and record it.
+  template<typename LayerType>
+  void StopTimer(const size_t layer, const Pass pass, LayerType& layerType);
+
+  //! Make sure that there are records for the given layer.
+  void Grow(const size_t layer);
+
+  //! The prefix of the names of the timers.
+  std::string name;
+
+  //! Whether the passes of the layers are recorded.
+  bool enabled;
+
+  //! The statistics of each pass of each layer.
+  std::vector<std::array<Record, 3> > records;
+
+  //! The names of the timers of each pass of each layer.
+  std::vector<std::array<std::string, 3> > timerNames;
+
+  //! The start of the pass being timed.
+  std::chrono::high_resolution_clock::time_point start;
+};
+
+/**
+ * An ensmallen callback that prints the report of a LayerProfiler at the end of
+ * the optimization, and optionally every given number of epochs.
+ *
+ * @code
+ * model.Profiler().Enabled() = true;
+ * model.Train(x, y, optimizer, ProfilerReport(model.Profiler(), std::cout, 1));
+ * @endcode
+ */
+class ProfilerReport
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param profiler The profiler to report.
+   * @param output Stream to print the report to.
+   * @param epochs Print the report every this many epochs (0 to only print it
+   *     at the end of the optimization).
+   */
+  ProfilerReport(const LayerProfiler& profiler,
+                 std::ostream& output = std::cout,
+                 const size_t epochs = 0) :
+      profiler(profiler),
+      output(output),
+      epochs(epochs)
+  {
+    /* Nothing to do here. */
+  }
+
+  /**
+   * Print the report every epochs epochs.
+   *
+   * @param * (optimizer) The optimizer used to update the function.
+   * @param * (function) Function to optimize.
+   * @param * (coordinates) The current function parameters.
+   * @param epoch The index of the current epoch.
+   * @param * (objective) Objective value of the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t epoch,
+                const double /* objective */)
+  {
+    if (epochs != 0 && epoch % epochs == 0)
+      output << "Epoch " << epoch << ":" << std::endl << profiler.Report();
+
+    return false;
+  }
+
+  /**
+   * Print the report at the end of the optimization.
+   *
+   * @param * (optimizer) The optimizer used to update the function.
+   * @param * (function) Function to optimize.
+   * @param * (coordinates) The current function parameters.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& /* function */,
+                       MatType& /* coordinates */)
+  {
+    output << profiler.Report();
+  }
+
+ private:
+  //! The profiler to report.
+  const LayerProfiler& profiler;
+  //! The stream to print the report to.
+  std::ostream& output;
+  //! Print the report every this many epochs.
+  size_t epochs;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_profiler_impl.hpp"
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file methods/ann/layer_profiler_impl.hpp
+ *
+ * Implementation of the LayerProfiler class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PROFILER_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_PROFILER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_profiler.hpp"
+
+#include <iomanip>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+inline const LayerProfiler::Record& LayerProfiler::Get(const size_t layer,
+                                                       const Pass pass) const
+{
+  static const Record empty;
+  if (layer >= records.size())
+    return empty;
+
+  return records[layer][pass];
+}
+
+inline void LayerProfiler::StartTimer(const size_t layer, const Pass pass)
+{
+  Grow(layer);
+  Timer::Start(timerNames[layer][pass]);
+
+  // Take the time last, so that the timer itself isn't counted.
+  start = std::chrono::high_resolution_clock::now();
+}
+
+template<typename LayerType>
+void LayerProfiler::StopTimer(const size_t layer,
+                              const Pass pass,
+                              LayerType& layerType)
+{
+  const std::chrono::high_resolution_clock::time_point end =
+      std::chrono::high_resolution_clock::now();
+  Timer::Stop(timerNames[layer][pass]);
+
+  Record& record = records[layer][pass];
+  ++record.calls;
+  record.time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+      end - start);
+
+  const double weights = boost::apply_visitor(WeightSizeVisitor(), layerType);
+  const arma::mat& output = boost::apply_visitor(OutputParameterVisitor(),
+      layerType);
+
+  if (pass == FORWARD)
+  {
+    record.flops += (weights > 0) ? 2 * weights * output.n_cols :
+        output.n_elem;
+    record.bytes += output.n_elem * sizeof(double);
+  }
+  else if (pass == BACKWARD)
+  {
+    const arma::mat& delta = boost::apply_visitor(DeltaVisitor(), layerType);
+    record.flops += (weights > 0) ? 2 * weights * delta.n_cols : delta.n_elem;
+    record.bytes += delta.n_elem * sizeof(double);
+  }
+  else
+  {
+    record.flops += 2 * weights * output.n_cols;
+    record.bytes += weights * sizeof(double);
+  }
+}
+
+inline void LayerProfiler::Grow(const size_t layer)
+{
+  // The names are kept when the records are reset.
+  static const char* passNames[] = { "forward", "backward", "gradient" };
+  while (timerNames.size() <= layer)
+  {
+    std::array<std::string, 3> names;
+    for (size_t p = 0; p < 3; ++p)
+    {
+      names[p] = name + "_layer" + std::to_string(timerNames.size()) + "_" +
+          passNames[p];
+    }
+    timerNames.push_back(names);
+  }
+
+  if (records.size() <= layer)
+    records.resize(layer + 1);
+}
+
+inline std::string LayerProfiler::Report() const
+{
+  static const char* passNames[] = { "forward", "backward", "gradient" };
+
+  std::chrono::nanoseconds total(0);
+  for (size_t i = 0; i < records.size(); ++i)
+    for (size_t p = 0; p < 3; ++p)
+      total += records[i][p].time;
+
+  std::ostringstream oss;
+  oss << std::left << std::setw(8) << "layer" << std::setw(10) << "pass"
+      << std::right << std::setw(10) << "calls" << std::setw(12) << "time (ms)"
+      << std::setw(9) << "share" << std::setw(11) << "GFLOP/s"
+      << std::setw(12) << "MB" << std::endl;
+
+  oss << std::fixed;
+  for (size_t i = 0; i < records.size(); ++i)
+  {
+    for (size_t p = 0; p < 3; ++p)
+    {
+      const Record& record = records[i][p];
+      if (record.calls == 0)
+        continue;
+
+      const double seconds = record.time.count() * 1e-9;
+      const double share = (total.count() > 0) ?
+          100.0 * record.time.count() / total.count() : 0.0;
+
+      oss << std::left << std::setw(8) << i << std::setw(10) << passNames[p]
+          << std::right << std::setw(10) << record.calls
+          << std::setw(12) << std::setprecision(3) << seconds * 1e3
+          << std::setw(8) << std::setprecision(1) << share << "%"
+          << std::setw(11) << std::setprecision(3)
+          << ((seconds > 0) ? record.flops / seconds * 1e-9 : 0.0)
+          << std::setw(12) << std::setprecision(3) << record.bytes / 1048576.0
+          << std::endl;
+    }
+  }
+
+  return oss.str();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
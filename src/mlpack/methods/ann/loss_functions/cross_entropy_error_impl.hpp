@@ -32,8 +32,8 @@ CrossEntropyError<InputDataType, OutputDataType>::Forward(
     const InputType& input,
     const TargetType& target)
 {
-  return -arma::accu(target % arma::log(input + eps) +
-      (1. - target) % arma::log(1. - input + eps));
+  return -accu(target % log(input + eps) +
+      (1. - target) % log(1. - input + eps));
 }
 
 template<typename InputDataType, typename OutputDataType>
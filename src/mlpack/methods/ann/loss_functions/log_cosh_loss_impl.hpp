@@ -32,7 +32,7 @@ typename InputType::elem_type
 LogCoshLoss<InputDataType, OutputDataType>::Forward(const InputType& input,
                                                     const TargetType& target)
 {
-  return arma::accu(arma::log(arma::cosh(a * (target - input)))) / a;
+  return accu(log(cosh(a * (target - input)))) / a;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -42,7 +42,7 @@ void LogCoshLoss<InputDataType, OutputDataType>::Backward(
     const TargetType& target,
     OutputType& output)
 {
-  output = arma::tanh(a * (target - input));
+  output = tanh(a * (target - input));
 }
 
 template<typename InputDataType, typename OutputDataType>
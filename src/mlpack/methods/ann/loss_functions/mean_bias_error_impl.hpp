@@ -31,7 +31,7 @@ typename InputType::elem_type
 MeanBiasError<InputDataType, OutputDataType>::Forward(const InputType& input,
                                                       const TargetType& target)
 {
-  return arma::accu(target - input) / target.n_cols;
+  return accu(target - input) / target.n_cols;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -41,7 +41,7 @@ void MeanBiasError<InputDataType, OutputDataType>::Backward(
     const TargetType& /* target */,
     OutputType& output)
 {
-  output.set_size(arma::size(input));
+  output.set_size(input.n_rows, input.n_cols);
   output.fill(-1.0);
 }
 
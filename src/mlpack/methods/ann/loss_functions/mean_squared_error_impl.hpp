@@ -31,7 +31,7 @@ MeanSquaredError<InputDataType, OutputDataType>::Forward(
     const InputType& input,
     const TargetType& target)
 {
-  return arma::accu(arma::square(input - target)) / target.n_cols;
+  return accu(square(input - target)) / target.n_cols;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -32,8 +32,8 @@ MeanSquaredLogarithmicError<InputDataType, OutputDataType>::Forward(
     const InputType& input,
     const TargetType& target)
 {
-  return arma::accu(arma::square(arma::log(1. + target) -
-      arma::log(1. + input))) / target.n_cols;
+  return accu(square(log(1. + target) - log(1. + input))) /
+      target.n_cols;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -43,7 +43,7 @@ void MeanSquaredLogarithmicError<InputDataType, OutputDataType>::Backward(
     const TargetType& target,
     OutputType& output)
 {
-  output = 2 * (arma::log(1. + input) - arma::log(1. + target)) /
+  output = 2 * (log(1. + input) - log(1. + target)) /
       ((1. + input) * target.n_cols);
 }
 
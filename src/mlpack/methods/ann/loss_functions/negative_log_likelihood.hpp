@@ -89,6 +89,43 @@ class NegativeLogLikelihood
   void serialize(Archive& /* ar */, const unsigned int /* version */);
 
  private:
+  //! Compute the loss element by element.
+  template<typename InputType, typename TargetType>
+  static typename InputType::elem_type Forward(
+      const InputType& input,
+      const TargetType& target,
+      std::true_type /* isArmaType */);
+
+  //! Compute the loss as a sum over the whole input, for matrix types whose
+  //! elements are slow to access one by one (for instance, on the GPU).
+  template<typename InputType, typename TargetType>
+  static typename InputType::elem_type Forward(
+      const InputType& input,
+      const TargetType& target,
+      std::false_type /* isArmaType */);
+
+  //! Compute the error element by element.
+  template<typename InputType, typename TargetType, typename OutputType>
+  static void Backward(const InputType& input,
+                       const TargetType& target,
+                       OutputType& output,
+                       std::true_type /* isArmaType */);
+
+  //! Compute the error in host memory and copy it once, for other matrix
+  //! types.
+  template<typename InputType, typename TargetType, typename OutputType>
+  static void Backward(const InputType& input,
+                       const TargetType& target,
+                       OutputType& output,
+                       std::false_type /* isArmaType */);
+
+  //! Return a host matrix of the size of the input, with the given value at
+  //! the target class of each point and zeros elsewhere.
+  template<typename ElemType, typename TargetType>
+  static arma::Mat<ElemType> TargetMatrix(const TargetType& target,
+                                          const size_t numClasses,
+                                          const ElemType value);
+
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -30,6 +30,18 @@ typename InputType::elem_type
 NegativeLogLikelihood<InputDataType, OutputDataType>::Forward(
     const InputType& input,
     const TargetType& target)
+{
+  return Forward(input, target, std::integral_constant<bool,
+      arma::is_arma_type<InputType>::value>());
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType>
+typename InputType::elem_type
+NegativeLogLikelihood<InputDataType, OutputDataType>::Forward(
+    const InputType& input,
+    const TargetType& target,
+    std::true_type /* isArmaType */)
 {
   typedef typename InputType::elem_type ElemType;
   ElemType output = 0;
@@ -45,12 +57,40 @@ NegativeLogLikelihood<InputDataType, OutputDataType>::Forward(
   return output;
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType>
+typename InputType::elem_type
+NegativeLogLikelihood<InputDataType, OutputDataType>::Forward(
+    const InputType& input,
+    const TargetType& target,
+    std::false_type /* isArmaType */)
+{
+  typedef typename InputType::elem_type ElemType;
+
+  // Only the targets and the selection matrix go through host memory.
+  const InputType selection(TargetMatrix<ElemType>(target, input.n_rows,
+      ElemType(1)));
+  return -accu(input % selection);
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename InputType, typename TargetType, typename OutputType>
 void NegativeLogLikelihood<InputDataType, OutputDataType>::Backward(
       const InputType& input,
       const TargetType& target,
       OutputType& output)
+{
+  Backward(input, target, output, std::integral_constant<bool,
+      arma::is_arma_type<InputType>::value>());
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType, typename OutputType>
+void NegativeLogLikelihood<InputDataType, OutputDataType>::Backward(
+      const InputType& input,
+      const TargetType& target,
+      OutputType& output,
+      std::true_type /* isArmaType */)
 {
   output = arma::zeros<OutputType>(input.n_rows, input.n_cols);
   for (size_t i = 0; i < input.n_cols; ++i)
@@ -63,6 +103,40 @@ void NegativeLogLikelihood<InputDataType, OutputDataType>::Backward(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType, typename OutputType>
+void NegativeLogLikelihood<InputDataType, OutputDataType>::Backward(
+      const InputType& input,
+      const TargetType& target,
+      OutputType& output,
+      std::false_type /* isArmaType */)
+{
+  typedef typename InputType::elem_type ElemType;
+  output = OutputType(TargetMatrix<ElemType>(target, input.n_rows,
+      ElemType(-1)));
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename ElemType, typename TargetType>
+arma::Mat<ElemType>
+NegativeLogLikelihood<InputDataType, OutputDataType>::TargetMatrix(
+    const TargetType& target,
+    const size_t numClasses,
+    const ElemType value)
+{
+  const arma::Mat<ElemType> hostTarget(target);
+  arma::Mat<ElemType> result(numClasses, hostTarget.n_elem, arma::fill::zeros);
+  for (size_t i = 0; i < hostTarget.n_elem; ++i)
+  {
+    size_t currentTarget = hostTarget[i] - 1;
+    Log::Assert(currentTarget < numClasses, "Target class out of range.");
+
+    result(currentTarget, i) = value;
+  }
+
+  return result;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void NegativeLogLikelihood<InputDataType, OutputDataType>::serialize(
@@ -78,6 +78,21 @@ class SigmoidCrossEntropyError
                        const TargetType& target,
                        OutputType& output);
 
+  /**
+   * Computes the Sigmoid CrossEntropy Error and its gradient in one pass over
+   * the input; this returns the result of Forward() and stores the result of
+   * Backward() in the output.  FFN and StaticFFN use it when training.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param target The target vector.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  inline typename InputType::elem_type ForwardBackward(
+      const InputType& input,
+      const TargetType& target,
+      OutputType& output);
+
   //! Get the output parameter.
   OutputDataType& OutputParameter() const { return outputParameter; }
   //! Modify the output parameter.
@@ -55,6 +55,30 @@ inline void SigmoidCrossEntropyError<InputDataType, OutputDataType>::Backward(
   output = 1.0 / (1.0 + arma::exp(-input)) - target;
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType, typename OutputType>
+inline typename InputType::elem_type
+SigmoidCrossEntropyError<InputDataType, OutputDataType>::ForwardBackward(
+    const InputType& input,
+    const TargetType& target,
+    OutputType& output)
+{
+  typedef typename InputType::elem_type ElemType;
+  output.set_size(input.n_rows, input.n_cols);
+
+  ElemType loss = 0;
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    // exp(-|x|) cannot overflow, and gives both the softplus and the sigmoid.
+    const ElemType x = input[i];
+    const ElemType e = std::exp(-std::abs(x));
+    loss += std::max(x, ElemType(0)) + std::log1p(e) - x * target[i];
+    output[i] = ((x >= 0) ? 1 / (1 + e) : e / (1 + e)) - target[i];
+  }
+
+  return loss;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void SigmoidCrossEntropyError<InputDataType, OutputDataType>::serialize(
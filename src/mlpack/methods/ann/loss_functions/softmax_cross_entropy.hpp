@@ -0,0 +1,122 @@
+/**
+ * @file methods/ann/loss_functions/softmax_cross_entropy.hpp
+ *
+ * Definition of the SoftmaxCrossEntropy class, which fuses the LogSoftMax layer
+ * and the NegativeLogLikelihood loss.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The softmax cross entropy loss takes the unnormalized log-probabilities
+ * (logits) of each class, and computes the same loss and error as a LogSoftMax
+ * layer followed by the NegativeLogLikelihood loss:
+ *
+ * \f[
+ * L(x, t) = \log \sum_j e^{x_j} - x_t, \qquad
+ * \frac{\partial L}{\partial x_j} = \frac{e^{x_j}}{\sum_k e^{x_k}} - [j = t].
+ * \f]
+ *
+ * The log-sum-exp is computed after subtracting the largest logit of each
+ * point, so it cannot overflow.  Since no layer has to store the
+ * log-probabilities, and the loss and the error are computed together by
+ * ForwardBackward() (which FFN and StaticFFN call when training), the top of
+ * the network takes one pass over the logits instead of several passes over
+ * the outputs of two layers.  The last layer of the network should be the one
+ * that computes the logits (such as Linear), and the network then predicts
+ * the logits instead of the log-probabilities; the predicted class is the
+ * same.
+ *
+ * Like NegativeLogLikelihood, the target of each point is its class index, in
+ * the range between 1 and the number of classes.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SoftmaxCrossEntropy
+{
+ public:
+  /**
+   * Create the SoftmaxCrossEntropy object.
+   */
+  SoftmaxCrossEntropy();
+
+  /**
+   * Computes the softmax cross entropy of the given logits.
+   *
+   * @param input The logits, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   */
+  template<typename InputType, typename TargetType>
+  typename InputType::elem_type Forward(const InputType& input,
+                                        const TargetType& target);
+
+  /**
+   * Computes the error of the given logits: the softmax of each point, minus
+   * one for its target class.
+   *
+   * @param input The logits, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  void Backward(const InputType& input,
+                const TargetType& target,
+                OutputType& output);
+
+  /**
+   * Computes the softmax cross entropy and the error of the given logits in
+   * one pass; this returns the result of Forward() and stores the result of
+   * Backward() in the output.
+   *
+   * @param input The logits, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  typename InputType::elem_type ForwardBackward(const InputType& input,
+                                                const TargetType& target,
+                                                OutputType& output);
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SoftmaxCrossEntropy
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "softmax_cross_entropy_impl.hpp"
+
+#endif
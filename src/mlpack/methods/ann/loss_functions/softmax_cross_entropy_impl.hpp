@@ -0,0 +1,116 @@
+/**
+ * @file methods/ann/loss_functions/softmax_cross_entropy_impl.hpp
+ *
+ * Implementation of the SoftmaxCrossEntropy class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_IMPL_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTIONS_SOFTMAX_CROSS_ENTROPY_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "softmax_cross_entropy.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SoftmaxCrossEntropy<InputDataType, OutputDataType>::SoftmaxCrossEntropy()
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType>
+typename InputType::elem_type
+SoftmaxCrossEntropy<InputDataType, OutputDataType>::Forward(
+    const InputType& input,
+    const TargetType& target)
+{
+  typedef typename InputType::elem_type ElemType;
+  ElemType output = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    Log::Assert(currentTarget < input.n_rows,
+        "Target class out of range.");
+
+    // Shift the logits by their maximum, so that no exponential overflows.
+    const ElemType* logits = input.colptr(i);
+    const ElemType maximum = *std::max_element(logits, logits + input.n_rows);
+    ElemType sum = 0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+      sum += std::exp(logits[j] - maximum);
+
+    output += maximum + std::log(sum) - logits[currentTarget];
+  }
+
+  return output;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType, typename OutputType>
+void SoftmaxCrossEntropy<InputDataType, OutputDataType>::Backward(
+    const InputType& input,
+    const TargetType& target,
+    OutputType& output)
+{
+  ForwardBackward(input, target, output);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename TargetType, typename OutputType>
+typename InputType::elem_type
+SoftmaxCrossEntropy<InputDataType, OutputDataType>::ForwardBackward(
+    const InputType& input,
+    const TargetType& target,
+    OutputType& output)
+{
+  typedef typename InputType::elem_type ElemType;
+  output.set_size(input.n_rows, input.n_cols);
+
+  ElemType loss = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t currentTarget = target(i) - 1;
+    Log::Assert(currentTarget < input.n_rows,
+        "Target class out of range.");
+
+    // The exponentials of the shifted logits are written to the output, and
+    // normalized once their sum is known.
+    const ElemType* logits = input.colptr(i);
+    typename OutputType::elem_type* probabilities = output.colptr(i);
+    const ElemType maximum = *std::max_element(logits, logits + input.n_rows);
+    ElemType sum = 0;
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      probabilities[j] = std::exp(logits[j] - maximum);
+      sum += probabilities[j];
+    }
+
+    loss += maximum + std::log(sum) - logits[currentTarget];
+
+    for (size_t j = 0; j < input.n_rows; ++j)
+      probabilities[j] /= sum;
+    probabilities[currentTarget] -= 1;
+  }
+
+  return loss;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SoftmaxCrossEntropy<InputDataType, OutputDataType>::serialize(
+    Archive& /* ar */,
+    const unsigned int /* version */)
+{
+  // Nothing to do here.
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file methods/ann/magnitude_pruning.hpp
+ *
+ * Definition of the MagnitudePruning class, which zeroes the smallest weights
+ * of the Linear layers of a feed forward network and replaces the pruned
+ * layers with sparse layers for inference, and of the KeepPruned callback.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MAGNITUDE_PRUNING_HPP
+#define MLPACK_METHODS_ANN_MAGNITUDE_PRUNING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/reset_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * This class prunes the Linear layers of a network by magnitude: in each
+ * layer, the given fraction of the weights with the smallest absolute value is
+ * set to zero (the biases are kept).  The pruned network can be retrained with
+ * the KeepPruned callback, which keeps the pruned weights at zero, to recover
+ * the accuracy lost by pruning; then the Linear layers that are sparse enough
+ * can be replaced by SparseLinear layers, which store only the non-zero
+ * weights and skip the others in the forward pass.
+ *
+ * @code
+ * FFN<> model;
+ * // ... add layers and train ...
+ * arma::mat mask;
+ * model.Prune(0.9, mask);
+ * model.Train(x, y, optimizer, KeepPruned(mask));
+ * model.Sparsify();
+ * @endcode
+ *
+ * Layers that hold other layers are not looked into.
+ */
+template<typename... CustomLayers>
+class MagnitudePruning
+{
+ public:
+  /**
+   * Set the given fraction of the weights of each Linear layer of the given
+   * network with the smallest magnitude to zero.
+   *
+   * @param network The layers of the network.
+   * @param parameter The weights of the network, aliased by the layers.
+   * @param sparsity The fraction of the weights of each layer to set to zero,
+   *     in [0, 1).
+   * @param mask Matrix to store the mask of the weights that are kept (the
+   *     same size as the parameter, zero for the pruned weights and one for
+   *     the others).
+   */
+  static void Prune(std::vector<LayerTypes<CustomLayers...> >& network,
+                    arma::mat& parameter,
+                    const double sparsity,
+                    arma::mat& mask);
+
+  /**
+   * Replace each Linear layer of the given network whose fraction of zero
+   * weights is at least minSparsity with a SparseLinear layer, and store the
+   * weights of the resulting network in the given parameter.  The weights of
+   * the replaced layers are not part of the parameter anymore.
+   *
+   * @param network The layers of the network; the replaced layers are deleted.
+   * @param parameter The weights of the network, aliased by the layers.
+   * @param minSparsity The minimum fraction of zero weights of the layers to
+   *     replace.
+   */
+  static void Sparsify(std::vector<LayerTypes<CustomLayers...> >& network,
+                       arma::mat& parameter,
+                       const double minSparsity = 0.5);
+
+ private:
+  //! Compute the offset of the weights of each layer in the parameter.
+  static std::vector<size_t> Offsets(
+      std::vector<LayerTypes<CustomLayers...> >& network);
+};
+
+/**
+ * An ensmallen callback that keeps the weights pruned by FFN::Prune() (see
+ * MagnitudePruning) at zero while a network is retrained, by multiplying the
+ * coordinates with the mask after each step of the optimizer.  The network
+ * must be the one being trained, so that its parameters are the coordinates of
+ * the optimizer (as with FFN::Train()).
+ */
+class KeepPruned
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param mask The mask of the weights that are kept, as given by
+   *     FFN::Prune().
+   */
+  KeepPruned(const arma::mat& mask) : mask(mask)
+  {
+    /* Nothing to do here. */
+  }
+
+  /**
+   * Apply the mask to the initial coordinates.
+   *
+   * @param * (optimizer) The optimizer used to update the function.
+   * @param * (function) Function to optimize.
+   * @param coordinates The current function parameters.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         MatType& coordinates)
+  {
+    coordinates %= mask;
+  }
+
+  /**
+   * Apply the mask to the coordinates after a step of the optimizer.
+   *
+   * @param * (optimizer) The optimizer used to update the function.
+   * @param * (function) Function to optimize.
+   * @param coordinates The current function parameters.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 MatType& coordinates)
+  {
+    coordinates %= mask;
+    return false;
+  }
+
+ private:
+  //! The mask of the weights that are kept.
+  arma::mat mask;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "magnitude_pruning_impl.hpp"
+
+#endif
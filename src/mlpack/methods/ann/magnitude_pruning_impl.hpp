@@ -0,0 +1,130 @@
+/**
+ * @file methods/ann/magnitude_pruning_impl.hpp
+ *
+ * Implementation of the MagnitudePruning class, which zeroes the smallest
+ * weights of the Linear layers of a feed forward network and replaces the
+ * pruned layers with sparse layers for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MAGNITUDE_PRUNING_IMPL_HPP
+#define MLPACK_METHODS_ANN_MAGNITUDE_PRUNING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "magnitude_pruning.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename... CustomLayers>
+void MagnitudePruning<CustomLayers...>::Prune(
+    std::vector<LayerTypes<CustomLayers...> >& network,
+    arma::mat& parameter,
+    const double sparsity,
+    arma::mat& mask)
+{
+  if (sparsity < 0.0 || sparsity >= 1.0)
+  {
+    std::ostringstream oss;
+    oss << "MagnitudePruning::Prune(): sparsity must be in [0, 1) (given "
+        << sparsity << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const std::vector<size_t> offsets = Offsets(network);
+  mask.ones(parameter.n_rows, parameter.n_cols);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    Linear<>** linear = boost::get<Linear<>*>(&network[i]);
+    if (!linear)
+      continue;
+
+    // The weights of the layer come first in its block of the parameter, and
+    // then the bias.
+    const size_t weights = (*linear)->InputSize() * (*linear)->OutputSize();
+    const size_t pruned = (size_t) std::floor(sparsity * weights);
+    if (pruned == 0)
+      continue;
+
+    const arma::uvec order = arma::sort_index(arma::abs(parameter.rows(
+        offsets[i], offsets[i] + weights - 1)));
+    for (size_t j = 0; j < pruned; ++j)
+    {
+      parameter[offsets[i] + order[j]] = 0.0;
+      mask[offsets[i] + order[j]] = 0.0;
+    }
+  }
+}
+
+template<typename... CustomLayers>
+void MagnitudePruning<CustomLayers...>::Sparsify(
+    std::vector<LayerTypes<CustomLayers...> >& network,
+    arma::mat& parameter,
+    const double minSparsity)
+{
+  const std::vector<size_t> offsets = Offsets(network);
+
+  // The weights of the layers that are kept are still a block of the
+  // parameter.
+  WeightSizeVisitor weightSizeVisitor;
+  arma::mat sparseParameter;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    Linear<>** linear = boost::get<Linear<>*>(&network[i]);
+    if (linear)
+    {
+      const arma::mat& weight = (*linear)->Weight();
+      const size_t zeros = weight.n_elem - arma::accu(weight != 0.0);
+      if (weight.n_elem > 0 && zeros >= minSparsity * weight.n_elem)
+      {
+        SparseLinear<>* layer = new SparseLinear<>(weight, (*linear)->Bias());
+        delete *linear;
+        network[i] = layer;
+        continue;
+      }
+    }
+
+    const size_t weights = boost::apply_visitor(weightSizeVisitor, network[i]);
+    if (weights > 0)
+    {
+      sparseParameter = arma::join_cols(sparseParameter,
+          parameter.rows(offsets[i], offsets[i] + weights - 1));
+    }
+  }
+
+  // Some layers (like BatchNorm) initialize their weights when they are reset,
+  // so the weights are only copied in after.
+  parameter.set_size(sparseParameter.n_elem, 1);
+  ResetVisitor resetVisitor;
+  for (size_t i = 0, offset = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(parameter, offset),
+        network[i]);
+
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+  parameter = sparseParameter;
+}
+
+template<typename... CustomLayers>
+std::vector<size_t> MagnitudePruning<CustomLayers...>::Offsets(
+    std::vector<LayerTypes<CustomLayers...> >& network)
+{
+  WeightSizeVisitor weightSizeVisitor;
+  std::vector<size_t> offsets(network.size(), 0);
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    offsets[i] = offsets[i - 1] + boost::apply_visitor(weightSizeVisitor,
+        network[i - 1]);
+  }
+
+  return offsets;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
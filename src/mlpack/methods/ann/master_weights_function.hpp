@@ -0,0 +1,193 @@
+/**
+ * @file methods/ann/master_weights_function.hpp
+ *
+ * Definition of the MasterWeightsFunction class, which lets an optimizer
+ * update double-precision master weights of a network that computes in single
+ * precision.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MASTER_WEIGHTS_FUNCTION_HPP
+#define MLPACK_METHODS_ANN_MASTER_WEIGHTS_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A differentiable separable function over arma::mat coordinates (the master
+ * weights) that evaluates a network whose parameters have a lower precision
+ * (for instance a StaticFFN of layers with arma::fmat outputs).  Before each
+ * evaluation the master weights are rounded into the parameters of the
+ * network, and the gradient of the network is converted back to double
+ * precision; so the forward and backward passes run in the precision of the
+ * network, but small updates of the optimizer are not lost to rounding.
+ *
+ * The gradient can also be computed with dynamic loss scaling: the error of
+ * the output layer is multiplied by the loss scale before it is
+ * backpropagated, so that small gradients don't underflow, and the gradient is
+ * divided by the loss scale in double precision.  If the gradient of a batch
+ * is not finite, the loss scale is halved and the gradient is set to zero, so
+ * that the step doesn't change the weights (for optimizers without momentum);
+ * after the given number of finite gradients in a row, the loss scale is
+ * doubled.  A loss scale of 1 with a growth interval of 0 disables the
+ * scaling.
+ *
+ * The network must give access to its parameters with Parameters(), and its
+ * EvaluateWithGradient() must multiply the error of the output layer by
+ * LossScale().  The function is usually used through
+ * StaticFFN::TrainWithMasterWeights().
+ *
+ * @tparam NetworkType Type of the network.
+ */
+template<typename NetworkType>
+class MasterWeightsFunction
+{
+ public:
+  //! The matrix type of the network.
+  typedef typename NetworkType::MatType NetworkMatType;
+
+  /**
+   * Create the function for the given network.
+   *
+   * @param network The network to evaluate.
+   * @param lossScale Initial loss scale.
+   * @param growthInterval Number of finite gradients in a row after which the
+   *     loss scale is doubled (0 to keep the loss scale fixed).
+   */
+  MasterWeightsFunction(NetworkType& network,
+                        const double lossScale = 1.0,
+                        const size_t growthInterval = 0) :
+      network(network),
+      growthInterval(growthInterval),
+      finiteSteps(0),
+      skippedSteps(0)
+  {
+    network.LossScale() = lossScale;
+  }
+
+  //! Evaluate the network on the whole training set.
+  double Evaluate(const arma::mat& coordinates)
+  {
+    SetParameters(coordinates);
+    return network.Evaluate(network.Parameters());
+  }
+
+  //! Evaluate the network on a batch of the training set.
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t begin,
+                  const size_t batchSize)
+  {
+    SetParameters(coordinates);
+    return network.Evaluate(network.Parameters(), begin, batchSize);
+  }
+
+  //! Evaluate the network and its gradient on the whole training set.
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient)
+  {
+    SetParameters(coordinates);
+    const double res = network.EvaluateWithGradient(network.Parameters(),
+        networkGradient);
+    SetGradient(gradient);
+    return res;
+  }
+
+  //! Evaluate the network and its gradient on a batch of the training set.
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize)
+  {
+    SetParameters(coordinates);
+    const double res = network.EvaluateWithGradient(network.Parameters(),
+        begin, networkGradient, batchSize);
+    SetGradient(gradient);
+    return res;
+  }
+
+  //! Compute the gradient of the network on a batch of the training set.
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize)
+  {
+    EvaluateWithGradient(coordinates, begin, gradient, batchSize);
+  }
+
+  //! Shuffle the training points of the network.
+  void Shuffle() { network.Shuffle(); }
+
+  //! Return the number of separable functions.
+  size_t NumFunctions() const { return network.NumFunctions(); }
+
+  //! Get the current loss scale.
+  double LossScale() const { return network.LossScale(); }
+
+  //! Get the number of gradients that were not finite, and set to zero.
+  size_t SkippedSteps() const { return skippedSteps; }
+
+ private:
+  //! Round the master weights into the parameters of the network, in place,
+  //! since the layers alias the parameters.
+  void SetParameters(const arma::mat& coordinates)
+  {
+    NetworkMatType& parameters = network.Parameters();
+    for (size_t i = 0; i < coordinates.n_elem; ++i)
+    {
+      parameters[i] =
+          static_cast<typename NetworkMatType::elem_type>(coordinates[i]);
+    }
+  }
+
+  //! Convert the gradient of the network to double precision, unscale it, and
+  //! update the loss scale.
+  void SetGradient(arma::mat& gradient)
+  {
+    const double lossScale = network.LossScale();
+    gradient = arma::conv_to<arma::mat>::from(networkGradient);
+    if (lossScale != 1.0)
+      gradient /= lossScale;
+
+    if (growthInterval == 0)
+      return;
+
+    if (!gradient.is_finite())
+    {
+      gradient.zeros();
+      network.LossScale() = lossScale / 2;
+      finiteSteps = 0;
+      ++skippedSteps;
+    }
+    else if (++finiteSteps == growthInterval)
+    {
+      network.LossScale() = lossScale * 2;
+      finiteSteps = 0;
+    }
+  }
+
+  //! The network to evaluate.
+  NetworkType& network;
+
+  //! The gradient of the network, in its own precision.
+  NetworkMatType networkGradient;
+
+  //! The number of finite gradients in a row after which the loss scale is
+  //! doubled.
+  size_t growthInterval;
+
+  //! The number of finite gradients since the loss scale last changed.
+  size_t finiteSteps;
+
+  //! The number of gradients that were not finite.
+  size_t skippedSteps;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file methods/ann/onnx/onnx.hpp
+ *
+ * Declaration of the Export() and Import() functions, which convert between
+ * feed forward networks and ONNX models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ONNX_ONNX_HPP
+#define MLPACK_METHODS_ANN_ONNX_ONNX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+
+#include "onnx_graph.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+namespace onnx /** Reading and writing of ONNX models. */ {
+
+/**
+ * Save the given trained network as an ONNX model (opset 11), so that it can
+ * be run by other inference runtimes.  The network is exported as a sequential
+ * graph whose input is a batch of points; a point is a vector for networks
+ * that start with a Linear layer, and a (channels, height, width) tensor for
+ * networks that start with a Convolution layer, whose input width and height
+ * must then be set.  The memory layout of the points is the same as in mlpack,
+ * so the data doesn't need to be reordered.  The weights are stored as floats.
+ *
+ * The supported layers are Linear, LinearNoBias, FusedLinear, Convolution,
+ * MaxPooling, MeanPooling, BatchNorm, the sigmoid, tanh, ReLU and leaky ReLU
+ * activations, Softmax and LogSoftMax.  Dropout and IdentityLayer are
+ * skipped, since they are the identity at inference time.  A
+ * std::invalid_argument is thrown for any other layer.
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<> > model;
+ * // ... build and train the model ...
+ * onnx::Export(model, "model.onnx");
+ * @endcode
+ *
+ * @param network The trained network.
+ * @param filename The file to save the model to.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+void Export(FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+                network,
+            const std::string& filename);
+
+/**
+ * Load the ONNX model in the given file into the given network, for
+ * inference or fine-tuning.  The graph must be sequential (each node takes the
+ * output of the previous node as its first input, and initializers as its
+ * other inputs) and made of the operators produced by Export(): Gemm, MatMul,
+ * Conv, MaxPool, AveragePool (without padding), BatchNormalization, Relu,
+ * Sigmoid, Tanh, LeakyRelu, Softmax, LogSoftmax, Flatten and Reshape; Dropout
+ * and Identity nodes are skipped.  For convolutional models the shape of the
+ * input of the graph must be given.  The layers are appended to the network,
+ * which should be empty, and its parameters are reset to the weights of the
+ * model.  A std::runtime_error is thrown if the model can't be read or
+ * converted.
+ *
+ * @param filename The file to load the model from.
+ * @param network The network to add the layers to.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+void Import(const std::string& filename,
+            FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+                network);
+
+} // namespace onnx
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "onnx_impl.hpp"
+
+#endif
@@ -0,0 +1,348 @@
+/**
+ * @file methods/ann/onnx/onnx_graph.hpp
+ *
+ * Definition of the GraphWriter class, which builds the protocol buffers
+ * encoding of a sequential ONNX graph, and of the ReadTensor() function, which
+ * decodes an ONNX tensor.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ONNX_ONNX_GRAPH_HPP
+#define MLPACK_METHODS_ANN_ONNX_ONNX_GRAPH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "protobuf.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+namespace onnx /** Reading and writing of ONNX models. */ {
+
+//! The ONNX element type of float tensors.
+const int64_t FloatType = 1;
+//! The ONNX element type of int64 tensors.
+const int64_t Int64Type = 7;
+//! The ONNX element type of double tensors.
+const int64_t DoubleType = 11;
+
+/**
+ * A builder of a sequential ONNX graph: each node takes the output of the
+ * previous node (or the input of the graph) as its first input, and its
+ * parameters as initializers.  The field numbers are the ones of onnx.proto.
+ */
+class GraphWriter
+{
+ public:
+  //! Create an empty graph, whose input tensor is named "input".
+  GraphWriter() : current("input"), count(0) { /* Nothing to do. */ }
+
+  /**
+   * Add a float initializer to the graph.
+   *
+   * @param name The name of the tensor.
+   * @param dims The dimensions of the tensor.
+   * @param data The values of the tensor, in row-major order.
+   * @return The name of the tensor.
+   */
+  std::string Initializer(const std::string& name,
+                          const std::vector<int64_t>& dims,
+                          const arma::mat& data)
+  {
+    std::string raw(4 * data.n_elem, '\0');
+    for (size_t i = 0; i < data.n_elem; ++i)
+    {
+      const float value = (float) data[i];
+      uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(float));
+      for (size_t b = 0; b < 4; ++b)
+        raw[4 * i + b] = (char) ((bits >> (8 * b)) & 0xFF);
+    }
+
+    ProtoWriter tensor;
+    tensor.Ints(1, dims);
+    tensor.Int(2, FloatType);
+    tensor.Bytes(8, name);
+    tensor.Bytes(9, raw);
+    initializers.push_back(tensor);
+    return name;
+  }
+
+  /**
+   * Add an int64 initializer to the graph.
+   *
+   * @param name The name of the tensor.
+   * @param values The values of the one dimensional tensor.
+   * @return The name of the tensor.
+   */
+  std::string Int64Initializer(const std::string& name,
+                               const std::vector<int64_t>& values)
+  {
+    ProtoWriter tensor;
+    tensor.Int(1, values.size());
+    tensor.Int(2, Int64Type);
+    tensor.Ints(7, values);
+    tensor.Bytes(8, name);
+    initializers.push_back(tensor);
+    return name;
+  }
+
+  /**
+   * Add a node to the graph.  Its first input is the current output of the
+   * graph, and its output becomes the current output.
+   *
+   * @param opType The ONNX operator of the node.
+   * @param parameters The names of the other inputs of the node.
+   * @param attributes The attributes of the node.
+   */
+  void Node(const std::string& opType,
+            const std::vector<std::string>& parameters =
+                std::vector<std::string>(),
+            const std::vector<ProtoWriter>& attributes =
+                std::vector<ProtoWriter>())
+  {
+    const std::string name = NodeName(opType);
+
+    ProtoWriter node;
+    node.Bytes(1, current);
+    for (size_t i = 0; i < parameters.size(); ++i)
+      node.Bytes(1, parameters[i]);
+    node.Bytes(2, name + "_output");
+    node.Bytes(3, name);
+    node.Bytes(4, opType);
+    for (size_t i = 0; i < attributes.size(); ++i)
+      node.Message(5, attributes[i]);
+
+    nodes.push_back(node);
+    current = name + "_output";
+    ++count;
+  }
+
+  //! Get the name the next node added with the given operator will have; its
+  //! initializers are named after it.
+  std::string NodeName(const std::string& opType) const
+  {
+    std::ostringstream name;
+    name << opType << "_" << count;
+    return name.str();
+  }
+
+  //! Create an integer attribute.
+  static ProtoWriter IntAttribute(const std::string& name, const int64_t value)
+  {
+    ProtoWriter attribute;
+    attribute.Bytes(1, name);
+    attribute.Int(3, value);
+    attribute.Int(20, 2);
+    return attribute;
+  }
+
+  //! Create a float attribute.
+  static ProtoWriter FloatAttribute(const std::string& name, const float value)
+  {
+    ProtoWriter attribute;
+    attribute.Bytes(1, name);
+    attribute.Float(2, value);
+    attribute.Int(20, 1);
+    return attribute;
+  }
+
+  //! Create an integer list attribute.
+  static ProtoWriter IntsAttribute(const std::string& name,
+                                   const std::vector<int64_t>& values)
+  {
+    ProtoWriter attribute;
+    attribute.Bytes(1, name);
+    attribute.Ints(8, values);
+    attribute.Int(20, 7);
+    return attribute;
+  }
+
+  /**
+   * Encode the model that holds the graph.
+   *
+   * @param inputShape The shape of one input point.
+   * @param outputShape The shape of one output point.
+   * @return The encoded ModelProto.
+   */
+  std::string Model(const std::vector<size_t>& inputShape,
+                    const std::vector<size_t>& outputShape) const
+  {
+    ProtoWriter graph;
+    for (size_t i = 0; i < nodes.size(); ++i)
+      graph.Message(1, nodes[i]);
+    graph.Bytes(2, "mlpack");
+    for (size_t i = 0; i < initializers.size(); ++i)
+      graph.Message(5, initializers[i]);
+    graph.Message(11, ValueInfo("input", inputShape));
+    graph.Message(12, ValueInfo(current, outputShape));
+
+    // The operators are the ones of opset 11.
+    ProtoWriter opset;
+    opset.Int(2, 11);
+
+    ProtoWriter model;
+    model.Int(1, 6);
+    model.Bytes(2, "mlpack");
+    model.Message(7, graph);
+    model.Message(8, opset);
+    return model.Buffer();
+  }
+
+ private:
+  //! Encode the float tensor with the given name and shape, with a symbolic
+  //! batch dimension.
+  static ProtoWriter ValueInfo(const std::string& name,
+                               const std::vector<size_t>& shape)
+  {
+    ProtoWriter tensorShape;
+    ProtoWriter batch;
+    batch.Bytes(2, "N");
+    tensorShape.Message(1, batch);
+    for (size_t i = 0; i < shape.size(); ++i)
+    {
+      ProtoWriter dim;
+      dim.Int(1, shape[i]);
+      tensorShape.Message(1, dim);
+    }
+
+    ProtoWriter tensorType;
+    tensorType.Int(1, FloatType);
+    tensorType.Message(2, tensorShape);
+
+    ProtoWriter type;
+    type.Message(1, tensorType);
+
+    ProtoWriter valueInfo;
+    valueInfo.Bytes(1, name);
+    valueInfo.Message(2, type);
+    return valueInfo;
+  }
+
+  //! The name of the current output of the graph.
+  std::string current;
+  //! The number of nodes of the graph.
+  size_t count;
+  //! The encoded nodes.
+  std::vector<ProtoWriter> nodes;
+  //! The encoded initializers.
+  std::vector<ProtoWriter> initializers;
+};
+
+/**
+ * A decoded ONNX tensor.
+ */
+struct Tensor
+{
+  //! The dimensions of the tensor.
+  std::vector<int64_t> dims;
+  //! The values of the tensor, in row-major order.
+  arma::vec data;
+};
+
+/**
+ * Decode an ONNX tensor of floats, doubles or int64 values.
+ *
+ * @param tensor The encoded TensorProto.
+ * @param result The decoded tensor.
+ */
+inline void ReadTensor(const ProtoReader& tensor, Tensor& result)
+{
+  std::vector<int64_t>& dims = result.dims;
+  arma::vec& data = result.data;
+  dims = tensor.Ints(1);
+  size_t elements = 1;
+  for (size_t i = 0; i < dims.size(); ++i)
+    elements *= dims[i];
+
+  const int64_t type = tensor.Int(2);
+  const ProtoField* raw = tensor.Field(9);
+  data.set_size(elements);
+  if (type == FloatType || type == DoubleType || type == Int64Type)
+  {
+    const size_t bytes = (type == FloatType) ? 4 : 8;
+    if (raw != NULL)
+    {
+      if (raw->bytes.size() != bytes * elements)
+        throw std::runtime_error("ReadTensor(): raw data has the wrong size");
+
+      for (size_t i = 0; i < elements; ++i)
+      {
+        uint64_t bits = 0;
+        for (size_t b = 0; b < bytes; ++b)
+        {
+          bits |= uint64_t((unsigned char) raw->bytes[bytes * i + b]) <<
+              (8 * b);
+        }
+
+        if (type == FloatType)
+          data[i] = ProtoReader::ToFloat(bits);
+        else if (type == DoubleType)
+          data[i] = ProtoReader::ToDouble(bits);
+        else
+          data[i] = (double) (int64_t) bits;
+      }
+    }
+    else if (type == Int64Type)
+    {
+      const std::vector<int64_t> values = tensor.Ints(7);
+      if (values.size() != elements)
+        throw std::runtime_error("ReadTensor(): int64 data has the wrong size");
+
+      for (size_t i = 0; i < elements; ++i)
+        data[i] = (double) values[i];
+    }
+    else
+    {
+      // float_data is a repeated fixed32 and double_data a repeated fixed64
+      // field; both may be packed.
+      const std::vector<const ProtoField*> fields =
+          tensor.Fields((type == FloatType) ? 4 : 10);
+      size_t i = 0;
+      for (size_t f = 0; f < fields.size(); ++f)
+      {
+        std::vector<uint64_t> values;
+        if (fields[f]->wireType == 2)
+        {
+          const std::string& packed = fields[f]->bytes;
+          for (size_t p = 0; p + bytes <= packed.size(); p += bytes)
+          {
+            uint64_t bits = 0;
+            for (size_t b = 0; b < bytes; ++b)
+              bits |= uint64_t((unsigned char) packed[p + b]) << (8 * b);
+            values.push_back(bits);
+          }
+        }
+        else
+        {
+          values.push_back(fields[f]->value);
+        }
+
+        for (size_t v = 0; v < values.size(); ++v, ++i)
+        {
+          if (i >= elements)
+            throw std::runtime_error("ReadTensor(): too many values");
+
+          data[i] = (type == FloatType) ? ProtoReader::ToFloat(values[v]) :
+              ProtoReader::ToDouble(values[v]);
+        }
+      }
+
+      if (i != elements)
+        throw std::runtime_error("ReadTensor(): too few values");
+    }
+  }
+  else
+  {
+    throw std::runtime_error("ReadTensor(): only float, double and int64 "
+        "tensors are supported");
+  }
+}
+
+} // namespace onnx
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,792 @@
+/**
+ * @file methods/ann/onnx/onnx_impl.hpp
+ *
+ * Implementation of the Export() and Import() functions, which convert between
+ * feed forward networks and ONNX models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ONNX_ONNX_IMPL_HPP
+#define MLPACK_METHODS_ANN_ONNX_ONNX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "onnx.hpp"
+
+#include <mlpack/methods/ann/layer_names.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+namespace onnx /** Reading and writing of ONNX models. */ {
+
+//! Get the number of elements of a point of the given shape.
+inline size_t ShapeSize(const std::vector<size_t>& shape)
+{
+  size_t size = 1;
+  for (size_t i = 0; i < shape.size(); ++i)
+    size *= shape[i];
+
+  return size;
+}
+
+//! Add a Flatten node if the points of the graph have more than one
+//! dimension.
+inline void ExportFlatten(GraphWriter& graph, std::vector<size_t>& shape)
+{
+  if (shape.size() > 1)
+  {
+    graph.Node("Flatten", {}, { GraphWriter::IntAttribute("axis", 1) });
+    shape = std::vector<size_t>(1, ShapeSize(shape));
+  }
+}
+
+/**
+ * Add a Gemm (or, without bias, a MatMul) node for a layer with the given
+ * (outSize, inSize) weights.  Their column-major memory is the row-major
+ * memory of the (inSize, outSize) matrix B of Y = X B + C, so it is stored as
+ * it is.
+ */
+inline void ExportLinear(GraphWriter& graph,
+                         const arma::mat& weight,
+                         const arma::mat* bias,
+                         std::vector<size_t>& shape)
+{
+  ExportFlatten(graph, shape);
+  if (shape[0] != weight.n_cols)
+  {
+    throw std::invalid_argument("onnx::Export(): the input size of a linear "
+        "layer doesn't match the output size of the previous layer");
+  }
+
+  const std::string name = graph.NodeName((bias != NULL) ? "Gemm" : "MatMul");
+  std::vector<std::string> parameters;
+  parameters.push_back(graph.Initializer(name + "_B",
+      { (int64_t) weight.n_cols, (int64_t) weight.n_rows }, weight));
+  if (bias != NULL)
+  {
+    parameters.push_back(graph.Initializer(name + "_C",
+        { (int64_t) weight.n_rows }, *bias));
+    graph.Node("Gemm", parameters);
+  }
+  else
+  {
+    graph.Node("MatMul", parameters);
+  }
+
+  shape = std::vector<size_t>(1, weight.n_rows);
+}
+
+//! Add a Conv node for the given layer.  The memory of the (kernelWidth,
+//! kernelHeight, inSize * outSize) weights is the row-major memory of the
+//! (outSize, inSize, kernelHeight, kernelWidth) ONNX weights.
+inline void ExportConvolution(GraphWriter& graph,
+                              const Convolution<>& layer,
+                              std::vector<size_t>& shape)
+{
+  const size_t inSize = layer.InputSize();
+  const size_t width = layer.InputWidth();
+  const size_t height = layer.InputHeight();
+  if (width == 0 || height == 0)
+  {
+    throw std::invalid_argument("onnx::Export(): the input width and height of "
+        "Convolution layers must be set");
+  }
+
+  std::vector<size_t> inputShape;
+  inputShape.push_back(inSize);
+  inputShape.push_back(height);
+  inputShape.push_back(width);
+  if (shape.size() == 1 && shape[0] == ShapeSize(inputShape))
+  {
+    const std::string name = graph.NodeName("Reshape");
+    graph.Node("Reshape", { graph.Int64Initializer(name + "_shape",
+        { -1, (int64_t) inSize, (int64_t) height, (int64_t) width }) });
+    shape = inputShape;
+  }
+  else if (shape != inputShape)
+  {
+    throw std::invalid_argument("onnx::Export(): the input shape of a "
+        "Convolution layer doesn't match the output of the previous layer");
+  }
+
+  const arma::cube& weight = layer.Weight();
+  const std::string name = graph.NodeName("Conv");
+  std::vector<std::string> parameters;
+  parameters.push_back(graph.Initializer(name + "_W",
+      { (int64_t) layer.OutputSize(), (int64_t) inSize,
+        (int64_t) layer.KernelHeight(), (int64_t) layer.KernelWidth() },
+      arma::mat(const_cast<double*>(weight.memptr()), weight.n_elem, 1, false,
+      true)));
+  parameters.push_back(graph.Initializer(name + "_B",
+      { (int64_t) layer.OutputSize() }, layer.Bias()));
+
+  std::vector<ProtoWriter> attributes;
+  attributes.push_back(GraphWriter::IntsAttribute("kernel_shape",
+      { (int64_t) layer.KernelHeight(), (int64_t) layer.KernelWidth() }));
+  attributes.push_back(GraphWriter::IntsAttribute("strides",
+      { (int64_t) layer.StrideHeight(), (int64_t) layer.StrideWidth() }));
+  attributes.push_back(GraphWriter::IntsAttribute("pads",
+      { (int64_t) layer.PadHTop(), (int64_t) layer.PadWLeft(),
+        (int64_t) layer.PadHBottom(), (int64_t) layer.PadWRight() }));
+  graph.Node("Conv", parameters, attributes);
+
+  shape[0] = layer.OutputSize();
+  shape[1] = (height + layer.PadHTop() + layer.PadHBottom() -
+      layer.KernelHeight()) / layer.StrideHeight() + 1;
+  shape[2] = (width + layer.PadWLeft() + layer.PadWRight() -
+      layer.KernelWidth()) / layer.StrideWidth() + 1;
+}
+
+//! Add a MaxPool or AveragePool node for the given pooling layer.
+template<typename PoolingType>
+void ExportPooling(GraphWriter& graph,
+                   const std::string& opType,
+                   const PoolingType& layer,
+                   std::vector<size_t>& shape)
+{
+  if (shape.size() != 3)
+  {
+    throw std::invalid_argument("onnx::Export(): pooling layers must follow a "
+        "Convolution layer");
+  }
+
+  std::vector<ProtoWriter> attributes;
+  attributes.push_back(GraphWriter::IntsAttribute("kernel_shape",
+      { (int64_t) layer.KernelHeight(), (int64_t) layer.KernelWidth() }));
+  attributes.push_back(GraphWriter::IntsAttribute("strides",
+      { (int64_t) layer.StrideHeight(), (int64_t) layer.StrideWidth() }));
+  attributes.push_back(GraphWriter::IntAttribute("ceil_mode",
+      layer.Floor() ? 0 : 1));
+  graph.Node(opType, {}, attributes);
+
+  const double height = (shape[1] - (double) layer.KernelHeight()) /
+      layer.StrideHeight() + 1;
+  const double width = (shape[2] - (double) layer.KernelWidth()) /
+      layer.StrideWidth() + 1;
+  shape[1] = layer.Floor() ? std::floor(height) : std::ceil(height);
+  shape[2] = layer.Floor() ? std::floor(width) : std::ceil(width);
+}
+
+//! Add a BatchNormalization node for the given layer; the channels are the
+//! first dimension of the points.
+inline void ExportBatchNorm(GraphWriter& graph,
+                            const BatchNorm<>& layer,
+                            const std::vector<size_t>& shape)
+{
+  const size_t size = layer.InputSize();
+  if (shape[0] != size || (shape.size() != 1 && shape.size() != 3))
+  {
+    throw std::invalid_argument("onnx::Export(): the size of a BatchNorm layer "
+        "must be the number of inputs or of channels");
+  }
+
+  const std::string name = graph.NodeName("BatchNormalization");
+  const arma::mat& weights = layer.Parameters();
+  std::vector<std::string> parameters;
+  parameters.push_back(graph.Initializer(name + "_scale", { (int64_t) size },
+      weights.rows(0, size - 1)));
+  parameters.push_back(graph.Initializer(name + "_B", { (int64_t) size },
+      weights.rows(size, 2 * size - 1)));
+  parameters.push_back(graph.Initializer(name + "_mean", { (int64_t) size },
+      layer.TrainingMean()));
+  parameters.push_back(graph.Initializer(name + "_var", { (int64_t) size },
+      layer.TrainingVariance()));
+  graph.Node("BatchNormalization", parameters,
+      { GraphWriter::FloatAttribute("epsilon", layer.Epsilon()) });
+}
+
+/**
+ * Add the nodes of the given layer to the graph, and update the shape of the
+ * points.
+ */
+template<typename... CustomLayers>
+void ExportLayer(GraphWriter& graph,
+                 LayerTypes<CustomLayers...>& layer,
+                 std::vector<size_t>& shape)
+{
+  if (Linear<>** linear = boost::get<Linear<>*>(&layer))
+  {
+    ExportLinear(graph, (*linear)->Weight(), &(*linear)->Bias(), shape);
+  }
+  else if (LinearNoBias<>** linear = boost::get<LinearNoBias<>*>(&layer))
+  {
+    const arma::mat& weights = (*linear)->Parameters();
+    ExportLinear(graph, arma::mat(const_cast<double*>(weights.memptr()),
+        (*linear)->OutputSize(), (*linear)->InputSize(), false, true), NULL,
+        shape);
+  }
+  else if (FusedLinear<LogisticFunction>** fused =
+      boost::get<FusedLinear<LogisticFunction>*>(&layer))
+  {
+    ExportLinear(graph, (*fused)->Weight(), &(*fused)->Bias(), shape);
+    graph.Node("Sigmoid");
+  }
+  else if (FusedLinear<TanhFunction>** fused =
+      boost::get<FusedLinear<TanhFunction>*>(&layer))
+  {
+    ExportLinear(graph, (*fused)->Weight(), &(*fused)->Bias(), shape);
+    graph.Node("Tanh");
+  }
+  else if (FusedLinear<RectifierFunction>** fused =
+      boost::get<FusedLinear<RectifierFunction>*>(&layer))
+  {
+    ExportLinear(graph, (*fused)->Weight(), &(*fused)->Bias(), shape);
+    graph.Node("Relu");
+  }
+  else if (Convolution<>** conv = boost::get<Convolution<>*>(&layer))
+  {
+    ExportConvolution(graph, **conv, shape);
+  }
+  else if (MaxPooling<>** pooling = boost::get<MaxPooling<>*>(&layer))
+  {
+    ExportPooling(graph, "MaxPool", **pooling, shape);
+  }
+  else if (MeanPooling<>** pooling = boost::get<MeanPooling<>*>(&layer))
+  {
+    ExportPooling(graph, "AveragePool", **pooling, shape);
+  }
+  else if (BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&layer))
+  {
+    ExportBatchNorm(graph, **batchNorm, shape);
+  }
+  else if (boost::get<SigmoidLayer<>*>(&layer) != NULL)
+  {
+    graph.Node("Sigmoid");
+  }
+  else if (boost::get<TanHLayer<>*>(&layer) != NULL)
+  {
+    graph.Node("Tanh");
+  }
+  else if (boost::get<ReLULayer<>*>(&layer) != NULL)
+  {
+    graph.Node("Relu");
+  }
+  else if (LeakyReLU<>** leakyReLU = boost::get<LeakyReLU<>*>(&layer))
+  {
+    graph.Node("LeakyRelu", {},
+        { GraphWriter::FloatAttribute("alpha", (*leakyReLU)->Alpha()) });
+  }
+  else if (boost::get<Softmax<>*>(&layer) != NULL)
+  {
+    // In opset 11 the points are flattened from the given axis, so the whole
+    // point is normalized, as in mlpack.
+    graph.Node("Softmax", {}, { GraphWriter::IntAttribute("axis", 1) });
+  }
+  else if (boost::get<LogSoftMax<>*>(&layer) != NULL)
+  {
+    graph.Node("LogSoftmax", {}, { GraphWriter::IntAttribute("axis", 1) });
+  }
+  else if (boost::get<Dropout<>*>(&layer) == NULL &&
+           boost::get<IdentityLayer<>*>(&layer) == NULL)
+  {
+    throw std::invalid_argument("onnx::Export(): the " +
+        boost::apply_visitor(LayerNameVisitor(), layer) +
+        " layer is not supported");
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+void Export(FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+                network,
+            const std::string& filename)
+{
+  std::vector<LayerTypes<CustomLayers...> >& model = network.Model();
+  if (model.empty() || network.Parameters().is_empty())
+  {
+    throw std::invalid_argument("onnx::Export(): the network has no layers or "
+        "no parameters");
+  }
+
+  // The shape of the input is given by the first layer.
+  std::vector<size_t> inputShape;
+  if (Linear<>** linear = boost::get<Linear<>*>(&model[0]))
+  {
+    inputShape.push_back((*linear)->InputSize());
+  }
+  else if (Convolution<>** conv = boost::get<Convolution<>*>(&model[0]))
+  {
+    inputShape.push_back((*conv)->InputSize());
+    inputShape.push_back((*conv)->InputHeight());
+    inputShape.push_back((*conv)->InputWidth());
+  }
+  else
+  {
+    throw std::invalid_argument("onnx::Export(): the first layer of the "
+        "network must be a Linear or a Convolution layer");
+  }
+
+  GraphWriter graph;
+  std::vector<size_t> shape = inputShape;
+  for (size_t i = 0; i < model.size(); ++i)
+    ExportLayer(graph, model[i], shape);
+
+  std::ofstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("onnx::Export(): cannot open '" + filename +
+        "' for writing");
+  }
+
+  const std::string buffer = graph.Model(inputShape, shape);
+  stream.write(buffer.data(), buffer.size());
+}
+
+/**
+ * The attributes of a decoded node, by name.
+ */
+class NodeAttributes
+{
+ public:
+  //! Decode the attributes of the given node.
+  explicit NodeAttributes(const ProtoReader& node)
+  {
+    const std::vector<const ProtoField*> fields = node.Fields(5);
+    for (size_t i = 0; i < fields.size(); ++i)
+    {
+      ProtoReader attribute(fields[i]->bytes);
+      attributes.insert(std::make_pair(attribute.Bytes(1), attribute));
+    }
+  }
+
+  //! Get an integer attribute.
+  int64_t Int(const std::string& name, const int64_t defaultValue) const
+  {
+    const ProtoReader* attribute = Find(name);
+    return (attribute == NULL) ? defaultValue : attribute->Int(3);
+  }
+
+  //! Get a float attribute.
+  double Float(const std::string& name, const double defaultValue) const
+  {
+    const ProtoReader* attribute = Find(name);
+    if (attribute == NULL || attribute->Field(2) == NULL)
+      return defaultValue;
+
+    return ProtoReader::ToFloat(attribute->Field(2)->value);
+  }
+
+  //! Get an integer list attribute.
+  std::vector<int64_t> Ints(const std::string& name,
+                            const std::vector<int64_t>& defaultValue) const
+  {
+    const ProtoReader* attribute = Find(name);
+    return (attribute == NULL) ? defaultValue : attribute->Ints(8);
+  }
+
+  //! Get a string attribute.
+  std::string String(const std::string& name,
+                     const std::string& defaultValue) const
+  {
+    const ProtoReader* attribute = Find(name);
+    return (attribute == NULL) ? defaultValue : attribute->Bytes(4);
+  }
+
+ private:
+  //! Find the attribute with the given name, or return NULL.
+  const ProtoReader* Find(const std::string& name) const
+  {
+    std::map<std::string, ProtoReader>::const_iterator it =
+        attributes.find(name);
+    return (it == attributes.end()) ? NULL : &it->second;
+  }
+
+  //! The attributes of the node.
+  std::map<std::string, ProtoReader> attributes;
+};
+
+//! Get the pooling window of the given MaxPool or AveragePool node as
+//! (kernelHeight, kernelWidth, strideHeight, strideWidth, ceil mode).
+inline std::vector<size_t> ImportPooling(const NodeAttributes& attributes,
+                                         const std::vector<size_t>& shape)
+{
+  const std::vector<int64_t> kernel = attributes.Ints("kernel_shape", {});
+  const std::vector<int64_t> strides = attributes.Ints("strides", { 1, 1 });
+  const std::vector<int64_t> pads = attributes.Ints("pads", { 0, 0, 0, 0 });
+  const bool padded = (std::count(pads.begin(), pads.end(), 0) !=
+      (std::ptrdiff_t) pads.size());
+  if (shape.size() != 3 || kernel.size() != 2 || strides.size() != 2 ||
+      padded)
+  {
+    throw std::runtime_error("onnx::Import(): only two dimensional pooling "
+        "without padding is supported");
+  }
+
+  std::vector<size_t> window;
+  window.push_back(kernel[0]);
+  window.push_back(kernel[1]);
+  window.push_back(strides[0]);
+  window.push_back(strides[1]);
+  window.push_back(attributes.Int("ceil_mode", 0));
+  return window;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+void Import(const std::string& filename,
+            FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+                network)
+{
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("onnx::Import(): cannot open '" + filename +
+        "' for reading");
+  }
+
+  const std::string buffer((std::istreambuf_iterator<char>(stream)),
+      std::istreambuf_iterator<char>());
+
+  const ProtoReader model(buffer);
+  const ProtoField* graphField = model.Field(7);
+  if (graphField == NULL)
+    throw std::runtime_error("onnx::Import(): the model has no graph");
+
+  // The default semantics of Softmax and LogSoftmax changed in opset 13.
+  int64_t opsetVersion = 0;
+  const std::vector<const ProtoField*> opsets = model.Fields(8);
+  for (size_t i = 0; i < opsets.size(); ++i)
+  {
+    const ProtoReader opset(opsets[i]->bytes);
+    if (opset.Bytes(1).empty() || opset.Bytes(1) == "ai.onnx")
+      opsetVersion = opset.Int(2);
+  }
+
+  const ProtoReader graph(graphField->bytes);
+  std::map<std::string, Tensor> initializers;
+  const std::vector<const ProtoField*> tensors = graph.Fields(5);
+  for (size_t i = 0; i < tensors.size(); ++i)
+  {
+    const ProtoReader tensor(tensors[i]->bytes);
+    ReadTensor(tensor, initializers[tensor.Bytes(8)]);
+  }
+
+  // Find the input of the graph and the shape of its points: the first
+  // dimension is the batch.
+  std::string current;
+  std::vector<size_t> shape;
+  const std::vector<const ProtoField*> inputs = graph.Fields(11);
+  for (size_t i = 0; i < inputs.size() && current.empty(); ++i)
+  {
+    const ProtoReader valueInfo(inputs[i]->bytes);
+    if (initializers.count(valueInfo.Bytes(1)))
+      continue;
+
+    current = valueInfo.Bytes(1);
+    const ProtoReader type(valueInfo.Bytes(2));
+    const ProtoReader tensorType(type.Bytes(1));
+    const ProtoReader tensorShape(tensorType.Bytes(2));
+    const std::vector<const ProtoField*> dims = tensorShape.Fields(1);
+    for (size_t d = 1; d < dims.size(); ++d)
+    {
+      const ProtoReader dim(dims[d]->bytes);
+      if (dim.Field(1) == NULL)
+      {
+        shape.clear();
+        break;
+      }
+
+      shape.push_back(dim.Int(1));
+    }
+  }
+
+  if (current.empty())
+    throw std::runtime_error("onnx::Import(): the graph has no input");
+
+  // The weights are set once the parameters of the network are allocated.
+  std::vector<std::function<void()> > setWeights;
+  const std::vector<const ProtoField*> nodes = graph.Fields(1);
+  for (size_t n = 0; n < nodes.size(); ++n)
+  {
+    const ProtoReader node(nodes[n]->bytes);
+    const std::string opType = node.Bytes(4);
+    const NodeAttributes attributes(node);
+
+    const std::vector<const ProtoField*> nodeInputs = node.Fields(1);
+    const std::vector<const ProtoField*> nodeOutputs = node.Fields(2);
+    if (nodeInputs.empty() || nodeInputs[0]->bytes != current ||
+        nodeOutputs.empty())
+    {
+      throw std::runtime_error("onnx::Import(): only sequential graphs are "
+          "supported");
+    }
+
+    // The other inputs of the node must be initializers.
+    std::vector<const Tensor*> parameters;
+    for (size_t i = 1; i < nodeInputs.size(); ++i)
+    {
+      if (nodeInputs[i]->bytes.empty())
+        continue;
+
+      std::map<std::string, Tensor>::const_iterator it =
+          initializers.find(nodeInputs[i]->bytes);
+      if (it == initializers.end())
+      {
+        throw std::runtime_error("onnx::Import(): the input '" +
+            nodeInputs[i]->bytes + "' of the " + opType + " node isn't an "
+            "initializer");
+      }
+
+      parameters.push_back(&it->second);
+    }
+
+    if (opType == "Gemm" || opType == "MatMul")
+    {
+      const bool transB = attributes.Int("transB", 0);
+      const double alpha = attributes.Float("alpha", 1.0);
+      const double beta = attributes.Float("beta", 1.0);
+      if (parameters.empty() || parameters[0]->dims.size() != 2 ||
+          attributes.Int("transA", 0) != 0)
+      {
+        throw std::runtime_error("onnx::Import(): unsupported " + opType +
+            " node");
+      }
+
+      const size_t inSize = parameters[0]->dims[transB ? 1 : 0];
+      const size_t outSize = parameters[0]->dims[transB ? 0 : 1];
+      if (!shape.empty() && ShapeSize(shape) != inSize)
+      {
+        throw std::runtime_error("onnx::Import(): the size of the weights of "
+            "a " + opType + " node doesn't match its input");
+      }
+
+      // The row-major (inSize, outSize) matrix B is the column-major
+      // (outSize, inSize) weight of a Linear layer.
+      arma::mat weight = transB ?
+          arma::mat(arma::trans(arma::reshape(parameters[0]->data, inSize,
+          outSize))) : arma::mat(arma::reshape(parameters[0]->data, outSize,
+          inSize));
+      weight *= alpha;
+
+      if (opType == "MatMul")
+      {
+        LinearNoBias<>* layer = new LinearNoBias<>(inSize, outSize);
+        network.Add(layer);
+        setWeights.push_back([layer, weight]()
+            { layer->Parameters() = arma::vectorise(weight); });
+      }
+      else
+      {
+        arma::vec bias(outSize, arma::fill::zeros);
+        if (parameters.size() > 1)
+        {
+          if (parameters[1]->data.n_elem == 1)
+            bias.fill(beta * parameters[1]->data[0]);
+          else if (parameters[1]->data.n_elem == outSize)
+            bias = beta * parameters[1]->data;
+          else
+            throw std::runtime_error("onnx::Import(): unsupported Gemm bias");
+        }
+
+        Linear<>* layer = new Linear<>(inSize, outSize);
+        network.Add(layer);
+        setWeights.push_back([layer, weight, bias]()
+            {
+              layer->Weight() = weight;
+              layer->Bias() = bias;
+            });
+      }
+
+      shape = std::vector<size_t>(1, outSize);
+    }
+    else if (opType == "Conv")
+    {
+      if (parameters.empty() || parameters[0]->dims.size() != 4 ||
+          shape.size() != 3 || (size_t) parameters[0]->dims[1] != shape[0])
+      {
+        throw std::runtime_error("onnx::Import(): unsupported Conv node; the "
+            "shape of the input of the graph must be known");
+      }
+
+      const std::vector<int64_t> strides = attributes.Ints("strides",
+          { 1, 1 });
+      const std::vector<int64_t> pads = attributes.Ints("pads",
+          { 0, 0, 0, 0 });
+      const std::vector<int64_t> dilations = attributes.Ints("dilations",
+          { 1, 1 });
+      const std::string autoPad = attributes.String("auto_pad", "NOTSET");
+      if (strides.size() != 2 || pads.size() != 4 || dilations.size() != 2 ||
+          dilations[0] != 1 || dilations[1] != 1 ||
+          attributes.Int("group", 1) != 1 || autoPad != "NOTSET")
+      {
+        throw std::runtime_error("onnx::Import(): only two dimensional, "
+            "ungrouped and undilated Conv nodes with explicit padding are "
+            "supported");
+      }
+
+      const size_t outSize = parameters[0]->dims[0];
+      const size_t inSize = parameters[0]->dims[1];
+      const size_t kernelHeight = parameters[0]->dims[2];
+      const size_t kernelWidth = parameters[0]->dims[3];
+      Convolution<>* layer = new Convolution<>(inSize, outSize, kernelWidth,
+          kernelHeight, strides[1], strides[0],
+          std::tuple<size_t, size_t>(pads[1], pads[3]),
+          std::tuple<size_t, size_t>(pads[0], pads[2]), shape[2], shape[1]);
+      network.Add(layer);
+
+      const arma::vec weight = parameters[0]->data;
+      const arma::vec bias = (parameters.size() > 1) ? parameters[1]->data :
+          arma::vec(outSize, arma::fill::zeros);
+      setWeights.push_back([layer, weight, bias, kernelWidth, kernelHeight,
+          inSize, outSize]()
+          {
+            layer->Weight() = arma::cube(weight.memptr(), kernelWidth,
+                kernelHeight, inSize * outSize);
+            layer->Bias() = bias;
+          });
+
+      shape[0] = outSize;
+      shape[1] = (shape[1] + pads[0] + pads[2] - kernelHeight) / strides[0] +
+          1;
+      shape[2] = (shape[2] + pads[1] + pads[3] - kernelWidth) / strides[1] + 1;
+    }
+    else if (opType == "MaxPool" || opType == "AveragePool")
+    {
+      const std::vector<size_t> window = ImportPooling(attributes, shape);
+      if (opType == "MaxPool")
+      {
+        network.template Add<MaxPooling<> >(window[1], window[0], window[3],
+            window[2], window[4] == 0);
+      }
+      else
+      {
+        network.template Add<MeanPooling<> >(window[1], window[0], window[3],
+            window[2], window[4] == 0);
+      }
+
+      const double height = (shape[1] - (double) window[0]) / window[2] + 1;
+      const double width = (shape[2] - (double) window[1]) / window[3] + 1;
+      shape[1] = (window[4] == 0) ? std::floor(height) : std::ceil(height);
+      shape[2] = (window[4] == 0) ? std::floor(width) : std::ceil(width);
+    }
+    else if (opType == "BatchNormalization")
+    {
+      if (parameters.size() != 4)
+      {
+        throw std::runtime_error("onnx::Import(): BatchNormalization nodes "
+            "need their scale, bias, mean and variance");
+      }
+
+      const size_t size = parameters[0]->data.n_elem;
+      BatchNorm<>* layer = new BatchNorm<>(size,
+          attributes.Float("epsilon", 1e-5));
+      network.Add(layer);
+
+      const arma::vec scale = parameters[0]->data;
+      const arma::vec bias = parameters[1]->data;
+      const arma::vec mean = parameters[2]->data;
+      const arma::vec variance = parameters[3]->data;
+      setWeights.push_back([layer, scale, bias, mean, variance, size]()
+          {
+            layer->Parameters().rows(0, size - 1) = scale;
+            layer->Parameters().rows(size, 2 * size - 1) = bias;
+            layer->TrainingMean() = mean;
+            layer->TrainingVariance() = variance;
+          });
+    }
+    else if (opType == "Relu")
+    {
+      network.template Add<ReLULayer<> >();
+    }
+    else if (opType == "Sigmoid")
+    {
+      network.template Add<SigmoidLayer<> >();
+    }
+    else if (opType == "Tanh")
+    {
+      network.template Add<TanHLayer<> >();
+    }
+    else if (opType == "LeakyRelu")
+    {
+      network.template Add<LeakyReLU<> >(attributes.Float("alpha", 0.01));
+    }
+    else if (opType == "Softmax" || opType == "LogSoftmax")
+    {
+      // mlpack normalizes whole points, which is what opset 11 does with the
+      // axis 1; for vectors any axis is the same.
+      const int64_t axis = attributes.Int("axis",
+          (opsetVersion >= 13) ? -1 : 1);
+      if (shape.size() > 1 && (axis != 1 || opsetVersion >= 13))
+      {
+        throw std::runtime_error("onnx::Import(): " + opType + " is only "
+            "supported over whole points");
+      }
+
+      if (opType == "Softmax")
+        network.template Add<Softmax<> >();
+      else
+        network.template Add<LogSoftMax<> >();
+    }
+    else if (opType == "Flatten")
+    {
+      if (attributes.Int("axis", 1) != 1)
+        throw std::runtime_error("onnx::Import(): Flatten must keep the batch");
+
+      if (!shape.empty())
+        shape = std::vector<size_t>(1, ShapeSize(shape));
+    }
+    else if (opType == "Reshape")
+    {
+      if (parameters.size() != 1 || parameters[0]->data.n_elem < 2 ||
+          (parameters[0]->data[0] != -1 && parameters[0]->data[0] != 0))
+      {
+        throw std::runtime_error("onnx::Import(): Reshape must keep the batch");
+      }
+
+      // Compute the dimension that is left to be inferred, if any.
+      std::vector<size_t> newShape;
+      size_t inferred = parameters[0]->data.n_elem;
+      for (size_t i = 1; i < parameters[0]->data.n_elem; ++i)
+      {
+        if (parameters[0]->data[i] == -1)
+        {
+          inferred = i - 1;
+          newShape.push_back(1);
+        }
+        else
+        {
+          newShape.push_back((size_t) parameters[0]->data[i]);
+        }
+      }
+
+      if (inferred < newShape.size())
+      {
+        if (shape.empty())
+          throw std::runtime_error("onnx::Import(): cannot infer the shape");
+
+        newShape[inferred] = ShapeSize(shape) / ShapeSize(newShape);
+      }
+
+      if (!shape.empty() && ShapeSize(shape) != ShapeSize(newShape))
+        throw std::runtime_error("onnx::Import(): invalid Reshape node");
+
+      shape = newShape;
+    }
+    else if (opType != "Dropout" && opType != "Identity")
+    {
+      throw std::runtime_error("onnx::Import(): the " + opType + " operator "
+          "is not supported");
+    }
+
+    current = nodeOutputs[0]->bytes;
+  }
+
+  network.ResetParameters();
+  for (size_t i = 0; i < setWeights.size(); ++i)
+    setWeights[i]();
+}
+
+} // namespace onnx
+} // namespace ann
+} // namespace mlpack
+
+#endif
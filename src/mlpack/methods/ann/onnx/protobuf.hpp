@@ -0,0 +1,278 @@
+/**
+ * @file methods/ann/onnx/protobuf.hpp
+ *
+ * Definition of the ProtoWriter and ProtoReader classes, a minimal encoder and
+ * decoder of the protocol buffers wire format, used to read and write ONNX
+ * models without depending on the protobuf library.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ONNX_PROTOBUF_HPP
+#define MLPACK_METHODS_ANN_ONNX_PROTOBUF_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+namespace onnx /** Reading and writing of ONNX models. */ {
+
+/**
+ * A writer of one protocol buffers message.  The fields are appended in the
+ * order they are written, and nested messages are written as the buffer of
+ * another ProtoWriter.
+ */
+class ProtoWriter
+{
+ public:
+  //! Write an integer (varint) field.
+  void Int(const size_t field, const int64_t value)
+  {
+    Key(field, 0);
+    Varint((uint64_t) value);
+  }
+
+  //! Write a float (fixed32) field.
+  void Float(const size_t field, const float value)
+  {
+    Key(field, 5);
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    for (size_t i = 0; i < 4; ++i)
+      buffer.push_back((char) ((bits >> (8 * i)) & 0xFF));
+  }
+
+  //! Write a string or bytes field.
+  void Bytes(const size_t field, const std::string& value)
+  {
+    Key(field, 2);
+    Varint(value.size());
+    buffer += value;
+  }
+
+  //! Write a nested message field.
+  void Message(const size_t field, const ProtoWriter& message)
+  {
+    Bytes(field, message.Buffer());
+  }
+
+  //! Write a repeated integer field, one value at a time.
+  void Ints(const size_t field, const std::vector<int64_t>& values)
+  {
+    for (size_t i = 0; i < values.size(); ++i)
+      Int(field, values[i]);
+  }
+
+  //! Get the encoded message.
+  const std::string& Buffer() const { return buffer; }
+
+ private:
+  //! Write the key of a field.
+  void Key(const size_t field, const size_t wireType)
+  {
+    Varint((field << 3) | wireType);
+  }
+
+  //! Write a base 128 varint.
+  void Varint(uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      buffer.push_back((char) ((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    buffer.push_back((char) value);
+  }
+
+  //! The encoded message.
+  std::string buffer;
+};
+
+/**
+ * One field of a decoded message: the value of varint and fixed-size fields is
+ * held in value, and the content of length-delimited fields in bytes.
+ */
+struct ProtoField
+{
+  //! The field number.
+  size_t number;
+  //! The wire type of the field.
+  size_t wireType;
+  //! The value of a varint, fixed64 or fixed32 field.
+  uint64_t value;
+  //! The content of a length-delimited field.
+  std::string bytes;
+};
+
+/**
+ * A reader of one protocol buffers message.  The whole message is decoded on
+ * construction; nested messages are read by constructing another ProtoReader
+ * from the bytes of their field.  A std::runtime_error is thrown if the
+ * message is malformed.
+ */
+class ProtoReader
+{
+ public:
+  /**
+   * Decode the given message.
+   *
+   * @param buffer The encoded message.
+   */
+  explicit ProtoReader(const std::string& buffer)
+  {
+    size_t position = 0;
+    while (position < buffer.size())
+    {
+      ProtoField field;
+      const uint64_t key = Varint(buffer, position);
+      field.number = key >> 3;
+      field.wireType = key & 0x7;
+      field.value = 0;
+
+      if (field.wireType == 0)
+      {
+        field.value = Varint(buffer, position);
+      }
+      else if (field.wireType == 1 || field.wireType == 5)
+      {
+        const size_t bytes = (field.wireType == 1) ? 8 : 4;
+        if (position + bytes > buffer.size())
+          throw std::runtime_error("ProtoReader: truncated message");
+
+        for (size_t i = 0; i < bytes; ++i)
+        {
+          field.value |= uint64_t((unsigned char) buffer[position + i]) <<
+              (8 * i);
+        }
+        position += bytes;
+      }
+      else if (field.wireType == 2)
+      {
+        const uint64_t length = Varint(buffer, position);
+        if (length > buffer.size() - position)
+          throw std::runtime_error("ProtoReader: truncated message");
+
+        field.bytes = buffer.substr(position, length);
+        position += length;
+      }
+      else
+      {
+        throw std::runtime_error("ProtoReader: unsupported wire type");
+      }
+
+      fields.push_back(field);
+    }
+  }
+
+  //! Get all the occurrences of the given field, in order.
+  std::vector<const ProtoField*> Fields(const size_t number) const
+  {
+    std::vector<const ProtoField*> result;
+    for (size_t i = 0; i < fields.size(); ++i)
+    {
+      if (fields[i].number == number)
+        result.push_back(&fields[i]);
+    }
+
+    return result;
+  }
+
+  //! Get the last occurrence of the given field, or NULL if it isn't set.
+  const ProtoField* Field(const size_t number) const
+  {
+    for (size_t i = fields.size(); i-- > 0;)
+    {
+      if (fields[i].number == number)
+        return &fields[i];
+    }
+
+    return NULL;
+  }
+
+  //! Get the value of the given integer field, or the given default value if
+  //! it isn't set.
+  int64_t Int(const size_t number, const int64_t defaultValue = 0) const
+  {
+    const ProtoField* field = Field(number);
+    return (field == NULL) ? defaultValue : (int64_t) field->value;
+  }
+
+  //! Get the value of the given string field, or an empty string if it isn't
+  //! set.
+  std::string Bytes(const size_t number) const
+  {
+    const ProtoField* field = Field(number);
+    return (field == NULL) ? std::string() : field->bytes;
+  }
+
+  //! Get all the values of the given repeated integer field, packed or not.
+  std::vector<int64_t> Ints(const size_t number) const
+  {
+    std::vector<int64_t> result;
+    for (size_t i = 0; i < fields.size(); ++i)
+    {
+      if (fields[i].number != number)
+        continue;
+
+      if (fields[i].wireType == 2)
+      {
+        size_t position = 0;
+        while (position < fields[i].bytes.size())
+          result.push_back((int64_t) Varint(fields[i].bytes, position));
+      }
+      else
+      {
+        result.push_back((int64_t) fields[i].value);
+      }
+    }
+
+    return result;
+  }
+
+  //! Interpret the value of a fixed32 field as a float.
+  static float ToFloat(const uint64_t value)
+  {
+    const uint32_t bits = (uint32_t) value;
+    float result;
+    std::memcpy(&result, &bits, sizeof(float));
+    return result;
+  }
+
+  //! Interpret the value of a fixed64 field as a double.
+  static double ToDouble(const uint64_t value)
+  {
+    double result;
+    std::memcpy(&result, &value, sizeof(double));
+    return result;
+  }
+
+ private:
+  //! Read a base 128 varint at the given position, and move past it.
+  static uint64_t Varint(const std::string& buffer, size_t& position)
+  {
+    uint64_t value = 0;
+    for (size_t shift = 0; shift < 64; shift += 7)
+    {
+      if (position >= buffer.size())
+        throw std::runtime_error("ProtoReader: truncated message");
+
+      const unsigned char byte = buffer[position++];
+      value |= uint64_t(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+
+    throw std::runtime_error("ProtoReader: malformed varint");
+  }
+
+  //! The fields of the message, in order.
+  std::vector<ProtoField> fields;
+};
+
+} // namespace onnx
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file methods/ann/quantization/quantized_ffn.hpp
+ *
+ * Definition of the QuantizedFFN class, an inference-only int8 version of a
+ * trained feed forward network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZED_FFN_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZED_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/visitor/copy_visitor.hpp>
+#include <mlpack/methods/ann/visitor/delete_visitor.hpp>
+#include <mlpack/methods/ann/visitor/output_parameter_visitor.hpp>
+#include <mlpack/methods/ann/visitor/weight_size_visitor.hpp>
+
+#include "quantized_layer.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A post-training int8 quantization of a feed forward network, for inference.
+ * The Linear, LinearNoBias and Convolution layers of the network are replaced
+ * by QuantizedLayer objects, which compute their products in 8-bit integers;
+ * the scale of the input of each of them is calibrated by running the network
+ * on a sample dataset.  The other layers (activations, pooling, dropout,
+ * softmax...) are copied as they are, and run in double precision between the
+ * quantized layers.  The model can be saved and loaded with data::Save() and
+ * data::Load(), separately from the network; the quantized weights take an
+ * eighth of the memory of the original weights.
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<> > model;
+ * // ... build and train the model ...
+ *
+ * QuantizedFFN<> quantizedModel(model, calibrationData);
+ * quantizedModel.Predict(testData, predictions);
+ * data::Save("model.bin", "model", quantizedModel);
+ * @endcode
+ *
+ * Layers with weights other than Linear, LinearNoBias and Convolution are not
+ * supported, and layers that hold other layers are not looked into.
+ *
+ * @tparam CustomLayers Any set of custom layers of the network.
+ */
+template<typename... CustomLayers>
+class QuantizedFFN
+{
+ public:
+  //! Create an empty network, to be loaded.
+  QuantizedFFN();
+
+  /**
+   * Quantize the given trained network, calibrating the range of the input of
+   * each quantized layer on the given data.  The calibration data should be
+   * representative of the data the network will be used on; a few hundred
+   * points are usually enough.
+   *
+   * @param network The trained network.
+   * @param calibrationData The points to calibrate the quantization with.
+   * @param batchSize Number of points to forward through the network at once
+   *     during calibration.
+   */
+  template<typename OutputLayerType, typename InitializationRuleType>
+  QuantizedFFN(FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+                   network,
+               const arma::mat& calibrationData,
+               const size_t batchSize = 256);
+
+  //! Copy constructor.
+  QuantizedFFN(const QuantizedFFN& other);
+
+  //! Move constructor.
+  QuantizedFFN(QuantizedFFN&& other);
+
+  //! Copy/move assignment operator.
+  QuantizedFFN& operator=(QuantizedFFN other);
+
+  //! Destroy the network and its layers.
+  ~QuantizedFFN();
+
+  /**
+   * Predict the responses to a given set of predictors, forwarding batchSize
+   * points through the network at once.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               const size_t batchSize = 256);
+
+  //! Get the number of layers of the network.
+  size_t NumLayers() const { return quantized.size(); }
+
+  //! Get the quantized layers of the network, in order.
+  const std::vector<QuantizedLayer>& QuantizedLayers() const
+  {
+    return quantizedLayers;
+  }
+
+  //! Serialize the network.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Swap the content of this network with the given network.
+  void Swap(QuantizedFFN& other);
+
+  //! Set the layers that are not quantized to deterministic mode.
+  void ResetDeterministic();
+
+  //! Whether each layer of the network is quantized.
+  std::vector<bool> quantized;
+
+  //! The quantized layers, in order.
+  std::vector<QuantizedLayer> quantizedLayers;
+
+  //! The layers that are not quantized, in order.
+  std::vector<LayerTypes<CustomLayers...> > floatLayers;
+
+  //! Locally-stored copy visitor.
+  CopyVisitor<CustomLayers...> copyVisitor;
+
+  //! Locally-stored delete visitor.
+  DeleteVisitor deleteVisitor;
+
+  //! Locally-stored output parameter visitor.
+  OutputParameterVisitor outputParameterVisitor;
+}; // class QuantizedFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_ffn_impl.hpp"
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * @file methods/ann/quantization/quantized_ffn_impl.hpp
+ *
+ * Implementation of the QuantizedFFN class, an inference-only int8 version of
+ * a trained feed forward network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZED_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZED_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_ffn.hpp"
+
+#include <mlpack/methods/ann/visitor/deterministic_set_visitor.hpp>
+#include <mlpack/methods/ann/visitor/forward_visitor.hpp>
+
+#include <boost/serialization/variant.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>::QuantizedFFN()
+{
+  /* Nothing to do here. */
+}
+
+template<typename... CustomLayers>
+template<typename OutputLayerType, typename InitializationRuleType>
+QuantizedFFN<CustomLayers...>::QuantizedFFN(
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& network,
+    const arma::mat& calibrationData,
+    const size_t batchSize)
+{
+  if (calibrationData.n_cols == 0 || batchSize == 0)
+  {
+    throw std::invalid_argument("QuantizedFFN(): the calibration data and the "
+        "batch size must not be empty");
+  }
+
+  std::vector<LayerTypes<CustomLayers...> >& model = network.Model();
+
+  // Find the layers to quantize.
+  WeightSizeVisitor weightSizeVisitor;
+  quantized.resize(model.size());
+  for (size_t i = 0; i < model.size(); ++i)
+  {
+    quantized[i] = (boost::get<Linear<>*>(&model[i]) != NULL) ||
+        (boost::get<LinearNoBias<>*>(&model[i]) != NULL) ||
+        (boost::get<Convolution<>*>(&model[i]) != NULL);
+
+    if (!quantized[i] &&
+        boost::apply_visitor(weightSizeVisitor, model[i]) != 0)
+    {
+      throw std::invalid_argument("QuantizedFFN(): only the Linear, "
+          "LinearNoBias and Convolution layers can have weights");
+    }
+  }
+
+  // One prediction sets the shapes of the layers and their deterministic mode.
+  arma::mat output;
+  network.Predict(calibrationData.col(0), output, 1);
+
+  // Record the largest absolute input of each layer on the calibration data.
+  std::vector<double> ranges(model.size(), 0.0);
+  for (size_t begin = 0; begin < calibrationData.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize,
+        (size_t) calibrationData.n_cols) - 1;
+    const arma::mat input(const_cast<double*>(calibrationData.colptr(begin)),
+        calibrationData.n_rows, end - begin + 1, false, true);
+
+    const arma::mat* layerInput = &input;
+    for (size_t i = 0; i < model.size(); ++i)
+    {
+      if (quantized[i])
+        ranges[i] = std::max(ranges[i], arma::abs(*layerInput).max());
+
+      arma::mat& layerOutput = boost::apply_visitor(outputParameterVisitor,
+          model[i]);
+      boost::apply_visitor(ForwardVisitor(*layerInput, layerOutput),
+          model[i]);
+      layerInput = &layerOutput;
+    }
+  }
+
+  for (size_t i = 0; i < model.size(); ++i)
+  {
+    if (Linear<>** layer = boost::get<Linear<>*>(&model[i]))
+      quantizedLayers.push_back(QuantizedLayer(**layer, ranges[i]));
+    else if (LinearNoBias<>** layer = boost::get<LinearNoBias<>*>(&model[i]))
+      quantizedLayers.push_back(QuantizedLayer(**layer, ranges[i]));
+    else if (Convolution<>** layer = boost::get<Convolution<>*>(&model[i]))
+      quantizedLayers.push_back(QuantizedLayer(**layer, ranges[i]));
+    else
+      floatLayers.push_back(boost::apply_visitor(copyVisitor, model[i]));
+  }
+
+  ResetDeterministic();
+}
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>::QuantizedFFN(const QuantizedFFN& other) :
+    quantized(other.quantized),
+    quantizedLayers(other.quantizedLayers)
+{
+  for (size_t i = 0; i < other.floatLayers.size(); ++i)
+  {
+    floatLayers.push_back(boost::apply_visitor(copyVisitor,
+        other.floatLayers[i]));
+  }
+}
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>::QuantizedFFN(QuantizedFFN&& other) :
+    quantized(std::move(other.quantized)),
+    quantizedLayers(std::move(other.quantizedLayers)),
+    floatLayers(std::move(other.floatLayers))
+{
+  /* Nothing to do here. */
+}
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>& QuantizedFFN<CustomLayers...>::operator=(
+    QuantizedFFN other)
+{
+  Swap(other);
+  return *this;
+}
+
+template<typename... CustomLayers>
+QuantizedFFN<CustomLayers...>::~QuantizedFFN()
+{
+  std::for_each(floatLayers.begin(), floatLayers.end(),
+      boost::apply_visitor(deleteVisitor));
+}
+
+template<typename... CustomLayers>
+void QuantizedFFN<CustomLayers...>::Predict(const arma::mat& predictors,
+                                            arma::mat& results,
+                                            const size_t batchSize)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("QuantizedFFN::Predict(): the batch size must "
+        "be greater than 0");
+  }
+
+  if (predictors.n_cols == 0 || quantized.empty())
+  {
+    results.reset();
+    return;
+  }
+
+  // The outputs of the quantized layers alternate between two buffers, so that
+  // a layer never writes into its input.
+  arma::mat buffers[2];
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - begin);
+    const arma::mat input(const_cast<double*>(predictors.colptr(begin)),
+        predictors.n_rows, effectiveBatchSize, false, true);
+
+    const arma::mat* layerInput = &input;
+    size_t buffer = 0;
+    for (size_t i = 0, q = 0, f = 0; i < quantized.size(); ++i)
+    {
+      if (quantized[i])
+      {
+        quantizedLayers[q++].Forward(*layerInput, buffers[buffer]);
+        layerInput = &buffers[buffer];
+        buffer = 1 - buffer;
+      }
+      else
+      {
+        arma::mat& layerOutput = boost::apply_visitor(outputParameterVisitor,
+            floatLayers[f]);
+        boost::apply_visitor(ForwardVisitor(*layerInput, layerOutput),
+            floatLayers[f++]);
+        layerInput = &layerOutput;
+      }
+    }
+
+    if (begin == 0)
+      results.set_size(layerInput->n_rows, predictors.n_cols);
+
+    results.cols(begin, begin + effectiveBatchSize - 1) = *layerInput;
+  }
+}
+
+template<typename... CustomLayers>
+template<typename Archive>
+void QuantizedFFN<CustomLayers...>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  // Be sure to clear the other layers before loading.
+  if (Archive::is_loading::value)
+  {
+    std::for_each(floatLayers.begin(), floatLayers.end(),
+        boost::apply_visitor(deleteVisitor));
+    floatLayers.clear();
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(quantized);
+  ar & BOOST_SERIALIZATION_NVP(quantizedLayers);
+  ar & BOOST_SERIALIZATION_NVP(floatLayers);
+
+  if (Archive::is_loading::value)
+    ResetDeterministic();
+}
+
+template<typename... CustomLayers>
+void QuantizedFFN<CustomLayers...>::Swap(QuantizedFFN& other)
+{
+  std::swap(quantized, other.quantized);
+  std::swap(quantizedLayers, other.quantizedLayers);
+  std::swap(floatLayers, other.floatLayers);
+}
+
+template<typename... CustomLayers>
+void QuantizedFFN<CustomLayers...>::ResetDeterministic()
+{
+  DeterministicSetVisitor deterministicSetVisitor(true);
+  std::for_each(floatLayers.begin(), floatLayers.end(),
+      boost::apply_visitor(deterministicSetVisitor));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,308 @@
+/**
+ * @file methods/ann/quantization/quantized_layer.hpp
+ *
+ * Definition of the QuantizedLayer class, an inference-only int8 version of
+ * the Linear, LinearNoBias and Convolution layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZED_LAYER_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZED_LAYER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An int8 version of a trained Linear, LinearNoBias or Convolution layer, for
+ * inference only.  The weights of each output map are quantized symmetrically
+ * to [-127, 127] with their own scale, and the input is quantized with a
+ * single scale, which is computed from the range of the inputs of the layer
+ * on a calibration dataset (inputs outside of that range are clipped).  The
+ * products are accumulated in 32-bit integers, and the results are scaled
+ * back to double precision and the (unquantized) bias is added.
+ *
+ * A Linear layer is handled as a convolution of a 1x1 input with InputSize()
+ * maps by 1x1 filters, so all three layers share the same kernel: the patches
+ * of the quantized input are unrolled into the columns of a matrix, and each
+ * output element is the dot product of a patch and the weights of one output
+ * map.
+ */
+class QuantizedLayer
+{
+ public:
+  //! Create an empty layer, to be loaded.
+  QuantizedLayer() :
+      inSize(0),
+      outSize(0),
+      kernelWidth(1),
+      kernelHeight(1),
+      strideWidth(1),
+      strideHeight(1),
+      padWLeft(0),
+      padWRight(0),
+      padHTop(0),
+      padHBottom(0),
+      inputWidth(1),
+      inputHeight(1),
+      outputWidth(1),
+      outputHeight(1),
+      inputScale(1.0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Quantize the given Linear layer.
+   *
+   * @param layer The trained layer.
+   * @param inputRange The largest absolute value of the inputs of the layer.
+   */
+  QuantizedLayer(const Linear<>& layer, const double inputRange) :
+      QuantizedLayer()
+  {
+    inSize = layer.InputSize();
+    outSize = layer.OutputSize();
+    QuantizeWeights(arma::mat(layer.Weight().t()), inputRange);
+    bias = arma::vectorise(layer.Bias());
+  }
+
+  /**
+   * Quantize the given LinearNoBias layer.
+   *
+   * @param layer The trained layer.
+   * @param inputRange The largest absolute value of the inputs of the layer.
+   */
+  QuantizedLayer(const LinearNoBias<>& layer, const double inputRange) :
+      QuantizedLayer()
+  {
+    inSize = layer.InputSize();
+    outSize = layer.OutputSize();
+    const arma::mat weight(const_cast<double*>(layer.Parameters().memptr()),
+        outSize, inSize, false, true);
+    QuantizeWeights(arma::mat(weight.t()), inputRange);
+    bias.zeros(outSize);
+  }
+
+  /**
+   * Quantize the given Convolution layer.  The input size of the layer must
+   * already be known (it is set by the first forward pass of the network).
+   *
+   * @param layer The trained layer.
+   * @param inputRange The largest absolute value of the inputs of the layer.
+   */
+  QuantizedLayer(const Convolution<>& layer, const double inputRange) :
+      inSize(layer.InputSize()),
+      outSize(layer.OutputSize()),
+      kernelWidth(layer.KernelWidth()),
+      kernelHeight(layer.KernelHeight()),
+      strideWidth(layer.StrideWidth()),
+      strideHeight(layer.StrideHeight()),
+      padWLeft(layer.PadWLeft()),
+      padWRight(layer.PadWRight()),
+      padHTop(layer.PadHTop()),
+      padHBottom(layer.PadHBottom()),
+      inputWidth(layer.InputWidth()),
+      inputHeight(layer.InputHeight()),
+      outputWidth((inputWidth + padWLeft + padWRight - kernelWidth) /
+          strideWidth + 1),
+      outputHeight((inputHeight + padHTop + padHBottom - kernelHeight) /
+          strideHeight + 1)
+  {
+    // The filters of output map o are the slices o * inSize to
+    // (o + 1) * inSize - 1, so they are one column of the memory of the
+    // weights.
+    const arma::cube& weight = layer.Weight();
+    const arma::mat weightMat(const_cast<double*>(weight.memptr()),
+        kernelWidth * kernelHeight * inSize, outSize, false, true);
+    QuantizeWeights(weightMat, inputRange);
+    bias = arma::vectorise(layer.Bias());
+  }
+
+  /**
+   * Compute the output of the layer for the given points (one per column).
+   *
+   * @param input The input points.
+   * @param output The output of the layer for each point.
+   */
+  void Forward(const arma::mat& input, arma::mat& output) const
+  {
+    const size_t paddedWidth = inputWidth + padWLeft + padWRight;
+    const size_t paddedHeight = inputHeight + padHTop + padHBottom;
+    const size_t positions = outputWidth * outputHeight;
+    const size_t patchSize = kernelWidth * kernelHeight * inSize;
+
+    output.set_size(positions * outSize, input.n_cols);
+    arma::Mat<arma::s8> padded(paddedWidth, paddedHeight * inSize,
+        arma::fill::zeros);
+    arma::Mat<arma::s8> patches(patchSize, positions);
+    for (size_t c = 0; c < input.n_cols; ++c)
+    {
+      // Quantize the input maps into the padded buffer.
+      const double* inputPtr = input.colptr(c);
+      for (size_t m = 0; m < inSize; ++m)
+      {
+        for (size_t y = 0; y < inputHeight; ++y)
+        {
+          arma::s8* paddedPtr = padded.colptr(m * paddedHeight + y + padHTop) +
+              padWLeft;
+          for (size_t x = 0; x < inputWidth; ++x)
+            paddedPtr[x] = Quantize(*inputPtr++);
+        }
+      }
+
+      // Unroll the patches of each output position.
+      arma::s8* patchPtr = patches.memptr();
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        for (size_t i = 0; i < outputWidth; ++i)
+        {
+          for (size_t m = 0; m < inSize; ++m)
+          {
+            for (size_t kj = 0; kj < kernelHeight; ++kj)
+            {
+              const arma::s8* paddedPtr = padded.colptr(m * paddedHeight +
+                  j * strideHeight + kj) + i * strideWidth;
+              for (size_t ki = 0; ki < kernelWidth; ++ki)
+                *patchPtr++ = paddedPtr[ki];
+            }
+          }
+        }
+      }
+
+      double* outputPtr = output.colptr(c);
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        const arma::s8* weightPtr = weights.colptr(o);
+        const double scale = inputScale * weightScales[o];
+        for (size_t p = 0; p < positions; ++p)
+        {
+          *outputPtr++ = scale * Dot(weightPtr, patches.colptr(p), patchSize) +
+              bias[o];
+        }
+      }
+    }
+  }
+
+  //! Get the number of input maps (or the number of inputs of a Linear layer).
+  size_t InputSize() const { return inSize; }
+  //! Get the number of output maps (or the number of outputs of a Linear
+  //! layer).
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the quantized weights; column o holds the weights of output map o.
+  const arma::Mat<arma::s8>& Weights() const { return weights; }
+  //! Get the scale of the weights of each output map.
+  const arma::vec& WeightScales() const { return weightScales; }
+  //! Get the scale of the input.
+  double InputScale() const { return inputScale; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(inSize);
+    ar & BOOST_SERIALIZATION_NVP(outSize);
+    ar & BOOST_SERIALIZATION_NVP(kernelWidth);
+    ar & BOOST_SERIALIZATION_NVP(kernelHeight);
+    ar & BOOST_SERIALIZATION_NVP(strideWidth);
+    ar & BOOST_SERIALIZATION_NVP(strideHeight);
+    ar & BOOST_SERIALIZATION_NVP(padWLeft);
+    ar & BOOST_SERIALIZATION_NVP(padWRight);
+    ar & BOOST_SERIALIZATION_NVP(padHTop);
+    ar & BOOST_SERIALIZATION_NVP(padHBottom);
+    ar & BOOST_SERIALIZATION_NVP(inputWidth);
+    ar & BOOST_SERIALIZATION_NVP(inputHeight);
+    ar & BOOST_SERIALIZATION_NVP(outputWidth);
+    ar & BOOST_SERIALIZATION_NVP(outputHeight);
+    ar & BOOST_SERIALIZATION_NVP(weights);
+    ar & BOOST_SERIALIZATION_NVP(weightScales);
+    ar & BOOST_SERIALIZATION_NVP(bias);
+    ar & BOOST_SERIALIZATION_NVP(inputScale);
+  }
+
+ private:
+  //! Quantize each column of the given weights with its own scale, and set the
+  //! scale of the input from its range.
+  void QuantizeWeights(const arma::mat& weight, const double inputRange)
+  {
+    inputScale = (inputRange > 0) ? inputRange / 127.0 : 1.0;
+
+    weights.set_size(weight.n_rows, weight.n_cols);
+    weightScales.set_size(weight.n_cols);
+    for (size_t o = 0; o < weight.n_cols; ++o)
+    {
+      const double range = arma::abs(weight.col(o)).max();
+      weightScales[o] = (range > 0) ? range / 127.0 : 1.0;
+      for (size_t k = 0; k < weight.n_rows; ++k)
+      {
+        weights(k, o) = (arma::s8) std::round(weight(k, o) /
+            weightScales[o]);
+      }
+    }
+  }
+
+  //! Quantize an input value, clipping it to the calibrated range.
+  arma::s8 Quantize(const double x) const
+  {
+    const double q = std::round(x / inputScale);
+    return (arma::s8) std::max(-127.0, std::min(127.0, q));
+  }
+
+  //! Compute the dot product of two int8 vectors in 32-bit integers.
+  static int32_t Dot(const arma::s8* a, const arma::s8* b, const size_t n)
+  {
+    int32_t sum = 0;
+    for (size_t k = 0; k < n; ++k)
+      sum += int32_t(a[k]) * int32_t(b[k]);
+
+    return sum;
+  }
+
+  //! The number of input maps.
+  size_t inSize;
+  //! The number of output maps.
+  size_t outSize;
+  //! The width of the filters.
+  size_t kernelWidth;
+  //! The height of the filters.
+  size_t kernelHeight;
+  //! The stride in the x direction.
+  size_t strideWidth;
+  //! The stride in the y direction.
+  size_t strideHeight;
+  //! The padding width on the left side.
+  size_t padWLeft;
+  //! The padding width on the right side.
+  size_t padWRight;
+  //! The padding height at the top.
+  size_t padHTop;
+  //! The padding height at the bottom.
+  size_t padHBottom;
+  //! The width of the input maps.
+  size_t inputWidth;
+  //! The height of the input maps.
+  size_t inputHeight;
+  //! The width of the output maps.
+  size_t outputWidth;
+  //! The height of the output maps.
+  size_t outputHeight;
+  //! The quantized weights, one column per output map.
+  arma::Mat<arma::s8> weights;
+  //! The scale of the weights of each output map.
+  arma::vec weightScales;
+  //! The bias of each output map.
+  arma::vec bias;
+  //! The scale of the input.
+  double inputScale;
+}; // class QuantizedLayer
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
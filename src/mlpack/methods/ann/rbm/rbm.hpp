@@ -300,7 +300,12 @@ class RBM
   SampleSlab(InputType& slabMean, DataType& slab);
 
   /**
-   * This function does the k-step Gibbs Sampling.
+   * This function does the k-step Gibbs Sampling.  With persistent CD, the
+   * chains are kept across calls instead of being started from the input: a
+   * pool of NumChains() chains (one per point of a batch by default), which is
+   * started from the points of the first input, is advanced by k steps and
+   * returned as the negative samples.  All the chains of the pool are sampled
+   * at once.
    *
    * @param input Input to the Gibbs function.
    * @param output Used for storing the negative sample.
@@ -335,6 +340,15 @@ class RBM
   //! Return the number of steps of Gibbs Sampling.
   size_t NumSteps() const { return numSteps; }
 
+  //! Get the number of persistent chains (0 means one per point of a batch).
+  size_t NumChains() const { return numChains; }
+  //! Modify the number of persistent chains (0 means one per point of a
+  //! batch).  The pool is restarted from the data if its size changes.
+  size_t& NumChains() { return numChains; }
+
+  //! Get the current state of the persistent chains, one per column.
+  const arma::Mat<ElemType>& Chains() const { return state; }
+
   //! Return the parameters of the network.
   const arma::Mat<ElemType>& Parameters() const { return parameter; }
   //! Modify the parameters of the network.
@@ -380,14 +394,37 @@ class RBM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Take one Gibbs sampling step on each of the given chains of the BinaryRBM;
+   * the chains are sampled together.
+   *
+   * @param chains The visible samples of the chains, one per column.
+   */
+  template<typename Policy = PolicyType>
+  typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, void>::type
+  GibbsStep(arma::Mat<ElemType>& chains);
+
+  /**
+   * Take one Gibbs sampling step on each of the given chains of the
+   * SpikeSlabRBM; since the hidden layer is sampled from one visible sample at
+   * a time, the chains are sampled one after the other.
+   *
+   * @param chains The visible samples of the chains, one per column.
+   */
+  template<typename Policy = PolicyType>
+  typename std::enable_if<std::is_same<Policy, SpikeSlabRBM>::value, void>::type
+  GibbsStep(arma::Mat<ElemType>& chains);
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
   arma::Mat<ElemType> predictors;
   // Initializer for initializing the weights of the network.
   InitializationRuleType initializeRule;
-  //! Locally-stored state of the persistent CD-k.
+  //! Locally-stored state of the persistent CD-k, one chain per column.
   arma::Mat<ElemType> state;
+  //! Locally-stored number of persistent chains.
+  size_t numChains;
   //! Locally-stored number of data points.
   size_t numFunctions;
   //! Locally stored number of visible neurons.
@@ -43,6 +43,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::RBM(
     batchSize(batchSize),
     numSteps(numSteps),
     negSteps(negSteps),
+    numChains(0),
     poolSize(poolSize),
     steps(0),
     slabPenalty(slabPenalty),
@@ -136,8 +137,9 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   DataType hiddenBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
       hiddenSize, 1, false, false);
 
-  HiddenMean(input, hiddenBiasGrad);
-  weightGrad.slice(0) = hiddenBiasGrad * input.t();
+  HiddenMean(input, hiddenReconstruction);
+  hiddenBiasGrad = arma::sum(hiddenReconstruction, 1);
+  weightGrad.slice(0) = hiddenReconstruction * input.t();
 }
 
 template<
@@ -168,11 +170,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>& output)
 {
   HiddenMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  output = arma::conv_to<arma::Mat<ElemType> >::from(
+      arma::randu<arma::Mat<ElemType> >(output.n_rows, output.n_cols) < output);
 }
 
 template<
@@ -187,11 +186,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>& output)
 {
   VisibleMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  output = arma::conv_to<arma::Mat<ElemType> >::from(
+      arma::randu<arma::Mat<ElemType> >(output.n_rows, output.n_cols) < output);
 }
 
 template<
@@ -238,26 +234,46 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gibbs(
 {
   this->steps = (steps == SIZE_MAX) ? this->numSteps : steps;
 
-  if (persistence && !state.is_empty())
-  {
-    SampleHidden(state, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
-  }
-  else
+  if (persistence)
   {
-    SampleHidden(input, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
+    // Start a new pool of chains from the points of the input.
+    const size_t chains = (numChains == 0) ? batchSize : numChains;
+    if (state.n_cols != chains || state.n_rows != input.n_rows)
+    {
+      state.set_size(input.n_rows, chains);
+      for (size_t j = 0; j < chains; ++j)
+        state.col(j) = input.col(j % input.n_cols);
+    }
+
+    for (size_t j = 0; j < this->steps; ++j)
+      GibbsStep(state);
+
+    output = state;
+    return;
   }
 
+  SampleHidden(input, gibbsTemporary);
+  SampleVisible(gibbsTemporary, output);
+
   for (size_t j = 1; j < this->steps; ++j)
   {
     SampleHidden(output, gibbsTemporary);
     SampleVisible(gibbsTemporary, output);
   }
-  if (persistence)
-  {
-    state = output;
-  }
+}
+
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename Policy>
+typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, void>::type
+RBM<InitializationRuleType, DataType, PolicyType>::GibbsStep(
+    arma::Mat<ElemType>& chains)
+{
+  SampleHidden(chains, gibbsTemporary);
+  SampleVisible(gibbsTemporary, chains);
 }
 
 template<
@@ -277,12 +293,17 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(predictors.cols(i, i + batchSize - 1),
       positiveGradient);
 
-  for (size_t i = 0; i < negSteps; ++i)
+  for (size_t step = 0; step < negSteps; ++step)
   {
     Gibbs(predictors.cols(i, i + batchSize - 1),
         negativeSamples);
     Phase(negativeSamples, tempNegativeGradient);
 
+    // The pool of persistent chains may not have as many samples as the batch
+    // has points.
+    if (persistence && negativeSamples.n_cols != batchSize)
+      tempNegativeGradient *= ElemType(batchSize) / negativeSamples.n_cols;
+
     negativeGradient += tempNegativeGradient;
   }
 
@@ -334,6 +355,7 @@ void RBM<InitializationRuleType, DataType, PolicyType>::serialize(
     negativeGradient.set_size(shape, 1);
     negativeSamples.set_size(visibleSize, batchSize);
     tempNegativeGradient.set_size(shape, 1);
+    numChains = state.n_cols;
     spikeMean.set_size(hiddenSize, 1);
     spikeSamples.set_size(hiddenSize, 1);
     slabMean.set_size(poolSize, hiddenSize);
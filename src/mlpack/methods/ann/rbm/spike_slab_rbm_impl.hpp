@@ -141,6 +141,24 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
   SampleSlab(slab, slab);
 }
 
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename Policy>
+typename std::enable_if<std::is_same<Policy, SpikeSlabRBM>::value, void>::type
+RBM<InitializationRuleType, DataType, PolicyType>::GibbsStep(
+    arma::Mat<ElemType>& chains)
+{
+  for (size_t j = 0; j < chains.n_cols; ++j)
+  {
+    arma::Mat<ElemType> chain(chains.colptr(j), chains.n_rows, 1, false, true);
+    SampleHidden(chain, gibbsTemporary);
+    SampleVisible(gibbsTemporary, chain);
+  }
+}
+
 template<
   typename InitializationRuleType,
   typename DataType,
@@ -160,10 +178,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 
   for (k = 0; k < numMaxTrials; ++k)
   {
-    for (size_t i = 0; i < visibleSize; ++i)
-    {
-      output(i) = math::RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    output = visibleMean + arma::randn<arma::Mat<ElemType> >(visibleSize, 1) /
+        visiblePenalty(0);
     if (arma::norm(output, 2) < radius)
     {
       break;
@@ -256,10 +272,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     InputType& spikeMean,
     DataType& spike)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+  spike = arma::conv_to<DataType>::from(
+      arma::randu<DataType>(hiddenSize, 1) < spikeMean);
 }
 
 template<
@@ -292,13 +306,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     InputType& slabMean,
     DataType& slab)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    for (size_t j = 0; j < poolSize; ++j)
-    {
-      slab(j, i) = math::RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  slab = slabMean + arma::randn<DataType>(poolSize, hiddenSize) / slabPenalty;
 }
 
 } // namespace ann
@@ -20,6 +20,9 @@
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "data_loader/prefetch_loader.hpp"
+#include "data_loader/length_buckets.hpp"
+#include "layer_profiler.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -167,6 +170,64 @@ class RNN
                arma::cube responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the recurrent neural network on sequences of different lengths,
+   * using the given optimizer.  The sequences are given in the format
+   * described above, padded to the same number of slices, and lengths[i] is
+   * the number of steps of the i'th sequence; the padding is ignored.  Each
+   * batch is only run for as many steps as its longest sequence, and the
+   * steps of a sequence after its end do not count in the objective or the
+   * gradient.  When the optimizer shuffles the data, the sequences are
+   * grouped by length (see BucketOrdering() and BucketSize()), so that each
+   * batch holds sequences of similar lengths.  With a single output per
+   * sequence, the response of each sequence is compared with the output of
+   * its last step.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param lengths Number of steps of each sequence.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(arma::cube predictors,
+               arma::cube responses,
+               arma::Row<size_t> lengths,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the recurrent neural network on a dataset streamed in chunks by the
+   * given loader, for the given number of epochs, so that the whole dataset
+   * never has to be in memory.  The chunks are cubes in the format described
+   * above.  The optimizer is run once on each chunk, with its maximum number
+   * of iterations set to the size of the chunk, so each epoch is one pass over
+   * the dataset; the state of its update policy is kept from one chunk to the
+   * next.  The loader already shuffles the sequences, so calls to Shuffle() by
+   * the optimizer don't copy the chunk again.  Any callbacks are run for every
+   * chunk.
+   *
+   * @tparam SourceType Type of the source of the loader.
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param loader Loader that gives the chunks of the dataset.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param epochs Number of passes over the dataset.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The sum of the final objectives of the chunks of the last epoch.
+   */
+  template<typename SourceType, typename OptimizerType,
+           typename... CallbackTypes>
+  double Train(PrefetchLoader<SourceType>& loader,
+               OptimizerType& optimizer,
+               const size_t epochs,
+               CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -291,6 +352,49 @@ class RNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  //! Get the number of steps of each truncated backpropagation through time
+  //! window (0 means the whole sequence).
+  size_t BPTTWindow() const { return bpttWindow; }
+  //! Modify the number of steps of each truncated backpropagation through time
+  //! window (0 means the whole sequence).  During training, the sequence is
+  //! then split into windows of that many steps.  The state of the recurrent
+  //! layers is carried from one window to the next in the forward pass, but
+  //! the error is not backpropagated from a window into the previous one.
+  size_t& BPTTWindow() { return bpttWindow; }
+
+  //! Get whether only the outputs of the recurrent layers are stored for the
+  //! backward pass.
+  bool CheckpointActivations() const { return checkpointActivations; }
+  //! Modify whether only the outputs of the recurrent layers are stored for
+  //! the backward pass.  The recurrent layers keep the state of every step
+  //! themselves; if this is true, the outputs of the other layers are not
+  //! stored during training, but recomputed from the input and the outputs of
+  //! the recurrent layers at each step of the backward pass.  Layers that draw
+  //! random numbers (like Dropout) then give a different output.
+  bool& CheckpointActivations() { return checkpointActivations; }
+
+  //! Get the number of steps of each training sequence (empty if all the
+  //! sequences have as many steps as there are slices).
+  const arma::Row<size_t>& SequenceLengths() const { return sequenceLengths; }
+  //! Modify the number of steps of each training sequence.  They must be
+  //! reordered along with Predictors() and Responses().
+  arma::Row<size_t>& SequenceLengths() { return sequenceLengths; }
+
+  //! Get the number of sequences sorted by length together when sequences of
+  //! different lengths are shuffled (0 sorts them all together).
+  size_t BucketSize() const { return bucketSize; }
+  //! Modify the number of sequences sorted by length together when sequences
+  //! of different lengths are shuffled (0 sorts them all together).  Larger
+  //! buckets give batches of more similar lengths, but a less random order.
+  size_t& BucketSize() { return bucketSize; }
+
+  //! Get the profiler of the layers of the network.
+  const LayerProfiler& Profiler() const { return profiler; }
+  //! Modify the profiler of the layers of the network.  It is disabled by
+  //! default; see LayerProfiler.  Each step of a sequence is recorded as one
+  //! call of each layer.
+  LayerProfiler& Profiler() { return profiler; }
+
   //! Get the matrix of responses to the input data points.
   const arma::cube& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -333,6 +437,14 @@ class RNN
    */
   void ResetCells();
 
+  /**
+   * Reset the state of RNN cells in the network for a new input sequence of
+   * the given number of steps.
+   *
+   * @param size The number of steps of the sequence.
+   */
+  void ResetCells(const size_t size);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -346,6 +458,55 @@ class RNN
   template<typename InputType>
   void Gradient(const InputType& input);
 
+  /**
+   * Drop the error carried back from the later time steps by the recurrent
+   * layers, so that the next call to Backward() starts a new truncated BPTT
+   * window, and find which layers are recurrent.
+   */
+  void TruncateBackward();
+
+  /**
+   * Store the outputs of the layers for the backward pass (only those of the
+   * recurrent layers if checkpointActivations is set).
+   *
+   * @param outputs The stack of stored outputs.
+   */
+  void SaveOutputs(std::vector<arma::mat>& outputs);
+
+  /**
+   * Restore the outputs of the layers for the last step stored with
+   * SaveOutputs(), recomputing those that were not stored.
+   *
+   * @param input The input of the network at that step.
+   * @param outputs The stack of stored outputs.
+   */
+  void LoadOutputs(const arma::mat& input, std::vector<arma::mat>& outputs);
+
+  /**
+   * Get the number of steps to run for the given batch: the number of steps
+   * of its longest sequence, or rho if the sequences have no lengths.
+   */
+  size_t BatchSteps(const size_t begin, const size_t batchSize) const;
+
+  /**
+   * Get the columns of the given batch whose output is compared with their
+   * responses at the given step: the sequences that have not ended (or, with a
+   * single output, the sequences that end at this step).
+   */
+  arma::uvec ActiveColumns(const size_t begin,
+                           const size_t batchSize,
+                           const size_t step) const;
+
+  /**
+   * Get the performance of the output layer at the given step of the given
+   * batch, on the responses of the given slice.  The sequences that have
+   * ended are left out.
+   */
+  double Performance(const size_t begin,
+                     const size_t batchSize,
+                     const size_t step,
+                     const size_t responseSeq);
+
   /**
    * Reset the module status by setting the current deterministic parameter
    * for all modules that implement the Deterministic function.
@@ -424,6 +585,32 @@ class RNN
   //! The current gradient for the gradient pass.
   arma::mat currentGradient;
 
+  //! The number of steps of each truncated BPTT window (0 for the whole
+  //! sequence).
+  size_t bpttWindow;
+
+  //! Whether only the outputs of the recurrent layers are stored for the
+  //! backward pass.
+  bool checkpointActivations;
+
+  //! Whether each layer of the network is recurrent (set by
+  //! TruncateBackward()).
+  std::vector<bool> recurrentLayers;
+
+  //! Whether the network is being trained on chunks from a PrefetchLoader,
+  //! which are already shuffled.
+  bool streaming;
+
+  //! The profiler of the layers.
+  LayerProfiler profiler;
+
+  //! The number of steps of each training sequence (empty if all the sequences
+  //! have as many steps as there are slices).
+  arma::Row<size_t> sequenceLengths;
+
+  //! The number of sequences sorted by length together by Shuffle().
+  size_t bucketSize;
+
   // The BRN class should have access to internal members.
   template<
     typename OutputLayerType1,
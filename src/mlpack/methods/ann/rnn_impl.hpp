@@ -20,11 +20,14 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/truncate_backward_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
 
+#include "data_loader/optimizer_options.hpp"
+
 #include <boost/serialization/variant.hpp>
 
 namespace mlpack {
@@ -46,7 +49,12 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     reset(false),
     single(single),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    bpttWindow(0),
+    checkpointActivations(false),
+    streaming(false),
+    profiler("rnn"),
+    bucketSize(1024)
 {
   /* Nothing to do here */
 }
@@ -109,6 +117,59 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  sequenceLengths.reset();
+
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+  {
+    ResetParameters();
+  }
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Train the model.
+  Timer::Start("rnn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("rnn_optimization");
+
+  Log::Info << "RNN::RNN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    arma::cube predictors,
+    arma::cube responses,
+    arma::Row<size_t> lengths,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  if (lengths.n_elem != predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "RNN::Train(): the number of lengths (" << lengths.n_elem << ") "
+        << "does not match the number of sequences (" << predictors.n_cols
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (lengths.n_elem > 0 &&
+      (lengths.min() == 0 || lengths.max() > predictors.n_slices))
+  {
+    throw std::invalid_argument("RNN::Train(): the length of each sequence "
+        "must be between 1 and the number of slices!");
+  }
+
+  numFunctions = responses.n_cols;
+
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  sequenceLengths = std::move(lengths);
 
   this->deterministic = true;
   ResetDeterministic();
@@ -134,10 +195,18 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetCells()
+{
+  ResetCells(rho);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetCells(const size_t size)
 {
   for (size_t i = 1; i < network.size(); ++i)
   {
-    boost::apply_visitor(ResetCellVisitor(rho), network[i]);
+    boost::apply_visitor(ResetCellVisitor(size), network[i]);
   }
 }
 
@@ -153,6 +222,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  sequenceLengths.reset();
 
   this->deterministic = true;
   ResetDeterministic();
@@ -176,6 +246,65 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   return out;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename SourceType, typename OptimizerType,
+         typename... CallbackTypes>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    PrefetchLoader<SourceType>& loader,
+    OptimizerType& optimizer,
+    const size_t epochs,
+    CallbackTypes&&... callbacks)
+{
+  // Start at the beginning of an epoch.
+  loader.Reset();
+
+  this->deterministic = true;
+  ResetDeterministic();
+  streaming = true;
+  sequenceLengths.reset();
+
+  // Save the options of the optimizer that are changed for each chunk.
+  const size_t maxIterations = SwapMaxIterations(optimizer, 0);
+  const bool resetPolicy = SwapResetPolicy(optimizer, true);
+
+  Timer::Start("rnn_optimization");
+  double out = 0.0;
+  size_t chunks = 0;
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    out = 0.0;
+    while (loader.Next(predictors, responses))
+    {
+      numFunctions = responses.n_cols;
+      if (numFunctions == 0)
+        continue;
+
+      if (!reset)
+        ResetParameters();
+
+      // Make one pass over the chunk, and keep the state of the optimizer for
+      // the next one.
+      SwapMaxIterations(optimizer, numFunctions);
+      out += optimizer.Optimize(*this, parameter, callbacks...);
+      if (++chunks == 1)
+        SwapResetPolicy(optimizer, false);
+    }
+  }
+  Timer::Stop("rnn_optimization");
+
+  SwapMaxIterations(optimizer, maxIterations);
+  SwapResetPolicy(optimizer, resetPolicy);
+  streaming = false;
+
+  // Don't keep reading chunks that won't be used.
+  loader.Reset();
+
+  Log::Info << "RNN::RNN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
@@ -257,8 +386,9 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 
   double performance = 0;
   size_t responseSeq = 0;
+  const size_t steps = BatchSteps(begin, batchSize);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t seqNum = 0; seqNum < steps; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
     arma::mat stepData(predictors.slice(seqNum).colptr(begin),
@@ -269,10 +399,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
       responseSeq = seqNum;
     }
 
-    performance += outputLayer.Forward(boost::apply_visitor(
-        outputParameterVisitor, network.back()),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true));
+    performance += Performance(begin, batchSize, seqNum, responseSeq);
   }
 
   if (outputSize == 0)
@@ -334,11 +461,20 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
-
   double performance = 0;
   size_t responseSeq = 0;
-  const size_t effectiveRho = std::min(rho, size_t(responses.size()));
+  const size_t effectiveRho = std::min(std::min(rho,
+      size_t(responses.size())), BatchSteps(begin, batchSize));
+
+  // Initialize current/working gradient.
+  if (currentGradient.is_empty())
+  {
+    currentGradient = arma::zeros<arma::mat>(parameter.n_rows,
+        parameter.n_cols);
+  }
+
+  ResetCells(sequenceLengths.is_empty() ? rho : effectiveRho);
+  TruncateBackward();
 
   for (size_t seqNum = 0; seqNum < effectiveRho; ++seqNum)
   {
@@ -351,16 +487,8 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       responseSeq = seqNum;
     }
 
-    for (size_t l = 0; l < network.size(); ++l)
-    {
-      boost::apply_visitor(SaveOutputParameterVisitor(moduleOutputParameter),
-          network[l]);
-    }
-
-    performance += outputLayer.Forward(boost::apply_visitor(
-        outputParameterVisitor, network.back()),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true));
+    SaveOutputs(moduleOutputParameter);
+    performance += Performance(begin, batchSize, seqNum, responseSeq);
   }
 
   if (outputSize == 0)
@@ -369,29 +497,47 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
         network.back()).n_elem / batchSize;
   }
 
-  // Initialize current/working gradient.
-  if (currentGradient.is_empty())
-  {
-    currentGradient = arma::zeros<arma::mat>(parameter.n_rows,
-        parameter.n_cols);
-  }
-
   ResetGradients(currentGradient);
 
-  for (size_t seqNum = 0; seqNum < effectiveRho; ++seqNum)
+  for (size_t seqNum = effectiveRho; seqNum-- > 0; )
   {
-    currentGradient.zeros();
-    for (size_t l = 0; l < network.size(); ++l)
+    // The error of the later steps is not backpropagated past the start of
+    // their truncated BPTT window.
+    if (bpttWindow != 0 && seqNum + 1 < effectiveRho &&
+        (seqNum + 1) % bpttWindow == 0)
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(moduleOutputParameter),
-          network[network.size() - 1 - l]);
+      TruncateBackward();
     }
 
-    if (single && seqNum > 0)
+    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+        predictors.n_rows, batchSize, false, true);
+    currentGradient.zeros();
+    LoadOutputs(stepData, moduleOutputParameter);
+
+    if (!sequenceLengths.is_empty())
+    {
+      // Only the sequences that have not ended give an error; the steps
+      // after the end of a sequence then have no effect on the gradient.
+      const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+          network.back());
+      const arma::mat target(responses.slice(single ? 0 : seqNum).colptr(
+          begin), responses.n_rows, batchSize, false, true);
+      const arma::uvec columns = ActiveColumns(begin, batchSize, seqNum);
+
+      error.zeros(output.n_rows, batchSize);
+      if (!columns.is_empty())
+      {
+        arma::mat columnError;
+        outputLayer.Backward(arma::mat(output.cols(columns)),
+            arma::mat(target.cols(columns)), columnError);
+        error.cols(columns) = columnError;
+      }
+    }
+    else if (single && seqNum < effectiveRho - 1)
     {
       error.zeros();
     }
-    else if (single && seqNum == 0)
+    else if (single)
     {
       outputLayer.Backward(boost::apply_visitor(
           outputParameterVisitor, network.back()),
@@ -402,14 +548,12 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     {
       outputLayer.Backward(boost::apply_visitor(
           outputParameterVisitor, network.back()),
-          arma::mat(responses.slice(effectiveRho - seqNum - 1).colptr(begin),
+          arma::mat(responses.slice(seqNum).colptr(begin),
           responses.n_rows, batchSize, false, true), error);
     }
 
     Backward();
-    Gradient(
-        arma::mat(predictors.slice(effectiveRho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
+    Gradient(stepData);
     gradient += currentGradient;
   }
 
@@ -431,6 +575,30 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
+  // The chunks given by a PrefetchLoader are shuffled by its thread.
+  if (streaming)
+    return;
+
+  if (!sequenceLengths.is_empty())
+  {
+    // Group the sequences by length, so that each batch holds sequences of
+    // similar lengths.
+    const arma::uvec ordering = BucketOrdering(sequenceLengths, bucketSize);
+    arma::cube newPredictors(predictors.n_rows, predictors.n_cols,
+        predictors.n_slices);
+    arma::cube newResponses(responses.n_rows, responses.n_cols,
+        responses.n_slices);
+    for (size_t i = 0; i < predictors.n_slices; ++i)
+      newPredictors.slice(i) = predictors.slice(i).cols(ordering);
+    for (size_t i = 0; i < responses.n_slices; ++i)
+      newResponses.slice(i) = responses.slice(i).cols(ordering);
+
+    predictors = std::move(newPredictors);
+    responses = std::move(newResponses);
+    sequenceLengths = arma::Row<size_t>(sequenceLengths.cols(ordering));
+    return;
+  }
+
   arma::cube newPredictors, newResponses;
   math::ShuffleData(predictors, responses, newPredictors, newResponses);
 
@@ -438,6 +606,60 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
   responses = std::move(newResponses);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t RNN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::BatchSteps(const size_t begin,
+                                        const size_t batchSize) const
+{
+  if (sequenceLengths.is_empty())
+    return rho;
+
+  return std::min(rho, (size_t) arma::max(sequenceLengths.subvec(begin,
+      begin + batchSize - 1)));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+arma::uvec RNN<OutputLayerType, InitializationRuleType,
+               CustomLayers...>::ActiveColumns(const size_t begin,
+                                               const size_t batchSize,
+                                               const size_t step) const
+{
+  const arma::Row<size_t> lengths = sequenceLengths.subvec(begin,
+      begin + batchSize - 1);
+  if (single)
+  {
+    // Sequences longer than rho are cut after rho steps.
+    return arma::find(arma::clamp(lengths, 0, rho) == step + 1);
+  }
+
+  return arma::find(lengths > step);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double RNN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::Performance(const size_t begin,
+                                         const size_t batchSize,
+                                         const size_t step,
+                                         const size_t responseSeq)
+{
+  const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  const arma::mat target(responses.slice(responseSeq).colptr(begin),
+      responses.n_rows, batchSize, false, true);
+  if (sequenceLengths.is_empty())
+    return outputLayer.Forward(output, target);
+
+  const arma::uvec columns = ActiveColumns(begin, batchSize, step);
+  if (columns.is_empty())
+    return 0.0;
+
+  return outputLayer.Forward(arma::mat(output.cols(columns)),
+      arma::mat(target.cols(columns)));
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
@@ -486,22 +708,93 @@ void RNN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::TruncateBackward()
+{
+  recurrentLayers.resize(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    recurrentLayers[i] = boost::apply_visitor(TruncateBackwardVisitor(),
+        network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SaveOutputs(std::vector<arma::mat>& outputs)
+{
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    if (!checkpointActivations || recurrentLayers[i])
+    {
+      boost::apply_visitor(SaveOutputParameterVisitor(outputs), network[i]);
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::LoadOutputs(const arma::mat& input,
+                                       std::vector<arma::mat>& outputs)
+{
+  for (size_t i = network.size(); i-- > 0; )
+  {
+    if (!checkpointActivations || recurrentLayers[i])
+    {
+      boost::apply_visitor(LoadOutputParameterVisitor(outputs), network[i]);
+    }
+  }
+
+  if (!checkpointActivations)
+    return;
+
+  // Recompute the outputs of the other layers; the recurrent layers are not
+  // run again, since that would move them to the next step.
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    if (recurrentLayers[i])
+      continue;
+
+    if (i == 0)
+    {
+      boost::apply_visitor(ForwardVisitor(input,
+          boost::apply_visitor(outputParameterVisitor, network[i])),
+          network[i]);
+    }
+    else
+    {
+      boost::apply_visitor(ForwardVisitor(
+          boost::apply_visitor(outputParameterVisitor, network[i - 1]),
+          boost::apply_visitor(outputParameterVisitor, network[i])),
+          network[i]);
+    }
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
+  profiler.Start(0, LayerProfiler::FORWARD);
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
       network.front());
+  profiler.Stop(0, LayerProfiler::FORWARD, network.front());
 
   for (size_t i = 1; i < network.size(); ++i)
   {
+    profiler.Start(i, LayerProfiler::FORWARD);
     boost::apply_visitor(ForwardVisitor(
         boost::apply_visitor(outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])),
         network[i]);
+    profiler.Stop(i, LayerProfiler::FORWARD, network[i]);
   }
 }
 
@@ -509,19 +802,24 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  profiler.Start(network.size() - 1, LayerProfiler::BACKWARD);
   boost::apply_visitor(BackwardVisitor(
         boost::apply_visitor(outputParameterVisitor, network.back()),
         error, boost::apply_visitor(deltaVisitor,
         network.back())), network.back());
+  profiler.Stop(network.size() - 1, LayerProfiler::BACKWARD, network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
+    profiler.Start(network.size() - i, LayerProfiler::BACKWARD);
     boost::apply_visitor(BackwardVisitor(
         boost::apply_visitor(outputParameterVisitor,
         network[network.size() - i]), boost::apply_visitor(
         deltaVisitor, network[network.size() - i + 1]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i])),
         network[network.size() - i]);
+    profiler.Stop(network.size() - i, LayerProfiler::BACKWARD,
+        network[network.size() - i]);
   }
 }
 
@@ -531,15 +829,19 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
+  profiler.Start(0, LayerProfiler::GRADIENT);
   boost::apply_visitor(GradientVisitor(input,
       boost::apply_visitor(deltaVisitor, network[1])), network.front());
+  profiler.Stop(0, LayerProfiler::GRADIENT, network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
+    profiler.Start(i, LayerProfiler::GRADIENT);
     boost::apply_visitor(GradientVisitor(
         boost::apply_visitor(outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(deltaVisitor, network[i + 1])),
         network[i]);
+    profiler.Stop(i, LayerProfiler::GRADIENT, network[i]);
   }
 }
 
@@ -0,0 +1,152 @@
+/**
+ * @file methods/ann/save_checkpoint.hpp
+ *
+ * Definition of the SaveCheckpoint callback, which saves a network
+ * periodically during training without blocking it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_SAVE_CHECKPOINT_HPP
+#define MLPACK_METHODS_ANN_SAVE_CHECKPOINT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/checkpoint_writer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An ensmallen callback that saves a network (an FFN or an RNN) every given
+ * number of epochs with a data::CheckpointWriter: training only waits while
+ * the network is copied, and the copy is serialized and written on a
+ * background thread.  The training data of the network is not serialized, so
+ * it is moved out of the network while the copy is made, instead of being
+ * copied.  The network must be the one being trained, so that its parameters
+ * are the coordinates of the optimizer (as with FFN::Train() and
+ * RNN::Train()).
+ *
+ * Each checkpoint replaces the previous one in the given file.  At the end of
+ * the optimization, the callback waits for the last checkpoint to be written
+ * (and rethrows any error of the background thread).
+ *
+ * @code
+ * FFN<> model;
+ * // ... add layers ...
+ * model.Train(x, y, optimizer, SaveCheckpoint<FFN<> >(model, "model.mlb", 5));
+ * @endcode
+ *
+ * @tparam NetworkType Type of the network.
+ */
+template<typename NetworkType>
+class SaveCheckpoint
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param network The network being trained.
+   * @param filename File to save the network to.
+   * @param epochs Save the network every this many epochs.
+   * @param name Name of the network in the file (see data::Save()).
+   */
+  SaveCheckpoint(NetworkType& network,
+                 const std::string& filename,
+                 const size_t epochs = 1,
+                 const std::string& name = "model") :
+      network(network),
+      filename(filename),
+      epochs(epochs),
+      name(name)
+  {
+    /* Nothing to do here. */
+  }
+
+  /**
+   * Save the network every epochs epochs.
+   *
+   * @param * (optimizer) The optimizer used to update the function.
+   * @param * (function) Function to optimize.
+   * @param * (coordinates) The current function parameters.
+   * @param epoch The index of the current epoch.
+   * @param * (objective) Objective value of the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t epoch,
+                const double /* objective */)
+  {
+    if (epochs != 0 && epoch % epochs == 0)
+      Save();
+
+    return false;
+  }
+
+  /**
+   * Wait for the last checkpoint to be written.
+   *
+   * @param * (optimizer) The optimizer used to update the function.
+   * @param * (function) Function to optimize.
+   * @param * (coordinates) The current function parameters.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& /* function */,
+                       MatType& /* coordinates */)
+  {
+    writer.Wait();
+  }
+
+  //! Get the writer of the checkpoints.
+  const data::CheckpointWriter& Writer() const { return writer; }
+  //! Modify the writer of the checkpoints.
+  data::CheckpointWriter& Writer() { return writer; }
+
+ private:
+  //! Copy the network without its training data, and save the copy.
+  void Save()
+  {
+    // Wait for the previous checkpoint before making the copy, so that there
+    // are never more than two copies of the network.
+    writer.Wait();
+
+    auto predictors = std::move(network.Predictors());
+    auto responses = std::move(network.Responses());
+    try
+    {
+      NetworkType snapshot(network);
+      network.Predictors() = std::move(predictors);
+      network.Responses() = std::move(responses);
+      writer.Save(filename, name, std::move(snapshot));
+    }
+    catch (...)
+    {
+      if (network.Predictors().is_empty())
+      {
+        network.Predictors() = std::move(predictors);
+        network.Responses() = std::move(responses);
+      }
+      throw;
+    }
+  }
+
+  //! The network being trained.
+  NetworkType& network;
+  //! The file to save the network to.
+  std::string filename;
+  //! Save the network every this many epochs.
+  size_t epochs;
+  //! The name of the network in the file.
+  std::string name;
+  //! The writer of the checkpoints.
+  data::CheckpointWriter writer;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
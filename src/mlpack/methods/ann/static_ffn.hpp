@@ -0,0 +1,599 @@
+/**
+ * @file methods/ann/static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward network whose layers are
+ * fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+#include <array>
+#include <tuple>
+
+#include <mlpack/methods/ann/init_rules/init_rules_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <ensmallen.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A feed forward network whose layers are given as template parameters, as an
+ * alternative to FFN for networks whose structure is known at compile time.
+ * The layers are held by value in a std::tuple, and the passes over the
+ * network call the methods of each layer directly, instead of going through
+ * boost::apply_visitor() on the LayerTypes variant; so every call can be
+ * inlined, and there is no dispatch cost per layer.  The offset of the weights
+ * of each layer in the parameter matrix is computed once, by
+ * ResetParameters(), and the layers keep their outputs between passes.  This
+ * makes a large difference in the latency of small networks, for instance
+ * multilayer perceptrons evaluated on one point at a time.
+ *
+ * @code
+ * StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+ *     SigmoidLayer<>, Linear<>, LogSoftMax<> > model(Linear<>(10, 8),
+ *     SigmoidLayer<>(), Linear<>(8, 3), LogSoftMax<>());
+ *
+ * model.Train(trainData, trainLabels);
+ * model.Predict(testData, predictions);
+ * @endcode
+ *
+ * The layers must not hold other layers (like Sequential or Concat), and their
+ * shape must be set at construction; that covers Linear, the activation
+ * layers, Dropout and most of the other layers of a multilayer perceptron.
+ *
+ * The parameters, the data and the buffers of the layers all have the output
+ * type of the layers, so a network of layers with arma::fmat outputs trains
+ * and predicts in single precision, with half the memory and bandwidth.  The
+ * parameters of a network trained in double precision can be used for
+ * prediction in single precision:
+ *
+ * @code
+ * StaticFFN<NegativeLogLikelihood<arma::fmat, arma::fmat>,
+ *     RandomInitialization, Linear<arma::fmat, arma::fmat>,
+ *     SigmoidLayer<arma::fmat, arma::fmat>, Linear<arma::fmat, arma::fmat>,
+ *     LogSoftMax<arma::fmat, arma::fmat> > floatModel(...);
+ *
+ * floatModel.ResetParameters();
+ * floatModel.Parameters() = arma::conv_to<arma::fmat>::from(
+ *     model.Parameters());
+ * @endcode
+ *
+ * A network in single precision can also be trained with double-precision
+ * master weights, and with loss scaling, by TrainWithMasterWeights(): the
+ * optimizer updates the master weights, which are rounded into the parameters
+ * of the network before each batch (see MasterWeightsFunction).  FFN and RNN
+ * only work in double precision, since the layers of their LayerTypes variant
+ * all use arma::mat.
+ *
+ * In the same way, the matrix type can be the matrix of another library with
+ * the Armadillo API.  If mlpack is built with the USE_BANDICOOT CMake option, a
+ * network of layers with coot::mat (or coot::fmat) outputs trains on the GPU:
+ * the data, the parameters, the gradients and the buffers of the layers all
+ * stay in GPU memory between the steps of the optimizer.  The layers that
+ * support this are Linear, the Sigmoid, TanH, ReLU, Identity and LogSoftMax
+ * layers, and the MeanSquaredError, NegativeLogLikelihood, CrossEntropyError,
+ * MeanSquaredLogarithmicError, LogCoshLoss and MeanBiasError output layers
+ * (NegativeLogLikelihood copies the labels of each batch to the GPU).  The
+ * parameters are initialized, and the data shuffled, through a copy in host
+ * memory.  Convolution and pooling layers, which work on arma::Cube, and the
+ * loss functions that loop over the elements (such as HuberLoss and
+ * SigmoidCrossEntropyError) don't support GPU matrices yet.
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam Layers The types of the layers of the network, in order.
+ */
+template<
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename... Layers
+>
+class StaticFFN
+{
+  static_assert(sizeof...(Layers) > 0, "StaticFFN must have at least one "
+      "layer.");
+
+ public:
+  //! The matrix type of the network, which is the output type of its first
+  //! layer; arma::mat by default, arma::fmat for a network in single
+  //! precision.
+  typedef typename std::decay<decltype(std::declval<typename std::tuple_element<
+      0, std::tuple<Layers...> >::type&>().OutputParameter())>::type MatType;
+
+  //! The element type of the network.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the network from the given layers.
+   *
+   * @param layers The layers of the network, in order.
+   */
+  StaticFFN(Layers... layers);
+
+  /**
+   * Create the network from the given layers, with the given output layer and
+   * initialization rule.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Instantiated InitializationRule object for
+   *        initializing the network parameter.
+   * @param layers The layers of the network, in order.
+   */
+  StaticFFN(OutputLayerType outputLayer,
+            InitializationRuleType initializeRule,
+            Layers... layers);
+
+  //! Copy constructor; the weights of the layers of the copy point to its own
+  //! parameters.
+  StaticFFN(const StaticFFN& other);
+
+  //! Copy assignment operator.
+  StaticFFN& operator=(const StaticFFN& other);
+
+  /**
+   * Train the network on the given input data using the given optimizer.
+   * This will use the existing model parameters as a starting point for the
+   * optimization.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(MatType predictors,
+               MatType responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the network on the given input data, using a default-constructed
+   * optimizer of the given type.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  double Train(MatType predictors,
+               MatType responses,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the network on the given input data using the given optimizer, with
+   * double-precision master weights: the optimizer updates a copy of the
+   * parameters in double precision, which is rounded into the parameters of
+   * the network before each batch, and the gradient of the network is
+   * converted to double precision.  With a loss scale, the error of the
+   * output layer is multiplied by the loss scale before it is backpropagated,
+   * and the gradient is divided by it; with a growth interval, the loss scale
+   * is halved after each batch whose gradient is not finite (and the gradient
+   * of that batch is set to zero), and doubled after growthInterval finite
+   * gradients in a row.  This is useful for networks in single precision,
+   * whose small updates would otherwise be lost to rounding.  The matrix type
+   * must be an Armadillo matrix.
+   *
+   * At the end of the optimization, the parameters of the network are the
+   * rounded master weights, and LossScale() is reset to 1.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param lossScale Initial loss scale.
+   * @param growthInterval Number of finite gradients in a row after which the
+   *     loss scale is doubled (0 to keep the loss scale fixed).
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double TrainWithMasterWeights(MatType predictors,
+                                MatType responses,
+                                OptimizerType& optimizer,
+                                const double lossScale = 1.0,
+                                const size_t growthInterval = 0,
+                                CallbackTypes&&... callbacks);
+
+  /**
+   * Predict the responses to a given set of predictors, forwarding batchSize
+   * points through the network at once.  Each batch is an alias of the
+   * columns of the predictors, and the results are only reallocated if they
+   * do not have the right size.  The results must not alias the predictors.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(const MatType& predictors,
+               MatType& results,
+               const size_t batchSize = 256);
+
+  /**
+   * Evaluate the network with the given predictors and responses.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  ElemType Evaluate(const MatType& predictors, const MatType& responses);
+
+  /**
+   * Evaluate the network on the whole training set, as one batch.  This is
+   * used by optimizers such as L-BFGS.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  ElemType Evaluate(const MatType& parameters);
+
+  /**
+   * Evaluate the network on a batch of the training set.  This is used by
+   * optimizers such as SGD.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  ElemType Evaluate(const MatType& parameters,
+                    const size_t begin,
+                    const size_t batchSize);
+
+  /**
+   * Evaluate the network and its gradient on the whole training set, as one
+   * batch.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param gradient Matrix to output gradient into.
+   */
+  ElemType EvaluateWithGradient(const MatType& parameters,
+                                MatType& gradient);
+
+  /**
+   * Evaluate the network and its gradient on a batch of the training set.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  ElemType EvaluateWithGradient(const MatType& parameters,
+                                const size_t begin,
+                                MatType& gradient,
+                                const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the network on a batch of the training set.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize);
+
+  //! Shuffle the order of the training points.
+  void Shuffle();
+
+  //! Return the number of separable functions (the number of predictor
+  //! points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const MatType& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  MatType& Parameters() { return parameter; }
+
+  //! Get the factor the error of the output layer is multiplied by before it
+  //! is backpropagated.
+  double LossScale() const { return lossScale; }
+  //! Modify the factor the error of the output layer is multiplied by before
+  //! it is backpropagated (the gradient is multiplied by it too).
+  double& LossScale() { return lossScale; }
+
+  //! Get the layer with the given index.
+  template<size_t I>
+  const typename std::tuple_element<I, std::tuple<Layers...> >::type&
+  Layer() const { return std::get<I>(layers); }
+  //! Modify the layer with the given index.
+  template<size_t I>
+  typename std::tuple_element<I, std::tuple<Layers...> >::type&
+  Layer() { return std::get<I>(layers); }
+
+  //! Get the offset of the weights of the given layer in the parameters.
+  size_t Offset(const size_t layer) const { return offsets[layer]; }
+
+  /**
+   * Reset the network parameters with the initialization rule, and point the
+   * weights of each layer to their place in the parameter matrix.
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Whether the matrix type is an Armadillo matrix (and not, for instance, a
+  //! Bandicoot matrix on the GPU).
+  typedef std::is_same<MatType, arma::Mat<ElemType> > IsArmaType;
+
+  //! Initialize the parameters with the initialization rule.
+  void InitializeParameters(std::true_type /* isArmaType */);
+  //! Initialize the parameters in host memory, and copy them to the matrix
+  //! type.
+  void InitializeParameters(std::false_type /* isArmaType */);
+
+  //! Shuffle the training points.
+  void ShufflePoints(std::true_type /* isArmaType */);
+  //! Shuffle the training points in host memory.
+  void ShufflePoints(std::false_type /* isArmaType */);
+
+  //! Whether there is a layer with the given index.
+  template<size_t I>
+  using HasLayer = std::integral_constant<bool, (I < sizeof...(Layers))>;
+
+  //! Compute the offset of the weights of each layer from layer I on.
+  template<size_t I>
+  void ComputeOffsets(std::true_type /* hasLayer */);
+  template<size_t I>
+  void ComputeOffsets(std::false_type /* hasLayer */) { }
+
+  //! Point the weights of each layer from layer I on into the parameters, and
+  //! reset the layers.
+  template<size_t I>
+  void SetWeights(std::true_type /* hasLayer */);
+  template<size_t I>
+  void SetWeights(std::false_type /* hasLayer */) { }
+
+  //! Point the gradient of each layer from layer I on into the given matrix.
+  template<size_t I>
+  void ResetGradients(MatType& gradient, std::true_type /* hasLayer */);
+  template<size_t I>
+  void ResetGradients(MatType& /* gradient */,
+                      std::false_type /* hasLayer */) { }
+
+  //! Set the deterministic parameter of each layer from layer I on.
+  template<size_t I>
+  void ResetDeterministic(std::true_type /* hasLayer */);
+  template<size_t I>
+  void ResetDeterministic(std::false_type /* hasLayer */) { }
+
+  //! Return the sum of the losses of the layers from layer I on.
+  template<size_t I>
+  double Loss(std::true_type /* hasLayer */);
+  template<size_t I>
+  double Loss(std::false_type /* hasLayer */) { return 0; }
+
+  //! Forward the output of layer I - 1 through the layers from layer I on.
+  template<size_t I>
+  void Forward(std::true_type /* hasLayer */);
+  template<size_t I>
+  void Forward(std::false_type /* hasLayer */) { }
+
+  //! Backpropagate the error from layer I down to layer 1 (the first layer
+  //! does not need its delta).
+  template<size_t I>
+  void Backward(std::true_type /* isNotFirst */);
+  template<size_t I>
+  void Backward(std::false_type /* isNotFirst */) { }
+
+  //! Compute the gradient of each layer from layer I on.
+  template<size_t I>
+  void Gradient(const MatType& input, std::true_type /* hasLayer */);
+  template<size_t I>
+  void Gradient(const MatType& /* input */,
+                std::false_type /* hasLayer */) { }
+
+  //! Serialize each layer from layer I on.
+  template<size_t I, typename Archive>
+  void SerializeLayers(Archive& ar, std::true_type /* hasLayer */);
+  template<size_t I, typename Archive>
+  void SerializeLayers(Archive& /* ar */, std::false_type /* hasLayer */) { }
+
+  //! Get the input of layer I: the input of the network, or the output of
+  //! layer I - 1.
+  template<size_t I>
+  const MatType& LayerInput(const MatType& input,
+                              std::true_type /* isNotFirst */);
+  template<size_t I>
+  const MatType& LayerInput(const MatType& input,
+                              std::false_type /* isNotFirst */)
+  { return input; }
+
+  //! Get the error of layer I: the delta of layer I + 1, or the error of the
+  //! output layer.
+  template<size_t I>
+  const MatType& LayerError(std::true_type /* isNotLast */);
+  template<size_t I>
+  const MatType& LayerError(std::false_type /* isNotLast */)
+  { return error; }
+
+  //! Run a forward pass through the whole network.
+  void Forward(const MatType& input);
+
+  //! Run a backward pass, and compute the gradient, for the given input; the
+  //! error of the output layer must already be computed.
+  void Backward(const MatType& input, MatType& gradient);
+
+  //! Compute the loss of the output layer for the output of the network, and
+  //! store the error of the output layer, in one pass.
+  template<typename TargetType, typename T = OutputLayerType>
+  typename std::enable_if<HasForwardBackwardCheck<T, ElemType(T::*)(
+      const MatType&, const MatType&, MatType&)>::value, ElemType>::type
+  OutputLayerForwardBackward(const TargetType& targets)
+  { return outputLayer.ForwardBackward(NetworkOutput(), targets, error); }
+
+  //! Compute the loss and the error of an output layer without a
+  //! ForwardBackward() function.
+  template<typename TargetType, typename T = OutputLayerType>
+  typename std::enable_if<!HasForwardBackwardCheck<T, ElemType(T::*)(
+      const MatType&, const MatType&, MatType&)>::value, ElemType>::type
+  OutputLayerForwardBackward(const TargetType& targets)
+  {
+    const ElemType res = outputLayer.Forward(NetworkOutput(), targets);
+    outputLayer.Backward(NetworkOutput(), targets, error);
+    return res;
+  }
+
+  //! Get the output of the last layer.
+  const MatType& NetworkOutput()
+  { return std::get<sizeof...(Layers) - 1>(layers).OutputParameter(); }
+
+  //! Set the deterministic parameter of the layers, if it changed.
+  void SetDeterministic(const bool deterministic);
+
+  //! Return the number of weights of a layer without weights.
+  template<typename T>
+  static typename std::enable_if<
+      !HasParametersCheck<T, MatType&(T::*)()>::value, size_t>::type
+  LayerWeights(T& /* layer */) { return 0; }
+
+  //! Return the number of weights of a layer with weights.
+  template<typename T>
+  static typename std::enable_if<
+      HasParametersCheck<T, MatType&(T::*)()>::value, size_t>::type
+  LayerWeights(T& layer) { return layer.Parameters().n_elem; }
+
+  //! Point the weights of a layer without weights (nothing to do).
+  template<typename T>
+  static typename std::enable_if<
+      !HasParametersCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerSetWeights(T& /* layer */, MatType& /* weights */,
+                  const size_t /* offset */) { }
+
+  //! Point the weights of a layer with weights into the given matrix.
+  template<typename T>
+  static typename std::enable_if<
+      HasParametersCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerSetWeights(T& layer, MatType& weights, const size_t offset);
+
+  //! Reset a layer without a Reset() method (nothing to do).
+  template<typename T>
+  static typename std::enable_if<
+      !HasResetCheck<T, void(T::*)()>::value, void>::type
+  LayerReset(T& /* layer */) { }
+
+  //! Reset a layer with a Reset() method.
+  template<typename T>
+  static typename std::enable_if<
+      HasResetCheck<T, void(T::*)()>::value, void>::type
+  LayerReset(T& layer) { layer.Reset(); }
+
+  //! Point the gradient of a layer without gradient (nothing to do).
+  template<typename T>
+  static typename std::enable_if<
+      !HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerSetGradient(T& /* layer */, MatType& /* gradient */,
+                   const size_t /* offset */) { }
+
+  //! Point the gradient of a layer with gradient into the given matrix.
+  template<typename T>
+  static typename std::enable_if<
+      HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerSetGradient(T& layer, MatType& gradient, const size_t offset);
+
+  //! Compute the gradient of a layer without gradient (nothing to do).
+  template<typename T>
+  static typename std::enable_if<
+      !HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerGradient(T& /* layer */, const MatType& /* input */,
+                const MatType& /* error */) { }
+
+  //! Compute the gradient of a layer with gradient.
+  template<typename T>
+  static typename std::enable_if<
+      HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerGradient(T& layer, const MatType& input, const MatType& error)
+  { layer.Gradient(input, error, layer.Gradient()); }
+
+  //! Set the deterministic parameter of a layer that does not have one
+  //! (nothing to do).
+  template<typename T>
+  static typename std::enable_if<
+      !HasDeterministicCheck<T, bool&(T::*)(void)>::value, void>::type
+  LayerDeterministic(T& /* layer */, const bool /* deterministic */) { }
+
+  //! Set the deterministic parameter of a layer.
+  template<typename T>
+  static typename std::enable_if<
+      HasDeterministicCheck<T, bool&(T::*)(void)>::value, void>::type
+  LayerDeterministic(T& layer, const bool deterministic)
+  { layer.Deterministic() = deterministic; }
+
+  //! Return the loss of a layer without loss.
+  template<typename T>
+  static typename std::enable_if<
+      !HasLoss<T, double(T::*)()>::value, double>::type
+  LayerLoss(T& /* layer */) { return 0; }
+
+  //! Return the loss of a layer with loss.
+  template<typename T>
+  static typename std::enable_if<
+      HasLoss<T, double(T::*)()>::value, double>::type
+  LayerLoss(T& layer) { return layer.Loss(); }
+
+  //! The layers of the network.
+  std::tuple<Layers...> layers;
+
+  //! Instantiated outputlayer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The offset of the weights of each layer in the parameters; the last
+  //! element is the total number of weights.
+  std::array<size_t, sizeof...(Layers) + 1> offsets;
+
+  //! The matrix of data points (predictors).
+  MatType predictors;
+
+  //! The matrix of responses to the input data points.
+  MatType responses;
+
+  //! Matrix of (trained) parameters.
+  MatType parameter;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  MatType error;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+
+  //! The factor the error of the output layer is multiplied by.
+  double lossScale;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
@@ -0,0 +1,629 @@
+/**
+ * @file methods/ann/static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class, a feed forward network whose layers
+ * are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+#include "master_weights_function.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    Layers... layers) :
+    layers(std::move(layers)...),
+    numFunctions(0),
+    deterministic(false),
+    lossScale(1.0)
+{
+  offsets.fill(0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule,
+    Layers... layers) :
+    layers(std::move(layers)...),
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    numFunctions(0),
+    deterministic(false),
+    lossScale(1.0)
+{
+  offsets.fill(0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    const StaticFFN& other) :
+    layers(other.layers),
+    outputLayer(other.outputLayer),
+    initializeRule(other.initializeRule),
+    offsets(other.offsets),
+    predictors(other.predictors),
+    responses(other.responses),
+    parameter(other.parameter),
+    numFunctions(other.numFunctions),
+    deterministic(other.deterministic),
+    lossScale(other.lossScale)
+{
+  // The copied layers still point to the parameters of the other network.
+  if (!parameter.is_empty())
+    SetWeights<0>(HasLayer<0>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::operator=(
+    const StaticFFN& other)
+{
+  if (this != &other)
+  {
+    layers = other.layers;
+    outputLayer = other.outputLayer;
+    initializeRule = other.initializeRule;
+    offsets = other.offsets;
+    predictors = other.predictors;
+    responses = other.responses;
+    parameter = other.parameter;
+    numFunctions = other.numFunctions;
+    deterministic = other.deterministic;
+    lossScale = other.lossScale;
+
+    if (!parameter.is_empty())
+      SetWeights<0>(HasLayer<0>());
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    MatType predictors,
+    MatType responses,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+
+  if (parameter.is_empty())
+    ResetParameters();
+  SetDeterministic(false);
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "StaticFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    MatType predictors,
+    MatType responses,
+    CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses), optimizer,
+      callbacks...);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::TrainWithMasterWeights(MatType predictors,
+                                       MatType responses,
+                                       OptimizerType& optimizer,
+                                       const double lossScale,
+                                       const size_t growthInterval,
+                                       CallbackTypes&&... callbacks)
+{
+  static_assert(IsArmaType::value, "StaticFFN::TrainWithMasterWeights() "
+      "requires an Armadillo matrix type.");
+
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+
+  if (parameter.is_empty())
+    ResetParameters();
+  SetDeterministic(false);
+
+  arma::mat masterParameter = arma::conv_to<arma::mat>::from(parameter);
+  MasterWeightsFunction<StaticFFN> function(*this, lossScale, growthInterval);
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(function, masterParameter,
+      callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  // The layers alias the parameters, so they are overwritten in place.
+  for (size_t i = 0; i < parameter.n_elem; ++i)
+    parameter[i] = static_cast<ElemType>(masterParameter[i]);
+  this->lossScale = 1.0;
+
+  Log::Info << "StaticFFN::TrainWithMasterWeights(): final objective of "
+      << "trained model is " << out << " (" << function.SkippedSteps()
+      << " batches skipped because of non-finite gradients)." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Predict(
+    const MatType& predictors, MatType& results, const size_t batchSize)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("StaticFFN::Predict(): the batch size must be "
+        "greater than 0");
+  }
+
+  if (parameter.is_empty())
+    ResetParameters();
+  SetDeterministic(true);
+
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
+
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - begin);
+
+    // The layers only read their input, so the batch can alias the
+    // predictors.
+    Forward(math::MakeAlias(const_cast<MatType&>(predictors),
+        begin * predictors.n_rows, predictors.n_rows, effectiveBatchSize));
+
+    const MatType& output = NetworkOutput();
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(begin, begin + effectiveBatchSize - 1) = output;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+typename StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& predictors, const MatType& responses)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+  SetDeterministic(true);
+
+  Forward(predictors);
+  return outputLayer.Forward(NetworkOutput(), responses) +
+      Loss<0>(HasLayer<0>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+typename StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& parameters)
+{
+  ElemType res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+typename StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& /* parameters */,
+    const size_t begin,
+    const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+  SetDeterministic(true);
+
+  Forward(math::MakeAlias(predictors, begin * predictors.n_rows,
+      predictors.n_rows, batchSize));
+  return outputLayer.Forward(NetworkOutput(),
+      responses.cols(begin, begin + batchSize - 1)) + Loss<0>(HasLayer<0>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+typename StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const MatType& parameters, MatType& gradient)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // Sum the gradients of each point.
+  gradient.zeros(parameter.n_rows, parameter.n_cols);
+  MatType pointGradient;
+  ElemType res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+  {
+    res += EvaluateWithGradient(parameters, i, pointGradient, 1);
+    gradient += pointGradient;
+  }
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+typename StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ElemType
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const MatType& /* parameters */,
+                     const size_t begin,
+                     MatType& gradient,
+                     const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (gradient.n_rows != parameter.n_rows ||
+      gradient.n_cols != parameter.n_cols)
+    gradient.zeros(parameter.n_rows, parameter.n_cols);
+  else
+    gradient.zeros();
+
+  SetDeterministic(false);
+
+  const MatType input = math::MakeAlias(predictors,
+      begin * predictors.n_rows, predictors.n_rows, batchSize);
+  Forward(input);
+  const ElemType res = OutputLayerForwardBackward(
+      responses.cols(begin, begin + batchSize - 1)) + Loss<0>(HasLayer<0>());
+  if (lossScale != 1.0)
+    error *= static_cast<ElemType>(lossScale);
+
+  Backward(input, gradient);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    const MatType& parameters,
+    const size_t begin,
+    MatType& gradient,
+    const size_t batchSize)
+{
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Shuffle()
+{
+  ShufflePoints(IsArmaType());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ResetParameters()
+{
+  offsets[0] = 0;
+  ComputeOffsets<0>(HasLayer<0>());
+  InitializeParameters(IsArmaType());
+
+  SetWeights<0>(HasLayer<0>());
+  ResetDeterministic<0>(HasLayer<0>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::InitializeParameters(std::true_type /* isArmaType */)
+{
+  parameter.set_size(offsets[sizeof...(Layers)], 1);
+
+  // Initialize the network layer by layer or the complete network.
+  if (InitTraits<InitializationRuleType>::UseLayer)
+  {
+    for (size_t i = 0; i < sizeof...(Layers); ++i)
+    {
+      MatType tmp = math::MakeAlias(parameter, offsets[i],
+          offsets[i + 1] - offsets[i], 1, false);
+      initializeRule.Initialize(tmp, tmp.n_elem, 1);
+    }
+  }
+  else
+  {
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::InitializeParameters(std::false_type /* isArmaType */)
+{
+  // The initialization rules only fill Armadillo matrices; the parameters are
+  // copied to the device once.
+  arma::Mat<ElemType> hostParameter(offsets[sizeof...(Layers)], 1);
+  if (InitTraits<InitializationRuleType>::UseLayer)
+  {
+    for (size_t i = 0; i < sizeof...(Layers); ++i)
+    {
+      arma::Mat<ElemType> tmp = math::MakeAlias(hostParameter, offsets[i],
+          offsets[i + 1] - offsets[i], 1, false);
+      initializeRule.Initialize(tmp, tmp.n_elem, 1);
+    }
+  }
+  else
+  {
+    initializeRule.Initialize(hostParameter, hostParameter.n_elem, 1);
+  }
+
+  parameter = MatType(hostParameter);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ShufflePoints(std::true_type /* isArmaType */)
+{
+  math::ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ShufflePoints(std::false_type /* isArmaType */)
+{
+  arma::Mat<ElemType> hostPredictors(predictors);
+  arma::Mat<ElemType> hostResponses(responses);
+  math::ShuffleData(hostPredictors, hostResponses, hostPredictors,
+      hostResponses);
+
+  predictors = MatType(hostPredictors);
+  responses = MatType(hostResponses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  SerializeLayers<0>(ar, HasLayer<0>());
+
+  // Point the loaded layers to the loaded parameters.
+  if (Archive::is_loading::value)
+  {
+    offsets[0] = 0;
+    ComputeOffsets<0>(HasLayer<0>());
+    if (!parameter.is_empty())
+      SetWeights<0>(HasLayer<0>());
+    ResetDeterministic<0>(HasLayer<0>());
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ComputeOffsets(std::true_type /* hasLayer */)
+{
+  static_assert(!HasModelCheck<typename std::tuple_element<I,
+      std::tuple<Layers...> >::type>::value, "StaticFFN does not support "
+      "layers that hold other layers.");
+
+  offsets[I + 1] = offsets[I] + LayerWeights(std::get<I>(layers));
+  ComputeOffsets<I + 1>(HasLayer<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::SetWeights(std::true_type /* hasLayer */)
+{
+  LayerSetWeights(std::get<I>(layers), parameter, offsets[I]);
+  LayerReset(std::get<I>(layers));
+  SetWeights<I + 1>(HasLayer<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ResetGradients(MatType& gradient,
+                               std::true_type /* hasLayer */)
+{
+  LayerSetGradient(std::get<I>(layers), gradient, offsets[I]);
+  ResetGradients<I + 1>(gradient, HasLayer<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::ResetDeterministic(std::true_type /* hasLayer */)
+{
+  LayerDeterministic(std::get<I>(layers), deterministic);
+  ResetDeterministic<I + 1>(HasLayer<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+double StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::Loss(std::true_type /* hasLayer */)
+{
+  return LayerLoss(std::get<I>(layers)) + Loss<I + 1>(HasLayer<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::Forward(std::true_type /* hasLayer */)
+{
+  std::get<I>(layers).Forward(std::get<I - 1>(layers).OutputParameter(),
+      std::get<I>(layers).OutputParameter());
+  Forward<I + 1>(HasLayer<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::Backward(std::true_type /* isNotFirst */)
+{
+  std::get<I>(layers).Backward(std::get<I>(layers).OutputParameter(),
+      LayerError<I>(HasLayer<I + 1>()), std::get<I>(layers).Delta());
+  Backward<I - 1>(std::integral_constant<bool, (I > 1)>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::Gradient(const MatType& input, std::true_type /* hasLayer */)
+{
+  LayerGradient(std::get<I>(layers),
+      LayerInput<I>(input, std::integral_constant<bool, (I > 0)>()),
+      LayerError<I>(HasLayer<I + 1>()));
+  Gradient<I + 1>(input, HasLayer<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I, typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::SerializeLayers(Archive& ar, std::true_type /* hasLayer */)
+{
+  ar & boost::serialization::make_nvp("layer", std::get<I>(layers));
+  SerializeLayers<I + 1>(ar, HasLayer<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+const typename StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::MatType&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::LayerInput(
+    const MatType& /* input */, std::true_type /* isNotFirst */)
+{
+  return std::get<I - 1>(layers).OutputParameter();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+const typename StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::MatType&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::LayerError(
+    std::true_type /* isNotLast */)
+{
+  return std::get<I + 1>(layers).Delta();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Forward(
+    const MatType& input)
+{
+  std::get<0>(layers).Forward(input, std::get<0>(layers).OutputParameter());
+  Forward<1>(HasLayer<1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Backward(
+    const MatType& input, MatType& gradient)
+{
+  // The first layer does not need its delta, so it is not backpropagated.
+  Backward<sizeof...(Layers) - 1>(
+      std::integral_constant<bool, (sizeof...(Layers) > 1)>());
+
+  ResetGradients<0>(gradient, HasLayer<0>());
+  Gradient<0>(input, HasLayer<0>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::SetDeterministic(const bool deterministic)
+{
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic<0>(HasLayer<0>());
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename T>
+typename std::enable_if<
+    HasParametersCheck<T, MatType&(T::*)()>::value, void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::LayerSetWeights(
+    T& layer, MatType& weights, const size_t offset)
+{
+  layer.Parameters() = math::MakeAlias(weights, offset,
+      layer.Parameters().n_rows, layer.Parameters().n_cols, false);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename T>
+typename std::enable_if<
+    HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+StaticFFN<OutputLayerType, InitializationRuleType,
+    Layers...>::LayerSetGradient(T& layer,
+                                 MatType& gradient,
+                                 const size_t offset)
+{
+  layer.Gradient() = math::MakeAlias(gradient, offset,
+      layer.Parameters().n_rows, layer.Parameters().n_cols, false);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file methods/ann/visitor/sparse_forward_visitor.hpp
+ *
+ * This file provides an abstraction for the Forward() function of the first
+ * layer of a network that is given a sparse input.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SPARSE_FORWARD_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SPARSE_FORWARD_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include "forward_visitor.hpp"
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SparseForwardVisitor executes the Forward() function given a sparse input
+ * and the output parameter.  Layers that don't support sparse inputs (see
+ * LayerTraits::SupportsSparseInput) are given a dense copy of the input.
+ */
+class SparseForwardVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Execute the Forward() function given the input and output parameter.
+  SparseForwardVisitor(const arma::sp_mat& input, arma::mat& output);
+
+  //! Execute the Forward() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The input parameter set.
+  const arma::sp_mat& input;
+
+  //! The output parameter set.
+  arma::mat& output;
+
+  //! Execute the sparse Forward() function of the layer.
+  template<typename T>
+  typename std::enable_if<
+      LayerTraits<T>::SupportsSparseInput, void>::type
+  LayerForward(T* layer) const;
+
+  //! Execute the Forward() function of the layer on a dense copy of the input.
+  template<typename T>
+  typename std::enable_if<
+      !LayerTraits<T>::SupportsSparseInput, void>::type
+  LayerForward(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_forward_visitor_impl.hpp"
+
+#endif
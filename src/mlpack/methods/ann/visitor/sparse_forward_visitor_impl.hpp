@@ -0,0 +1,61 @@
+/**
+ * @file methods/ann/visitor/sparse_forward_visitor_impl.hpp
+ *
+ * Implementation of the sparse Forward() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SPARSE_FORWARD_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SPARSE_FORWARD_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_forward_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! SparseForwardVisitor visitor class.
+inline SparseForwardVisitor::SparseForwardVisitor(const arma::sp_mat& input,
+                                                  arma::mat& output) :
+    input(input),
+    output(output)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void SparseForwardVisitor::operator()(LayerType* layer) const
+{
+  LayerForward(layer);
+}
+
+inline void SparseForwardVisitor::operator()(MoreTypes layer) const
+{
+  layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    LayerTraits<T>::SupportsSparseInput, void>::type
+SparseForwardVisitor::LayerForward(T* layer) const
+{
+  layer->Forward(input, output);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !LayerTraits<T>::SupportsSparseInput, void>::type
+SparseForwardVisitor::LayerForward(T* layer) const
+{
+  const arma::mat denseInput(input);
+  const ForwardVisitor visitor(denseInput, output);
+  visitor(layer);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file methods/ann/visitor/sparse_gradient_visitor.hpp
+ *
+ * This file provides an abstraction for the Gradient() function of the first
+ * layer of a network that is given a sparse input.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include "gradient_visitor.hpp"
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SparseGradientVisitor executes the Gradient() method of the given module
+ * using a sparse input and the delta parameter.  Layers that don't support
+ * sparse inputs (see LayerTraits::SupportsSparseInput) are given a dense copy
+ * of the input.
+ */
+class SparseGradientVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Executes the Gradient() method of the given module using the input and
+  //! delta parameter.
+  SparseGradientVisitor(const arma::sp_mat& input, const arma::mat& delta);
+
+  //! Executes the Gradient() method.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The input set.
+  const arma::sp_mat& input;
+
+  //! The delta parameter.
+  const arma::mat& delta;
+
+  //! Execute the sparse Gradient() function of the layer.
+  template<typename T>
+  typename std::enable_if<
+      LayerTraits<T>::SupportsSparseInput, void>::type
+  LayerGradients(T* layer) const;
+
+  //! Execute the Gradient() function of the layer (if any) on a dense copy of
+  //! the input.
+  template<typename T>
+  typename std::enable_if<
+      !LayerTraits<T>::SupportsSparseInput, void>::type
+  LayerGradients(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_gradient_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file methods/ann/visitor/truncate_backward_visitor.hpp
+ *
+ * Boost static visitor abstraction for calling the TruncateBackward() function
+ * of recurrent layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_TRUNCATE_BACKWARD_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_TRUNCATE_BACKWARD_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * TruncateBackwardVisitor executes the TruncateBackward() function, and
+ * returns whether the layer implements it, that is, whether the layer is a
+ * recurrent layer which carries state from one time step to the next.
+ */
+class TruncateBackwardVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Execute the TruncateBackward() function.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+  bool operator()(MoreTypes layer) const;
+
+ private:
+  //! Execute the TruncateBackward() function for a module which implements
+  //! the TruncateBackward() function.
+  template<typename T>
+  typename std::enable_if<
+      HasTruncateBackwardCheck<T, void(T::*)()>::value, bool>::type
+  TruncateBackward(T* layer) const;
+
+  //! Do not execute the TruncateBackward() function for a module which
+  //! doesn't implement it.
+  template<typename T>
+  typename std::enable_if<
+      !HasTruncateBackwardCheck<T, void(T::*)()>::value, bool>::type
+  TruncateBackward(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "truncate_backward_visitor_impl.hpp"
+
+#endif
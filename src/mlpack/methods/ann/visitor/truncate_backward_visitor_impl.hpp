@@ -0,0 +1,52 @@
+/**
+ * @file methods/ann/visitor/truncate_backward_visitor_impl.hpp
+ *
+ * Implementation of the TruncateBackward() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_TRUNCATE_BACKWARD_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_TRUNCATE_BACKWARD_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "truncate_backward_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! TruncateBackwardVisitor visitor class.
+template<typename LayerType>
+inline bool TruncateBackwardVisitor::operator()(LayerType* layer) const
+{
+  return TruncateBackward(layer);
+}
+
+inline bool TruncateBackwardVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasTruncateBackwardCheck<T, void(T::*)()>::value, bool>::type
+TruncateBackwardVisitor::TruncateBackward(T* layer) const
+{
+  layer->TruncateBackward();
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasTruncateBackwardCheck<T, void(T::*)()>::value, bool>::type
+TruncateBackwardVisitor::TruncateBackward(T* /* layer */) const
+{
+  return false;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
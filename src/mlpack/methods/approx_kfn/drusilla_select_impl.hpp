@@ -78,10 +78,12 @@ void DrusillaSelect<MatType>::Train(
         "large!  Choose smaller values.  l*m must be smaller than the number "
         "of points in the dataset.");
 
+  typedef typename MatType::elem_type ElemType;
+
   candidateSet.set_size(referenceSet.n_rows, l * m);
   candidateIndices.set_size(l * m);
 
-  arma::vec dataMean(arma::mean(referenceSet, 1));
+  arma::Col<ElemType> dataMean(arma::mean(referenceSet, 1));
   arma::vec norms(referenceSet.n_cols);
 
   MatType refCopy(referenceSet.n_rows, referenceSet.n_cols);
@@ -98,7 +100,11 @@ void DrusillaSelect<MatType>::Train(
     arma::uword maxIndex = 0;
     norms.max(maxIndex);
 
-    arma::vec line(refCopy.col(maxIndex) / arma::norm(refCopy.col(maxIndex)));
+    arma::Col<ElemType> line(refCopy.col(maxIndex) /
+        arma::norm(refCopy.col(maxIndex)));
+
+    // Project every point onto the line at once.
+    const arma::Row<ElemType> offsets = line.t() * refCopy;
 
     // Calculate distortion and offset and make scores.
     std::vector<bool> closeAngle(referenceSet.n_cols, false);
@@ -107,7 +113,7 @@ void DrusillaSelect<MatType>::Train(
     {
       if (norms[j] > 0.0)
       {
-        const double offset = arma::dot(refCopy.col(j), line);
+        const double offset = offsets[j];
         const double distortion = arma::norm(refCopy.col(j) - offset * line);
         sums[j] = std::abs(offset) - std::abs(distortion);
         closeAngle[j] =
@@ -187,9 +193,19 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
       tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
       rules(candidateSet, querySet, k, metric, 0, false);
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+  // Compare blocks of query points with the whole candidate set, so that the
+  // distances can be computed with matrix products for dense data.
+  const size_t blockSize = 256;
+  std::vector<size_t> queryIndices;
+  for (size_t begin = 0; begin < querySet.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+    queryIndices.resize(end - begin);
+    for (size_t q = begin; q < end; ++q)
+      queryIndices[q - begin] = q;
+
+    rules.BaseCaseBlock(queryIndices, 0, candidateSet.n_cols);
+  }
 
   rules.GetResults(neighbors, distances);
 
@@ -34,6 +34,9 @@ template<typename MatType = arma::mat>
 class QDAFN
 {
  public:
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
   /**
    * Construct the QDAFN object but do not train it.  Be sure to call Train()
    * before calling Search().
@@ -73,6 +76,10 @@ class QDAFN
    * can contain just one point, that is okay.)  The results will be stored in
    * the given neighbors and distances matrices, in the same format as the
    * mlpack NeighborSearch and LSHSearch classes.
+   *
+   * All the query points are projected onto the lines with a single matrix
+   * product, and the distances to the candidates of each table are computed
+   * as a block.
    */
   void Search(const MatType& querySet,
               const size_t k,
@@ -97,17 +104,39 @@ class QDAFN
   //! The number of elements to store for each projection.
   size_t m;
   //! The random lines we are projecting onto.  Has l columns.
-  arma::mat lines;
+  arma::Mat<ElemType> lines;
   //! Projections of each point onto each random line.
-  arma::mat projections;
+  arma::Mat<ElemType> projections;
 
   //! Indices of the points for each S.
   arma::Mat<size_t> sIndices;
   //! Values of a_i * x for each point in S.
-  arma::mat sValues;
+  arma::Mat<ElemType> sValues;
 
   // Candidate sets; one element in the vector for each table.
   std::vector<MatType> candidateSet;
+
+  /**
+   * Compute the distances between the query point and the first count
+   * candidates of the given table as a block, for dense data.
+   */
+  template<typename VecType>
+  static void CandidateDistances(const MatType& candidates,
+                                 const size_t count,
+                                 const VecType& query,
+                                 arma::Row<ElemType>& distances,
+                                 const std::true_type /* dense */);
+
+  /**
+   * Compute the distances between the query point and the first count
+   * candidates of the given table one at a time, for sparse data.
+   */
+  template<typename VecType>
+  static void CandidateDistances(const MatType& candidates,
+                                 const size_t count,
+                                 const VecType& query,
+                                 arma::Row<ElemType>& distances,
+                                 const std::false_type /* dense */);
 };
 
 } // namespace neighbor
@@ -16,6 +16,8 @@
 #include "qdafn.hpp"
 
 #include <queue>
+#include <numeric>
+#include <algorithm>
 #include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
 
 namespace mlpack {
@@ -64,7 +66,7 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   mlpack::distribution::GaussianDistribution gd(referenceSet.n_rows);
   lines.set_size(referenceSet.n_rows, l);
   for (size_t i = 0; i < l; ++i)
-    lines.col(i) = gd.Random();
+    lines.col(i) = arma::conv_to<arma::Col<ElemType>>::from(gd.Random());
 
   // Now, project each of the reference points onto each line, and collect the
   // top m elements.
@@ -74,10 +76,19 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   sIndices.set_size(m, l);
   sValues.set_size(m, l);
   candidateSet.resize(l);
+  std::vector<size_t> sortedIndices(projections.n_rows);
   for (size_t i = 0; i < l; ++i)
   {
     candidateSet[i].set_size(referenceSet.n_rows, m);
-    arma::uvec sortedIndices = arma::sort_index(projections.col(i), "descend");
+
+    // Only the top m elements need to be sorted.
+    std::iota(sortedIndices.begin(), sortedIndices.end(), 0);
+    const ElemType* projection = projections.colptr(i);
+    std::partial_sort(sortedIndices.begin(), sortedIndices.begin() + m,
+        sortedIndices.end(), [projection](const size_t a, const size_t b)
+        {
+          return projection[a] > projection[b];
+        });
 
     // Grab the top m elements.
     for (size_t j = 0; j < m; ++j)
@@ -104,6 +115,13 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
+  // Project all the query points onto all the lines at once.
+  const arma::Mat<ElemType> queryProjections = lines.t() * querySet;
+
+  arma::Col<size_t> tableCounts(l);
+  std::vector<std::pair<double, size_t>> results(m);
+  arma::Row<ElemType> tableDistances;
+
   // Search for each point.
   for (size_t q = 0; q < querySet.n_cols; ++q)
   {
@@ -113,40 +131,27 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     std::priority_queue<std::pair<double, size_t>> queue;
     for (size_t i = 0; i < l; ++i)
     {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
+      const double val = sValues(0, i) - queryProjections(i, q);
       queue.push(std::make_pair(val, i));
     }
 
-    // To track where we are in each S table, we keep the next index to look at
-    // in each table (they start at 0).
-    arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
-
-    // Now that the queue is initialized, iterate over m elements.
-    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
-        size_t(-1)));
-    std::priority_queue<std::pair<double, size_t>>
-        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
+    // Now that the queue is initialized, iterate over m elements.  The elements
+    // of each table are visited in order, so we only need to count how many
+    // elements of each table are visited.
+    tableCounts.zeros();
     for (size_t i = 0; i < m; ++i)
     {
-      std::pair<size_t, double> p = queue.top();
+      std::pair<double, size_t> p = queue.top();
       queue.pop();
 
       // Get index of reference point to look at.
-      const size_t tableIndex = tableLocations[p.second];
-
-      // Calculate distance from query point.
-      const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
-
-      resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
+      const size_t tableIndex = tableCounts[p.second]++;
 
       // Now (line 14) get the next element and insert into the queue.  Do this
       // by adjusting the previous value.  Don't insert anything if we are at
       // the end of the search, though.
       if (i < m - 1)
       {
-        tableLocations[p.second]++;
         const double val = p.first - sValues(tableIndex, p.second) +
             sValues(tableIndex + 1, p.second);
 
@@ -154,28 +159,69 @@ void QDAFN<MatType>::Search(const MatType& querySet,
       }
     }
 
-    // Extract the results and deduplicate them.
-    size_t extracted = 1;
-    neighbors(0, q) = resultsQueue.top().second;
-    distances(0, q) = resultsQueue.top().first;
-    resultsQueue.pop();
-
-    while (!resultsQueue.empty())
+    // Calculate the distances from the query point to the visited elements,
+    // one block per table.
+    size_t numResults = 0;
+    for (size_t t = 0; t < l; ++t)
     {
-      if (extracted == k)
-        break;
-
-      std::pair<double, size_t> result = resultsQueue.top();
-      resultsQueue.pop();
+      if (tableCounts[t] == 0)
+        continue;
 
-      // Avoid inserting any duplicates.
-      if (neighbors(extracted - 1, q) != result.second)
+      CandidateDistances(candidateSet[t], tableCounts[t], querySet.col(q),
+          tableDistances, std::integral_constant<bool,
+          arma::is_Mat<MatType>::value>());
+      for (size_t j = 0; j < tableCounts[t]; ++j)
       {
-        neighbors(extracted, q) = resultsQueue.top().second;
-        distances(extracted, q) = resultsQueue.top().first;
-        ++extracted;
+        results[numResults++] = std::make_pair((double) tableDistances[j],
+            sIndices(j, t));
       }
     }
+
+    // Extract the furthest results and deduplicate them; a point that was
+    // found in several tables has the same distance each time, so duplicates
+    // are next to each other once sorted.
+    std::sort(results.begin(), results.end(),
+        std::greater<std::pair<double, size_t>>());
+
+    size_t extracted = 0;
+    for (size_t i = 0; (i < m) && (extracted < k); ++i)
+    {
+      if (extracted > 0 && neighbors(extracted - 1, q) == results[i].second)
+        continue;
+
+      neighbors(extracted, q) = results[i].second;
+      distances(extracted, q) = results[i].first;
+      ++extracted;
+    }
+  }
+}
+
+template<typename MatType>
+template<typename VecType>
+void QDAFN<MatType>::CandidateDistances(const MatType& candidates,
+                                        const size_t count,
+                                        const VecType& query,
+                                        arma::Row<ElemType>& distances,
+                                        const std::true_type /* dense */)
+{
+  const arma::Col<ElemType> queryCol(query);
+  distances = arma::sqrt(arma::sum(arma::square(
+      candidates.head_cols(count).each_col() - queryCol), 0));
+}
+
+template<typename MatType>
+template<typename VecType>
+void QDAFN<MatType>::CandidateDistances(const MatType& candidates,
+                                        const size_t count,
+                                        const VecType& query,
+                                        arma::Row<ElemType>& distances,
+                                        const std::false_type /* dense */)
+{
+  distances.set_size(count);
+  for (size_t j = 0; j < count; ++j)
+  {
+    distances[j] = mlpack::metric::EuclideanDistance::Evaluate(query,
+        candidates.col(j));
   }
 }
 
@@ -13,6 +13,10 @@
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::regression;
 
@@ -27,23 +31,156 @@ BayesianLinearRegression::BayesianLinearRegression(const bool centerData,
   responsesOffset(0.0),
   alpha(0.0),
   beta(0.0),
-  gamma(0.0)
+  gamma(0.0),
+  numPoints(0),
+  responsesMean(0.0),
+  responsesM2(0.0)
 {/* Nothing to do */}
 
 double BayesianLinearRegression::Train(const arma::mat& data,
                                        const arma::rowvec& responses)
 {
+  ResetStatistics();
+  Accumulate(data, responses);
+  Train();
+
+  return RMSE(data, responses);
+}
+
+void BayesianLinearRegression::Accumulate(const arma::mat& data,
+                                          const arma::rowvec& responses)
+{
+  if (responses.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "BayesianLinearRegression::Accumulate(): number of responses ("
+        << responses.n_elem << ") must be equal to the number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numPoints > 0 && data.n_rows != pointsMean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "BayesianLinearRegression::Accumulate(): dimensionality of the "
+        << "points (" << data.n_rows << ") must be equal to the "
+        << "dimensionality of the points added before (" << pointsMean.n_elem
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0)
+    return;
+
+  if (numPoints == 0)
+  {
+    pointsMean.zeros(data.n_rows);
+    pointsM2.zeros(data.n_rows, data.n_rows);
+    crossM2.zeros(data.n_rows);
+    responsesMean = 0.0;
+    responsesM2 = 0.0;
+  }
+
+  // Split the points into one block per thread.  The statistics of each block
+  // (centered on the mean of the block) are computed in parallel, and then
+  // merged in order, so the result does not depend on the scheduling.
+  #ifdef HAS_OPENMP
+  const size_t numBlocks = std::min((size_t) omp_get_max_threads(),
+      (size_t) data.n_cols);
+  #else
+  const size_t numBlocks = 1;
+  #endif
+
+  std::vector<arma::colvec> blockMeans(numBlocks);
+  std::vector<arma::mat> blockM2(numBlocks);
+  std::vector<arma::colvec> blockCrossM2(numBlocks);
+  std::vector<double> blockResponsesMeans(numBlocks);
+  std::vector<double> blockResponsesM2(numBlocks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = ((size_t) b * data.n_cols) / numBlocks;
+    const size_t end = (((size_t) b + 1) * data.n_cols) / numBlocks;
+
+    arma::mat centered = data.cols(begin, end - 1);
+    arma::rowvec centeredResponses = responses.subvec(begin, end - 1);
+    blockMeans[b] = arma::mean(centered, 1);
+    blockResponsesMeans[b] = arma::mean(centeredResponses);
+    centered.each_col() -= blockMeans[b];
+    centeredResponses -= blockResponsesMeans[b];
+
+    blockM2[b] = centered * centered.t();
+    blockCrossM2[b] = centered * centeredResponses.t();
+    blockResponsesM2[b] = arma::dot(centeredResponses, centeredResponses);
+  }
+
+  // Merge the statistics of the blocks with those of the previous points (see
+  // Chan, Golub and LeVeque, "Algorithms for computing the sample variance").
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t blockSize = ((b + 1) * data.n_cols) / numBlocks -
+        (b * data.n_cols) / numBlocks;
+    const double total = (double) (numPoints + blockSize);
+    const double weight = (double) numPoints * blockSize / total;
+
+    const arma::colvec delta = blockMeans[b] - pointsMean;
+    const double responsesDelta = blockResponsesMeans[b] - responsesMean;
+
+    pointsM2 += blockM2[b] + weight * (delta * delta.t());
+    crossM2 += blockCrossM2[b] + (weight * responsesDelta) * delta;
+    responsesM2 += blockResponsesM2[b] +
+        weight * responsesDelta * responsesDelta;
+    pointsMean += (blockSize / total) * delta;
+    responsesMean += (blockSize / total) * responsesDelta;
+    numPoints += blockSize;
+  }
+}
+
+double BayesianLinearRegression::Train()
+{
+  if (numPoints == 0)
+  {
+    throw std::invalid_argument("BayesianLinearRegression::Train(): no points "
+        "were added with Accumulate()!");
+  }
+
   Timer::Start("bayesian_linear_regression");
 
-  arma::mat phi;
-  arma::rowvec t;
-  arma::colvec eigVal;
-  arma::mat eigVec;
+  const double n = (double) numPoints;
 
-  // Preprocess the data. Center and scale.
-  responsesOffset = CenterScaleData(data, responses, phi, t);
+  // Compute phi * phi^T, phi * t^T and t * t^T of the centered and scaled
+  // training set (phi, t) from its statistics.
+  arma::mat phiPhiT;
+  arma::colvec phiT;
+  double tT;
+  if (centerData)
+  {
+    dataOffset = pointsMean;
+    responsesOffset = responsesMean;
+    phiPhiT = pointsM2;
+    phiT = crossM2;
+    tT = responsesM2;
+  }
+  else
+  {
+    responsesOffset = 0.0;
+    phiPhiT = pointsM2 + n * (pointsMean * pointsMean.t());
+    phiT = crossM2 + (n * responsesMean) * pointsMean;
+    tT = responsesM2 + n * responsesMean * responsesMean;
+  }
 
-  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phi * phi.t())))
+  if (scaleData)
+  {
+    dataScale = arma::sqrt(pointsM2.diag() / (n - 1));
+    phiPhiT.each_col() /= dataScale;
+    phiPhiT.each_row() /= dataScale.t();
+    phiT /= dataScale;
+  }
+
+  arma::colvec eigVal;
+  arma::mat eigVec;
+  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phiPhiT)))
   {
     Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
                << "of covariance failed!" << std::endl;
@@ -51,11 +188,11 @@ double BayesianLinearRegression::Train(const arma::mat& data,
 
   // Compute this quantities once and for all.
   const arma::mat eigVecInv = inv(eigVec);
-  const arma::colvec eigVecInvPhitT = eigVecInv * phi * t.t();
+  const arma::colvec eigVecInvPhitT = eigVecInv * phiT;
 
   // Initialize the hyperparameters and begin with an infinitely broad prior.
   alpha = 1e-6;
-  beta =  1 / (var(t, 1) * 0.1);
+  beta =  1 / (responsesM2 / n * 0.1);
 
   unsigned short i = 0;
   double deltaAlpha = 1.0, deltaBeta = 1.0, crit = 1.0;
@@ -73,8 +210,7 @@ double BayesianLinearRegression::Train(const arma::mat& data,
     alpha = gamma / dot(omega, omega);
 
     // Update beta.
-    const arma::rowvec temp = t - omega.t() * phi;
-    beta = (data.n_cols - gamma) / dot(temp, temp);
+    beta = (n - gamma) / ResidualNorm(phiPhiT, phiT, tT);
 
     // Compute the stopping criterion.
     deltaAlpha += alpha;
@@ -87,7 +223,17 @@ double BayesianLinearRegression::Train(const arma::mat& data,
 
   Timer::Stop("bayesian_linear_regression");
 
-  return RMSE(data, responses);
+  return std::sqrt(ResidualNorm(phiPhiT, phiT, tT) / n);
+}
+
+void BayesianLinearRegression::ResetStatistics()
+{
+  numPoints = 0;
+  pointsMean.reset();
+  pointsM2.reset();
+  crossM2.reset();
+  responsesMean = 0.0;
+  responsesM2 = 0.0;
 }
 
 void BayesianLinearRegression::Predict(const arma::mat& points,
@@ -119,46 +265,16 @@ double BayesianLinearRegression::RMSE(const arma::mat& data,
   return sqrt(mean(square(responses - predictions)));
 }
 
-double BayesianLinearRegression::CenterScaleData(const arma::mat& data,
-                                                 const arma::rowvec& responses,
-                                                 arma::mat& dataProc,
-                                                 arma::rowvec& responsesProc)
+double BayesianLinearRegression::ResidualNorm(const arma::mat& phiPhiT,
+                                              const arma::colvec& phiT,
+                                              const double tT) const
 {
-  if (!centerData && !scaleData)
-  {
-    dataProc = arma::mat(const_cast<double*>(data.memptr()), data.n_rows,
-                                             data.n_cols, false, true);
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else if (centerData && !scaleData)
-  {
-    dataOffset = mean(data, 1);
-    responsesOffset = mean(responses);
-    dataProc = data.each_col() - dataOffset;
-    responsesProc = responses - responsesOffset;
-  }
-
-  else if (!centerData && scaleData)
-  {
-    dataScale = stddev(data, 0, 1);
-    dataProc = data.each_col() / dataScale;
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else
-  {
-    dataOffset = mean(data, 1);
-    dataScale = stddev(data, 0, 1);
-    responsesOffset = mean(responses);
-    dataProc = (data.each_col() - dataOffset).each_col() / dataScale;
-    responsesProc = responses - responsesOffset;
-  }
-  return responsesOffset;
+  // ||t - omega^T phi||^2 = t t^T - 2 omega^T phi t^T + omega^T phi phi^T
+  // omega.  The expansion cancels when the fit is (almost) exact, so the result
+  // is kept above the rounding error of t t^T.
+  const double norm = tT - 2 * arma::dot(omega, phiT) +
+      arma::as_scalar(omega.t() * phiPhiT * omega);
+  return std::max(norm, std::numeric_limits<double>::epsilon() * tT);
 }
 
 void BayesianLinearRegression::CenterScaleDataPred(
@@ -127,6 +127,49 @@ class BayesianLinearRegression
   double Train(const arma::mat& data,
                const arma::rowvec& responses);
 
+  /**
+   * Add the given points to the statistics of the training set, without
+   * training the model; call Train() once all the points have been added.
+   * Only the means and the second moments (of size P x P) of the points are
+   * kept, so a training set that does not fit in memory can be added in
+   * chunks, for instance with data::ChunkedLoader:
+   *
+   * @code
+   * data::ChunkedLoader<double> loader("dataset.csv", 100000);
+   * BayesianLinearRegression estimator;
+   * arma::mat chunk;
+   * while (loader.Next(chunk))
+   * {
+   *   // The responses are the last dimension of the dataset.
+   *   estimator.Accumulate(chunk.rows(0, chunk.n_rows - 2),
+   *       chunk.row(chunk.n_rows - 1));
+   * }
+   * estimator.Train();
+   * @endcode
+   *
+   * The points are split into blocks whose products are computed in parallel,
+   * if OpenMP is available.
+   *
+   * @param data Column-major input data, dim(P, N).
+   * @param responses A vector of targets, dim(N).
+   */
+  void Accumulate(const arma::mat& data, const arma::rowvec& responses);
+
+  /**
+   * Train the model on the points added with Accumulate() since the last call
+   * to ResetStatistics().  Only the statistics of the points are used, so the
+   * cost of each iteration does not depend on the number of points.
+   *
+   * @return Root mean squared error on the added points.
+   */
+  double Train();
+
+  //! Forget the points added with Accumulate().
+  void ResetStatistics();
+
+  //! Get the number of points added with Accumulate().
+  size_t NumPoints() const { return numPoints; }
+
   /**
    * Predict \f$y_{i}\f$ for each data point in the given data matrix using the
    * currently-trained Bayesian Ridge model.
@@ -257,20 +300,35 @@ class BayesianLinearRegression
   //! Covariance matrix of the solution vector omega.
   arma::mat matCovariance;
 
+  //! Number of points added with Accumulate().
+  size_t numPoints;
+
+  //! Mean of the points added with Accumulate().
+  arma::colvec pointsMean;
+
+  //! Sum of the outer products of the centered points, dim(P, P).
+  arma::mat pointsM2;
+
+  //! Sum of the centered points weighted by the centered responses.
+  arma::colvec crossM2;
+
+  //! Mean of the responses added with Accumulate().
+  double responsesMean;
+
+  //! Sum of the squares of the centered responses.
+  double responsesM2;
+
   /**
-   * Center and scale the data accordind to centerData and scaleData.
-   * Allows future modifications of new points.
+   * Compute the squared norm of the residuals t - omega^T phi of the centered
+   * and scaled training set from its statistics.
    *
-   * @param data Design matrix in column-major format, dim(P, N).
-   * @param responses A vector of targets.
-   * @param dataProc Data processed, dim(P, N).
-   * @param responsesProc Responses processed, dim(N).
-   * @return reponsesOffset Mean of responses.
+   * @param phiPhiT phi * phi^T, dim(P, P).
+   * @param phiT phi * t^T, dim(P).
+   * @param tT t * t^T.
    */
-  double CenterScaleData(const arma::mat& data,
-                         const arma::rowvec& responses,
-                         arma::mat& dataProc,
-                         arma::rowvec& responsesProc);
+  double ResidualNorm(const arma::mat& phiPhiT,
+                      const arma::colvec& phiT,
+                      const double tT) const;
 
   /**
    * Center and scale the points before prediction.
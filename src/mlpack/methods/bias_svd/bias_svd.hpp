@@ -19,6 +19,7 @@
 #include <mlpack/methods/cf/cf.hpp>
 
 #include "bias_svd_function.hpp"
+#include <mlpack/methods/regularized_svd/blocked_sgd.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -59,7 +60,8 @@ class BiasSVD
  public:
   /**
    * Constructor of Bias SVD. By default SGD optimizer is used in BiasSVD.
-   * The optimizer uses a template specialization of Optimize().
+   * The optimizer uses a template specialization of Optimize().  If
+   * OptimizerType is BlockedSGD, the ratings are processed in parallel.
    *
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
@@ -100,6 +100,20 @@ class BiasSVDFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Take one stochastic gradient descent step on the given rating: only the
+   * parameters of the user and the item of the rating are updated.
+   * This is used by the SGD optimizers.
+   *
+   * @param parameters Parameters(user/item matrices/bias) of the
+   *     decomposition.
+   * @param i Index of the rating.
+   * @param stepSize Step size of the update.
+   */
+  void Update(arma::mat& parameters,
+              const size_t i,
+              const double stepSize) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
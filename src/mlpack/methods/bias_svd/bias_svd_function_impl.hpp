@@ -178,6 +178,37 @@ void BiasSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void BiasSVDFunction<MatType>::Update(arma::mat& parameters,
+                                      const size_t i,
+                                      const double stepSize) const
+{
+  // Indices for accessing the the correct parameter columns.
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+
+  // Prediction error for the example.
+  const double rating = data(2, i);
+  const double userBias = parameters(rank, user);
+  const double itemBias = parameters(rank, item);
+  double ratingError = rating - userBias - itemBias -
+      arma::dot(parameters.col(user).subvec(0, rank - 1),
+                parameters.col(item).subvec(0, rank - 1));
+
+  // Gradient is non-zero only for the parameter columns corresponding to the
+  // example.
+  parameters.col(user).subvec(0, rank - 1) -= stepSize * 2 *(
+      lambda * parameters.col(user).subvec(0, rank - 1) -
+      ratingError * parameters.col(item).subvec(0, rank - 1));
+  parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(item).subvec(0, rank - 1) -
+      ratingError * parameters.col(user).subvec(0, rank - 1));
+  parameters(rank, user) -= stepSize * 2 * (
+      lambda * parameters(rank, user) - ratingError);
+  parameters(rank, item) -= stepSize * 2 * (
+      lambda * parameters(rank, item) - ratingError);
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -201,11 +232,6 @@ double StandardSGD::Optimize(
   for (size_t i = 0; i < numFunctions; ++i)
     overallObjective += function.Evaluate(parameters, i);
 
-  const arma::mat data = function.Dataset();
-
-  // Rank of decomposition.
-  const size_t rank = function.Rank();
-
   // Now iterate!
   for (size_t i = 1; i != maxIterations; ++i, currentFunction++)
   {
@@ -221,34 +247,7 @@ double StandardSGD::Optimize(
       currentFunction = 0;
     }
 
-    const size_t numUsers = function.NumUsers();
-
-    // Indices for accessing the the correct parameter columns.
-    const size_t user = data(0, currentFunction);
-    const size_t item = data(1, currentFunction) + numUsers;
-
-    // Prediction error for the example.
-    const double rating = data(2, currentFunction);
-    const double userBias = parameters(rank, user);
-    const double itemBias = parameters(rank, item);
-    double ratingError = rating - userBias - itemBias -
-        arma::dot(parameters.col(user).subvec(0, rank - 1),
-                  parameters.col(item).subvec(0, rank - 1));
-
-    double lambda = function.Lambda();
-
-    // Gradient is non-zero only for the parameter columns corresponding to the
-    // example.
-    parameters.col(user).subvec(0, rank - 1) -= stepSize * 2 *(
-        lambda * parameters.col(user).subvec(0, rank - 1) -
-        ratingError * parameters.col(item).subvec(0, rank - 1));
-    parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
-        lambda * parameters.col(item).subvec(0, rank - 1) -
-        ratingError * parameters.col(user).subvec(0, rank - 1));
-    parameters(rank, user) -= stepSize * 2 * (
-        lambda * parameters(rank, user) - ratingError);
-    parameters(rank, item) -= stepSize * 2 * (
-        lambda * parameters(rank, item) - ratingError);
+    function.Update(parameters, currentFunction, stepSize);
 
     // Now add that to the overall objective function.
     overallObjective += function.Evaluate(parameters, currentFunction);
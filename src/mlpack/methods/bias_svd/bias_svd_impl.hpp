@@ -42,14 +42,22 @@ void BiasSVD<OptimizerType>::Apply(const arma::mat& data,
   Log::Warn << "The batch size for optimizing BiasSVD is 1."
       << std::endl;
 
-  // Make the optimizer object using a BiasSVDFunction object.
+  // Make the function to optimize using a BiasSVDFunction object.
   BiasSVDFunction<arma::mat> biasSVDFunc(data, rank, lambda);
-  ens::StandardSGD optimizer(alpha, batchSize,
-      iterations * data.n_cols);
 
   // Get optimized parameters.
   arma::mat parameters = biasSVDFunc.GetInitialPoint();
-  optimizer.Optimize(biasSVDFunc, parameters);
+  if (std::is_same<OptimizerType, BlockedSGD>::value)
+  {
+    // Each iteration is one pass over the ratings, in parallel.
+    BlockedSGD optimizer(alpha, iterations);
+    optimizer.Optimize(biasSVDFunc, parameters);
+  }
+  else
+  {
+    ens::StandardSGD optimizer(alpha, batchSize, iterations * data.n_cols);
+    optimizer.Optimize(biasSVDFunc, parameters);
+  }
 
   // Constants for extracting user and item matrices.
   const size_t numUsers = max(data.row(0)) + 1;
@@ -11,6 +11,7 @@
  */
 
 #include "randomized_block_krylov_svd.hpp"
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -43,13 +44,65 @@ RandomizedBlockKrylovSVD::RandomizedBlockKrylovSVD(const size_t maxIterations,
   /* Nothing to do here */
 }
 
+//! Compute output = data * m for dense data.
+static void Multiply(const arma::mat& data,
+                     const arma::mat& m,
+                     arma::mat& output)
+{
+  output = data * m;
+}
+
+//! Compute output = data * m for sparse data, without densifying the data.
+static void Multiply(const arma::sp_mat& data,
+                     const arma::mat& m,
+                     arma::mat& output)
+{
+  math::SparseMultiply(data, m, output);
+}
+
+//! Compute output = data^T * m for dense data.
+static void TransMultiply(const arma::mat& data,
+                          const arma::mat& m,
+                          arma::mat& output)
+{
+  output = data.t() * m;
+}
+
+//! Compute output = data^T * m for sparse data, without forming the transpose
+//! of the data.
+static void TransMultiply(const arma::sp_mat& data,
+                          const arma::mat& m,
+                          arma::mat& output)
+{
+  math::SparseTransMultiply(data, m, output);
+}
+
 void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
                                      arma::mat& u,
                                      arma::vec& s,
                                      arma::mat& v,
                                      const size_t rank)
 {
-  arma::mat Q, R, block, blockIteration;
+  ApplyInternal(data, u, s, v, rank);
+}
+
+void RandomizedBlockKrylovSVD::Apply(const arma::sp_mat& data,
+                                     arma::mat& u,
+                                     arma::vec& s,
+                                     arma::mat& v,
+                                     const size_t rank)
+{
+  ApplyInternal(data, u, s, v, rank);
+}
+
+template<typename MatType>
+void RandomizedBlockKrylovSVD::ApplyInternal(const MatType& data,
+                                             arma::mat& u,
+                                             arma::vec& s,
+                                             arma::mat& v,
+                                             const size_t rank)
+{
+  arma::mat Q, R, block, blockIteration, product, dataBlock;
 
   if (blockSize == 0)
   {
@@ -65,7 +118,8 @@ void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
   // Create a working matrix using data from writable auxiliary memory
   // (K matrix). Doing so avoids an uncessary copy in upcoming step.
   block = arma::mat(K.memptr(), data.n_rows, blockSize, false, false);
-  arma::qr_econ(block, R, data * G);
+  Multiply(data, G, product);
+  arma::qr_econ(block, R, product);
 
   for (size_t blockOffset = block.n_elem; blockOffset < K.n_elem;
       blockOffset += block.n_elem)
@@ -74,7 +128,9 @@ void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
     blockIteration = arma::mat(K.memptr() + blockOffset, block.n_rows,
         block.n_cols, false, false);
 
-    arma::qr_econ(blockIteration, R, data * (data.t() * block));
+    TransMultiply(data, block, dataBlock);
+    Multiply(data, dataBlock, product);
+    arma::qr_econ(blockIteration, R, product);
 
     // Update working matrix for the next iteration.
     block = arma::mat(K.memptr() + blockOffset, block.n_rows, block.n_cols,
@@ -84,7 +140,8 @@ void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
   arma::qr_econ(Q, R, K);
 
   // Approximate eigenvalues and eigenvectors using Rayleigh–Ritz method.
-  arma::svd_econ(u, s, v, Q.t() * data);
+  TransMultiply(data, Q, product);
+  arma::svd_econ(u, s, v, product.t());
 
   // Do economical singular value decomposition and compute only the
   // approximations of the left singular vectors by using the centered data
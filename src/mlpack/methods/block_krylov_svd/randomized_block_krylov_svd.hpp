@@ -104,6 +104,24 @@ class RandomizedBlockKrylovSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set using
+   * the randomized block krylov SVD.  The data is never densified, and the
+   * products with the data are computed in parallel (see
+   * math::SparseMultiply()).
+   *
+   * @param data Sparse data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank);
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -115,6 +133,14 @@ class RandomizedBlockKrylovSVD
   size_t& BlockSize() { return blockSize; }
 
  private:
+  //! Compute the decomposition of dense or sparse data.
+  template<typename MatType>
+  void ApplyInternal(const MatType& data,
+                     arma::mat& u,
+                     arma::vec& s,
+                     arma::mat& v,
+                     const size_t rank);
+
   //! Locally stored number of iterations for the power method.
   size_t maxIterations;
 
@@ -18,6 +18,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
@@ -143,6 +145,30 @@ class CFType
              const double minResidue = 1e-5,
              const bool mit = false);
 
+  /**
+   * Fold new ratings into the model without training it again, so that new
+   * users (and new items) get recommendations right away.  The new ratings are
+   * normalized with the statistics of the training ratings and added to the
+   * cleaned data (replacing the ratings of the same users and items, if any).
+   * Then the factors of each user of the new ratings are solved against the
+   * fixed factors of the items, with the regularized least squares problem of
+   * the ratings of the user; the factors of the new items are solved against
+   * the fixed factors of the users in the same way, and then the users are
+   * solved again to take their ratings of the new items into account.
+   *
+   * The factors of the existing items are not changed, so the model drifts
+   * from the model that Train() would give as more ratings are folded in; it
+   * should be trained again from time to time.  Folding in the ratings of
+   * existing users updates their factors.
+   *
+   * The DecompositionPolicy must provide FoldInUsers() and FoldInItems(), as
+   * all the decomposition policies of mlpack do.
+   *
+   * @param data New ratings; dense matrix (coordinate lists).
+   * @param lambda Regularization parameter of the least squares problems.
+   */
+  void FoldIn(const arma::mat& data, const double lambda = 0.05);
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -216,6 +242,54 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Generates the given number of recommendations for all users, using
+   * max-kernel search over the factors of the items (see the other overload).
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations into.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetRecommendationsFastMKS(const size_t numRecs,
+                                 arma::Mat<size_t>& recommendations);
+
+  /**
+   * Generates the given number of recommendations for the specified users,
+   * like GetRecommendations(), but without computing the rating of every item
+   * for every user.  The predicted ratings of a user are the inner products of
+   * the factors of the items (see the GetItemFactors() method of the
+   * decomposition policy) with a weighted sum of the factors of the neighbors
+   * of the user, so the best items are found with FastMKS and a linear kernel,
+   * which takes time sublinear in the number of items for each user, once a
+   * cover tree is built on the items.  Since the tree is built at each call,
+   * it is best to get the recommendations of many users with one call.
+   *
+   * The recommendations are the same as those of GetRecommendations() (up to
+   * ties), as long as denormalizing a rating is an increasing affine function
+   * of the rating, plus a term that depends on the user and a term that
+   * depends on the item.  This holds for all the normalizations of mlpack.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetRecommendationsFastMKS(const size_t numRecs,
+                                 arma::Mat<size_t>& recommendations,
+                                 const arma::Col<size_t>& users);
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -154,6 +154,55 @@ Train(const arma::sp_mat& data,
   Timer::Stop("cf_factorization");
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldIn(const arma::mat& data, const double lambda)
+{
+  if (data.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldIn(): the new ratings should have 3 rows (user, item, "
+        << "rating), but they have " << data.n_rows << " rows";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0)
+    return;
+
+  // Normalize the new ratings like the training ratings.
+  arma::mat normalizedData(data);
+  normalization.FoldIn(normalizedData);
+  arma::sp_mat newRatings;
+  CleanData(normalizedData, newRatings);
+
+  // Merge the new ratings into the cleaned data; a new rating replaces the
+  // existing rating of the same user and item.
+  const size_t oldItems = cleanedData.n_rows;
+  const size_t numItems = std::max(cleanedData.n_rows, newRatings.n_rows);
+  const size_t numUsers = std::max(cleanedData.n_cols, newRatings.n_cols);
+  cleanedData.resize(numItems, numUsers);
+  newRatings.resize(numItems, numUsers);
+  cleanedData = cleanedData - cleanedData % arma::spones(newRatings) +
+      newRatings;
+
+  const arma::Col<size_t> users = arma::conv_to<arma::Col<size_t>>::from(
+      arma::unique(data.row(0)));
+  const arma::Col<size_t> items = arma::conv_to<arma::Col<size_t>>::from(
+      arma::unique(data.row(1)));
+  const arma::Col<size_t> newItems = items.elem(arma::find(items >= oldItems));
+
+  Timer::Start("cf_fold_in");
+  decomposition.FoldInUsers(cleanedData, users, lambda);
+  if (newItems.n_elem > 0)
+  {
+    decomposition.FoldInItems(cleanedData, newItems, lambda);
+    decomposition.FoldInUsers(cleanedData, users, lambda);
+  }
+  Timer::Stop("cf_fold_in");
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename NeighborSearchPolicy,
@@ -273,6 +322,124 @@ GetRecommendations(const size_t numRecs,
   }
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRecommendationsFastMKS(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations)
+{
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0,
+      cleanedData.n_cols - 1, cleanedData.n_cols);
+
+  GetRecommendationsFastMKS<NeighborSearchPolicy,
+                            InterpolationPolicy>(numRecs, recommendations,
+                                                 users);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRecommendationsFastMKS(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations,
+                          const arma::Col<size_t>& users)
+{
+  const size_t numItems = cleanedData.n_rows;
+
+  // Calculate the neighborhood of the queried users, as GetRecommendations()
+  // does.
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
+
+  // The denormalized rating of item j for user u is slope * rating + a_u + c_j;
+  // find the slope and the terms of the items (relative to the first item), so
+  // that the items can be ranked by an inner product.
+  const double base = normalization.Denormalize(0, 0, 0.0);
+  const double slope = normalization.Denormalize(0, 0, 1.0) - base;
+  if (!(slope > 0.0))
+  {
+    throw std::invalid_argument("CFType::GetRecommendationsFastMKS(): "
+        "denormalized ratings must increase with the ratings");
+  }
+
+  // The factors of each item, with an extra dimension for the terms of the
+  // items.
+  arma::mat itemFactors;
+  decomposition.GetItemFactors(itemFactors);
+  itemFactors.resize(itemFactors.n_rows + 1, itemFactors.n_cols);
+  for (size_t j = 0; j < numItems; ++j)
+  {
+    itemFactors(itemFactors.n_rows - 1, j) =
+        (normalization.Denormalize(0, j, 0.0) - base) / slope;
+  }
+
+  // The query of each user is the weighted sum of the factors of its
+  // neighbors.
+  arma::mat queries(itemFactors.n_rows, users.n_elem);
+  InterpolationPolicy interpolation(cleanedData);
+  size_t maxRated = 0;
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    arma::vec weights(numUsersForSimilarity);
+    interpolation.GetWeights(weights, decomposition, users(i),
+        neighborhood.col(i), similarities.col(i), cleanedData);
+
+    arma::vec query(itemFactors.n_rows - 1, arma::fill::zeros);
+    arma::vec userFactors;
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    {
+      decomposition.GetUserFactors(neighborhood(j, i), userFactors);
+      query += weights(j) * userFactors;
+    }
+
+    queries.col(i).subvec(0, query.n_elem - 1) = query;
+    queries(query.n_elem, i) = 1.0;
+
+    maxRated = std::max(maxRated,
+        (size_t) cleanedData.col(users(i)).n_nonzero);
+  }
+
+  // Search for enough items that the best un-rated items are found for each
+  // user.
+  const size_t k = std::min(numRecs + maxRated, numItems);
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  if (k > 0)
+  {
+    fastmks::FastMKS<kernel::LinearKernel> fastmks(std::move(itemFactors));
+    fastmks.Search(queries, k, indices, kernels);
+  }
+
+  // Take the best un-rated items of each user; the items are sorted by
+  // decreasing predicted rating.
+  recommendations.set_size(numRecs, users.n_elem);
+  recommendations.fill(numItems);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    size_t found = 0;
+    for (size_t j = 0; j < k && found < numRecs; ++j)
+    {
+      // The algorithm omits rating of zero, as in GetRecommendations().
+      if (cleanedData(indices(j, i), users(i)) == 0.0)
+        recommendations(found++, i) = indices(j, i);
+    }
+
+    // If we were not able to come up with enough recommendations, issue a
+    // warning.
+    if (found < numRecs)
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
+  }
+}
+
 // Predict the rating for a single user/item combination.
 template<typename DecompositionPolicy,
          typename NormalizationType>
@@ -115,6 +115,28 @@ class RecommendationVisitor : public boost::static_visitor<void>
   void operator()(CFType<DecompositionPolicy, NormalizationType>* c) const;
 };
 
+/**
+ * FoldInVisitor folds new ratings into the CFType object (see
+ * CFType::FoldIn()).
+ */
+class FoldInVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! New ratings.
+  const arma::mat& data;
+  //! Regularization parameter.
+  const double lambda;
+
+ public:
+  //! Visitor constructor.
+  FoldInVisitor(const arma::mat& data, const double lambda);
+
+  //! Fold the new ratings into the model.
+  template <typename DecompositionPolicy,
+            typename NormalizationType = NoNormalization>
+  void operator()(CFType<DecompositionPolicy, NormalizationType>* c) const;
+};
+
 /**
  * The model to save to disk.
  */
@@ -195,6 +217,9 @@ class CFModel
              const bool mit,
              const std::string& normalizationType = "none");
 
+  //! Fold new ratings (of new or existing users) into the model.
+  void FoldIn(const arma::mat& data, const double lambda = 0.05);
+
   //! Make predictions.
   template <typename NeighborSearchPolicy,
             typename InterpolationPolicy>
@@ -105,6 +105,23 @@ void RecommendationVisitor<NeighborSearchPolicy, InterpolationPolicy>
         (numRecs, recommendations);
 }
 
+inline FoldInVisitor::FoldInVisitor(const arma::mat& data,
+                                    const double lambda) :
+    data(data),
+    lambda(lambda)
+{ }
+
+template <typename DecompositionPolicy,
+          typename NormalizationType>
+void FoldInVisitor::operator()(
+    CFType<DecompositionPolicy, NormalizationType>* c) const
+{
+  if (!c)
+    throw std::runtime_error("no cf model initialized");
+
+  c->FoldIn(data, lambda);
+}
+
 CFModel::~CFModel()
 {
   boost::apply_visitor(DeleteVisitor(), cf);
@@ -163,6 +180,13 @@ void CFModel::Train(const MatType& data,
   }
 }
 
+//! Fold new ratings into the model.
+inline void CFModel::FoldIn(const arma::mat& data, const double lambda)
+{
+  FoldInVisitor foldIn(data, lambda);
+  boost::apply_visitor(foldIn, cf);
+}
+
 //! Make predictions.
 template <typename NeighborSearchPolicy,
           typename InterpolationPolicy>
@@ -0,0 +1,276 @@
+/**
+ * @file methods/cf/decomposition_policies/als_method.hpp
+ *
+ * Implementation of the weighted alternating least squares method for use in
+ * Collaborative Filtering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/amf/amf.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Implementation of the ALS policy to act as a wrapper when accessing
+ * weighted alternating least squares (see amf::WeightedALSUpdate) from within
+ * CFType.  Unlike NMFPolicy, only the observed ratings are fitted, and the
+ * factors of each user and item are solved in parallel, so this policy is
+ * suited to large and very sparse rating matrices.  With implicit feedback,
+ * the ratings should be non-negative (such as counts), and NoNormalization
+ * should be used.
+ *
+ * An example of how to use ALSPolicy in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * ALSPolicy als(0.05); // Regularization parameter.
+ * CFType<ALSPolicy> cf(data, als);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.GetRecommendations(10, recommendations);
+ * @endcode
+ */
+class ALSPolicy
+{
+ public:
+  /**
+   * Use ALS method to perform collaborative filtering.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether the ratings are implicit feedback.
+   * @param alpha Confidence scale of implicit feedback.
+   */
+  ALSPolicy(const double lambda = 0.05,
+            const bool implicit = false,
+            const double alpha = 40.0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Apply Collaborative Filtering to the provided dataset using weighted
+   * alternating least squares.
+   *
+   * @param * (data) Data matrix: dense matrix (coordinate lists)
+   *    or sparse matrix (cleaned).
+   * @param cleanedData item user table in form of sparse matrix.
+   * @param rank Rank parameter for matrix factorization.
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  template<typename MatType>
+  void Apply(const MatType& /* data */,
+             const arma::sp_mat& cleanedData,
+             const size_t rank,
+             const size_t maxIterations,
+             const double minResidue,
+             const bool mit)
+  {
+    amf::WeightedALSUpdate update(lambda, implicit, alpha);
+    if (mit)
+    {
+      amf::MaxIterationTermination iter(maxIterations);
+      amf::AMF<amf::MaxIterationTermination, amf::RandomInitialization,
+          amf::WeightedALSUpdate> als(iter, amf::RandomInitialization(),
+          update);
+      als.Apply(cleanedData, rank, w, h);
+    }
+    else
+    {
+      amf::SimpleResidueTermination srt(minResidue, maxIterations);
+      amf::AMF<amf::SimpleResidueTermination, amf::RandomInitialization,
+          amf::WeightedALSUpdate> als(srt, amf::RandomInitialization(),
+          update);
+      als.Apply(cleanedData, rank, w, h);
+    }
+  }
+
+  /**
+   * Return predicted rating given user ID and item ID.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double GetRating(const size_t user, const size_t item) const
+  {
+    double rating = arma::as_scalar(w.row(item) * h.col(user));
+    return rating;
+  }
+
+  /**
+   * Get predicted ratings for a user.
+   *
+   * @param user User ID.
+   * @param rating Resulting rating vector.
+   */
+  void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    rating = w * h.col(user);
+  }
+
+  /**
+   * Get the factors of the items: the rating of an item by a user is the inner
+   * product of the column of the item and of the factors of the user (see
+   * GetUserFactors()).
+   *
+   * @param itemFactors Matrix to store the factors of each item in.
+   */
+  void GetItemFactors(arma::mat& itemFactors) const
+  {
+    itemFactors = w.t();
+  }
+
+  /**
+   * Get the factors of a user (see GetItemFactors()).
+   *
+   * @param user User ID.
+   * @param userFactors Vector to store the factors of the user in.
+   */
+  void GetUserFactors(const size_t user, arma::vec& userFactors) const
+  {
+    userFactors = h.col(user);
+  }
+
+  /**
+   * Fold the given users into the decomposition: the factors of each user are
+   * solved against the fixed factors of the items, with the regularized least
+   * squares problem of the ratings of the user (see details::FoldInFactors()).
+   * The ratings of items without factors are ignored.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param users Users to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& users,
+                   const double lambda)
+  {
+    details::FoldInUsers(cleanedData, users, lambda, w, h);
+  }
+
+  /**
+   * Fold the given items into the decomposition: the factors of each item are
+   * solved against the fixed factors of the users, with the regularized least
+   * squares problem of the ratings of the item.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param items Items to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& items,
+                   const double lambda)
+  {
+    details::FoldInItems(cleanedData, items, lambda, w, h);
+  }
+
+  /**
+   * Get the neighborhood and corresponding similarities for a set of users.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors returned for
+   *     each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       const size_t numUsersForSimilarity,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const
+  {
+    // We want to avoid calculating the full rating matrix, so we will do
+    // nearest neighbor search only on the H matrix, using the observation that
+    // if the rating matrix X = W*H, then d(X.col(i), X.col(j)) = d(W H.col(i),
+    // W H.col(j)).  This can be seen as nearest neighbor search on the H
+    // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
+    // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
+    // H by L^T. Then we can perform nearest neighbor search.
+    arma::mat l = arma::chol(w.t() * w);
+    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
+
+    // Temporarily store feature vector of queried users.
+    arma::mat query(stretchedH.n_rows, users.n_elem);
+    // Select feature vectors of queried users.
+    for (size_t i = 0; i < users.n_elem; ++i)
+      query.col(i) = stretchedH.col(users(i));
+
+    NeighborSearchPolicy neighborSearch(stretchedH);
+    neighborSearch.Search(
+        query, numUsersForSimilarity, neighborhood, similarities);
+  }
+
+  //! Get the Item Matrix.
+  const arma::mat& W() const { return w; }
+  //! Get the User Matrix.
+  const arma::mat& H() const { return h; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the ratings are implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the ratings are implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence scale of implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scale of implicit feedback.
+  double& Alpha() { return alpha; }
+
+  /**
+   * Serialization.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(w);
+    ar & BOOST_SERIALIZATION_NVP(h);
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(implicit);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+  }
+
+ private:
+  //! Regularization parameter.
+  double lambda;
+  //! Whether the ratings are implicit feedback.
+  bool implicit;
+  //! Confidence scale of implicit feedback.
+  double alpha;
+  //! Item matrix.
+  arma::mat w;
+  //! User matrix.
+  arma::mat h;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,7 @@
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -107,6 +108,62 @@ class BatchSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get the factors of the items: the rating of an item by a user is the inner
+   * product of the column of the item and of the factors of the user (see
+   * GetUserFactors()).
+   *
+   * @param itemFactors Matrix to store the factors of each item in.
+   */
+  void GetItemFactors(arma::mat& itemFactors) const
+  {
+    itemFactors = w.t();
+  }
+
+  /**
+   * Get the factors of a user (see GetItemFactors()).
+   *
+   * @param user User ID.
+   * @param userFactors Vector to store the factors of the user in.
+   */
+  void GetUserFactors(const size_t user, arma::vec& userFactors) const
+  {
+    userFactors = h.col(user);
+  }
+
+  /**
+   * Fold the given users into the decomposition: the factors of each user are
+   * solved against the fixed factors of the items, with the regularized least
+   * squares problem of the ratings of the user (see details::FoldInFactors()).
+   * The ratings of items without factors are ignored.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param users Users to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& users,
+                   const double lambda)
+  {
+    details::FoldInUsers(cleanedData, users, lambda, w, h);
+  }
+
+  /**
+   * Fold the given items into the decomposition: the factors of each item are
+   * solved against the fixed factors of the users, with the regularized least
+   * squares problem of the ratings of the item.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param items Items to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& items,
+                   const double lambda)
+  {
+    details::FoldInItems(cleanedData, items, lambda, w, h);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
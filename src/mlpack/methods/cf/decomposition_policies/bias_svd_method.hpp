@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/bias_svd/bias_svd.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -47,13 +48,17 @@ class BiasSVDPolicy
    * @param maxIterations Number of iterations.
    * @param alpha Learning rate for optimization.
    * @param lambda Regularization parameter for optimization.
+   * @param parallel Whether to optimize with svd::BlockedSGD, which processes
+   *     the ratings in parallel.
    */
   BiasSVDPolicy(const size_t maxIterations = 10,
                 const double alpha = 0.02,
-                const double lambda = 0.05) :
+                const double lambda = 0.05,
+                const bool parallel = false) :
       maxIterations(maxIterations),
       alpha(alpha),
-      lambda(lambda)
+      lambda(lambda),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -78,8 +83,16 @@ class BiasSVDPolicy
              const bool /* mit */)
   {
     // Perform decomposition using the bias SVD algorithm.
-    svd::BiasSVD<> biassvd(maxIterations, alpha, lambda);
-    biassvd.Apply(data, rank, w, h, p, q);
+    if (parallel)
+    {
+      svd::BiasSVD<svd::BlockedSGD> biassvd(maxIterations, alpha, lambda);
+      biassvd.Apply(data, rank, w, h, p, q);
+    }
+    else
+    {
+      svd::BiasSVD<> biassvd(maxIterations, alpha, lambda);
+      biassvd.Apply(data, rank, w, h, p, q);
+    }
   }
 
   /**
@@ -106,6 +119,95 @@ class BiasSVDPolicy
     rating = w * h.col(user) + p + q(user);
   }
 
+  /**
+   * Get the factors of the items: the rating of an item by a user is the inner
+   * product of the column of the item and of the factors of the user (see
+   * GetUserFactors()).  The biases are held by two extra dimensions.
+   *
+   * @param itemFactors Matrix to store the factors of each item in.
+   */
+  void GetItemFactors(arma::mat& itemFactors) const
+  {
+    itemFactors.set_size(w.n_cols + 2, w.n_rows);
+    itemFactors.rows(0, w.n_cols - 1) = w.t();
+    itemFactors.row(w.n_cols) = p.t();
+    itemFactors.row(w.n_cols + 1).ones();
+  }
+
+  /**
+   * Get the factors of a user (see GetItemFactors()).
+   *
+   * @param user User ID.
+   * @param userFactors Vector to store the factors of the user in.
+   */
+  void GetUserFactors(const size_t user, arma::vec& userFactors) const
+  {
+    userFactors.set_size(h.n_rows + 2);
+    userFactors.subvec(0, h.n_rows - 1) = h.col(user);
+    userFactors[h.n_rows] = 1.0;
+    userFactors[h.n_rows + 1] = q(user);
+  }
+
+  /**
+   * Fold the given users into the decomposition: the factors and the bias of
+   * each user are solved against the fixed factors and biases of the items,
+   * with the regularized least squares problem of the ratings of the user (see
+   * details::FoldInFactors()).  The ratings of items without factors are
+   * ignored.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param users Users to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& users,
+                   const double lambda)
+  {
+    // The extra row of ones gives the bias of the user.
+    const arma::mat fixed = arma::join_cols(w.t(),
+        arma::ones<arma::rowvec>(w.n_rows));
+    arma::mat factors;
+    details::FoldInFactors(fixed, p, details::FoldInUserRatings(cleanedData,
+        users), lambda, factors);
+
+    h.resize(w.n_cols, cleanedData.n_cols);
+    q.resize(cleanedData.n_cols);
+    for (size_t j = 0; j < users.n_elem; ++j)
+    {
+      h.col(users[j]) = factors.col(j).head(w.n_cols);
+      q[users[j]] = factors(w.n_cols, j);
+    }
+  }
+
+  /**
+   * Fold the given items into the decomposition: the factors and the bias of
+   * each item are solved against the fixed factors and biases of the users,
+   * with the regularized least squares problem of the ratings of the item.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param items Items to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& items,
+                   const double lambda)
+  {
+    // The extra row of ones gives the bias of the item.
+    const arma::mat fixed = arma::join_cols(h,
+        arma::ones<arma::rowvec>(h.n_cols));
+    arma::mat factors;
+    details::FoldInFactors(fixed, q, details::FoldInItemRatings(cleanedData,
+        items), lambda, factors);
+
+    w.resize(cleanedData.n_rows, h.n_rows);
+    p.resize(cleanedData.n_rows);
+    for (size_t j = 0; j < items.n_elem; ++j)
+    {
+      w.row(items[j]) = factors.col(j).head(h.n_rows).t();
+      p[items[j]] = factors(h.n_rows, j);
+    }
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -160,6 +262,11 @@ class BiasSVDPolicy
   //! Modify regularization parameter.
   double& Lambda() { return lambda; }
 
+  //! Get whether the ratings are processed in parallel (see svd::BlockedSGD).
+  bool Parallel() const { return parallel; }
+  //! Modify whether the ratings are processed in parallel.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -182,6 +289,8 @@ class BiasSVDPolicy
   double alpha;
   //! Regularization parameter for optimization.
   double lambda;
+  //! Whether the ratings are processed in parallel.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
@@ -0,0 +1,245 @@
+/**
+ * @file methods/cf/decomposition_policies/compact_method.hpp
+ *
+ * A decomposition policy that stores the factors of another decomposition
+ * policy in single precision, to reduce the memory of CF models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_COMPACT_METHOD_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_COMPACT_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/cf/decomposition_policies/nmf_method.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * CompactPolicy trains the model with another decomposition policy, and then
+ * only keeps the factors of the items and of the users (see the
+ * GetItemFactors() and GetUserFactors() methods of the decomposition
+ * policies), in single precision.  The trained factors of the other policy are
+ * discarded, so the model takes half of the memory of the factors (or less,
+ * for policies that hold more than the factors, such as the implicit data of
+ * SVDPlusPlusPolicy).  Predictions are computed from the single precision
+ * factors, with double precision sums.
+ *
+ * The neighborhood of a user is found with the distance between the predicted
+ * ratings of the users (like NMFPolicy does), for every decomposition policy.
+ * CompactPolicy does not support RegressionInterpolation, which needs the W
+ * and H matrices, nor CFType::FoldIn().
+ *
+ * An example of how to use CompactPolicy in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<CompactPolicy<BiasSVDPolicy>> cf(data);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.GetRecommendations(10, recommendations);
+ * @endcode
+ *
+ * @tparam DecompositionPolicy The policy used to train the model.
+ */
+template<typename DecompositionPolicy = NMFPolicy>
+class CompactPolicy
+{
+ public:
+  /**
+   * Create the policy, with the given (untrained) policy to train the model
+   * with.
+   *
+   * @param decomposition Policy to train the model with.
+   */
+  CompactPolicy(const DecompositionPolicy& decomposition =
+      DecompositionPolicy()) :
+      decomposition(decomposition)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Collaborative Filtering to the provided dataset with the other
+   * decomposition policy, and keep its factors in single precision.
+   *
+   * @param data Data matrix: dense matrix (coordinate lists)
+   *    or sparse matrix (cleaned).
+   * @param cleanedData item user table in form of sparse matrix.
+   * @param rank Rank parameter for matrix factorization.
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  template<typename MatType>
+  void Apply(const MatType& data,
+             const arma::sp_mat& cleanedData,
+             const size_t rank,
+             const size_t maxIterations,
+             const double minResidue,
+             const bool mit)
+  {
+    // Train a copy, so that the double precision factors are freed when we are
+    // done.
+    DecompositionPolicy trained(decomposition);
+    trained.Apply(data, cleanedData, rank, maxIterations, minResidue, mit);
+
+    {
+      arma::mat factors;
+      trained.GetItemFactors(factors);
+      itemFactors = arma::conv_to<arma::fmat>::from(factors);
+    }
+
+    userFactors.set_size(itemFactors.n_rows, cleanedData.n_cols);
+    arma::vec factors;
+    for (size_t user = 0; user < cleanedData.n_cols; ++user)
+    {
+      trained.GetUserFactors(user, factors);
+      userFactors.col(user) = arma::conv_to<arma::fvec>::from(factors);
+    }
+  }
+
+  /**
+   * Return predicted rating given user ID and item ID.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double GetRating(const size_t user, const size_t item) const
+  {
+    const float* itemColumn = itemFactors.colptr(item);
+    const float* userColumn = userFactors.colptr(user);
+    double rating = 0.0;
+    for (size_t k = 0; k < itemFactors.n_rows; ++k)
+      rating += (double) itemColumn[k] * (double) userColumn[k];
+
+    return rating;
+  }
+
+  /**
+   * Get predicted ratings for a user.
+   *
+   * @param user User ID.
+   * @param rating Resulting rating vector.
+   */
+  void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    const arma::vec factors =
+        arma::conv_to<arma::vec>::from(userFactors.col(user));
+    rating.set_size(itemFactors.n_cols);
+    for (size_t item = 0; item < itemFactors.n_cols; ++item)
+    {
+      const float* itemColumn = itemFactors.colptr(item);
+      double value = 0.0;
+      for (size_t k = 0; k < itemFactors.n_rows; ++k)
+        value += (double) itemColumn[k] * factors[k];
+      rating[item] = value;
+    }
+  }
+
+  /**
+   * Get the factors of the items: the rating of an item by a user is the inner
+   * product of the column of the item and of the factors of the user (see
+   * GetUserFactors()).
+   *
+   * @param itemFactors Matrix to store the factors of each item in.
+   */
+  void GetItemFactors(arma::mat& itemFactors) const
+  {
+    itemFactors = arma::conv_to<arma::mat>::from(this->itemFactors);
+  }
+
+  /**
+   * Get the factors of a user (see GetItemFactors()).
+   *
+   * @param user User ID.
+   * @param userFactors Vector to store the factors of the user in.
+   */
+  void GetUserFactors(const size_t user, arma::vec& userFactors) const
+  {
+    userFactors = arma::conv_to<arma::vec>::from(this->userFactors.col(user));
+  }
+
+  /**
+   * Get the neighborhood and corresponding similarities for a set of users.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors returned for
+   *     each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       const size_t numUsersForSimilarity,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const
+  {
+    // The distance between the predicted ratings of two users is the
+    // Mahalanobis distance between their factors, where M^{-1} = F F^T (F
+    // holds the factors of the items); see NMFPolicy::GetNeighborhood().  The
+    // products are summed in double precision.
+    arma::mat gram(itemFactors.n_rows, itemFactors.n_rows, arma::fill::zeros);
+    for (size_t item = 0; item < itemFactors.n_cols; ++item)
+    {
+      const arma::vec f = arma::conv_to<arma::vec>::from(
+          itemFactors.col(item));
+      gram += f * f.t();
+    }
+
+    arma::mat l = arma::chol(gram);
+    arma::mat stretched = l * arma::conv_to<arma::mat>::from(userFactors);
+
+    // Temporarily store feature vector of queried users.
+    arma::mat query(stretched.n_rows, users.n_elem);
+    // Select feature vectors of queried users.
+    for (size_t i = 0; i < users.n_elem; ++i)
+      query.col(i) = stretched.col(users(i));
+
+    NeighborSearchPolicy neighborSearch(stretched);
+    neighborSearch.Search(
+        query, numUsersForSimilarity, neighborhood, similarities);
+  }
+
+  //! Get the policy used to train the model.
+  const DecompositionPolicy& Decomposition() const { return decomposition; }
+  //! Modify the policy used to train the model.
+  DecompositionPolicy& Decomposition() { return decomposition; }
+
+  //! Get the factors of the items (one column per item).
+  const arma::fmat& ItemFactors() const { return itemFactors; }
+  //! Get the factors of the users (one column per user).
+  const arma::fmat& UserFactors() const { return userFactors; }
+
+  /**
+   * Serialization.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(decomposition);
+    ar & BOOST_SERIALIZATION_NVP(itemFactors);
+    ar & BOOST_SERIALIZATION_NVP(userFactors);
+  }
+
+ private:
+  //! The (untrained) policy used to train the model.
+  DecompositionPolicy decomposition;
+  //! Factors of the items.
+  arma::fmat itemFactors;
+  //! Factors of the users.
+  arma::fmat userFactors;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
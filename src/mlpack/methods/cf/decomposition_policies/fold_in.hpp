@@ -0,0 +1,238 @@
+/**
+ * @file methods/cf/decomposition_policies/fold_in.hpp
+ *
+ * Utilities shared by the decomposition policies to fold new users and new
+ * items into a trained decomposition, without training it again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+namespace details {
+
+/**
+ * Solve for the factors of each column of the given ratings, keeping the
+ * factors of the rows fixed.  The factors x of column j minimize
+ *
+ * \f[
+ * \sum_{i \in R(j)} (r_{ij} - o_i - f_i^T x)^2 + \lambda |R(j)| \| x \|^2
+ * \f]
+ *
+ * where R(j) is the set of the rows that have a rating in column j, f_i is
+ * column i of the fixed factors and o_i is the offset of row i (such as an item
+ * bias).  The rows that have no fixed factors (their index is at least the
+ * number of columns of the fixed factors) are ignored, and a column without any
+ * rating gets zero factors.  The columns are solved in parallel when mlpack is
+ * compiled with OpenMP.
+ *
+ * @param fixed Fixed factors, one column per row of the ratings.
+ * @param offsets Offset of each row of the ratings; may be empty.
+ * @param ratings Ratings to solve the factors of, one column per problem.
+ * @param lambda Regularization parameter.
+ * @param factors Matrix to store the factors in, one column per problem.
+ */
+inline void FoldInFactors(const arma::mat& fixed,
+                          const arma::vec& offsets,
+                          const arma::sp_mat& ratings,
+                          const double lambda,
+                          arma::mat& factors)
+{
+  const size_t rank = fixed.n_rows;
+  factors.set_size(rank, ratings.n_cols);
+  ratings.sync();
+
+  #pragma omp parallel
+  {
+    arma::mat a(rank, rank);
+    arma::vec b(rank);
+    arma::mat r;
+    arma::vec x, y;
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) ratings.n_cols; ++j)
+    {
+      a.zeros();
+      b.zeros();
+
+      size_t count = 0;
+      arma::sp_mat::const_col_iterator it = ratings.begin_col(j);
+      for (; it != ratings.end_col(j); ++it)
+      {
+        if (it.row() >= fixed.n_cols)
+          continue;
+
+        const double* f = fixed.colptr(it.row());
+        const double value = (*it) -
+            (offsets.n_elem == 0 ? 0.0 : offsets[it.row()]);
+        for (size_t k = 0; k < rank; ++k)
+        {
+          b[k] += value * f[k];
+          for (size_t l = 0; l < rank; ++l)
+            a(l, k) += f[l] * f[k];
+        }
+        ++count;
+      }
+
+      if (count == 0)
+      {
+        factors.col(j).zeros();
+        continue;
+      }
+
+      a.diag() += lambda * count;
+
+      // We can't throw from the parallel region, so a system that can't be
+      // solved at all gives zero factors.
+      const bool solved = arma::chol(r, a) &&
+          arma::solve(y, arma::trimatl(r.t()), b) &&
+          arma::solve(x, arma::trimatu(r), y);
+      if (!solved && !arma::solve(x, a, b))
+        x.zeros(rank);
+
+      factors.col(j) = x;
+    }
+  }
+}
+
+/**
+ * Get the ratings of the given users, one column per user.
+ *
+ * @param cleanedData Item user table in form of sparse matrix.
+ * @param users Users to get the ratings of.
+ */
+inline arma::sp_mat FoldInUserRatings(const arma::sp_mat& cleanedData,
+                                      const arma::Col<size_t>& users)
+{
+  cleanedData.sync();
+  size_t numRatings = 0;
+  for (size_t j = 0; j < users.n_elem; ++j)
+  {
+    numRatings += cleanedData.col_ptrs[users[j] + 1] -
+        cleanedData.col_ptrs[users[j]];
+  }
+
+  arma::umat locations(2, numRatings);
+  arma::vec values(numRatings);
+  size_t k = 0;
+  for (size_t j = 0; j < users.n_elem; ++j)
+  {
+    arma::sp_mat::const_col_iterator it = cleanedData.begin_col(users[j]);
+    for (; it != cleanedData.end_col(users[j]); ++it, ++k)
+    {
+      locations(0, k) = it.row();
+      locations(1, k) = j;
+      values[k] = (*it);
+    }
+  }
+
+  return arma::sp_mat(locations, values, cleanedData.n_rows, users.n_elem);
+}
+
+/**
+ * Get the ratings of the given items, one column per item (that is, one row per
+ * user).  This takes one pass over all the ratings.
+ *
+ * @param cleanedData Item user table in form of sparse matrix.
+ * @param items Items to get the ratings of.
+ */
+inline arma::sp_mat FoldInItemRatings(const arma::sp_mat& cleanedData,
+                                      const arma::Col<size_t>& items)
+{
+  // The position of each item in the result; items.n_elem means that the item
+  // isn't folded in.
+  std::vector<size_t> position(cleanedData.n_rows, items.n_elem);
+  for (size_t j = 0; j < items.n_elem; ++j)
+    position[items[j]] = j;
+
+  size_t numRatings = 0;
+  arma::sp_mat::const_iterator it = cleanedData.begin();
+  for (; it != cleanedData.end(); ++it)
+  {
+    if (position[it.row()] != items.n_elem)
+      ++numRatings;
+  }
+
+  arma::umat locations(2, numRatings);
+  arma::vec values(numRatings);
+  size_t k = 0;
+  for (it = cleanedData.begin(); it != cleanedData.end(); ++it)
+  {
+    if (position[it.row()] != items.n_elem)
+    {
+      locations(0, k) = it.col();
+      locations(1, k) = position[it.row()];
+      values[k] = (*it);
+      ++k;
+    }
+  }
+
+  return arma::sp_mat(locations, values, cleanedData.n_cols, items.n_elem);
+}
+
+/**
+ * Fold the given users into a decomposition whose rating of an item by a user
+ * is the product of the row of the item in W and of the column of the user in
+ * H: the columns of the users are solved against the fixed rows of W (see
+ * FoldInFactors()).  H is resized to hold all the users of the cleaned data.
+ *
+ * @param cleanedData Item user table in form of sparse matrix.
+ * @param users Users to fold in.
+ * @param lambda Regularization parameter.
+ * @param w Item matrix.
+ * @param h User matrix.
+ */
+inline void FoldInUsers(const arma::sp_mat& cleanedData,
+                        const arma::Col<size_t>& users,
+                        const double lambda,
+                        const arma::mat& w,
+                        arma::mat& h)
+{
+  arma::mat factors;
+  FoldInFactors(w.t(), arma::vec(), FoldInUserRatings(cleanedData, users),
+      lambda, factors);
+
+  h.resize(w.n_cols, cleanedData.n_cols);
+  for (size_t j = 0; j < users.n_elem; ++j)
+    h.col(users[j]) = factors.col(j);
+}
+
+/**
+ * Fold the given items into a decomposition whose rating of an item by a user
+ * is the product of the row of the item in W and of the column of the user in
+ * H: the rows of the items are solved against the fixed columns of H (see
+ * FoldInFactors()).  W is resized to hold all the items of the cleaned data.
+ *
+ * @param cleanedData Item user table in form of sparse matrix.
+ * @param items Items to fold in.
+ * @param lambda Regularization parameter.
+ * @param w Item matrix.
+ * @param h User matrix.
+ */
+inline void FoldInItems(const arma::sp_mat& cleanedData,
+                        const arma::Col<size_t>& items,
+                        const double lambda,
+                        arma::mat& w,
+                        const arma::mat& h)
+{
+  arma::mat factors;
+  FoldInFactors(h, arma::vec(), FoldInItemRatings(cleanedData, items), lambda,
+      factors);
+
+  w.resize(cleanedData.n_rows, h.n_rows);
+  for (size_t j = 0; j < items.n_elem; ++j)
+    w.row(items[j]) = factors.col(j).t();
+}
+
+} // namespace details
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -46,9 +47,13 @@ class RegSVDPolicy
    *
    * @param maxIterations Number of iterations for the power method
    *        (Default: 2).
+   * @param parallel Whether to optimize with svd::BlockedSGD, which processes
+   *        the ratings in parallel.
    */
-  RegSVDPolicy(const size_t maxIterations = 10) :
-      maxIterations(maxIterations)
+  RegSVDPolicy(const size_t maxIterations = 10,
+               const bool parallel = false) :
+      maxIterations(maxIterations),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -73,8 +78,16 @@ class RegSVDPolicy
              const bool /* mit */)
   {
     // Do singular value decomposition using the regularized SVD algorithm.
-    svd::RegularizedSVD<> regsvd(maxIterations);
-    regsvd.Apply(data, rank, w, h);
+    if (parallel)
+    {
+      svd::RegularizedSVD<svd::BlockedSGD> regsvd(maxIterations);
+      regsvd.Apply(data, rank, w, h);
+    }
+    else
+    {
+      svd::RegularizedSVD<> regsvd(maxIterations);
+      regsvd.Apply(data, rank, w, h);
+    }
   }
 
   /**
@@ -100,6 +113,62 @@ class RegSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get the factors of the items: the rating of an item by a user is the inner
+   * product of the column of the item and of the factors of the user (see
+   * GetUserFactors()).
+   *
+   * @param itemFactors Matrix to store the factors of each item in.
+   */
+  void GetItemFactors(arma::mat& itemFactors) const
+  {
+    itemFactors = w.t();
+  }
+
+  /**
+   * Get the factors of a user (see GetItemFactors()).
+   *
+   * @param user User ID.
+   * @param userFactors Vector to store the factors of the user in.
+   */
+  void GetUserFactors(const size_t user, arma::vec& userFactors) const
+  {
+    userFactors = h.col(user);
+  }
+
+  /**
+   * Fold the given users into the decomposition: the factors of each user are
+   * solved against the fixed factors of the items, with the regularized least
+   * squares problem of the ratings of the user (see details::FoldInFactors()).
+   * The ratings of items without factors are ignored.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param users Users to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& users,
+                   const double lambda)
+  {
+    details::FoldInUsers(cleanedData, users, lambda, w, h);
+  }
+
+  /**
+   * Fold the given items into the decomposition: the factors of each item are
+   * solved against the fixed factors of the users, with the regularized least
+   * squares problem of the ratings of the item.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param items Items to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& items,
+                   const double lambda)
+  {
+    details::FoldInItems(cleanedData, items, lambda, w, h);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -149,6 +218,11 @@ class RegSVDPolicy
   //! Modify the number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get whether the ratings are processed in parallel (see svd::BlockedSGD).
+  bool Parallel() const { return parallel; }
+  //! Modify whether the ratings are processed in parallel.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -162,6 +236,8 @@ class RegSVDPolicy
  private:
   //! Locally stored number of iterations.
   size_t maxIterations;
+  //! Whether the ratings are processed in parallel.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
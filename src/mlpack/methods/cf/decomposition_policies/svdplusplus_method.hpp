@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/svdplusplus/svdplusplus.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -47,13 +48,17 @@ class SVDPlusPlusPolicy
    * @param maxIterations Number of iterations.
    * @param alpha Learning rate for optimization.
    * @param lambda Regularization parameter for optimization.
+   * @param parallel Whether to optimize with svd::BlockedSGD, which processes
+   *     the ratings in parallel.
    */
   SVDPlusPlusPolicy(const size_t maxIterations = 10,
                     const double alpha = 0.001,
-                    const double lambda = 0.1) :
+                    const double lambda = 0.1,
+                    const bool parallel = false) :
       maxIterations(maxIterations),
       alpha(alpha),
-      lambda(lambda)
+      lambda(lambda),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -77,14 +82,21 @@ class SVDPlusPlusPolicy
              const double /* minResidue */,
              const bool /* mit */)
   {
-    svd::SVDPlusPlus<> svdpp(maxIterations, alpha, lambda);
-
     // Save implicit data in the form of sparse matrix.
     arma::mat implicitDenseData = data.submat(0, 0, 1, data.n_cols - 1);
-    svdpp.CleanData(implicitDenseData, implicitData, data);
+    svd::SVDPlusPlus<>::CleanData(implicitDenseData, implicitData, data);
 
     // Perform decomposition using the svdplusplus algorithm.
-    svdpp.Apply(data, implicitDenseData, rank, w, h, p, q, y);
+    if (parallel)
+    {
+      svd::SVDPlusPlus<svd::BlockedSGD> svdpp(maxIterations, alpha, lambda);
+      svdpp.Apply(data, implicitDenseData, rank, w, h, p, q, y);
+    }
+    else
+    {
+      svd::SVDPlusPlus<> svdpp(maxIterations, alpha, lambda);
+      svdpp.Apply(data, implicitDenseData, rank, w, h, p, q, y);
+    }
   }
 
   /**
@@ -141,6 +153,133 @@ class SVDPlusPlusPolicy
     rating = w * userVec + p + q(user);
   }
 
+  /**
+   * Get the factors of the items: the rating of an item by a user is the inner
+   * product of the column of the item and of the factors of the user (see
+   * GetUserFactors()).  The biases are held by two extra dimensions.
+   *
+   * @param itemFactors Matrix to store the factors of each item in.
+   */
+  void GetItemFactors(arma::mat& itemFactors) const
+  {
+    itemFactors.set_size(w.n_cols + 2, w.n_rows);
+    itemFactors.rows(0, w.n_cols - 1) = w.t();
+    itemFactors.row(w.n_cols) = p.t();
+    itemFactors.row(w.n_cols + 1).ones();
+  }
+
+  /**
+   * Get the factors of a user (see GetItemFactors()), including the implicit
+   * feedback of the user.
+   *
+   * @param user User ID.
+   * @param userFactors Vector to store the factors of the user in.
+   */
+  void GetUserFactors(const size_t user, arma::vec& userFactors) const
+  {
+    // Iterate through each item which the user interacted with to calculate
+    // user vector.
+    arma::vec userVec(h.n_rows, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+    size_t implicitCount = 0;
+    for (; it != it_end; ++it)
+    {
+      userVec += y.col(it.row());
+      implicitCount += 1;
+    }
+    if (implicitCount != 0)
+      userVec /= std::sqrt(implicitCount);
+    userVec += h.col(user);
+
+    userFactors.set_size(h.n_rows + 2);
+    userFactors.subvec(0, h.n_rows - 1) = userVec;
+    userFactors[h.n_rows] = 1.0;
+    userFactors[h.n_rows + 1] = q(user);
+  }
+
+  /**
+   * Fold the given users into the decomposition.  The ratings of the users are
+   * also their implicit feedback, so the implicit data is updated.  Then the
+   * whole vector of each user (its factors plus its implicit part, see
+   * GetRating()) and its bias are solved against the fixed factors and biases
+   * of the items, with the regularized least squares problem of the ratings of
+   * the user (see details::FoldInFactors()), and the implicit part is removed
+   * to get the factors of the user.  The ratings of items without factors are
+   * ignored.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param users Users to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& users,
+                   const double lambda)
+  {
+    implicitData = arma::spones(cleanedData);
+    y.resize(w.n_cols, cleanedData.n_rows);
+
+    // The extra row of ones gives the bias of the user.
+    const arma::mat fixed = arma::join_cols(w.t(),
+        arma::ones<arma::rowvec>(w.n_rows));
+    arma::mat factors;
+    details::FoldInFactors(fixed, p, details::FoldInUserRatings(cleanedData,
+        users), lambda, factors);
+
+    h.resize(w.n_cols, cleanedData.n_cols);
+    q.resize(cleanedData.n_cols);
+    for (size_t j = 0; j < users.n_elem; ++j)
+    {
+      h.col(users[j]) = factors.col(j).head(w.n_cols) -
+          ImplicitVector(users[j]);
+      q[users[j]] = factors(w.n_cols, j);
+    }
+  }
+
+  /**
+   * Fold the given items into the decomposition: the factors and the bias of
+   * each item are solved against the fixed vectors (see GetRating()) and biases
+   * of the users, with the regularized least squares problem of the ratings of
+   * the item.  The implicit vectors of the new items are zero.
+   *
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param items Items to fold in.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& items,
+                   const double lambda)
+  {
+    y.resize(h.n_rows, cleanedData.n_rows);
+    const arma::sp_mat ratings = details::FoldInItemRatings(cleanedData, items);
+
+    // Only compute the vectors of the users that rated the items; the extra
+    // row of ones gives the bias of the user.
+    arma::mat fixed(h.n_rows + 1, h.n_cols, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = ratings.begin();
+    for (; it != ratings.end(); ++it)
+    {
+      const size_t user = it.row();
+      if (user < h.n_cols && fixed(h.n_rows, user) == 0.0)
+      {
+        fixed.submat(0, user, h.n_rows - 1, user) = h.col(user) +
+            ImplicitVector(user);
+        fixed(h.n_rows, user) = 1.0;
+      }
+    }
+
+    arma::mat factors;
+    details::FoldInFactors(fixed, q, ratings, lambda, factors);
+
+    w.resize(cleanedData.n_rows, h.n_rows);
+    p.resize(cleanedData.n_rows);
+    for (size_t j = 0; j < items.n_elem; ++j)
+    {
+      w.row(items[j]) = factors.col(j).head(h.n_rows).t();
+      p[items[j]] = factors(h.n_rows, j);
+    }
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -199,6 +338,11 @@ class SVDPlusPlusPolicy
   //! Modify regularization parameter.
   double& Lambda() { return lambda; }
 
+  //! Get whether the ratings are processed in parallel (see svd::BlockedSGD).
+  bool Parallel() const { return parallel; }
+  //! Modify whether the ratings are processed in parallel.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -217,12 +361,32 @@ class SVDPlusPlusPolicy
   }
 
  private:
+  //! Compute the implicit part of the vector of the given user.
+  arma::vec ImplicitVector(const size_t user) const
+  {
+    arma::vec userVec(h.n_rows, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+    size_t implicitCount = 0;
+    for (; it != it_end; ++it)
+    {
+      userVec += y.col(it.row());
+      implicitCount += 1;
+    }
+    if (implicitCount != 0)
+      userVec /= std::sqrt(implicitCount);
+
+    return userVec;
+  }
+
   //! Locally stored number of iterations.
   size_t maxIterations;
   //! Learning rate for optimization.
   double alpha;
   //! Regularization parameter for optimization.
   double lambda;
+  //! Whether the ratings are processed in parallel.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
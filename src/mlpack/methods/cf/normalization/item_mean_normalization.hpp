@@ -120,6 +120,50 @@ class ItemMeanNormalization
     }
   }
 
+  /**
+   * Normalize new ratings (such as the ratings of new items) by subtracting
+   * the item mean.  The means of the items that were given to Normalize() are
+   * kept; the means of the new items are computed from the new ratings.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t oldItemNum = itemMean.n_elem;
+    const size_t itemNum = std::max(oldItemNum,
+        (size_t) arma::max(data.row(1)) + 1);
+    itemMean.resize(itemNum);
+    // Number of ratings for each new item.
+    arma::Row<size_t> ratingNum(itemNum, arma::fill::zeros);
+
+    // Sum ratings for each new item.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      if (item >= oldItemNum)
+      {
+        itemMean(item) += datapoint(2);
+        ratingNum(item) += 1;
+      }
+    });
+
+    for (size_t i = oldItemNum; i < itemNum; ++i)
+    {
+      if (ratingNum(i) != 0)
+        itemMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      datapoint(2) -= itemMean(item);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding item mean.
    *
@@ -36,6 +36,14 @@ class NoNormalization
   template<typename MatType>
   inline void Normalize(const MatType& /* data */) const { }
 
+  /**
+   * Do nothing.
+   *
+   * @param * (data) New ratings.
+   */
+  template<typename MatType>
+  inline void FoldIn(const MatType& /* data */) const { }
+
   /**
    * Do nothing.
    *
@@ -93,6 +93,24 @@ class OverallMeanNormalization
     }
   }
 
+  /**
+   * Normalize new ratings (such as the ratings of new users) by subtracting the
+   * mean of the ratings that were given to Normalize().
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) -= mean;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive float value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding mean.
    *
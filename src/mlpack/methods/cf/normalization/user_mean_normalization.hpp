@@ -120,6 +120,50 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize new ratings (such as the ratings of new users) by subtracting
+   * the user mean.  The means of the users that were given to Normalize() are
+   * kept; the means of the new users are computed from the new ratings.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t oldUserNum = userMean.n_elem;
+    const size_t userNum = std::max(oldUserNum,
+        (size_t) arma::max(data.row(0)) + 1);
+    userMean.resize(userNum);
+    // Number of ratings for each new user.
+    arma::Row<size_t> ratingNum(userNum, arma::fill::zeros);
+
+    // Sum ratings for each new user.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      if (user >= oldUserNum)
+      {
+        userMean(user) += datapoint(2);
+        ratingNum(user) += 1;
+      }
+    });
+
+    for (size_t i = oldUserNum; i < userNum; ++i)
+    {
+      if (ratingNum(i) != 0)
+        userMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      datapoint(2) -= userMean(user);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
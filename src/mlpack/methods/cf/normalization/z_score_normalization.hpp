@@ -75,8 +75,12 @@ class ZScoreNormalization
    */
   void Normalize(arma::sp_mat& cleanedData)
   {
-    // Caculate mean and stdev of all non zero ratings.
-    arma::vec ratings = arma::nonzeros(cleanedData);
+    // Caculate mean and stdev of all non zero ratings.  The ratings are read
+    // in place, so that no copy of the (possibly very large) ratings is made.
+    cleanedData.sync();
+    const size_t numRatings = cleanedData.n_nonzero;
+    const arma::vec ratings(const_cast<double*>(cleanedData.values),
+        numRatings, false, true);
     mean = arma::mean(ratings);
     stddev = arma::stddev(ratings);
 
@@ -87,22 +91,36 @@ class ZScoreNormalization
           << std::endl;
     }
 
-    // Subtract mean from existing rating and divide it by stddev.
-    // TODO: consider using spmat::transform() instead of spmat iterators
-    // TODO: http://arma.sourceforge.net/docs.html#transform
-    arma::sp_mat::iterator it = cleanedData.begin();
-    arma::sp_mat::iterator it_end = cleanedData.end();
-    for (; it != it_end; ++it)
+    // Subtract mean from existing rating and divide it by stddev.  The
+    // non-zero values are transformed in place.
+    const double m = mean;
+    const double s = stddev;
+    cleanedData.transform([m, s](const double rating)
     {
-      double tmp = (*it - mean) / stddev;
+      const double tmp = (rating - m) / s;
 
       // The algorithm omits rating of zero. If normalized rating equals zero,
       // it is set to the smallest positive float value.
-      if (tmp == 0)
-        tmp = std::numeric_limits<float>::min();
+      return (tmp == 0) ? std::numeric_limits<float>::min() : tmp;
+    });
+  }
 
-      *it = tmp;
-    }
+  /**
+   * Normalize new ratings (such as the ratings of new users) with the mean and
+   * the standard deviation of the ratings that were given to Normalize().
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) = (data.row(2) - mean) / stddev;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive float value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<float>::min();
+    });
   }
 
   /**
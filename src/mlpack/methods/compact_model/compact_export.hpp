@@ -0,0 +1,342 @@
+/**
+ * @file methods/compact_model/compact_export.hpp
+ *
+ * Export trained decision trees, random forests, logistic and softmax
+ * regressions and linear SVMs to compact model files, which can be loaded
+ * with the standalone CompactModel predictor.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_COMPACT_MODEL_COMPACT_EXPORT_HPP
+#define MLPACK_METHODS_COMPACT_MODEL_COMPACT_EXPORT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/decision_tree/flat_decision_tree.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_random_forest.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+#include <mlpack/methods/softmax_regression/softmax_regression.hpp>
+#include <mlpack/methods/linear_svm/linear_svm.hpp>
+
+#include "compact_model.hpp"
+
+namespace mlpack {
+namespace compact {
+
+namespace compact_detail {
+
+//! Get a header of the given kind, with all the sizes set to 0.
+inline CompactHeader MakeHeader(const CompactModelKind kind)
+{
+  CompactHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, compactMagic, sizeof(compactMagic));
+  header.byteOrder = compactByteOrder;
+  header.kind = kind;
+  return header;
+}
+
+//! Write the given arrays to the given stream.
+template<typename T>
+void WriteArray(std::ofstream& stream, const T* elements, const size_t count)
+{
+  if (count > 0)
+  {
+    stream.write(reinterpret_cast<const char*>(elements),
+        count * sizeof(T));
+  }
+}
+
+//! Open the given file for writing, or throw.
+inline void Open(std::ofstream& stream, const std::string& filename)
+{
+  stream.open(filename, std::ios::binary | std::ios::trunc);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("ExportCompact(): cannot open file '" + filename +
+        "' for writing");
+  }
+}
+
+//! Make sure everything was written.
+inline void Close(std::ofstream& stream, const std::string& filename)
+{
+  stream.close();
+  if (stream.fail())
+  {
+    throw std::runtime_error("ExportCompact(): cannot write file '" +
+        filename + "'");
+  }
+}
+
+//! Convert an index of a tree to the 32-bit index of the file, or throw.
+inline uint32_t Index32(const size_t index)
+{
+  if (index > std::numeric_limits<uint32_t>::max())
+  {
+    throw std::invalid_argument("ExportCompact(): the trees are too large for "
+        "a compact model");
+  }
+
+  return (uint32_t) index;
+}
+
+//! Export the given flat trees; their predictions are averaged.
+inline void ExportTrees(const std::string& filename,
+                        const std::vector<const tree::FlatDecisionTree*>& trees)
+{
+  if (trees.empty() || trees[0]->Nodes().empty())
+  {
+    throw std::invalid_argument("ExportCompact(): the model is not "
+        "trained!");
+  }
+
+  CompactHeader header = MakeHeader(TREES);
+  header.numClasses = trees[0]->NumClasses();
+  header.numTrees = trees.size();
+
+  // The nodes and leaves of each tree are numbered after those of the previous
+  // trees.
+  std::vector<uint64_t> roots(trees.size());
+  std::vector<CompactNode> nodes;
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    if (trees[t]->NumClasses() != header.numClasses)
+    {
+      throw std::invalid_argument("ExportCompact(): the trees do not have the "
+          "same number of classes!");
+    }
+
+    const std::vector<tree::FlatDecisionTree::Node>& treeNodes =
+        trees[t]->Nodes();
+    roots[t] = nodes.size();
+    for (size_t i = 0; i < treeNodes.size(); ++i)
+    {
+      const tree::FlatDecisionTree::Node& treeNode = treeNodes[i];
+      CompactNode node;
+      node.threshold = treeNode.threshold;
+      node.dimension = Index32(treeNode.dimension);
+      node.numChildren = Index32(treeNode.numChildren);
+      node.categorical = treeNode.categorical ? 1 : 0;
+      if (treeNode.numChildren == 0)
+      {
+        node.child = Index32(header.numLeaves + treeNode.child);
+      }
+      else
+      {
+        node.child = Index32(roots[t] + treeNode.child);
+        header.dimensionality = std::max(header.dimensionality,
+            (uint64_t) treeNode.dimension + 1);
+      }
+      nodes.push_back(node);
+    }
+
+    header.numLeaves += trees[t]->NumLeaves();
+  }
+  header.numNodes = nodes.size();
+  Index32(header.numNodes);
+  Index32(header.numLeaves);
+
+  std::ofstream stream;
+  Open(stream, filename);
+  WriteArray(stream, &header, 1);
+  WriteArray(stream, roots.data(), roots.size());
+  WriteArray(stream, nodes.data(), nodes.size());
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    // The leaf probabilities are stored by column, one leaf after the other.
+    const arma::mat& probabilities = trees[t]->LeafProbabilities();
+    WriteArray(stream, probabilities.memptr(), probabilities.n_elem);
+  }
+  Close(stream, filename);
+}
+
+//! Export a linear model, given its weights (one row per score) and biases.
+inline void ExportLinear(const std::string& filename,
+                         const arma::mat& weights,
+                         const arma::vec& bias,
+                         const size_t numClasses,
+                         const CompactLink link)
+{
+  if (weights.is_empty())
+  {
+    throw std::invalid_argument("ExportCompact(): the model is not "
+        "trained!");
+  }
+
+  CompactHeader header = MakeHeader(LINEAR);
+  header.dimensionality = weights.n_cols;
+  header.numClasses = numClasses;
+  header.link = link;
+
+  // Each row of weights is written contiguously.
+  const arma::mat transposedWeights = weights.t();
+
+  std::ofstream stream;
+  Open(stream, filename);
+  WriteArray(stream, &header, 1);
+  WriteArray(stream, transposedWeights.memptr(), transposedWeights.n_elem);
+  WriteArray(stream, bias.memptr(), bias.n_elem);
+  Close(stream, filename);
+}
+
+} // namespace compact_detail
+
+/**
+ * Export the given flat decision tree to a compact model file.  A
+ * std::runtime_error is thrown if the file can't be written.
+ *
+ * @param filename File to write the model to.
+ * @param tree Tree to export.
+ */
+inline void ExportCompact(const std::string& filename,
+                          const tree::FlatDecisionTree& tree)
+{
+  compact_detail::ExportTrees(filename,
+      std::vector<const tree::FlatDecisionTree*>(1, &tree));
+}
+
+/**
+ * Export the given flat random forest to a compact model file.
+ *
+ * @param filename File to write the model to.
+ * @param forest Forest to export.
+ */
+inline void ExportCompact(const std::string& filename,
+                          const tree::FlatRandomForest& forest)
+{
+  std::vector<const tree::FlatDecisionTree*> trees(forest.NumTrees());
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    trees[i] = &forest.Tree(i);
+  compact_detail::ExportTrees(filename, trees);
+}
+
+/**
+ * Export the given decision tree to a compact model file.  The numeric splits
+ * must be binary, as for FlatDecisionTree.
+ *
+ * @param filename File to write the model to.
+ * @param tree Tree to export.
+ */
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+void ExportCompact(const std::string& filename,
+                   const tree::DecisionTree<FitnessFunction, NumericSplitType,
+                       CategoricalSplitType, DimensionSelectionType, ElemType,
+                       NoRecursion>& tree)
+{
+  ExportCompact(filename, tree::FlatDecisionTree(tree));
+}
+
+/**
+ * Export the given random forest to a compact model file.  The numeric splits
+ * must be binary, as for FlatRandomForest.
+ *
+ * @param filename File to write the model to.
+ * @param forest Forest to export.
+ */
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+void ExportCompact(const std::string& filename,
+                   const tree::RandomForest<FitnessFunction,
+                       DimensionSelectionType, NumericSplitType,
+                       CategoricalSplitType, ElemType>& forest)
+{
+  ExportCompact(filename, tree::FlatRandomForest(forest));
+}
+
+/**
+ * Export the given logistic regression model to a compact model file.  The
+ * CompactModel predicts class 1 when its probability is at least 0.5, as
+ * LogisticRegression::Classify() does with the default decision boundary.
+ *
+ * @param filename File to write the model to.
+ * @param model Model to export.
+ */
+template<typename MatType>
+void ExportCompact(const std::string& filename,
+                   const regression::LogisticRegression<MatType>& model)
+{
+  const arma::rowvec& parameters = model.Parameters();
+  if (parameters.n_elem < 2)
+  {
+    throw std::invalid_argument("ExportCompact(): the model is not "
+        "trained!");
+  }
+
+  // The first parameter is the bias.
+  arma::vec bias(1);
+  bias[0] = parameters[0];
+  compact_detail::ExportLinear(filename,
+      parameters.cols(1, parameters.n_elem - 1), bias, 2, SIGMOID);
+}
+
+/**
+ * Export the given softmax regression model to a compact model file.
+ *
+ * @param filename File to write the model to.
+ * @param model Model to export.
+ */
+inline void ExportCompact(const std::string& filename,
+                          const regression::SoftmaxRegression& model)
+{
+  // The intercepts are the first column of the parameters, if any.
+  const arma::mat& parameters = model.Parameters();
+  if (model.FitIntercept() && parameters.n_cols > 1)
+  {
+    compact_detail::ExportLinear(filename,
+        parameters.cols(1, parameters.n_cols - 1), parameters.col(0),
+        model.NumClasses(), SOFTMAX);
+  }
+  else
+  {
+    compact_detail::ExportLinear(filename, parameters,
+        arma::zeros<arma::vec>(parameters.n_rows), model.NumClasses(),
+        SOFTMAX);
+  }
+}
+
+/**
+ * Export the given linear SVM to a compact model file.  The CompactModel gives
+ * the scores of the classes in place of probabilities.
+ *
+ * @param filename File to write the model to.
+ * @param model Model to export.
+ */
+template<typename MatType>
+void ExportCompact(const std::string& filename,
+                   const svm::LinearSVM<MatType>& model)
+{
+  // The parameters hold one column per class; the intercepts are the last
+  // row, if any.
+  const arma::mat& parameters = model.Parameters();
+  if (model.FitIntercept() && parameters.n_rows > 1)
+  {
+    compact_detail::ExportLinear(filename,
+        parameters.rows(0, parameters.n_rows - 2).t(),
+        parameters.row(parameters.n_rows - 1).t(), model.NumClasses(),
+        IDENTITY);
+  }
+  else
+  {
+    compact_detail::ExportLinear(filename, parameters.t(),
+        arma::zeros<arma::vec>(parameters.n_cols), model.NumClasses(),
+        IDENTITY);
+  }
+}
+
+} // namespace compact
+} // namespace mlpack
+
+#endif
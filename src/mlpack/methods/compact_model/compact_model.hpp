@@ -0,0 +1,435 @@
+/**
+ * @file methods/compact_model/compact_model.hpp
+ *
+ * Definition of the CompactModel class, a small predictor for the models
+ * exported with ExportCompact().  This file only depends on the standard
+ * library, so it can be copied alone into an application that does not link
+ * against mlpack or Armadillo.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_COMPACT_MODEL_COMPACT_MODEL_HPP
+#define MLPACK_METHODS_COMPACT_MODEL_COMPACT_MODEL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mlpack {
+namespace compact /** Inference-only exported models. */ {
+
+//! The magic string at the start of the compact model files.
+static const char compactMagic[8] = { 'M', 'L', 'P', 'K', 'C', 'M', 'P', '1' };
+//! The byte order mark of the compact model files; a file written on a machine
+//! of a different byte order can't be read.
+static const uint32_t compactByteOrder = 0x01020304;
+
+//! The kinds of models a compact model file can hold.
+enum CompactModelKind
+{
+  //! A decision tree, or a forest of decision trees.
+  TREES = 1,
+  //! A linear model.
+  LINEAR = 2
+};
+
+//! How the scores of a linear model are turned into predictions.
+enum CompactLink
+{
+  //! The prediction is the class of highest score (a linear SVM).
+  IDENTITY = 0,
+  //! The score is the log-odds of class 1 (logistic regression).
+  SIGMOID = 1,
+  //! The scores are the unnormalized log-probabilities of the classes (softmax
+  //! regression).
+  SOFTMAX = 2
+};
+
+//! The header of a compact model file (64 bytes).
+struct CompactHeader
+{
+  char magic[8];
+  uint32_t byteOrder;
+  uint32_t kind;
+  uint64_t dimensionality;
+  uint64_t numClasses;
+  uint64_t numTrees;
+  uint64_t numNodes;
+  uint64_t numLeaves;
+  uint64_t link;
+};
+
+/**
+ * A node of the trees of a compact model file (24 bytes).  If numChildren is
+ * 0, the node is a leaf: dimension is its majority class and child is the
+ * index of its class probabilities.  Otherwise, a point goes to the node of
+ * index child if its value in the dimension is at most threshold, and to
+ * child + 1 if not; or, if categorical is not 0, to child plus the category of
+ * the point.  The indices are indices in the whole file, not in the tree.
+ */
+struct CompactNode
+{
+  double threshold;
+  uint32_t dimension;
+  uint32_t child;
+  uint32_t numChildren;
+  uint32_t categorical;
+};
+
+static_assert(sizeof(CompactHeader) == 64, "unexpected CompactHeader padding");
+static_assert(sizeof(CompactNode) == 24, "unexpected CompactNode padding");
+
+/**
+ * A CompactModel makes the predictions of a decision tree, a random forest, a
+ * logistic regression, a softmax regression or a linear SVM exported with
+ * ExportCompact(), without any of the training state of the model (the
+ * DatasetInfo, the gains, the class probabilities of the inner nodes, ...).
+ * Loading a model is a single read of a flat binary file, with no
+ * deserialization, and the model takes about as much memory as the file.
+ *
+ * The file is a CompactHeader followed by, for the trees, the index of the
+ * root of each tree (numTrees uint64_t), the nodes of all the trees (numNodes
+ * CompactNode), and the class probabilities of the leaves (numLeaves x
+ * numClasses double); for a linear model, the weights (one row of
+ * dimensionality double per score) followed by the bias of each score.  There
+ * is one score per class, except for logistic regression, which has a single
+ * score.
+ *
+ * This class only needs the standard library, so that the file can be copied
+ * alone into the application that makes the predictions.
+ *
+ * @code
+ * // On the training machine.
+ * RandomForest<> forest(data, labels, numClasses, 50);
+ * compact::ExportCompact("forest.cmp", forest);
+ *
+ * // In the application.
+ * compact::CompactModel model("forest.cmp");
+ * const size_t prediction = model.Classify(point);
+ * @endcode
+ */
+class CompactModel
+{
+ public:
+  /**
+   * Create an empty model; it can't classify anything until Load() is called.
+   */
+  CompactModel() : header() { }
+
+  /**
+   * Load the model from the given file.
+   *
+   * @param filename File holding the exported model.
+   */
+  explicit CompactModel(const std::string& filename) : header()
+  {
+    Load(filename);
+  }
+
+  /**
+   * Load the model from the given file.  A std::runtime_error is thrown if the
+   * file can't be read or is not a valid compact model file.
+   *
+   * @param filename File holding the exported model.
+   */
+  void Load(const std::string& filename)
+  {
+    std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("CompactModel: cannot open file '" + filename +
+          "' for reading");
+    }
+
+    const std::streamoff size = stream.tellg();
+    std::vector<char> buffer(size > 0 ? (size_t) size : 0);
+    stream.seekg(0);
+    if (size < 0 || !stream.read(buffer.data(), buffer.size()))
+    {
+      throw std::runtime_error("CompactModel: cannot read file '" + filename +
+          "'");
+    }
+
+    Load(buffer.data(), buffer.size());
+  }
+
+  /**
+   * Load the model from the given memory buffer holding the contents of a
+   * compact model file (for instance, a file embedded in the application).
+   * A std::runtime_error is thrown if the buffer is not a valid compact model.
+   *
+   * @param buffer Contents of the compact model file.
+   * @param size Size of the buffer in bytes.
+   */
+  void Load(const char* buffer, const size_t size)
+  {
+    CompactHeader newHeader;
+    if (size < sizeof(newHeader))
+      throw std::runtime_error("CompactModel: the model is truncated");
+    std::memcpy(&newHeader, buffer, sizeof(newHeader));
+
+    if (std::memcmp(newHeader.magic, compactMagic, sizeof(compactMagic)) != 0)
+      throw std::runtime_error("CompactModel: not a compact model file");
+    if (newHeader.byteOrder != compactByteOrder)
+    {
+      throw std::runtime_error("CompactModel: the model was written on a "
+          "machine of a different byte order");
+    }
+    if (newHeader.numClasses == 0)
+      throw std::runtime_error("CompactModel: the model has no classes");
+
+    size_t offset = sizeof(newHeader);
+    std::vector<uint64_t> newRoots;
+    std::vector<CompactNode> newNodes;
+    std::vector<double> newValues, newBias;
+    if (newHeader.kind == TREES)
+    {
+      if (newHeader.numTrees == 0)
+        throw std::runtime_error("CompactModel: the model has no trees");
+
+      Read(buffer, size, offset, newHeader.numTrees, newRoots);
+      Read(buffer, size, offset, newHeader.numNodes, newNodes);
+      if (newHeader.numLeaves > size / newHeader.numClasses)
+        throw std::runtime_error("CompactModel: the model is truncated");
+      Read(buffer, size, offset, newHeader.numLeaves * newHeader.numClasses,
+          newValues);
+      CheckTrees(newHeader, newRoots, newNodes);
+    }
+    else if (newHeader.kind == LINEAR)
+    {
+      if (newHeader.link > SOFTMAX ||
+          (newHeader.link == SIGMOID && newHeader.numClasses != 2))
+        throw std::runtime_error("CompactModel: invalid linear model");
+
+      const size_t numScores = NumScores(newHeader);
+      if (newHeader.dimensionality > size / numScores)
+        throw std::runtime_error("CompactModel: the model is truncated");
+      Read(buffer, size, offset, numScores * newHeader.dimensionality,
+          newValues);
+      Read(buffer, size, offset, numScores, newBias);
+    }
+    else
+    {
+      throw std::runtime_error("CompactModel: unknown kind of model");
+    }
+
+    header = newHeader;
+    roots.swap(newRoots);
+    nodes.swap(newNodes);
+    values.swap(newValues);
+    bias.swap(newBias);
+  }
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point The Dimensionality() values of the point.
+   * @return Predicted class of the point.
+   */
+  size_t Classify(const double* point) const
+  {
+    if (header.kind == TREES && header.numTrees == 1)
+      return nodes[FindLeaf(roots[0], point)].dimension;
+
+    std::vector<double> probabilities(header.numClasses);
+    return Classify(point, probabilities.data());
+  }
+
+  /**
+   * Predict the class of the given point, and write the probability of each
+   * class to the given array (of NumClasses() elements).  For a linear SVM,
+   * the scores of the classes are written instead.
+   *
+   * @param point The Dimensionality() values of the point.
+   * @param probabilities Array to write the probabilities of the classes to.
+   * @return Predicted class of the point.
+   */
+  size_t Classify(const double* point, double* probabilities) const
+  {
+    if (header.kind == TREES)
+    {
+      std::fill(probabilities, probabilities + header.numClasses, 0.0);
+      size_t leafNode = 0;
+      for (size_t t = 0; t < header.numTrees; ++t)
+      {
+        leafNode = FindLeaf(roots[t], point);
+        const double* leafProbabilities = values.data() +
+            nodes[leafNode].child * header.numClasses;
+        for (size_t c = 0; c < header.numClasses; ++c)
+          probabilities[c] += leafProbabilities[c];
+      }
+
+      for (size_t c = 0; c < header.numClasses; ++c)
+        probabilities[c] /= header.numTrees;
+
+      // A single tree predicts the majority class of the leaf.
+      if (header.numTrees == 1)
+        return nodes[leafNode].dimension;
+
+      return ArgMax(probabilities);
+    }
+
+    // Compute the scores of the linear model.
+    const size_t numScores = NumScores(header);
+    for (size_t k = 0; k < numScores; ++k)
+    {
+      const double* weights = values.data() + k * header.dimensionality;
+      double score = bias[k];
+      for (size_t d = 0; d < header.dimensionality; ++d)
+        score += weights[d] * point[d];
+      probabilities[k] = score;
+    }
+
+    if (header.link == SIGMOID)
+    {
+      const double p = 1.0 / (1.0 + std::exp(-probabilities[0]));
+      probabilities[0] = 1.0 - p;
+      probabilities[1] = p;
+      return (p >= 0.5) ? 1 : 0;
+    }
+    else if (header.link == SOFTMAX)
+    {
+      // Subtract the largest score to avoid overflow.
+      const size_t prediction = ArgMax(probabilities);
+      const double maxScore = probabilities[prediction];
+      double sum = 0.0;
+      for (size_t k = 0; k < numScores; ++k)
+      {
+        probabilities[k] = std::exp(probabilities[k] - maxScore);
+        sum += probabilities[k];
+      }
+      for (size_t k = 0; k < numScores; ++k)
+        probabilities[k] /= sum;
+
+      return prediction;
+    }
+
+    return ArgMax(probabilities);
+  }
+
+  //! Get the kind of the model (a CompactModelKind).
+  size_t Kind() const { return header.kind; }
+  //! Get the link of a linear model (a CompactLink).
+  size_t Link() const { return header.link; }
+  //! Get the number of values of the points (for trees, one more than the
+  //! largest dimension that is split on).
+  size_t Dimensionality() const { return header.dimensionality; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return header.numClasses; }
+  //! Get the number of trees (0 for a linear model).
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the number of nodes of all the trees.
+  size_t NumNodes() const { return nodes.size(); }
+
+ private:
+  //! Get the number of scores of a linear model.
+  static size_t NumScores(const CompactHeader& header)
+  {
+    return (header.link == SIGMOID) ? 1 : header.numClasses;
+  }
+
+  //! Get the index of the largest of the NumClasses() given values (the first
+  //! one, in case of ties).
+  size_t ArgMax(const double* scores) const
+  {
+    size_t best = 0;
+    for (size_t c = 1; c < header.numClasses; ++c)
+      if (scores[c] > scores[best])
+        best = c;
+    return best;
+  }
+
+  //! Find the leaf node the given point falls in, starting from the given
+  //! root.
+  size_t FindLeaf(size_t index, const double* point) const
+  {
+    while (nodes[index].numChildren != 0)
+    {
+      const CompactNode& node = nodes[index];
+      const double value = point[node.dimension];
+      if (node.categorical)
+      {
+        // Unknown categories go to the last child.
+        const size_t category = (value >= 0.0 && value < node.numChildren) ?
+            (size_t) value : node.numChildren - 1;
+        index = node.child + category;
+      }
+      else
+      {
+        index = node.child + (value <= node.threshold ? 0 : 1);
+      }
+    }
+
+    return index;
+  }
+
+  //! Copy count elements from the buffer at the given offset.
+  template<typename T>
+  static void Read(const char* buffer,
+                   const size_t size,
+                   size_t& offset,
+                   const uint64_t count,
+                   std::vector<T>& elements)
+  {
+    if (count > (size - offset) / sizeof(T))
+      throw std::runtime_error("CompactModel: the model is truncated");
+
+    elements.resize(count);
+    if (count > 0)
+      std::memcpy(elements.data(), buffer + offset, count * sizeof(T));
+    offset += count * sizeof(T);
+  }
+
+  //! Make sure that the trees can't index outside the model, and can't loop.
+  static void CheckTrees(const CompactHeader& header,
+                         const std::vector<uint64_t>& roots,
+                         const std::vector<CompactNode>& nodes)
+  {
+    for (size_t t = 0; t < roots.size(); ++t)
+      if (roots[t] >= nodes.size())
+        throw std::runtime_error("CompactModel: invalid root index");
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      const CompactNode& node = nodes[i];
+      if (node.numChildren == 0)
+      {
+        if (node.child >= header.numLeaves ||
+            node.dimension >= header.numClasses)
+          throw std::runtime_error("CompactModel: invalid leaf");
+      }
+      else if (node.child <= i ||
+          (uint64_t) node.child + node.numChildren > nodes.size() ||
+          node.dimension >= header.dimensionality ||
+          (!node.categorical && node.numChildren != 2))
+      {
+        throw std::runtime_error("CompactModel: invalid node");
+      }
+    }
+  }
+
+  //! The header of the model.
+  CompactHeader header;
+  //! The index of the root of each tree.
+  std::vector<uint64_t> roots;
+  //! The nodes of the trees.
+  std::vector<CompactNode> nodes;
+  //! The class probabilities of the leaves, or the weights of a linear model.
+  std::vector<double> values;
+  //! The bias of each score of a linear model.
+  std::vector<double> bias;
+};
+
+} // namespace compact
+} // namespace mlpack
+
+#endif
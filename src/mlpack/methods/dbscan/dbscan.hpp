@@ -16,6 +16,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
@@ -44,7 +45,8 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
- * @tparam RangeSearchType Class to use for range searching.
+ * @tparam RangeSearchType Class to use for range searching; its Search()
+ *      methods must be able to return a range::RangeSearchResults object.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
  */
@@ -60,17 +62,35 @@ class DBSCAN
    * When batchMode is false, each point will be searched iteratively, which
    * could be slower but will use less memory.
    *
+   * If parallel is true, the points are searched in blocks and the neighbors
+   * of each block are merged into the clusters by all threads at once, with a
+   * lock-free union-find structure (the batchMode parameter and the point
+   * selection policy are ignored, since the clusters do not depend on the
+   * order of the points).  Each block is one call to rangeSearch.Search(), so
+   * the range search should parallelize its queries too (for RangeSearch, set
+   * ParallelQueries()).
+   *
+   * If trainRangeSearch is false, the given range search must already be
+   * trained on the dataset that will be clustered, for instance with a tree
+   * from a tree::TreeCache shared with other algorithms (move the RangeSearch
+   * object in, since copying it copies its tree).
+   *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
    * @param batchMode If true, all points are searched in batch.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
+   * @param parallel If true, the clusters are built in parallel.
+   * @param trainRangeSearch If false, the range search is not trained on the
+   *     data given to Cluster(), because it already is.
    */
   DBSCAN(const double epsilon,
          const size_t minPoints,
          const bool batchMode = true,
          RangeSearchType rangeSearch = RangeSearchType(),
-         PointSelectionPolicy pointSelector = PointSelectionPolicy());
+         PointSelectionPolicy pointSelector = PointSelectionPolicy(),
+         const bool parallel = false,
+         const bool trainRangeSearch = true);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -123,6 +143,12 @@ class DBSCAN
   //! Whether or not to perform the search in batch mode.  If false, single
   bool batchMode;
 
+  //! Whether or not to build the clusters in parallel.
+  bool parallel;
+
+  //! Whether or not to train the range search on the data to cluster.
+  bool trainRangeSearch;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
@@ -155,6 +181,29 @@ class DBSCAN
   template<typename MatType>
   void BatchCluster(const MatType& data,
                     emst::UnionFind& uf);
+
+  /**
+   * Performs DBSCAN clustering on the data, searching the points in blocks.
+   * The neighbors of each block are merged into the union-find structure by
+   * all threads at once, so only one block of neighbors is held in memory.
+   *
+   * @param data Dataset to cluster.
+   * @param uf ConcurrentUnionFind structure that will be modified.
+   */
+  template<typename MatType>
+  void ParallelCluster(const MatType& data,
+                       emst::ConcurrentUnionFind& uf);
+
+  /**
+   * Turn the components of the points into cluster assignments: components
+   * with fewer than minPoints points are noise, and the others are numbered
+   * in order.
+   *
+   * @param assignments Component of each point; overwritten with the cluster
+   *     of each point.
+   * @return The number of clusters.
+   */
+  size_t LabelClusters(arma::Row<size_t>& assignments) const;
 };
 
 } // namespace dbscan
@@ -26,10 +26,14 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     const size_t minPoints,
     const bool batchMode,
     RangeSearchType rangeSearch,
-    PointSelectionPolicy pointSelector) :
+    PointSelectionPolicy pointSelector,
+    const bool parallel,
+    const bool trainRangeSearch) :
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
+    parallel(parallel),
+    trainRangeSearch(trainRangeSearch),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -100,20 +104,45 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
-  rangeSearch.Train(data);
+  if (trainRangeSearch)
+    rangeSearch.Train(data);
+  assignments.set_size(data.n_cols);
+
+  if (parallel)
+  {
+    emst::ConcurrentUnionFind uf(data.n_cols);
+    ParallelCluster(data, uf);
 
-  if (batchMode)
-    BatchCluster(data, uf);
+    // No more unions are done, so each Find() gives the final component.
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
   else
-    PointwiseCluster(data, uf);
+  {
+    // Initialize the UnionFind object.
+    emst::UnionFind uf(data.n_cols);
 
-  // Now set assignments.
-  assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
+    if (batchMode)
+      BatchCluster(data, uf);
+    else
+      PointwiseCluster(data, uf);
 
+    // Now set assignments.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
+
+  return LabelClusters(assignments);
+}
+
+/**
+ * Turn the components of the points into cluster assignments.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::LabelClusters(
+    arma::Row<size_t>& assignments) const
+{
   // Get a count of all clusters.
   const size_t numClusters = arma::max(assignments) + 1;
   arma::Col<size_t> counts(numClusters, arma::fill::zeros);
@@ -152,8 +181,7 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
     emst::UnionFind& uf)
 {
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
+  range::RangeSearchResults results;
 
   for (size_t i = 0; i < data.n_cols; ++i)
   {
@@ -161,12 +189,12 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
       Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
 
     // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
-        distances);
+    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), results);
 
     // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    const size_t* neighbors = results.Neighbors(0);
+    for (size_t j = 0; j < results.NumResults(0); ++j)
+      uf.Union(i, neighbors[j]);
   }
 }
 
@@ -182,11 +210,9 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     emst::UnionFind& uf)
 {
   // For each point, find the points in epsilon-nighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
+  range::RangeSearchResults results;
   Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
+  rangeSearch.Search(data, math::Range(0.0, epsilon), results);
   Log::Info << "Range search complete." << std::endl;
 
   // Now loop over all points.
@@ -194,8 +220,47 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
   {
     // Get the next index.
     const size_t index = pointSelector.Select(i, data);
-    for (size_t j = 0; j < neighbors[index].size(); ++j)
-      uf.Union(index, neighbors[index][j]);
+    const size_t* neighbors = results.Neighbors(index);
+    for (size_t j = 0; j < results.NumResults(index); ++j)
+      uf.Union(index, neighbors[j]);
+  }
+}
+
+/**
+ * Performs DBSCAN clustering on the data, searching the points in blocks and
+ * merging the neighbors of each block in parallel.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MatType>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::ParallelCluster(
+    const MatType& data,
+    emst::ConcurrentUnionFind& uf)
+{
+  // The blocks are large enough for the range search to parallelize well, but
+  // bound the memory used by the neighbors of a block.
+  const size_t blockSize = 65536;
+
+  range::RangeSearchResults results;
+  for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    if (begin > 0)
+    {
+      Log::Info << "DBSCAN clustering on point " << begin << "..."
+          << std::endl;
+    }
+
+    const MatType block = data.cols(begin, end - 1);
+    rangeSearch.Search(block, math::Range(0.0, epsilon), results);
+
+    // Union each point of the block to all its neighbors.
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (omp_size_t i = 0; i < (omp_size_t) results.NumQueries(); ++i)
+    {
+      const size_t* neighbors = results.Neighbors(i);
+      for (size_t j = 0; j < results.NumResults(i); ++j)
+        uf.Union(begin + i, neighbors[j]);
+    }
   }
 }
 
@@ -63,7 +63,13 @@ BINDING_LONG_DESC(
     " 'hilbert-r', 'r-plus', 'r-plus-plus', 'cover', 'ball'. The " +
     PRINT_PARAM_STRING("single_mode") + " parameter will force single-tree "
     "search (as opposed to the default dual-tree search), and '" +
-    PRINT_PARAM_STRING("naive") + " will force brute-force range search.");
+    PRINT_PARAM_STRING("naive") + " will force brute-force range search."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("parallel") + " is specified, the points are "
+    "searched in blocks, and the clusters are built by all threads at once.  "
+    "Single-tree and brute-force searches of each block are then run in "
+    "parallel too, so " + PRINT_PARAM_STRING("single_mode") + " or " +
+    PRINT_PARAM_STRING("naive") + " is usually faster with this option.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -98,6 +104,8 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_FLAG("parallel", "If set, the clusters are built in parallel (if OpenMP "
+    "is available).", "P");
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType, typename PointSelectionPolicy>
@@ -106,6 +114,8 @@ void RunDBSCAN(RangeSearchType rs,
 {
   if (IO::HasParam("single_mode"))
     rs.SingleMode() = true;
+  const bool parallel = IO::HasParam("parallel");
+  rs.ParallelQueries() = parallel;
 
   // Load dataset.
   arma::mat dataset = std::move(IO::GetParam<arma::mat>("input"));
@@ -114,7 +124,7 @@ void RunDBSCAN(RangeSearchType rs,
   arma::Row<size_t> assignments;
 
   DBSCAN<RangeSearchType, PointSelectionPolicy> d(epsilon, minSize,
-      !IO::HasParam("single_mode"), rs, pointSelector);
+      !IO::HasParam("single_mode"), rs, pointSelector, parallel);
 
   // If possible, avoid the overhead of calculating centroids.
   if (IO::HasParam("centroids"))
@@ -0,0 +1,158 @@
+/**
+ * @file methods/dbscan/hdbscan.hpp
+ *
+ * An implementation of HDBSCAN*, which extracts the most stable clusters of
+ * the density-based hierarchy of a dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_HDBSCAN_HPP
+#define MLPACK_METHODS_DBSCAN_HDBSCAN_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/single_linkage.hpp>
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * HDBSCAN* (Hierarchical DBSCAN) is a clustering technique described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   title={Density-Based Clustering Based on Hierarchical Density Estimates},
+ *   author={Campello, R.J.G.B. and Moulavi, D. and Sander, J.},
+ *   booktitle={Advances in Knowledge Discovery and Data Mining (PAKDD '13)},
+ *   pages={160--172},
+ *   year={2013}
+ * }
+ * @endcode
+ *
+ * Instead of a single radius like DBSCAN, HDBSCAN* considers all the radii at
+ * once.  The core distance of each point is the distance to its minPoints'th
+ * nearest neighbor (counting the point itself), and the mutual reachability
+ * distance of two points is the largest of their distance and their core
+ * distances.  The single-linkage hierarchy of the mutual reachability distance
+ * is condensed by only keeping the splits where both sides have at least
+ * minClusterSize points (the points of a smaller side fall out of the
+ * cluster), and the clusters of the condensed tree with the largest stability
+ * (excess of mass) are selected.  Points that are in none of the selected
+ * clusters are noise.
+ *
+ * The core distances are computed with a dual-tree k-nearest-neighbor search,
+ * and the minimum spanning tree of the mutual reachability distance with
+ * emst::DualTreeBoruvka, whose pruning rules take the core distances into
+ * account; so the whole algorithm only needs two tree-based passes over the
+ * data, and the extraction of the clusters is linear in the number of points.
+ *
+ * @code
+ * extern arma::mat data;
+ * arma::Row<size_t> assignments;
+ *
+ * HDBSCAN<> h(5, 10);
+ * const size_t clusters = h.Cluster(data, assignments);
+ * @endcode
+ *
+ * @tparam MetricType Metric to use for the distances between points.
+ * @tparam TreeType Type of tree to use for the nearest neighbor search and the
+ *      minimum spanning tree.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class HDBSCAN
+{
+ public:
+  /**
+   * Construct the HDBSCAN object with the given parameters.
+   *
+   * @param minPoints Number of points (including the point itself) in the
+   *      neighborhood that defines the core distance of each point.
+   * @param minClusterSize Minimum number of points of each cluster (at least
+   *      2).
+   * @param metric Optional instantiated metric.
+   */
+  HDBSCAN(const size_t minPoints = 5,
+          const size_t minClusterSize = 5,
+          const MetricType metric = MetricType());
+
+  /**
+   * Perform HDBSCAN* clustering on the data, returning the number of clusters
+   * and also the list of cluster assignments.  If assignments[i] == SIZE_MAX,
+   * then the point is considered "noise".
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   * @return The number of clusters.
+   */
+  size_t Cluster(const arma::mat& data, arma::Row<size_t>& assignments);
+
+  //! Get the number of points that defines the core distances.
+  size_t MinPoints() const { return minPoints; }
+  //! Modify the number of points that defines the core distances.
+  size_t& MinPoints() { return minPoints; }
+
+  //! Get the minimum number of points of each cluster.
+  size_t MinClusterSize() const { return minClusterSize; }
+  //! Modify the minimum number of points of each cluster.
+  size_t& MinClusterSize() { return minClusterSize; }
+
+  /**
+   * Get the condensed tree computed by the last call to Cluster().  Each
+   * column describes one edge of the tree, as in the hdbscan Python package:
+   * the parent cluster, the child (a point if it is less than the number of
+   * points N, and otherwise a cluster), the lambda value (the inverse of the
+   * mutual reachability distance) at which the child left the parent, and the
+   * number of points of the child.  The root cluster is N.
+   */
+  const arma::mat& CondensedTree() const { return condensedTree; }
+
+ private:
+  /**
+   * Condense the single-linkage hierarchy into condensedTree.
+   *
+   * @param linkage Single-linkage hierarchy, as given by emst::SingleLinkage().
+   * @return The number of clusters of the condensed tree.
+   */
+  size_t Condense(const arma::mat& linkage);
+
+  /**
+   * Select the clusters of the condensed tree with the largest stability, and
+   * label the points.
+   *
+   * @param numPoints Number of points.
+   * @param numCondensedClusters Number of clusters of the condensed tree.
+   * @param assignments Vector to store the cluster of each point.
+   * @return The number of selected clusters.
+   */
+  size_t SelectClusters(const size_t numPoints,
+                        const size_t numCondensedClusters,
+                        arma::Row<size_t>& assignments) const;
+
+  //! Number of points that defines the core distances.
+  size_t minPoints;
+
+  //! Minimum number of points of each cluster.
+  size_t minClusterSize;
+
+  //! The instantiated metric.
+  MetricType metric;
+
+  //! The condensed tree of the last clustering.
+  arma::mat condensedTree;
+};
+
+} // namespace dbscan
+} // namespace mlpack
+
+// Include implementation.
+#include "hdbscan_impl.hpp"
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file methods/dbscan/hdbscan_impl.hpp
+ *
+ * Implementation of HDBSCAN*.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_HDBSCAN_IMPL_HPP
+#define MLPACK_METHODS_DBSCAN_HDBSCAN_IMPL_HPP
+
+#include "hdbscan.hpp"
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * Construct the HDBSCAN object with the given parameters.
+ */
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+HDBSCAN<MetricType, TreeType>::HDBSCAN(const size_t minPoints,
+                                       const size_t minClusterSize,
+                                       const MetricType metric) :
+    minPoints(minPoints),
+    minClusterSize(minClusterSize),
+    metric(metric)
+{
+  // Nothing to do.
+}
+
+/**
+ * Perform HDBSCAN* clustering on the data.
+ */
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::Cluster(const arma::mat& data,
+                                              arma::Row<size_t>& assignments)
+{
+  if (minClusterSize < 2)
+  {
+    throw std::invalid_argument("HDBSCAN::Cluster(): the minimum cluster size "
+        "must be at least 2");
+  }
+
+  if (minPoints == 0 || minPoints > data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HDBSCAN::Cluster(): minPoints (" << minPoints << ") must be "
+        << "between 1 and the number of points (" << data.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // With a single point, there is no hierarchy.
+  if (data.n_cols < 2)
+  {
+    condensedTree.set_size(4, 0);
+    assignments.set_size(data.n_cols);
+    assignments.fill(SIZE_MAX);
+    return 0;
+  }
+
+  // The core distance of each point is the distance to its (minPoints - 1)'th
+  // nearest neighbor, since the point itself is not returned.
+  arma::vec coreDistances(data.n_cols, arma::fill::zeros);
+  if (minPoints > 1)
+  {
+    neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+        arma::mat, TreeType> knn(data, neighbor::DUAL_TREE_MODE, 0, metric);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(minPoints - 1, neighbors, distances);
+    coreDistances = distances.row(minPoints - 2).t();
+  }
+
+  // Compute the minimum spanning tree of the mutual reachability distance, and
+  // its single-linkage hierarchy.
+  arma::mat mst;
+  emst::DualTreeBoruvka<MetricType, arma::mat, TreeType> dtb(data, false,
+      metric);
+  dtb.ComputeMST(mst, coreDistances);
+
+  arma::mat linkage;
+  emst::SingleLinkage(mst, linkage);
+
+  const size_t numCondensedClusters = Condense(linkage);
+  return SelectClusters(data.n_cols, numCondensedClusters, assignments);
+}
+
+/**
+ * Condense the single-linkage hierarchy.
+ */
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::Condense(const arma::mat& linkage)
+{
+  const size_t numPoints = linkage.n_cols + 1;
+  std::vector<double> edges;
+  edges.reserve(4 * numPoints);
+
+  // The nodes of the hierarchy still to visit, with their condensed cluster.
+  // The children of each cluster get larger labels than their parent.
+  std::vector<std::pair<size_t, size_t>> stack;
+  stack.push_back(std::make_pair(2 * numPoints - 2, numPoints));
+  size_t nextLabel = numPoints + 1;
+
+  std::vector<size_t> subtree;
+  while (!stack.empty())
+  {
+    const size_t node = stack.back().first;
+    const size_t label = stack.back().second;
+    stack.pop_back();
+
+    const size_t merge = node - numPoints;
+    const size_t children[2] = { (size_t) linkage(0, merge),
+                                 (size_t) linkage(1, merge) };
+    const double distance = linkage(2, merge);
+    const double lambda = (distance > 0.0) ? 1.0 / distance : DBL_MAX;
+
+    size_t sizes[2];
+    for (size_t i = 0; i < 2; ++i)
+    {
+      sizes[i] = (children[i] < numPoints) ? 1 :
+          (size_t) linkage(3, children[i] - numPoints);
+    }
+
+    const bool large[2] = { sizes[0] >= minClusterSize,
+                            sizes[1] >= minClusterSize };
+    for (size_t i = 0; i < 2; ++i)
+    {
+      if (large[i] && large[1 - i])
+      {
+        // A true split: each side is a new cluster.
+        edges.push_back(label);
+        edges.push_back(nextLabel);
+        edges.push_back(lambda);
+        edges.push_back(sizes[i]);
+        stack.push_back(std::make_pair(children[i], nextLabel++));
+      }
+      else if (large[i])
+      {
+        // The cluster only loses the points of the other side.
+        stack.push_back(std::make_pair(children[i], label));
+      }
+      else
+      {
+        // All the points of this side fall out of the cluster.
+        subtree.assign(1, children[i]);
+        while (!subtree.empty())
+        {
+          const size_t n = subtree.back();
+          subtree.pop_back();
+          if (n < numPoints)
+          {
+            edges.push_back(label);
+            edges.push_back(n);
+            edges.push_back(lambda);
+            edges.push_back(1);
+          }
+          else
+          {
+            subtree.push_back((size_t) linkage(0, n - numPoints));
+            subtree.push_back((size_t) linkage(1, n - numPoints));
+          }
+        }
+      }
+    }
+  }
+
+  condensedTree = arma::mat(edges.data(), 4, edges.size() / 4);
+  return nextLabel - numPoints;
+}
+
+/**
+ * Select the most stable clusters of the condensed tree, and label the points.
+ */
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::SelectClusters(
+    const size_t numPoints,
+    const size_t numCondensedClusters,
+    arma::Row<size_t>& assignments) const
+{
+  // Find the lambda at which each cluster appears, and its parent and
+  // children.
+  arma::vec births(numCondensedClusters, arma::fill::zeros);
+  arma::Col<size_t> parents(numCondensedClusters);
+  parents.fill(SIZE_MAX);
+  std::vector<std::vector<size_t>> children(numCondensedClusters);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    const size_t child = (size_t) condensedTree(1, i);
+    if (child >= numPoints)
+    {
+      const size_t parent = (size_t) condensedTree(0, i) - numPoints;
+      births[child - numPoints] = condensedTree(2, i);
+      parents[child - numPoints] = parent;
+      children[parent].push_back(child - numPoints);
+    }
+  }
+
+  // The stability of a cluster is the sum, over its points and child
+  // clusters, of the lambda range during which they were in the cluster.
+  arma::vec stabilities(numCondensedClusters, arma::fill::zeros);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    const size_t parent = (size_t) condensedTree(0, i) - numPoints;
+    stabilities[parent] += (condensedTree(2, i) - births[parent]) *
+        condensedTree(3, i);
+  }
+
+  // Select the clusters bottom-up: a cluster is selected unless its children
+  // are more stable together, and selecting it deselects its descendants.  The
+  // root is never selected.
+  std::vector<bool> selected(numCondensedClusters, false);
+  std::vector<size_t> descendants;
+  for (size_t c = numCondensedClusters - 1; c > 0; --c)
+  {
+    double childStability = 0.0;
+    for (size_t i = 0; i < children[c].size(); ++i)
+      childStability += stabilities[children[c][i]];
+
+    if (childStability > stabilities[c])
+    {
+      stabilities[c] = childStability;
+      continue;
+    }
+
+    selected[c] = true;
+    descendants.assign(children[c].begin(), children[c].end());
+    while (!descendants.empty())
+    {
+      const size_t d = descendants.back();
+      descendants.pop_back();
+      selected[d] = false;
+      descendants.insert(descendants.end(), children[d].begin(),
+          children[d].end());
+    }
+  }
+
+  // Each cluster takes the label of its selected ancestor (parents have
+  // smaller indices than their children).
+  arma::Col<size_t> labels(numCondensedClusters);
+  labels.fill(SIZE_MAX);
+  size_t numClusters = 0;
+  for (size_t c = 0; c < numCondensedClusters; ++c)
+  {
+    if (selected[c])
+      labels[c] = numClusters++;
+    else if (c > 0)
+      labels[c] = labels[parents[c]];
+  }
+
+  // Every point falls out of exactly one cluster.
+  assignments.set_size(numPoints);
+  assignments.fill(SIZE_MAX);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    const size_t child = (size_t) condensedTree(1, i);
+    if (child < numPoints)
+      assignments[child] = labels[(size_t) condensedTree(0, i) - numPoints];
+  }
+
+  return numClusters;
+}
+
+} // namespace dbscan
+} // namespace mlpack
+
+#endif
@@ -28,6 +28,8 @@ namespace decision_stump {
  * last bin has range up to @f$ \infty @f$ (split[i + 1] does not exist in that
  * case).
  * Points that are below the first bin will take the label of the first bin.
+ * When OpenMP is available, the candidate splitting dimensions are searched in
+ * parallel during training.
  *
  * @note
  * This class has been deprecated and should be removed in mlpack 4.0.0.  Use
@@ -104,30 +104,37 @@ double DecisionStump<MatType>::Train(const MatType& data,
 {
   // If classLabels are not all identical, proceed with training.
   size_t bestDim = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<UseWeights>(labels, weights);
 
-  double gain, bestGain = 0.0;
-  for (size_t i = 0; i < data.n_rows; ++i)
+  // Each dimension is searched independently, so the dimensions are searched
+  // in parallel; the gain of a dimension whose values are all identical is 0.
+  arma::vec gains(data.n_rows, arma::fill::zeros);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; ++i)
   {
     // Go through each dimension of the data.
     if (IsDistinct(data.row(i)))
     {
       // For each dimension with non-identical values, treat it as a potential
       // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
+      const double entropy = SetupSplitDimension<UseWeights>(data.row(i),
+          labels, weights);
 
-      gain = rootEntropy - entropy;
-      // Find the dimension with the best entropy so that the gain is
-      // maximized.
+      gains[i] = rootEntropy - entropy;
+    }
+  }
 
-      // We are maximizing gain, which is what is returned from
-      // SetupSplitDimension().
-      if (gain < bestGain)
-      {
-        bestDim = i;
-        bestGain = gain;
-      }
+  // Find the dimension with the best entropy so that the gain is maximized.
+  // We are maximizing gain, which is what is returned from
+  // SetupSplitDimension().  Ties go to the first dimension, whatever the
+  // number of threads.
+  double bestGain = 0.0;
+  for (size_t i = 0; i < data.n_rows; ++i)
+  {
+    if (gains[i] < bestGain)
+    {
+      bestDim = i;
+      bestGain = gains[i];
     }
   }
   splitDimension = bestDim;
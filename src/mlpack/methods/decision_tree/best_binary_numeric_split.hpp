@@ -63,6 +63,48 @@ class BestBinaryNumericSplit
       arma::Col<typename VecType::elem_type>& classProbabilities,
       AuxiliarySplitInfo<typename VecType::elem_type>& aux);
 
+  /**
+   * Check if we can split a node, given the order of its points in the
+   * dimension.  This is the same as SplitIfBetter(), but the points of the
+   * node are the elements of data, labels and weights given by sortedIndices,
+   * which must be sorted by their value in data; so the elements of data that
+   * are not in sortedIndices are ignored, and there is nothing to sort.  This
+   * lets DecisionTree sort each dimension only once, at the root (see
+   * PresortedBinaryNumericSplit).
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param sortedIndices The indices of the points of the node, sorted by
+   *      their value in data.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights,
+           typename VecType,
+           typename IndexVecType,
+           typename LabelsType,
+           typename WeightVecType>
+  static double SplitIfBetterSorted(
+      const double bestGain,
+      const VecType& data,
+      const IndexVecType& sortedIndices,
+      const LabelsType& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
   /**
    * Returns 2, since the binary split always has two children.
    */
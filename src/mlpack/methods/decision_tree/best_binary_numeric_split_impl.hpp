@@ -26,7 +26,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     arma::Col<typename VecType::elem_type>& classProbabilities,
-    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+    AuxiliarySplitInfo<typename VecType::elem_type>& aux)
 {
   // First sanity check: if we don't have enough points, we can't split.
   if (data.n_elem < (minimumLeafSize * 2))
@@ -35,15 +35,47 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     return DBL_MAX; // It can't be outperformed.
 
   // Next, sort the data.
-  arma::uvec sortedIndices = arma::sort_index(data);
-  arma::Row<size_t> sortedLabels(labels.n_elem);
+  const arma::uvec sortedIndices = arma::sort_index(data);
+  return SplitIfBetterSorted<UseWeights>(bestGain, data, sortedIndices, labels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit,
+      classProbabilities, aux);
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights,
+         typename VecType,
+         typename IndexVecType,
+         typename LabelsType,
+         typename WeightVecType>
+double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetterSorted(
+    const double bestGain,
+    const VecType& data,
+    const IndexVecType& sortedIndices,
+    const LabelsType& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  // The number of points of the node.
+  const size_t n = sortedIndices.n_elem;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (n < (minimumLeafSize * 2) || n == 0)
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  arma::Row<size_t> sortedLabels(n);
   arma::rowvec sortedWeights;
   for (size_t i = 0; i < sortedLabels.n_elem; ++i)
     sortedLabels[i] = labels[sortedIndices[i]];
 
   // Sanity check: if the first element is the same as the last, we can't split
   // in this dimension.
-  if (data[sortedIndices[0]] == data[sortedIndices[sortedIndices.n_elem - 1]])
+  if (data[sortedIndices[0]] == data[sortedIndices[n - 1]])
     return DBL_MAX;
 
   // Only initialize if we are using weights.
@@ -82,7 +114,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     }
 
     // These points have to be on the right.
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < n; ++i)
     {
       classWeightSums(sortedLabels[i], 1) += sortedWeights[i];
       totalRightWeight += sortedWeights[i];
@@ -91,7 +123,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   else
   {
     classCounts.zeros(numClasses, 2);
-    bestFoundGain *= data.n_elem;
+    bestFoundGain *= n;
 
     // Initialize the counts.
     // These points have to be on the left.
@@ -99,11 +131,11 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       ++classCounts(sortedLabels[i], 0);
 
     // These points have to be on the right.
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < n; ++i)
       ++classCounts(sortedLabels[i], 1);
   }
 
-  for (size_t index = minimum; index < data.n_elem - minimum; ++index)
+  for (size_t index = minimum; index < n - minimum; ++index)
   {
     // Update class weight sums or counts.
     if (UseWeights)
@@ -17,10 +17,17 @@
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "presorted_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
+#include "flat_decision_tree.hpp"
 #include <type_traits>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -475,12 +482,29 @@ class DecisionTree :
   template<typename VecType>
   size_t CalculateDirection(const VecType& point) const;
 
+  /**
+   * Find the leaf the given point falls into, without recursion.  The class
+   * probabilities of the leaf (ClassProbabilities()) are the ones Classify()
+   * returns for the point.
+   *
+   * @param point Point to find the leaf of.
+   */
+  template<typename VecType>
+  const DecisionTree& FindLeaf(const VecType& point) const;
+
+  //! Get the class probabilities of the node (only meaningful if this is a
+  //! leaf in a trained tree).
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Get the number of classes in the tree.
    */
   size_t NumClasses() const;
 
  private:
+  //! The FlatDecisionTree packs the nodes of the tree.
+  friend class FlatDecisionTree;
+
   //! The vector of children.
   std::vector<DecisionTree*> children;
   //! The dimension this node splits on.
@@ -497,6 +521,10 @@ class DecisionTree :
    */
   arma::vec classProbabilities;
 
+  //! Nodes with at least this many points search their dimensions and build
+  //! their children in parallel, when OpenMP is available.
+  static const size_t ParallelThreshold = 4096;
+
   //! Note that this class will also hold the members of the NumericSplit and
   //! CategoricalSplit AuxiliarySplitInfo classes, since it inherits from them.
   //! We'll define some convenience typedefs here.
@@ -570,6 +598,146 @@ class DecisionTree :
                const double minimumGainSplit,
                const size_t maximumDepth,
                DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Train the node on the given data, assuming all dimensions are numeric,
+   * with the order of the points of the node in each dimension.
+   *
+   * @param data Dataset to train on.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *      this node.
+   * @param count Number of points in this node.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param sortedIndices For each dimension (column), rows begin to begin +
+   *      count - 1 hold the indices of the points of this node, sorted by
+   *      their value in the dimension.  It is empty if the numeric split does
+   *      not use presorted indices.
+   * @param histogramBins The bins of the dataset, which is empty if the
+   *      numeric split does not use histograms of the whole dataset.
+   * @param histograms The histograms of all the dimensions of this node, or
+   *      an empty cube if they are not used (or the node can't be split).
+   *      They are freed (or given to a child) when the node is split.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double Train(MatType& data,
+               const size_t begin,
+               const size_t count,
+               arma::Row<size_t>& labels,
+               const size_t numClasses,
+               arma::rowvec& weights,
+               const size_t minimumLeafSize,
+               const double minimumGainSplit,
+               const size_t maximumDepth,
+               DimensionSelectionType& dimensionSelector,
+               arma::umat& sortedIndices,
+               HistogramBins<typename MatType::elem_type>& histogramBins,
+               arma::cube& histograms);
+
+  /**
+   * Call NumericSplit::SplitIfBetterSorted() if the numeric split uses
+   * presorted indices (see IsPresortedSplit); the overload for other numeric
+   * splits is never called.
+   */
+  template<bool UseWeights,
+           typename VecType,
+           typename IndexVecType,
+           typename WeightsRowType>
+  double SplitIfBetterSorted(std::true_type /* presorted */,
+                             const double bestGain,
+                             const VecType& data,
+                             const IndexVecType& sortedIndices,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const WeightsRowType& weights,
+                             const size_t minimumLeafSize,
+                             const double minimumGainSplit,
+                             arma::vec& classProbabilities,
+                             NumericAuxiliarySplitInfo& aux);
+
+  template<bool UseWeights,
+           typename VecType,
+           typename IndexVecType,
+           typename WeightsRowType>
+  double SplitIfBetterSorted(std::false_type /* presorted */,
+                             const double bestGain,
+                             const VecType& data,
+                             const IndexVecType& sortedIndices,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const WeightsRowType& weights,
+                             const size_t minimumLeafSize,
+                             const double minimumGainSplit,
+                             arma::vec& classProbabilities,
+                             NumericAuxiliarySplitInfo& aux);
+
+  /**
+   * Call NumericSplit::SplitIfBetterHistogram() if the numeric split uses
+   * histograms of the whole dataset (see IsHistogramSplit); the overload for
+   * other numeric splits is never called.
+   */
+  template<bool UseWeights, typename BinElemType>
+  double SplitIfBetterHistogram(std::true_type /* histogram */,
+                                const double bestGain,
+                                const arma::mat& histogram,
+                                const BinElemType* binMin,
+                                const BinElemType* binMax,
+                                const size_t numClasses,
+                                const size_t minimumLeafSize,
+                                const double minimumGainSplit,
+                                arma::vec& classProbabilities,
+                                NumericAuxiliarySplitInfo& aux);
+
+  template<bool UseWeights, typename BinElemType>
+  double SplitIfBetterHistogram(std::false_type /* histogram */,
+                                const double bestGain,
+                                const arma::mat& histogram,
+                                const BinElemType* binMin,
+                                const BinElemType* binMax,
+                                const size_t numClasses,
+                                const size_t minimumLeafSize,
+                                const double minimumGainSplit,
+                                arma::vec& classProbabilities,
+                                NumericAuxiliarySplitInfo& aux);
+
+  /**
+   * Given the gains of the splits of the candidate dimensions of a node, each
+   * computed against the gain of the node (as in a parallel search), return
+   * the index of the split the sequential search would choose, or the number of
+   * gains if there is none.  bestGain is set to its gain.
+   *
+   * @param gains The gain of the best split of each candidate dimension, or
+   *      DBL_MAX if the dimension can't be split.
+   * @param bestGain The gain of the node; set to the gain of the chosen split.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  static size_t BestDimension(const std::vector<double>& gains,
+                              double& bestGain,
+                              const double minimumGainSplit);
+
+  /**
+   * Once the points of a node have been moved to the ranges of its children,
+   * partition the presorted indices of the node the same way, keeping them
+   * sorted in each child.
+   *
+   * @param sortedIndices The presorted indices of the tree.
+   * @param begin Index of the first point of the node.
+   * @param count Number of points in the node.
+   * @param assignments The child of each point, in the order before the move.
+   * @param origins The position before the move of each point of the node.
+   * @param childBegins The index of the first point of each child, and the
+   *      index after the last point of the node.
+   */
+  static void PartitionSortedIndices(arma::umat& sortedIndices,
+                                     const size_t begin,
+                                     const size_t count,
+                                     const arma::Row<size_t>& assignments,
+                                     const std::vector<size_t>& origins,
+                                     const std::vector<size_t>& childBegins);
 };
 
 /**
@@ -681,6 +681,25 @@ double DecisionTree<FitnessFunction,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector)
 {
+  #ifdef HAS_OPENMP
+    // The dimensions and the children of large nodes are handled in parallel,
+    // as OpenMP tasks.  The root opens the parallel region that runs them,
+    // unless we are already in one (for instance, in RandomForest).
+    if (count >= ParallelThreshold && omp_get_max_threads() > 1 &&
+        omp_get_level() == 0)
+    {
+      double gain = 0.0;
+      #pragma omp parallel
+      {
+        #pragma omp single
+        gain = Train<UseWeights>(data, begin, count, datasetInfo, labels,
+            numClasses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector);
+      }
+      return gain;
+    }
+  #endif
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -700,13 +719,19 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
-    for (size_t i = dimensionSelector.Begin(); i != end;
-         i = dimensionSelector.Next())
+    // Find the gain of the best split in the given dimension, if it improves on
+    // the given gain.
+    auto dimensionGain = [&](const size_t i,
+                             const double gain,
+                             arma::vec& probabilities,
+                             NumericAuxiliarySplitInfo& numericAux,
+                             CategoricalAuxiliarySplitInfo& categoricalAux)
+        -> double
     {
-      double dimGain = -DBL_MAX;
+      double dimGain = DBL_MAX;
       if (datasetInfo.Type(i) == data::Datatype::categorical)
       {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(gain,
             data.cols(begin, begin + count - 1).row(i),
             datasetInfo.NumMappings(i),
             labels.subvec(begin, begin + count - 1),
@@ -714,34 +739,77 @@ double DecisionTree<FitnessFunction,
             UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
             minimumLeafSize,
             minimumGainSplit,
-            classProbabilities,
-            *this);
+            probabilities,
+            categoricalAux);
       }
       else if (datasetInfo.Type(i) == data::Datatype::numeric)
       {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(gain,
             data.cols(begin, begin + count - 1).row(i),
             labels.subvec(begin, begin + count - 1),
             numClasses,
             UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
             minimumLeafSize,
             minimumGainSplit,
-            classProbabilities,
-            *this);
+            probabilities,
+            numericAux);
       }
+      return dimGain;
+    };
 
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
 
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
+    if (count >= ParallelThreshold && dimensions.size() > 1)
+    {
+      // Search the dimensions in parallel, each with its own split
+      // information, and keep the split the sequential search would keep.
+      std::vector<double> gains(dimensions.size());
+      std::vector<arma::vec> probabilities(dimensions.size());
+      std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+      std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+          dimensions.size());
+      for (size_t d = 0; d < dimensions.size(); ++d)
+      {
+        #pragma omp task shared(dimensionGain, dimensions, gains, \
+            probabilities, numericAux, categoricalAux) firstprivate(d)
+        gains[d] = dimensionGain(dimensions[d], bestGain, probabilities[d],
+            numericAux[d], categoricalAux[d]);
+      }
+      #pragma omp taskwait
 
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
+      const size_t best = BestDimension(gains, bestGain, minimumGainSplit);
+      if (best != dimensions.size())
+      {
+        bestDim = dimensions[best];
+        classProbabilities = std::move(probabilities[best]);
+        NumericAuxiliarySplitInfo::operator=(numericAux[best]);
+        CategoricalAuxiliarySplitInfo::operator=(categoricalAux[best]);
+      }
+    }
+    else
+    {
+      for (const size_t i : dimensions)
+      {
+        const double dimGain = dimensionGain(i, bestGain, classProbabilities,
+            *this, *this);
+
+        // If the splitter reported that it did not split, move to the next
+        // dimension.
+        if (dimGain == DBL_MAX)
+          continue;
+
+        // Was there an improvement?  If so mark that it's the new best
+        // dimension.
+        bestDim = i;
+        bestGain = dimGain;
+
+        // If the gain is the best possible, no need to keep looking.
+        if (bestGain >= 0.0)
+          break;
+      }
     }
   }
 
@@ -787,11 +855,12 @@ double DecisionTree<FitnessFunction,
     }
 
     // Split into children.
+    std::vector<size_t> childBegins(numChildren + 1);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -803,26 +872,35 @@ double DecisionTree<FitnessFunction,
           ++currentCol;
         }
       }
+    }
+    childBegins[numChildren] = currentCol;
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
+    // Now build the children recursively; large children are built by other
+    // threads, if some are free.  Each child gets its own dimension selector.
+    children.resize(numChildren);
+    std::vector<double> childGains(numChildren);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+      #pragma omp task if (childCount >= ParallelThreshold) shared(data, \
+          datasetInfo, labels, weights, dimensionSelector, childBegins, \
+          childGains) firstprivate(i, childCount)
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childSelector(dimensionSelector);
+        children[i] = new DecisionTree();
+        childGains[i] = children[i]->template Train<UseWeights>(data,
+            childBegins[i], childCount, datasetInfo, labels, numClasses,
+            weights, NoRecursion ? childCount : minimumLeafSize,
+            minimumGainSplit, maximumDepth - 1, childSelector);
       }
-      children.push_back(child);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -865,6 +943,86 @@ double DecisionTree<FitnessFunction,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector)
+{
+  // If the numeric split uses presorted indices, sort each dimension once for
+  // the whole tree; the children get their part of the order when the node is
+  // split.
+  arma::umat sortedIndices;
+  if (IsPresortedSplit<NumericSplit>::value && count > 0)
+  {
+    sortedIndices.set_size(count, data.n_rows);
+    for (size_t i = 0; i < data.n_rows; ++i)
+    {
+      sortedIndices.col(i) = arma::sort_index(
+          data.cols(begin, begin + count - 1).row(i)) + begin;
+    }
+  }
+
+  // If the numeric split uses histograms, quantize each dimension once for the
+  // whole tree, and build the histograms of the root; the histograms of the
+  // children are built when the node is split.
+  HistogramBins<typename MatType::elem_type> histogramBins;
+  arma::cube histograms;
+  if (IsHistogramSplit<NumericSplit>::value && count > 0)
+  {
+    histogramBins.Quantize(data, begin, count,
+        IsHistogramSplit<NumericSplit>::maxBins);
+    histogramBins.template Histograms<UseWeights>(labels, numClasses, weights,
+        begin, count, histograms);
+  }
+
+  #ifdef HAS_OPENMP
+    // The dimensions and the children of large nodes are handled in parallel,
+    // as OpenMP tasks.  Open the parallel region that runs them, unless we are
+    // already in one (for instance, in RandomForest).
+    if (count >= ParallelThreshold && omp_get_max_threads() > 1 &&
+        omp_get_level() == 0)
+    {
+      double gain = 0.0;
+      #pragma omp parallel
+      {
+        #pragma omp single
+        gain = Train<UseWeights>(data, begin, count, labels, numClasses,
+            weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+            dimensionSelector, sortedIndices, histogramBins, histograms);
+      }
+      return gain;
+    }
+  #endif
+
+  return Train<UseWeights>(data, begin, count, labels, numClasses, weights,
+      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector,
+      sortedIndices, histogramBins, histograms);
+}
+
+//! Train on the given data with presorted indices or histograms, assuming all
+//! dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    arma::umat& sortedIndices,
+    HistogramBins<typename MatType::elem_type>& histogramBins,
+    arma::cube& histograms)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -887,11 +1045,39 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
-    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
-         i = dimensionSelector.Next())
+    // Find the gain of the best split in the given dimension, if it improves on
+    // the given gain.
+    auto dimensionGain = [&](const size_t i,
+                             const double gain,
+                             arma::vec& probabilities,
+                             NumericAuxiliarySplitInfo& aux) -> double
     {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
+      if (!sortedIndices.is_empty())
+      {
+        return SplitIfBetterSorted<UseWeights>(
+            std::integral_constant<bool,
+                IsPresortedSplit<NumericSplit>::value>(),
+            gain, data.row(i),
+            sortedIndices.col(i).subvec(begin, begin + count - 1), labels,
+            numClasses, weights, minimumLeafSize, minimumGainSplit,
+            probabilities, aux);
+      }
+
+      if (!histograms.is_empty())
+      {
+        // Cube::slice() is not safe to call from several threads.
+        const arma::mat histogram(histograms.slice_memptr(i),
+            histograms.n_rows, histograms.n_cols, false, true);
+        return SplitIfBetterHistogram<UseWeights>(
+            std::integral_constant<bool,
+                IsHistogramSplit<NumericSplit>::value>(),
+            gain, histogram, histogramBins.BinMin().colptr(i),
+            histogramBins.BinMax().colptr(i), numClasses, minimumLeafSize,
+            minimumGainSplit, probabilities, aux);
+      }
+
+      return NumericSplitType<FitnessFunction>::template
+          SplitIfBetter<UseWeights>(gain,
                                     data.cols(begin, begin + count - 1).row(i),
                                     labels.cols(begin, begin + count - 1),
                                     numClasses,
@@ -900,20 +1086,58 @@ double DecisionTree<FitnessFunction,
                                         weights,
                                     minimumLeafSize,
                                     minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
+                                    probabilities,
+                                    aux);
+    };
 
-      // If the splitter did not report that it improved, then move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
 
-      bestDim = i;
-      bestGain = dimGain;
+    if (count >= ParallelThreshold && dimensions.size() > 1)
+    {
+      // Search the dimensions in parallel, each with its own split
+      // information, and keep the split the sequential search would keep.
+      std::vector<double> gains(dimensions.size());
+      std::vector<arma::vec> probabilities(dimensions.size());
+      std::vector<NumericAuxiliarySplitInfo> aux(dimensions.size());
+      for (size_t d = 0; d < dimensions.size(); ++d)
+      {
+        #pragma omp task shared(dimensionGain, dimensions, gains, \
+            probabilities, aux) firstprivate(d)
+        gains[d] = dimensionGain(dimensions[d], bestGain, probabilities[d],
+            aux[d]);
+      }
+      #pragma omp taskwait
 
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
+      const size_t best = BestDimension(gains, bestGain, minimumGainSplit);
+      if (best != dimensions.size())
+      {
+        bestDim = dimensions[best];
+        classProbabilities = std::move(probabilities[best]);
+        NumericAuxiliarySplitInfo::operator=(aux[best]);
+      }
+    }
+    else
+    {
+      for (const size_t i : dimensions)
+      {
+        const double dimGain = dimensionGain(i, bestGain, classProbabilities,
+            *this);
+
+        // If the splitter did not report that it improved, then move to the
+        // next dimension.
+        if (dimGain == DBL_MAX)
+          continue;
+
+        bestDim = i;
+        bestGain = dimGain;
+
+        // If the gain is the best possible, no need to keep looking.
+        if (bestGain >= 0.0)
+          break;
+      }
     }
   }
 
@@ -946,11 +1170,23 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
+    // Move the points of each child together, recording where each point
+    // comes from for the presorted indices.
+    const arma::Row<size_t> assignments = childAssignments;
+    std::vector<size_t> origins;
+    if (!sortedIndices.is_empty())
+    {
+      origins.resize(count);
+      for (size_t j = 0; j < count; ++j)
+        origins[j] = begin + j;
+    }
+
+    std::vector<size_t> childBegins(numChildren + 1);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -959,35 +1195,85 @@ double DecisionTree<FitnessFunction,
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
+          if (!origins.empty())
+            std::swap(origins[currentCol - begin], origins[j - begin]);
+          if (!histogramBins.IsEmpty())
+            histogramBins.Swap(currentCol, j);
           ++currentCol;
         }
       }
+    }
+    childBegins[numChildren] = currentCol;
+
+    if (!sortedIndices.is_empty())
+    {
+      PartitionSortedIndices(sortedIndices, begin, count, assignments,
+          origins, childBegins);
+    }
+
+    // Give the children that may be split their histograms: those of the
+    // largest child are the histograms of the node minus those of the other
+    // children, which are built from their points.
+    std::vector<arma::cube> childHistograms(numChildren);
+    if (!histograms.is_empty() && !NoRecursion && maximumDepth != 2)
+    {
+      size_t largest = 0;
+      for (size_t i = 1; i < numChildren; ++i)
+        if (childCounts[i] > childCounts[largest])
+          largest = i;
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
+      childHistograms[largest] = std::move(histograms);
+      for (size_t i = 0; i < numChildren; ++i)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+        if (i == largest)
+          continue;
+
+        histogramBins.template Histograms<UseWeights>(labels, numClasses,
+            weights, childBegins[i], childCounts[i], childHistograms[i]);
+        childHistograms[largest] -= childHistograms[i];
       }
-      else
+
+      // The children that are too small to be split don't need them.
+      for (size_t i = 0; i < numChildren; ++i)
+        if (childCounts[i] < std::max(2 * minimumLeafSize, (size_t) 2))
+          childHistograms[i].reset();
+    }
+    histograms.reset();
+
+    // Now build the children recursively; large children are built by other
+    // threads, if some are free.  Each child gets its own dimension selector.
+    children.resize(numChildren);
+    std::vector<double> childGains(numChildren);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+      #pragma omp task if (childCount >= ParallelThreshold) shared(data, \
+          labels, weights, dimensionSelector, sortedIndices, histogramBins, \
+          childHistograms, childBegins, childGains) firstprivate(i, childCount)
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childSelector(dimensionSelector);
+        children[i] = new DecisionTree();
+        childGains[i] = children[i]->template Train<UseWeights>(data,
+            childBegins[i], childCount, labels, numClasses, weights,
+            NoRecursion ? childCount : minimumLeafSize, minimumGainSplit,
+            maximumDepth - 1, childSelector, sortedIndices, histogramBins,
+            childHistograms[i]);
       }
-      children.push_back(child);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
   {
     // We won't be needing these members, so reset them.
     NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    histograms.reset();
 
     // Calculate class probabilities because we are a leaf.
     CalculateClassProbabilities<UseWeights>(
@@ -999,6 +1285,221 @@ double DecisionTree<FitnessFunction,
   return -bestGain;
 }
 
+//! Call the sorted split of the numeric split type.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights,
+         typename VecType,
+         typename IndexVecType,
+         typename WeightsRowType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::SplitIfBetterSorted(
+    std::true_type /* presorted */,
+    const double bestGain,
+    const VecType& data,
+    const IndexVecType& sortedIndices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightsRowType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& classProbabilities,
+    NumericAuxiliarySplitInfo& aux)
+{
+  return NumericSplit::template SplitIfBetterSorted<UseWeights>(bestGain, data,
+      sortedIndices, labels, numClasses, weights, minimumLeafSize,
+      minimumGainSplit, classProbabilities, aux);
+}
+
+//! The numeric split type does not use presorted indices.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights,
+         typename VecType,
+         typename IndexVecType,
+         typename WeightsRowType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::SplitIfBetterSorted(
+    std::false_type /* presorted */,
+    const double /* bestGain */,
+    const VecType& /* data */,
+    const IndexVecType& /* sortedIndices */,
+    const arma::Row<size_t>& /* labels */,
+    const size_t /* numClasses */,
+    const WeightsRowType& /* weights */,
+    const size_t /* minimumLeafSize */,
+    const double /* minimumGainSplit */,
+    arma::vec& /* classProbabilities */,
+    NumericAuxiliarySplitInfo& /* aux */)
+{
+  // This is never called: the indices are only presorted for split types that
+  // use them.
+  return DBL_MAX;
+}
+
+//! Call the histogram split of the numeric split type.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename BinElemType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::SplitIfBetterHistogram(
+    std::true_type /* histogram */,
+    const double bestGain,
+    const arma::mat& histogram,
+    const BinElemType* binMin,
+    const BinElemType* binMax,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& classProbabilities,
+    NumericAuxiliarySplitInfo& aux)
+{
+  return NumericSplit::template SplitIfBetterHistogram<UseWeights>(bestGain,
+      histogram, binMin, binMax, numClasses, minimumLeafSize,
+      minimumGainSplit, classProbabilities, aux);
+}
+
+//! The numeric split type does not use histograms of the whole dataset.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename BinElemType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::SplitIfBetterHistogram(
+    std::false_type /* histogram */,
+    const double /* bestGain */,
+    const arma::mat& /* histogram */,
+    const BinElemType* /* binMin */,
+    const BinElemType* /* binMax */,
+    const size_t /* numClasses */,
+    const size_t /* minimumLeafSize */,
+    const double /* minimumGainSplit */,
+    arma::vec& /* classProbabilities */,
+    NumericAuxiliarySplitInfo& /* aux */)
+{
+  // This is never called: the histograms are only built for split types that
+  // use them.
+  return DBL_MAX;
+}
+
+//! Partition the presorted indices of a node between its children.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+void DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::PartitionSortedIndices(
+    arma::umat& sortedIndices,
+    const size_t begin,
+    const size_t count,
+    const arma::Row<size_t>& assignments,
+    const std::vector<size_t>& origins,
+    const std::vector<size_t>& childBegins)
+{
+  // The new position of each point of the node.
+  std::vector<size_t> positions(count);
+  for (size_t j = 0; j < count; ++j)
+    positions[origins[j] - begin] = begin + j;
+
+  // Distribute each dimension in order, so that the part of each child stays
+  // sorted.
+  arma::uvec buffer(count);
+  std::vector<size_t> next(childBegins.size() - 1);
+  for (size_t i = 0; i < sortedIndices.n_cols; ++i)
+  {
+    for (size_t c = 0; c < next.size(); ++c)
+      next[c] = childBegins[c] - begin;
+
+    arma::uword* indices = sortedIndices.colptr(i) + begin;
+    for (size_t j = 0; j < count; ++j)
+    {
+      const size_t point = indices[j] - begin;
+      buffer[next[assignments[point]]++] = positions[point];
+    }
+
+    std::copy(buffer.begin(), buffer.end(), indices);
+  }
+}
+
+//! Choose the best dimension from the gains of a parallel search.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::BestDimension(
+    const std::vector<double>& gains,
+    double& bestGain,
+    const double minimumGainSplit)
+{
+  size_t best = gains.size();
+  for (size_t d = 0; d < gains.size(); ++d)
+  {
+    // If the splitter reported that it did not split, move to the next
+    // dimension.
+    if (gains[d] == DBL_MAX)
+      continue;
+
+    // Every split improves on the gain of the node, but the sequential search
+    // would only keep it if it also improves on the best split so far.
+    if (best != gains.size() && gains[d] < 0.0 &&
+        gains[d] <= std::min(bestGain + minimumGainSplit, 0.0))
+      continue;
+
+    best = d;
+    bestGain = gains[d];
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+
+  return best;
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -1174,6 +1675,34 @@ size_t DecisionTree<FitnessFunction,
         classProbabilities, *this);
 }
 
+// Find the leaf of the given point.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename VecType>
+const DecisionTree<FitnessFunction,
+                   NumericSplitType,
+                   CategoricalSplitType,
+                   DimensionSelectionType,
+                   ElemType,
+                   NoRecursion>&
+DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             ElemType,
+             NoRecursion>::FindLeaf(const VecType& point) const
+{
+  const DecisionTree* node = this;
+  while (node->children.size() != 0)
+    node = node->children[node->CalculateDirection(point)];
+
+  return *node;
+}
+
 // Get the number of classes in the tree.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -0,0 +1,167 @@
+/**
+ * @file methods/decision_tree/flat_decision_tree.hpp
+ *
+ * A read-only copy of a trained DecisionTree, packed into one contiguous array
+ * of nodes for fast classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A FlatDecisionTree holds the same model as a trained DecisionTree, for
+ * inference only.  Instead of following the pointers between the nodes of the
+ * DecisionTree, classification walks one std::vector of small nodes: all the
+ * children of a node are stored next to each other, so each node only needs
+ * the offset of its first child, and the class probabilities of the leaves are
+ * the columns of one matrix.  The leaves are numbered from left to right, in
+ * the order they are met by a depth-first traversal.
+ *
+ * The numeric splits of the tree must be binary, and send the points whose
+ * value is less than or equal to the split point to the first child, like
+ * BestBinaryNumericSplit and HistogramNumericSplit do; the categorical splits
+ * must send each category to its own child, like AllCategoricalSplit does.
+ *
+ * @code
+ * DecisionTree<> tree(data, labels, numClasses);
+ * FlatDecisionTree flatTree(tree);
+ * flatTree.Classify(testData, predictions, probabilities);
+ * @endcode
+ */
+class FlatDecisionTree
+{
+ public:
+  /**
+   * A node of the tree.  If the node is a leaf, numChildren is 0, dimension is
+   * the majority class and child is the index of the leaf (its column in
+   * LeafProbabilities()).  Otherwise, the node sends a point to the node of
+   * index child if its value in the dimension is at most threshold, and to
+   * child + 1 if not; or, if the node is categorical, to child plus the
+   * category of the point.
+   */
+  struct Node
+  {
+    double threshold;
+    size_t dimension;
+    size_t child;
+    size_t numChildren;
+    bool categorical;
+  };
+
+  /**
+   * Create an empty flat tree; it can't classify anything.
+   */
+  FlatDecisionTree() { }
+
+  /**
+   * Pack the given trained DecisionTree.  The flat tree does not refer to the
+   * original tree, which may be destroyed.
+   *
+   * @param tree Tree to pack.
+   */
+  template<typename TreeType>
+  explicit FlatDecisionTree(const TreeType& tree);
+
+  /**
+   * Classify the given point.
+   *
+   * @param point Point to classify.
+   * @return Predicted class of the point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const
+  {
+    return nodes[FindLeaf(point)].dimension;
+  }
+
+  /**
+   * Classify the given point and also return estimates of the probability for
+   * each class in the given vector.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities for the
+   *      point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points and also return estimates of the probabilities
+   * for each class in the given matrix.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  /**
+   * Find the node of the leaf the given point falls in.
+   *
+   * @param point Point to find the leaf of.
+   * @return Index of the leaf node in Nodes().
+   */
+  template<typename VecType>
+  size_t FindLeaf(const VecType& point) const;
+
+  //! Get the nodes of the tree; the first one is the root.
+  const std::vector<Node>& Nodes() const { return nodes; }
+
+  //! Get the class probabilities of each leaf, one column per leaf.
+  const arma::mat& LeafProbabilities() const { return leafProbabilities; }
+
+  //! Get the number of leaves.
+  size_t NumLeaves() const { return leafProbabilities.n_cols; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return leafProbabilities.n_rows; }
+
+ private:
+  /**
+   * Fill the node of the given index, and the nodes of its subtree, from the
+   * given node of a DecisionTree.
+   */
+  template<typename TreeType>
+  void Pack(const TreeType& tree,
+            const size_t index,
+            std::vector<const arma::vec*>& leaves);
+
+  //! The nodes of the tree.
+  std::vector<Node> nodes;
+  //! The class probabilities of each leaf.
+  arma::mat leafProbabilities;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_decision_tree_impl.hpp"
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file methods/decision_tree/flat_decision_tree_impl.hpp
+ *
+ * Implementation of the FlatDecisionTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_DECISION_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_decision_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+FlatDecisionTree::FlatDecisionTree(const TreeType& tree)
+{
+  // The root is the first node; the children of each node are allocated
+  // together when the node is packed.
+  std::vector<const arma::vec*> leaves;
+  nodes.resize(1);
+  Pack(tree, 0, leaves);
+
+  leafProbabilities.set_size(leaves[0]->n_elem, leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+    leafProbabilities.col(i) = *leaves[i];
+}
+
+template<typename TreeType>
+void FlatDecisionTree::Pack(const TreeType& tree,
+                            const size_t index,
+                            std::vector<const arma::vec*>& leaves)
+{
+  if (tree.NumChildren() == 0)
+  {
+    nodes[index].threshold = 0.0;
+    nodes[index].dimension = tree.dimensionTypeOrMajorityClass;
+    nodes[index].child = leaves.size();
+    nodes[index].numChildren = 0;
+    nodes[index].categorical = false;
+    leaves.push_back(&tree.classProbabilities);
+    return;
+  }
+
+  // For the numeric splits, the split point is the first element of the class
+  // probabilities of the node.
+  const bool categorical = ((data::Datatype) tree.dimensionTypeOrMajorityClass
+      == data::Datatype::categorical);
+  const size_t child = nodes.size();
+  nodes[index].threshold = categorical ? 0.0 : tree.classProbabilities[0];
+  nodes[index].dimension = tree.SplitDimension();
+  nodes[index].child = child;
+  nodes[index].numChildren = tree.NumChildren();
+  nodes[index].categorical = categorical;
+
+  // This may reallocate the nodes, so the reference to the node is not kept.
+  nodes.resize(child + tree.NumChildren());
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    Pack(tree.Child(i), child + i, leaves);
+}
+
+template<typename VecType>
+size_t FlatDecisionTree::FindLeaf(const VecType& point) const
+{
+  size_t index = 0;
+  while (nodes[index].numChildren != 0)
+  {
+    const Node& node = nodes[index];
+    if (node.categorical)
+      index = node.child + (size_t) point[node.dimension];
+    else
+      index = node.child + (point[node.dimension] <= node.threshold ? 0 : 1);
+  }
+
+  return index;
+}
+
+template<typename VecType>
+void FlatDecisionTree::Classify(const VecType& point,
+                                size_t& prediction,
+                                arma::vec& probabilities) const
+{
+  const Node& leaf = nodes[FindLeaf(point)];
+  prediction = leaf.dimension;
+  probabilities = leafProbabilities.col(leaf.child);
+}
+
+template<typename MatType>
+void FlatDecisionTree::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions) const
+{
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = Classify(data.col(i));
+}
+
+template<typename MatType>
+void FlatDecisionTree::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& probabilities) const
+{
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(NumClasses(), data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const Node& leaf = nodes[FindLeaf(data.col(i))];
+    predictions[i] = leaf.dimension;
+    probabilities.col(i) = leafProbabilities.col(leaf.child);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
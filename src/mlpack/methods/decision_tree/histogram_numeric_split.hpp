@@ -0,0 +1,270 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split among the bounds of
+ * a histogram of the points of the node.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HistogramNumericSplitType is a splitting function for decision trees
+ * that approximates the BestBinaryNumericSplit.  Instead of sorting the points
+ * of the node, it counts the points of each class in MaxBins bins of equal
+ * width between the smallest and the largest value of the node, and only
+ * considers splits between two bins.  So the split search takes O(n + MaxBins
+ * * numClasses) time instead of O(n log n), and it never reads the data more
+ * than twice.
+ *
+ * The split points are still placed halfway between two actual values of the
+ * node (the largest one of the left bins and the smallest one of the right
+ * bins), so when each distinct value gets its own bin (for instance, with few
+ * distinct values), this finds the same splits as the BestBinaryNumericSplit.
+ *
+ * When the DecisionTree is trained on numeric data only, it does not call
+ * SplitIfBetter() (see IsHistogramSplit): it quantizes each dimension of the
+ * whole dataset once into at most MaxBins bins (see HistogramBins), holding
+ * the bin of each value in a matrix of bytes, and keeps the histograms of all
+ * the dimensions of each node.  Only the histograms of the smaller child of a
+ * node are built from its points; those of the larger child are the
+ * difference between the histograms of the node and of the smaller child.
+ * Each node then calls SplitIfBetterHistogram(), which only reads the
+ * histograms, so the split search of a node doesn't depend on its number of
+ * points.  The bins hold about the same number of points each (or one distinct
+ * value each, if there are at most MaxBins distinct values).
+ *
+ * Use the HistogramNumericSplit alias (256 bins) as the NumericSplitType of
+ * DecisionTree or RandomForest:
+ *
+ * @code
+ * DecisionTree<GiniGain, HistogramNumericSplit> tree(data, labels,
+ *     numClasses);
+ * @endcode
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ * @tparam MaxBins Maximum number of bins of the histogram.
+ */
+template<typename FitnessFunction, size_t MaxBins>
+class HistogramNumericSplitType
+{
+  static_assert(MaxBins >= 2 && MaxBins <= 256, "HistogramNumericSplitType: "
+      "the number of bins must be between 2 and 256, so that the bins fit in "
+      "a byte.");
+
+ public:
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Check if we can split a node, given the histogram of one dimension of the
+   * node, in the same way as SplitIfBetter().  Row c < numClasses of the
+   * histogram holds the number (or the weight) of the points of class c in
+   * each bin, and row numClasses holds the number of points of each bin.  The
+   * split between two bins is placed halfway between the largest value of the
+   * left bin and the smallest value of the right bin.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param histogram The histogram of the dimension, with one column per bin.
+   * @param binMin The smallest value of each bin.
+   * @param binMax The largest value of each bin.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename ElemType>
+  static double SplitIfBetterHistogram(
+      const double bestGain,
+      const arma::mat& histogram,
+      const ElemType* binMin,
+      const ElemType* binMax,
+      const size_t numClasses,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<ElemType>& classProbabilities,
+      AuxiliarySplitInfo<ElemType>& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    if (point <= classProbabilities[0])
+      return 0; // Go left.
+    else
+      return 1; // Go right.
+  }
+};
+
+/**
+ * The HistogramNumericSplit uses histograms of 256 bins.
+ */
+template<typename FitnessFunction>
+using HistogramNumericSplit = HistogramNumericSplitType<FitnessFunction, 256>;
+
+/**
+ * The bins of each dimension of a dataset, for the histograms of the
+ * HistogramNumericSplitType: each dimension is quantized once, into at most
+ * the given number of bins holding about the same number of points, and the
+ * bin of each value is held in a byte.
+ *
+ * @tparam ElemType The type of the values of the dataset.
+ */
+template<typename ElemType>
+class HistogramBins
+{
+ public:
+  /**
+   * Quantize the points begin to begin + count - 1 of the given dataset.  The
+   * bins of the other points are not set.
+   *
+   * @param data The dataset (one point per column).
+   * @param begin Index of the first point to quantize.
+   * @param count Number of points to quantize.
+   * @param maxBins Maximum number of bins of each dimension (at most 256).
+   */
+  template<typename MatType>
+  void Quantize(const MatType& data,
+                const size_t begin,
+                const size_t count,
+                const size_t maxBins);
+
+  /**
+   * Build the histograms of all the dimensions of the points begin to begin +
+   * count - 1: slice i holds the histogram of dimension i, in the format of
+   * HistogramNumericSplitType::SplitIfBetterHistogram().
+   *
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of the points (only used if UseWeights is true).
+   * @param begin Index of the first point.
+   * @param count Number of points.
+   * @param histograms The histograms to fill.
+   */
+  template<bool UseWeights>
+  void Histograms(const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const arma::rowvec& weights,
+                  const size_t begin,
+                  const size_t count,
+                  arma::cube& histograms) const;
+
+  //! Swap the bins of two points, when the points are swapped in the dataset.
+  void Swap(const size_t first, const size_t second)
+  { bins.swap_cols(first, second); }
+
+  //! Return whether the dataset has been quantized.
+  bool IsEmpty() const { return bins.is_empty(); }
+
+  //! Get the bin of each value (one point per column).
+  const arma::Mat<unsigned char>& Bins() const { return bins; }
+  //! Get the smallest value of each bin (one dimension per column).
+  const arma::Mat<ElemType>& BinMin() const { return binMin; }
+  //! Get the largest value of each bin (one dimension per column).
+  const arma::Mat<ElemType>& BinMax() const { return binMax; }
+
+ private:
+  //! The bin of each value.
+  arma::Mat<unsigned char> bins;
+  //! The smallest value of each bin.
+  arma::Mat<ElemType> binMin;
+  //! The largest value of each bin.
+  arma::Mat<ElemType> binMax;
+};
+
+/**
+ * IsHistogramSplit::value is true if the DecisionTree should quantize the
+ * dataset for the given numeric split type, and call its
+ * SplitIfBetterHistogram() method with histograms of the whole dataset
+ * instead of SplitIfBetter(); maxBins is then the maximum number of bins.
+ *
+ * @tparam NumericSplitType The numeric split type.
+ */
+template<typename NumericSplitType>
+struct IsHistogramSplit
+{
+  static const bool value = false;
+  static const size_t maxBins = 0;
+};
+
+//! The HistogramNumericSplitType uses histograms of the whole dataset.
+template<typename FitnessFunction, size_t MaxBins>
+struct IsHistogramSplit<HistogramNumericSplitType<FitnessFunction, MaxBins>>
+{
+  static const bool value = true;
+  static const size_t maxBins = MaxBins;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,284 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the strategy that finds the best binary numeric split
+ * from a histogram of the points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction, size_t MaxBins>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplitType<FitnessFunction, MaxBins>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& aux)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  const size_t n = data.n_elem;
+  if (n < (minimumLeafSize * 2) || n < 2)
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Sanity check: if all the values are the same, we can't split in this
+  // dimension.
+  const ElemType minValue = data.min();
+  const ElemType maxValue = data.max();
+  if (minValue == maxValue)
+    return DBL_MAX;
+
+  // Build the histogram of the node, with bins of equal width: the number (or
+  // the weight) of the points of each class in each bin, the number of points
+  // of each bin, and the range of the values of each bin.
+  const size_t bins = std::min(MaxBins, n);
+  const double scale = double(bins) / (double(maxValue) - double(minValue));
+  arma::mat histogram(numClasses + 1, bins, arma::fill::zeros);
+  arma::Col<ElemType> binMin(bins), binMax(bins);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const ElemType value = data[i];
+    const size_t bin = std::min(bins - 1,
+        (size_t) ((double(value) - double(minValue)) * scale));
+
+    histogram(labels[i], bin) += UseWeights ? double(weights[i]) : 1.0;
+
+    if (histogram(numClasses, bin) == 0 || value < binMin[bin])
+      binMin[bin] = value;
+    if (histogram(numClasses, bin) == 0 || value > binMax[bin])
+      binMax[bin] = value;
+    ++histogram(numClasses, bin);
+  }
+
+  return SplitIfBetterHistogram<UseWeights>(bestGain, histogram,
+      binMin.memptr(), binMax.memptr(), numClasses, minimumLeafSize,
+      minimumGainSplit, classProbabilities, aux);
+}
+
+template<typename FitnessFunction, size_t MaxBins>
+template<bool UseWeights, typename ElemType>
+double HistogramNumericSplitType<FitnessFunction, MaxBins>::
+SplitIfBetterHistogram(
+    const double bestGain,
+    const arma::mat& histogram,
+    const ElemType* binMin,
+    const ElemType* binMax,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<ElemType>& classProbabilities,
+    AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  const size_t bins = histogram.n_cols;
+  const size_t n = (size_t) arma::accu(histogram.row(numClasses));
+  if (n < (minimumLeafSize * 2) || n < 2)
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // The totals of the node, and the running totals of the left child.
+  arma::Col<size_t> leftCounts, rightCounts;
+  arma::vec leftWeights, rightWeights;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  if (UseWeights)
+  {
+    leftWeights.zeros(numClasses);
+    rightWeights = arma::sum(histogram.head_rows(numClasses), 1);
+    totalWeight = arma::accu(rightWeights);
+  }
+  else
+  {
+    leftCounts.zeros(numClasses);
+    rightCounts = arma::conv_to<arma::Col<size_t>>::from(
+        arma::sum(histogram.head_rows(numClasses), 1));
+  }
+
+  // Loop through the bounds between the non-empty bins, choosing the best one.
+  // Also, force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bestFoundGain *= UseWeights ? totalWeight : double(n);
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  size_t leftSize = 0;
+  size_t last = bins; // The last non-empty bin on the left.
+  for (size_t bin = 0; bin < bins; ++bin)
+  {
+    const size_t binSize = (size_t) histogram(numClasses, bin);
+    if (binSize == 0)
+      continue;
+
+    // Try the split between the last non-empty bin and this one.
+    // As in the BestBinaryNumericSplit, the right child must have more than
+    // the minimum number of points.
+    if (last != bins && leftSize >= minimum && n - leftSize > minimum)
+    {
+      double gain;
+      if (UseWeights)
+      {
+        const double totalRightWeight = totalWeight - totalLeftWeight;
+        gain = totalLeftWeight * FitnessFunction::template
+            EvaluatePtr<true>(leftWeights.memptr(), numClasses,
+            totalLeftWeight) + totalRightWeight * FitnessFunction::template
+            EvaluatePtr<true>(rightWeights.memptr(), numClasses,
+            totalRightWeight);
+      }
+      else
+      {
+        gain = double(leftSize) * FitnessFunction::template
+            EvaluatePtr<false>(leftCounts.memptr(), numClasses, leftSize) +
+            double(n - leftSize) * FitnessFunction::template
+            EvaluatePtr<false>(rightCounts.memptr(), numClasses,
+            size_t(n - leftSize));
+      }
+
+      if (gain >= 0.0 || gain > bestFoundGain)
+      {
+        // The split value is halfway between the values around the bound.
+        bestFoundGain = gain;
+        classProbabilities.set_size(1);
+        classProbabilities[0] = (binMax[last] + binMin[bin]) / 2.0;
+        improved = true;
+
+        // Corner case: no split will be better than this one.
+        if (gain >= 0.0)
+          return gain;
+      }
+    }
+
+    // Move this bin to the left child.
+    for (size_t c = 0; c < numClasses; ++c)
+    {
+      if (UseWeights)
+      {
+        leftWeights[c] += histogram(c, bin);
+        rightWeights[c] -= histogram(c, bin);
+        totalLeftWeight += histogram(c, bin);
+      }
+      else
+      {
+        leftCounts[c] += (size_t) histogram(c, bin);
+        rightCounts[c] -= (size_t) histogram(c, bin);
+      }
+    }
+    leftSize += binSize;
+    last = bin;
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= n;
+
+  return bestFoundGain;
+}
+
+template<typename ElemType>
+template<typename MatType>
+void HistogramBins<ElemType>::Quantize(const MatType& data,
+                                       const size_t begin,
+                                       const size_t count,
+                                       const size_t maxBins)
+{
+  bins.set_size(data.n_rows, data.n_cols);
+  binMin.zeros(maxBins, data.n_rows);
+  binMax.zeros(maxBins, data.n_rows);
+
+  #pragma omp parallel for if (count * data.n_rows >= 65536)
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    const arma::Row<ElemType> values = data.row(d).cols(begin,
+        begin + count - 1);
+    const arma::Row<ElemType> sorted = arma::sort(values);
+
+    // If there are few distinct values, each one gets its own bin; otherwise,
+    // a bin is closed once it holds its share of the points, and never in the
+    // middle of a run of equal values.
+    size_t distinct = (count > 0) ? 1 : 0;
+    for (size_t j = 1; j < count; ++j)
+      distinct += (sorted[j] != sorted[j - 1]);
+    const size_t binSize = (distinct <= maxBins) ? 1 :
+        (count + maxBins - 1) / maxBins;
+
+    ElemType* dimMin = binMin.colptr(d);
+    ElemType* dimMax = binMax.colptr(d);
+    size_t numBins = 0;
+    size_t inBin = 0;
+    for (size_t j = 0; j < count; ++j)
+    {
+      if (j == 0 || (sorted[j] != sorted[j - 1] && inBin >= binSize &&
+          numBins < maxBins))
+      {
+        dimMin[numBins++] = sorted[j];
+        inBin = 0;
+      }
+      dimMax[numBins - 1] = sorted[j];
+      ++inBin;
+    }
+
+    // The bin of a value is the first one whose largest value is not smaller.
+    for (size_t j = 0; j < count; ++j)
+    {
+      bins(d, begin + j) = (unsigned char) (std::lower_bound(dimMax,
+          dimMax + numBins, values[j]) - dimMax);
+    }
+  }
+}
+
+template<typename ElemType>
+template<bool UseWeights>
+void HistogramBins<ElemType>::Histograms(const arma::Row<size_t>& labels,
+                                         const size_t numClasses,
+                                         const arma::rowvec& weights,
+                                         const size_t begin,
+                                         const size_t count,
+                                         arma::cube& histograms) const
+{
+  // Each bin of each dimension is a column of numClasses + 1 counts.
+  const size_t rows = numClasses + 1;
+  const size_t sliceSize = rows * binMin.n_rows;
+  histograms.zeros(rows, binMin.n_rows, bins.n_rows);
+  double* counts = histograms.memptr();
+  for (size_t j = begin; j < begin + count; ++j)
+  {
+    const size_t label = labels[j];
+    const double weight = UseWeights ? weights[j] : 1.0;
+    const unsigned char* pointBins = bins.colptr(j);
+    for (size_t d = 0; d < bins.n_rows; ++d)
+    {
+      double* binCounts = counts + d * sliceSize + pointBins[d] * rows;
+      binCounts[label] += weight;
+      ++binCounts[numClasses];
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file methods/decision_tree/presorted_binary_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split, using the order of
+ * the points in each dimension computed once for the whole tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_PRESORTED_BINARY_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_PRESORTED_BINARY_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The PresortedBinaryNumericSplit finds the same splits as the
+ * BestBinaryNumericSplit, but it lets the DecisionTree sort each dimension of
+ * the dataset only once, before training.  The sorted order of the points is
+ * then partitioned between the children of each node along with the points
+ * (which keeps it sorted), so each node evaluates its splits in linear time
+ * instead of sorting its points in every dimension.
+ *
+ * This costs the memory of one index per point and per dimension during
+ * training, and partitioning every dimension at every node; it pays off most
+ * when many dimensions are evaluated at each node, and when the tree is deep.
+ * It is only used when all the dimensions are numeric; otherwise, it behaves
+ * exactly as the BestBinaryNumericSplit.
+ *
+ * @code
+ * DecisionTree<GiniGain, PresortedBinaryNumericSplit> tree(data, labels,
+ *     numClasses);
+ * RandomForest<GiniGain, MultipleRandomDimensionSelect,
+ *     PresortedBinaryNumericSplit> forest(data, labels, numClasses);
+ * @endcode
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class PresortedBinaryNumericSplit :
+    public BestBinaryNumericSplit<FitnessFunction>
+{
+  // Nothing to add: the DecisionTree calls SplitIfBetterSorted() with the
+  // presorted indices for splits of this type (see IsPresortedSplit).
+};
+
+/**
+ * IsPresortedSplit::value is true if the DecisionTree should presort the
+ * dataset for the given numeric split type, and call its
+ * SplitIfBetterSorted() method instead of SplitIfBetter().
+ *
+ * @tparam NumericSplitType The numeric split type.
+ */
+template<typename NumericSplitType>
+struct IsPresortedSplit
+{
+  static const bool value = false;
+};
+
+//! The PresortedBinaryNumericSplit uses presorted indices.
+template<typename FitnessFunction>
+struct IsPresortedSplit<PresortedBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -178,14 +178,13 @@ static void mlpackMain()
     if (IO::HasParam("training_set_estimates"))
     {
       // Compute density estimates for each point in the training set.
-      arma::rowvec trainingDensities(trainingData.n_cols);
+      arma::vec trainingDensities;
       Timer::Start("det_estimation_time");
-      for (size_t i = 0; i < trainingData.n_cols; ++i)
-        trainingDensities[i] = tree->ComputeValue(trainingData.unsafe_col(i));
+      tree->ComputeValue(trainingData, trainingDensities);
       Timer::Stop("det_estimation_time");
 
       IO::GetParam<arma::mat>("training_set_estimates") =
-          std::move(trainingDensities);
+          trainingDensities.t();
     }
   }
   else
@@ -202,14 +201,11 @@ static void mlpackMain()
     {
       // Compute test set densities.
       Timer::Start("det_test_set_estimation");
-      arma::rowvec testDensities(testData.n_cols);
-
-      for (size_t i = 0; i < testData.n_cols; ++i)
-        testDensities[i] = tree->ComputeValue(testData.unsafe_col(i));
-
+      arma::vec testDensities;
+      tree->ComputeValue(testData, testDensities);
       Timer::Stop("det_test_set_estimation");
 
-      IO::GetParam<arma::mat>("test_set_estimates") = std::move(testDensities);
+      IO::GetParam<arma::mat>("test_set_estimates") = testDensities.t();
     }
 
     // Print variable importance.
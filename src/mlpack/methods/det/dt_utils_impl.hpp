@@ -221,6 +221,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     cvDTree.Grow(train, cvOldFromNew, useVolumeReg, maxLeafSize,
         minLeafSize);
 
+    // The density estimates of the test points.
+    arma::vec testValues;
+
     // Sequentially prune with all the values of available alphas and adding
     // values for test values.  Don't enter this loop if there are less than two
     // trees in the pruned sequence.
@@ -230,12 +233,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
          i < ((prunedSequence.size() < 2) ? 0 : prunedSequence.size() - 2); ++i)
     {
       // Compute test values for this state of the tree.
-      double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; ++j)
-      {
-        arma::vec testPoint = test.unsafe_col(j);
-        cvVal += cvDTree.ComputeValue(testPoint);
-      }
+      cvDTree.ComputeValue(test, testValues);
+      const double cvVal = arma::accu(testValues);
 
       // Update the cv regularization constant.
       cvRegularizationConstants[i] += 2.0 * cvVal / (double) cvData.n_cols;
@@ -247,12 +246,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     }
 
     // Compute test values for this state of the tree.
-    double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
-    {
-      typename MatType::vec_type testPoint = test.unsafe_col(i);
-      cvVal += cvDTree.ComputeValue(testPoint);
-    }
+    cvDTree.ComputeValue(test, testValues);
+    const double cvVal = arma::accu(testValues);
 
     if (prunedSequence.size() > 2)
       cvRegularizationConstants[prunedSequence.size() - 2] += 2.0 * cvVal
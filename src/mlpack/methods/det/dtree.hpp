@@ -151,6 +151,11 @@ class DTree
    * Greedily expand the tree.  The points in the dataset will be reordered
    * during tree growth.
    *
+   * For dense data, each dimension is sorted once for the whole tree, so that
+   * the split search of each node scans its points in order instead of sorting
+   * them; this takes as much memory as the dataset.  When OpenMP is available,
+   * the dimensions and the children of large nodes are handled in parallel.
+   *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
    * @param useVolReg If true, volume regularization is used.
@@ -182,6 +187,17 @@ class DTree
    */
   double ComputeValue(const VecType& query) const;
 
+  /**
+   * Compute the density estimate of each of the given query points (the
+   * result is the same as calling ComputeValue() for each of them).  The
+   * points are sent down the tree together, and blocks of points are handled
+   * in parallel when OpenMP is available.
+   *
+   * @param queries Points to estimate density of.
+   * @param values Vector to store the density estimates in.
+   */
+  void ComputeValue(const MatType& queries, arma::vec& values) const;
+
   /**
    * Index the buckets for possible usage later; this results in every leaf in
    * the tree having a specific tag (accessible with BucketTag()).  This
@@ -335,23 +351,81 @@ class DTree
  private:
   // Utility methods.
 
+  //! Nodes with at least this many points search their dimensions and grow
+  //! their children in parallel, when OpenMP is available.
+  static const size_t ParallelThreshold = 4096;
+
   /**
-   * Find the dimension to split on.
+   * The points of a dense dataset sorted along each dimension, so that the
+   * split search does not have to sort the points of each node.  Each point
+   * is identified by a key, its column when the tree started growing; the
+   * rows start to end - 1 of sortedKeys.col(d) hold the keys of the points of
+   * a node in increasing order along dimension d.  keys[i] is the key of the
+   * point in column i, and columns[k] is the column of the point with key k.
+   */
+  struct PresortedPoints
+  {
+    arma::umat sortedKeys;
+    arma::Col<size_t> keys;
+    arma::Col<size_t> columns;
+  };
+
+  /**
+   * Grow the tree from this node; see Grow().
+   */
+  double GrowNode(MatType& data,
+                  arma::Col<size_t>& oldFromNew,
+                  const bool useVolReg,
+                  const size_t maxLeafSize,
+                  const size_t minLeafSize,
+                  PresortedPoints& presorted);
+
+  /**
+   * Sort the points of this node along each dimension (dense data).
+   */
+  void Presort(const MatType& data,
+               PresortedPoints& presorted,
+               const std::true_type /* dense */) const;
+
+  /**
+   * Sparse data is not presorted: the split search sorts the nonzero values
+   * of each node instead.
+   */
+  void Presort(const MatType& /* data */,
+               PresortedPoints& /* presorted */,
+               const std::false_type /* dense */) const { }
+
+  /**
+   * Find the dimension to split on.  If presorted points are given, the
+   * values of each dimension are taken in their order instead of being
+   * sorted.
    */
   bool FindSplit(const MatType& data,
                  size_t& splitDim,
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const PresortedPoints* presorted = NULL) const;
 
   /**
-   * Split the data, returning the number of points left of the split.
+   * Split the data, returning the number of points left of the split.  If
+   * presorted points are given, their keys and order are updated too.
    */
   size_t SplitData(MatType& data,
                    const size_t splitDim,
                    const ElemType splitValue,
-                   arma::Col<size_t>& oldFromNew) const;
+                   arma::Col<size_t>& oldFromNew,
+                   PresortedPoints* presorted = NULL) const;
+
+  /**
+   * Send the given query points down the subtree of this node and store their
+   * density estimates.
+   */
+  void ComputeValues(const MatType& queries,
+                     arma::uword* indices,
+                     const size_t count,
+                     arma::vec& values) const;
 
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
@@ -13,6 +13,7 @@
  */
 #include "dtree.hpp"
 #include <stack>
+#include <algorithm>
 #include <vector>
 
 using namespace mlpack;
@@ -147,6 +148,34 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+/**
+ * Extract the splits of a dimension from presorted points: the values are
+ * taken in the order of the given keys, so they do not have to be sorted.
+ */
+template<typename ElemType, typename MatType>
+void ExtractPresortedSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                            const MatType& data,
+                            size_t dim,
+                            const arma::uword* sortedKeys,
+                            const arma::Col<size_t>& columns,
+                            const size_t points,
+                            const size_t minLeafSize)
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+  std::vector<ElemType> dimVec(points);
+  for (size_t i = 0; i < points; ++i)
+    dimVec[i] = data(dim, columns[sortedKeys[i]]);
+
+  for (size_t i = minLeafSize - 1; i < dimVec.size() - minLeafSize; ++i)
+  {
+    // As in ExtractSplits(), split in the middle of two different values.
+    const ElemType split = (dimVec[i] + dimVec[i + 1]) / 2.0;
+
+    if (split != dimVec[i])
+      splitVec.push_back(SplitItem(split, i + 1));
+  }
+}
+
 } // namespace details
 
 template<typename MatType, typename TagType>
@@ -439,7 +468,8 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const PresortedPoints* presorted) const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -450,46 +480,44 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
 
   const size_t points = end - start;
 
-  double minError = logNegError;
-  bool splitFound = false;
+  // The best split of each dimension.
+  std::vector<char> dimSplitFound(maxVals.n_elem, false);
+  std::vector<double> dimError(maxVals.n_elem);
+  std::vector<double> dimLeftError(maxVals.n_elem);
+  std::vector<double> dimRightError(maxVals.n_elem);
+  std::vector<ElemType> dimSplitValue(maxVals.n_elem);
 
-  // Loop through each dimension.
-#ifdef _WIN32
-  #pragma omp parallel for default(shared)
-  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; ++dim)
-#else
-  #pragma omp parallel for default(shared)
-  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
-#endif
+  auto searchDimension = [&](const size_t dim)
   {
     const ElemType min = minVals[dim];
     const ElemType max = maxVals[dim];
 
     // If there is nothing to split in this dimension, move on.
     if (max - min == 0.0)
-      continue; // Skip to next dimension.
-
-    // Find the log volume of all the other dimensions.
-    const double volumeWithoutDim = logVolume - std::log(max - min);
+      return;
 
-    // Initializing all other stuff for this dimension.
-    bool dimSplitFound = false;
     // Take an error estimate for this dimension.
     double minDimError = std::pow(points, 2.0) / (max - min);
-    double dimLeftError = 0.0; // For -Wuninitialized.  These variables will
-    double dimRightError = 0.0; // always be set to something else before use.
-    ElemType dimSplitValue = 0.0;
 
     // Get the values for splitting. The old implementation:
     //   dimVec = data.row(dim).subvec(start, end - 1);
     //   dimVec = arma::sort(dimVec);
     // could be quite inefficient for sparse matrices, due to
     // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
-
+    // sparse matrices.  If the points are presorted, no sorting is needed at
+    // all.
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    if (presorted != NULL && !presorted->sortedKeys.is_empty())
+    {
+      details::ExtractPresortedSplits<ElemType>(splitVec, data, dim,
+          presorted->sortedKeys.colptr(dim) + start, presorted->columns, points,
+          minLeafSize);
+    }
+    else
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+          minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -520,30 +548,59 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
         if ((negLeftError + negRightError) >= minDimError)
         {
           minDimError = negLeftError + negRightError;
-          dimLeftError = negLeftError;
-          dimRightError = negRightError;
-          dimSplitValue = split;
-          dimSplitFound = true;
+          dimLeftError[dim] = negLeftError;
+          dimRightError[dim] = negRightError;
+          dimSplitValue[dim] = split;
+          dimSplitFound[dim] = true;
         }
       }
     }
 
-    const double actualMinDimError = std::log(minDimError)
+    dimError[dim] = std::log(minDimError);
+  };
+
+  // Loop through each dimension; the dimensions of large nodes are searched
+  // in parallel, as OpenMP tasks.
+  if (points >= ParallelThreshold && maxVals.n_elem > 1)
+  {
+    for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+    {
+      #pragma omp task shared(searchDimension) firstprivate(dim)
+      searchDimension(dim);
+    }
+    #pragma omp taskwait
+  }
+  else
+  {
+    for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+      searchDimension(dim);
+  }
+
+  // Keep the first dimension with the smallest error.
+  double minError = logNegError;
+  bool splitFound = false;
+  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+  {
+    if (!dimSplitFound[dim])
+      continue;
+
+    // Calculate actual error (in logspace) by adding terms back to our
+    // estimate.
+    const double volumeWithoutDim = logVolume -
+        std::log(maxVals[dim] - minVals[dim]);
+    const double actualMinDimError = dimError[dim]
       - 2 * std::log((double) data.n_cols)
       - volumeWithoutDim;
 
-#pragma omp critical(DTreeFindUpdate)
-    if ((actualMinDimError > minError) && dimSplitFound)
+    if (actualMinDimError > minError)
     {
-      // Calculate actual error (in logspace) by adding terms back to our
-      // estimate.
       minError = actualMinDimError;
       splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
+      splitValue = dimSplitValue[dim];
+      leftError = std::log(dimLeftError[dim]) - 2 * std::log((double)
+          data.n_cols) - volumeWithoutDim;
+      rightError = std::log(dimRightError[dim]) - 2 * std::log((double)
+          data.n_cols) - volumeWithoutDim;
       splitFound = true;
     } // end if better split found in this dimension.
   }
@@ -555,8 +612,12 @@ template<typename MatType, typename TagType>
 size_t DTree<MatType, TagType>::SplitData(MatType& data,
                                           const size_t splitDim,
                                           const ElemType splitValue,
-                                          arma::Col<size_t>& oldFromNew) const
+                                          arma::Col<size_t>& oldFromNew,
+                                          PresortedPoints* presorted) const
 {
+  const bool updatePresorted = (presorted != NULL) &&
+      !presorted->sortedKeys.is_empty();
+
   // Swap all columns such that any columns with value in dimension splitDim
   // less than or equal to splitValue are on the left side, and all others are
   // on the right side.  A similar sort to this is also performed in
@@ -579,12 +640,65 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
     const size_t tmp = oldFromNew[left];
     oldFromNew[left] = oldFromNew[right];
     oldFromNew[right] = tmp;
+
+    if (updatePresorted)
+    {
+      const size_t tmpKey = presorted->keys[left];
+      presorted->keys[left] = presorted->keys[right];
+      presorted->keys[right] = tmpKey;
+    }
+  }
+
+  if (updatePresorted)
+  {
+    // Find the new columns of the points, then distribute the sorted keys of
+    // each dimension between the two sides, keeping them in order.
+    for (size_t i = start; i < end; ++i)
+      presorted->columns[presorted->keys[i]] = i;
+
+    arma::Col<size_t> buffer(end - start);
+    for (size_t d = 0; d < presorted->sortedKeys.n_cols; ++d)
+    {
+      arma::uword* sortedKeys = presorted->sortedKeys.colptr(d) + start;
+      size_t nextLeft = 0;
+      size_t nextRight = left - start;
+      for (size_t i = 0; i < end - start; ++i)
+      {
+        if (presorted->columns[sortedKeys[i]] < left)
+          buffer[nextLeft++] = sortedKeys[i];
+        else
+          buffer[nextRight++] = sortedKeys[i];
+      }
+
+      std::copy(buffer.begin(), buffer.end(), sortedKeys);
+    }
   }
 
   // This now refers to the first index of the "right" side.
   return left;
 }
 
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::Presort(const MatType& data,
+                                      PresortedPoints& presorted,
+                                      const std::true_type /* dense */) const
+{
+  if (end <= start)
+    return;
+
+  presorted.keys.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    presorted.keys[i] = i;
+  presorted.columns = presorted.keys;
+
+  presorted.sortedKeys.set_size(data.n_cols, data.n_rows);
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    presorted.sortedKeys.col(d).subvec(start, end - 1) =
+        arma::sort_index(data(d, arma::span(start, end - 1))) + start;
+  }
+}
+
 // Greedily expand the tree.
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
@@ -592,6 +706,43 @@ double DTree<MatType, TagType>::Grow(MatType& data,
                                      const bool useVolReg,
                                      const size_t maxLeafSize,
                                      const size_t minLeafSize)
+{
+  // For dense data, sort each dimension once for the whole tree; the children
+  // get their part of the order when a node is split.
+  PresortedPoints presorted;
+  Presort(data, presorted, std::integral_constant<bool,
+      arma::is_Mat<MatType>::value>());
+
+  #ifdef HAS_OPENMP
+    // The dimensions and the children of large nodes are handled in parallel,
+    // as OpenMP tasks.  Open the parallel region that runs them, unless we are
+    // already in one (for instance, during cross-validation).
+    if ((end - start) >= ParallelThreshold && omp_get_max_threads() > 1 &&
+        omp_get_level() == 0)
+    {
+      double g = 0.0;
+      #pragma omp parallel
+      {
+        #pragma omp single
+        g = GrowNode(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+            presorted);
+      }
+      return g;
+    }
+  #endif
+
+  return GrowNode(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+      presorted);
+}
+
+// Greedily expand the tree from this node.
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::GrowNode(MatType& data,
+                                         arma::Col<size_t>& oldFromNew,
+                                         const bool useVolReg,
+                                         const size_t maxLeafSize,
+                                         const size_t minLeafSize,
+                                         PresortedPoints& presorted)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
@@ -614,11 +765,13 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        &presorted))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
-      const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew,
+          &presorted);
 
       // Make max and min vals for the children.
       StatType maxValsL(maxVals);
@@ -637,10 +790,15 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      // The children own disjoint columns of the data, so large ones can be
+      // grown in parallel.
+      #pragma omp task if (splitIndex - start >= ParallelThreshold) \
+          shared(data, oldFromNew, presorted, leftG)
+      leftG = left->GrowNode(data, oldFromNew, useVolReg, maxLeafSize,
+                             minLeafSize, presorted);
+      rightG = right->GrowNode(data, oldFromNew, useVolReg, maxLeafSize,
+                               minLeafSize, presorted);
+      #pragma omp taskwait
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
@@ -889,6 +1047,72 @@ double DTree<MatType, TagType>::ComputeValue(const VecType& query) const
   return 0.0;
 }
 
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::ComputeValue(const MatType& queries,
+                                           arma::vec& values) const
+{
+  Log::Assert(queries.n_rows == maxVals.n_elem);
+
+  values.zeros(queries.n_cols);
+
+  // Send blocks of query points down the tree together.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (queries.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t blockEnd = std::min(begin + blockSize,
+        (size_t) queries.n_cols);
+
+    // Points outside of the range of the root have a density of 0.
+    arma::uvec indices(blockEnd - begin);
+    size_t count = 0;
+    for (size_t i = begin; i < blockEnd; ++i)
+    {
+      bool withinRange = true;
+      for (size_t d = 0; d < queries.n_rows && withinRange && root; ++d)
+      {
+        const ElemType value = queries(d, i);
+        withinRange = (value >= minVals[d]) && (value <= maxVals[d]);
+      }
+
+      if (withinRange)
+        indices[count++] = i;
+    }
+
+    if (count > 0)
+      ComputeValues(queries, indices.memptr(), count, values);
+  }
+}
+
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::ComputeValues(const MatType& queries,
+                                            arma::uword* indices,
+                                            const size_t count,
+                                            arma::vec& values) const
+{
+  if (subtreeLeaves == 1)  // If we are a leaf...
+  {
+    const double value = std::exp(std::log(ratio) - logVolume);
+    for (size_t i = 0; i < count; ++i)
+      values[indices[i]] = value;
+    return;
+  }
+
+  // Send the points to the left or the right child, depending on the
+  // splitValue.
+  arma::uword* middle = std::partition(indices, indices + count,
+      [&](const arma::uword i) { return queries(splitDim, i) <= splitValue; });
+  const size_t leftCount = middle - indices;
+
+  if (leftCount > 0)
+    left->ComputeValues(queries, indices, leftCount, values);
+  if (leftCount < count)
+    right->ComputeValues(queries, middle, count - leftCount, values);
+}
+
 // Index the buckets for possible usage later.
 template<typename MatType, typename TagType>
 TagType DTree<MatType, TagType>::TagTree(const TagType& tag, bool every)
@@ -0,0 +1,109 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * Implements a union-find data structure that can be modified by several
+ * threads at once.  Like UnionFind, each point is initially in its own
+ * component; Union(x, y) unites the components of x and y, and Find(x)
+ * returns the index of the component containing x.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free Union-Find data structure, which allows Find() and Union() to be
+ * called concurrently from any number of threads.  A root is always linked
+ * under a root with a smaller index (with a compare-and-swap, retried if
+ * another thread changed the root first), and Find() shortens paths by
+ * halving.  So the index of a component is always the smallest index of the
+ * points in it, whatever the order in which the unions were done.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  //! Destroy the object (nothing to do).
+  ~ConcurrentUnionFind() { }
+
+  /**
+   * Returns the component containing an element.  If other threads are
+   * calling Union() at the same time, the component may be merged into
+   * another one before this returns.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    size_t p = parent[x].load(std::memory_order_relaxed);
+    while (p != x)
+    {
+      // Point x to its grandparent; if this fails, another thread has
+      // already shortened the path.
+      size_t grandparent = parent[p].load(std::memory_order_relaxed);
+      if (grandparent != p)
+        parent[x].compare_exchange_weak(p, grandparent,
+            std::memory_order_relaxed);
+
+      x = grandparent;
+      p = parent[x].load(std::memory_order_relaxed);
+    }
+
+    return x;
+  }
+
+  /**
+   * Union the components containing x and y.  Only calls that actually linked
+   * two separate components return true, so the (x, y) pairs of those calls
+   * never form a cycle, even when the calls are concurrent.
+   *
+   * @param x one component
+   * @param y the other component
+   * @return Whether this call joined two different components.
+   */
+  bool Union(const size_t x, const size_t y)
+  {
+    size_t xRoot = Find(x);
+    size_t yRoot = Find(y);
+    while (xRoot != yRoot)
+    {
+      // Link the larger root under the smaller one, if it is still a root.
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_strong(expected, yRoot,
+          std::memory_order_acq_rel))
+        return true;
+
+      xRoot = Find(xRoot);
+      yRoot = Find(yRoot);
+    }
+
+    return false;
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -99,6 +100,9 @@ class DualTreeBoruvka
   //! Indicates whether or not O(n^2) naive mode will be used.
   bool naive;
 
+  //! Indicates whether or not the Boruvka rounds are run in parallel.
+  bool parallel;
+
   //! Edges.
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
@@ -115,6 +119,10 @@ class DualTreeBoruvka
   //! Total distance of the tree.
   double totalDist;
 
+  //! The core distance of each point (in the order of the dataset of the
+  //! tree), or empty if the Euclidean MST is computed.
+  arma::vec coreDistances;
+
   //! The instantiated metric.
   MetricType metric;
 
@@ -175,7 +183,44 @@ class DualTreeBoruvka
    */
   void ComputeMST(arma::mat& results);
 
+  /**
+   * Compute the minimum spanning tree for the mutual reachability distance
+   * max(core(a), core(b), d(a, b)) used by HDBSCAN*, given the core distance of
+   * each point (typically the distance to its k-th nearest neighbor).  The
+   * core distances are folded into the pruning bounds of the dual-tree
+   * traversal, so this is as fast as ComputeMST().  The results have the same
+   * format as ComputeMST(), with mutual reachability distances in the third
+   * row.
+   *
+   * If the tree was built by this object, the core distances are given in the
+   * order of the original dataset; if a pre-built tree was passed, they must
+   * be given in the order of the dataset of that tree.
+   *
+   * @param results Matrix which results will be stored in.
+   * @param coreDistances Core distance of each point.
+   */
+  void ComputeMST(arma::mat& results, const arma::vec& coreDistances);
+
+  /**
+   * Get whether the Boruvka rounds are run in parallel (if OpenMP is
+   * available).  In each round, disjoint subtrees of the query tree (or blocks
+   * of points, in naive mode) are traversed by different threads, and the
+   * edges found are then added and contracted in parallel with a
+   * ConcurrentUnionFind.  Trees with self-children (like the cover tree) are
+   * always traversed serially.  The MST has the same total length either way,
+   * but if several edges have the same length a different set of them may be
+   * chosen.
+   */
+  bool Parallel() const { return parallel; }
+  //! Modify whether the Boruvka rounds are run in parallel.
+  bool& Parallel() { return parallel; }
+
  private:
+  /**
+   * Run the Boruvka rounds in parallel until the MST is complete.
+   */
+  void ParallelComputeMST();
+
   /**
    * Adds a single edge to the edge list
    */
@@ -194,13 +239,23 @@ class DualTreeBoruvka
   /**
    * This function resets the values in the nodes of the tree nearest neighbor
    * distance, and checks for fully connected nodes.
+   *
+   * @param tree Node to reset.
+   * @param components Component of each point.
    */
-  void CleanupHelper(Tree* tree);
+  void CleanupHelper(Tree* tree, const arma::Col<size_t>& components);
 
   /**
    * The values stored in the tree must be reset on each iteration.
    */
   void Cleanup();
+
+  /**
+   * Set the range of the core distances of the points of each node.
+   *
+   * @param node Node to set the statistics of.
+   */
+  void SetCoreDistances(Tree* node);
 }; // class DualTreeBoruvka
 
 } // namespace emst
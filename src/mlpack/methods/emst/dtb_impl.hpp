@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_EMST_DTB_IMPL_HPP
 
 #include "dtb_rules.hpp"
+#include "parallel_dtb_rules.hpp"
 
 namespace mlpack {
 namespace emst {
@@ -57,6 +58,7 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     data(naive ? dataset : tree->Dataset()),
     ownTree(!naive),
     naive(naive),
+    parallel(false),
     connections(dataset.n_cols),
     totalDist(0.0),
     metric(metric)
@@ -82,6 +84,7 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     data(tree->Dataset()),
     ownTree(false),
     naive(false),
+    parallel(false),
     connections(data.n_cols),
     totalDist(0.0),
     metric(metric)
@@ -119,13 +122,66 @@ template<
 void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     arma::mat& results)
 {
+  ComputeMST(results, arma::vec());
+}
+
+/**
+ * Find the minimum spanning tree for the mutual reachability distance given by
+ * the core distances (or for the metric, if no core distances are given).
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
+    arma::mat& results,
+    const arma::vec& coreDistances)
+{
+  if (coreDistances.n_elem > 0 && coreDistances.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DualTreeBoruvka::ComputeMST(): number of core distances ("
+        << coreDistances.n_elem << ") does not match number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The rules index the core distances like the dataset of the tree.
+  if (coreDistances.n_elem > 0 && !naive && ownTree &&
+      tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    this->coreDistances.set_size(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      this->coreDistances[i] = coreDistances[oldFromNew[i]];
+  }
+  else
+  {
+    this->coreDistances = coreDistances;
+  }
+
+  if (!naive)
+    SetCoreDistances(tree);
+
   Timer::Start("emst/mst_computation");
 
   totalDist = 0; // Reset distance.
 
+  if (parallel)
+  {
+    ParallelComputeMST();
+    Timer::Stop("emst/mst_computation");
+
+    EmitResults(results);
+
+    Log::Info << "Total spanning tree length: " << totalDist << std::endl;
+    return;
+  }
+
   typedef DTBRules<MetricType, Tree> RuleType;
   RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+                 neighborsOutComponent, metric, this->coreDistances);
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
@@ -276,7 +332,9 @@ template<
     template<typename TreeMetricType,
              typename TreeStatType,
              typename TreeMatType> class TreeType>
-void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
+void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(
+    Tree* tree,
+    const arma::Col<size_t>& components)
 {
   // Reset the statistic information.
   tree->Stat().MaxNeighborDistance() = DBL_MAX;
@@ -285,13 +343,13 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Recurse into all children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
-    CleanupHelper(&tree->Child(i));
+    CleanupHelper(&tree->Child(i), components);
 
   // Get the component of the first child or point.  Then we will check to see
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
       tree->Child(0).Stat().ComponentMembership() :
-      connections.Find(tree->Point(0));
+      components[tree->Point(0)];
 
   // Check components of children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
@@ -300,7 +358,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Check components of points.
   for (size_t i = 0; i < tree->NumPoints(); ++i)
-    if (connections.Find(tree->Point(i)) != size_t(component))
+    if (components[tree->Point(i)] != size_t(component))
       return;
 
   // If we made it this far, all components are the same.
@@ -322,7 +380,247 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
     neighborsDistances[i] = DBL_MAX;
 
   if (!naive)
-    CleanupHelper(tree);
+  {
+    // Find the component of each point once, instead of once per node.
+    arma::Col<size_t> components(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      components[i] = connections.Find(i);
+
+    CleanupHelper(tree, components);
+  }
+}
+
+/**
+ * Set the range of the core distances of the points of each node.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::SetCoreDistances(
+    Tree* node)
+{
+  // Without core distances, the bounds of the rules are unchanged.
+  if (coreDistances.n_elem == 0)
+  {
+    node->Stat().MinCoreDistance() = 0.0;
+    node->Stat().MaxCoreDistance() = 0.0;
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      SetCoreDistances(&node->Child(i));
+    return;
+  }
+
+  double minCore = DBL_MAX;
+  double maxCore = 0.0;
+  for (size_t i = 0; i < node->NumChildren(); ++i)
+  {
+    SetCoreDistances(&node->Child(i));
+    minCore = std::min(minCore, node->Child(i).Stat().MinCoreDistance());
+    maxCore = std::max(maxCore, node->Child(i).Stat().MaxCoreDistance());
+  }
+
+  for (size_t i = 0; i < node->NumPoints(); ++i)
+  {
+    minCore = std::min(minCore, coreDistances[node->Point(i)]);
+    maxCore = std::max(maxCore, coreDistances[node->Point(i)]);
+  }
+
+  // An empty node gives no bound.
+  node->Stat().MinCoreDistance() = (minCore == DBL_MAX) ? 0.0 : minCore;
+  node->Stat().MaxCoreDistance() = maxCore;
+}
+
+/**
+ * Run the Boruvka rounds in parallel until the MST is complete.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ParallelComputeMST()
+{
+  #ifdef HAS_OPENMP
+    const size_t threads = omp_get_max_threads();
+  #else
+    const size_t threads = 1;
+  #endif
+
+  const size_t n = data.n_cols;
+  ConcurrentUnionFind parallelConnections(n);
+  arma::Col<size_t> components(n);
+  for (size_t i = 0; i < n; ++i)
+    components[i] = i;
+
+  // The candidate edge of each point, the distance of the best candidate of
+  // each component, and the point with the best candidate of each component.
+  arma::vec pointDistances(n);
+  arma::Col<size_t> pointNeighbors(n);
+  std::vector<std::atomic<double>> componentBounds(n);
+  std::vector<std::atomic<size_t>> bestPoints(n);
+
+  typedef ParallelDTBRules<MetricType, Tree> RuleType;
+  RuleType rules(data, components, componentBounds, pointDistances,
+      pointNeighbors, metric, coreDistances);
+
+  // Split the tree into disjoint query subtrees, with several subtrees per
+  // thread so that dynamic scheduling can balance their different costs.
+  std::vector<Tree*> tasks;
+  if (!naive)
+  {
+    tasks.push_back(tree);
+    bool split = !tree::TreeTraits<Tree>::HasSelfChildren;
+    while (split && tasks.size() < 8 * threads)
+    {
+      split = false;
+      std::vector<Tree*> children;
+      for (size_t i = 0; i < tasks.size(); ++i)
+      {
+        if (tasks[i]->IsLeaf())
+        {
+          children.push_back(tasks[i]);
+          continue;
+        }
+
+        split = true;
+        for (size_t j = 0; j < tasks[i]->NumChildren(); ++j)
+          children.push_back(&tasks[i]->Child(j));
+      }
+      tasks.swap(children);
+    }
+  }
+
+  while (edges.size() < (n - 1))
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      pointDistances[i] = DBL_MAX;
+      componentBounds[i].store(DBL_MAX, std::memory_order_relaxed);
+      bestPoints[i].store(n, std::memory_order_relaxed);
+    }
+
+    // Find the candidate edges.  Each thread only writes the candidates of its
+    // own query points.
+    if (naive)
+    {
+      #pragma omp parallel
+      {
+        RuleType threadRules(rules);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+          for (size_t j = 0; j < n; ++j)
+            threadRules.BaseCase(i, j);
+      }
+    }
+    else if (tasks.size() == 1)
+    {
+      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+      traverser.Traverse(*tree, *tree);
+    }
+    else if (rules.Score(*tree, *tree) != DBL_MAX)
+    {
+      // The roots are scored first, like the serial traversal would.
+      const typename RuleType::TraversalInfoType traversalInfo =
+          rules.TraversalInfo();
+
+      #pragma omp parallel
+      {
+        RuleType threadRules(rules);
+        threadRules.BaseCases() = 0;
+        threadRules.Scores() = 0;
+
+        #pragma omp for schedule(dynamic)
+        for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+        {
+          threadRules.TraversalInfo() = traversalInfo;
+          if (threadRules.Score(*tasks[i], *tree) == DBL_MAX)
+            continue;
+
+          typename Tree::template DualTreeTraverser<RuleType>
+              traverser(threadRules);
+          traverser.Traverse(*tasks[i], *tree);
+        }
+
+        #pragma omp critical(DTBParallelComputeMSTCounts)
+        {
+          rules.BaseCases() += threadRules.BaseCases();
+          rules.Scores() += threadRules.Scores();
+        }
+      }
+    }
+
+    // The best candidate of a component is held by its points whose candidate
+    // is as close as the bound of the component; ties go to the lowest index.
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      const size_t component = components[i];
+      if (pointDistances[i] == DBL_MAX || pointDistances[i] !=
+          componentBounds[component].load(std::memory_order_relaxed))
+        continue;
+
+      std::atomic<size_t>& best = bestPoints[component];
+      size_t oldBest = best.load(std::memory_order_relaxed);
+      while ((size_t) i < oldBest &&
+          !best.compare_exchange_weak(oldBest, (size_t) i,
+          std::memory_order_relaxed))
+      { }
+    }
+
+    // Add the best candidate of each component and contract it.  An edge
+    // whose ends are already connected (through edges of the same length
+    // added by this round) is skipped.
+    #pragma omp parallel
+    {
+      std::vector<EdgePair> threadEdges;
+      double threadDist = 0.0;
+
+      #pragma omp for
+      for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+      {
+        const size_t inEdge = bestPoints[i].load(std::memory_order_relaxed);
+        if (inEdge == n)
+          continue;
+
+        const size_t outEdge = pointNeighbors[inEdge];
+        if (parallelConnections.Union(inEdge, outEdge))
+        {
+          Log::Assert((pointDistances[inEdge] >= 0.0),
+              "DualTreeBoruvka::AddEdge(): distance cannot be negative.");
+          threadEdges.push_back(EdgePair(std::min(inEdge, outEdge),
+              std::max(inEdge, outEdge), pointDistances[inEdge]));
+          threadDist += pointDistances[inEdge];
+        }
+      }
+
+      #pragma omp critical(DTBParallelComputeMSTEdges)
+      {
+        edges.insert(edges.end(), threadEdges.begin(), threadEdges.end());
+        totalDist += threadDist;
+      }
+    }
+
+    // Update the components, and reset the statistics of the tree.
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+      components[i] = parallelConnections.Find(i);
+
+    if (!naive)
+      CleanupHelper(tree, components);
+
+    Log::Info << edges.size() << " edges found so far." << std::endl;
+    if (!naive)
+    {
+      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
+      Log::Info << rules.Scores() << " cumulative node combinations scored."
+          << std::endl;
+    }
+  }
 }
 
 } // namespace emst
@@ -28,7 +28,8 @@ class DTBRules
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
-           MetricType& metric);
+           MetricType& metric,
+           const arma::vec& coreDistances);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -118,6 +119,11 @@ class DTBRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! The core distance of each point, if the spanning tree is computed for the
+  //! mutual reachability distance max(core(a), core(b), d(a, b)); empty
+  //! otherwise.
+  const arma::vec& coreDistances;
+
   /**
    * Update the bound for the given query node.
    */
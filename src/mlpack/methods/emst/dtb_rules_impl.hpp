@@ -22,7 +22,8 @@ DTBRules(const arma::mat& dataSet,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
-         MetricType& metric)
+         MetricType& metric,
+         const arma::vec& coreDistances)
 :
   dataSet(dataSet),
   connections(connections),
@@ -30,6 +31,7 @@ DTBRules(const arma::mat& dataSet,
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
   metric(metric),
+  coreDistances(coreDistances),
   baseCases(0),
   scores(0)
 {
@@ -56,6 +58,12 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
     ++baseCases;
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
+    if (coreDistances.n_elem > 0)
+    {
+      // Use the mutual reachability distance.
+      distance = std::max(distance, std::max(coreDistances[queryIndex],
+          coreDistances[referenceIndex]));
+    }
 
     if (distance < neighborsDistances[queryComponentIndex])
     {
@@ -89,7 +97,10 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
     return DBL_MAX;
 
   const arma::vec queryPoint = dataSet.unsafe_col(queryIndex);
-  const double distance = referenceNode.MinDistance(queryPoint);
+  double distance = std::max(referenceNode.MinDistance(queryPoint),
+      referenceNode.Stat().MinCoreDistance());
+  if (coreDistances.n_elem > 0)
+    distance = std::max(distance, coreDistances[queryIndex]);
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
@@ -120,7 +131,9 @@ double DTBRules<MetricType, TreeType>::Score(TreeType& queryNode,
     return DBL_MAX;
 
   ++scores;
-  const double distance = queryNode.MinDistance(referenceNode);
+  const double distance = std::max(queryNode.MinDistance(referenceNode),
+      std::max(queryNode.Stat().MinCoreDistance(),
+               referenceNode.Stat().MinCoreDistance()));
   const double bound = CalculateBound(queryNode);
 
   // If all the points in the reference node are farther than the candidate
@@ -177,8 +190,11 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   const double worstBound = std::max(worstPointBound, worstChildBound);
   const double bestBound = std::min(bestPointBound, bestChildBound);
   // We must check that bestBound != DBL_MAX; otherwise, we risk overflow.
+  // With core distances, the candidate of the best point is also within the
+  // core distance of each point of the node.
   const double bestAdjustedBound = (bestBound == DBL_MAX) ? DBL_MAX :
-      bestBound + 2 * queryNode.FurthestDescendantDistance();
+      std::max(bestBound + 2 * queryNode.FurthestDescendantDistance(),
+               queryNode.Stat().MaxCoreDistance());
 
   // Update the relevant quantities in the node.
   queryNode.Stat().MaxNeighborDistance() = worstBound;
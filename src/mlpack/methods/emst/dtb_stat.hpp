@@ -19,7 +19,9 @@ namespace emst {
 
 /**
  * A statistic for use with mlpack trees, which stores the upper bound on
- * distance to nearest neighbors and the component which this node belongs to.
+ * distance to nearest neighbors, the component which this node belongs to, and
+ * the range of the core distances of its points (for mutual reachability
+ * spanning trees).
  */
 class DTBStat
 {
@@ -41,6 +43,14 @@ class DTBStat
   //! negative.
   int componentMembership;
 
+  //! The smallest core distance of the points in this node (0 if the MST is
+  //! computed without core distances).
+  double minCoreDistance;
+
+  //! The largest core distance of the points in this node (0 if the MST is
+  //! computed without core distances).
+  double maxCoreDistance;
+
  public:
   /**
    * A generic initializer.  Sets the maximum neighbor distance to its default,
@@ -50,7 +60,9 @@ class DTBStat
       maxNeighborDistance(DBL_MAX),
       minNeighborDistance(DBL_MAX),
       bound(DBL_MAX),
-      componentMembership(-1) { }
+      componentMembership(-1),
+      minCoreDistance(0.0),
+      maxCoreDistance(0.0) { }
 
   /**
    * This is called when a node is finished initializing.  We set the maximum
@@ -66,7 +78,9 @@ class DTBStat
       bound(DBL_MAX),
       componentMembership(
           ((node.NumPoints() == 1) && (node.NumChildren() == 0)) ?
-            node.Point(0) : -1) { }
+            node.Point(0) : -1),
+      minCoreDistance(0.0),
+      maxCoreDistance(0.0) { }
 
   //! Get the maximum neighbor distance.
   double MaxNeighborDistance() const { return maxNeighborDistance; }
@@ -87,6 +101,16 @@ class DTBStat
   int ComponentMembership() const { return componentMembership; }
   //! Modify the component membership of this node.
   int& ComponentMembership() { return componentMembership; }
+
+  //! Get the smallest core distance of the points in this node.
+  double MinCoreDistance() const { return minCoreDistance; }
+  //! Modify the smallest core distance of the points in this node.
+  double& MinCoreDistance() { return minCoreDistance; }
+
+  //! Get the largest core distance of the points in this node.
+  double MaxCoreDistance() const { return maxCoreDistance; }
+  //! Modify the largest core distance of the points in this node.
+  double& MaxCoreDistance() { return maxCoreDistance; }
 }; // class DTBStat
 
 } // namespace emst
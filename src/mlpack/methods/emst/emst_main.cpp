@@ -29,6 +29,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include "dtb.hpp"
+#include "single_linkage.hpp"
 
 // Program Name.
 BINDING_NAME("Fast Euclidean Minimum Spanning Tree");
@@ -52,7 +53,17 @@ BINDING_LONG_DESC(
     "and if the " + PRINT_PARAM_STRING("naive") + " option is given, then "
     "brute-force search is used (this is typically much slower in low "
     "dimensions).  The leaf size does not affect the results, but it may have "
-    "some effect on the runtime of the algorithm.");
+    "some effect on the runtime of the algorithm.  If the " +
+    PRINT_PARAM_STRING("parallel") + " option is given, each round of the "
+    "algorithm is run in parallel (if OpenMP is available)."
+    "\n\n"
+    "The single-linkage hierarchical clustering of the input points, which "
+    "follows directly from the minimum spanning tree, may be saved with the " +
+    PRINT_PARAM_STRING("linkage") + " output parameter.  Each row describes "
+    "one merge, from the shortest edge of the tree to the longest: the indices "
+    "of the two merged clusters, their distance, and the number of points in "
+    "the new cluster.  The input points are the clusters 0 to N - 1, and the "
+    "i'th merge (counting from 0) creates the cluster N + i.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -80,7 +91,11 @@ BINDING_SEE_ALSO("mlpack::emst::DualTreeBoruvka class documentation",
 
 PARAM_MATRIX_IN_REQ("input", "Input data matrix.", "i");
 PARAM_MATRIX_OUT("output", "Output data.  Stored as an edge list.", "o");
+PARAM_MATRIX_OUT("linkage", "Single-linkage hierarchical clustering of the "
+    "input points.", "");
 PARAM_FLAG("naive", "Compute the MST using O(n^2) naive algorithm.", "n");
+PARAM_FLAG("parallel", "If set, each round of the algorithm is run in "
+    "parallel.", "P");
 PARAM_INT_IN("leaf_size", "Leaf size in the kd-tree.  One-element leaves give "
     "the empirically best performance, but at the cost of greater memory "
     "requirements.", "l", 1);
@@ -94,9 +109,11 @@ using namespace std;
 
 static void mlpackMain()
 {
-  RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
+  RequireAtLeastOnePassed({ "output", "linkage" }, false,
+      "no output will be saved");
 
   arma::mat dataPoints = std::move(IO::GetParam<arma::mat>("input"));
+  arma::mat mst;
 
   // Do naive computation if necessary.
   if (IO::GetParam<bool>("naive"))
@@ -104,12 +121,9 @@ static void mlpackMain()
     Log::Info << "Running naive algorithm." << endl;
 
     DualTreeBoruvka<> naive(dataPoints, true);
+    naive.Parallel() = IO::HasParam("parallel");
 
-    arma::mat naiveResults;
-    naive.ComputeMST(naiveResults);
-
-    if (IO::HasParam("output"))
-      IO::GetParam<arma::mat>("output") = std::move(naiveResults);
+    naive.ComputeMST(mst);
   }
   else
   {
@@ -131,6 +145,7 @@ static void mlpackMain()
     Timer::Stop("tree_building");
 
     DualTreeBoruvka<> dtb(&tree, metric);
+    dtb.Parallel() = IO::HasParam("parallel");
 
     // Run the DTB algorithm.
     Log::Info << "Calculating minimum spanning tree." << endl;
@@ -138,7 +153,7 @@ static void mlpackMain()
     dtb.ComputeMST(results);
 
     // Unmap the results.
-    arma::mat unmappedResults(results.n_rows, results.n_cols);
+    mst.set_size(results.n_rows, results.n_cols);
     for (size_t i = 0; i < results.n_cols; ++i)
     {
       const size_t indexA = oldFromNew[size_t(results(0, i))];
@@ -146,19 +161,26 @@ static void mlpackMain()
 
       if (indexA < indexB)
       {
-        unmappedResults(0, i) = indexA;
-        unmappedResults(1, i) = indexB;
+        mst(0, i) = indexA;
+        mst(1, i) = indexB;
       }
       else
       {
-        unmappedResults(0, i) = indexB;
-        unmappedResults(1, i) = indexA;
+        mst(0, i) = indexB;
+        mst(1, i) = indexA;
       }
 
-      unmappedResults(2, i) = results(2, i);
+      mst(2, i) = results(2, i);
     }
+  }
 
-    if (IO::HasParam("output"))
-      IO::GetParam<arma::mat>("output") = std::move(unmappedResults);
+  if (IO::HasParam("linkage"))
+  {
+    arma::mat linkage;
+    SingleLinkage(mst, linkage);
+    IO::GetParam<arma::mat>("linkage") = std::move(linkage);
   }
+
+  if (IO::HasParam("output"))
+    IO::GetParam<arma::mat>("output") = std::move(mst);
 }
@@ -0,0 +1,168 @@
+/**
+ * @file methods/emst/parallel_dtb_rules.hpp
+ *
+ * Tree traverser rules for the DualTreeBoruvka algorithm, for traversals of
+ * disjoint query subtrees that run at the same time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_PARALLEL_DTB_RULES_HPP
+#define MLPACK_METHODS_EMST_PARALLEL_DTB_RULES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/tree/traversal_info.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * The rules of one Boruvka round for DualTreeBoruvka, when several threads
+ * traverse disjoint query subtrees of the same tree.  Unlike DTBRules, the
+ * candidate edge is stored for each query point, so each thread only writes
+ * the candidates of its own query points.  The distance of the best candidate
+ * of each component, which is needed for pruning, is shared by all threads and
+ * only ever decreases (with an atomic update).  After the traversal, the best
+ * candidate of a component is the candidate of any of its points whose
+ * distance equals the bound of the component.
+ *
+ * The components of the points are fixed during a round, so they are given as
+ * a precomputed vector instead of a union-find structure.
+ */
+template<typename MetricType, typename TreeType>
+class ParallelDTBRules
+{
+ public:
+  /**
+   * Construct the rules.
+   *
+   * @param dataSet The data points.
+   * @param components Component of each point for this round.
+   * @param componentBounds Distance of the best candidate edge of each
+   *      component (shared by all threads).
+   * @param pointDistances Distance of the candidate edge of each point.
+   * @param pointNeighbors Other end of the candidate edge of each point.
+   * @param metric Instantiated metric.
+   */
+  ParallelDTBRules(const arma::mat& dataSet,
+                   const arma::Col<size_t>& components,
+                   std::vector<std::atomic<double>>& componentBounds,
+                   arma::vec& pointDistances,
+                   arma::Col<size_t>& pointNeighbors,
+                   MetricType& metric,
+                   const arma::vec& coreDistances);
+
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order, against the current pruning
+   * bound.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned).
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order, against the current pruning
+   * bound.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases performed.
+  size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases performed.
+  size_t& BaseCases() { return baseCases; }
+
+  //! Get the number of node combinations that have been scored.
+  size_t Scores() const { return scores; }
+  //! Modify the number of node combinations that have been scored.
+  size_t& Scores() { return scores; }
+
+ private:
+  //! The data points.
+  const arma::mat& dataSet;
+
+  //! The component of each point in this round.
+  const arma::Col<size_t>& components;
+
+  //! The distance to the best candidate edge of each component.
+  std::vector<std::atomic<double>>& componentBounds;
+
+  //! The distance to the candidate edge of each point.
+  arma::vec& pointDistances;
+
+  //! The other end of the candidate edge of each point.
+  arma::Col<size_t>& pointNeighbors;
+
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The core distance of each point, if the spanning tree is computed for the
+  //! mutual reachability distance max(core(a), core(b), d(a, b)); empty
+  //! otherwise.
+  const arma::vec& coreDistances;
+
+  //! Get the current bound of the given component.
+  double ComponentBound(const size_t component) const
+  {
+    return componentBounds[component].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Update and return the bound for pruning of the given query node.
+   */
+  inline double CalculateBound(TreeType& queryNode) const;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases calculated.
+  size_t baseCases;
+  //! The number of node combinations that have been scored.
+  size_t scores;
+}; // class ParallelDTBRules
+
+} // namespace emst
+} // namespace mlpack
+
+#include "parallel_dtb_rules_impl.hpp"
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file methods/emst/parallel_dtb_rules_impl.hpp
+ *
+ * Implementation of the tree traverser rules for parallel Boruvka rounds.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_PARALLEL_DTB_RULES_IMPL_HPP
+#define MLPACK_METHODS_EMST_PARALLEL_DTB_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dtb_rules.hpp"
+
+namespace mlpack {
+namespace emst {
+
+template<typename MetricType, typename TreeType>
+ParallelDTBRules<MetricType, TreeType>::
+ParallelDTBRules(const arma::mat& dataSet,
+                 const arma::Col<size_t>& components,
+                 std::vector<std::atomic<double>>& componentBounds,
+                 arma::vec& pointDistances,
+                 arma::Col<size_t>& pointNeighbors,
+                 MetricType& metric,
+                 const arma::vec& coreDistances) :
+    dataSet(dataSet),
+    components(components),
+    componentBounds(componentBounds),
+    pointDistances(pointDistances),
+    pointNeighbors(pointNeighbors),
+    metric(metric),
+    coreDistances(coreDistances),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing else to do.
+}
+
+template<typename MetricType, typename TreeType>
+inline force_inline
+double ParallelDTBRules<MetricType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  const size_t queryComponentIndex = components[queryIndex];
+
+  if (queryComponentIndex != components[referenceIndex])
+  {
+    ++baseCases;
+    double distance = metric.Evaluate(dataSet.col(queryIndex),
+                                      dataSet.col(referenceIndex));
+    if (coreDistances.n_elem > 0)
+    {
+      // Use the mutual reachability distance.
+      distance = std::max(distance, std::max(coreDistances[queryIndex],
+          coreDistances[referenceIndex]));
+    }
+
+    // Only this thread writes the candidate of the query point.
+    if (distance < pointDistances[queryIndex])
+    {
+      pointDistances[queryIndex] = distance;
+      pointNeighbors[queryIndex] = referenceIndex;
+
+      // Lower the bound of the component, unless another thread has already
+      // found a closer candidate.
+      std::atomic<double>& bound = componentBounds[queryComponentIndex];
+      double oldBound = bound.load(std::memory_order_relaxed);
+      while (distance < oldBound &&
+          !bound.compare_exchange_weak(oldBound, distance,
+          std::memory_order_relaxed)) { }
+    }
+  }
+
+  return ComponentBound(queryComponentIndex);
+}
+
+template<typename MetricType, typename TreeType>
+double ParallelDTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
+                                                     TreeType& referenceNode)
+{
+  const size_t queryComponentIndex = components[queryIndex];
+
+  // If the query belongs to the same component as all of the references,
+  // then prune.
+  if (queryComponentIndex ==
+      (size_t) referenceNode.Stat().ComponentMembership())
+    return DBL_MAX;
+
+  double distance = std::max(referenceNode.MinDistance(
+      dataSet.unsafe_col(queryIndex)), referenceNode.Stat().MinCoreDistance());
+  if (coreDistances.n_elem > 0)
+    distance = std::max(distance, coreDistances[queryIndex]);
+
+  // If all the points in the reference node are farther than the candidate
+  // nearest neighbor for the query's component, we prune.
+  return ComponentBound(queryComponentIndex) < distance ? DBL_MAX : distance;
+}
+
+template<typename MetricType, typename TreeType>
+double ParallelDTBRules<MetricType, TreeType>::Rescore(
+    const size_t queryIndex,
+    TreeType& /* referenceNode */,
+    const double oldScore)
+{
+  return (oldScore > ComponentBound(components[queryIndex])) ? DBL_MAX :
+      oldScore;
+}
+
+template<typename MetricType, typename TreeType>
+double ParallelDTBRules<MetricType, TreeType>::Score(TreeType& queryNode,
+                                                     TreeType& referenceNode)
+{
+  // If all the queries belong to the same component as all the references
+  // then we prune.
+  if ((queryNode.Stat().ComponentMembership() >= 0) &&
+      (queryNode.Stat().ComponentMembership() ==
+           referenceNode.Stat().ComponentMembership()))
+    return DBL_MAX;
+
+  ++scores;
+  const double distance = std::max(queryNode.MinDistance(referenceNode),
+      std::max(queryNode.Stat().MinCoreDistance(),
+               referenceNode.Stat().MinCoreDistance()));
+  const double bound = CalculateBound(queryNode);
+
+  // If all the points in the reference node are farther than the candidate
+  // nearest neighbor for all queries in the node, we prune.
+  return (bound < distance) ? DBL_MAX : distance;
+}
+
+template<typename MetricType, typename TreeType>
+double ParallelDTBRules<MetricType, TreeType>::Rescore(
+    TreeType& queryNode,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  const double bound = CalculateBound(queryNode);
+  return (oldScore > bound) ? DBL_MAX : oldScore;
+}
+
+// Calculate the bound for a given query node in its current state and update
+// it.  This is the same bound as DTBRules::CalculateBound(); the statistics of
+// the query node are only written by the thread that traverses it.
+template<typename MetricType, typename TreeType>
+inline double ParallelDTBRules<MetricType, TreeType>::CalculateBound(
+    TreeType& queryNode) const
+{
+  double worstPointBound = -DBL_MAX;
+  double bestPointBound = DBL_MAX;
+
+  double worstChildBound = -DBL_MAX;
+  double bestChildBound = DBL_MAX;
+
+  // Now, find the best and worst point bounds.
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    const double bound = ComponentBound(components[queryNode.Point(i)]);
+
+    if (bound > worstPointBound)
+      worstPointBound = bound;
+    if (bound < bestPointBound)
+      bestPointBound = bound;
+  }
+
+  // Find the best and worst child bounds.
+  for (size_t i = 0; i < queryNode.NumChildren(); ++i)
+  {
+    const double maxBound = queryNode.Child(i).Stat().MaxNeighborDistance();
+    if (maxBound > worstChildBound)
+      worstChildBound = maxBound;
+
+    const double minBound = queryNode.Child(i).Stat().MinNeighborDistance();
+    if (minBound < bestChildBound)
+      bestChildBound = minBound;
+  }
+
+  // Now calculate the actual bounds.
+  const double worstBound = std::max(worstPointBound, worstChildBound);
+  const double bestBound = std::min(bestPointBound, bestChildBound);
+  // We must check that bestBound != DBL_MAX; otherwise, we risk overflow.
+  const double bestAdjustedBound = (bestBound == DBL_MAX) ? DBL_MAX :
+      std::max(bestBound + 2 * queryNode.FurthestDescendantDistance(),
+               queryNode.Stat().MaxCoreDistance());
+
+  // Update the relevant quantities in the node.
+  queryNode.Stat().MaxNeighborDistance() = worstBound;
+  queryNode.Stat().MinNeighborDistance() = bestBound;
+  queryNode.Stat().Bound() = std::min(worstBound, bestAdjustedBound);
+
+  return queryNode.Stat().Bound();
+}
+
+} // namespace emst
+} // namespace mlpack
+
+#endif
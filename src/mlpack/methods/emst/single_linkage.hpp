@@ -0,0 +1,94 @@
+/**
+ * @file methods/emst/single_linkage.hpp
+ *
+ * Compute the single-linkage hierarchical clustering of a dataset from its
+ * minimum spanning tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_SINGLE_LINKAGE_HPP
+#define MLPACK_METHODS_EMST_SINGLE_LINKAGE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "union_find.hpp"
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * Compute the single-linkage hierarchical clustering (the dendrogram) of N
+ * points from their minimum spanning tree, as computed by
+ * DualTreeBoruvka::ComputeMST().  The clusters are merged in order of
+ * increasing edge length; the original points are the clusters 0 to N - 1,
+ * and the i'th merge creates the cluster N + i.  Each column of the result
+ * describes one merge, with the same layout as the linkage matrices of SciPy:
+ *
+ *  - the index of the first merged cluster (the lesser one),
+ *  - the index of the second merged cluster,
+ *  - the distance between the two clusters (the length of the MST edge),
+ *  - the number of points in the new cluster.
+ *
+ * @param mst 3 x (N - 1) matrix of MST edges (lesser index, greater index,
+ *      length); the edges do not need to be sorted.
+ * @param linkage 4 x (N - 1) matrix to store the merges in.
+ */
+inline void SingleLinkage(const arma::mat& mst, arma::mat& linkage)
+{
+  if (mst.n_rows != 3)
+  {
+    throw std::invalid_argument("SingleLinkage(): the spanning tree must have "
+        "3 rows (lesser index, greater index, distance)");
+  }
+
+  const size_t numPoints = mst.n_cols + 1;
+  const arma::uvec order = arma::stable_sort_index(mst.row(2));
+
+  // The cluster and size of each component, indexed by its root.
+  UnionFind components(numPoints);
+  arma::Col<size_t> clusters(numPoints);
+  arma::Col<size_t> sizes(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    clusters[i] = i;
+    sizes[i] = 1;
+  }
+
+  linkage.set_size(4, mst.n_cols);
+  for (size_t i = 0; i < mst.n_cols; ++i)
+  {
+    const size_t edge = order[i];
+    const size_t first = (size_t) mst(0, edge);
+    const size_t second = (size_t) mst(1, edge);
+    if (first >= numPoints || second >= numPoints)
+    {
+      throw std::invalid_argument("SingleLinkage(): the spanning tree has an "
+          "edge with an invalid point index");
+    }
+
+    const size_t firstRoot = components.Find(first);
+    const size_t secondRoot = components.Find(second);
+    if (firstRoot == secondRoot)
+    {
+      throw std::invalid_argument("SingleLinkage(): the given edges are not a "
+          "spanning tree");
+    }
+
+    linkage(0, i) = std::min(clusters[firstRoot], clusters[secondRoot]);
+    linkage(1, i) = std::max(clusters[firstRoot], clusters[secondRoot]);
+    linkage(2, i) = mst(2, edge);
+    linkage(3, i) = sizes[firstRoot] + sizes[secondRoot];
+
+    components.Union(firstRoot, secondRoot);
+    const size_t root = components.Find(firstRoot);
+    clusters[root] = numPoints + i;
+    sizes[root] = (size_t) linkage(3, i);
+  }
+}
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_SINGLE_LINKAGE_HPP
@@ -297,6 +297,17 @@ class FastMKS
   //! Modify whether or not brute-force (naive) search is used.
   bool& Naive() { return naive; }
 
+  /**
+   * Access whether naive and dual-tree searches are run in parallel.  Naive
+   * search is then run over blocks of query points, and dual-tree search over
+   * disjoint subtrees of the query tree, each thread with its own copy of the
+   * rules.  Single-tree search caches kernel evaluations in the statistics of
+   * the reference tree, so it is always serial.
+   */
+  bool ParallelQueries() const { return parallelQueries; }
+  //! Modify whether queries are searched in parallel.
+  bool& ParallelQueries() { return parallelQueries; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -316,6 +327,8 @@ class FastMKS
   bool singleMode;
   //! If true, naive (brute-force) search is used.
   bool naive;
+  //! If true, naive and dual-tree searches are run in parallel.
+  bool parallelQueries;
 
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
@@ -334,6 +347,35 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  /**
+   * Find the k maximum kernels of each point of the query set by brute force.
+   * The kernels are evaluated between blocks of query and reference points
+   * (with a matrix product, for kernels that only depend on the dot product).
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param sameSet If true, the query set is the reference set, and a point is
+   *     not returned as its own candidate.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool sameSet);
+
+  /**
+   * Run the dual-tree traversal of the given query tree with the given rules.
+   * If parallelQueries is true, the query tree is split into disjoint subtrees
+   * that are traversed in parallel, and the results are merged into the rules.
+   *
+   * @param queryTree Tree built on query points.
+   * @param rules Rules to run the traversal with (and store the results in).
+   */
+  template<typename RuleType>
+  void DualTreeSearch(Tree& queryTree, RuleType& rules);
 };
 
 } // namespace fastmks
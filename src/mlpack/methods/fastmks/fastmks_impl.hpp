@@ -16,6 +16,7 @@
 #include "fastmks.hpp"
 
 #include "fastmks_rules.hpp"
+#include "kernel_block.hpp"
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
@@ -35,7 +36,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const bool singleMode,
     treeOwner(true),
     setOwner(true),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    parallelQueries(false)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -58,7 +60,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(
     treeOwner(true),
     setOwner(false),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    parallelQueries(false)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -82,6 +85,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const MatType& referenceSet,
     setOwner(false),
     singleMode(singleMode),
     naive(naive),
+    parallelQueries(false),
     metric(kernel)
 {
   Timer::Start("tree_building");
@@ -108,7 +112,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(
     treeOwner(true),
     setOwner(naive),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    parallelQueries(false)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -135,6 +140,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(MatType&& referenceSet,
     setOwner(naive),
     singleMode(singleMode),
     naive(naive),
+    parallelQueries(false),
     metric(kernel)
 {
   Timer::Start("tree_building");
@@ -163,6 +169,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(Tree* referenceTree,
     setOwner(false),
     singleMode(singleMode),
     naive(false),
+    parallelQueries(false),
     metric(referenceTree->Metric())
 {
   // Nothing to do.
@@ -180,6 +187,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
+    parallelQueries(other.parallelQueries),
     metric(other.metric)
 {
   // Set reference set correctly.
@@ -201,6 +209,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
+    parallelQueries(other.parallelQueries),
     metric(std::move(other.metric))
 {
   // Clear information from the other.
@@ -210,6 +219,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
   other.setOwner = false;
   other.singleMode = false;
   other.naive = false;
+  other.parallelQueries = false;
 }
 
 template<typename KernelType,
@@ -248,6 +258,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  parallelQueries = other.parallelQueries;
 }
 
 template<typename KernelType,
@@ -426,33 +437,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, indices, kernels, false);
 
     Timer::Stop("computing_products");
 
@@ -533,9 +518,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   typedef FastMKSRules<KernelType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeSearch(*queryTree, rules);
 
   Log::Info << rules.BaseCases() << " base cases." << std::endl;
   Log::Info << rules.Scores() << " scores." << std::endl;
@@ -563,36 +546,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
 
     Timer::Stop("computing_products");
 
@@ -632,6 +586,164 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  // The kernels are evaluated between blocks of query points and chunks of
+  // reference points, so that the kernel values of a block fit in the cache
+  // and can be computed with a single matrix product when possible.
+  const size_t queryBlockSize = 64;
+  const size_t referenceChunkSize = 4096;
+  const size_t numBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  #pragma omp parallel for schedule(dynamic) if (parallelQueries)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t queryBegin = b * queryBlockSize;
+    const size_t queryCount = std::min(queryBlockSize,
+        (size_t) querySet.n_cols - queryBegin);
+
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<CandidateList> pqueues;
+    pqueues.reserve(queryCount);
+    for (size_t q = 0; q < queryCount; ++q)
+      pqueues.push_back(CandidateList(CandidateCmp(), std::vector<Candidate>(k,
+          def)));
+
+    arma::mat blockKernels;
+    for (size_t referenceBegin = 0; referenceBegin < referenceSet->n_cols;
+         referenceBegin += referenceChunkSize)
+    {
+      const size_t referenceCount = std::min(referenceChunkSize,
+          (size_t) referenceSet->n_cols - referenceBegin);
+      KernelBlock(metric.Kernel(), *referenceSet, referenceBegin,
+          referenceCount, querySet, queryBegin, queryCount, blockKernels);
+
+      for (size_t q = 0; q < queryCount; ++q)
+      {
+        CandidateList& pqueue = pqueues[q];
+        for (size_t r = 0; r < referenceCount; ++r)
+        {
+          // Don't return the point as its own candidate.
+          if (sameSet && (queryBegin + q == referenceBegin + r))
+            continue;
+
+          const double eval = blockKernels(r, q);
+          if (eval > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(eval, referenceBegin + r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
+        }
+      }
+    }
+
+    for (size_t q = 0; q < queryCount; ++q)
+    {
+      CandidateList& pqueue = pqueues[q];
+      for (size_t j = 1; j <= k; ++j)
+      {
+        indices(k - j, queryBegin + q) = pqueue.top().second;
+        kernels(k - j, queryBegin + q) = pqueue.top().first;
+        pqueue.pop();
+      }
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void FastMKS<KernelType, MatType, TreeType>::DualTreeSearch(Tree& queryTree,
+                                                            RuleType& rules)
+{
+  #ifdef HAS_OPENMP
+    const size_t threads = omp_get_max_threads();
+  #else
+    const size_t threads = 1;
+  #endif
+
+  // Split the query tree into disjoint subtrees, several per thread so that
+  // dynamic scheduling can balance their different costs.
+  std::vector<Tree*> tasks(1, &queryTree);
+  bool split = parallelQueries && (threads > 1);
+  while (split && tasks.size() < 8 * threads)
+  {
+    split = false;
+    std::vector<Tree*> children;
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+      if (tasks[i]->NumChildren() == 0)
+      {
+        children.push_back(tasks[i]);
+        continue;
+      }
+
+      // The split node is never scored, but the bounds of its children are
+      // computed from its bound, so it must be the loosest possible bound.
+      split = true;
+      tasks[i]->Stat().Bound() = -DBL_MAX;
+      for (size_t j = 0; j < tasks[i]->NumChildren(); ++j)
+        children.push_back(&tasks[i]->Child(j));
+    }
+    tasks.swap(children);
+  }
+
+  if (tasks.size() == 1)
+  {
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    return;
+  }
+
+  #pragma omp parallel
+  {
+    // The query subtrees are disjoint, so each thread only modifies the
+    // candidates and the query statistics of its own query points.  The
+    // reference tree is only read by dual-tree search.
+    RuleType threadRules(rules);
+    threadRules.BaseCases() = 0;
+    threadRules.Scores() = 0;
+    std::vector<Tree*> threadTasks;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+    {
+      // The parent-child prunes of the first node combination use the last
+      // visited nodes; pointing to the subtree itself and no reference node
+      // makes them impossible, as at the root.
+      threadRules.TraversalInfo().LastQueryNode() = tasks[i];
+      threadRules.TraversalInfo().LastReferenceNode() = NULL;
+
+      typename Tree::template DualTreeTraverser<RuleType> traverser(
+          threadRules);
+      traverser.Traverse(*tasks[i], *referenceTree);
+      threadTasks.push_back(tasks[i]);
+    }
+
+    #pragma omp critical(FastMKSDualTreeSearchMerge)
+    {
+      rules.Merge(threadRules, threadTasks);
+      rules.BaseCases() += threadRules.BaseCases();
+      rules.Scores() += threadRules.Scores();
+    }
+  }
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
@@ -101,6 +101,8 @@ PARAM_INT_IN("k", "Number of maximum kernels to find.", "k", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single", "If true, single-tree search is used (as opposed to "
     "dual-tree search.", "S");
+PARAM_FLAG("parallel_queries", "If true, naive and dual-tree searches are run "
+    "in parallel (if OpenMP is available).", "P");
 
 PARAM_MATRIX_OUT("kernels", "Output matrix of kernels.", "p");
 PARAM_UMATRIX_OUT("indices", "Output matrix of indices.", "i");
@@ -223,6 +225,9 @@ static void mlpackMain()
   model->Naive() = IO::HasParam("naive");
   model->SingleMode() = IO::HasParam("single");
 
+  // Searching in parallel is a property of this run, not of the model.
+  model->ParallelQueries() = IO::HasParam("parallel_queries");
+
   // Should we do search?
   if (IO::HasParam("k"))
   {
@@ -219,6 +219,52 @@ bool& FastMKSModel::SingleMode()
   throw std::runtime_error("invalid model type");
 }
 
+bool FastMKSModel::ParallelQueries() const
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->ParallelQueries();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->ParallelQueries();
+    case COSINE_DISTANCE:
+      return cosine->ParallelQueries();
+    case GAUSSIAN_KERNEL:
+      return gaussian->ParallelQueries();
+    case EPANECHNIKOV_KERNEL:
+      return epan->ParallelQueries();
+    case TRIANGULAR_KERNEL:
+      return triangular->ParallelQueries();
+    case HYPTAN_KERNEL:
+      return hyptan->ParallelQueries();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
+bool& FastMKSModel::ParallelQueries()
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->ParallelQueries();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->ParallelQueries();
+    case COSINE_DISTANCE:
+      return cosine->ParallelQueries();
+    case GAUSSIAN_KERNEL:
+      return gaussian->ParallelQueries();
+    case EPANECHNIKOV_KERNEL:
+      return epan->ParallelQueries();
+    case TRIANGULAR_KERNEL:
+      return triangular->ParallelQueries();
+    case HYPTAN_KERNEL:
+      return hyptan->ParallelQueries();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
 void FastMKSModel::Search(const arma::mat& querySet,
                           const size_t k,
                           arma::Mat<size_t>& indices,
@@ -86,6 +86,11 @@ class FastMKSModel
   //! Set whether or not single-tree search is used.
   bool& SingleMode();
 
+  //! Get whether or not naive and dual-tree searches are run in parallel.
+  bool ParallelQueries() const;
+  //! Set whether or not naive and dual-tree searches are run in parallel.
+  bool& ParallelQueries();
+
   //! Get the kernel type.
   int KernelType() const { return kernelType; }
   //! Modify the kernel type.
@@ -109,6 +109,18 @@ class FastMKSRules
                  TreeType& referenceNode,
                  const double oldScore) const;
 
+  /**
+   * Merge the candidates of the points of the given query subtrees from
+   * another rules object into this one.  This is used by parallel dual-tree
+   * search, where each thread traverses its query subtrees with a copy of the
+   * rules.
+   *
+   * @param other Rules object that was used to traverse the query subtrees.
+   * @param queryNodes Roots of the query subtrees traversed with other.
+   */
+  void Merge(const FastMKSRules& other,
+             const std::vector<TreeType*>& queryNodes);
+
   //! Get the number of times BaseCase() was called.
   size_t BaseCases() const { return baseCases; }
   //! Modify the number of times BaseCase() was called.
@@ -124,6 +124,21 @@ double FastMKSRules<KernelType, TreeType>::BaseCase(
   return kernelEval;
 }
 
+template<typename KernelType, typename TreeType>
+void FastMKSRules<KernelType, TreeType>::Merge(
+    const FastMKSRules& other,
+    const std::vector<TreeType*>& queryNodes)
+{
+  for (size_t i = 0; i < queryNodes.size(); ++i)
+  {
+    for (size_t j = 0; j < queryNodes[i]->NumDescendants(); ++j)
+    {
+      const size_t queryIndex = queryNodes[i]->Descendant(j);
+      candidates[queryIndex] = other.candidates[queryIndex];
+    }
+  }
+}
+
 template<typename KernelType, typename TreeType>
 double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
                                                  TreeType& referenceNode)
@@ -0,0 +1,112 @@
+/**
+ * @file methods/fastmks/kernel_block.hpp
+ *
+ * Evaluation of a kernel between a block of reference points and a block of
+ * query points, used by the naive FastMKS search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_KERNEL_BLOCK_HPP
+#define MLPACK_METHODS_FASTMKS_KERNEL_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+
+namespace mlpack {
+namespace fastmks {
+
+/**
+ * Evaluate the kernel between the given blocks of points one pair at a time.
+ * This is used for the kernels that do not only depend on the dot product and
+ * for the matrix types other than arma::mat (sparse matrices, for instance).
+ */
+template<typename KernelType, typename MatType>
+void KernelBlock(KernelType& kernel,
+                 const MatType& referenceSet,
+                 const size_t referenceBegin,
+                 const size_t referenceCount,
+                 const MatType& querySet,
+                 const size_t queryBegin,
+                 const size_t queryCount,
+                 arma::mat& output,
+                 const std::false_type /* useMatrixProduct */)
+{
+  output.set_size(referenceCount, queryCount);
+  for (size_t q = 0; q < queryCount; ++q)
+  {
+    for (size_t r = 0; r < referenceCount; ++r)
+    {
+      output(r, q) = kernel.Evaluate(querySet.col(queryBegin + q),
+          referenceSet.col(referenceBegin + r));
+    }
+  }
+}
+
+/**
+ * Evaluate a kernel that only depends on the dot product between the given
+ * blocks of dense points, with a single matrix product.
+ */
+template<typename KernelType, typename MatType>
+void KernelBlock(KernelType& kernel,
+                 const MatType& referenceSet,
+                 const size_t referenceBegin,
+                 const size_t referenceCount,
+                 const MatType& querySet,
+                 const size_t queryBegin,
+                 const size_t queryCount,
+                 arma::mat& output,
+                 const std::true_type /* useMatrixProduct */)
+{
+  // Alias the blocks, which are contiguous, instead of copying them.
+  const arma::mat referenceBlock(const_cast<double*>(
+      referenceSet.colptr(referenceBegin)), referenceSet.n_rows,
+      referenceCount, false, true);
+  const arma::mat queryBlock(const_cast<double*>(querySet.colptr(queryBegin)),
+      querySet.n_rows, queryCount, false, true);
+
+  kernel::KernelMatrix(kernel, referenceBlock, queryBlock, output);
+}
+
+/**
+ * Evaluate the kernel between the reference points referenceBegin to
+ * referenceBegin + referenceCount - 1 and the query points queryBegin to
+ * queryBegin + queryCount - 1, so that output(r, q) is the kernel value
+ * between the r'th reference point and the q'th query point of the blocks.
+ *
+ * For kernels that only depend on the dot product (KernelTraits::
+ * UsesDotProduct, like LinearKernel and PolynomialKernel) and dense matrices,
+ * the dot products are computed with a single matrix product; otherwise the
+ * kernel is evaluated for each pair of points.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param referenceSet Set of reference points.
+ * @param referenceBegin Index of the first reference point of the block.
+ * @param referenceCount Number of reference points in the block.
+ * @param querySet Set of query points.
+ * @param queryBegin Index of the first query point of the block.
+ * @param queryCount Number of query points in the block.
+ * @param output Matrix to store the kernel values in.
+ */
+template<typename KernelType, typename MatType>
+void KernelBlock(KernelType& kernel,
+                 const MatType& referenceSet,
+                 const size_t referenceBegin,
+                 const size_t referenceCount,
+                 const MatType& querySet,
+                 const size_t queryBegin,
+                 const size_t queryCount,
+                 arma::mat& output)
+{
+  KernelBlock(kernel, referenceSet, referenceBegin, referenceCount, querySet,
+      queryBegin, queryCount, output, std::integral_constant<bool,
+      kernel::KernelTraits<KernelType>::UsesDotProduct &&
+      std::is_same<MatType, arma::mat>::value>());
+}
+
+} // namespace fastmks
+} // namespace mlpack
+
+#endif
@@ -67,6 +67,28 @@ double DiagonalGMM::LogProbability(const arma::vec& observation) const
   return sum;
 }
 
+/**
+ * Return the log probability of each of the given observations being from
+ * this GMM.
+ */
+void DiagonalGMM::LogProbability(const arma::mat& observations,
+                                 arma::vec& logProbabilities) const
+{
+  // Evaluate each component on all the observations, then add the components
+  // in log-space.
+  arma::mat componentLogProbs(gaussians, observations.n_cols);
+  arma::vec logProbs;
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    dists[i].LogProbability(observations, logProbs);
+    componentLogProbs.row(i) = log(weights[i]) + logProbs.t();
+  }
+
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t j = 0; j < observations.n_cols; ++j)
+    logProbabilities[j] = math::AccuLog(componentLogProbs.unsafe_col(j));
+}
+
 /**
  * Return the probability of the given observation being from this GMM.
  */
@@ -130,7 +152,16 @@ arma::vec DiagonalGMM::Random() const
 void DiagonalGMM::Classify(const arma::mat& observations,
                            arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Compute the log-probabilities of all the observations for each component at
+  // once.  We have to use LogProbability() otherwise Probability() would
+  // overflow easily.
+  arma::mat logProbs(gaussians, observations.n_cols);
+  arma::vec componentLogProbs;
+  for (size_t j = 0; j < gaussians; ++j)
+  {
+    dists[j].LogProbability(observations, componentLogProbs);
+    logProbs.row(j) = log(weights[j]) + componentLogProbs.t();
+  }
 
   // We should not have to fill this with values, because each one should be
   // overwritten.
@@ -138,13 +169,12 @@ void DiagonalGMM::Classify(const arma::mat& observations,
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
     // Find maximum probability component.
-    double probability = 0;
+    double probability = -std::numeric_limits<double>::infinity();
     for (size_t j = 0; j < gaussians; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbs(j, i) >= probability)
       {
-        probability = newProb;
+        probability = logProbs(j, i);
         labels[i] = j;
       }
     }
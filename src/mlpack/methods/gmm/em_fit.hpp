@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/dists/gaussian_distribution.hpp>
 #include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
 
 // Default clustering mechanism.
 #include <mlpack/methods/kmeans/kmeans.hpp>
@@ -38,6 +39,14 @@ namespace gmm {
  *
  * This method should create 'clusters' clusters, and return the assignment of
  * each point to a cluster.
+ *
+ * The E-step and the M-step of each iteration are parallelized with OpenMP
+ * over blocks of points.  In addition, if a nonzero prune threshold is given,
+ * the E-step uses a kd-tree on the observations: for each node, every
+ * component whose responsibility is bounded above by the prune threshold
+ * times that of another component, for every point of the node, is skipped,
+ * and its responsibility is set to 0.  With many well-separated components,
+ * this avoids evaluating every component at every point.
  */
 template<typename InitialClusteringType = kmeans::KMeans<>,
          typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
@@ -60,11 +69,14 @@ class EMFit
    * @param tolerance Log-likelihood tolerance required for convergence.
    * @param clusterer Object which will perform the initial clustering.
    * @param constraint Constraint policy of covariance.
+   * @param pruneThreshold Relative responsibility below which a component is
+   *     skipped in the tree-based E-step (0 uses the exact E-step).
    */
   EMFit(const size_t maxIterations = 300,
         const double tolerance = 1e-10,
         InitialClusteringType clusterer = InitialClusteringType(),
-        CovarianceConstraintPolicy constraint = CovarianceConstraintPolicy());
+        CovarianceConstraintPolicy constraint = CovarianceConstraintPolicy(),
+        const double pruneThreshold = 0.0);
 
   /**
    * Fit the observations to a Gaussian mixture model (GMM) using the EM
@@ -127,11 +139,20 @@ class EMFit
   //! Modify the tolerance for the convergence of the EM algorithm.
   double& Tolerance() { return tolerance; }
 
+  //! Get the prune threshold of the tree-based E-step (0 if it is not used).
+  double PruneThreshold() const { return pruneThreshold; }
+  //! Modify the prune threshold of the tree-based E-step (0 if it is not used).
+  double& PruneThreshold() { return pruneThreshold; }
+
   //! Serialize the fitter.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! The type of tree used by the pruned E-step.
+  typedef tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic,
+      arma::mat> TreeType;
+
   /**
    * Run the clusterer, and then turn the cluster assignments into Gaussians.
    * This is a helper function for both overloads of Estimate().  The vectors
@@ -148,19 +169,86 @@ class EMFit
       arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Run the E-step: compute the conditional log-probability of each component
+   * given each observation, and return the log-likelihood of the model.  Yes,
+   * the log-likelihood is reimplemented in the GMM code.  Intuition suggests
+   * that the log-likelihood is not the best way to determine if the EM
+   * algorithm has converged.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param dists Distributions to store model in.
+   * If a tree is given, the components pruned at a node get a conditional
+   * probability of 0 for the points of that node, and do not contribute to
+   * the returned log-likelihood.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions of the model.
    * @param weights Vector of a priori weights.
+   * @param tree Tree built on the observations, or NULL for the exact E-step.
+   * @param oldFromNew Mappings from the points of the tree to the
+   *     observations.
+   * @param condLogProb Matrix to store the conditional log-probabilities in
+   *     (one row per observation, one column per component).
    */
-  double LogLikelihood(
-      const arma::mat& data,
+  double ConditionalLogProbabilities(
+      const arma::mat& observations,
       const std::vector<Distribution>& dists,
-      const arma::vec& weights) const;
+      const arma::vec& weights,
+      const TreeType* tree,
+      const std::vector<size_t>& oldFromNew,
+      arma::mat& condLogProb) const;
+
+  /**
+   * Compute the unnormalized weighted log-probabilities of the given
+   * components for the points of the given node, recursing into the children
+   * of the node while more components can be pruned.
+   *
+   * @param node Node holding the points.
+   * @param components Components that were not pruned at the parent.
+   * @param dists Distributions of the model.
+   * @param weights Vector of a priori weights.
+   * @param logScales Maximum weighted log-probability of each component.
+   * @param minEigenvalues Smallest eigenvalue of each covariance.
+   * @param maxEigenvalues Largest eigenvalue of each covariance.
+   * @param oldFromNew Mappings from the points of the tree to the
+   *     observations.
+   * @param condLogProb Matrix to store the log-probabilities in.
+   */
+  void PrunedLogProbabilities(const TreeType& node,
+                              const std::vector<size_t>& components,
+                              const std::vector<Distribution>& dists,
+                              const arma::vec& weights,
+                              const arma::vec& logScales,
+                              const arma::vec& minEigenvalues,
+                              const arma::vec& maxEigenvalues,
+                              const std::vector<size_t>& oldFromNew,
+                              arma::mat& condLogProb) const;
+
+  /**
+   * Run the M-step: update the means and covariances of the components from
+   * the given conditional log-probabilities, which may already include the
+   * log-probability of each observation being from the mixture.  condLogProb
+   * is overwritten with the normalized weight of each observation in each
+   * component.
+   *
+   * @param observations List of observations.
+   * @param condLogProb Conditional log-probabilities from the E-step.
+   * @param dists Distributions to update.
+   * @param probRowSums Vector to store the log of the total probability of
+   *     each component in.
+   */
+  void UpdateComponents(const arma::mat& observations,
+                        arma::mat& condLogProb,
+                        std::vector<Distribution>& dists,
+                        arma::vec& probRowSums);
+
+  //! Get the smallest and largest eigenvalues of a covariance matrix.
+  static void EigenvalueBounds(const arma::mat& covariance,
+                               double& minEigenvalue,
+                               double& maxEigenvalue);
+
+  //! Get the smallest and largest eigenvalues of a diagonal covariance.
+  static void EigenvalueBounds(const arma::vec& covariance,
+                               double& minEigenvalue,
+                               double& maxEigenvalue);
 
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
@@ -186,11 +274,34 @@ class EMFit
   InitialClusteringType clusterer;
   //! Object which applies constraints to the covariance matrix.
   CovarianceConstraintPolicy constraint;
+  //! Relative responsibility below which components are pruned (0 for none).
+  double pruneThreshold;
 };
 
 } // namespace gmm
 } // namespace mlpack
 
+//! Set the serialization version of the EMFit class.
+namespace boost {
+namespace serialization {
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+struct version<mlpack::gmm::EMFit<InitialClusteringType,
+                                  CovarianceConstraintPolicy,
+                                  Distribution>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+  BOOST_MPL_ASSERT((boost::mpl::less<boost::mpl::int_<1>,
+                    boost::mpl::int_<256>>));
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "em_fit_impl.hpp"
 
@@ -29,11 +29,13 @@ EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::EMFit(
     const size_t maxIterations,
     const double tolerance,
     InitialClusteringType clusterer,
-    CovarianceConstraintPolicy constraint) :
+    CovarianceConstraintPolicy constraint,
+    const double pruneThreshold) :
     maxIterations(maxIterations),
     tolerance(tolerance),
     clusterer(clusterer),
-    constraint(constraint)
+    constraint(constraint),
+    pruneThreshold(pruneThreshold)
 { /* Nothing to do. */ }
 
 template<typename InitialClusteringType,
@@ -71,13 +73,23 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // Build the tree for the pruned E-step, if it will be used.
+  std::vector<size_t> oldFromNew;
+  std::unique_ptr<TreeType> tree;
+  if (pruneThreshold > 0.0)
+    tree.reset(new TreeType(observations, oldFromNew));
+
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present theta value, along with the
+  // log-likelihood of the model.
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  double l = ConditionalLogProbabilities(observations, dists, weights,
+      tree.get(), oldFromNew, condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -86,73 +98,11 @@ Estimate(const arma::mat& observations,
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums(dists.size());
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
-    }
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * arma::exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    // Calculate the new value of the means and covariances using the updated
+    // conditional probabilities, and store the sum of the probability of each
+    // state over all the observations.
+    arma::vec probRowSums;
+    UpdateComponents(observations, condLogProb, dists, probRowSums);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -160,7 +110,8 @@ Estimate(const arma::mat& observations,
 
     // Update values of l; calculate new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ConditionalLogProbabilities(observations, dists, weights, tree.get(),
+        oldFromNew, condLogProb);
 
     iteration++;
   }
@@ -179,93 +130,32 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // Build the tree for the pruned E-step, if it will be used.
+  std::vector<size_t> oldFromNew;
+  std::unique_ptr<TreeType> tree;
+  if (pruneThreshold > 0.0)
+    tree.reset(new TreeType(observations, oldFromNew));
+
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  double l = ConditionalLogProbabilities(observations, dists, weights,
+      tree.get(), oldFromNew, condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
+  const arma::vec logProbabilities = arma::log(probabilities);
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    arma::vec logProbabilities = arma::log(probabilities);
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = mlpack::math::AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-      {
-        dists[i].Mean() = observations *
-              arma::exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
-      }
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec cov = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-    }
+    // Weight the conditional probability of each point being from each
+    // Gaussian by the probability of the point being from this mixture model,
+    // and calculate the new value of the means and covariances.
+    condLogProb.each_col() += logProbabilities;
+    arma::vec probRowSums;
+    UpdateComponents(observations, condLogProb, dists, probRowSums);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -273,7 +163,8 @@ Estimate(const arma::mat& observations,
 
     // Update values of l; calculate new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ConditionalLogProbabilities(observations, dists, weights, tree.get(),
+        oldFromNew, condLogProb);
 
     iteration++;
   }
@@ -377,47 +268,320 @@ template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
 double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
-LogLikelihood(const arma::mat& observations,
-              const std::vector<Distribution>& dists,
-              const arma::vec& weights) const
+ConditionalLogProbabilities(const arma::mat& observations,
+                            const std::vector<Distribution>& dists,
+                            const arma::vec& weights,
+                            const TreeType* tree,
+                            const std::vector<size_t>& oldFromNew,
+                            arma::mat& condLogProb) const
 {
-  double logLikelihood = 0;
+  if (tree == NULL)
+  {
+    // Store the weighted log-probabilities of every component, for blocks of
+    // points in parallel.  It has to be LogProbability() otherwise
+    // Probability() would overflow easily.
+    const size_t blockSize = 1024;
+    const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t count = std::min(blockSize,
+          (size_t) observations.n_cols - begin);
+      const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+          observations.n_rows, count, false, true);
+
+      arma::vec logProbabilities;
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        dists[i].LogProbability(block, logProbabilities);
+        condLogProb.col(i).subvec(begin, begin + count - 1) =
+            logProbabilities + log(weights[i]);
+      }
+    }
+  }
+  else
+  {
+    // The weighted log-probability of a component is at most its value at the
+    // mean; the eigenvalues of the covariance bound how fast it decreases.
+    arma::vec logScales(dists.size());
+    arma::vec minEigenvalues(dists.size());
+    arma::vec maxEigenvalues(dists.size());
+    std::vector<size_t> components(dists.size());
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      components[i] = i;
+      logScales[i] = log(weights[i]) +
+          dists[i].LogProbability(dists[i].Mean());
+      EigenvalueBounds(dists[i].Covariance(), minEigenvalues[i],
+          maxEigenvalues[i]);
+    }
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
+    // The pruned components keep a conditional probability of 0.
+    condLogProb.fill(-std::numeric_limits<double>::infinity());
+    #pragma omp parallel
+    {
+      #pragma omp single
+      PrunedLogProbabilities(*tree, components, dists, weights, logScales,
+          minEigenvalues, maxEigenvalues, oldFromNew, condLogProb);
+    }
+  }
 
-  // It has to be LogProbability() otherwise Probability() would overflow easily
-  for (size_t i = 0; i < dists.size(); ++i)
+  // Normalize row-wise, keeping the log-likelihood of each point.
+  arma::vec logLikelihoods(observations.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) observations.n_cols; ++j)
   {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
+    // Avoid dividing by zero; if the probability for everything is 0, we
+    // don't want to make it NaN.
+    logLikelihoods[j] = mlpack::math::AccuLog(condLogProb.row(j));
+    if (logLikelihoods[j] != -std::numeric_limits<double>::infinity())
+      condLogProb.row(j) -= logLikelihoods[j];
   }
+
   // Now sum over every point.
+  double logLikelihood = 0;
   for (size_t j = 0; j < observations.n_cols; ++j)
   {
-    if (mlpack::math::AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
+    if (logLikelihoods[j] == -std::numeric_limits<double>::infinity())
     {
       Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
           << "outlier." << std::endl;
     }
-    logLikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
+    logLikelihood += logLikelihoods[j];
   }
 
   return logLikelihood;
 }
 
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+PrunedLogProbabilities(const TreeType& node,
+                       const std::vector<size_t>& components,
+                       const std::vector<Distribution>& dists,
+                       const arma::vec& weights,
+                       const arma::vec& logScales,
+                       const arma::vec& minEigenvalues,
+                       const arma::vec& maxEigenvalues,
+                       const std::vector<size_t>& oldFromNew,
+                       arma::mat& condLogProb) const
+{
+  // Bound the weighted log-probability of each component over the node: the
+  // Mahalanobis distance of a point to the mean is between its squared
+  // distance to the mean divided by the largest and by the smallest eigenvalue
+  // of the covariance.
+  std::vector<double> upperBounds(components.size());
+  double bestLowerBound = -std::numeric_limits<double>::infinity();
+  for (size_t c = 0; c < components.size(); ++c)
+  {
+    const size_t i = components[c];
+    const double minDistance = node.Bound().MinDistance(dists[i].Mean());
+    const double maxDistance = node.Bound().MaxDistance(dists[i].Mean());
+    upperBounds[c] = logScales[i] -
+        0.5 * minDistance * minDistance / maxEigenvalues[i];
+    bestLowerBound = std::max(bestLowerBound, logScales[i] -
+        0.5 * maxDistance * maxDistance / minEigenvalues[i]);
+  }
+
+  // A component can be skipped if, at every point of the node, its
+  // responsibility is at most pruneThreshold times that of another component.
+  const double cutoff = bestLowerBound + std::log(pruneThreshold);
+  std::vector<size_t> kept;
+  for (size_t c = 0; c < components.size(); ++c)
+    if (upperBounds[c] >= cutoff)
+      kept.push_back(components[c]);
+
+  // Compute the remaining components exactly at the leaves, or once nothing
+  // else can be pruned.
+  if (node.NumChildren() == 0 || kept.size() == 1)
+  {
+    const arma::mat points(const_cast<double*>(
+        node.Dataset().colptr(node.Begin())), node.Dataset().n_rows,
+        node.Count(), false, true);
+
+    arma::vec logProbabilities;
+    for (size_t c = 0; c < kept.size(); ++c)
+    {
+      const size_t i = kept[c];
+      dists[i].LogProbability(points, logProbabilities);
+      for (size_t j = 0; j < node.Count(); ++j)
+      {
+        condLogProb(oldFromNew[node.Begin() + j], i) = logProbabilities[j] +
+            log(weights[i]);
+      }
+    }
+
+    return;
+  }
+
+  // The left child of a large node is handled by another thread, if one is
+  // free.
+  #pragma omp task shared(node, kept, dists, weights, logScales, \
+      minEigenvalues, maxEigenvalues, oldFromNew, condLogProb) \
+      if (node.Count() >= 4096)
+  PrunedLogProbabilities(node.Child(0), kept, dists, weights, logScales,
+      minEigenvalues, maxEigenvalues, oldFromNew, condLogProb);
+  PrunedLogProbabilities(node.Child(1), kept, dists, weights, logScales,
+      minEigenvalues, maxEigenvalues, oldFromNew, condLogProb);
+  #pragma omp taskwait
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+UpdateComponents(const arma::mat& observations,
+                 arma::mat& condLogProb,
+                 std::vector<Distribution>& dists,
+                 arma::vec& probRowSums)
+{
+  // Check if the type of Distribution is DiagonalGaussianDistribution.  If so,
+  // we only need the diagonal elements of the covariance.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+  typedef typename std::conditional<isDiagGaussDist, arma::vec,
+      arma::mat>::type CovType;
+
+  // Store the sum of the probability of each state over all the observations,
+  // and turn the conditional probabilities into the weight of each point in
+  // the update of each Gaussian.
+  probRowSums.set_size(dists.size());
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    probRowSums[i] = mlpack::math::AccuLog(condLogProb.col(i));
+    if (probRowSums[i] != -std::numeric_limits<double>::infinity())
+      condLogProb.col(i) = arma::exp(condLogProb.col(i) - probRowSums[i]);
+    else
+      condLogProb.col(i).zeros();
+  }
+
+  // Calculate the new value of the means over blocks of points, with one
+  // accumulator per thread.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  arma::mat means(observations.n_rows, dists.size(), arma::fill::zeros);
+  #pragma omp parallel
+  {
+    arma::mat localMeans(observations.n_rows, dists.size(), arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols) - 1;
+      localMeans += observations.cols(begin, end) *
+          condLogProb.rows(begin, end);
+    }
+
+    #pragma omp critical
+    means += localMeans;
+  }
+
+  // Calculate the new value of the covariances using the updated means.
+  std::vector<CovType> covs(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (isDiagGaussDist)
+      covs[i].zeros(observations.n_rows);
+    else
+      covs[i].zeros(observations.n_rows, observations.n_rows);
+  }
+
+  #pragma omp parallel
+  {
+    std::vector<CovType> localCovs(covs);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t count = std::min(blockSize,
+          (size_t) observations.n_cols - begin);
+      const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+          observations.n_rows, count, false, true);
+
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        // Skip the Gaussians with no weight in this block, for instance
+        // because they were pruned.
+        const arma::vec w = condLogProb.col(i).subvec(begin, begin + count - 1);
+        if (!arma::any(w))
+          continue;
+
+        const arma::mat diffs = block.each_col() - means.col(i);
+        if (isDiagGaussDist)
+          localCovs[i] += (diffs % diffs) * w;
+        else
+          localCovs[i] += (diffs.each_row() % trans(w)) * trans(diffs);
+      }
+    }
+
+    #pragma omp critical
+    for (size_t i = 0; i < dists.size(); ++i)
+      covs[i] += localCovs[i];
+  }
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] == -std::numeric_limits<double>::infinity())
+      continue;
+
+    dists[i].Mean() = means.col(i);
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covs[i]);
+    dists[i].Covariance(std::move(covs[i]));
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+EigenvalueBounds(const arma::mat& covariance,
+                 double& minEigenvalue,
+                 double& maxEigenvalue)
+{
+  // Clamp the eigenvalues so that the bounds never divide by zero.
+  const arma::vec eigenvalues = arma::eig_sym(covariance);
+  minEigenvalue = std::max(eigenvalues.min(), DBL_MIN);
+  maxEigenvalue = std::max(eigenvalues.max(), DBL_MIN);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+EigenvalueBounds(const arma::vec& covariance,
+                 double& minEigenvalue,
+                 double& maxEigenvalue)
+{
+  minEigenvalue = std::max(covariance.min(), DBL_MIN);
+  maxEigenvalue = std::max(covariance.max(), DBL_MIN);
+}
+
 template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
 template<typename Archive>
 void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
-serialize(Archive& ar, const unsigned int /* version */)
+serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(maxIterations);
   ar & BOOST_SERIALIZATION_NVP(tolerance);
   ar & BOOST_SERIALIZATION_NVP(clusterer);
   ar & BOOST_SERIALIZATION_NVP(constraint);
+
+  // Older versions did not have the pruned E-step.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(pruneThreshold);
+  else if (Archive::is_loading::value)
+    pruneThreshold = 0.0;
 }
 
 template<typename InitialClusteringType,
@@ -0,0 +1,171 @@
+/**
+ * @file methods/gmm/em_sufficient_statistics.hpp
+ *
+ * Sufficient statistics of a Gaussian mixture model for one EM iteration,
+ * which can be accumulated one chunk of data at a time and merged across
+ * shards.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_EM_SUFFICIENT_STATISTICS_HPP
+#define MLPACK_METHODS_GMM_EM_SUFFICIENT_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * The sufficient statistics needed by the M-step of the EM algorithm for a
+ * Gaussian mixture model: for each Gaussian, the total responsibility of the
+ * points, their weighted mean, and their weighted scatter around that mean
+ * (a full matrix, or only its diagonal for DiagonalGaussianDistribution).
+ * The statistics are kept centered on the weighted means, and merged with the
+ * pairwise update of Chan, Golub and LeVeque, so that they stay accurate when
+ * summed over many chunks.
+ *
+ * The statistics of separate shards of a dataset, computed with the same
+ * model, can be merged (and serialized to be sent between processes), and the
+ * merged statistics give the same M-step as the whole dataset:
+ *
+ * @code
+ * // On each shard.
+ * EMSufficientStatistics<> stats(dimensionality, gaussians);
+ * stats.Accumulate(shard, dists, weights);
+ *
+ * // Once all the statistics are collected.
+ * EMSufficientStatistics<> total(dimensionality, gaussians);
+ * for (size_t i = 0; i < shardStats.size(); ++i)
+ *   total.Merge(shardStats[i]);
+ * total.Update(dists, weights, constraint);
+ * @endcode
+ *
+ * @tparam Distribution Type of the Gaussians of the model.
+ */
+template<typename Distribution = distribution::GaussianDistribution>
+class EMSufficientStatistics
+{
+ public:
+  //! The type of the scatter of a Gaussian: a matrix, or only its diagonal.
+  typedef typename std::conditional<std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value, arma::vec,
+      arma::mat>::type CovType;
+
+  /**
+   * Create empty statistics for the given number of Gaussians of the given
+   * dimensionality.
+   *
+   * @param dimensionality Dimensionality of the data.
+   * @param gaussians Number of Gaussians of the model.
+   */
+  EMSufficientStatistics(const size_t dimensionality = 0,
+                         const size_t gaussians = 0);
+
+  /**
+   * Reset the statistics to be empty, for the given number of Gaussians of the
+   * given dimensionality.
+   *
+   * @param dimensionality Dimensionality of the data.
+   * @param gaussians Number of Gaussians of the model.
+   */
+  void Reset(const size_t dimensionality, const size_t gaussians);
+
+  /**
+   * Run the E-step of the given model on the given observations, and add them
+   * to the statistics according to the responsibility of each Gaussian.
+   *
+   * @param observations Chunk of observations.
+   * @param dists Gaussians of the model.
+   * @param weights A priori weights of the Gaussians.
+   * @return Log-likelihood of the observations under the model.
+   */
+  double Accumulate(const arma::mat& observations,
+                    const std::vector<Distribution>& dists,
+                    const arma::vec& weights);
+
+  /**
+   * Add the given observations to the statistics, with the given
+   * responsibility of each Gaussian for each observation.
+   *
+   * @param observations Chunk of observations.
+   * @param chunkResponsibilities Responsibility of each Gaussian (one column
+   *     per Gaussian) for each observation (one row per observation).
+   */
+  void Accumulate(const arma::mat& observations,
+                  const arma::mat& chunkResponsibilities);
+
+  /**
+   * Merge the given statistics, which were computed with the same model on
+   * other observations, into these statistics.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const EMSufficientStatistics& other);
+
+  /**
+   * Run the M-step: set the means, covariances and weights of the model from
+   * the statistics.  Gaussians with no responsibility are not changed.
+   *
+   * @param dists Gaussians to update.
+   * @param weights A priori weights to update.
+   * @param constraint Constraint to apply to each covariance.
+   */
+  template<typename CovarianceConstraintPolicy>
+  void Update(std::vector<Distribution>& dists,
+              arma::vec& weights,
+              CovarianceConstraintPolicy& constraint) const;
+
+  //! Get the number of observations accumulated so far.
+  size_t Points() const { return points; }
+  //! Get the total responsibility of each Gaussian.
+  const arma::vec& Responsibilities() const { return responsibilities; }
+  //! Get the weighted mean of the observations for each Gaussian.
+  const arma::mat& Means() const { return means; }
+  //! Get the weighted scatter around the mean for each Gaussian.
+  const std::vector<CovType>& Scatters() const { return scatters; }
+  //! Get the log-likelihood of the observations accumulated with a model.
+  double LogLikelihood() const { return logLikelihood; }
+
+  //! Serialize the statistics.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Merge the statistics of one Gaussian over a set of observations into the
+   * statistics of that Gaussian.
+   *
+   * @param i Index of the Gaussian.
+   * @param responsibility Total responsibility of the other observations.
+   * @param mean Weighted mean of the other observations.
+   * @param scatter Weighted scatter of the other observations.
+   */
+  void MergeGaussian(const size_t i,
+                     const double responsibility,
+                     const arma::vec& mean,
+                     const CovType& scatter);
+
+  //! The number of observations accumulated.
+  size_t points;
+  //! The total responsibility of each Gaussian.
+  arma::vec responsibilities;
+  //! The weighted mean of the observations for each Gaussian.
+  arma::mat means;
+  //! The weighted scatter around the mean for each Gaussian.
+  std::vector<CovType> scatters;
+  //! The log-likelihood of the observations accumulated with a model.
+  double logLikelihood;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "em_sufficient_statistics_impl.hpp"
+
+#endif
@@ -0,0 +1,217 @@
+/**
+ * @file methods/gmm/em_sufficient_statistics_impl.hpp
+ *
+ * Implementation of the sufficient statistics of the EM algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_EM_SUFFICIENT_STATISTICS_IMPL_HPP
+#define MLPACK_METHODS_GMM_EM_SUFFICIENT_STATISTICS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "em_sufficient_statistics.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+template<typename Distribution>
+EMSufficientStatistics<Distribution>::EMSufficientStatistics(
+    const size_t dimensionality,
+    const size_t gaussians)
+{
+  Reset(dimensionality, gaussians);
+}
+
+template<typename Distribution>
+void EMSufficientStatistics<Distribution>::Reset(const size_t dimensionality,
+                                                 const size_t gaussians)
+{
+  points = 0;
+  logLikelihood = 0.0;
+  responsibilities.zeros(gaussians);
+  means.zeros(dimensionality, gaussians);
+
+  scatters.resize(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    if (std::is_same<CovType, arma::vec>::value)
+      scatters[i].zeros(dimensionality);
+    else
+      scatters[i].zeros(dimensionality, dimensionality);
+  }
+}
+
+template<typename Distribution>
+double EMSufficientStatistics<Distribution>::Accumulate(
+    const arma::mat& observations,
+    const std::vector<Distribution>& dists,
+    const arma::vec& weights)
+{
+  // Calculate the conditional log-probabilities of choosing a particular
+  // Gaussian given each observation.
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
+    dists[i].LogProbability(observations, condLogProbAlias);
+    condLogProbAlias += log(weights[i]);
+  }
+
+  // Normalize row-wise, keeping the log-likelihood of each point.
+  arma::vec pointLogLikelihoods(observations.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) observations.n_cols; ++j)
+  {
+    // Avoid dividing by zero; if the probability for everything is 0, we
+    // don't want to make it NaN.
+    pointLogLikelihoods[j] = mlpack::math::AccuLog(condLogProb.row(j));
+    if (pointLogLikelihoods[j] != -std::numeric_limits<double>::infinity())
+      condLogProb.row(j) -= pointLogLikelihoods[j];
+  }
+
+  Accumulate(observations, arma::exp(condLogProb));
+
+  const double chunkLogLikelihood = arma::accu(pointLogLikelihoods);
+  logLikelihood += chunkLogLikelihood;
+  return chunkLogLikelihood;
+}
+
+template<typename Distribution>
+void EMSufficientStatistics<Distribution>::Accumulate(
+    const arma::mat& observations,
+    const arma::mat& chunkResponsibilities)
+{
+  if (observations.n_rows != means.n_rows ||
+      chunkResponsibilities.n_rows != observations.n_cols ||
+      chunkResponsibilities.n_cols != means.n_cols)
+  {
+    Log::Fatal << "EMSufficientStatistics::Accumulate(): expected "
+        << means.n_rows << "-dimensional observations with responsibilities "
+        << "for " << means.n_cols << " Gaussians!" << std::endl;
+  }
+
+  // Compute the statistics of the chunk around its own weighted means, and
+  // merge them into the current statistics.
+  const arma::vec totals = trans(arma::sum(chunkResponsibilities, 0));
+  const arma::mat sums = observations * chunkResponsibilities;
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) means.n_cols; ++i)
+  {
+    if (totals[i] == 0.0)
+      continue;
+
+    const arma::vec mean = sums.col(i) / totals[i];
+    const arma::mat diffs = observations.each_col() - mean;
+    CovType scatter;
+    if (std::is_same<CovType, arma::vec>::value)
+    {
+      scatter = (diffs % diffs) * chunkResponsibilities.col(i);
+    }
+    else
+    {
+      scatter = (diffs.each_row() % trans(chunkResponsibilities.col(i))) *
+          trans(diffs);
+    }
+
+    MergeGaussian(i, totals[i], mean, scatter);
+  }
+
+  points += observations.n_cols;
+}
+
+template<typename Distribution>
+void EMSufficientStatistics<Distribution>::Merge(
+    const EMSufficientStatistics& other)
+{
+  if (other.means.n_rows != means.n_rows ||
+      other.means.n_cols != means.n_cols)
+  {
+    Log::Fatal << "EMSufficientStatistics::Merge(): cannot merge statistics "
+        << "of " << other.means.n_cols << " " << other.means.n_rows
+        << "-dimensional Gaussians into statistics of " << means.n_cols << " "
+        << means.n_rows << "-dimensional Gaussians!" << std::endl;
+  }
+
+  for (size_t i = 0; i < means.n_cols; ++i)
+  {
+    MergeGaussian(i, other.responsibilities[i], other.means.col(i),
+        other.scatters[i]);
+  }
+
+  points += other.points;
+  logLikelihood += other.logLikelihood;
+}
+
+template<typename Distribution>
+template<typename CovarianceConstraintPolicy>
+void EMSufficientStatistics<Distribution>::Update(
+    std::vector<Distribution>& dists,
+    arma::vec& weights,
+    CovarianceConstraintPolicy& constraint) const
+{
+  if (points == 0)
+    return;
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (responsibilities[i] == 0.0)
+      continue;
+
+    dists[i].Mean() = means.col(i);
+
+    // Apply covariance constraint.
+    CovType covariance = scatters[i] / responsibilities[i];
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = responsibilities / points;
+}
+
+template<typename Distribution>
+void EMSufficientStatistics<Distribution>::MergeGaussian(
+    const size_t i,
+    const double responsibility,
+    const arma::vec& mean,
+    const CovType& scatter)
+{
+  if (responsibility == 0.0)
+    return;
+
+  // The scatter of the union is the sum of the scatters, plus a term for the
+  // distance between the two means.
+  const double total = responsibilities[i] + responsibility;
+  const arma::vec delta = mean - means.col(i);
+  const double factor = responsibilities[i] * responsibility / total;
+  if (std::is_same<CovType, arma::vec>::value)
+    scatters[i] += scatter + factor * (delta % delta);
+  else
+    scatters[i] += scatter + factor * (delta * trans(delta));
+
+  means.col(i) += (responsibility / total) * delta;
+  responsibilities[i] = total;
+}
+
+template<typename Distribution>
+template<typename Archive>
+void EMSufficientStatistics<Distribution>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(points);
+  ar & BOOST_SERIALIZATION_NVP(responsibilities);
+  ar & BOOST_SERIALIZATION_NVP(means);
+  ar & BOOST_SERIALIZATION_NVP(scatters);
+  ar & BOOST_SERIALIZATION_NVP(logLikelihood);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
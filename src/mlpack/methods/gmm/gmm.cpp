@@ -66,6 +66,28 @@ double GMM::LogProbability(const arma::vec& observation) const
   return sum;
 }
 
+/**
+ * Return the log probability of each of the given observations being from
+ * this GMM.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  // Evaluate each component on all the observations, then add the components
+  // in log-space.
+  arma::mat componentLogProbs(gaussians, observations.n_cols);
+  arma::vec logProbs;
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    dists[i].LogProbability(observations, logProbs);
+    componentLogProbs.row(i) = log(weights[i]) + logProbs.t();
+  }
+
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t j = 0; j < observations.n_cols; ++j)
+    logProbabilities[j] = math::AccuLog(componentLogProbs.unsafe_col(j));
+}
+
 /**
  * Return the probability of the given observation being from this GMM.
  */
@@ -133,7 +155,16 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Compute the log-probabilities of all the observations for each component at
+  // once.  We have to use LogProbability() otherwise Probability() would
+  // overflow easily.
+  arma::mat logProbs(gaussians, observations.n_cols);
+  arma::vec componentLogProbs;
+  for (size_t j = 0; j < gaussians; ++j)
+  {
+    dists[j].LogProbability(observations, componentLogProbs);
+    logProbs.row(j) = log(weights[j]) + componentLogProbs.t();
+  }
 
   // We should not have to fill this with values, because each one should be
   // overwritten.
@@ -144,12 +175,9 @@ void GMM::Classify(const arma::mat& observations,
     double probability = -std::numeric_limits<double>::infinity();
     for (size_t j = 0; j < gaussians; ++j)
     {
-      // We have to use LogProbability() otherwise Probability() would overflow
-      // easily.
-      double newProb = LogProbability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbs(j, i) >= probability)
       {
-        probability = newProb;
+        probability = logProbs(j, i);
         labels[i] = j;
       }
     }
@@ -172,6 +172,16 @@ class GMM
    */
   double LogProbability(const arma::vec& observation) const;
 
+  /**
+   * Compute the log probability of each of the given observations; the
+   * components are evaluated on all the observations at once.
+   *
+   * @param observations Observations to evaluate the probability of.
+   * @param logProbabilities Vector to store the log probabilities in.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
   /**
    * Return the probability that the given observation came from the given
    * Gaussian component in this distribution.
@@ -82,7 +82,14 @@ BINDING_LONG_DESC(
     "will avoid the checks after each iteration of the EM algorithm which "
     "ensure that the covariance matrices are positive definite.  Specifying "
     "the flag can cause faster runtime, but may also cause non-positive "
-    "definite covariance matrices, which will cause the program to crash.");
+    "definite covariance matrices, which will cause the program to crash."
+    "\n\n"
+    "For models with many Gaussians, the " +
+    PRINT_PARAM_STRING("prune_threshold") + " parameter can be set to a small "
+    "value (such as 1e-8) so that each E-step uses a kd-tree to skip the "
+    "Gaussians that are negligible for a whole region of the data.  Those "
+    "Gaussians are then given a responsibility of 0, so the result is an "
+    "approximation.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -124,6 +131,10 @@ PARAM_INT_IN("max_iterations", "Maximum number of iterations of EM algorithm "
     "(passing 0 will run until convergence).", "n", 250);
 PARAM_FLAG("diagonal_covariance", "Force the covariance of the Gaussians to "
     "be diagonal.  This can accelerate training time significantly.", "d");
+PARAM_DOUBLE_IN("prune_threshold", "If nonzero, use a kd-tree in each E-step "
+    "and skip the Gaussians whose responsibility for all points of a node is "
+    "below this fraction of that of another Gaussian (should be between 0.0 "
+    "and 1.0).", "", 0.0);
 
 // Parameters for dataset modification.
 PARAM_DOUBLE_IN("noise", "Variance of zero-mean Gaussian noise to add to data.",
@@ -161,6 +172,7 @@ static void mlpackMain()
       "trials must be greater than 0");
 
   ReportIgnoredParam({{ "diagonal_covariance", true }}, "no_force_positive");
+  ReportIgnoredParam({{ "diagonal_covariance", true }}, "prune_threshold");
   RequireAtLeastOnePassed({ "output_model" }, false, "no model will be saved");
 
   RequireParamValue<double>("noise", [](double x) { return x >= 0.0; }, true,
@@ -170,6 +182,9 @@ static void mlpackMain()
       "max_iterations must be greater than or equal to 0");
   RequireParamValue<int>("kmeans_max_iterations", [](int x) { return x >= 0; },
       true, "kmeans_max_iterations must be greater than or equal to 0");
+  RequireParamValue<double>("prune_threshold",
+      [](double x) { return x >= 0.0 && x < 1.0; }, true,
+      "prune_threshold must be at least 0.0 and less than 1.0");
 
   arma::mat dataPoints = std::move(IO::GetParam<arma::mat>("input"));
 
@@ -205,6 +220,7 @@ static void mlpackMain()
   const bool diagonalCovariance = IO::HasParam("diagonal_covariance");
   const size_t kmeansMaxIterations =
       (size_t) IO::GetParam<int>("kmeans_max_iterations");
+  const double pruneThreshold = IO::GetParam<double>("prune_threshold");
 
   // This gets a bit weird because we need different types depending on whether
   // --refined_start is specified.
@@ -267,7 +283,8 @@ static void mlpackMain()
     {
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
-      EMFit<KMeansType> em(maxIterations, tolerance, k);
+      EMFit<KMeansType> em(maxIterations, tolerance, k,
+          PositiveDefiniteConstraint(), pruneThreshold);
       likelihood = gmm->Train(dataPoints, IO::GetParam<int>("trials"), false,
           em);
       Timer::Stop("em");
@@ -276,7 +293,8 @@ static void mlpackMain()
     {
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
-      EMFit<KMeansType, NoConstraint> em(maxIterations, tolerance, k);
+      EMFit<KMeansType, NoConstraint> em(maxIterations, tolerance, k,
+          NoConstraint(), pruneThreshold);
       likelihood = gmm->Train(dataPoints, IO::GetParam<int>("trials"), false,
           em);
       Timer::Stop("em");
@@ -325,7 +343,8 @@ static void mlpackMain()
     {
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
-      EMFit<> em(maxIterations, tolerance, KMeans<>(kmeansMaxIterations));
+      EMFit<> em(maxIterations, tolerance, KMeans<>(kmeansMaxIterations),
+          PositiveDefiniteConstraint(), pruneThreshold);
       likelihood = gmm->Train(dataPoints, IO::GetParam<int>("trials"), false,
           em);
       Timer::Stop("em");
@@ -335,7 +354,8 @@ static void mlpackMain()
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
       KMeans<> k(kmeansMaxIterations);
-      EMFit<KMeans<>, NoConstraint> em(maxIterations, tolerance, k);
+      EMFit<KMeans<>, NoConstraint> em(maxIterations, tolerance, k,
+          NoConstraint(), pruneThreshold);
       likelihood = gmm->Train(dataPoints, IO::GetParam<int>("trials"), false,
           em);
       Timer::Stop("em");
@@ -0,0 +1,173 @@
+/**
+ * @file methods/gmm/streaming_em_fit.hpp
+ *
+ * Utility class to fit a GMM with the EM algorithm on data that is read one
+ * chunk at a time, so that the whole dataset never has to be in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_STREAMING_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_STREAMING_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+
+// Default clustering mechanism.
+#include <mlpack/methods/kmeans/kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+#include "em_sufficient_statistics.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the EM algorithm, like EMFit, but
+ * reads the observations one chunk at a time.  Each iteration makes one pass
+ * over the chunks, keeping only the sufficient statistics of each Gaussian
+ * (see EMSufficientStatistics), so memory use depends on the size of a chunk
+ * and not of the dataset.
+ *
+ * The chunks are given by a function (or functor) with the signature
+ *
+ *  - bool operator()(const size_t chunk, arma::mat& observations);
+ *
+ * which loads the given chunk into the matrix and returns true, or returns
+ * false if there is no such chunk.  It is called with chunk = 0, 1, 2, ... on
+ * each pass, so it must give the same chunks every time.  For example, to use
+ * a set of files:
+ *
+ * @code
+ * auto chunks = [&files](const size_t chunk, arma::mat& observations)
+ * {
+ *   if (chunk >= files.size())
+ *     return false;
+ *   data::Load(files[chunk], observations, true);
+ *   return true;
+ * };
+ *
+ * StreamingEMFit<> fitter;
+ * fitter.Estimate(chunks, dists, weights);
+ * @endcode
+ *
+ * If the initial model is not given, the initial clustering is done on the
+ * first chunk only.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class StreamingEMFit
+{
+ public:
+  /**
+   * Construct the StreamingEMFit object, optionally passing an
+   * InitialClusteringType object (just in case it needs to store state).
+   * Setting the maximum number of iterations to 0 means that the EM algorithm
+   * will iterate until convergence (with the given tolerance).
+   *
+   * @param maxIterations Maximum number of iterations for EM.
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  StreamingEMFit(const size_t maxIterations = 300,
+                 const double tolerance = 1e-10,
+                 InitialClusteringType clusterer = InitialClusteringType(),
+                 CovarianceConstraintPolicy constraint =
+                     CovarianceConstraintPolicy());
+
+  /**
+   * Fit the chunked observations to a Gaussian mixture model (GMM) using the
+   * EM algorithm.  The size of the vectors (indicating the number of
+   * components) must already be set.  Optionally, if useInitialModel is set to
+   * true, then the model given in the dists and weights parameters is used as
+   * the initial model, instead of clustering the first chunk.
+   *
+   * @param chunks Function that loads each chunk of observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   * @return Log-likelihood of the final model.
+   */
+  template<typename ChunkFunctionType>
+  double Estimate(ChunkFunctionType chunks,
+                  std::vector<Distribution>& dists,
+                  arma::vec& weights,
+                  const bool useInitialModel = false);
+
+  /**
+   * Make one pass over the chunks with the given model, and return the
+   * sufficient statistics of the observations.  This is one E-step; merging
+   * the statistics of several passes (for instance on separate shards) and
+   * calling EMSufficientStatistics::Update() gives the M-step.
+   *
+   * @param chunks Function that loads each chunk of observations.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   * @param stats Statistics to fill.
+   */
+  template<typename ChunkFunctionType>
+  void Accumulate(ChunkFunctionType& chunks,
+                  const std::vector<Distribution>& dists,
+                  const arma::vec& weights,
+                  EMSufficientStatistics<Distribution>& stats) const;
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the maximum number of iterations of the EM algorithm.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the EM algorithm.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of the EM algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the EM algorithm.
+  double& Tolerance() { return tolerance; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  /**
+   * Run the clusterer on the first chunk, and turn the cluster assignments
+   * into Gaussians.
+   *
+   * @param chunks Function that loads each chunk of observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   */
+  template<typename ChunkFunctionType>
+  void InitialClustering(ChunkFunctionType& chunks,
+                         std::vector<Distribution>& dists,
+                         arma::vec& weights);
+
+  //! Maximum iterations of EM algorithm.
+  size_t maxIterations;
+  //! Tolerance for convergence of EM.
+  double tolerance;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file methods/gmm/streaming_em_fit_impl.hpp
+ *
+ * Implementation of the EM algorithm for fitting GMMs to chunked data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_STREAMING_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_STREAMING_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+StreamingEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::StreamingEMFit(const size_t maxIterations,
+                                  const double tolerance,
+                                  InitialClusteringType clusterer,
+                                  CovarianceConstraintPolicy constraint) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    clusterer(clusterer),
+    constraint(constraint)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename ChunkFunctionType>
+double StreamingEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(ChunkFunctionType chunks,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  // Only perform initial clustering if the user wanted it.
+  if (!useInitialModel)
+    InitialClustering(chunks, dists, weights);
+
+  // Each pass over the chunks is the E-step of the current model, and gives
+  // its log-likelihood.
+  EMSufficientStatistics<Distribution> stats;
+  Accumulate(chunks, dists, weights, stats);
+  double l = stats.LogLikelihood();
+
+  Log::Debug << "StreamingEMFit::Estimate(): initial log-likelihood: " << l
+      << std::endl;
+
+  double lOld = -DBL_MAX;
+
+  // Iterate to update the model until no more improvement is found.
+  size_t iteration = 1;
+  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  {
+    Log::Info << "StreamingEMFit::Estimate(): iteration " << iteration << ", "
+        << "log-likelihood " << l << "." << std::endl;
+
+    // Calculate the new model from the statistics of the last pass.
+    stats.Update(dists, weights, constraint);
+
+    // Update values of l; calculate new log-likelihood.
+    lOld = l;
+    Accumulate(chunks, dists, weights, stats);
+    l = stats.LogLikelihood();
+
+    iteration++;
+  }
+
+  return l;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename ChunkFunctionType>
+void StreamingEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Accumulate(ChunkFunctionType& chunks,
+                              const std::vector<Distribution>& dists,
+                              const arma::vec& weights,
+                              EMSufficientStatistics<Distribution>& stats) const
+{
+  stats.Reset(dists[0].Mean().n_elem, dists.size());
+
+  arma::mat observations;
+  for (size_t chunk = 0; chunks(chunk, observations); ++chunk)
+    stats.Accumulate(observations, dists, weights);
+
+  if (stats.Points() == 0)
+  {
+    Log::Fatal << "StreamingEMFit::Accumulate(): no observations were given!"
+        << std::endl;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename ChunkFunctionType>
+void StreamingEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitialClustering(ChunkFunctionType& chunks,
+                                     std::vector<Distribution>& dists,
+                                     arma::vec& weights)
+{
+  arma::mat observations;
+  if (!chunks(0, observations))
+  {
+    Log::Fatal << "StreamingEMFit::Estimate(): no observations were given!"
+        << std::endl;
+  }
+
+  // Run clustering algorithm.
+  arma::Row<size_t> assignments;
+  clusterer.Cluster(observations, dists.size(), assignments);
+
+  // Each point belongs only to its cluster.
+  arma::mat responsibilities(observations.n_cols, dists.size(),
+      arma::fill::zeros);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    responsibilities(i, assignments[i]) = 1.0;
+
+  EMSufficientStatistics<Distribution> stats(observations.n_rows,
+      dists.size());
+  stats.Accumulate(observations, responsibilities);
+  stats.Update(dists, weights, constraint);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void StreamingEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
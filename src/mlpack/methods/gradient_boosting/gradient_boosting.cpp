@@ -0,0 +1,263 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting.cpp
+ *
+ * Implementation of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+GradientBoosting::GradientBoosting() : numClasses(0)
+{
+  // Nothing to do.
+}
+
+GradientBoosting::GradientBoosting(const arma::mat& data,
+                                   const arma::Row<size_t>& labels,
+                                   const size_t numClasses,
+                                   const size_t numRounds,
+                                   const double learningRate,
+                                   const size_t maximumDepth,
+                                   const size_t minimumLeafSize,
+                                   const double lambda,
+                                   const double minimumGain,
+                                   const double rowSubsample,
+                                   const double columnSubsample,
+                                   const size_t maxBins) :
+    numClasses(0)
+{
+  Train(data, labels, numClasses, numRounds, learningRate, maximumDepth,
+      minimumLeafSize, lambda, minimumGain, rowSubsample, columnSubsample,
+      maxBins);
+}
+
+double GradientBoosting::Train(const arma::mat& data,
+                               const arma::Row<size_t>& labels,
+                               const size_t numClasses,
+                               const size_t numRounds,
+                               const double learningRate,
+                               const size_t maximumDepth,
+                               const size_t minimumLeafSize,
+                               const double lambda,
+                               const double minimumGain,
+                               const double rowSubsample,
+                               const double columnSubsample,
+                               const size_t maxBins)
+{
+  if (data.n_cols == 0 || labels.n_elem != data.n_cols)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the dataset must "
+        "not be empty, and there must be one label per point!");
+  }
+
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): there must be at "
+        "least two classes!");
+  }
+
+  if (arma::max(labels) >= numClasses)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the labels must "
+        "be in [0, numClasses - 1]!");
+  }
+
+  if (maxBins < 2 || maxBins > 256)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the number of "
+        "bins must be between 2 and 256!");
+  }
+
+  if (rowSubsample <= 0.0 || rowSubsample > 1.0 || columnSubsample <= 0.0 ||
+      columnSubsample > 1.0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the subsampling "
+        "ratios must be in (0, 1]!");
+  }
+
+  // Bin the dataset once for all the trees.
+  std::vector<arma::vec> cuts;
+  arma::Mat<unsigned char> bins;
+  Bin(data, maxBins, cuts, bins);
+
+  // The initial scores are the log of the (smoothed) frequencies of the
+  // classes.
+  arma::vec counts(numClasses, arma::fill::ones);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    counts[labels[i]] += 1.0;
+  this->numClasses = numClasses;
+  initialScores = arma::log(counts / arma::accu(counts));
+
+  trees.clear();
+  trees.reserve(numRounds * numClasses);
+
+  arma::mat scores = arma::repmat(initialScores, 1, data.n_cols);
+  arma::mat probabilities;
+  arma::vec gradients(data.n_cols), hessians(data.n_cols);
+  const size_t numPoints = std::max((size_t) 1,
+      (size_t) std::ceil(rowSubsample * data.n_cols - 1e-9));
+  const size_t numDimensions = std::max((size_t) 1,
+      (size_t) std::ceil(columnSubsample * data.n_rows - 1e-9));
+  for (size_t r = 0; r < numRounds; ++r)
+  {
+    probabilities = scores;
+    Softmax(probabilities);
+
+    // All the trees of the round use the same points and dimensions.
+    const arma::uvec points = (numPoints == data.n_cols) ?
+        arma::regspace<arma::uvec>(0, data.n_cols - 1) :
+        arma::uvec(arma::sort(arma::randperm(data.n_cols, numPoints)));
+    const arma::uvec dimensions = (numDimensions == data.n_rows) ?
+        arma::regspace<arma::uvec>(0, data.n_rows - 1) :
+        arma::uvec(arma::sort(arma::randperm(data.n_rows, numDimensions)));
+
+    for (size_t c = 0; c < numClasses; ++c)
+    {
+      // The gradient and the hessian of the softmax loss with respect to the
+      // score of the class.
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        const double p = probabilities(c, i);
+        gradients[i] = p - ((labels[i] == c) ? 1.0 : 0.0);
+        hessians[i] = std::max(p * (1.0 - p), 1e-16);
+      }
+
+      trees.push_back(GradientBoostingTree());
+      trees.back().Train(bins, cuts, gradients, hessians, points, dimensions,
+          maximumDepth, minimumLeafSize, lambda, minimumGain, learningRate);
+    }
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      for (size_t c = 0; c < numClasses; ++c)
+        scores(c, i) += trees[r * numClasses + c].Predict(data.col(i));
+    }
+  }
+
+  // Compute the final loss.
+  Softmax(scores);
+  double loss = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    loss -= std::log(std::max(scores(labels[i], i), 1e-300));
+
+  return loss / data.n_cols;
+}
+
+size_t GradientBoosting::Classify(const arma::vec& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+void GradientBoosting::Classify(const arma::vec& point,
+                                size_t& prediction,
+                                arma::vec& probabilities) const
+{
+  arma::mat scores;
+  Scores(point, scores);
+  Softmax(scores);
+
+  probabilities = scores.col(0);
+  prediction = (size_t) probabilities.index_max();
+}
+
+void GradientBoosting::Classify(const arma::mat& data,
+                                arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+void GradientBoosting::Classify(const arma::mat& data,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& probabilities) const
+{
+  Scores(data, probabilities);
+  Softmax(probabilities);
+
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = (size_t) probabilities.col(i).index_max();
+}
+
+void GradientBoosting::Bin(const arma::mat& data,
+                           const size_t maxBins,
+                           std::vector<arma::vec>& cuts,
+                           arma::Mat<unsigned char>& bins)
+{
+  cuts.resize(data.n_rows);
+  bins.set_size(data.n_rows, data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    const arma::vec values = arma::unique(data.row(d).t());
+    if (values.n_elem <= maxBins)
+    {
+      // Each value has its own bin; the bounds are halfway between the
+      // values.
+      if (values.n_elem > 1)
+      {
+        cuts[d] = (values.subvec(0, values.n_elem - 2) +
+            values.subvec(1, values.n_elem - 1)) / 2.0;
+      }
+      else
+      {
+        cuts[d].clear();
+      }
+    }
+    else
+    {
+      // The bounds are the quantiles of the values.
+      const arma::vec sorted = arma::sort(data.row(d).t());
+      arma::vec quantiles(maxBins - 1);
+      for (size_t b = 1; b < maxBins; ++b)
+        quantiles[b - 1] = sorted[b * sorted.n_elem / maxBins];
+      cuts[d] = arma::unique(quantiles);
+    }
+
+    // The bin of a value is the number of bounds below it.
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      bins(d, i) = (unsigned char) (std::lower_bound(cuts[d].begin(),
+          cuts[d].end(), data(d, i)) - cuts[d].begin());
+    }
+  }
+}
+
+void GradientBoosting::Softmax(arma::mat& scores)
+{
+  for (size_t i = 0; i < scores.n_cols; ++i)
+  {
+    scores.col(i) = arma::exp(scores.col(i) - scores.col(i).max());
+    scores.col(i) /= arma::accu(scores.col(i));
+  }
+}
+
+void GradientBoosting::Scores(const arma::mat& data, arma::mat& scores) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Classify(): no model "
+        "trained!");
+  }
+
+  scores = arma::repmat(initialScores, 1, data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    for (size_t t = 0; t < trees.size(); ++t)
+      scores(t % numClasses, i) += trees[t].Predict(data.col(i));
+  }
+}
@@ -0,0 +1,213 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, which trains an ensemble of
+ * gradient boosted decision trees for classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "gradient_boosting_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * An implementation of gradient boosted decision trees for classification,
+ * with the softmax (multinomial logistic) loss.  Each boosting round fits one
+ * GradientBoostingTree per class to the gradients and hessians of the loss of
+ * the current scores, and adds its Newton steps, shrunk by the learning rate,
+ * to the scores of the class.  The predicted class probabilities are the
+ * softmax of the scores.
+ *
+ * As in XGBoost and LightGBM, the dataset is binned once before training: the
+ * values of each dimension are mapped to at most 256 bins with bounds at its
+ * quantiles, and the trees find their splits with histograms of the bins.
+ * Each tree may be trained on a random subset of the points and of the
+ * dimensions (row and column subsampling).
+ *
+ * For more information, see the following:
+ *
+ * @code
+ * @article{friedman2001greedy,
+ *   title={Greedy Function Approximation: A Gradient Boosting Machine},
+ *   author={Friedman, Jerome H.},
+ *   journal={Annals of Statistics},
+ *   volume={29},
+ *   number={5},
+ *   pages={1189--1232},
+ *   year={2001}
+ * }
+ *
+ * @inproceedings{chen2016xgboost,
+ *   title={XGBoost: A Scalable Tree Boosting System},
+ *   author={Chen, Tianqi and Guestrin, Carlos},
+ *   booktitle={Proceedings of the 22nd ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={785--794},
+ *   year={2016}
+ * }
+ * @endcode
+ */
+class GradientBoosting
+{
+ public:
+  /**
+   * Create an untrained model; Classify() will throw an exception until
+   * Train() is called.
+   */
+  GradientBoosting();
+
+  /**
+   * Train a model on the given data.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for the dataset, in [0, numClasses - 1].
+   * @param numClasses Number of classes in the dataset.
+   * @param numRounds Number of boosting rounds; each round trains one tree per
+   *     class.
+   * @param learningRate Shrinkage applied to the values of each tree.
+   * @param maximumDepth Maximum depth of each tree; a tree of depth d has at
+   *     most 2^d leaves (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param minimumGain Minimum decrease of the loss needed to split a node.
+   * @param rowSubsample Fraction of the points used to train each tree.
+   * @param columnSubsample Fraction of the dimensions used by each tree.
+   * @param maxBins Maximum number of bins of each dimension (at most 256).
+   */
+  GradientBoosting(const arma::mat& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t numRounds = 100,
+                   const double learningRate = 0.1,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 1,
+                   const double lambda = 1.0,
+                   const double minimumGain = 0.0,
+                   const double rowSubsample = 1.0,
+                   const double columnSubsample = 1.0,
+                   const size_t maxBins = 256);
+
+  /**
+   * Train the model on the given data, replacing any previous model.  The
+   * parameters are the same as for the constructor.
+   *
+   * @return The average softmax loss of the training points at the end of the
+   *     training.
+   */
+  double Train(const arma::mat& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numRounds = 100,
+               const double learningRate = 0.1,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 1,
+               const double lambda = 1.0,
+               const double minimumGain = 0.0,
+               const double rowSubsample = 1.0,
+               const double columnSubsample = 1.0,
+               const size_t maxBins = 256);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  size_t Classify(const arma::vec& point) const;
+
+  /**
+   * Predict the class of the given point, and the probability of each class.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class.
+   * @param probabilities This will be filled with the class probabilities.
+   */
+  void Classify(const arma::vec& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the class of each point of the given dataset.
+   *
+   * @param data Dataset to classify.
+   * @param predictions This will be filled with the predicted classes.
+   */
+  void Classify(const arma::mat& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the class of each point of the given dataset, and the probability
+   * of each class.
+   *
+   * @param data Dataset to classify.
+   * @param predictions This will be filled with the predicted classes.
+   * @param probabilities This will be filled with the class probabilities of
+   *     each point, one column per point.
+   */
+  void Classify(const arma::mat& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the number of boosting rounds.
+  size_t NumRounds() const
+  {
+    return (numClasses == 0) ? 0 : trees.size() / numClasses;
+  }
+
+  //! Get the tree of the given class trained at the given round.
+  const GradientBoostingTree& Tree(const size_t round, const size_t c) const
+  {
+    return trees[round * numClasses + c];
+  }
+
+  //! Get the initial score of each class.
+  const arma::vec& InitialScores() const { return initialScores; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numClasses);
+    ar & BOOST_SERIALIZATION_NVP(initialScores);
+    ar & BOOST_SERIALIZATION_NVP(trees);
+  }
+
+ private:
+  /**
+   * Compute the bounds of the bins of each dimension of the given data, and
+   * the bin of each value.
+   */
+  static void Bin(const arma::mat& data,
+                  const size_t maxBins,
+                  std::vector<arma::vec>& cuts,
+                  arma::Mat<unsigned char>& bins);
+
+  /**
+   * Turn the given scores into class probabilities, in place.
+   */
+  static void Softmax(arma::mat& scores);
+
+  //! Compute the scores of the given dataset.
+  void Scores(const arma::mat& data, arma::mat& scores) const;
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The initial score of each class (the log of its frequency).
+  arma::vec initialScores;
+  //! The trees of each round, one per class.
+  std::vector<GradientBoostingTree> trees;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
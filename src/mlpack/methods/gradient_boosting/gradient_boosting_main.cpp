@@ -0,0 +1,279 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_main.cpp
+ *
+ * A program to build and evaluate gradient boosted decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_NAME("Gradient boosted decision trees");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of gradient boosted decision trees for classification, "
+    "with histogram-based trees and second-order leaf values.  Given labeled "
+    "data, a model can be trained and saved for future use; or, a pre-trained "
+    "model can be used for classification.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program is an implementation of gradient boosted decision trees for "
+    "classification with the softmax loss.  Each boosting round trains one "
+    "regression tree per class on the gradients and hessians of the loss, as "
+    "XGBoost does; the trees find their splits with histograms of the binned "
+    "training data.  A model can be trained and saved for later use, or a "
+    "model may be loaded and predictions or class probabilities for points "
+    "may be generated."
+    "\n\n"
+    "The training set and associated labels are specified with the " +
+    PRINT_PARAM_STRING("training") + " and " + PRINT_PARAM_STRING("labels") +
+    " parameters, respectively.  The labels should be in the range [0, "
+    "num_classes - 1]."
+    "\n\n"
+    "When a model is trained, the " + PRINT_PARAM_STRING("output_model") + " "
+    "output parameter may be used to save the trained model.  A model may be "
+    "loaded for predictions with the " + PRINT_PARAM_STRING("input_model") +
+    " parameter.  The " + PRINT_PARAM_STRING("input_model") + " parameter may "
+    "not be specified when the " + PRINT_PARAM_STRING("training") + " parameter"
+    " is specified.  The " + PRINT_PARAM_STRING("num_rounds") + " parameter "
+    "controls the number of boosting rounds, and the " +
+    PRINT_PARAM_STRING("learning_rate") + " parameter the shrinkage of each "
+    "tree.  The " + PRINT_PARAM_STRING("maximum_depth") + ", " +
+    PRINT_PARAM_STRING("minimum_leaf_size") + ", " +
+    PRINT_PARAM_STRING("lambda") + " and " +
+    PRINT_PARAM_STRING("minimum_gain") + " parameters control the size of the "
+    "trees and the regularization of their leaves.  Each tree may be trained "
+    "on a random fraction of the points and of the dimensions, given by the " +
+    PRINT_PARAM_STRING("row_subsample") + " and " +
+    PRINT_PARAM_STRING("column_subsample") + " parameters.  The " +
+    PRINT_PARAM_STRING("max_bins") + " parameter controls the number of bins "
+    "of each dimension.  If " + PRINT_PARAM_STRING("print_training_accuracy") +
+    " is specified, the calculated accuracy on the training set will be "
+    "printed."
+    "\n\n"
+    "Test data may be specified with the " + PRINT_PARAM_STRING("test") + " "
+    "parameter, and if performance measures are desired for that test set, "
+    "labels for the test points may be specified with the " +
+    PRINT_PARAM_STRING("test_labels") + " parameter.  Predictions for each "
+    "test point may be saved via the " + PRINT_PARAM_STRING("predictions") +
+    " output parameter.  Class probabilities for each prediction may be saved "
+    "with the " + PRINT_PARAM_STRING("probabilities") + " output parameter.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, to train a model with 50 rounds of trees of depth at most 4 "
+    "on the dataset contained in " + PRINT_DATASET("data") + " with labels " +
+    PRINT_DATASET("labels") + ", saving the model to " +
+    PRINT_MODEL("gb_model") + " and printing the training error, one could "
+    "call"
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "training", "data", "labels", "labels",
+        "num_rounds", 50, "maximum_depth", 4, "output_model", "gb_model",
+        "print_training_accuracy", true) +
+    "\n\n"
+    "Then, to use that model to classify points in " +
+    PRINT_DATASET("test_set") + " and print the test error given the labels " +
+    PRINT_DATASET("test_labels") + ", while saving the predictions for each "
+    "point to " + PRINT_DATASET("predictions") + ", one could call "
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "input_model", "gb_model", "test",
+        "test_set", "test_labels", "test_labels", "predictions",
+        "predictions"));
+
+// See also...
+BINDING_SEE_ALSO("@random_forest", "#random_forest");
+BINDING_SEE_ALSO("@decision_tree", "#decision_tree");
+BINDING_SEE_ALSO("@adaboost", "#adaboost");
+BINDING_SEE_ALSO("Gradient boosting on Wikipedia",
+        "https://en.wikipedia.org/wiki/Gradient_boosting");
+BINDING_SEE_ALSO("XGBoost: A Scalable Tree Boosting System (pdf)",
+        "https://arxiv.org/pdf/1603.02754.pdf");
+BINDING_SEE_ALSO("mlpack::tree::GradientBoosting C++ class documentation",
+        "@doxygen/classmlpack_1_1tree_1_1GradientBoosting.html");
+
+PARAM_MATRIX_IN("training", "Training dataset.", "t");
+PARAM_UROW_IN("labels", "Labels for training dataset.", "l");
+PARAM_MATRIX_IN("test", "Test dataset to produce predictions for.", "T");
+PARAM_UROW_IN("test_labels", "Test dataset labels, if accuracy calculation is "
+    "desired.", "L");
+
+PARAM_FLAG("print_training_accuracy", "If set, then the accuracy of the model "
+    "on the training set will be predicted (verbose must also be specified).",
+    "a");
+
+PARAM_INT_IN("num_rounds", "Number of boosting rounds; each round trains one "
+    "tree per class.", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Shrinkage applied to the values of each "
+    "tree.", "r", 0.1);
+PARAM_INT_IN("maximum_depth", "Maximum depth of each tree (0 means no limit).",
+    "D", 6);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf "
+    "node.", "n", 1);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the leaf values.", "R", 1.0);
+PARAM_DOUBLE_IN("minimum_gain", "Minimum decrease of the loss needed to split "
+    "a node.", "g", 0.0);
+PARAM_DOUBLE_IN("row_subsample", "Fraction of the points used to train each "
+    "tree.", "S", 1.0);
+PARAM_DOUBLE_IN("column_subsample", "Fraction of the dimensions used by each "
+    "tree.", "C", 1.0);
+PARAM_INT_IN("max_bins", "Maximum number of bins of each dimension (at most "
+    "256).", "b", 256);
+
+PARAM_MATRIX_OUT("probabilities", "Predicted class probabilities for each "
+    "point in the test set.", "P");
+PARAM_UROW_OUT("predictions", "Predicted classes for each point in the test "
+    "set.", "p");
+
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+PARAM_MODEL_IN(GradientBoosting, "input_model", "Pre-trained gradient boosting "
+    "model to use for classification.", "m");
+PARAM_MODEL_OUT(GradientBoosting, "output_model", "Model to save trained "
+    "gradient boosting model to.", "M");
+
+static void mlpackMain()
+{
+  // Initialize random seed if needed.
+  if (IO::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) IO::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // Check for incompatible input parameters.
+  RequireOnlyOnePassed({ "training", "input_model" }, true);
+
+  ReportIgnoredParam({{ "training", false }}, "print_training_accuracy");
+  ReportIgnoredParam({{ "test", false }}, "test_labels");
+
+  RequireAtLeastOnePassed({ "test", "output_model", "print_training_accuracy" },
+      false, "the trained model will not be used or saved");
+
+  if (IO::HasParam("training"))
+  {
+    RequireAtLeastOnePassed({ "labels" }, true, "must pass labels when training"
+        " set given");
+  }
+
+  ReportIgnoredParam({{ "test", false }}, "predictions");
+  ReportIgnoredParam({{ "test", false }}, "probabilities");
+
+  RequireParamValue<int>("num_rounds", [](int x) { return x > 0; }, true,
+      "number of rounds must be positive");
+  RequireParamValue<double>("learning_rate", [](double x) { return x > 0.0; },
+      true, "learning rate must be positive");
+  RequireParamValue<int>("maximum_depth", [](int x) { return x >= 0; }, true,
+      "maximum depth must not be negative");
+  RequireParamValue<int>("minimum_leaf_size", [](int x) { return x > 0; }, true,
+      "minimum leaf size must be greater than 0");
+  RequireParamValue<double>("lambda", [](double x) { return x >= 0.0; }, true,
+      "lambda must be nonnegative");
+  RequireParamValue<double>("minimum_gain", [](double x) { return x >= 0.0; },
+      true, "minimum gain for splitting must be nonnegative");
+  RequireParamValue<double>("row_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "row subsampling ratio must be in (0, 1]");
+  RequireParamValue<double>("column_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "column subsampling ratio must be in (0, 1]");
+  RequireParamValue<int>("max_bins", [](int x) { return x >= 2 && x <= 256; },
+      true, "number of bins must be between 2 and 256");
+
+  ReportIgnoredParam({{ "training", false }}, "num_rounds");
+  ReportIgnoredParam({{ "training", false }}, "learning_rate");
+  ReportIgnoredParam({{ "training", false }}, "maximum_depth");
+  ReportIgnoredParam({{ "training", false }}, "minimum_leaf_size");
+
+  GradientBoosting* model;
+  if (IO::HasParam("training"))
+  {
+    Timer::Start("gb_training");
+    model = new GradientBoosting();
+
+    // Train the model on the given input data.
+    arma::mat data = std::move(IO::GetParam<arma::mat>("training"));
+    arma::Row<size_t> labels =
+        std::move(IO::GetParam<arma::Row<size_t>>("labels"));
+
+    const size_t numClasses = std::max((size_t) arma::max(labels) + 1,
+        (size_t) 2);
+
+    Log::Info << "Training gradient boosted trees with "
+        << IO::GetParam<int>("num_rounds") << " rounds..." << endl;
+
+    model->Train(data, labels, numClasses,
+        (size_t) IO::GetParam<int>("num_rounds"),
+        IO::GetParam<double>("learning_rate"),
+        (size_t) IO::GetParam<int>("maximum_depth"),
+        (size_t) IO::GetParam<int>("minimum_leaf_size"),
+        IO::GetParam<double>("lambda"),
+        IO::GetParam<double>("minimum_gain"),
+        IO::GetParam<double>("row_subsample"),
+        IO::GetParam<double>("column_subsample"),
+        (size_t) IO::GetParam<int>("max_bins"));
+    Timer::Stop("gb_training");
+
+    // Did we want training accuracy?
+    if (IO::HasParam("print_training_accuracy"))
+    {
+      Timer::Start("gb_prediction");
+      arma::Row<size_t> predictions;
+      model->Classify(data, predictions);
+
+      const size_t correct = arma::accu(predictions == labels);
+
+      Log::Info << correct << " of " << labels.n_elem << " correct on training"
+          << " set (" << (double(correct) / double(labels.n_elem) * 100) << ")."
+          << endl;
+      Timer::Stop("gb_prediction");
+    }
+  }
+  else
+  {
+    // Then we must be loading a model.
+    model = IO::GetParam<GradientBoosting*>("input_model");
+  }
+
+  if (IO::HasParam("test"))
+  {
+    arma::mat testData = std::move(IO::GetParam<arma::mat>("test"));
+    Timer::Start("gb_prediction");
+
+    // Get predictions and probabilities.
+    arma::Row<size_t> predictions;
+    arma::mat probabilities;
+    model->Classify(testData, predictions, probabilities);
+    Timer::Stop("gb_prediction");
+
+    // Did we want to calculate test accuracy?
+    if (IO::HasParam("test_labels"))
+    {
+      arma::Row<size_t> testLabels =
+          std::move(IO::GetParam<arma::Row<size_t>>("test_labels"));
+
+      const size_t correct = arma::accu(predictions == testLabels);
+
+      Log::Info << correct << " of " << testLabels.n_elem << " correct on test"
+          << " set (" << (double(correct) / double(testLabels.n_elem) * 100)
+          << ")." << endl;
+    }
+
+    // Save the outputs.
+    IO::GetParam<arma::mat>("probabilities") = std::move(probabilities);
+    IO::GetParam<arma::Row<size_t>>("predictions") = std::move(predictions);
+  }
+
+  // Save the output model.
+  IO::GetParam<GradientBoosting*>("output_model") = model;
+}
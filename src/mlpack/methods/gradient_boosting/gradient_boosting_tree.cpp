@@ -0,0 +1,175 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_tree.cpp
+ *
+ * Implementation of the GradientBoostingTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting_tree.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+GradientBoostingTree::GradientBoostingTree() :
+    nodes(1),
+    maximumDepth(0),
+    minimumLeafSize(1),
+    lambda(0.0),
+    minimumGain(0.0),
+    shrinkage(1.0)
+{
+  nodes[0].dimension = 0;
+  nodes[0].threshold = 0.0;
+  nodes[0].left = 0;
+  nodes[0].value = 0.0;
+}
+
+void GradientBoostingTree::Train(const arma::Mat<unsigned char>& bins,
+                                 const std::vector<arma::vec>& cuts,
+                                 const arma::vec& gradients,
+                                 const arma::vec& hessians,
+                                 const arma::uvec& points,
+                                 const arma::uvec& dimensions,
+                                 const size_t maximumDepth,
+                                 const size_t minimumLeafSize,
+                                 const double lambda,
+                                 const double minimumGain,
+                                 const double shrinkage)
+{
+  this->maximumDepth = maximumDepth;
+  this->minimumLeafSize = std::max(minimumLeafSize, (size_t) 1);
+  this->lambda = lambda;
+  this->minimumGain = minimumGain;
+  this->shrinkage = shrinkage;
+
+  double gradient = 0.0, hessian = 0.0;
+  for (size_t i = 0; i < points.n_elem; ++i)
+  {
+    gradient += gradients[points[i]];
+    hessian += hessians[points[i]];
+  }
+
+  // The points are reordered so that the points of each node are contiguous.
+  arma::uvec order(points);
+  nodes.resize(1);
+  Split(bins, cuts, gradients, hessians, dimensions, order, 0, 0,
+      order.n_elem, gradient, hessian, 0);
+}
+
+void GradientBoostingTree::Split(const arma::Mat<unsigned char>& bins,
+                                 const std::vector<arma::vec>& cuts,
+                                 const arma::vec& gradients,
+                                 const arma::vec& hessians,
+                                 const arma::uvec& dimensions,
+                                 arma::uvec& points,
+                                 const size_t node,
+                                 const size_t begin,
+                                 const size_t count,
+                                 const double gradient,
+                                 const double hessian,
+                                 const size_t depth)
+{
+  // Start as a leaf.
+  nodes[node].dimension = 0;
+  nodes[node].threshold = 0.0;
+  nodes[node].left = 0;
+  nodes[node].value = (count == 0) ? 0.0 :
+      -shrinkage * gradient / (hessian + lambda);
+
+  if ((maximumDepth != 0 && depth >= maximumDepth) ||
+      count < 2 * minimumLeafSize)
+    return;
+
+  // Find the best split of each dimension with the histogram of the gradients
+  // and hessians of its bins.
+  const double score = gradient * gradient / (hessian + lambda);
+  std::vector<double> gains(dimensions.n_elem, 0.0);
+  std::vector<size_t> splitBins(dimensions.n_elem, 0);
+  std::vector<char> found(dimensions.n_elem, 0);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) dimensions.n_elem; ++j)
+  {
+    const size_t d = dimensions[j];
+    const size_t numBins = cuts[d].n_elem + 1;
+    arma::vec binGradients(numBins, arma::fill::zeros);
+    arma::vec binHessians(numBins, arma::fill::zeros);
+    arma::Col<size_t> binCounts(numBins, arma::fill::zeros);
+    for (size_t i = begin; i < begin + count; ++i)
+    {
+      const size_t p = points[i];
+      const size_t b = bins(d, p);
+      binGradients[b] += gradients[p];
+      binHessians[b] += hessians[p];
+      ++binCounts[b];
+    }
+
+    double leftGradient = 0.0, leftHessian = 0.0;
+    size_t leftCount = 0;
+    for (size_t b = 0; b + 1 < numBins; ++b)
+    {
+      leftGradient += binGradients[b];
+      leftHessian += binHessians[b];
+      leftCount += binCounts[b];
+      if (leftCount < minimumLeafSize)
+        continue;
+      if (count - leftCount < minimumLeafSize)
+        break;
+
+      const double rightGradient = gradient - leftGradient;
+      const double rightHessian = hessian - leftHessian;
+      const double gain = leftGradient * leftGradient /
+          (leftHessian + lambda) + rightGradient * rightGradient /
+          (rightHessian + lambda) - score;
+      if (gain > gains[j])
+      {
+        gains[j] = gain;
+        splitBins[j] = b;
+        found[j] = 1;
+      }
+    }
+  }
+
+  // Keep the best dimension; ties go to the first one, whatever the number of
+  // threads.
+  size_t best = dimensions.n_elem;
+  for (size_t j = 0; j < dimensions.n_elem; ++j)
+  {
+    if (found[j] && gains[j] > minimumGain &&
+        (best == dimensions.n_elem || gains[j] > gains[best]))
+      best = j;
+  }
+
+  if (best == dimensions.n_elem)
+    return;
+
+  // Move the points of the left child first.
+  const size_t d = dimensions[best];
+  const size_t splitBin = splitBins[best];
+  arma::uword* first = points.memptr() + begin;
+  arma::uword* middle = std::partition(first, first + count,
+      [&](const arma::uword p) { return bins(d, p) <= splitBin; });
+  const size_t leftCount = middle - first;
+
+  double leftGradient = 0.0, leftHessian = 0.0;
+  for (size_t i = begin; i < begin + leftCount; ++i)
+  {
+    leftGradient += gradients[points[i]];
+    leftHessian += hessians[points[i]];
+  }
+
+  const size_t left = nodes.size();
+  nodes.resize(left + 2);
+  nodes[node].dimension = d;
+  nodes[node].threshold = cuts[d][splitBin];
+  nodes[node].left = left;
+
+  Split(bins, cuts, gradients, hessians, dimensions, points, left, begin,
+      leftCount, leftGradient, leftHessian, depth + 1);
+  Split(bins, cuts, gradients, hessians, dimensions, points, left + 1,
+      begin + leftCount, count - leftCount, gradient - leftGradient,
+      hessian - leftHessian, depth + 1);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_tree.hpp
+ *
+ * Definition of the GradientBoostingTree class, a regression tree fitted to
+ * the gradients and hessians of a loss with histograms of binned data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A GradientBoostingTree is a binary regression tree, fitted to the gradients
+ * and hessians of a loss function at each point, as in XGBoost and LightGBM.
+ * Its leaves hold the Newton step of the loss,
+ *
+ *   value = -shrinkage * G / (H + lambda),
+ *
+ * where G and H are the sums of the gradients and hessians of the points of
+ * the leaf, and each split maximizes the decrease of the second-order
+ * approximation of the loss,
+ *
+ *   G_L^2 / (H_L + lambda) + G_R^2 / (H_R + lambda) - G^2 / (H + lambda).
+ *
+ * The tree is trained on binned data: the values of each dimension are
+ * replaced by the index of their bin, so each node finds its best split with
+ * a histogram of the gradients and hessians per bin, in linear time, like the
+ * HistogramNumericSplit of the DecisionTree.  The dimensions of a node are
+ * searched in parallel when OpenMP is available.  The split points are the
+ * bounds of the bins, so the trained tree predicts the original data
+ * directly: a point goes left if its value is at most the split point.
+ */
+class GradientBoostingTree
+{
+ public:
+  /**
+   * Create an empty tree, which predicts 0 everywhere.
+   */
+  GradientBoostingTree();
+
+  /**
+   * Fit the tree to the given gradients and hessians.
+   *
+   * @param bins Bin of each value of the dataset (one column per point).  The
+   *     values of dimension d in bins up to b are at most cuts[d][b].
+   * @param cuts Upper bounds of the bins of each dimension (all the bins but
+   *     the last one).
+   * @param gradients Gradient of the loss at each point.
+   * @param hessians Hessian of the loss at each point.
+   * @param points Points to fit the tree to.
+   * @param dimensions Dimensions the tree may split on.
+   * @param maximumDepth Maximum depth of the tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param minimumGain Minimum decrease of the loss needed to split a node.
+   * @param shrinkage Factor applied to the leaf values.
+   */
+  void Train(const arma::Mat<unsigned char>& bins,
+             const std::vector<arma::vec>& cuts,
+             const arma::vec& gradients,
+             const arma::vec& hessians,
+             const arma::uvec& points,
+             const arma::uvec& dimensions,
+             const size_t maximumDepth,
+             const size_t minimumLeafSize,
+             const double lambda,
+             const double minimumGain,
+             const double shrinkage);
+
+  /**
+   * Predict the value of the given point.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const
+  {
+    size_t i = 0;
+    while (nodes[i].left != 0)
+    {
+      i = (point[nodes[i].dimension] <= nodes[i].threshold) ? nodes[i].left :
+          nodes[i].left + 1;
+    }
+
+    return nodes[i].value;
+  }
+
+  //! Get the number of nodes in the tree.
+  size_t NumNodes() const { return nodes.size(); }
+
+  //! Get the number of leaves in the tree.
+  size_t NumLeaves() const { return (nodes.size() + 1) / 2; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(nodes);
+  }
+
+ private:
+  /**
+   * A node of the tree.  If left is 0, the node is a leaf; otherwise, its
+   * children are the nodes left and left + 1.
+   */
+  struct Node
+  {
+    size_t dimension;
+    double threshold;
+    size_t left;
+    double value;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(dimension);
+      ar & BOOST_SERIALIZATION_NVP(threshold);
+      ar & BOOST_SERIALIZATION_NVP(left);
+      ar & BOOST_SERIALIZATION_NVP(value);
+    }
+  };
+
+  /**
+   * Fit the subtree of the given node to the points [begin, begin + count) of
+   * the given points, whose gradients and hessians sum to the given values.
+   */
+  void Split(const arma::Mat<unsigned char>& bins,
+             const std::vector<arma::vec>& cuts,
+             const arma::vec& gradients,
+             const arma::vec& hessians,
+             const arma::uvec& dimensions,
+             arma::uvec& points,
+             const size_t node,
+             const size_t begin,
+             const size_t count,
+             const double gradient,
+             const double hessian,
+             const size_t depth);
+
+  //! The nodes of the tree; the root is the first one.
+  std::vector<Node> nodes;
+
+  //! The training parameters, only used during Train().
+  size_t maximumDepth;
+  size_t minimumLeafSize;
+  double lambda;
+  double minimumGain;
+  double shrinkage;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
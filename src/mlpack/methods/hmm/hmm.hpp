@@ -163,6 +163,10 @@ class HMM
    * is called, it uses the current parameters of the HMM as a starting point
    * for training.
    *
+   * The E-step of each iteration is run in parallel over the sequences when
+   * OpenMP is available; each thread sums the statistics of its sequences,
+   * which are then merged in the order of the threads.
+   *
    * @param dataSeq Vector of observation sequences.
    * @return Log-likelihood of state sequence.
    */
@@ -399,6 +403,45 @@ class HMM
                 const arma::vec& logScales,
                 arma::mat& backwardLogProb) const;
 
+  /**
+   * Compute the log-probability of each observation in the given data sequence
+   * under the emission distribution of each state.  The returned matrix has
+   * rows equal to the number of hidden states and columns equal to the number
+   * of observations.  Distributions that can evaluate a whole matrix of
+   * observations at once (with a LogProbability(const arma::mat&, arma::vec&)
+   * overload, like GaussianDistribution and GMM) are given the whole sequence.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionLogProb Matrix in which the log-probabilities will be saved.
+   */
+  void EmissionLogProbability(const arma::mat& dataSeq,
+                              arma::mat& emissionLogProb) const;
+
+  /**
+   * The Forward algorithm, given the emission log-probabilities computed by
+   * EmissionLogProbability().  The sum over the previous states is computed as
+   * a matrix-vector product with the transition matrix.
+   *
+   * @param emissionLogProb Emission log-probabilities of the data sequence.
+   * @param logScales Vector in which scaling factors will be saved.
+   * @param forwardLogProb Matrix in which forward probabilities will be saved.
+   */
+  void LogForward(const arma::mat& emissionLogProb,
+                  arma::vec& logScales,
+                  arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm, given the emission log-probabilities computed by
+   * EmissionLogProbability() and the scaling factors found by LogForward().
+   *
+   * @param emissionLogProb Emission log-probabilities of the data sequence.
+   * @param logScales Vector of scaling factors.
+   * @param backwardLogProb Matrix in which backward probabilities will be saved.
+   */
+  void LogBackward(const arma::mat& emissionLogProb,
+                   const arma::vec& logScales,
+                   arma::mat& backwardLogProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -419,6 +462,39 @@ class HMM
    */
   void ConvertToLogSpace() const;
 
+  /**
+   * Compute the log-probability of each of the given observations with a
+   * single call, for distributions that support it.
+   */
+  template<typename DistributionType>
+  static auto LogProbabilities(const DistributionType& distribution,
+                               const arma::mat& observations,
+                               arma::vec& logProbabilities,
+                               const int /* preferred */)
+      -> decltype(distribution.LogProbability(observations, logProbabilities),
+                  void())
+  {
+    distribution.LogProbability(observations, logProbabilities);
+  }
+
+  /**
+   * Compute the log-probability of each of the given observations one at a
+   * time, for the other distributions.
+   */
+  template<typename DistributionType>
+  static void LogProbabilities(const DistributionType& distribution,
+                               const arma::mat& observations,
+                               arma::vec& logProbabilities,
+                               const long /* fallback */)
+  {
+    logProbabilities.set_size(observations.n_cols);
+    for (size_t i = 0; i < observations.n_cols; ++i)
+    {
+      logProbabilities[i] = distribution.LogProbability(
+          observations.unsafe_col(i));
+    }
+  }
+
   /**
    * A proxy vriable in linear space for logInitial.
    * Should be removed in mlpack 4.0.
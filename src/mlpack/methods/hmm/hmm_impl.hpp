@@ -114,10 +114,39 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // do not change between iterations, so the emission list is filled once.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    }
+    sumTime += dataSeq[seq].n_cols;
+  }
+
+  // Each thread sums the statistics of its own sequences; they are merged
+  // afterwards in the order of the threads, so that the result does not depend
+  // on the scheduling.
+  #ifdef HAS_OPENMP
+    const size_t threads = omp_get_max_threads();
+  #else
+    const size_t threads = 1;
+  #endif
+  std::vector<arma::vec> threadLogInitial(threads);
+  std::vector<arma::mat> threadLogTransition(threads);
+  std::vector<double> threadLoglik(threads);
+
+  // Make sure the log-space parameters are up to date before they are shared
+  // between the threads.
+  ConvertToLogSpace();
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -125,30 +154,44 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   for (size_t iter = 0; iter < iterations; iter++)
   {
     // Clear new transition matrix and emission probabilities.
-    arma::vec newLogInitial(logTransition.n_rows);
-    newLogInitial.fill(-std::numeric_limits<double>::infinity());
-    arma::mat newLogTransition(logTransition.n_rows, logTransition.n_cols);
-    newLogTransition.fill(-std::numeric_limits<double>::infinity());
-
-    // Reset log likelihood.
-    loglik = 0;
-
-    // Sum over time.
-    size_t sumTime = 0;
+    for (size_t thread = 0; thread < threads; ++thread)
+    {
+      threadLogInitial[thread].set_size(logTransition.n_rows);
+      threadLogInitial[thread].fill(-std::numeric_limits<double>::infinity());
+      threadLogTransition[thread].set_size(logTransition.n_rows,
+          logTransition.n_cols);
+      threadLogTransition[thread].fill(
+          -std::numeric_limits<double>::infinity());
+      threadLoglik[thread] = 0;
+    }
 
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // Loop over each sequence.  This is the E-step.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
     {
-      arma::mat stateLogProb;
+      #ifdef HAS_OPENMP
+        const size_t thread = omp_get_thread_num();
+      #else
+        const size_t thread = 0;
+      #endif
+      const size_t length = dataSeq[seq].n_cols;
+      if (length == 0)
+        continue;
+
+      arma::mat emissionLogProb;
       arma::mat forwardLog;
       arma::mat backwardLog;
       arma::vec logScales;
 
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
+      // Add the log-likelihood of this sequence.
+      EmissionLogProbability(dataSeq[seq], emissionLogProb);
+      LogForward(emissionLogProb, logScales, forwardLog);
+      LogBackward(emissionLogProb, logScales, backwardLog);
+      const arma::mat stateLogProb = forwardLog + backwardLog;
+      threadLoglik[thread] += accu(logScales);
 
       // Add to estimate of initial probability for state j.
+      arma::vec& newLogInitial = threadLogInitial[thread];
       for (size_t j = 0; j < logTransition.n_cols; ++j)
         newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
 
@@ -157,29 +200,65 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
       //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
       //           t + 1)))
       //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      // We store the new estimates in a different matrix.  The sum over t of
+      // the estimate of T_ij (probability of transition from state j to state
+      // i) is a matrix product; we postpone multiplication of the old T_ij
+      // until later.  Each row is shifted by its maximum before leaving log
+      // space, so that the product does not underflow.
+      if (length > 1)
       {
-        for (size_t j = 0; j < logTransition.n_cols; ++j)
+        arma::mat next = backwardLog.cols(1, length - 1) +
+            emissionLogProb.cols(1, length - 1);
+        next.each_row() -= logScales.subvec(1, length - 1).t();
+        const arma::mat previous = forwardLog.cols(0, length - 2);
+
+        arma::vec nextMax = arma::max(next, 1);
+        arma::vec previousMax = arma::max(previous, 1);
+        nextMax.elem(arma::find_nonfinite(nextMax)).zeros();
+        previousMax.elem(arma::find_nonfinite(previousMax)).zeros();
+
+        arma::mat sums = log(exp(next.each_col() - nextMax) *
+            exp(previous.each_col() - previousMax).t());
+        sums.each_col() += nextMax;
+        sums.each_row() += previousMax.t();
+
+        arma::mat& newLogTransition = threadLogTransition[thread];
+        for (size_t j = 0; j < sums.n_cols; ++j)
         {
-          if (t < dataSeq[seq].n_cols - 1)
+          for (size_t i = 0; i < sums.n_rows; ++i)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < logTransition.n_rows; ++i)
-            {
-              newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
-                  forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
-            }
+            newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
+                sums(i, j));
           }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
         }
-        sumTime++;
+      }
+
+      // Store the weights of the observations, for Distribution::Train().
+      for (size_t j = 0; j < logTransition.n_cols; ++j)
+      {
+        emissionProb[j].subvec(offsets[seq], offsets[seq] + length - 1) =
+            exp(stateLogProb.row(j).t());
+      }
+    }
+
+    // Merge the statistics of each thread.
+    loglik = 0;
+    arma::vec newLogInitial(logTransition.n_rows);
+    newLogInitial.fill(-std::numeric_limits<double>::infinity());
+    arma::mat newLogTransition(logTransition.n_rows, logTransition.n_cols);
+    newLogTransition.fill(-std::numeric_limits<double>::infinity());
+    for (size_t thread = 0; thread < threads; ++thread)
+    {
+      loglik += threadLoglik[thread];
+      for (size_t i = 0; i < newLogInitial.n_elem; ++i)
+      {
+        newLogInitial[i] = math::LogAdd(newLogInitial[i],
+            threadLogInitial[thread][i]);
+      }
+      for (size_t i = 0; i < newLogTransition.n_elem; ++i)
+      {
+        newLogTransition[i] = math::LogAdd(newLogTransition[i],
+            threadLogTransition[thread][i]);
       }
     }
 
@@ -337,9 +416,12 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::mat& backwardLogProb,
                                       arma::vec& logScales) const
 {
-  // First run the forward-backward algorithm.
-  Forward(dataSeq, logScales, forwardLogProb);
-  Backward(dataSeq, logScales, backwardLogProb);
+  // First run the forward-backward algorithm.  The emission probabilities are
+  // shared by both passes.
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+  LogForward(emissionLogProb, logScales, forwardLogProb);
+  LogBackward(emissionLogProb, logScales, backwardLogProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
@@ -468,16 +550,20 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 
   ConvertToLogSpace();
 
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
+  logStateProb.col(0) = logInitial + emissionLogProb.col(0);
   for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
     stateSeqBack(state, 0) = state;
-  }
+
+  // Column j of the transposed transition matrix holds the log-probabilities
+  // of the transitions to state j.
+  const arma::mat logTransitionT = logTransition.t();
+  arma::mat prob(logTransition.n_rows, logTransition.n_rows);
 
   // Store the best first state.
   arma::uword index;
@@ -486,11 +572,12 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     // Assemble the state probability for this element.
     // Given that we are in state j, we use state with the highest probability
     // of being the previous state.
+    prob = logTransitionT;
+    prob.each_col() += logStateProb.col(t - 1);
     for (size_t j = 0; j < logTransition.n_rows; ++j)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
+      logStateProb(j, t) = prob.unsafe_col(j).max(index) +
+          emissionLogProb(j, t);
       stateSeqBack(j, t) = index;
     }
   }
@@ -577,13 +664,58 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& logScales,
                                 arma::mat& forwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+  LogForward(emissionLogProb, logScales, forwardLogProb);
+}
+
+/**
+ * The Backward procedure (part of the Forward-Backward algorithm).
+ */
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& logScales,
+                                 arma::mat& backwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+  LogBackward(emissionLogProb, logScales, backwardLogProb);
+}
+
+/**
+ * Compute the log-probability of each observation under each emission
+ * distribution.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbability(
+    const arma::mat& dataSeq,
+    arma::mat& emissionLogProb) const
+{
+  emissionLogProb.set_size(emission.size(), dataSeq.n_cols);
+  arma::vec logProbs;
+  for (size_t state = 0; state < emission.size(); state++)
+  {
+    LogProbabilities(emission[state], dataSeq, logProbs, 0);
+    emissionLogProb.row(state) = logProbs.t();
+  }
+}
+
+/**
+ * The Forward procedure, given the emission log-probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogForward(const arma::mat& emissionLogProb,
+                                   arma::vec& logScales,
+                                   arma::mat& forwardLogProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
-  forwardLogProb.fill(-std::numeric_limits<double>::infinity());
-  logScales.resize(dataSeq.n_cols);
-  logScales.fill(-std::numeric_limits<double>::infinity());
+  const size_t length = emissionLogProb.n_cols;
+  forwardLogProb.set_size(logTransition.n_rows, length);
+  logScales.set_size(length);
+  if (length == 0)
+    return;
 
   ConvertToLogSpace();
 
@@ -592,29 +724,25 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    forwardLogProb(state, 0) = logInitial(state) +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-  }
+  forwardLogProb.col(0) = logInitial + emissionLogProb.col(0);
 
   // Then normalize the column.
   logScales[0] = math::AccuLog(forwardLogProb.col(0));
   if (std::isfinite(logScales[0]))
     forwardLogProb.col(0) -= logScales[0];
 
+  // The previous column is normalized, so its probabilities can be summed in
+  // linear space without underflowing.
+  const arma::mat transition = exp(logTransition);
+
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < length; t++)
   {
-    for (size_t j = 0; j < logTransition.n_rows; ++j)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      arma::vec tmp = forwardLogProb.col(t - 1) + logTransition.row(j).t();
-      forwardLogProb(j, t) = math::AccuLog(tmp) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
-    }
+    // The forward probability of state j at time t is the sum over all states
+    // of the probability of the previous state transitioning to the current
+    // state and emitting the given observation.
+    forwardLogProb.col(t) = log(transition * exp(forwardLogProb.col(t - 1))) +
+        emissionLogProb.col(t);
 
     // Normalize probability.
     logScales[t] = math::AccuLog(forwardLogProb.col(t));
@@ -623,39 +751,51 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * The Backward procedure, given the emission log-probabilities.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& logScales,
-                                 arma::mat& backwardLogProb) const
+void HMM<Distribution>::LogBackward(const arma::mat& emissionLogProb,
+                                    const arma::vec& logScales,
+                                    arma::mat& backwardLogProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
-  backwardLogProb.fill(-std::numeric_limits<double>::infinity());
+  const size_t length = emissionLogProb.n_cols;
+  backwardLogProb.set_size(logTransition.n_rows, length);
+  if (length == 0)
+    return;
+
+  ConvertToLogSpace();
+  const arma::mat transition = exp(logTransition);
 
   // The last element probability is 1.
-  backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
+  backwardLogProb.col(length - 1).fill(0);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  arma::vec next;
+  for (size_t t = length - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < logTransition.n_rows; ++j)
+    // The backward probability of state j at time t is the sum over all states
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.  The terms are shifted by their maximum
+    // so that the sum does not underflow.
+    next = backwardLogProb.col(t + 1) + emissionLogProb.col(t + 1);
+    const double shift = next.max();
+    if (std::isfinite(shift))
     {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < logTransition.n_rows; state++)
-      {
-        backwardLogProb(j, t) = math::LogAdd(backwardLogProb(j, t),
-            logTransition(state, j) + backwardLogProb(state, t + 1)
-            + emission[state].LogProbability(dataSeq.unsafe_col(t + 1)));
-      }
-
-      // Normalize by the weights from the forward algorithm.
-      if (std::isfinite(logScales[t + 1]))
-        backwardLogProb(j, t) -= logScales[t + 1];
+      backwardLogProb.col(t) = log(transition.t() * exp(next - shift)) +
+          shift;
     }
+    else
+    {
+      backwardLogProb.col(t).fill(-std::numeric_limits<double>::infinity());
+    }
+
+    // Normalize by the weights from the forward algorithm.
+    if (std::isfinite(logScales[t + 1]))
+      backwardLogProb.col(t) -= logScales[t + 1];
   }
 }
 
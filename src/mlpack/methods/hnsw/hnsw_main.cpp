@@ -0,0 +1,241 @@
+/**
+ * @file methods/hnsw/hnsw_main.cpp
+ *
+ * This file computes the approximate nearest neighbors with hierarchical
+ * navigable small world graphs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/io.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "hnsw_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Program Name.
+BINDING_NAME("K-Approximate-Nearest-Neighbor Search with HNSW graphs");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of approximate k-nearest-neighbor search with "
+    "hierarchical navigable small world (HNSW) graphs.  Given a set of "
+    "reference points and a set of query points, this will compute the k "
+    "approximate nearest neighbors of each query point in the reference set; "
+    "models can be saved for future use.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points using a hierarchical navigable small world graph built on the "
+    "reference points.  You may specify a separate set of reference points and "
+    "query points, or just a reference set which will be used as both the "
+    "reference and query set (in which case each point is not counted as its "
+    "own neighbor)."
+    "\n\n"
+    "The number of links of each node of the graph is controlled with " +
+    PRINT_PARAM_STRING("links") + " (nodes of the bottom level have twice as "
+    "many links), and the width of the beam search used to insert points with " +
+    PRINT_PARAM_STRING("ef_construction") + "; larger values give a better "
+    "graph, but take longer to build.  The width of the beam search used to "
+    "search for the neighbors is given by " + PRINT_PARAM_STRING("ef_search") +
+    " (at least k is used); larger values give better recall, but slower "
+    "searches.  This parameter can be changed when a model is loaded."
+    "\n\n"
+    "The reference set and the links of the bottom level of the graph of the "
+    "output model can be written to the files given with " +
+    PRINT_PARAM_STRING("reference_map_file") + " and " +
+    PRINT_PARAM_STRING("graph_map_file") + "; the model is then saved without "
+    "them, and loading the model later memory-maps them from these files.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "The levels of the nodes of the graph are random, so results may be "
+    "different from run to run.  Thus, the " + PRINT_PARAM_STRING("seed") +
+    " parameter can be specified to set the random seed.");
+
+// See also...
+BINDING_SEE_ALSO("@knn", "#knn");
+BINDING_SEE_ALSO("@lsh", "#lsh");
+BINDING_SEE_ALSO("Efficient and robust approximate nearest neighbor search "
+    "using Hierarchical Navigable Small World graphs (pdf)",
+    "https://arxiv.org/pdf/1603.09320.pdf");
+BINDING_SEE_ALSO("mlpack::neighbor::HNSWSearch C++ class documentation",
+    "@doxygen/classmlpack_1_1neighbor_1_1HNSWSearch.html");
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSWSearch<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSWSearch<>, "output_model", "Output for trained HNSW model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("links", "Number of links of each node on the upper levels of "
+    "the graph.", "l", 16);
+PARAM_INT_IN("ef_construction", "Width of the beam search used to insert "
+    "points into the graph.", "c", 200);
+PARAM_INT_IN("ef_search", "Width of the beam search used to search the graph; "
+    "if 0, the value of the input model (or 50) is used.", "e", 0);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+PARAM_STRING_IN("reference_map_file", "If specified, the reference set of the "
+    "output model is written to this file and the output model is saved "
+    "without it; loading that model later memory-maps the reference set from "
+    "this file.", "f", "");
+PARAM_STRING_IN("graph_map_file", "If specified, the links of the bottom level "
+    "of the graph of the output model are written to this file and the output "
+    "model is saved without them; loading that model later memory-maps the "
+    "links from this file.", "g", "");
+
+static void mlpackMain()
+{
+  if (IO::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) IO::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (IO::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("links", [](int x) { return x >= 2; }, true,
+      "the number of links must be at least 2");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be greater than 0");
+  RequireParamValue<int>("ef_search", [](int x) { return x >= 0; }, true,
+      "ef_search must not be negative");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "true_neighbors");
+
+  ReportIgnoredParam({{ "reference", false }}, "links");
+  ReportIgnoredParam({{ "reference", false }}, "ef_construction");
+  ReportIgnoredParam({{ "output_model", false }}, "reference_map_file");
+  ReportIgnoredParam({{ "output_model", false }}, "graph_map_file");
+
+  if (IO::HasParam("input_model") && !IO::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  const size_t k = (size_t) IO::GetParam<int>("k");
+
+  HNSWSearch<>* hnsw;
+  if (IO::HasParam("reference"))
+  {
+    hnsw = new HNSWSearch<>((size_t) IO::GetParam<int>("links"),
+        (size_t) IO::GetParam<int>("ef_construction"));
+    Log::Info << "Using reference data from "
+        << IO::GetPrintableParam<arma::mat>("reference") << "." << endl;
+
+    Timer::Start("graph_building");
+    hnsw->Train(std::move(IO::GetParam<arma::mat>("reference")));
+    Timer::Stop("graph_building");
+
+    Log::Info << "Built graph with " << hnsw->MaxLevel() + 1 << " levels."
+        << endl;
+  }
+  else // We must have an input model.
+  {
+    hnsw = IO::GetParam<HNSWSearch<>*>("input_model");
+  }
+
+  if (IO::GetParam<int>("ef_search") > 0)
+    hnsw->EfSearch() = (size_t) IO::GetParam<int>("ef_search");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  if (IO::HasParam("k"))
+  {
+    Log::Info << "Computing " << k << " approximate nearest neighbors." << endl;
+
+    Timer::Start("computing_neighbors");
+    if (IO::HasParam("query"))
+    {
+      Log::Info << "Loaded query data from "
+          << IO::GetPrintableParam<arma::mat>("query") << "." << endl;
+      hnsw->Search(IO::GetParam<arma::mat>("query"), k, neighbors, distances);
+    }
+    else
+    {
+      hnsw->Search(k, neighbors, distances);
+    }
+    Timer::Stop("computing_neighbors");
+
+    Log::Info << "Neighbors computed." << endl;
+
+    // Compute recall, if desired.
+    if (IO::HasParam("true_neighbors"))
+    {
+      const arma::Mat<size_t>& trueNeighbors =
+          IO::GetParam<arma::Mat<size_t>>("true_neighbors");
+      if (trueNeighbors.n_rows != neighbors.n_rows ||
+          trueNeighbors.n_cols != neighbors.n_cols)
+      {
+        // Delete the model if needed.
+        if (IO::HasParam("reference"))
+          delete hnsw;
+        Log::Fatal << "The true neighbors file must have the same number of "
+            << "values as the set of neighbors being queried!" << endl;
+      }
+
+      size_t found = 0;
+      for (size_t q = 0; q < neighbors.n_cols; ++q)
+        for (size_t i = 0; i < neighbors.n_rows; ++i)
+          for (size_t j = 0; j < neighbors.n_rows; ++j)
+            if (neighbors(i, q) == trueNeighbors(j, q))
+              ++found;
+
+      Log::Info << "Recall: " << 100.0 * found / neighbors.n_elem << endl;
+    }
+
+    IO::GetParam<arma::mat>("distances") = std::move(distances);
+    IO::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+
+  // Write the matrices to files that can be memory-mapped, if desired.
+  if (IO::HasParam("reference_map_file"))
+    hnsw->MapReferenceSet(IO::GetParam<std::string>("reference_map_file"));
+  if (IO::HasParam("graph_map_file"))
+    hnsw->MapGraph(IO::GetParam<std::string>("graph_map_file"));
+
+  IO::GetParam<HNSWSearch<>*>("output_model") = hnsw;
+}
@@ -0,0 +1,351 @@
+/**
+ * @file methods/hnsw/hnsw_search.hpp
+ *
+ * Approximate nearest neighbor search with hierarchical navigable small world
+ * (HNSW) graphs, as described in the following paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Y.A. and Yashunin, D.A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world graph on a
+ * reference set, and uses it to find the approximate nearest neighbors of query
+ * points.  Each reference point is a node of the graph, and is given a random
+ * level; on each level, the nodes of that level are linked to (about) their
+ * NumLinks() nearest neighbors of that level (2 * NumLinks() on level 0).  A
+ * search descends greedily from the top level to level 1, then does a beam
+ * search of width EfSearch() on level 0.
+ *
+ * The graph is built by inserting the points in batches that grow with the
+ * graph: the points of a batch search the graph built so far for their
+ * neighbors in parallel, and then the links of the graph are updated in
+ * parallel (each node is updated by one thread).  Because of this, the graph
+ * does not depend on the number of threads.
+ *
+ * Any metric can be used, for instance metric::IPMetric to search with a
+ * kernel-induced distance.  The reference set and the links of level 0 (which
+ * hold most of the memory of the model) can be memory-mapped from files; see
+ * MapReferenceSet() and MapGraph().
+ *
+ * @code
+ * HNSWSearch<> hnsw(referenceSet, 16, 200);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * hnsw.Search(querySet, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType Metric to use for the search.
+ * @tparam MatType Type of dense matrix to use to store the data.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the HNSWSearch object without a reference set.  Be sure to call
+   * Train() before calling Search().
+   *
+   * @param numLinks Number of links of each node on the levels above 0 (M).
+   * @param efConstruction Size of the beam when searching for the neighbors of
+   *     an inserted point.
+   * @param efSearch Size of the beam when searching for the neighbors of a
+   *     query point (at least k is used).
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(const size_t numLinks = 16,
+             const size_t efConstruction = 200,
+             const size_t efSearch = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create the HNSWSearch object and build the graph on the given reference
+   * set.  The reference set is taken by value; use std::move() to avoid a copy.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLinks Number of links of each node on the levels above 0 (M).
+   * @param efConstruction Size of the beam when searching for the neighbors of
+   *     an inserted point.
+   * @param efSearch Size of the beam when searching for the neighbors of a
+   *     query point (at least k is used).
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t numLinks = 16,
+             const size_t efConstruction = 200,
+             const size_t efSearch = 50,
+             const MetricType metric = MetricType());
+
+  //! Copy the given model; a memory-mapped reference set or graph is shared.
+  HNSWSearch(const HNSWSearch& other);
+  //! Take ownership of the given model.
+  HNSWSearch(HNSWSearch&& other);
+  //! Copy the given model; a memory-mapped reference set or graph is shared.
+  HNSWSearch& operator=(const HNSWSearch& other);
+  //! Take ownership of the given model.
+  HNSWSearch& operator=(HNSWSearch&& other);
+
+  /**
+   * Build the graph on the given reference set, with the current parameters.
+   * Any previous graph (and any memory mapping) is discarded.  The points are
+   * inserted in parallel, if OpenMP is available.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Search for the approximate k nearest neighbors of each point of the given
+   * query set.  The results are stored in the same format as NeighborSearch
+   * and LSHSearch: column i of neighbors and distances holds the neighbors of
+   * query point i, closest first.  If fewer than k points are found, the
+   * remaining neighbors are set to SIZE_MAX and their distances to DBL_MAX.
+   * The query points are searched in parallel, if OpenMP is available.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the neighbors in.
+   * @param distances Matrix to store the distances in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Search for the approximate k nearest neighbors of each point of the
+   * reference set (not counting the point itself).
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the neighbors in.
+   * @param distances Matrix to store the distances in.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Write the reference set to the given file and memory-map it from there.
+   * From then on the model is serialized without the reference set: only the
+   * name of the file is stored, and loading the model memory-maps the file
+   * again.  The file must not be modified or removed while a model uses it.
+   * Training the model again drops the mapping.
+   *
+   * @param filename File to write the reference set to.
+   */
+  void MapReferenceSet(const std::string& filename);
+
+  /**
+   * Write the links of level 0 to the given file and memory-map them from
+   * there, in the same way as MapReferenceSet().
+   *
+   * @param filename File to write the links to.
+   */
+  void MapGraph(const std::string& filename);
+
+  //! Get the file the reference set is memory-mapped from (empty if none).
+  const std::string& ReferenceMapFile() const { return referenceMapFile; }
+  //! Get the file the links of level 0 are memory-mapped from (empty if none).
+  const std::string& GraphMapFile() const { return graphMapFile; }
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links of each node on the levels above 0.
+  size_t NumLinks() const { return numLinks; }
+  //! Modify the number of links of each node on the levels above 0 (only used
+  //! by the next call to Train()).
+  size_t& NumLinks() { return numLinks; }
+
+  //! Get the size of the beam when inserting points.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Modify the size of the beam when inserting points (only used by the next
+  //! call to Train()).
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Get the size of the beam when searching.
+  size_t EfSearch() const { return efSearch; }
+  //! Modify the size of the beam when searching.
+  size_t& EfSearch() { return efSearch; }
+
+  //! Get the highest level of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+  //! Get the level of each node.
+  const std::vector<size_t>& Levels() const { return levels; }
+
+  /**
+   * Get the neighbors of the given node on the given level (which must be at
+   * most the level of the node).
+   *
+   * @param node Index of the node.
+   * @param level Level of the links.
+   */
+  std::vector<size_t> Links(const size_t node, const size_t level) const;
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A candidate neighbor: its distance and its index.
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * The nodes visited by a search; marking a node only writes the tag of the
+   * current search, so the list does not need to be cleared between searches.
+   */
+  struct VisitedList
+  {
+    VisitedList(const size_t size) : marks(size, 0), tag(0) { }
+
+    //! Start a new search.
+    void Clear()
+    {
+      if (++tag == 0)
+      {
+        std::fill(marks.begin(), marks.end(), 0);
+        tag = 1;
+      }
+    }
+
+    //! Mark the given node; return false if it was already visited.
+    bool Visit(const size_t node)
+    {
+      if (marks[node] == tag)
+        return false;
+      marks[node] = tag;
+      return true;
+    }
+
+    std::vector<unsigned int> marks;
+    unsigned int tag;
+  };
+
+  //! Get the maximum number of links of a node on the given level.
+  size_t MaxLinks(const size_t level) const
+  {
+    return (level == 0) ? 2 * numLinks : numLinks;
+  }
+
+  //! Get the links of the given node on the given level: the number of links,
+  //! followed by the links.
+  size_t* LinkList(const size_t node, const size_t level);
+  //! Get the links of the given node on the given level.
+  const size_t* LinkList(const size_t node, const size_t level) const;
+
+  /**
+   * Search the given level of the graph for the ef nearest nodes of the given
+   * point, starting from the given nodes.  The results are sorted by distance.
+   */
+  template<typename VecType>
+  void SearchLevel(const VecType& point,
+                   const std::vector<Candidate>& entryPoints,
+                   const size_t ef,
+                   const size_t level,
+                   VisitedList& visited,
+                   std::vector<Candidate>& results);
+
+  /**
+   * Search for the ef nearest nodes of the given point on level 0, descending
+   * from the entry point of the graph.
+   */
+  template<typename VecType>
+  void SearchGraph(const VecType& point,
+                   const size_t ef,
+                   VisitedList& visited,
+                   std::vector<Candidate>& results);
+
+  /**
+   * Select at most maxLinks of the given candidates (sorted by distance) with
+   * the heuristic of the paper: a candidate is kept only if it is closer to the
+   * base point than to every candidate kept before it, so that the links point
+   * in diverse directions.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxLinks,
+                       std::vector<size_t>& selected);
+
+  //! Insert the points [begin, end) into the graph of the points [0, begin).
+  void InsertBatch(const size_t begin, const size_t end);
+
+  //! Drop the memory mappings, giving the matrices memory of their own.
+  void Unmap();
+
+  //! The instantiated metric.
+  MetricType metric;
+  //! The reference set.
+  MatType referenceSet;
+
+  //! The number of links of each node on the levels above 0.
+  size_t numLinks;
+  //! The size of the beam when inserting points.
+  size_t efConstruction;
+  //! The size of the beam when searching.
+  size_t efSearch;
+
+  //! The node where searches start.
+  size_t entryPoint;
+  //! The highest level of the graph.
+  size_t maxLevel;
+  //! The level of each node.
+  std::vector<size_t> levels;
+  //! The links of level 0: one column per node, holding the number of links
+  //! and then the links.
+  arma::Mat<size_t> baseLinks;
+  //! The offset of the links of each node on the levels above 0 in upperLinks.
+  std::vector<size_t> upperOffsets;
+  //! The links of the levels above 0: for each node, NumLinks() + 1 values per
+  //! level (the number of links and then the links).
+  std::vector<size_t> upperLinks;
+
+  //! The file the reference set is memory-mapped from (empty if none).
+  std::string referenceMapFile;
+  //! The memory-mapped reference set, if any; copies of the model share it.
+  std::shared_ptr<data::MappedMatrix<ElemType>> mappedReferenceSet;
+  //! The file the links of level 0 are memory-mapped from (empty if none).
+  std::string graphMapFile;
+  //! The memory-mapped links of level 0, if any; copies of the model share
+  //! them.
+  std::shared_ptr<data::MappedMatrix<size_t>> mappedGraph;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
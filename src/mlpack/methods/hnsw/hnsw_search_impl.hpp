@@ -0,0 +1,730 @@
+/**
+ * @file methods/hnsw/hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <queue>
+#include <algorithm>
+#include <boost/serialization/string.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+// Constructor with no reference set.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t numLinks,
+                                            const size_t efConstruction,
+                                            const size_t efSearch,
+                                            const MetricType metric) :
+    metric(metric),
+    numLinks(numLinks),
+    efConstruction(efConstruction),
+    efSearch(efSearch),
+    entryPoint(0),
+    maxLevel(0)
+{
+  // Nothing to do.
+}
+
+// Constructor.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSet,
+                                            const size_t numLinks,
+                                            const size_t efConstruction,
+                                            const size_t efSearch,
+                                            const MetricType metric) :
+    metric(metric),
+    numLinks(numLinks),
+    efConstruction(efConstruction),
+    efSearch(efSearch),
+    entryPoint(0),
+    maxLevel(0)
+{
+  Train(std::move(referenceSet));
+}
+
+// Copy constructor.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const HNSWSearch& other) :
+    metric(other.metric),
+    referenceSet(other.mappedReferenceSet ? MatType() : other.referenceSet),
+    numLinks(other.numLinks),
+    efConstruction(other.efConstruction),
+    efSearch(other.efSearch),
+    entryPoint(other.entryPoint),
+    maxLevel(other.maxLevel),
+    levels(other.levels),
+    baseLinks(other.mappedGraph ? arma::Mat<size_t>() : other.baseLinks),
+    upperOffsets(other.upperOffsets),
+    upperLinks(other.upperLinks),
+    referenceMapFile(other.referenceMapFile),
+    mappedReferenceSet(other.mappedReferenceSet),
+    graphMapFile(other.graphMapFile),
+    mappedGraph(other.mappedGraph)
+{
+  // Share the mapped matrices instead of keeping a copy of them.
+  if (mappedReferenceSet)
+    mappedReferenceSet->Alias(referenceSet);
+  if (mappedGraph)
+    mappedGraph->Alias(baseLinks);
+}
+
+// Move constructor.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(HNSWSearch&& other) :
+    metric(std::move(other.metric)),
+    referenceSet(std::move(other.referenceSet)),
+    numLinks(other.numLinks),
+    efConstruction(other.efConstruction),
+    efSearch(other.efSearch),
+    entryPoint(other.entryPoint),
+    maxLevel(other.maxLevel),
+    levels(std::move(other.levels)),
+    baseLinks(std::move(other.baseLinks)),
+    upperOffsets(std::move(other.upperOffsets)),
+    upperLinks(std::move(other.upperLinks)),
+    referenceMapFile(std::move(other.referenceMapFile)),
+    mappedReferenceSet(std::move(other.mappedReferenceSet)),
+    graphMapFile(std::move(other.graphMapFile)),
+    mappedGraph(std::move(other.mappedGraph))
+{
+  // Armadillo may copy an alias instead of moving it.
+  if (mappedReferenceSet)
+  {
+    mappedReferenceSet->Alias(referenceSet);
+    data::MappedMatrix<ElemType>::Unalias(other.referenceSet);
+  }
+  if (mappedGraph)
+  {
+    mappedGraph->Alias(baseLinks);
+    data::MappedMatrix<size_t>::Unalias(other.baseLinks);
+  }
+  other.referenceMapFile.clear();
+  other.graphMapFile.clear();
+
+  // Reset the other model to defaults.
+  other.numLinks = 16;
+  other.efConstruction = 200;
+  other.efSearch = 50;
+  other.entryPoint = 0;
+  other.maxLevel = 0;
+}
+
+// Copy operator.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>& HNSWSearch<MetricType, MatType>::operator=(
+    const HNSWSearch& other)
+{
+  if (this == &other)
+    return *this;
+
+  // A mapped matrix cannot be resized, so drop the mappings first.
+  Unmap();
+
+  metric = other.metric;
+  numLinks = other.numLinks;
+  efConstruction = other.efConstruction;
+  efSearch = other.efSearch;
+  entryPoint = other.entryPoint;
+  maxLevel = other.maxLevel;
+  levels = other.levels;
+  upperOffsets = other.upperOffsets;
+  upperLinks = other.upperLinks;
+
+  // Share the mapped matrices instead of keeping a copy of them.
+  if (other.mappedReferenceSet)
+  {
+    referenceMapFile = other.referenceMapFile;
+    mappedReferenceSet = other.mappedReferenceSet;
+    mappedReferenceSet->Alias(referenceSet);
+  }
+  else
+  {
+    referenceSet = other.referenceSet;
+  }
+
+  if (other.mappedGraph)
+  {
+    graphMapFile = other.graphMapFile;
+    mappedGraph = other.mappedGraph;
+    mappedGraph->Alias(baseLinks);
+  }
+  else
+  {
+    baseLinks = other.baseLinks;
+  }
+
+  return *this;
+}
+
+// Move operator.
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>& HNSWSearch<MetricType, MatType>::operator=(
+    HNSWSearch&& other)
+{
+  if (this == &other)
+    return *this;
+
+  // A mapped matrix cannot be resized, so drop the mappings first.
+  Unmap();
+
+  metric = std::move(other.metric);
+  numLinks = other.numLinks;
+  efConstruction = other.efConstruction;
+  efSearch = other.efSearch;
+  entryPoint = other.entryPoint;
+  maxLevel = other.maxLevel;
+  levels = std::move(other.levels);
+  upperOffsets = std::move(other.upperOffsets);
+  upperLinks = std::move(other.upperLinks);
+
+  if (other.mappedReferenceSet)
+  {
+    referenceMapFile = std::move(other.referenceMapFile);
+    mappedReferenceSet = std::move(other.mappedReferenceSet);
+    mappedReferenceSet->Alias(referenceSet);
+    data::MappedMatrix<ElemType>::Unalias(other.referenceSet);
+    other.referenceMapFile.clear();
+  }
+  else
+  {
+    referenceSet = std::move(other.referenceSet);
+  }
+
+  if (other.mappedGraph)
+  {
+    graphMapFile = std::move(other.graphMapFile);
+    mappedGraph = std::move(other.mappedGraph);
+    mappedGraph->Alias(baseLinks);
+    data::MappedMatrix<size_t>::Unalias(other.baseLinks);
+    other.graphMapFile.clear();
+  }
+  else
+  {
+    baseLinks = std::move(other.baseLinks);
+  }
+
+  // Reset the other model to defaults.
+  other.numLinks = 16;
+  other.efConstruction = 200;
+  other.efSearch = 50;
+  other.entryPoint = 0;
+  other.maxLevel = 0;
+
+  return *this;
+}
+
+// Build the graph.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  if (numLinks < 2)
+    throw std::invalid_argument("HNSWSearch::Train(): the number of links must "
+        "be at least 2!");
+  if (efConstruction == 0)
+    throw std::invalid_argument("HNSWSearch::Train(): efConstruction must be "
+        "greater than 0!");
+
+  Unmap();
+  referenceSet = std::move(referenceSetIn);
+  const size_t n = referenceSet.n_cols;
+
+  // Draw the level of each node from an exponential distribution, so that
+  // each level holds about 1 / numLinks of the nodes of the level below.
+  const double levelMultiplier = 1.0 / std::log((double) numLinks);
+  levels.resize(n);
+  upperOffsets.resize(n + 1);
+  upperOffsets[0] = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    levels[i] = (size_t) std::floor(-std::log(1.0 - math::Random()) *
+        levelMultiplier);
+    upperOffsets[i + 1] = upperOffsets[i] + levels[i] * (numLinks + 1);
+  }
+
+  upperLinks.assign(upperOffsets[n], 0);
+  baseLinks.zeros(2 * numLinks + 1, n);
+  entryPoint = 0;
+  maxLevel = (n > 0) ? levels[0] : 0;
+
+  // Insert the points in batches of at most an eighth of the graph built so
+  // far; the points of a batch are not linked to each other directly, but the
+  // batches are small enough that this barely changes the graph.
+  size_t inserted = std::min(n, (size_t) 1);
+  while (inserted < n)
+  {
+    const size_t batchSize = std::min(n - inserted,
+        std::max((size_t) 1, inserted / 8));
+    InsertBatch(inserted, inserted + batchSize);
+    inserted += batchSize;
+  }
+}
+
+// Search for the neighbors of the given query points.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (referenceSet.n_cols == 0)
+    throw std::runtime_error("HNSWSearch::Search(): graph not built!  Call "
+        "Train() first.");
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(DBL_MAX);
+
+  const size_t ef = std::max(efSearch, k);
+  #pragma omp parallel
+  {
+    VisitedList visited(referenceSet.n_cols);
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      SearchGraph(querySet.col(q), ef, visited, results);
+      for (size_t i = 0; i < std::min(k, results.size()); ++i)
+      {
+        neighbors(i, q) = results[i].second;
+        distances(i, q) = results[i].first;
+      }
+    }
+  }
+}
+
+// Search for the neighbors of the reference points.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (referenceSet.n_cols == 0)
+    throw std::runtime_error("HNSWSearch::Search(): graph not built!  Call "
+        "Train() first.");
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, referenceSet.n_cols);
+  distances.fill(DBL_MAX);
+
+  // One more neighbor is searched for, since the point itself is found too.
+  const size_t ef = std::max(efSearch, k + 1);
+  #pragma omp parallel
+  {
+    VisitedList visited(referenceSet.n_cols);
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t q = 0; q < (omp_size_t) referenceSet.n_cols; ++q)
+    {
+      SearchGraph(referenceSet.col(q), ef, visited, results);
+      size_t found = 0;
+      for (size_t i = 0; (i < results.size()) && (found < k); ++i)
+      {
+        if (results[i].second == (size_t) q)
+          continue;
+
+        neighbors(found, q) = results[i].second;
+        distances(found, q) = results[i].first;
+        ++found;
+      }
+    }
+  }
+}
+
+// Write the reference set to the given file and memory-map it.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::MapReferenceSet(
+    const std::string& filename)
+{
+  // Rewriting a file that is already mapped would corrupt the mapping.
+  if (filename == referenceMapFile)
+    return;
+
+  data::MappedMatrix<ElemType>::Save(filename, referenceSet);
+
+  std::shared_ptr<data::MappedMatrix<ElemType>> mapped =
+      std::make_shared<data::MappedMatrix<ElemType>>(filename);
+  mapped->Alias(referenceSet);
+
+  mappedReferenceSet = mapped;
+  referenceMapFile = filename;
+}
+
+// Write the links of level 0 to the given file and memory-map them.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::MapGraph(const std::string& filename)
+{
+  // Rewriting a file that is already mapped would corrupt the mapping.
+  if (filename == graphMapFile)
+    return;
+
+  data::MappedMatrix<size_t>::Save(filename, baseLinks);
+
+  std::shared_ptr<data::MappedMatrix<size_t>> mapped =
+      std::make_shared<data::MappedMatrix<size_t>>(filename);
+  mapped->Alias(baseLinks);
+
+  mappedGraph = mapped;
+  graphMapFile = filename;
+}
+
+// Get the links of a node.
+template<typename MetricType, typename MatType>
+std::vector<size_t> HNSWSearch<MetricType, MatType>::Links(
+    const size_t node,
+    const size_t level) const
+{
+  if (node >= levels.size() || level > levels[node])
+    throw std::invalid_argument("HNSWSearch::Links(): invalid node or level!");
+
+  const size_t* list = LinkList(node, level);
+  return std::vector<size_t>(list + 1, list + 1 + list[0]);
+}
+
+template<typename MetricType, typename MatType>
+size_t* HNSWSearch<MetricType, MatType>::LinkList(const size_t node,
+                                                  const size_t level)
+{
+  if (level == 0)
+    return baseLinks.colptr(node);
+
+  // Use the number of links the graph was built with, which is given by the
+  // shape of baseLinks.
+  const size_t stride = (baseLinks.n_rows - 1) / 2 + 1;
+  return upperLinks.data() + upperOffsets[node] + (level - 1) * stride;
+}
+
+template<typename MetricType, typename MatType>
+const size_t* HNSWSearch<MetricType, MatType>::LinkList(
+    const size_t node,
+    const size_t level) const
+{
+  if (level == 0)
+    return baseLinks.colptr(node);
+
+  const size_t stride = (baseLinks.n_rows - 1) / 2 + 1;
+  return upperLinks.data() + upperOffsets[node] + (level - 1) * stride;
+}
+
+// Beam search on one level of the graph.
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLevel(
+    const VecType& point,
+    const std::vector<Candidate>& entryPoints,
+    const size_t ef,
+    const size_t level,
+    VisitedList& visited,
+    std::vector<Candidate>& results)
+{
+  visited.Clear();
+
+  // The candidates to expand, closest first, and the ef best nodes found so
+  // far, furthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> candidates;
+  std::priority_queue<Candidate> best;
+  for (size_t i = 0; i < entryPoints.size(); ++i)
+  {
+    visited.Visit(entryPoints[i].second);
+    candidates.push(entryPoints[i]);
+    best.push(entryPoints[i]);
+    if (best.size() > ef)
+      best.pop();
+  }
+
+  while (!candidates.empty())
+  {
+    const Candidate current = candidates.top();
+    if (current.first > best.top().first)
+      break;
+    candidates.pop();
+
+    const size_t* list = LinkList(current.second, level);
+    for (size_t j = 1; j <= list[0]; ++j)
+    {
+      const size_t node = list[j];
+      if (!visited.Visit(node))
+        continue;
+
+      const double distance = metric.Evaluate(point, referenceSet.col(node));
+      if (best.size() < ef || distance < best.top().first)
+      {
+        candidates.push(Candidate(distance, node));
+        best.push(Candidate(distance, node));
+        if (best.size() > ef)
+          best.pop();
+      }
+    }
+  }
+
+  results.resize(best.size());
+  for (size_t i = best.size(); i > 0; --i)
+  {
+    results[i - 1] = best.top();
+    best.pop();
+  }
+}
+
+// Search the whole graph.
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchGraph(
+    const VecType& point,
+    const size_t ef,
+    VisitedList& visited,
+    std::vector<Candidate>& results)
+{
+  std::vector<Candidate> entryPoints(1, Candidate(metric.Evaluate(point,
+      referenceSet.col(entryPoint)), entryPoint));
+
+  // Descend greedily to level 1, then search level 0 with the full beam.
+  for (size_t level = maxLevel; level > 0; --level)
+  {
+    SearchLevel(point, entryPoints, 1, level, visited, results);
+    entryPoints.assign(1, results[0]);
+  }
+
+  SearchLevel(point, entryPoints, ef, 0, visited, results);
+}
+
+// Select the neighbors of a node among the given candidates.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxLinks,
+    std::vector<size_t>& selected)
+{
+  selected.clear();
+  for (size_t i = 0; (i < candidates.size()) && (selected.size() < maxLinks);
+      ++i)
+  {
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      if (metric.Evaluate(referenceSet.col(candidates[i].second),
+          referenceSet.col(selected[j])) < candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidates[i].second);
+  }
+}
+
+// Insert a batch of points.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::InsertBatch(const size_t begin,
+                                                  const size_t end)
+{
+  const size_t topLevel = maxLevel;
+  const size_t start = entryPoint;
+
+  // First, find the neighbors of each new point on each of its levels in the
+  // graph built so far; the graph is only read here.
+  std::vector<std::vector<std::vector<size_t>>> selected(end - begin);
+  #pragma omp parallel
+  {
+    VisitedList visited(begin);
+    std::vector<Candidate> entryPoints, results;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+    {
+      entryPoints.assign(1, Candidate(metric.Evaluate(referenceSet.col(i),
+          referenceSet.col(start)), start));
+      for (size_t level = topLevel; level > levels[i]; --level)
+      {
+        SearchLevel(referenceSet.col(i), entryPoints, 1, level, visited,
+            results);
+        entryPoints.assign(1, results[0]);
+      }
+
+      std::vector<std::vector<size_t>>& nodeLinks = selected[i - begin];
+      nodeLinks.resize(std::min((size_t) levels[i], topLevel) + 1);
+      for (size_t level = nodeLinks.size(); level-- > 0; )
+      {
+        SearchLevel(referenceSet.col(i), entryPoints, efConstruction, level,
+            visited, results);
+        SelectNeighbors(results, numLinks, nodeLinks[level]);
+        entryPoints.swap(results);
+      }
+    }
+  }
+
+  // Link the new points to their neighbors, and collect the links back, as
+  // ((level, neighbor), new point).
+  typedef std::pair<std::pair<size_t, size_t>, size_t> Edge;
+  std::vector<Edge> reverseEdges;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const std::vector<std::vector<size_t>>& nodeLinks = selected[i - begin];
+    for (size_t level = 0; level < nodeLinks.size(); ++level)
+    {
+      size_t* list = LinkList(i, level);
+      list[0] = nodeLinks[level].size();
+      for (size_t j = 0; j < nodeLinks[level].size(); ++j)
+      {
+        list[j + 1] = nodeLinks[level][j];
+        reverseEdges.push_back(Edge(std::make_pair(level, nodeLinks[level][j]),
+            i));
+      }
+    }
+  }
+
+  // Then add the links back to the existing nodes.  Each node (on each level)
+  // is updated by a single thread; when a node has too many links, its
+  // neighbors are selected again among the old and the new ones.
+  std::sort(reverseEdges.begin(), reverseEdges.end());
+  std::vector<size_t> groups;
+  for (size_t e = 0; e < reverseEdges.size(); ++e)
+    if (e == 0 || reverseEdges[e].first != reverseEdges[e - 1].first)
+      groups.push_back(e);
+  groups.push_back(reverseEdges.size());
+
+  #pragma omp parallel
+  {
+    std::vector<Candidate> candidates;
+    std::vector<size_t> kept;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t g = 0; g < (omp_size_t) groups.size() - 1; ++g)
+    {
+      const size_t level = reverseEdges[groups[g]].first.first;
+      const size_t node = reverseEdges[groups[g]].first.second;
+      const size_t maxLinks = (level == 0) ? 2 * numLinks : numLinks;
+      size_t* list = LinkList(node, level);
+
+      if (list[0] + (groups[g + 1] - groups[g]) <= maxLinks)
+      {
+        for (size_t e = groups[g]; e < groups[g + 1]; ++e)
+          list[++list[0]] = reverseEdges[e].second;
+        continue;
+      }
+
+      candidates.clear();
+      for (size_t j = 1; j <= list[0]; ++j)
+      {
+        candidates.push_back(Candidate(metric.Evaluate(referenceSet.col(node),
+            referenceSet.col(list[j])), list[j]));
+      }
+      for (size_t e = groups[g]; e < groups[g + 1]; ++e)
+      {
+        const size_t other = reverseEdges[e].second;
+        candidates.push_back(Candidate(metric.Evaluate(referenceSet.col(node),
+            referenceSet.col(other)), other));
+      }
+      std::sort(candidates.begin(), candidates.end());
+
+      SelectNeighbors(candidates, maxLinks, kept);
+      list[0] = kept.size();
+      std::copy(kept.begin(), kept.end(), list + 1);
+    }
+  }
+
+  // The highest new node becomes the entry point.
+  for (size_t i = begin; i < end; ++i)
+  {
+    if (levels[i] > maxLevel)
+    {
+      maxLevel = levels[i];
+      entryPoint = i;
+    }
+  }
+}
+
+// Drop the memory mappings.
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Unmap()
+{
+  if (mappedReferenceSet)
+  {
+    data::MappedMatrix<ElemType>::Unalias(referenceSet);
+    mappedReferenceSet.reset();
+    referenceMapFile.clear();
+  }
+
+  if (mappedGraph)
+  {
+    data::MappedMatrix<size_t>::Unalias(baseLinks);
+    mappedGraph.reset();
+    graphMapFile.clear();
+  }
+}
+
+//! Serialize the model.
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(numLinks);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(efSearch);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+  ar & BOOST_SERIALIZATION_NVP(levels);
+  ar & BOOST_SERIALIZATION_NVP(upperOffsets);
+  ar & BOOST_SERIALIZATION_NVP(upperLinks);
+
+  // Any mapped matrices are replaced by the loaded ones.
+  if (Archive::is_loading::value)
+    Unmap();
+
+  // If a matrix is memory-mapped, only the name of its file is stored.
+  ar & BOOST_SERIALIZATION_NVP(referenceMapFile);
+  if (referenceMapFile.empty())
+  {
+    ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  }
+  else if (Archive::is_loading::value)
+  {
+    mappedReferenceSet = std::make_shared<data::MappedMatrix<ElemType>>(
+        referenceMapFile);
+    mappedReferenceSet->Alias(referenceSet);
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(graphMapFile);
+  if (graphMapFile.empty())
+  {
+    ar & BOOST_SERIALIZATION_NVP(baseLinks);
+  }
+  else if (Archive::is_loading::value)
+  {
+    mappedGraph = std::make_shared<data::MappedMatrix<size_t>>(graphMapFile);
+    mappedGraph->Alias(baseLinks);
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
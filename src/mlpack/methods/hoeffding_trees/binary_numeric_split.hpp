@@ -101,6 +101,21 @@ class BinaryNumericSplit
    */
   void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo);
 
+  /**
+   * Add the points seen by the given split, which must be for the same number
+   * of classes, to the points of this split, as if this split had also been
+   * trained on them.
+   *
+   * @param other Split to merge into this one.
+   */
+  void Merge(const BinaryNumericSplit& other);
+
+  /**
+   * Forget the points seen so far, so that this split can collect statistics
+   * that will be merged into another split.
+   */
+  void Reset();
+
   //! The majority class of the points seen so far.
   size_t MajorityClass() const;
   //! The probability of the majority class given the points seen so far.
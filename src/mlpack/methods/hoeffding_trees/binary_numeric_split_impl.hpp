@@ -152,6 +152,33 @@ void BinaryNumericSplit<FitnessFunction, ObservationType>::Split(
   splitInfo = SplitInfo(bestSplit);
 }
 
+template<typename FitnessFunction, typename ObservationType>
+void BinaryNumericSplit<FitnessFunction, ObservationType>::Merge(
+    const BinaryNumericSplit& other)
+{
+  if (other.classCounts.n_elem != classCounts.n_elem)
+  {
+    throw std::invalid_argument("BinaryNumericSplit::Merge(): the splits must "
+        "have the same number of classes!");
+  }
+
+  sortedElements.insert(other.sortedElements.begin(),
+      other.sortedElements.end());
+  classCounts += other.classCounts;
+
+  // Whatever we have cached is no longer valid.
+  isAccurate = false;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void BinaryNumericSplit<FitnessFunction, ObservationType>::Reset()
+{
+  sortedElements.clear();
+  classCounts.zeros();
+  bestSplit = std::numeric_limits<ObservationType>::min();
+  isAccurate = true;
+}
+
 template<typename FitnessFunction, typename ObservationType>
 size_t BinaryNumericSplit<FitnessFunction, ObservationType>::MajorityClass()
     const
@@ -101,6 +101,22 @@ class HoeffdingCategoricalSplit
    */
   void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo);
 
+  /**
+   * Add the statistics of the given split, which must be for the same
+   * dimension and the same number of classes, to the statistics of this split,
+   * as if this split had also been trained on the points the other split was
+   * trained on.
+   *
+   * @param other Split to merge into this one.
+   */
+  void Merge(const HoeffdingCategoricalSplit& other);
+
+  /**
+   * Forget the points seen so far, so that this split can collect statistics
+   * that will be merged into another split.
+   */
+  void Reset() { sufficientStatistics.zeros(); }
+
   //! Get the majority class seen so far.
   size_t MajorityClass() const;
   //! Get the probability of the majority class given the points seen so far.
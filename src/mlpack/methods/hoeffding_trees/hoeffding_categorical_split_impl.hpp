@@ -74,6 +74,21 @@ void HoeffdingCategoricalSplit<FitnessFunction>::Split(
   splitInfo = SplitInfo(sufficientStatistics.n_cols);
 }
 
+template<typename FitnessFunction>
+void HoeffdingCategoricalSplit<FitnessFunction>::Merge(
+    const HoeffdingCategoricalSplit& other)
+{
+  if (other.sufficientStatistics.n_rows != sufficientStatistics.n_rows ||
+      other.sufficientStatistics.n_cols != sufficientStatistics.n_cols)
+  {
+    throw std::invalid_argument("HoeffdingCategoricalSplit::Merge(): the "
+        "splits must have the same number of categories and classes!");
+  }
+
+  // The counts of the two splits simply add up.
+  sufficientStatistics += other.sufficientStatistics;
+}
+
 template<typename FitnessFunction>
 size_t HoeffdingCategoricalSplit<FitnessFunction>::MajorityClass() const
 {
@@ -0,0 +1,264 @@
+/**
+ * @file methods/hoeffding_trees/hoeffding_forest.hpp
+ *
+ * An ensemble of Hoeffding trees trained with online bagging, for streaming
+ * classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hoeffding_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HoeffdingForest is an ensemble of Hoeffding trees that is trained on a
+ * stream of points with online bagging:
+ *
+ * @code
+ * @inproceedings{oza2001online,
+ *     title={{Online Bagging and Boosting}},
+ *     author={Oza, N.C. and Russell, S.},
+ *     year={2001},
+ *     booktitle={Proceedings of the Eighth International Workshop on
+ *         Artificial Intelligence and Statistics (AISTATS '01)},
+ *     pages={105--112}
+ * }
+ * @endcode
+ *
+ * Each point of the stream is given to each tree k times, where k is drawn
+ * from a Poisson(lambda) distribution independently for each tree; with
+ * lambda = 1, this is the streaming equivalent of training each tree on a
+ * bootstrap sample, and larger values of lambda (as in leveraging bagging)
+ * make the trees learn faster.  Since the trees are independent, each batch of
+ * points given to Train() is processed by all the trees in parallel (if OpenMP
+ * is available).  The random weights of each tree are drawn from their own
+ * random stream, whose seed is drawn from math::randGen at each call of
+ * Train(), so the forest does not depend on the number of threads.
+ *
+ * Points are classified by a majority vote of the trees.
+ *
+ * @code
+ * HoeffdingForest<> forest(info, numClasses, 20);
+ * while (...)
+ * {
+ *   // Get the next batch of points and train on it.
+ *   forest.Train(batch, batchLabels);
+ * }
+ *
+ * arma::Row<size_t> predictions;
+ * forest.Classify(testData, predictions);
+ * @endcode
+ *
+ * @tparam TreeType The type of the trees (a HoeffdingTree).
+ */
+template<typename TreeType = HoeffdingTree<>>
+class HoeffdingForest
+{
+ public:
+  /**
+   * Create a forest of untrained trees with the given parameters.
+   *
+   * @param datasetInfo Information on the dataset (types of each feature).
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bounds before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced (0
+   *      never forces a split).
+   * @param checkInterval Number of samples required before each split check.
+   * @param minSamples If a node has seen this many points or fewer, no split
+   *      will be allowed.
+   * @param lambda Mean of the Poisson distribution of the number of times each
+   *      tree is trained on each point (must be positive).
+   */
+  HoeffdingForest(const data::DatasetInfo& datasetInfo,
+                  const size_t numClasses,
+                  const size_t numTrees = 10,
+                  const double successProbability = 0.95,
+                  const size_t maxSamples = 0,
+                  const size_t checkInterval = 100,
+                  const size_t minSamples = 100,
+                  const double lambda = 1.0);
+
+  /**
+   * Create a forest of trees with the given parameters, and train it on the
+   * given points in streaming mode.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Information on the dataset (types of each feature).
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bounds before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced (0
+   *      never forces a split).
+   * @param checkInterval Number of samples required before each split check.
+   * @param minSamples If a node has seen this many points or fewer, no split
+   *      will be allowed.
+   * @param lambda Mean of the Poisson distribution of the number of times each
+   *      tree is trained on each point (must be positive).
+   */
+  template<typename MatType>
+  HoeffdingForest(const MatType& data,
+                  const data::DatasetInfo& datasetInfo,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const size_t numTrees = 10,
+                  const double successProbability = 0.95,
+                  const size_t maxSamples = 0,
+                  const size_t checkInterval = 100,
+                  const size_t minSamples = 100,
+                  const double lambda = 1.0);
+
+  /**
+   * Create an empty forest.  Be sure to load it before using it.
+   */
+  HoeffdingForest();
+
+  /**
+   * Copy the given forest (and all of its trees).
+   *
+   * @param other Forest to copy.
+   */
+  HoeffdingForest(const HoeffdingForest& other);
+
+  /**
+   * Take ownership of the trees of the given forest.
+   *
+   * @param other Forest to move.
+   */
+  HoeffdingForest(HoeffdingForest&& other);
+
+  /**
+   * Copy the given forest (and all of its trees).
+   *
+   * @param other Forest to copy.
+   */
+  HoeffdingForest& operator=(const HoeffdingForest& other);
+
+  /**
+   * Take ownership of the trees of the given forest.
+   *
+   * @param other Forest to move.
+   */
+  HoeffdingForest& operator=(HoeffdingForest&& other);
+
+  /**
+   * Clean up memory.
+   */
+  ~HoeffdingForest();
+
+  /**
+   * Train the forest on the given batch of points of the stream: each tree is
+   * trained in streaming mode on each point a Poisson(lambda) number of times.
+   * The trees are trained in parallel.
+   *
+   * @param data Points to train on.
+   * @param labels Labels of the points.
+   */
+  template<typename MatType>
+  void Train(const MatType& data, const arma::Row<size_t>& labels);
+
+  /**
+   * Train the forest on a single point of the stream.  To use several threads,
+   * give batches of points to Train(data, labels) instead.
+   *
+   * @param point Point to train on.
+   * @param label Label of the point.
+   */
+  template<typename VecType>
+  void Train(const VecType& point, const size_t label);
+
+  /**
+   * Classify the given point by a majority vote of the trees.
+   *
+   * @param point Point to classify.
+   * @return Predicted label of the point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point by a majority vote of the trees, and also return
+   * the fraction of the trees that voted for the prediction.
+   *
+   * @param point Point to classify.
+   * @param prediction Predicted label of the point.
+   * @param probability Fraction of the trees that predict that label.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                double& probability) const;
+
+  /**
+   * Classify the given points by a majority vote of the trees.  The points are
+   * classified in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted label of each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points by a majority vote of the trees, and also return
+   * the fraction of the trees that voted for each prediction.  The points are
+   * classified in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted label of each point.
+   * @param probabilities Fraction of the trees that predict each label.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::rowvec& probabilities) const;
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return trees.size(); }
+
+  //! Get a tree of the forest.
+  const TreeType& Tree(const size_t i) const { return *trees[i]; }
+  //! Modify a tree of the forest.
+  TreeType& Tree(const size_t i) { return *trees[i]; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the mean of the Poisson weights of the points.
+  double Lambda() const { return lambda; }
+  //! Modify the mean of the Poisson weights of the points.
+  double& Lambda() { return lambda; }
+
+  //! Serialize the forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Delete all the trees.
+  void Clear();
+
+  //! The trees of the forest.
+  std::vector<TreeType*> trees;
+  //! The number of classes.
+  size_t numClasses;
+  //! The mean of the Poisson weights of the points.
+  double lambda;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#include "hoeffding_forest_impl.hpp"
+
+#endif
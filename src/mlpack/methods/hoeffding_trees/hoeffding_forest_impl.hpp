@@ -0,0 +1,264 @@
+/**
+ * @file methods/hoeffding_trees/hoeffding_forest_impl.hpp
+ *
+ * Implementation of the HoeffdingForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hoeffding_forest.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/math/philox.hpp>
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::HoeffdingForest(
+    const data::DatasetInfo& datasetInfo,
+    const size_t numClasses,
+    const size_t numTrees,
+    const double successProbability,
+    const size_t maxSamples,
+    const size_t checkInterval,
+    const size_t minSamples,
+    const double lambda) :
+    numClasses(numClasses),
+    lambda(lambda)
+{
+  trees.reserve(numTrees);
+  for (size_t i = 0; i < numTrees; ++i)
+  {
+    trees.push_back(new TreeType(datasetInfo, numClasses, successProbability,
+        maxSamples, checkInterval, minSamples));
+  }
+}
+
+template<typename TreeType>
+template<typename MatType>
+HoeffdingForest<TreeType>::HoeffdingForest(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numTrees,
+    const double successProbability,
+    const size_t maxSamples,
+    const size_t checkInterval,
+    const size_t minSamples,
+    const double lambda) :
+    HoeffdingForest(datasetInfo, numClasses, numTrees, successProbability,
+        maxSamples, checkInterval, minSamples, lambda)
+{
+  Train(data, labels);
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::HoeffdingForest() :
+    numClasses(0),
+    lambda(1.0)
+{
+  // Nothing to do.
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::HoeffdingForest(const HoeffdingForest& other) :
+    numClasses(other.numClasses),
+    lambda(other.lambda)
+{
+  trees.reserve(other.trees.size());
+  for (size_t i = 0; i < other.trees.size(); ++i)
+    trees.push_back(new TreeType(*other.trees[i]));
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::HoeffdingForest(HoeffdingForest&& other) :
+    trees(std::move(other.trees)),
+    numClasses(other.numClasses),
+    lambda(other.lambda)
+{
+  other.trees.clear();
+  other.numClasses = 0;
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>& HoeffdingForest<TreeType>::operator=(
+    const HoeffdingForest& other)
+{
+  if (this != &other)
+  {
+    Clear();
+
+    numClasses = other.numClasses;
+    lambda = other.lambda;
+    trees.reserve(other.trees.size());
+    for (size_t i = 0; i < other.trees.size(); ++i)
+      trees.push_back(new TreeType(*other.trees[i]));
+  }
+
+  return *this;
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>& HoeffdingForest<TreeType>::operator=(
+    HoeffdingForest&& other)
+{
+  if (this != &other)
+  {
+    Clear();
+
+    trees = std::move(other.trees);
+    numClasses = other.numClasses;
+    lambda = other.lambda;
+
+    other.trees.clear();
+    other.numClasses = 0;
+  }
+
+  return *this;
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::~HoeffdingForest()
+{
+  Clear();
+}
+
+template<typename TreeType>
+template<typename MatType>
+void HoeffdingForest<TreeType>::Train(const MatType& data,
+                                      const arma::Row<size_t>& labels)
+{
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingForest::Train(): " << data.n_cols << " points were given, "
+        << "but there are " << labels.n_elem << " labels";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Each tree draws its weights from its own stream, so the result does not
+  // depend on the number of threads or on the order the trees are trained in.
+  const uint64_t seed = ((uint64_t) math::randGen() << 32) | math::randGen();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) trees.size(); ++t)
+  {
+    math::Philox generator(seed, (uint64_t) t);
+    std::poisson_distribution<size_t> weightDist(lambda);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t weight = weightDist(generator);
+      for (size_t k = 0; k < weight; ++k)
+        trees[t]->Train(data.col(i), labels[i]);
+    }
+  }
+}
+
+template<typename TreeType>
+template<typename VecType>
+void HoeffdingForest<TreeType>::Train(const VecType& point, const size_t label)
+{
+  std::poisson_distribution<size_t> weightDist(lambda);
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    const size_t weight = weightDist(math::randGen);
+    for (size_t k = 0; k < weight; ++k)
+      trees[t]->Train(point, label);
+  }
+}
+
+template<typename TreeType>
+template<typename VecType>
+size_t HoeffdingForest<TreeType>::Classify(const VecType& point) const
+{
+  size_t prediction;
+  double probability;
+  Classify(point, prediction, probability);
+  return prediction;
+}
+
+template<typename TreeType>
+template<typename VecType>
+void HoeffdingForest<TreeType>::Classify(const VecType& point,
+                                         size_t& prediction,
+                                         double& probability) const
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("HoeffdingForest::Classify(): the forest has "
+        "no trees!");
+  }
+
+  arma::Col<size_t> votes(numClasses, arma::fill::zeros);
+  for (size_t t = 0; t < trees.size(); ++t)
+    ++votes[trees[t]->Classify(point)];
+
+  prediction = votes.index_max();
+  probability = (double) votes[prediction] / (double) trees.size();
+}
+
+template<typename TreeType>
+template<typename MatType>
+void HoeffdingForest<TreeType>::Classify(const MatType& data,
+                                         arma::Row<size_t>& predictions) const
+{
+  arma::rowvec probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename TreeType>
+template<typename MatType>
+void HoeffdingForest<TreeType>::Classify(const MatType& data,
+                                         arma::Row<size_t>& predictions,
+                                         arma::rowvec& probabilities) const
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("HoeffdingForest::Classify(): the forest has "
+        "no trees!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    Classify(data.col(i), predictions[i], probabilities[i]);
+  }
+}
+
+template<typename TreeType>
+template<typename Archive>
+void HoeffdingForest<TreeType>::serialize(Archive& ar,
+                                          const unsigned int /* version */)
+{
+  // Clear memory if needed.
+  if (Archive::is_loading::value)
+    Clear();
+
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(lambda);
+  ar & BOOST_SERIALIZATION_NVP(trees);
+}
+
+template<typename TreeType>
+void HoeffdingForest<TreeType>::Clear()
+{
+  for (size_t i = 0; i < trees.size(); ++i)
+    delete trees[i];
+  trees.clear();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -111,6 +111,27 @@ class HoeffdingNumericSplit
    */
   void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo) const;
 
+  /**
+   * Add the statistics of the given split, which must have the same number of
+   * bins and classes, to the statistics of this split, as if this split had
+   * also been trained on the points the other split was trained on.  If
+   * either split has not yet binned its observations, this is exact: the
+   * unbinned observations are simply trained on.  If both splits have binned
+   * their observations but with different bins, the counts of each bin of the
+   * other split are added to the bin of this split that holds its center, so
+   * the result is only an approximation.
+   *
+   * @param other Split to merge into this one.
+   */
+  void Merge(const HoeffdingNumericSplit& other);
+
+  /**
+   * Forget the points seen so far, but keep the bins if they have been
+   * computed, so that this split can collect statistics that will be merged
+   * into another split with the same bins.
+   */
+  void Reset();
+
   //! Return the majority class.
   size_t MajorityClass() const;
   //! Return the probability of the majority class.
@@ -138,6 +159,9 @@ class HoeffdingNumericSplit
   //! The number of samples we have seen so far.
   size_t samplesSeen;
 
+  //! Return the bin of the given value.
+  size_t Bin(const ObservationType value) const;
+
   //! After binning, this contains the sufficient statistics.
   arma::Mat<size_t> sufficientStatistics;
 };
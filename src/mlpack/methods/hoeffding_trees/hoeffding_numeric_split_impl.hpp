@@ -132,6 +132,103 @@ void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Split(
   splitInfo = SplitInfo(splitPoints);
 }
 
+template<typename FitnessFunction, typename ObservationType>
+void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Merge(
+    const HoeffdingNumericSplit& other)
+{
+  if (other.bins != bins ||
+      other.sufficientStatistics.n_rows != sufficientStatistics.n_rows)
+  {
+    throw std::invalid_argument("HoeffdingNumericSplit::Merge(): the splits "
+        "must have the same number of bins and classes!");
+  }
+
+  if (other.samplesSeen < other.observationsBeforeBinning)
+  {
+    // The other split has not binned its observations yet, so we can train on
+    // them directly.
+    for (size_t i = 0; i < other.samplesSeen; ++i)
+      Train(other.observations[i], other.labels[i]);
+  }
+  else if (samplesSeen < observationsBeforeBinning)
+  {
+    // Take the bins of the other split, and then train on our own
+    // observations.
+    const arma::Col<ObservationType> oldObservations(observations);
+    const arma::Col<size_t> oldLabels(labels);
+    const size_t oldSamplesSeen = samplesSeen;
+
+    splitPoints = other.splitPoints;
+    sufficientStatistics = other.sufficientStatistics;
+    samplesSeen = std::max(other.samplesSeen, observationsBeforeBinning);
+    for (size_t i = 0; i < oldSamplesSeen; ++i)
+      Train(oldObservations[i], oldLabels[i]);
+  }
+  else
+  {
+    bool sameBins = true;
+    for (size_t i = 0; i < splitPoints.n_elem; ++i)
+    {
+      if (splitPoints[i] != other.splitPoints[i])
+      {
+        sameBins = false;
+        break;
+      }
+    }
+
+    if (sameBins)
+    {
+      sufficientStatistics += other.sufficientStatistics;
+    }
+    else
+    {
+      // The bins of the other split all have the same width, so bin i is
+      // centered at splitPoints[0] + (i - 0.5) * width.  With a single split
+      // point the width is unknown, so the bins are mapped to the bin of the
+      // split point and the bin after it.
+      const size_t splitBin = Bin(other.splitPoints[0]);
+      for (size_t i = 0; i < bins; ++i)
+      {
+        size_t bin;
+        if (other.splitPoints.n_elem > 1)
+        {
+          const double width = double(other.splitPoints[1]) -
+              double(other.splitPoints[0]);
+          bin = Bin(ObservationType(double(other.splitPoints[0]) +
+              (double(i) - 0.5) * width));
+        }
+        else
+        {
+          bin = std::min(splitBin + i, bins - 1);
+        }
+
+        sufficientStatistics.col(bin) += other.sufficientStatistics.col(i);
+      }
+    }
+  }
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Reset()
+{
+  // If the bins have been computed, keep them (samplesSeen then only marks
+  // that the binning happened).
+  if (samplesSeen < observationsBeforeBinning)
+    samplesSeen = 0;
+  sufficientStatistics.zeros();
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t HoeffdingNumericSplit<FitnessFunction, ObservationType>::Bin(
+    const ObservationType value) const
+{
+  size_t bin = 0;
+  while (bin < bins - 1 && value > splitPoints[bin])
+    ++bin;
+
+  return bin;
+}
+
 template<typename FitnessFunction, typename ObservationType>
 size_t HoeffdingNumericSplit<FitnessFunction, ObservationType>::
     MajorityClass() const
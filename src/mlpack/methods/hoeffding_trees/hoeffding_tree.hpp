@@ -19,6 +19,10 @@
 #include "hoeffding_numeric_split.hpp"
 #include "hoeffding_categorical_split.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -192,6 +196,33 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train on a stream of points in streaming mode with several threads (if
+   * OpenMP is available).  The points are processed in blocks: the points of
+   * each block are sharded between the threads, which route them to the
+   * leaves of the tree and collect the statistics of each leaf in thread-local
+   * copies of its splits.  At the end of each block, the thread-local
+   * statistics are merged into the leaves, and each leaf that has passed a
+   * multiple of the check interval checks for a split.  This requires the
+   * numeric and categorical split types to provide Merge() and Reset() (as
+   * HoeffdingNumericSplit, BinaryNumericSplit and HoeffdingCategoricalSplit
+   * do).
+   *
+   * Since the leaves only split between blocks, the tree may differ slightly
+   * from the tree given by Train(data, labels, false); with a block size of 1,
+   * it is the same.  The thread-local statistics take up to as much memory as
+   * the statistics of the tree for each thread.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of data points.
+   * @param blockSize Number of points between merges of the thread-local
+   *     statistics (0 means the check interval of the tree).
+   */
+  template<typename MatType>
+  void ParallelTrain(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const size_t blockSize = 0);
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -314,6 +345,17 @@ class HoeffdingTree
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  //! The statistics a thread collects for a leaf during ParallelTrain().
+  struct LeafStatistics
+  {
+    //! The number of points seen since the last merge.
+    size_t numSamples;
+    //! The thread-local numeric splits.
+    std::vector<NumericSplitType<FitnessFunction>> numericSplits;
+    //! The thread-local categorical splits.
+    std::vector<CategoricalSplitType<FitnessFunction>> categoricalSplits;
+  };
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
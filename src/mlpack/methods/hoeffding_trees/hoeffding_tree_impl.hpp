@@ -429,6 +429,167 @@ void HoeffdingTree<
   }
 }
 
+//! Train on a set of points with several threads.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::ParallelTrain(const MatType& data,
+                 const arma::Row<size_t>& labels,
+                 const size_t blockSize)
+{
+  if (labels.n_elem != data.n_cols)
+  {
+    throw std::invalid_argument("HoeffdingTree::ParallelTrain(): the number "
+        "of labels must match the number of points!");
+  }
+
+  #ifdef HAS_OPENMP
+    const size_t threads = omp_get_max_threads();
+  #else
+    const size_t threads = 1;
+  #endif
+
+  const size_t block = (blockSize == 0) ? checkInterval : blockSize;
+
+  // The statistics each thread has collected for each leaf.  They are kept
+  // (and reset) between blocks, so that the splits are only copied once per
+  // leaf and thread.
+  typedef std::unordered_map<HoeffdingTree*, LeafStatistics> StatisticsMap;
+  std::vector<StatisticsMap> statistics(threads);
+
+  for (size_t begin = 0; begin < data.n_cols; begin += block)
+  {
+    const size_t end = std::min(begin + block, (size_t) data.n_cols);
+
+    // Each thread gets a contiguous shard of the block, so merging the
+    // statistics of the threads in order keeps the order of the stream.
+    #pragma omp parallel num_threads(threads)
+    {
+      #ifdef HAS_OPENMP
+        StatisticsMap& localStatistics = statistics[omp_get_thread_num()];
+      #else
+        StatisticsMap& localStatistics = statistics[0];
+      #endif
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+      {
+        // Find the leaf of the point; the tree does not change in the block.
+        HoeffdingTree* node = this;
+        while (node->splitDimension != size_t(-1))
+          node = node->children[node->CalculateDirection(data.col(i))];
+
+        typename StatisticsMap::iterator it = localStatistics.find(node);
+        if (it == localStatistics.end())
+        {
+          LeafStatistics leafStatistics;
+          leafStatistics.numSamples = 0;
+          leafStatistics.numericSplits = node->numericSplits;
+          leafStatistics.categoricalSplits = node->categoricalSplits;
+          for (size_t j = 0; j < leafStatistics.numericSplits.size(); ++j)
+            leafStatistics.numericSplits[j].Reset();
+          for (size_t j = 0; j < leafStatistics.categoricalSplits.size(); ++j)
+            leafStatistics.categoricalSplits[j].Reset();
+
+          it = localStatistics.insert(std::make_pair(node,
+              std::move(leafStatistics))).first;
+        }
+
+        LeafStatistics& leafStatistics = it->second;
+        ++leafStatistics.numSamples;
+        size_t numericIndex = 0;
+        size_t categoricalIndex = 0;
+        for (size_t d = 0; d < data.n_rows; ++d)
+        {
+          if (datasetInfo->Type(d) == data::Datatype::categorical)
+          {
+            leafStatistics.categoricalSplits[categoricalIndex++].Train(
+                data(d, i), labels[i]);
+          }
+          else if (datasetInfo->Type(d) == data::Datatype::numeric)
+          {
+            leafStatistics.numericSplits[numericIndex++].Train(data(d, i),
+                labels[i]);
+          }
+        }
+      }
+    }
+
+    // Merge the statistics of each leaf into the leaf, thread by thread.
+    std::vector<HoeffdingTree*> leaves;
+    std::unordered_map<HoeffdingTree*, size_t> oldNumSamples;
+    for (size_t t = 0; t < threads; ++t)
+    {
+      for (typename StatisticsMap::iterator it = statistics[t].begin();
+          it != statistics[t].end(); ++it)
+      {
+        HoeffdingTree* node = it->first;
+        LeafStatistics& leafStatistics = it->second;
+        if (leafStatistics.numSamples == 0)
+          continue;
+
+        if (oldNumSamples.count(node) == 0)
+        {
+          oldNumSamples[node] = node->numSamples;
+          leaves.push_back(node);
+        }
+
+        node->numSamples += leafStatistics.numSamples;
+        for (size_t j = 0; j < node->numericSplits.size(); ++j)
+        {
+          node->numericSplits[j].Merge(leafStatistics.numericSplits[j]);
+          leafStatistics.numericSplits[j].Reset();
+        }
+        for (size_t j = 0; j < node->categoricalSplits.size(); ++j)
+        {
+          node->categoricalSplits[j].Merge(leafStatistics.categoricalSplits[j]);
+          leafStatistics.categoricalSplits[j].Reset();
+        }
+        leafStatistics.numSamples = 0;
+      }
+    }
+
+    // Now update the majority classes, and check for splits.
+    for (size_t l = 0; l < leaves.size(); ++l)
+    {
+      HoeffdingTree* node = leaves[l];
+      if (node->categoricalSplits.size() > 0)
+      {
+        node->majorityClass = node->categoricalSplits[0].MajorityClass();
+        node->majorityProbability =
+            node->categoricalSplits[0].MajorityProbability();
+      }
+      else
+      {
+        node->majorityClass = node->numericSplits[0].MajorityClass();
+        node->majorityProbability =
+            node->numericSplits[0].MajorityProbability();
+      }
+
+      // Check for a split if the node has passed a multiple of the check
+      // interval during this block.
+      if (node->numSamples / node->checkInterval ==
+          oldNumSamples[node] / node->checkInterval)
+        continue;
+
+      if (node->SplitCheck() > 0)
+      {
+        node->children.clear();
+        node->CreateChildren();
+
+        // The node is not a leaf anymore.
+        for (size_t t = 0; t < threads; ++t)
+          statistics[t].erase(node);
+      }
+    }
+  }
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
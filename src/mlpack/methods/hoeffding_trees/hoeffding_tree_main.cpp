@@ -55,6 +55,13 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("batch_mode") + " option, but this may not be the best "
     "option for large datasets."
     "\n\n"
+    "Numeric features may be split with the 'domingos' strategy (fixed bins "
+    "computed after a number of observations), the 'binary' strategy (the best "
+    "binary split over every observed value, which uses memory proportional "
+    "to the number of points seen), or the 'quantile' strategy (binary splits "
+    "over bounded-memory quantile sketches of the values of each class, whose "
+    "size is controlled by " + PRINT_PARAM_STRING("sketch_size") + ")."
+    "\n\n"
     "When a model is trained, it may be saved via the " +
     PRINT_PARAM_STRING("output_model") + " output parameter.  A model may be "
     "loaded from file for further training or testing with the " +
@@ -117,7 +124,7 @@ PARAM_MATRIX_OUT("probabilities", "In addition to predicting labels, provide "
     "rediction probabilities in this matrix.", "P");
 
 PARAM_STRING_IN("numeric_split_strategy", "The splitting strategy to use for "
-    "numeric features: 'domingos' or 'binary'.", "N", "binary");
+    "numeric features: 'domingos', 'binary', or 'quantile'.", "N", "binary");
 PARAM_FLAG("batch_mode", "If true, samples will be considered in batch instead "
     "of as a stream.  This generally results in better trees but at the cost of"
     " memory usage and runtime.", "b");
@@ -130,6 +137,9 @@ PARAM_INT_IN("bins", "If the 'domingos' split strategy is used, this specifies "
 PARAM_INT_IN("observations_before_binning", "If the 'domingos' split strategy "
     "is used, this specifies the number of samples observed before binning is "
     "performed.", "o", 100);
+PARAM_INT_IN("sketch_size", "If the 'quantile' split strategy is used, this "
+    "specifies the accuracy parameter of the quantile sketches; each sketch "
+    "holds at most about three times this many values.", "k", 200);
 
 // Convenience typedef.
 typedef tuple<DatasetInfo, arma::mat> TupleType;
@@ -157,8 +167,10 @@ static void mlpackMain()
         false, "no output will be given");
   }
 
-  RequireParamInSet<string>("numeric_split_strategy", { "domingos", "binary" },
-      true, "unrecognized numeric split strategy");
+  RequireParamInSet<string>("numeric_split_strategy", { "domingos", "binary",
+      "quantile" }, true, "unrecognized numeric split strategy");
+  RequireParamValue<int>("sketch_size", [](int x) { return x >= 2; }, true,
+      "the sketch size must be at least 2");
 
   // Do we need to load a model or do we already have one?
   HoeffdingTreeModel* model;
@@ -176,8 +188,12 @@ static void mlpackMain()
       model = new HoeffdingTreeModel(HoeffdingTreeModel::GINI_HOEFFDING);
     else if (!IO::HasParam("info_gain") && (numericSplitStrategy == "binary"))
       model = new HoeffdingTreeModel(HoeffdingTreeModel::GINI_BINARY);
+    else if (!IO::HasParam("info_gain") && (numericSplitStrategy == "quantile"))
+      model = new HoeffdingTreeModel(HoeffdingTreeModel::GINI_QUANTILE);
     else if (IO::HasParam("info_gain") && (numericSplitStrategy == "domingos"))
       model = new HoeffdingTreeModel(HoeffdingTreeModel::INFO_HOEFFDING);
+    else if (IO::HasParam("info_gain") && (numericSplitStrategy == "quantile"))
+      model = new HoeffdingTreeModel(HoeffdingTreeModel::INFO_QUANTILE);
     else
       model = new HoeffdingTreeModel(HoeffdingTreeModel::INFO_BINARY);
   }
@@ -193,6 +209,7 @@ static void mlpackMain()
     const size_t bins = (size_t) IO::GetParam<int>("bins");
     const size_t observationsBeforeBinning = (size_t)
         IO::GetParam<int>("observations_before_binning");
+    const size_t sketchSize = (size_t) IO::GetParam<int>("sketch_size");
     size_t passes = (size_t) IO::GetParam<int>("passes");
     if (passes > 1)
       batchTraining = false; // We already warned about this earlier.
@@ -230,7 +247,7 @@ static void mlpackMain()
       // Build the model.
       model->BuildModel(trainingSet, datasetInfo, labels,
           arma::max(labels) + 1, batchTraining, confidence, maxSamples,
-          100, minSamples, bins, observationsBeforeBinning);
+          100, minSamples, bins, observationsBeforeBinning, sketchSize);
       --passes; // This model-building takes one pass.
     }
 
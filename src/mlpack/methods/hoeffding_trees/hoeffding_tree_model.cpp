@@ -22,7 +22,9 @@ HoeffdingTreeModel::HoeffdingTreeModel(const TreeType& type) :
     giniHoeffdingTree(NULL),
     giniBinaryTree(NULL),
     infoHoeffdingTree(NULL),
-    infoBinaryTree(NULL)
+    infoBinaryTree(NULL),
+    giniQuantileTree(NULL),
+    infoQuantileTree(NULL)
 {
   // Nothing to do.
 }
@@ -37,7 +39,11 @@ HoeffdingTreeModel::HoeffdingTreeModel(const HoeffdingTreeModel& other) :
     infoHoeffdingTree(other.infoHoeffdingTree ? new InfoHoeffdingTreeType(
         *other.infoHoeffdingTree) : NULL),
     infoBinaryTree(other.infoBinaryTree ? new InfoBinaryTreeType(
-        *other.infoBinaryTree) : NULL)
+        *other.infoBinaryTree) : NULL),
+    giniQuantileTree(other.giniQuantileTree ? new GiniQuantileTreeType(
+        *other.giniQuantileTree) : NULL),
+    infoQuantileTree(other.infoQuantileTree ? new InfoQuantileTreeType(
+        *other.infoQuantileTree) : NULL)
 {
   // Nothing else to do.
 }
@@ -48,7 +54,9 @@ HoeffdingTreeModel::HoeffdingTreeModel(HoeffdingTreeModel&& other) :
     giniHoeffdingTree(other.giniHoeffdingTree),
     giniBinaryTree(other.giniBinaryTree),
     infoHoeffdingTree(other.infoHoeffdingTree),
-    infoBinaryTree(other.infoBinaryTree)
+    infoBinaryTree(other.infoBinaryTree),
+    giniQuantileTree(other.giniQuantileTree),
+    infoQuantileTree(other.infoQuantileTree)
 {
   // Reset other model.
   other.type = GINI_HOEFFDING;
@@ -56,6 +64,8 @@ HoeffdingTreeModel::HoeffdingTreeModel(HoeffdingTreeModel&& other) :
   other.giniBinaryTree = NULL;
   other.infoHoeffdingTree = NULL;
   other.infoBinaryTree = NULL;
+  other.giniQuantileTree = NULL;
+  other.infoQuantileTree = NULL;
 }
 
 // Copy operator.
@@ -67,11 +77,15 @@ HoeffdingTreeModel& HoeffdingTreeModel::operator=(
   delete giniBinaryTree;
   delete infoHoeffdingTree;
   delete infoBinaryTree;
+  delete giniQuantileTree;
+  delete infoQuantileTree;
 
   giniHoeffdingTree = NULL;
   giniBinaryTree = NULL;
   infoHoeffdingTree = NULL;
   infoBinaryTree = NULL;
+  giniQuantileTree = NULL;
+  infoQuantileTree = NULL;
 
   // Create the right tree.
   type = other.type;
@@ -83,6 +97,10 @@ HoeffdingTreeModel& HoeffdingTreeModel::operator=(
     infoHoeffdingTree = new InfoHoeffdingTreeType(*other.infoHoeffdingTree);
   else if (other.infoBinaryTree && (type == INFO_BINARY))
     infoBinaryTree = new InfoBinaryTreeType(*other.infoBinaryTree);
+  else if (other.giniQuantileTree && (type == GINI_QUANTILE))
+    giniQuantileTree = new GiniQuantileTreeType(*other.giniQuantileTree);
+  else if (other.infoQuantileTree && (type == INFO_QUANTILE))
+    infoQuantileTree = new InfoQuantileTreeType(*other.infoQuantileTree);
 
   return *this;
 }
@@ -95,12 +113,16 @@ HoeffdingTreeModel& HoeffdingTreeModel::operator=(HoeffdingTreeModel&& other)
   delete giniBinaryTree;
   delete infoHoeffdingTree;
   delete infoBinaryTree;
+  delete giniQuantileTree;
+  delete infoQuantileTree;
 
   type = other.type;
   giniHoeffdingTree = other.giniHoeffdingTree;
   giniBinaryTree = other.giniBinaryTree;
   infoHoeffdingTree = other.infoHoeffdingTree;
   infoBinaryTree = other.infoBinaryTree;
+  giniQuantileTree = other.giniQuantileTree;
+  infoQuantileTree = other.infoQuantileTree;
 
   // Clear the other model.
   other.type = GINI_HOEFFDING;
@@ -108,6 +130,8 @@ HoeffdingTreeModel& HoeffdingTreeModel::operator=(HoeffdingTreeModel&& other)
   other.giniBinaryTree = NULL;
   other.infoHoeffdingTree = NULL;
   other.infoBinaryTree = NULL;
+  other.giniQuantileTree = NULL;
+  other.infoQuantileTree = NULL;
 
   return *this;
 }
@@ -119,6 +143,8 @@ HoeffdingTreeModel::~HoeffdingTreeModel()
   delete giniBinaryTree;
   delete infoHoeffdingTree;
   delete infoBinaryTree;
+  delete giniQuantileTree;
+  delete infoQuantileTree;
 }
 
 // Create the model.
@@ -133,13 +159,16 @@ void HoeffdingTreeModel::BuildModel(
     const size_t checkInterval,
     const size_t minSamples,
     const size_t bins,
-    const size_t observationsBeforeBinning)
+    const size_t observationsBeforeBinning,
+    const size_t sketchSize)
 {
   // Clean memory, if needed.
   delete giniHoeffdingTree;
   delete giniBinaryTree;
   delete infoHoeffdingTree;
   delete infoBinaryTree;
+  delete giniQuantileTree;
+  delete infoQuantileTree;
 
   // Depending on the type, create the tree.
   switch (type)
@@ -181,6 +210,31 @@ void HoeffdingTreeModel::BuildModel(
           numClasses, batchTraining, successProbability, maxSamples,
           checkInterval, minSamples);
       break;
+
+    case GINI_QUANTILE:
+      // Create instantiated numeric split.
+      {
+        QuantileDoubleNumericSplit<GiniImpurity> ns(0, sketchSize);
+
+        giniQuantileTree = new GiniQuantileTreeType(dataset, datasetInfo,
+            labels, numClasses, batchTraining, successProbability, maxSamples,
+            checkInterval, minSamples,
+            HoeffdingCategoricalSplit<GiniImpurity>(0, 0), ns);
+      }
+      break;
+
+    case INFO_QUANTILE:
+      // Create instantiated numeric split.
+      {
+        QuantileDoubleNumericSplit<HoeffdingInformationGain> ns(0,
+            sketchSize);
+
+        infoQuantileTree = new InfoQuantileTreeType(dataset, datasetInfo,
+            labels, numClasses, batchTraining, successProbability, maxSamples,
+            checkInterval, minSamples,
+            HoeffdingCategoricalSplit<HoeffdingInformationGain>(0, 0), ns);
+      }
+      break;
   }
 }
 
@@ -207,6 +261,14 @@ void HoeffdingTreeModel::Train(const arma::mat& dataset,
     case INFO_BINARY:
       infoBinaryTree->Train(dataset, labels, batchTraining);
       break;
+
+    case GINI_QUANTILE:
+      giniQuantileTree->Train(dataset, labels, batchTraining);
+      break;
+
+    case INFO_QUANTILE:
+      infoQuantileTree->Train(dataset, labels, batchTraining);
+      break;
   }
 }
 
@@ -232,6 +294,14 @@ void HoeffdingTreeModel::Classify(const arma::mat& dataset,
     case INFO_BINARY:
       infoBinaryTree->Classify(dataset, predictions);
       break;
+
+    case GINI_QUANTILE:
+      giniQuantileTree->Classify(dataset, predictions);
+      break;
+
+    case INFO_QUANTILE:
+      infoQuantileTree->Classify(dataset, predictions);
+      break;
   }
 }
 
@@ -258,6 +328,14 @@ void HoeffdingTreeModel::Classify(const arma::mat& dataset,
     case INFO_BINARY:
       infoBinaryTree->Classify(dataset, predictions, probabilities);
       break;
+
+    case GINI_QUANTILE:
+      giniQuantileTree->Classify(dataset, predictions, probabilities);
+      break;
+
+    case INFO_QUANTILE:
+      infoQuantileTree->Classify(dataset, predictions, probabilities);
+      break;
   }
 }
 
@@ -295,6 +373,10 @@ size_t HoeffdingTreeModel::NumNodes() const
       return CountNodes(*infoHoeffdingTree);
     case INFO_BINARY:
       return CountNodes(*infoBinaryTree);
+    case GINI_QUANTILE:
+      return CountNodes(*giniQuantileTree);
+    case INFO_QUANTILE:
+      return CountNodes(*infoQuantileTree);
   }
 
   return 0; // This should never happen!
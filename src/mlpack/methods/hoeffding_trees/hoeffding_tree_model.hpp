@@ -14,6 +14,7 @@
 
 #include "hoeffding_tree.hpp"
 #include "binary_numeric_split.hpp"
+#include "quantile_numeric_split.hpp"
 #include "information_gain.hpp"
 
 namespace mlpack {
@@ -27,13 +28,15 @@ namespace tree {
 class HoeffdingTreeModel
 {
  public:
-  //! This enumerates the four types of trees we can hold.
+  //! This enumerates the types of trees we can hold.
   enum TreeType
   {
     GINI_HOEFFDING,
     GINI_BINARY,
     INFO_HOEFFDING,
-    INFO_BINARY
+    INFO_BINARY,
+    GINI_QUANTILE,
+    INFO_QUANTILE
   };
 
   //! Convenience typedef for GINI_HOEFFDING tree type.
@@ -48,6 +51,12 @@ class HoeffdingTreeModel
   //! Convenience typedef for INFO_BINARY tree type.
   typedef HoeffdingTree<HoeffdingInformationGain, BinaryDoubleNumericSplit,
       HoeffdingCategoricalSplit> InfoBinaryTreeType;
+  //! Convenience typedef for GINI_QUANTILE tree type.
+  typedef HoeffdingTree<GiniImpurity, QuantileDoubleNumericSplit,
+      HoeffdingCategoricalSplit> GiniQuantileTreeType;
+  //! Convenience typedef for INFO_QUANTILE tree type.
+  typedef HoeffdingTree<HoeffdingInformationGain, QuantileDoubleNumericSplit,
+      HoeffdingCategoricalSplit> InfoQuantileTreeType;
 
   /**
    * Construct the Hoeffding tree model, but don't initialize any tree.
@@ -110,6 +119,8 @@ class HoeffdingTreeModel
    * @param bins Number of bins, for Hoeffding numeric split.
    * @param observationsBeforeBinning Number of observations before binning, for
    *      Hoeffding numeric split.
+   * @param sketchSize Accuracy parameter of the quantile sketches, for the
+   *      quantile numeric split.
    */
   void BuildModel(const arma::mat& dataset,
                   const data::DatasetInfo& datasetInfo,
@@ -121,7 +132,8 @@ class HoeffdingTreeModel
                   const size_t checkInterval,
                   const size_t minSamples,
                   const size_t bins,
-                  const size_t observationsBeforeBinning);
+                  const size_t observationsBeforeBinning,
+                  const size_t sketchSize = 200);
 
   /**
    * Train in streaming mode on the given dataset.  This takes one pass.  Be
@@ -175,11 +187,15 @@ class HoeffdingTreeModel
       delete giniBinaryTree;
       delete infoHoeffdingTree;
       delete infoBinaryTree;
+      delete giniQuantileTree;
+      delete infoQuantileTree;
 
       giniHoeffdingTree = NULL;
       giniBinaryTree = NULL;
       infoHoeffdingTree = NULL;
       infoBinaryTree = NULL;
+      giniQuantileTree = NULL;
+      infoQuantileTree = NULL;
     }
 
     ar & BOOST_SERIALIZATION_NVP(type);
@@ -194,6 +210,10 @@ class HoeffdingTreeModel
       ar & BOOST_SERIALIZATION_NVP(infoHoeffdingTree);
     else if (type == INFO_BINARY)
       ar & BOOST_SERIALIZATION_NVP(infoBinaryTree);
+    else if (type == GINI_QUANTILE)
+      ar & BOOST_SERIALIZATION_NVP(giniQuantileTree);
+    else if (type == INFO_QUANTILE)
+      ar & BOOST_SERIALIZATION_NVP(infoQuantileTree);
   }
 
  private:
@@ -215,6 +235,14 @@ class HoeffdingTreeModel
   //! This is used if we are using the information gain and the binary numeric
   //! split.
   InfoBinaryTreeType* infoBinaryTree;
+
+  //! This is used if we are using the Gini impurity and the quantile numeric
+  //! split.
+  GiniQuantileTreeType* giniQuantileTree;
+
+  //! This is used if we are using the information gain and the quantile
+  //! numeric split.
+  InfoQuantileTreeType* infoQuantileTree;
 };
 
 } // namespace tree
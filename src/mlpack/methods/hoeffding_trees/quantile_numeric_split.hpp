@@ -0,0 +1,159 @@
+/**
+ * @file methods/hoeffding_trees/quantile_numeric_split.hpp
+ *
+ * A binary numeric feature split for Hoeffding trees that summarizes the
+ * points it has seen with bounded-memory quantile sketches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "binary_numeric_split_info.hpp"
+#include "quantile_sketch.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The QuantileNumericSplit class makes the same binary splits as the
+ * BinaryNumericSplit class, but instead of keeping every value it has seen, it
+ * keeps one QuantileSketch of the values of each class.  The candidate split
+ * points are the values held by the sketches, and the number of points of
+ * each class on each side of a split point is estimated from the weights of
+ * the sketch.  So the memory used by each split is bounded by about
+ * 3 * k * numClasses values, however long the stream is, and the estimated
+ * number of points of a class below a split point is within about n_c / k of
+ * the true number (n_c is the number of points of the class), with high
+ * probability.  The class counts themselves are exact.
+ *
+ * Training takes amortized O(log k) time per point, and
+ * EvaluateFitnessFunction() takes O(k * numClasses * log(k * numClasses))
+ * time.
+ *
+ * @tparam FitnessFunction Fitness function to use for calculating gain.
+ * @tparam ObservationType Type of observation used by this dimension.
+ */
+template<typename FitnessFunction,
+         typename ObservationType = double>
+class QuantileNumericSplit
+{
+ public:
+  //! The splitting information required by the QuantileNumericSplit.
+  typedef BinaryNumericSplitInfo<ObservationType> SplitInfo;
+
+  /**
+   * Create the QuantileNumericSplit object with the given number of classes
+   * and sketch accuracy.
+   *
+   * @param numClasses Number of classes in dataset.
+   * @param k Accuracy parameter of the sketch of each class; each sketch holds
+   *     at most about 3k values.
+   */
+  QuantileNumericSplit(const size_t numClasses = 0, const size_t k = 200);
+
+  /**
+   * Create the QuantileNumericSplit object with the given number of classes,
+   * using the sketch accuracy of the given other split.
+   */
+  QuantileNumericSplit(const size_t numClasses,
+                       const QuantileNumericSplit& other);
+
+  /**
+   * Train on the given value with the given label.
+   *
+   * @param value The value to train on.
+   * @param label The label to train on.
+   */
+  void Train(ObservationType value, const size_t label);
+
+  /**
+   * Given the points seen so far, evaluate the fitness function, returning the
+   * best possible gain of a binary split.
+   *
+   * @param bestFitness Fitness function value for best possible split.
+   * @param secondBestFitness Fitness function value for second best possible
+   *      split.
+   */
+  void EvaluateFitnessFunction(double& bestFitness,
+                               double& secondBestFitness);
+
+  // Return the number of children if this node were to split on this feature.
+  size_t NumChildren() const { return 2; }
+
+  /**
+   * Given that a split should happen, return the majority classes of the (two)
+   * children and an initialized SplitInfo object.
+   *
+   * @param childMajorities Majority classes of the children after the split.
+   * @param splitInfo Split information.
+   */
+  void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo);
+
+  /**
+   * Merge the sketches of the given split, which must be for the same number
+   * of classes, into the sketches of this split.
+   *
+   * @param other Split to merge into this one.
+   */
+  void Merge(const QuantileNumericSplit& other);
+
+  /**
+   * Forget the points seen so far, so that this split can collect statistics
+   * that will be merged into another split.
+   */
+  void Reset();
+
+  //! The majority class of the points seen so far.
+  size_t MajorityClass() const;
+  //! The probability of the majority class given the points seen so far.
+  double MajorityProbability() const;
+
+  //! Get the accuracy parameter of the sketches.
+  size_t K() const { return k; }
+  //! Get the number of values held by the sketches of all the classes.
+  size_t NumRetained() const;
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Collect the values of all the sketches, sorted by value, with their
+   * labels and weights.
+   */
+  void SortedValues(std::vector<ObservationType>& values,
+                    std::vector<size_t>& labels,
+                    std::vector<size_t>& weights) const;
+
+  //! The sketch of the values of each class.
+  std::vector<QuantileSketch<ObservationType>> sketches;
+  //! The classes we have seen so far (for majority calculations).
+  arma::Col<size_t> classCounts;
+  //! The accuracy parameter of the sketches.
+  size_t k;
+
+  //! A cached best split point.
+  ObservationType bestSplit;
+  //! If true, the cached best split point is accurate (that is, we have not
+  //! seen any more samples since we calculated it).
+  bool isAccurate;
+};
+
+// Convenience typedef.
+template<typename FitnessFunction>
+using QuantileDoubleNumericSplit = QuantileNumericSplit<FitnessFunction,
+    double>;
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "quantile_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,267 @@
+/**
+ * @file methods/hoeffding_trees/quantile_numeric_split_impl.hpp
+ *
+ * Implementation of the QuantileNumericSplit class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantile_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction, typename ObservationType>
+QuantileNumericSplit<FitnessFunction, ObservationType>::QuantileNumericSplit(
+    const size_t numClasses,
+    const size_t k) :
+    sketches(numClasses, QuantileSketch<ObservationType>(k)),
+    classCounts(numClasses),
+    k(k),
+    bestSplit(std::numeric_limits<ObservationType>::min()),
+    isAccurate(true)
+{
+  // Zero out class counts.
+  classCounts.zeros();
+}
+
+template<typename FitnessFunction, typename ObservationType>
+QuantileNumericSplit<FitnessFunction, ObservationType>::QuantileNumericSplit(
+    const size_t numClasses,
+    const QuantileNumericSplit& other) :
+    sketches(numClasses, QuantileSketch<ObservationType>(other.k)),
+    classCounts(numClasses),
+    k(other.k),
+    bestSplit(std::numeric_limits<ObservationType>::min()),
+    isAccurate(true)
+{
+  // Zero out class counts.
+  classCounts.zeros();
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Train(
+    ObservationType value,
+    const size_t label)
+{
+  sketches[label].Insert(value);
+  ++classCounts[label];
+
+  // Whatever we have cached is no longer valid.
+  isAccurate = false;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::
+    EvaluateFitnessFunction(double& bestFitness,
+                            double& secondBestFitness)
+{
+  bestSplit = std::numeric_limits<ObservationType>::min();
+  secondBestFitness = 0.0;
+
+  std::vector<ObservationType> values;
+  std::vector<size_t> labels, weights;
+  SortedValues(values, labels, weights);
+  if (values.empty())
+  {
+    bestFitness = 0.0;
+    isAccurate = true;
+    return;
+  }
+
+  // Initialize the sufficient statistics; the weights of the sketch of each
+  // class add up to the exact count of the class.
+  arma::Mat<size_t> counts(classCounts.n_elem, 2);
+  counts.col(0).zeros();
+  counts.col(1) = classCounts;
+
+  bestFitness = FitnessFunction::Evaluate(counts);
+
+  // This is the same sweep as in BinaryNumericSplit, but each value of the
+  // sketches moves its whole weight to the left side.
+  ObservationType lastObservation = values[0];
+  size_t lastClass = classCounts.n_elem;
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    if ((values[i] != lastObservation) || (labels[i] != lastClass))
+    {
+      lastObservation = values[i];
+      lastClass = labels[i];
+
+      const double value = FitnessFunction::Evaluate(counts);
+      if (value > bestFitness)
+      {
+        bestFitness = value;
+        bestSplit = values[i];
+      }
+      else if (value > secondBestFitness)
+      {
+        secondBestFitness = value;
+      }
+    }
+
+    // Move the weight to the left side of the split.
+    counts(labels[i], 1) -= weights[i];
+    counts(labels[i], 0) += weights[i];
+  }
+
+  isAccurate = true;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Split(
+    arma::Col<size_t>& childMajorities,
+    SplitInfo& splitInfo)
+{
+  if (!isAccurate)
+  {
+    double bestGain, secondBestGain;
+    EvaluateFitnessFunction(bestGain, secondBestGain);
+  }
+
+  // Make one child for each side of the split.
+  childMajorities.set_size(2);
+
+  arma::Mat<size_t> counts(classCounts.n_elem, 2);
+  counts.col(0).zeros();
+  counts.col(1) = classCounts;
+
+  std::vector<ObservationType> values;
+  std::vector<size_t> weights;
+  for (size_t c = 0; c < sketches.size(); ++c)
+  {
+    sketches[c].WeightedValues(values, weights);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      if (values[i] < bestSplit)
+      {
+        counts(c, 1) -= weights[i];
+        counts(c, 0) += weights[i];
+      }
+    }
+  }
+
+  // Calculate the majority classes of the children.
+  arma::uword maxIndex;
+  counts.unsafe_col(0).max(maxIndex);
+  childMajorities[0] = size_t(maxIndex);
+  counts.unsafe_col(1).max(maxIndex);
+  childMajorities[1] = size_t(maxIndex);
+
+  // Create the according SplitInfo object.
+  splitInfo = SplitInfo(bestSplit);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Merge(
+    const QuantileNumericSplit& other)
+{
+  if (other.classCounts.n_elem != classCounts.n_elem)
+  {
+    throw std::invalid_argument("QuantileNumericSplit::Merge(): the splits "
+        "must have the same number of classes!");
+  }
+
+  for (size_t c = 0; c < sketches.size(); ++c)
+    sketches[c].Merge(other.sketches[c]);
+  classCounts += other.classCounts;
+
+  // Whatever we have cached is no longer valid.
+  isAccurate = false;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Reset()
+{
+  for (size_t c = 0; c < sketches.size(); ++c)
+    sketches[c].Reset();
+  classCounts.zeros();
+  bestSplit = std::numeric_limits<ObservationType>::min();
+  isAccurate = true;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t QuantileNumericSplit<FitnessFunction, ObservationType>::MajorityClass()
+    const
+{
+  arma::uword maxIndex;
+  classCounts.max(maxIndex);
+  return size_t(maxIndex);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+double QuantileNumericSplit<FitnessFunction, ObservationType>::
+    MajorityProbability() const
+{
+  return double(arma::max(classCounts)) / double(arma::accu(classCounts));
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t QuantileNumericSplit<FitnessFunction, ObservationType>::NumRetained()
+    const
+{
+  size_t retained = 0;
+  for (size_t c = 0; c < sketches.size(); ++c)
+    retained += sketches[c].NumRetained();
+
+  return retained;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::SortedValues(
+    std::vector<ObservationType>& values,
+    std::vector<size_t>& labels,
+    std::vector<size_t>& weights) const
+{
+  std::vector<std::tuple<ObservationType, size_t, size_t>> items;
+  items.reserve(NumRetained());
+
+  std::vector<ObservationType> classValues;
+  std::vector<size_t> classWeights;
+  for (size_t c = 0; c < sketches.size(); ++c)
+  {
+    sketches[c].WeightedValues(classValues, classWeights);
+    for (size_t i = 0; i < classValues.size(); ++i)
+      items.push_back(std::make_tuple(classValues[i], c, classWeights[i]));
+  }
+
+  std::sort(items.begin(), items.end());
+
+  values.resize(items.size());
+  labels.resize(items.size());
+  weights.resize(items.size());
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    values[i] = std::get<0>(items[i]);
+    labels[i] = std::get<1>(items[i]);
+    weights[i] = std::get<2>(items[i]);
+  }
+}
+
+template<typename FitnessFunction, typename ObservationType>
+template<typename Archive>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(k);
+  ar & BOOST_SERIALIZATION_NVP(sketches);
+  ar & BOOST_SERIALIZATION_NVP(classCounts);
+
+  if (Archive::is_loading::value)
+  {
+    bestSplit = std::numeric_limits<ObservationType>::min();
+    isAccurate = false;
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
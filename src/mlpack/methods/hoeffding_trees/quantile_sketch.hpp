@@ -0,0 +1,123 @@
+/**
+ * @file methods/hoeffding_trees/quantile_sketch.hpp
+ *
+ * A KLL quantile sketch, which summarizes a stream of values in bounded
+ * memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_SKETCH_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_SKETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The QuantileSketch class implements the KLL sketch of Karnin, Lang and
+ * Liberty:
+ *
+ * @code
+ * @inproceedings{karnin2016optimal,
+ *   title={Optimal Quantile Approximation in Streams},
+ *   author={Karnin, Z. and Lang, K. and Liberty, E.},
+ *   booktitle={Proceedings of the IEEE 57th Annual Symposium on Foundations of
+ *       Computer Science (FOCS '16)},
+ *   pages={71--78},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * The sketch keeps its values in a stack of compactors: the values of level h
+ * each stand for 2^h values of the stream.  When a level is full, it is
+ * sorted, and every other value (starting at a random offset) is promoted to
+ * the next level, while the others are dropped.  The capacity of level h is
+ * about k * (2/3)^(H - 1 - h), where H is the number of levels, so the sketch
+ * holds at most about 3k values, whatever the length of the stream.  The rank
+ * of any value in the sketch is within about n / k of its rank in the stream
+ * with high probability; a larger k means more memory and less error.  The
+ * total weight of the values in the sketch is always exactly the number of
+ * values seen.
+ *
+ * Sketches are mergeable: merging two sketches gives a sketch of the union of
+ * their streams, with the same guarantees.
+ *
+ * @tparam ObservationType Type of the values in the stream.
+ */
+template<typename ObservationType = double>
+class QuantileSketch
+{
+ public:
+  /**
+   * Create an empty sketch.
+   *
+   * @param k Accuracy parameter: the capacity of the top level of the sketch.
+   */
+  QuantileSketch(const size_t k = 200);
+
+  //! Add the given value to the sketch.
+  void Insert(const ObservationType value);
+
+  /**
+   * Merge the given sketch into this one, so this sketch summarizes the values
+   * of both.
+   *
+   * @param other Sketch to merge.
+   */
+  void Merge(const QuantileSketch& other);
+
+  //! Forget all the values seen so far.
+  void Reset();
+
+  /**
+   * Get the values held by the sketch and the number of values of the stream
+   * each one stands for.  The values are not sorted.
+   *
+   * @param values Values of the sketch.
+   * @param weights Weight of each value.
+   */
+  void WeightedValues(std::vector<ObservationType>& values,
+                      std::vector<size_t>& weights) const;
+
+  //! Get the number of values seen.
+  size_t Count() const { return count; }
+  //! Get the number of values held by the sketch.
+  size_t NumRetained() const;
+  //! Get the accuracy parameter.
+  size_t K() const { return k; }
+
+  //! Serialize the sketch.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(k);
+    ar & BOOST_SERIALIZATION_NVP(count);
+    ar & BOOST_SERIALIZATION_NVP(levels);
+  }
+
+ private:
+  //! Get the capacity of the given level.
+  size_t Capacity(const size_t level) const;
+
+  //! Compact the levels that are over their capacity.
+  void Compress();
+
+  //! The accuracy parameter.
+  size_t k;
+  //! The number of values seen.
+  size_t count;
+  //! The values of each level; a value of level h stands for 2^h values.
+  std::vector<std::vector<ObservationType>> levels;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "quantile_sketch_impl.hpp"
+
+#endif
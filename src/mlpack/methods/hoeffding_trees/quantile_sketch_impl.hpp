@@ -0,0 +1,140 @@
+/**
+ * @file methods/hoeffding_trees/quantile_sketch_impl.hpp
+ *
+ * Implementation of the QuantileSketch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_SKETCH_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_SKETCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantile_sketch.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace tree {
+
+template<typename ObservationType>
+QuantileSketch<ObservationType>::QuantileSketch(const size_t k) :
+    k(std::max(k, (size_t) 2)),
+    count(0),
+    levels(1)
+{
+  // Nothing to do.
+}
+
+template<typename ObservationType>
+void QuantileSketch<ObservationType>::Insert(const ObservationType value)
+{
+  levels[0].push_back(value);
+  ++count;
+
+  if (levels[0].size() >= Capacity(0))
+    Compress();
+}
+
+template<typename ObservationType>
+void QuantileSketch<ObservationType>::Merge(const QuantileSketch& other)
+{
+  if (other.levels.size() > levels.size())
+    levels.resize(other.levels.size());
+
+  for (size_t h = 0; h < other.levels.size(); ++h)
+  {
+    levels[h].insert(levels[h].end(), other.levels[h].begin(),
+        other.levels[h].end());
+  }
+  count += other.count;
+
+  Compress();
+}
+
+template<typename ObservationType>
+void QuantileSketch<ObservationType>::Reset()
+{
+  count = 0;
+  levels.clear();
+  levels.resize(1);
+}
+
+template<typename ObservationType>
+void QuantileSketch<ObservationType>::WeightedValues(
+    std::vector<ObservationType>& values,
+    std::vector<size_t>& weights) const
+{
+  values.clear();
+  weights.clear();
+  values.reserve(NumRetained());
+  weights.reserve(NumRetained());
+  for (size_t h = 0; h < levels.size(); ++h)
+  {
+    for (size_t i = 0; i < levels[h].size(); ++i)
+    {
+      values.push_back(levels[h][i]);
+      weights.push_back(size_t(1) << h);
+    }
+  }
+}
+
+template<typename ObservationType>
+size_t QuantileSketch<ObservationType>::NumRetained() const
+{
+  size_t retained = 0;
+  for (size_t h = 0; h < levels.size(); ++h)
+    retained += levels[h].size();
+
+  return retained;
+}
+
+template<typename ObservationType>
+size_t QuantileSketch<ObservationType>::Capacity(const size_t level) const
+{
+  // The capacities decrease geometrically from the top level down.
+  const double depth = double(levels.size() - 1 - level);
+  return std::max((size_t) 2,
+      (size_t) std::ceil(k * std::pow(2.0 / 3.0, depth)));
+}
+
+template<typename ObservationType>
+void QuantileSketch<ObservationType>::Compress()
+{
+  for (size_t h = 0; h < levels.size(); ++h)
+  {
+    if (levels[h].size() < Capacity(h))
+      continue;
+
+    if (h + 1 == levels.size())
+      levels.emplace_back();
+
+    // Promote every other value of the sorted level, from a random offset.  If
+    // the level holds an odd number of values, the largest one stays, so the
+    // total weight does not change.
+    std::vector<ObservationType>& level = levels[h];
+    std::sort(level.begin(), level.end());
+    const size_t offset = (size_t) math::RandInt(2);
+    const size_t pairs = level.size() / 2;
+    for (size_t i = 0; i < pairs; ++i)
+      levels[h + 1].push_back(level[2 * i + offset]);
+
+    if (level.size() % 2 == 1)
+    {
+      const ObservationType last = level.back();
+      level.clear();
+      level.push_back(last);
+    }
+    else
+    {
+      level.clear();
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file methods/ivf_pq/ivf_pq_search.hpp
+ *
+ * An inverted file index with product quantization (IVF-PQ) for approximate
+ * nearest neighbor search on large datasets, as described in the following
+ * paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The IVFPQSearch class builds a compressed index on a reference set and uses
+ * it to find the approximate nearest neighbors (in Euclidean distance) of
+ * query points.  The reference set itself is not kept: each reference point is
+ * stored as a code of NumSubspaces() bytes, so large datasets fit in memory.
+ *
+ * The index is built in two steps.  First, the reference points are clustered
+ * with k-means into NumLists() lists (the coarse quantizer), and each point is
+ * put in the list of its closest centroid.  Then the residual of each point
+ * (its difference with the centroid of its list) is split into NumSubspaces()
+ * contiguous blocks of dimensions, and each block is quantized with its own
+ * k-means codebook of NumCodewords() codewords (the product quantizer).
+ *
+ * To search, the NumProbes() lists whose centroids are closest to the query
+ * point are visited.  For each visited list, the squared distances between each
+ * block of the residual of the query and each codeword are computed once (the
+ * asymmetric distance table), and the distance to each point of the list is
+ * then the sum of NumSubspaces() entries of the table.
+ *
+ * @code
+ * IVFPQSearch<> ivfpq(referenceSet, 1000, 16);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * ivfpq.Search(querySet, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MatType Type of dense matrix to use to store the data.
+ */
+template<typename MatType = arma::mat>
+class IVFPQSearch
+{
+ public:
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the IVFPQSearch object without training it.  Be sure to call
+   * Train() before calling Search().
+   *
+   * @param numLists Number of lists (coarse centroids).
+   * @param numSubspaces Number of blocks the residuals are split into (the
+   *     number of bytes of each code).
+   * @param numCodewords Number of codewords for each block (at most 256).
+   * @param numProbes Default number of lists to visit for each query point.
+   * @param maxIterations Maximum number of iterations of each k-means run.
+   */
+  IVFPQSearch(const size_t numLists = 100,
+              const size_t numSubspaces = 8,
+              const size_t numCodewords = 256,
+              const size_t numProbes = 8,
+              const size_t maxIterations = 100);
+
+  /**
+   * Create the IVFPQSearch object and build the index on the given reference
+   * set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of lists (coarse centroids).
+   * @param numSubspaces Number of blocks the residuals are split into (the
+   *     number of bytes of each code).
+   * @param numCodewords Number of codewords for each block (at most 256).
+   * @param numProbes Default number of lists to visit for each query point.
+   * @param maxIterations Maximum number of iterations of each k-means run.
+   */
+  IVFPQSearch(const MatType& referenceSet,
+              const size_t numLists = 100,
+              const size_t numSubspaces = 8,
+              const size_t numCodewords = 256,
+              const size_t numProbes = 8,
+              const size_t maxIterations = 100);
+
+  /**
+   * Build the index on the given reference set, with the current parameters.
+   * Any previous index is discarded.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Search for the approximate k nearest neighbors of each point of the given
+   * query set.  The results are stored in the same format as NeighborSearch
+   * and LSHSearch: column i of neighbors and distances holds the neighbors of
+   * query point i, closest first.  The distances are the (approximate)
+   * distances between the query points and the quantized reference points.  If
+   * fewer than k points are found in the visited lists, the remaining
+   * neighbors are set to SIZE_MAX and their distances to DBL_MAX.
+   *
+   * The query points are handled in parallel (if OpenMP is available), and the
+   * distances to the coarse centroids are computed with a single matrix
+   * product for the whole query set.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the neighbors in.
+   * @param distances Matrix to store the distances in.
+   * @param numProbes Number of lists to visit for each query point; if 0,
+   *     NumProbes() is used.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t numProbes = 0) const;
+
+  //! Get the number of lists.
+  size_t NumLists() const { return numLists; }
+  //! Modify the number of lists (only used by the next call to Train()).
+  size_t& NumLists() { return numLists; }
+
+  //! Get the number of blocks of each code.
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Modify the number of blocks of each code (only used by the next call to
+  //! Train()).
+  size_t& NumSubspaces() { return numSubspaces; }
+
+  //! Get the number of codewords of each block.
+  size_t NumCodewords() const { return numCodewords; }
+  //! Modify the number of codewords of each block (only used by the next call
+  //! to Train()).
+  size_t& NumCodewords() { return numCodewords; }
+
+  //! Get the default number of lists to visit.
+  size_t NumProbes() const { return numProbes; }
+  //! Modify the default number of lists to visit.
+  size_t& NumProbes() { return numProbes; }
+
+  //! Get the maximum number of iterations of k-means.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of k-means.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the coarse centroids (one column per list).
+  const arma::Mat<ElemType>& CoarseCentroids() const { return coarseCentroids; }
+  //! Get the codebook of each block (one column per codeword).
+  const std::vector<arma::Mat<ElemType>>& Codebooks() const
+  { return codebooks; }
+  //! Get the codes of the reference points, in the order of the lists.
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+  //! Get the offsets of the lists in Codes() and ListIndices() (there are
+  //! NumLists() + 1 offsets).
+  const std::vector<size_t>& ListOffsets() const { return listOffsets; }
+  //! Get the index of the reference point of each code.
+  const std::vector<size_t>& ListIndices() const { return listIndices; }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Compute the codes of the given residuals for every block.
+  void Encode(const arma::Mat<ElemType>& residuals,
+              arma::Mat<unsigned char>& residualCodes) const;
+
+  //! The number of lists.
+  size_t numLists;
+  //! The number of blocks of each code.
+  size_t numSubspaces;
+  //! The number of codewords of each block.
+  size_t numCodewords;
+  //! The default number of lists to visit.
+  size_t numProbes;
+  //! The maximum number of iterations of k-means.
+  size_t maxIterations;
+
+  //! The coarse centroids.
+  arma::Mat<ElemType> coarseCentroids;
+  //! The squared norms of the coarse centroids.
+  arma::Col<ElemType> coarseNorms;
+  //! The first dimension of each block (and the number of dimensions last).
+  std::vector<size_t> subspaceBounds;
+  //! The codebook of each block.
+  std::vector<arma::Mat<ElemType>> codebooks;
+  //! The squared norms of the codewords of each block (one column per block).
+  arma::Mat<ElemType> codebookNorms;
+  //! The codes of the reference points, in the order of the lists.
+  arma::Mat<unsigned char> codes;
+  //! The offsets of the lists in codes and listIndices.
+  std::vector<size_t> listOffsets;
+  //! The index of the reference point of each code.
+  std::vector<size_t> listIndices;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ivf_pq_search_impl.hpp"
+
+#endif
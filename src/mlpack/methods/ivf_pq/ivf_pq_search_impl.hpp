@@ -0,0 +1,276 @@
+/**
+ * @file methods/ivf_pq/ivf_pq_search_impl.hpp
+ *
+ * Implementation of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivf_pq_search.hpp"
+
+#include <queue>
+#include <numeric>
+#include <algorithm>
+
+namespace mlpack {
+namespace neighbor {
+
+// Constructor with no training.
+template<typename MatType>
+IVFPQSearch<MatType>::IVFPQSearch(const size_t numLists,
+                                  const size_t numSubspaces,
+                                  const size_t numCodewords,
+                                  const size_t numProbes,
+                                  const size_t maxIterations) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    numCodewords(numCodewords),
+    numProbes(numProbes),
+    maxIterations(maxIterations)
+{
+  // Nothing to do.
+}
+
+// Constructor.
+template<typename MatType>
+IVFPQSearch<MatType>::IVFPQSearch(const MatType& referenceSet,
+                                  const size_t numLists,
+                                  const size_t numSubspaces,
+                                  const size_t numCodewords,
+                                  const size_t numProbes,
+                                  const size_t maxIterations) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    numCodewords(numCodewords),
+    numProbes(numProbes),
+    maxIterations(maxIterations)
+{
+  Train(referenceSet);
+}
+
+// Build the index.
+template<typename MatType>
+void IVFPQSearch<MatType>::Train(const MatType& referenceSet)
+{
+  if (numLists == 0)
+    throw std::invalid_argument("IVFPQSearch::Train(): the number of lists "
+        "must be greater than 0!");
+  if (numSubspaces == 0 || numSubspaces > referenceSet.n_rows)
+    throw std::invalid_argument("IVFPQSearch::Train(): the number of "
+        "subspaces must be between 1 and the dimensionality of the data!");
+  if (numCodewords == 0 || numCodewords > 256)
+    throw std::invalid_argument("IVFPQSearch::Train(): the number of "
+        "codewords must be between 1 and 256!");
+  if (referenceSet.n_cols < std::max(numLists, numCodewords))
+    throw std::invalid_argument("IVFPQSearch::Train(): there must be at least "
+        "as many reference points as lists and codewords!");
+
+  typedef arma::Mat<ElemType> DenseMatType;
+  kmeans::KMeans<metric::EuclideanDistance, kmeans::SampleInitialization,
+      kmeans::MaxVarianceNewCluster, kmeans::NaiveKMeans, DenseMatType>
+      clusterer(maxIterations);
+
+  // Build the coarse quantizer.
+  Log::Info << "Clustering " << referenceSet.n_cols << " points into "
+      << numLists << " lists..." << std::endl;
+  arma::Row<size_t> assignments;
+  clusterer.Cluster(referenceSet, numLists, assignments, coarseCentroids);
+  coarseNorms = arma::sum(arma::square(coarseCentroids), 0).t();
+
+  const DenseMatType residuals = referenceSet -
+      coarseCentroids.cols(arma::conv_to<arma::uvec>::from(assignments));
+
+  // Split the dimensions into blocks whose sizes differ by at most one, and
+  // build the codebook of each block on the residuals.
+  subspaceBounds.resize(numSubspaces + 1);
+  for (size_t s = 0; s <= numSubspaces; ++s)
+    subspaceBounds[s] = (s * referenceSet.n_rows) / numSubspaces;
+
+  Log::Info << "Building " << numSubspaces << " codebooks of " << numCodewords
+      << " codewords..." << std::endl;
+  codebooks.resize(numSubspaces);
+  codebookNorms.set_size(numCodewords, numSubspaces);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const DenseMatType block = residuals.rows(subspaceBounds[s],
+        subspaceBounds[s + 1] - 1);
+    clusterer.Cluster(block, numCodewords, codebooks[s]);
+    codebookNorms.col(s) = arma::sum(arma::square(codebooks[s]), 0).t();
+  }
+
+  arma::Mat<unsigned char> pointCodes;
+  Encode(residuals, pointCodes);
+
+  // Now group the codes by list.
+  listOffsets.assign(numLists + 1, 0);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    ++listOffsets[assignments[i] + 1];
+  for (size_t l = 0; l < numLists; ++l)
+    listOffsets[l + 1] += listOffsets[l];
+
+  std::vector<size_t> positions(listOffsets.begin(), listOffsets.end() - 1);
+  listIndices.resize(referenceSet.n_cols);
+  codes.set_size(numSubspaces, referenceSet.n_cols);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+  {
+    const size_t position = positions[assignments[i]]++;
+    listIndices[position] = i;
+    codes.col(position) = pointCodes.col(i);
+  }
+}
+
+// Search for the approximate nearest neighbors.
+template<typename MatType>
+void IVFPQSearch<MatType>::Search(const MatType& querySet,
+                                  const size_t k,
+                                  arma::Mat<size_t>& neighbors,
+                                  arma::mat& distances,
+                                  const size_t numProbes) const
+{
+  if (coarseCentroids.n_cols == 0)
+    throw std::runtime_error("IVFPQSearch::Search(): index not built!  Call "
+        "Train() first.");
+  if (querySet.n_rows != coarseCentroids.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << coarseCentroids.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Use the shape of the index, and not the parameters, which may have been
+  // modified since the last call to Train().
+  const size_t lists = coarseCentroids.n_cols;
+  const size_t blocks = codebooks.size();
+  const size_t probes = std::min((numProbes == 0) ? this->numProbes :
+      numProbes, lists);
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(DBL_MAX);
+  if (k == 0)
+    return;
+
+  // The squared distances between the query points and the coarse centroids,
+  // up to the squared norm of each query point (which does not change the
+  // order of the lists), with one matrix product.
+  arma::Mat<ElemType> coarseDistances = -2 * coarseCentroids.t() * querySet;
+  coarseDistances.each_col() += coarseNorms;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+  {
+    // Find the lists to visit.
+    std::vector<size_t> order(lists);
+    std::iota(order.begin(), order.end(), 0);
+    const ElemType* listDistances = coarseDistances.colptr(q);
+    std::partial_sort(order.begin(), order.begin() + probes, order.end(),
+        [listDistances](const size_t a, const size_t b)
+        {
+          return listDistances[a] < listDistances[b];
+        });
+
+    typedef std::pair<double, size_t> Candidate;
+    std::priority_queue<Candidate> candidates;
+    arma::Mat<ElemType> table(codebookNorms.n_rows, blocks);
+    for (size_t p = 0; p < probes; ++p)
+    {
+      const size_t list = order[p];
+      if (listOffsets[list] == listOffsets[list + 1])
+        continue;
+
+      // Build the asymmetric distance table of the residual of the query
+      // point: table(c, s) is the squared distance between block s of the
+      // residual and codeword c of block s.
+      const arma::Col<ElemType> residual = querySet.col(q) -
+          coarseCentroids.col(list);
+      for (size_t s = 0; s < blocks; ++s)
+      {
+        const arma::Col<ElemType> block = residual.subvec(subspaceBounds[s],
+            subspaceBounds[s + 1] - 1);
+        table.col(s) = codebookNorms.col(s) - 2 * codebooks[s].t() * block +
+            arma::dot(block, block);
+      }
+
+      for (size_t i = listOffsets[list]; i < listOffsets[list + 1]; ++i)
+      {
+        const unsigned char* code = codes.colptr(i);
+        double distance = 0.0;
+        for (size_t s = 0; s < blocks; ++s)
+          distance += table(code[s], s);
+
+        if (candidates.size() < k)
+          candidates.push(std::make_pair(distance, listIndices[i]));
+        else if (distance < candidates.top().first)
+        {
+          candidates.pop();
+          candidates.push(std::make_pair(distance, listIndices[i]));
+        }
+      }
+    }
+
+    // The worst candidate is on top of the heap.
+    for (size_t i = candidates.size(); i > 0; --i)
+    {
+      neighbors(i - 1, q) = candidates.top().second;
+      distances(i - 1, q) = std::sqrt(std::max(candidates.top().first, 0.0));
+      candidates.pop();
+    }
+  }
+}
+
+// Compute the code of each residual.
+template<typename MatType>
+void IVFPQSearch<MatType>::Encode(
+    const arma::Mat<ElemType>& residuals,
+    arma::Mat<unsigned char>& residualCodes) const
+{
+  residualCodes.set_size(codebooks.size(), residuals.n_cols);
+  for (size_t s = 0; s < codebooks.size(); ++s)
+  {
+    // The closest codeword minimizes ||c||^2 - 2 c^T x.
+    arma::Mat<ElemType> blockDistances = -2 * codebooks[s].t() *
+        residuals.rows(subspaceBounds[s], subspaceBounds[s + 1] - 1);
+    blockDistances.each_col() += codebookNorms.col(s);
+
+    const arma::urowvec closest = arma::index_min(blockDistances, 0);
+    for (size_t i = 0; i < residuals.n_cols; ++i)
+      residualCodes(s, i) = (unsigned char) closest[i];
+  }
+}
+
+//! Serialize the index.
+template<typename MatType>
+template<typename Archive>
+void IVFPQSearch<MatType>::serialize(Archive& ar,
+                                     const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numLists);
+  ar & BOOST_SERIALIZATION_NVP(numSubspaces);
+  ar & BOOST_SERIALIZATION_NVP(numCodewords);
+  ar & BOOST_SERIALIZATION_NVP(numProbes);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(coarseCentroids);
+  ar & BOOST_SERIALIZATION_NVP(coarseNorms);
+  ar & BOOST_SERIALIZATION_NVP(subspaceBounds);
+  if (Archive::is_loading::value)
+    codebooks.clear();
+  ar & BOOST_SERIALIZATION_NVP(codebooks);
+  ar & BOOST_SERIALIZATION_NVP(codebookNorms);
+  ar & BOOST_SERIALIZATION_NVP(codes);
+  ar & BOOST_SERIALIZATION_NVP(listOffsets);
+  ar & BOOST_SERIALIZATION_NVP(listIndices);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
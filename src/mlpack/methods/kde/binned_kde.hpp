@@ -0,0 +1,130 @@
+/**
+ * @file methods/kde/binned_kde.hpp
+ *
+ * Binned kernel density estimation for low-dimensional data, where the kernel
+ * sums on a regular grid are computed with FFT convolutions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_BINNED_KDE_HPP
+#define MLPACK_METHODS_KDE_BINNED_KDE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * BinnedKDE computes kernel sums of 1-, 2- or 3-dimensional data with linear
+ * binning:
+ *
+ * @code
+ * @article{wand1994fast,
+ *   title={Fast Computation of Multivariate Kernel Estimators},
+ *   author={Wand, M.P.},
+ *   journal={Journal of Computational and Graphical Statistics},
+ *   volume={3},
+ *   number={4},
+ *   pages={433--445},
+ *   year={1994}
+ * }
+ * @endcode
+ *
+ * A regular grid with gridSize points in each dimension is laid over the
+ * bounding box of the reference and query points.  Each reference point is
+ * split between the 2^d corners of its grid cell (linear binning), the binned
+ * weights are convolved with the kernel sampled on the grid through FFTs, and
+ * the kernel sum at each query point is interpolated from the corners of its
+ * cell.  This costs O(N + M + G log G) for N references, M queries and G grid
+ * points (instead of tree traversals), so it is well suited to evaluating a
+ * density on a whole grid for plotting; query points that are grid points
+ * get the grid values directly.  The error depends on the grid spacing
+ * relative to the bandwidth, and not on an error tolerance.
+ *
+ * The distances are Euclidean.  Only the Gaussian kernel (truncated at 5
+ * bandwidths) and the Epanechnikov kernel are supported.
+ *
+ * @tparam KernelType Kernel to use (GaussianKernel or EpanechnikovKernel).
+ */
+template<typename KernelType>
+class BinnedKDE
+{
+ public:
+  /**
+   * Create the BinnedKDE object.
+   *
+   * @param kernel Instantiated kernel.
+   * @param gridSize Number of grid points in each dimension (at least 2).
+   */
+  BinnedKDE(const KernelType& kernel, const size_t gridSize);
+
+  /**
+   * Compute the (unnormalized) kernel sum of the reference points at each
+   * query point.
+   *
+   * @param referenceSet Reference points (1 to 3 dimensions).
+   * @param querySet Query points (same dimension as the references).
+   * @param estimations Vector to store the kernel sum of each query point.
+   * @param parallel If true, the queries are interpolated in parallel.
+   */
+  template<typename MatType>
+  void Evaluate(const MatType& referenceSet,
+                const MatType& querySet,
+                arma::vec& estimations,
+                const bool parallel = false) const;
+
+ private:
+  //! Get the support radius of the Gaussian kernel.
+  static double Support(const kernel::GaussianKernel& kernel)
+  {
+    return 5.0 * kernel.Bandwidth();
+  }
+
+  //! Get the support radius of the Epanechnikov kernel.
+  static double Support(const kernel::EpanechnikovKernel& kernel)
+  {
+    return kernel.Bandwidth();
+  }
+
+  //! Other kernels are not supported.
+  template<typename OtherKernelType>
+  static double Support(const OtherKernelType& /* kernel */)
+  {
+    throw std::invalid_argument("BinnedKDE: only the Gaussian and "
+        "Epanechnikov kernels are supported");
+  }
+
+  /**
+   * Find the grid cell of the given coordinate, and the position of the
+   * coordinate in the cell.
+   */
+  void Locate(const double coordinate,
+              const double lower,
+              const double spacing,
+              size_t& cell,
+              double& fraction) const;
+
+  /**
+   * Compute the FFT (or the inverse FFT) of a grid along all of its
+   * dimensions.
+   */
+  static void Transform(arma::cx_cube& grid, const bool inverse);
+
+  //! The instantiated kernel.
+  const KernelType& kernel;
+  //! Number of grid points in each dimension.
+  size_t gridSize;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "binned_kde_impl.hpp"
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file methods/kde/binned_kde_impl.hpp
+ *
+ * Implementation of binned kernel density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_BINNED_KDE_IMPL_HPP
+#define MLPACK_METHODS_KDE_BINNED_KDE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binned_kde.hpp"
+
+namespace mlpack {
+namespace kde {
+
+template<typename KernelType>
+BinnedKDE<KernelType>::BinnedKDE(const KernelType& kernel,
+                                 const size_t gridSize) :
+    kernel(kernel),
+    gridSize(gridSize)
+{
+  if (gridSize < 2)
+  {
+    throw std::invalid_argument("BinnedKDE: the grid size must be at least "
+        "2");
+  }
+}
+
+template<typename KernelType>
+template<typename MatType>
+void BinnedKDE<KernelType>::Evaluate(const MatType& referenceSet,
+                                     const MatType& querySet,
+                                     arma::vec& estimations,
+                                     const bool parallel) const
+{
+  const size_t dimensionality = referenceSet.n_rows;
+  if (dimensionality == 0 || dimensionality > 3)
+  {
+    throw std::invalid_argument("BinnedKDE: only 1, 2 or 3-dimensional data "
+        "is supported");
+  }
+
+  if (querySet.n_rows != dimensionality)
+  {
+    throw std::invalid_argument("BinnedKDE: querySet and referenceSet "
+        "dimensions don't match");
+  }
+
+  const double support = Support(kernel);
+
+  // The grid covers the bounding box of all the points.  The unused
+  // dimensions have a single grid point.
+  double lower[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  size_t sizes[3] = { 1, 1, 1 };
+  size_t fftSizes[3] = { 1, 1, 1 };
+  size_t offsets[3] = { 0, 0, 0 };
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    double lo = DBL_MAX;
+    double hi = -DBL_MAX;
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+    {
+      lo = std::min(lo, (double) referenceSet(d, i));
+      hi = std::max(hi, (double) referenceSet(d, i));
+    }
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      lo = std::min(lo, (double) querySet(d, i));
+      hi = std::max(hi, (double) querySet(d, i));
+    }
+
+    lower[d] = lo;
+    spacing[d] = (hi > lo) ? (hi - lo) / (gridSize - 1) : 1.0;
+    sizes[d] = gridSize;
+
+    // Number of grid spacings in the support of the kernel; farther grid
+    // points do not need to be convolved.
+    offsets[d] = std::min(gridSize - 1,
+        (size_t) std::ceil(support / spacing[d]));
+
+    // A circular convolution of this size gives the linear convolution on the
+    // grid.  Powers of 2 are the fastest sizes for the FFT.
+    fftSizes[d] = 1;
+    while (fftSizes[d] < sizes[d] + offsets[d])
+      fftSizes[d] *= 2;
+  }
+
+  // Linear binning of the reference points.
+  arma::cx_cube grid(fftSizes[0], fftSizes[1], fftSizes[2], arma::fill::zeros);
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  {
+    size_t cells[3] = { 0, 0, 0 };
+    double fractions[3] = { 0.0, 0.0, 0.0 };
+    for (size_t d = 0; d < dimensionality; ++d)
+      Locate(referenceSet(d, i), lower[d], spacing[d], cells[d], fractions[d]);
+
+    for (size_t corner = 0; corner < (size_t(1) << dimensionality); ++corner)
+    {
+      double weight = 1.0;
+      size_t index[3] = { 0, 0, 0 };
+      for (size_t d = 0; d < dimensionality; ++d)
+      {
+        const bool upper = (corner >> d) & 1;
+        weight *= upper ? fractions[d] : (1.0 - fractions[d]);
+        index[d] = cells[d] + (upper ? 1 : 0);
+      }
+      grid(index[0], index[1], index[2]) += weight;
+    }
+  }
+
+  // Sample the kernel on the grid offsets, with the negative offsets wrapped
+  // around.
+  arma::cx_cube kernelGrid(fftSizes[0], fftSizes[1], fftSizes[2],
+      arma::fill::zeros);
+  const long l0 = offsets[0], l1 = offsets[1], l2 = offsets[2];
+  for (long k = -l2; k <= l2; ++k)
+  {
+    for (long j = -l1; j <= l1; ++j)
+    {
+      for (long i = -l0; i <= l0; ++i)
+      {
+        const double distance = std::sqrt(
+            std::pow(i * spacing[0], 2.0) +
+            std::pow(j * spacing[1], 2.0) +
+            std::pow(k * spacing[2], 2.0));
+        kernelGrid((i < 0) ? fftSizes[0] + i : i,
+                   (j < 0) ? fftSizes[1] + j : j,
+                   (k < 0) ? fftSizes[2] + k : k) = kernel.Evaluate(distance);
+      }
+    }
+  }
+
+  // Convolve.
+  Transform(grid, false);
+  Transform(kernelGrid, false);
+  grid %= kernelGrid;
+  Transform(grid, true);
+  const arma::cube sums = arma::real(grid.subcube(0, 0, 0, sizes[0] - 1,
+      sizes[1] - 1, sizes[2] - 1));
+
+  // Interpolate the sums at the query points.
+  estimations.set_size(querySet.n_cols);
+  #pragma omp parallel for if (parallel)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+  {
+    size_t cells[3] = { 0, 0, 0 };
+    double fractions[3] = { 0.0, 0.0, 0.0 };
+    for (size_t d = 0; d < dimensionality; ++d)
+      Locate(querySet(d, q), lower[d], spacing[d], cells[d], fractions[d]);
+
+    double estimation = 0.0;
+    for (size_t corner = 0; corner < (size_t(1) << dimensionality); ++corner)
+    {
+      double weight = 1.0;
+      size_t index[3] = { 0, 0, 0 };
+      for (size_t d = 0; d < dimensionality; ++d)
+      {
+        const bool upper = (corner >> d) & 1;
+        weight *= upper ? fractions[d] : (1.0 - fractions[d]);
+        index[d] = cells[d] + (upper ? 1 : 0);
+      }
+      if (weight > 0.0)
+        estimation += weight * sums(index[0], index[1], index[2]);
+    }
+
+    // Rounding errors of the FFT can make empty regions slightly negative.
+    estimations[q] = std::max(estimation, 0.0);
+  }
+}
+
+template<typename KernelType>
+void BinnedKDE<KernelType>::Locate(const double coordinate,
+                                   const double lower,
+                                   const double spacing,
+                                   size_t& cell,
+                                   double& fraction) const
+{
+  const double position = std::max((coordinate - lower) / spacing, 0.0);
+  cell = std::min((size_t) position, gridSize - 2);
+  fraction = std::min(position - cell, 1.0);
+}
+
+template<typename KernelType>
+void BinnedKDE<KernelType>::Transform(arma::cx_cube& grid, const bool inverse)
+{
+  // Transform the first two dimensions of each slice.
+  for (size_t s = 0; s < grid.n_slices; ++s)
+  {
+    grid.slice(s) = inverse ? arma::cx_mat(arma::ifft2(grid.slice(s))) :
+        arma::cx_mat(arma::fft2(grid.slice(s)));
+  }
+
+  // Then transform along the slices: each row of this alias of the grid is
+  // one tube.
+  if (grid.n_slices > 1)
+  {
+    arma::cx_mat tubes(grid.memptr(), grid.n_rows * grid.n_cols,
+        grid.n_slices, false, true);
+    if (inverse)
+      tubes = arma::ifft(arma::cx_mat(tubes.st())).st();
+    else
+      tubes = arma::fft(arma::cx_mat(tubes.st())).st();
+  }
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -15,8 +15,11 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_query_blocks.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "kde_stat.hpp"
+#include "binned_kde.hpp"
 
 namespace mlpack {
 namespace kde /** Kernel Density Estimation. */ {
@@ -25,7 +28,9 @@ namespace kde /** Kernel Density Estimation. */ {
 enum KDEMode
 {
   DUAL_TREE_MODE,
-  SINGLE_TREE_MODE
+  SINGLE_TREE_MODE,
+  //! Linear binning on a grid and FFT convolution (see BinnedKDE).
+  BINNED_MODE
 };
 
 //! KDEDefaultParams contains the default input parameter values for KDE.
@@ -55,6 +60,15 @@ struct KDEDefaultParams
 
   //! Monte Carlo break coefficient.
   static constexpr double mcBreakCoef = 0.4;
+
+  //! Whether to use series expansions when possible.
+  static constexpr bool seriesExpansion = false;
+
+  //! Order of the series expansions in each dimension.
+  static constexpr size_t seriesOrder = 6;
+
+  //! Number of grid points in each dimension in binned mode.
+  static constexpr size_t gridSize = 128;
 };
 
 /**
@@ -64,6 +78,12 @@ struct KDEDefaultParams
  * This implementation performs this estimation using a tree-independent
  * dual-tree algorithm. Details about this algorithm are available in KDERules.
  *
+ * For 1-, 2- or 3-dimensional data with the Gaussian or Epanechnikov kernel,
+ * BINNED_MODE instead bins the reference points on a regular grid and convolves
+ * them with the kernel through FFTs (see BinnedKDE); this is much faster for
+ * large query sets such as plotting grids, but the error tolerances do not
+ * apply and the metric must be the Euclidean distance.
+ *
  * @tparam KernelType Kernel function to use for KDE calculations.
  * @tparam MetricType Metric to use for KDE calculations.
  * @tparam MatType Type of data to use.
@@ -110,6 +130,10 @@ class KDE
    * @param mcBreakCoef Coefficient to control what fraction of the node's
    *                    descendants evaluated is the limit before Monte Carlo
    *                    estimation recurses.
+   * @param seriesExpansion Whether to use Hermite series expansions when
+   *                        possible (only used with the Gaussian kernel).
+   * @param seriesOrder Order of the series expansions in each dimension.
+   * @param gridSize Number of grid points in each dimension in binned mode.
    */
   KDE(const double relError = KDEDefaultParams::relError,
       const double absError = KDEDefaultParams::absError,
@@ -120,7 +144,10 @@ class KDE
       const double mcProb = KDEDefaultParams::mcProb,
       const size_t initialSampleSize = KDEDefaultParams::initialSampleSize,
       const double mcEntryCoef = KDEDefaultParams::mcEntryCoef,
-      const double mcBreakCoef = KDEDefaultParams::mcBreakCoef);
+      const double mcBreakCoef = KDEDefaultParams::mcBreakCoef,
+      const bool seriesExpansion = KDEDefaultParams::seriesExpansion,
+      const size_t seriesOrder = KDEDefaultParams::seriesOrder,
+      const size_t gridSize = KDEDefaultParams::gridSize);
 
   /**
    * Construct KDE object as a copy of the given model. This may be
@@ -265,6 +292,18 @@ class KDE
   //! Modify whether Monte Carlo estimations are being used or not.
   bool& MonteCarlo() { return monteCarlo; }
 
+  /**
+   * Get whether queries are evaluated in parallel (if OpenMP is available).
+   * In dual-tree mode the query tree is split into disjoint subtrees, in
+   * single-tree mode the query points are split into blocks, and each thread
+   * evaluates its part with its own copy of the rules.  Trees with
+   * self-children (like the cover tree) are always evaluated serially.
+   */
+  bool ParallelQueries() const { return parallelQueries; }
+
+  //! Modify whether queries are evaluated in parallel.
+  bool& ParallelQueries() { return parallelQueries; }
+
   //! Get Monte Carlo probability of error being bounded by relative error.
   double MCProb() const { return mcProb; }
 
@@ -290,6 +329,31 @@ class KDE
   //! Modify Monte Carlo break coefficient. (0 < newCoef <= 1).
   void MCBreakCoef(const double newCoef);
 
+  /**
+   * Get whether series expansions are being used or not.  With the Gaussian
+   * kernel, the contribution of a reference node with more points than its
+   * expansion has coefficients may be approximated by a truncated Hermite
+   * series when its error bound fits in the tolerance.
+   */
+  bool SeriesExpansion() const { return seriesExpansion; }
+
+  //! Modify whether series expansions are being used or not.
+  bool& SeriesExpansion() { return seriesExpansion; }
+
+  //! Get the order of the series expansions in each dimension.
+  size_t SeriesOrder() const { return seriesOrder; }
+
+  //! Modify the order of the series expansions in each dimension.
+  //! (newOrder > 0).
+  void SeriesOrder(const size_t newOrder);
+
+  //! Get the number of grid points in each dimension in binned mode.
+  size_t GridSize() const { return gridSize; }
+
+  //! Modify the number of grid points in each dimension in binned mode.
+  //! (newSize >= 2).
+  void GridSize(const size_t newSize);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
@@ -341,9 +405,55 @@ class KDE
   //! is the limit before Monte Carlo estimation recurses.
   double mcBreakCoef;
 
+  //! If true, queries are evaluated in parallel.
+  bool parallelQueries;
+
+  //! If true, series expansions will be used when possible.
+  bool seriesExpansion;
+
+  //! Order of the series expansions in each dimension.
+  size_t seriesOrder;
+
+  //! Number of grid points in each dimension in binned mode.
+  size_t gridSize;
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
+  /**
+   * Run the dual-tree traversal of the given query tree against the reference
+   * tree with the given rules.  If parallelQueries is set, the query tree is
+   * split into disjoint subtrees which are traversed in parallel.  The error
+   * tolerance of each query point is tracked in the statistics of its own
+   * query nodes, so each subtree has its own share of the error budget and no
+   * tolerance is shared between threads.
+   *
+   * @param rules Rules of the estimation.
+   * @param queryTree Root of the query tree.
+   */
+  template<typename RuleType>
+  void DualTreeEvaluate(RuleType& rules, Tree& queryTree);
+
+  /**
+   * Run the single-tree traversal for each query point with the given rules.
+   * If parallelQueries is set, blocks of query points are traversed in
+   * parallel.
+   *
+   * @param rules Rules of the estimation.
+   * @param numQueries Number of query points.
+   */
+  template<typename RuleType>
+  void SingleTreeEvaluate(RuleType& rules, const size_t numQueries);
+
+  /**
+   * Estimate the density at the given query points with BinnedKDE.  The
+   * metric must be the Euclidean distance.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Vector to store the estimations.
+   */
+  void BinnedEvaluate(const MatType& querySet, arma::vec& estimations);
+
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
@@ -377,7 +487,7 @@ struct version<mlpack::kde::KDE<KernelType,
                                 DualTreeTraversalType,
                                 SingleTreeTraversalType>>
 {
-  typedef mpl::int_<1> type;
+  typedef mpl::int_<3> type;
   typedef mpl::integral_c_tag tag;
   BOOST_STATIC_CONSTANT(int, value = version::type::value);
   BOOST_MPL_ASSERT((boost::mpl::less<boost::mpl::int_<1>,
@@ -61,7 +61,10 @@ KDE(const double relError,
     const double mcProb,
     const size_t initialSampleSize,
     const double mcEntryCoef,
-    const double mcBreakCoef) :
+    const double mcBreakCoef,
+    const bool seriesExpansion,
+    const size_t seriesOrder,
+    const size_t gridSize) :
     kernel(kernel),
     metric(metric),
     referenceTree(nullptr),
@@ -72,12 +75,16 @@ KDE(const double relError,
     trained(false),
     mode(mode),
     monteCarlo(monteCarlo),
-    initialSampleSize(initialSampleSize)
+    initialSampleSize(initialSampleSize),
+    parallelQueries(false),
+    seriesExpansion(seriesExpansion)
 {
   CheckErrorValues(relError, absError);
   MCProb(mcProb);
   MCEntryCoef(mcEntryCoef);
   MCBreakCoef(mcBreakCoef);
+  SeriesOrder(seriesOrder);
+  GridSize(gridSize);
 }
 
 template<typename KernelType,
@@ -106,7 +113,11 @@ KDE(const KDE& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    parallelQueries(other.parallelQueries),
+    seriesExpansion(other.seriesExpansion),
+    seriesOrder(other.seriesOrder),
+    gridSize(other.gridSize)
 {
   if (trained)
   {
@@ -152,7 +163,11 @@ KDE(KDE&& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    parallelQueries(other.parallelQueries),
+    seriesExpansion(other.seriesExpansion),
+    seriesOrder(other.seriesOrder),
+    gridSize(other.gridSize)
 {
   other.kernel = std::move(KernelType());
   other.metric = std::move(MetricType());
@@ -168,6 +183,10 @@ KDE(KDE&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.parallelQueries = false;
+  other.seriesExpansion = KDEDefaultParams::seriesExpansion;
+  other.seriesOrder = KDEDefaultParams::seriesOrder;
+  other.gridSize = KDEDefaultParams::gridSize;
 }
 
 template<typename KernelType,
@@ -214,6 +233,10 @@ operator=(KDE other)
   this->initialSampleSize = other.initialSampleSize;
   this->mcEntryCoef = other.mcEntryCoef;
   this->mcBreakCoef = other.mcBreakCoef;
+  this->parallelQueries = other.parallelQueries;
+  this->seriesExpansion = other.seriesExpansion;
+  this->seriesOrder = other.seriesOrder;
+  this->gridSize = other.gridSize;
 
   return *this;
 }
@@ -348,6 +371,35 @@ Evaluate(MatType querySet, arma::vec& estimations)
     }
     delete queryTree;
   }
+  else if (mode == BINNED_MODE)
+  {
+    // Check whether has already been trained.
+    if (!trained)
+    {
+      throw std::runtime_error("cannot evaluate KDE model: model needs to be "
+                               "trained before evaluation");
+    }
+
+    // Check querySet has at least 1 element to evaluate.
+    if (querySet.n_cols == 0)
+    {
+      estimations.clear();
+      Log::Warn << "KDE::Evaluate(): querySet is empty, no predictions will "
+                << "be returned" << std::endl;
+      return;
+    }
+
+    // Check whether dimensions match.
+    if (querySet.n_rows != referenceTree->Dataset().n_rows)
+    {
+      throw std::invalid_argument("cannot evaluate KDE model: querySet and "
+                                  "referenceSet dimensions don't match");
+    }
+
+    Timer::Start("computing_kde");
+    BinnedEvaluate(querySet, estimations);
+    Timer::Stop("computing_kde");
+  }
   else if (mode == SINGLE_TREE_MODE)
   {
     // Get estimations vector ready.
@@ -393,14 +445,12 @@ Evaluate(MatType querySet, arma::vec& estimations)
                               metric,
                               kernel,
                               monteCarlo,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
+                              false,
+                              seriesExpansion,
+                              seriesOrder);
 
     // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeEvaluate(rules, querySet.n_cols);
 
     estimations /= referenceTree->Dataset().n_cols;
     Timer::Stop("computing_kde");
@@ -491,11 +541,11 @@ Evaluate(Tree* queryTree,
                             metric,
                             kernel,
                             monteCarlo,
-                            false);
+                            false,
+                            seriesExpansion,
+                            seriesOrder);
 
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeEvaluate(rules, *queryTree);
   estimations /= referenceTree->Dataset().n_cols;
   Timer::Stop("computing_kde");
 
@@ -529,6 +579,21 @@ Evaluate(arma::vec& estimations)
                              "trained before evaluation");
   }
 
+  if (mode == BINNED_MODE)
+  {
+    Timer::Start("computing_kde");
+    BinnedEvaluate(referenceTree->Dataset(), estimations);
+
+    // Remove the contribution of each point to its own estimation.
+    const double selfContribution = kernel.Evaluate(0.0) /
+        referenceTree->Dataset().n_cols;
+    estimations = arma::clamp(estimations - selfContribution, 0.0, DBL_MAX);
+
+    RearrangeEstimations(*oldFromNewReferences, estimations);
+    Timer::Stop("computing_kde");
+    return;
+  }
+
   // Get estimations vector ready.
   estimations.clear();
   estimations.set_size(referenceTree->Dataset().n_cols);
@@ -560,20 +625,14 @@ Evaluate(arma::vec& estimations)
                             metric,
                             kernel,
                             monteCarlo,
-                            true);
+                            true,
+                            seriesExpansion,
+                            seriesOrder);
 
   if (mode == DUAL_TREE_MODE)
-  {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
-  }
+    DualTreeEvaluate(rules, *referenceTree);
   else if (mode == SINGLE_TREE_MODE)
-  {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-  }
+    SingleTreeEvaluate(rules, referenceTree->Dataset().n_cols);
 
   estimations /= referenceTree->Dataset().n_cols;
   // Rearrange if necessary.
@@ -697,6 +756,54 @@ MCBreakCoef(const double newCoef)
   mcBreakCoef = newCoef;
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SeriesOrder(const size_t newOrder)
+{
+  if (newOrder == 0)
+  {
+    throw std::invalid_argument("series expansion order must be a value "
+                                "greater than 0");
+  }
+  seriesOrder = newOrder;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+GridSize(const size_t newSize)
+{
+  if (newSize < 2)
+  {
+    throw std::invalid_argument("grid size must be a value greater than or "
+                                "equal to 2");
+  }
+  gridSize = newSize;
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -739,6 +846,25 @@ serialize(Archive& ar, const unsigned int version)
     mcBreakCoef = KDEDefaultParams::mcBreakCoef;
   }
 
+  // Backward compatibility: Old versions of KDE did not have series
+  // expansions.
+  if (version > 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(seriesExpansion);
+    ar & BOOST_SERIALIZATION_NVP(seriesOrder);
+  }
+  else if (Archive::is_loading::value)
+  {
+    seriesExpansion = KDEDefaultParams::seriesExpansion;
+    seriesOrder = KDEDefaultParams::seriesOrder;
+  }
+
+  // Backward compatibility: Old versions of KDE did not have a binned mode.
+  if (version > 2)
+    ar & BOOST_SERIALIZATION_NVP(gridSize);
+  else if (Archive::is_loading::value)
+    gridSize = KDEDefaultParams::gridSize;
+
   // If we are loading, clean up memory if necessary.
   if (Archive::is_loading::value)
   {
@@ -786,6 +912,38 @@ CheckErrorValues(const double relError, const double absError)
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+BinnedEvaluate(const MatType& querySet, arma::vec& estimations)
+{
+  if (!std::is_same<MetricType, metric::EuclideanDistance>::value)
+  {
+    throw std::invalid_argument("cannot evaluate KDE model: binned mode "
+                                "requires the Euclidean distance");
+  }
+
+  BinnedKDE<KernelType> binned(kernel, gridSize);
+  binned.Evaluate(referenceTree->Dataset(), querySet, estimations,
+      parallelQueries);
+  estimations /= referenceTree->Dataset().n_cols;
+
+  Log::Info << "Binned " << referenceTree->Dataset().n_cols << " reference "
+      << "points on a grid of " << gridSize << " points per dimension."
+      << std::endl;
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -816,5 +974,173 @@ RearrangeEstimations(const std::vector<size_t>& oldFromNew,
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeEvaluate(RuleType& rules, Tree& queryTree)
+{
+  #ifdef HAS_OPENMP
+    const size_t threads = omp_get_max_threads();
+  #else
+    const size_t threads = 1;
+  #endif
+
+  // The series expansions of the reference tree are computed before the
+  // traversal, so that it only reads them.
+  rules.ComputeSeries(*referenceTree);
+
+  // Split the query tree into disjoint subtrees, with several subtrees per
+  // thread so that dynamic scheduling can balance their different costs.
+  std::vector<Tree*> tasks(1, &queryTree);
+  if (parallelQueries && !tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    bool split = true;
+    while (split && tasks.size() < 8 * threads)
+    {
+      split = false;
+      std::vector<Tree*> children;
+      for (size_t i = 0; i < tasks.size(); ++i)
+      {
+        if (tasks[i]->IsLeaf())
+        {
+          children.push_back(tasks[i]);
+          continue;
+        }
+
+        split = true;
+        for (size_t j = 0; j < tasks[i]->NumChildren(); ++j)
+          children.push_back(&tasks[i]->Child(j));
+      }
+      tasks.swap(children);
+    }
+  }
+
+  tree::TraversalStatistics statistics;
+  if (tasks.size() == 1)
+  {
+    DualTreeTraversalType<RuleType> traverser(rules);
+    tree::CollectTraversalStatistics(traverser, statistics);
+    traverser.Traverse(queryTree, *referenceTree);
+    statistics.Print();
+    return;
+  }
+
+  // Score the roots first, like the serial traversal would.  After that, the
+  // threads only read the statistics of the reference tree.
+  rules.ComputeAlphas(*referenceTree);
+  if (rules.Score(queryTree, *referenceTree) == DBL_MAX)
+    return;
+
+  const typename RuleType::TraversalInfoType traversalInfo =
+      rules.TraversalInfo();
+  const size_t seed = (size_t) math::randGen();
+
+  #pragma omp parallel
+  {
+    // The query subtrees of the tasks are disjoint, so each thread writes
+    // estimations (and error tolerances) for its own query points only.
+    RuleType threadRules(rules);
+    threadRules.BaseCases() = 0;
+    threadRules.Scores() = 0;
+    std::vector<Tree*> threadTasks;
+    tree::TraversalStatistics threadStatistics;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+    {
+      threadTasks.push_back(tasks[i]);
+      threadRules.TraversalInfo() = traversalInfo;
+      threadRules.Seed(seed + i);
+
+      // The serial traversal would score each subtree against the reference
+      // root before descending into it.
+      if (threadRules.Score(*tasks[i], *referenceTree) == DBL_MAX)
+        continue;
+
+      // The levels of the statistics are counted from the query subtree.
+      DualTreeTraversalType<RuleType> traverser(threadRules);
+      tree::CollectTraversalStatistics(traverser, threadStatistics);
+      traverser.Traverse(*tasks[i], *referenceTree);
+    }
+
+    // The implicit barrier of the loop above guarantees that every thread has
+    // copied the rules before any results are merged back.
+    #pragma omp critical(KDEDualTreeEvaluateMerge)
+    {
+      rules.Merge(threadRules, threadTasks);
+      rules.BaseCases() += threadRules.BaseCases();
+      rules.Scores() += threadRules.Scores();
+      statistics += threadStatistics;
+    }
+  }
+
+  statistics.Print();
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeEvaluate(RuleType& rules, const size_t numQueries)
+{
+  const bool parallel = parallelQueries &&
+      !tree::TreeTraits<Tree>::HasSelfChildren;
+
+  // The series expansions of the reference tree are computed before the
+  // traversal, so that it only reads them.
+  rules.ComputeSeries(*referenceTree);
+
+  // When the blocks are searched in parallel, each block samples with its own
+  // seed, and the threads only read the statistics of the reference tree.
+  size_t seed = 0;
+  if (parallel)
+  {
+    rules.ComputeAlphas(*referenceTree);
+    seed = (size_t) math::randGen();
+  }
+
+  tree::TraversalStatistics statistics;
+  tree::ParallelQueryBlocks(rules, numQueries, parallel,
+      [&](RuleType& blockRules, const size_t begin, const size_t end)
+      {
+        if (parallel)
+          blockRules.Seed(seed + begin);
+
+        SingleTreeTraversalType<RuleType> traverser(blockRules);
+        tree::TraversalStatistics blockStatistics;
+        tree::CollectTraversalStatistics(traverser, blockStatistics);
+        for (size_t i = begin; i < end; ++i)
+          traverser.Traverse(i, *referenceTree);
+
+        #pragma omp critical(KDEStatistics)
+        statistics += blockStatistics;
+      });
+
+  statistics.Print();
+}
+
 } // namespace kde
 } // namespace mlpack
@@ -72,7 +72,24 @@ BINDING_LONG_DESC(
     "computations an exact approach would take, this program recurses the tree "
     "whenever a fraction of the amount of the node's descendant points have "
     "already been computed. This fraction is set using " +
-    PRINT_PARAM_STRING("mc_break_coef") + ".");
+    PRINT_PARAM_STRING("mc_break_coef") + "."
+    "\n\n"
+    "With the Gaussian kernel, the contribution of large reference nodes can "
+    "also be approximated with truncated Hermite series expansions (as in the "
+    "fast Gauss transform), which keep the error guarantee. To enable series "
+    "expansions, the " + PRINT_PARAM_STRING("series_expansion") + " flag can "
+    "be used, and the order of the expansions in each dimension can be set "
+    "with the " + PRINT_PARAM_STRING("series_order") + " option. Since an "
+    "expansion has (order ^ dimensionality) coefficients, this is mostly "
+    "useful for low-dimensional data."
+    "\n\n"
+    "For 1, 2 or 3-dimensional data with the Gaussian or Epanechnikov kernel, "
+    "the 'binned' algorithm bins the reference points on a regular grid and "
+    "convolves them with the kernel using FFTs, which is much faster to "
+    "evaluate the density on many query points (such as a plotting grid).  The "
+    "number of grid points in each dimension can be set with " +
+    PRINT_PARAM_STRING("grid_size") + "; the error tolerances do not apply to "
+    "this algorithm.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -152,7 +169,7 @@ PARAM_STRING_IN("tree", "Tree to use for the prediction."
     "('kd-tree', 'ball-tree', 'cover-tree', 'octree', 'r-tree').",
     "t", "kd-tree");
 PARAM_STRING_IN("algorithm", "Algorithm to use for the prediction."
-    "('dual-tree', 'single-tree').",
+    "('dual-tree', 'single-tree', 'binned').",
     "a", "dual-tree");
 PARAM_DOUBLE_IN("rel_error",
                 "Relative error tolerance for the prediction.",
@@ -185,6 +202,22 @@ PARAM_DOUBLE_IN("mc_break_coef",
                 "the limit for the sample size before it recurses.",
                 "c",
                 KDEDefaultParams::mcBreakCoef);
+PARAM_FLAG("series_expansion",
+           "Whether to use Hermite series expansions when possible.",
+           "");
+PARAM_INT_IN("series_order",
+             "Order of the series expansions in each dimension.",
+             "",
+             KDEDefaultParams::seriesOrder);
+PARAM_INT_IN("grid_size",
+             "Number of grid points in each dimension for the 'binned' "
+             "algorithm.",
+             "",
+             KDEDefaultParams::gridSize);
+PARAM_FLAG("parallel_queries",
+           "If set, the queries are evaluated in parallel (if OpenMP is "
+           "available).",
+           "");
 
 // Output predictions options.
 PARAM_COL_OUT("predictions", "Vector to store density predictions.",
@@ -206,6 +239,9 @@ static void mlpackMain()
   const int initialSampleSize = IO::GetParam<int>("initial_sample_size");
   const double mcEntryCoef = IO::GetParam<double>("mc_entry_coef");
   const double mcBreakCoef = IO::GetParam<double>("mc_break_coef");
+  const bool seriesExpansion = IO::GetParam<bool>("series_expansion");
+  const int seriesOrder = IO::GetParam<int>("series_order");
+  const int gridSize = IO::GetParam<int>("grid_size");
 
   // Initialize results vector.
   arma::vec estimations;
@@ -226,13 +262,35 @@ static void mlpackMain()
                        "Monte Carlo only works with Gaussian kernel");
   }
 
+  // The series order only makes sense if series expansions are activated.
+  ReportIgnoredParam({{ "series_expansion", false }}, "series_order");
+  if (seriesExpansion && kernelStr != "gaussian")
+  {
+    ReportIgnoredParam("series_expansion",
+                       "series expansions only work with Gaussian kernel");
+  }
+
+  // The grid size only makes sense with the binned algorithm, which needs a
+  // kernel with a known support.
+  if (modeStr != "binned" && IO::HasParam("grid_size"))
+  {
+    ReportIgnoredParam("grid_size",
+                       "the grid size is only used by the binned algorithm");
+  }
+  if (modeStr == "binned" && IO::HasParam("reference") &&
+      kernelStr != "gaussian" && kernelStr != "epanechnikov")
+  {
+    Log::Fatal << "The binned algorithm only works with the Gaussian and "
+        << "Epanechnikov kernels." << std::endl;
+  }
+
   // Requirements for parameter values.
   RequireParamInSet<string>("kernel", { "gaussian", "epanechnikov",
       "laplacian", "spherical", "triangular" }, true, "unknown kernel type");
   RequireParamInSet<string>("tree", { "kd-tree", "ball-tree", "cover-tree",
       "octree", "r-tree"}, true, "unknown tree type");
-  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree"},
-      true, "unknown algorithm");
+  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree",
+      "binned" }, true, "unknown algorithm");
   RequireParamValue<double>("rel_error", [](double x){return x >= 0 && x <= 1;},
       true, "relative error must be between 0 and 1");
   RequireParamValue<double>("abs_error", [](double x){return x >= 0;},
@@ -249,6 +307,10 @@ static void mlpackMain()
       [](double x){return x > 0 && x <= 1;}, true,
       "Monte Carlo break coefficient must be greater than 0 and less than "
       "or equal to 1");
+  RequireParamValue<int>("series_order", [](int x){return x > 0;},
+      true, "series order must be greater than 0");
+  RequireParamValue<int>("grid_size", [](int x){return x >= 2;},
+      true, "grid size must be at least 2");
 
   KDEModel* kde;
 
@@ -290,6 +352,8 @@ static void mlpackMain()
       kde->Mode() = KDEMode::DUAL_TREE_MODE;
     else if (modeStr == "single-tree")
       kde->Mode() = KDEMode::SINGLE_TREE_MODE;
+    else if (modeStr == "binned")
+      kde->Mode() = KDEMode::BINNED_MODE;
   }
   else
   {
@@ -306,6 +370,10 @@ static void mlpackMain()
   kde->MCInitialSampleSize(initialSampleSize);
   kde->MCEntryCoefficient(mcEntryCoef);
   kde->MCBreakCoefficient(mcBreakCoef);
+  kde->SeriesExpansion(seriesExpansion);
+  kde->SeriesOrder(seriesOrder);
+  kde->GridSize(gridSize);
+  kde->ParallelQueries() = IO::HasParam("parallel_queries");
 
   // Evaluation.
   if (IO::HasParam("query"))
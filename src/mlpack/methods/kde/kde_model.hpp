@@ -340,6 +340,71 @@ class MCBreakCoefVisitor : public boost::static_visitor<void>
   MCBreakCoefVisitor(const double breakCoef);
 };
 
+/**
+ * SeriesExpansionVisitor activates or deactivates series expansions for a given
+ * KDEType.
+ */
+class SeriesExpansionVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Whether to use series expansions or not.
+  const bool seriesExpansion;
+
+ public:
+  //! Default SeriesExpansionVisitor on some KDEType.
+  template<typename KernelType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(KDEType<KernelType, TreeType>* kde) const;
+
+  //! SeriesExpansionVisitor constructor.
+  SeriesExpansionVisitor(const bool seriesExpansion);
+};
+
+/**
+ * SeriesOrderVisitor sets the order of the series expansions.
+ */
+class SeriesOrderVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Order of the series expansions.
+  const size_t seriesOrder;
+
+ public:
+  //! Default SeriesOrderVisitor on some KDEType.
+  template<typename KernelType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(KDEType<KernelType, TreeType>* kde) const;
+
+  //! SeriesOrderVisitor constructor.
+  SeriesOrderVisitor(const size_t seriesOrder);
+};
+
+/**
+ * GridSizeVisitor sets the number of grid points in each dimension in binned
+ * mode.
+ */
+class GridSizeVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Number of grid points in each dimension.
+  const size_t gridSize;
+
+ public:
+  //! Default GridSizeVisitor on some KDEType.
+  template<typename KernelType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(KDEType<KernelType, TreeType>* kde) const;
+
+  //! GridSizeVisitor constructor.
+  GridSizeVisitor(const size_t gridSize);
+};
+
 /**
  * ModeVisitor exposes the Mode() method of the KDEType.
  */
@@ -351,6 +416,17 @@ class ModeVisitor : public boost::static_visitor<KDEMode&>
   KDEMode& operator()(KDEType* kde) const;
 };
 
+/**
+ * ParallelQueriesVisitor exposes the ParallelQueries() method of the KDEType.
+ */
+class ParallelQueriesVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  //! Return whether queries of the KDEType instance are run in parallel.
+  template<typename KDEType>
+  bool& operator()(KDEType* kde) const;
+};
+
 class DeleteVisitor : public boost::static_visitor<void>
 {
  public:
@@ -412,6 +488,15 @@ class KDEModel
   //! Break coefficient for Monte Carlo estimations.
   double mcBreakCoef;
 
+  //! Whether series expansions will be used.
+  bool seriesExpansion;
+
+  //! Order of the series expansions in each dimension.
+  size_t seriesOrder;
+
+  //! Number of grid points in each dimension in binned mode.
+  size_t gridSize;
+
   /**
    * kdeModel holds an instance of each possible combination of KernelType and
    * TreeType. It is initialized using BuildModel.
@@ -466,6 +551,10 @@ class KDEModel
    * @param mcBreakCoef Coefficient to control what fraction of the node's
    *                    descendants evaluated is the limit before Monte Carlo
    *                    estimation recurses.
+   * @param seriesExpansion Whether to use Hermite series expansions when
+   *                        possible (only used with the Gaussian kernel).
+   * @param seriesOrder Order of the series expansions in each dimension.
+   * @param gridSize Number of grid points in each dimension in binned mode.
    */
   KDEModel(const double bandwidth = 1.0,
            const double relError = KDEDefaultParams::relError,
@@ -476,7 +565,10 @@ class KDEModel
            const double mcProb = KDEDefaultParams::mcProb,
            const size_t initialSampleSize = KDEDefaultParams::initialSampleSize,
            const double mcEntryCoef = KDEDefaultParams::mcEntryCoef,
-           const double mcBreakCoef = KDEDefaultParams::mcBreakCoef);
+           const double mcBreakCoef = KDEDefaultParams::mcBreakCoef,
+           const bool seriesExpansion = KDEDefaultParams::seriesExpansion,
+           const size_t seriesOrder = KDEDefaultParams::seriesOrder,
+           const size_t gridSize = KDEDefaultParams::gridSize);
 
   //! Copy constructor of the given model.
   KDEModel(const KDEModel& other);
@@ -560,12 +652,36 @@ class KDEModel
   //! Modify Monte Carlo break coefficient.
   void MCBreakCoefficient(const double newBreakCoef);
 
+  //! Get whether the model is using series expansions or not.
+  bool SeriesExpansion() const { return seriesExpansion; }
+
+  //! Modify whether the model is using series expansions or not.
+  void SeriesExpansion(const bool newSeriesExpansion);
+
+  //! Get the order of the series expansions.
+  size_t SeriesOrder() const { return seriesOrder; }
+
+  //! Modify the order of the series expansions.
+  void SeriesOrder(const size_t newSeriesOrder);
+
+  //! Get the number of grid points in each dimension in binned mode.
+  size_t GridSize() const { return gridSize; }
+
+  //! Modify the number of grid points in each dimension in binned mode.
+  void GridSize(const size_t newGridSize);
+
   //! Get the mode of the model.
   KDEMode Mode() const;
 
   //! Modify the mode of the model.
   KDEMode& Mode();
 
+  //! Get whether queries are evaluated in parallel.  This is not serialized.
+  bool ParallelQueries() const;
+
+  //! Modify whether queries are evaluated in parallel.
+  bool& ParallelQueries();
+
   /**
    * Build the KDE model with the given parameters and then trains it with the
    * given reference data.
@@ -609,7 +725,7 @@ class KDEModel
 } // namespace mlpack
 
 //! Set the serialization version of the KDEModel class.
-BOOST_TEMPLATE_CLASS_VERSION(template<>, mlpack::kde::KDEModel, 1);
+BOOST_TEMPLATE_CLASS_VERSION(template<>, mlpack::kde::KDEModel, 3);
 
 #include "kde_model_impl.hpp"
 
@@ -30,7 +30,10 @@ inline KDEModel::KDEModel(const double bandwidth,
                           const double mcProb,
                           const size_t initialSampleSize,
                           const double mcEntryCoef,
-                          const double mcBreakCoef) :
+                          const double mcBreakCoef,
+                          const bool seriesExpansion,
+                          const size_t seriesOrder,
+                          const size_t gridSize) :
   bandwidth(bandwidth),
   relError(relError),
   absError(absError),
@@ -40,7 +43,10 @@ inline KDEModel::KDEModel(const double bandwidth,
   mcProb(mcProb),
   initialSampleSize(initialSampleSize),
   mcEntryCoef(mcEntryCoef),
-  mcBreakCoef(mcBreakCoef)
+  mcBreakCoef(mcBreakCoef),
+  seriesExpansion(seriesExpansion),
+  seriesOrder(seriesOrder),
+  gridSize(gridSize)
 {
   // Nothing to do.
 }
@@ -56,7 +62,10 @@ inline KDEModel::KDEModel(const KDEModel& other) :
   mcProb(other.mcProb),
   initialSampleSize(other.initialSampleSize),
   mcEntryCoef(other.mcEntryCoef),
-  mcBreakCoef(other.mcBreakCoef)
+  mcBreakCoef(other.mcBreakCoef),
+  seriesExpansion(other.seriesExpansion),
+  seriesOrder(other.seriesOrder),
+  gridSize(other.gridSize)
 {
   // Nothing to do.
 }
@@ -73,6 +82,9 @@ inline KDEModel::KDEModel(KDEModel&& other) :
   initialSampleSize(other.initialSampleSize),
   mcEntryCoef(other.mcEntryCoef),
   mcBreakCoef(other.mcBreakCoef),
+  seriesExpansion(other.seriesExpansion),
+  seriesOrder(other.seriesOrder),
+  gridSize(other.gridSize),
   kdeModel(std::move(other.kdeModel))
 {
   // Reset other model.
@@ -86,6 +98,9 @@ inline KDEModel::KDEModel(KDEModel&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.seriesExpansion = KDEDefaultParams::seriesExpansion;
+  other.seriesOrder = KDEDefaultParams::seriesOrder;
+  other.gridSize = KDEDefaultParams::gridSize;
   other.kdeModel = decltype(other.kdeModel)();
 }
 
@@ -102,6 +117,9 @@ inline KDEModel& KDEModel::operator=(KDEModel other)
   initialSampleSize = other.initialSampleSize;
   mcEntryCoef = other.mcEntryCoef;
   mcBreakCoef = other.mcBreakCoef;
+  seriesExpansion = other.seriesExpansion;
+  seriesOrder = other.seriesOrder;
+  gridSize = other.gridSize;
   kdeModel = std::move(other.kdeModel);
   return *this;
 }
@@ -264,6 +282,18 @@ inline void KDEModel::BuildModel(arma::mat&& referenceSet)
   MCBreakCoefVisitor breakCoefficientVisitor(mcBreakCoef);
   boost::apply_visitor(breakCoefficientVisitor, kdeModel);
 
+  // Set whether to use series expansions or not.
+  SeriesExpansionVisitor seriesExpansionVisitor(seriesExpansion);
+  boost::apply_visitor(seriesExpansionVisitor, kdeModel);
+
+  // Set the order of the series expansions.
+  SeriesOrderVisitor seriesOrderVisitor(seriesOrder);
+  boost::apply_visitor(seriesOrderVisitor, kdeModel);
+
+  // Set the number of grid points in binned mode.
+  GridSizeVisitor gridSizeVisitor(gridSize);
+  boost::apply_visitor(gridSizeVisitor, kdeModel);
+
   // Train the model.
   TrainVisitor train(std::move(referenceSet));
   boost::apply_visitor(train, kdeModel);
@@ -507,6 +537,62 @@ void MCBreakCoefVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
     throw std::runtime_error("no KDE model initialized");
 }
 
+// Activate or deactivate series expansions.
+inline SeriesExpansionVisitor::SeriesExpansionVisitor(
+    const bool seriesExpansion) :
+    seriesExpansion(seriesExpansion)
+{}
+
+// Default activate or deactivate series expansions.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void SeriesExpansionVisitor::operator()(KDEType<KernelType, TreeType>* kde)
+    const
+{
+  if (kde)
+    kde->SeriesExpansion() = seriesExpansion;
+  else
+    throw std::runtime_error("no KDE model initialized");
+}
+
+// Set the order of the series expansions.
+inline SeriesOrderVisitor::SeriesOrderVisitor(const size_t seriesOrder) :
+    seriesOrder(seriesOrder)
+{}
+
+// Default order of the series expansions.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void SeriesOrderVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
+{
+  if (kde)
+    kde->SeriesOrder(seriesOrder);
+  else
+    throw std::runtime_error("no KDE model initialized");
+}
+
+// Set the number of grid points in binned mode.
+inline GridSizeVisitor::GridSizeVisitor(const size_t gridSize) :
+    gridSize(gridSize)
+{}
+
+// Default number of grid points in binned mode.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void GridSizeVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
+{
+  if (kde)
+    kde->GridSize(gridSize);
+  else
+    throw std::runtime_error("no KDE model initialized");
+}
+
 // Delete model.
 template<typename KDEType>
 void DeleteVisitor::operator()(KDEType* kde) const
@@ -537,6 +623,28 @@ KDEMode& KDEModel::Mode()
   return boost::apply_visitor(ModeVisitor(), kdeModel);
 }
 
+// Whether queries of the model are evaluated in parallel.
+template<typename KDEType>
+bool& ParallelQueriesVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+    return kde->ParallelQueries();
+  else
+    throw std::runtime_error("no KDE model initialized");
+}
+
+// Get whether queries are evaluated in parallel.
+inline bool KDEModel::ParallelQueries() const
+{
+  return boost::apply_visitor(ParallelQueriesVisitor(), kdeModel);
+}
+
+// Modify whether queries are evaluated in parallel.
+inline bool& KDEModel::ParallelQueries()
+{
+  return boost::apply_visitor(ParallelQueriesVisitor(), kdeModel);
+}
+
 // Serialize the model.
 template<typename Archive>
 void KDEModel::serialize(Archive& ar, const unsigned int version)
@@ -566,6 +674,26 @@ void KDEModel::serialize(Archive& ar, const unsigned int version)
     mcBreakCoef = KDEDefaultParams::mcBreakCoef;
   }
 
+  // Backward compatibility: Old versions of KDEModel did not have series
+  // expansions.
+  if (version > 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(seriesExpansion);
+    ar & BOOST_SERIALIZATION_NVP(seriesOrder);
+  }
+  else if (Archive::is_loading::value)
+  {
+    seriesExpansion = KDEDefaultParams::seriesExpansion;
+    seriesOrder = KDEDefaultParams::seriesOrder;
+  }
+
+  // Backward compatibility: Old versions of KDEModel did not have a binned
+  // mode.
+  if (version > 2)
+    ar & BOOST_SERIALIZATION_NVP(gridSize);
+  else if (Archive::is_loading::value)
+    gridSize = KDEDefaultParams::gridSize;
+
   if (Archive::is_loading::value)
     boost::apply_visitor(DeleteVisitor(), kdeModel);
 
@@ -636,6 +764,30 @@ void KDEModel::MCBreakCoefficient(const double newBreakCoef)
   boost::apply_visitor(mcBreakCoefVisitor, kdeModel);
 }
 
+// Modify whether series expansions will be used.
+inline void KDEModel::SeriesExpansion(const bool newSeriesExpansion)
+{
+  seriesExpansion = newSeriesExpansion;
+  SeriesExpansionVisitor seriesExpansionVisitor(newSeriesExpansion);
+  boost::apply_visitor(seriesExpansionVisitor, kdeModel);
+}
+
+// Modify the order of the series expansions.
+inline void KDEModel::SeriesOrder(const size_t newSeriesOrder)
+{
+  seriesOrder = newSeriesOrder;
+  SeriesOrderVisitor seriesOrderVisitor(newSeriesOrder);
+  boost::apply_visitor(seriesOrderVisitor, kdeModel);
+}
+
+// Modify the number of grid points in binned mode.
+inline void KDEModel::GridSize(const size_t newGridSize)
+{
+  gridSize = newGridSize;
+  GridSizeVisitor gridSizeVisitor(newGridSize);
+  boost::apply_visitor(gridSizeVisitor, kdeModel);
+}
+
 } // namespace kde
 } // namespace mlpack
 
@@ -45,9 +45,13 @@ class KDERules
    *                   possible.
    * @param sameSet True if query and reference sets are the same
    *                (monochromatic evaluation).
+   * @param seriesExpansion If true, the Hermite series expansions of reference
+   *                        nodes are used when possible (only for the Gaussian
+   *                        kernel).
+   * @param seriesOrder Order of the series expansions in each dimension.
    */
-  KDERules(const arma::mat& referenceSet,
-           const arma::mat& querySet,
+  KDERules(const typename TreeType::Mat& referenceSet,
+           const typename TreeType::Mat& querySet,
            arma::vec& densities,
            const double relError,
            const double absError,
@@ -58,7 +62,9 @@ class KDERules
            MetricType& metric,
            KernelType& kernel,
            const bool monteCarlo,
-           const bool sameSet);
+           const bool sameSet,
+           const bool seriesExpansion = false,
+           const size_t seriesOrder = 0);
 
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -90,9 +96,68 @@ class KDERules
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
 
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
+
   //! Get the number of scores.
   size_t Scores() const { return scores; }
 
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
+
+  /**
+   * Merge the per-point error bookkeeping of the given query subtrees from
+   * another rules object into this one.  This is used by parallel traversers,
+   * where each thread performs its part of the estimation with a copy of the
+   * rules.  Densities are written directly into the shared output vector.
+   *
+   * @param other Rules object that was used to traverse the query subtrees.
+   * @param queryNodes Roots of the query subtrees traversed with other.
+   */
+  void Merge(const KDERules& other, const std::vector<TreeType*>& queryNodes);
+
+  /**
+   * Merge the per-point error bookkeeping of the query points in [begin, end)
+   * from another rules object into this one.  This is used when blocks of
+   * query points are searched in parallel with single-tree traversals.
+   *
+   * @param other Rules object that was used to search the query points.
+   * @param begin First query point of the block.
+   * @param end One past the last query point of the block.
+   */
+  void Merge(const KDERules& other, const size_t begin, const size_t end);
+
+  /**
+   * Compute the Monte Carlo alpha of every node of the given reference tree.
+   * Score() otherwise computes (and stores) it the first time each reference
+   * node is visited; computing it beforehand means that a traversal only reads
+   * the statistics of the reference tree, so that several threads can share
+   * it.
+   *
+   * @param referenceNode Root of the reference tree.
+   */
+  void ComputeAlphas(TreeType& referenceNode);
+
+  /**
+   * Compute the Hermite series expansion of every node of the given reference
+   * tree that has more points than the expansion has coefficients, if series
+   * expansions are used.  Expansions that are still valid (for the same
+   * bandwidth and order) from an earlier evaluation are kept.  Expansions of
+   * nodes are translated from those of their children when possible.
+   *
+   * @param referenceNode Root of the reference tree.
+   */
+  void ComputeSeries(TreeType& referenceNode);
+
+  /**
+   * Seed the generator used to sample reference points for Monte Carlo
+   * estimations.  Each copy of the rules used by a parallel traversal should
+   * be seeded differently.
+   *
+   * @param seed Seed of the generator.
+   */
+  void Seed(const size_t seed) { generator.seed((uint32_t) seed); }
+
   //! Get the minimum number of base cases we need to perform to have acceptable
   //! results.
   size_t MinimumBaseCases() const { return 0; }
@@ -103,17 +168,58 @@ class KDERules
                         const size_t referenceIndex) const;
 
   //! Evaluate kernel value of 2 points.
-  double EvaluateKernel(const arma::vec& query,
-                        const arma::vec& reference) const;
+  double EvaluateKernel(const arma::Col<typename TreeType::ElemType>& query,
+                        const arma::Col<typename TreeType::ElemType>& reference)
+      const;
 
   //! Calculate depth alpha for some node.
   double CalculateAlpha(TreeType* node);
 
+  //! Sample a random descendant of the reference node, in [lo, hi).
+  size_t RandomDescendant(const size_t lo, const size_t hi);
+
+  /**
+   * Compute the series expansion of the given node, and return whether it has
+   * one.
+   */
+  bool BuildSeries(TreeType& node);
+
+  /**
+   * Add the expansion with the given coefficients, around a center which is
+   * at the given (scaled) offset from the center of the expansion to add to,
+   * to the given coefficients.
+   */
+  void TranslateSeries(const arma::vec& coefficients,
+                       const arma::vec& offset,
+                       arma::vec& result) const;
+
+  /**
+   * Return the bound on the total error of approximating the kernel values of
+   * all the points of the reference node with its series expansion, or
+   * DBL_MAX if the expansion may not be used for this combination.
+   */
+  double SeriesError(TreeType& referenceNode,
+                     const bool alreadyDidRefPoint0,
+                     const double minDistance) const;
+
+  //! Evaluate the series expansion of the given node at a query point.
+  double SeriesEvaluate(const arma::Col<typename TreeType::ElemType>& query,
+                        const KDEStat& stat) const;
+
+  //! Get the bandwidth of a Gaussian kernel.
+  static double GaussianBandwidth(const kernel::GaussianKernel& kernel)
+  { return kernel.Bandwidth(); }
+
+  //! Series expansions are only used with the Gaussian kernel.
+  template<typename OtherKernelType>
+  static double GaussianBandwidth(const OtherKernelType& /* kernel */)
+  { return 0.0; }
+
   //! The reference set.
-  const arma::mat& referenceSet;
+  const typename TreeType::Mat& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const typename TreeType::Mat& querySet;
 
   //! Density values.
   arma::vec& densities;
@@ -174,6 +280,21 @@ class KDERules
   //! Traversal information.
   TraversalInfoType traversalInfo;
 
+  //! Order of the series expansions in each dimension.
+  const size_t seriesOrder;
+
+  //! Number of coefficients of a series expansion, or 0 if series expansions
+  //! are not used.
+  size_t seriesCoefficients;
+
+  //! Bandwidth of the Gaussian kernel, for the series expansions.
+  const double seriesBandwidth;
+
+  //! Generator for Monte Carlo samples; it is owned by the rules (instead of
+  //! using math::RandInt()) so that copies of the rules can sample in
+  //! parallel.
+  std::mt19937 generator;
+
   //! The number of base cases.
   size_t baseCases;
 
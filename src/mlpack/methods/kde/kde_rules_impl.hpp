@@ -24,8 +24,8 @@ namespace kde {
 
 template<typename MetricType, typename KernelType, typename TreeType>
 KDERules<MetricType, KernelType, TreeType>::KDERules(
-    const arma::mat& referenceSet,
-    const arma::mat& querySet,
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
     arma::vec& densities,
     const double relError,
     const double absError,
@@ -36,7 +36,9 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     MetricType& metric,
     KernelType& kernel,
     const bool monteCarlo,
-    const bool sameSet) :
+    const bool sameSet,
+    const bool seriesExpansion,
+    const size_t seriesOrder) :
     referenceSet(referenceSet),
     querySet(querySet),
     densities(densities),
@@ -53,6 +55,10 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     absErrorTol(absError / referenceSet.n_cols),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
+    seriesOrder(seriesOrder),
+    seriesCoefficients(0),
+    seriesBandwidth(GaussianBandwidth(kernel)),
+    generator((uint32_t) math::randGen()),
     baseCases(0),
     scores(0)
 {
@@ -62,6 +68,80 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
   // Initialize accumMCAlpha only if Monte Carlo estimations are available.
   if (monteCarlo && kernelIsGaussian)
     accumMCAlpha = arma::vec(querySet.n_cols, arma::fill::zeros);
+
+  // An expansion has seriesOrder coefficients per dimension; it is only worth
+  // using for nodes with more points than that.
+  if (seriesExpansion && kernelIsGaussian && seriesOrder > 0)
+  {
+    seriesCoefficients = 1;
+    for (size_t d = 0; d < referenceSet.n_rows; ++d)
+    {
+      seriesCoefficients *= seriesOrder;
+      if (seriesCoefficients >= referenceSet.n_cols)
+      {
+        seriesCoefficients = 0;
+        break;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::Merge(
+    const KDERules& other,
+    const std::vector<TreeType*>& queryNodes)
+{
+  for (size_t i = 0; i < queryNodes.size(); ++i)
+  {
+    for (size_t j = 0; j < queryNodes[i]->NumDescendants(); ++j)
+    {
+      const size_t queryIndex = queryNodes[i]->Descendant(j);
+      accumError(queryIndex) = other.accumError(queryIndex);
+      if (monteCarlo && kernelIsGaussian)
+        accumMCAlpha(queryIndex) = other.accumMCAlpha(queryIndex);
+    }
+  }
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::Merge(
+    const KDERules& other,
+    const size_t begin,
+    const size_t end)
+{
+  if (end <= begin)
+    return;
+
+  accumError.subvec(begin, end - 1) = other.accumError.subvec(begin, end - 1);
+  if (monteCarlo && kernelIsGaussian)
+  {
+    accumMCAlpha.subvec(begin, end - 1) =
+        other.accumMCAlpha.subvec(begin, end - 1);
+  }
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::ComputeAlphas(
+    TreeType& referenceNode)
+{
+  if (!monteCarlo || !kernelIsGaussian)
+    return;
+
+  // The alpha of a node depends on the alpha of its parent, so the tree is
+  // walked top-down.
+  CalculateAlpha(&referenceNode);
+  for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
+    ComputeAlphas(referenceNode.Child(i));
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::ComputeSeries(
+    TreeType& referenceNode)
+{
+  if (seriesCoefficients == 0)
+    return;
+
+  BuildSeries(referenceNode);
 }
 
 //! The base case.
@@ -102,7 +182,8 @@ inline double KDERules<MetricType, KernelType, TreeType>::
 Score(const size_t queryIndex, TreeType& referenceNode)
 {
   // Auxiliary variables.
-  const arma::vec& queryPoint = querySet.unsafe_col(queryIndex);
+  const arma::Col<typename TreeType::ElemType>& queryPoint =
+      querySet.unsafe_col(queryIndex);
   const size_t refNumDesc = referenceNode.NumDescendants();
   double score, minDistance, maxDistance, depthAlpha;
   // Calculations are not duplicated.
@@ -160,6 +241,11 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   else
     pointAccumErrorTol = accumError(queryIndex) / refNumDesc;
 
+  // Bound on the error of the series expansion of the reference node, if it
+  // can be used.
+  const double seriesError = SeriesError(referenceNode, alreadyDidRefPoint0,
+      minDistance);
+
   if (bound <= 2 * errorTolerance + pointAccumErrorTol)
   {
     // Estimate kernel value.
@@ -184,6 +270,22 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     if (kernelIsGaussian && monteCarlo)
       accumMCAlpha(queryIndex) += depthAlpha;
   }
+  else if (2 * seriesError <= refNumDesc *
+      (2 * errorTolerance + pointAccumErrorTol))
+  {
+    // Evaluate the series expansion of the reference node.
+    densities(queryIndex) += SeriesEvaluate(queryPoint, referenceNode.Stat());
+
+    // Don't explore this tree branch.
+    score = DBL_MAX;
+
+    // Subtract used error tolerance or add extra available tolerance.
+    accumError(queryIndex) -= 2 * seriesError - refNumDesc * 2 * errorTolerance;
+
+    // Store not used alpha for Monte Carlo.
+    if (kernelIsGaussian && monteCarlo)
+      accumMCAlpha(queryIndex) += depthAlpha;
+  }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
            kernelIsGaussian)
@@ -222,9 +324,9 @@ Score(const size_t queryIndex, TreeType& referenceNode)
         // Sample and evaluate random points from the reference node.
         size_t randomPoint;
         if (alreadyDidRefPoint0)
-          randomPoint = math::RandInt(1, refNumDesc);
+          randomPoint = RandomDescendant(1, refNumDesc);
         else
-          randomPoint = math::RandInt(0, refNumDesc);
+          randomPoint = RandomDescendant(0, refNumDesc);
 
         sample(oldSize + i) =
             EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -367,6 +469,11 @@ Score(TreeType& queryNode, TreeType& referenceNode)
   // it here to prune more.
   const double pointAccumErrorTol = queryStat.AccumError() / refNumDesc;
 
+  // Bound on the error of the series expansion of the reference node, if it
+  // can be used.
+  const double seriesError = SeriesError(referenceNode, alreadyDidRefPoint0,
+      minDistance);
+
   // If possible, avoid some calculations because of the error tolerance.
   if (bound <= 2 * errorTolerance + pointAccumErrorTol)
   {
@@ -393,6 +500,27 @@ Score(TreeType& queryNode, TreeType& referenceNode)
     if (kernelIsGaussian && monteCarlo)
       queryStat.AccumAlpha() += depthAlpha;
   }
+  else if (2 * seriesError <= refNumDesc *
+      (2 * errorTolerance + pointAccumErrorTol))
+  {
+    // Evaluate the series expansion of the reference node at each query point.
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+    {
+      const size_t queryIndex = queryNode.Descendant(i);
+      densities(queryIndex) += SeriesEvaluate(querySet.unsafe_col(queryIndex),
+          referenceNode.Stat());
+    }
+
+    // Prune.
+    score = DBL_MAX;
+
+    // Subtract used error tolerance or add extra available tolerance.
+    queryStat.AccumError() -= 2 * seriesError - refNumDesc * 2 * errorTolerance;
+
+    // Store not used alpha for Monte Carlo.
+    if (kernelIsGaussian && monteCarlo)
+      queryStat.AccumAlpha() += depthAlpha;
+  }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
            kernelIsGaussian)
@@ -439,9 +567,9 @@ Score(TreeType& queryNode, TreeType& referenceNode)
           // Sample and evaluate random points from the reference node.
           size_t randomPoint;
           if (alreadyDidRefPoint0)
-            randomPoint = math::RandInt(1, refNumDesc);
+            randomPoint = RandomDescendant(1, refNumDesc);
           else
-            randomPoint = math::RandInt(0, refNumDesc);
+            randomPoint = RandomDescendant(0, refNumDesc);
 
           sample(oldSize + i) =
               EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -539,7 +667,8 @@ EvaluateKernel(const size_t queryIndex,
 
 template<typename MetricType, typename KernelType, typename TreeType>
 inline force_inline double KDERules<MetricType, KernelType, TreeType>::
-EvaluateKernel(const arma::vec& query, const arma::vec& reference) const
+EvaluateKernel(const arma::Col<typename TreeType::ElemType>& query,
+               const arma::Col<typename TreeType::ElemType>& reference) const
 {
   return kernel.Evaluate(metric.Evaluate(query, reference));
 }
@@ -573,6 +702,181 @@ CalculateAlpha(TreeType* node)
   return stat.MCAlpha();
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline size_t KDERules<MetricType, KernelType, TreeType>::
+RandomDescendant(const size_t lo, const size_t hi)
+{
+  std::uniform_int_distribution<size_t> distribution(lo, hi - 1);
+  return distribution(generator);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::BuildSeries(TreeType& node)
+{
+  // The expansion of a node with fewer points than coefficients would never be
+  // cheaper than computing the kernel values exactly.
+  if (node.NumDescendants() <= seriesCoefficients)
+    return false;
+
+  KDEStat& stat = node.Stat();
+  if (stat.SeriesBandwidth() == seriesBandwidth &&
+      stat.SeriesOrder() == seriesOrder)
+    return true;
+
+  // The expansions of the children are needed first.
+  bool childrenHaveSeries = (node.NumChildren() > 0);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    if (!BuildSeries(node.Child(i)))
+      childrenHaveSeries = false;
+
+  // Coordinates are scaled so that the kernel is exp(-||t_q - t_r||^2).
+  const double scale = 1.0 / (std::sqrt(2.0) * seriesBandwidth);
+  const size_t dimensionality = referenceSet.n_rows;
+  node.Center(stat.SeriesCenter());
+  const arma::vec& center = stat.SeriesCenter();
+  arma::vec& coefficients = stat.SeriesCoefficients();
+  coefficients.zeros(seriesCoefficients);
+  double radius = 0.0;
+
+  if (childrenHaveSeries)
+  {
+    // Translate the expansions of the children to the center of this node.
+    arma::vec offset(dimensionality);
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      const KDEStat& childStat = node.Child(i).Stat();
+      offset = (childStat.SeriesCenter() - center) * scale;
+      TranslateSeries(childStat.SeriesCoefficients(), offset, coefficients);
+      radius = std::max(radius, childStat.SeriesRadius() +
+          arma::max(arma::abs(offset)));
+    }
+  }
+  else
+  {
+    // The coefficient of the multi-index a is the sum of t^a / a! over the
+    // points; index a_0 + a_1 p + a_2 p^2 + ... holds it.
+    arma::vec powers(seriesOrder);
+    arma::vec term;
+    for (size_t i = 0; i < node.NumDescendants(); ++i)
+    {
+      const size_t index = node.Descendant(i);
+      term.ones(1);
+      for (size_t d = 0; d < dimensionality; ++d)
+      {
+        const double t = (referenceSet(d, index) - center[d]) * scale;
+        radius = std::max(radius, std::abs(t));
+
+        powers[0] = 1.0;
+        for (size_t n = 1; n < seriesOrder; ++n)
+          powers[n] = powers[n - 1] * t / n;
+        term = arma::kron(powers, term);
+      }
+      coefficients += term;
+    }
+  }
+
+  stat.SeriesRadius() = radius;
+  stat.SeriesBandwidth() = seriesBandwidth;
+  stat.SeriesOrder() = seriesOrder;
+  return true;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::TranslateSeries(
+    const arma::vec& coefficients,
+    const arma::vec& offset,
+    arma::vec& result) const
+{
+  // Since t = t' + offset, t^a / a! is the sum over b <= a of
+  // t'^b / b! * offset^(a - b) / (a - b)!, which is applied to one dimension
+  // at a time.
+  arma::vec translated = coefficients;
+  arma::vec next(translated.n_elem);
+  arma::vec factors(seriesOrder);
+  size_t stride = 1;
+  for (size_t d = 0; d < offset.n_elem; ++d)
+  {
+    factors[0] = 1.0;
+    for (size_t n = 1; n < seriesOrder; ++n)
+      factors[n] = factors[n - 1] * offset[d] / n;
+
+    next.zeros();
+    for (size_t i = 0; i < translated.n_elem; ++i)
+    {
+      const size_t a = (i / stride) % seriesOrder;
+      const size_t base = i - a * stride;
+      for (size_t b = 0; b <= a; ++b)
+        next[i] += factors[a - b] * translated[base + b * stride];
+    }
+
+    translated.swap(next);
+    stride *= seriesOrder;
+  }
+
+  result += translated;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::SeriesError(
+    TreeType& referenceNode,
+    const bool alreadyDidRefPoint0,
+    const double minDistance) const
+{
+  // The expansion includes every point of the node, so it can't be used if
+  // some of them were already computed, or may be the query point itself.
+  const KDEStat& stat = referenceNode.Stat();
+  if (seriesCoefficients == 0 ||
+      alreadyDidRefPoint0 ||
+      (sameSet && minDistance == 0.0) ||
+      stat.SeriesBandwidth() != seriesBandwidth ||
+      stat.SeriesOrder() != seriesOrder ||
+      stat.SeriesRadius() >= 1.0)
+    return DBL_MAX;
+
+  // This is the bound on the error of the truncated far-field expansion from
+  // Lee, Gray and Moore, "Dual-Tree Fast Gauss Transforms" (NIPS 2005).
+  const double r = stat.SeriesRadius();
+  const size_t dimensionality = referenceSet.n_rows;
+  const double rp = std::pow(r, (double) seriesOrder);
+  const double tail = rp / std::sqrt(std::tgamma(seriesOrder + 1.0));
+  double sum = 0.0;
+  double binomial = 1.0;
+  for (size_t k = 0; k < dimensionality; ++k)
+  {
+    sum += binomial * std::pow(1.0 - rp, (double) k) *
+        std::pow(tail, (double) (dimensionality - k));
+    binomial *= (double) (dimensionality - k) / (k + 1);
+  }
+
+  return referenceNode.NumDescendants() * sum /
+      std::pow(1.0 - r, (double) dimensionality);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::SeriesEvaluate(
+    const arma::Col<typename TreeType::ElemType>& query,
+    const KDEStat& stat) const
+{
+  // The Hermite functions h_n(t) = H_n(t) exp(-t^2) of each coordinate, with
+  // H_{n + 1}(t) = 2 t H_n(t) - 2 n H_{n - 1}(t).
+  const double scale = 1.0 / (std::sqrt(2.0) * seriesBandwidth);
+  const arma::vec& center = stat.SeriesCenter();
+  arma::vec hermite(seriesOrder);
+  arma::vec term(1, arma::fill::ones);
+  for (size_t d = 0; d < query.n_elem; ++d)
+  {
+    const double t = (query[d] - center[d]) * scale;
+    hermite[0] = std::exp(-t * t);
+    if (seriesOrder > 1)
+      hermite[1] = 2 * t * hermite[0];
+    for (size_t n = 2; n < seriesOrder; ++n)
+      hermite[n] = 2 * t * hermite[n - 1] - 2 * (n - 1) * hermite[n - 2];
+    term = arma::kron(hermite, term);
+  }
+
+  return arma::dot(stat.SeriesCoefficients(), term);
+}
+
 //! Clean rules base case.
 template<typename TreeType>
 inline force_inline
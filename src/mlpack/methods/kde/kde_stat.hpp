@@ -29,7 +29,10 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      seriesBandwidth(0),
+      seriesOrder(0),
+      seriesRadius(0)
   { /* Nothing to do.*/ }
 
   //! Initialization for a fully initialized node.
@@ -38,7 +41,10 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      seriesBandwidth(0),
+      seriesOrder(0),
+      seriesRadius(0)
   { /* Nothing to do. */ }
 
   //! Get accumulated Monte Carlo alpha of the node.
@@ -65,6 +71,39 @@ class KDEStat
   //! Modify Monte Carlo alpha of the node.
   inline double& MCAlpha() { return mcAlpha; }
 
+  //! Get the bandwidth for which the series expansion is valid (0 if there is
+  //! no expansion).
+  inline double SeriesBandwidth() const { return seriesBandwidth; }
+
+  //! Modify the bandwidth for which the series expansion is valid.
+  inline double& SeriesBandwidth() { return seriesBandwidth; }
+
+  //! Get the order of the series expansion.
+  inline size_t SeriesOrder() const { return seriesOrder; }
+
+  //! Modify the order of the series expansion.
+  inline size_t& SeriesOrder() { return seriesOrder; }
+
+  //! Get the scaled maximum-norm radius of the points around the center of the
+  //! series expansion.
+  inline double SeriesRadius() const { return seriesRadius; }
+
+  //! Modify the scaled radius of the series expansion.
+  inline double& SeriesRadius() { return seriesRadius; }
+
+  //! Get the center of the series expansion.
+  inline const arma::vec& SeriesCenter() const { return seriesCenter; }
+
+  //! Modify the center of the series expansion.
+  inline arma::vec& SeriesCenter() { return seriesCenter; }
+
+  //! Get the coefficients of the series expansion.
+  inline const arma::vec& SeriesCoefficients() const
+  { return seriesCoefficients; }
+
+  //! Modify the coefficients of the series expansion.
+  inline arma::vec& SeriesCoefficients() { return seriesCoefficients; }
+
   //! Serialize the statistic to/from an archive.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version)
@@ -111,6 +150,22 @@ class KDEStat
 
   //! Accumulated not used error tolerance in the current node.
   double accumError;
+
+  //! Bandwidth for which the series expansion is valid.  The expansion is not
+  //! serialized; it is recomputed when it is needed.
+  double seriesBandwidth;
+
+  //! Order of the series expansion in each dimension.
+  size_t seriesOrder;
+
+  //! Scaled maximum-norm radius of the points around seriesCenter.
+  double seriesRadius;
+
+  //! Center of the series expansion.
+  arma::vec seriesCenter;
+
+  //! Coefficients of the Hermite series expansion of the points of the node.
+  arma::vec seriesCoefficients;
 };
 
 } // namespace kde
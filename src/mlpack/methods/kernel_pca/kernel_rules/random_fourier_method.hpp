@@ -0,0 +1,164 @@
+/**
+ * @file methods/kernel_pca/kernel_rules/random_fourier_method.hpp
+ *
+ * Use random Fourier features for approximating the kernel matrix of a
+ * shift-invariant kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Draw the frequencies of the random Fourier features of a shift-invariant
+ * kernel from the Fourier transform of the kernel.  This is only defined for
+ * the kernels whose Fourier transform is known (see the specializations
+ * below).
+ */
+template<typename KernelType>
+struct FourierFrequencies
+{
+  static_assert(!std::is_same<KernelType, KernelType>::value,
+      "random Fourier features are only available for GaussianKernel and "
+      "LaplacianKernel");
+};
+
+//! The Fourier transform of the Gaussian kernel is a Gaussian distribution.
+template<>
+struct FourierFrequencies<kernel::GaussianKernel>
+{
+  static void Sample(const kernel::GaussianKernel& kernel,
+                     const size_t dimensionality,
+                     const size_t numFeatures,
+                     arma::mat& frequencies)
+  {
+    frequencies = arma::randn<arma::mat>(dimensionality, numFeatures) /
+        kernel.Bandwidth();
+  }
+};
+
+//! The Fourier transform of the Laplacian kernel (which uses the Euclidean
+//! distance) is a multivariate Cauchy distribution.
+template<>
+struct FourierFrequencies<kernel::LaplacianKernel>
+{
+  static void Sample(const kernel::LaplacianKernel& kernel,
+                     const size_t dimensionality,
+                     const size_t numFeatures,
+                     arma::mat& frequencies)
+  {
+    frequencies = arma::randn<arma::mat>(dimensionality, numFeatures);
+    const arma::rowvec scales = arma::abs(arma::randn<arma::rowvec>(
+        numFeatures)) * kernel.Bandwidth();
+    frequencies.each_row() /= scales;
+  }
+};
+
+/**
+ * Approximate the kernel matrix with random Fourier features, as described in
+ * the following paper:
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title={Random Features for Large-Scale Kernel Machines},
+ *   author={Rahimi, A. and Recht, B.},
+ *   booktitle={Advances in Neural Information Processing Systems 20
+ *       (NIPS 2007)},
+ *   pages={1177--1184},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Each point x is mapped to the features z(x) = sqrt(2 / D) cos(W^T x + b),
+ * where the columns of W are drawn from the Fourier transform of the kernel
+ * and b is uniform in [0, 2 pi], so that z(x)^T z(y) approximates K(x, y).
+ * The principal components are then computed from the D x D covariance of the
+ * centered features, so the n x n kernel matrix is never built and the cost is
+ * linear in the number of points.
+ *
+ * @tparam KernelType Shift-invariant kernel (GaussianKernel or
+ *     LaplacianKernel).
+ * @tparam NumFeatures Number of random features D; if 0, the rank given to
+ *     ApplyKernelMatrix() is used.
+ */
+template<typename KernelType, size_t NumFeatures = 0>
+class RandomFourierKernelRule
+{
+ public:
+  /**
+   * Construct the kernel matrix approximation using random Fourier features.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors (in the feature space) will be written to
+   *     this matrix.
+   * @param rank Number of random features, if NumFeatures is 0.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                KernelType kernel = KernelType())
+  {
+    const size_t numFeatures = (NumFeatures == 0) ? rank : NumFeatures;
+
+    arma::mat frequencies;
+    FourierFrequencies<KernelType>::Sample(kernel, data.n_rows, numFeatures,
+        frequencies);
+    const arma::vec offsets = arma::randu<arma::vec>(numFeatures) * 2.0 *
+        M_PI;
+
+    // Map the points to the features (one column per point).
+    arma::mat features = frequencies.t() * data;
+    const double scale = std::sqrt(2.0 / numFeatures);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) features.n_cols; ++i)
+    {
+      double* column = features.colptr(i);
+      for (size_t j = 0; j < numFeatures; ++j)
+        column[j] = scale * std::cos(column[j] + offsets[j]);
+    }
+
+    // Center the features, which centers the approximate kernel matrix.
+    features.each_col() -= arma::mean(features, 1);
+
+    // The nonzero eigenvalues of the centered kernel matrix
+    // features^T * features are those of features * features^T.
+    arma::mat covariance = features * features.t();
+    if (!arma::eig_sym(eigval, eigvec, covariance))
+    {
+      Log::Fatal << "Failed to construct the kernel matrix." << std::endl;
+    }
+
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
+      eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+
+    // Flip the coefficients to produce the same effect.
+    eigvec = arma::fliplr(eigvec);
+
+    // Project the features onto the principal components.
+    transformedData = eigvec.t() * features;
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
@@ -32,7 +32,7 @@ class AllowEmptyClusters
    * This function allows empty clusters to persist simply by leaving the empty
    * cluster in its last position.
    *
-   * @tparam MatType Type of data (arma::mat or arma::spmat).
+   * @tparam MatType Type of data (arma::mat, arma::fmat or arma::spmat).
    * @param * (data) Dataset on which clustering is being performed.
    * @param emptyCluster Index of cluster which is empty.
    * @param oldCentroids Centroids of each cluster (one per column) at the start
@@ -49,8 +49,8 @@ class AllowEmptyClusters
   static inline force_inline void EmptyCluster(
       const MatType& /* data */,
       const size_t emptyCluster,
-      const arma::mat& oldCentroids,
-      arma::mat& newCentroids,
+      const arma::Mat<typename MatType::elem_type>& oldCentroids,
+      arma::Mat<typename MatType::elem_type>& newCentroids,
       arma::Col<size_t>& /* clusterCounts */,
       MetricType& /* metric */,
       const size_t /* iteration */)
@@ -50,6 +50,10 @@ class DualTreeKMeans
   using NNSTreeType =
       TreeType<TreeMetricType, DualTreeKMeansStatistic, TreeMatType>;
 
+  //! The nearest neighbor search on the centroids.
+  typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+      MatType, NNSTreeType> CentroidSearchType;
+
   /**
    * Construct the DualTreeKMeans object, which will construct a tree on the
    * points.
@@ -97,8 +101,9 @@ class DualTreeKMeans
   arma::vec upperBounds;
   //! Lower bounds on second closest cluster distance for each point.
   arma::vec lowerBounds;
-  //! Indicator of whether or not the point is pruned.
-  std::vector<bool> prunedPoints;
+  //! Indicator of whether or not the point is pruned (this is not a
+  //! std::vector<bool>, because it is modified by several threads at once).
+  std::vector<char> prunedPoints;
 
   arma::Row<size_t> assignments;
 
@@ -110,6 +115,29 @@ class DualTreeKMeans
 
   arma::mat interclusterDistances; // Static storage for intercluster distances.
 
+  //! The search on the tree built on the centroids, which is kept across
+  //! iterations.
+  CentroidSearchType centroidSearch;
+  //! Mapping of the centroids in the centroid tree, if the tree rearranges
+  //! them.
+  std::vector<size_t> oldFromNewCentroids;
+  //! The diameter of the centroid tree when it was built.
+  double centroidTreeDiameter;
+  //! The total movement of the centroids since the centroid tree was built (the
+  //! sum over the iterations of the largest movement).
+  double centroidTreeMovement;
+
+  //! The centroid tree is refit instead of rebuilt while the centroids have
+  //! moved less than this fraction of its diameter since it was built.
+  static constexpr double maxRefitMovement = 0.1;
+  //! Nodes with at least this many descendants are updated, coalesced and
+  //! decoalesced with one OpenMP task per child.
+  static const size_t parallelUpdateSize = 10000;
+
+  //! Build the centroid tree on the given centroids, or refit the tree of the
+  //! last iteration if the centroids did not move much.
+  void UpdateCentroidTree(const arma::mat& centroids);
+
   //! Update the bounds in the tree before the next iteration.
   //! centroids is the current (not yet searched) centroids.
   void UpdateTree(Tree& node,
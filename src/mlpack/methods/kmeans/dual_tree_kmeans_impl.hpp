@@ -19,6 +19,7 @@
 #include "dual_tree_kmeans.hpp"
 
 #include "dual_tree_kmeans_rules.hpp"
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 namespace mlpack {
 namespace kmeans {
@@ -47,6 +48,28 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+HAS_ANY_METHOD_FORM(Refit, HasRefit);
+
+//! Refit a tree whose points were moved, for trees that can be refit.
+template<typename TreeType>
+void RefitTree(
+    TreeType& tree,
+    const std::vector<size_t>& movedPoints,
+    const typename std::enable_if<HasRefit<TreeType>::value>::type* = 0)
+{
+  tree.Refit(movedPoints);
+}
+
+//! Other trees are always rebuilt, so this is never called.
+template<typename TreeType>
+void RefitTree(
+    TreeType& /* tree */,
+    const std::vector<size_t>& /* movedPoints */,
+    const typename std::enable_if<!HasRefit<TreeType>::value>::type* = 0)
+{
+  // Nothing to do.
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -65,7 +88,9 @@ DualTreeKMeans<MetricType, MatType, TreeType>::DualTreeKMeans(
     lowerBounds(dataset.n_cols),
     prunedPoints(dataset.n_cols, false), // Fill with false.
     assignments(dataset.n_cols),
-    visited(dataset.n_cols, false) // Fill with false.
+    visited(dataset.n_cols, false), // Fill with false.
+    centroidTreeDiameter(0.0),
+    centroidTreeMovement(0.0)
 {
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
@@ -99,16 +124,12 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::mat& newCentroids,
     arma::Col<size_t>& counts)
 {
-  // Build a tree on the centroids.  This will make a copy if necessary, which
-  // is unfortunate, but I don't see a reasonable way around it.
-  std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
-
-  // Find the nearest neighbors of each of the clusters.  We have to make our
-  // own TreeType, which is a little bit abuse, but we know for sure the
+  // Build a tree on the centroids, or refit the tree of the last iteration.
+  // We have to make our own TreeType for the nearest neighbor search on the
+  // centroids, which is a little bit abuse, but we know for sure the
   // TreeStatType we have will work.
-  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
-      NNSTreeType> nns(std::move(*centroidTree));
+  UpdateCentroidTree(centroids);
+  CentroidSearchType& nns = centroidSearch;
 
   // Reset information in the tree, if we need to.
   if (iteration > 0)
@@ -136,7 +157,12 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
 
     Timer::Stop("knn");
 
-    UpdateTree(*tree, centroids);
+    // Large subtrees are updated in parallel.
+    #pragma omp parallel
+    {
+      #pragma omp single
+      UpdateTree(*tree, centroids);
+    }
 
     for (size_t i = 0; i < dataset.n_cols; ++i)
       visited[i] = false;
@@ -159,7 +185,11 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
       traverser(rules);
 
   Timer::Start("tree_mod");
-  CoalesceTree(*tree);
+  #pragma omp parallel
+  {
+    #pragma omp single
+    CoalesceTree(*tree);
+  }
   Timer::Stop("tree_mod");
 
   // Set the number of pruned centroids in the root to 0.
@@ -168,7 +198,11 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   distanceCalculations += rules.BaseCases() + rules.Scores();
 
   Timer::Start("tree_mod");
-  DecoalesceTree(*tree);
+  #pragma omp parallel
+  {
+    #pragma omp single
+    DecoalesceTree(*tree);
+  }
   Timer::Stop("tree_mod");
 
   // Now we need to extract the clusters.
@@ -199,13 +233,72 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   }
   distanceCalculations += centroids.n_cols;
 
-  delete centroidTree;
-
   ++iteration;
 
   return std::sqrt(residual);
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DualTreeKMeans<MetricType, MatType, TreeType>::UpdateCentroidTree(
+    const arma::mat& centroids)
+{
+  Tree& centroidTree = centroidSearch.ReferenceTree();
+  if (iteration > 0 && HasRefit<Tree>::value &&
+      centroidTree.Dataset().n_cols == centroids.n_cols)
+  {
+    // Find the centroids that moved, in the order of the tree.
+    MatType& treeCentroids = centroidTree.Dataset();
+    std::vector<size_t> moved;
+    double maxMovement = 0.0;
+    for (size_t i = 0; i < treeCentroids.n_cols; ++i)
+    {
+      const size_t c = oldFromNewCentroids.empty() ? i :
+          oldFromNewCentroids[i];
+      const double movement = metric.Evaluate(treeCentroids.col(i),
+          centroids.col(c));
+      if (movement > 0.0)
+      {
+        moved.push_back(i);
+        maxMovement = std::max(maxMovement, movement);
+      }
+    }
+    distanceCalculations += centroids.n_cols;
+
+    // While the centroids stay close to where they were when the tree was
+    // built, the structure of the tree is still good, so only the bounds of
+    // the nodes holding the centroids that moved are updated.
+    if (centroidTreeMovement + maxMovement <=
+        maxRefitMovement * centroidTreeDiameter)
+    {
+      for (size_t i = 0; i < moved.size(); ++i)
+      {
+        const size_t c = oldFromNewCentroids.empty() ? moved[i] :
+            oldFromNewCentroids[moved[i]];
+        treeCentroids.col(moved[i]) = centroids.col(c);
+      }
+
+      RefitTree(centroidTree, moved);
+      centroidTreeMovement += maxMovement;
+      return;
+    }
+  }
+
+  // Build a new tree.  This will make a copy if necessary, which is
+  // unfortunate, but I don't see a reasonable way around it.
+  oldFromNewCentroids.clear();
+  Tree* newTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+  centroidSearch.Train(std::move(*newTree));
+  delete newTree;
+
+  centroidTreeDiameter =
+      2 * centroidSearch.ReferenceTree().FurthestDescendantDistance();
+  centroidTreeMovement = 0.0;
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -222,6 +315,10 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::UpdateTree(
   const bool prunedLastIteration = node.Stat().StaticPruned();
   node.Stat().StaticPruned() = false;
 
+  // Distance calculations are counted locally, since several nodes may be
+  // updated at once.
+  size_t nodeDistanceCalculations = 0;
+
   // Grab information from the parent, if we can.
   if (node.Parent() != NULL &&
       node.Parent()->Stat().Pruned() == centroids.n_cols &&
@@ -328,7 +425,7 @@ visited[node.Descendant(i)] << ".\n";
                    node.MaxDistance(centroids.col(node.Stat().Owner())));
       adjustedUpperBound = node.Stat().UpperBound();
 
-      ++distanceCalculations;
+      ++nodeDistanceCalculations;
       if (node.Stat().UpperBound() < node.Stat().LowerBound())
         node.Stat().StaticPruned() = true;
     }
@@ -339,15 +436,23 @@ visited[node.Descendant(i)] << ".\n";
   }
 
   // Recurse into children, and if all the children (and all the points) are
-  // pruned, then we can mark this as statically pruned.
-  bool allChildrenPruned = true;
+  // pruned, then we can mark this as statically pruned.  The children of large
+  // nodes are updated in parallel; they only read the statistic of this node,
+  // which is not modified until they are done.
   for (size_t i = 0; i < node.NumChildren(); ++i)
   {
-    UpdateTree(node.Child(i), centroids, unadjustedUpperBound,
-        adjustedUpperBound, unadjustedLowerBound, adjustedLowerBound);
+    Tree* child = &node.Child(i);
+    #pragma omp task shared(centroids) if (node.NumDescendants() >= \
+        parallelUpdateSize)
+    UpdateTree(*child, centroids, unadjustedUpperBound, adjustedUpperBound,
+        unadjustedLowerBound, adjustedLowerBound);
+  }
+  #pragma omp taskwait
+
+  bool allChildrenPruned = true;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
     if (!node.Child(i).Stat().StaticPruned())
       allChildrenPruned = false;
-  }
 
   bool allPointsPruned = true;
   if (tree::TreeTraits<Tree>::HasSelfChildren && node.NumChildren() > 0)
@@ -400,7 +505,7 @@ visited[node.Descendant(i)] << ".\n";
         // Attempt to tighten the bound.
         upperBounds[index] = metric.Evaluate(dataset.col(index),
                                              centroids.col(owner));
-        ++distanceCalculations;
+        ++nodeDistanceCalculations;
         if (upperBounds[index] < pruningLowerBound)
         {
           prunedPoints[index] = true;
@@ -434,6 +539,9 @@ visited[node.Descendant(i)] << ".\n";
   }
 */
 
+  #pragma omp atomic
+  distanceCalculations += nodeDistanceCalculations;
+
   // If all of the children and points are pruned, we may mark this node as
   // pruned.
   if (allChildrenPruned && allPointsPruned && !node.Stat().StaticPruned())
@@ -577,40 +685,42 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::CoalesceTree(
   if (node.NumChildren() == 0)
     return; // We can't do anything.
 
-  // If this is the root node, we can't coalesce.
-  if (node.Parent() != NULL)
+  // First, we should coalesce those children that aren't statically pruned
+  // (the children of the root are never hidden, since we can't coalesce the
+  // root).  Each child only modifies its own slot in this node, so the
+  // children of large nodes are coalesced in parallel.
+  const size_t numChildren = node.NumChildren();
+  std::vector<char> hidden(numChildren);
+  for (size_t i = 0; i < numChildren; ++i)
   {
-    // First, we should coalesce those nodes that aren't statically pruned.
-    for (size_t i = node.NumChildren() - 1; i > 0; --i)
+    hidden[i] = (node.Parent() != NULL) && node.Child(i).Stat().StaticPruned();
+    if (!hidden[i])
     {
-      if (node.Child(i).Stat().StaticPruned())
-        HideChild(node, i);
-      else
-        CoalesceTree(node.Child(i), i);
+      Tree* childNode = &node.Child(i);
+      #pragma omp task if (node.NumDescendants() >= parallelUpdateSize)
+      CoalesceTree(*childNode, i);
     }
+  }
+  #pragma omp taskwait
 
-    if (node.Child(0).Stat().StaticPruned())
-      HideChild(node, 0);
-    else
-      CoalesceTree(node.Child(0), 0);
-
-    // If we've pruned all but one child, then notPrunedIndex will contain the
-    // index of that child, and we can coalesce this node entirely.  Note that
-    // the case where all children are statically pruned should not happen,
-    // because then this node should itself be statically pruned.
+  // If this is the root node, we can't coalesce.
+  if (node.Parent() != NULL)
+  {
+    // Hide the statically pruned children, from the last one so that the
+    // indices of the other children don't change.
+    for (size_t i = numChildren; i > 0; --i)
+      if (hidden[i - 1])
+        HideChild(node, i - 1);
+
+    // If we've pruned all but one child, we can coalesce this node entirely.
+    // Note that the case where all children are statically pruned should not
+    // happen, because then this node should itself be statically pruned.
     if (node.NumChildren() == 1)
     {
       node.Child(0).Parent() = node.Parent();
       node.Parent()->ChildPtr(child) = node.ChildPtr(0);
     }
   }
-  else
-  {
-    // We can't coalesce the root, so call the children individually and
-    // coalesce them.
-    for (size_t i = 0; i < node.NumChildren(); ++i)
-      CoalesceTree(node.Child(i), i);
-  }
 }
 
 template<typename MetricType,
@@ -624,7 +734,12 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::DecoalesceTree(Tree& node)
   RestoreChildren(node);
 
   for (size_t i = 0; i < node.NumChildren(); ++i)
-    DecoalesceTree(node.Child(i));
+  {
+    Tree* childNode = &node.Child(i);
+    #pragma omp task if (node.NumDescendants() >= parallelUpdateSize)
+    DecoalesceTree(*childNode);
+  }
+  #pragma omp taskwait
 }
 
 //! Utility function for hiding children in a non-binary tree.
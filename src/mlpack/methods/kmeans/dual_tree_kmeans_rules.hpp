@@ -29,7 +29,7 @@ class DualTreeKMeansRules
                       arma::vec& upperBounds,
                       arma::vec& lowerBounds,
                       MetricType& metric,
-                      const std::vector<bool>& prunedPoints,
+                      const std::vector<char>& prunedPoints,
                       const std::vector<size_t>& oldFromNewCentroids,
                       std::vector<bool>& visited);
 
@@ -67,7 +67,7 @@ class DualTreeKMeansRules
   arma::vec& lowerBounds;
   MetricType& metric;
 
-  const std::vector<bool>& prunedPoints;
+  const std::vector<char>& prunedPoints;
 
   const std::vector<size_t>& oldFromNewCentroids;
 
@@ -32,8 +32,8 @@ class ElkanKMeans
    * @param newCentroids New cluster centroids.
    * @param counts Current counts, to be overwritten with new counts.
    */
-  double Iterate(const arma::mat& centroids,
-                 arma::mat& newCentroids,
+  double Iterate(const arma::Mat<typename MatType::elem_type>& centroids,
+                 arma::Mat<typename MatType::elem_type>& newCentroids,
                  arma::Col<size_t>& counts);
 
   size_t DistanceCalculations() const { return distanceCalculations; }
@@ -30,9 +30,10 @@ ElkanKMeans<MetricType, MatType>::ElkanKMeans(const MatType& dataset,
 
 // Run a single iteration of Elkan's algorithm for Lloyd iterations.
 template<typename MetricType, typename MatType>
-double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
-                                                 arma::mat& newCentroids,
-                                                 arma::Col<size_t>& counts)
+double ElkanKMeans<MetricType, MatType>::Iterate(
+    const arma::Mat<typename MatType::elem_type>& centroids,
+    arma::Mat<typename MatType::elem_type>& newCentroids,
+    arma::Col<size_t>& counts)
 {
   // Clear new centroids.
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
@@ -46,9 +47,6 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
-
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
   {
@@ -79,19 +77,32 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  The
+  // bounds of each point are independent of the other points, so the points
+  // are processed in parallel; each thread accumulates its own new centroids.
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:pointDistanceCalculations)
   {
-    // Step 2: identify all points such that u(x) <= s(c(x)).
-    if (upperBounds(i) <= minClusterDistances(assignments[i]))
-    {
-      // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-      continue;
-    }
-    else
+    arma::Mat<typename MatType::elem_type> localCentroids(centroids.n_rows,
+        centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
     {
+      // Step 2: identify all points such that u(x) <= s(c(x)).
+      if (upperBounds(i) <= minClusterDistances(assignments[i]))
+      {
+        // No change needed.  This point must still belong to that cluster.
+        localCounts(assignments[i])++;
+        localCentroids.col(assignments[i]) +=
+            arma::Col<typename MatType::elem_type>(dataset.col(i));
+        continue;
+      }
+
+      // Initially set r(x) to true.
+      bool mustRecalculate = true;
+
       for (size_t c = 0; c < centroids.n_cols; ++c)
       {
         // Step 3: for all remaining points x and centers c such that c != c(x),
@@ -108,13 +119,13 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
         // Otherwise, d(x, c(x)) = u(x).
         double dist;
-        if (mustRecalculate[i])
+        if (mustRecalculate)
         {
-          mustRecalculate[i] = false;
+          mustRecalculate = false;
           dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
           lowerBounds(assignments[i], i) = dist;
           upperBounds(i) = dist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
 
           // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
@@ -136,7 +147,7 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           const double pointDist = metric.Evaluate(dataset.col(i),
                                                    centroids.col(c));
           lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
           if (pointDist < dist)
           {
             upperBounds(i) = pointDist;
@@ -144,14 +155,23 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           }
         }
       }
+
+      // At this point, we know the new cluster assignment.
+      // Step 4: for each center c, let m(c) be the mean of the points assigned
+      // to c.
+      localCentroids.col(assignments[i]) +=
+          arma::Col<typename MatType::elem_type>(dataset.col(i));
+      localCounts[assignments[i]]++;
     }
 
-    // At this point, we know the new cluster assignment.
-    // Step 4: for each center c, let m(c) be the mean of the points assigned to
-    // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    // Combine the centroids calculated by each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
   }
+  distanceCalculations += pointDistanceCalculations;
 
   // Now, normalize and calculate the distance each cluster has moved.
   arma::vec moveDistances(centroids.n_cols);
@@ -166,7 +186,8 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
@@ -29,9 +29,10 @@ HamerlyKMeans<MetricType, MatType>::HamerlyKMeans(const MatType& dataset,
 }
 
 template<typename MetricType, typename MatType>
-double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
-                                                   arma::mat& newCentroids,
-                                                   arma::Col<size_t>& counts)
+double HamerlyKMeans<MetricType, MatType>::Iterate(
+    const arma::Mat<typename MatType::elem_type>& centroids,
+    arma::Mat<typename MatType::elem_type>& newCentroids,
+    arma::Col<size_t>& counts)
 {
   size_t hamerlyPruned = 0;
 
@@ -67,64 +68,85 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     }
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // The bounds of each point are independent of the other points, so the
+  // points are processed in parallel; each thread accumulates its own new
+  // centroids.
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:hamerlyPruned, pointDistanceCalculations)
   {
-    const double m = std::max(minClusterDistances(assignments[i]),
-                              lowerBounds(i));
+    arma::Mat<typename MatType::elem_type> localCentroids(centroids.n_rows,
+        centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
 
-    // First bound test.
-    if (upperBounds(i) <= m)
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
     {
-      ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
-
-    // Tighten upper bound.
-    upperBounds(i) = metric.Evaluate(dataset.col(i),
-                                     centroids.col(assignments[i]));
-    ++distanceCalculations;
+      const double m = std::max(minClusterDistances(assignments[i]),
+                                lowerBounds(i));
 
-    // Second bound test.
-    if (upperBounds(i) <= m)
-    {
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
-
-    // The bounds failed.  So test against all other clusters.
-    // This is Hamerly's Point-All-Ctrs() function from the paper.
-    // We have to reset the lower bound first.
-    lowerBounds(i) = DBL_MAX;
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-    {
-      if (c == assignments[i])
+      // First bound test.
+      if (upperBounds(i) <= m)
+      {
+        ++hamerlyPruned;
+        localCentroids.col(assignments[i]) += dataset.col(i);
+        ++localCounts(assignments[i]);
         continue;
+      }
 
-      const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+      // Tighten upper bound.
+      upperBounds(i) = metric.Evaluate(dataset.col(i),
+                                       centroids.col(assignments[i]));
+      ++pointDistanceCalculations;
 
-      // Is this a better cluster?  At this point, upperBounds[i] = d(i, c(i)).
-      if (dist < upperBounds(i))
+      // Second bound test.
+      if (upperBounds(i) <= m)
       {
-        // lowerBounds holds the second closest cluster.
-        lowerBounds(i) = upperBounds(i);
-        upperBounds(i) = dist;
-        assignments[i] = c;
+        localCentroids.col(assignments[i]) += dataset.col(i);
+        ++localCounts(assignments[i]);
+        continue;
       }
-      else if (dist < lowerBounds(i))
+
+      // The bounds failed.  So test against all other clusters.
+      // This is Hamerly's Point-All-Ctrs() function from the paper.
+      // We have to reset the lower bound first.
+      lowerBounds(i) = DBL_MAX;
+      for (size_t c = 0; c < centroids.n_cols; ++c)
       {
-        // This is a closer second-closest cluster.
-        lowerBounds(i) = dist;
+        if (c == assignments[i])
+          continue;
+
+        const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+
+        // Is this a better cluster?  At this point, upperBounds[i] = d(i,
+        // c(i)).
+        if (dist < upperBounds(i))
+        {
+          // lowerBounds holds the second closest cluster.
+          lowerBounds(i) = upperBounds(i);
+          upperBounds(i) = dist;
+          assignments[i] = c;
+        }
+        else if (dist < lowerBounds(i))
+        {
+          // This is a closer second-closest cluster.
+          lowerBounds(i) = dist;
+        }
       }
+      pointDistanceCalculations += centroids.n_cols - 1;
+
+      // Update new centroids.
+      localCentroids.col(assignments[i]) += dataset.col(i);
+      ++localCounts(assignments[i]);
     }
-    distanceCalculations += centroids.n_cols - 1;
 
-    // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
-    ++counts(assignments[i]);
+    // Combine the centroids calculated by each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
   }
+  distanceCalculations += pointDistanceCalculations;
 
   // Normalize centroids and calculate cluster movement (contains parts of
   // Move-Centers() and Update-Bounds()).
@@ -158,7 +180,8 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   }
 
   // Now update bounds (lines 3-8 of Update-Bounds()).
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     upperBounds(i) += centroidMovements(assignments[i]);
     if (assignments[i] == furthestMovingCluster)
@@ -32,7 +32,7 @@ class KillEmptyClusters
    * This function sets an empty cluster found during k-means to all DBL_MAX
    * (i.e. an invalid "dead" cluster).
    *
-   * @tparam MatType Type of data (arma::mat or arma::spmat).
+   * @tparam MatType Type of data (arma::mat, arma::fmat or arma::spmat).
    * @param * (data) Dataset on which clustering is being performed.
    * @param emptyCluster Index of cluster which is empty.
    * @param * (oldCentroids) Centroids of each cluster (one per column) at the start
@@ -49,8 +49,8 @@ class KillEmptyClusters
   static inline force_inline void EmptyCluster(
       const MatType& /* data */,
       const size_t emptyCluster,
-      const arma::mat& /* oldCentroids */,
-      arma::mat& newCentroids,
+      const arma::Mat<typename MatType::elem_type>& /* oldCentroids */,
+      arma::Mat<typename MatType::elem_type>& newCentroids,
       arma::Col<size_t>& clusterCounts,
       MetricType& /* metric */,
       const size_t /* iteration */)
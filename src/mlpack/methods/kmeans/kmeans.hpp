@@ -49,18 +49,34 @@ namespace kmeans /** K-Means clustering. */ {
  * k.Cluster(data, 6, centroids); // 6 clusters.
  * @endcode
  *
+ * The centroids have the element type of the data, so single-precision data
+ * can be clustered without conversion by using arma::fmat as MatType (with the
+ * NaiveKMeans, ElkanKMeans or HamerlyKMeans Lloyd step types):
+ *
+ * @code
+ * extern arma::fmat data;
+ * arma::fmat centroids;
+ *
+ * KMeans<metric::EuclideanDistance, SampleInitialization,
+ *     MaxVarianceNewCluster, NaiveKMeans, arma::fmat> k;
+ * k.Cluster(data, 3, centroids);
+ * @endcode
+ *
  * @tparam MetricType The distance metric to use for this KMeans; see
  *     metric::LMetric for an example.
  * @tparam InitialPartitionPolicy Initial partitioning policy; must implement a
- *     default constructor and either 'void Cluster(const arma::mat&, const
- *     size_t, arma::Row<size_t>&)' or 'void Cluster(const arma::mat&, const
- *     size_t, arma::mat&)'.
+ *     default constructor and either 'void Cluster(const MatType&, const
+ *     size_t, arma::Row<size_t>&)' or 'void Cluster(const MatType&, const
+ *     size_t, arma::Mat<ElemType>&)', where ElemType is the element type of
+ *     MatType.
  * @tparam EmptyClusterPolicy Policy for what to do on an empty cluster; must
- *     implement a default constructor and 'void EmptyCluster(const arma::mat&
- *     data, const size_t emptyCluster, const arma::mat& oldCentroids,
- *     arma::mat& newCentroids, arma::Col<size_t>& counts, MetricType& metric,
- *     const size_t iteration)'.
+ *     implement a default constructor and 'void EmptyCluster(const MatType&
+ *     data, const size_t emptyCluster, const arma::Mat<ElemType>& oldCentroids,
+ *     arma::Mat<ElemType>& newCentroids, arma::Col<size_t>& counts,
+ *     MetricType& metric, const size_t iteration)'.
  * @tparam LloydStepType Implementation of single Lloyd step to use.
+ * @tparam MatType Type of data to cluster (for instance arma::mat, arma::fmat
+ *     or arma::sp_mat).
  *
  * @see RandomPartition, SampleInitialization, RefinedStart, AllowEmptyClusters,
  *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans
@@ -98,7 +114,7 @@ class KMeans
    * initial guess of the cluster assignments; to do this, set initialGuess to
    * true.
    *
-   * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+   * @tparam MatType Type of matrix (arma::mat, arma::fmat or arma::sp_mat).
    * @param data Dataset to cluster.
    * @param clusters Number of clusters to compute.
    * @param assignments Vector to store cluster assignments in.
@@ -116,7 +132,7 @@ class KMeans
    * specified by filling the centroids matrix with the initial centroids and
    * specifying initialGuess = true.
    *
-   * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+   * @tparam MatType Type of matrix (arma::mat, arma::fmat or arma::sp_mat).
    * @param data Dataset to cluster.
    * @param clusters Number of clusters to compute.
    * @param centroids Matrix in which centroids are stored.
@@ -125,7 +141,7 @@ class KMeans
    */
   void Cluster(const MatType& data,
                size_t clusters,
-               arma::mat& centroids,
+               arma::Mat<typename MatType::elem_type>& centroids,
                const bool initialGuess = false);
 
   /**
@@ -138,7 +154,7 @@ class KMeans
    * supersedes initialCentroidGuess, so if both are set to true, the
    * assignments vector is used.
    *
-   * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+   * @tparam MatType Type of matrix (arma::mat, arma::fmat or arma::sp_mat).
    * @param data Dataset to cluster.
    * @param clusters Number of clusters to compute.
    * @param assignments Vector to store cluster assignments in.
@@ -151,7 +167,7 @@ class KMeans
   void Cluster(const MatType& data,
                const size_t clusters,
                arma::Row<size_t>& assignments,
-               arma::mat& centroids,
+               arma::Mat<typename MatType::elem_type>& centroids,
                const bool initialAssignmentGuess = false,
                const bool initialCentroidGuess = false);
 
@@ -26,20 +26,23 @@ HAS_MEM_FUNC(Cluster, GivesCentroidsCheck);
 
 /**
  * 'value' is true if the InitialPartitionPolicy class has a member
- * Cluster(const arma::mat& data, const size_t clusters, arma::mat& centroids).
+ * Cluster(const MatType& data, const size_t clusters,
+ * arma::Mat<typename MatType::elem_type>& centroids).
  */
-template<typename InitialPartitionPolicy>
+template<typename InitialPartitionPolicy, typename MatType = arma::mat>
 struct GivesCentroids
 {
+  typedef arma::Mat<typename MatType::elem_type> CentroidsType;
+
   static const bool value =
     // Non-static version.
     GivesCentroidsCheck<InitialPartitionPolicy,
-        void(InitialPartitionPolicy::*)(const arma::mat&,
+        void(InitialPartitionPolicy::*)(const MatType&,
                                         const size_t,
-                                        arma::mat&)>::value ||
+                                        CentroidsType&)>::value ||
     // Static version.
     GivesCentroidsCheck<InitialPartitionPolicy,
-        void(*)(const arma::mat&, const size_t, arma::mat&)>::value;
+        void(*)(const MatType&, const size_t, CentroidsType&)>::value;
 };
 
 //! Call the initial partition policy, if it returns assignments.  This returns
@@ -51,9 +54,9 @@ bool GetInitialAssignmentsOrCentroids(
     const MatType& data,
     const size_t clusters,
     arma::Row<size_t>& assignments,
-    arma::mat& /* centroids */,
+    arma::Mat<typename MatType::elem_type>& /* centroids */,
     const typename std::enable_if_t<
-        !GivesCentroids<InitialPartitionPolicy>::value>* = 0)
+        !GivesCentroids<InitialPartitionPolicy, MatType>::value>* = 0)
 {
   ipp.Cluster(data, clusters, assignments);
 
@@ -69,9 +72,9 @@ bool GetInitialAssignmentsOrCentroids(
     const MatType& data,
     const size_t clusters,
     arma::Row<size_t>& /* assignments */,
-    arma::mat& centroids,
+    arma::Mat<typename MatType::elem_type>& centroids,
     const typename std::enable_if_t<
-        GivesCentroids<InitialPartitionPolicy>::value>* = 0)
+        GivesCentroids<InitialPartitionPolicy, MatType>::value>* = 0)
 {
   ipp.Cluster(data, clusters, centroids);
 
@@ -126,7 +129,7 @@ Cluster(const MatType& data,
         arma::Row<size_t>& assignments,
         const bool initialGuess)
 {
-  arma::mat centroids(data.n_rows, clusters);
+  arma::Mat<typename MatType::elem_type> centroids(data.n_rows, clusters);
   Cluster(data, clusters, assignments, centroids, initialGuess);
 }
 
@@ -147,7 +150,7 @@ void KMeans<
     MatType>::
 Cluster(const MatType& data,
         const size_t clusters,
-        arma::mat& centroids,
+        arma::Mat<typename MatType::elem_type>& centroids,
         const bool initialGuess)
 {
   // Make sure we have more points than clusters.
@@ -192,7 +195,8 @@ Cluster(const MatType& data,
       centroids.zeros(data.n_rows, clusters);
       for (size_t i = 0; i < data.n_cols; ++i)
       {
-        centroids.col(assignments[i]) += arma::vec(data.col(i));
+        centroids.col(assignments[i]) +=
+            arma::Col<typename MatType::elem_type>(data.col(i));
         counts[assignments[i]]++;
       }
 
@@ -208,7 +212,7 @@ Cluster(const MatType& data,
   size_t iteration = 0;
 
   LloydStepType<MetricType, MatType> lloydStep(data, metric);
-  arma::mat centroidsOther;
+  arma::Mat<typename MatType::elem_type> centroidsOther;
   double cNorm;
 
   do
@@ -281,7 +285,7 @@ void KMeans<
 Cluster(const MatType& data,
         const size_t clusters,
         arma::Row<size_t>& assignments,
-        arma::mat& centroids,
+        arma::Mat<typename MatType::elem_type>& centroids,
         const bool initialAssignmentGuess,
         const bool initialCentroidGuess)
 {
@@ -299,7 +303,8 @@ Cluster(const MatType& data,
     centroids.zeros(data.n_rows, clusters);
     for (size_t i = 0; i < data.n_cols; ++i)
     {
-      centroids.col(assignments[i]) += arma::vec(data.col(i));
+      centroids.col(assignments[i]) +=
+          arma::Col<typename MatType::elem_type>(data.col(i));
       counts[assignments[i]]++;
     }
 
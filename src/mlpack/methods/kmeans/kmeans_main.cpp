@@ -17,10 +17,14 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
+#include "yinyang_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -53,14 +57,27 @@ BINDING_LONG_DESC(
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "Alternately, the k-means++ seeding strategy can be used by specifying the "
+    + PRINT_PARAM_STRING("kmeans_plus_plus") + " parameter, or its scalable "
+    "parallel variant k-means|| by specifying the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter; the number of "
+    "sampling rounds of k-means|| is given by " +
+    PRINT_PARAM_STRING("parallel_rounds") + "."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
-    "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "modification to Elkan's algorithm ('hamerly'), Yinyang k-means, which "
+    "keeps one bound per group of centroids and is fastest for large k "
+    "('yinyang'), the dual-tree k-means "
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), and mini-batch k-means ('minibatch'), "
+    "which updates the centroids with a random sample of 1024 points in each "
+    "iteration; mini-batch k-means is approximate and needs many more "
+    "iterations, so " + PRINT_PARAM_STRING("max_iterations") + " should be "
+    "increased when it is used."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -148,9 +165,17 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for k-means++ and k-means|| initialization.
+PARAM_FLAG("kmeans_plus_plus", "Use the k-means++ strategy to choose initial "
+    "points.", "");
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| strategy to choose initial "
+    "points.", "");
+PARAM_INT_IN("parallel_rounds", "Number of sampling rounds for k-means|| (use "
+    "when --kmeans_parallel is specified).", "", 5);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'yinyang', 'dualtree', "
+    "'dualtree-covertree', or 'minibatch').", "a", "naive");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -179,6 +204,14 @@ static void mlpackMain()
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
+  if (IO::HasParam("refined_start") + IO::HasParam("kmeans_plus_plus") +
+      IO::HasParam("kmeans_parallel") > 1)
+  {
+    Log::Fatal << "Can only pass one of " << PRINT_PARAM_STRING("refined_start")
+        << ", " << PRINT_PARAM_STRING("kmeans_plus_plus") << ", or "
+        << PRINT_PARAM_STRING("kmeans_parallel") << "!" << endl;
+  }
+
   if (IO::HasParam("refined_start"))
   {
     RequireParamValue<int>("samplings", [](int x) { return x > 0; }, true,
@@ -191,6 +224,20 @@ static void mlpackMain()
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (IO::HasParam("kmeans_plus_plus"))
+  {
+    FindEmptyClusterPolicy<KMeansPlusPlusInitialization>(
+        KMeansPlusPlusInitialization());
+  }
+  else if (IO::HasParam("kmeans_parallel"))
+  {
+    RequireParamValue<int>("parallel_rounds", [](int x) { return x > 0; },
+        true, "number of rounds must be positive");
+    const int rounds = IO::GetParam<int>("parallel_rounds");
+
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization((size_t) rounds));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -220,15 +267,17 @@ void FindEmptyClusterPolicy(const InitialPartitionPolicy& ipp)
 template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
-  RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+  RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "yinyang",
+      "pelleg-moore", "dualtree", "dualtree-covertree", "naive", "minibatch" },
+      true, "unknown k-means algorithm");
 
   const string algorithm = IO::GetParam<string>("algorithm");
   if (algorithm == "elkan")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, ElkanKMeans>(ipp);
   else if (algorithm == "hamerly")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, HamerlyKMeans>(ipp);
+  else if (algorithm == "yinyang")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, YinyangKMeans>(ipp);
   else if (algorithm == "pelleg-moore")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
         PellegMooreKMeans>(ipp);
@@ -240,6 +289,9 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "minibatch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        MiniBatchKMeans>(ipp);
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -286,8 +338,11 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       clusters = centroids.n_cols;
 
     ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_plus_plus", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_parallel", true }}, "initial_centroids");
 
-    if (!IO::HasParam("refined_start"))
+    if (!IO::HasParam("refined_start") && !IO::HasParam("kmeans_plus_plus") &&
+        !IO::HasParam("kmeans_parallel"))
       Log::Info << "Using initial centroid guesses." << endl;
   }
 
@@ -0,0 +1,107 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization.hpp
+ *
+ * An implementation of the k-means|| initialization strategy, a scalable
+ * variant of k-means++ that samples many candidate centroids at once in a few
+ * rounds, and then reclusters the candidates.  The strategy is described in
+ * the following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Choose the initial centroids with k-means||.  Starting from one random
+ * point, each round samples every point independently with probability
+ * proportional to its squared distance to the closest candidate, so that
+ * about (oversampling * k) candidates are added per round.  After all the
+ * rounds, each candidate is weighted by the number of points closest to it,
+ * and the k centroids are chosen from the candidates with weighted k-means++.
+ *
+ * Unlike k-means++, which needs k sequential passes over the data, this needs
+ * only one pass per round, and each pass is done in parallel.  The sample does
+ * not depend on the number of threads.
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object, optionally specifying the
+   * number of sampling rounds and the oversampling factor.
+   *
+   * @param rounds Number of sampling rounds.
+   * @param oversampling Expected number of candidates sampled in each round,
+   *     as a multiple of the number of clusters.
+   */
+  KMeansParallelInitialization(const size_t rounds = 5,
+                               const double oversampling = 2.0) :
+      rounds(rounds), oversampling(oversampling) { }
+
+  /**
+   * Initialize the centroids matrix with k-means||.
+   *
+   * @tparam MatType Type of data (arma::mat, arma::fmat or arma::sp_mat).
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::Mat<typename MatType::elem_type>& centroids);
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(rounds);
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+  }
+
+ private:
+  //! The number of sampling rounds.
+  size_t rounds;
+  //! The expected number of candidates per round, as a multiple of k.
+  double oversampling;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(
+    const MatType& data,
+    const size_t clusters,
+    arma::Mat<typename MatType::elem_type>& centroids)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // With too few points there is nothing to gain.
+  if (data.n_cols <= clusters || clusters == 0)
+  {
+    KMeansPlusPlusInitialization::Cluster(data, clusters, centroids);
+    return;
+  }
+
+  // The candidates, and for each point, the squared distance to its closest
+  // candidate and the index of that candidate.
+  std::vector<size_t> candidates;
+  arma::vec distances(data.n_cols);
+  arma::Col<size_t> closest(data.n_cols, arma::fill::zeros);
+
+  // Start from a single random point.
+  candidates.push_back((size_t) math::RandInt(0, data.n_cols));
+  const arma::Col<ElemType> first(data.col(candidates[0]));
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+  {
+    distances[j] = metric::SquaredEuclideanDistance::Evaluate(data.col(j),
+        first);
+  }
+
+  // The points are sampled in fixed blocks, each with its own generator, so
+  // that the sample does not depend on how the blocks are spread over threads.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  const double expected = oversampling * clusters;
+  for (size_t round = 0; round < rounds; ++round)
+  {
+    const double cost = arma::accu(distances);
+    if (!(cost > 0.0))
+      break; // Every point is a candidate already.
+
+    // Sample each point with probability min(1, expected * d(x) / cost).
+    const size_t roundSeed = (size_t) math::randGen();
+    std::vector<std::vector<size_t>> blockSamples(numBlocks);
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      std::mt19937 generator((uint32_t) (roundSeed + b));
+      std::uniform_real_distribution<> uniform;
+      const size_t end = std::min((size_t) (b + 1) * blockSize,
+          (size_t) data.n_cols);
+      for (size_t j = b * blockSize; j < end; ++j)
+        if (uniform(generator) * cost < expected * distances[j])
+          blockSamples[b].push_back(j);
+    }
+
+    const size_t firstNew = candidates.size();
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      candidates.insert(candidates.end(), blockSamples[b].begin(),
+          blockSamples[b].end());
+    }
+    if (candidates.size() == firstNew)
+      continue;
+
+    arma::Mat<ElemType> newCandidates(data.n_rows,
+        candidates.size() - firstNew);
+    for (size_t i = firstNew; i < candidates.size(); ++i)
+      newCandidates.col(i - firstNew) = data.col(candidates[i]);
+
+    // Update the closest candidate of each point.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      for (size_t i = 0; i < newCandidates.n_cols; ++i)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            data.col(j), newCandidates.col(i));
+        if (distance < distances[j])
+        {
+          distances[j] = distance;
+          closest[j] = firstNew + i;
+        }
+      }
+    }
+  }
+
+  // If too few candidates were sampled, fall back to k-means++ on the data.
+  if (candidates.size() < clusters)
+  {
+    KMeansPlusPlusInitialization::Cluster(data, clusters, centroids);
+    return;
+  }
+
+  // Weight each candidate by the number of points closest to it, and choose
+  // the centroids among the candidates.
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  for (size_t j = 0; j < data.n_cols; ++j)
+    weights[closest[j]] += 1.0;
+
+  arma::Mat<ElemType> candidatePoints(data.n_rows, candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i)
+    candidatePoints.col(i) = data.col(candidates[i]);
+
+  KMeansPlusPlusInitialization::Cluster(candidatePoints, weights, clusters,
+      centroids);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
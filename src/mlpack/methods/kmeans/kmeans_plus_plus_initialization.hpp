@@ -0,0 +1,160 @@
+/**
+ * @file methods/kmeans/kmeans_plus_plus_initialization.hpp
+ *
+ * An implementation of the k-means++ initialization strategy, which samples
+ * each new centroid with probability proportional to its squared distance to
+ * the closest centroid chosen so far.  The strategy is described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{arthur2007kmeanspp,
+ *   title={k-means++: The advantages of careful seeding},
+ *   author={Arthur, David and Vassilvitskii, Sergei},
+ *   booktitle={Proceedings of the Eighteenth Annual ACM-SIAM Symposium on
+ *       Discrete Algorithms (SODA '07)},
+ *   pages={1027--1035},
+ *   year={2007}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Choose the initial centroids with k-means++: the first centroid is a random
+ * point, and each following centroid is a point sampled with probability
+ * proportional to its squared Euclidean distance to the closest centroid
+ * chosen so far.  The distances are updated in parallel, so choosing k
+ * centroids takes O(kN) time.
+ */
+class KMeansPlusPlusInitialization
+{
+ public:
+  //! Empty constructor, required by the InitialPartitionPolicy type definition.
+  KMeansPlusPlusInitialization() { }
+
+  /**
+   * Initialize the centroids matrix with k-means++.
+   *
+   * @tparam MatType Type of data (arma::mat, arma::fmat or arma::sp_mat).
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  inline static void Cluster(const MatType& data,
+                             const size_t clusters,
+                             arma::Mat<typename MatType::elem_type>& centroids)
+  {
+    Seed(data, NULL, clusters, centroids);
+  }
+
+  /**
+   * Initialize the centroids matrix with k-means++ on a weighted dataset: each
+   * point is sampled with probability proportional to its weight times its
+   * squared distance to the closest centroid.  This is used to recluster the
+   * candidates of KMeansParallelInitialization.
+   *
+   * @tparam MatType Type of data (arma::mat, arma::fmat or arma::sp_mat).
+   * @param data Dataset.
+   * @param weights Weight of each point.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  inline static void Cluster(const MatType& data,
+                             const arma::vec& weights,
+                             const size_t clusters,
+                             arma::Mat<typename MatType::elem_type>& centroids)
+  {
+    Seed(data, &weights, clusters, centroids);
+  }
+
+  //! Serialize the object (nothing to do).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  //! Run k-means++, with the given weights or with unit weights if NULL.
+  template<typename MatType>
+  static void Seed(const MatType& data,
+                   const arma::vec* weights,
+                   const size_t clusters,
+                   arma::Mat<typename MatType::elem_type>& centroids)
+  {
+    centroids.set_size(data.n_rows, clusters);
+    if (clusters == 0 || data.n_cols == 0)
+      return;
+
+    // The first centroid is a point chosen at random (according to the
+    // weights, if any).
+    arma::vec distances(data.n_cols, arma::fill::ones);
+    size_t index = Sample(distances, weights);
+    centroids.col(0) = data.col(index);
+
+    // distances holds the squared distance of each point to its closest
+    // centroid.
+    distances.fill(arma::datum::inf);
+    for (size_t i = 0; i < clusters; ++i)
+    {
+      if (i > 0)
+      {
+        index = Sample(distances, weights);
+        centroids.col(i) = data.col(index);
+      }
+
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            data.col(j), centroids.col(i));
+        if (distance < distances[j])
+          distances[j] = distance;
+      }
+    }
+  }
+
+  //! Sample a point with probability proportional to its (weighted) distance.
+  static size_t Sample(const arma::vec& distances, const arma::vec* weights)
+  {
+    const double total = (weights == NULL) ? arma::accu(distances) :
+        arma::dot(distances, *weights);
+
+    // If every point is already a centroid, any point will do.
+    if (!(total > 0.0))
+      return (size_t) math::RandInt(0, distances.n_elem);
+
+    const double threshold = math::Random() * total;
+    double cumulative = 0.0;
+    for (size_t j = 0; j < distances.n_elem; ++j)
+    {
+      cumulative += (weights == NULL) ? distances[j] :
+          distances[j] * (*weights)[j];
+      if (cumulative > threshold)
+        return j;
+    }
+
+    // Rounding can leave the threshold just past the last point.
+    size_t j = distances.n_elem - 1;
+    while (j > 0 && distances[j] == 0.0)
+      --j;
+    return j;
+  }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
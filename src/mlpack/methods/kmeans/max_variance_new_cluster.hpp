@@ -33,7 +33,7 @@ class MaxVarianceNewCluster
    * Take the point furthest from the centroid of the cluster with maximum
    * variance to be a new cluster.
    *
-   * @tparam MatType Type of data (arma::mat or arma::spmat).
+   * @tparam MatType Type of data (arma::mat, arma::fmat or arma::spmat).
    * @param data Dataset on which clustering is being performed.
    * @param emptyCluster Index of cluster which is empty.
    * @param oldCentroids Centroids of each cluster (one per column) at the start
@@ -48,8 +48,8 @@ class MaxVarianceNewCluster
   template<typename MetricType, typename MatType>
   void EmptyCluster(const MatType& data,
                     const size_t emptyCluster,
-                    const arma::mat& oldCentroids,
-                    arma::mat& newCentroids,
+                    const arma::Mat<typename MatType::elem_type>& oldCentroids,
+                    arma::Mat<typename MatType::elem_type>& newCentroids,
                     arma::Col<size_t>& clusterCounts,
                     MetricType& metric,
                     const size_t iteration);
@@ -69,7 +69,7 @@ class MaxVarianceNewCluster
   //! Called when we are on a new iteration.
   template<typename MetricType, typename MatType>
   void Precalculate(const MatType& data,
-                    const arma::mat& oldCentroids,
+                    const arma::Mat<typename MatType::elem_type>& oldCentroids,
                     arma::Col<size_t>& clusterCounts,
                     MetricType& metric);
 };
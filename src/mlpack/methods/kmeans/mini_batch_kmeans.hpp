@@ -0,0 +1,152 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans.hpp
+ *
+ * An implementation of the mini-batch k-means algorithm, which replaces each
+ * Lloyd iteration over the whole dataset with an update from a small random
+ * sample of points.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A mini-batch step for k-means.  Each call to Iterate() samples a batch of
+ * points from the dataset, assigns each of them to its closest centroid, and
+ * moves each centroid towards the points assigned to it with a per-centroid
+ * learning rate of 1 / (number of points assigned to that centroid so far).
+ * Each centroid is thus the mean of all the points that were ever assigned to
+ * it.  An iteration costs O(kB) for a batch of B points rather than O(kN), but
+ * many more iterations are needed than with Lloyd's algorithm, so the maximum
+ * number of iterations given to KMeans should be raised accordingly.
+ *
+ * The points do not have to come from the dataset given to the constructor:
+ * Update() takes one step with any batch of points, so data that does not fit
+ * in memory can be clustered by loading it one chunk at a time.
+ *
+ * @code
+ * arma::mat emptyDataset;
+ * metric::EuclideanDistance metric;
+ * MiniBatchKMeans<metric::EuclideanDistance, arma::mat> step(emptyDataset,
+ *     metric);
+ *
+ * arma::mat centroids = ...; // Initial centroids.
+ * arma::mat chunk;
+ * while (LoadNextChunk(chunk)) // Any way of getting the next chunk.
+ *   step.Update(chunk, centroids);
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat, arma::fmat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  //! The type of the elements of the data and the centroids.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset to sample batches from (may be empty if only
+   *     Update() is used).
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points sampled by each call to Iterate().
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1024);
+
+  /**
+   * Run one mini-batch step on a batch sampled (with replacement) from the
+   * dataset, storing the updated centroids in newCentroids.  The returned
+   * counts are the total numbers of points assigned to each cluster so far, so
+   * a cluster is only reported as empty if no point was ever assigned to it.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster so far.
+   * @return The distance that the centroids moved (as for the other steps).
+   */
+  double Iterate(const arma::Mat<ElemType>& centroids,
+                 arma::Mat<ElemType>& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Run one mini-batch step with every point of the given batch, updating the
+   * centroids in place.  This can be used to cluster a chunked data source.
+   *
+   * @param batch Points to update the centroids with.
+   * @param centroids Centroids to update.
+   * @return The distance that the centroids moved.
+   */
+  double Update(const MatType& batch, arma::Mat<ElemType>& centroids);
+
+  //! Get the total number of points assigned to each cluster so far.
+  const arma::Col<size_t>& ClusterCounts() const { return clusterCounts; }
+
+  //! Get the number of points sampled by each call to Iterate().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points sampled by each call to Iterate().
+  size_t& BatchSize() { return batchSize; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  /**
+   * Take one step with the given columns of the given points.
+   *
+   * @param points Matrix holding the points of the batch.
+   * @param indices Indices of the points of the batch in that matrix.
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @return The distance that the centroids moved.
+   */
+  double Step(const MatType& points,
+              const arma::uvec& indices,
+              const arma::Mat<ElemType>& centroids,
+              arma::Mat<ElemType>& newCentroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of points sampled by each call to Iterate().
+  size_t batchSize;
+
+  //! The total number of points assigned to each cluster so far.
+  arma::Col<size_t> clusterCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of the mini-batch k-means step.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single step on a sampled batch.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::Mat<ElemType>& centroids,
+    arma::Mat<ElemType>& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  if (dataset.n_cols == 0)
+  {
+    Log::Fatal << "MiniBatchKMeans::Iterate(): cannot sample a batch from an "
+        << "empty dataset!" << std::endl;
+  }
+
+  // Sample the batch, or take the whole dataset if it is smaller than a batch.
+  arma::uvec indices;
+  if (batchSize == 0 || batchSize >= dataset.n_cols)
+  {
+    indices = arma::regspace<arma::uvec>(0, dataset.n_cols - 1);
+  }
+  else
+  {
+    indices = arma::conv_to<arma::uvec>::from(arma::floor(
+        arma::randu<arma::vec>(batchSize) * dataset.n_cols));
+    indices.transform([this](const arma::uword i)
+        { return std::min(i, (arma::uword) dataset.n_cols - 1); });
+  }
+
+  const double cNorm = Step(dataset, indices, centroids, newCentroids);
+  counts = clusterCounts;
+  return cNorm;
+}
+
+// Run a single step on the given batch.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Update(
+    const MatType& batch,
+    arma::Mat<ElemType>& centroids)
+{
+  if (batch.n_cols == 0)
+    return 0.0;
+
+  const arma::uvec indices = arma::regspace<arma::uvec>(0, batch.n_cols - 1);
+  arma::Mat<ElemType> newCentroids;
+  const double cNorm = Step(batch, indices, centroids, newCentroids);
+  centroids.swap(newCentroids);
+  return cNorm;
+}
+
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Step(
+    const MatType& points,
+    const arma::uvec& indices,
+    const arma::Mat<ElemType>& centroids,
+    arma::Mat<ElemType>& newCentroids)
+{
+  // The counts are reset if the number of clusters changes.
+  if (clusterCounts.n_elem != centroids.n_cols)
+    clusterCounts.zeros(centroids.n_cols);
+
+  // Find the closest centroid to each point of the batch, in parallel.
+  arma::Col<size_t> assignments(indices.n_elem);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) indices.n_elem; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(points.col(indices[i]),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+  distanceCalculations += centroids.n_cols * indices.n_elem;
+
+  // Sum the points assigned to each centroid.
+  arma::Mat<ElemType> sums(centroids.n_rows, centroids.n_cols,
+      arma::fill::zeros);
+  arma::Col<size_t> batchCounts(centroids.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    sums.unsafe_col(assignments[i]) += points.col(indices[i]);
+    batchCounts[assignments[i]]++;
+  }
+
+  // Moving a centroid towards each of its points in turn, with a learning rate
+  // of 1 / (number of points assigned to it so far), keeps it at the mean of
+  // all the points ever assigned to it; this does all the moves of the batch
+  // at once.
+  newCentroids = centroids;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    if (batchCounts[i] == 0)
+      continue;
+
+    const size_t total = clusterCounts[i] + batchCounts[i];
+    newCentroids.col(i) = (ElemType(clusterCounts[i]) * centroids.col(i) +
+        sums.col(i)) / ElemType(total);
+    clusterCounts[i] = total;
+  }
+
+  // Calculate how far the centroids moved.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -26,7 +26,7 @@ namespace kmeans {
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
  * @param MetricType Type of metric used with this implementation.
- * @param MatType Matrix type (arma::mat or arma::sp_mat).
+ * @param MatType Matrix type (arma::mat, arma::fmat or arma::sp_mat).
  */
 template<typename MetricType, typename MatType>
 class NaiveKMeans
@@ -50,8 +50,8 @@ class NaiveKMeans
    * @param newCentroids New cluster centroids.
    * @param counts Number of points in each cluster at the end of the iteration.
    */
-  double Iterate(const arma::mat& centroids,
-                 arma::mat& newCentroids,
+  double Iterate(const arma::Mat<typename MatType::elem_type>& centroids,
+                 arma::Mat<typename MatType::elem_type>& newCentroids,
                  arma::Col<size_t>& counts);
 
   size_t DistanceCalculations() const { return distanceCalculations; }
@@ -32,9 +32,10 @@ NaiveKMeans<MetricType, MatType>::NaiveKMeans(const MatType& dataset,
 
 // Run a single iteration.
 template<typename MetricType, typename MatType>
-double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
-                                                 arma::mat& newCentroids,
-                                                 arma::Col<size_t>& counts)
+double NaiveKMeans<MetricType, MatType>::Iterate(
+    const arma::Mat<typename MatType::elem_type>& centroids,
+    arma::Mat<typename MatType::elem_type>& newCentroids,
+    arma::Col<size_t>& counts)
 {
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
@@ -44,8 +45,8 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   #pragma omp parallel
   {
     // The current state of the K-means is private for each thread
-    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
-        arma::fill::zeros);
+    arma::Mat<typename MatType::elem_type> localCentroids(centroids.n_rows,
+        centroids.n_cols, arma::fill::zeros);
     arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
 
     #pragma omp for
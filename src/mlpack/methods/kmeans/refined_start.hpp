@@ -53,7 +53,7 @@ class RefinedStart
    * the random sampling scheme outlined in Bradley and Fayyad's paper, and
    * return centroids.
    *
-   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @tparam MatType Type of data (arma::mat, arma::fmat or arma::sp_mat).
    * @param data Dataset to partition.
    * @param clusters Number of clusters to split dataset into.
    * @param centroids Matrix to store centroids into.
@@ -61,14 +61,14 @@ class RefinedStart
   template<typename MatType>
   void Cluster(const MatType& data,
                const size_t clusters,
-               arma::mat& centroids) const;
+               arma::Mat<typename MatType::elem_type>& centroids) const;
 
   /**
    * Partition the given dataset into the given number of clusters according to
    * the random sampling scheme outlined in Bradley and Fayyad's paper, and
    * return point assignments.
    *
-   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @tparam MatType Type of data (arma::mat, arma::fmat or arma::sp_mat).
    * @param data Dataset to partition.
    * @param clusters Number of clusters to split dataset into.
    * @param assignments Vector to store cluster assignments into.  Values will
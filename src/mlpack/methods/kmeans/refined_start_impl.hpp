@@ -22,16 +22,21 @@ namespace kmeans {
 
 //! Partition the given dataset according to Bradley and Fayyad's algorithm.
 template<typename MatType>
-void RefinedStart::Cluster(const MatType& data,
-                           const size_t clusters,
-                           arma::mat& centroids) const
+void RefinedStart::Cluster(
+    const MatType& data,
+    const size_t clusters,
+    arma::Mat<typename MatType::elem_type>& centroids) const
 {
+  typedef arma::Mat<typename MatType::elem_type> CentroidsType;
+  typedef KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, NaiveKMeans, CentroidsType> KMeansType;
+
   // This will hold the sampled datasets.
   const size_t numPoints = size_t(percentage * data.n_cols);
   MatType sampledData(data.n_rows, numPoints);
   // vector<bool> is packed so each bool is 1 bit.
   std::vector<bool> pointsUsed(data.n_cols, false);
-  arma::mat sampledCentroids(data.n_rows, samplings * clusters);
+  CentroidsType sampledCentroids(data.n_rows, samplings * clusters);
 
   for (size_t i = 0; i < samplings; ++i)
   {
@@ -55,7 +60,7 @@ void RefinedStart::Cluster(const MatType& data,
     // cluster, we re-initialize that cluster as the point furthest away from
     // the cluster with maximum variance.  This is not *exactly* what the paper
     // implements, but it is quite similar, and we'll call it "good enough".
-    KMeans<> kmeans;
+    KMeansType kmeans;
     kmeans.Cluster(sampledData, clusters, centroids);
 
     // Store the sampled centroids.
@@ -65,7 +70,7 @@ void RefinedStart::Cluster(const MatType& data,
   }
 
   // Now, we run k-means on the sampled centroids to get our final clusters.
-  KMeans<> kmeans;
+  KMeansType kmeans;
   kmeans.Cluster(sampledCentroids, clusters, centroids);
 }
 
@@ -76,7 +81,7 @@ void RefinedStart::Cluster(const MatType& data,
 {
   // Perform the Bradley-Fayyad refined start algorithm, and get initial
   // centroids back.
-  arma::mat centroids;
+  arma::Mat<typename MatType::elem_type> centroids;
   Cluster(data, clusters, centroids);
 
   // Turn the final centroids into assignments.
@@ -37,7 +37,7 @@ class SampleInitialization
   template<typename MatType>
   inline static void Cluster(const MatType& data,
                              const size_t clusters,
-                             arma::mat& centroids)
+                             arma::Mat<typename MatType::elem_type>& centroids)
   {
     centroids.set_size(data.n_rows, clusters);
     for (size_t i = 0; i < clusters; ++i)
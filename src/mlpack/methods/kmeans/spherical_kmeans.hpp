@@ -0,0 +1,146 @@
+/**
+ * @file methods/kmeans/spherical_kmeans.hpp
+ *
+ * A Lloyd step for spherical k-means, which clusters L2-normalized points (for
+ * instance sparse TF-IDF vectors) by cosine similarity.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A Lloyd step for spherical k-means:
+ *
+ * @code
+ * @article{dhillon2001concept,
+ *   title={Concept Decompositions for Large Sparse Text Data Using
+ *       Clustering},
+ *   author={Dhillon, I.S. and Modha, D.S.},
+ *   journal={Machine Learning},
+ *   volume={42},
+ *   number={1},
+ *   pages={143--175},
+ *   year={2001}
+ * }
+ * @endcode
+ *
+ * Each point is assigned to the centroid with the largest cosine similarity,
+ * and each new centroid is the sum of its points, normalized to unit length.
+ * The points must have unit L2 norm (like TF-IDF vectors given by
+ * data::StringEncoding with the TF-IDF policy, once their columns are
+ * normalized); the distance metric is then not used, but since all the
+ * centroids have unit length, the closest centroid for the Euclidean distance
+ * is also the most similar one, so KMeans should use the Euclidean distance
+ * (for the final assignments and the empty cluster policy).
+ *
+ * The centroids are dense.  With sparse data (MatType = arma::sp_mat), the
+ * similarities of a point are computed from its nonzero elements only, as
+ * sums of rows of the scaled, transposed centroids (O(k) contiguous values
+ * per nonzero element), and the centroids are accumulated from the nonzero
+ * elements, so the data is never densified.  The similarities are computed in
+ * parallel over the points; the centroids are accumulated afterwards in a
+ * single pass over the nonzero elements, so that each thread does not need
+ * its own copy of the dense centroids.
+ *
+ * @code
+ * extern arma::sp_mat documents; // One normalized TF-IDF vector per column.
+ * arma::Row<size_t> assignments;
+ *
+ * KMeans<metric::EuclideanDistance, SampleInitialization,
+ *     MaxVarianceNewCluster, SphericalKMeans, arma::sp_mat> k;
+ * k.Cluster(documents, 100, assignments);
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation (unused).
+ * @tparam MatType Matrix type (arma::mat, arma::fmat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class SphericalKMeans
+{
+ public:
+  //! The type of the elements of the data and the centroids.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Construct the SphericalKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset to cluster (its points must have unit L2 norm).
+   * @param metric Instantiated metric (unused).
+   */
+  SphericalKMeans(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single iteration of spherical k-means, storing the new (unit length)
+   * centroids in newCentroids.
+   *
+   * @param centroids Current cluster centroids (they do not need to have unit
+   *     length).
+   * @param newCentroids New cluster centroids.
+   * @param counts Current counts, to be overwritten with new counts.
+   * @return The distance that the centroids moved.
+   */
+  double Iterate(const arma::Mat<ElemType>& centroids,
+                 arma::Mat<ElemType>& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the sum of the cosine similarities between the points and their
+  //! centroids at the last iteration (which spherical k-means maximizes).
+  double Objective() const { return objective; }
+
+ private:
+  //! Compute the similarities of a sparse point with all the centroids.
+  static void Similarities(const arma::SpMat<ElemType>& data,
+                           const size_t point,
+                           const arma::Mat<ElemType>& scaledCentroids,
+                           arma::Col<ElemType>& similarities);
+
+  //! Compute the similarities of a dense point with all the centroids.
+  static void Similarities(const arma::Mat<ElemType>& data,
+                           const size_t point,
+                           const arma::Mat<ElemType>& scaledCentroids,
+                           arma::Col<ElemType>& similarities);
+
+  //! Add a sparse point to the given centroid.
+  static void AddPoint(const arma::SpMat<ElemType>& data,
+                       const size_t point,
+                       arma::Mat<ElemType>& centroids,
+                       const size_t cluster);
+
+  //! Add a dense point to the given centroid.
+  static void AddPoint(const arma::Mat<ElemType>& data,
+                       const size_t point,
+                       arma::Mat<ElemType>& centroids,
+                       const size_t cluster);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The cluster of each point at the last iteration.
+  arma::Col<size_t> assignments;
+  //! The objective at the last iteration.
+  double objective;
+
+  //! Track distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "spherical_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file methods/kmeans/spherical_kmeans_impl.hpp
+ *
+ * Implementation of the SphericalKMeans Lloyd step.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "spherical_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+SphericalKMeans<MetricType, MatType>::SphericalKMeans(const MatType& dataset,
+                                                      MetricType& metric) :
+    dataset(dataset),
+    metric(metric),
+    objective(0.0),
+    distanceCalculations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+double SphericalKMeans<MetricType, MatType>::Iterate(
+    const arma::Mat<ElemType>& centroids,
+    arma::Mat<ElemType>& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // The similarity of a point with a centroid is their dot product divided by
+  // the norm of the centroid.  The centroids are transposed and scaled once, so
+  // that the k values for each dimension are contiguous.
+  arma::Col<ElemType> inverseNorms(centroids.n_cols);
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    const ElemType norm = arma::norm(centroids.col(c));
+    inverseNorms[c] = (norm > 0) ? ElemType(1) / norm : ElemType(0);
+  }
+  arma::Mat<ElemType> scaledCentroids = centroids.t();
+  scaledCentroids.each_col() %= inverseNorms;
+
+  // Find the most similar centroid to each point.
+  assignments.set_size(dataset.n_cols);
+  double totalSimilarity = 0.0;
+  #pragma omp parallel reduction(+:totalSimilarity)
+  {
+    arma::Col<ElemType> similarities(centroids.n_cols);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    {
+      Similarities(dataset, (size_t) i, scaledCentroids, similarities);
+      const size_t best = similarities.index_max();
+      assignments[i] = best;
+      totalSimilarity += similarities[best];
+    }
+  }
+  objective = totalSimilarity;
+  distanceCalculations += dataset.n_cols * centroids.n_cols;
+
+  // Sum the points of each cluster.
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    AddPoint(dataset, i, newCentroids, assignments[i]);
+    counts[assignments[i]]++;
+  }
+
+  // Normalize the sums, and calculate the distance each cluster has moved.
+  double cNorm = 0.0;
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    const ElemType norm = arma::norm(newCentroids.col(c));
+    if (norm > 0)
+      newCentroids.col(c) /= norm;
+
+    cNorm += std::pow((double) arma::norm(newCentroids.col(c) -
+        centroids.col(c)), 2.0);
+  }
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType, typename MatType>
+void SphericalKMeans<MetricType, MatType>::Similarities(
+    const arma::SpMat<ElemType>& data,
+    const size_t point,
+    const arma::Mat<ElemType>& scaledCentroids,
+    arma::Col<ElemType>& similarities)
+{
+  similarities.zeros();
+  typename arma::SpMat<ElemType>::const_iterator it = data.begin_col(point);
+  for ( ; it != data.end_col(point); ++it)
+    similarities += (*it) * scaledCentroids.col(it.row());
+}
+
+template<typename MetricType, typename MatType>
+void SphericalKMeans<MetricType, MatType>::Similarities(
+    const arma::Mat<ElemType>& data,
+    const size_t point,
+    const arma::Mat<ElemType>& scaledCentroids,
+    arma::Col<ElemType>& similarities)
+{
+  similarities = scaledCentroids * data.col(point);
+}
+
+template<typename MetricType, typename MatType>
+void SphericalKMeans<MetricType, MatType>::AddPoint(
+    const arma::SpMat<ElemType>& data,
+    const size_t point,
+    arma::Mat<ElemType>& centroids,
+    const size_t cluster)
+{
+  typename arma::SpMat<ElemType>::const_iterator it = data.begin_col(point);
+  for ( ; it != data.end_col(point); ++it)
+    centroids(it.row(), cluster) += (*it);
+}
+
+template<typename MetricType, typename MatType>
+void SphericalKMeans<MetricType, MatType>::AddPoint(
+    const arma::Mat<ElemType>& data,
+    const size_t point,
+    arma::Mat<ElemType>& centroids,
+    const size_t cluster)
+{
+  centroids.col(cluster) += data.col(point);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
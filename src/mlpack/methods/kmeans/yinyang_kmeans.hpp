@@ -0,0 +1,113 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans.hpp
+ *
+ * An implementation of Yinyang k-means, which keeps one lower bound per group
+ * of centroids for each point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An implementation of Yinyang k-means, which gives the same iterations as
+ * Lloyd's algorithm:
+ *
+ * @code
+ * @inproceedings{ding2015yinyang,
+ *     title={{Yinyang K-Means: A Drop-In Replacement of the Classic K-Means
+ *         with Consistent Speedup}},
+ *     author={Ding, Y. and Zhao, Y. and Shen, X. and Musuvathi, M. and
+ *         Mytkowicz, T.},
+ *     booktitle={Proceedings of the 32nd International Conference on Machine
+ *         Learning (ICML '15)},
+ *     pages={579--587},
+ *     year={2015}
+ * }
+ * @endcode
+ *
+ * At the first iteration, the centroids are clustered into ceil(k / 10) groups
+ * (with a few Lloyd iterations on the centroids).  Each point keeps an upper
+ * bound on the distance to its centroid, like in Hamerly's algorithm, and one
+ * lower bound per group on the distance to the centroids of that group (other
+ * than its own), like in Elkan's algorithm, but with k / 10 bounds per point
+ * instead of k.  At each iteration, the bounds are moved by the largest drift
+ * of the centroids of each group; a point is skipped if its upper bound is
+ * below all of its group bounds, and otherwise only the groups whose bound is
+ * below the distance to the best centroid so far are visited.  Inside each
+ * visited group, the centroids that cannot be closer (given the previous bound
+ * of the group and the drift of the centroid) are skipped too.
+ *
+ * The points are processed in parallel.  The metric must satisfy the triangle
+ * inequality.
+ */
+template<typename MetricType, typename MatType>
+class YinyangKMeans
+{
+ public:
+  /**
+   * Construct the YinyangKMeans object, which must store several sets of
+   * bounds.
+   */
+  YinyangKMeans(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single iteration of Yinyang k-means, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Current counts, to be overwritten with new counts.
+   */
+  double Iterate(const arma::Mat<typename MatType::elem_type>& centroids,
+                 arma::Mat<typename MatType::elem_type>& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! Cluster the given centroids into groups.
+  void GroupCentroids(const arma::Mat<typename MatType::elem_type>& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The centroids of each group.
+  std::vector<std::vector<size_t>> groups;
+  //! The group of each centroid.
+  arma::Col<size_t> centroidGroups;
+
+  //! The centroids given to the previous iteration, to compute the drifts.
+  arma::Mat<typename MatType::elem_type> oldCentroids;
+  //! The distance each centroid moved since the previous iteration.
+  arma::vec drifts;
+  //! The largest drift of the centroids of each group.
+  arma::vec groupDrifts;
+
+  //! Holds the index of the cluster that owns each point.
+  arma::Col<size_t> assignments;
+  //! Upper bounds on the distance between each point and its closest cluster.
+  arma::vec upperBounds;
+  //! Lower bounds on the distance between each point and the centroids of
+  //! each group (except the centroid of the point).
+  arma::mat lowerBounds;
+
+  //! Track distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "yinyang_kmeans_impl.hpp"
+
+#endif
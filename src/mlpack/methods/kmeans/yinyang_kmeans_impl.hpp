@@ -0,0 +1,335 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans_impl.hpp
+ *
+ * An implementation of Yinyang k-means for exact Lloyd iterations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "yinyang_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+YinyangKMeans<MetricType, MatType>::YinyangKMeans(const MatType& dataset,
+                                                  MetricType& metric) :
+    dataset(dataset),
+    metric(metric),
+    distanceCalculations(0)
+{
+  // Nothing to do here.
+}
+
+// Run a single iteration of Yinyang k-means.
+template<typename MetricType, typename MatType>
+double YinyangKMeans<MetricType, MatType>::Iterate(
+    const arma::Mat<typename MatType::elem_type>& centroids,
+    arma::Mat<typename MatType::elem_type>& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // Clear new centroids.
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // If this is the first iteration, we must group the centroids, and all the
+  // distances will be computed.
+  const bool firstIteration = (oldCentroids.n_cols != centroids.n_cols);
+  if (firstIteration)
+  {
+    GroupCentroids(centroids);
+
+    assignments.set_size(dataset.n_cols);
+    upperBounds.set_size(dataset.n_cols);
+    lowerBounds.set_size(groups.size(), dataset.n_cols);
+    drifts.zeros(centroids.n_cols);
+  }
+  else
+  {
+    // The drifts are computed from the centroids given to the previous
+    // iteration (and not from the centroids it returned), so that the bounds
+    // stay valid if the empty cluster policy moved some centroids.
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      drifts(c) = metric.Evaluate(oldCentroids.col(c), centroids.col(c));
+      distanceCalculations++;
+    }
+  }
+
+  groupDrifts.zeros(groups.size());
+  for (size_t g = 0; g < groups.size(); ++g)
+    for (size_t j = 0; j < groups[g].size(); ++j)
+      groupDrifts(g) = std::max(groupDrifts(g), drifts(groups[g][j]));
+
+  oldCentroids = centroids;
+
+  // The bounds of each point are independent of the other points, so the
+  // points are processed in parallel; each thread accumulates its own new
+  // centroids.
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:pointDistanceCalculations)
+  {
+    arma::Mat<typename MatType::elem_type> localCentroids(centroids.n_rows,
+        centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    // The smallest and second smallest distances (or lower bounds) to the
+    // centroids of each visited group, and the centroid of the smallest one.
+    arma::vec groupMin(groups.size());
+    arma::vec groupSecondMin(groups.size());
+    arma::Col<size_t> groupMinIndex(groups.size());
+    std::vector<bool> visited(groups.size());
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    {
+      if (firstIteration)
+      {
+        // Compute the distances to all the centroids.
+        size_t best = 0;
+        double bestDist = DBL_MAX;
+        for (size_t g = 0; g < groups.size(); ++g)
+        {
+          groupMin(g) = DBL_MAX;
+          groupSecondMin(g) = DBL_MAX;
+          groupMinIndex(g) = size_t(-1);
+          for (size_t j = 0; j < groups[g].size(); ++j)
+          {
+            const size_t c = groups[g][j];
+            const double dist = metric.Evaluate(dataset.col(i),
+                                                centroids.col(c));
+            pointDistanceCalculations++;
+
+            if (dist < groupMin(g))
+            {
+              groupSecondMin(g) = groupMin(g);
+              groupMin(g) = dist;
+              groupMinIndex(g) = c;
+            }
+            else if (dist < groupSecondMin(g))
+            {
+              groupSecondMin(g) = dist;
+            }
+          }
+
+          if (groupMin(g) < bestDist)
+          {
+            bestDist = groupMin(g);
+            best = groupMinIndex(g);
+          }
+        }
+
+        assignments[i] = best;
+        upperBounds(i) = bestDist;
+        for (size_t g = 0; g < groups.size(); ++g)
+        {
+          lowerBounds(g, i) = (groupMinIndex(g) == best) ? groupSecondMin(g) :
+              groupMin(g);
+        }
+      }
+      else
+      {
+        // Move the bounds by the drifts.
+        const size_t assignment = assignments[i];
+        upperBounds(i) += drifts(assignment);
+        double globalLowerBound = DBL_MAX;
+        for (size_t g = 0; g < groups.size(); ++g)
+        {
+          lowerBounds(g, i) -= groupDrifts(g);
+          globalLowerBound = std::min(globalLowerBound, lowerBounds(g, i));
+        }
+
+        // Global filter: no other centroid can be closer.
+        if (upperBounds(i) > globalLowerBound)
+        {
+          // Tighten the upper bound, and try again.
+          upperBounds(i) = metric.Evaluate(dataset.col(i),
+                                           centroids.col(assignment));
+          pointDistanceCalculations++;
+
+          if (upperBounds(i) > globalLowerBound)
+          {
+            const double assignmentDist = upperBounds(i);
+            size_t best = assignment;
+            double bestDist = assignmentDist;
+
+            for (size_t g = 0; g < groups.size(); ++g)
+            {
+              // Group filter: no centroid of this group can be closer.
+              visited[g] = (lowerBounds(g, i) < bestDist);
+              if (!visited[g])
+                continue;
+
+              // The bound of the group before the drifts, for the local
+              // filter.
+              const double oldLowerBound = lowerBounds(g, i) + groupDrifts(g);
+              groupMin(g) = DBL_MAX;
+              groupSecondMin(g) = DBL_MAX;
+              groupMinIndex(g) = size_t(-1);
+              for (size_t j = 0; j < groups[g].size(); ++j)
+              {
+                const size_t c = groups[g][j];
+                double dist;
+                if (c == assignment)
+                {
+                  dist = assignmentDist;
+                }
+                else if (oldLowerBound - drifts(c) >= bestDist)
+                {
+                  // Local filter: this centroid cannot be closer, so its
+                  // lower bound is enough.
+                  dist = oldLowerBound - drifts(c);
+                }
+                else
+                {
+                  dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+                  pointDistanceCalculations++;
+                  if (dist < bestDist)
+                  {
+                    bestDist = dist;
+                    best = c;
+                  }
+                }
+
+                if (dist < groupMin(g))
+                {
+                  groupSecondMin(g) = groupMin(g);
+                  groupMin(g) = dist;
+                  groupMinIndex(g) = c;
+                }
+                else if (dist < groupSecondMin(g))
+                {
+                  groupSecondMin(g) = dist;
+                }
+              }
+            }
+
+            // Now that the closest centroid is known, update the bounds of
+            // the visited groups.
+            for (size_t g = 0; g < groups.size(); ++g)
+            {
+              if (visited[g])
+              {
+                lowerBounds(g, i) = (groupMinIndex(g) == best) ?
+                    groupSecondMin(g) : groupMin(g);
+              }
+            }
+
+            // If the point changed clusters and the group of its old centroid
+            // wasn't visited, the old centroid now counts in its bound.
+            if (best != assignment && !visited[centroidGroups[assignment]])
+            {
+              const size_t g = centroidGroups[assignment];
+              lowerBounds(g, i) = std::min(lowerBounds(g, i), assignmentDist);
+            }
+
+            assignments[i] = best;
+            upperBounds(i) = bestDist;
+          }
+        }
+      }
+
+      localCentroids.col(assignments[i]) +=
+          arma::Col<typename MatType::elem_type>(dataset.col(i));
+      localCounts[assignments[i]]++;
+    }
+
+    // Combine the centroids calculated by each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
+  }
+  distanceCalculations += pointDistanceCalculations;
+
+  // Now, normalize and calculate the distance each cluster has moved.
+  double cNorm = 0.0; // Cluster movement for residual.
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    if (counts[c] > 0)
+      newCentroids.col(c) /= counts[c];
+
+    cNorm += std::pow(metric.Evaluate(newCentroids.col(c), centroids.col(c)),
+        2.0);
+    distanceCalculations++;
+  }
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType, typename MatType>
+void YinyangKMeans<MetricType, MatType>::GroupCentroids(
+    const arma::Mat<typename MatType::elem_type>& centroids)
+{
+  const size_t k = centroids.n_cols;
+  const size_t numGroups = (k + 9) / 10;
+
+  // Start from evenly spaced centroids, and run a few Lloyd iterations on the
+  // centroids; the groups only need to be reasonable.
+  arma::mat groupCentroids(centroids.n_rows, numGroups);
+  for (size_t g = 0; g < numGroups; ++g)
+    groupCentroids.col(g) = arma::conv_to<arma::vec>::from(
+        centroids.col((g * k) / numGroups));
+
+  centroidGroups.set_size(k);
+  for (size_t iteration = 0; iteration < 5; ++iteration)
+  {
+    for (size_t c = 0; c < k; ++c)
+    {
+      double bestDist = DBL_MAX;
+      for (size_t g = 0; g < numGroups; ++g)
+      {
+        const double dist = metric.Evaluate(
+            arma::conv_to<arma::vec>::from(centroids.col(c)),
+            groupCentroids.col(g));
+        distanceCalculations++;
+        if (dist < bestDist)
+        {
+          bestDist = dist;
+          centroidGroups[c] = g;
+        }
+      }
+    }
+
+    arma::Col<size_t> groupCounts(numGroups, arma::fill::zeros);
+    arma::mat sums(centroids.n_rows, numGroups, arma::fill::zeros);
+    for (size_t c = 0; c < k; ++c)
+    {
+      sums.col(centroidGroups[c]) +=
+          arma::conv_to<arma::vec>::from(centroids.col(c));
+      groupCounts[centroidGroups[c]]++;
+    }
+
+    for (size_t g = 0; g < numGroups; ++g)
+      if (groupCounts[g] > 0)
+        groupCentroids.col(g) = sums.col(g) / groupCounts[g];
+  }
+
+  // Build the groups, without the empty ones.
+  std::vector<size_t> groupIndices(numGroups, size_t(-1));
+  groups.clear();
+  for (size_t c = 0; c < k; ++c)
+  {
+    size_t& g = groupIndices[centroidGroups[c]];
+    if (g == size_t(-1))
+    {
+      g = groups.size();
+      groups.push_back(std::vector<size_t>());
+    }
+
+    groups[g].push_back(c);
+    centroidGroups[c] = g;
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -226,9 +226,19 @@ double LARS::Train(const arma::mat& matX,
     return maxCorr;
   }
 
+  // When the Cholesky factorization is used, only the entries of the Gram
+  // matrix between the active dimensions are needed, so unless a Gram matrix
+  // was given, they are computed when a dimension becomes active, and the full
+  // Gram matrix (which takes O(d^2 N) time and O(d^2) memory) is never formed.
+  const bool computeGramColumns = useCholesky && (matGram == &matGramInternal);
+
   // Compute the Gram matrix.  If this is the elastic net problem, we will add
   // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
+  if (computeGramColumns)
+  {
+    matGramInternal.reset();
+  }
+  else if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
   {
     // In this case, matGram should reference matGramInternal.
     matGramInternal = trans(dataRef) * dataRef;
@@ -254,7 +264,21 @@ double LARS::Train(const arma::mat& matX,
 
     if (!lassocond)
     {
-      if (useCholesky)
+      if (useCholesky && computeGramColumns)
+      {
+        // Compute the entries of the Gram matrix between the new dimension and
+        // the active set.
+        arma::vec newGramCol(activeSet.size());
+        for (size_t i = 0; i < activeSet.size(); ++i)
+        {
+          newGramCol[i] = arma::dot(dataRef.col(activeSet[i]),
+              dataRef.col(changeInd));
+        }
+
+        CholeskyInsert(arma::dot(dataRef.col(changeInd),
+            dataRef.col(changeInd)), newGramCol);
+      }
+      else if (useCholesky)
       {
         // vec newGramCol = vec(activeSet.size());
         // for (size_t i = 0; i < activeSet.size(); ++i)
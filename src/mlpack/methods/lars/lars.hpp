@@ -93,7 +93,9 @@ class LARS
    * Set the parameters to LARS.  Both lambda1 and lambda2 default to 0.
    *
    * @param useCholesky Whether or not to use Cholesky decomposition when
-   *    solving linear system (as opposed to using the full Gram matrix).
+   *    solving linear system (as opposed to using the full Gram matrix).  With
+   *    the Cholesky decomposition, the full Gram matrix is never computed;
+   *    only its entries between the active dimensions are.
    * @param lambda1 Regularization parameter for l1-norm penalty.
    * @param lambda2 Regularization parameter for l2-norm penalty.
    * @param tolerance Run until the maximum correlation of elements in (X^T y)
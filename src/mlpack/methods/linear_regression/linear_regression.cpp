@@ -13,9 +13,147 @@
 #include "linear_regression.hpp"
 #include <mlpack/core/util/log.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::regression;
 
+namespace {
+
+//! The number of points of the blocks used to accumulate the normal equations.
+const size_t NormalEquationsBlockSize = 2048;
+
+/**
+ * Accumulate the normal equations P P^T a = P r^T, where P holds the
+ * predictors (with a row of ones on top if there is an intercept) and r the
+ * responses, both scaled by the square roots of the weights (if any).  The
+ * points are split into one contiguous chunk per thread, each chunk is
+ * accumulated one block of points at a time (so P is never copied whole), and
+ * the sums of the chunks are added up in order.
+ */
+void NormalEquations(const arma::mat& predictors,
+                     const arma::rowvec& responses,
+                     const arma::rowvec& weights,
+                     const bool intercept,
+                     arma::mat& cov,
+                     arma::vec& rhs)
+{
+  const size_t dims = predictors.n_rows + (intercept ? 1 : 0);
+  const size_t numBlocks = (predictors.n_cols + NormalEquationsBlockSize - 1) /
+      NormalEquationsBlockSize;
+
+  #ifdef HAS_OPENMP
+  const size_t numChunks = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), numBlocks));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  std::vector<arma::mat> chunkCov(numChunks);
+  std::vector<arma::vec> chunkRhs(numChunks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    chunkCov[c].zeros(dims, dims);
+    chunkRhs[c].zeros(dims);
+
+    const size_t chunkBegin = c * predictors.n_cols / numChunks;
+    const size_t chunkEnd = (c + 1) * predictors.n_cols / numChunks;
+    for (size_t begin = chunkBegin; begin < chunkEnd;
+         begin += NormalEquationsBlockSize)
+    {
+      const size_t end = std::min(begin + NormalEquationsBlockSize, chunkEnd);
+
+      arma::mat p(dims, end - begin);
+      if (intercept)
+      {
+        p.row(0).ones();
+        p.rows(1, dims - 1) = predictors.cols(begin, end - 1);
+      }
+      else
+      {
+        p = predictors.cols(begin, end - 1);
+      }
+
+      arma::rowvec r = responses.subvec(begin, end - 1);
+      if (weights.n_elem > 0)
+      {
+        const arma::rowvec sqrtWeights = arma::sqrt(weights.subvec(begin,
+            end - 1));
+        p.each_row() %= sqrtWeights;
+        r %= sqrtWeights;
+      }
+
+      chunkCov[c] += p * p.t();
+      chunkRhs[c] += p * r.t();
+    }
+  }
+
+  cov = std::move(chunkCov[0]);
+  rhs = std::move(chunkRhs[0]);
+  for (size_t c = 1; c < numChunks; ++c)
+  {
+    cov += chunkCov[c];
+    rhs += chunkRhs[c];
+  }
+}
+
+/**
+ * Compute out = (P W P^T + lambda I) v, where P holds the sparse predictors
+ * (with a row of ones on top if there is an intercept) and W the weights (the
+ * identity if there are none), without forming P W P^T.  The transpose of the
+ * predictors is given too, so that both products with the data are computed
+ * in parallel without write conflicts.
+ */
+void ApplyNormalEquations(const arma::sp_mat& predictors,
+                          const arma::sp_mat& predictorsT,
+                          const arma::rowvec& weights,
+                          const bool intercept,
+                          const double lambda,
+                          const arma::vec& v,
+                          arma::vec& out)
+{
+  const size_t offset = intercept ? 1 : 0;
+
+  // First, t = W P^T v, one point at a time.
+  arma::vec t(predictors.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) predictors.n_cols; ++i)
+  {
+    double value = intercept ? v[0] : 0.0;
+    for (arma::sp_mat::const_col_iterator it = predictors.begin_col(i);
+         it != predictors.end_col(i); ++it)
+    {
+      value += (*it) * v[it.row() + offset];
+    }
+
+    t[i] = (weights.n_elem > 0) ? weights[i] * value : value;
+  }
+
+  // Then, out = P t + lambda v, one dimension at a time.
+  out.set_size(v.n_elem);
+  if (intercept)
+    out[0] = arma::accu(t) + lambda * v[0];
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) predictorsT.n_cols; ++j)
+  {
+    double value = 0.0;
+    for (arma::sp_mat::const_col_iterator it = predictorsT.begin_col(j);
+         it != predictorsT.end_col(j); ++it)
+    {
+      value += (*it) * t[it.row()];
+    }
+
+    out[j + offset] = value + lambda * v[j + offset];
+  }
+}
+
+} // namespace
+
 LinearRegression::LinearRegression(const arma::mat& predictors,
                                    const arma::rowvec& responses,
                                    const double lambda,
@@ -54,41 +192,110 @@ double LinearRegression::Train(const arma::mat& predictors,
    * In order to get the intercept value, we will add a row of ones.
    */
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
+  // Convert to this form:
+  // a * (X X^T) = y X^T,
+  // where X has a row of ones on top if there is an intercept, and X and y are
+  // scaled by the square roots of the weights.  X X^T and y X^T are
+  // accumulated over blocks of points, in parallel.  Then we'll use Armadillo
+  // to solve it.
+  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
+  // (assuming the SVD is used to solve it)
+  arma::mat cov;
+  arma::vec rhs;
+  NormalEquations(predictors, responses, weights, intercept, cov, rhs);
+  cov.diag() += lambda;
+
+  parameters = arma::solve(cov, rhs);
+  return ComputeError(predictors, responses);
+}
+
+double LinearRegression::Train(const arma::sp_mat& predictors,
+                               const arma::rowvec& responses,
+                               const bool intercept,
+                               const size_t maxIterations,
+                               const double tolerance)
+{
+  return Train(predictors, responses, arma::rowvec(), intercept, maxIterations,
+      tolerance);
+}
+
+double LinearRegression::Train(const arma::sp_mat& predictors,
+                               const arma::rowvec& responses,
+                               const arma::rowvec& weights,
+                               const bool intercept,
+                               const size_t maxIterations,
+                               const double tolerance)
+{
+  this->intercept = intercept;
 
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
+  const size_t offset = intercept ? 1 : 0;
+  const size_t dims = predictors.n_rows + offset;
+  const arma::sp_mat predictorsT = predictors.t();
 
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
+  // The right hand side of the normal equations is P W r^T.
+  const arma::rowvec r = (weights.n_elem > 0) ? arma::rowvec(weights %
+      responses) : responses;
+  arma::vec rhs(dims);
+  if (intercept)
+    rhs[0] = arma::accu(r);
+  rhs.subvec(offset, dims - 1) = predictors * r.t();
+
+  // The Jacobi preconditioner is the inverse of the diagonal of the normal
+  // equations.  The diagonal is zero only for dimensions without any nonzero
+  // value (and no regularization); their parameters stay zero anyway.
+  arma::vec diagonal(dims);
   if (intercept)
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    diagonal[0] = ((weights.n_elem > 0) ? arma::accu(weights) :
+        (double) predictors.n_cols) + lambda;
   }
-
+  const arma::sp_mat squares = arma::square(predictors);
   if (weights.n_elem > 0)
+    diagonal.subvec(offset, dims - 1) = squares * weights.t() + lambda;
+  else
+    diagonal.subvec(offset, dims - 1) = arma::vec(arma::sum(squares, 1)) +
+        lambda;
+  diagonal.transform([](const double d) { return (d > 0.0) ? 1.0 / d : 1.0; });
+
+  // Now run the preconditioned conjugate gradient method, starting from zero.
+  parameters.zeros(dims);
+  arma::vec residual = rhs;
+  arma::vec z = diagonal % residual;
+  arma::vec direction = z;
+  arma::vec product;
+  double rz = arma::dot(residual, z);
+
+  const double rhsNorm = arma::norm(rhs);
+  const size_t iterations = (maxIterations == 0) ? 2 * dims : maxIterations;
+  size_t i = 0;
+  for (; i < iterations && arma::norm(residual) > tolerance * rhsNorm; ++i)
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    ApplyNormalEquations(predictors, predictorsT, weights, intercept, lambda,
+        direction, product);
+
+    const double curvature = arma::dot(direction, product);
+    if (curvature <= 0.0)
+      break;
+
+    const double alpha = rz / curvature;
+    parameters += alpha * direction;
+    residual -= alpha * product;
+
+    z = diagonal % residual;
+    const double newRz = arma::dot(residual, z);
+    direction = z + (newRz / rz) * direction;
+    rz = newRz;
   }
 
-  // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
-  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
+  Log::Info << "LinearRegression::Train(): conjugate gradient ran for " << i
+      << " iterations; relative residual norm " << (rhsNorm > 0.0 ?
+      arma::norm(residual) / rhsNorm : 0.0) << "." << std::endl;
 
-  parameters = arma::solve(cov, p * r.t());
   return ComputeError(predictors, responses);
 }
 
-void LinearRegression::Predict(const arma::mat& points,
+template<typename MatType>
+void LinearRegression::PredictImpl(const MatType& points,
     arma::rowvec& predictions) const
 {
   if (intercept)
@@ -112,38 +319,50 @@ void LinearRegression::Predict(const arma::mat& points,
   }
 }
 
-double LinearRegression::ComputeError(const arma::mat& predictors,
-                                      const arma::rowvec& responses) const
+template<typename MatType>
+double LinearRegression::ComputeErrorImpl(const MatType& predictors,
+                                          const arma::rowvec& responses) const
 {
   // Get the number of columns and rows of the dataset.
   const size_t nCols = predictors.n_cols;
   const size_t nRows = predictors.n_rows;
 
   // Calculate the differences between actual responses and predicted responses.
-  // We must also add the intercept (parameters(0)) to the predictions.
-  arma::rowvec temp;
-  if (intercept)
+  // Ensure that we have the correct number of dimensions in the dataset.
+  if (nRows != parameters.n_rows - (intercept ? 1 : 0))
   {
-    // Ensure that we have the correct number of dimensions in the dataset.
-    if (nRows != parameters.n_rows - 1)
-    {
-      Log::Fatal << "The test data must have the same number of columns as the "
-          "training file." << std::endl;
-    }
-    temp = responses - (parameters(0) +
-        arma::trans(parameters.subvec(1, parameters.n_elem - 1)) * predictors);
-  }
-  else
-  {
-    // Ensure that we have the correct number of dimensions in the dataset.
-    if (nRows != parameters.n_rows)
-    {
-      Log::Fatal << "The test data must have the same number of columns as the "
-          "training file." << std::endl;
-    }
-    temp = responses - arma::trans(parameters) * predictors;
+    Log::Fatal << "The test data must have the same number of columns as the "
+        "training file." << std::endl;
   }
+
+  arma::rowvec temp;
+  PredictImpl(predictors, temp);
+  temp = responses - temp;
   const double cost = arma::dot(temp, temp) / nCols;
 
   return cost;
 }
+
+void LinearRegression::Predict(const arma::mat& points,
+    arma::rowvec& predictions) const
+{
+  PredictImpl(points, predictions);
+}
+
+void LinearRegression::Predict(const arma::sp_mat& points,
+    arma::rowvec& predictions) const
+{
+  PredictImpl(points, predictions);
+}
+
+double LinearRegression::ComputeError(const arma::mat& predictors,
+                                      const arma::rowvec& responses) const
+{
+  return ComputeErrorImpl(predictors, responses);
+}
+
+double LinearRegression::ComputeError(const arma::sp_mat& predictors,
+                                      const arma::rowvec& responses) const
+{
+  return ComputeErrorImpl(predictors, responses);
+}
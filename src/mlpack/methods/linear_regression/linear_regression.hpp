@@ -95,6 +95,58 @@ class LinearRegression
                const arma::rowvec& weights,
                const bool intercept = true);
 
+  /**
+   * Train the LinearRegression model on the given sparse data. Careful! This
+   * will completely ignore and overwrite the existing model.  The same
+   * (ridge) least squares problem as for dense data is solved, but with the
+   * preconditioned conjugate gradient method on the normal equations: the
+   * matrix X X^T is never formed, and each iteration only takes two passes
+   * over the nonzero elements of the data, in parallel when OpenMP is
+   * available.  So this is suited to data with many points and dimensions.
+   * To set the regularization parameter lambda, call Lambda() or set a
+   * different value in the constructor.
+   *
+   * @param predictors X, the sparse matrix of data points to train the model
+   *     on.
+   * @param responses y, the responses to the data points.
+   * @param intercept Whether or not to fit an intercept term.
+   * @param maxIterations Maximum number of iterations of the conjugate
+   *     gradient method; if 0, twice the number of parameters is used.
+   * @param tolerance The conjugate gradient method stops when the norm of the
+   *     residual of the normal equations falls below this fraction of its
+   *     initial value.
+   * @return The least squares error after training.
+   */
+  double Train(const arma::sp_mat& predictors,
+               const arma::rowvec& responses,
+               const bool intercept = true,
+               const size_t maxIterations = 0,
+               const double tolerance = 1e-10);
+
+  /**
+   * Train the LinearRegression model on the given sparse data and weights.
+   * Careful! This will completely ignore and overwrite the existing model.  See
+   * the overload without weights for details.
+   *
+   * @param predictors X, the sparse matrix of data points to train the model
+   *     on.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights (for boosting).
+   * @param intercept Whether or not to fit an intercept term.
+   * @param maxIterations Maximum number of iterations of the conjugate
+   *     gradient method; if 0, twice the number of parameters is used.
+   * @param tolerance The conjugate gradient method stops when the norm of the
+   *     residual of the normal equations falls below this fraction of its
+   *     initial value.
+   * @return The least squares error after training.
+   */
+  double Train(const arma::sp_mat& predictors,
+               const arma::rowvec& responses,
+               const arma::rowvec& weights,
+               const bool intercept = true,
+               const size_t maxIterations = 0,
+               const double tolerance = 1e-10);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -103,6 +155,14 @@ class LinearRegression
    */
   void Predict(const arma::mat& points, arma::rowvec& predictions) const;
 
+  /**
+   * Calculate y_i for each data point in the given sparse matrix.
+   *
+   * @param points the data points to calculate with.
+   * @param predictions y, will contain calculated values on completion.
+   */
+  void Predict(const arma::sp_mat& points, arma::rowvec& predictions) const;
+
   /**
    * Calculate the L2 squared error on the given predictors and responses using
    * this linear regression model. This calculation returns
@@ -123,6 +183,16 @@ class LinearRegression
   double ComputeError(const arma::mat& points,
                       const arma::rowvec& responses) const;
 
+  /**
+   * Calculate the L2 squared error on the given sparse predictors and
+   * responses using this linear regression model.
+   *
+   * @param points Sparse matrix of predictors (X).
+   * @param responses Transposed vector of responses (y^T).
+   */
+  double ComputeError(const arma::sp_mat& points,
+                      const arma::rowvec& responses) const;
+
   //! Return the parameters (the b vector).
   const arma::vec& Parameters() const { return parameters; }
   //! Modify the parameters (the b vector).
@@ -148,6 +218,15 @@ class LinearRegression
   }
 
  private:
+  //! Calculate y_i for each data point in points (dense or sparse).
+  template<typename MatType>
+  void PredictImpl(const MatType& points, arma::rowvec& predictions) const;
+
+  //! Calculate the L2 squared error on the given (dense or sparse) data.
+  template<typename MatType>
+  double ComputeErrorImpl(const MatType& points,
+                          const arma::rowvec& responses) const;
+
   /**
    * The calculated B.
    * Initialized and filled by constructor to hold the least squares solution.
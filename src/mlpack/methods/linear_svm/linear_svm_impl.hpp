@@ -14,6 +14,7 @@
 
 // In case it hasn't been included yet.
 #include "linear_svm.hpp"
+#include <mlpack/methods/ann/data_loader/optimizer_options.hpp>
 
 namespace mlpack {
 namespace svm {
@@ -144,6 +145,77 @@ double LinearSVM<MatType>::Train(
   return out;
 }
 
+template <typename MatType>
+template <typename SourceType, typename OptimizerType,
+          typename... CallbackTypes>
+double LinearSVM<MatType>::Train(
+    ann::PrefetchLoader<SourceType>& loader,
+    const size_t numClasses,
+    OptimizerType& optimizer,
+    const size_t epochs,
+    CallbackTypes&&... callbacks)
+{
+  static_assert(std::is_same<typename SourceType::InputType, MatType>::value,
+      "LinearSVM::Train(): the predictors of the loader must have the type of "
+      "the data of the model!");
+
+  if (numClasses <= 1)
+  {
+    throw std::invalid_argument("LinearSVM dataset has 0 number of classes!");
+  }
+
+  this->numClasses = numClasses;
+
+  // Start at the beginning of an epoch.
+  loader.Reset();
+
+  // Save the options of the optimizer that are changed for each chunk.
+  const size_t maxIterations = ann::SwapMaxIterations(optimizer, 0);
+  const bool resetPolicy = ann::SwapResetPolicy(optimizer, true);
+
+  MatType data;
+  typename SourceType::OutputType responses;
+
+  Timer::Start("linear_svm_optimization");
+  double out = 0.0;
+  size_t chunks = 0;
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    out = 0.0;
+    while (loader.Next(data, responses))
+    {
+      if (data.n_cols == 0)
+        continue;
+
+      const arma::Row<size_t> labels =
+          arma::conv_to<arma::Row<size_t>>::from(responses);
+      LinearSVMFunction<MatType> svm(data, labels, numClasses, lambda, delta,
+          fitIntercept);
+      if (parameters.is_empty())
+        parameters = svm.InitialPoint();
+
+      // Make one pass over the chunk, and keep the state of the optimizer for
+      // the next one.
+      ann::SwapMaxIterations(optimizer, data.n_cols);
+      out += optimizer.Optimize(svm, parameters, callbacks...);
+      if (++chunks == 1)
+        ann::SwapResetPolicy(optimizer, false);
+    }
+  }
+  Timer::Stop("linear_svm_optimization");
+
+  ann::SwapMaxIterations(optimizer, maxIterations);
+  ann::SwapResetPolicy(optimizer, resetPolicy);
+
+  // Don't keep reading chunks that won't be used.
+  loader.Reset();
+
+  Log::Info << "LinearSVM::LinearSVM(): final objective of "
+            << "trained model is " << out << "." << std::endl;
+
+  return out;
+}
+
 template <typename MatType>
 void LinearSVM<MatType>::Classify(
     const MatType& data,
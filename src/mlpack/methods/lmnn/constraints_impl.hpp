@@ -266,6 +266,10 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
     // Calculate impostors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
+    // Don't build a tree for a class without any query point.
+    if (subIndexSame.n_elem == 0)
+      continue;
+
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
@@ -315,6 +319,10 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
     // Calculate impostors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
+    // Don't build a tree for a class without any query point.
+    if (subIndexSame.n_elem == 0)
+      continue;
+
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
@@ -348,6 +356,10 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
+  // The bounds may show that no impostor can have changed.
+  if (numPoints == 0)
+    return;
+
   // KNN instance.
   KNN knn;
 
@@ -363,6 +375,10 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
     subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
         uniqueLabels[i]);
 
+    // Don't build a tree for a class without any query point.
+    if (subIndexSame.n_elem == 0)
+      continue;
+
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
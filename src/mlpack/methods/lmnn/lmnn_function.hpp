@@ -246,6 +246,16 @@ class LMNNFunction
   inline void UpdateCache(const arma::mat& transformation,
                           const size_t begin,
                           const size_t batchSize);
+  /**
+   * Add the weighted outer products of the differences between the points
+   * begin, ..., begin + weights.n_cols - 1 and their neighbors to the given
+   * matrix: weights(j, i) (x_{begin + i} - x_n) (x_{begin + i} - x_n)^T for
+   * each neighbor x_n = neighbors(j, begin + i).
+   */
+  inline void AddOuterProducts(arma::mat& output,
+                               const arma::Mat<size_t>& neighbors,
+                               const arma::mat& weights,
+                               const size_t begin) const;
   //! Calculate norm of change in transformation.
   inline void TransDiff(std::map<size_t, double>& transformationDiffs,
                         const arma::mat& transformation,
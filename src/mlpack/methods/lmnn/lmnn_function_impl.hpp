@@ -257,7 +257,10 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation)
     constraint.Impostors(impostors, distance, transformedDataset, labels, norm);
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // The points are independent, so they are processed in parallel; each one
+  // only updates its own cached bounds.
+  #pragma omp parallel for reduction(+:cost) schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     for (size_t j = 0; j < k ; ++j)
     {
@@ -384,7 +387,10 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
         norm, begin, batchSize);
   }
 
-  for (size_t i = begin; i < begin + batchSize; ++i)
+  // The points are independent, so they are processed in parallel; each one
+  // only updates its own cached bounds.
+  #pragma omp parallel for reduction(+:cost) schedule(dynamic, 64)
+  for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
   {
     for (size_t j = 0; j < k ; ++j)
     {
@@ -411,7 +417,7 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
           eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+              transformationDiffs.at(lastTransformationIndices[i]) *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -452,7 +458,8 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
           // update bound.
           evalOld(l, j, i) = 0;
           maxImpNorm(l, i) = 0;
-          --oldTransformationCounts[lastTransformationIndices(i)];
+          #pragma omp atomic
+          --oldTransformationCounts[(size_t) lastTransformationIndices(i)];
           lastTransformationIndices(i) = 0;
         }
       }
@@ -517,10 +524,15 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
   // Calculate gradient due to target neighbors.
   arma::mat cij = pCij;
 
-  // Calculate gradient due to impostors.
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // Count the active triplets of each point, for the gradient due to
+  // impostors.
+  arma::mat targetWeights(k, dataset.n_cols, arma::fill::zeros);
+  arma::mat impostorWeights(k, dataset.n_cols, arma::fill::zeros);
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // The points are independent, so they are processed in parallel; each one
+  // only updates its own cached bounds and triplet counts.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     for (int j = k - 1; j >= 0; j--)
     {
@@ -579,16 +591,18 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
           maxImpNorm(l, i) = 0;
         }
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
-
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+        // Count the triplet for the gradient due to impostors.
+        targetWeights(j, i) += 1.0;
+        impostorWeights(l, i) -= 1.0;
       }
     }
   }
 
+  // Calculate gradient due to impostors.
+  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  AddOuterProducts(cil, targetNeighbors, targetWeights, 0);
+  AddOuterProducts(cil, impostors, impostorWeights, 0);
+
   gradient = 2 * transformation * ((1 - regularization) * cij +
       regularization * cil);
 
@@ -646,18 +660,16 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
 
   gradient.zeros(transformation.n_rows, transformation.n_cols);
 
-  arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // Count the active triplets of each point, for the gradient due to
+  // impostors.
+  arma::mat targetWeights(k, batchSize, arma::fill::zeros);
+  arma::mat impostorWeights(k, batchSize, arma::fill::zeros);
 
-  for (size_t i = begin; i < begin + batchSize; ++i)
+  // The points are independent, so they are processed in parallel; each one
+  // only updates its own cached bounds and triplet counts.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
   {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * arma::trans(diff);
-    }
-
     for (int j = k - 1; j >= 0; j--)
     {
       // Bound constraints to avoid uneccesary computation.
@@ -674,7 +686,7 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
           eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+              transformationDiffs.at(lastTransformationIndices[i]) *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -713,20 +725,27 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
           // update bound.
           evalOld(l, j, i) = 0;
           maxImpNorm(l, i) = 0;
-          --oldTransformationCounts[lastTransformationIndices(i)];
+          #pragma omp atomic
+          --oldTransformationCounts[(size_t) lastTransformationIndices(i)];
           lastTransformationIndices(i) = 0;
         }
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
-
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+        // Count the triplet for the gradient due to impostors.
+        targetWeights(j, i - begin) += 1.0;
+        impostorWeights(l, i - begin) -= 1.0;
       }
     }
   }
 
+  // Calculate gradient due to target neighbors.
+  arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
+  AddOuterProducts(cij, targetNeighbors, arma::ones(k, batchSize), begin);
+
+  // Calculate gradient due to impostors.
+  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  AddOuterProducts(cil, targetNeighbors, targetWeights, begin);
+  AddOuterProducts(cil, impostors, impostorWeights, begin);
+
   gradient = 2 * transformation * ((1 - regularization) * cij +
       regularization * cil);
 
@@ -792,10 +811,15 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
   // Calculate gradient due to target neighbors.
   arma::mat cij = pCij;
 
-  // Calculate gradient due to impostors.
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // Count the active triplets of each point, for the gradient due to
+  // impostors.
+  arma::mat targetWeights(k, dataset.n_cols, arma::fill::zeros);
+  arma::mat impostorWeights(k, dataset.n_cols, arma::fill::zeros);
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // The points are independent, so they are processed in parallel; each one
+  // only updates its own cached bounds and triplet counts.
+  #pragma omp parallel for reduction(+:cost) schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     for (size_t j = 0; j < k ; ++j)
     {
@@ -856,16 +880,18 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
 
         cost += regularization * (1 + eval);
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
-
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+        // Count the triplet for the gradient due to impostors.
+        targetWeights(j, i) += 1.0;
+        impostorWeights(l, i) -= 1.0;
       }
     }
   }
 
+  // Calculate gradient due to impostors.
+  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  AddOuterProducts(cil, targetNeighbors, targetWeights, 0);
+  AddOuterProducts(cil, impostors, impostorWeights, 0);
+
   gradient = 2 * transformation * ((1 - regularization) * cij +
       regularization * cil);
 
@@ -928,10 +954,15 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
 
   gradient.zeros(transformation.n_rows, transformation.n_cols);
 
-  arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // Count the active triplets of each point, for the gradient due to
+  // impostors.
+  arma::mat targetWeights(k, batchSize, arma::fill::zeros);
+  arma::mat impostorWeights(k, batchSize, arma::fill::zeros);
 
-  for (size_t i = begin; i < begin + batchSize; ++i)
+  // The points are independent, so they are processed in parallel; each one
+  // only updates its own cached bounds and triplet counts.
+  #pragma omp parallel for reduction(+:cost) schedule(dynamic, 64)
+  for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
   {
     for (size_t j = 0; j < k ; ++j)
     {
@@ -939,10 +970,6 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
       double eval = metric.Evaluate(transformedDataset.col(i),
                         transformedDataset.col(targetNeighbors(j, i)));
       cost += (1 - regularization) * eval;
-
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * arma::trans(diff);
     }
 
     for (int j = k - 1; j >= 0; j--)
@@ -961,7 +988,7 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
           eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+              transformationDiffs.at(lastTransformationIndices[i]) *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -996,16 +1023,22 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
 
         cost += regularization * (1 + eval);
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
-
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+        // Count the triplet for the gradient due to impostors.
+        targetWeights(j, i - begin) += 1.0;
+        impostorWeights(l, i - begin) -= 1.0;
       }
     }
   }
 
+  // Calculate gradient due to target neighbors.
+  arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
+  AddOuterProducts(cij, targetNeighbors, arma::ones(k, batchSize), begin);
+
+  // Calculate gradient due to impostors.
+  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  AddOuterProducts(cil, targetNeighbors, targetWeights, begin);
+  AddOuterProducts(cil, impostors, impostorWeights, begin);
+
   gradient = 2 * transformation * ((1 - regularization) * cij +
       regularization * cil);
 
@@ -1018,16 +1051,33 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
 template<typename MetricType>
 inline void LMNNFunction<MetricType>::Precalculate()
 {
+  // Calculate gradient due to target neighbors.
   pCij.zeros(dataset.n_rows, dataset.n_rows);
+  AddOuterProducts(pCij, targetNeighbors, arma::ones(k, dataset.n_cols), 0);
+}
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+template<typename MetricType>
+inline void LMNNFunction<MetricType>::AddOuterProducts(
+    arma::mat& output,
+    const arma::Mat<size_t>& neighbors,
+    const arma::mat& weights,
+    const size_t begin) const
+{
+  const size_t end = begin + weights.n_cols - 1;
+  arma::mat diffs;
+  for (size_t j = 0; j < weights.n_rows; ++j)
   {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      pCij += diff * arma::trans(diff);
-    }
+    // Skip the neighbors that are not part of any active triplet.
+    if (!arma::any(weights.row(j)))
+      continue;
+
+    // Column i of 'diffs' is the difference between point (begin + i) and its
+    // j'th neighbor.  All the weighted outer products are then summed with a
+    // single matrix product.
+    const arma::uvec indices = arma::conv_to<arma::uvec>::from(
+        neighbors.submat(j, begin, j, end));
+    diffs = dataset.cols(begin, end) - dataset.cols(indices);
+    output += (diffs.each_row() % weights.row(j)) * diffs.t();
   }
 }
 
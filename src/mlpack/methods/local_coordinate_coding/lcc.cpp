@@ -35,21 +35,19 @@ void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
       * data);
 
   arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
 
+  Log::Debug << "Encoding " << data.n_cols << " points." << std::endl;
+
+  // The points are independent, so they are encoded in parallel.  The Gram
+  // matrix of the dictionary is shared, and only reweighted for each point.
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
-
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
+    const arma::vec invW = invSqDists.unsafe_col(i);
+    arma::mat dictPrime = dictionary.each_row() % invW.t();
 
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
+    arma::mat dictGramTD = dictGram % (invW * invW.t());
 
     bool useCholesky = false;
     regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
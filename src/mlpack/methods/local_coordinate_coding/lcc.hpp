@@ -145,7 +145,8 @@ class LocalCoordinateCoding
                    DictionaryInitializer());
 
   /**
-   * Code each point via distance-weighted LARS.
+   * Code each point via distance-weighted LARS.  The points are encoded in
+   * parallel when OpenMP is available.
    *
    * @param data Matrix containing points to encode.
    * @param codes Output matrix to store codes in.
@@ -25,6 +25,11 @@ namespace regression {
  * The log-likelihood function for the logistic regression objective function.
  * This is used by various mlpack optimizers to train a logistic regression
  * model.
+ *
+ * The predictors may be dense (arma::mat) or sparse (arma::sp_mat); the
+ * gradient is computed as a product of the predictors and a vector, which only
+ * visits the nonzero elements of sparse predictors.  When OpenMP is available,
+ * the objective and gradient of large batches are computed in parallel.
  */
 template<typename MatType = arma::mat>
 class LogisticRegressionFunction
@@ -158,7 +163,31 @@ class LogisticRegressionFunction
   //! Return the number of features(add 1 for the intercept term).
   size_t NumFeatures() const { return predictors.n_rows + 1; }
 
+  //! The smallest number of points that is worth giving to its own thread when
+  //! the objective or gradient of a batch is computed.
+  static const size_t MinChunkSize = 4096;
+
  private:
+  /**
+   * Compute the negative log-likelihood of the given batch of points, and/or
+   * its gradient (without the regularization term).  The sigmoids are computed
+   * only once for both.  When OpenMP is available, large batches are split into
+   * one chunk per thread, and the results of the chunks are added up in order.
+   *
+   * @tparam ComputeObjective Whether to compute the negative log-likelihood.
+   * @tparam ComputeGradient Whether to compute the gradient.
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param gradient Matrix to output the gradient into, if it is computed.
+   * @return The negative log-likelihood, or 0 if it is not computed.
+   */
+  template<bool ComputeObjective, bool ComputeGradient>
+  double Accumulate(const arma::mat& parameters,
+                    const size_t begin,
+                    const size_t batchSize,
+                    arma::mat& gradient) const;
+
   //! The matrix of data points (predictors).  This is an alias until shuffling
   //! is done.
   MatType predictors;
@@ -17,6 +17,10 @@
 
 #include <mlpack/core.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace regression {
 
@@ -82,23 +86,13 @@ double LogisticRegressionFunction<MatType>::Evaluate(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
       parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
-  // does not need to be multiplied by any of the predictors.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
   // Assemble full objective function.  Often the objective function and the
   // regularization as given are divided by the number of features, but this
   // doesn't actually affect the optimization result, so we'll just ignore those
-  // terms for computational efficiency.  Note that the conversion causes some
-  // copy and slowdown, but this is so negligible compared to the rest of the
-  // calculation it is not worth optimizing for.
-  const double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoid %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
-
-  // Invert the result, because it's a minimization.
-  return regularization - result;
+  // terms for computational efficiency.
+  arma::mat gradient; // Unused.
+  return regularization + Accumulate<true, false>(parameters, 0,
+      predictors.n_cols, gradient);
 }
 
 /**
@@ -117,19 +111,10 @@ double LogisticRegressionFunction<MatType>::Evaluate(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
-
   // Compute the objective for the given batch size from a given point.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoid %
-      (2 * respD - 1.0)));
-
-  // Invert the result, because it's a minimization.
-  return regularization - result;
+  arma::mat gradient; // Unused.
+  return regularization + Accumulate<true, false>(parameters, begin,
+      batchSize, gradient);
 }
 
 //! Evaluate the gradient of the logistic regression objective function.
@@ -138,17 +123,11 @@ void LogisticRegressionFunction<MatType>::Gradient(
     const arma::mat& parameters,
     arma::mat& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1);
+  Accumulate<false, true>(parameters, 0, predictors.n_cols, gradient);
 
-  const arma::rowvec sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
-      - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  // Regularization term.
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
 }
 
 //! Evaluate the gradient of the logistic regression objective function for a
@@ -161,23 +140,15 @@ void LogisticRegressionFunction<MatType>::Gradient(
                 GradType& gradient,
                 const size_t batchSize) const
 {
+  arma::mat batchGradient;
+  Accumulate<false, true>(parameters, begin, batchSize, batchGradient);
+
   // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1)
-      / predictors.n_cols * batchSize;
-
-  const arma::rowvec exponents = parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1);
-  // Calculating the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
-
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  batchGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+      batchSize;
+
+  gradient = std::move(batchGradient);
 }
 
 /**
@@ -212,30 +183,21 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     const arma::mat& parameters,
     GradType& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization = lambda *
-      parameters.tail_cols(parameters.n_elem - 1);
-
   const double objectiveRegularization = lambda / 2.0 *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  // The sigmoids are computed only once for both the objective and gradient.
+  arma::mat fullGradient;
+  const double result = Accumulate<true, true>(parameters, 0,
+      predictors.n_cols, fullGradient);
 
-  // Now compute the objective function using the sigmoids.
-  double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoids %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
+  // Regularization term.
+  fullGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
 
-  // Invert the result, because it's a minimization.
-  return objectiveRegularization - result;
+  gradient = std::move(fullGradient);
+  return objectiveRegularization + result;
 }
 
 template<typename MatType>
@@ -246,36 +208,93 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  // Regularization term.
-  arma::mat regularization =
-      lambda * parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
-      batchSize;
-
   const double objectiveRegularization = lambda *
       (batchSize / (2.0 * predictors.n_cols)) *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
-
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoids %
-      (2 * respD - 1.0)));
-
-  // Invert the result, because it's a minimization.
-  return objectiveRegularization - result;
+  arma::mat batchGradient;
+  const double result = Accumulate<true, true>(parameters, begin, batchSize,
+      batchGradient);
+
+  // Regularization term.
+  batchGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+      batchSize;
+
+  gradient = std::move(batchGradient);
+  return objectiveRegularization + result;
+}
+
+template<typename MatType>
+template<bool ComputeObjective, bool ComputeGradient>
+double LogisticRegressionFunction<MatType>::Accumulate(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& gradient) const
+{
+  // Large batches are split into one chunk per thread; for small batches, the
+  // overhead of the threads would outweigh the work.
+  #ifdef HAS_OPENMP
+  const size_t numChunks = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), batchSize / MinChunkSize));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  std::vector<double> objectives(numChunks, 0.0);
+  std::vector<arma::mat> gradients(numChunks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t chunkBegin = begin + c * batchSize / numChunks;
+    const size_t chunkEnd = begin + (c + 1) * batchSize / numChunks;
+    if (chunkEnd == chunkBegin)
+      continue;
+
+    // Calculate the sigmoid function values.  The intercept term is
+    // parameters(0, 0) and does not need to be multiplied by any of the
+    // predictors.
+    const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+        parameters.tail_cols(parameters.n_elem - 1) *
+        predictors.cols(chunkBegin, chunkEnd - 1))));
+    const arma::rowvec respD = arma::conv_to<arma::rowvec>::from(
+        responses.subvec(chunkBegin, chunkEnd - 1));
+
+    // Invert the log-likelihood, because it's a minimization.
+    if (ComputeObjective)
+    {
+      objectives[c] = -arma::accu(arma::log(1.0 - respD + sigmoids %
+          (2 * respD - 1.0)));
+    }
+
+    // Multiplying the predictors by a column vector, rather than a row vector
+    // by the transposed predictors, avoids a transposed copy of sparse
+    // predictors.
+    if (ComputeGradient)
+    {
+      const arma::rowvec diffs = sigmoids - respD;
+      gradients[c].set_size(arma::size(parameters));
+      gradients[c][0] = arma::accu(diffs);
+      gradients[c].tail_cols(parameters.n_elem - 1) =
+          (predictors.cols(chunkBegin, chunkEnd - 1) * diffs.t()).t();
+    }
+  }
+
+  // Reduce the results of the chunks, in order.
+  double objective = 0.0;
+  if (ComputeGradient)
+    gradient.zeros(arma::size(parameters));
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    objective += objectives[c];
+    if (ComputeGradient && !gradients[c].is_empty())
+      gradient += gradients[c];
+  }
+
+  return objective;
 }
 
 } // namespace regression
@@ -104,6 +104,10 @@ PARAM_INT_IN("second_hash_size", "The size of the second level hash table.",
 PARAM_INT_IN("bucket_size", "The size of a bucket in the second level hash.",
     "B", 500);
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+PARAM_STRING_IN("hash_table_map_file", "If specified, the buckets of the "
+    "second level hash table of the output model are written to this file and "
+    "the output model is saved without them; loading that model later "
+    "memory-maps the buckets from this file.", "f", "");
 
 static void mlpackMain()
 {
@@ -150,6 +154,7 @@ static void mlpackMain()
   ReportIgnoredParam({{ "reference", false }}, "bucket_size");
   ReportIgnoredParam({{ "reference", false }}, "second_hash_size");
   ReportIgnoredParam({{ "reference", false }}, "hash_width");
+  ReportIgnoredParam({{ "output_model", false }}, "hash_table_map_file");
 
   if (IO::HasParam("input_model") && !IO::HasParam("k"))
   {
@@ -249,5 +254,9 @@ static void mlpackMain()
     IO::GetParam<arma::mat>("distances") = std::move(distances);
     IO::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
   }
+  // Write the buckets to a file that can be memory-mapped, if desired.
+  if (IO::HasParam("hash_table_map_file"))
+    allkann->MapHashTable(IO::GetParam<std::string>("hash_table_map_file"));
+
   IO::GetParam<LSHSearch<>*>("output_model") = allkann;
 }
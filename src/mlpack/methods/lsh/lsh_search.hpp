@@ -49,6 +49,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/data/mapped_matrix.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
 
@@ -290,9 +291,28 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  /**
+   * Get the second hash table, as one vector of point indices per non-empty
+   * bucket.  The table is stored in a compressed form, so this decodes (and
+   * copies) all of it; the indices of each bucket are in increasing order.
+   */
+  std::vector<arma::Col<size_t>> SecondHashTable() const;
+
+  /**
+   * Write the compressed buckets of the second hash table to the given file
+   * and memory-map them from there.  From then on the model is serialized
+   * without the buckets: only the name of the file is stored, and loading the
+   * model memory-maps the file again, so that large models load quickly and
+   * any number of processes can share one copy of the buckets in the page
+   * cache.  The file must not be modified or removed while a model uses it.
+   * Training the model again drops the mapping.
+   *
+   * @param filename File to write the buckets to.
+   */
+  void MapHashTable(const std::string& filename);
+
+  //! Get the file the buckets are memory-mapped from (empty if none).
+  const std::string& HashTableMapFile() const { return hashTableMapFile; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -307,25 +327,76 @@ class LSHSearch
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Search for the approximate neighbors of every point in the given query
+   * set.  The queries are processed in blocks: each block is hashed with
+   * HashQueries(), and then the candidates of each query are collected and
+   * evaluated in parallel.
    *
-   * @param queryPoint The query point currently being processed.
-   * @param referenceIndices The list of neighbor candidates obtained from
-   *    hashing the query into all the hash tables and eventually into
-   *    multiple buckets of the second hash table.
+   * @param querySet Set of query points.
+   * @param monochromatic If true, querySet is the reference set, and a point
+   *    is not returned as its own neighbor.
+   * @param k Number of neighbors to search for.
+   * @param resultingNeighbors Matrix holding output neighbors.
+   * @param distances Matrix holding output distances.
    * @param numTablesToSearch The number of tables to perform the search in. If
    *    0, all tables are searched.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
+   * @return The total number of neighbor candidates that were evaluated.
+   */
+  size_t SearchQueries(const MatType& querySet,
+                       const bool monochromatic,
+                       const size_t k,
+                       arma::Mat<size_t>& resultingNeighbors,
+                       arma::mat& distances,
+                       size_t numTablesToSearch,
+                       const size_t T) const;
+
+  /**
+   * This function takes a block of queries and hashes each of them into each
+   * of the hash tables to get keys for the queries, and then each key (and
+   * each additional probing bin of multiprobe LSH) is hashed to a bucket of
+   * the second hash table.  The projections of all the queries in all the
+   * tables are computed with a single matrix multiplication, and the
+   * (query, table) pairs are then processed in parallel.
+   *
+   * @param querySet Set of query points.
+   * @param begin Index of the first query of the block.
+   * @param count Number of queries in the block.
+   * @param numTablesToSearch The number of tables to perform the search in.
+   * @param T The number of additional probing bins for multiprobe LSH.
+   * @param hashCodes Output matrix of size (T + 1) x (count *
+   *    numTablesToSearch); column (i * numTablesToSearch + j) holds the
+   *    buckets of the second hash table to probe for query (begin + i) in
+   *    table j.
+   */
+  void HashQueries(const MatType& querySet,
+                   const size_t begin,
+                   const size_t count,
+                   const size_t numTablesToSearch,
+                   const size_t T,
+                   arma::Mat<size_t>& hashCodes) const;
+
+  /**
+   * This function collects all the points in the buckets of the second hash
+   * table that were returned by HashQueries() for one query, as the potential
+   * neighbor candidates of that query.  Duplicates are discarded with the
+   * given bitmap, which must have one (false) entry per reference point; it is
+   * reset before returning, so it can be reused for the next query.
+   *
+   * @param hashCodes Bucket codes returned by HashQueries().
+   * @param queryIndex Index of the query in the block given to HashQueries().
+   * @param numTablesToSearch The number of tables that were hashed.
+   * @param candidateMask Bitmap used to discard duplicate candidates.
+   * @param referenceIndices The list of neighbor candidates obtained from
+   *    hashing the query into all the hash tables and eventually into
+   *    multiple buckets of the second hash table, in increasing order.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
-                              arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
-                              const size_t T) const;
+  void ReturnIndicesFromTable(const arma::Mat<size_t>& hashCodes,
+                              const size_t queryIndex,
+                              const size_t numTablesToSearch,
+                              std::vector<bool>& candidateMask,
+                              arma::uvec& referenceIndices) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -369,7 +440,7 @@ class LSHSearch
 
   /**
    * This function implements the core idea behind Multiprobe LSH. It is called
-   * by ReturnIndicesFromTables when T > 0. Given a query's code and its
+   * by HashQueries() when T > 0. Given a query's code and its
    * projection location, GetAdditionalProbingBins will calculate the T most
    * likely alternative bin codes (other than queryCode) where a query's
    * neighbors might be found in.
@@ -424,6 +495,17 @@ class LSHSearch
    */
   bool PerturbationValid(const std::vector<bool>& A) const;
 
+  /**
+   * Compress the given buckets of point indices into secondHashTable and
+   * bucketOffsets.  The indices of each bucket are sorted.
+   *
+   * @param buckets Point indices of each bucket.
+   */
+  void CompressBuckets(std::vector<arma::Col<size_t>>& buckets);
+
+  //! Drop the memory mapping of the buckets, if any, leaving them empty.
+  void UnmapHashTable();
+
   //! Reference dataset.
   MatType referenceSet;
 
@@ -450,9 +532,15 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table; holds (< secondHashSize) buckets, each with
+  //! (<= bucketSize) point indices.  The indices of a bucket are sorted and
+  //! stored as varint-coded differences, and the buckets are stored one after
+  //! the other in this single column.
+  arma::Mat<unsigned char> secondHashTable;
+
+  //! The offset of each bucket in secondHashTable; the last element is the
+  //! total size of secondHashTable.
+  arma::Col<size_t> bucketOffsets;
 
   //! The number of elements present in each hash bucket; should be
   //! secondHashSize.
@@ -465,6 +553,11 @@ class LSHSearch
   //! The number of distance evaluations.
   size_t distanceEvaluations;
 
+  //! The file the buckets are memory-mapped from (empty if none).
+  std::string hashTableMapFile;
+  //! The memory-mapped buckets, if any; copies of the model share them.
+  std::shared_ptr<data::MappedMatrix<unsigned char>> mappedHashTable;
+
   //! Candidate represents a possible candidate neighbor (distance, index).
   typedef std::pair<double, size_t> Candidate;
 
@@ -486,7 +579,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 2);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
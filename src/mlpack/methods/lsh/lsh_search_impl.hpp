@@ -18,6 +18,36 @@
 namespace mlpack {
 namespace neighbor {
 
+namespace lsh_detail {
+
+//! Append the given value to the given buffer as a varint: seven bits per
+//! byte, least significant first, with the high bit set on all but the last.
+inline void EncodeVarint(size_t value, std::vector<unsigned char>& buffer)
+{
+  while (value >= 0x80)
+  {
+    buffer.push_back((unsigned char) (value | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back((unsigned char) value);
+}
+
+//! Decode the varint at the given position, and advance the position past it.
+inline size_t DecodeVarint(const unsigned char*& position)
+{
+  size_t value = 0;
+  size_t shift = 0;
+  while (*position & 0x80)
+  {
+    value |= (size_t) (*position++ & 0x7F) << shift;
+    shift += 7;
+  }
+  value |= (size_t) (*position++) << shift;
+  return value;
+}
+
+} // namespace lsh_detail
+
 // Construct the object with random tables
 template<typename SortPolicy, typename MatType>
 LSHSearch<SortPolicy, MatType>::
@@ -83,12 +113,18 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
+    secondHashTable(other.mappedHashTable ? arma::Mat<unsigned char>() :
+        other.secondHashTable),
+    bucketOffsets(other.bucketOffsets),
     bucketContentSize(other.bucketContentSize),
     bucketRowInHashTable(other.bucketRowInHashTable),
-    distanceEvaluations(other.distanceEvaluations)
+    distanceEvaluations(other.distanceEvaluations),
+    hashTableMapFile(other.hashTableMapFile),
+    mappedHashTable(other.mappedHashTable)
 {
-  // Nothing to do.
+  // Share the mapped buckets instead of keeping a copy of them.
+  if (mappedHashTable)
+    mappedHashTable->Alias(secondHashTable);
 }
 
 // Move constructor.
@@ -104,10 +140,21 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
     secondHashTable(std::move(other.secondHashTable)),
+    bucketOffsets(std::move(other.bucketOffsets)),
     bucketContentSize(std::move(other.bucketContentSize)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
-    distanceEvaluations(other.distanceEvaluations)
+    distanceEvaluations(other.distanceEvaluations),
+    hashTableMapFile(std::move(other.hashTableMapFile)),
+    mappedHashTable(std::move(other.mappedHashTable))
 {
+  // Armadillo may copy an alias instead of moving it.
+  if (mappedHashTable)
+  {
+    mappedHashTable->Alias(secondHashTable);
+    data::MappedMatrix<unsigned char>::Unalias(other.secondHashTable);
+  }
+  other.hashTableMapFile.clear();
+
   // Reset other model to defaults.
   other.numProj = 0;
   other.numTables = 0;
@@ -122,6 +169,12 @@ template<typename SortPolicy, typename MatType>
 LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
     const LSHSearch& other)
 {
+  if (this == &other)
+    return *this;
+
+  // A mapped table cannot be resized, so drop it first.
+  UnmapHashTable();
+
   referenceSet = other.referenceSet;
   numProj = other.numProj;
   numTables = other.numTables;
@@ -131,11 +184,23 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
+  bucketOffsets = other.bucketOffsets;
   bucketContentSize = other.bucketContentSize;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
+  // Share the mapped buckets instead of keeping a copy of them.
+  if (other.mappedHashTable)
+  {
+    hashTableMapFile = other.hashTableMapFile;
+    mappedHashTable = other.mappedHashTable;
+    mappedHashTable->Alias(secondHashTable);
+  }
+  else
+  {
+    secondHashTable = other.secondHashTable;
+  }
+
   return *this;
 }
 
@@ -144,6 +209,12 @@ template<typename SortPolicy, typename MatType>
 LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
     LSHSearch&& other)
 {
+  if (this == &other)
+    return *this;
+
+  // A mapped table cannot be resized, so drop it first.
+  UnmapHashTable();
+
   referenceSet = std::move(other.referenceSet);
   numProj = other.numProj;
   numTables = other.numTables;
@@ -153,11 +224,24 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
+  bucketOffsets = std::move(other.bucketOffsets);
   bucketContentSize = std::move(other.bucketContentSize);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
+  if (other.mappedHashTable)
+  {
+    hashTableMapFile = std::move(other.hashTableMapFile);
+    mappedHashTable = std::move(other.mappedHashTable);
+    mappedHashTable->Alias(secondHashTable);
+    data::MappedMatrix<unsigned char>::Unalias(other.secondHashTable);
+    other.hashTableMapFile.clear();
+  }
+  else
+  {
+    secondHashTable = std::move(other.secondHashTable);
+  }
+
   // Reset other model to defaults.
   other.numProj = 0;
   other.numTables = 0;
@@ -182,6 +266,9 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   // Set new reference set.
   this->referenceSet = std::move(referenceSet);
 
+  // The new buckets will not be mapped.
+  UnmapHashTable();
+
   // Set new parameters.
   this->numProj = numProj;
   this->numTables = numTables;
@@ -311,7 +398,7 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
 
   const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
   bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
+  std::vector<arma::Col<size_t>> buckets(numRowsInTable);
 
   // Next we must assign each point in each table to the right second hash
   // table.
@@ -332,23 +419,110 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
       if (bucketRowInHashTable[hashInd] == secondHashSize)
       {
         bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
+        buckets[currentRow].set_size(maxSize);
         currentRow++;
       }
 
       // If this vector in the hash table is not full, add the point.
       const size_t index = bucketRowInHashTable[hashInd];
       if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
+        buckets[index](bucketContentSize[index]++) = j;
     } // Loop over all points in the reference set.
   } // Loop over tables.
 
+  CompressBuckets(buckets);
+
   Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
             << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
+            << "totaling " << arma::accu(secondHashBinCounts) << " elements, "
+            << "compressed to " << secondHashTable.n_elem << " bytes."
             << std::endl;
 }
 
+// Compress the buckets into one contiguous, varint-coded block.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::CompressBuckets(
+    std::vector<arma::Col<size_t>>& buckets)
+{
+  // Sorted indices have small differences, which take only a byte or two each
+  // instead of the eight bytes of a size_t.
+  std::vector<unsigned char> buffer;
+  bucketOffsets.set_size(buckets.size() + 1);
+  for (size_t i = 0; i < buckets.size(); ++i)
+  {
+    bucketOffsets[i] = buffer.size();
+
+    arma::Col<size_t>& bucket = buckets[i];
+    std::sort(bucket.begin(), bucket.end());
+    size_t previous = 0;
+    for (size_t j = 0; j < bucket.n_elem; ++j)
+    {
+      lsh_detail::EncodeVarint(bucket[j] - previous, buffer);
+      previous = bucket[j];
+    }
+
+    // Release the memory of the uncompressed bucket right away.
+    bucket.reset();
+  }
+  bucketOffsets[buckets.size()] = buffer.size();
+
+  secondHashTable.set_size(buffer.size(), 1);
+  if (!buffer.empty())
+    std::copy(buffer.begin(), buffer.end(), secondHashTable.memptr());
+}
+
+// Decode the second hash table.
+template<typename SortPolicy, typename MatType>
+std::vector<arma::Col<size_t>>
+LSHSearch<SortPolicy, MatType>::SecondHashTable() const
+{
+  std::vector<arma::Col<size_t>> buckets(bucketContentSize.n_elem);
+  for (size_t i = 0; i < buckets.size(); ++i)
+  {
+    buckets[i].set_size(bucketContentSize[i]);
+    const unsigned char* position = secondHashTable.memptr() +
+        bucketOffsets[i];
+    size_t index = 0;
+    for (size_t j = 0; j < bucketContentSize[i]; ++j)
+    {
+      index += lsh_detail::DecodeVarint(position);
+      buckets[i][j] = index;
+    }
+  }
+
+  return buckets;
+}
+
+// Write the buckets to the given file and memory-map them.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::MapHashTable(const std::string& filename)
+{
+  // Rewriting a file that is already mapped would corrupt the mapping.
+  if (filename == hashTableMapFile)
+    return;
+
+  data::MappedMatrix<unsigned char>::Save(filename, secondHashTable);
+
+  std::shared_ptr<data::MappedMatrix<unsigned char>> mapped =
+      std::make_shared<data::MappedMatrix<unsigned char>>(filename);
+  mapped->Alias(secondHashTable);
+
+  mappedHashTable = mapped;
+  hashTableMapFile = filename;
+}
+
+// Drop the mapping of the buckets.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::UnmapHashTable()
+{
+  if (mappedHashTable)
+  {
+    data::MappedMatrix<unsigned char>::Unalias(secondHashTable);
+    mappedHashTable.reset();
+  }
+  hashTableMapFile.clear();
+}
+
 // Base case where the query set is the reference set.  (So, we can't return
 // ourselves as the nearest neighbor.)
 template<typename SortPolicy, typename MatType>
@@ -703,155 +877,192 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
 }
 
 template<typename SortPolicy, typename MatType>
-template<typename VecType>
-void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
-    arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
-    const size_t T) const
+void LSHSearch<SortPolicy, MatType>::HashQueries(
+    const MatType& querySet,
+    const size_t begin,
+    const size_t count,
+    const size_t numTablesToSearch,
+    const size_t T,
+    arma::Mat<size_t>& hashCodes) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
+  // Hash the queries in each of the 'numTablesToSearch' hash tables using the
   // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
+  // keys for each query where each key is a 'numProj' dimensional integer
   // vector.
 
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; ++i)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
+  // The slices of the cube are contiguous, so the projections of the first
+  // 'numTablesToSearch' tables can be used as one (dims x (numProj *
+  // numTablesToSearch)) matrix, and the projections of all the queries in all
+  // the tables are computed with a single matrix multiplication.
+  const arma::mat allProjections(const_cast<double*>(projections.memptr()),
+      projections.n_rows, numProj * numTablesToSearch, false, true);
+  const arma::mat queryProjections = allProjections.t() *
+      querySet.cols(begin, begin + count - 1);
 
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
-  allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
-
-  // Use hashMat to store the primary probing codes and any additional codes
+  // Use hashCodes to store the primary probing codes and any additional codes
   // from multiprobe LSH.
-  arma::Mat<size_t> hashMat;
-  hashMat.set_size(T + 1, numTablesToSearch);
-
-  // Compute the primary hash value of each key of the query into a bucket of
-  // the secondHashTable using the secondHashWeights.
-  hashMat.row(0) = arma::conv_to<arma::Row<size_t>> // Floor by typecasting
-      ::from(secondHashWeights.t() * allProjInTables);
-  // Mod to compute 2nd-level codes.
-  for (size_t i = 0; i < numTablesToSearch; ++i)
-    hashMat(0, i) = (hashMat(0, i) % secondHashSize);
-
-  // Compute hash codes of additional probing bins.
-  if (T > 0)
+  hashCodes.set_size(T + 1, count * numTablesToSearch);
+
+  // Each (query, table) pair can be handled independently; this is where the
+  // probing sequences of multiprobe LSH are computed, so this is also where
+  // most of the time goes when T > 0.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t pair = 0; pair < (omp_size_t) hashCodes.n_cols; ++pair)
   {
-    for (size_t i = 0; i < numTablesToSearch; ++i)
+    const size_t query = pair / numTablesToSearch;
+    const size_t table = pair % numTablesToSearch;
+
+    const arma::vec queryCodeNotFloored = queryProjections.submat(
+        table * numProj, query, (table + 1) * numProj - 1, query) +
+        offsets.col(table);
+    const arma::vec queryCode = arma::floor(queryCodeNotFloored / hashWidth);
+
+    // Column 0 holds the primary bin; the others hold the probing sequence of
+    // length T.
+    arma::mat probingBins(numProj, T + 1);
+    probingBins.col(0) = queryCode;
+    if (T > 0)
     {
-      // Construct this table's probing sequence of length T.
       arma::mat additionalProbingBins;
-      GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
-                                queryCodesNotFloored.unsafe_col(i),
-                                T,
-                                additionalProbingBins);
-
-      // Map each probing bin to a bin in secondHashTable (just like we did for
-      // the primary hash table).
-      hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
-        arma::conv_to< arma::Col<size_t> >:: // floor by typecasting to size_t
-        from(secondHashWeights.t() * additionalProbingBins);
-      for (size_t p = 1; p < T + 1; ++p)
-        hashMat(p, i) = (hashMat(p, i) % secondHashSize);
+      GetAdditionalProbingBins(queryCode, queryCodeNotFloored, T,
+          additionalProbingBins);
+      probingBins.cols(1, T) = additionalProbingBins;
     }
-  }
 
-  // Count number of points hashed in the same bucket as the query.
-  size_t maxNumPoints = 0;
-  for (size_t i = 0; i < numTablesToSearch; ++i)
-  {
+    // Map each bin to a bin in secondHashTable using the secondHashWeights
+    // (floor by typecasting), then mod to compute 2nd-level codes.
+    const arma::Row<size_t> codes = arma::conv_to<arma::Row<size_t>>::from(
+        secondHashWeights.t() * probingBins);
     for (size_t p = 0; p < T + 1; ++p)
-    {
-      const size_t hashInd = hashMat(p, i); // find query's bucket
-      const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
-    }
+      hashCodes(p, pair) = (codes[p] % secondHashSize);
   }
+}
 
-  // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
-  // Option 1 runs faster for small maxNumPoints but worse for larger values, so
-  // we choose based on a heuristic.
-  const float cutoff = 0.1;
-  const float selectivity = static_cast<float>(maxNumPoints) /
-      static_cast<float>(referenceSet.n_cols);
-
-  if (selectivity > cutoff)
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
+    const arma::Mat<size_t>& hashCodes,
+    const size_t queryIndex,
+    const size_t numTablesToSearch,
+    std::vector<bool>& candidateMask,
+    arma::uvec& referenceIndices) const
+{
+  // Collect each reference point hashed in the same bucket as the query the
+  // first time it is seen.
+  std::vector<size_t> candidates;
+  for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables.
   {
-    // Heuristic: larger maxNumPoints means we should use find() because it
-    // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
-
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
+    const size_t col = queryIndex * numTablesToSearch + i;
+    for (size_t p = 0; p < hashCodes.n_rows; ++p) // For the probing sequence.
     {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
+      const size_t hashInd = hashCodes(p, col); // Find the query's bucket.
+      const size_t tableRow = bucketRowInHashTable[hashInd];
+      if (tableRow >= secondHashSize)
+        continue;
+
+      // Decode the indices in the bucket as we go.
+      const unsigned char* position = secondHashTable.memptr() +
+          bucketOffsets[tableRow];
+      size_t index = 0;
+      for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
       {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
-
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+        index += lsh_detail::DecodeVarint(position);
+        if (!candidateMask[index])
         {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          candidateMask[index] = true;
+          candidates.push_back(index);
         }
       }
     }
+  }
 
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
+  // Return the candidates in increasing order.  If they are a sizable
+  // fraction of the reference set, scanning the bitmap is faster than sorting.
+  referenceIndices.set_size(candidates.size());
+  if (candidates.size() > referenceSet.n_cols / 16)
+  {
+    size_t j = 0;
+    for (size_t index = 0; index < candidateMask.size(); ++index)
+      if (candidateMask[index])
+        referenceIndices[j++] = index;
   }
   else
   {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
+    std::sort(candidates.begin(), candidates.end());
+    for (size_t j = 0; j < candidates.size(); ++j)
+      referenceIndices[j] = candidates[j];
+  }
+
+  // Only reset the entries we marked, so the bitmap can be reused cheaply.
+  for (size_t j = 0; j < candidates.size(); ++j)
+    candidateMask[candidates[j]] = false;
+}
+
+template<typename SortPolicy, typename MatType>
+size_t LSHSearch<SortPolicy, MatType>::SearchQueries(
+    const MatType& querySet,
+    const bool monochromatic,
+    const size_t k,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances,
+    size_t numTablesToSearch,
+    const size_t T) const
+{
+  // Decide on the number of tables to look into.
+  if (numTablesToSearch == 0) // If no user input is given, search all.
+    numTablesToSearch = numTables;
+
+  // Sanity check to make sure that the existing number of tables is not
+  // exceeded.
+  if (numTablesToSearch > numTables)
+    numTablesToSearch = numTables;
+
+  // The queries are hashed in blocks, so that the bucket codes of a whole
+  // block fit in memory even for large query sets.
+  const size_t blockSize = 4096;
+  size_t indicesReturned = 0;
+  for (size_t begin = 0; begin < querySet.n_cols; begin += blockSize)
+  {
+    const size_t count = std::min(blockSize, (size_t) querySet.n_cols - begin);
 
-    // Retrieve candidates.
-    size_t start = 0;
+    // Hash every query of the block into every hash table and eventually into
+    // the 'secondHashTable' to obtain the neighbor candidates.
+    arma::Mat<size_t> hashCodes;
+    HashQueries(querySet, begin, count, numTablesToSearch, T, hashCodes);
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
+    // Parallelization to process more than one query at a time.
+    #pragma omp parallel shared(resultingNeighbors, distances) \
+        reduction(+:indicesReturned)
     {
-      for (size_t p = 0; p < T + 1; ++p)
+      // Each thread discards duplicate candidates with its own bitmap.
+      std::vector<bool> candidateMask(referenceSet.n_cols, false);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
       {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
+        arma::uvec refIndices;
+        ReturnIndicesFromTable(hashCodes, i, numTablesToSearch, candidateMask,
+            refIndices);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        indicesReturned += refIndices.n_elem;
 
-        if (tableRow < secondHashSize)
+        // Sequentially go through all the candidates and save the best 'k'
+        // candidates.
+        if (monochromatic)
+        {
+          BaseCase(begin + i, refIndices, k, resultingNeighbors, distances);
+        }
+        else
         {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
+          BaseCase(begin + i, refIndices, k, querySet, resultingNeighbors,
+              distances);
+        }
       }
     }
-
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
   }
+
+  return indicesReturned;
 }
 
 // Search for nearest neighbors in a given query set.
@@ -907,34 +1118,10 @@ void LSHSearch<SortPolicy, MatType>::Search(
     Log::Info << "Running multiprobe LSH with " << Teffective
         <<" additional probing bins per table per query." << std::endl;
 
-  size_t avgIndicesReturned = 0;
-
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
-  }
+  size_t avgIndicesReturned = SearchQueries(querySet, false, k,
+      resultingNeighbors, distances, numTablesToSearch, Teffective);
 
   Timer::Stop("computing_neighbors");
 
@@ -973,34 +1160,10 @@ Search(const size_t k,
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
-  size_t avgIndicesReturned = 0;
-
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
-  }
+  size_t avgIndicesReturned = SearchQueries(referenceSet, true, k,
+      resultingNeighbors, distances, numTablesToSearch, Teffective);
 
   Timer::Stop("computing_neighbors");
 
@@ -1073,6 +1236,14 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(bucketSize);
   // needs specific handling for new version
 
+  // Any mapped buckets are replaced by the loaded ones.
+  if (Archive::is_loading::value)
+    UnmapHashTable();
+
+  // Older versions of LSHSearch stored the buckets uncompressed; they are
+  // loaded into this vector and compressed at the end.
+  std::vector<arma::Col<size_t>> buckets;
+
   // Backward compatibility: in older versions of LSHSearch, the secondHashTable
   // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
   // prune it down to size.
@@ -1085,7 +1256,7 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
     // it.
     tmpSecondHashTable = tmpSecondHashTable.t();
 
-    secondHashTable.resize(tmpSecondHashTable.n_cols);
+    buckets.resize(tmpSecondHashTable.n_cols);
     for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
     {
       // Find length of each column.  We know we are at the end of the list when
@@ -1097,26 +1268,25 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
           break;
 
       // Set the size of the new column correctly.
-      secondHashTable[i].set_size(len);
+      buckets[i].set_size(len);
       for (size_t j = 0; j < len; ++j)
-        secondHashTable[i](j) = tmpSecondHashTable(j, i);
+        buckets[i](j) = tmpSecondHashTable(j, i);
     }
   }
-  else
+  else if (version == 1)
   {
     size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
     ar & BOOST_SERIALIZATION_NVP(tables);
-
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
-    {
-      secondHashTable.clear();
-      secondHashTable.resize(tables);
-    }
-
-    ar & BOOST_SERIALIZATION_NVP(secondHashTable);
+    buckets.resize(tables);
+    ar & boost::serialization::make_nvp("secondHashTable", buckets);
+  }
+  else
+  {
+    // If the buckets are memory-mapped, only the name of the file is stored.
+    ar & BOOST_SERIALIZATION_NVP(hashTableMapFile);
+    if (hashTableMapFile.empty())
+      ar & BOOST_SERIALIZATION_NVP(secondHashTable);
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
   }
 
   // Backward compatibility: old versions of LSHSearch held bucketContentSize
@@ -1132,7 +1302,7 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
 
     // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
+    bucketContentSize.set_size(buckets.size());
     for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
       if (tmpBucketContentSize[i] > 0)
         bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
@@ -1143,6 +1313,20 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
   }
 
+  if (Archive::is_loading::value)
+  {
+    if (version < 2)
+    {
+      CompressBuckets(buckets);
+    }
+    else if (!hashTableMapFile.empty())
+    {
+      mappedHashTable = std::make_shared<data::MappedMatrix<unsigned char>>(
+          hashTableMapFile);
+      mappedHashTable->Alias(secondHashTable);
+    }
+  }
+
   ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
 }
 
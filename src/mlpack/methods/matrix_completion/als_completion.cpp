@@ -0,0 +1,181 @@
+/**
+ * @file methods/matrix_completion/als_completion.cpp
+ *
+ * Implementation of the ALSCompletion class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "als_completion.hpp"
+
+namespace mlpack {
+namespace matrix_completion {
+
+ALSCompletion::ALSCompletion(const size_t m,
+                             const size_t n,
+                             const arma::umat& indices,
+                             const arma::vec& values,
+                             const size_t rank,
+                             const double lambda,
+                             const size_t maxIterations,
+                             const double tolerance) :
+    m(m),
+    n(n),
+    rank(rank),
+    lambda(lambda),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    rmse(0.0),
+    iterations(0)
+{
+  if (indices.n_rows != 2)
+  {
+    Log::Fatal << "ALSCompletion::ALSCompletion(): matrix of indices does not "
+        << "have 2 rows!" << std::endl;
+  }
+
+  if (indices.n_cols != values.n_elem)
+  {
+    Log::Fatal << "ALSCompletion::ALSCompletion(): the number of indices "
+        << "(columns of indices matrix) does not match the number of values "
+        << "(length of value vector)!" << std::endl;
+  }
+
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    if (indices(0, i) >= m || indices(1, i) >= n)
+      Log::Fatal << "ALSCompletion::ALSCompletion(): indices ("
+          << indices(0, i) << ", " << indices(1, i)
+          << ") are out of bounds for matrix of size " << m << " x " << n
+          << "!" << std::endl;
+  }
+
+  Group(indices, values, 0, m, rowOffsets, rowColumns, rowValues);
+  Group(indices, values, 1, n, columnOffsets, columnRows, columnValues);
+}
+
+void ALSCompletion::Recover(arma::mat& recovered)
+{
+  arma::mat w, h;
+  Recover(w, h);
+  recovered = w * h;
+}
+
+void ALSCompletion::Recover(arma::mat& w, arma::mat& h)
+{
+  if (rank == 0)
+  {
+    Log::Fatal << "ALSCompletion::Recover(): the rank must be greater than 0!"
+        << std::endl;
+  }
+
+  // W is kept transposed, so that each row of W is a contiguous column.
+  arma::mat wt(rank, m);
+  h = arma::randu<arma::mat>(rank, n);
+
+  double lastRMSE = DBL_MAX;
+  iterations = 0;
+  while (maxIterations == 0 || iterations < maxIterations)
+  {
+    Update(rowOffsets, rowColumns, rowValues, h, wt);
+    Update(columnOffsets, columnRows, columnValues, wt, h);
+    ++iterations;
+
+    rmse = ComputeRMSE(wt, h);
+    Log::Debug << "ALSCompletion::Recover(): iteration " << iterations
+        << ", RMSE " << rmse << "." << std::endl;
+    if (lastRMSE - rmse <= tolerance * lastRMSE)
+      break;
+
+    lastRMSE = rmse;
+  }
+
+  w = wt.t();
+}
+
+void ALSCompletion::Group(const arma::umat& indices,
+                          const arma::vec& values,
+                          const size_t dim,
+                          const size_t size,
+                          std::vector<size_t>& offsets,
+                          std::vector<size_t>& others,
+                          arma::vec& sortedValues)
+{
+  offsets.assign(size + 1, 0);
+  for (size_t i = 0; i < indices.n_cols; ++i)
+    ++offsets[indices(dim, i) + 1];
+  for (size_t i = 0; i < size; ++i)
+    offsets[i + 1] += offsets[i];
+
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  others.resize(indices.n_cols);
+  sortedValues.set_size(indices.n_cols);
+  for (size_t i = 0; i < indices.n_cols; ++i)
+  {
+    const size_t position = next[indices(dim, i)]++;
+    others[position] = indices(1 - dim, i);
+    sortedValues[position] = values[i];
+  }
+}
+
+void ALSCompletion::Update(const std::vector<size_t>& offsets,
+                           const std::vector<size_t>& others,
+                           const arma::vec& sortedValues,
+                           const arma::mat& y,
+                           arma::mat& x) const
+{
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+  {
+    const size_t begin = offsets[i];
+    const size_t count = offsets[i + 1] - begin;
+    if (count == 0)
+    {
+      // Nothing is known about this row, so the regularization sets it to 0.
+      x.col(i).zeros();
+      continue;
+    }
+
+    // Gather the columns of y of the known entries, and solve the regularized
+    // normal equations (Y Y^T + lambda n_i I) x_i = Y v.
+    arma::mat known(rank, count);
+    for (size_t k = 0; k < count; ++k)
+      known.col(k) = y.col(others[begin + k]);
+    const arma::vec knownValues = sortedValues.subvec(begin, begin + count - 1);
+
+    arma::mat gram = known * known.t();
+    gram.diag() += lambda * count;
+    const arma::vec rhs = known * knownValues;
+
+    arma::vec solution;
+    if (!arma::solve(solution, gram, rhs))
+      solution = arma::pinv(gram) * rhs;
+    x.col(i) = solution;
+  }
+}
+
+double ALSCompletion::ComputeRMSE(const arma::mat& wt,
+                                  const arma::mat& h) const
+{
+  if (rowValues.n_elem == 0)
+    return 0.0;
+
+  double error = 0.0;
+  #pragma omp parallel for schedule(dynamic, 64) reduction(+:error)
+  for (omp_size_t i = 0; i < (omp_size_t) m; ++i)
+  {
+    for (size_t k = rowOffsets[i]; k < rowOffsets[i + 1]; ++k)
+    {
+      const double diff = rowValues[k] -
+          arma::dot(wt.col(i), h.col(rowColumns[k]));
+      error += diff * diff;
+    }
+  }
+
+  return std::sqrt(error / rowValues.n_elem);
+}
+
+} // namespace matrix_completion
+} // namespace mlpack
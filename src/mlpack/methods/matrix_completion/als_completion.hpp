@@ -0,0 +1,206 @@
+/**
+ * @file methods/matrix_completion/als_completion.hpp
+ *
+ * Low rank matrix completion by alternating least squares over the known
+ * entries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_ALS_COMPLETION_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_ALS_COMPLETION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace matrix_completion {
+
+/**
+ * This class fills in the unknown values of a matrix X of size m x n with a
+ * low rank approximation X ~= W H, where W has size m x r and H has size r x n,
+ * found by alternating minimization of the regularized squared error over the
+ * known entries M_ij only:
+ *
+ *   min sum_{(i, j) known} (M_ij - w_i h_j)^2
+ *       + lambda (sum_i n_i ||w_i||^2 + sum_j n_j ||h_j||^2)
+ *
+ * where n_i (n_j) is the number of known entries of row i (column j).  For a
+ * fixed H, each row of W is the solution of an r x r least squares problem on
+ * the known entries of that row, and conversely; all the rows (then all the
+ * columns) are solved in parallel, if OpenMP is available.  This is the
+ * weighted-lambda regularization of the following paper:
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-scale parallel collaborative filtering for the Netflix
+ *       prize},
+ *   author={Zhou, Y. and Wilkinson, D. and Schreiber, R. and Pan, R.},
+ *   booktitle={International Conference on Algorithmic Applications in
+ *       Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Unlike MatrixCompletion, which solves a semidefinite program with one
+ * constraint per known entry, the cost of an iteration is O(p r^2 + (m + n)
+ * r^3) for p known entries and the memory is O(p + (m + n) r), so problems with
+ * millions of known entries can be solved.  The rank must be given, and the
+ * solution is only a local minimum.
+ *
+ * @code
+ * size_t m, n;         // size of unknown matrix
+ * arma::umat indices;  // contains the known indices [2 x n_entries]
+ * arma::vec values;    // contains the known values [n_entries]
+ * arma::mat recovered; // will contain the completed matrix
+ *
+ * ALSCompletion mc(m, n, indices, values, 10);
+ * mc.Recover(recovered);
+ * @endcode
+ *
+ * @see MatrixCompletion
+ */
+class ALSCompletion
+{
+ public:
+  /**
+   * Construct a matrix completion problem.
+   *
+   * @param m Number of rows of original matrix.
+   * @param n Number of columns of original matrix.
+   * @param indices Matrix containing the indices of the known entries (must be
+   *    [2 x p]).
+   * @param values Vector containing the values of the known entries (must be
+   *    length p).
+   * @param rank Rank of the solution.
+   * @param lambda Regularization parameter.
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   * @param tolerance The iterations stop when the relative decrease of the
+   *    root mean squared error on the known entries is below this value.
+   */
+  ALSCompletion(const size_t m,
+                const size_t n,
+                const arma::umat& indices,
+                const arma::vec& values,
+                const size_t rank,
+                const double lambda = 1e-6,
+                const size_t maxIterations = 100,
+                const double tolerance = 1e-6);
+
+  /**
+   * Compute the factors W and H, and fill in the completed matrix W H.
+   *
+   * @param recovered Will contain the completed matrix.
+   */
+  void Recover(arma::mat& recovered);
+
+  /**
+   * Compute the factors W and H of the completed matrix, without forming it
+   * (which takes m x n memory).
+   *
+   * @param w Will contain W, of size m x r.
+   * @param h Will contain H, of size r x n.
+   */
+  void Recover(arma::mat& w, arma::mat& h);
+
+  //! Get the root mean squared error on the known entries of the last call to
+  //! Recover().
+  double RMSE() const { return rmse; }
+  //! Get the number of iterations of the last call to Recover().
+  size_t Iterations() const { return iterations; }
+
+  //! Get the rank of the solution.
+  size_t Rank() const { return rank; }
+  //! Modify the rank of the solution.
+  size_t& Rank() { return rank; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance of the stopping criterion.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the stopping criterion.
+  double& Tolerance() { return tolerance; }
+
+ private:
+  //! Number of rows in original matrix.
+  size_t m;
+  //! Number of columns in original matrix.
+  size_t n;
+  //! Rank of the solution.
+  size_t rank;
+  //! Regularization parameter.
+  double lambda;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Tolerance of the stopping criterion.
+  double tolerance;
+
+  //! Offset of the known entries of each row in rowColumns and rowValues (the
+  //! entries of row i are [rowOffsets[i], rowOffsets[i + 1])).
+  std::vector<size_t> rowOffsets;
+  //! Column of each known entry, sorted by row.
+  std::vector<size_t> rowColumns;
+  //! Value of each known entry, sorted by row.
+  arma::vec rowValues;
+
+  //! Offset of the known entries of each column in columnRows and
+  //! columnValues.
+  std::vector<size_t> columnOffsets;
+  //! Row of each known entry, sorted by column.
+  std::vector<size_t> columnRows;
+  //! Value of each known entry, sorted by column.
+  arma::vec columnValues;
+
+  //! Root mean squared error on the known entries after the last Recover().
+  double rmse;
+  //! Number of iterations of the last Recover().
+  size_t iterations;
+
+  /**
+   * Group the known entries by row or by column (a counting sort).
+   *
+   * @param indices Indices of the known entries.
+   * @param values Values of the known entries.
+   * @param dim Row of indices to group by (0 for rows, 1 for columns).
+   * @param size Number of rows (or columns).
+   * @param offsets Will contain the offsets of the groups.
+   * @param others Will contain the other index of each entry.
+   * @param sortedValues Will contain the value of each entry.
+   */
+  static void Group(const arma::umat& indices,
+                    const arma::vec& values,
+                    const size_t dim,
+                    const size_t size,
+                    std::vector<size_t>& offsets,
+                    std::vector<size_t>& others,
+                    arma::vec& sortedValues);
+
+  /**
+   * Solve the least squares problem of each row of the factor x (stored as
+   * columns, r x size), given the other factor y (r x otherSize).
+   */
+  void Update(const std::vector<size_t>& offsets,
+              const std::vector<size_t>& others,
+              const arma::vec& sortedValues,
+              const arma::mat& y,
+              arma::mat& x) const;
+
+  //! Compute the root mean squared error of W H on the known entries (W is
+  //! stored as columns, r x m).
+  double ComputeRMSE(const arma::mat& wt, const arma::mat& h) const;
+};
+
+} // namespace matrix_completion
+} // namespace mlpack
+
+#endif
@@ -47,7 +47,11 @@ namespace matrix_completion {
  * mc.Recover(recovered);
  * @endcode
  *
- * @see LRSDP
+ * Because the SDP has one constraint per known entry, this is only practical
+ * for small problems; ALSCompletion solves larger problems directly from the
+ * known entries.
+ *
+ * @see LRSDP, ALSCompletion
  */
 class MatrixCompletion
 {
@@ -85,6 +85,9 @@ class MeanShift
    * @param forceConvergence Flag whether to force each centroid seed to
    * converge regardless of maxIterations.
    * @param useSeeds Set true to use seeds.
+   *
+   * The seeds are shifted in parallel if OpenMP is available; each thread
+   * searches the same reference tree.
    */
   void Cluster(const MatType& data,
                arma::Row<size_t>& assignments,
@@ -132,13 +135,15 @@ class MeanShift
    * @param data The whole dataset
    * @param neighbors Valid neighbors
    * @param distances Distances to neighbors
+   * @param numNeighbors Number of valid neighbors
    # @param centroid Store calculated centroid
    */
   template<bool ApplyKernel = UseKernel>
   typename std::enable_if<ApplyKernel, bool>::type
   CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>& distances,
+                    const size_t* neighbors,
+                    const double* distances,
+                    const size_t numNeighbors,
                     arma::colvec& centroid);
 
   /**
@@ -147,15 +152,31 @@ class MeanShift
    * @param data The whole dataset
    * @param neighbors Valid neighbors
    * @param distances Distances to neighbors
+   * @param numNeighbors Number of valid neighbors
    # @param centroid Store calculated centroid
    */
   template<bool ApplyKernel = UseKernel>
   typename std::enable_if<!ApplyKernel, bool>::type
   CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>&, /*unused*/
+                    const size_t* neighbors,
+                    const double*, /*unused*/
+                    const size_t numNeighbors,
                     arma::colvec& centroid);
 
+  /**
+   * Add the converged centroids to the given centroids, in order, skipping
+   * each one that is within the radius of a centroid that was already added.
+   * The centroids are hashed into bins so that each one is only compared to
+   * the centroids in neighboring bins.
+   *
+   * @param allCentroids Centroid of each seed.
+   * @param converged Whether the centroid of each seed has converged.
+   * @param centroids Matrix the centroids are added to.
+   */
+  void MergeCentroids(const arma::mat& allCentroids,
+                      const std::vector<char>& converged,
+                      arma::mat& centroids);
+
   /**
    * If distance of two centroids is less than radius, one will be removed.
    * Points with distance to current centroid less than radius will be used
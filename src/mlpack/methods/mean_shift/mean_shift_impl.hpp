@@ -18,7 +18,7 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 
-#include "map"
+#include <unordered_map>
 
 // In case it hasn't been included yet.
 #include "mean_shift.hpp"
@@ -88,6 +88,35 @@ class less
   }
 };
 
+// Class to hash the (integer) coordinates of a hypercube bin.
+template <typename VecType>
+class BinHash
+{
+ public:
+  size_t operator()(const VecType& bin) const
+  {
+    size_t hash = bin.n_elem;
+    for (size_t i = 0; i < bin.n_elem; ++i)
+    {
+      // Combine the hashes like boost::hash_combine().
+      hash ^= std::hash<double>()(bin[i]) + 0x9e3779b9 + (hash << 6) +
+          (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+// Class to check whether two bins are the same.
+template <typename VecType>
+class BinEqual
+{
+ public:
+  bool operator()(const VecType& first, const VecType& second) const
+  {
+    return arma::all(first == second);
+  }
+};
+
 // Generate seeds from given data set.
 template<bool UseKernel, typename KernelType, typename MatType>
 void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
@@ -96,35 +125,28 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
     const int minFreq,
     MatType& seeds)
 {
+  // Count the points in each bin with a hash table, so that binning takes
+  // linear time in the number of points.
   typedef arma::colvec VecType;
-  std::map<VecType, int, less<VecType> > allSeeds;
+  std::unordered_map<VecType, int, BinHash<VecType>, BinEqual<VecType>>
+      allSeeds;
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     VecType binnedPoint = arma::floor(data.unsafe_col(i) / binSize);
-    if (allSeeds.find(binnedPoint) == allSeeds.end())
-      allSeeds[binnedPoint] = 1;
-    else
-      allSeeds[binnedPoint]++;
+    ++allSeeds[binnedPoint];
   }
 
-  // Remove seeds with too few points.  First we count the number of seeds we
-  // end up with, then we add them.
-  std::map<VecType, int, less<VecType> >::iterator it;
-  size_t count = 0;
-  for (it = allSeeds.begin(); it != allSeeds.end(); ++it)
+  // Remove seeds with too few points, and sort the others so that the order of
+  // the seeds does not depend on the hash table.
+  std::vector<VecType> bins;
+  for (auto it = allSeeds.begin(); it != allSeeds.end(); ++it)
     if (it->second >= minFreq)
-      ++count;
+      bins.push_back(it->first);
+  std::sort(bins.begin(), bins.end(), less<VecType>());
 
-  seeds.set_size(data.n_rows, count);
-  count = 0;
-  for (it = allSeeds.begin(); it != allSeeds.end(); ++it)
-  {
-    if (it->second >= minFreq)
-    {
-      seeds.col(count) = it->first;
-      ++count;
-    }
-  }
+  seeds.set_size(data.n_rows, bins.size());
+  for (size_t i = 0; i < bins.size(); ++i)
+    seeds.col(i) = bins[i];
 
   seeds *= binSize;
 }
@@ -135,12 +157,13 @@ template<bool ApplyKernel>
 typename std::enable_if<ApplyKernel, bool>::type
 MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>& distances,
+                  const size_t* neighbors,
+                  const double* distances,
+                  const size_t numNeighbors,
                   arma::colvec& centroid)
 {
   double sumWeight = 0;
-  for (size_t i = 0; i < neighbors.size(); ++i)
+  for (size_t i = 0; i < numNeighbors; ++i)
   {
     if (distances[i] > 0)
     {
@@ -165,14 +188,15 @@ template<bool ApplyKernel>
 typename std::enable_if<!ApplyKernel, bool>::type
 MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>&, /*unused*/
+                  const size_t* neighbors,
+                  const double*, /*unused*/
+                  const size_t numNeighbors,
                   arma::colvec& centroid)
 {
-  for (size_t i = 0; i < neighbors.size(); ++i)
+  for (size_t i = 0; i < numNeighbors; ++i)
     centroid += data.unsafe_col(neighbors[i]);
 
-  centroid /= neighbors.size();
+  centroid /= numNeighbors;
   return true;
 }
 
@@ -204,63 +228,64 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
 
   // Holds all centroids before removing duplicate ones.
   arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  std::vector<char> converged(pSeeds->n_cols, 0);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
-  math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
-
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  // The tree is built once, and each thread searches it with its own
+  // single-tree searcher (so no query tree is built for each iteration).  The
+  // neighbors are indices into the rearranged dataset of the tree.
+  typedef typename range::RangeSearch<>::Tree Tree;
+  Tree referenceTree(data);
+  const MatType& treeData = referenceTree.Dataset();
+  const math::Range validRadius(0, radius);
+
+  // For each seed, perform mean shift algorithm.  The seeds are independent,
+  // so they are shifted in parallel.
+  #pragma omp parallel
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
-    {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
-
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+    range::RangeSearch<> rangeSearcher(&referenceTree, true);
+    range::RangeSearchResults results;
 
-      // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
-
-      // If the mean shift vector is small enough, it has converged.
-      if (metric::EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) pSeeds->n_cols; ++i)
+    {
+      // Initial centroid is the seed itself.
+      allCentroids.col(i) = pSeeds->unsafe_col(i);
+      for (size_t completedIterations = 0; completedIterations < maxIterations
+          || forceConvergence; completedIterations++)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
+        // Store new centroid in this.
+        arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+
+        rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
+            results);
+        if (results.NumResults(0) == 0) // There are no points in the cluster.
+          break;
+
+        // Calculate new centroid.
+        if (!CalculateCentroid(treeData, results.Neighbors(0),
+            results.Distances(0), results.NumResults(0), newCentroid))
+          newCentroid = allCentroids.unsafe_col(i);
+
+        // If the mean shift vector is small enough, it has converged.
+        if (metric::EuclideanDistance::Evaluate(newCentroid,
+            allCentroids.unsafe_col(i)) < 1e-3 * radius)
         {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
+          converged[i] = 1;
+          break;
         }
 
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
-        break;
+        // Update the centroid.
+        allCentroids.col(i) = newCentroid;
       }
-
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
     }
   }
 
+  // Remove duplicate centroids in the order of the seeds, so the result is
+  // the same as when the seeds are shifted one after another.
+  MergeCentroids(allCentroids, converged, centroids);
+
   // If no centroid has converged due to too little iterations and without
   // forcing convergence, take 1 random centroid calculated.
   if (centroids.empty())
@@ -294,6 +319,97 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
   }
 }
 
+// Keep the converged centroids that are not within the radius of a previously
+// kept centroid.
+template<bool UseKernel, typename KernelType, typename MatType>
+void MeanShift<UseKernel, KernelType, MatType>::MergeCentroids(
+    const arma::mat& allCentroids,
+    const std::vector<char>& converged,
+    arma::mat& centroids)
+{
+  // Kept centroids are hashed into hypercube bins with side length equal to
+  // the radius, so a duplicate can only be in one of the 3^d bins around the
+  // bin of a centroid.  When there are fewer kept centroids than that, they
+  // are compared one by one instead.
+  typedef arma::colvec VecType;
+  std::unordered_map<VecType, std::vector<size_t>, BinHash<VecType>,
+      BinEqual<VecType>> bins;
+  const size_t dimensionality = allCentroids.n_rows;
+  const double neighborBins = std::pow(3.0, (double) dimensionality);
+
+  // Any centroids that were already given are kept.
+  arma::mat keptCentroids = centroids;
+  size_t numKept = centroids.n_cols;
+  keptCentroids.resize(dimensionality, numKept + allCentroids.n_cols);
+  VecType bin(dimensionality), offset(dimensionality), neighborBin;
+  for (size_t i = 0; i < numKept; ++i)
+  {
+    bin = arma::floor(keptCentroids.col(i) / radius);
+    bins[bin].push_back(i);
+  }
+
+  for (size_t i = 0; i < allCentroids.n_cols; ++i)
+  {
+    if (!converged[i])
+      continue;
+
+    bool isDuplicated = false;
+    bin = arma::floor(allCentroids.col(i) / radius);
+    if ((double) numKept <= neighborBins)
+    {
+      for (size_t k = 0; k < numKept && !isDuplicated; ++k)
+      {
+        isDuplicated = (metric::EuclideanDistance::Evaluate(
+            allCentroids.unsafe_col(i), keptCentroids.unsafe_col(k)) < radius);
+      }
+    }
+    else
+    {
+      // Visit each neighboring bin, counting the offsets in base 3.
+      offset.fill(-1.0);
+      bool done = false;
+      while (!done && !isDuplicated)
+      {
+        neighborBin = bin + offset;
+        auto it = bins.find(neighborBin);
+        if (it != bins.end())
+        {
+          for (size_t k = 0; k < it->second.size() && !isDuplicated; ++k)
+          {
+            isDuplicated = (metric::EuclideanDistance::Evaluate(
+                allCentroids.unsafe_col(i),
+                keptCentroids.unsafe_col(it->second[k])) < radius);
+          }
+        }
+
+        done = true;
+        for (size_t d = 0; d < dimensionality && done; ++d)
+        {
+          if (offset[d] < 1.0)
+          {
+            offset[d] += 1.0;
+            done = false;
+          }
+          else
+          {
+            offset[d] = -1.0;
+          }
+        }
+      }
+    }
+
+    if (!isDuplicated)
+    {
+      keptCentroids.col(numKept) = allCentroids.col(i);
+      bins[bin].push_back(numKept);
+      ++numKept;
+    }
+  }
+
+  keptCentroids.resize(dimensionality, numKept);
+  centroids = std::move(keptCentroids);
+}
+
 } // namespace meanshift
 } // namespace mlpack
 
@@ -108,6 +108,13 @@ class NaiveBayesClassifier
    * classes, either re-initialize or call Means(), Variances(), and
    * Probabilities() individually to set them to the right size.
    *
+   * The statistics of the dataset are computed on one chunk of the points per
+   * thread (when OpenMP is available), with a stable two-pass algorithm, and
+   * the statistics of the chunks are then merged into the model.  So a dataset
+   * too large to fit in memory can be trained on by calling Train() on each
+   * piece of it in turn, with the incremental algorithm.  If the dataset is an
+   * arma::SpMat, only its nonzero elements are visited.
+   *
    * @param data The dataset to train on.
    * @param labels The labels for the dataset.
    * @param numClasses The numbe of classes in the dataset.
@@ -216,7 +223,7 @@ class NaiveBayesClassifier
 
   //! Serialize the classifier.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   //! Sample mean for each class.
@@ -230,6 +237,53 @@ class NaiveBayesClassifier
   //! Small value to prevent log of zero.
   double epsilon;
 
+  /**
+   * Compute the class counts, and the means and sums of squared deviations from
+   * the means of each class, of the points in the given range of columns.
+   *
+   * @param data Dataset to compute the statistics of.
+   * @param labels Labels of the dataset.
+   * @param begin Index of the first point of the range.
+   * @param end Index one past the last point of the range.
+   * @param numClasses Number of classes.
+   * @param counts Will be filled with the number of points of each class.
+   * @param chunkMeans Will be filled with the mean of each class.
+   * @param chunkM2 Will be filled with the sum of squared deviations from the
+   *     mean of each class.
+   */
+  template<typename MatType>
+  void ChunkStatistics(const MatType& data,
+                       const arma::Row<size_t>& labels,
+                       const size_t begin,
+                       const size_t end,
+                       const size_t numClasses,
+                       ModelMatType& counts,
+                       ModelMatType& chunkMeans,
+                       ModelMatType& chunkM2) const;
+
+  //! Compute the statistics of a range of columns of a sparse dataset, only
+  //! visiting the nonzero elements.
+  template<typename eT>
+  void ChunkStatistics(const arma::SpMat<eT>& data,
+                       const arma::Row<size_t>& labels,
+                       const size_t begin,
+                       const size_t end,
+                       const size_t numClasses,
+                       ModelMatType& counts,
+                       ModelMatType& chunkMeans,
+                       ModelMatType& chunkM2) const;
+
+  /**
+   * Merge the statistics of another set of points into the given statistics,
+   * with the parallel algorithm of Chan, Golub and LeVeque.
+   */
+  static void MergeStatistics(ModelMatType& counts,
+                              ModelMatType& means,
+                              ModelMatType& m2,
+                              const ModelMatType& otherCounts,
+                              const ModelMatType& otherMeans,
+                              const ModelMatType& otherM2);
+
   /**
    * Compute the unnormalized posterior log probability of given points (log
    * likelihood). Results are returned as arma::mat, and each column represents
@@ -246,6 +300,10 @@ class NaiveBayesClassifier
 } // namespace naive_bayes
 } // namespace mlpack
 
+//! Set the serialization version of the NaiveBayesClassifier class.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename ModelMatType>,
+    mlpack::naive_bayes::NaiveBayesClassifier<ModelMatType>, 1);
+
 // Include implementation.
 #include "naive_bayes_classifier_impl.hpp"
 
@@ -22,6 +22,10 @@
 // In case it hasn't been included already.
 #include "naive_bayes_classifier.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace naive_bayes {
 
@@ -88,6 +92,9 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   // Do we need to resize the model?
   if (probabilities.n_elem != numClasses)
   {
+    // Any previous model can't be used as a starting point.
+    trainingPoints = 0;
+
     // Perform training, after initializing the model to 0 (that is, if Train()
     // won't do that for us, which it won't if we're using the incremental
     // algorithm).
@@ -105,74 +112,71 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     }
   }
 
-  // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
-  if (incremental)
+  // Calculate the class counts as well as the sample mean and the sum of
+  // squared deviations from the mean of each feature for each label, for one
+  // contiguous chunk of the points per thread.  These are then merged into the
+  // model with the parallel algorithm of Chan, Golub and LeVeque, which is as
+  // stable as the two-pass algorithm used on each chunk.
+  #ifdef HAS_OPENMP
+  const size_t numChunks = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), (size_t) data.n_cols));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  std::vector<ModelMatType> chunkCounts(numChunks);
+  std::vector<ModelMatType> chunkMeans(numChunks);
+  std::vector<ModelMatType> chunkM2(numChunks);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
-
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
+    const size_t begin = i * data.n_cols / numChunks;
+    const size_t end = (i + 1) * data.n_cols / numChunks;
+    ChunkStatistics(data, labels, begin, end, numClasses, chunkCounts[i],
+        chunkMeans[i], chunkM2[i]);
+  }
 
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
+  // Recover the statistics of the current model, if we are using it as a
+  // starting point.
+  ModelMatType counts, m2;
+  if (incremental && trainingPoints > 0)
+  {
+    counts = arma::round(probabilities * trainingPoints);
+    m2.zeros(arma::size(variances));
+    for (size_t i = 0; i < counts.n_elem; ++i)
     {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
+      // The variances hold epsilon, which we remove before de-normalizing.
+      if (counts[i] > 1)
+      {
+        m2.col(i) = arma::clamp(variances.col(i) - epsilon, 0.0,
+            std::numeric_limits<ElemType>::max()) * (counts[i] - 1);
+      }
     }
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
-    means.zeros();
-    variances.zeros();
-
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
-
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
-    }
+    counts.zeros(numClasses);
+    means.zeros(data.n_rows, numClasses);
+    m2.zeros(data.n_rows, numClasses);
+    trainingPoints = 0;
+  }
 
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+  for (size_t i = 0; i < numChunks; ++i)
+    MergeStatistics(counts, means, m2, chunkCounts[i], chunkMeans[i],
+        chunkM2[i]);
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
-    }
-
-    // Normalize variances.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
-  }
+  // Normalize variances.
+  variances = m2;
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    if (counts[i] > 1)
+      variances.col(i) /= (counts[i] - 1);
 
   // Add epsilon to prevent log of zero.
   variances += epsilon;
 
-  probabilities /= data.n_cols;
   trainingPoints += data.n_cols;
+  if (trainingPoints > 0)
+    probabilities = counts / trainingPoints;
 }
 
 template<typename ModelMatType>
@@ -200,6 +204,130 @@ void NaiveBayesClassifier<ModelMatType>::Train(const VecType& point,
   probabilities /= trainingPoints;
 }
 
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::ChunkStatistics(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t begin,
+    const size_t end,
+    const size_t numClasses,
+    ModelMatType& counts,
+    ModelMatType& chunkMeans,
+    ModelMatType& chunkM2) const
+{
+  counts.zeros(numClasses);
+  chunkMeans.zeros(data.n_rows, numClasses);
+  chunkM2.zeros(data.n_rows, numClasses);
+
+  // This is a two-pass algorithm.  It is possible to calculate the means and
+  // variances using a faster one-pass algorithm but there are some precision
+  // and stability issues.
+
+  // Calculate the means.
+  for (size_t j = begin; j < end; ++j)
+  {
+    const size_t label = labels[j];
+    ++counts[label];
+    chunkMeans.col(label) += data.col(j);
+  }
+
+  // Normalize means.
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    if (counts[i] != 0.0)
+      chunkMeans.col(i) /= counts[i];
+
+  // Calculate the sums of squared deviations.
+  for (size_t j = begin; j < end; ++j)
+  {
+    const size_t label = labels[j];
+    chunkM2.col(label) += arma::square(data.col(j) - chunkMeans.col(label));
+  }
+}
+
+template<typename ModelMatType>
+template<typename eT>
+void NaiveBayesClassifier<ModelMatType>::ChunkStatistics(
+    const arma::SpMat<eT>& data,
+    const arma::Row<size_t>& labels,
+    const size_t begin,
+    const size_t end,
+    const size_t numClasses,
+    ModelMatType& counts,
+    ModelMatType& chunkMeans,
+    ModelMatType& chunkM2) const
+{
+  counts.zeros(numClasses);
+  chunkMeans.zeros(data.n_rows, numClasses);
+  chunkM2.zeros(data.n_rows, numClasses);
+
+  // This is the same two-pass algorithm, but it only visits the nonzero
+  // elements; each zero element adds the square of the mean to the sum of
+  // squared deviations, so we only have to count them.
+  arma::Mat<size_t> nonzeros(data.n_rows, numClasses, arma::fill::zeros);
+  for (size_t j = begin; j < end; ++j)
+  {
+    const size_t label = labels[j];
+    ++counts[label];
+    for (typename arma::SpMat<eT>::const_iterator it = data.begin_col(j);
+         it != data.end_col(j); ++it)
+    {
+      chunkMeans(it.row(), label) += (*it);
+      ++nonzeros(it.row(), label);
+    }
+  }
+
+  // Normalize means.
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    if (counts[i] != 0.0)
+      chunkMeans.col(i) /= counts[i];
+
+  // Calculate the sums of squared deviations of the nonzero elements.
+  for (size_t j = begin; j < end; ++j)
+  {
+    const size_t label = labels[j];
+    for (typename arma::SpMat<eT>::const_iterator it = data.begin_col(j);
+         it != data.end_col(j); ++it)
+    {
+      const ElemType diff = (*it) - chunkMeans(it.row(), label);
+      chunkM2(it.row(), label) += diff * diff;
+    }
+  }
+
+  // Now add the zero elements.
+  for (size_t i = 0; i < numClasses; ++i)
+  {
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      chunkM2(d, i) += (counts[i] - nonzeros(d, i)) * chunkMeans(d, i) *
+          chunkMeans(d, i);
+    }
+  }
+}
+
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::MergeStatistics(
+    ModelMatType& counts,
+    ModelMatType& means,
+    ModelMatType& m2,
+    const ModelMatType& otherCounts,
+    const ModelMatType& otherMeans,
+    const ModelMatType& otherM2)
+{
+  for (size_t i = 0; i < counts.n_elem; ++i)
+  {
+    const ElemType n = counts[i] + otherCounts[i];
+    if (otherCounts[i] == 0)
+      continue;
+
+    const arma::Col<ElemType> delta = otherMeans.col(i) - means.col(i);
+    means.col(i) += delta * (otherCounts[i] / n);
+    m2.col(i) += otherM2.col(i) +
+        arma::square(delta) * (counts[i] * otherCounts[i] / n);
+    counts[i] = n;
+  }
+}
+
 template<typename ModelMatType>
 template<typename MatType>
 void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
@@ -351,11 +479,23 @@ template<typename ModelMatType>
 template<typename Archive>
 void NaiveBayesClassifier<ModelMatType>::serialize(
     Archive& ar,
-    const unsigned int /* version */)
+    const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(means);
   ar & BOOST_SERIALIZATION_NVP(variances);
   ar & BOOST_SERIALIZATION_NVP(probabilities);
+
+  // Older versions did not store the number of training points and epsilon,
+  // which are needed to continue training incrementally.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(trainingPoints);
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+  }
+  else if (Archive::is_loading::value)
+  {
+    trainingPoints = 0;
+  }
 }
 
 } // namespace naive_bayes
@@ -86,6 +86,14 @@ class NCA
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
 
+  //! Get the number of neighbors the softmax sums are truncated to (0 means
+  //! all the points).
+  size_t NumNeighbors() const { return errorFunction.NumNeighbors(); }
+  //! Modify the number of neighbors the softmax sums are truncated to (0 means
+  //! all the points).  A few tens of neighbors are usually enough, and make
+  //! each evaluation O(k) instead of O(n).
+  size_t& NumNeighbors() { return errorFunction.NumNeighbors(); }
+
  private:
   //! Dataset reference.
   const arma::mat& dataset;
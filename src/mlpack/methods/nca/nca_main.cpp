@@ -92,6 +92,12 @@ BINDING_LONG_DESC(
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
+    "Each evaluation of the objective scans the whole dataset for every point."
+    "  For large datasets, the " + PRINT_PARAM_STRING("num_neighbors") +
+    " parameter can be given to only consider that many nearest neighbors "
+    "(in the projected space) of each point; the neighbors are recomputed at "
+    "the start of each pass over the data.  If set to 0, all points are used."
+    "\n\n"
     "By default, the SGD optimizer is used.");
 
 // See also...
@@ -135,6 +141,9 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("num_neighbors", "Number of nearest neighbors to truncate the "
+    "softmax sums to (0 uses all the points).", "k", 0);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -156,6 +165,9 @@ static void mlpackMain()
   RequireParamInSet<string>("optimizer", { "sgd", "lbfgs" },
       true, "unknown optimizer type");
 
+  RequireParamValue<int>("num_neighbors", [](int x) { return x >= 0; }, true,
+      "number of neighbors must be non-negative");
+
   // Warn on unused parameters.
   if (optimizerType == "sgd")
   {
@@ -187,6 +199,7 @@ static void mlpackMain()
   const double minStep = IO::GetParam<double>("min_step");
   const double maxStep = IO::GetParam<double>("max_step");
   const size_t batchSize = (size_t) IO::GetParam<int>("batch_size");
+  const size_t numNeighbors = (size_t) IO::GetParam<int>("num_neighbors");
 
   // Load data.
   arma::mat data = std::move(IO::GetParam<arma::mat>("input"));
@@ -246,6 +259,7 @@ static void mlpackMain()
     nca.Optimizer().Tolerance() = tolerance;
     nca.Optimizer().Shuffle() = shuffle;
     nca.Optimizer().BatchSize() = batchSize;
+    nca.NumNeighbors() = numNeighbors;
 
     nca.LearnDistance(distance);
   }
@@ -258,6 +272,7 @@ static void mlpackMain()
     nca.Optimizer().Wolfe() = wolfe;
     nca.Optimizer().MinGradientNorm() = tolerance;
     nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
+    nca.NumNeighbors() = numNeighbors;
     nca.Optimizer().MinStep() = minStep;
     nca.Optimizer().MaxStep() = maxStep;
 
@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -40,6 +41,15 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * Each p_i needs a scan over the whole dataset.  If a number of neighbors is
+ * given, the sum over k is truncated to the nearest neighbors of x_i in the
+ * projected space (the points that carry almost all of the softmax mass),
+ * which are found with a kNN search and refreshed at the beginning of each
+ * pass over the dataset (or whenever the non-separable functions are called
+ * with new coordinates).  The points of a batch are handled in parallel with
+ * OpenMP, and the gradient is assembled with matrix products instead of one
+ * outer product per pair of points.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -54,10 +64,13 @@ class SoftmaxErrorFunction
    * @param dataset Matrix containing the dataset.
    * @param labels Vector of class labels for each point in the dataset.
    * @param metric Instantiated metric (optional).
+   * @param numNeighbors Number of nearest neighbors (in the projected space) to
+   *     truncate the softmax sums to; 0 uses all the points (optional).
    */
   SoftmaxErrorFunction(const arma::mat& dataset,
                        const arma::Row<size_t>& labels,
-                       MetricType metric = MetricType());
+                       MetricType metric = MetricType(),
+                       const size_t numNeighbors = 0);
 
   /**
    * Shuffle the dataset.
@@ -131,6 +144,18 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of neighbors the softmax sums are truncated to (0 means
+  //! all the points).
+  size_t NumNeighbors() const { return numNeighbors; }
+  //! Modify the number of neighbors the softmax sums are truncated to (0 means
+  //! all the points).
+  size_t& NumNeighbors()
+  {
+    neighborsPrecalculated = false;
+    precalculated = false;
+    return numNeighbors;
+  }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -154,6 +179,16 @@ class SoftmaxErrorFunction
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! Number of neighbors to truncate the softmax sums to (0 means all points).
+  size_t numNeighbors;
+  //! Nearest neighbors of each point in the projected space, when the softmax
+  //! sums are truncated.
+  arma::umat neighborIndices;
+  //! Coordinates the neighbors were computed with.
+  arma::mat neighborCoordinates;
+  //! False if the neighbors have to be computed again.
+  bool neighborsPrecalculated;
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
@@ -168,6 +203,45 @@ class SoftmaxErrorFunction
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  /**
+   * Return true if the neighbors of the points have to be computed again for
+   * the given coordinates: they are only refreshed at the beginning of a pass
+   * over the dataset (begin = 0), so the batches of a pass use the same ones.
+   */
+  bool NeighborsOutdated(const arma::mat& coordinates,
+                         const size_t begin) const;
+
+  /**
+   * Find the nearest neighbors of each point in the stretched dataset, which
+   * must have been computed with the given coordinates.
+   */
+  void UpdateNeighbors(const arma::mat& coordinates);
+
+  //! Get the number of points each softmax sum is taken over.
+  size_t NumCandidates() const
+  {
+    return (numNeighbors > 0) ? neighborIndices.n_rows : dataset.n_cols;
+  }
+
+  /**
+   * Compute the terms exp(-D(A x_i, A x_k)) of the softmax sums of point i
+   * (0 for k = i), and whether each point k is in the same class as point i
+   * (1 or 0).  When the sums are truncated, the c'th term is the one of the
+   * c'th nearest neighbor of point i.
+   */
+  void PointTerms(const size_t i, arma::vec& evals, arma::vec& sameClass);
+
+  /**
+   * Compute the sum
+   *   sum_i sum_k (p_i - [class of i == class of k]) p_ik x_ik x_ik^T
+   * over the points i = begin, ..., begin + batchSize - 1 (where x_ik = x_i -
+   * x_k), so that the gradient is -2 A times the sum.  The stretched dataset
+   * (and the neighbors) must be up to date.
+   */
+  void GradientSum(const size_t begin,
+                   const size_t batchSize,
+                   arma::mat& sum);
 };
 
 } // namespace nca
@@ -25,11 +25,14 @@ template<typename MetricType>
 SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     const arma::mat& dataset,
     const arma::Row<size_t>& labels,
-    MetricType metric) :
+    MetricType metric,
+    const size_t numNeighbors) :
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
-    precalculated(false)
+    precalculated(false),
+    numNeighbors(numNeighbors),
+    neighborsPrecalculated(false)
 { /* nothing to do */ }
 
 //! Shuffle the dataset.
@@ -46,6 +49,10 @@ void SoftmaxErrorFunction<MetricType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The precalculated values and the neighbors refer to the old order.
+  precalculated = false;
+  neighborsPrecalculated = false;
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -66,44 +73,42 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t begin,
                                                   const size_t batchSize)
 {
-  // Unfortunately each evaluation will take O(N) time because it requires a
-  // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
-  double result = 0;
-
-  // It's quicker to do this now than one point at a time later.
+  // Unfortunately each evaluation will take O(N) time (or O(k) with truncated
+  // sums) because it requires a scan over the points.  Our objective is to
+  // compute p_i.  It's quicker to stretch the dataset now than one point at a
+  // time later.
   stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; ++i)
-  {
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (k == i)
-        continue;
-
-      // We want to evaluate exp(-D(A x_i, A x_k)).
-      double eval = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                              stretchedDataset.unsafe_col(k)));
+  if (NeighborsOutdated(coordinates, begin))
+    UpdateNeighbors(coordinates);
 
-      // If they are in the same class, update the numerator.
-      if (labels[i] == labels[k])
-        numerator += eval;
-
-      denominator += eval;
-    }
+  double result = 0;
+  size_t zeroDenominators = 0;
+  #pragma omp parallel for reduction(+:result, zeroDenominators) \
+      schedule(dynamic)
+  for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
+  {
+    arma::vec evals, sameClass;
+    PointTerms(i, evals, sameClass);
 
     // Now the result is just a simple division, but we have to be sure that the
     // denominator is not 0.
+    const double denominator = arma::accu(evals);
     if (denominator == 0.0)
     {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+      ++zeroDenominators;
       continue;
     }
 
-    result += -(numerator / denominator); // Negate because the optimizer is a
-                                          // minimizer.
+    result += -(arma::dot(evals, sameClass) / denominator); // Negate because
+        // the optimizer is a minimizer.
+  }
+
+  if (zeroDenominators > 0)
+  {
+    Log::Warn << "Denominator of p_i is 0 for " << zeroDenominators
+        << " points!" << std::endl;
   }
+
   return result;
 }
 
@@ -112,44 +117,11 @@ template<typename MetricType>
 void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 arma::mat& gradient)
 {
-  // Calculate the denominators and numerators, if necessary.
+  // Calculate the stretched dataset (and the neighbors), if necessary.
   Precalculate(coordinates);
 
-  // Now, we handle the summation over i:
-  //   sum_i (p_i sum_k (p_ik x_ik x_ik^T) -
-  //       sum_{j in class of i} (p_ij x_ij x_ij^T)
-  // We can algebraically manipulate the whole thing to produce a more
-  // memory-friendly way to calculate this.  Looping over each i and k (again
-  // O((n * (n + 1)) / 2) as with the last step, we can add the following to the
-  // sum:
-  //
-  //   if class of i is the same as the class of k, add
-  //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
-  //   otherwise, add
-  //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
   arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
-  {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; ++k)
-    {
-      // Calculate p_ik and p_ki first.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
-
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
-
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
-    }
-  }
+  GradientSum(0, dataset.n_cols, sum);
 
   // Assemble the final gradient.
   gradient = -2 * coordinates * sum;
@@ -163,72 +135,17 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
-  // The gradient involves two matrix terms which are eventually combined into
-  // one.
-  GradType firstTerm, secondTerm;
-  // We will need to calculate p_i before this evaluation is done, so
-  // these two variables will hold the information necessary for that.
-  double numerator, denominator;
-
-  gradient.zeros(coordinates.n_rows, coordinates.n_rows);
-
   // Compute the stretched dataset.
   stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; ++i)
-  {
-    numerator = 0;
-    denominator = 0;
-
-    firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-    secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (i == k)
-        continue;
-
-      // Calculate the numerator of p_ik.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
+  if (NeighborsOutdated(coordinates, begin))
+    UpdateNeighbors(coordinates);
 
-      // If the points are in the same class, we must add to the second term of
-      // the gradient as well as the numerator of p_i.  We will divide by the
-      // denominator of p_ik later.  For x_ik we are not using stretched points.
-      GradType x_ik = dataset.col(i) - dataset.col(k);
-      if (labels[i] == labels[k])
-      {
-        numerator += eval;
-        secondTerm += eval * x_ik * trans(x_ik);
-      }
-
-      // We always have to add to the denominator of p_i
-      // and the first term of the gradient computation.
-      // We will divide by the denominator of p_ik later.
-      denominator += eval;
-      firstTerm += eval * x_ik * trans(x_ik);
-    }
-
-    // Calculate p_i.
-    double p = 0;
-    if (denominator == 0)
-    {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      // If the denominator is zero, then all p_ik should be zero and there is
-      // no gradient contribution from this point.
-      continue;
-    }
-    else
-    {
-      p = numerator / denominator;
-      firstTerm /= denominator;
-      secondTerm /= denominator;
-    }
+  arma::mat sum;
+  GradientSum(begin, batchSize, sum);
 
-    // Now multiply the first term by p_i, and add the two together and multiply
-    // all by 2 * A.  We negate it though, because our optimizer is a minimizer.
-    gradient += -2 * coordinates * (p * firstTerm - secondTerm);
-  }
+  // Multiply all by 2 * A.  We negate it though, because our optimizer is a
+  // minimizer.
+  gradient = GradType(-2 * coordinates * sum);
 }
 
 template<typename MetricType>
@@ -256,34 +173,24 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   // Coordinates are different; save the new ones, and stretch the dataset.
   lastCoordinates = coordinates;
   stretchedDataset = coordinates * dataset;
+  if (NeighborsOutdated(coordinates, 0))
+    UpdateNeighbors(coordinates);
 
   // For each point i, we must evaluate the softmax function:
   //   p_ij = exp( -K(x_i, x_j) ) / ( sum_{k != i} ( exp( -K(x_i, x_k) )))
   //   p_i = sum_{j in class of i} p_ij
   // We will do this by keeping track of the denominators for each i as well as
-  // the numerators (the sum for all j in class of i).  This will be on the
-  // order of O((n * (n + 1)) / 2), which really isn't all that great.
-  p.zeros(stretchedDataset.n_cols);
-  denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  // the numerators (the sum for all j in class of i).  Each point is handled
+  // independently, so the points are split between the threads.
+  p.set_size(stretchedDataset.n_cols);
+  denominators.set_size(stretchedDataset.n_cols);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) stretchedDataset.n_cols; ++i)
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; ++j)
-    {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
-
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
-
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
-      {
-        p[i] += eval;
-        p[j] += eval;
-      }
-    }
+    arma::vec evals, sameClass;
+    PointTerms(i, evals, sameClass);
+    denominators[i] = arma::accu(evals);
+    p[i] = arma::dot(evals, sameClass);
   }
 
   // Divide p_i by their denominators.
@@ -306,6 +213,161 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MetricType>
+bool SoftmaxErrorFunction<MetricType>::NeighborsOutdated(
+    const arma::mat& coordinates,
+    const size_t begin) const
+{
+  if (numNeighbors == 0)
+    return false;
+  if (!neighborsPrecalculated)
+    return true;
+  if (begin != 0)
+    return false;
+
+  return (neighborCoordinates.n_rows != coordinates.n_rows ||
+      neighborCoordinates.n_cols != coordinates.n_cols ||
+      accu(coordinates == neighborCoordinates) != coordinates.n_elem);
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::UpdateNeighbors(
+    const arma::mat& coordinates)
+{
+  // A point is not its own neighbor, so there can't be more than n - 1.
+  const size_t k = std::min(numNeighbors, (size_t) dataset.n_cols - 1);
+  if (k == 0)
+  {
+    neighborIndices.set_size(0, dataset.n_cols);
+  }
+  else
+  {
+    neighbor::KNN knn(stretchedDataset);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(k, neighbors, distances);
+    neighborIndices = arma::conv_to<arma::umat>::from(neighbors);
+  }
+
+  neighborCoordinates = coordinates;
+  neighborsPrecalculated = true;
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::PointTerms(const size_t i,
+                                                  arma::vec& evals,
+                                                  arma::vec& sameClass)
+{
+  const size_t candidates = NumCandidates();
+  evals.set_size(candidates);
+  sameClass.set_size(candidates);
+  for (size_t c = 0; c < candidates; ++c)
+  {
+    const size_t k = (numNeighbors > 0) ? (size_t) neighborIndices(c, i) : c;
+
+    // Don't consider the case where the points are the same.
+    if (k == i)
+    {
+      evals[c] = 0.0;
+      sameClass[c] = 0.0;
+      continue;
+    }
+
+    // We want to evaluate exp(-D(A x_i, A x_k)).
+    evals[c] = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                         stretchedDataset.unsafe_col(k)));
+    sameClass[c] = (labels[i] == labels[k]) ? 1.0 : 0.0;
+  }
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::GradientSum(const size_t begin,
+                                                   const size_t batchSize,
+                                                   arma::mat& sum)
+{
+  // With w_ik = (p_i - [class of i == class of k]) p_ik, the sum of the
+  // w_ik x_ik x_ik^T is, once the outer products are expanded,
+  //   sum_i (r_i x_i x_i^T - x_i y_i^T - y_i x_i^T) + sum_k c_k x_k x_k^T
+  // where r_i = sum_k w_ik, y_i = sum_k w_ik x_k and c_k = sum_i w_ik, so it
+  // takes a few matrix products instead of one outer product for each pair of
+  // points.  We are not using stretched points here.
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+  const size_t candidates = NumCandidates();
+  if (candidates == 0 || batchSize == 0)
+    return;
+
+  // The weights are computed for chunks of points, so that they take a
+  // bounded amount of memory.
+  const size_t chunkSize = std::max((size_t) 1,
+      ((size_t) 1 << 22) / candidates);
+  arma::mat weights, y;
+  arma::vec candidateWeights(dataset.n_cols, arma::fill::zeros);
+  size_t zeroDenominators = 0;
+  for (size_t chunkBegin = begin; chunkBegin < begin + batchSize;
+       chunkBegin += chunkSize)
+  {
+    const size_t count = std::min(chunkSize, begin + batchSize - chunkBegin);
+    weights.set_size(candidates, count);
+    y.set_size(dataset.n_rows, count);
+
+    #pragma omp parallel for reduction(+:zeroDenominators) schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) count; ++j)
+    {
+      const size_t i = chunkBegin + j;
+      arma::vec evals, sameClass;
+      PointTerms(i, evals, sameClass);
+
+      const double denominator = arma::accu(evals);
+      if (denominator == 0.0)
+      {
+        // If the denominator is zero, then all p_ik should be zero and there
+        // is no gradient contribution from this point.
+        ++zeroDenominators;
+        weights.col(j).zeros();
+        y.col(j).zeros();
+        continue;
+      }
+
+      const double p = arma::dot(evals, sameClass) / denominator;
+      weights.col(j) = (p - sameClass) % evals / denominator;
+      if (numNeighbors > 0)
+        y.col(j) = dataset.cols(neighborIndices.col(i)) * weights.col(j);
+      else
+        y.col(j) = dataset * weights.col(j);
+    }
+
+    // Add the terms of the points of the chunk.
+    const arma::mat points = dataset.cols(chunkBegin, chunkBegin + count - 1);
+    const arma::rowvec r = arma::sum(weights, 0);
+    sum += (points.each_row() % r) * points.t() - points * y.t() -
+        y * points.t();
+
+    // Collect the weights of the points they are compared with.
+    if (numNeighbors > 0)
+    {
+      for (size_t j = 0; j < count; ++j)
+        for (size_t c = 0; c < candidates; ++c)
+          candidateWeights[neighborIndices(c, chunkBegin + j)] += weights(c, j);
+    }
+    else
+    {
+      candidateWeights += arma::sum(weights, 1);
+    }
+  }
+
+  // Only the points with some weight are needed for the last term.
+  const arma::uvec used = arma::find(candidateWeights);
+  const arma::mat usedPoints = dataset.cols(used);
+  sum += (usedPoints.each_row() % candidateWeights.elem(used).t()) *
+      usedPoints.t();
+
+  if (zeroDenominators > 0)
+  {
+    Log::Warn << "Denominator of p_i is 0 for " << zeroDenominators
+        << " points!" << std::endl;
+  }
+}
+
 } // namespace nca
 } // namespace mlpack
 
@@ -0,0 +1,212 @@
+/**
+ * @file methods/neighbor_search/gpu_neighbor_search.hpp
+ *
+ * Brute-force neighbor search on the GPU, where tiles of the reference set are
+ * streamed through device memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_GPU_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_GPU_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "sort_policies/nearest_neighbor_sort.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The matrix type the distances are computed with: single-precision Bandicoot
+ * matrices in GPU memory if mlpack is built with the USE_BANDICOOT CMake
+ * option, and Armadillo matrices (that is, the same tiled computation on the
+ * CPU) otherwise.
+ */
+#ifdef HAS_BANDICOOT
+typedef coot::fmat GPUMatType;
+#else
+typedef arma::fmat GPUMatType;
+#endif
+
+/**
+ * GPUNeighborSearch is an exact brute-force k-nearest (or furthest) neighbor
+ * search with the Euclidean distance, for dense data where trees do not prune
+ * (such as embeddings with tens or hundreds of dimensions).  The squared
+ * distances between the points are expanded as ||q||^2 + ||r||^2 - 2 q^T r, so
+ * that almost all of the work is one matrix product for each pair of a tile of
+ * reference points and a tile of query points, done by the device.
+ *
+ * Only one tile of referenceTileSize reference points, one tile of
+ * queryTileSize query points and the referenceTileSize x queryTileSize tile of
+ * products are in device memory at a time: the reference set is streamed
+ * through the device one tile at a time, so it can be much larger than the
+ * memory of the GPU.  The candidates of each query point are selected on the
+ * device: the distances of each query point to the tile are sorted there, and
+ * only the k'th best of them and the indices of the reference points that may
+ * be neighbors (about k per query point) are copied back to the host.  With
+ * Armadillo matrices, the products are already on the host, and the
+ * candidates are selected there without sorting.  In both cases the selected
+ * points are evaluated in parallel over the query points, if OpenMP is
+ * available.
+ *
+ * The products are computed in single precision, on points centered on the
+ * mean of the reference set.  As in metric::SquaredDistanceBlock(), the result
+ * comes with a bound on its error: the reference points whose distance can't
+ * be better than the k'th best pessimistic bound are discarded, and the few
+ * that remain are evaluated exactly on the host.  So the results are the same
+ * as those of the other search modes.
+ *
+ * @code
+ * extern arma::mat referenceSet, querySet;
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ *
+ * GPUNeighborSearch<> gpu;
+ * gpu.Search(referenceSet, querySet, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam DeviceMatType Matrix type the products are computed with.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename DeviceMatType = GPUMatType>
+class GPUNeighborSearch
+{
+ public:
+  /**
+   * Create the GPUNeighborSearch object.  The device memory used is about
+   * (dimensionality + 3 * queryTileSize) * referenceTileSize +
+   * dimensionality * queryTileSize elements (the products, the distances and
+   * the sorted distances of a tile).
+   *
+   * @param referenceTileSize Number of reference points in device memory at a
+   *     time.
+   * @param queryTileSize Number of query points in device memory at a time.
+   */
+  GPUNeighborSearch(const size_t referenceTileSize = 16384,
+                    const size_t queryTileSize = 1024);
+
+  /**
+   * Find the k nearest (or furthest) neighbors in the reference set of each
+   * point of the query set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing the list of neighbors of each query point.
+   * @param distances Matrix storing the distances of the neighbors.
+   */
+  void Search(const arma::mat& referenceSet,
+              const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Find the k nearest (or furthest) neighbors of each point of the reference
+   * set, excluding the point itself.
+   *
+   * @param referenceSet Set of reference points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing the list of neighbors of each point.
+   * @param distances Matrix storing the distances of the neighbors.
+   */
+  void Search(const arma::mat& referenceSet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the number of reference points in device memory at a time.
+  size_t ReferenceTileSize() const { return referenceTileSize; }
+  //! Modify the number of reference points in device memory at a time.
+  size_t& ReferenceTileSize() { return referenceTileSize; }
+
+  //! Get the number of query points in device memory at a time.
+  size_t QueryTileSize() const { return queryTileSize; }
+  //! Modify the number of query points in device memory at a time.
+  size_t& QueryTileSize() { return queryTileSize; }
+
+ private:
+  //! The element type of the device matrices.
+  typedef typename DeviceMatType::elem_type ElemType;
+
+  //! The type of vectors of indices on the device.
+#ifdef HAS_BANDICOOT
+  typedef typename std::conditional<arma::is_arma_type<DeviceMatType>::value,
+      arma::uvec, coot::uvec>::type DeviceIndexType;
+#else
+  typedef arma::uvec DeviceIndexType;
+#endif
+
+  //! Candidate represents a possible candidate neighbor (squared distance,
+  //! index).
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Compare two candidates based on the distance.
+  struct CandidateCmp {
+    bool operator()(const Candidate& c1, const Candidate& c2)
+    {
+      return !SortPolicy::IsBetter(c2.first, c1.first);
+    };
+  };
+
+  //! Use a priority queue to represent the list of candidate neighbors.
+  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
+      CandidateList;
+
+  //! Search the reference set for the query set; if sameSet is true, the
+  //! query set is the reference set and the points themselves are skipped.
+  void SearchImpl(const arma::mat& referenceSet,
+                  const arma::mat& querySet,
+                  const size_t k,
+                  const bool sameSet,
+                  arma::Mat<size_t>& neighbors,
+                  arma::mat& distances) const;
+
+  /**
+   * Select on the device the reference points of a tile that may be
+   * neighbors of each point of a tile of query points, given the products of
+   * the centered points, and evaluate them exactly on the host.
+   */
+  void SearchDeviceTile(const DeviceMatType& products,
+                        const arma::mat& referenceSet,
+                        const arma::mat& querySet,
+                        const arma::rowvec& referenceNorms,
+                        const arma::rowvec& queryNorms,
+                        const double error,
+                        const size_t refBegin,
+                        const size_t queryBegin,
+                        const size_t queryEnd,
+                        const size_t k,
+                        const bool sameSet,
+                        std::vector<CandidateList>& candidates) const;
+
+  //! Copy a matrix to the host (an Armadillo matrix is used as is).
+  static const arma::Mat<ElemType>& ToHost(const arma::Mat<ElemType>& m)
+  {
+    return m;
+  }
+
+  //! Copy a matrix to the host.
+  template<typename OtherMatType>
+  static arma::Mat<ElemType> ToHost(const OtherMatType& m)
+  {
+    return arma::Mat<ElemType>(m);
+  }
+
+  //! Number of reference points in device memory at a time.
+  size_t referenceTileSize;
+  //! Number of query points in device memory at a time.
+  size_t queryTileSize;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "gpu_neighbor_search_impl.hpp"
+
+#endif
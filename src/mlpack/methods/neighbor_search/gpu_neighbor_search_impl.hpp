@@ -0,0 +1,370 @@
+/**
+ * @file methods/neighbor_search/gpu_neighbor_search_impl.hpp
+ *
+ * Implementation of brute-force neighbor search on the GPU.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_GPU_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_GPU_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gpu_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy, typename DeviceMatType>
+GPUNeighborSearch<SortPolicy, DeviceMatType>::GPUNeighborSearch(
+    const size_t referenceTileSize,
+    const size_t queryTileSize) :
+    referenceTileSize(referenceTileSize),
+    queryTileSize(queryTileSize)
+{
+  if (referenceTileSize == 0 || queryTileSize == 0)
+  {
+    throw std::invalid_argument("GPUNeighborSearch: the tile sizes must be "
+        "positive");
+  }
+}
+
+template<typename SortPolicy, typename DeviceMatType>
+void GPUNeighborSearch<SortPolicy, DeviceMatType>::Search(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  SearchImpl(referenceSet, querySet, k, false, neighbors, distances);
+}
+
+template<typename SortPolicy, typename DeviceMatType>
+void GPUNeighborSearch<SortPolicy, DeviceMatType>::Search(
+    const arma::mat& referenceSet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  SearchImpl(referenceSet, referenceSet, k, true, neighbors, distances);
+}
+
+template<typename SortPolicy, typename DeviceMatType>
+void GPUNeighborSearch<SortPolicy, DeviceMatType>::SearchImpl(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    const size_t k,
+    const bool sameSet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::stringstream ss;
+    ss << "GPUNeighborSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // The point itself is not one of its neighbors.
+  const size_t numCandidates = (sameSet && referenceSet.n_cols > 0) ?
+      referenceSet.n_cols - 1 : referenceSet.n_cols;
+  if (k == 0 || k > numCandidates)
+  {
+    std::stringstream ss;
+    ss << "GPUNeighborSearch::Search(): requested value of k (" << k << ") "
+        << "must be positive and at most the number of candidate neighbors ("
+        << numCandidates << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // Center both sets on the mean of the reference set, so that the norms, and
+  // the error of the products, are on the scale of the spread of the points.
+  const arma::vec center = arma::mean(referenceSet, 1);
+
+  // The candidates hold squared distances until the end.
+  std::vector<CandidateList> candidates;
+  candidates.reserve(querySet.n_cols);
+  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
+      size_t() - 1);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    std::vector<Candidate> vect(k, def);
+    candidates.push_back(CandidateList(CandidateCmp(), std::move(vect)));
+  }
+
+  const double epsilon = std::numeric_limits<ElemType>::epsilon();
+  for (size_t refBegin = 0; refBegin < referenceSet.n_cols;
+       refBegin += referenceTileSize)
+  {
+    const size_t refEnd = std::min(refBegin + referenceTileSize,
+        referenceSet.n_cols);
+    const size_t tileSize = refEnd - refBegin;
+
+    // Copy the tile of reference points to the device; it stays there while
+    // all the query points are compared with it.
+    arma::mat centeredReferences = referenceSet.cols(refBegin, refEnd - 1);
+    centeredReferences.each_col() -= center;
+    const arma::rowvec referenceNorms = arma::sum(arma::square(
+        centeredReferences), 0);
+    const DeviceMatType references(
+        arma::conv_to<arma::Mat<ElemType>>::from(centeredReferences));
+
+    for (size_t queryBegin = 0; queryBegin < querySet.n_cols;
+         queryBegin += queryTileSize)
+    {
+      const size_t queryEnd = std::min(queryBegin + queryTileSize,
+          querySet.n_cols);
+
+      arma::mat centeredQueries = querySet.cols(queryBegin, queryEnd - 1);
+      centeredQueries.each_col() -= center;
+      const arma::rowvec queryNorms = arma::sum(arma::square(
+          centeredQueries), 0);
+      const DeviceMatType queries(
+          arma::conv_to<arma::Mat<ElemType>>::from(centeredQueries));
+
+      // The reference points are along the rows, so that the products of each
+      // query point are contiguous.
+      const DeviceMatType products = references.t() * queries;
+
+      // The error of each product is bounded by (dims + 2) * epsilon times the
+      // norms involved (including the rounding to ElemType); be generous with
+      // the constant, as metric::SquaredDistanceBlock() does.
+      const double error = 4 * (referenceSet.n_rows + 4) * epsilon *
+          (referenceNorms.max() + queryNorms.max());
+
+      if (arma::is_arma_type<DeviceMatType>::value)
+      {
+        // The products are already on the host; select the candidates of each
+        // query point there.
+        const arma::Mat<ElemType>& hostProducts = ToHost(products);
+
+        #pragma omp parallel
+        {
+          std::vector<double> pessimisticBounds;
+          if (tileSize > k)
+            pessimisticBounds.reserve(tileSize);
+
+          #pragma omp for schedule(static)
+          for (omp_size_t j = 0; j < (omp_size_t) (queryEnd - queryBegin); ++j)
+          {
+            const size_t queryIndex = queryBegin + (size_t) j;
+            CandidateList& pqueue = candidates[queryIndex];
+            const ElemType* tileProducts = hostProducts.colptr(j);
+
+            // The exact squared distance of each pair lies between lower and
+            // upper; the worst of the two is the pessimistic bound.
+            auto bounds = [&](const size_t i, double& lower, double& upper)
+            {
+              const double d = std::max(queryNorms[j] + referenceNorms[i] -
+                  2 * (double) tileProducts[i], 0.0);
+              lower = std::max(d - error, 0.0);
+              upper = d + error;
+            };
+
+            // Only the points whose optimistic bound is at least as good as the
+            // k'th best pessimistic bound (of the tile, or of the candidates
+            // found so far) can be neighbors; see
+            // NeighborSearchRules::BaseCaseBlock().
+            double bound = pqueue.top().first;
+            if (tileSize > k)
+            {
+              pessimisticBounds.clear();
+              for (size_t i = 0; i < tileSize; ++i)
+              {
+                if (sameSet && (queryIndex == refBegin + i))
+                  continue;
+
+                double lower, upper;
+                bounds(i, lower, upper);
+                pessimisticBounds.push_back(SortPolicy::IsBetter(lower, upper) ?
+                    upper : lower);
+              }
+
+              if (pessimisticBounds.size() >= k)
+              {
+                std::nth_element(pessimisticBounds.begin(),
+                    pessimisticBounds.begin() + (k - 1),
+                    pessimisticBounds.end(),
+                    [](const double a, const double b)
+                    {
+                      return (a != b) && SortPolicy::IsBetter(a, b);
+                    });
+                if (SortPolicy::IsBetter(pessimisticBounds[k - 1], bound))
+                  bound = pessimisticBounds[k - 1];
+              }
+            }
+
+            for (size_t i = 0; i < tileSize; ++i)
+            {
+              const size_t referenceIndex = refBegin + i;
+              if (sameSet && (queryIndex == referenceIndex))
+                continue;
+
+              double lower, upper;
+              bounds(i, lower, upper);
+              const double optimistic = SortPolicy::IsBetter(lower, upper) ?
+                  lower : upper;
+              if ((bound != optimistic) && SortPolicy::IsBetter(bound,
+                  optimistic))
+                continue;
+
+              // Evaluate the remaining points exactly.
+              const Candidate c = std::make_pair(
+                  metric::SquaredEuclideanDistance::Evaluate(
+                  querySet.col(queryIndex), referenceSet.col(referenceIndex)),
+                  referenceIndex);
+              if (CandidateCmp()(c, pqueue.top()))
+              {
+                pqueue.pop();
+                pqueue.push(c);
+              }
+            }
+          }
+        }
+      }
+      else
+      {
+        SearchDeviceTile(products, referenceSet, querySet, referenceNorms,
+            queryNorms, error, refBegin, queryBegin, queryEnd, k, sameSet,
+            candidates);
+      }
+    }
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    CandidateList& pqueue = candidates[i];
+    for (size_t j = 1; j <= k; ++j)
+    {
+      neighbors(k - j, i) = pqueue.top().second;
+      distances(k - j, i) = std::sqrt(pqueue.top().first);
+      pqueue.pop();
+    }
+  }
+}
+
+template<typename SortPolicy, typename DeviceMatType>
+void GPUNeighborSearch<SortPolicy, DeviceMatType>::SearchDeviceTile(
+    const DeviceMatType& products,
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    const arma::rowvec& referenceNorms,
+    const arma::rowvec& queryNorms,
+    const double error,
+    const size_t refBegin,
+    const size_t queryBegin,
+    const size_t queryEnd,
+    const size_t k,
+    const bool sameSet,
+    std::vector<CandidateList>& candidates) const
+{
+  const size_t tileSize = products.n_rows;
+  const size_t numQueries = queryEnd - queryBegin;
+  const bool smallerIsBetter = SortPolicy::IsBetter(0.0, 1.0);
+
+  // The approximate squared distances of the tile.  They are summed in
+  // ElemType on the device, which at most doubles the error.
+  const double deviceError = 2 * error;
+  const DeviceMatType tileDistances =
+      repmat(DeviceMatType(arma::conv_to<arma::Mat<ElemType>>::from(
+      referenceNorms.t())), 1, numQueries) +
+      repmat(DeviceMatType(arma::conv_to<arma::Mat<ElemType>>::from(
+      queryNorms)), tileSize, 1) - ElemType(2) * products;
+
+  // Sort the distances of each query point on the device, and only copy back
+  // the distance at the given rank: the k'th best, or the (k + 1)'th best if
+  // the query point itself may be in the tile.
+  const size_t rank = sameSet ? k : k - 1;
+  arma::Mat<ElemType> tileBounds;
+  if (rank < tileSize)
+  {
+    const DeviceMatType sortedDistances = sort(tileDistances,
+        smallerIsBetter ? "ascend" : "descend", 0);
+    tileBounds = ToHost(DeviceMatType(sortedDistances.row(rank)));
+  }
+
+  // Only the points whose optimistic bound is at least as good as the k'th
+  // best pessimistic bound (of the tile, or of the candidates found so far)
+  // can be neighbors; see NeighborSearchRules::BaseCaseBlock().  This gives a
+  // threshold on the approximate distances of each query point, which is
+  // rounded outwards to ElemType.
+  const double limit = std::numeric_limits<ElemType>::max();
+  arma::Mat<ElemType> thresholds(1, numQueries);
+  for (size_t j = 0; j < numQueries; ++j)
+  {
+    double bound = candidates[queryBegin + j].top().first;
+    if (rank < tileSize)
+    {
+      const double tileBound = smallerIsBetter ?
+          tileBounds[j] + deviceError : tileBounds[j] - deviceError;
+      if (SortPolicy::IsBetter(tileBound, bound))
+        bound = tileBound;
+    }
+
+    const double threshold = smallerIsBetter ? bound + deviceError :
+        bound - deviceError;
+    thresholds[j] = std::nextafter((ElemType) std::max(std::min(threshold,
+        limit), -limit), (ElemType) (smallerIsBetter ? limit : -limit));
+  }
+
+  // Select the points under the threshold on the device; only their indices
+  // in the tile (about k per query point) are copied back.
+  const DeviceMatType deviceThresholds(thresholds);
+  DeviceIndexType selected;
+  if (smallerIsBetter)
+    selected = find(tileDistances <= repmat(deviceThresholds, tileSize, 1));
+  else
+    selected = find(tileDistances >= repmat(deviceThresholds, tileSize, 1));
+  const arma::Mat<typename DeviceIndexType::elem_type> hostSelected(selected);
+
+  // Group the selected points by query point (column of the tile).
+  std::vector<size_t> offsets(numQueries + 1, 0);
+  for (size_t i = 0; i < hostSelected.n_elem; ++i)
+    ++offsets[(size_t) hostSelected[i] / tileSize + 1];
+  for (size_t j = 0; j < numQueries; ++j)
+    offsets[j + 1] += offsets[j];
+
+  std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+  std::vector<size_t> selectedPoints(hostSelected.n_elem);
+  for (size_t i = 0; i < hostSelected.n_elem; ++i)
+  {
+    const size_t index = (size_t) hostSelected[i];
+    selectedPoints[positions[index / tileSize]++] = index % tileSize;
+  }
+
+  // Evaluate the selected points exactly.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) numQueries; ++j)
+  {
+    const size_t queryIndex = queryBegin + (size_t) j;
+    CandidateList& pqueue = candidates[queryIndex];
+    for (size_t i = offsets[j]; i < offsets[j + 1]; ++i)
+    {
+      const size_t referenceIndex = refBegin + selectedPoints[i];
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      const Candidate c = std::make_pair(
+          metric::SquaredEuclideanDistance::Evaluate(
+          querySet.col(queryIndex), referenceSet.col(referenceIndex)),
+          referenceIndex);
+      if (CandidateCmp()(c, pqueue.top()))
+      {
+        pqueue.pop();
+        pqueue.push(c);
+      }
+    }
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -110,10 +110,17 @@ PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
     "'dual_tree', 'greedy'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate furthest neighbor"
     " search with given relative error. Must be in the range [0,1).", "e", 0);
+PARAM_FLAG("parallel_queries", "If set, naive and single-tree searches are "
+    "run over blocks of query points in parallel (if OpenMP is available).",
+    "P");
 PARAM_DOUBLE_IN("percentage", "If specified, will do approximate furthest "
     "neighbor search. Must be in the range (0,1] (decimal form). Resultant "
     "neighbors will be at least (p*100) % of the distance as the true furthest "
     "neighbor.", "p", 1);
+PARAM_STRING_IN("reference_map_file", "If specified, the reference set of the "
+    "output model is written to this file and the output model is saved "
+    "without it; loading that model later memory-maps the reference set from "
+    "this file.", "f", "");
 
 static void mlpackMain()
 {
@@ -127,6 +134,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "output_model", false }}, "reference_map_file");
 
   // Notify the user of parameters that will be only be considered for query
   // tree.
@@ -267,6 +275,9 @@ static void mlpackMain()
         << " dataset)." << endl;
   }
 
+  // Searching in parallel is a property of this run, not of the model.
+  kfn->ParallelQueries() = IO::HasParam("parallel_queries");
+
   // Perform search, if desired.
   if (IO::HasParam("k"))
   {
@@ -380,5 +391,9 @@ static void mlpackMain()
     IO::GetParam<arma::mat>("distances") = std::move(distances);
   }
 
+  // Write the reference set to a file that can be memory-mapped, if desired.
+  if (IO::HasParam("reference_map_file"))
+    kfn->MapReferenceSet(IO::GetParam<std::string>("reference_map_file"));
+
   IO::GetParam<KFNModel*>("output_model") = kfn;
 }
@@ -50,7 +50,31 @@ BINDING_LONG_DESC(
     "points using kd-trees or cover trees (cover tree support is experimental "
     "and may be slow). You may specify a separate set of "
     "reference points and query points, or just a reference set which will be "
-    "used as both the reference and query set.");
+    "used as both the reference and query set."
+    "\n\n"
+    "For high-dimensional data (more than about 50 dimensions), trees prune "
+    "little, and the naive algorithm (with 'naive' for " +
+    PRINT_PARAM_STRING("algorithm") + ") is usually the fastest: it computes "
+    "the distances between blocks of query and reference points with matrix "
+    "products, and with " + PRINT_PARAM_STRING("parallel_queries") + " the "
+    "blocks of query points are searched in parallel."
+    "\n\n"
+    "With 'gpu' for " + PRINT_PARAM_STRING("algorithm") + ", the search is a "
+    "brute-force search on the GPU (if mlpack was built with Bandicoot; "
+    "otherwise the same tiled computation runs on the CPU), which is usually "
+    "the fastest for large sets of dense, high-dimensional points.  The "
+    "reference set is streamed through the memory of the GPU in tiles of " +
+    PRINT_PARAM_STRING("gpu_tile_size") + " points, so it may be larger than "
+    "the memory of the GPU.  A model given with " +
+    PRINT_PARAM_STRING("input_model") + " must have been built with 'naive' or "
+    "'gpu' for " + PRINT_PARAM_STRING("algorithm") + "."
+    "\n\n"
+    "By default (with 'auto' for " + PRINT_PARAM_STRING("tree_type") + " and " +
+    PRINT_PARAM_STRING("algorithm") + "), the tree type, the algorithm and the "
+    "leaf size (unless " + PRINT_PARAM_STRING("leaf_size") + " is given) are "
+    "chosen by estimating the intrinsic dimensionality of the reference set "
+    "and timing the candidates on samples of the reference and query sets.  "
+    "The choice is saved in the output model.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -101,9 +125,9 @@ PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 
 // The user may specify the type of tree to use, and a few parameters for tree
 // building.
-PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
-    "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'spill', 'oct'.", "t", "kd");
+PARAM_STRING_IN("tree_type", "Type of tree to use: 'auto', 'kd', 'vp', 'rp', "
+    "'max-rp', 'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', "
+    "'r-plus', 'r-plus-plus', 'spill', 'oct'.", "t", "auto");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, vp "
     "trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, spill trees, and octrees).", "l",
@@ -118,10 +142,19 @@ PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
-PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
-    "'dual_tree', 'greedy'.", "a", "dual_tree");
+PARAM_STRING_IN("algorithm", "Type of neighbor search: 'auto', 'naive', "
+    "'single_tree', 'dual_tree', 'greedy', 'gpu'.", "a", "auto");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_FLAG("parallel_queries", "If set, naive and single-tree searches are "
+    "run over blocks of query points in parallel (if OpenMP is available).",
+    "P");
+PARAM_INT_IN("gpu_tile_size", "Number of reference points in GPU memory at a "
+    "time (only valid for the 'gpu' algorithm).", "", 16384);
+PARAM_STRING_IN("reference_map_file", "If specified, the reference set of the "
+    "output model is written to this file and the output model is saved "
+    "without it; loading that model later memory-maps the reference set from "
+    "this file.", "f", "");
 
 static void mlpackMain()
 {
@@ -137,6 +170,7 @@ static void mlpackMain()
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
   ReportIgnoredParam({{ "input_model", true }}, "tau");
   ReportIgnoredParam({{ "input_model", true }}, "rho");
+  ReportIgnoredParam({{ "output_model", false }}, "reference_map_file");
   if (IO::HasParam("input_model") && IO::HasParam("leaf_size"))
   {
     Log::Warn << PRINT_PARAM_STRING("leaf_size") << " will only be considered"
@@ -193,8 +227,24 @@ static void mlpackMain()
   KNNModel* knn;
 
   const string algorithm = IO::GetParam<string>("algorithm");
-  RequireParamInSet<string>("algorithm", { "naive", "single_tree", "dual_tree",
-      "greedy" }, true, "unknown neighbor search algorithm");
+  RequireParamInSet<string>("algorithm", { "auto", "naive", "single_tree",
+      "dual_tree", "greedy", "gpu" }, true,
+      "unknown neighbor search algorithm");
+
+  // Sanity check on the GPU tile size.
+  if (algorithm == "gpu")
+  {
+    RequireParamValue<int>("gpu_tile_size", [](int x) { return x > 0; },
+        true, "GPU tile size must be positive");
+#ifndef HAS_BANDICOOT
+    Log::Warn << "mlpack was built without Bandicoot; the 'gpu' algorithm "
+        << "will run on the CPU." << endl;
+#endif
+  }
+  else
+  {
+    ReportIgnoredParam("gpu_tile_size", "the 'gpu' algorithm is not used");
+  }
   NeighborSearchMode searchMode = DUAL_TREE_MODE;
 
   if (algorithm == "naive")
@@ -205,6 +255,8 @@ static void mlpackMain()
     searchMode = DUAL_TREE_MODE;
   else if (algorithm == "greedy")
     searchMode = GREEDY_SINGLE_TREE_MODE;
+  else if (algorithm == "gpu")
+    searchMode = NAIVE_MODE; // The GPU engine searches the unmodified set.
 
   if (IO::HasParam("reference"))
   {
@@ -213,9 +265,9 @@ static void mlpackMain()
     const bool randomBasis = IO::HasParam("random_basis");
 
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
-    RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
-        "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
+    RequireParamInSet<string>("tree_type", { "auto", "kd", "cover", "r",
+        "r-star", "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill",
+        "vp", "rp", "max-rp", "ub", "oct" }, true, "unknown tree type");
 
     knn = new KNNModel();
 
@@ -261,7 +313,31 @@ static void mlpackMain()
 
     arma::mat referenceSet = std::move(IO::GetParam<arma::mat>("reference"));
 
-    knn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
+    // Choose the settings given as 'auto' (and the leaf size with them, if it
+    // is not given).
+    int settings = 0;
+    if (treeType == "auto" && algorithm != "gpu")
+      settings |= KNNModel::SELECT_TREE_TYPE;
+    if (algorithm == "auto")
+      settings |= KNNModel::SELECT_SEARCH_MODE;
+    if (settings != 0 && !IO::HasParam("leaf_size"))
+      settings |= KNNModel::SELECT_LEAF_SIZE;
+    if (settings != 0)
+    {
+      const arma::mat noQuerySet;
+      const arma::mat& querySet = (IO::HasParam("k") && IO::HasParam("query")) ?
+          IO::GetParam<arma::mat>("query") : noQuerySet;
+      const size_t k = IO::HasParam("k") ? (size_t) IO::GetParam<int>("k") : 1;
+      if (querySet.is_empty() || querySet.n_rows == referenceSet.n_rows)
+      {
+        Timer::Start("engine_selection");
+        searchMode = knn->SelectEngine(referenceSet, querySet, k, epsilon,
+            searchMode, settings);
+        Timer::Stop("engine_selection");
+      }
+    }
+
+    knn->BuildModel(std::move(referenceSet), knn->LeafSize(), searchMode,
         epsilon);
   }
   else
@@ -269,8 +345,16 @@ static void mlpackMain()
     // Load the model from file.
     knn = IO::GetParam<KNNModel*>("input_model");
 
-    // Adjust search mode.
-    knn->SearchMode() = searchMode;
+    // Adjust search mode, unless the one of the model is kept.
+    if (algorithm == "gpu" && knn->SearchMode() != NAIVE_MODE)
+    {
+      Log::Fatal << "The 'gpu' algorithm needs a model built with the 'naive' "
+          << "or 'gpu' algorithm." << endl;
+    }
+    else if (algorithm != "auto")
+    {
+      knn->SearchMode() = searchMode;
+    }
     knn->Epsilon() = epsilon;
 
     // If leaf_size wasn't provided, let's consider the current value in the
@@ -285,6 +369,12 @@ static void mlpackMain()
         << " dataset)." << endl;
   }
 
+  // Searching in parallel or on the GPU is a property of this run, not of the
+  // model.
+  knn->ParallelQueries() = IO::HasParam("parallel_queries");
+  knn->GPUSearch() = (algorithm == "gpu");
+  knn->GPUTileSize() = (size_t) IO::GetParam<int>("gpu_tile_size");
+
   // Perform search, if desired.
   if (IO::HasParam("k"))
   {
@@ -396,5 +486,9 @@ static void mlpackMain()
     IO::GetParam<arma::mat>("distances") = std::move(distances);
   }
 
+  // Write the reference set to a file that can be memory-mapped, if desired.
+  if (IO::HasParam("reference_map_file"))
+    knn->MapReferenceSet(IO::GetParam<std::string>("reference_map_file"));
+
   IO::GetParam<KNNModel*>("output_model") = knn;
 }
@@ -21,6 +21,9 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
 
+#include <mlpack/core/tree/parallel_query_blocks.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
 #include "neighbor_search_rules.hpp"
@@ -30,9 +33,28 @@ namespace mlpack {
 // all-furthest-neighbors searches.
 namespace neighbor  {
 
-// Forward declaration.
+// Forward declarations.
 template<typename SortPolicy>
 class TrainVisitor;
+template<typename SortPolicy>
+class InsertPointsVisitor;
+template<typename SortPolicy>
+class DeletePointsVisitor;
+
+HAS_MEM_FUNC(Insert, HasInsertCheck);
+
+/**
+ * Whether or not points can be inserted into and removed from a tree of the
+ * given type in place, with the Insert() and Delete() methods of the
+ * BinarySpaceTree.
+ */
+template<typename TreeType, typename MatType>
+struct SupportsIncrementalUpdates
+{
+  static const bool value = HasInsertCheck<TreeType,
+      void(TreeType::*)(const MatType&, std::vector<size_t>&, const size_t)
+  >::value;
+};
 
 //! NeighborSearchMode represents the different neighbor search modes available.
 enum NeighborSearchMode
@@ -206,6 +228,49 @@ class NeighborSearch
    */
   void Train(Tree referenceTree);
 
+  /**
+   * Use the given reference tree without copying it or taking ownership of it,
+   * so that several objects (or several algorithms, see tree::TreeCache) can
+   * share one tree.  The tree must stay valid as long as this object uses it.
+   * The statistics of the tree are reset before they are used, since other
+   * objects may have modified them.  Insert() and Delete() copy the tree first.
+   *
+   * @param referenceTree Pre-built tree for reference points.
+   * @param oldFromNewReferences Mapping of the points of the tree's dataset to
+   *     the original reference set, as filled by the tree constructor; if it is
+   *     empty, the results are given in the order of the tree's dataset.
+   */
+  void Train(Tree* referenceTree,
+             const std::vector<size_t>& oldFromNewReferences);
+
+  /**
+   * Add the given points to the reference set.  The new points get the
+   * indices that follow the current reference points, as if they had been
+   * appended to the reference set.  If the reference tree can be updated in
+   * place (like every BinarySpaceTree), the points are inserted into the
+   * existing tree, whose leaves are split again when they get more than
+   * leafSize points; otherwise the reference tree is rebuilt with its default
+   * parameters.
+   *
+   * @param points Points to add to the reference set.
+   * @param leafSize Maximum number of points in a leaf of the reference tree
+   *      (only used if the tree is updated in place).
+   */
+  void Insert(const MatType& points, const size_t leafSize = 20);
+
+  /**
+   * Remove the reference points with the given indices from the reference set.
+   * The remaining points are renumbered as if the given points had been shed
+   * from the reference set.  If the reference tree can be updated in place
+   * (like every BinarySpaceTree), the points are removed from the existing
+   * tree; otherwise the reference tree is rebuilt with its default parameters.
+   *
+   * @param indices Indices of the reference points to remove.
+   * @param leafSize Maximum number of points in a leaf of the reference tree
+   *      (only used if the tree is updated in place).
+   */
+  void Delete(const std::vector<size_t>& indices, const size_t leafSize = 20);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -272,6 +337,50 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * For each point in the query set, compute the nearest neighbors, but give
+   * the results to the given callback one block of query points at a time
+   * instead of storing them for the whole query set.  The query points are
+   * searched in blocks of blockSize points (with the search mode of this
+   * object), and as soon as a block is finished its results are final and
+   * they are passed to
+   *
+   * @code
+   * callback(begin, neighbors, distances);
+   * @endcode
+   *
+   * where neighbors and distances have k rows and one column per query point
+   * of the block, for the query points begin, begin + 1, ...  The blocks are
+   * given in order.  This caps the memory used by the results, so that huge
+   * searches can, for instance, write their results to disk as they go.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param callback Function to call with the results of each block.
+   * @param blockSize Number of query points in each block.
+   */
+  template<typename CallbackType>
+  void Search(const MatType& querySet,
+              const size_t k,
+              CallbackType&& callback,
+              const size_t blockSize = 65536);
+
+  /**
+   * Search for the nearest neighbors of every point in the reference set (like
+   * Search(k, neighbors, distances)), but give the results to the given
+   * callback one block of points at a time (see the overload above).  Each
+   * block is searched with one extra neighbor, and the point itself is then
+   * removed from its results.
+   *
+   * @param k Number of neighbors to search for.
+   * @param callback Function to call with the results of each block.
+   * @param blockSize Number of points in each block.
+   */
+  template<typename CallbackType>
+  void Search(const size_t k,
+              CallbackType&& callback,
+              const size_t blockSize = 65536);
+
   /**
    * Calculate the average relative error (effective error) between the
    * distances calculated and the true distances provided.  The input matrices
@@ -321,6 +430,17 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  /**
+   * Access whether naive, single-tree and greedy single-tree searches are run
+   * in parallel over blocks of query points.  Each thread then uses its own
+   * copy of the rules, so memory usage grows with the number of threads.  Trees
+   * with self-children (like the cover tree) cache base cases in the reference
+   * tree, so single-tree searches with those trees are always serial.
+   */
+  bool ParallelQueries() const { return parallelQueries; }
+  //! Modify whether queries are searched in parallel blocks.
+  bool& ParallelQueries() { return parallelQueries; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -346,6 +466,10 @@ class NeighborSearch
   //! Indicates the relative error to be considered in approximate search.
   double epsilon;
 
+  //! If true, naive and single-tree searches are run over query blocks in
+  //! parallel.
+  bool parallelQueries;
+
   //! Instantiation of metric.
   MetricType metric;
 
@@ -358,9 +482,37 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! If true, we own the reference tree (and delete it); otherwise it was
+  //! given with Train(Tree*, ...) and may be shared with other objects.
+  bool treeOwner;
+
+  //! If the reference tree is shared, copy it so that it can be modified.
+  void OwnReferenceTree();
+
+  //! Return the reference set, with its points in their original order.
+  MatType OriginalReferenceSet() const;
+  //! Return the reference set without the points with the given indices, in
+  //! the original order.
+  MatType RemainingReferenceSet(const std::vector<size_t>& indices) const;
+
+  /**
+   * Run the naive search for the query points [begin, end) with the given
+   * rules.  Blocks of query points are compared with blocks of reference points
+   * with RuleType::BaseCaseBlock(), so that the distances of each pair of
+   * blocks are computed with one (dense or sparse) matrix product.
+   */
+  template<typename RuleType>
+  void NaiveSearchBlock(RuleType& rules,
+                        const size_t begin,
+                        const size_t end) const;
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
+  template<typename SortPol>
+  friend class InsertPointsVisitor;
+  template<typename SortPol>
+  friend class DeletePointsVisitor;
 }; // class NeighborSearch
 
 } // namespace neighbor
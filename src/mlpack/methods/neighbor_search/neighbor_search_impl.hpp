@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
@@ -45,6 +46,120 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Insert points into a tree that can be updated in place.
+template<typename TreeType, typename MatType>
+bool InsertIntoTree(
+    TreeType& tree,
+    const MatType& points,
+    std::vector<size_t>& oldFromNew,
+    const size_t leafSize,
+    const typename std::enable_if_t<
+        SupportsIncrementalUpdates<TreeType, MatType>::value
+    >* = 0)
+{
+  // A tree that was given to Train() has no mapping yet; its points keep the
+  // indices they have in the tree.
+  if (oldFromNew.empty())
+  {
+    oldFromNew.resize(tree.Dataset().n_cols);
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+      oldFromNew[i] = i;
+  }
+
+  tree.Insert(points, oldFromNew, leafSize);
+  return true;
+}
+
+//! Other trees have to be rebuilt.
+template<typename TreeType, typename MatType>
+bool InsertIntoTree(
+    TreeType& /* tree */,
+    const MatType& /* points */,
+    std::vector<size_t>& /* oldFromNew */,
+    const size_t /* leafSize */,
+    const typename std::enable_if_t<
+        !SupportsIncrementalUpdates<TreeType, MatType>::value
+    >* = 0)
+{
+  return false;
+}
+
+//! Traverse the reference tree with the query points [begin, end), one at a
+//! time.
+template<typename TreeType, typename TraverserType>
+void TraverseQueries(
+    TraverserType& traverser,
+    TreeType& referenceTree,
+    const size_t begin,
+    const size_t end,
+    const typename std::enable_if_t<!tree::IsSpillTree<TreeType>::value>* = 0)
+{
+  for (size_t i = begin; i < end; ++i)
+    traverser.Traverse(i, referenceTree);
+}
+
+//! Traverse a spill tree with the query points [begin, end) all at once, so
+//! that the query points that reach the same leaf are compared with its points
+//! in one block.
+template<typename TreeType, typename TraverserType>
+void TraverseQueries(
+    TraverserType& traverser,
+    TreeType& referenceTree,
+    const size_t begin,
+    const size_t end,
+    const typename std::enable_if_t<tree::IsSpillTree<TreeType>::value>* = 0)
+{
+  std::vector<size_t> queryIndices(end - begin);
+  for (size_t i = begin; i < end; ++i)
+    queryIndices[i - begin] = i;
+
+  traverser.Traverse(queryIndices, referenceTree);
+}
+
+//! Remove the points with the given original indices from a tree that can be
+//! updated in place.
+template<typename TreeType>
+bool DeleteFromTree(
+    TreeType& tree,
+    const std::vector<size_t>& indices,
+    std::vector<size_t>& oldFromNew,
+    const size_t leafSize,
+    const typename std::enable_if_t<SupportsIncrementalUpdates<TreeType,
+        typename TreeType::Mat>::value>* = 0)
+{
+  if (oldFromNew.empty())
+  {
+    oldFromNew.resize(tree.Dataset().n_cols);
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+      oldFromNew[i] = i;
+  }
+
+  // The tree removes columns of its dataset.
+  std::vector<size_t> newFromOld(oldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    newFromOld[oldFromNew[i]] = i;
+
+  std::vector<size_t> points(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+    points[i] = newFromOld[indices[i]];
+
+  tree.Delete(points, oldFromNew, leafSize);
+  return true;
+}
+
+//! Other trees have to be rebuilt.
+template<typename TreeType>
+bool DeleteFromTree(
+    TreeType& /* tree */,
+    const std::vector<size_t>& /* indices */,
+    std::vector<size_t>& /* oldFromNew */,
+    const size_t /* leafSize */,
+    const typename std::enable_if_t<!SupportsIncrementalUpdates<TreeType,
+        typename TreeType::Mat>::value>* = 0)
+{
+  return false;
+}
+
 // Construct the object.
 template<typename SortPolicy,
          typename MetricType,
@@ -65,10 +180,12 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
         &referenceTree->Dataset()),
     searchMode(mode),
     epsilon(epsilon),
+    parallelQueries(false),
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    treeOwner(true)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -92,10 +209,12 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     referenceSet(&this->referenceTree->Dataset()),
     searchMode(mode),
     epsilon(epsilon),
+    parallelQueries(false),
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    treeOwner(true)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -118,10 +237,12 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     referenceSet(mode == NAIVE_MODE ? new MatType() : NULL), // Empty matrix.
     searchMode(mode),
     epsilon(epsilon),
+    parallelQueries(false),
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    treeOwner(true)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -129,7 +250,7 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
   // Build the tree on the empty dataset, if necessary.
   if (mode != NAIVE_MODE)
   {
-    referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+    referenceTree = BuildTree<Tree>(std::move(MatType()),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
   }
@@ -147,15 +268,18 @@ template<typename SortPolicy,
 NeighborSearch<SortPolicy, MetricType, MatType, TreeType, DualTreeTraversalType,
 SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     oldFromNewReferences(other.oldFromNewReferences),
-    referenceTree(other.referenceTree ? new Tree(*other.referenceTree) : NULL),
+    referenceTree(!other.referenceTree ? NULL : (other.treeOwner ?
+        new Tree(*other.referenceTree) : other.referenceTree)),
     referenceSet(other.referenceTree ? &referenceTree->Dataset() :
         new MatType(*other.referenceSet)),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    parallelQueries(other.parallelQueries),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    treeOwner(other.treeOwner)
 {
   // Nothing else to do.
 }
@@ -176,10 +300,12 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     referenceSet(other.referenceSet),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    parallelQueries(other.parallelQueries),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    treeNeedsReset(other.treeNeedsReset),
+    treeOwner(other.treeOwner)
 {
   // Clear the other model.
   other.referenceTree = BuildTree<Tree>(std::move(MatType()),
@@ -187,9 +313,11 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.parallelQueries = false;
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.treeOwner = true;
 }
 
 // Copy operator.
@@ -219,20 +347,28 @@ NeighborSearch<SortPolicy,
 
   // Clean memory first.
   if (referenceTree)
-    delete referenceTree;
+  {
+    if (treeOwner)
+      delete referenceTree;
+  }
   else
+  {
     delete referenceSet;
+  }
 
   oldFromNewReferences = other.oldFromNewReferences;
-  referenceTree = other.referenceTree ? new Tree(*other.referenceTree) : NULL;
+  referenceTree = !other.referenceTree ? NULL : (other.treeOwner ?
+      new Tree(*other.referenceTree) : other.referenceTree);
   referenceSet = other.referenceTree ? &referenceTree->Dataset() :
       new MatType(*other.referenceSet);
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  parallelQueries = other.parallelQueries;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = false;
+  treeOwner = other.treeOwner;
 }
 
 // Move operator.
@@ -262,32 +398,41 @@ NeighborSearch<SortPolicy,
 
   // Clean memory first.
   if (referenceTree)
-    delete referenceTree;
+  {
+    if (treeOwner)
+      delete referenceTree;
+  }
   else
+  {
     delete referenceSet;
+  }
 
   oldFromNewReferences = std::move(other.oldFromNewReferences);
   referenceTree = other.referenceTree;
   referenceSet = other.referenceSet;
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  parallelQueries = other.parallelQueries;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = other.treeNeedsReset;
+  treeOwner = other.treeOwner;
 
   // Reset the other object.  Clean memory if needed.
   if (!other.referenceTree)
     delete other.referenceSet;
 
-  other.referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+  other.referenceTree = BuildTree<Tree>(std::move(MatType()),
       other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
+  other.parallelQueries = false;
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.treeOwner = true;
 }
 
 // Clean memory.
@@ -303,9 +448,14 @@ NeighborSearch<SortPolicy, MetricType, MatType, TreeType, DualTreeTraversalType,
 SingleTreeTraversalType>::~NeighborSearch()
 {
   if (referenceTree)
-    delete referenceTree;
+  {
+    if (treeOwner)
+      delete referenceTree;
+  }
   else
+  {
     delete referenceSet;
+  }
 }
 
 template<typename SortPolicy,
@@ -323,8 +473,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   if (referenceTree)
   {
     oldFromNewReferences.clear();
-    delete referenceTree;
+    if (treeOwner)
+      delete referenceTree;
     referenceTree = NULL;
+    treeOwner = true;
   }
   else
   {
@@ -362,7 +514,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
   if (this->referenceTree)
   {
     oldFromNewReferences.clear();
-    delete this->referenceTree;
+    if (treeOwner)
+      delete this->referenceTree;
   }
   else
   {
@@ -371,6 +524,215 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 
   this->referenceTree = new Tree(std::move(referenceTree));
   this->referenceSet = &this->referenceTree->Dataset();
+  treeOwner = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Train(
+    Tree* referenceTree,
+    const std::vector<size_t>& oldFromNewReferences)
+{
+  if (searchMode == NAIVE_MODE)
+    throw std::invalid_argument("cannot train on given reference tree when "
+        "naive search (without trees) is desired");
+
+  if (this->referenceTree)
+  {
+    if (treeOwner)
+      delete this->referenceTree;
+  }
+  else
+  {
+    delete this->referenceSet;
+  }
+
+  this->referenceTree = referenceTree;
+  this->referenceSet = &referenceTree->Dataset();
+  this->oldFromNewReferences = oldFromNewReferences;
+  treeOwner = false;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::OwnReferenceTree()
+{
+  if (referenceTree && !treeOwner)
+  {
+    referenceTree = new Tree(*referenceTree);
+    referenceSet = &referenceTree->Dataset();
+    treeOwner = true;
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(const MatType& points,
+                                                        const size_t leafSize)
+{
+  if (points.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Insert(): dimensionality of points ("
+        << points.n_rows << ") does not match dimensionality of reference set ("
+        << referenceSet->n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // A shared tree can't be modified.
+  OwnReferenceTree();
+  if (searchMode != NAIVE_MODE && InsertIntoTree(*referenceTree, points,
+      oldFromNewReferences, leafSize))
+  {
+    referenceSet = &referenceTree->Dataset();
+    return;
+  }
+
+  // Otherwise, start again from the full reference set.
+  Train(MatType(arma::join_rows(OriginalReferenceSet(), points)));
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Delete(
+    const std::vector<size_t>& indices,
+    const size_t leafSize)
+{
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    if (indices[i] >= referenceSet->n_cols)
+    {
+      std::ostringstream oss;
+      oss << "NeighborSearch::Delete(): reference point " << indices[i]
+          << " does not exist (the reference set has " << referenceSet->n_cols
+          << " points)";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  // A shared tree can't be modified.
+  OwnReferenceTree();
+  if (searchMode != NAIVE_MODE && DeleteFromTree(*referenceTree, indices,
+      oldFromNewReferences, leafSize))
+  {
+    referenceSet = &referenceTree->Dataset();
+    return;
+  }
+
+  // Otherwise, start again from the remaining reference points.
+  Train(RemainingReferenceSet(indices));
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+MatType NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::OriginalReferenceSet() const
+{
+  if (oldFromNewReferences.empty())
+    return *referenceSet;
+
+  MatType originalSet(referenceSet->n_rows, referenceSet->n_cols);
+  for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+    originalSet.col(oldFromNewReferences[i]) = referenceSet->col(i);
+
+  return originalSet;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+MatType NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RemainingReferenceSet(
+    const std::vector<size_t>& indices) const
+{
+  std::vector<bool> removed(referenceSet->n_cols, false);
+  for (size_t i = 0; i < indices.size(); ++i)
+    removed[indices[i]] = true;
+
+  std::vector<arma::uword> kept;
+  for (size_t i = 0; i < removed.size(); ++i)
+    if (!removed[i])
+      kept.push_back(i);
+
+  const arma::uvec keptCols(kept);
+  return OriginalReferenceSet().cols(keptCols);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NaiveSearchBlock(
+    RuleType& rules,
+    const size_t begin,
+    const size_t end) const
+{
+  // Limit the size of the blocks of distances (256 x 1024 elements).
+  const size_t queryBlockSize = 256;
+  const size_t referenceBlockSize = 1024;
+
+  std::vector<size_t> queryIndices;
+  for (size_t queryBegin = begin; queryBegin < end;
+       queryBegin += queryBlockSize)
+  {
+    const size_t queryEnd = std::min(queryBegin + queryBlockSize, end);
+    queryIndices.resize(queryEnd - queryBegin);
+    for (size_t i = queryBegin; i < queryEnd; ++i)
+      queryIndices[i - queryBegin] = i;
+
+    for (size_t refBegin = 0; refBegin < referenceSet->n_cols;
+         refBegin += referenceBlockSize)
+    {
+      const size_t refEnd = std::min(refBegin + referenceBlockSize,
+          (size_t) referenceSet->n_cols);
+      rules.BaseCaseBlock(queryIndices, refBegin, refEnd);
+    }
+  }
 }
 
 /**
@@ -441,9 +803,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
       // The naive brute-force traversal.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+      tree::ParallelQueryBlocks(rules, querySet.n_cols, parallelQueries,
+          [this](RuleType& blockRules, const size_t begin, const size_t end)
+          {
+            NaiveSearchBlock(blockRules, begin, end);
+          });
 
       baseCases += querySet.n_cols * referenceSet->n_cols;
 
@@ -455,12 +819,22 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Now have it traverse for each point.  Trees with self-children cache
+      // base cases in the reference nodes, so they can't be shared by threads.
+      tree::TraversalStatistics statistics;
+      tree::ParallelQueryBlocks(rules, querySet.n_cols, parallelQueries &&
+          !tree::TreeTraits<Tree>::HasSelfChildren,
+          [this, &statistics](RuleType& blockRules, const size_t begin,
+                              const size_t end)
+          {
+            SingleTreeTraversalType<RuleType> traverser(blockRules);
+            tree::TraversalStatistics blockStatistics;
+            tree::CollectTraversalStatistics(traverser, blockStatistics);
+            TraverseQueries(traverser, *referenceTree, begin, end);
+
+            #pragma omp critical(NeighborSearchStatistics)
+            statistics += blockStatistics;
+          });
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -469,6 +843,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      statistics.Print();
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -487,6 +862,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // Create the traverser.
       DualTreeTraversalType<RuleType> traverser(rules);
+      tree::TraversalStatistics statistics;
+      tree::CollectTraversalStatistics(traverser, statistics);
 
       traverser.Traverse(*queryTree, *referenceTree);
 
@@ -497,6 +874,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      statistics.Print();
 
       rules.GetResults(*neighborPtr, *distancePtr);
 
@@ -508,12 +886,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric);
 
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
       // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      tree::ParallelQueryBlocks(rules, querySet.n_cols, parallelQueries &&
+          !tree::TreeTraits<Tree>::HasSelfChildren,
+          [this](RuleType& blockRules, const size_t begin, const size_t end)
+          {
+            tree::GreedySingleTreeTraverser<Tree, RuleType>
+                traverser(blockRules);
+            for (size_t i = begin; i < end; ++i)
+              traverser.Traverse(i, *referenceTree);
+          });
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -643,6 +1025,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   // Create the traverser.
   DualTreeTraversalType<RuleType> traverser(rules);
+  tree::TraversalStatistics statistics;
+  tree::CollectTraversalStatistics(traverser, statistics);
   traverser.Traverse(queryTree, *referenceTree);
 
   scores += rules.Scores();
@@ -650,6 +1034,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
   Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  statistics.Print();
 
   rules.GetResults(*neighborPtr, distances);
 
@@ -735,21 +1120,33 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     case NAIVE_MODE:
     {
       // The naive brute-force solution.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+      tree::ParallelQueryBlocks(rules, referenceSet->n_cols, parallelQueries,
+          [this](RuleType& blockRules, const size_t begin, const size_t end)
+          {
+            NaiveSearchBlock(blockRules, begin, end);
+          });
 
       baseCases += referenceSet->n_cols * referenceSet->n_cols;
       break;
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Now have it traverse for each point.  Trees with self-children cache
+      // base cases in the reference nodes, so they can't be shared by threads.
+      tree::TraversalStatistics statistics;
+      tree::ParallelQueryBlocks(rules, referenceSet->n_cols, parallelQueries &&
+          !tree::TreeTraits<Tree>::HasSelfChildren,
+          [this, &statistics](RuleType& blockRules, const size_t begin,
+                              const size_t end)
+          {
+            SingleTreeTraversalType<RuleType> traverser(blockRules);
+            tree::TraversalStatistics blockStatistics;
+            tree::CollectTraversalStatistics(traverser, blockStatistics);
+            TraverseQueries(traverser, *referenceTree, begin, end);
+
+            #pragma omp critical(NeighborSearchStatistics)
+            statistics += blockStatistics;
+          });
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -758,13 +1155,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      statistics.Print();
       break;
     }
     case DUAL_TREE_MODE:
     {
       // The dual-tree monochromatic search case may require resetting the
       // bounds in the tree.
-      if (treeNeedsReset)
+      // A shared tree may have been used by another object too.
+      if (treeNeedsReset || !treeOwner)
       {
         std::stack<Tree*> nodes;
         nodes.push(referenceTree);
@@ -784,6 +1183,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // Create the traverser.
       DualTreeTraversalType<RuleType> traverser(rules);
+      tree::TraversalStatistics statistics;
+      tree::CollectTraversalStatistics(traverser, statistics);
 
       if (tree::IsSpillTree<Tree>::value)
       {
@@ -806,6 +1207,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+      statistics.Print();
 
       // Next time we perform this search, we'll need to reset the tree.
       treeNeedsReset = true;
@@ -813,12 +1215,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
       // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      tree::ParallelQueryBlocks(rules, referenceSet->n_cols, parallelQueries &&
+          !tree::TreeTraits<Tree>::HasSelfChildren,
+          [this](RuleType& blockRules, const size_t begin, const size_t end)
+          {
+            tree::GreedySingleTreeTraverser<Tree, RuleType>
+                traverser(blockRules);
+            for (size_t i = begin; i < end; ++i)
+              traverser.Traverse(i, *referenceTree);
+          });
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -859,6 +1265,142 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+//! Search the query points in blocks, giving the results to a callback.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename CallbackType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    CallbackType&& callback,
+    const size_t blockSize)
+{
+  if (blockSize == 0)
+    throw std::invalid_argument("NeighborSearch::Search(): block size must be "
+        "greater than 0!");
+
+  // The results of each block are final as soon as its search is done.  The
+  // counts are kept for the whole search.
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (size_t begin = 0; begin < querySet.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+    const MatType block = querySet.cols(begin, end - 1);
+    Search(block, k, neighbors, distances);
+    totalBaseCases += baseCases;
+    totalScores += scores;
+
+    callback(begin, static_cast<const arma::Mat<size_t>&>(neighbors),
+        static_cast<const arma::mat&>(distances));
+  }
+
+  baseCases = totalBaseCases;
+  scores = totalScores;
+}
+
+//! Search the reference points in blocks, giving the results to a callback.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename CallbackType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const size_t k,
+    CallbackType&& callback,
+    const size_t blockSize)
+{
+  if (k >= referenceSet->n_cols)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than or equal to the "
+        << "number of points in the reference set (" << referenceSet->n_cols
+        << ") and no query set has been provided.";
+    throw std::invalid_argument(ss.str());
+  }
+  if (blockSize == 0)
+    throw std::invalid_argument("NeighborSearch::Search(): block size must be "
+        "greater than 0!");
+
+  // If we built the tree, the points are rearranged: the point with index i is
+  // column newFromOld[i] of the reference set, and the neighbors are returned
+  // with their original indices.
+  const bool mapped = !oldFromNewReferences.empty() &&
+      tree::TreeTraits<Tree>::RearrangesDataset;
+  std::vector<size_t> newFromOld;
+  if (mapped)
+  {
+    newFromOld.resize(oldFromNewReferences.size());
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      newFromOld[oldFromNewReferences[i]] = i;
+  }
+
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+  arma::Mat<size_t> blockNeighbors, neighbors;
+  arma::mat blockDistances, distances;
+  for (size_t begin = 0; begin < referenceSet->n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize,
+        (size_t) referenceSet->n_cols);
+    MatType block(referenceSet->n_rows, end - begin);
+    for (size_t i = begin; i < end; ++i)
+      block.col(i - begin) = referenceSet->col(mapped ? newFromOld[i] : i);
+
+    // Each point finds itself (or a duplicate of itself), so search for one
+    // more neighbor.
+    Search(block, k + 1, blockNeighbors, blockDistances);
+    totalBaseCases += baseCases;
+    totalScores += scores;
+
+    // Remove the point from its own results; if it was not found (because of
+    // duplicate points), the last neighbor is removed instead.
+    neighbors.set_size(k, end - begin);
+    distances.set_size(k, end - begin);
+    for (size_t i = 0; i < end - begin; ++i)
+    {
+      size_t self = k;
+      for (size_t j = 0; j <= k; ++j)
+      {
+        if (blockNeighbors(j, i) == begin + i)
+        {
+          self = j;
+          break;
+        }
+      }
+
+      for (size_t j = 0, l = 0; j <= k; ++j)
+      {
+        if (j == self)
+          continue;
+        neighbors(l, i) = blockNeighbors(j, i);
+        distances(l, i) = blockDistances(j, i);
+        ++l;
+      }
+    }
+
+    callback(begin, static_cast<const arma::Mat<size_t>&>(neighbors),
+        static_cast<const arma::mat&>(distances));
+  }
+
+  baseCases = totalBaseCases;
+  scores = totalScores;
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -963,17 +1505,18 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     // If we are loading, set the tree to NULL and clean up memory if necessary.
     if (Archive::is_loading::value)
     {
-      if (referenceTree)
+      if (referenceTree && treeOwner)
         delete referenceTree;
 
       referenceTree = NULL;
       oldFromNewReferences.clear();
+      treeOwner = true;
     }
   }
   else
   {
     // Delete the current reference tree, if necessary and if we are loading.
-    if (Archive::is_loading::value && referenceTree)
+    if (Archive::is_loading::value && referenceTree && treeOwner)
     {
       delete referenceTree;
     }
@@ -987,6 +1530,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     {
       referenceSet = &referenceTree->Dataset();
       metric = referenceTree->Metric(); // Get the metric from the tree.
+      treeOwner = true;
     }
   }
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/squared_distance_block.hpp>
 
 #include <queue>
 
@@ -63,6 +64,41 @@ class NeighborSearchRules
    */
   void GetResults(arma::Mat<size_t>& neighbors, arma::mat& distances);
 
+  /**
+   * Construct a copy of the given rules that shares their candidate lists, so
+   * that the neighbors found with the copy are stored in place.  Parallel
+   * traversals give each thread such a copy; since the threads search disjoint
+   * sets of query points, each candidate list is only modified by one thread.
+   * The copy must not outlive the given rules.
+   *
+   * @param other Rules to copy.
+   */
+  NeighborSearchRules(NeighborSearchRules& other);
+
+  /**
+   * Merge the candidate lists of the given query subtrees from another rules
+   * object into this one.  Copies of the rules share the candidate lists of
+   * the original, so there is nothing to do.
+   *
+   * @param other Rules object that was used to traverse the query subtrees.
+   * @param queryNodes Roots of the query subtrees traversed with other.
+   */
+  void Merge(const NeighborSearchRules& /* other */,
+             const std::vector<TreeType*>& /* queryNodes */) { }
+
+  /**
+   * Merge the candidate lists of the query points in [begin, end) from another
+   * rules object into this one.  Copies of the rules share the candidate
+   * lists of the original, so there is nothing to do.
+   *
+   * @param other Rules object that was used to search the query points.
+   * @param begin Index of the first query point to merge.
+   * @param end One past the index of the last query point to merge.
+   */
+  void Merge(const NeighborSearchRules& /* other */,
+             const size_t /* begin */,
+             const size_t /* end */) { }
+
   /**
    * Get the distance from the query point to the reference point.
    * This will update the list of candidates with the new point if appropriate
@@ -73,6 +109,36 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Perform the base cases between each of the given query points and every
+   * reference point in [referenceBegin, referenceEnd); the results are the
+   * same as calling BaseCase() for each pair in order.  For the (squared)
+   * Euclidean distance on dense or sparse data, the distances are first
+   * computed approximately as one matrix product; for each query point the
+   * k'th best bound of the block is selected first, and only the pairs that
+   * may enter the candidate list are evaluated exactly.
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceEnd One past the index of the last reference point.
+   */
+  void BaseCaseBlock(const std::vector<size_t>& queryIndices,
+                     const size_t referenceBegin,
+                     const size_t referenceEnd);
+
+  /**
+   * Perform the base cases between each of the given query points and each of
+   * the given reference points, which need not be contiguous (this is used
+   * for the leaves of spill trees).  Like BaseCaseBlock(), the distances are
+   * computed for the whole block at once when possible.  (This is not an
+   * overload of BaseCaseBlock(), so that HasBaseCaseBlock can still detect it.)
+   *
+   * @param queryIndices Indices of the query points.
+   * @param referenceIndices Indices of the reference points.
+   */
+  void IndexedBaseCaseBlock(const std::vector<size_t>& queryIndices,
+                            const std::vector<size_t>& referenceIndices);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -183,8 +249,12 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
+  //! Storage of the candidate neighbors of each point (empty for a copy of
+  //! other rules, which uses the candidates of the original).
+  std::vector<CandidateList> candidateStorage;
+
   //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -214,6 +284,23 @@ class NeighborSearchRules
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  //! Whether base cases can be computed as a block of squared distances.
+  typedef std::integral_constant<bool,
+      (std::is_same<MetricType, metric::EuclideanDistance>::value ||
+       std::is_same<MetricType, metric::SquaredEuclideanDistance>::value) &&
+      (arma::is_Mat<typename TreeType::Mat>::value ||
+       arma::is_SpMat<typename TreeType::Mat>::value)> UseDistanceBlock;
+
+  //! Perform the base cases of a block with a block of squared distances.
+  void BaseCaseBlockImpl(const std::vector<size_t>& queryIndices,
+                         const std::vector<size_t>& referenceIndices,
+                         const std::true_type /* useDistanceBlock */);
+
+  //! Perform the base cases of a block one pair at a time.
+  void BaseCaseBlockImpl(const std::vector<size_t>& queryIndices,
+                         const std::vector<size_t>& referenceIndices,
+                         const std::false_type /* useDistanceBlock */);
+
   /**
    * Recalculate the bound for a given query node.
    */
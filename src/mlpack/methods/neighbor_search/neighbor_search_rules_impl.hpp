@@ -29,12 +29,14 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(candidateStorage),
     k(k),
     metric(metric),
     sameSet(sameSet),
     epsilon(epsilon),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
+    lastBaseCase(0.0),
     baseCases(0),
     scores(0)
 {
@@ -59,6 +61,26 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     candidates.push_back(pqueue);
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    NeighborSearchRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(other.metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(other.lastQueryIndex),
+    lastReferenceIndex(other.lastReferenceIndex),
+    lastBaseCase(other.lastBaseCase),
+    baseCases(other.baseCases),
+    scores(other.scores),
+    traversalInfo(other.traversalInfo)
+{
+  // Nothing else to do.
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -107,6 +129,145 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlock(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceEnd)
+{
+  std::vector<size_t> referenceIndices(referenceEnd - referenceBegin);
+  for (size_t j = 0; j < referenceIndices.size(); ++j)
+    referenceIndices[j] = referenceBegin + j;
+
+  BaseCaseBlockImpl(queryIndices, referenceIndices, UseDistanceBlock());
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+IndexedBaseCaseBlock(const std::vector<size_t>& queryIndices,
+                     const std::vector<size_t>& referenceIndices)
+{
+  BaseCaseBlockImpl(queryIndices, referenceIndices, UseDistanceBlock());
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlockImpl(
+    const std::vector<size_t>& queryIndices,
+    const std::vector<size_t>& referenceIndices,
+    const std::true_type /* useDistanceBlock */)
+{
+  typedef typename TreeType::Mat MatType;
+  typedef typename MatType::elem_type ElemType;
+
+  const MatType queries = metric::GatherColumns(querySet, queryIndices);
+  const MatType references = metric::GatherColumns(referenceSet,
+      referenceIndices);
+
+  arma::Mat<ElemType> squaredDistances;
+  const double error = metric::SquaredDistanceBlock(queries, references,
+      squaredDistances);
+  const bool takeRoot =
+      std::is_same<MetricType, metric::EuclideanDistance>::value;
+
+  // The exact squared distance of each pair lies between lower and upper; the
+  // worst of the two (upper for nearest neighbor search) is the pessimistic
+  // bound.  The square root is monotonic, so for the Euclidean distance the
+  // bounds are compared to squared distances instead of taking their roots.
+  auto bounds = [&](const size_t i, const size_t j, double& lower,
+      double& upper)
+  {
+    lower = std::max(squaredDistances(i, j) - error, 0.0);
+    upper = squaredDistances(i, j) + error;
+  };
+
+  std::vector<double> pessimisticBounds;
+  if (references.n_cols > k)
+    pessimisticBounds.reserve(references.n_cols);
+
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+  {
+    const size_t queryIndex = queryIndices[i];
+
+    // Select the k'th best pessimistic bound of the block: at least k points of
+    // the block are at least that good, so any point whose optimistic bound is
+    // strictly worse can't be one of the k neighbors, and is skipped without
+    // touching the candidate list.  Early on, when the candidate list is still
+    // empty, this avoids evaluating most of the block exactly.
+    double blockBound = SortPolicy::WorstDistance();
+    if (references.n_cols > k)
+    {
+      pessimisticBounds.clear();
+      for (size_t j = 0; j < references.n_cols; ++j)
+      {
+        if (sameSet && (queryIndex == referenceIndices[j]))
+          continue;
+
+        double lower, upper;
+        bounds(i, j, lower, upper);
+        pessimisticBounds.push_back(SortPolicy::IsBetter(lower, upper) ?
+            upper : lower);
+      }
+
+      if (pessimisticBounds.size() >= k)
+      {
+        std::nth_element(pessimisticBounds.begin(),
+            pessimisticBounds.begin() + (k - 1), pessimisticBounds.end(),
+            [](const double a, const double b)
+            {
+              return (a != b) && SortPolicy::IsBetter(a, b);
+            });
+        blockBound = pessimisticBounds[k - 1];
+      }
+    }
+
+    for (size_t j = 0; j < references.n_cols; ++j)
+    {
+      const size_t referenceIndex = referenceIndices[j];
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+      if ((lastQueryIndex == queryIndex) &&
+          (lastReferenceIndex == referenceIndex))
+        continue;
+
+      ++baseCases;
+
+      // Only evaluate the distance exactly if it may enter the candidate list.
+      double lower, upper;
+      bounds(i, j, lower, upper);
+      const double optimistic = SortPolicy::IsBetter(lower, upper) ? lower :
+          upper;
+      if (!SortPolicy::IsBetter(optimistic, blockBound))
+        continue;
+
+      const Candidate& top = candidates[queryIndex].top();
+      const Candidate worst(takeRoot ? top.first * top.first : top.first,
+          top.second);
+      if (!CandidateCmp()(std::make_pair(lower, referenceIndex), worst) &&
+          !CandidateCmp()(std::make_pair(upper, referenceIndex), worst))
+        continue;
+
+      const double distance = metric.Evaluate(querySet.col(queryIndex),
+                                              referenceSet.col(referenceIndex));
+      InsertNeighbor(queryIndex, referenceIndex, distance);
+
+      lastQueryIndex = queryIndex;
+      lastReferenceIndex = referenceIndex;
+      lastBaseCase = distance;
+    }
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlockImpl(
+    const std::vector<size_t>& queryIndices,
+    const std::vector<size_t>& referenceIndices,
+    const std::false_type /* useDistanceBlock */)
+{
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+    for (size_t j = 0; j < referenceIndices.size(); ++j)
+      BaseCase(queryIndices[i], referenceIndices[j]);
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -20,8 +20,10 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/spill_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
 #include <boost/variant.hpp>
 #include "neighbor_search.hpp"
+#include "gpu_neighbor_search.hpp"
 
 namespace mlpack {
 namespace neighbor {
@@ -190,6 +192,69 @@ class TrainVisitor : public boost::static_visitor<void>
                const double rho);
 };
 
+/**
+ * InsertPointsVisitor adds points to the reference set of the given NSType.
+ * Reference trees that can be updated in place get the points inserted; other
+ * reference trees are rebuilt like TrainVisitor builds them, so that they keep
+ * the parameters of the model.
+ */
+template<typename SortPolicy>
+class InsertPointsVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The points to insert.
+  const arma::mat& points;
+  //! The leaf size, used only by BinarySpaceTree.
+  size_t leafSize;
+  //! Overlapping size (for spill trees).
+  const double tau;
+  //! Balance threshold (for spill trees).
+  const double rho;
+
+ public:
+  //! Insert the points into the given NSType instance.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Construct the InsertPointsVisitor object with the given points, leafSize
+  //! for BinarySpaceTrees, and tau and rho for spill trees.
+  InsertPointsVisitor(const arma::mat& points,
+                      const size_t leafSize,
+                      const double tau,
+                      const double rho);
+};
+
+/**
+ * DeletePointsVisitor removes points from the reference set of the given
+ * NSType.  Reference trees that can be updated in place have the points
+ * removed; other reference trees are rebuilt like TrainVisitor builds them.
+ */
+template<typename SortPolicy>
+class DeletePointsVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The indices of the points to remove.
+  const std::vector<size_t>& indices;
+  //! The leaf size, used only by BinarySpaceTree.
+  size_t leafSize;
+  //! Overlapping size (for spill trees).
+  const double tau;
+  //! Balance threshold (for spill trees).
+  const double rho;
+
+ public:
+  //! Remove the points from the given NSType instance.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Construct the DeletePointsVisitor object with the given indices, leafSize
+  //! for BinarySpaceTrees, and tau and rho for spill trees.
+  DeletePointsVisitor(const std::vector<size_t>& indices,
+                      const size_t leafSize,
+                      const double tau,
+                      const double rho);
+};
+
 /**
  * SearchModeVisitor exposes the SearchMode() method of the given NSType.
  */
@@ -212,6 +277,18 @@ class EpsilonVisitor : public boost::static_visitor<double&>
   double& operator()(NSType *ns) const;
 };
 
+/**
+ * ParallelQueriesVisitor exposes the ParallelQueries() method of the given
+ * NSType.
+ */
+class ParallelQueriesVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  //! Return whether queries are searched in parallel blocks.
+  template<typename NSType>
+  bool& operator()(NSType *ns) const;
+};
+
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given NSType.
  */
@@ -268,6 +345,15 @@ class NSModel
     OCTREE
   };
 
+  //! The settings that SelectEngine() can choose; they can be combined.
+  enum EngineSettings
+  {
+    SELECT_TREE_TYPE = 1,
+    SELECT_SEARCH_MODE = 2,
+    SELECT_LEAF_SIZE = 4,
+    SELECT_ALL = 7
+  };
+
  private:
   //! Tree type considered for neighbor search.
   TreeTypes treeType;
@@ -306,6 +392,16 @@ class NSModel
                  NSType<SortPolicy, tree::UBTree>*,
                  NSType<SortPolicy, tree::Octree>*> nSearch;
 
+  //! The file the reference set is memory-mapped from (empty if none).
+  std::string referenceMapFile;
+  //! The memory-mapped reference set, if any; copies of the model share it.
+  std::shared_ptr<data::MappedMatrix<double>> mappedReferenceSet;
+
+  //! If true, searches are run by the GPU brute-force engine.
+  bool gpuSearch;
+  //! Number of reference points in device memory at a time for GPU searches.
+  size_t gpuTileSize;
+
  public:
   /**
    * Initialize the NSModel with the given type and whether or not a random
@@ -363,6 +459,10 @@ class NSModel
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose ParallelQueries.
+  bool ParallelQueries() const;
+  bool& ParallelQueries();
+
   //! Expose leafSize.
   size_t LeafSize() const { return leafSize; }
   size_t& LeafSize() { return leafSize; }
@@ -383,12 +483,131 @@ class NSModel
   bool RandomBasis() const { return randomBasis; }
   bool& RandomBasis() { return randomBasis; }
 
+  /**
+   * Get whether searches are run by the GPU brute-force engine
+   * (GPUNeighborSearch) instead of the search mode of the model.  The engine
+   * compares the query points with the reference set of the model in its
+   * original order, so the model must have been built for naive search (trees
+   * rearrange the reference set).  Like ParallelQueries(), this depends on the
+   * machine the model is used on, so it is not saved with the model.
+   */
+  bool GPUSearch() const { return gpuSearch; }
+  //! Modify whether searches are run by the GPU brute-force engine.
+  bool& GPUSearch() { return gpuSearch; }
+
+  //! Get the number of reference points in device memory at a time for GPU
+  //! searches.
+  size_t GPUTileSize() const { return gpuTileSize; }
+  //! Modify the number of reference points in device memory at a time for GPU
+  //! searches.
+  size_t& GPUTileSize() { return gpuTileSize; }
+
+  /**
+   * Write the reference set to the given file and memory-map it from there.
+   * From then on the model is serialized without its reference set: only the
+   * name of the file is stored, and loading the model memory-maps the file
+   * again.  Any number of processes can load such a model while sharing a
+   * single copy of the reference set in the page cache.  The file must not be
+   * modified or removed while a model uses it.  Building the model again
+   * drops the mapping.
+   *
+   * @param filename File to write the reference set to.
+   */
+  void MapReferenceSet(const std::string& filename);
+
+  //! Get the file the reference set is memory-mapped from (empty if none).
+  const std::string& ReferenceMapFile() const { return referenceMapFile; }
+
+  /**
+   * Choose the tree type, the search mode and the leaf size that should search
+   * the given sets the fastest, and set the tree type and the leaf size of the
+   * model; the model must then be built with BuildModel() and the returned
+   * search mode.  Since the choice is held by the model, it is saved with it.
+   *
+   * The intrinsic dimensionality of the reference set is first estimated on a
+   * sample with the two nearest neighbors of each point (Facco et al., 2017):
+   * if it is larger than log2 of the number of reference points, the trees
+   * can't prune and naive search is chosen.  Otherwise each combination of the
+   * kd-tree, the ball tree, the cover tree and the max-split random projection
+   * tree with single-tree and dual-tree search and leaf sizes 10, 20 and 40
+   * (and naive search) is built and searched on samples of the sets.  The time
+   * of each one on the full sets is extrapolated from these: the search time
+   * of a tree grows as n^(1 - 1 / d) with the number n of reference points and
+   * the intrinsic dimensionality d, and linearly for naive search.
+   *
+   * @param referenceSet Set of reference points the model will be built on.
+   * @param querySet Set of query points that will be searched for; if empty,
+   *     the search is monochromatic.
+   * @param k Number of neighbors that will be searched for.
+   * @param epsilon Relative error allowed in the search.
+   * @param searchMode Search mode to use if it is not chosen.
+   * @param settings The settings to choose (a combination of EngineSettings);
+   *     the others keep the value of the model.
+   * @param sampleSize Number of reference points of the sample; a quarter as
+   *     many query points are used.
+   * @return The chosen search mode.
+   */
+  NeighborSearchMode SelectEngine(const arma::mat& referenceSet,
+                                  const arma::mat& querySet,
+                                  const size_t k,
+                                  const double epsilon = 0,
+                                  const NeighborSearchMode searchMode =
+                                      DUAL_TREE_MODE,
+                                  const int settings = SELECT_ALL,
+                                  const size_t sampleSize = 2000);
+
+  /**
+   * Estimate the intrinsic dimensionality of the given points with the ratios
+   * of the distances to their second and first nearest neighbors (the TWO-NN
+   * estimator).
+   *
+   * @code
+   * @article{facco2017estimating,
+   *   title={Estimating the intrinsic dimension of datasets by a minimal
+   *       neighborhood information},
+   *   author={Facco, Elena and d'Errico, Maria and Rodriguez, Alex and Laio,
+   *       Alessandro},
+   *   journal={Scientific Reports},
+   *   volume={7},
+   *   pages={12140},
+   *   year={2017}
+   * }
+   * @endcode
+   *
+   * @param points Points to estimate the intrinsic dimensionality of.
+   * @return The estimated intrinsic dimensionality.
+   */
+  static double IntrinsicDimensionality(const arma::mat& points);
+
   //! Build the reference tree.
   void BuildModel(arma::mat&& referenceSet,
                   const size_t leafSize,
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
+  /**
+   * Add the given points to the reference set, as if they had been appended to
+   * it: the new points get the indices that follow the current reference
+   * points.  Reference trees that are binary space trees (such as kd-trees and
+   * ball trees) are updated in place; other trees are rebuilt.  If the
+   * reference set was memory-mapped, it is copied to memory first and the
+   * mapping is dropped.
+   *
+   * @param points Points to add to the reference set.
+   */
+  void Insert(const arma::mat& points);
+
+  /**
+   * Remove the reference points with the given indices, as if they had been
+   * shed from the reference set: the remaining points are renumbered.
+   * Reference trees that are binary space trees are updated in place; other
+   * trees are rebuilt.  If the reference set was memory-mapped, it is copied to
+   * memory first and the mapping is dropped.
+   *
+   * @param indices Indices of the reference points to remove.
+   */
+  void Delete(const std::vector<size_t>& indices);
+
   //! Perform neighbor search.  The query set will be reordered.
   void Search(arma::mat&& querySet,
               const size_t k,
@@ -402,6 +621,15 @@ class NSModel
 
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+ private:
+  //! If the reference set is memory-mapped, copy it to memory and drop the
+  //! mapping, so that the reference set can be modified.
+  void UnmapReferenceSet();
+
+  //! Throw an exception if the GPU engine can't search the reference set of
+  //! the model.
+  void CheckGPUSearch() const;
 };
 
 } // namespace neighbor
@@ -409,7 +637,7 @@ class NSModel
 
 //! Set the serialization version of the NSModel class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::NSModel<SortPolicy>, 1);
+    mlpack::neighbor::NSModel<SortPolicy>, 2);
 
 // Include implementation.
 #include "ns_model_impl.hpp"
@@ -18,7 +18,10 @@
 // In case it hasn't been included yet.
 #include "ns_model.hpp"
 
+#include <chrono>
+
 #include <boost/serialization/variant.hpp>
+#include <boost/serialization/string.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -225,6 +228,70 @@ void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
   }
 }
 
+template<typename SortPolicy>
+InsertPointsVisitor<SortPolicy>::InsertPointsVisitor(const arma::mat& points,
+                                                     const size_t leafSize,
+                                                     const double tau,
+                                                     const double rho) :
+    points(points),
+    leafSize(leafSize),
+    tau(tau),
+    rho(rho)
+{}
+
+//! Insert the points into the given NSType instance.
+template<typename SortPolicy>
+template<typename NSType>
+void InsertPointsVisitor<SortPolicy>::operator()(NSType* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  if (ns->SearchMode() == NAIVE_MODE ||
+      SupportsIncrementalUpdates<typename NSType::Tree, arma::mat>::value)
+  {
+    ns->Insert(points, leafSize);
+  }
+  else
+  {
+    arma::mat referenceSet = arma::join_rows(ns->OriginalReferenceSet(),
+        points);
+    TrainVisitor<SortPolicy>(std::move(referenceSet), leafSize, tau, rho)(ns);
+  }
+}
+
+template<typename SortPolicy>
+DeletePointsVisitor<SortPolicy>::DeletePointsVisitor(
+    const std::vector<size_t>& indices,
+    const size_t leafSize,
+    const double tau,
+    const double rho) :
+    indices(indices),
+    leafSize(leafSize),
+    tau(tau),
+    rho(rho)
+{}
+
+//! Remove the points from the given NSType instance.
+template<typename SortPolicy>
+template<typename NSType>
+void DeletePointsVisitor<SortPolicy>::operator()(NSType* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  if (ns->SearchMode() == NAIVE_MODE ||
+      SupportsIncrementalUpdates<typename NSType::Tree, arma::mat>::value)
+  {
+    ns->Delete(indices, leafSize);
+  }
+  else
+  {
+    arma::mat referenceSet = ns->RemainingReferenceSet(indices);
+    TrainVisitor<SortPolicy>(std::move(referenceSet), leafSize, tau, rho)(ns);
+  }
+}
+
 //! Return the search mode.
 template<typename NSType>
 NeighborSearchMode& SearchModeVisitor::operator()(NSType* ns) const
@@ -243,6 +310,15 @@ double& EpsilonVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Expose whether the given NSType searches queries in parallel blocks.
+template<typename NSType>
+bool& ParallelQueriesVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->ParallelQueries();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Expose the referenceSet of the given NSType.
 template<typename NSType>
 const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
@@ -270,7 +346,9 @@ NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
     leafSize(20),
     tau(0),
     rho(0.7),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    gpuSearch(false),
+    gpuTileSize(16384)
 {
   // Nothing to do.
 }
@@ -283,7 +361,11 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(other.q),
-    nSearch(other.nSearch)
+    nSearch(other.nSearch),
+    referenceMapFile(other.referenceMapFile),
+    mappedReferenceSet(other.mappedReferenceSet),
+    gpuSearch(other.gpuSearch),
+    gpuTileSize(other.gpuTileSize)
 {
   // Nothing to do.
 }
@@ -296,7 +378,11 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    nSearch(other.nSearch)
+    nSearch(other.nSearch),
+    referenceMapFile(std::move(other.referenceMapFile)),
+    mappedReferenceSet(std::move(other.mappedReferenceSet)),
+    gpuSearch(other.gpuSearch),
+    gpuTileSize(other.gpuTileSize)
 {
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -305,6 +391,8 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.rho = 0.7;
   other.randomBasis = false;
   other.nSearch = decltype(other.nSearch)();
+  other.gpuSearch = false;
+  other.gpuTileSize = 16384;
 }
 
 template<typename SortPolicy>
@@ -319,6 +407,10 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   randomBasis = other.randomBasis;
   q = other.q;
   nSearch = other.nSearch;
+  referenceMapFile = other.referenceMapFile;
+  mappedReferenceSet = other.mappedReferenceSet;
+  gpuSearch = other.gpuSearch;
+  gpuTileSize = other.gpuTileSize;
 
   return *this;
 }
@@ -336,6 +428,10 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   q = std::move(other.q);
   // Copy the pointer and type.
   nSearch = other.nSearch;
+  referenceMapFile = std::move(other.referenceMapFile);
+  mappedReferenceSet = std::move(other.mappedReferenceSet);
+  gpuSearch = other.gpuSearch;
+  gpuTileSize = other.gpuTileSize;
 
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -344,6 +440,8 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   other.rho = 0.7;
   other.randomBasis = false;
   other.nSearch = decltype(other.nSearch)();
+  other.gpuSearch = false;
+  other.gpuTileSize = 16384;
 
   return *this;
 }
@@ -372,11 +470,61 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
+  // Older versions of NSModel could not memory-map the reference set.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(referenceMapFile);
+  else if (Archive::is_loading::value)
+    referenceMapFile.clear();
+
   // This should never happen, but just in case, be clean with memory.
   if (Archive::is_loading::value)
+  {
     boost::apply_visitor(DeleteVisitor(), nSearch);
+    mappedReferenceSet.reset();
+  }
+
+  if (Archive::is_saving::value && !referenceMapFile.empty())
+  {
+    // Serialize an empty reference set; it will be mapped again on loading.
+    // The matrix is owned by the NeighborSearch object (or its tree), so it is
+    // fine to modify it here.
+    arma::mat& referenceSet = const_cast<arma::mat&>(Dataset());
+    data::MappedMatrix<double>::Unalias(referenceSet);
+    ar & BOOST_SERIALIZATION_NVP(nSearch);
+    mappedReferenceSet->Alias(referenceSet);
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(nSearch);
+  }
 
-  ar & BOOST_SERIALIZATION_NVP(nSearch);
+  if (Archive::is_loading::value && !referenceMapFile.empty())
+  {
+    mappedReferenceSet = std::make_shared<data::MappedMatrix<double>>(
+        referenceMapFile);
+    mappedReferenceSet->Alias(const_cast<arma::mat&>(Dataset()));
+  }
+}
+
+//! Write the reference set to the given file and memory-map it.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::MapReferenceSet(const std::string& filename)
+{
+  // Rewriting a file that is already mapped would corrupt the mapping.
+  if (filename == referenceMapFile)
+    return;
+
+  // The matrix is owned by the NeighborSearch object (or its tree); only the
+  // memory that backs it is replaced.
+  arma::mat& referenceSet = const_cast<arma::mat&>(Dataset());
+  data::MappedMatrix<double>::Save(filename, referenceSet);
+
+  std::shared_ptr<data::MappedMatrix<double>> mapped =
+      std::make_shared<data::MappedMatrix<double>>(filename);
+  mapped->Alias(referenceSet);
+
+  mappedReferenceSet = mapped;
+  referenceMapFile = filename;
 }
 
 //! Expose the dataset.
@@ -412,6 +560,194 @@ double& NSModel<SortPolicy>::Epsilon()
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
+template<typename SortPolicy>
+bool NSModel<SortPolicy>::ParallelQueries() const
+{
+  return boost::apply_visitor(ParallelQueriesVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+bool& NSModel<SortPolicy>::ParallelQueries()
+{
+  return boost::apply_visitor(ParallelQueriesVisitor(), nSearch);
+}
+
+//! Choose the tree type, the search mode and the leaf size.
+template<typename SortPolicy>
+NeighborSearchMode NSModel<SortPolicy>::SelectEngine(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    const size_t k,
+    const double epsilon,
+    const NeighborSearchMode searchMode,
+    const int settings,
+    const size_t sampleSize)
+{
+  const bool monochromatic = querySet.is_empty();
+  const size_t referencePoints = std::min((size_t) referenceSet.n_cols,
+      std::max(sampleSize, (size_t) 3));
+  const size_t queryPoints = monochromatic ? referencePoints :
+      std::min((size_t) querySet.n_cols, std::max(sampleSize / 4, (size_t) 1));
+  const size_t sampleK = std::min(k, monochromatic ? referencePoints - 1 :
+      referencePoints);
+  if (referenceSet.n_cols < 3 || sampleK == 0)
+    return searchMode;
+
+  const arma::mat referenceSample = referenceSet.cols(
+      arma::randperm(referenceSet.n_cols, referencePoints));
+  const arma::mat querySample = monochromatic ? arma::mat() :
+      arma::mat(querySet.cols(arma::randperm(querySet.n_cols, queryPoints)));
+
+  // The times measured on the samples are scaled to the full sets.
+  const double n = referenceSet.n_cols;
+  const double referenceRatio = n / referencePoints;
+  const double queryRatio = (monochromatic ? n : (double) querySet.n_cols) /
+      queryPoints;
+  const double buildRatio = referenceRatio * std::log(n) /
+      std::log((double) referencePoints);
+
+  const double dimensionality = IntrinsicDimensionality(referenceSample);
+  Log::Info << "Estimated intrinsic dimensionality: " << dimensionality << "."
+      << std::endl;
+  const double treeSearchRatio = queryRatio * std::pow(referenceRatio,
+      1.0 - 1.0 / std::max(dimensionality, 1.0));
+
+  // List the combinations to try.
+  std::vector<TreeTypes> treeTypes(1, treeType);
+  if (settings & SELECT_TREE_TYPE)
+  {
+    treeTypes = { TreeTypes::KD_TREE, TreeTypes::BALL_TREE,
+        TreeTypes::COVER_TREE, TreeTypes::MAX_RP_TREE };
+  }
+  std::vector<NeighborSearchMode> searchModes(1, searchMode);
+  if (settings & SELECT_SEARCH_MODE)
+  {
+    // When the intrinsic dimensionality is too high, the trees visit nearly
+    // every leaf.
+    if (dimensionality > std::log2(n))
+      searchModes = { NAIVE_MODE };
+    else
+      searchModes = { NAIVE_MODE, SINGLE_TREE_MODE, DUAL_TREE_MODE };
+  }
+  std::vector<size_t> leafSizes(1, leafSize);
+  if (settings & SELECT_LEAF_SIZE)
+    leafSizes = { 10, 20, 40 };
+
+  // The candidates log what they do; only the choice is interesting.
+  const bool ignoring = Log::Info.ignoreInput;
+  Log::Info.ignoreInput = true;
+
+  double bestTime = DBL_MAX;
+  TreeTypes bestTreeType = treeType;
+  NeighborSearchMode bestSearchMode = searchMode;
+  size_t bestLeafSize = leafSize;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  try
+  {
+    for (const NeighborSearchMode mode : searchModes)
+    {
+      for (const TreeTypes type : treeTypes)
+      {
+        for (const size_t candidateLeafSize : leafSizes)
+        {
+          NSModel candidate(type, false);
+          candidate.Tau() = tau;
+          candidate.Rho() = rho;
+
+          arma::mat referenceCopy(referenceSample);
+          arma::mat queryCopy(querySample);
+          const auto start = std::chrono::steady_clock::now();
+          candidate.BuildModel(std::move(referenceCopy), candidateLeafSize,
+              mode, epsilon);
+          const auto built = std::chrono::steady_clock::now();
+          if (monochromatic)
+            candidate.Search(sampleK, neighbors, distances);
+          else
+            candidate.Search(std::move(queryCopy), sampleK, neighbors,
+                distances);
+          const auto searched = std::chrono::steady_clock::now();
+
+          const double buildTime =
+              std::chrono::duration<double>(built - start).count();
+          const double searchTime =
+              std::chrono::duration<double>(searched - built).count();
+          const double time = (mode == NAIVE_MODE) ?
+              buildTime * referenceRatio +
+              searchTime * referenceRatio * queryRatio :
+              buildTime * buildRatio + searchTime * treeSearchRatio;
+
+          if (time < bestTime)
+          {
+            bestTime = time;
+            bestTreeType = type;
+            bestSearchMode = mode;
+            bestLeafSize = candidateLeafSize;
+          }
+
+          // The tree type and the leaf size do not matter for naive search,
+          // and the cover tree has no leaf size.
+          if (mode == NAIVE_MODE || type == TreeTypes::COVER_TREE)
+            break;
+        }
+
+        if (mode == NAIVE_MODE)
+          break;
+      }
+    }
+  }
+  catch (...)
+  {
+    Log::Info.ignoreInput = ignoring;
+    throw;
+  }
+  Log::Info.ignoreInput = ignoring;
+
+  treeType = bestTreeType;
+  leafSize = bestLeafSize;
+  if (bestSearchMode == NAIVE_MODE)
+    Log::Info << "Selected naive search." << std::endl;
+  else
+    Log::Info << "Selected " << (bestSearchMode == SINGLE_TREE_MODE ?
+        "single-tree " : (bestSearchMode == DUAL_TREE_MODE ? "dual-tree " :
+        "greedy single-tree ")) << TreeName() << " search with leaf size "
+        << leafSize << "." << std::endl;
+
+  return bestSearchMode;
+}
+
+//! Estimate the intrinsic dimensionality with the TWO-NN estimator.
+template<typename SortPolicy>
+double NSModel<SortPolicy>::IntrinsicDimensionality(const arma::mat& points)
+{
+  if (points.n_cols < 3)
+    return points.n_rows;
+
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance> knn(points,
+      NAIVE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(2, neighbors, distances);
+
+  // The maximum likelihood estimate is the number of points over the sum of
+  // the logarithms of the ratios.  Duplicate points have no ratio.
+  double logRatios = 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    if (distances(0, i) > 0.0)
+    {
+      logRatios += std::log(distances(1, i) / distances(0, i));
+      ++count;
+    }
+  }
+
+  if (logRatios <= 0.0)
+    return points.n_rows;
+
+  return count / logRatios;
+}
+
 //! Build the reference tree.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
@@ -454,6 +790,8 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
 
   // Clean memory, if necessary.
   boost::apply_visitor(DeleteVisitor(), nSearch);
+  referenceMapFile.clear();
+  mappedReferenceSet.reset();
 
   // Do we need to modify the reference set?
   if (randomBasis)
@@ -526,6 +864,68 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   }
 }
 
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Insert(const arma::mat& points)
+{
+  if (points.n_rows != Dataset().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NSModel::Insert(): dimensionality of points (" << points.n_rows
+        << ") does not match dimensionality of reference set ("
+        << Dataset().n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  UnmapReferenceSet();
+
+  // The new points have to be projected onto the random basis too.
+  arma::mat basisPoints;
+  if (randomBasis)
+    basisPoints = q * points;
+
+  InsertPointsVisitor<SortPolicy> visitor(randomBasis ? basisPoints : points,
+      leafSize, tau, rho);
+  boost::apply_visitor(visitor, nSearch);
+}
+
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Delete(const std::vector<size_t>& indices)
+{
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    if (indices[i] >= Dataset().n_cols)
+    {
+      std::ostringstream oss;
+      oss << "NSModel::Delete(): reference point " << indices[i] << " does "
+          << "not exist (the reference set has " << Dataset().n_cols
+          << " points)";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  UnmapReferenceSet();
+
+  DeletePointsVisitor<SortPolicy> visitor(indices, leafSize, tau, rho);
+  boost::apply_visitor(visitor, nSearch);
+}
+
+template<typename SortPolicy>
+void NSModel<SortPolicy>::UnmapReferenceSet()
+{
+  if (!mappedReferenceSet)
+    return;
+
+  // A matrix that aliases the mapping cannot be resized, so give it its own
+  // memory.  The matrix is owned by the NeighborSearch object (or its tree).
+  arma::mat& referenceSet = const_cast<arma::mat&>(Dataset());
+  arma::mat copy(referenceSet);
+  data::MappedMatrix<double>::Unalias(referenceSet);
+  referenceSet = std::move(copy);
+
+  referenceMapFile.clear();
+  mappedReferenceSet.reset();
+}
+
 //! Perform neighbor search.  The query set will be reordered.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::Search(arma::mat&& querySet,
@@ -537,6 +937,16 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
   if (randomBasis)
     querySet = q * querySet;
 
+  if (gpuSearch)
+  {
+    CheckGPUSearch();
+    Log::Info << "Searching for " << k << " neighbors with brute-force GPU "
+        << "search..." << std::endl;
+    GPUNeighborSearch<SortPolicy> gpu(gpuTileSize);
+    gpu.Search(Dataset(), querySet, k, neighbors, distances);
+    return;
+  }
+
   Log::Info << "Searching for " << k << " neighbors with ";
 
   switch (SearchMode())
@@ -567,6 +977,16 @@ void NSModel<SortPolicy>::Search(const size_t k,
                                  arma::Mat<size_t>& neighbors,
                                  arma::mat& distances)
 {
+  if (gpuSearch)
+  {
+    CheckGPUSearch();
+    Log::Info << "Searching for " << k << " neighbors with brute-force GPU "
+        << "search..." << std::endl;
+    GPUNeighborSearch<SortPolicy> gpu(gpuTileSize);
+    gpu.Search(Dataset(), k, neighbors, distances);
+    return;
+  }
+
   Log::Info << "Searching for " << k << " neighbors with ";
 
   switch (SearchMode())
@@ -594,6 +1014,17 @@ void NSModel<SortPolicy>::Search(const size_t k,
   boost::apply_visitor(search, nSearch);
 }
 
+//! Make sure the GPU engine can search the reference set of the model.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::CheckGPUSearch() const
+{
+  if (SearchMode() != NAIVE_MODE)
+  {
+    throw std::invalid_argument("NSModel::Search(): GPU search needs a model "
+        "built for naive search, since trees rearrange the reference set");
+  }
+}
+
 //! Get the name of the tree type.
 template<typename SortPolicy>
 std::string NSModel<SortPolicy>::TreeName() const
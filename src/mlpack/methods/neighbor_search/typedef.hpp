@@ -37,6 +37,21 @@ typedef NeighborSearch<NearestNeighborSort, metric::EuclideanDistance> KNN;
  */
 typedef NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance> KFN;
 
+/**
+ * The ParallelKNN class is the k-nearest-neighbors method with a kd-tree whose
+ * dual-tree traversal is split into tasks over query subtrees and run in
+ * parallel with OpenMP.  It returns L2 distances (Euclidean distances) for each
+ * of the k nearest neighbors.
+ */
+typedef NeighborSearch<
+    NearestNeighborSort,
+    metric::EuclideanDistance,
+    arma::mat,
+    tree::KDTree,
+    tree::KDTree<metric::EuclideanDistance,
+        NeighborSearchStat<NearestNeighborSort>,
+        arma::mat>::template ParallelDualTreeTraverser> ParallelKNN;
+
 /**
  * The DefeatistKNN class is the k-nearest-neighbors method considering
  * defeatist search. It returns L2 distances (Euclidean distances) for each of
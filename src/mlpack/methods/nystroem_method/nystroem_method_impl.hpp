@@ -36,17 +36,12 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& semiKernel)
 {
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(selectedData->col(i),
-                                         selectedData->col(j));
+  KernelMatrix(kernel, *selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected data and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         selectedData->col(j));
+  KernelMatrix(kernel, data, *selectedData, semiKernel);
+
   // Clean the memory.
   delete selectedData;
 }
@@ -57,22 +52,14 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
+  const arma::mat selectedData = data.cols(selectedPoints);
+
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-  {
-    for (size_t j = 0; j < rank; ++j)
-    {
-      miniKernel(i, j) = kernel.Evaluate(data.col(selectedPoints(i)),
-                                         data.col(selectedPoints(j)));
-    }
-  }
+  KernelMatrix(kernel, selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected points and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         data.col(selectedPoints(j)));
+  KernelMatrix(kernel, data, selectedData, semiKernel);
 }
 
 template<typename KernelType, typename PointSelectionPolicy>
@@ -0,0 +1,118 @@
+/**
+ * @file methods/pca/decomposition_policies/covariance_method.hpp
+ *
+ * Implementation of the covariance eigendecomposition method for use in the
+ * Principal Components Analysis method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_COVARIANCE_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_COVARIANCE_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the covariance policy, which computes the eigenvectors of
+ * the covariance matrix X * X' / (N - 1) of the centered data X.  The
+ * covariance matrix is accumulated over blocks of points in parallel with
+ * OpenMP (if available), and only takes d x d memory per thread, where d is
+ * the dimensionality of the data; this is much less than the memory of the SVD
+ * of the data when there are many more points than dimensions.
+ */
+class CovariancePolicy
+{
+ public:
+  /**
+   * Use the eigendecomposition of the covariance matrix to perform the
+   * principal components analysis (PCA).
+   *
+   * @param blockSize Number of points in each block of the covariance
+   *        accumulation.
+   */
+  CovariancePolicy(const size_t blockSize = 1024) : blockSize(blockSize)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * eigendecomposition of the covariance matrix.
+   *
+   * @param data Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param * (rank) Rank of the decomposition.
+   */
+  void Apply(const arma::mat& data,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t /* rank */)
+  {
+    const size_t dims = centeredData.n_rows;
+    const size_t size = std::max(blockSize, (size_t) 1);
+    const size_t numBlocks = (centeredData.n_cols + size - 1) / size;
+
+    arma::mat covariance(dims, dims, arma::fill::zeros);
+
+    #pragma omp parallel
+    {
+      arma::mat localCovariance(dims, dims, arma::fill::zeros);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const size_t begin = b * size;
+        const size_t end = std::min(begin + size, (size_t) centeredData.n_cols)
+            - 1;
+        const arma::mat block(const_cast<double*>(centeredData.colptr(begin)),
+            dims, end - begin + 1, false, true);
+        localCovariance += block * block.t();
+      }
+
+      #pragma omp critical
+      covariance += localCovariance;
+    }
+
+    // The covariance matrix is X * X' / (N - 1).
+    covariance /= (data.n_cols - 1);
+
+    if (!arma::eig_sym(eigVal, eigvec, covariance))
+    {
+      Log::Fatal << "CovariancePolicy::Apply(): failed to compute the "
+          << "eigendecomposition of the covariance matrix." << std::endl;
+    }
+
+    // The eigenvalues are in ascending order; we need them from largest to
+    // smallest.
+    eigVal = arma::flipud(eigVal);
+    eigvec = arma::fliplr(eigvec);
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  //! Get the number of points in each block of the covariance accumulation.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points in each block of the covariance accumulation.
+  size_t& BlockSize() { return blockSize; }
+
+ private:
+  //! Locally stored number of points in each block.
+  size_t blockSize;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
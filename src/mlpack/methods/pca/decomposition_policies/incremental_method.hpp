@@ -0,0 +1,219 @@
+/**
+ * @file methods/pca/decomposition_policies/incremental_method.hpp
+ *
+ * Implementation of the incremental PCA method, which processes the data in
+ * batches, for use in the Principal Components Analysis method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental PCA policy.  The data is processed in
+ * batches of points; the principal components are updated with each batch by
+ * taking the SVD of the current components (scaled by their singular values),
+ * the centered batch, and the shift of the mean, so that only the components
+ * and one batch are held at once.  For more information, see the following.
+ *
+ * @code
+ * @article{Ross2008,
+ *   author  = {Ross, D. A. and Lim, J. and Lin, R.-S. and Yang, M.-H.},
+ *   title   = {Incremental Learning for Robust Visual Tracking},
+ *   journal = {International Journal of Computer Vision},
+ *   volume  = {77},
+ *   pages   = {125--141},
+ *   year    = {2008}
+ * }
+ * @endcode
+ *
+ * When used by the PCA class, rank + 2 components are kept (as many as
+ * RandomizedSVDPolicy computes), so the eigenvalues are those of the kept
+ * components only.  The batches can also be given one at a time with Update(),
+ * for data that does not fit in memory:
+ *
+ * @code
+ * IncrementalPCAPolicy ipca;
+ * ipca.Reset(10); // Keep 10 components.
+ * while (...) // Load each batch of points (one point per column).
+ *   ipca.Update(batch);
+ *
+ * // The principal components are the columns of ipca.Components(), and the
+ * // mean of the data is ipca.Mean().
+ * @endcode
+ */
+class IncrementalPCAPolicy
+{
+ public:
+  /**
+   * Use incremental PCA to perform the principal components analysis (PCA).
+   *
+   * @param batchSize Number of points in each batch.
+   */
+  IncrementalPCAPolicy(const size_t batchSize = 1024) :
+      batchSize(batchSize),
+      numComponents(0),
+      numPoints(0)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using
+   * incremental PCA over batches of the centered data.
+   *
+   * @param data Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::mat& data,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    Reset(std::min(rank + 2, (size_t) centeredData.n_rows));
+
+    const size_t size = std::max(batchSize, (size_t) 1);
+    for (size_t begin = 0; begin < centeredData.n_cols; begin += size)
+    {
+      const size_t end = std::min(begin + size, (size_t) centeredData.n_cols)
+          - 1;
+      Update(centeredData.cols(begin, end));
+    }
+
+    // Now we must square the singular values to get the eigenvalues.
+    // In addition we must divide by the number of points, because the
+    // covariance matrix is X * X' / (N - 1).
+    eigVal = arma::square(singularValues) / (data.n_cols - 1);
+    eigvec = components;
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  /**
+   * Forget all the points seen so far, and set the number of components to
+   * keep.
+   *
+   * @param numComponents Number of principal components to keep (0 keeps all
+   *        of them).
+   */
+  void Reset(const size_t numComponents)
+  {
+    this->numComponents = numComponents;
+    numPoints = 0;
+    mean.reset();
+    components.reset();
+    singularValues.reset();
+  }
+
+  /**
+   * Update the principal components with a batch of points.
+   *
+   * @param batch Batch of points (one point per column).
+   */
+  void Update(const arma::mat& batch)
+  {
+    if (batch.n_cols == 0)
+      return;
+
+    if (numPoints > 0 && batch.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "IncrementalPCAPolicy::Update(): dimensionality of batch ("
+          << batch.n_rows << ") does not match dimensionality of previous "
+          << "points (" << mean.n_elem << ")";
+      throw std::invalid_argument(oss.str());
+    }
+
+    const double n = (double) numPoints;
+    const double m = (double) batch.n_cols;
+    const arma::vec batchMean = arma::mean(batch, 1);
+
+    // The matrix to decompose holds the current components scaled by their
+    // singular values, the centered batch, and the correction for the shift of
+    // the mean.
+    arma::mat stacked;
+    if (numPoints == 0)
+    {
+      stacked = batch.each_col() - batchMean;
+    }
+    else
+    {
+      stacked.set_size(batch.n_rows, components.n_cols + batch.n_cols + 1);
+      stacked.cols(0, components.n_cols - 1) = components *
+          arma::diagmat(singularValues);
+      stacked.cols(components.n_cols, components.n_cols + batch.n_cols - 1) =
+          batch.each_col() - batchMean;
+      stacked.col(stacked.n_cols - 1) = std::sqrt(n * m / (n + m)) *
+          (mean - batchMean);
+    }
+
+    arma::mat u, v;
+    arma::vec s;
+    arma::svd_econ(u, s, v, stacked, 'l');
+
+    const size_t keep = (numComponents == 0) ? s.n_elem :
+        std::min(numComponents, (size_t) s.n_elem);
+    components = u.cols(0, keep - 1);
+    singularValues = s.subvec(0, keep - 1);
+
+    if (numPoints == 0)
+      mean = batchMean;
+    else
+      mean = (n * mean + m * batchMean) / (n + m);
+    numPoints += batch.n_cols;
+  }
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of points given to Update() since the last Reset().
+  size_t NumPoints() const { return numPoints; }
+  //! Get the mean of the points.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the principal components (one per column).
+  const arma::mat& Components() const { return components; }
+  //! Get the singular values of the centered points.
+  const arma::vec& SingularValues() const { return singularValues; }
+
+ private:
+  //! Locally stored number of points in each batch.
+  size_t batchSize;
+
+  //! Number of principal components to keep.
+  size_t numComponents;
+
+  //! Number of points seen so far.
+  size_t numPoints;
+
+  //! Mean of the points seen so far.
+  arma::vec mean;
+
+  //! Principal components of the points seen so far.
+  arma::mat components;
+
+  //! Singular values of the centered points seen so far.
+  arma::vec singularValues;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -15,7 +15,9 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include "pca.hpp"
+#include <mlpack/methods/pca/decomposition_policies/covariance_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -38,7 +40,8 @@ BINDING_SHORT_DESC(
 // Long description.
 BINDING_LONG_DESC(
     "This program performs principal components analysis on the given dataset "
-    "using the exact, randomized, randomized block Krylov, or QUIC SVD method. "
+    "using the exact, randomized, randomized block Krylov, or QUIC SVD method, "
+    "the eigendecomposition of the covariance matrix, or incremental PCA. "
     "It will transform the data onto its principal components, optionally "
     "performing dimensionality reduction by ignoring the principal components "
     "with the smallest eigenvalues."
@@ -54,7 +57,10 @@ BINDING_LONG_DESC(
     "Multiple different decomposition techniques can be used.  The method to "
     "use can be specified with the " +
     PRINT_PARAM_STRING("decomposition_method") + " parameter, and it may take "
-    "the values 'exact', 'randomized', or 'quic'.");
+    "the values 'exact', 'randomized', 'randomized-block-krylov', 'quic', "
+    "'covariance', or 'incremental'.  The 'covariance' method accumulates the "
+    "covariance matrix in parallel, which takes much less memory than the SVD "
+    "when there are many more points than dimensions.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -85,7 +91,7 @@ PARAM_FLAG("scale", "If set, the data will be scaled before running PCA, such "
 
 PARAM_STRING_IN("decomposition_method", "Method used for the principal "
     "components analysis: 'exact', 'randomized', 'randomized-block-krylov', "
-    "'quic'.", "c", "exact");
+    "'quic', 'covariance', 'incremental'.", "c", "exact");
 
 
 //! Run RunPCA on the specified dataset with the given decomposition method.
@@ -127,7 +133,7 @@ static void mlpackMain()
 
   // Check decomposition method validity.
   RequireParamInSet<string>("decomposition_method", { "exact", "randomized",
-      "randomized-block-krylov", "quic" }, true,
+      "randomized-block-krylov", "quic", "covariance", "incremental" }, true,
       "unknown decomposition method");
 
   // Find out what dimension we want.
@@ -170,6 +176,14 @@ static void mlpackMain()
   {
     RunPCA<QUICSVDPolicy>(dataset, newDimension, scale, varToRetain);
   }
+  else if (decompositionMethod == "covariance")
+  {
+    RunPCA<CovariancePolicy>(dataset, newDimension, scale, varToRetain);
+  }
+  else if (decompositionMethod == "incremental")
+  {
+    RunPCA<IncrementalPCAPolicy>(dataset, newDimension, scale, varToRetain);
+  }
 
   // Now save the results.
   if (IO::HasParam("output"))
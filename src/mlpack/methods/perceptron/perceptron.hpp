@@ -26,6 +26,15 @@ namespace perceptron {
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * By default, the points are visited one by one, and the weights are updated
+ * after each misclassified point.  If BatchSize() is set, the perceptron is
+ * instead trained on blocks of points: the scores of all the points of a block
+ * are computed with one matrix product, the updates of the misclassified
+ * points are accumulated in parallel (if OpenMP is available) and applied at
+ * once, and the final weights are the average of the weights after each block
+ * (the averaged perceptron).  The LearnPolicy must then give updates that do
+ * not depend on the current weights, like SimpleWeightUpdate.
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomInitialization.
@@ -127,6 +136,13 @@ class Perceptron
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of points of each block of the training (0 to update the
+  //! weights after each point).
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points of each block of the training (0 to update
+  //! the weights after each point).
+  size_t& BatchSize() { return batchSize; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -141,9 +157,20 @@ class Perceptron
   arma::vec& Biases() { return biases; }
 
  private:
+  /**
+   * Train the perceptron on blocks of BatchSize() points, and average the
+   * weights after each block.
+   */
+  void TrainBatch(const MatType& data,
+                  const arma::Row<size_t>& labels,
+                  const arma::rowvec& instanceWeights);
+
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of points of each block of the training (0 for none).
+  size_t batchSize;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -30,7 +30,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(0)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -56,7 +57,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(0)
 {
   // Start training.
   Train(data, labels, numClasses);
@@ -84,7 +86,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const arma::rowvec& instanceWeights) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    batchSize(other.batchSize)
 {
   Train(data, labels, numClasses, instanceWeights);
 }
@@ -106,16 +109,11 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
-
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; ++i)
-  {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
-  }
+  // Compute the scores of all the points with one matrix product.
+  arma::mat scores = weights.t() * test;
+  scores.each_col() += biases;
+  predictedLabels = arma::conv_to<arma::Row<size_t>>::from(
+      arma::index_max(scores, 0));
 }
 
 /**
@@ -145,6 +143,12 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     wip.Initialize(weights, biases, data.n_rows, numClasses);
   }
 
+  if (batchSize > 0)
+  {
+    TrainBatch(data, labels, instanceWeights);
+    return;
+  }
+
   size_t j, i = 0;
   bool converged = false;
   size_t tempLabel;
@@ -192,6 +196,108 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
   }
 }
 
+/**
+ * Train the perceptron on blocks of points, and average the weights after each
+ * block.
+ */
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::TrainBatch(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const arma::rowvec& instanceWeights)
+{
+  const bool hasWeights = (instanceWeights.n_elem > 0);
+
+  arma::mat weightsSum(arma::size(weights), arma::fill::zeros);
+  arma::vec biasesSum(arma::size(biases), arma::fill::zeros);
+  size_t numBlocks = 0;
+
+  bool converged = false;
+  for (size_t i = 0; (i < maxIterations) && !converged; ++i)
+  {
+    converged = true;
+    for (size_t begin = 0; begin < data.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize, (size_t) data.n_cols);
+
+      // Compute the scores of the whole block with one matrix product.
+      arma::mat scores = weights.t() * data.cols(begin, end - 1);
+      scores.each_col() += biases;
+      const arma::urowvec predictions = arma::index_max(scores, 0);
+
+      // All the updates of the block are computed against the same weights,
+      // so each thread can sum its updates separately; the sums are then added
+      // together.
+      arma::mat weightsUpdate(arma::size(weights), arma::fill::zeros);
+      arma::vec biasesUpdate(arma::size(biases), arma::fill::zeros);
+      bool updated = false;
+
+      #pragma omp parallel
+      {
+        LearnPolicy LP;
+        arma::mat threadWeights;
+        arma::vec threadBiases;
+
+        #pragma omp for schedule(static)
+        for (omp_size_t j = (omp_size_t) begin; j < (omp_size_t) end; ++j)
+        {
+          const size_t prediction = predictions[j - begin];
+          if (prediction == labels[j])
+            continue;
+
+          if (threadWeights.is_empty())
+          {
+            threadWeights.zeros(arma::size(weights));
+            threadBiases.zeros(arma::size(biases));
+          }
+
+          if (hasWeights)
+          {
+            LP.UpdateWeights(data.col(j), threadWeights, threadBiases,
+                prediction, labels[j], instanceWeights[j]);
+          }
+          else
+          {
+            LP.UpdateWeights(data.col(j), threadWeights, threadBiases,
+                prediction, labels[j]);
+          }
+        }
+
+        if (!threadWeights.is_empty())
+        {
+          #pragma omp critical
+          {
+            weightsUpdate += threadWeights;
+            biasesUpdate += threadBiases;
+            updated = true;
+          }
+        }
+      }
+
+      if (updated)
+      {
+        converged = false;
+        weights += weightsUpdate;
+        biases += biasesUpdate;
+      }
+
+      weightsSum += weights;
+      biasesSum += biases;
+      ++numBlocks;
+    }
+  }
+
+  if (numBlocks > 0)
+  {
+    weights = weightsSum / numBlocks;
+    biases = biasesSum / numBlocks;
+  }
+}
+
 //! Serialize the perceptron.
 template<typename LearnPolicy,
          typename WeightInitializationPolicy,
@@ -12,6 +12,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/io.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/math/streaming_statistics.hpp>
+#include <mlpack/core/data/chunked_loader.hpp>
 
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -45,7 +47,16 @@ BINDING_LONG_DESC(
     "specific dimension to analyze if there are too many dimensions. The " +
     PRINT_PARAM_STRING("population") + " parameter can be specified when the "
     "dataset should be considered as a population.  Otherwise, the dataset "
-    "will be considered as a sample.");
+    "will be considered as a sample."
+    "\n\n"
+    "The statistics are computed in one pass over the data, in parallel over "
+    "the dimensions.  Instead of the " + PRINT_PARAM_STRING("input") + " "
+    "matrix, a file may be given with the " + PRINT_PARAM_STRING("input_file") +
+    " parameter; it is then read " + PRINT_PARAM_STRING("chunk_size") + " "
+    "points at a time, so it does not need to fit in memory.  The medians are "
+    "exact for fewer points than " + PRINT_PARAM_STRING("sketch_size") + ", "
+    "and are found with a quantile sketch otherwise (the rank of the reported "
+    "median is then within a fraction of a percent of the true one).");
 
 // Example.
 BINDING_EXAMPLE(
@@ -67,7 +78,14 @@ BINDING_SEE_ALSO("@preprocess_imputer", "#preprocess_imputer");
 BINDING_SEE_ALSO("@preprocess_split", "#preprocess_split");
 
 // Define parameters for data.
-PARAM_MATRIX_IN_REQ("input", "Matrix containing data,", "i");
+PARAM_MATRIX_IN("input", "Matrix containing data.", "i");
+PARAM_STRING_IN("input_file", "File containing data, which is read in chunks "
+    "of points instead of being loaded all at once.", "f", "");
+PARAM_INT_IN("chunk_size", "Number of points read at a time from the input "
+    "file.", "c", 100000);
+PARAM_INT_IN("sketch_size", "Capacity of the compactors of the sketches used "
+    "to find the medians.  The medians are exact for fewer points, and "
+    "approximate otherwise.", "k", 1024);
 PARAM_INT_IN("dimension", "Dimension of the data. Use this to specify a "
     "dimension", "d", 0);
 PARAM_INT_IN("precision", "Precision of the output statistics.", "p", 4);
@@ -79,107 +97,78 @@ PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "across rows, not across columns.  (Remember that in mlpack, a column "
     "represents a point, so this option is generally not necessary.)", "r");
 
-/**
- * Calculates the sum of deviations to the Nth Power.
- *
- * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
- */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
+static void mlpackMain()
 {
-  return arma::sum(arma::pow(input - fMean, static_cast<double>(n)));
-}
+  const size_t dimension = static_cast<size_t>(IO::GetParam<int>("dimension"));
+  const size_t precision = static_cast<size_t>(IO::GetParam<int>("precision"));
+  const size_t width = static_cast<size_t>(IO::GetParam<int>("width"));
+  const bool population = IO::HasParam("population");
+  const bool rowMajor = IO::HasParam("row_major");
 
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
+  RequireOnlyOnePassed({ "input", "input_file" }, true);
+  ReportIgnoredParam({{ "input_file", false }}, "chunk_size");
+  RequireParamValue<int>("chunk_size", [](int x) { return x > 0; }, true,
+      "chunk size must be positive");
+  RequireParamValue<int>("sketch_size", [](int x) { return x >= 2; }, true,
+      "sketch size must be at least 2");
+  RequireParamValue<int>("dimension", [](int x) { return x >= 0; }, true,
+      "dimension must not be negative");
+  if (IO::HasParam("input_file") && rowMajor)
   {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
+    Log::Fatal << "--row_major can't be used with --input_file; transpose the "
+        << "file instead." << endl;
   }
-  else
+
+  // The statistics of all the dimensions, or only of the given one, are
+  // computed in one pass over the data.
+  const bool oneDimension = IO::HasParam("dimension");
+  const size_t sketchSize = (size_t) IO::GetParam<int>("sketch_size");
+  auto CheckDimension = [&](const size_t dimensions)
   {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
+    if (oneDimension && dimension >= dimensions)
+    {
+      Log::Fatal << "Invalid dimension " << dimension << "; the data has "
+          << dimensions << " dimensions." << endl;
+    }
+  };
 
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
+  Timer::Start("statistics");
+  math::StreamingStatistics stats;
+  if (IO::HasParam("input"))
   {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
+    const arma::mat& data = IO::GetParam<arma::mat>("input");
+    const arma::mat points = rowMajor ? arma::mat(data.t()) : arma::mat();
+    const arma::mat& input = rowMajor ? points : data;
+
+    CheckDimension(input.n_rows);
+    stats = math::StreamingStatistics(oneDimension ? 1 : input.n_rows,
+        sketchSize);
+    if (oneDimension)
+      stats.Update(input.row(dimension));
+    else
+      stats.Update(input);
   }
   else
   {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
+    ChunkedLoader<double> loader(IO::GetParam<string>("input_file"),
+        (size_t) IO::GetParam<int>("chunk_size"));
+
+    CheckDimension(loader.Dimensionality());
+    stats = math::StreamingStatistics(oneDimension ? 1 :
+        loader.Dimensionality(), sketchSize);
+    arma::mat chunk;
+    while (loader.Next(chunk))
+    {
+      if (oneDimension)
+        stats.Update(chunk.row(dimension));
+      else
+        stats.Update(chunk);
+    }
   }
-  return kurtosis;
-}
-
-/**
- * Calculates standard error of standard deviation.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @return Standard error of the stanrdard devation of the given vector.
- */
-double StandardError(const size_t size, const double& fStd)
-{
-  return fStd / sqrt(size);
-}
-
-static void mlpackMain()
-{
-  const size_t dimension = static_cast<size_t>(IO::GetParam<int>("dimension"));
-  const size_t precision = static_cast<size_t>(IO::GetParam<int>("precision"));
-  const size_t width = static_cast<size_t>(IO::GetParam<int>("width"));
-  const bool population = IO::HasParam("population");
-  const bool rowMajor = IO::HasParam("row_major");
+  Timer::Stop("statistics");
 
-  // Load the data.
-  arma::mat& data = IO::GetParam<arma::mat>("input");
+  if (stats.Count() == 0)
+    Log::Fatal << "The data has no points." << endl;
 
   // Generate boost format recipe.
   const string widthPrecision("%-" + to_string(width) + "." +
@@ -195,56 +184,31 @@ static void mlpackMain()
     numberFormat += widthPrecision + "f";
   }
 
-  Timer::Start("statistics");
   // Print the headers.
   Log::Info << boost::format(stringFormat)
       % "dim" % "var" % "mean" % "std" % "median" % "min" % "max"
       % "range" % "skew" % "kurt" % "SE" << endl;
 
-  // Lambda function to print out the results.
-  auto PrintStatResults = [&](size_t dim, bool rowMajor)
+  for (size_t i = 0; i < stats.Dimensionality(); ++i)
   {
-    arma::rowvec feature;
-    if (rowMajor)
-      feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
-    else
-      feature = data.row(dim);
-
     // f at the front of the variable names means "feature".
-    const double fMax = arma::max(feature);
-    const double fMin = arma::min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
+    const double fMax = stats.Max(i);
+    const double fMin = stats.Min(i);
+    const double fStd = stats.Stddev(i, population);
 
     // Print statistics of the given dimension.
     Log::Info << boost::format(numberFormat)
-        % dim
-        % arma::var(feature, population)
-        % fMean
+        % (oneDimension ? dimension : i)
+        % stats.Variance(i, population)
+        % stats.Mean(i)
         % fStd
-        % arma::median(feature)
+        % stats.Median(i)
         % fMin
         % fMax
         % (fMax - fMin) // range
-        % Skewness(feature, fStd, fMean, population)
-        % Kurtosis(feature, fStd, fMean, population)
-        % StandardError(feature.n_elem, fStd)
+        % stats.Skewness(i, population)
+        % stats.Kurtosis(i, population)
+        % (fStd / sqrt(stats.Count())) // standard error
         << endl;
-  };
-
-  // If the user specified dimension, describe statistics of the given
-  // dimension. If a dimension is not specified, describe all dimensions.
-  if (IO::HasParam("dimension"))
-  {
-    PrintStatResults(dimension, rowMajor);
   }
-  else
-  {
-    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
-    for (size_t i = 0; i < dimensions; ++i)
-    {
-      PrintStatResults(i, rowMajor);
-    }
-  }
-  Timer::Stop("statistics");
 }
@@ -28,7 +28,11 @@ BINDING_LONG_DESC(
     "the IDs of the dimensions to be one-hot encoded."
     "\n\n"
     "The output matrix with encoded features may be saved with the " +
-    PRINT_PARAM_STRING("output") + " parameters.");
+    PRINT_PARAM_STRING("output") + " parameters.  When many categories are "
+    "encoded, most of the encoded matrix is zero; the " +
+    PRINT_PARAM_STRING("sparse_output_file") + " parameter can then be used to "
+    "save it as a sparse matrix (in coordinate list format) instead, without "
+    "ever building the dense matrix.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -51,6 +55,9 @@ PARAM_MATRIX_IN_REQ("input", "Matrix containing data.", "i");
 PARAM_MATRIX_OUT("output", "Matrix to save one-hot encoded features "
     "data to.", "o");
 
+PARAM_STRING_IN("sparse_output_file", "File to save the one-hot encoded "
+    "features to, as a sparse matrix in coordinate list format.", "s", "");
+
 PARAM_VECTOR_IN_REQ(int, "dimensions", "Index of dimensions that"
     "need to be one-hot encoded.", "d");
 
@@ -69,7 +76,7 @@ static void mlpackMain()
       {
         for (int dim : x)
         {
-          if (dim < 0 || (size_t)dim > data.n_rows)
+          if (dim < 0 || (size_t)dim >= data.n_rows)
           {
             return false;
           }
@@ -81,6 +88,17 @@ static void mlpackMain()
   {
     copyIndices[i] = (size_t)indices[i];
   }
+
+  if (IO::HasParam("sparse_output_file"))
+  {
+    arma::sp_mat output;
+    data::OneHotEncoding(data, (arma::Col<size_t>)(copyIndices), output);
+    data::Save(IO::GetParam<string>("sparse_output_file"), output, true);
+    if (IO::HasParam("output"))
+      IO::GetParam<arma::mat>("output") = arma::mat(output);
+    return;
+  }
+
   arma::mat output;
   data::OneHotEncoding(data, (arma::Col<size_t>)(copyIndices), output);
   if (IO::HasParam("output"))
@@ -81,6 +81,11 @@ class ScalingModel
   template<typename MatType>
   void Fit(const MatType& input);
 
+  // Fit on one more chunk of the dataset, continuing from the previous calls
+  // to Fit() or PartialFit().
+  template<typename MatType>
+  void PartialFit(const MatType& input);
+
   // Scale back the dataset to their original values.
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output);
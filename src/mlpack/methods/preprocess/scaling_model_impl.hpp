@@ -174,6 +174,47 @@ void ScalingModel::Fit(const MatType& input)
   }
 }
 
+template<typename MatType>
+void ScalingModel::PartialFit(const MatType& input)
+{
+  if (scalerType == ScalerTypes::STANDARD_SCALER)
+  {
+    if (!standardscale)
+      standardscale = new data::StandardScaler();
+    standardscale->PartialFit(input);
+  }
+  else if (scalerType == ScalerTypes::MIN_MAX_SCALER)
+  {
+    if (!minmaxscale)
+      minmaxscale = new data::MinMaxScaler(minValue, maxValue);
+    minmaxscale->PartialFit(input);
+  }
+  else if (scalerType == ScalerTypes::MEAN_NORMALIZATION)
+  {
+    if (!meanscale)
+      meanscale = new data::MeanNormalization();
+    meanscale->PartialFit(input);
+  }
+  else if (scalerType == ScalerTypes::MAX_ABS_SCALER)
+  {
+    if (!maxabsscale)
+      maxabsscale = new data::MaxAbsScaler();
+    maxabsscale->PartialFit(input);
+  }
+  else if (scalerType == ScalerTypes::PCA_WHITENING)
+  {
+    if (!pcascale)
+      pcascale = new data::PCAWhitening(epsilon);
+    pcascale->PartialFit(input);
+  }
+  else if (scalerType == ScalerTypes::ZCA_WHITENING)
+  {
+    if (!zcascale)
+      zcascale = new data::ZCAWhitening(epsilon);
+    zcascale->PartialFit(input);
+  }
+}
+
 template<typename MatType>
 void ScalingModel::Transform(const MatType& input, MatType& output)
 {
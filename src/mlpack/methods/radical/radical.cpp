@@ -13,6 +13,7 @@
 #include "radical.hpp"
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
+#include <mlpack/core/math/random.hpp>
 
 using namespace std;
 using namespace arma;
@@ -45,16 +46,9 @@ void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 
 double Radical::Vasicek(vec& z) const
 {
-  z = sort(z);
+  // Sort in place, to avoid allocating a sorted copy for each estimate.
+  std::sort(z.begin(), z.end());
 
-  // Apparently slower.
-  /*
-  vec logs = log(z.subvec(m, z.n_elem - 1) - z.subvec(0, z.n_elem - 1 - m));
-  //vec val = sum(log(z.subvec(m, nPoints - 1) - z.subvec(0, nPoints - 1 - m)));
-  return (double) sum(logs);
-  */
-
-  // Apparently faster.
   double sum = 0;
   uword range = z.n_elem - m;
   for (uword i = 0; i < range; ++i)
@@ -69,25 +63,25 @@ double Radical::Vasicek(vec& z) const
 double Radical::DoRadical2D(const mat& matX)
 {
   CopyAndPerturb(perturbed, matX);
+  return OptimalAngle(perturbed);
+}
 
-  mat::fixed<2, 2> matJacobi;
 
+double Radical::OptimalAngle(const mat& perturbedX) const
+{
   vec values(angles);
 
-  for (size_t i = 0; i < angles; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) angles; ++i)
   {
     const double theta = (i / (double) angles) * M_PI / 2.0;
     const double cosTheta = cos(theta);
     const double sinTheta = sin(theta);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
-
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+    vec candidateY1 = cosTheta * perturbedX.col(0) -
+        sinTheta * perturbedX.col(1);
+    vec candidateY2 = sinTheta * perturbedX.col(0) +
+        cosTheta * perturbedX.col(1);
 
     values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
   }
@@ -132,42 +126,60 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
   Timer::Start("radical_do_radical");
   matW = matWhitening;
 
-  mat matYSubspace(nPoints, 2);
-
-  mat matJ = eye(nDims, nDims);
+  // The pairs of dimensions are visited in rounds of disjoint pairs, with the
+  // circle method of round-robin tournaments (with a dummy dimension if the
+  // number of dimensions is odd).
+  const size_t players = nDims + (nDims % 2);
+  const size_t rounds = (players == 0) ? 0 : players - 1;
 
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
 
-    for (size_t i = 0; i < nDims - 1; ++i)
+    for (size_t round = 0; round < rounds; ++round)
     {
-      for (size_t j = i + 1; j < nDims; ++j)
+      std::vector<std::pair<size_t, size_t>> pairs;
+      for (size_t k = 0; k < players / 2; ++k)
       {
-        Log::Debug << "RADICAL 2D on dimensions " << i << " and " << j << "."
-            << std::endl;
+        const size_t i = (round + k) % rounds;
+        const size_t j = (k == 0) ? rounds : (round + rounds - k) % rounds;
+        if (i < nDims && j < nDims)
+        {
+          pairs.push_back(std::make_pair(std::min(i, j), std::max(i, j)));
+          Log::Debug << "RADICAL 2D on dimensions " << pairs.back().first
+              << " and " << pairs.back().second << "." << std::endl;
+        }
+      }
+
+      // Each pair gets its own random stream of this round.
+      const uint64_t seed = ((uint64_t) math::randGen() << 32) |
+          math::randGen();
 
-        matYSubspace.col(0) = matY.col(i);
-        matYSubspace.col(1) = matY.col(j);
+      #pragma omp parallel for schedule(dynamic) if (pairs.size() > 1)
+      for (omp_size_t p = 0; p < (omp_size_t) pairs.size(); ++p)
+      {
+        const size_t i = pairs[p].first;
+        const size_t j = pairs[p].second;
 
-        const double thetaOpt = DoRadical2D(matYSubspace);
+        math::Philox generator(seed, (uint64_t) p);
+        mat perturbedY(replicates * nPoints, 2);
+        math::RandNormalVector(perturbedY, generator, 0.0, noiseStdDev);
+        perturbedY.col(0) += repmat(matY.col(i), replicates, 1);
+        perturbedY.col(1) += repmat(matY.col(j), replicates, 1);
+
+        const double thetaOpt = OptimalAngle(perturbedY);
 
         const double cosThetaOpt = cos(thetaOpt);
         const double sinThetaOpt = sin(thetaOpt);
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
-
-        matY *= matJ;
+        // Rotate dimensions i and j of the data and of the unmixing matrix.
+        const vec yi = matY.col(i);
+        matY.col(i) = cosThetaOpt * yi - sinThetaOpt * matY.col(j);
+        matY.col(j) = sinThetaOpt * yi + cosThetaOpt * matY.col(j);
 
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        const vec wi = matW.col(i);
+        matW.col(i) = cosThetaOpt * wi - sinThetaOpt * matW.col(j);
+        matW.col(j) = sinThetaOpt * wi + cosThetaOpt * matW.col(j);
       }
     }
   }
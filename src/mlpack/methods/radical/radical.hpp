@@ -63,7 +63,11 @@ class Radical
           const size_t m = 0);
 
   /**
-   * Run RADICAL.
+   * Run RADICAL.  Each sweep visits the pairs of dimensions in rounds of
+   * disjoint pairs (as in a round-robin tournament); the pairs of a round
+   * rotate different dimensions, so they are optimized in parallel, if OpenMP
+   * is available.  Each pair draws its perturbations from its own random
+   * stream, so the result does not depend on the number of threads.
    *
    * @param matX Input data into the algorithm - a matrix where each column is
    *    a point and each row is a dimension.
@@ -75,7 +79,7 @@ class Radical
 
   /**
    * Vasicek's m-spacing estimator of entropy, with overlap modification from
-   * (Learned-Miller and Fisher, 2003).
+   * (Learned-Miller and Fisher, 2003).  The sample is sorted in place.
    *
    * @param x Empirical sample (one-dimensional) over which to estimate entropy.
    */
@@ -88,7 +92,8 @@ class Radical
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  //! Two-dimensional version of RADICAL.  The angles are searched in
+  //! parallel, if OpenMP is available.
   double DoRadical2D(const arma::mat& matX);
 
   //! Get the standard deviation of the additive Gaussian noise.
@@ -131,8 +136,13 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
+
+  /**
+   * Find the angle of the rotation of the given perturbed two-dimensional
+   * data (one column per dimension) that minimizes the sum of the entropies of
+   * its dimensions.
+   */
+  double OptimalAngle(const arma::mat& perturbedX) const;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
@@ -13,11 +13,17 @@
 #ifndef MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 #define MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 
+#include <mlpack/core/math/random.hpp>
+
+#include <vector>
+
 namespace mlpack {
 namespace tree {
 
 /**
  * Given a dataset, create another dataset via bootstrap sampling, with labels.
+ * The points that were not sampled (the out-of-bag points) are marked in the
+ * given bitset.
  */
 template<bool UseWeights,
          typename MatType,
@@ -28,25 +34,48 @@ void Bootstrap(const MatType& dataset,
                const WeightsType& weights,
                MatType& bootstrapDataset,
                LabelsType& bootstrapLabels,
-               WeightsType& bootstrapWeights)
+               WeightsType& bootstrapWeights,
+               std::vector<bool>& outOfBag)
 {
   bootstrapDataset.set_size(dataset.n_rows, dataset.n_cols);
   bootstrapLabels.set_size(labels.n_elem);
   if (UseWeights)
     bootstrapWeights.set_size(weights.n_elem);
+  outOfBag.assign(dataset.n_cols, true);
 
-  // Random sampling with replacement.
-  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  // Random sampling with replacement.  This is called once per tree from an
+  // OpenMP region, so the indices are drawn from the random object of the
+  // calling thread (or of the tree, see math::RandomTaskScope).
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
-    bootstrapDataset.col(i) = dataset.col(indices[i]);
-    bootstrapLabels[i] = labels[indices[i]];
+    const size_t index = (size_t) math::RandInt(dataset.n_cols);
+    bootstrapDataset.col(i) = dataset.col(index);
+    bootstrapLabels[i] = labels[index];
     if (UseWeights)
-      bootstrapWeights[i] = weights[indices[i]];
+      bootstrapWeights[i] = weights[index];
+    outOfBag[index] = false;
   }
 }
 
+/**
+ * Given a dataset, create another dataset via bootstrap sampling, with labels.
+ */
+template<bool UseWeights,
+         typename MatType,
+         typename LabelsType,
+         typename WeightsType>
+void Bootstrap(const MatType& dataset,
+               const LabelsType& labels,
+               const WeightsType& weights,
+               MatType& bootstrapDataset,
+               LabelsType& bootstrapLabels,
+               WeightsType& bootstrapWeights)
+{
+  std::vector<bool> outOfBag;
+  Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
+      bootstrapLabels, bootstrapWeights, outOfBag);
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,184 @@
+/**
+ * @file methods/random_forest/flat_random_forest.hpp
+ *
+ * Definition of the FlatRandomForest class, a read-only copy of a trained
+ * RandomForest for fast classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/flat_decision_tree.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A FlatRandomForest gives the same predictions as a trained RandomForest, but
+ * each of its trees is a FlatDecisionTree, which holds its nodes in one
+ * contiguous array.  Sets of points are classified by blocks: each tree
+ * classifies all the points of a block before the next tree, so the nodes of
+ * the tree stay in the cache while they are used.
+ *
+ * Alternately, the forest can be evaluated with bitvectors, as QuickScorer
+ * does.  Then the nodes are not traversed at all: the split points of all the
+ * trees are sorted by dimension, and for each dimension of a point, a scan of
+ * its split points removes the leaves of the left subtree of each node the
+ * point goes right of from the bitvector of the tree; the leftmost remaining
+ * leaf is the leaf of the point.  This only works if all the splits are binary
+ * numeric splits.
+ *
+ * @code
+ * @inproceedings{lucchese2015quickscorer,
+ *   title={QuickScorer: A Fast Algorithm to Rank Documents with Additive
+ *       Ensembles of Regression Trees},
+ *   author={Lucchese, Claudio and Nardini, Franco Maria and Orlando, Salvatore
+ *       and Perego, Raffaele and Tonellotto, Nicola and Venturini, Rossano},
+ *   booktitle={Proceedings of the 38th International ACM SIGIR Conference on
+ *       Research and Development in Information Retrieval},
+ *   pages={73--82},
+ *   year={2015}
+ * }
+ * @endcode
+ */
+class FlatRandomForest
+{
+ public:
+  /**
+   * Create an empty flat forest; it can't classify anything.
+   */
+  FlatRandomForest() : useBitvectors(false) { }
+
+  /**
+   * Pack the trees of the given trained RandomForest.  The flat forest does not
+   * refer to the original forest, which may be destroyed.
+   *
+   * @param forest Forest to pack.
+   * @param useBitvectors Whether to evaluate the forest with bitvectors instead
+   *     of traversing the trees.  Then all the splits must be binary numeric
+   *     splits.
+   */
+  template<typename ForestType>
+  explicit FlatRandomForest(const ForestType& forest,
+                            const bool useBitvectors = false);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities for each class.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Access a tree in the forest.
+  const FlatDecisionTree& Tree(const size_t i) const { return trees[i]; }
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return trees.size(); }
+
+  //! Get whether the forest is evaluated with bitvectors.
+  bool UseBitvectors() const { return useBitvectors; }
+
+  //! The number of points of each block of a dataset that each tree classifies
+  //! in turn.
+  static const size_t BlockSize = 64;
+
+ private:
+  /**
+   * A split point of a tree: the points whose value is greater than the
+   * threshold in its dimension can't reach the leaves in [firstLeaf, lastLeaf)
+   * of the tree.
+   */
+  struct Condition
+  {
+    double threshold;
+    size_t tree;
+    size_t firstLeaf;
+    size_t lastLeaf;
+  };
+
+  /**
+   * Build the sorted conditions and the bitvectors used by the bitvector
+   * evaluation.
+   */
+  void BuildBitvectors();
+
+  /**
+   * Add the class probabilities of the given point given by each tree to the
+   * given probabilities.
+   *
+   * @param point Point to be classified.
+   * @param probabilities Probabilities to add to.
+   * @param bits Space for the bitvectors of the trees (only used by the
+   *     bitvector evaluation).
+   */
+  template<typename VecType, typename ColType>
+  void AddProbabilities(const VecType& point,
+                        ColType&& probabilities,
+                        std::vector<uint64_t>& bits) const;
+
+  //! The trees in the forest.
+  std::vector<FlatDecisionTree> trees;
+
+  //! Whether the forest is evaluated with bitvectors.
+  bool useBitvectors;
+
+  //! The conditions of all the trees, sorted by dimension and threshold.
+  std::vector<Condition> conditions;
+  //! The conditions of dimension i are [dimensionBegins[i],
+  //! dimensionBegins[i + 1]).
+  std::vector<size_t> dimensionBegins;
+  //! The bitvector of tree i is the words [wordBegins[i], wordBegins[i + 1]).
+  std::vector<size_t> wordBegins;
+  //! The bitvectors with all the leaves of each tree set.
+  std::vector<uint64_t> initialBits;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_random_forest_impl.hpp"
+
+#endif
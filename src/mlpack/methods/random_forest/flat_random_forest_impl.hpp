@@ -0,0 +1,273 @@
+/**
+ * @file methods/random_forest/flat_random_forest_impl.hpp
+ *
+ * Implementation of the FlatRandomForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_RANDOM_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename ForestType>
+FlatRandomForest::FlatRandomForest(const ForestType& forest,
+                                   const bool useBitvectors) :
+    useBitvectors(useBitvectors)
+{
+  if (forest.NumTrees() == 0)
+  {
+    throw std::invalid_argument("FlatRandomForest::FlatRandomForest(): no "
+        "random forest trained!");
+  }
+
+  trees.reserve(forest.NumTrees());
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    trees.push_back(FlatDecisionTree(forest.Tree(i)));
+
+  if (useBitvectors)
+    BuildBitvectors();
+}
+
+inline void FlatRandomForest::BuildBitvectors()
+{
+  conditions.clear();
+  std::vector<size_t> conditionDimensions;
+  wordBegins.assign(1, 0);
+  size_t dimensions = 0;
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    const std::vector<FlatDecisionTree::Node>& nodes = trees[t].Nodes();
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      if (nodes[i].numChildren == 0)
+        continue;
+
+      if (nodes[i].categorical || nodes[i].numChildren != 2)
+      {
+        throw std::invalid_argument("FlatRandomForest::FlatRandomForest(): "
+            "the bitvector evaluation needs binary numeric splits only!");
+      }
+
+      // The leaves are numbered from left to right, so the leaves of the left
+      // subtree are the leaves between its leftmost and its rightmost leaf.
+      size_t first = nodes[i].child;
+      while (nodes[first].numChildren != 0)
+        first = nodes[first].child;
+      size_t last = nodes[i].child;
+      while (nodes[last].numChildren != 0)
+        last = nodes[last].child + nodes[last].numChildren - 1;
+
+      Condition condition;
+      condition.threshold = nodes[i].threshold;
+      condition.tree = t;
+      condition.firstLeaf = nodes[first].child;
+      condition.lastLeaf = nodes[last].child + 1;
+      conditions.push_back(condition);
+      conditionDimensions.push_back(nodes[i].dimension);
+
+      dimensions = std::max(dimensions, nodes[i].dimension + 1);
+    }
+
+    wordBegins.push_back(wordBegins.back() + (trees[t].NumLeaves() + 63) / 64);
+  }
+
+  // Sort the conditions by dimension, and by threshold within each dimension.
+  std::vector<size_t> order(conditions.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  std::sort(order.begin(), order.end(), [&](const size_t a, const size_t b)
+  {
+    if (conditionDimensions[a] != conditionDimensions[b])
+      return conditionDimensions[a] < conditionDimensions[b];
+    return conditions[a].threshold < conditions[b].threshold;
+  });
+
+  std::vector<Condition> sortedConditions(conditions.size());
+  dimensionBegins.assign(dimensions + 1, 0);
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    sortedConditions[i] = conditions[order[i]];
+    ++dimensionBegins[conditionDimensions[order[i]] + 1];
+  }
+  for (size_t d = 0; d < dimensions; ++d)
+    dimensionBegins[d + 1] += dimensionBegins[d];
+  conditions.swap(sortedConditions);
+
+  // Initially, every leaf of each tree can be reached.
+  initialBits.assign(wordBegins.back(), 0);
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    for (size_t j = 0; j < trees[t].NumLeaves(); ++j)
+      initialBits[wordBegins[t] + j / 64] |= (uint64_t(1) << (j % 64));
+  }
+}
+
+template<typename VecType, typename ColType>
+void FlatRandomForest::AddProbabilities(const VecType& point,
+                                        ColType&& probabilities,
+                                        std::vector<uint64_t>& bits) const
+{
+  if (!useBitvectors)
+  {
+    for (size_t t = 0; t < trees.size(); ++t)
+    {
+      const FlatDecisionTree& tree = trees[t];
+      probabilities += tree.LeafProbabilities().col(
+          tree.Nodes()[tree.FindLeaf(point)].child);
+    }
+    return;
+  }
+
+  // Remove the leaves that the point can't reach, one dimension at a time.
+  // The scan of a dimension stops at the first split point that sends the
+  // point left, so a NaN value goes right everywhere, as in the trees.
+  bits = initialBits;
+  for (size_t d = 0; d + 1 < dimensionBegins.size(); ++d)
+  {
+    const double value = point[d];
+    for (size_t c = dimensionBegins[d]; c < dimensionBegins[d + 1]; ++c)
+    {
+      const Condition& condition = conditions[c];
+      if (value <= condition.threshold)
+        break;
+
+      uint64_t* treeBits = bits.data() + wordBegins[condition.tree];
+      for (size_t j = condition.firstLeaf; j < condition.lastLeaf; ++j)
+        treeBits[j / 64] &= ~(uint64_t(1) << (j % 64));
+    }
+  }
+
+  // The leaf of the point in each tree is the leftmost leaf remaining.
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    size_t leaf = 0;
+    size_t w = wordBegins[t];
+    while (bits[w] == 0)
+    {
+      ++w;
+      leaf += 64;
+    }
+
+    uint64_t word = bits[w];
+    while ((word & 1) == 0)
+    {
+      word >>= 1;
+      ++leaf;
+    }
+
+    probabilities += trees[t].LeafProbabilities().col(leaf);
+  }
+}
+
+template<typename VecType>
+size_t FlatRandomForest::Classify(const VecType& point) const
+{
+  // Pass off to another Classify() overload.
+  size_t predictedClass;
+  arma::vec probabilities;
+  Classify(point, predictedClass, probabilities);
+
+  return predictedClass;
+}
+
+template<typename VecType>
+void FlatRandomForest::Classify(const VecType& point,
+                                size_t& prediction,
+                                arma::vec& probabilities) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("FlatRandomForest::Classify(): no random "
+        "forest packed!");
+  }
+
+  std::vector<uint64_t> bits;
+  probabilities.zeros(trees[0].NumClasses());
+  AddProbabilities(point, probabilities, bits);
+
+  // Find maximum element after renormalizing probabilities.
+  probabilities /= trees.size();
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+
+  // Set prediction.
+  prediction = (size_t) maxIndex;
+}
+
+template<typename MatType>
+void FlatRandomForest::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void FlatRandomForest::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& probabilities) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatRandomForest::Classify(): no random "
+        "forest packed!");
+  }
+
+  probabilities.zeros(trees[0].NumClasses(), data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+    if (useBitvectors)
+    {
+      std::vector<uint64_t> bits;
+      for (size_t i = begin; i < end; ++i)
+        AddProbabilities(data.col(i), probabilities.col(i), bits);
+    }
+    else
+    {
+      // Each tree classifies the whole block in turn.
+      for (size_t t = 0; t < trees.size(); ++t)
+      {
+        const FlatDecisionTree& tree = trees[t];
+        for (size_t i = begin; i < end; ++i)
+        {
+          probabilities.col(i) += tree.LeafProbabilities().col(
+              tree.Nodes()[tree.FindLeaf(data.col(i))].child);
+        }
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= trees.size();
+      predictions[i] = (size_t) probabilities.col(i).index_max();
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
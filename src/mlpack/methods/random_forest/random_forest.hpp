@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+#include <mlpack/core/data/model_archive.hpp>
 #include "bootstrap.hpp"
 
 namespace mlpack {
@@ -315,14 +316,73 @@ class RandomForest
    * predicted class probabilities for each point.  If the random forest has not
    * been trained, this will throw an exception.
    *
+   * The points are split into blocks of BlockSize points, which are classified
+   * in parallel when OpenMP is available; each tree classifies the whole block
+   * in turn, so that the nodes of the tree stay in the cache, and adds the
+   * class probabilities of its leaves to the columns of the block.  The
+   * probabilities are accumulated in the element type of the given matrix, so
+   * an arma::fmat can be passed to halve the memory traffic of large forests.
+   *
    * @param data Dataset to be classified.
    * @param predictions Output predictions for each point in the dataset.
    * @param probabilities Output matrix of class probabilities for each point.
    */
-  template<typename MatType>
+  template<typename MatType, typename ProbabilityType>
   void Classify(const MatType& data,
                 arma::Row<size_t>& predictions,
-                arma::mat& probabilities) const;
+                arma::Mat<ProbabilityType>& probabilities) const;
+
+  //! The number of points of each block of a dataset that each tree classifies
+  //! in turn.
+  static const size_t BlockSize = 64;
+
+  /**
+   * Compute the out-of-bag error of the forest: each point of the training set
+   * is classified by the trees whose bootstrap sample did not contain it, and
+   * the fraction of misclassified points is returned.  This estimates the
+   * generalization error without holding out a validation set or retraining
+   * the forest (as cross-validation does).  The points that are in the
+   * bootstrap sample of every tree are ignored.
+   *
+   * The out-of-bag points of each tree are only known after Train() (they are
+   * not serialized), and the given dataset and labels must be those the forest
+   * was trained on; otherwise, an exception is thrown.  The points are
+   * classified in parallel, if OpenMP is available.
+   *
+   * @param data Dataset the forest was trained on.
+   * @param labels Labels of the dataset.
+   * @return The out-of-bag error, between 0 and 1.
+   */
+  template<typename MatType>
+  double OOBError(const MatType& data, const arma::Row<size_t>& labels) const;
+
+  /**
+   * Compute the permutation importance of each dimension of the data (the
+   * "mean decrease in accuracy" of Breiman): for each tree, the values of the
+   * dimension are shuffled among the out-of-bag points of the tree, and the
+   * importance of the dimension is the decrease of the accuracy of the tree on
+   * these points, averaged over the trees.  Dimensions the forest does not
+   * rely on have an importance near 0.
+   *
+   * As for OOBError(), the forest must have been trained on the given dataset
+   * and labels in this session.  The trees are handled in parallel, if OpenMP
+   * is available; the importances only depend on the random seed.
+   *
+   * @param data Dataset the forest was trained on.
+   * @param labels Labels of the dataset.
+   * @param importances Vector to store the importance of each dimension.
+   */
+  template<typename MatType>
+  void PermutationImportance(const MatType& data,
+                             const arma::Row<size_t>& labels,
+                             arma::vec& importances) const;
+
+  //! Get whether each training point is out of the bootstrap sample of the
+  //! given tree (only available after Train()).
+  const std::vector<bool>& OutOfBag(const size_t i) const
+  {
+    return outOfBag[i];
+  }
 
   //! Access a tree in the forest.
   const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
@@ -338,6 +398,49 @@ class RandomForest
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
+  /**
+   * Write the random forest to the given model archive, with each tree as a
+   * separate component, so that the trees can be loaded on demand (see
+   * LoadTree()) or in parallel (see Load()).
+   *
+   * @param archive Archive to write the forest to.
+   * @param name Name of the forest in the archive.
+   */
+  void Save(data::ModelArchiveWriter& archive, const std::string& name) const;
+
+  /**
+   * Load the random forest written by Save() from the given model archive.
+   * The trees are deserialized in parallel, if OpenMP is available.
+   *
+   * @param archive Archive to read the forest from.
+   * @param name Name of the forest in the archive.
+   */
+  void Load(const data::ModelArchive& archive, const std::string& name);
+
+  /**
+   * Get the number of trees of the random forest of the given name in the
+   * given model archive, without loading any tree.
+   *
+   * @param archive Archive holding the forest.
+   * @param name Name of the forest in the archive.
+   */
+  static size_t NumTrees(const data::ModelArchive& archive,
+                         const std::string& name);
+
+  /**
+   * Load only the given tree of the random forest of the given name in the
+   * given model archive.
+   *
+   * @param archive Archive holding the forest.
+   * @param name Name of the forest in the archive.
+   * @param i Index of the tree to load.
+   * @param tree Will hold the tree.
+   */
+  static void LoadTree(const data::ModelArchive& archive,
+                       const std::string& name,
+                       const size_t i,
+                       DecisionTreeType& tree);
+
  private:
   /**
    * Perform the training of the decision tree.  The template bool parameters
@@ -371,8 +474,21 @@ class RandomForest
                const size_t maximumDepth,
                DimensionSelectionType& dimensionSelector);
 
+  /**
+   * Make sure that the out-of-bag points of the trees are known for the given
+   * dataset and labels, and throw an exception otherwise.
+   */
+  template<typename MatType>
+  void CheckOutOfBag(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const std::string& functionName) const;
+
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
+
+  //! For each tree, whether each training point is out of its bootstrap
+  //! sample.
+  std::vector<std::vector<bool>> outOfBag;
 };
 
 } // namespace tree
@@ -317,13 +317,7 @@ void RandomForest<
 
   probabilities.zeros(trees[0].NumClasses());
   for (size_t i = 0; i < trees.size(); ++i)
-  {
-    arma::vec treeProbs;
-    size_t treePrediction; // Ignored.
-    trees[i].Classify(point, treePrediction, treeProbs);
-
-    probabilities += treeProbs;
-  }
+    probabilities += trees[i].FindLeaf(point).ClassProbabilities();
 
   // Find maximum element after renormalizing probabilities.
   probabilities /= trees.size();
@@ -360,13 +354,8 @@ void RandomForest<
         "trained!");
   }
 
-  predictions.set_size(data.n_cols);
-
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
-  {
-    predictions[i] = Classify(data.col(i));
-  }
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
 }
 
 template<
@@ -376,7 +365,7 @@ template<
     template<typename> class CategoricalSplitType,
     typename ElemType
 >
-template<typename MatType>
+template<typename MatType, typename ProbabilityType>
 void RandomForest<
     FitnessFunction,
     DimensionSelectionType,
@@ -385,7 +374,7 @@ void RandomForest<
     ElemType
 >::Classify(const MatType& data,
             arma::Row<size_t>& predictions,
-            arma::mat& probabilities) const
+            arma::Mat<ProbabilityType>& probabilities) const
 {
   // Check edge case.
   if (trees.size() == 0)
@@ -397,13 +386,236 @@ void RandomForest<
         "trained!");
   }
 
-  probabilities.set_size(trees[0].NumClasses(), data.n_cols);
+  probabilities.zeros(trees[0].NumClasses(), data.n_cols);
   predictions.set_size(data.n_cols);
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+
+    // Each tree classifies the whole block in turn.
+    for (size_t t = 0; t < trees.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const arma::vec& leafProbabilities =
+            trees[t].FindLeaf(data.col(i)).ClassProbabilities();
+        ProbabilityType* column = probabilities.colptr(i);
+        for (size_t c = 0; c < leafProbabilities.n_elem; ++c)
+          column[c] += (ProbabilityType) leafProbabilities[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= trees.size();
+      predictions[i] = (size_t) probabilities.col(i).index_max();
+    }
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+double RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::OOBError(const MatType& data,
+                const arma::Row<size_t>& labels) const
+{
+  CheckOutOfBag(data, labels, "OOBError");
+
+  // Add up the class probabilities of the trees for which each point is out of
+  // bag, as Classify() does.
+  const size_t numClasses = trees[0].NumClasses();
+  arma::mat probabilities(numClasses, data.n_cols, arma::fill::zeros);
+  arma::Col<size_t> numVotes(data.n_cols, arma::fill::zeros);
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+
+    for (size_t t = 0; t < trees.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        if (!outOfBag[t][i])
+          continue;
+
+        probabilities.col(i) +=
+            trees[t].FindLeaf(data.col(i)).ClassProbabilities();
+        ++numVotes[i];
+      }
+    }
+  }
+
+  size_t numPoints = 0, numErrors = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (numVotes[i] == 0)
+      continue;
+
+    ++numPoints;
+    if ((size_t) probabilities.col(i).index_max() != labels[i])
+      ++numErrors;
+  }
+
+  if (numPoints == 0)
+  {
+    throw std::runtime_error("RandomForest::OOBError(): no point is out of bag "
+        "for any tree; train more trees");
+  }
+
+  return double(numErrors) / double(numPoints);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::PermutationImportance(const MatType& data,
+                             const arma::Row<size_t>& labels,
+                             arma::vec& importances) const
+{
+  CheckOutOfBag(data, labels, "PermutationImportance");
+
+  // Collect the out-of-bag points of each tree, and its accuracy on them.
+  std::vector<arma::uvec> points(trees.size());
+  arma::vec accuracies(trees.size(), arma::fill::zeros);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) trees.size(); ++t)
+  {
+    std::vector<arma::uword> indices;
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      if (outOfBag[t][i])
+        indices.push_back(i);
+    }
+    points[t] = arma::uvec(indices);
+
+    size_t correct = 0;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      if (trees[t].Classify(data.col(indices[i])) == labels[indices[i]])
+        ++correct;
+    }
+    if (!indices.empty())
+      accuracies[t] = double(correct) / double(indices.size());
+  }
+
+  // Now shuffle each dimension among the out-of-bag points of each tree.  The
+  // out-of-bag points of a tree are copied once, and each dimension is
+  // shuffled and restored in turn.  Each tree draws from its own random object,
+  // so the importances do not depend on the number of threads.
+  arma::mat decreases(data.n_rows, trees.size(), arma::fill::zeros);
+  const uint64_t seed = math::RandomTaskSeed();
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) trees.size(); ++t)
+  {
+    if (points[t].n_elem == 0)
+      continue;
+
+    math::RandomTaskScope randomScope(seed, t);
+    MatType block = data.cols(points[t]);
+    arma::Row<typename MatType::elem_type> original;
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      original = block.row(d);
+      for (size_t i = block.n_cols - 1; i > 0; --i)
+      {
+        const size_t j = (size_t) math::RandInt(i + 1);
+        std::swap(block(d, i), block(d, j));
+      }
+
+      size_t correct = 0;
+      for (size_t i = 0; i < block.n_cols; ++i)
+      {
+        if (trees[t].Classify(block.col(i)) == labels[points[t][i]])
+          ++correct;
+      }
+      decreases(d, t) = accuracies[t] - double(correct) / double(block.n_cols);
+      block.row(d) = original;
+    }
+  }
+
+  // Average over the trees that have out-of-bag points.
+  size_t numTrees = 0;
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    if (points[t].n_elem > 0)
+      ++numTrees;
+  }
+
+  if (numTrees == 0)
+  {
+    throw std::runtime_error("RandomForest::PermutationImportance(): no point "
+        "is out of bag for any tree");
+  }
+
+  importances = arma::sum(decreases, 1) / numTrees;
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::CheckOutOfBag(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const std::string& functionName) const
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("RandomForest::" + functionName + "(): no "
+        "random forest trained!");
+  }
+
+  if (outOfBag.size() != trees.size())
+  {
+    throw std::invalid_argument("RandomForest::" + functionName + "(): the "
+        "out-of-bag points are only known after Train()");
+  }
+
+  if (data.n_cols != labels.n_elem || data.n_cols != outOfBag[0].size())
   {
-    arma::vec probs = probabilities.unsafe_col(i);
-    Classify(data.col(i), predictions[i], probs);
+    std::ostringstream oss;
+    oss << "RandomForest::" << functionName << "(): the forest was trained on "
+        << outOfBag[0].size() << " points, but " << data.n_cols << " points "
+        << "and " << labels.n_elem << " labels were given";
+    throw std::invalid_argument(oss.str());
   }
 }
 
@@ -425,7 +637,10 @@ void RandomForest<
 {
   size_t numTrees;
   if (Archive::is_loading::value)
+  {
     trees.clear();
+    outOfBag.clear();
+  }
   else
     numTrees = trees.size();
 
@@ -438,6 +653,113 @@ void RandomForest<
   ar & BOOST_SERIALIZATION_NVP(trees);
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Save(data::ModelArchiveWriter& archive, const std::string& name) const
+{
+  const size_t numTrees = trees.size();
+  archive.Add(name + "/numTrees", numTrees);
+  for (size_t i = 0; i < trees.size(); ++i)
+    archive.Add(name + "/tree/" + std::to_string(i), trees[i]);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Load(const data::ModelArchive& archive, const std::string& name)
+{
+  std::vector<DecisionTreeType> loadedTrees(NumTrees(archive, name));
+
+  // An exception can't leave an OpenMP loop, so the first error is kept and
+  // thrown afterwards.
+  std::string error;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) loadedTrees.size(); ++i)
+  {
+    try
+    {
+      LoadTree(archive, name, i, loadedTrees[i]);
+    }
+    catch (std::exception& e)
+    {
+      #pragma omp critical
+      {
+        if (error.empty())
+          error = e.what();
+      }
+    }
+  }
+
+  if (!error.empty())
+    throw std::runtime_error(error);
+
+  // The forest is only changed if all the trees were loaded.
+  trees.swap(loadedTrees);
+  outOfBag.clear();
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+size_t RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::NumTrees(const data::ModelArchive& archive, const std::string& name)
+{
+  size_t numTrees;
+  archive.Load(name + "/numTrees", numTrees);
+  return numTrees;
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::LoadTree(const data::ModelArchive& archive,
+            const std::string& name,
+            const size_t i,
+            DecisionTreeType& tree)
+{
+  archive.Load(name + "/tree/" + std::to_string(i), tree);
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -465,17 +787,24 @@ double RandomForest<
 {
   // Train each tree individually.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
+  outOfBag.assign(numTrees, std::vector<bool>());
   double avgGain = 0.0;
 
+  // Each tree draws from its own random object, so the forest does not depend
+  // on the number of threads.
+  const uint64_t seed = math::RandomTaskSeed();
+
   #pragma omp parallel for reduction( + : avgGain)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
+    math::RandomTaskScope randomScope(seed, i);
+
     Timer::Start("bootstrap");
     MatType bootstrapDataset;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
     Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
+        bootstrapLabels, bootstrapWeights, outOfBag[i]);
     Timer::Stop("bootstrap");
 
     // Now build the decision tree.
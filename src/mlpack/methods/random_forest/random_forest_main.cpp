@@ -61,7 +61,10 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("subspace_dim") + " parameter is used to control the "
     "number of random dimensions chosen for an individual node's split.  If " +
     PRINT_PARAM_STRING("print_training_accuracy") + " is specified, the "
-    "calculated accuracy on the training set will be printed."
+    "calculated accuracy on the training set will be printed.  If " +
+    PRINT_PARAM_STRING("print_oob_error") + " is specified, the out-of-bag "
+    "error of the forest (an estimate of its error on unseen data, which does "
+    "not need a test set) will be printed."
     "\n\n"
     "Test data may be specified with the " + PRINT_PARAM_STRING("test") + " "
     "parameter, and if performance measures are desired for that test set, "
@@ -113,6 +116,10 @@ PARAM_FLAG("print_training_accuracy", "If set, then the accuracy of the model "
     "on the training set will be predicted (verbose must also be specified).",
     "a");
 
+PARAM_FLAG("print_oob_error", "If set, then the out-of-bag error of the model "
+    "on the training set will be printed (verbose must also be specified).",
+    "o");
+
 PARAM_INT_IN("num_trees", "Number of trees in the random forest.", "N", 10);
 PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf "
     "node.", "n", 1);
@@ -170,10 +177,12 @@ static void mlpackMain()
   RequireOnlyOnePassed({ "training", "input_model" }, true);
 
   ReportIgnoredParam({{ "training", false }}, "print_training_accuracy");
+  ReportIgnoredParam({{ "training", false }}, "print_oob_error");
   ReportIgnoredParam({{ "test", false }}, "test_labels");
 
-  RequireAtLeastOnePassed({ "test", "output_model", "print_training_accuracy" },
-      false, "the trained forest model will not be used or saved");
+  RequireAtLeastOnePassed({ "test", "output_model", "print_training_accuracy",
+      "print_oob_error" }, false, "the trained forest model will not be used "
+      "or saved");
 
   if (IO::HasParam("training"))
   {
@@ -250,6 +259,14 @@ static void mlpackMain()
           << endl;
       Timer::Stop("rf_prediction");
     }
+
+    if (IO::HasParam("print_oob_error"))
+    {
+      Timer::Start("rf_oob_error");
+      const double oobError = rfModel->rf.OOBError(data, labels);
+      Log::Info << "Out-of-bag error: " << (oobError * 100) << "%." << endl;
+      Timer::Stop("rf_oob_error");
+    }
   }
   else
   {
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -158,19 +159,21 @@ class RandomizedSVD
     if (iteratedPower == 0)
       iteratedPower = rank + 2;
 
-    arma::mat R, Q, Qdata;
+    arma::mat R, Q, Qdata, product;
 
     // Apply the centered data matrix to a random matrix, obtaining Q.
     if (data.n_cols >= data.n_rows)
     {
       R = arma::randn<arma::mat>(data.n_rows, iteratedPower);
-      Q = (data.t() * R) - arma::repmat(arma::trans(R.t() * rowMean),
+      TransMultiply(data, R, product);
+      Q = product - arma::repmat(arma::trans(R.t() * rowMean),
           data.n_cols, 1);
     }
     else
     {
       R = arma::randn<arma::mat>(data.n_cols, iteratedPower);
-      Q = (data * R) - (rowMean * (arma::ones(1, data.n_cols) * R));
+      Multiply(data, R, product);
+      Q = product - (rowMean * (arma::ones(1, data.n_cols) * R));
     }
 
     // Form a matrix Q whose columns constitute a
@@ -189,15 +192,19 @@ class RandomizedSVD
     {
       if (data.n_cols >= data.n_rows)
       {
-        Q = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+        Multiply(data, Q, product);
+        Q = product - rowMean * (arma::ones(1, data.n_cols) * Q);
         arma::lu(Q, v, Q);
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+        TransMultiply(data, Q, product);
+        Q = product - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
       }
       else
       {
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+        TransMultiply(data, Q, product);
+        Q = product - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
         arma::lu(Q, v, Q);
-        Q = (data * Q) - (rowMean * (arma::ones(1, data.n_cols) * Q));
+        Multiply(data, Q, product);
+        Q = product - (rowMean * (arma::ones(1, data.n_cols) * Q));
       }
 
       // Computing the LU decomposition is more efficient than computing the QR
@@ -219,13 +226,15 @@ class RandomizedSVD
     // applied to Q.
     if (data.n_cols >= data.n_rows)
     {
-      Qdata = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+      Multiply(data, Q, product);
+      Qdata = product - rowMean * (arma::ones(1, data.n_cols) * Q);
       arma::svd_econ(u, s, v, Qdata);
       v = Q * v;
     }
     else
     {
-      Qdata = (Q.t() * data) - arma::repmat(Q.t() * rowMean, 1,  data.n_cols);
+      TransMultiply(data, Q, product);
+      Qdata = product.t() - arma::repmat(Q.t() * rowMean, 1,  data.n_cols);
       arma::svd_econ(u, s, v, Qdata);
       u = Q * u;
     }
@@ -247,6 +256,40 @@ class RandomizedSVD
   double& Epsilon() { return eps; }
 
  private:
+  //! Compute output = data * m for dense data.
+  static void Multiply(const arma::mat& data,
+                       const arma::mat& m,
+                       arma::mat& output)
+  {
+    output = data * m;
+  }
+
+  //! Compute output = data * m for sparse data, in parallel and without
+  //! densifying the data.
+  static void Multiply(const arma::sp_mat& data,
+                       const arma::mat& m,
+                       arma::mat& output)
+  {
+    math::SparseMultiply(data, m, output);
+  }
+
+  //! Compute output = data^T * m for dense data.
+  static void TransMultiply(const arma::mat& data,
+                            const arma::mat& m,
+                            arma::mat& output)
+  {
+    output = data.t() * m;
+  }
+
+  //! Compute output = data^T * m for sparse data, in parallel and without
+  //! forming the transpose of the data.
+  static void TransMultiply(const arma::sp_mat& data,
+                            const arma::mat& m,
+                            arma::mat& output)
+  {
+    math::SparseTransMultiply(data, m, output);
+  }
+
   //! Locally stored size of the normalized power iterations.
   size_t iteratedPower;
 
@@ -16,7 +16,10 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_query_blocks.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include "range_search_stat.hpp"
+#include "range_search_results.hpp"
 
 namespace mlpack {
 namespace range /** Range-search routines. */ {
@@ -153,6 +156,19 @@ class RangeSearch
    */
   void Train(Tree* referenceTree);
 
+  /**
+   * Set the reference tree to a new reference tree, which is not copied (so it
+   * may be shared with other objects, see tree::TreeCache), and map the
+   * reference indices of the results back to the original reference set with
+   * the given mapping.
+   *
+   * @param referenceTree Pre-built tree for reference points.
+   * @param oldFromNewReferences Mapping of the points of the tree's dataset to
+   *     the original reference set, as filled by the tree constructor.
+   */
+  void Train(Tree* referenceTree,
+             const std::vector<size_t>& oldFromNewReferences);
+
   /**
    * Search for all reference points in the given range for each point in the
    * query set, returning the results in the neighbors and distances objects.
@@ -185,6 +201,23 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in compressed form (see
+   * RangeSearchResults); this avoids one allocation per query point, and is
+   * preferable when there are many query points.  Each thread stores the
+   * results it finds in its own buffer, and the buffers are gathered at the
+   * end of the search.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param results Object which will hold the neighbors and distances of each
+   *      query point.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              RangeSearchResults& results);
+
   /**
    * Given a pre-built query tree, search for all reference points in the given
    * range for each point in the query set, returning the results in the
@@ -226,6 +259,21 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Given a pre-built query tree, search for all reference points in the given
+   * range for each point in the query set, returning the results in compressed
+   * form (see RangeSearchResults).  As above, this throws an invalid_argument
+   * exception if either naive or singleMode are set to true.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param results Object which will hold the neighbors and distances of each
+   *      query point.
+   */
+  void Search(Tree* queryTree,
+              const math::Range& range,
+              RangeSearchResults& results);
+
   /**
    * Search for all points in the given range for each point in the reference
    * set (which was passed to the constructor), returning the results in the
@@ -259,6 +307,17 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in compressed form (see RangeSearchResults).
+   * This means that the query set and the reference set are the same.
+   *
+   * @param range Range of distances in which to search.
+   * @param results Object which will hold the neighbors and distances of each
+   *      reference point.
+   */
+  void Search(const math::Range& range, RangeSearchResults& results);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -269,6 +328,16 @@ class RangeSearch
   //! Modify whether naive search is being used.
   bool& Naive() { return naive; }
 
+  /**
+   * Get whether naive and single-tree searches are run in parallel over blocks
+   * of query points.  Trees with self-children (like the cover tree) cache base
+   * cases in the reference tree, so single-tree searches with those trees are
+   * always serial.
+   */
+  bool ParallelQueries() const { return parallelQueries; }
+  //! Modify whether queries are searched in parallel blocks.
+  bool& ParallelQueries() { return parallelQueries; }
+
   //! Get the number of base cases during the last search.
   size_t BaseCases() const { return baseCases; }
   //! Get the number of scores during the last search.
@@ -300,6 +369,9 @@ class RangeSearch
   bool naive;
   //! If true, single-tree computation is used.
   bool singleMode;
+  //! If true, naive and single-tree searches are run over query blocks in
+  //! parallel.
+  bool parallelQueries;
 
   //! Instantiated distance metric.
   MetricType metric;
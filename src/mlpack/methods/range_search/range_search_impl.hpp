@@ -59,6 +59,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     treeOwner(!naive),
     naive(naive),
     singleMode(!naive && singleMode),
+    parallelQueries(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -80,6 +81,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     treeOwner(false),
     naive(false),
     singleMode(singleMode),
+    parallelQueries(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -101,6 +103,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     treeOwner(false),
     naive(naive),
     singleMode(singleMode),
+    parallelQueries(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -108,7 +111,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
   {
-    referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+    referenceTree = BuildTree<Tree>(std::move(MatType()),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
     treeOwner = true;
@@ -129,6 +132,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     treeOwner(other.referenceTree),
     naive(other.naive),
     singleMode(other.singleMode),
+    parallelQueries(other.parallelQueries),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores)
@@ -148,17 +152,19 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     treeOwner(other.treeOwner),
     naive(other.naive),
     singleMode(other.singleMode),
+    parallelQueries(other.parallelQueries),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores)
 {
   // Clear other object.
   other.referenceTree =
-      BuildTree<Tree>(std::move(arma::mat()), other.oldFromNewReferences);
+      BuildTree<Tree>(std::move(MatType()), other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
   other.treeOwner = true;
   other.naive = false;
   other.singleMode = false;
+  other.parallelQueries = false;
   other.baseCases = 0;
   other.scores = 0;
 }
@@ -184,6 +190,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch other)
   treeOwner = other.treeOwner;
   naive = other.naive;
   singleMode = other.singleMode;
+  parallelQueries = other.parallelQueries;
   metric = std::move(other.metric);
   baseCases = other.baseCases;
   scores = other.scores;
@@ -225,6 +232,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Train(
   }
   else
   {
+    oldFromNewReferences.clear();
     treeOwner = false;
   }
 
@@ -259,9 +267,23 @@ void RangeSearch<MetricType, MatType, TreeType>::Train(
 
   this->referenceTree = referenceTree;
   this->referenceSet = &referenceTree->Dataset();
+  oldFromNewReferences.clear();
   treeOwner = false;
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Train(
+    Tree* referenceTree,
+    const std::vector<size_t>& oldFromNewReferences)
+{
+  Train(referenceTree);
+  this->oldFromNewReferences = oldFromNewReferences;
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -272,6 +294,26 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     const math::Range& range,
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
+{
+  RangeSearchResults results;
+  Search(querySet, range, results);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  results.Export(neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    RangeSearchResults& results)
 {
   if (querySet.n_rows != referenceSet->n_rows)
   {
@@ -283,6 +325,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 
   // If there are no points, there is no search to be done.
+  results.Clear(querySet.n_cols);
   if (referenceSet->n_cols == 0)
     return;
 
@@ -291,35 +334,12 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
 
-  // If we have built the trees ourselves, then we will have to map all the
-  // indices back to their original indices when this computation is finished.
-  // To avoid extra copies, we will store the unmapped neighbors and distances
-  // in a separate object.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
-
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // Query indices only need to be mapped if we are building the query tree
-    // ourselves.
-    if (!singleMode && !naive)
-    {
-      distancePtr = new std::vector<std::vector<double>>;
-      neighborPtr = new std::vector<std::vector<size_t>>;
-    }
-
-    // Reference indices only need to be mapped if we built the reference tree
-    // ourselves.
-    else if (treeOwner)
-      neighborPtr = new std::vector<std::vector<size_t>>;
-  }
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distancePtr->clear();
-  distancePtr->resize(querySet.n_cols);
+  // Each thread stores its results in its own buffer.
+  #ifdef HAS_OPENMP
+    std::vector<RangeSearchBuffer> buffers(omp_get_max_threads());
+  #else
+    std::vector<RangeSearchBuffer> buffers(1);
+  #endif
 
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
@@ -330,26 +350,42 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    RuleType rules(*referenceSet, querySet, range, buffers, metric);
 
     // The naive brute-force solution.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    tree::ParallelQueryBlocks(rules, querySet.n_cols, parallelQueries,
+        [this](RuleType& blockRules, const size_t begin, const size_t end)
+        {
+          for (size_t i = begin; i < end; ++i)
+            for (size_t j = 0; j < referenceSet->n_cols; ++j)
+              blockRules.BaseCase(i, j);
+        });
 
     baseCases += (querySet.n_cols * referenceSet->n_cols);
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    RuleType rules(*referenceSet, querySet, range, buffers, metric);
+
+    // Now have it traverse for each point.  Trees with self-children cache base
+    // cases in the reference nodes, so they can't be shared by threads.
+    tree::TraversalStatistics statistics;
+    tree::ParallelQueryBlocks(rules, querySet.n_cols, parallelQueries &&
+        !tree::TreeTraits<Tree>::HasSelfChildren,
+        [this, &statistics](RuleType& blockRules, const size_t begin,
+                            const size_t end)
+        {
+          typename Tree::template SingleTreeTraverser<RuleType>
+              traverser(blockRules);
+          tree::TraversalStatistics blockStatistics;
+          tree::CollectTraversalStatistics(traverser, blockStatistics);
+          for (size_t i = begin; i < end; ++i)
+            traverser.Traverse(i, *referenceTree);
+
+          #pragma omp critical(RangeSearchStatistics)
+          statistics += blockStatistics;
+        });
+    statistics.Print();
 
     baseCases += rules.BaseCases();
     scores += rules.Scores();
@@ -364,11 +400,14 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Start("range_search/computing_neighbors");
 
     // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, buffers,
+        metric);
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    tree::TraversalStatistics statistics;
+    tree::CollectTraversalStatistics(traverser, statistics);
 
     traverser.Traverse(*queryTree, *referenceTree);
+    statistics.Print();
 
     baseCases += rules.BaseCases();
     scores += rules.Scores();
@@ -377,73 +416,19 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     delete queryTree;
   }
 
-  Timer::Stop("range_search/computing_neighbors");
+  // Gather the results, mapping the points back to their original indices if
+  // necessary.  Query indices only need to be mapped if we built the query
+  // tree ourselves, and reference indices if we built the reference tree or
+  // were given its mapping.
+  const bool mapQueries = tree::TreeTraits<Tree>::RearrangesDataset &&
+      !singleMode && !naive;
+  const bool mapReferences = tree::TreeTraits<Tree>::RearrangesDataset &&
+      !oldFromNewReferences.empty();
+  results.Build(querySet.n_cols, buffers,
+      mapQueries ? &oldFromNewQueries : NULL,
+      mapReferences ? &oldFromNewReferences : NULL);
 
-  // Map points back to original indices, if necessary.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    if (!singleMode && !naive && treeOwner)
-    {
-      // We must map both query and reference indices.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-
-        // Copy each neighbor individually, because we need to map it.
-        neighbors[queryMapping].resize(distances[queryMapping].size());
-        for (size_t j = 0; j < distances[queryMapping].size(); ++j)
-          neighbors[queryMapping][j] =
-              oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (!singleMode && !naive)
-    {
-      // We must map query indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances and neighbors (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-        neighbors[queryMapping] = (*neighborPtr)[i];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (treeOwner)
-    {
-      // We must map reference indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < neighbors.size(); ++i)
-      {
-        neighbors[i].resize((*neighborPtr)[i].size());
-        for (size_t j = 0; j < neighbors[i].size(); ++j)
-          neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary object.
-      delete neighborPtr;
-    }
-  }
+  Timer::Stop("range_search/computing_neighbors");
 }
 
 template<typename MetricType,
@@ -461,60 +446,61 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   if (referenceSet->n_cols == 0)
     return;
 
-  Timer::Start("range_search/computing_neighbors");
+  RangeSearchResults results;
+  Search(queryTree, range, results);
+  results.Export(neighbors, distances);
+}
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    Tree* queryTree,
+    const math::Range& range,
+    RangeSearchResults& results)
+{
   // Get a reference to the query set.
   const MatType& querySet = queryTree->Dataset();
 
+  // If there are no points, there is no search to be done.
+  results.Clear(querySet.n_cols);
+  if (referenceSet->n_cols == 0)
+    return;
+
   // Make sure we are in dual-tree mode.
   if (singleMode || naive)
     throw std::invalid_argument("cannot call RangeSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
-  // We won't need to map query indices, but will we need to map distances?
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-    neighborPtr = new std::vector<std::vector<size_t>>;
+  Timer::Start("range_search/computing_neighbors");
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distances.clear();
-  distances.resize(querySet.n_cols);
+  // The traversal is serial, so a single buffer is enough.
+  std::vector<RangeSearchBuffer> buffers(1);
 
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
+  RuleType rules(*referenceSet, querySet, range, buffers, metric);
 
   // Create the traverser.
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  tree::TraversalStatistics statistics;
+  tree::CollectTraversalStatistics(traverser, statistics);
 
   traverser.Traverse(*queryTree, *referenceTree);
-
-  Timer::Stop("range_search/computing_neighbors");
+  statistics.Print();
 
   baseCases = rules.BaseCases();
   scores = rules.Scores();
 
-  // Do we need to map indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // We must map reference indices only.
-    neighbors.clear();
-    neighbors.resize(querySet.n_cols);
-
-    for (size_t i = 0; i < neighbors.size(); ++i)
-    {
-      neighbors[i].resize((*neighborPtr)[i].size());
-      for (size_t j = 0; j < neighbors[i].size(); ++j)
-        neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-    }
+  // We won't need to map query indices, but we may need to map the reference
+  // indices.
+  results.Build(querySet.n_cols, buffers, NULL,
+      (tree::TreeTraits<Tree>::RearrangesDataset &&
+      !oldFromNewReferences.empty()) ? &oldFromNewReferences : NULL);
 
-    // Finished with temporary object.
-    delete neighborPtr;
-  }
+  Timer::Stop("range_search/computing_neighbors");
 }
 
 template<typename MetricType,
@@ -531,48 +517,75 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   if (referenceSet->n_cols == 0)
     return;
 
-  Timer::Start("range_search/computing_neighbors");
+  RangeSearchResults results;
+  Search(range, results);
+  results.Export(neighbors, distances);
+}
 
-  // Here, we will use the query set as the reference set.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    RangeSearchResults& results)
+{
+  // If there are no points, there is no search to be done.
+  results.Clear(referenceSet->n_cols);
+  if (referenceSet->n_cols == 0)
+    return;
 
-  if (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner)
-  {
-    // We will always need to rearrange in this case.
-    distancePtr = new std::vector<std::vector<double>>;
-    neighborPtr = new std::vector<std::vector<size_t>>;
-  }
+  Timer::Start("range_search/computing_neighbors");
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(referenceSet->n_cols);
-  distancePtr->clear();
-  distancePtr->resize(referenceSet->n_cols);
+  // Each thread stores its results in its own buffer.
+  #ifdef HAS_OPENMP
+    std::vector<RangeSearchBuffer> buffers(omp_get_max_threads());
+  #else
+    std::vector<RangeSearchBuffer> buffers(1);
+  #endif
 
-  // Create the helper object for the traversal.
+  // Create the helper object for the traversal.  Here, we will use the query
+  // set as the reference set.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
+  RuleType rules(*referenceSet, *referenceSet, range, buffers, metric,
+      true /* don't return the query in the results */);
 
   if (naive)
   {
     // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    tree::ParallelQueryBlocks(rules, referenceSet->n_cols, parallelQueries,
+        [this](RuleType& blockRules, const size_t begin, const size_t end)
+        {
+          for (size_t i = begin; i < end; ++i)
+            for (size_t j = 0; j < referenceSet->n_cols; ++j)
+              blockRules.BaseCase(i, j);
+        });
 
     baseCases = (referenceSet->n_cols * referenceSet->n_cols);
     scores = 0;
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Now have it traverse for each point.  Trees with self-children cache base
+    // cases in the reference nodes, so they can't be shared by threads.
+    tree::TraversalStatistics statistics;
+    tree::ParallelQueryBlocks(rules, referenceSet->n_cols, parallelQueries &&
+        !tree::TreeTraits<Tree>::HasSelfChildren,
+        [this, &statistics](RuleType& blockRules, const size_t begin,
+                            const size_t end)
+        {
+          typename Tree::template SingleTreeTraverser<RuleType>
+              traverser(blockRules);
+          tree::TraversalStatistics blockStatistics;
+          tree::CollectTraversalStatistics(traverser, blockStatistics);
+          for (size_t i = begin; i < end; ++i)
+            traverser.Traverse(i, *referenceTree);
+
+          #pragma omp critical(RangeSearchStatistics)
+          statistics += blockStatistics;
+        });
+    statistics.Print();
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
@@ -581,41 +594,24 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   {
     // Create the traverser.
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    tree::TraversalStatistics statistics;
+    tree::CollectTraversalStatistics(traverser, statistics);
 
     traverser.Traverse(*referenceTree, *referenceTree);
+    statistics.Print();
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
   }
 
-  Timer::Stop("range_search/computing_neighbors");
-
-  // Do we need to map the reference indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    neighbors.clear();
-    neighbors.resize(referenceSet->n_cols);
-    distances.clear();
-    distances.resize(referenceSet->n_cols);
-
-    for (size_t i = 0; i < distances.size(); ++i)
-    {
-      // Map distances (copy a column).
-      const size_t refMapping = oldFromNewReferences[i];
-      distances[refMapping] = (*distancePtr)[i];
-
-      // Copy each neighbor individually, because we need to map it.
-      neighbors[refMapping].resize(distances[refMapping].size());
-      for (size_t j = 0; j < distances[refMapping].size(); ++j)
-      {
-        neighbors[refMapping][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-    }
+  // Gather the results; if we built the tree (or were given its mapping), both
+  // the query and the reference indices must be mapped.
+  const std::vector<size_t>* mapping =
+      (tree::TreeTraits<Tree>::RearrangesDataset &&
+      !oldFromNewReferences.empty()) ? &oldFromNewReferences : NULL;
+  results.Build(referenceSet->n_cols, buffers, mapping, mapping);
 
-    // Finished with temporary objects.
-    delete neighborPtr;
-    delete distancePtr;
-  }
+  Timer::Stop("range_search/computing_neighbors");
 }
 
 template<typename MetricType,
@@ -113,6 +113,10 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
+PARAM_STRING_IN("reference_map_file", "If specified, the reference set of the "
+    "output model is written to this file and the output model is saved "
+    "without it; loading that model later memory-maps the reference set from "
+    "this file.", "f", "");
 
 static void mlpackMain()
 {
@@ -128,6 +132,7 @@ static void mlpackMain()
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
   ReportIgnoredParam({{ "input_model", true }}, "leaf_size");
   ReportIgnoredParam({{ "input_model", true }}, "naive");
+  ReportIgnoredParam({{ "output_model", false }}, "reference_map_file");
 
   // The user must give something to do...
   RequireAtLeastOnePassed({ "min", "max", "output_model" }, false, "no results "
@@ -254,13 +259,12 @@ static void mlpackMain()
           << PRINT_PARAM_STRING("naive") << " is present." << endl;
 
     // Now run the search.
-    vector<vector<size_t>> neighbors;
-    vector<vector<double>> distances;
+    RangeSearchResults results;
 
     if (IO::HasParam("query"))
-      rs->Search(std::move(queryData), r, neighbors, distances);
+      rs->Search(std::move(queryData), r, results);
     else
-      rs->Search(r, neighbors, distances);
+      rs->Search(r, results);
 
     Log::Info << "Search complete." << endl;
 
@@ -277,15 +281,17 @@ static void mlpackMain()
       else
       {
         // Loop over each point.
-        for (size_t i = 0; i < distances.size(); ++i)
+        for (size_t i = 0; i < results.NumQueries(); ++i)
         {
           // Store the distances of each point.  We may have 0 points to store,
           // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < distances[i].size(); ++j)
-            distancesStr << distances[i][j] << ", ";
+          const double* distances = results.Distances(i);
+          const size_t numResults = results.NumResults(i);
+          for (size_t j = 0; j + 1 < numResults; ++j)
+            distancesStr << distances[j] << ", ";
 
-          if (distances[i].size() > 0)
-            distancesStr << distances[i][distances[i].size() - 1];
+          if (numResults > 0)
+            distancesStr << distances[numResults - 1];
 
           distancesStr << endl;
         }
@@ -306,15 +312,17 @@ static void mlpackMain()
       else
       {
         // Loop over each point.
-        for (size_t i = 0; i < neighbors.size(); ++i)
+        for (size_t i = 0; i < results.NumQueries(); ++i)
         {
           // Store the neighbors of each point.  We may have 0 points to store,
           // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < neighbors[i].size(); ++j)
-            neighborsStr << neighbors[i][j] << ", ";
+          const size_t* neighbors = results.Neighbors(i);
+          const size_t numResults = results.NumResults(i);
+          for (size_t j = 0; j + 1 < numResults; ++j)
+            neighborsStr << neighbors[j] << ", ";
 
-          if (neighbors[i].size() > 0)
-            neighborsStr << neighbors[i][neighbors[i].size() - 1];
+          if (numResults > 0)
+            neighborsStr << neighbors[numResults - 1];
 
           neighborsStr << endl;
         }
@@ -324,6 +332,10 @@ static void mlpackMain()
     }
   }
 
+  // Write the reference set to a file that can be memory-mapped, if desired.
+  if (IO::HasParam("reference_map_file"))
+    rs->MapReferenceSet(IO::GetParam<std::string>("reference_map_file"));
+
   // Save the output model.
   IO::GetParam<RSModel*>("output_model") = rs;
 }
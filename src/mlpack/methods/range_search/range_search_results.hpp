@@ -0,0 +1,226 @@
+/**
+ * @file methods/range_search/range_search_results.hpp
+ *
+ * Compact storage for the results of a range search: the neighbors and the
+ * distances of all the query points are stored in two flat arrays, along with
+ * the offset of the results of each query point (like the compressed sparse
+ * row format), instead of one vector per query point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * The results found by one thread during a range search, in the order they were
+ * found.  Each result is appended to three flat vectors, so there is no
+ * allocation per query point.
+ */
+struct RangeSearchBuffer
+{
+  //! The query point of each result.
+  std::vector<size_t> queries;
+  //! The reference point of each result.
+  std::vector<size_t> neighbors;
+  //! The distance of each result.
+  std::vector<double> distances;
+  //! Padding, so that the buffers of different threads (which are stored next
+  //! to each other) don't share a cache line.
+  char padding[64];
+};
+
+/**
+ * RangeSearchResults holds the results of a range search in compressed form:
+ * the neighbors of query point i are Neighbors(i)[0], ...,
+ * Neighbors(i)[NumResults(i) - 1], and their distances are given by
+ * Distances(i) in the same way.  All the results are stored in two contiguous
+ * arrays, which takes much less memory than one vector per query point (and
+ * much fewer allocations) when there are many query points.
+ *
+ * @code
+ * RangeSearch<> rs(dataset);
+ * RangeSearchResults results;
+ * rs.Search(queries, math::Range(0.0, 1.0), results);
+ * for (size_t i = 0; i < results.NumQueries(); ++i)
+ *   for (size_t j = 0; j < results.NumResults(i); ++j)
+ *     std::cout << results.Neighbors(i)[j] << " "
+ *         << results.Distances(i)[j] << std::endl;
+ * @endcode
+ */
+class RangeSearchResults
+{
+ public:
+  //! Create empty results (for no query points).
+  RangeSearchResults() : offsets(1, 0) { }
+
+  /**
+   * Empty the results, so that they hold no result for the given number of
+   * query points.
+   *
+   * @param numQueries Number of query points.
+   */
+  void Clear(const size_t numQueries = 0)
+  {
+    offsets.assign(numQueries + 1, 0);
+    neighbors.clear();
+    distances.clear();
+  }
+
+  /**
+   * Store the results of the given buffers.  The results of each query point
+   * are kept in the order of the buffers (and in the order they were found in
+   * each buffer).  If mappings are given, the query points and the neighbors
+   * found in the buffers are mapped back to their original indices with them
+   * (for trees that rearrange the dataset).
+   *
+   * @param numQueries Number of query points.
+   * @param buffers Results found by each thread.
+   * @param oldFromNewQueries Mapping of the query points, or NULL.
+   * @param oldFromNewReferences Mapping of the reference points, or NULL.
+   */
+  void Build(const size_t numQueries,
+             const std::vector<RangeSearchBuffer>& buffers,
+             const std::vector<size_t>* oldFromNewQueries = NULL,
+             const std::vector<size_t>* oldFromNewReferences = NULL)
+  {
+    // Count the results of each query point, and turn the counts into offsets.
+    offsets.assign(numQueries + 1, 0);
+    size_t numResults = 0;
+    for (size_t b = 0; b < buffers.size(); ++b)
+    {
+      const std::vector<size_t>& queries = buffers[b].queries;
+      for (size_t i = 0; i < queries.size(); ++i)
+      {
+        const size_t query = (oldFromNewQueries == NULL) ? queries[i] :
+            (*oldFromNewQueries)[queries[i]];
+        ++offsets[query + 1];
+      }
+      numResults += queries.size();
+    }
+
+    for (size_t i = 0; i < numQueries; ++i)
+      offsets[i + 1] += offsets[i];
+
+    // Now scatter the results into place.
+    neighbors.resize(numResults);
+    distances.resize(numResults);
+    std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+    for (size_t b = 0; b < buffers.size(); ++b)
+    {
+      const RangeSearchBuffer& buffer = buffers[b];
+      for (size_t i = 0; i < buffer.queries.size(); ++i)
+      {
+        const size_t query = (oldFromNewQueries == NULL) ? buffer.queries[i] :
+            (*oldFromNewQueries)[buffer.queries[i]];
+        const size_t position = positions[query]++;
+        neighbors[position] = (oldFromNewReferences == NULL) ?
+            buffer.neighbors[i] : (*oldFromNewReferences)[buffer.neighbors[i]];
+        distances[position] = buffer.distances[i];
+      }
+    }
+  }
+
+  /**
+   * Reorder the query points with the given mapping: the results of query
+   * point i are moved to query point oldFromNewQueries[i].  This is used when
+   * the query points were rearranged by a query tree.
+   *
+   * @param oldFromNewQueries Mapping of the query points.
+   */
+  void MapQueries(const std::vector<size_t>& oldFromNewQueries)
+  {
+    std::vector<size_t> newOffsets(offsets.size(), 0);
+    for (size_t i = 0; i < NumQueries(); ++i)
+      newOffsets[oldFromNewQueries[i] + 1] = NumResults(i);
+    for (size_t i = 0; i < NumQueries(); ++i)
+      newOffsets[i + 1] += newOffsets[i];
+
+    std::vector<size_t> newNeighbors(neighbors.size());
+    std::vector<double> newDistances(distances.size());
+    for (size_t i = 0; i < NumQueries(); ++i)
+    {
+      const size_t position = newOffsets[oldFromNewQueries[i]];
+      std::copy(neighbors.begin() + offsets[i],
+          neighbors.begin() + offsets[i + 1], newNeighbors.begin() + position);
+      std::copy(distances.begin() + offsets[i],
+          distances.begin() + offsets[i + 1], newDistances.begin() + position);
+    }
+
+    offsets.swap(newOffsets);
+    neighbors.swap(newNeighbors);
+    distances.swap(newDistances);
+  }
+
+  /**
+   * Copy the results into one vector of neighbors and one vector of distances
+   * for each query point.
+   *
+   * @param neighborsOut Vectors to store the neighbors in.
+   * @param distancesOut Vectors to store the distances in.
+   */
+  void Export(std::vector<std::vector<size_t>>& neighborsOut,
+              std::vector<std::vector<double>>& distancesOut) const
+  {
+    neighborsOut.clear();
+    neighborsOut.resize(NumQueries());
+    distancesOut.clear();
+    distancesOut.resize(NumQueries());
+    for (size_t i = 0; i < NumQueries(); ++i)
+    {
+      neighborsOut[i].assign(neighbors.begin() + offsets[i],
+          neighbors.begin() + offsets[i + 1]);
+      distancesOut[i].assign(distances.begin() + offsets[i],
+          distances.begin() + offsets[i + 1]);
+    }
+  }
+
+  //! Get the number of query points.
+  size_t NumQueries() const { return offsets.size() - 1; }
+  //! Get the total number of results.
+  size_t NumResults() const { return neighbors.size(); }
+  //! Get the number of results of the given query point.
+  size_t NumResults(const size_t query) const
+  {
+    return offsets[query + 1] - offsets[query];
+  }
+
+  //! Get the neighbors of the given query point.
+  const size_t* Neighbors(const size_t query) const
+  {
+    return neighbors.data() + offsets[query];
+  }
+  //! Get the distances of the neighbors of the given query point.
+  const double* Distances(const size_t query) const
+  {
+    return distances.data() + offsets[query];
+  }
+
+  //! Get the offsets of the results of each query point (there are
+  //! NumQueries() + 1 offsets, the last one is NumResults()).
+  const std::vector<size_t>& Offsets() const { return offsets; }
+  //! Get the neighbors of all the query points.
+  const std::vector<size_t>& Neighbors() const { return neighbors; }
+  //! Get the distances of all the query points.
+  const std::vector<double>& Distances() const { return distances; }
+
+ private:
+  //! The offset of the results of each query point.
+  std::vector<size_t> offsets;
+  //! The neighbors of all the query points.
+  std::vector<size_t> neighbors;
+  //! The distances of all the query points.
+  std::vector<double> distances;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,8 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/squared_distance_block.hpp>
+#include "range_search_results.hpp"
 
 namespace mlpack {
 namespace range {
@@ -41,14 +43,36 @@ class RangeSearchRules
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
    */
-  RangeSearchRules(const arma::mat& referenceSet,
-                   const arma::mat& querySet,
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
                    const math::Range& range,
                    std::vector<std::vector<size_t> >& neighbors,
                    std::vector<std::vector<double> >& distances,
                    MetricType& metric,
                    const bool sameSet = false);
 
+  /**
+   * Construct the RangeSearchRules object so that the results are appended to
+   * the given per-thread buffers (the buffer of the calling thread, given by
+   * omp_get_thread_num(), so there must be one buffer for each thread that
+   * may take part in the search).  The results of a query point may be spread over several buffers;
+   * they can be gathered with RangeSearchResults::Build().
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param buffers Buffers to store the results in, one per thread.
+   * @param metric Instantiated metric.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   */
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
+                   const math::Range& range,
+                   std::vector<RangeSearchBuffer>& buffers,
+                   MetricType& metric,
+                   const bool sameSet = false);
+
   /**
    * Compute the base case between the given query point and reference point.
    *
@@ -57,6 +81,22 @@ class RangeSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between each of the given query points and every
+   * reference point in [referenceBegin, referenceEnd); the results are the
+   * same as calling BaseCase() for each pair in order.  For the (squared)
+   * Euclidean distance, the distances are first computed approximately as one
+   * matrix product, and only the pairs that may be in the range are evaluated
+   * exactly.
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceEnd One past the index of the last reference point.
+   */
+  void BaseCaseBlock(const std::vector<size_t>& queryIndices,
+                     const size_t referenceBegin,
+                     const size_t referenceEnd);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -114,8 +154,38 @@ class RangeSearchRules
 
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
   //! Get the number of scores (that is, calls to RangeDistance()).
   size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
+
+  /**
+   * Merge the results of the given query subtrees from another rules object
+   * into this one.  This is used by parallel traversers, where each thread
+   * performs its part of the search with a copy of the rules.  Results are
+   * written directly into the shared neighbors and distances vectors (or
+   * buffers), so there is nothing to do.
+   *
+   * @param other Rules object that was used to traverse the query subtrees.
+   * @param queryNodes Roots of the query subtrees traversed with other.
+   */
+  void Merge(const RangeSearchRules& /* other */,
+             const std::vector<TreeType*>& /* queryNodes */) { }
+
+  /**
+   * Merge the results of the query points in [begin, end) from another rules
+   * object into this one.  As above, results are written directly into the
+   * shared vectors, so there is nothing to do.
+   *
+   * @param other Rules object that was used to search the query points.
+   * @param begin Index of the first query point to merge.
+   * @param end One past the index of the last query point to merge.
+   */
+  void Merge(const RangeSearchRules& /* other */,
+             const size_t /* begin */,
+             const size_t /* end */) { }
 
   //! Get the minimum number of base cases we need to perform to have acceptable
   //! results.
@@ -123,19 +193,25 @@ class RangeSearchRules
 
  private:
   //! The reference set.
-  const arma::mat& referenceSet;
+  const typename TreeType::Mat& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const typename TreeType::Mat& querySet;
 
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
+  //! The vector the resultant neighbor indices should be stored in (NULL if
+  //! the results are stored in buffers).
+  std::vector<std::vector<size_t> >* neighbors;
 
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The vector the resultant neighbor distances should be stored in (NULL if
+  //! the results are stored in buffers).
+  std::vector<std::vector<double> >* distances;
+
+  //! The per-thread buffers the results should be stored in (NULL if the
+  //! results are stored in the vectors above).
+  std::vector<RangeSearchBuffer>* buffers;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -154,12 +230,35 @@ class RangeSearchRules
   void AddResult(const size_t queryIndex,
                  TreeType& referenceNode);
 
+  //! Store the given result.
+  void AddNeighbor(const size_t queryIndex,
+                   const size_t referenceIndex,
+                   const double distance);
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases.
   size_t baseCases;
   //! THe number of scores.
   size_t scores;
+
+  //! Whether base cases can be computed as a block of squared distances.
+  typedef std::integral_constant<bool,
+      (std::is_same<MetricType, metric::EuclideanDistance>::value ||
+       std::is_same<MetricType, metric::SquaredEuclideanDistance>::value) &&
+      arma::is_Mat<typename TreeType::Mat>::value> UseDistanceBlock;
+
+  //! Compute the base cases of a block with a block of squared distances.
+  void BaseCaseBlockImpl(const std::vector<size_t>& queryIndices,
+                         const size_t referenceBegin,
+                         const size_t referenceEnd,
+                         const std::true_type /* useDistanceBlock */);
+
+  //! Compute the base cases of a block one pair at a time.
+  void BaseCaseBlockImpl(const std::vector<size_t>& queryIndices,
+                         const size_t referenceBegin,
+                         const size_t referenceEnd,
+                         const std::false_type /* useDistanceBlock */);
 };
 
 } // namespace range
@@ -20,8 +20,8 @@ namespace range {
 
 template<typename MetricType, typename TreeType>
 RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
-    const arma::mat& referenceSet,
-    const arma::mat& querySet,
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
     const math::Range& range,
     std::vector<std::vector<size_t> >& neighbors,
     std::vector<std::vector<double> >& distances,
@@ -30,8 +30,33 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    neighbors(&neighbors),
+    distances(&distances),
+    buffers(NULL),
+    metric(metric),
+    sameSet(sameSet),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename TreeType>
+RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const math::Range& range,
+    std::vector<RangeSearchBuffer>& buffers,
+    MetricType& metric,
+    const bool sameSet) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    range(range),
+    neighbors(NULL),
+    distances(NULL),
+    buffers(&buffers),
     metric(metric),
     sameSet(sameSet),
     lastQueryIndex(querySet.n_cols),
@@ -67,12 +92,93 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   lastReferenceIndex = referenceIndex;
 
   if (range.Contains(distance))
+    AddNeighbor(queryIndex, referenceIndex, distance);
+
+  return distance;
+}
+
+template<typename MetricType, typename TreeType>
+void RangeSearchRules<MetricType, TreeType>::BaseCaseBlock(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceEnd)
+{
+  BaseCaseBlockImpl(queryIndices, referenceBegin, referenceEnd,
+      UseDistanceBlock());
+}
+
+template<typename MetricType, typename TreeType>
+void RangeSearchRules<MetricType, TreeType>::BaseCaseBlockImpl(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceEnd,
+    const std::true_type /* useDistanceBlock */)
+{
+  typedef typename TreeType::Mat MatType;
+  typedef typename MatType::elem_type ElemType;
+
+  const MatType queries = querySet.cols(
+      arma::conv_to<arma::uvec>::from(queryIndices));
+  const MatType references = referenceSet.cols(referenceBegin,
+      referenceEnd - 1);
+
+  arma::Mat<ElemType> squaredDistances;
+  const double error = metric::SquaredDistanceBlock(queries, references,
+      squaredDistances);
+  const bool takeRoot =
+      std::is_same<MetricType, metric::EuclideanDistance>::value;
+
+  // The square root is monotonic, so for the Euclidean distance the bounds on
+  // the squared distances are compared to the squared range instead of taking
+  // their roots.
+  const double rangeLo = (takeRoot && range.Lo() > 0.0) ?
+      range.Lo() * range.Lo() : range.Lo();
+  const double rangeHi = takeRoot ? range.Hi() * range.Hi() : range.Hi();
+
+  for (size_t i = 0; i < queryIndices.size(); ++i)
   {
-    neighbors[queryIndex].push_back(referenceIndex);
-    distances[queryIndex].push_back(distance);
+    const size_t queryIndex = queryIndices[i];
+    for (size_t j = 0; j < references.n_cols; ++j)
+    {
+      const size_t referenceIndex = referenceBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+      if ((lastQueryIndex == queryIndex) &&
+          (lastReferenceIndex == referenceIndex))
+        continue;
+
+      ++baseCases;
+
+      // Only evaluate the distance exactly if it may be in the range; the
+      // squared distance lies between lower and upper.
+      const double lower = std::max(squaredDistances(i, j) - error, 0.0);
+      const double upper = squaredDistances(i, j) + error;
+      if (upper < rangeLo || lower > rangeHi)
+        continue;
+
+      const double distance = metric.Evaluate(
+          querySet.unsafe_col(queryIndex),
+          referenceSet.unsafe_col(referenceIndex));
+
+      lastQueryIndex = queryIndex;
+      lastReferenceIndex = referenceIndex;
+
+      if (range.Contains(distance))
+        AddNeighbor(queryIndex, referenceIndex, distance);
+    }
   }
+}
 
-  return distance;
+template<typename MetricType, typename TreeType>
+void RangeSearchRules<MetricType, TreeType>::BaseCaseBlockImpl(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceEnd,
+    const std::false_type /* useDistanceBlock */)
+{
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+    for (size_t ref = referenceBegin; ref < referenceEnd; ++ref)
+      BaseCase(queryIndices[i], ref);
 }
 
 //! Single-tree scoring function.
@@ -239,11 +345,15 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
   // Resize distances and neighbors vectors appropriately.  We have to use
   // reserve() and not resize(), because we don't know if we will encounter the
   // case where the datasets and points are the same (and we skip in that case).
-  const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
+  // Buffers grow geometrically on their own, so they are left alone.
+  if (neighbors)
+  {
+    const size_t oldSize = (*neighbors)[queryIndex].size();
+    (*neighbors)[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
+        baseCaseMod);
+    (*distances)[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
+        baseCaseMod);
+  }
 
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
@@ -254,9 +364,38 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
         referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
 
-    neighbors[queryIndex].push_back(referenceNode.Descendant(i));
-    distances[queryIndex].push_back(distance);
+    AddNeighbor(queryIndex, referenceNode.Descendant(i), distance);
+  }
+}
+
+//! Store the given result in the vectors or in the buffer of this thread.
+template<typename MetricType, typename TreeType>
+inline force_inline
+void RangeSearchRules<MetricType, TreeType>::AddNeighbor(
+    const size_t queryIndex,
+    const size_t referenceIndex,
+    const double distance)
+{
+  if (neighbors)
+  {
+    (*neighbors)[queryIndex].push_back(referenceIndex);
+    (*distances)[queryIndex].push_back(distance);
+    return;
   }
+
+  // The search may be called from a thread of an enclosing parallel region,
+  // whose number may be larger than the number of buffers; it is then the
+  // only thread using them.
+  #ifdef HAS_OPENMP
+    RangeSearchBuffer& buffer =
+        (*buffers)[omp_get_thread_num() % buffers->size()];
+  #else
+    RangeSearchBuffer& buffer = (*buffers)[0];
+  #endif
+
+  buffer.queries.push_back(queryIndex);
+  buffer.neighbors.push_back(referenceIndex);
+  buffer.distances.push_back(distance);
 }
 
 } // namespace range
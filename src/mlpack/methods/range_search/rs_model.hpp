@@ -19,6 +19,7 @@
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
 #include <boost/variant.hpp>
 #include "range_search.hpp"
 
@@ -42,10 +43,8 @@ class MonoSearchVisitor : public  boost::static_visitor<void>
  private:
   //! The range to search for.
   const math::Range& range;
-  //! Output neighbors.
-  std::vector<std::vector<size_t>>& neighbors;
-  //! Output distances.
-  std::vector<std::vector<double>>& distances;
+  //! Output neighbors and distances.
+  RangeSearchResults& results;
 
  public:
   //! Perform monochromatic search with the given RangeSearch object.
@@ -54,11 +53,9 @@ class MonoSearchVisitor : public  boost::static_visitor<void>
 
   //! Construct the MonoSearchVisitor with the given parameters.
   MonoSearchVisitor(const math::Range& range,
-                    std::vector<std::vector<size_t>>& neighbors,
-                    std::vector<std::vector<double>>& distances):
+                    RangeSearchResults& results):
       range(range),
-      neighbors(neighbors),
-      distances(distances)
+      results(results)
   {};
 };
 
@@ -75,10 +72,8 @@ class BiSearchVisitor : public boost::static_visitor<void>
   const arma::mat& querySet;
   //! Range to search neighbours for.
   const math::Range& range;
-  //! The result vector for neighbors.
-  std::vector<std::vector<size_t>>& neighbors;
-  //! The result vector for distances.
-  std::vector<std::vector<double>>& distances;
+  //! The results (neighbors and distances).
+  RangeSearchResults& results;
   //! The number of points in a leaf (for BinarySpaceTrees).
   const size_t leafSize;
 
@@ -111,8 +106,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   //! Construct the BiSearchVisitor.
   BiSearchVisitor(const arma::mat& querySet,
                   const math::Range& range,
-                  std::vector<std::vector<size_t>>& neighbors,
-                  std::vector<std::vector<double>>& distances,
+                  RangeSearchResults& results,
                   const size_t leafSize);
 };
 
@@ -259,6 +253,11 @@ class RSModel
                  RSType<tree::UBTree>*,
                  RSType<tree::Octree>*> rSearch;
 
+  //! The file the reference set is memory-mapped from (empty if none).
+  std::string referenceMapFile;
+  //! The memory-mapped reference set, if any; copies of the model share it.
+  std::shared_ptr<data::MappedMatrix<double>> mappedReferenceSet;
+
  public:
   /**
    * Initialize the RSModel with the given type and whether or not a random
@@ -300,7 +299,7 @@ class RSModel
 
   //! Serialize the range search model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   //! Expose the dataset.
   const arma::mat& Dataset() const;
@@ -345,6 +344,22 @@ class RSModel
                   const bool naive,
                   const bool singleMode);
 
+  /**
+   * Write the reference set to the given file and memory-map it from there.
+   * From then on the model is serialized without its reference set: only the
+   * name of the file is stored, and loading the model memory-maps the file
+   * again.  Any number of processes can load such a model while sharing a
+   * single copy of the reference set in the page cache.  The file must not be
+   * modified or removed while a model uses it.  Building the model again
+   * drops the mapping.
+   *
+   * @param filename File to write the reference set to.
+   */
+  void MapReferenceSet(const std::string& filename);
+
+  //! Get the file the reference set is memory-mapped from (empty if none).
+  const std::string& ReferenceMapFile() const { return referenceMapFile; }
+
   /**
    * Perform range search.  This takes possession of the query set, so the query
    * set will not be usable after the search.  For more information on the
@@ -360,6 +375,20 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Perform range search, returning the results in compressed form (see
+   * RangeSearchResults).  This takes possession of the query set, so the query
+   * set will not be usable after the search.
+   *
+   * @param querySet Set of query points.
+   * @param range Range to search for.
+   * @param results Output: neighbors falling within the desired range, and
+   *     their distances.
+   */
+  void Search(arma::mat&& querySet,
+              const math::Range& range,
+              RangeSearchResults& results);
+
   /**
    * Perform monochromatic range search, with the reference set as the query
    * set.  For more information on the output format, see
@@ -373,6 +402,16 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Perform monochromatic range search, with the reference set as the query
+   * set, returning the results in compressed form (see RangeSearchResults).
+   *
+   * @param range Range to search for.
+   * @param results Output: neighbors falling within the desired range, and
+   *     their distances.
+   */
+  void Search(const math::Range& range, RangeSearchResults& results);
+
  private:
   /**
    * Return a string representing the name of the tree.  This is used for
@@ -389,6 +428,9 @@ class RSModel
 } // namespace range
 } // namespace mlpack
 
+//! Set the serialization version of the RSModel class.
+BOOST_CLASS_VERSION(mlpack::range::RSModel, 1);
+
 // Include implementation (of serialize() and inline functions).
 #include "rs_model_impl.hpp"
 
@@ -17,6 +17,7 @@
 
 #include <mlpack/core/math/random_basis.hpp>
 #include <boost/serialization/variant.hpp>
+#include <boost/serialization/string.hpp>
 
 namespace mlpack {
 namespace range {
@@ -39,7 +40,9 @@ inline RSModel::RSModel(const RSModel& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(other.q),
-    rSearch(other.rSearch)
+    rSearch(other.rSearch),
+    referenceMapFile(other.referenceMapFile),
+    mappedReferenceSet(other.mappedReferenceSet)
 {
   // Nothing to do.
 }
@@ -50,7 +53,9 @@ inline RSModel::RSModel(RSModel&& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    rSearch(std::move(other.rSearch))
+    rSearch(std::move(other.rSearch)),
+    referenceMapFile(std::move(other.referenceMapFile)),
+    mappedReferenceSet(std::move(other.mappedReferenceSet))
 {
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -68,6 +73,8 @@ inline RSModel& RSModel::operator=(RSModel other)
   randomBasis = other.randomBasis;
   q = std::move(other.q);
   rSearch = std::move(other.rSearch);
+  referenceMapFile = std::move(other.referenceMapFile);
+  mappedReferenceSet = std::move(other.mappedReferenceSet);
 
   return *this;
 }
@@ -94,6 +101,8 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
 
   // Clean memory, if necessary.
   boost::apply_visitor(DeleteVisitor(), rSearch);
+  referenceMapFile.clear();
+  mappedReferenceSet.reset();
 
   // Do we need to modify the reference set?
   if (randomBasis)
@@ -179,6 +188,16 @@ inline void RSModel::Search(arma::mat&& querySet,
                             const math::Range& range,
                             std::vector<std::vector<size_t>>& neighbors,
                             std::vector<std::vector<double>>& distances)
+{
+  RangeSearchResults results;
+  Search(std::move(querySet), range, results);
+  results.Export(neighbors, distances);
+}
+
+// Perform range search, with compressed results.
+inline void RSModel::Search(arma::mat&& querySet,
+                            const math::Range& range,
+                            RangeSearchResults& results)
 {
   // We may need to map the query set randomly.
   if (randomBasis)
@@ -194,8 +213,7 @@ inline void RSModel::Search(arma::mat&& querySet,
     Log::Info << "brute-force (naive) search..." << std::endl;
 
 
-  BiSearchVisitor search(querySet, range, neighbors, distances,
-      leafSize);
+  BiSearchVisitor search(querySet, range, results, leafSize);
   boost::apply_visitor(search, rSearch);
 }
 
@@ -203,6 +221,15 @@ inline void RSModel::Search(arma::mat&& querySet,
 inline void RSModel::Search(const math::Range& range,
                             std::vector<std::vector<size_t>>& neighbors,
                             std::vector<std::vector<double>>& distances)
+{
+  RangeSearchResults results;
+  Search(range, results);
+  results.Export(neighbors, distances);
+}
+
+// Perform range search (monochromatic case), with compressed results.
+inline void RSModel::Search(const math::Range& range,
+                            RangeSearchResults& results)
 {
   Log::Info << "Search for points in the range [" << range.Lo() << ", "
       << range.Hi() << "] with ";
@@ -213,7 +240,7 @@ inline void RSModel::Search(const math::Range& range,
   else
     Log::Info << "brute-force (naive) search..." << std::endl;
 
-  MonoSearchVisitor search(range, neighbors, distances);
+  MonoSearchVisitor search(range, results);
   boost::apply_visitor(search, rSearch);
 }
 
@@ -266,7 +293,7 @@ template<typename RSType>
 void MonoSearchVisitor::operator()(RSType* rs) const
 {
   if (rs)
-    return rs->Search(range, neighbors, distances);
+    return rs->Search(range, results);
   throw std::runtime_error("no range search model initialized");
 }
 
@@ -274,13 +301,11 @@ void MonoSearchVisitor::operator()(RSType* rs) const
 inline BiSearchVisitor::BiSearchVisitor(
     const arma::mat& querySet,
     const math::Range& range,
-    std::vector<std::vector<size_t>>& neighbors,
-    std::vector<std::vector<double>>& distances,
+    RangeSearchResults& results,
     const size_t leafSize) :
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    results(results),
     leafSize(leafSize)
 {}
 
@@ -291,7 +316,7 @@ template<template<typename TreeMetricType,
 void BiSearchVisitor::operator()(RSTypeT<TreeType>* rs) const
 {
   if (rs)
-    return rs->Search(querySet, range, neighbors, distances);
+    return rs->Search(querySet, range, results);
   throw std::runtime_error("no range search model initialized");
 }
 
@@ -334,21 +359,13 @@ void BiSearchVisitor::SearchLeaf(RSType* rs) const
     Log::Info << "Tree built." << std::endl;
     Timer::Stop("tree_building");
 
-    std::vector<std::vector<size_t>> neighborsOut;
-    std::vector<std::vector<double>> distancesOut;
-    rs->Search(&queryTree, range, neighborsOut, distancesOut);
+    rs->Search(&queryTree, range, results);
 
     // Remap the query points.
-    neighbors.resize(queryTree.Dataset().n_cols);
-    distances.resize(queryTree.Dataset().n_cols);
-    for (size_t i = 0; i < queryTree.Dataset().n_cols; ++i)
-    {
-      neighbors[oldFromNewQueries[i]] = neighborsOut[i];
-      distances[oldFromNewQueries[i]] = distancesOut[i];
-    }
+    results.MapQueries(oldFromNewQueries);
   }
   else
-    rs->Search(querySet, range, neighbors, distances);
+    rs->Search(querySet, range, results);
 }
 
 //! Save parameters for Train.
@@ -450,18 +467,67 @@ bool& NaiveVisitor::operator()(RSType* rs) const
 
 // Serialize the model.
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const unsigned int /* version */)
+void RSModel::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
+  // Older versions of RSModel could not memory-map the reference set.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(referenceMapFile);
+  else if (Archive::is_loading::value)
+    referenceMapFile.clear();
+
   // This should never happen, but just in case...
   if (Archive::is_loading::value)
+  {
     boost::apply_visitor(DeleteVisitor(), rSearch);
+    mappedReferenceSet.reset();
+  }
 
   // We'll only need to serialize one of the model objects, based on the type.
-  ar & BOOST_SERIALIZATION_NVP(rSearch);
+  if (Archive::is_saving::value && !referenceMapFile.empty())
+  {
+    // Serialize an empty reference set; it will be mapped again on loading.
+    // The matrix is owned by the RangeSearch object (or its tree), so it is
+    // fine to modify it here.
+    arma::mat& referenceSet = const_cast<arma::mat&>(Dataset());
+    data::MappedMatrix<double>::Unalias(referenceSet);
+    ar & BOOST_SERIALIZATION_NVP(rSearch);
+    mappedReferenceSet->Alias(referenceSet);
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(rSearch);
+  }
+
+  if (Archive::is_loading::value && !referenceMapFile.empty())
+  {
+    mappedReferenceSet = std::make_shared<data::MappedMatrix<double>>(
+        referenceMapFile);
+    mappedReferenceSet->Alias(const_cast<arma::mat&>(Dataset()));
+  }
+}
+
+// Write the reference set to the given file and memory-map it.
+inline void RSModel::MapReferenceSet(const std::string& filename)
+{
+  // Rewriting a file that is already mapped would corrupt the mapping.
+  if (filename == referenceMapFile)
+    return;
+
+  // The matrix is owned by the RangeSearch object (or its tree); only the
+  // memory that backs it is replaced.
+  arma::mat& referenceSet = const_cast<arma::mat&>(Dataset());
+  data::MappedMatrix<double>::Save(filename, referenceSet);
+
+  std::shared_ptr<data::MappedMatrix<double>> mapped =
+      std::make_shared<data::MappedMatrix<double>>(filename);
+  mapped->Alias(referenceSet);
+
+  mappedReferenceSet = mapped;
+  referenceMapFile = filename;
 }
 
 inline const arma::mat& RSModel::Dataset() const
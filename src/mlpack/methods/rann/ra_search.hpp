@@ -28,6 +28,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_query_blocks.hpp>
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
@@ -356,6 +357,17 @@ class RASearch
   //! Modify the limit on the size of a node that can be approximation.
   size_t& SingleSampleLimit() { return singleSampleLimit; }
 
+  /**
+   * Get whether naive and single-tree searches are run in parallel over blocks
+   * of query points.  Each thread then uses its own copy of the rules, so
+   * memory usage grows with the number of threads.  The samples of each query
+   * point are drawn from their own random stream, so the results do not depend
+   * on the number of threads.
+   */
+  bool ParallelQueries() const { return parallelQueries; }
+  //! Modify whether queries are searched in parallel blocks.
+  bool& ParallelQueries() { return parallelQueries; }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -389,6 +401,8 @@ class RASearch
   //! The limit on the number of points in the largest node that can be
   //! approximated by sampling.
   size_t singleSampleLimit;
+  //! If true, single-tree searches are run over query blocks in parallel.
+  bool parallelQueries;
 
   //! Instantiation of kernel.
   MetricType metric;
@@ -76,6 +76,7 @@ RASearch(MatType referenceSetIn,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
+    parallelQueries(false),
     metric(metric)
 {
   // Nothing to do.
@@ -108,6 +109,7 @@ RASearch(Tree* referenceTree,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
+    parallelQueries(false),
     metric(metric)
 // Nothing else to initialize.
 {  }
@@ -139,6 +141,7 @@ RASearch(const bool naive,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
+    parallelQueries(false),
     metric(metric)
 {
   // Build the tree on the empty dataset, if necessary.
@@ -306,9 +309,12 @@ Search(const MatType& querySet,
 
     // Run the base case on each combination of query point and sampled
     // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    tree::ParallelQueryBlocks(rules, querySet.n_cols, parallelQueries,
+        [&distinctSamples](RuleType& blockRules, const size_t begin,
+                           const size_t end)
+        {
+          blockRules.BaseCaseSamples(begin, end, distinctSamples);
+        });
 
     rules.GetResults(*neighborPtr, *distancePtr);
   }
@@ -323,12 +329,18 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
       // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      tree::ParallelQueryBlocks(rules, querySet.n_cols, parallelQueries,
+          [this](RuleType& blockRules, const size_t begin, const size_t end)
+          {
+            typename Tree::template SingleTreeTraverser<RuleType>
+                traverser(blockRules);
+            for (size_t i = begin; i < end; ++i)
+            {
+              blockRules.SeedSamples(i);
+              traverser.Traverse(i, *referenceTree);
+            }
+          });
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -539,12 +551,18 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
     // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    tree::ParallelQueryBlocks(rules, referenceSet->n_cols, parallelQueries,
+        [this](RuleType& blockRules, const size_t begin, const size_t end)
+        {
+          typename Tree::template SingleTreeTraverser<RuleType>
+              traverser(blockRules);
+          for (size_t i = begin; i < end; ++i)
+          {
+            blockRules.SeedSamples(i);
+            traverser.Traverse(i, *referenceTree);
+          }
+        });
   }
   else
   {
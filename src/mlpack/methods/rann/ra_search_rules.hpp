@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/squared_distance_block.hpp>
 
 #include <queue>
 
@@ -227,6 +228,32 @@ class RASearchRules
                  const double oldScore);
 
 
+  /**
+   * Perform the base cases between each query point in [queryBegin, queryEnd)
+   * and each of the given reference points (the samples of naive search); the
+   * results are the same as calling BaseCase() for each pair in order.  For the
+   * (squared) Euclidean distance, the distances are first computed
+   * approximately as matrix products, and only the pairs that may enter the
+   * candidate lists are evaluated exactly.
+   *
+   * @param queryBegin Index of the first query point.
+   * @param queryEnd One past the index of the last query point.
+   * @param referenceIndices Indices of the reference points.
+   */
+  void BaseCaseSamples(const size_t queryBegin,
+                       const size_t queryEnd,
+                       const arma::uvec& referenceIndices);
+
+  /**
+   * Restart the random sampling with the given stream.  Single-tree search
+   * does this before each query point, with the index of the point as the
+   * stream, so that the samples of a point do not depend on the other points
+   * or on how the query points are split between threads.
+   *
+   * @param stream Index of the stream of random numbers.
+   */
+  void SeedSamples(const size_t stream) { generator.Seed(seed, stream); }
+
   size_t NumDistComputations() { return numDistComputations; }
   size_t NumEffectiveSamples()
   {
@@ -236,6 +263,28 @@ class RASearchRules
       return arma::sum(numSamplesMade);
   }
 
+  //! Get the number of base cases (distance computations).
+  size_t BaseCases() const { return numDistComputations; }
+  //! Modify the number of base cases (distance computations).
+  size_t& BaseCases() { return numDistComputations; }
+
+  //! Get the number of node combinations that have been scored.
+  size_t Scores() const { return scores; }
+  //! Modify the number of node combinations that have been scored.
+  size_t& Scores() { return scores; }
+
+  /**
+   * Merge the candidate lists and sample counts of the query points in
+   * [begin, end) from another rules object into this one.  This is used when
+   * blocks of query points are searched in parallel, with one copy of the rules
+   * per thread.
+   *
+   * @param other Rules object that was used to search the query points.
+   * @param begin Index of the first query point to merge.
+   * @param end One past the index of the last query point to merge.
+   */
+  void Merge(const RASearchRules& other, const size_t begin, const size_t end);
+
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
@@ -298,11 +347,52 @@ class RASearchRules
   //! The number of distance calculations performed during search.
   size_t numDistComputations;
 
+  //! The number of node combinations that have been scored.
+  size_t scores;
+
   //! If the query and reference set are identical, this is true.
   bool sameSet;
 
   TraversalInfoType traversalInfo;
 
+  //! The seed of the random samples, drawn from the global random number
+  //! generator when the rules are created.
+  uint64_t seed;
+  //! The random number generator of the samples; each copy of the rules (one
+  //! per thread, when query points are searched in parallel) has its own.
+  math::Philox generator;
+
+  /**
+   * Obtain distinct samples from [loInclusive, hiExclusive), with the random
+   * number generator of these rules.
+   */
+  void ObtainDistinctSamples(const size_t loInclusive,
+                             const size_t hiExclusive,
+                             const size_t maxNumSamples,
+                             arma::uvec& distinctSamples)
+  {
+    math::ObtainDistinctSamples(loInclusive, hiExclusive, maxNumSamples,
+        distinctSamples, generator);
+  }
+
+  //! Whether base cases can be computed as a block of squared distances.
+  typedef std::integral_constant<bool,
+      std::is_same<MetricType, metric::EuclideanDistance>::value ||
+      std::is_same<MetricType, metric::SquaredEuclideanDistance>::value>
+      UseDistanceBlock;
+
+  //! Perform the base cases of the samples with blocks of squared distances.
+  void BaseCaseSamplesImpl(const size_t queryBegin,
+                           const size_t queryEnd,
+                           const arma::uvec& referenceIndices,
+                           const std::true_type /* useDistanceBlock */);
+
+  //! Perform the base cases of the samples one pair at a time.
+  void BaseCaseSamplesImpl(const size_t queryBegin,
+                           const size_t queryEnd,
+                           const arma::uvec& referenceIndices,
+                           const std::false_type /* useDistanceBlock */);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -38,7 +38,9 @@ RASearchRules(const arma::mat& referenceSet,
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    sameSet(sameSet)
+    sameSet(sameSet),
+    seed((uint64_t) math::randGen()),
+    generator(seed)
 {
   // Validate tau to make sure that the rank approximation is greater than the
   // number of neighbors requested.
@@ -65,6 +67,7 @@ RASearchRules(const arma::mat& referenceSet,
   // Initialize some statistics to be collected during the search.
   numSamplesMade = arma::zeros<arma::Col<size_t> >(querySet.n_cols);
   numDistComputations = 0;
+  scores = 0;
   samplingRatio = (double) numSamplesReqd / (double) n;
 
   Log::Info << "Minimum samples required per query: " << numSamplesReqd <<
@@ -90,7 +93,7 @@ RASearchRules(const arma::mat& referenceSet,
     arma::uvec distinctSamples;
     for (size_t i = 0; i < querySet.n_cols; ++i)
     {
-      math::ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples);
+      ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples);
       for (size_t j = 0; j < distinctSamples.n_elem; ++j)
         BaseCase(i, (size_t) distinctSamples[j]);
     }
@@ -117,6 +120,19 @@ void RASearchRules<SortPolicy, MetricType, TreeType>::GetResults(
   }
 };
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::Merge(
+    const RASearchRules& other,
+    const size_t begin,
+    const size_t end)
+{
+  for (size_t i = begin; i < end; ++i)
+  {
+    candidates[i] = other.candidates[i];
+    numSamplesMade[i] = other.numSamplesMade[i];
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline force_inline
 double RASearchRules<SortPolicy, MetricType, TreeType>::BaseCase(
@@ -140,11 +156,98 @@ double RASearchRules<SortPolicy, MetricType, TreeType>::BaseCase(
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BaseCaseSamples(
+    const size_t queryBegin,
+    const size_t queryEnd,
+    const arma::uvec& referenceIndices)
+{
+  BaseCaseSamplesImpl(queryBegin, queryEnd, referenceIndices,
+      UseDistanceBlock());
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BaseCaseSamplesImpl(
+    const size_t queryBegin,
+    const size_t queryEnd,
+    const arma::uvec& referenceIndices,
+    const std::true_type /* useDistanceBlock */)
+{
+  if (queryEnd <= queryBegin || referenceIndices.n_elem == 0)
+    return;
+
+  const arma::mat references = referenceSet.cols(referenceIndices);
+  const bool takeRoot =
+      std::is_same<MetricType, metric::EuclideanDistance>::value;
+
+  // Compute the distances of a few query points at a time, so that the block
+  // of distances stays small.
+  const size_t blockSize = 256;
+  arma::mat squaredDistances;
+  for (size_t blockBegin = queryBegin; blockBegin < queryEnd;
+       blockBegin += blockSize)
+  {
+    const size_t blockEnd = std::min(blockBegin + blockSize, queryEnd);
+    const arma::mat queries = querySet.cols(blockBegin, blockEnd - 1);
+    const double error = metric::SquaredDistanceBlock(queries, references,
+        squaredDistances);
+
+    for (size_t i = 0; i < queries.n_cols; ++i)
+    {
+      const size_t queryIndex = blockBegin + i;
+      for (size_t j = 0; j < referenceIndices.n_elem; ++j)
+      {
+        const size_t referenceIndex = referenceIndices[j];
+        if (sameSet && (queryIndex == referenceIndex))
+          continue;
+
+        // As in BaseCase(), every sample is counted, whether or not its
+        // distance has to be evaluated exactly.
+        numSamplesMade[queryIndex]++;
+        numDistComputations++;
+
+        // Only evaluate the distance exactly if it may enter the candidate
+        // list; the distance lies between lower and upper.
+        double lower = std::max(squaredDistances(i, j) - error, 0.0);
+        double upper = squaredDistances(i, j) + error;
+        if (takeRoot)
+        {
+          lower = std::sqrt(lower);
+          upper = std::sqrt(upper);
+        }
+
+        const Candidate& worst = candidates[queryIndex].top();
+        if (!CandidateCmp()(std::make_pair(lower, referenceIndex), worst) &&
+            !CandidateCmp()(std::make_pair(upper, referenceIndex), worst))
+          continue;
+
+        const double distance = metric.Evaluate(
+            querySet.unsafe_col(queryIndex),
+            referenceSet.unsafe_col(referenceIndex));
+        InsertNeighbor(queryIndex, referenceIndex, distance);
+      }
+    }
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BaseCaseSamplesImpl(
+    const size_t queryBegin,
+    const size_t queryEnd,
+    const arma::uvec& referenceIndices,
+    const std::false_type /* useDistanceBlock */)
+{
+  for (size_t i = queryBegin; i < queryEnd; ++i)
+    for (size_t j = 0; j < referenceIndices.n_elem; ++j)
+      BaseCase(i, (size_t) referenceIndices[j]);
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
     TreeType& referenceNode)
 {
+  ++scores; // Count number of Score() calls.
   const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode);
@@ -159,6 +262,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
     TreeType& referenceNode,
     const double baseCaseResult)
 {
+  ++scores; // Count number of Score() calls.
   const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode, baseCaseResult);
@@ -204,7 +308,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
           arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(0, referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t i = 0; i < distinctSamples.n_elem; ++i)
             // The counting of the samples are done in the 'BaseCase' function
@@ -220,7 +324,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           {
             // Approximate node by sampling enough number of points.
             arma::uvec distinctSamples;
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(0, referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t i = 0; i < distinctSamples.n_elem; ++i)
               // The counting of the samples are done in the 'BaseCase' function
@@ -308,7 +412,7 @@ Rescore(const size_t queryIndex,
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
         arma::uvec distinctSamples;
-        math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+        ObtainDistinctSamples(0, referenceNode.NumDescendants(),
             samplesReqd, distinctSamples);
         for (size_t i = 0; i < distinctSamples.n_elem; ++i)
           // The counting of the samples are done in the 'BaseCase' function so
@@ -324,7 +428,7 @@ Rescore(const size_t queryIndex,
         {
           // Approximate node by sampling enough points.
           arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(0, referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t i = 0; i < distinctSamples.n_elem; ++i)
             // The counting of the samples are done in the 'BaseCase' function
@@ -362,6 +466,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
     TreeType& queryNode,
     TreeType& referenceNode)
 {
+  ++scores; // Count number of Score() calls.
   // First try to find the distance bound to check if we can prune by distance.
 
   // Calculate the best node-to-node distance.
@@ -400,6 +505,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
       TreeType& referenceNode,
       const double baseCaseResult)
 {
+  ++scores; // Count number of Score() calls.
   // First try to find the distance bound to check if we can prune
   // by distance.
 
@@ -511,7 +617,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(0, referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t j = 0; j < distinctSamples.n_elem; ++j)
               // The counting of the samples are done in the 'BaseCase' function
@@ -541,7 +647,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
             {
               const size_t queryIndex = queryNode.Descendant(i);
-              math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+              ObtainDistinctSamples(0, referenceNode.NumDescendants(),
                   samplesReqd, distinctSamples);
               for (size_t j = 0; j < distinctSamples.n_elem; ++j)
                 // The counting of the samples are done in the 'BaseCase'
@@ -716,7 +822,7 @@ Rescore(TreeType& queryNode,
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
         {
           const size_t queryIndex = queryNode.Descendant(i);
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(0, referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t j = 0; j < distinctSamples.n_elem; ++j)
             // The counting of the samples are done in the 'BaseCase'
@@ -745,7 +851,7 @@ Rescore(TreeType& queryNode,
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(0, referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t j = 0; j < distinctSamples.n_elem; ++j)
               // The counting of the samples are done in BaseCase() so no
@@ -0,0 +1,143 @@
+/**
+ * @file methods/regularized_svd/blocked_sgd.hpp
+ *
+ * Definition of the BlockedSGD optimizer, a lock-free parallel stochastic
+ * gradient descent for matrix factorizations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZED_SVD_BLOCKED_SGD_HPP
+#define MLPACK_METHODS_REGULARIZED_SVD_BLOCKED_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * BlockedSGD is a parallel stochastic gradient descent optimizer for the
+ * matrix factorization functions RegularizedSVDFunction, BiasSVDFunction and
+ * SVDPlusPlusFunction.  The users and the items are randomly split into
+ * numBlocks groups each, which splits the ratings into a grid of numBlocks x
+ * numBlocks blocks.  The blocks of a "diagonal" of the grid share no user and
+ * no item, so the threads process the blocks of a diagonal at the same time,
+ * without locks, since they update disjoint parameters; every epoch visits
+ * all the diagonals, in a random order.  Each block holds the indices of its
+ * ratings contiguously, so a thread works on a small set of user and item
+ * parameters at a time.  See the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-scale Matrix Factorization with Distributed Stochastic
+ *       Gradient Descent},
+ *   author={Gemulla, R. and Nijkamp, E. and Haas, P.J. and Sismanis, Y.},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining (KDD '11)},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The implicit vectors of SVDPlusPlusFunction depend on all the items that a
+ * user interacted with, so they can be shared between blocks; they are
+ * updated with atomic operations.
+ *
+ * The function to optimize must provide Dataset(), NumUsers(), NumItems(),
+ * NumFunctions(), Evaluate(parameters, i) and Update(parameters, i,
+ * stepSize), which takes one step on rating i.
+ *
+ * For example, to factorize a rating matrix with RegularizedSVD:
+ *
+ * @code
+ * arma::mat data; // Rating data in the form of coordinate list.
+ * RegularizedSVD<BlockedSGD> rSVD(10, 0.01, 0.02);
+ *
+ * arma::mat u, v;
+ * rSVD.Apply(data, 20, u, v);
+ * @endcode
+ */
+class BlockedSGD
+{
+ public:
+  /**
+   * Create the optimizer with the given parameters.
+   *
+   * @param stepSize Step size of the updates.
+   * @param maxEpochs Maximum number of passes over the ratings (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute change of the objective between two
+   *     epochs to terminate.
+   * @param shuffle Whether to shuffle the ratings of each block every epoch.
+   * @param numBlocks Number of groups of users and of items; 0 means twice the
+   *     number of threads.
+   */
+  BlockedSGD(const double stepSize = 0.01,
+             const size_t maxEpochs = 10,
+             const double tolerance = 1e-5,
+             const bool shuffle = true,
+             const size_t numBlocks = 0);
+
+  /**
+   * Optimize the given function, starting from the given parameters, which are
+   * modified to store the result.  The objective over all the ratings is
+   * returned.
+   *
+   * @param function Function to optimize.
+   * @param parameters Starting point; will be modified to store the result.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function, arma::mat& parameters);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of epochs (0 means no limit).
+  size_t MaxEpochs() const { return maxEpochs; }
+  //! Modify the maximum number of epochs (0 means no limit).
+  size_t& MaxEpochs() { return maxEpochs; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether the ratings of each block are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether the ratings of each block are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the number of groups of users and of items (0 means automatic).
+  size_t NumBlocks() const { return numBlocks; }
+  //! Modify the number of groups of users and of items (0 means automatic).
+  size_t& NumBlocks() { return numBlocks; }
+
+ private:
+  //! Compute the objective over all the ratings, in parallel.
+  template<typename FunctionType>
+  static double Objective(const FunctionType& function,
+                          const arma::mat& parameters);
+
+  //! The step size.
+  double stepSize;
+  //! The maximum number of epochs.
+  size_t maxEpochs;
+  //! The tolerance for termination.
+  double tolerance;
+  //! Whether to shuffle the ratings of each block.
+  bool shuffle;
+  //! The number of groups of users and of items.
+  size_t numBlocks;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+// Include implementation.
+#include "blocked_sgd_impl.hpp"
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file methods/regularized_svd/blocked_sgd_impl.hpp
+ *
+ * Implementation of the BlockedSGD optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZED_SVD_BLOCKED_SGD_IMPL_HPP
+#define MLPACK_METHODS_REGULARIZED_SVD_BLOCKED_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "blocked_sgd.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace svd {
+
+inline BlockedSGD::BlockedSGD(const double stepSize,
+                              const size_t maxEpochs,
+                              const double tolerance,
+                              const bool shuffle,
+                              const size_t numBlocks) :
+    stepSize(stepSize),
+    maxEpochs(maxEpochs),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    numBlocks(numBlocks)
+{
+  // Nothing to do.
+}
+
+template<typename FunctionType>
+double BlockedSGD::Optimize(FunctionType& function, arma::mat& parameters)
+{
+  const arma::mat& data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+  const size_t numItems = function.NumItems();
+  const size_t numRatings = function.NumFunctions();
+
+  // Use more blocks than threads, so that the threads that get small blocks
+  // can take another block of the diagonal.
+  size_t blocks = numBlocks;
+  if (blocks == 0)
+  {
+    #ifdef HAS_OPENMP
+    blocks = 2 * omp_get_max_threads();
+    #else
+    blocks = 1;
+    #endif
+  }
+  blocks = std::max((size_t) 1, std::min(blocks, std::min(numUsers,
+      numItems)));
+
+  // Split the users and the items randomly into groups of the same size, so
+  // that the blocks are balanced even if the ratings are sorted.
+  arma::Col<size_t> userBlock(numUsers), itemBlock(numItems);
+  const arma::uvec userOrder = arma::randperm(numUsers);
+  for (size_t i = 0; i < numUsers; ++i)
+    userBlock[userOrder[i]] = i * blocks / numUsers;
+  const arma::uvec itemOrder = arma::randperm(numItems);
+  for (size_t i = 0; i < numItems; ++i)
+    itemBlock[itemOrder[i]] = i * blocks / numItems;
+
+  // Sort the indices of the ratings by block.
+  arma::Col<size_t> blockStart(blocks * blocks + 1, arma::fill::zeros);
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    const size_t user = (size_t) data(0, i);
+    const size_t item = (size_t) data(1, i);
+    ++blockStart[userBlock[user] * blocks + itemBlock[item] + 1];
+  }
+  for (size_t b = 0; b < blocks * blocks; ++b)
+    blockStart[b + 1] += blockStart[b];
+
+  std::vector<size_t> ratings(numRatings);
+  {
+    arma::Col<size_t> position = blockStart.head(blocks * blocks);
+    for (size_t i = 0; i < numRatings; ++i)
+    {
+      const size_t user = (size_t) data(0, i);
+      const size_t item = (size_t) data(1, i);
+      ratings[position[userBlock[user] * blocks + itemBlock[item]]++] = i;
+    }
+  }
+
+  arma::Col<size_t> diagonals = arma::linspace<arma::Col<size_t>>(0,
+      blocks - 1, blocks);
+  std::vector<std::mt19937::result_type> seeds(blocks * blocks);
+
+  double objective = Objective(function, parameters);
+  Log::Info << "BlockedSGD: " << blocks << " x " << blocks << " blocks; "
+      << "initial objective " << objective << "." << std::endl;
+
+  for (size_t epoch = 1; maxEpochs == 0 || epoch <= maxEpochs; ++epoch)
+  {
+    // Choose the order of the diagonals and the seeds of the shuffles of the
+    // blocks with the global generator, to get reproducible results.
+    diagonals = arma::shuffle(diagonals);
+    if (shuffle)
+    {
+      for (size_t b = 0; b < seeds.size(); ++b)
+        seeds[b] = math::randGen();
+    }
+
+    for (size_t d = 0; d < blocks; ++d)
+    {
+      // The blocks of a diagonal have different users and different items.
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t u = 0; u < (omp_size_t) blocks; ++u)
+      {
+        const size_t block = u * blocks + (u + diagonals[d]) % blocks;
+        std::vector<size_t>::iterator begin = ratings.begin() +
+            blockStart[block];
+        std::vector<size_t>::iterator end = ratings.begin() +
+            blockStart[block + 1];
+        if (shuffle)
+        {
+          std::mt19937 generator(seeds[block]);
+          std::shuffle(begin, end, generator);
+        }
+
+        for (std::vector<size_t>::iterator it = begin; it != end; ++it)
+          function.Update(parameters, *it, stepSize);
+      }
+    }
+
+    const double lastObjective = objective;
+    objective = Objective(function, parameters);
+    Log::Info << "BlockedSGD: epoch " << epoch << ", objective " << objective
+        << "." << std::endl;
+
+    if (std::isnan(objective) || std::isinf(objective))
+    {
+      Log::Warn << "BlockedSGD: converged to " << objective << "; terminating "
+          << "with failure.  Try a smaller step size?" << std::endl;
+      return objective;
+    }
+
+    if (std::abs(lastObjective - objective) < tolerance)
+    {
+      Log::Info << "BlockedSGD: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+      return objective;
+    }
+  }
+
+  return objective;
+}
+
+template<typename FunctionType>
+double BlockedSGD::Objective(const FunctionType& function,
+                             const arma::mat& parameters)
+{
+  double objective = 0.0;
+  #pragma omp parallel for schedule(static) reduction(+:objective)
+  for (omp_size_t i = 0; i < (omp_size_t) function.NumFunctions(); ++i)
+    objective += function.Evaluate(parameters, i);
+
+  return objective;
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
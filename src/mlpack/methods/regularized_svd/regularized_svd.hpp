@@ -18,6 +18,7 @@
 #include <mlpack/methods/cf/cf.hpp>
 
 #include "regularized_svd_function.hpp"
+#include "blocked_sgd.hpp"
 
 namespace mlpack {
 namespace svd {
@@ -62,7 +63,8 @@ class RegularizedSVD
    * Constructor for Regularized SVD. Obtains the user and item matrices after
    * training on the passed data. The constructor initiates an object of class
    * RegularizedSVDFunction for optimization. It uses the SGD optimizer by
-   * default. The optimizer uses a template specialization of Optimize().
+   * default. The optimizer uses a template specialization of Optimize().  If
+   * OptimizerType is BlockedSGD, the ratings are processed in parallel.
    *
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
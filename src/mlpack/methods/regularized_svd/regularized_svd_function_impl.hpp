@@ -150,6 +150,28 @@ void RegularizedSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void RegularizedSVDFunction<MatType>::Update(arma::mat& parameters,
+                                             const size_t i,
+                                             const double stepSize) const
+{
+  // Indices for accessing the the correct parameter columns.
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+
+  // Prediction error for the example.
+  const double rating = data(2, i);
+  double ratingError = rating - arma::dot(parameters.col(user),
+                                          parameters.col(item));
+
+  // Gradient is non-zero only for the parameter columns corresponding to the
+  // example.
+  parameters.col(user) -= stepSize * (lambda * parameters.col(user) -
+                                      ratingError * parameters.col(item));
+  parameters.col(item) -= stepSize * (lambda * parameters.col(item) -
+                                      ratingError * parameters.col(user));
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -173,8 +195,6 @@ double StandardSGD::Optimize(
   for (size_t i = 0; i < numFunctions; ++i)
     overallObjective += function.Evaluate(parameters, i);
 
-  const arma::mat data = function.Dataset();
-
   // Now iterate!
   for (size_t i = 1; i != maxIterations; ++i, currentFunction++)
   {
@@ -190,25 +210,7 @@ double StandardSGD::Optimize(
       currentFunction = 0;
     }
 
-    const size_t numUsers = function.NumUsers();
-
-    // Indices for accessing the the correct parameter columns.
-    const size_t user = data(0, currentFunction);
-    const size_t item = data(1, currentFunction) + numUsers;
-
-    // Prediction error for the example.
-    const double rating = data(2, currentFunction);
-    double ratingError = rating - arma::dot(parameters.col(user),
-                                            parameters.col(item));
-
-    double lambda = function.Lambda();
-
-    // Gradient is non-zero only for the parameter columns corresponding to the
-    // example.
-    parameters.col(user) -= stepSize * (lambda * parameters.col(user) -
-                                        ratingError * parameters.col(item));
-    parameters.col(item) -= stepSize * (lambda * parameters.col(item) -
-                                        ratingError * parameters.col(user));
+    function.Update(parameters, currentFunction, stepSize);
 
     // Now add that to the overall objective function.
     overallObjective += function.Evaluate(parameters, currentFunction);
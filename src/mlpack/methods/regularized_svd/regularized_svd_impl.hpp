@@ -39,14 +39,22 @@ void RegularizedSVD<OptimizerType>::Apply(const arma::mat& data,
   Log::Warn << "The batch size for optimizing RegularizedSVD is 1."
       << std::endl;
 
-  // Make the optimizer object using a RegularizedSVDFunction object.
+  // Make the function to optimize using a RegularizedSVDFunction object.
   RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
-  ens::StandardSGD optimizer(alpha, batchSize,
-      iterations * data.n_cols);
 
   // Get optimized parameters.
   arma::mat parameters = rSVDFunc.GetInitialPoint();
-  optimizer.Optimize(rSVDFunc, parameters);
+  if (std::is_same<OptimizerType, BlockedSGD>::value)
+  {
+    // Each iteration is one pass over the ratings, in parallel.
+    BlockedSGD optimizer(alpha, iterations);
+    optimizer.Optimize(rSVDFunc, parameters);
+  }
+  else
+  {
+    ens::StandardSGD optimizer(alpha, batchSize, iterations * data.n_cols);
+    optimizer.Optimize(rSVDFunc, parameters);
+  }
 
   // Constants for extracting user and item matrices.
   const size_t numUsers = max(data.row(0)) + 1;
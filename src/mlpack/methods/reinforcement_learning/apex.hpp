@@ -0,0 +1,228 @@
+/**
+ * @file methods/reinforcement_learning/apex.hpp
+ *
+ * This file is the definition of the ApeX class, which trains a QLearning
+ * agent with several actors generating experience in parallel with one
+ * learner.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_APEX_HPP
+#define MLPACK_METHODS_RL_APEX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "q_learning.hpp"
+#include "replay/prioritized_replay.hpp"
+#include "worker/hogwild_update.hpp"
+#include "training_config.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of the distributed actor/learner architecture of Ape-X.
+ * Several actor threads each run their own copy of the environment, of the
+ * behavior policy and of the network, which may be a little stale.  Each
+ * actor computes the initial priorities of its transitions (their absolute
+ * TD error) with its copy of the network, and ships them in batches to the
+ * shared PrioritizedReplay.  Meanwhile, the learner (a QLearning agent, on
+ * the calling thread) trains continuously on the replay, and publishes its
+ * weights every WeightSyncInterval() training steps; the actors pick them up
+ * after their next batch.
+ *
+ * For more details, see the following:
+ * @code
+ * @inproceedings{horgan2018distributed,
+ *   title     = {Distributed Prioritized Experience Replay},
+ *   author    = {Horgan, Dan and Quan, John and Budden, David and
+ *                Barth-Maron, Gabriel and Hessel, Matteo and
+ *                van Hasselt, Hado and Silver, David},
+ *   booktitle = {International Conference on Learning Representations},
+ *   year      = {2018}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType The environment of the reinforcement learning task.
+ * @tparam NetworkType The network to compute action value.
+ * @tparam UpdaterType How to apply gradients when training.
+ * @tparam PolicyType Behavior policy of the actors.
+ */
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+class ApeX
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for the replay method.
+  using ReplayType = PrioritizedReplay<EnvironmentType>;
+
+  //! Convenient typedef for the learner.
+  using LearnerType = QLearning<EnvironmentType, NetworkType, UpdaterType,
+      PolicyType, ReplayType>;
+
+  /**
+   * Create the ApeX object with given settings.
+   *
+   * @param config Hyper-parameters for training.
+   * @param network The network to compute action value.
+   * @param policy Behavior policy; each actor uses its own copy.
+   * @param replayMethod The shared experience replay.  It must use single step
+   *     transitions.
+   * @param numActors The number of actor threads.
+   * @param sendInterval The number of transitions each actor sends at once.
+   * @param weightSyncInterval The number of training steps of the learner
+   *     between two publications of its weights.
+   * @param updater How to apply gradients when training.
+   * @param environment Reinforcement learning task; each actor uses its own
+   *     copy.
+   */
+  ApeX(TrainingConfig& config,
+       NetworkType& network,
+       PolicyType& policy,
+       ReplayType& replayMethod,
+       const size_t numActors = 4,
+       const size_t sendInterval = 50,
+       const size_t weightSyncInterval = 100,
+       UpdaterType updater = UpdaterType(),
+       EnvironmentType environment = EnvironmentType());
+
+  /**
+   * Run the actors and the learner until the given measure asks to stop.
+   *
+   * @tparam Measure The type of the measurement. It should be a callable
+   *   object like
+   *   @code
+   *   bool foo(double reward);
+   *   @endcode
+   *   where reward is the return of an episode of an actor, and the return
+   *   value indicates whether the training is completed.  It is called on the
+   *   calling thread.
+   * @param measure The measurement instance.
+   */
+  template <typename Measure>
+  void Train(Measure& measure);
+
+  //! Get the learner.
+  const LearnerType& Learner() const { return learner; }
+  //! Modify the learner.
+  LearnerType& Learner() { return learner; }
+
+  //! Get the number of actor threads.
+  size_t NumActors() const { return numActors; }
+  //! Modify the number of actor threads.
+  size_t& NumActors() { return numActors; }
+
+  //! Get the number of transitions each actor sends at once.
+  size_t SendInterval() const { return sendInterval; }
+  //! Modify the number of transitions each actor sends at once.
+  size_t& SendInterval() { return sendInterval; }
+
+  //! Get the number of training steps between two weight publications.
+  size_t WeightSyncInterval() const { return weightSyncInterval; }
+  //! Modify the number of training steps between two weight publications.
+  size_t& WeightSyncInterval() { return weightSyncInterval; }
+
+  //! Get the number of steps taken by all the actors.
+  size_t ActorSteps() const { return actorSteps; }
+
+  //! Get the number of training steps of the learner.
+  size_t LearnerSteps() const { return learnerSteps; }
+
+ private:
+  /**
+   * Run an actor until the training stops.
+   *
+   * @param network The copy of the network of the actor.
+   * @param policy The copy of the behavior policy of the actor.
+   * @param environment The copy of the environment of the actor.
+   */
+  void Actor(NetworkType& network,
+             PolicyType& policy,
+             EnvironmentType& environment);
+
+  /**
+   * Compute the priorities of the given transitions with the given network,
+   * and store them in the replay.
+   */
+  void Send(NetworkType& network,
+            const std::vector<StateType>& states,
+            const std::vector<ActionType>& actions,
+            const std::vector<double>& rewards,
+            const std::vector<StateType>& nextStates,
+            const std::vector<bool>& isTerminal);
+
+  //! Locally-stored hyper-parameters.
+  TrainingConfig& config;
+
+  //! Locally-stored behavior policy, copied by each actor.
+  PolicyType policy;
+
+  //! Locally-stored shared experience replay.
+  ReplayType& replayMethod;
+
+  //! Locally-stored reinforcement learning task, copied by each actor.
+  EnvironmentType environment;
+
+  //! The learner.
+  LearnerType learner;
+
+  //! Locally-stored number of actor threads.
+  size_t numActors;
+
+  //! Locally-stored number of transitions each actor sends at once.
+  size_t sendInterval;
+
+  //! Locally-stored number of training steps between weight publications.
+  size_t weightSyncInterval;
+
+  //! Protects the replay.
+  std::mutex replayMutex;
+
+  //! The last weights published by the learner, and their version.
+  arma::mat weights;
+  std::atomic<size_t> weightsVersion;
+  std::mutex weightsMutex;
+
+  //! The returns of the episodes of the actors, not yet measured.
+  std::queue<double> returns;
+  std::mutex returnsMutex;
+
+  //! Set to stop the actors.
+  std::atomic<bool> stop;
+
+  //! The first exception thrown by an actor.
+  std::exception_ptr error;
+
+  //! The number of steps taken by all the actors.
+  std::atomic<size_t> actorSteps;
+
+  //! The number of training steps of the learner.
+  size_t learnerSteps;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+// Include implementation.
+#include "apex_impl.hpp"
+
+#endif
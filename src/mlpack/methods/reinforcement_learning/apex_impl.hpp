@@ -0,0 +1,315 @@
+/**
+ * @file methods/reinforcement_learning/apex_impl.hpp
+ *
+ * This file is the implementation of the ApeX class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_APEX_IMPL_HPP
+#define MLPACK_METHODS_RL_APEX_IMPL_HPP
+
+#include "apex.hpp"
+
+namespace mlpack {
+namespace rl {
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+ApeX<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::ApeX(TrainingConfig& config,
+        NetworkType& network,
+        PolicyType& policy,
+        ReplayType& replayMethod,
+        const size_t numActors,
+        const size_t sendInterval,
+        const size_t weightSyncInterval,
+        UpdaterType updater,
+        EnvironmentType environment) :
+    config(config),
+    policy(policy),
+    replayMethod(replayMethod),
+    environment(environment),
+    learner(config, network, policy, replayMethod, std::move(updater),
+        std::move(environment)),
+    numActors(numActors),
+    sendInterval(sendInterval),
+    weightSyncInterval(weightSyncInterval),
+    weightsVersion(0),
+    stop(false),
+    actorSteps(0),
+    learnerSteps(0)
+{
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("ApeX::ApeX(): the replay must use single "
+        "step transitions, since the transitions of the actors are "
+        "interleaved!");
+  }
+
+  if (numActors == 0 || sendInterval == 0 || weightSyncInterval == 0)
+  {
+    throw std::invalid_argument("ApeX::ApeX(): the number of actors and the "
+        "intervals must be positive!");
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+template <typename Measure>
+void ApeX<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::Train(Measure& measure)
+{
+  stop = false;
+  error = nullptr;
+  weights = learner.Network().Parameters();
+  ++weightsVersion;
+
+  // Each actor owns a copy of the network, of the policy and of the task.
+  std::vector<NetworkType> networks(numActors, learner.Network());
+  std::vector<PolicyType> policies(numActors, policy);
+  std::vector<EnvironmentType> environments(numActors, environment);
+  for (NetworkType& network : networks)
+    LinkParameters(network);
+
+  std::vector<std::thread> actors;
+  actors.reserve(numActors);
+  for (size_t i = 0; i < numActors; ++i)
+  {
+    actors.emplace_back(&ApeX::Actor, this, std::ref(networks[i]),
+        std::ref(policies[i]), std::ref(environments[i]));
+  }
+
+  try
+  {
+    while (!stop)
+    {
+      // Measure the episodes the actors finished since the last step.
+      bool converged = false;
+      {
+        std::lock_guard<std::mutex> lock(returnsMutex);
+        while (!returns.empty() && !converged)
+        {
+          converged = measure(returns.front());
+          returns.pop();
+        }
+      }
+
+      if (converged)
+        break;
+
+      // The actors record their failures under the lock of the replay.
+      size_t stored;
+      {
+        std::lock_guard<std::mutex> lock(replayMutex);
+        if (error)
+          break;
+        stored = replayMethod.Size();
+      }
+
+      // Wait for the actors to fill the replay.
+      if (stored == 0 || stored < config.ExplorationSteps())
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(replayMutex);
+        learner.TotalSteps()++;
+        learner.TrainAgent();
+      }
+      ++learnerSteps;
+
+      // Publish the new weights to the actors.
+      if (learnerSteps % weightSyncInterval == 0)
+      {
+        std::lock_guard<std::mutex> lock(weightsMutex);
+        weights = learner.Network().Parameters();
+        ++weightsVersion;
+      }
+    }
+  }
+  catch (...)
+  {
+    stop = true;
+    for (std::thread& actor : actors)
+      actor.join();
+    throw;
+  }
+
+  stop = true;
+  for (std::thread& actor : actors)
+    actor.join();
+
+  // Pass on the failure of an actor.
+  if (error)
+    std::rethrow_exception(error);
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+void ApeX<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::Actor(NetworkType& network,
+         PolicyType& policy,
+         EnvironmentType& environment)
+{
+  try
+  {
+    std::vector<StateType> states, nextStates;
+    std::vector<ActionType> actions;
+    std::vector<double> rewards;
+    std::vector<bool> isTerminal;
+    states.reserve(sendInterval);
+    nextStates.reserve(sendInterval);
+    actions.reserve(sendInterval);
+    rewards.reserve(sendInterval);
+    isTerminal.reserve(sendInterval);
+
+    size_t version = 0;
+    StateType state = environment.InitialSample();
+    double episodeReturn = 0.0;
+    while (!stop)
+    {
+      // Pick up the last weights published by the learner.
+      if (version != weightsVersion)
+      {
+        std::lock_guard<std::mutex> lock(weightsMutex);
+        network.Parameters() = weights;
+        version = weightsVersion;
+      }
+
+      // Collect a batch of transitions.
+      states.clear();
+      nextStates.clear();
+      actions.clear();
+      rewards.clear();
+      isTerminal.clear();
+      while (states.size() < sendInterval)
+      {
+        arma::colvec actionValue;
+        network.Predict(state.Encode(), actionValue);
+        const ActionType action = policy.Sample(actionValue, false,
+            config.NoisyQLearning());
+
+        StateType nextState;
+        const double reward = environment.Sample(state, action, nextState);
+        const bool terminal = environment.IsTerminal(nextState);
+
+        states.push_back(state);
+        actions.push_back(action);
+        rewards.push_back(reward);
+        nextStates.push_back(nextState);
+        isTerminal.push_back(terminal);
+
+        episodeReturn += reward;
+        if (++actorSteps > config.ExplorationSteps())
+          policy.Anneal();
+
+        if (terminal)
+        {
+          {
+            std::lock_guard<std::mutex> lock(returnsMutex);
+            returns.push(episodeReturn);
+          }
+          episodeReturn = 0.0;
+          state = environment.InitialSample();
+        }
+        else
+        {
+          state = std::move(nextState);
+        }
+      }
+
+      Send(network, states, actions, rewards, nextStates, isTerminal);
+    }
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(replayMutex);
+    if (!error)
+      error = std::current_exception();
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+void ApeX<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::Send(NetworkType& network,
+        const std::vector<StateType>& states,
+        const std::vector<ActionType>& actions,
+        const std::vector<double>& rewards,
+        const std::vector<StateType>& nextStates,
+        const std::vector<bool>& isTerminal)
+{
+  // Evaluate all the transitions with one forward pass per matrix.
+  arma::mat encodedStates(states[0].Encode().n_elem, states.size());
+  arma::mat encodedNextStates(encodedStates.n_rows, states.size());
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    encodedStates.col(i) = states[i].Encode();
+    encodedNextStates.col(i) = nextStates[i].Encode();
+  }
+
+  arma::mat actionValues, nextActionValues;
+  network.Predict(encodedStates, actionValues);
+  network.Predict(encodedNextStates, nextActionValues);
+
+  // The initial priority of a transition is its absolute TD error; a small
+  // floor keeps the transitions that are already fitted in the sampling.
+  arma::vec priorities(states.size());
+  const arma::rowvec maxNextActionValues = arma::max(nextActionValues, 0);
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    const double target = rewards[i] + (isTerminal[i] ? 0.0 :
+        config.Discount() * maxNextActionValues(i));
+    priorities(i) = std::max(std::abs(target -
+        actionValues(actions[i].action, i)), 1e-6);
+  }
+
+  std::lock_guard<std::mutex> lock(replayMutex);
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    replayMethod.Store(states[i], actions[i], rewards[i], nextStates[i],
+        isTerminal[i], config.Discount(), priorities(i));
+  }
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -14,7 +14,8 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+#include <atomic>
+#include <thread>
 
 namespace mlpack {
 namespace rl {
@@ -68,22 +69,30 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
+  else
+    LinkParameters(learningNetwork);
   NetworkType targetNetwork = learningNetwork;
-  size_t totalSteps = 0;
+  LinkParameters(targetNetwork);
+  std::atomic<size_t> totalSteps(0);
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
-  // Set up worker pool, worker 0 will be deterministic for evaluation.
+  // Set up worker pool, worker 0 will be deterministic for evaluation.  The
+  // space is reserved so that the workers are never copied.
   std::vector<WorkerType> workers;
+  workers.reserve(config.NumWorkers() + 1);
   for (size_t i = 0; i <= config.NumWorkers(); ++i)
   {
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
+
+  // Each worker can only be stepped by one thread at a time; a thread claims
+  // a worker by setting its flag.
+  std::unique_ptr<std::atomic<bool>[]> busy(
+      new std::atomic<bool>[workers.size()]);
+  for (size_t i = 0; i < workers.size(); ++i)
+    busy[i] = false;
 
   /**
    * Compute the number of threads for the for-loop. In general, we should use
@@ -95,9 +104,15 @@ void AsyncLearning<
   numThreads++;
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
+  /**
+   * Each thread goes through its own share of the workers (the workers i,
+   * i + numThreads, ...), without any lock.  When the worker it wants is
+   * being stepped by another thread, it steals the next free one instead, so
+   * no thread waits while there is work left.
+   */
+  #pragma omp parallel for shared(stop, workers, busy, learningNetwork, \
       targetNetwork, totalSteps, policy)
-  for (omp_size_t i = 0; i < numThreads; ++i)
+  for (omp_size_t i = 0; i < (omp_size_t) numThreads; ++i)
   {
     #pragma omp critical
     {
@@ -106,27 +121,22 @@ void AsyncLearning<
             " started." << std::endl;
       #endif
     }
-    size_t task = std::numeric_limits<size_t>::max();
+
+    size_t task = i % workers.size();
+    size_t attempts = 0;
     while (!stop)
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
+      if (busy[task].exchange(true, std::memory_order_acquire))
       {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
-        {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
-
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
+        // This may happen when threads are more than workers.
+        task = (task + 1) % workers.size();
+        if (++attempts % workers.size() == 0)
+          std::this_thread::yield();
         continue;
+      }
+      attempts = 0;
 
-      // Get corresponding worker.
+      // Step the claimed worker; only worker 0 is evaluated.
       WorkerType& worker = workers[task];
       double episodeReturn;
       if (worker.Step(learningNetwork, targetNetwork, totalSteps,
@@ -134,6 +144,9 @@ void AsyncLearning<
       {
         stop = measure(episodeReturn);
       }
+      busy[task].store(false, std::memory_order_release);
+
+      task = (task + numThreads) % workers.size();
     }
   }
 
@@ -0,0 +1,132 @@
+/**
+ * @file methods/reinforcement_learning/categorical_projection.hpp
+ *
+ * The projection of the target distributions of categorical DQN (C51) onto
+ * the support atoms, and the gradient of the cross-entropy loss.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_CATEGORICAL_PROJECTION_HPP
+#define MLPACK_METHODS_RL_CATEGORICAL_PROJECTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Project the distributions of the returns of a batch of transitions onto the
+ * fixed support of categorical DQN: the atom z_j of the next state's
+ * distribution moves to r + discount * z_j (or to r, for a terminal
+ * transition), clamped to [vMin, vMax], and its probability is split between
+ * the two closest atoms in proportion to the distance.
+ *
+ * The positions of the moved atoms are computed for the whole batch at once;
+ * then the probabilities are scatter-added into each column in one pass over
+ * the batch (in parallel over the columns, for large batches).  A moved atom
+ * that lands exactly on an atom gives all its probability to that atom, so the
+ * projected distributions sum to one like the distributions of the next
+ * states.
+ *
+ * @param nextDist Distributions of the next states (one column per
+ *     transition, one row per atom).
+ * @param rewards Rewards of the transitions.
+ * @param isTerminal Whether each transition ends an episode.
+ * @param discount Discount of the returns.
+ * @param vMin Smallest atom of the support.
+ * @param vMax Largest atom of the support.
+ * @param projDist Matrix to store the projected distributions.
+ */
+inline void ProjectDistribution(const arma::mat& nextDist,
+                                const arma::rowvec& rewards,
+                                const arma::irowvec& isTerminal,
+                                const double discount,
+                                const double vMin,
+                                const double vMax,
+                                arma::mat& projDist)
+{
+  const size_t atomSize = nextDist.n_rows;
+  const size_t batchSize = nextDist.n_cols;
+  if (atomSize < 2)
+  {
+    throw std::invalid_argument("ProjectDistribution(): the support must "
+        "have at least 2 atoms!");
+  }
+
+  // The positions of the moved atoms, in units of atoms: b = (Tz - vMin) /
+  // deltaZ, where Tz = r + discount * z.  Since z = vMin + j * deltaZ, this is
+  // j * discount + (r + (discount - 1) * vMin) / deltaZ.
+  const double deltaZ = (vMax - vMin) / (atomSize - 1);
+  const arma::rowvec scales = discount *
+      arma::conv_to<arma::rowvec>::from(1 - isTerminal);
+  const arma::rowvec offsets = (rewards + (scales - 1) * vMin) / deltaZ;
+  arma::mat b = arma::linspace<arma::colvec>(0, atomSize - 1, atomSize) *
+      scales;
+  b.each_row() += offsets;
+  b.clamp(0, atomSize - 1);
+
+  projDist.zeros(atomSize, batchSize);
+  const double* positions = b.memptr();
+  const double* probabilities = nextDist.memptr();
+  #pragma omp parallel for if (batchSize * atomSize >= 100000)
+  for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
+  {
+    double* column = projDist.colptr(i);
+    for (size_t j = i * atomSize; j < (i + 1) * atomSize; ++j)
+    {
+      const size_t l = (size_t) positions[j];
+      const size_t u = std::min(l + 1, atomSize - 1);
+      const double upperWeight = positions[j] - l;
+      column[l] += probabilities[j] * (1 - upperWeight);
+      column[u] += probabilities[j] * upperWeight;
+    }
+  }
+}
+
+/**
+ * Compute the cross-entropy between the projected target distributions and
+ * the distributions the learning network predicts for the actions taken, and
+ * its gradient with respect to all the outputs of the network, in one pass.
+ * The gradient is zero for the atoms of the actions that were not taken.
+ *
+ * @param dists Output of the network: the distributions of each action,
+ *     stacked (one column per transition).
+ * @param actions Actions taken.
+ * @param projDist Projected target distributions (see ProjectDistribution()).
+ * @param gradients Matrix to store the gradient of the loss.
+ * @return The cross-entropy, summed over the batch.
+ */
+template<typename ActionType>
+double CategoricalCrossEntropy(const arma::mat& dists,
+                               const std::vector<ActionType>& actions,
+                               const arma::mat& projDist,
+                               arma::mat& gradients)
+{
+  const size_t atomSize = projDist.n_rows;
+  gradients.zeros(arma::size(dists));
+
+  double loss = 0.0;
+  for (size_t i = 0; i < projDist.n_cols; ++i)
+  {
+    const size_t offset = actions[i].action * atomSize;
+    const double* predicted = dists.colptr(i) + offset;
+    const double* target = projDist.colptr(i);
+    double* gradient = gradients.colptr(i) + offset;
+    for (size_t j = 0; j < atomSize; ++j)
+    {
+      const double p = 1e-10 + predicted[j];
+      loss -= target[j] * std::log(p);
+      gradient[j] = -target[j] / p;
+    }
+  }
+
+  return loss;
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -164,11 +164,9 @@ class Acrobot
     // Update the number of steps performed.
     stepsPerformed++;
 
-    // Make a vector to estimate nextstate.
-    arma::colvec currentState = {state.Theta1(), state.Theta2(),
-        state.AngularVelocity1(), state.AngularVelocity2()};
-
-    arma::colvec currentNextState = Rk4(currentState, Torque(action));
+    // Estimate the next state without temporary vectors.
+    double currentNextState[4];
+    Rk4(state.Encode().memptr(), Torque(action), currentNextState);
 
     nextState.Theta1() = Wrap(currentNextState[0], -M_PI, M_PI);
 
@@ -207,6 +205,71 @@ class Acrobot
     return Sample(state, action, nextState);
   }
 
+  /**
+   * Dynamics of the Acrobot System for a batch of states, which are advanced
+   * in place.  Each row of the matrix is a state, and each column holds one
+   * variable of State::Encode() for all the states; the RK4 integration of each
+   * state is done on local arrays, without temporary vectors.  The number of
+   * steps of the episode of each state is kept in steps (in place of
+   * StepsPerformed()), and the next states, rewards and terminal flags are the
+   * same as those of Sample() and IsTerminal() on each state (the noise of the
+   * torques is drawn in the order of the states).
+   *
+   * @param states The current states (one per row), replaced by the next
+   *     states.
+   * @param actions The action of each state.
+   * @param steps The number of steps performed in the episode of each state;
+   *     each is incremented.
+   * @param rewards Will contain the reward of each state.
+   * @param isTerminal Will contain whether each next state is terminal.
+   */
+  void SampleBatch(arma::mat& states,
+                   const std::vector<Action>& actions,
+                   arma::Row<size_t>& steps,
+                   arma::rowvec& rewards,
+                   arma::irowvec& isTerminal) const
+  {
+    rewards.set_size(states.n_rows);
+    isTerminal.set_size(states.n_rows);
+    double* theta1 = states.colptr(0);
+    double* theta2 = states.colptr(1);
+    double* angularVelocity1 = states.colptr(2);
+    double* angularVelocity2 = states.colptr(3);
+    for (size_t i = 0; i < states.n_rows; ++i)
+    {
+      ++steps[i];
+
+      const double currentState[4] = { theta1[i], theta2[i],
+          angularVelocity1[i], angularVelocity2[i] };
+      double currentNextState[4];
+      Rk4(currentState, Torque(actions[i]), currentNextState);
+
+      theta1[i] = Wrap(currentNextState[0], -M_PI, M_PI);
+      theta2[i] = Wrap(currentNextState[1], -M_PI, M_PI);
+      angularVelocity1[i] = math::ClampRange(currentNextState[2], -maxVel1,
+          maxVel1);
+      angularVelocity2[i] = math::ClampRange(currentNextState[3], -maxVel2,
+          maxVel2);
+
+      // Do not reward the agent if time ran out.
+      if (maxSteps != 0 && steps[i] >= maxSteps)
+      {
+        isTerminal[i] = 1;
+        rewards[i] = 0;
+      }
+      else if (-std::cos(theta1[i]) - std::cos(theta1[i] + theta2[i]) > 1.0)
+      {
+        isTerminal[i] = 1;
+        rewards[i] = doneReward;
+      }
+      else
+      {
+        isTerminal[i] = 0;
+        rewards[i] = -1;
+      }
+    }
+  }
+
   /**
    * This function does random initialization of state space.
    */
@@ -247,6 +310,21 @@ class Acrobot
    * @param torque The torque Applied.
    */
   arma::colvec Dsdt(arma::colvec state, const double torque) const
+  {
+    arma::colvec values(4);
+    Dsdt(state.memptr(), torque, values.memptr());
+    return values;
+  };
+
+  /**
+   * Compute the derivatives of the given state into the given array, without
+   * allocating.
+   *
+   * @param state Current state (4 elements).
+   * @param torque The torque applied.
+   * @param values Will contain the derivatives (4 elements).
+   */
+  void Dsdt(const double* state, const double torque, double* values) const
   {
     const double m1 = linkMass1;
     const double m2 = linkMass2;
@@ -260,7 +338,6 @@ class Acrobot
     const double theta1 = state[0];
     const double theta2 = state[1];
 
-    arma::colvec values(4);
     values[0] = state[2];
     values[1] = state[3];
 
@@ -282,8 +359,6 @@ class Acrobot
         std::pow(d2, 2) / d1);
 
     values[2] = -(d2 * values[3] + phi1) / d1;
-
-    return values;
   };
 
   /**
@@ -334,15 +409,39 @@ class Acrobot
    */
   arma::colvec Rk4(const arma::colvec state, const double torque) const
   {
-    arma::colvec k1 = Dsdt(state, torque);
-    arma::colvec k2 = Dsdt(state + dt * k1 / 2, torque);
-    arma::colvec k3 = Dsdt(state + dt * k2 / 2, torque);
-    arma::colvec k4 = Dsdt(state + dt * k3, torque);
-    arma::colvec nextState = state + dt * (k1 + 2 * k2 + 2 * k3 + k4) / 6;
-
+    arma::colvec nextState(4);
+    Rk4(state.memptr(), torque, nextState.memptr());
     return nextState;
   };
 
+  /**
+   * Estimate the next state with the RK4 method into the given array, using
+   * only local arrays.
+   *
+   * @param state The current state (4 elements).
+   * @param torque The torque applied.
+   * @param nextState Will contain the next state (4 elements).
+   */
+  void Rk4(const double* state, const double torque, double* nextState) const
+  {
+    double k1[4], k2[4], k3[4], k4[4], y[4];
+    Dsdt(state, torque, k1);
+    for (size_t j = 0; j < 4; ++j)
+      y[j] = state[j] + dt * k1[j] / 2;
+    Dsdt(y, torque, k2);
+    for (size_t j = 0; j < 4; ++j)
+      y[j] = state[j] + dt * k2[j] / 2;
+    Dsdt(y, torque, k3);
+    for (size_t j = 0; j < 4; ++j)
+      y[j] = state[j] + dt * k3[j];
+    Dsdt(y, torque, k4);
+    for (size_t j = 0; j < 4; ++j)
+    {
+      nextState[j] = state[j] + dt * (k1[j] + 2 * k2[j] + 2 * k3[j] + k4[j]) /
+          6;
+    }
+  };
+
   //! Get the number of steps performed.
   size_t StepsPerformed() const { return stepsPerformed; }
 
@@ -163,12 +163,15 @@ class DoublePoleCart
     // Update the number of steps performed.
     stepsPerformed++;
 
-    arma::vec dydx(6, arma::fill::zeros);
-    dydx[0] = state.Velocity();
-    dydx[2] = state.AngularVelocity(1);
-    dydx[4] = state.AngularVelocity(2);
-    Dsdt(state, action, dydx);
-    RK4(state, action, dydx, nextState);
+    // Integrate on local arrays, without temporary vectors.
+    const double* y = state.Encode().memptr();
+    double dydx[6];
+    dydx[0] = y[1];
+    dydx[2] = y[3];
+    dydx[4] = y[5];
+    Dsdt(y, action, dydx);
+    nextState.Data().set_size(State::dimension);
+    RK4(y, action, dydx, nextState.Data().memptr());
 
     // Check if the episode has terminated.
     bool done = IsTerminal(nextState);
@@ -197,21 +200,34 @@ class DoublePoleCart
   void Dsdt(const State& state,
             const Action& action,
             arma::vec& dydx)
+  {
+    Dsdt(state.Encode().memptr(), action, dydx.memptr());
+  }
+
+  /**
+   * Compute the accelerations of the given state into the given array (the
+   * elements 1, 3 and 5), without allocating.
+   *
+   * @param state The current state (6 elements).
+   * @param action The action taken.
+   * @param dydx The differential (6 elements).
+   */
+  void Dsdt(const double* state, const Action& action, double* dydx) const
   {
     double totalForce = action.action ? forceMag : -forceMag;
     double totalMass = massCart;
-    double omega1 = state.AngularVelocity(1);
-    double omega2 = state.AngularVelocity(2);
-    double sinTheta1 = std::sin(state.Angle(1));
-    double sinTheta2 = std::sin(state.Angle(2));
-    double cosTheta1 = std::cos(state.Angle(1));
-    double cosTheta2 = std::cos(state.Angle(2));
+    double omega1 = state[3];
+    double omega2 = state[5];
+    double sinTheta1 = std::sin(state[2]);
+    double sinTheta2 = std::sin(state[4]);
+    double cosTheta1 = std::cos(state[2]);
+    double cosTheta2 = std::cos(state[4]);
 
     // Calculate total effective force.
     totalForce += m1 * l1 * omega1 * omega1 * sinTheta1 + 0.375 * m1 * gravity *
-        std::sin(2 * state.Angle(1));
+        std::sin(2 * state[2]);
     totalForce += m2 * l2 * omega2 * omega2 * sinTheta1 + 0.375 * m2 * gravity *
-        std::sin(2 * state.Angle(2));
+        std::sin(2 * state[4]);
 
     // Calculate total effective mass.
     totalMass += m1 * (0.25 + 0.75 * sinTheta1 * sinTheta1);
@@ -239,32 +255,55 @@ class DoublePoleCart
            const Action& action,
            arma::vec& dydx,
            State& nextState)
+  {
+    nextState.Data().set_size(State::dimension);
+    RK4(state.Encode().memptr(), action, dydx.memptr(),
+        nextState.Data().memptr());
+  }
+
+  /**
+   * Estimate the next state with the RK4 method into the given array, using
+   * only local arrays.
+   *
+   * @param state The current state (6 elements).
+   * @param action The action to be applied.
+   * @param dydx The differential at the current state (6 elements).
+   * @param nextState Will contain the next state (6 elements).
+   */
+  void RK4(const double* state,
+           const Action& action,
+           const double* dydx,
+           double* nextState) const
   {
     const double hh = tau * 0.5;
     const double h6 = tau / 6;
-    arma::vec yt(6);
-    arma::vec dyt(6);
-    arma::vec dym(6);
+    double yt[6], dyt[6], dym[6];
 
-    yt = state.Data() + (hh * dydx);
-    Dsdt(State(yt), action, dyt);
+    for (size_t j = 0; j < 6; ++j)
+      yt[j] = state[j] + hh * dydx[j];
+    Dsdt(yt, action, dyt);
     dyt[0] = yt[1];
     dyt[2] = yt[3];
     dyt[4] = yt[5];
-    yt = state.Data() + (hh * dyt);
+    for (size_t j = 0; j < 6; ++j)
+      yt[j] = state[j] + hh * dyt[j];
 
-    Dsdt(State(yt), action, dym);
+    Dsdt(yt, action, dym);
     dym[0] = yt[1];
     dym[2] = yt[3];
     dym[4] = yt[5];
-    yt = state.Data() + (tau * dym);
-    dym += dyt;
+    for (size_t j = 0; j < 6; ++j)
+    {
+      yt[j] = state[j] + tau * dym[j];
+      dym[j] += dyt[j];
+    }
 
-    Dsdt(State(yt), action, dyt);
+    Dsdt(yt, action, dyt);
     dyt[0] = yt[1];
     dyt[2] = yt[3];
     dyt[4] = yt[5];
-    nextState.Data() = state.Data() + h6 * (dydx + dyt + 2 * dym);
+    for (size_t j = 0; j < 6; ++j)
+      nextState[j] = state[j] + h6 * (dydx[j] + dyt[j] + 2 * dym[j]);
   }
 
   /**
@@ -281,6 +320,67 @@ class DoublePoleCart
     return Sample(state, action, nextState);
   }
 
+  /**
+   * Dynamics of Double Pole Cart for a batch of states, which are advanced in
+   * place.  Each row of the matrix is a state, and each column holds one
+   * variable of State::Encode() for all the states; the RK4 integration of each
+   * state is done on local arrays, without temporary vectors.  The number of
+   * steps of the episode of each state is kept in steps (in place of
+   * StepsPerformed()), and the next states, rewards and terminal flags are the
+   * same as those of Sample() and IsTerminal() on each state.
+   *
+   * @param states The current states (one per row), replaced by the next
+   *     states.
+   * @param actions The action of each state.
+   * @param steps The number of steps performed in the episode of each state;
+   *     each is incremented.
+   * @param rewards Will contain the reward of each state.
+   * @param isTerminal Will contain whether each next state is terminal.
+   */
+  void SampleBatch(arma::mat& states,
+                   const std::vector<Action>& actions,
+                   arma::Row<size_t>& steps,
+                   arma::rowvec& rewards,
+                   arma::irowvec& isTerminal) const
+  {
+    rewards.set_size(states.n_rows);
+    isTerminal.set_size(states.n_rows);
+    for (size_t i = 0; i < states.n_rows; ++i)
+    {
+      ++steps[i];
+
+      double y[6], dydx[6], next[6];
+      for (size_t j = 0; j < 6; ++j)
+        y[j] = states.at(i, j);
+      dydx[0] = y[1];
+      dydx[2] = y[3];
+      dydx[4] = y[5];
+      Dsdt(y, actions[i], dydx);
+      RK4(y, actions[i], dydx, next);
+      for (size_t j = 0; j < 6; ++j)
+        states.at(i, j) = next[j];
+
+      // Do not reward the agent if it failed.
+      if (maxSteps != 0 && steps[i] >= maxSteps)
+      {
+        isTerminal[i] = 1;
+        rewards[i] = doneReward;
+      }
+      else if (std::abs(next[0]) > xThreshold ||
+          std::abs(next[2]) > thetaThresholdRadians ||
+          std::abs(next[4]) > thetaThresholdRadians)
+      {
+        isTerminal[i] = 1;
+        rewards[i] = 0;
+      }
+      else
+      {
+        isTerminal[i] = 0;
+        rewards[i] = 1.0;
+      }
+    }
+  }
+
   /**
    * Initial state representation is randomly generated within [-0.05, 0.05].
    *
@@ -178,6 +178,64 @@ class MountainCar
     return Sample(state, action, nextState);
   }
 
+  /**
+   * Dynamics of Mountain Car for a batch of states, which are advanced in
+   * place.  The states are stored by variable: each row of the matrix is a
+   * state, and each column holds one variable of State::Encode() for all the
+   * states, so the update is a single loop over contiguous arrays.  The number
+   * of steps of the episode of each state is kept in steps (in place of
+   * StepsPerformed()), and the next states, rewards and terminal flags are the
+   * same as those of Sample() and IsTerminal() on each state.
+   *
+   * @param states The current states (one per row), replaced by the next
+   *     states.
+   * @param actions The action of each state.
+   * @param steps The number of steps performed in the episode of each state;
+   *     each is incremented.
+   * @param rewards Will contain the reward of each state.
+   * @param isTerminal Will contain whether each next state is terminal.
+   */
+  void SampleBatch(arma::mat& states,
+                   const std::vector<Action>& actions,
+                   arma::Row<size_t>& steps,
+                   arma::rowvec& rewards,
+                   arma::irowvec& isTerminal) const
+  {
+    rewards.set_size(states.n_rows);
+    isTerminal.set_size(states.n_rows);
+    double* velocity = states.colptr(0);
+    double* position = states.colptr(1);
+    for (size_t i = 0; i < states.n_rows; ++i)
+    {
+      ++steps[i];
+
+      const int direction = actions[i].action - 1;
+      velocity[i] = math::ClampRange(velocity[i] + 0.001 * direction - 0.0025 *
+          std::cos(3 * position[i]), velocityMin, velocityMax);
+      position[i] = math::ClampRange(position[i] + velocity[i], positionMin,
+          positionMax);
+      if (position[i] == positionMin && velocity[i] < 0)
+        velocity[i] = 0.0;
+
+      // Do not reward the agent if time ran out.
+      if (maxSteps != 0 && steps[i] >= maxSteps)
+      {
+        isTerminal[i] = 1;
+        rewards[i] = 0;
+      }
+      else if (position[i] >= positionGoal)
+      {
+        isTerminal[i] = 1;
+        rewards[i] = doneReward;
+      }
+      else
+      {
+        isTerminal[i] = 0;
+        rewards[i] = -1;
+      }
+    }
+  }
+
   /**
    * Initial position is randomly generated within [-0.6, -0.4].
    * Initial velocity is 0.
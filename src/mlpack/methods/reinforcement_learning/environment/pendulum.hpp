@@ -45,12 +45,15 @@ class Pendulum
     { /* Nothing to do here. */ }
 
     /**
-     * Construct a state based on the given data.
+     * Construct a state based on the given data.  Theta is recovered from its
+     * sine and cosine, in the range [-pi, pi].
      *
-     * @param data Data for the cos(theta), sin(theta) and
+     * @param data Data for the sin(theta), cos(theta) and
      *             angular velocity.
      */
-    State(const arma::colvec& data): theta(0), data(data)
+    State(const arma::colvec& data) :
+        theta(std::atan2(data[0], data[1])),
+        data(data)
     { /* Nothing to do here. */ }
 
     //! Modify the internal representation of the state.
@@ -67,7 +70,7 @@ class Pendulum
     double& AngularVelocity() { return data[2]; }
 
     //! Encode the state to a column vector.
-    const arma::colvec& Encode() { return data; }
+    const arma::colvec& Encode() const { return data; }
 
     //! Updates the theta transformations in data.
     void SetState()
@@ -188,6 +191,64 @@ class Pendulum
     return Sample(state, action, nextState);
   }
 
+  /**
+   * Dynamics of Pendulum for a batch of states, which are advanced in place.
+   * Each row of the matrix is a state, and each column holds one variable of
+   * State::Encode() (sin(theta), cos(theta) and the angular velocity) for all
+   * the states; theta is recovered from its sine and cosine.  The number of
+   * steps of the episode of each state is kept in steps (in place of
+   * StepsPerformed()), and the next states, rewards and terminal flags are the
+   * same as those of Sample() and IsTerminal() on each state.
+   *
+   * @param states The current states (one per row), replaced by the next
+   *     states.
+   * @param actions The action of each state.
+   * @param steps The number of steps performed in the episode of each state;
+   *     each is incremented.
+   * @param rewards Will contain the reward of each state.
+   * @param isTerminal Will contain whether each next state is terminal.
+   */
+  void SampleBatch(arma::mat& states,
+                   const std::vector<Action>& actions,
+                   arma::Row<size_t>& steps,
+                   arma::rowvec& rewards,
+                   arma::irowvec& isTerminal) const
+  {
+    // Define constants which specify our pendulum.
+    const double gravity = 10.0;
+    const double mass = 1.0;
+    const double length = 1.0;
+
+    rewards.set_size(states.n_rows);
+    isTerminal.set_size(states.n_rows);
+    double* sinTheta = states.colptr(0);
+    double* cosTheta = states.colptr(1);
+    double* angularVelocity = states.colptr(2);
+    for (size_t i = 0; i < states.n_rows; ++i)
+    {
+      ++steps[i];
+
+      const double theta = std::atan2(sinTheta[i], cosTheta[i]);
+      const double torque = math::ClampRange(actions[i].action[0], -maxTorque,
+          maxTorque);
+
+      // The reward is the negative of the cost of the action.
+      rewards[i] = -(std::pow(AngleNormalize(theta), 2) + 0.1 *
+          std::pow(angularVelocity[i], 2) + 0.001 * std::pow(torque, 2));
+
+      const double newAngularVelocity = angularVelocity[i] + (-3.0 * gravity /
+          (2 * length) * std::sin(theta + M_PI) + 3.0 / (mass *
+          std::pow(length, 2)) * torque) * dt;
+      const double newTheta = theta + newAngularVelocity * dt;
+      sinTheta[i] = std::sin(newTheta);
+      cosTheta[i] = std::cos(newTheta);
+      angularVelocity[i] = math::ClampRange(newAngularVelocity,
+          -maxAngularVelocity, maxAngularVelocity);
+
+      isTerminal[i] = (maxSteps != 0 && steps[i] >= maxSteps) ? 1 : 0;
+    }
+  }
+
   /**
    * Initial theta is randomly generated within [-pi, pi].
    * Initial angular velocity is randomly generated within [-1, 1].
@@ -0,0 +1,264 @@
+/**
+ * @file methods/reinforcement_learning/environment/vector_environment.hpp
+ *
+ * A wrapper that steps several copies of an RL environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace rl {
+
+// This gives us a HasSampleBatchCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when an environment can advance a
+// batch of states.
+HAS_EXACT_METHOD_FORM(SampleBatch, HasSampleBatchCheck);
+
+/**
+ * HasSampleBatch<EnvironmentType>::value is true if the environment has a
+ * SampleBatch() method, which advances a batch of states stored by variable.
+ */
+template<typename EnvironmentType>
+struct HasSampleBatch
+{
+  template<typename C>
+  using SampleBatchForm = void(C::*)(arma::mat&,
+                                     const std::vector<typename C::Action>&,
+                                     arma::Row<size_t>&,
+                                     arma::rowvec&,
+                                     arma::irowvec&) const;
+
+  static const bool value =
+      HasSampleBatchCheck<EnvironmentType, SampleBatchForm>::value;
+};
+
+/**
+ * The VectorEnvironment holds several copies of an environment (such as
+ * CartPole, Acrobot or Pendulum) and advances all of them by one step at a
+ * time, so that an agent can select the actions of all the copies with a single
+ * batched forward pass of its network (see QLearning::VectorStep() and
+ * SAC::VectorStep()).
+ *
+ * A copy whose episode ends is restarted from a new initial state right away,
+ * and the return of the finished episode is made available through
+ * FinishedReturns() until the next step.
+ *
+ * If the environment has a SampleBatch() method (as MountainCar,
+ * ContinuousMountainCar, Pendulum, DoublePoleCart and Acrobot do), all the
+ * copies are advanced by a single call on a matrix that holds each state
+ * variable of all the copies contiguously, with the parameters of the first
+ * copy; the steps of the episodes are then counted here, in place of the
+ * StepsPerformed() of the copies.  Other environments are advanced one copy
+ * after the other with Sample().
+ *
+ * @code
+ * VectorEnvironment<CartPole> environments(8, CartPole(200));
+ * for (size_t step = 0; step < 1000; ++step)
+ * {
+ *   agent.VectorStep(environments);
+ *   for (double episodeReturn : environments.FinishedReturns())
+ *     std::cout << episodeReturn << std::endl;
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType The type of the environment that is copied.
+ */
+template<typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment, and start an
+   * episode in each of them.
+   *
+   * @param size The number of copies of the environment.
+   * @param environment The environment to copy.
+   */
+  VectorEnvironment(const size_t size,
+                    const EnvironmentType& environment = EnvironmentType()) :
+      environments(size, environment)
+  {
+    if (size == 0)
+    {
+      throw std::invalid_argument("VectorEnvironment::VectorEnvironment(): "
+          "the number of environments must be positive!");
+    }
+
+    Reset();
+  }
+
+  /**
+   * Start a new episode in each copy of the environment.
+   */
+  void Reset()
+  {
+    states.resize(environments.size());
+    episodeReturns.zeros(environments.size());
+    steps.zeros(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+      states[i] = environments[i].InitialSample();
+    finishedReturns.clear();
+  }
+
+  /**
+   * Return the current states of all the copies, encoded as the columns of a
+   * matrix.
+   */
+  arma::mat Encode() const
+  {
+    arma::mat encoded(states[0].Encode().n_elem, states.size());
+    for (size_t i = 0; i < states.size(); ++i)
+      encoded.col(i) = states[i].Encode();
+    return encoded;
+  }
+
+  /**
+   * Apply the given action to each copy of the environment.  The copies whose
+   * episode ends are restarted, so States() holds the states the next actions
+   * apply to, while nextStates holds the states the given actions led to.
+   *
+   * @param actions The action of each copy.
+   * @param nextStates The states reached by each copy.
+   * @param rewards The reward received by each copy.
+   * @param isTerminal Whether each reached state is terminal.
+   */
+  void Step(const std::vector<ActionType>& actions,
+            std::vector<StateType>& nextStates,
+            arma::rowvec& rewards,
+            arma::irowvec& isTerminal)
+  {
+    if (actions.size() != environments.size())
+    {
+      std::ostringstream oss;
+      oss << "VectorEnvironment::Step(): " << actions.size() << " actions "
+          << "given for " << environments.size() << " environments!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    nextStates.resize(environments.size());
+    rewards.set_size(environments.size());
+    isTerminal.set_size(environments.size());
+    finishedReturns.clear();
+
+    Sample(actions, nextStates, rewards, isTerminal);
+
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      episodeReturns[i] += rewards[i];
+
+      if (isTerminal[i])
+      {
+        finishedReturns.push_back(episodeReturns[i]);
+        episodeReturns[i] = 0.0;
+        steps[i] = 0;
+        states[i] = environments[i].InitialSample();
+      }
+      else
+      {
+        states[i] = nextStates[i];
+      }
+    }
+  }
+
+  //! Get the number of copies of the environment.
+  size_t Size() const { return environments.size(); }
+
+  //! Get the current state of each copy.
+  const std::vector<StateType>& States() const { return states; }
+  //! Modify the current state of each copy.
+  std::vector<StateType>& States() { return states; }
+
+  //! Get the copies of the environment.
+  const std::vector<EnvironmentType>& Environments() const
+  { return environments; }
+  //! Modify the copies of the environment.
+  std::vector<EnvironmentType>& Environments() { return environments; }
+
+  //! Get the returns of the episodes that ended at the last step.
+  const std::vector<double>& FinishedReturns() const { return finishedReturns; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! The current state of each copy.
+  std::vector<StateType> states;
+
+  //! The return of the current episode of each copy.
+  arma::vec episodeReturns;
+
+  //! The returns of the episodes that ended at the last step.
+  std::vector<double> finishedReturns;
+
+  //! The number of steps of the current episode of each copy (only used by
+  //! SampleBatch()).
+  arma::Row<size_t> steps;
+
+  //! The states of all the copies, one per row (only used by SampleBatch()).
+  arma::mat batchStates;
+
+  /**
+   * Advance all the copies with a single call to SampleBatch().
+   */
+  template<typename T = EnvironmentType>
+  void Sample(const std::vector<ActionType>& actions,
+              std::vector<StateType>& nextStates,
+              arma::rowvec& rewards,
+              arma::irowvec& isTerminal,
+              const typename std::enable_if<HasSampleBatch<T>::value>::type*
+                  = 0)
+  {
+    // Gather the states by variable; the matrix is only allocated once.
+    batchStates.set_size(states.size(), StateType::dimension);
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+      const arma::colvec& encoded = states[i].Encode();
+      for (size_t j = 0; j < StateType::dimension; ++j)
+        batchStates(i, j) = encoded[j];
+    }
+
+    environments[0].SampleBatch(batchStates, actions, steps, rewards,
+        isTerminal);
+
+    for (size_t i = 0; i < states.size(); ++i)
+      nextStates[i] = StateType(arma::colvec(batchStates.row(i).t()));
+  }
+
+  /**
+   * Advance the copies one after the other with Sample().
+   */
+  template<typename T = EnvironmentType>
+  void Sample(const std::vector<ActionType>& actions,
+              std::vector<StateType>& nextStates,
+              arma::rowvec& rewards,
+              arma::irowvec& isTerminal,
+              const typename std::enable_if<!HasSampleBatch<T>::value>::type*
+                  = 0)
+  {
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      rewards[i] = environments[i].Sample(states[i], actions[i],
+          nextStates[i]);
+      isTerminal[i] = environments[i].IsTerminal(nextStates[i]);
+    }
+  }
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -17,6 +17,9 @@
 
 #include "replay/random_replay.hpp"
 #include "replay/prioritized_replay.hpp"
+#include "environment/vector_environment.hpp"
+#include "target_update.hpp"
+#include "categorical_projection.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -110,6 +113,24 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Advance all the copies of the given vectorized environment by one step.
+   * The actions of all the copies are selected with a single forward pass of
+   * the learning network, the transitions are all stored in the replay
+   * memory, and the agent is then trained once (after the exploration steps),
+   * so each call counts as environments.Size() steps.  The returns of the
+   * episodes that ended are given by environments.FinishedReturns().
+   *
+   * The replay method must use single step transitions, since the
+   * transitions of the copies are interleaved.  Since the target network is
+   * synchronized when the total number of steps is a multiple of
+   * TargetNetworkSyncInterval(), that interval should be a multiple of
+   * environments.Size().
+   *
+   * @param environments The copies of the environment to advance.
+   */
+  void VectorStep(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -146,6 +167,13 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Update the target network with the learning network, either by copying
+   * the parameters or, if config.SoftTargetUpdate() is set, by moving them
+   * towards the learning network by config.Rho().  Both work in place.
+   */
+  void UpdateTargetNetwork();
+
   //! Locally-stored hyper-parameters.
   TrainingConfig& config;
 
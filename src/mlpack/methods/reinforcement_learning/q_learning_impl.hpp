@@ -115,6 +115,32 @@ arma::Col<size_t> QLearning<
   return bestActions;
 };
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::UpdateTargetNetwork()
+{
+  if (config.SoftTargetUpdate())
+  {
+    SoftTargetUpdate(targetNetwork.Parameters(), learningNetwork.Parameters(),
+        config.Rho());
+  }
+  else
+  {
+    HardTargetUpdate(targetNetwork.Parameters(), learningNetwork.Parameters());
+  }
+}
+
 template <
   typename EnvironmentType,
   typename NetworkType,
@@ -196,7 +222,7 @@ void QLearning<
   }
   // Update target network.
   if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    targetNetwork.Parameters() = learningNetwork.Parameters();
+    UpdateTargetNetwork();
 
   if (totalSteps > config.ExplorationSteps())
     policy.Anneal();
@@ -230,9 +256,6 @@ void QLearning<
       sampledNextStates, isTerminal);
 
   size_t atomSize = config.AtomSize();
-  arma::colvec support = arma::linspace<arma::colvec>(config.VMin(),
-      config.VMax(), atomSize);
-
   size_t batchSize = sampledNextStates.n_cols;
 
   // Compute action value for next state with target network.
@@ -260,35 +283,16 @@ void QLearning<
         arma::size(atomSize, 1));
   }
 
-  arma::mat tZ = (arma::conv_to<arma::mat>::from(config.Discount() *
-      (support * (1 - isTerminal))).each_row() + sampledRewards);
-  tZ = arma::clamp(tZ, config.VMin(), config.VMax());
-  arma::mat b = (tZ - config.VMin()) / (config.VMax() - config.VMin()) *
-      (atomSize - 1);
-  arma::mat l = arma::floor(b);
-  arma::mat u = arma::ceil(b);
-
-  arma::mat projDistUpper = nextDist % (u - b);
-  arma::mat projDistLower = nextDist % (b - l);
+  // Project the target distributions onto the support, and compute the
+  // gradient of the cross-entropy with the predicted distributions.
+  arma::mat projDist;
+  ProjectDistribution(nextDist, sampledRewards, isTerminal, config.Discount(),
+      config.VMin(), config.VMax(), projDist);
 
-  arma::mat projDist = arma::zeros<arma::mat>(arma::size(nextDist));
-  for (size_t batchNo = 0; batchNo < batchSize; batchNo++)
-  {
-    for (size_t j = 0; j < atomSize; j++)
-    {
-      projDist(l(j, batchNo), batchNo) += projDistUpper(j, batchNo);
-      projDist(u(j, batchNo), batchNo) += projDistLower(j, batchNo);
-    }
-  }
-  arma::mat dists;
+  arma::mat dists, lossGradients;
   learningNetwork.Forward(sampledStates, dists);
-  arma::mat lossGradients = arma::zeros<arma::mat>(arma::size(dists));
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    lossGradients(sampledActions[i].action * atomSize, i,
-        arma::size(atomSize, 1)) = -(projDist.col(i) / (1e-10 + dists(
-        sampledActions[i].action * atomSize, i, arma::size(atomSize, 1))));
-  }
+  CategoricalCrossEntropy(dists, sampledActions, projDist, lossGradients);
+
   // Learn from experience.
   arma::mat gradients;
   learningNetwork.Backward(sampledStates, lossGradients, gradients);
@@ -307,7 +311,7 @@ void QLearning<
   }
   // Update target network.
   if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    targetNetwork.Parameters() = learningNetwork.Parameters();
+    UpdateTargetNetwork();
 
   if (totalSteps > config.ExplorationSteps())
     policy.Anneal();
@@ -385,6 +389,63 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::VectorStep(VectorEnvironment<EnvironmentType>& environments)
+{
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("QLearning::VectorStep(): the replay method "
+        "must use single step transitions!");
+  }
+
+  // Get the action values of all the current states at once.
+  arma::mat actionValues;
+  learningNetwork.Predict(environments.Encode(), actionValues);
+
+  std::vector<ActionType> actions(environments.Size());
+  for (size_t i = 0; i < environments.Size(); ++i)
+  {
+    actions[i] = policy.Sample(actionValues.col(i), deterministic,
+        config.NoisyQLearning());
+  }
+  action = actions.back();
+
+  // The states are replaced by the next ones (or by new initial states).
+  const std::vector<StateType> states = environments.States();
+  std::vector<StateType> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+  environments.Step(actions, nextStates, rewards, isTerminal);
+
+  for (size_t i = 0; i < environments.Size(); ++i)
+  {
+    replayMethod.Store(states[i], actions[i], rewards[i], nextStates[i],
+        isTerminal[i], config.Discount());
+  }
+
+  state = environments.States().back();
+  totalSteps += environments.Size();
+
+  if (deterministic || totalSteps < config.ExplorationSteps())
+    return;
+  if (config.IsCategorical())
+    TrainCategoricalAgent();
+  else
+    TrainAgent();
+}
+
 } // namespace rl
 } // namespace mlpack
 
@@ -0,0 +1,320 @@
+/**
+ * @file methods/reinforcement_learning/replay/frame_replay.hpp
+ *
+ * This file is an implementation of random experience replay that stores
+ * each frame only once, in a circular buffer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_FRAME_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_FRAME_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of random experience replay with compact storage.
+ *
+ * RandomReplay stores the state and the next state of each transition, so
+ * each observation is stored twice.  FrameReplay instead stores the frames of
+ * the episodes one after the other in a circular buffer: the next state of a
+ * transition is the frame that follows its state, so it is stored once, and
+ * it is reconstructed by index when the transitions are sampled.  Only the
+ * first state of each episode costs an extra frame.
+ *
+ * Frames may be stored with a smaller element type, such as float, or
+ * unsigned char for environments whose states are pixel intensities in
+ * [0, 255]; they are converted back to double when they are sampled.
+ *
+ * States made of the last historyLength frames stacked together (the oldest
+ * frame first, as for Atari games) are supported without storing the stacks:
+ * each step only stores the newest frame of the next state, and the stacks
+ * are rebuilt from the consecutive frames of the buffer.
+ *
+ * The transitions must be stored in the order they happen, one episode after
+ * the other: the state given to Store() must be the next state of the
+ * previous call, unless that one was terminal.  The transitions are
+ * single-step (NSteps() is 1).
+ *
+ * @tparam EnvironmentType Desired task.
+ * @tparam ElemType The type of the elements of the stored frames.
+ */
+template <typename EnvironmentType, typename ElemType = double>
+class FrameReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  FrameReplay():
+      batchSize(0),
+      capacity(0),
+      historyLength(1),
+      frameDimension(0),
+      position(0),
+      full(false),
+      open(false),
+      size(0),
+      nSteps(1)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Construct an instance of the compact experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of frames.
+   * @param historyLength Number of frames stacked in each state.
+   * @param dimension The dimension of an encoded state (the frames stacked
+   *     together).
+   */
+  FrameReplay(const size_t batchSize,
+              const size_t capacity,
+              const size_t historyLength = 1,
+              const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      historyLength(historyLength),
+      frameDimension(historyLength == 0 ? 0 : dimension / historyLength),
+      position(0),
+      full(false),
+      open(false),
+      size(0),
+      nSteps(1),
+      frames(frameDimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      isTerminal(capacity),
+      valid(capacity, 0)
+  {
+    if (historyLength == 0 || dimension % historyLength != 0)
+    {
+      std::ostringstream oss;
+      oss << "FrameReplay::FrameReplay(): the dimension of the states ("
+          << dimension << ") must be a multiple of the history length ("
+          << historyLength << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (capacity <= historyLength)
+    {
+      throw std::invalid_argument("FrameReplay::FrameReplay(): the capacity "
+          "must be larger than the history length!");
+    }
+  }
+
+  /**
+   * Store the given experience.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   * @param * (discount) The discount parameter (unused, the transitions are
+   *     single-step).
+   */
+  void Store(const StateType& state,
+             const ActionType& action,
+             const double reward,
+             const StateType& nextState,
+             const bool isEnd,
+             const double& /* discount */)
+  {
+    // The first state of an episode brings its whole history.
+    if (!open)
+    {
+      for (size_t j = 0; j < historyLength; ++j)
+        WriteFrame(state.Encode(), j);
+    }
+
+    // The newest frame of the state is the last one written.
+    const size_t index = (position + capacity - 1) % capacity;
+    WriteFrame(nextState.Encode(), historyLength - 1);
+
+    actions[index] = action;
+    rewards(index) = reward;
+    isTerminal(index) = isEnd;
+    valid[index] = 1;
+    ++size;
+
+    // After a terminal state, the next episode starts with a new history.
+    open = !isEnd;
+  }
+
+  /**
+   * Sample some experiences.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              std::vector<ActionType>& sampledActions,
+              arma::rowvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::irowvec& isTerminal)
+  {
+    if (size == 0)
+    {
+      throw std::logic_error("FrameReplay::Sample(): no transition has been "
+          "stored!");
+    }
+
+    const size_t upperBound = full ? capacity : position;
+    sampledStates.set_size(frameDimension * historyLength, batchSize);
+    sampledNextStates.set_size(frameDimension * historyLength, batchSize);
+    sampledRewards.set_size(batchSize);
+    isTerminal.set_size(batchSize);
+    sampledActions.clear();
+    for (size_t t = 0; t < batchSize; ++t)
+    {
+      // Most of the slots hold a transition, so this ends quickly.
+      size_t index;
+      do
+      {
+        index = math::RandInt(upperBound);
+      } while (!valid[index]);
+
+      Decode(index, sampledStates.col(t));
+      Decode((index + 1) % capacity, sampledNextStates.col(t));
+      sampledActions.push_back(actions[index]);
+      sampledRewards(t) = rewards(index);
+      isTerminal(t) = this->isTerminal(index);
+    }
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  const size_t& Size() const { return size; }
+
+  /**
+   * Update the priorities of transitions and Update the gradients.
+   *
+   * @param * (target) The learned value
+   * @param * (sampledActions) Agent's sampled action
+   * @param * (nextActionValues) Agent's next action
+   * @param * (gradients) The model's gradients
+   */
+  void Update(arma::mat /* target */,
+              std::vector<ActionType> /* sampledActions */,
+              arma::mat /* nextActionValues */,
+              arma::mat& /* gradients */)
+  {
+    /* Do nothing for random replay. */
+  }
+
+  //! Get the number of steps for n-step agent.
+  const size_t& NSteps() const { return nSteps; }
+
+  //! Get the number of frames stacked in each state.
+  size_t HistoryLength() const { return historyLength; }
+
+ private:
+  /**
+   * Write the given frame of the given encoded state to the next slot of the
+   * buffer, and drop the transitions that needed the frame it replaces.
+   */
+  void WriteFrame(const arma::colvec& encoded, const size_t frame)
+  {
+    // The overwritten frame was the next state of the previous slot, and in
+    // the history of the historyLength slots from this one.
+    Invalidate((position + capacity - 1) % capacity);
+    for (size_t j = 0; j < historyLength; ++j)
+      Invalidate((position + j) % capacity);
+
+    frames.col(position) = arma::conv_to<arma::Col<ElemType> >::from(
+        encoded.subvec(frame * frameDimension,
+        (frame + 1) * frameDimension - 1));
+
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
+  //! Drop the transition of the given slot, if there is one.
+  void Invalidate(const size_t index)
+  {
+    if (valid[index])
+    {
+      valid[index] = 0;
+      --size;
+    }
+  }
+
+  //! Rebuild the state whose newest frame is in the given slot.
+  template<typename ColType>
+  void Decode(const size_t index, ColType&& state) const
+  {
+    for (size_t j = 0; j < historyLength; ++j)
+    {
+      const size_t slot = (index + capacity + j + 1 - historyLength) %
+          capacity;
+      state.subvec(j * frameDimension, (j + 1) * frameDimension - 1) =
+          arma::conv_to<arma::colvec>::from(frames.col(slot));
+    }
+  }
+
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total number of frames.
+  size_t capacity;
+
+  //! Locally-stored number of frames stacked in each state.
+  size_t historyLength;
+
+  //! Locally-stored dimension of a frame.
+  size_t frameDimension;
+
+  //! Indicate the slot to store the next frame in.
+  size_t position;
+
+  //! Locally-stored indicator that whether the memory is full or not
+  bool full;
+
+  //! Whether the last frame written is the state of the next transition.
+  bool open;
+
+  //! Locally-stored number of transitions in the memory.
+  size_t size;
+
+  //! Locally-stored number of steps to look into the future.
+  size_t nSteps;
+
+  //! Locally-stored frames.
+  arma::Mat<ElemType> frames;
+
+  //! Locally-stored action taken from the state of each slot.
+  std::vector<ActionType> actions;
+
+  //! Locally-stored reward received from the state of each slot.
+  arma::rowvec rewards;
+
+  //! Locally-stored termination information of each slot.
+  arma::irowvec isTerminal;
+
+  //! Whether each slot holds the state of a transition.
+  std::vector<unsigned char> valid;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
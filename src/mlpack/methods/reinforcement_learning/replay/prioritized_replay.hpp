@@ -99,14 +99,8 @@ class PrioritizedReplay
       nextStates(dimension, capacity),
       isTerminal(capacity)
   {
-    size_t size = 1;
-    while (size < capacity)
-    {
-      size *= 2;
-    }
-
     beta = initialBeta;
-    idxSum = SumTree<double>(size);
+    idxSum = SumTree<double>(capacity);
   }
 
   /**
@@ -125,6 +119,30 @@ class PrioritizedReplay
              StateType nextState,
              bool isEnd,
              const double& discount)
+  {
+    Store(std::move(state), std::move(action), reward, std::move(nextState),
+        isEnd, discount, maxPriority);
+  }
+
+  /**
+   * Store the given experience with the given priority, such as the absolute
+   * TD error computed by the actor that generated it (see ApeX).
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   * @param discount The discount parameter.
+   * @param priority The priority of the experience.
+   */
+  void Store(StateType state,
+             ActionType action,
+             double reward,
+             StateType nextState,
+             bool isEnd,
+             const double& discount,
+             const double priority)
   {
     nStepBuffer.push_back({state, action, reward, nextState, isEnd});
 
@@ -150,7 +168,8 @@ class PrioritizedReplay
     nextStates.col(position) = nextState.Encode();
     isTerminal(position) = isEnd;
 
-    idxSum.Set(position, maxPriority * alpha);
+    maxPriority = std::max(maxPriority, priority);
+    idxSum.Set(position, priority * alpha);
 
     position++;
     if (position == capacity)
@@ -191,21 +210,20 @@ class PrioritizedReplay
   }
 
   /**
-   * Sample some experience according to their priorities.
+   * Sample some experience according to their priorities.  The total
+   * priority is split into batchSize equal ranges, and one transition is
+   * sampled in each range (stratified sampling); the tree is searched for all
+   * of them at once.
    *
    * @return The indices to be chosen.
    */
   arma::ucolvec SampleProportional()
   {
-    arma::ucolvec idxes(batchSize);
-    double totalSum = idxSum.Sum(0, (full ? capacity : position));
-    double sumPerRange = totalSum / batchSize;
-    for (size_t bt = 0; bt < batchSize; bt++)
-    {
-      const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
-      idxes(bt) = idxSum.FindPrefixSum(mass);
-    }
-    return idxes;
+    const double totalSum = idxSum.Sum(0, (full ? capacity : position));
+    const double sumPerRange = totalSum / batchSize;
+    const arma::colvec masses = (arma::randu<arma::colvec>(batchSize) +
+        arma::regspace<arma::colvec>(0, batchSize - 1)) * sumPerRange;
+    return idxSum.BatchFindPrefixSum(masses);
   }
 
   /**
@@ -239,9 +257,10 @@ class PrioritizedReplay
     size_t numSample = full ? capacity : position;
     weights = arma::rowvec(sampledIndices.n_rows);
 
+    const double totalSum = idxSum.Sum();
     for (size_t i = 0; i < sampledIndices.n_rows; ++i)
     {
-      double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
+      double p_sample = idxSum.Get(sampledIndices(i)) / totalSum;
       weights(i) = pow(numSample * p_sample, -beta);
     }
     weights /= weights.max();
@@ -26,11 +26,19 @@ namespace rl {
  *
  * Used to maintain prefix-sum of an array.
  *
+ * Each node has Fanout children, stored next to each other, and the levels of
+ * the tree are stored one after the other (the leaves first) in a single
+ * array.  With the default fanout of 8, the children of a node fill one cache
+ * line, so a search from the root only touches log_8(n) cache lines.
+ *
  * @tparam T The array's element type.
+ * @tparam Fanout The number of children of each node.
  */
-template<typename T>
+template<typename T, size_t Fanout = 8>
 class SumTree
 {
+  static_assert(Fanout >= 2, "SumTree: the fanout must be at least 2.");
+
  public:
   /**
    * Default constructor.
@@ -45,7 +53,22 @@ class SumTree
    */
   SumTree(const size_t capacity) : capacity(capacity)
   {
-    element = std::vector<T>(2 * capacity);
+    // Each level is padded to a multiple of the fanout, so that the children
+    // of every node are complete; the last level is the root.
+    size_t levelSize = std::max(capacity, (size_t) 1);
+    size_t total = 0;
+    while (true)
+    {
+      levelSize = (levelSize == 1) ? 1 :
+          ((levelSize + Fanout - 1) / Fanout) * Fanout;
+      offsets.push_back(total);
+      total += levelSize;
+      if (levelSize == 1)
+        break;
+      levelSize /= Fanout;
+    }
+
+    element = std::vector<T>(total);
   }
 
   /**
@@ -56,32 +79,40 @@ class SumTree
    */
   void Set(size_t idx, const T value)
   {
-    idx += capacity;
     element[idx] = value;
-    idx /= 2;
-    while (idx >= 1)
+    for (size_t level = 1; level < offsets.size(); ++level)
     {
-      element[idx] = element[2 * idx] + element[2 * idx + 1];
-      idx /= 2;
+      idx /= Fanout;
+      Recompute(level, idx);
     }
   }
 
   /**
    * Update the data with batch rather loop over the indices with set method.
+   * Each node above the given indices is only recomputed once.
    *
    * @param indices The indices of data to be changed.
    * @param data The data that array with indices to be.
    */
   void BatchUpdate(const arma::ucolvec& indices, const arma::Col<T>& data)
   {
-    for (size_t i = 0; i < indices.n_rows; ++i)
+    std::vector<size_t> nodes(indices.n_elem);
+    for (size_t i = 0; i < indices.n_elem; ++i)
     {
-      element[indices[i] + capacity] = data[i];
+      element[indices[i]] = data[i];
+      nodes[i] = indices[i];
     }
-    // update the total tree with bottom-up technique.
-    for (size_t i = capacity - 1; i > 0; i--)
+
+    // Update the ancestors of the changed data with bottom-up technique.
+    for (size_t level = 1; level < offsets.size(); ++level)
     {
-      element[i] = element[2 * i] + element[2 * i + 1];
+      for (size_t i = 0; i < nodes.size(); ++i)
+        nodes[i] /= Fanout;
+      std::sort(nodes.begin(), nodes.end());
+      nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+      for (size_t i = 0; i < nodes.size(); ++i)
+        Recompute(level, nodes[i]);
     }
   }
 
@@ -90,99 +121,111 @@ class SumTree
    *
    * @param idx The array idx to get data.
    */
-  T Get(size_t idx)
+  T Get(size_t idx) const
   {
-    idx += capacity;
     return element[idx];
   }
 
-  /**
-   * Help function for the `sum` function
-   *
-   * @param start The starting position of subsequence.
-   * @param end The end position of subsequence.
-   * @param node Reference position.
-   * @param nodeStart Starting position of reference segment.
-   * @param nodeEnd End position of reference segment.
-   */
-  T SumHelper(const size_t start,
-              const size_t end,
-              const size_t node,
-              const size_t nodeStart,
-              const size_t nodeEnd)
-  {
-    if (start == nodeStart && end == nodeEnd)
-    {
-      return element[node];
-    }
-    size_t mid = (nodeStart + nodeEnd) / 2;
-    if (end <= mid)
-    {
-      return SumHelper(start, end, 2 * node, nodeStart, mid);
-    }
-    else
-    {
-      if (mid + 1 <= start)
-      {
-        return SumHelper(start, end, 2 * node + 1, mid + 1 , nodeEnd);
-      }
-      else
-      {
-        return SumHelper(start, mid, 2 * node, nodeStart, mid) +
-            SumHelper(mid + 1, end, 2 * node + 1, mid + 1 , nodeEnd);
-      }
-    }
-  }
-
   /**
    * Calculate the sum of contiguous subsequence of the array.
    *
    * @param start The starting position of subsequence.
    * @param end The end position of subsequence.
    */
-  T Sum(const size_t start, size_t end)
+  T Sum(const size_t start, size_t end) const
   {
-    end -= 1;
-    return SumHelper(start, end, 1, 0, capacity - 1);
+    return (start == 0) ? PrefixSum(end) : PrefixSum(end) - PrefixSum(start);
   }
 
   /**
    * Shortcut for calculating the sum of whole array.
    */
-  T Sum()
+  T Sum() const
   {
-    return Sum(0, capacity);
+    return element.back();
   }
 
   /**
    * Find the highest index `idx` in the array such that
-   * sum(arr[0] + arr[1] + ... + arr[idx]) <= mass.
+   * sum(arr[0] + arr[1] + ... + arr[idx]) <= mass.  If the mass reaches the
+   * sum of the whole array, the last index with a positive value is returned.
    *
    * @param mass The upper bound of segment array sum.
    */
-  size_t FindPrefixSum(T mass)
+  size_t FindPrefixSum(T mass) const
   {
-    size_t idx = 1;
-    while (idx < capacity)
+    size_t idx = 0;
+    for (size_t level = offsets.size() - 1; level > 0; --level)
     {
-      if (element[2 * idx] > mass)
-      {
-        idx = 2 * idx;
-      }
-      else
+      const T* children = &element[offsets[level - 1] + idx * Fanout];
+      size_t child = 0, lastPositive = 0;
+      for (; child < Fanout; ++child)
       {
-        mass -= element[2 * idx];
-        idx = 2 * idx + 1;
+        if (children[child] > mass)
+          break;
+
+        mass -= children[child];
+        if (children[child] > 0)
+          lastPositive = child;
       }
+
+      idx = idx * Fanout + ((child == Fanout) ? lastPositive : child);
     }
-    return idx - capacity;
+    return idx;
+  }
+
+  //! Get the size of the data array.
+  size_t Capacity() const { return capacity; }
+
+  /**
+   * Find the index of the prefix sum of each of the given masses (see
+   * FindPrefixSum()), in parallel with OpenMP.
+   *
+   * @param masses The upper bounds of segment array sums.
+   * @return The indices found for each mass.
+   */
+  arma::ucolvec BatchFindPrefixSum(const arma::Col<T>& masses) const
+  {
+    arma::ucolvec indices(masses.n_elem);
+    #pragma omp parallel for if (masses.n_elem >= 1024)
+    for (omp_size_t i = 0; i < (omp_size_t) masses.n_elem; ++i)
+      indices[i] = FindPrefixSum(masses[i]);
+    return indices;
   }
 
  private:
+  //! Recompute the given node of the given level from its children.
+  void Recompute(const size_t level, const size_t idx)
+  {
+    const T* children = &element[offsets[level - 1] + idx * Fanout];
+    T sum = children[0];
+    for (size_t child = 1; child < Fanout; ++child)
+      sum += children[child];
+    element[offsets[level] + idx] = sum;
+  }
+
+  //! Calculate the sum of the elements before the given index.
+  T PrefixSum(size_t end) const
+  {
+    // Add the left siblings of the node at each level, going up.
+    T sum = 0;
+    for (size_t level = 0; level < offsets.size(); ++level)
+    {
+      const size_t first = end - end % Fanout;
+      for (size_t i = first; i < end; ++i)
+        sum += element[offsets[level] + i];
+      end /= Fanout;
+    }
+    return sum;
+  }
+
   //! The capacity of the data array.
   size_t capacity;
 
-  //! Double size of capacity, maintain the segment sum of data.
+  //! The position of each level in the array, the leaves first.
+  std::vector<size_t> offsets;
+
+  //! The data and the sums of all the nodes, level by level.
   std::vector<T> element;
 };
 
@@ -16,9 +16,11 @@
 #include <mlpack/prereqs.hpp>
 
 #include "replay/random_replay.hpp"
+#include "environment/vector_environment.hpp"
 #include <mlpack/methods/ann/activation_functions/tanh_function.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/visitor/parameters_visitor.hpp>
+#include "target_update.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -122,6 +124,22 @@ class SAC
    */
   double Episode();
 
+  /**
+   * Advance all the copies of the given vectorized environment by one step.
+   * The actions of all the copies are computed with a single forward pass of
+   * the policy network, the transitions are all stored in the replay memory,
+   * and the networks are then updated UpdateInterval() times (after the
+   * exploration steps), so each call counts as environments.Size() steps.
+   * The returns of the episodes that ended are given by
+   * environments.FinishedReturns().
+   *
+   * The replay method must use single step transitions, since the
+   * transitions of the copies are interleaved.
+   *
+   * @param environments The copies of the environment to advance.
+   */
+  void VectorStep(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -136,10 +136,10 @@ void SAC<
   ReplayType
 >::SoftUpdate(double rho)
 {
-  targetQ1Network.Parameters() = (1 - rho) * targetQ1Network.Parameters() +
-      rho * learningQ1Network.Parameters();
-  targetQ2Network.Parameters() = (1 - rho) * targetQ2Network.Parameters() +
-      rho * learningQ2Network.Parameters();
+  SoftTargetUpdate(targetQ1Network.Parameters(),
+      learningQ1Network.Parameters(), rho);
+  SoftTargetUpdate(targetQ2Network.Parameters(),
+      learningQ2Network.Parameters(), rho);
 }
 
 template <
@@ -358,6 +358,68 @@ double SAC<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+void SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::VectorStep(VectorEnvironment<EnvironmentType>& environments)
+{
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("SAC::VectorStep(): the replay method must use "
+        "single step transitions!");
+  }
+
+  // Get the actions of all the current states at once, from policy.
+  arma::mat outputActions;
+  policyNetwork.Predict(environments.Encode(), outputActions);
+
+  if (!deterministic)
+  {
+    arma::mat noise = arma::randn<arma::mat>(arma::size(outputActions)) * 0.1;
+    noise = arma::clamp(noise, -0.25, 0.25);
+    outputActions += noise;
+  }
+
+  std::vector<ActionType> actions(environments.Size());
+  for (size_t i = 0; i < environments.Size(); ++i)
+  {
+    actions[i].action = arma::conv_to<std::vector<double>>::from(
+        outputActions.col(i));
+  }
+  action = actions.back();
+
+  // The states are replaced by the next ones (or by new initial states).
+  const std::vector<StateType> states = environments.States();
+  std::vector<StateType> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+  environments.Step(actions, nextStates, rewards, isTerminal);
+
+  for (size_t i = 0; i < environments.Size(); ++i)
+  {
+    replayMethod.Store(states[i], actions[i], rewards[i], nextStates[i],
+        isTerminal[i], config.Discount());
+  }
+
+  state = environments.States().back();
+  totalSteps += environments.Size();
+
+  if (deterministic || totalSteps < config.ExplorationSteps())
+    return;
+  for (size_t i = 0; i < config.UpdateInterval(); i++)
+    Update();
+}
+
 } // namespace rl
 } // namespace mlpack
 #endif
@@ -0,0 +1,72 @@
+/**
+ * @file methods/reinforcement_learning/target_update.hpp
+ *
+ * Updates of the parameters of target networks that work in place.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_TARGET_UPDATE_HPP
+#define MLPACK_METHODS_RL_TARGET_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Move the parameters of a target network towards the parameters of the
+ * learning network (Polyak averaging):
+ *
+ *   target = (1 - rho) * target + rho * source.
+ *
+ * This is computed in a single pass over the parameters, in place, so the
+ * memory of the target parameters (which its layers use) is never
+ * reallocated and no temporary is created.
+ *
+ * @param target The parameters of the target network.
+ * @param source The parameters of the learning network.
+ * @param rho The rate of the update, in [0, 1].
+ */
+inline void SoftTargetUpdate(arma::mat& target,
+                             const arma::mat& source,
+                             const double rho)
+{
+  if (target.n_elem != source.n_elem)
+  {
+    throw std::invalid_argument("SoftTargetUpdate(): the target and the "
+        "source parameters must have the same size!");
+  }
+
+  double* t = target.memptr();
+  const double* s = source.memptr();
+  #pragma omp parallel for if (target.n_elem >= 100000)
+  for (omp_size_t i = 0; i < (omp_size_t) target.n_elem; ++i)
+    t[i] += rho * (s[i] - t[i]);
+}
+
+/**
+ * Copy the parameters of the learning network into the parameters of a target
+ * network.  The copy is written into the memory the target parameters
+ * already have, so the layers of the target network keep using it.
+ *
+ * @param target The parameters of the target network.
+ * @param source The parameters of the learning network.
+ */
+inline void HardTargetUpdate(arma::mat& target, const arma::mat& source)
+{
+  if (target.n_elem != source.n_elem)
+  {
+    throw std::invalid_argument("HardTargetUpdate(): the target and the "
+        "source parameters must have the same size!");
+  }
+
+  arma::arrayops::copy(target.memptr(), source.memptr(), source.n_elem);
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -34,7 +34,8 @@ class TrainingConfig
       atomSize(51),
       vMin(0),
       vMax(200),
-      rho(0.005)
+      rho(0.005),
+      softTargetUpdate(false)
   { /* Nothing to do here. */ }
 
   TrainingConfig(
@@ -67,7 +68,8 @@ class TrainingConfig
       atomSize(atomSize),
       vMin(vMin),
       vMax(vMax),
-      rho(rho)
+      rho(rho),
+      softTargetUpdate(false)
   { /* Nothing to do here. */ }
 
   //! Get the amount of workers.
@@ -144,11 +146,21 @@ class TrainingConfig
   //! Modify the maximum value for support.
   double& VMax() { return vMax; }
 
-  //! Get the rho value for sac.
+  //! Get the rho value for sac and soft target network updates.
   double Rho() const { return rho; }
-  //! Modify the rho value for sac.
+  //! Modify the rho value for sac and soft target network updates.
   double& Rho() { return rho; }
 
+  //! Get the indicator of soft target network updates for q-learning.
+  bool SoftTargetUpdate() const { return softTargetUpdate; }
+  /**
+   * Modify the indicator of soft target network updates for q-learning.  If
+   * it is set, the target network moves towards the learning network by
+   * Rho() every TargetNetworkSyncInterval() steps (Polyak averaging), instead
+   * of being replaced by it.
+   */
+  bool& SoftTargetUpdate() { return softTargetUpdate; }
+
  private:
   /**
    * Locally-stored number of workers.
@@ -239,9 +251,16 @@ class TrainingConfig
 
   /**
    * Locally-stored parameter for softly updating q networks.
-   * This is valid only for Soft Actor-Critic.
+   * This is valid for Soft Actor-Critic, and for q-learning agent when
+   * softTargetUpdate is set.
    */
   double rho;
+
+  /**
+   * Locally-stored indicator for soft target network updates.
+   * This is valid only for q-learning agent.
+   */
+  bool softTargetUpdate;
 };
 
 } // namespace rl
@@ -0,0 +1,103 @@
+/**
+ * @file methods/reinforcement_learning/worker/hogwild_update.hpp
+ *
+ * Lock-free (Hogwild) access to the parameters of the network shared by the
+ * workers of AsyncLearning.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_WORKER_HOGWILD_UPDATE_HPP
+#define MLPACK_METHODS_RL_WORKER_HOGWILD_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Add the given step to the shared parameters without any lock, as in
+ * Hogwild: each element is updated atomically, so no update is lost, but the
+ * steps of concurrent workers are interleaved element by element.
+ *
+ * For more details, see the following:
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title     = {Hogwild!: A Lock-Free Approach to Parallelizing Stochastic
+ *                Gradient Descent},
+ *   author    = {Recht, Benjamin and Re, Christopher and Wright, Stephen and
+ *                Niu, Feng},
+ *   booktitle = {Advances in Neural Information Processing Systems},
+ *   pages     = {693--701},
+ *   year      = {2011}
+ * }
+ * @endcode
+ *
+ * @param shared The shared parameters.
+ * @param step The step to add to the parameters.
+ */
+inline void HogwildUpdate(arma::mat& shared, const arma::mat& step)
+{
+  double* parameters = shared.memptr();
+  const double* steps = step.memptr();
+  for (size_t i = 0; i < shared.n_elem; ++i)
+  {
+    #pragma omp atomic
+    parameters[i] += steps[i];
+  }
+}
+
+/**
+ * Copy the shared parameters into the given local parameters while other
+ * workers may be updating them with HogwildUpdate().  Each element is read
+ * atomically; the local parameters keep their memory, so the layers of a
+ * network that use it see the new values.
+ *
+ * @param shared The shared parameters.
+ * @param local The local copy of the parameters.
+ */
+inline void HogwildRead(const arma::mat& shared, arma::mat& local)
+{
+  local.set_size(shared.n_rows, shared.n_cols);
+
+  const double* parameters = shared.memptr();
+  double* copy = local.memptr();
+  for (size_t i = 0; i < shared.n_elem; ++i)
+  {
+    double value;
+    // Atomic reads need OpenMP 3.1; older versions (such as the one of MSVC)
+    // read the elements directly.
+    #if defined(_OPENMP) && (_OPENMP >= 201107)
+    #pragma omp atomic read
+    #endif
+    value = parameters[i];
+    copy[i] = value;
+  }
+}
+
+/**
+ * Make the layers of the given network use its parameters again.  The layers
+ * of a copied network hold their own copies of the weights, so the parameters
+ * of the copy couldn't be updated in place (with HogwildRead()) otherwise.
+ *
+ * @param network The network to link.
+ */
+template<typename NetworkType>
+void LinkParameters(NetworkType& network)
+{
+  if (network.Parameters().is_empty())
+    return;
+
+  const arma::mat parameters = network.Parameters();
+  network.ResetParameters();
+  network.Parameters() = parameters;
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
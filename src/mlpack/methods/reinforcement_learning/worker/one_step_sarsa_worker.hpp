@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RL_WORKER_ONE_STEP_SARSA_WORKER_HPP
 
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
+#include "hogwild_update.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -85,6 +86,7 @@ class OneStepSarsaWorker
       state(other.state),
       action(other.action)
   {
+    LinkParameters(network);
     Reset();
 
     #if ENS_VERSION_MAJOR >= 2
@@ -149,6 +151,7 @@ class OneStepSarsaWorker
     pending = other.pending;
     pendingIndex = other.pendingIndex;
     network = other.network;
+    LinkParameters(network);
     state = other.state;
     action = other.action;
 
@@ -232,6 +235,7 @@ class OneStepSarsaWorker
 
     // Build local network.
     network = learningNetwork;
+    LinkParameters(network);
   }
 
   /**
@@ -239,7 +243,9 @@ class OneStepSarsaWorker
    *
    * @param learningNetwork The shared learning network.
    * @param targetNetwork The shared target network.
-   * @param totalSteps The shared counter for total steps.
+   * @param totalSteps The shared counter for total steps.  It is incremented
+   *     atomically, so exactly one worker syncs the target network at each
+   *     multiple of the sync interval.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
    *     after this step. Otherwise this is invalid.
@@ -247,7 +253,7 @@ class OneStepSarsaWorker
    */
   bool Step(NetworkType& learningNetwork,
             NetworkType& targetNetwork,
-            size_t& totalSteps,
+            std::atomic<size_t>& totalSteps,
             PolicyType& policy,
             double& totalReward)
   {
@@ -277,7 +283,7 @@ class OneStepSarsaWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        HogwildRead(learningNetwork.Parameters(), network.Parameters());
         return true;
       }
       state = nextState;
@@ -285,8 +291,7 @@ class OneStepSarsaWorker
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
+    const size_t step = ++totalSteps;
 
     pending[pendingIndex++] =
         std::make_tuple(state, action, reward, nextState, nextAction);
@@ -332,26 +337,28 @@ class OneStepSarsaWorker
           { return std::min(std::max(gradient, -config.GradientLimit()),
           config.GradientLimit()); });
 
-      // Perform async update of the global network.
+      // Compute the step of the optimizer on the local parameters, and add it
+      // to the global network without locking it.
+      arma::mat parameters = network.Parameters();
       #if ENS_VERSION_MAJOR == 1
-      updater.Update(learningNetwork.Parameters(), config.StepSize(),
-          totalGradients);
+      updater.Update(parameters, config.StepSize(), totalGradients);
       #else
-      updatePolicy->Update(learningNetwork.Parameters(),
-          config.StepSize(), totalGradients);
+      updatePolicy->Update(parameters, config.StepSize(), totalGradients);
       #endif
+      HogwildUpdate(learningNetwork.Parameters(),
+          parameters - network.Parameters());
 
       // Sync the local network with the global network.
-      network = learningNetwork;
+      HogwildRead(learningNetwork.Parameters(), network.Parameters());
 
       pendingIndex = 0;
     }
 
     // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+    if (step % config.TargetNetworkSyncInterval() == 0)
     {
       #pragma omp critical
-      { targetNetwork = learningNetwork; }
+      { HogwildRead(learningNetwork.Parameters(), targetNetwork.Parameters()); }
     }
 
     policy.Anneal();
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <ensmallen.hpp>
+#include <mlpack/methods/ann/data_loader/prefetch_loader.hpp>
 
 #include "softmax_regression_function.hpp"
 
@@ -205,6 +206,39 @@ class SoftmaxRegression
                OptimizerType optimizer,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the softmax regression on a dataset streamed in chunks by the given
+   * loader, for the given number of epochs, so that the whole dataset never has
+   * to be in memory; each epoch reads the chunks from the source again.  The
+   * optimizer is run once on each chunk, with its maximum number of iterations
+   * set to the size of the chunk, so each epoch is one pass over the dataset;
+   * the state of its update policy is kept from one chunk to the next.  This
+   * is meant for stochastic optimizers such as ens::SGD.  The responses of
+   * each chunk must be a row of labels.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization, if there are any.
+   *
+   * @tparam SourceType Type of the source of the loader.
+   * @tparam OptimizerType Desired optimizer.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param loader Loader that gives the chunks of the dataset.
+   * @param numClasses Number of classes for classification.
+   * @param optimizer Instantiated optimizer.
+   * @param epochs Number of passes over the dataset.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`,
+   *      which are run for every chunk.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The sum of the final objectives of the chunks of the last epoch.
+   */
+  template<typename SourceType, typename OptimizerType,
+           typename... CallbackTypes>
+  double Train(ann::PrefetchLoader<SourceType>& loader,
+               const size_t numClasses,
+               OptimizerType& optimizer,
+               const size_t epochs,
+               CallbackTypes&&... callbacks);
+
   //! Sets the number of classes.
   size_t& NumClasses() { return numClasses; }
   //! Gets the number of classes.
@@ -231,7 +231,7 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
 
   logLikelihood = arma::accu(groundTruth.cols(start, start + batchSize - 1) %
       arma::log(probabilities)) / batchSize;
-  weightDecay = 0.5 * lambda * arma::accu(parameters * parameters);
+  weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
 
   return -logLikelihood + weightDecay;
 }
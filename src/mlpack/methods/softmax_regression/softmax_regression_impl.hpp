@@ -14,6 +14,7 @@
 
 // In case it hasn't been included yet.
 #include "softmax_regression.hpp"
+#include <mlpack/methods/ann/data_loader/optimizer_options.hpp>
 
 namespace mlpack {
 namespace regression {
@@ -102,6 +103,71 @@ double SoftmaxRegression::Train(const arma::mat& data,
   return out;
 }
 
+template<typename SourceType, typename OptimizerType,
+         typename... CallbackTypes>
+double SoftmaxRegression::Train(ann::PrefetchLoader<SourceType>& loader,
+                                const size_t numClasses,
+                                OptimizerType& optimizer,
+                                const size_t epochs,
+                                CallbackTypes&&... callbacks)
+{
+  static_assert(std::is_same<typename SourceType::InputType,
+                             arma::mat>::value,
+      "SoftmaxRegression::Train(): the predictors of the loader must be an "
+      "arma::mat!");
+
+  this->numClasses = numClasses;
+
+  // Start at the beginning of an epoch.
+  loader.Reset();
+
+  // Save the options of the optimizer that are changed for each chunk.
+  const size_t maxIterations = ann::SwapMaxIterations(optimizer, 0);
+  const bool resetPolicy = ann::SwapResetPolicy(optimizer, true);
+
+  arma::mat data;
+  typename SourceType::OutputType responses;
+
+  Timer::Start("softmax_regression_optimization");
+  double out = 0.0;
+  size_t chunks = 0;
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    out = 0.0;
+    while (loader.Next(data, responses))
+    {
+      if (data.n_cols == 0)
+        continue;
+
+      const arma::Row<size_t> labels =
+          arma::conv_to<arma::Row<size_t>>::from(responses);
+      SoftmaxRegressionFunction regressor(data, labels, numClasses, lambda,
+                                          fitIntercept);
+      if (parameters.n_elem != regressor.GetInitialPoint().n_elem)
+        parameters = regressor.GetInitialPoint();
+
+      // Make one pass over the chunk, and keep the state of the optimizer for
+      // the next one.
+      ann::SwapMaxIterations(optimizer, data.n_cols);
+      out += optimizer.Optimize(regressor, parameters, callbacks...);
+      if (++chunks == 1)
+        ann::SwapResetPolicy(optimizer, false);
+    }
+  }
+  Timer::Stop("softmax_regression_optimization");
+
+  ann::SwapMaxIterations(optimizer, maxIterations);
+  ann::SwapResetPolicy(optimizer, resetPolicy);
+
+  // Don't keep reading chunks that won't be used.
+  loader.Reset();
+
+  Log::Info << "SoftmaxRegression::SoftmaxRegression(): final objective of "
+            << "trained model is " << out << "." << std::endl;
+
+  return out;
+}
+
 } // namespace regression
 } // namespace mlpack
 
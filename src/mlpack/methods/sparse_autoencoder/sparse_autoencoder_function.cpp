@@ -10,6 +10,11 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "sparse_autoencoder_function.hpp"
+#include <mlpack/core/math/make_alias.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 using namespace mlpack;
 using namespace mlpack::nn;
@@ -21,7 +26,7 @@ SparseAutoencoderFunction::SparseAutoencoderFunction(const arma::mat& data,
                                                      const double lambda,
                                                      const double beta,
                                                      const double rho) :
-    data(data),
+    data(math::MakeAlias(const_cast<arma::mat&>(data), false)),
     visibleSize(visibleSize),
     hiddenSize(hiddenSize),
     lambda(lambda),
@@ -71,9 +76,69 @@ const arma::mat SparseAutoencoderFunction::InitializeWeights()
   return parameters;
 }
 
+/**
+ * Shuffle the points of the dataset.
+ */
+void SparseAutoencoderFunction::Shuffle()
+{
+  arma::mat newData = data.cols(arma::shuffle(arma::linspace<arma::uvec>(0,
+      data.n_cols - 1, data.n_cols)));
+  math::ClearAlias(data);
+  data = std::move(newData);
+}
+
 /** Evaluates the objective function given the parameters.
   */
 double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Evaluate(parameters, 0, data.n_cols);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         arma::mat& gradient) const
+{
+  Gradient(parameters, 0, gradient, data.n_cols);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return EvaluateWithGradient(parameters, 0, gradient, data.n_cols);
+}
+
+double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
+{
+  arma::mat gradient; // Not used.
+  return Accumulate<false>(parameters, begin, batchSize, gradient);
+}
+
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         arma::mat& gradient,
+                                         const size_t batchSize) const
+{
+  Accumulate<true>(parameters, begin, batchSize, gradient);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  return Accumulate<true>(parameters, begin, batchSize, gradient);
+}
+
+template<bool ComputeGradient>
+double SparseAutoencoderFunction::Accumulate(const arma::mat& parameters,
+                                             const size_t begin,
+                                             const size_t batchSize,
+                                             arma::mat& gradient) const
 {
   // The objective function is the average squared reconstruction error of the
   // network. w1 and b1 are the weights and biases associated with the hidden
@@ -82,6 +147,10 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // 'm' is the number of training examples.
   // The cost also takes into account the regularization and KL divergence terms
   // to control the parameter weights and sparsity of the model respectively.
+  //
+  // The gradient is computed with the Backpropagation algorithm: the delta
+  // values at each layer, except for the input layer, are used with the input
+  // layer and hidden layer activations to get the parameter gradients.
 
   // Compute the limits for the parameters w1, w2, b1 and b2.
   const size_t l1 = hiddenSize;
@@ -96,31 +165,74 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
+  // Large batches are split into one chunk per thread; for small batches, the
+  // overhead of the threads would outweigh the work.
+  #ifdef HAS_OPENMP
+  const size_t numChunks = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), batchSize / MinChunkSize));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  // The activations of the hidden layer are kept for the backward pass, since
+  // the sparsity term needs their average over the whole batch first.
+  arma::mat hiddenLayer(l1, batchSize);
+  arma::mat delOut;
+  if (ComputeGradient)
+    delOut.set_size(l2, batchSize);
+
+  std::vector<double> errors(numChunks, 0.0);
+  std::vector<arma::vec> hiddenSums(numChunks);
 
   // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t chunkBegin = c * batchSize / numChunks;
+    const size_t chunkEnd = (c + 1) * batchSize / numChunks;
+    const size_t chunkSize = chunkEnd - chunkBegin;
+    hiddenSums[c].zeros(l1);
+    if (chunkSize == 0)
+      continue;
+
+    const arma::mat chunk(const_cast<double*>(data.colptr(begin + chunkBegin)),
+        l2, chunkSize, false, true);
+
+    arma::mat hiddenChunk, outputChunk;
+    Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * chunk +
+        arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, chunkSize),
+        hiddenChunk);
+
+    Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenChunk +
+        arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, chunkSize),
+        outputChunk);
+
+    // Difference between the reconstructed data and the original data.
+    const arma::mat diff = outputChunk - chunk;
+    errors[c] = arma::accu(diff % diff);
+    hiddenSums[c] = arma::sum(hiddenChunk, 1);
+
+    // The delta vector for the output layer is given by diff * f'(z), where z
+    // is the preactivation and f is the activation function. The derivative of
+    // the sigmoid function turns out to be f(z) * (1 - f(z)).
+    if (ComputeGradient)
+    {
+      delOut.cols(chunkBegin, chunkEnd - 1) = diff % outputChunk %
+          (1 - outputChunk);
+    }
+    hiddenLayer.cols(chunkBegin, chunkEnd - 1) = hiddenChunk;
+  }
+
+  // Reduce the results of the chunks, in order.
+  double sumOfSquaresError = 0.0;
+  arma::vec rhoCap(l1, arma::fill::zeros);
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    sumOfSquaresError += errors[c];
+    rhoCap += hiddenSums[c];
+  }
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  double wL2SquaredNorm;
-
-  // Calculate squared L2-norms of w1 and w2.
-  wL2SquaredNorm = arma::accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
-      parameters.submat(0, 0, l3 - 1, l2 - 1));
-
-  double sumOfSquaresError, weightDecay, klDivergence, cost;
+  rhoCap /= batchSize;
 
   // Calculate the reconstruction error, the regularization cost and the KL
   // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
@@ -128,83 +240,69 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * arma::accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
-      arma::log((1 - rho) / (1 - rhoCap)));
+  const double wL2SquaredNorm = arma::accu(
+      parameters.submat(0, 0, l3 - 1, l2 - 1) %
+      parameters.submat(0, 0, l3 - 1, l2 - 1));
+  sumOfSquaresError = 0.5 * sumOfSquaresError / batchSize;
+  const double weightDecay = 0.5 * lambda * wL2SquaredNorm;
+  const double klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) +
+      (1 - rho) * arma::log((1 - rho) / (1 - rhoCap)));
 
   // The cost is the sum of the terms calculated above.
-  cost = sumOfSquaresError + weightDecay + klDivergence;
-
-  return cost;
-}
-
-/** Calculates and stores the gradient values given a set of parameters.
-  */
-void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
-                                         arma::mat& gradient) const
-{
-  // Performs a feedforward pass of the neural network, and computes the
-  // activations of the output layer as in the Evaluate() method. It uses the
-  // Backpropagation algorithm to calculate the delta values at each layer,
-  // except for the input layer. The delta values are then used with input layer
-  // and hidden layer activations to get the parameter gradients.
-
-  // Compute the limits for the parameters w1, w2, b1 and b2.
-  const size_t l1 = hiddenSize;
-  const size_t l2 = visibleSize;
-  const size_t l3 = 2 * hiddenSize;
-
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
-
-  // The delta vector for the output layer is given by diff * f'(z), where z is
-  // the preactivation and f is the activation function. The derivative of the
-  // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
-  // in the neural network which comes before the output layer, the delta values
-  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
-  // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      arma::repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
-      (1 - hiddenLayer);
+  const double cost = sumOfSquaresError + weightDecay + klDivergence;
+
+  if (!ComputeGradient)
+    return cost;
+
+  // For every layer in the neural network which comes before the output layer,
+  // the delta values are given del_n = w_n' * del_(n+1) * f'(z_n). Since our
+  // cost function also includes the KL divergence term, we adjust for that in
+  // the formula below.
+  const arma::vec klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+      (1 - rhoCap));
+
+  std::vector<arma::mat> gradients(numChunks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t chunkBegin = c * batchSize / numChunks;
+    const size_t chunkEnd = (c + 1) * batchSize / numChunks;
+    if (chunkEnd == chunkBegin)
+      continue;
+
+    const size_t chunkSize = chunkEnd - chunkBegin;
+    const arma::mat chunk(const_cast<double*>(data.colptr(begin + chunkBegin)),
+        l2, chunkSize, false, true);
+    const auto hiddenChunk = hiddenLayer.cols(chunkBegin, chunkEnd - 1);
+    const auto delOutChunk = delOut.cols(chunkBegin, chunkEnd - 1);
+
+    arma::mat delHid = parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOutChunk;
+    delHid.each_col() += klDivGrad;
+    delHid %= hiddenChunk % (1 - hiddenChunk);
+
+    // Compute the (unnormalized) gradient values using the activations and the
+    // delta values.
+    arma::mat& g = gradients[c];
+    g.zeros(2 * hiddenSize + 1, visibleSize + 1);
+    g.submat(0, 0, l1 - 1, l2 - 1) = delHid * chunk.t();
+    g.submat(l1, 0, l3 - 1, l2 - 1) = hiddenChunk * delOutChunk.t();
+    g.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1);
+    g.submat(l3, 0, l3, l2 - 1) = arma::sum(delOutChunk, 1).t();
+  }
 
   gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
-
-  // Compute the gradient values using the activations and the delta values. The
-  // formula also accounts for the regularization terms in the objective.
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    if (!gradients[c].is_empty())
+      gradient += gradients[c];
+  }
+  gradient /= batchSize;
+
+  // The formula also accounts for the regularization terms in the objective
   // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / data.n_cols).t();
+  gradient.submat(0, 0, l3 - 1, l2 - 1) += lambda *
+      parameters.submat(0, 0, l3 - 1, l2 - 1);
+
+  return cost;
 }
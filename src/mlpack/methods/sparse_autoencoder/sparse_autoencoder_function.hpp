@@ -22,6 +22,12 @@ namespace nn {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The objective can be evaluated on the whole dataset (for optimizers such as
+ * L-BFGS) or on batches of points (for SGD-type optimizers); on a batch, the
+ * sparsity term uses the average activations of the hidden layer over the
+ * batch.  Large batches are split into chunks of points that are processed in
+ * parallel, if OpenMP is available.
  */
 class SparseAutoencoderFunction
 {
@@ -47,6 +53,9 @@ class SparseAutoencoderFunction
   //! Initializes the parameters of the model to suitable values.
   const arma::mat InitializeWeights();
 
+  //! Shuffle the points of the dataset.
+  void Shuffle();
+
   /**
    * Evaluates the objective function of the sparse autoencoder model using the
    * given parameters. The cost function has terms for the reconstruction
@@ -70,6 +79,66 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluate the objective function and its gradient together, with a single
+   * feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   * @return The value of the objective function.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function on the given batch of points.  The
+   * reconstruction error is averaged over the batch, and the sparsity term
+   * uses the average activations of the hidden layer over the batch.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the gradient of the objective function on the given batch of
+   * points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points of the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient on the given batch of
+   * points, with a single feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points of the batch.
+   * @return The value of the objective function on the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
+  //! Return the number of separable functions (the number of points).
+  size_t NumFunctions() const { return data.n_cols; }
+
+  //! The smallest number of points that is worth giving to its own thread when
+  //! the objective or gradient of a batch is computed.
+  static const size_t MinChunkSize = 256;
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -146,8 +215,20 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  /**
+   * Compute the objective function and/or its gradient on the given batch of
+   * points, with one feedforward pass over chunks of the batch (in parallel,
+   * if OpenMP is available).
+   */
+  template<bool ComputeGradient>
+  double Accumulate(const arma::mat& parameters,
+                    const size_t begin,
+                    const size_t batchSize,
+                    arma::mat& gradient) const;
+
+  //! The matrix of data points (an alias of the given matrix, until it is
+  //! shuffled).
+  arma::mat data;
   //! Initial parameter vector.
   arma::mat initialPoint;
   //! Size of the visible layer.
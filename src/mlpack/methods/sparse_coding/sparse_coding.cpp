@@ -28,7 +28,8 @@ SparseCoding::SparseCoding(
     lambda2(lambda2),
     maxIterations(maxIterations),
     objTolerance(objTolerance),
-    newtonTolerance(newtonTolerance)
+    newtonTolerance(newtonTolerance),
+    maxNonzeros(0)
 {
   // Nothing to do.
 }
@@ -36,16 +37,34 @@ SparseCoding::SparseCoding(
 void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
 {
   // When using the Cholesky version of LARS, this is correct even if
-  // lambda2 > 0.
+  // lambda2 > 0.  The Gram matrix is only read, so it is shared by all the
+  // points.
   arma::mat matGram = trans(dictionary) * dictionary;
 
-  codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  Log::Debug << "Encoding " << data.n_cols << " points." << std::endl;
+
+  if (maxNonzeros > 0)
   {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
+    // Orthogonal matching pursuit only needs the correlations of each point
+    // with the atoms, which are computed for all the points at once.
+    matGram.diag() += lambda2;
+    const arma::mat correlations = trans(dictionary) * data;
+
+    codes.zeros(atoms, data.n_cols);
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      arma::vec code = codes.unsafe_col(i);
+      OrthogonalMatchingPursuit(matGram, correlations.unsafe_col(i), code);
+    }
 
+    return;
+  }
+
+  codes.set_size(atoms, data.n_cols);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
 
@@ -58,6 +77,78 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   }
 }
 
+void SparseCoding::OrthogonalMatchingPursuit(const arma::mat& gram,
+                                             const arma::vec& correlations,
+                                             arma::vec& code) const
+{
+  // This is the Batch-OMP variant of orthogonal matching pursuit (Rubinstein,
+  // Zibulevsky and Elad, 2008), which only uses the Gram matrix of the
+  // dictionary and the correlations of the point with the atoms.
+  const size_t maxAtoms = std::min(maxNonzeros, (size_t) atoms);
+  std::vector<arma::uword> selected;
+  std::vector<bool> isSelected(atoms, false);
+  arma::mat lower(maxAtoms, maxAtoms, arma::fill::zeros);
+  arma::vec residualCorrelations = correlations;
+  arma::vec coefficients;
+
+  while (selected.size() < maxAtoms)
+  {
+    // Find the unselected atom most correlated with the residual.
+    size_t best = atoms;
+    double bestCorrelation = lambda1;
+    for (size_t j = 0; j < atoms; ++j)
+    {
+      if (!isSelected[j] && std::abs(residualCorrelations[j]) > bestCorrelation)
+      {
+        best = j;
+        bestCorrelation = std::abs(residualCorrelations[j]);
+      }
+    }
+
+    if (best == atoms)
+      break;
+
+    // Add a row to the Cholesky factor of the Gram matrix of the selected
+    // atoms.
+    const size_t k = selected.size();
+    if (k == 0)
+    {
+      lower(0, 0) = std::sqrt(gram(best, best));
+    }
+    else
+    {
+      const arma::uvec indices(selected);
+      const arma::vec gramColumn = gram.submat(indices,
+          arma::uvec({ (arma::uword) best }));
+      const arma::vec w = arma::solve(arma::trimatl(
+          lower.submat(0, 0, k - 1, k - 1)), gramColumn);
+      const double diagonal = gram(best, best) - arma::dot(w, w);
+
+      // The atom is (numerically) a combination of the selected atoms.
+      if (diagonal <= 1e-12 * gram(best, best))
+        break;
+
+      lower.submat(k, 0, k, k - 1) = w.t();
+      lower(k, k) = std::sqrt(diagonal);
+    }
+
+    selected.push_back(best);
+    isSelected[best] = true;
+
+    // Solve for the coefficients of the selected atoms with two triangular
+    // solves, and update the correlations of the residual.
+    const arma::uvec indices(selected);
+    const arma::mat factor = lower.submat(0, 0, k, k);
+    const arma::vec y = arma::solve(arma::trimatl(factor),
+        correlations.elem(indices));
+    coefficients = arma::solve(arma::trimatu(factor.t()), y);
+    residualCorrelations = correlations - gram.cols(indices) * coefficients;
+  }
+
+  if (!selected.empty())
+    code.elem(arma::uvec(selected)) = coefficients;
+}
+
 // Dictionary step for optimization.
 double SparseCoding::OptimizeDictionary(const arma::mat& data,
                                         const arma::mat& codes,
@@ -187,7 +187,12 @@ class SparseCoding
 
   /**
    * Sparse code each point in the given dataset via LARS, using the current
-   * dictionary and store the encoded data in the codes matrix.
+   * dictionary and store the encoded data in the codes matrix.  If
+   * MaxNonzeros() is greater than 0, orthogonal matching pursuit is used
+   * instead: atoms are added to the code of each point while their correlation
+   * with the residual is greater than lambda1, up to MaxNonzeros() atoms.  The
+   * points are encoded in parallel when OpenMP is available, and the Gram
+   * matrix of the dictionary is shared by all of them.
    *
    * @param data Input data matrix to be encoded.
    * @param codes Output codes matrix.
@@ -254,11 +259,33 @@ class SparseCoding
   //! Modify the tolerance for Newton's method (dictionary optimization step).
   double& NewtonTolerance() { return newtonTolerance; }
 
+  //! Get the maximum number of nonzero coefficients of orthogonal matching
+  //! pursuit (0 if LARS is used).
+  size_t MaxNonzeros() const { return maxNonzeros; }
+  //! Modify the maximum number of nonzero coefficients of orthogonal matching
+  //! pursuit (0 to use LARS).
+  size_t& MaxNonzeros() { return maxNonzeros; }
+
   //! Serialize the sparse coding model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
+  /**
+   * Encode a single point with orthogonal matching pursuit, given the
+   * correlations of the point with each atom.  The least-squares problem of
+   * the selected atoms is solved with a Cholesky factor that is updated each
+   * time an atom is added.
+   *
+   * @param gram Gram matrix of the dictionary (with lambda2 added to the
+   *     diagonal).
+   * @param correlations Correlations of the point with each atom.
+   * @param code Output code; must be filled with zeros.
+   */
+  void OrthogonalMatchingPursuit(const arma::mat& gram,
+                                 const arma::vec& correlations,
+                                 arma::vec& code) const;
+
   //! Number of atoms.
   size_t atoms;
 
@@ -276,11 +303,17 @@ class SparseCoding
   double objTolerance;
   //! Tolerance for Newton's method (dictionary training).
   double newtonTolerance;
+  //! Maximum number of nonzero coefficients for orthogonal matching pursuit
+  //! (0 to use LARS).
+  size_t maxNonzeros;
 };
 
 } // namespace sparse_coding
 } // namespace mlpack
 
+//! Set the serialization version of the SparseCoding class.
+BOOST_CLASS_VERSION(mlpack::sparse_coding::SparseCoding, 1);
+
 // Include implementation.
 #include "sparse_coding_impl.hpp"
 
@@ -34,7 +34,8 @@ SparseCoding::SparseCoding(
     lambda2(lambda2),
     maxIterations(maxIterations),
     objTolerance(objTolerance),
-    newtonTolerance(newtonTolerance)
+    newtonTolerance(newtonTolerance),
+    maxNonzeros(0)
 {
   Train(data, initializer);
 }
@@ -110,7 +111,7 @@ double SparseCoding::Train(
 }
 
 template<typename Archive>
-void SparseCoding::serialize(Archive& ar, const unsigned int /* version */)
+void SparseCoding::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(atoms);
   ar & BOOST_SERIALIZATION_NVP(dictionary);
@@ -119,6 +120,12 @@ void SparseCoding::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(maxIterations);
   ar & BOOST_SERIALIZATION_NVP(objTolerance);
   ar & BOOST_SERIALIZATION_NVP(newtonTolerance);
+
+  // Older models were always encoded with LARS.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(maxNonzeros);
+  else if (Archive::is_loading::value)
+    maxNonzeros = 0;
 }
 
 } // namespace sparse_coding
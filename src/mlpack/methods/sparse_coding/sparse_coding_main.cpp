@@ -111,6 +111,10 @@ PARAM_DOUBLE_IN("objective_tolerance", "Tolerance for convergence of the "
     "objective function.", "o", 0.01);
 PARAM_DOUBLE_IN("newton_tolerance", "Tolerance for convergence of Newton "
     "method.", "w", 1e-6);
+PARAM_INT_IN("max_nonzeros", "If greater than 0, the points are encoded with "
+    "orthogonal matching pursuit instead of LARS, with at most this many "
+    "nonzero coefficients per point (atoms are only added while their "
+    "correlation with the residual is greater than lambda1).", "", 0);
 
 // Load/save a model.
 PARAM_MODEL_IN(SparseCoding, "input_model", "File containing input sparse "
@@ -157,6 +161,7 @@ static void mlpackMain()
   ReportIgnoredParam({{ "training", false }}, "normalize");
   ReportIgnoredParam({{ "training", false }}, "objective_tolerance");
   ReportIgnoredParam({{ "training", false }}, "newton_tolerance");
+  ReportIgnoredParam({{ "training", false }}, "max_nonzeros");
 
   RequireParamValue<int>("atoms", [](int x) { return x > 0; }, true,
       "number of atoms must be positive");
@@ -172,6 +177,8 @@ static void mlpackMain()
   RequireParamValue<double>("newton_tolerance",
       [](double x) { return x >= 0.0; }, true,
       "Newton method tolerance must be nonnegative");
+  RequireParamValue<int>("max_nonzeros", [](int x) { return x >= 0; }, true,
+      "maximum number of nonzero coefficients must be nonnegative");
 
   // Do we have an existing model?
   SparseCoding* sc;
@@ -198,6 +205,7 @@ static void mlpackMain()
     sc->Atoms() = (size_t) IO::GetParam<int>("atoms");
     sc->ObjTolerance() = IO::GetParam<double>("objective_tolerance");
     sc->NewtonTolerance() = IO::GetParam<double>("newton_tolerance");
+    sc->MaxNonzeros() = (size_t) IO::GetParam<int>("max_nonzeros");
 
     // Inform the user if we are overwriting their model.
     if (IO::HasParam("input_model"))
@@ -20,6 +20,7 @@
 #include <ensmallen.hpp>
 
 #include "svdplusplus_function.hpp"
+#include <mlpack/methods/regularized_svd/blocked_sgd.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -79,6 +80,7 @@ class SVDPlusPlus
   /**
    * Constructor of SVDPlusPlus. By default SGD optimizer is used in
    * SVDPlusPlus. The optimizer uses a template specialization of Optimize().
+   * If OptimizerType is BlockedSGD, the ratings are processed in parallel.
    *
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
@@ -285,6 +285,72 @@ void SVDPlusPlusFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void SVDPlusPlusFunction<MatType>::Update(arma::mat& parameters,
+                                          const size_t i,
+                                          const double stepSize) const
+{
+  // Indices for accessing the the correct parameter columns.
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+  const size_t implicitStart = numUsers + numItems;
+
+  // Calculate the squared error in the prediction.
+  const double rating = data(2, i);
+  const double userBias = parameters(rank, user);
+  const double itemBias = parameters(rank, item);
+
+  // Iterate through each item which the user interacted with to calculate
+  // user vector.
+  arma::vec userVec(rank, arma::fill::zeros);
+  arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+  arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+  size_t implicitCount = 0;
+  for (; it != it_end; ++it)
+  {
+    userVec += parameters.col(implicitStart + it.row()).subvec(0, rank - 1);
+    implicitCount += 1;
+  }
+  if (implicitCount != 0)
+    userVec /= std::sqrt(implicitCount);
+  userVec += parameters.col(user).subvec(0, rank - 1);
+
+  double ratingError = rating - userBias - itemBias -
+      arma::dot(userVec, parameters.col(item).subvec(0, rank - 1));
+
+  // Gradient is non-zero only for the parameter columns corresponding to the
+  // example.
+  parameters.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(user).subvec(0, rank - 1) -
+      ratingError * parameters.col(item).subvec(0, rank - 1));
+  parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(item).subvec(0, rank - 1) -
+      ratingError * userVec);
+  parameters(rank, user) -= stepSize * 2 * (
+      lambda * parameters(rank, user) - ratingError);
+  parameters(rank, item) -= stepSize * 2 * (
+      lambda * parameters(rank, item) - ratingError);
+
+  // Update item implicit vectors.  Unlike the other parameters, they may be
+  // shared with the ratings that other threads are processing when the
+  // BlockedSGD optimizer is used, so the updates are atomic.
+  it = implicitData.begin_col(user);
+  it_end = implicitData.end_col(user);
+  for (; it != it_end; ++it)
+  {
+    // Note that implicitCount != 0 if this loop is acutally executed.
+    double* implicitVec = parameters.colptr(implicitStart + it.row());
+    const double* itemVec = parameters.colptr(item);
+    for (size_t r = 0; r < rank; ++r)
+    {
+      const double update = stepSize * 2.0 * (lambda / implicitCount *
+          implicitVec[r] - ratingError / std::sqrt(implicitCount) * itemVec[r]);
+      #pragma omp atomic
+      implicitVec[r] -= update;
+    }
+  }
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -308,15 +374,6 @@ double StandardSGD::Optimize(
   for (size_t i = 0; i < numFunctions; ++i)
     overallObjective += function.Evaluate(parameters, i);
 
-  const arma::mat data = function.Dataset();
-  const arma::sp_mat implicitData = function.ImplicitDataset();
-  const size_t numUsers = function.NumUsers();
-  const size_t numItems = function.NumItems();
-  const double lambda = function.Lambda();
-
-  // Rank of decomposition.
-  const size_t rank = function.Rank();
-
   // Now iterate!
   for (size_t i = 1; i != maxIterations; ++i, currentFunction++)
   {
@@ -332,58 +389,7 @@ double StandardSGD::Optimize(
       currentFunction = 0;
     }
 
-    // Indices for accessing the the correct parameter columns.
-    const size_t user = data(0, currentFunction);
-    const size_t item = data(1, currentFunction) + numUsers;
-    const size_t implicitStart = numUsers + numItems;
-
-    // Calculate the squared error in the prediction.
-    const double rating = data(2, currentFunction);
-    const double userBias = parameters(rank, user);
-    const double itemBias = parameters(rank, item);
-
-    // Iterate through each item which the user interacted with to calculate
-    // user vector.
-    arma::vec userVec(rank, arma::fill::zeros);
-    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-    size_t implicitCount = 0;
-    for (; it != it_end; ++it)
-    {
-      userVec += parameters.col(implicitStart + it.row()).subvec(0, rank - 1);
-      implicitCount += 1;
-    }
-    if (implicitCount != 0)
-      userVec /= std::sqrt(implicitCount);
-    userVec += parameters.col(user).subvec(0, rank - 1);
-
-    double ratingError = rating - userBias - itemBias -
-        arma::dot(userVec, parameters.col(item).subvec(0, rank - 1));
-
-    // Gradient is non-zero only for the parameter columns corresponding to the
-    // example.
-    parameters.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
-        lambda * parameters.col(user).subvec(0, rank - 1) -
-        ratingError * parameters.col(item).subvec(0, rank - 1));
-    parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
-        lambda * parameters.col(item).subvec(0, rank - 1) -
-        ratingError * userVec);
-    parameters(rank, user) -= stepSize * 2 * (
-        lambda * parameters(rank, user) - ratingError);
-    parameters(rank, item) -= stepSize * 2 * (
-        lambda * parameters(rank, item) - ratingError);
-    // Update item implicit vectors.
-    it = implicitData.begin_col(user);
-    it_end = implicitData.end_col(user);
-    for (; it != it_end; ++it)
-    {
-      // Note that implicitCount != 0 if this loop is acutally executed.
-      parameters.col(implicitStart + it.row()).subvec(0, rank - 1) -=
-          stepSize * 2.0 * (lambda / implicitCount *
-          parameters.col(implicitStart + it.row()).subvec(0, rank - 1) -
-          ratingError / std::sqrt(implicitCount) *
-          parameters.col(item).subvec(0, rank - 1));
-    }
+    function.Update(parameters, currentFunction, stepSize);
 
     // Now add that to the overall objective function.
     overallObjective += function.Evaluate(parameters, currentFunction);
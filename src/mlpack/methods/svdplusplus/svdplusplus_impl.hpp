@@ -48,14 +48,22 @@ void SVDPlusPlus<OptimizerType>::Apply(const arma::mat& data,
   arma::sp_mat cleanedData;
   CleanData(implicitData, cleanedData, data);
 
-  // Make the optimizer object using a SVDPlusPlusFunction object.
+  // Make the function to optimize using a SVDPlusPlusFunction object.
   SVDPlusPlusFunction<arma::mat> svdPPFunc(data, cleanedData, rank, lambda);
-  ens::StandardSGD optimizer(alpha, batchSize,
-      iterations * data.n_cols);
 
   // Get optimized parameters.
   arma::mat parameters = svdPPFunc.GetInitialPoint();
-  optimizer.Optimize(svdPPFunc, parameters);
+  if (std::is_same<OptimizerType, BlockedSGD>::value)
+  {
+    // Each iteration is one pass over the ratings, in parallel.
+    BlockedSGD optimizer(alpha, iterations);
+    optimizer.Optimize(svdPPFunc, parameters);
+  }
+  else
+  {
+    ens::StandardSGD optimizer(alpha, batchSize, iterations * data.n_cols);
+    optimizer.Optimize(svdPPFunc, parameters);
+  }
 
   // Constants for extracting user and item matrices.
   const size_t numUsers = max(data.row(0)) + 1;
@@ -124,6 +124,12 @@ or upgrade Boost to 1.59 or newer.
 // defines.
 #include <mlpack/core/util/arma_config_check.hpp>
 
+// Bandicoot provides GPU matrices with the same API as Armadillo; it is only
+// used if the USE_BANDICOOT CMake option found it.
+#ifdef HAS_BANDICOOT
+  #include <bandicoot>
+#endif
+
 // All code should have access to logging.
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
@@ -891,3 +891,56 @@ TEST_CASE("ID3DecisionStumpSerializationTest", "[AdaBoostTest]")
             abBinary.WeakLearner(i).SplitDimension());
   }
 }
+
+/**
+ * Make sure that classifying a dataset larger than one block gives the same
+ * results as classifying each point on its own.
+ */
+TEST_CASE("BlockClassifyTest", "[AdaBoostTest]")
+{
+  // Build a dataset that spans a few blocks, with a partial last block.
+  const size_t numPoints = 2 * AdaBoost<>::BlockSize + 117;
+  arma::mat inputData(3, numPoints, arma::fill::randu);
+  arma::Row<size_t> labels(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    labels[i] = (inputData(0, i) + inputData(1, i) > 1.0) ? 1 : 0;
+
+  const size_t numClasses = 2;
+  ID3DecisionStump ds(inputData, labels, numClasses, 10);
+  AdaBoost<ID3DecisionStump> a(inputData, labels, numClasses, ds, 20, 1e-10);
+
+  arma::Row<size_t> predictedLabels;
+  arma::mat probabilities;
+  a.Classify(inputData, predictedLabels, probabilities);
+
+  REQUIRE(predictedLabels.n_elem == numPoints);
+  REQUIRE(probabilities.n_rows == numClasses);
+  REQUIRE(probabilities.n_cols == numPoints);
+
+  for (size_t i = 0; i < numPoints; i += 37)
+  {
+    arma::Row<size_t> pointLabel;
+    arma::mat pointProbabilities;
+    a.Classify(inputData.col(i), pointLabel, pointProbabilities);
+
+    REQUIRE(pointLabel[0] == predictedLabels[i]);
+    for (size_t c = 0; c < numClasses; ++c)
+      REQUIRE(pointProbabilities(c, 0) == Approx(probabilities(c, i)));
+  }
+
+  // The votes can also be accumulated in single precision.
+  arma::Row<size_t> floatPredictedLabels;
+  arma::fmat floatProbabilities;
+  a.Classify(inputData, floatPredictedLabels, floatProbabilities);
+
+  REQUIRE(floatProbabilities.n_rows == numClasses);
+  REQUIRE(floatProbabilities.n_cols == numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    for (size_t c = 0; c < numClasses; ++c)
+    {
+      REQUIRE(floatProbabilities(c, i) ==
+          Approx(probabilities(c, i)).epsilon(1e-5).margin(1e-6));
+    }
+  }
+}
@@ -387,6 +387,34 @@ TEST_CASE("SimpleLinearLayerTest", "[ANNLayerTest]")
   REQUIRE(arma::accu(delta) == 0);
 }
 
+/**
+ * Make sure that the Linear layer gives the same output and gradient for a
+ * sparse input as for its dense copy.
+ */
+TEST_CASE("SparseLinearLayerTest", "[ANNLayerTest]")
+{
+  arma::sp_mat input;
+  input.sprandu(100, 8, 0.05);
+  const arma::mat denseInput(input);
+
+  Linear<> module(100, 6);
+  module.Parameters().randu();
+  module.Reset();
+
+  arma::mat output, denseOutput;
+  module.Forward(input, output);
+  module.Forward(denseInput, denseOutput);
+  CheckMatrices(output, denseOutput, 1e-10);
+
+  const arma::mat error = arma::randn(6, 8);
+  arma::mat gradient(module.Parameters().n_elem, 1);
+  arma::mat denseGradient(module.Parameters().n_elem, 1);
+  gradient.fill(1.0);
+  module.Gradient(input, error, gradient);
+  module.Gradient(denseInput, error, denseGradient);
+  CheckMatrices(gradient, denseGradient, 1e-10);
+}
+
 /**
  * Jacobian linear module test.
  */
@@ -1161,6 +1189,42 @@ TEST_CASE("GradientFastLSTMLayerTest", "[ANNLayerTest]")
   REQUIRE(CheckGradient(function) <= 0.2);
 }
 
+/**
+ * Make sure that the Fast LSTM layer gives the same output for a batch of
+ * sequences as for each sequence on its own.
+ */
+TEST_CASE("FastLSTMBatchTest", "[ANNLayerTest]")
+{
+  const size_t steps = 3;
+  arma::cube input = arma::randn<arma::cube>(4, 5, steps);
+
+  FastLSTM<> batchLayer(4, 3, steps);
+  batchLayer.Parameters().randn();
+  batchLayer.Reset();
+
+  arma::cube output(3, 5, steps);
+  for (size_t t = 0; t < steps; ++t)
+  {
+    arma::mat stepOutput;
+    batchLayer.Forward(input.slice(t), stepOutput);
+    output.slice(t) = stepOutput;
+  }
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    FastLSTM<> layer(4, 3, steps);
+    layer.Parameters() = batchLayer.Parameters();
+    layer.Reset();
+
+    for (size_t t = 0; t < steps; ++t)
+    {
+      arma::mat stepOutput;
+      layer.Forward(arma::mat(input.slice(t).col(i)), stepOutput);
+      CheckMatrices(stepOutput, arma::mat(output.slice(t).col(i)));
+    }
+  }
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * Fast LSTM layer work.
@@ -1782,6 +1846,40 @@ TEST_CASE("SimpleLookupLayerTest", "[ANNLayerTest]")
   REQUIRE(std::fabs(arma::accu(error) - arma::accu(gradient)) <= 1e-07);
 }
 
+/**
+ * Make sure that a sparse input to the Lookup layer gives the weighted sum of
+ * the embeddings of its non-zero tokens, and the matching gradient.
+ */
+TEST_CASE("SparseLookupLayerTest", "[ANNLayerTest]")
+{
+  Lookup<> module(10, 3);
+  module.Parameters().randu();
+
+  // Two bags of words.
+  arma::sp_mat input(10, 2);
+  input(1, 0) = 2.0;
+  input(4, 0) = 1.0;
+  input(7, 1) = 0.5;
+
+  arma::mat output;
+  module.Forward(input, output);
+  REQUIRE(output.n_rows == 3);
+  REQUIRE(output.n_cols == 2);
+  CheckMatrices(output.col(0), 2.0 * module.Parameters().col(1) +
+      module.Parameters().col(4));
+  CheckMatrices(output.col(1), 0.5 * module.Parameters().col(7));
+
+  const arma::mat error = arma::randn(3, 2);
+  arma::mat gradient;
+  module.Gradient(input, error, gradient);
+
+  arma::mat expected = arma::zeros(3, 10);
+  expected.col(1) = 2.0 * error.col(0);
+  expected.col(4) = error.col(0);
+  expected.col(7) = 0.5 * error.col(1);
+  CheckMatrices(gradient, expected);
+}
+
 /**
  * Lookup layer numerical gradient test.
  */
@@ -1838,6 +1936,71 @@ TEST_CASE("GradientLookupLayerTest", "[ANNLayerTest]")
   REQUIRE(CheckGradient(function) <= 1e-6);
 }
 
+/**
+ * Make sure that the EmbeddingBag layer sums or averages the embeddings of
+ * bags of different lengths, and that only the rows of the table that appear
+ * in the input are updated.
+ */
+TEST_CASE("EmbeddingBagLayerTest", "[ANNLayerTest]")
+{
+  EmbeddingBag<> module(10, 3, false, 0.5);
+  const arma::mat table = module.Table();
+
+  // Three bags: { 2, 5, 2 }, { 9 } and an empty bag.
+  arma::mat input = { { 2, 9, 0 },
+                      { 5, 0, 0 },
+                      { 2, 0, 0 } };
+
+  arma::mat output;
+  module.Forward(input, output);
+  REQUIRE(output.n_rows == 3);
+  REQUIRE(output.n_cols == 3);
+  CheckMatrices(output.col(0), 2 * table.col(1) + table.col(4));
+  CheckMatrices(output.col(1), table.col(8));
+  CheckMatrices(output.col(2), arma::zeros(3));
+
+  module.Mean() = true;
+  module.Forward(input, output);
+  CheckMatrices(output.col(0), (2 * table.col(1) + table.col(4)) / 3);
+  CheckMatrices(output.col(2), arma::zeros(3));
+
+  const arma::mat error = arma::randn(3, 3);
+  arma::mat gradient;
+  module.Gradient(input, error, gradient);
+
+  REQUIRE(module.TouchedRows().n_elem == 3);
+  REQUIRE(module.TouchedRows()[0] == 1);
+  REQUIRE(module.TouchedRows()[1] == 4);
+  REQUIRE(module.TouchedRows()[2] == 8);
+  CheckMatrices(module.RowGradients().col(0), 2 * error.col(0) / 3);
+  CheckMatrices(module.RowGradients().col(1), error.col(0) / 3);
+  CheckMatrices(module.RowGradients().col(2), error.col(1));
+
+  arma::mat expected = table;
+  expected.col(1) -= 0.5 * module.RowGradients().col(0);
+  expected.col(4) -= 0.5 * module.RowGradients().col(1);
+  expected.col(8) -= 0.5 * module.RowGradients().col(2);
+  CheckMatrices(module.Table(), expected);
+
+  // A sparse bag of words gives the weighted embeddings.
+  arma::sp_mat sparseInput(10, 2);
+  sparseInput(1, 0) = 2.0;
+  sparseInput(4, 0) = 1.0;
+  sparseInput(7, 1) = 0.5;
+
+  module.Mean() = false;
+  module.Forward(sparseInput, output);
+  CheckMatrices(output.col(0), 2 * expected.col(1) + expected.col(4));
+  CheckMatrices(output.col(1), 0.5 * expected.col(7));
+
+  module.StepSize() = 0.0;
+  module.Gradient(sparseInput, error.cols(0, 1), gradient);
+  REQUIRE(module.TouchedRows().n_elem == 3);
+  CheckMatrices(module.RowGradients().col(0), 2 * error.col(0));
+  CheckMatrices(module.RowGradients().col(2), 0.5 * error.col(1));
+  CheckMatrices(module.Table(), expected);
+}
+
 /**
  * Test that the functions that can access the parameters of the
  * Lookup layer work.
@@ -2154,6 +2317,52 @@ TEST_CASE("GradientBatchNormTest", "[ANNLayerTest]")
   REQUIRE(pass);
 }
 
+/**
+ * BatchNorm layer numerical gradient test, with several values per feature map,
+ * whose statistics are computed over the whole feature map.
+ */
+TEST_CASE("GradientBatchNormFeatureMapsTest", "[ANNLayerTest]")
+{
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randn(10, 256);
+      arma::mat target;
+      target.ones(1, 256);
+
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(10, 8);
+      model->Add<BatchNorm<> >(2);
+      model->Add<Linear<> >(8, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 256, false);
+      model->Gradient(model->Parameters(), 0, gradient, 256);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
 /**
  * Test that the functions that can access the parameters of the
  * Batch Norm layer work.
@@ -3752,6 +3961,76 @@ TEST_CASE("MaxPoolingTestCase", "[ANNLayerTest]")
   REQUIRE(output.n_cols == 1);
 }
 
+/**
+ * Make sure that the kernels for non-overlapping windows of MaxPooling and
+ * MeanPooling match a direct computation, for the specialized 2x2 and 3x3
+ * windows and for other sizes, in the forward and the backward pass.
+ */
+TEST_CASE("NonOverlappingPoolingTest", "[ANNLayerTest]")
+{
+  const size_t sizes[3][2] = { { 2, 2 }, { 3, 3 }, { 2, 3 } };
+  for (size_t k = 0; k < 3; ++k)
+  {
+    const size_t kw = sizes[k][0];
+    const size_t kh = sizes[k][1];
+
+    // Two channels, two points; the last row and column aren't covered when
+    // the window doesn't divide the input.
+    const size_t width = 3 * kw + 1, height = 2 * kh + 1;
+    arma::mat input = arma::randn(width * height * 2, 2);
+    arma::cube inputCube(input.memptr(), width, height, 4);
+
+    MaxPooling<> maxModule(kw, kh, kw, kh, true);
+    maxModule.InputWidth() = width;
+    maxModule.InputHeight() = height;
+    MeanPooling<> meanModule(kw, kh, kw, kh, true);
+    meanModule.InputWidth() = width;
+    meanModule.InputHeight() = height;
+
+    arma::mat maxOutput, meanOutput;
+    maxModule.Forward(input, maxOutput);
+    meanModule.Forward(input, meanOutput);
+    REQUIRE(maxOutput.n_rows == 3 * 2 * 2);
+    REQUIRE(meanOutput.n_rows == 3 * 2 * 2);
+
+    arma::mat error = arma::randn(3 * 2 * 2, 2);
+    arma::mat maxDelta, meanDelta;
+    maxModule.Backward(input, error, maxDelta);
+    meanModule.Backward(input, error, meanDelta);
+
+    arma::cube maxOutputCube(maxOutput.memptr(), 3, 2, 4, false);
+    arma::cube meanOutputCube(meanOutput.memptr(), 3, 2, 4, false);
+    arma::cube errorCube(error.memptr(), 3, 2, 4, false);
+    arma::cube maxDeltaCube(maxDelta.memptr(), width, height, 4, false);
+    arma::cube meanDeltaCube(meanDelta.memptr(), width, height, 4, false);
+    arma::cube expectedMaxDelta(width, height, 4, arma::fill::zeros);
+    arma::cube expectedMeanDelta(width, height, 4, arma::fill::zeros);
+    for (size_t s = 0; s < 4; ++s)
+    {
+      for (size_t j = 0; j < 2; ++j)
+      {
+        for (size_t i = 0; i < 3; ++i)
+        {
+          const arma::mat window = inputCube.slice(s).submat(i * kw, j * kh,
+              i * kw + kw - 1, j * kh + kh - 1);
+          REQUIRE(maxOutputCube(i, j, s) == Approx(window.max()));
+          REQUIRE(meanOutputCube(i, j, s) ==
+              Approx(arma::accu(window) / (kw * kh)));
+
+          const size_t argmax = window.index_max();
+          expectedMaxDelta(i * kw + argmax % kw, j * kh + argmax / kw, s) =
+              errorCube(i, j, s);
+          expectedMeanDelta.slice(s).submat(i * kw, j * kh, i * kw + kw - 1,
+              j * kh + kh - 1).fill(errorCube(i, j, s) / (kw * kh));
+        }
+      }
+    }
+
+    CheckMatrices(maxDeltaCube, expectedMaxDelta);
+    CheckMatrices(meanDeltaCube, expectedMeanDelta);
+  }
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * Glimpse layer work.
@@ -4746,3 +5025,236 @@ TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
 
   REQUIRE(CheckGradient(function) <= 2e-06);
 }
+
+/**
+ * Make sure that the streaming attention used in deterministic mode gives the
+ * same output as the attention computed from the full matrix of scores.
+ */
+TEST_CASE("StreamingMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t tgtSeqLen = 5;
+  const size_t srcSeqLen = 7;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+  const size_t batchSize = 3;
+
+  arma::mat attnMask = arma::zeros(tgtSeqLen, srcSeqLen);
+  for (size_t i = 0; i < tgtSeqLen; ++i)
+  {
+    for (size_t j = 0; j < srcSeqLen; ++j)
+    {
+      if (i + 2 < j)
+        attnMask(i, j) = std::numeric_limits<double>::lowest();
+    }
+  }
+
+  arma::mat keyPaddingMask = arma::zeros(1, srcSeqLen);
+  keyPaddingMask(1) = std::numeric_limits<double>::lowest();
+
+  MultiheadAttention<> module(tgtSeqLen, srcSeqLen, embedDim, numHeads);
+  module.AttentionMask() = attnMask;
+  module.KeyPaddingMask() = keyPaddingMask;
+  module.Reset();
+  module.Parameters().randu();
+
+  arma::mat input = arma::randu(embedDim * (tgtSeqLen + 2 * srcSeqLen),
+      batchSize);
+  arma::mat output, streamingOutput;
+  module.Forward(input, output);
+
+  // Use blocks that don't divide the source sequence length.
+  module.Deterministic() = true;
+  module.BlockSize() = 3;
+  module.Forward(input, streamingOutput);
+
+  CheckMatrices(output, streamingOutput);
+}
+
+/**
+ * Make sure that decoding a sequence one position at a time with the cache of
+ * keys and values gives the same output as the causal attention over the whole
+ * sequence.
+ */
+TEST_CASE("CachedMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t seqLen = 6;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+
+  arma::mat attnMask = arma::zeros(seqLen, seqLen);
+  for (size_t i = 0; i < seqLen; ++i)
+  {
+    for (size_t j = 0; j < seqLen; ++j)
+    {
+      if (i < j)
+        attnMask(i, j) = std::numeric_limits<double>::lowest();
+    }
+  }
+
+  MultiheadAttention<> module(seqLen, seqLen, embedDim, numHeads);
+  module.AttentionMask() = attnMask;
+  module.Reset();
+  module.Parameters().randu();
+
+  arma::mat query = arma::randu(embedDim * seqLen, 1);
+  arma::mat key = arma::randu(embedDim * seqLen, 1);
+  arma::mat value = arma::randu(embedDim * seqLen, 1);
+  arma::mat output;
+  module.Forward(arma::mat(arma::join_cols(arma::join_cols(query, key),
+      value)), output);
+
+  MultiheadAttention<> step(1, 1, embedDim, numHeads);
+  step.Parameters() = module.Parameters();
+  step.Reset();
+  step.UseCache() = true;
+
+  arma::mat stepOutput;
+  for (size_t t = 0; t < seqLen; ++t)
+  {
+    const size_t begin = t * embedDim;
+    const size_t end = begin + embedDim - 1;
+    step.Forward(arma::mat(arma::join_cols(arma::join_cols(
+        query.rows(begin, end), key.rows(begin, end)), value.rows(begin, end))),
+        stepOutput);
+
+    REQUIRE(step.CacheSize() == t + 1);
+    CheckMatrices(arma::mat(output.rows(begin, end)), stepOutput);
+  }
+
+  // Resetting the cache starts a new sequence.
+  step.ResetCache();
+  step.Forward(arma::mat(arma::join_cols(arma::join_cols(query.rows(0,
+      embedDim - 1), key.rows(0, embedDim - 1)), value.rows(0, embedDim - 1))),
+      stepOutput);
+  REQUIRE(step.CacheSize() == 1);
+  CheckMatrices(arma::mat(output.rows(0, embedDim - 1)), stepOutput);
+}
+
+/**
+ * Make sure that the GroupedConvolution layer gives the results of a
+ * Convolution layer whose filters between maps of different groups are zero.
+ */
+TEST_CASE("GroupedConvolutionMatchesConvolutionTest", "[ANNLayerTest]")
+{
+  // The general kernel with one and two groups, the depthwise kernel with a
+  // channel multiplier of 2, and the pointwise kernel with two groups.
+  const size_t groupsList[] = { 1, 2, 4, 2 };
+  const size_t kernelList[] = { 3, 3, 3, 1 };
+  const size_t strideList[] = { 2, 1, 2, 1 };
+  const size_t padList[] = { 1, 1, 1, 0 };
+  for (size_t t = 0; t < 4; ++t)
+  {
+    const size_t groups = groupsList[t];
+    const size_t k = kernelList[t];
+    GroupedConvolution<> grouped(4, 8, groups, k, k, strideList[t],
+        strideList[t], padList[t], padList[t], 7, 6);
+    grouped.Parameters().randu();
+    grouped.Reset();
+
+    Convolution<> convolution(4, 8, k, k, strideList[t], strideList[t],
+        padList[t], padList[t], 7, 6);
+    convolution.Parameters().zeros();
+    convolution.Reset();
+    for (size_t o = 0; o < 8; ++o)
+    {
+      const size_t group = o / (8 / groups);
+      for (size_t m = 0; m < 4 / groups; ++m)
+      {
+        convolution.Weight().slice(o * 4 + group * (4 / groups) + m) =
+            grouped.Weight().slice(o * (4 / groups) + m);
+      }
+    }
+    convolution.Bias() = grouped.Bias();
+
+    arma::mat input(7 * 6 * 4, 3, arma::fill::randu);
+    arma::mat output, convolutionOutput;
+    grouped.Forward(input, output);
+    convolution.Forward(input, convolutionOutput);
+    REQUIRE(grouped.OutputWidth() == convolution.OutputWidth());
+    REQUIRE(grouped.OutputHeight() == convolution.OutputHeight());
+    CheckMatrices(output, convolutionOutput, 1e-8);
+
+    arma::mat error(output.n_rows, output.n_cols, arma::fill::randu);
+    arma::mat delta, convolutionDelta;
+    grouped.Backward(input, error, delta);
+    convolution.Backward(input, error, convolutionDelta);
+    CheckMatrices(delta, convolutionDelta, 1e-8);
+
+    arma::mat gradient, convolutionGradient;
+    grouped.Gradient(input, error, gradient);
+    convolution.Gradient(input, error, convolutionGradient);
+    REQUIRE(gradient.n_elem == grouped.Parameters().n_elem);
+    for (size_t o = 0; o < 8; ++o)
+    {
+      const size_t group = o / (8 / groups);
+      for (size_t m = 0; m < 4 / groups; ++m)
+      {
+        const size_t slice = o * (4 / groups) + m;
+        const size_t convolutionSlice = o * 4 + group * (4 / groups) + m;
+        CheckMatrices(gradient.rows(slice * k * k, (slice + 1) * k * k - 1),
+            convolutionGradient.rows(convolutionSlice * k * k,
+            (convolutionSlice + 1) * k * k - 1), 1e-8);
+      }
+    }
+    CheckMatrices(gradient.tail_rows(8), convolutionGradient.tail_rows(8),
+        1e-8);
+  }
+
+  REQUIRE_THROWS_AS(GroupedConvolution<>(4, 6, 4, 3, 3),
+      std::invalid_argument);
+}
+
+/**
+ * Depthwise-separable convolution (a depthwise and a pointwise
+ * GroupedConvolution) numerical gradient test.
+ */
+TEST_CASE("GradientGroupedConvolutionLayerTest", "[ANNLayerTest]")
+{
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(50, 1);
+      target = arma::mat("1");
+
+      model = new FFN<NegativeLogLikelihood<>, RandomInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<GroupedConvolution<> >(2, 4, 2, 3, 3, 2, 2, 1, 1, 5, 5);
+      model->Add<GroupedConvolution<> >(4, 2, 1, 1, 1, 1, 1, 0, 0, 3, 3);
+      model->Add<Linear<> >(18, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, RandomInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
+/**
+ * Simple serialization test for the GroupedConvolution layer.
+ */
+TEST_CASE("GroupedConvolutionSerializationTest", "[ANNLayerTest]")
+{
+  // A depthwise convolution of two maps of 5x1 elements.
+  GroupedConvolution<> layer(2, 2, 2, 3, 1, 1, 1, 1, 0, 5, 1);
+  ANNLayerSerializationTest(layer);
+}
@@ -11,6 +11,8 @@
  */
 
 #include <mlpack/core/data/load.hpp>
+#include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/chunked_loader.hpp>
 #include <mlpack/methods/bayesian_linear_regression/bayesian_linear_regression.hpp>
 #include <mlpack/methods/linear_regression/linear_regression.hpp>
 
@@ -193,3 +195,57 @@ TEST_CASE("EqualtoRidge", "[BayesianLinearRegressionTest]")
 
   REQUIRE(trial <= 3);
 }
+
+// Check that a model trained on statistics accumulated over the chunks of a
+// file is the same as a model trained on the whole file.
+TEST_CASE("AccumulateChunks", "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+  GenerateProblem(matX, y, 250, 10, 0.5);
+  matX.each_col() += arma::randu<arma::colvec>(10);
+
+  // The responses are the last dimension of the file.
+  REQUIRE(data::Save("blr_chunks.csv", arma::mat(arma::join_cols(matX, y))));
+  arma::mat dataset;
+  REQUIRE(data::Load("blr_chunks.csv", dataset));
+  matX = dataset.rows(0, 9);
+  y = dataset.row(10);
+
+  for (size_t options = 0; options < 4; ++options)
+  {
+    const bool center = (options & 1), scale = (options & 2);
+    BayesianLinearRegression blr(center, scale), blrChunks(center, scale);
+    blr.Train(matX, y);
+
+    data::ChunkedLoader<double> loader("blr_chunks.csv", 37);
+    arma::mat chunk;
+    while (loader.Next(chunk))
+    {
+      blrChunks.Accumulate(chunk.rows(0, chunk.n_rows - 2),
+          chunk.row(chunk.n_rows - 1));
+    }
+    REQUIRE(blrChunks.NumPoints() == 250);
+    const double rmse = blrChunks.Train();
+
+    REQUIRE(rmse == Approx(blr.RMSE(matX, y)).epsilon(1e-6));
+    REQUIRE(blrChunks.Alpha() == Approx(blr.Alpha()).epsilon(1e-6));
+    REQUIRE(blrChunks.Beta() == Approx(blr.Beta()).epsilon(1e-6));
+    REQUIRE(blrChunks.DataOffset().n_elem == blr.DataOffset().n_elem);
+    REQUIRE(blrChunks.DataScale().n_elem == blr.DataScale().n_elem);
+    REQUIRE(blrChunks.ResponsesOffset() ==
+        Approx(blr.ResponsesOffset()).margin(1e-10));
+    for (size_t i = 0; i < 10; ++i)
+      REQUIRE(blrChunks.Omega()(i) == Approx(blr.Omega()(i)).epsilon(1e-6));
+
+    // Statistics of a wrong dimensionality are rejected.
+    REQUIRE_THROWS_AS(blrChunks.Accumulate(matX.rows(0, 8), y),
+        std::invalid_argument);
+
+    blrChunks.ResetStatistics();
+    REQUIRE(blrChunks.NumPoints() == 0);
+    REQUIRE_THROWS_AS(blrChunks.Train(), std::invalid_argument);
+  }
+
+  remove("blr_chunks.csv");
+}
@@ -106,3 +106,34 @@ TEST_CASE("RandomizedBlockKrylovSVDNoisyLowRankTest", "[BlockKrylovSVDTest]")
   double error = arma::max(arma::abs(s1.subvec(0, rank) - s2.subvec(0, rank)));
   REQUIRE(error == Approx(0.0).margin(1e-4));
 }
+
+/**
+ * The decomposition of sparse data should match the decomposition of the same
+ * data in dense form.
+ */
+TEST_CASE("RandomizedBlockKrylovSVDSparseTest", "[BlockKrylovSVDTest]")
+{
+  // Sparse data of rank 3.
+  arma::sp_mat left, right;
+  left.sprandu(60, 3, 0.5);
+  right.sprandu(3, 150, 0.3);
+  arma::sp_mat data = left * right;
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, arma::mat(data));
+
+  svd::RandomizedBlockKrylovSVD rSVD(2, 5);
+  rSVD.Apply(data, U2, s2, V2, 3);
+
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(s2[i] == Approx(s1[i]).epsilon(1e-5));
+
+  arma::mat reconstruct = U2.cols(0, 2) * arma::diagmat(s2.subvec(0, 2)) *
+      V2.cols(0, 2).t();
+  const double error = arma::norm(arma::mat(data) - reconstruct, "frob") /
+      arma::norm(arma::mat(data), "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-7));
+}
+
@@ -13,8 +13,10 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/cf/cf.hpp>
+#include <mlpack/methods/cf/decomposition_policies/als_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/batch_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
+#include <mlpack/methods/cf/decomposition_policies/compact_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/regularized_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/svd_complete_method.hpp>
@@ -1228,4 +1230,326 @@ BOOST_AUTO_TEST_CASE(CFPredictRegressionInterpolation)
             RegressionInterpolation>(2.0);
 }
 
+/**
+ * Make sure that the recommendations found with FastMKS are the best-rated
+ * un-rated items, as found by GetRecommendations().
+ */
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization>
+void GetRecommendationsFastMKS()
+{
+  DecompositionPolicy decomposition;
+  const size_t numRecs = 5;
+
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy, NormalizationType> c(dataset, decomposition,
+      5, 5, 30);
+
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0, 29, 30);
+  arma::Mat<size_t> recommendations, fastRecommendations;
+  c.GetRecommendations(numRecs, recommendations, users);
+  c.GetRecommendationsFastMKS(numRecs, fastRecommendations, users);
+
+  BOOST_REQUIRE_EQUAL(fastRecommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(fastRecommendations.n_cols, users.n_elem);
+
+  // Compare the predicted ratings, so that ties don't matter.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(c.CleanedData()(fastRecommendations(j, i),
+          users(i)), 0.0);
+      BOOST_REQUIRE_CLOSE(c.Predict(users(i), fastRecommendations(j, i)),
+          c.Predict(users(i), recommendations(j, i)), 1e-5);
+    }
+  }
+
+  // Getting the recommendations of all users should give the same results.
+  c.GetRecommendationsFastMKS(numRecs, fastRecommendations);
+  BOOST_REQUIRE_EQUAL(fastRecommendations.n_cols, c.CleanedData().n_cols);
+}
+
+/**
+ * Make sure that FastMKS recommendations are the best recommendations for NMF.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsFastMKSNMFTest)
+{
+  GetRecommendationsFastMKS<NMFPolicy>();
+}
+
+/**
+ * Make sure that FastMKS recommendations are the best recommendations when the
+ * decomposition has biases and the normalization depends on the item.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsFastMKSBiasSVDTest)
+{
+  GetRecommendationsFastMKS<BiasSVDPolicy, ItemMeanNormalization>();
+}
+
+/**
+ * Make sure that FastMKS recommendations are the best recommendations with
+ * z-score and combined normalizations.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsFastMKSNormalizationTest)
+{
+  GetRecommendationsFastMKS<RegSVDPolicy, ZScoreNormalization>();
+  GetRecommendationsFastMKS<RegSVDPolicy, CombinedNormalization<
+      OverallMeanNormalization, UserMeanNormalization,
+      ItemMeanNormalization>>();
+}
+
+/**
+ * Make sure that correct number of recommendations are generated for ALS.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsAllUsersALSTest)
+{
+  GetRecommendationsAllUsers<ALSPolicy>();
+}
+
+/**
+ * Make sure that Predict() is returning reasonable results for ALS.
+ */
+BOOST_AUTO_TEST_CASE(CFPredictALSTest)
+{
+  CFPredict<ALSPolicy>();
+}
+
+/**
+ * Ensure we can load and save the CF model using ALS.
+ */
+BOOST_AUTO_TEST_CASE(SerializationALSTest)
+{
+  Serialization<ALSPolicy>();
+}
+
+/**
+ * Make sure that FastMKS recommendations are the best recommendations for ALS.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsFastMKSALSTest)
+{
+  GetRecommendationsFastMKS<ALSPolicy>();
+}
+
+/**
+ * Make sure that ALS with implicit feedback recommends items that were not
+ * rated.
+ */
+BOOST_AUTO_TEST_CASE(CFImplicitALSTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  ALSPolicy als(0.1, true, 10.0);
+  CFType<ALSPolicy, NoNormalization> c(dataset, als, 5, 5, 30);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().Implicit(), true);
+
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(5, recommendations);
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, c.CleanedData().n_cols);
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+  {
+    for (size_t j = 0; j < recommendations.n_rows; ++j)
+    {
+      BOOST_REQUIRE_LT(recommendations(j, i), c.CleanedData().n_rows);
+      BOOST_REQUIRE_EQUAL(c.CleanedData()(recommendations(j, i), i), 0.0);
+    }
+  }
+}
+
+/**
+ * Train a model without the users with the highest IDs, then fold their
+ * ratings in (except one rating of each user), and make sure the held out
+ * ratings are predicted reasonably well.
+ */
+template<typename DecompositionPolicy,
+         typename NormalizationType = OverallMeanNormalization>
+void FoldIn(const double rmseBound = 1.5)
+{
+  DecompositionPolicy decomposition;
+
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  const size_t firstNewUser = (size_t) (0.8 * arma::max(dataset.row(0)));
+  const arma::uvec oldRatings = arma::find(dataset.row(0) < firstNewUser);
+  const arma::uvec newRatings = arma::find(dataset.row(0) >= firstNewUser);
+  const arma::mat trainData = dataset.cols(oldRatings);
+  arma::mat foldInData = dataset.cols(newRatings);
+
+  // Hold out the first rating of each new user that has a few ratings, if the
+  // item is in the training set.
+  arma::Col<size_t> userRatings((size_t) arma::max(dataset.row(0)) + 1,
+      arma::fill::zeros);
+  for (size_t i = 0; i < foldInData.n_cols; ++i)
+    ++userRatings[(size_t) foldInData(0, i)];
+  std::set<size_t> trainItems;
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    trainItems.insert((size_t) trainData(1, i));
+
+  std::set<size_t> seenUsers;
+  arma::mat savedCols(3, 0);
+  for (size_t i = 0; i < foldInData.n_cols; ++i)
+  {
+    const size_t user = (size_t) foldInData(0, i);
+    const size_t item = (size_t) foldInData(1, i);
+    if (userRatings[user] >= 5 && trainItems.count(item) == 1 &&
+        seenUsers.count(user) == 0)
+    {
+      seenUsers.insert(user);
+      savedCols.insert_cols(savedCols.n_cols, foldInData.col(i));
+      foldInData.shed_col(i);
+      --i;
+    }
+  }
+
+  CFType<DecompositionPolicy,
+      NormalizationType> c(trainData, decomposition, 5, 5, 30);
+  const size_t oldItems = c.CleanedData().n_rows;
+
+  c.FoldIn(foldInData);
+
+  const size_t numUsers = (size_t) arma::max(foldInData.row(0)) + 1;
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers);
+  BOOST_REQUIRE_GE(c.CleanedData().n_rows, oldItems);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_nonzero,
+      trainData.n_cols + foldInData.n_cols);
+
+  double totalError = 0.0;
+  for (size_t i = 0; i < savedCols.n_cols; ++i)
+  {
+    const double prediction = c.Predict(savedCols(0, i), savedCols(1, i));
+    BOOST_REQUIRE(std::isfinite(prediction));
+    totalError += std::pow(prediction - savedCols(2, i), 2.0);
+  }
+
+  const double rmse = std::sqrt(totalError / savedCols.n_cols);
+  BOOST_REQUIRE_LT(rmse, rmseBound);
+
+  // Recommendations must be available for the new users.
+  arma::Col<size_t> users(savedCols.n_cols);
+  for (size_t i = 0; i < savedCols.n_cols; ++i)
+    users[i] = (size_t) savedCols(0, i);
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(10, recommendations, users);
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, users.n_elem);
+}
+
+/**
+ * Make sure that new users can be folded into a model trained with NMF.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInNMFTest)
+{
+  FoldIn<NMFPolicy>();
+}
+
+/**
+ * Make sure that new users can be folded into a model trained with
+ * regularized SVD.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInRegSVDTest)
+{
+  FoldIn<RegSVDPolicy, UserMeanNormalization>();
+}
+
+/**
+ * Make sure that new users can be folded into a model trained with BiasSVD.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInBiasSVDTest)
+{
+  FoldIn<BiasSVDPolicy>();
+}
+
+/**
+ * Make sure that new users can be folded into a model trained with SVD++.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInSVDPPTest)
+{
+  FoldIn<SVDPlusPlusPolicy>();
+}
+
+/**
+ * Make sure that UserMeanNormalization keeps the means of the existing users
+ * and computes the means of the new users when folding in new ratings.
+ */
+BOOST_AUTO_TEST_CASE(UserMeanNormalizationFoldInTest)
+{
+  arma::mat data = { { 0, 0, 1 },
+                     { 0, 1, 1 },
+                     { 2, 4, 3 } };
+  UserMeanNormalization normalization;
+  normalization.Normalize(data);
+
+  arma::mat newData = { { 1, 2, 2 },
+                        { 2, 0, 1 },
+                        { 5, 1, 2 } };
+  normalization.FoldIn(newData);
+
+  BOOST_REQUIRE_EQUAL(normalization.Mean().n_elem, 3);
+  BOOST_REQUIRE_CLOSE(normalization.Mean()[0], 3.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(normalization.Mean()[1], 3.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(normalization.Mean()[2], 1.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(newData(2, 0), 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(newData(2, 1), -0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(newData(2, 2), 0.5, 1e-5);
+}
+
+/**
+ * Make sure that correct number of recommendations are generated with the
+ * single precision factors of CompactPolicy.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsAllUsersCompactTest)
+{
+  GetRecommendationsAllUsers<CompactPolicy<NMFPolicy>>();
+  GetRecommendationsAllUsers<CompactPolicy<BiasSVDPolicy>>();
+}
+
+/**
+ * Make sure that Predict() is returning reasonable results with the single
+ * precision factors of CompactPolicy.
+ */
+BOOST_AUTO_TEST_CASE(CFPredictCompactTest)
+{
+  CFPredict<CompactPolicy<NMFPolicy>>();
+  CFPredict<CompactPolicy<RegSVDPolicy>>();
+}
+
+/**
+ * Make sure that the predictions of CompactPolicy match the predictions of the
+ * policy it was trained with, up to single precision.
+ */
+BOOST_AUTO_TEST_CASE(CompactPolicyMatchesTrainedPolicyTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  arma::sp_mat cleanedData;
+  CFType<>::CleanData(dataset, cleanedData);
+
+  // Train both models from the same seed, so that they have the same factors.
+  math::RandomSeed(42);
+  BiasSVDPolicy bias;
+  bias.Apply(dataset, cleanedData, 5, 10, 1e-5, true);
+
+  math::RandomSeed(42);
+  CompactPolicy<BiasSVDPolicy> compact;
+  compact.Apply(dataset, cleanedData, 5, 10, 1e-5, true);
+
+  BOOST_REQUIRE_EQUAL(compact.UserFactors().n_cols, cleanedData.n_cols);
+  BOOST_REQUIRE_EQUAL(compact.ItemFactors().n_cols, cleanedData.n_rows);
+
+  for (size_t user = 0; user < cleanedData.n_cols; user += 7)
+  {
+    for (size_t item = 0; item < cleanedData.n_rows; item += 13)
+    {
+      BOOST_REQUIRE_SMALL(bias.GetRating(user, item) -
+          compact.GetRating(user, item), 1e-3);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,223 @@
+/**
+ * @file tests/compact_model_test.cpp
+ *
+ * Tests for the compact model export and the CompactModel predictor.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/compact_model/compact_export.hpp>
+#include <mlpack/methods/compact_model/compact_model.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "mock_categorical_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::compact;
+using namespace mlpack::regression;
+using namespace mlpack::svm;
+using namespace mlpack::tree;
+
+/**
+ * Make sure that the compact model gives the given predictions and
+ * probabilities (or scores) for the given points.
+ */
+void CheckCompactModel(const CompactModel& model,
+                       const arma::mat& data,
+                       const arma::Row<size_t>& predictions,
+                       const arma::mat& probabilities)
+{
+  BOOST_REQUIRE_EQUAL(model.NumClasses(), probabilities.n_rows);
+
+  arma::vec pointProbabilities(model.NumClasses());
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(model.Classify(data.colptr(i)), predictions[i]);
+    BOOST_REQUIRE_EQUAL(model.Classify(data.colptr(i),
+        pointProbabilities.memptr()), predictions[i]);
+    for (size_t c = 0; c < model.NumClasses(); ++c)
+    {
+      BOOST_REQUIRE_CLOSE(pointProbabilities[c] + 1.0,
+          probabilities(c, i) + 1.0, 1e-8);
+    }
+  }
+}
+
+/**
+ * Create a dataset of four Gaussian classes.
+ */
+void GaussianClasses(arma::mat& data, arma::Row<size_t>& labels)
+{
+  data.randn(5, 1000);
+  labels.set_size(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    labels[i] = i % 4;
+    data(labels[i], i) += 2.0;
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(CompactModelTest);
+
+/**
+ * A compact decision tree gives the same predictions and probabilities as the
+ * tree, with categorical and numeric splits.
+ */
+BOOST_AUTO_TEST_CASE(CompactDecisionTreeTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  const arma::mat trainingData = d.cols(0, 1999);
+  const arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  DecisionTree<> tree(trainingData, di, trainingLabels, 5, 5);
+  ExportCompact("compact_tree.bin", tree);
+  CompactModel model("compact_tree.bin");
+  remove("compact_tree.bin");
+
+  BOOST_REQUIRE_EQUAL(model.Kind(), TREES);
+  BOOST_REQUIRE_EQUAL(model.NumTrees(), 1);
+
+  const arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  tree.Classify(testData, predictions, probabilities);
+  CheckCompactModel(model, testData, predictions, probabilities);
+}
+
+/**
+ * A compact random forest gives the same predictions and probabilities as the
+ * forest.
+ */
+BOOST_AUTO_TEST_CASE(CompactRandomForestTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GaussianClasses(data, labels);
+
+  RandomForest<> rf(data, labels, 4, 20 /* 20 trees */, 3);
+  ExportCompact("compact_forest.bin", rf);
+  CompactModel model("compact_forest.bin");
+  remove("compact_forest.bin");
+
+  BOOST_REQUIRE_EQUAL(model.NumTrees(), 20);
+  BOOST_REQUIRE_LE(model.Dimensionality(), 5);
+
+  arma::mat testData;
+  arma::Row<size_t> testLabels;
+  GaussianClasses(testData, testLabels);
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  rf.Classify(testData, predictions, probabilities);
+  CheckCompactModel(model, testData, predictions, probabilities);
+}
+
+/**
+ * Compact linear models give the same predictions and probabilities (or
+ * scores) as logistic regression, softmax regression and linear SVMs.
+ */
+BOOST_AUTO_TEST_CASE(CompactLinearModelsTest)
+{
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  GaussianClasses(data, labels);
+  GaussianClasses(testData, testLabels);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+
+  // Logistic regression: is the class 0 or not?
+  const arma::Row<size_t> binaryLabels =
+      arma::conv_to<arma::Row<size_t>>::from(labels == 0);
+  LogisticRegression<> lr(data, binaryLabels, 0.001);
+  ExportCompact("compact_lr.bin", lr);
+  CompactModel lrModel("compact_lr.bin");
+  remove("compact_lr.bin");
+  BOOST_REQUIRE_EQUAL(lrModel.Link(), SIGMOID);
+  lr.Classify(testData, predictions);
+  lr.Classify(testData, probabilities);
+  CheckCompactModel(lrModel, testData, predictions, probabilities);
+
+  // Softmax regression, with and without intercept.
+  for (size_t fitIntercept = 0; fitIntercept < 2; ++fitIntercept)
+  {
+    SoftmaxRegression sr(data, labels, 4, 0.001, fitIntercept == 1);
+    ExportCompact("compact_sr.bin", sr);
+    CompactModel srModel("compact_sr.bin");
+    remove("compact_sr.bin");
+    BOOST_REQUIRE_EQUAL(srModel.Link(), SOFTMAX);
+    sr.Classify(testData, predictions, probabilities);
+    CheckCompactModel(srModel, testData, predictions, probabilities);
+  }
+
+  // Linear SVMs, with and without intercept.
+  for (size_t fitIntercept = 0; fitIntercept < 2; ++fitIntercept)
+  {
+    LinearSVM<> svm(data, labels, 4, 0.001, 1.0, fitIntercept == 1);
+    ExportCompact("compact_svm.bin", svm);
+    CompactModel svmModel("compact_svm.bin");
+    remove("compact_svm.bin");
+    BOOST_REQUIRE_EQUAL(svmModel.Link(), IDENTITY);
+    svm.Classify(testData, predictions, probabilities);
+    CheckCompactModel(svmModel, testData, predictions, probabilities);
+  }
+}
+
+/**
+ * Invalid or truncated models are rejected.
+ */
+BOOST_AUTO_TEST_CASE(CompactModelInvalidTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GaussianClasses(data, labels);
+
+  RandomForest<> rf(data, labels, 4, 5 /* 5 trees */, 3);
+  ExportCompact("compact_invalid.bin", rf);
+
+  std::ifstream stream("compact_invalid.bin", std::ios::binary);
+  const std::string contents((std::istreambuf_iterator<char>(stream)),
+      std::istreambuf_iterator<char>());
+  stream.close();
+  remove("compact_invalid.bin");
+
+  CompactModel model;
+  model.Load(contents.data(), contents.size());
+  BOOST_REQUIRE_EQUAL(model.NumTrees(), 5);
+
+  // Every truncation must be detected.
+  for (size_t size = 0; size < contents.size(); size += 7)
+  {
+    BOOST_REQUIRE_THROW(model.Load(contents.data(), size),
+        std::runtime_error);
+  }
+
+  // The model is left unchanged by a failed load.
+  BOOST_REQUIRE_EQUAL(model.NumTrees(), 5);
+
+  // A child index out of the model is detected.
+  std::string corrupted = contents;
+  CompactNode root;
+  const size_t rootOffset = sizeof(CompactHeader) + 5 * sizeof(uint64_t);
+  std::memcpy(&root, &corrupted[rootOffset], sizeof(root));
+  root.child = 1000000;
+  std::memcpy(&corrupted[rootOffset], &root, sizeof(root));
+  BOOST_REQUIRE_THROW(model.Load(corrupted.data(), corrupted.size()),
+      std::runtime_error);
+
+  // So is a file of another kind.
+  corrupted = contents;
+  corrupted[0] = 'X';
+  BOOST_REQUIRE_THROW(model.Load(corrupted.data(), corrupted.size()),
+      std::runtime_error);
+
+  BOOST_REQUIRE_THROW(model.Load("compact_missing.bin"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
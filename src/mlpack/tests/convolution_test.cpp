@@ -16,6 +16,9 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/winograd_convolution.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
 
 #include "serialization_catch.hpp"
 #include "catch.hpp"
@@ -148,6 +151,14 @@ TEST_CASE("ValidConvolution2DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution as a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
+
+  // Perform the convolution with the Winograd minimal filtering algorithm.
+  Convolution2DMethodTest<WinogradConvolution<ValidConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -185,6 +196,14 @@ TEST_CASE("FullConvolution2DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution as a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
+
+  // Perform the convolution with the Winograd minimal filtering algorithm.
+  Convolution2DMethodTest<WinogradConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -230,6 +249,14 @@ TEST_CASE("ValidConvolution3DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution as a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
+
+  // Perform the convolution with the Winograd minimal filtering algorithm.
+  Convolution3DMethodTest<WinogradConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -279,6 +306,14 @@ TEST_CASE("FullConvolution3DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution as a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
+
+  // Perform the convolution with the Winograd minimal filtering algorithm.
+  Convolution3DMethodTest<WinogradConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -321,6 +356,14 @@ TEST_CASE("ValidConvolutionBatchTest", "[ConvolutionTest]")
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution as a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
+
+  // Perform the convolution with the Winograd minimal filtering algorithm.
+  ConvolutionMethodBatchTest<WinogradConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -367,4 +410,135 @@ TEST_CASE("FullConvolutionBatchTest", "[ConvolutionTest]")
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution as a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+
+  // Perform the convolution with the Winograd minimal filtering algorithm.
+  ConvolutionMethodBatchTest<WinogradConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+}
+
+/**
+ * Make sure that the im2col and Winograd convolutions give the same results as
+ * the naive convolution, also for strides, dilations and odd output sizes.
+ */
+TEST_CASE("Im2ColWinogradMatchNaiveTest", "[ConvolutionTest]")
+{
+  for (size_t filterSize = 1; filterSize <= 4; ++filterSize)
+  {
+    for (size_t inputRows = 7; inputRows <= 8; ++inputRows)
+    {
+      arma::mat input(inputRows, inputRows + 2, arma::fill::randn);
+      arma::mat filter(filterSize, filterSize, arma::fill::randn);
+
+      for (size_t stride = 1; stride <= 2; ++stride)
+      {
+        for (size_t dilation = 1; dilation <= 2; ++dilation)
+        {
+          arma::mat naiveOutput, im2colOutput, winogradOutput;
+          NaiveConvolution<ValidConvolution>::Convolution(input, filter,
+              naiveOutput, stride, stride, dilation, dilation);
+          Im2ColConvolution<ValidConvolution>::Convolution(input, filter,
+              im2colOutput, stride, stride, dilation, dilation);
+          WinogradConvolution<ValidConvolution>::Convolution(input, filter,
+              winogradOutput, stride, stride, dilation, dilation);
+
+          CheckMatrices(naiveOutput, im2colOutput);
+          CheckMatrices(naiveOutput, winogradOutput);
+
+          NaiveConvolution<FullConvolution>::Convolution(input, filter,
+              naiveOutput, stride, stride, dilation, dilation);
+          Im2ColConvolution<FullConvolution>::Convolution(input, filter,
+              im2colOutput, stride, stride, dilation, dilation);
+          WinogradConvolution<FullConvolution>::Convolution(input, filter,
+              winogradOutput, stride, stride, dilation, dilation);
+
+          CheckMatrices(naiveOutput, im2colOutput);
+          CheckMatrices(naiveOutput, winogradOutput);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that MapConvolution() gives the sums of the naive convolutions of
+ * each input map, for each output map.
+ */
+TEST_CASE("MapConvolutionTest", "[ConvolutionTest]")
+{
+  const size_t inMaps = 3;
+  const size_t outMaps = 4;
+
+  for (size_t filterSize = 2; filterSize <= 3; ++filterSize)
+  {
+    arma::cube input(9, 8, inMaps, arma::fill::randn);
+    arma::cube filter(filterSize, filterSize, inMaps * outMaps,
+        arma::fill::randn);
+
+    for (size_t stride = 1; stride <= 2; ++stride)
+    {
+      arma::cube im2colOutput, winogradOutput;
+      Im2ColConvolution<ValidConvolution>::MapConvolution(input, filter,
+          im2colOutput, stride, stride);
+      WinogradConvolution<ValidConvolution>::MapConvolution(input, filter,
+          winogradOutput, stride, stride);
+
+      REQUIRE(im2colOutput.n_slices == outMaps);
+      REQUIRE(winogradOutput.n_slices == outMaps);
+      for (size_t o = 0; o < outMaps; ++o)
+      {
+        arma::mat expected, convOutput;
+        for (size_t m = 0; m < inMaps; ++m)
+        {
+          NaiveConvolution<ValidConvolution>::Convolution(input.slice(m),
+              filter.slice(o * inMaps + m), convOutput, stride, stride);
+          if (m == 0)
+            expected = convOutput;
+          else
+            expected += convOutput;
+        }
+
+        CheckMatrices(expected, im2colOutput.slice(o));
+        CheckMatrices(expected, winogradOutput.slice(o));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the Convolution layer gives the same output with the
+ * im2col and Winograd rules, which convolve all maps at once, as with the
+ * naive rule.
+ */
+TEST_CASE("ConvolutionLayerMapConvolutionTest", "[ConvolutionTest]")
+{
+  Convolution<> naive(2, 3, 3, 3, 1, 1, 1, 1, 7, 6);
+  Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution> > im2col(2, 3, 3, 3, 1, 1, 1, 1, 7,
+      6);
+  Convolution<WinogradConvolution<ValidConvolution>,
+      WinogradConvolution<FullConvolution>,
+      WinogradConvolution<ValidConvolution> > winograd(2, 3, 3, 3, 1, 1, 1, 1,
+      7, 6);
+
+  arma::mat parameters(naive.Parameters().n_elem, 1, arma::fill::randn);
+  naive.Parameters() = parameters;
+  im2col.Parameters() = parameters;
+  winograd.Parameters() = parameters;
+  naive.Reset();
+  im2col.Reset();
+  winograd.Reset();
+
+  arma::mat input(7 * 6 * 2, 5, arma::fill::randn);
+  arma::mat naiveOutput, im2colOutput, winogradOutput;
+  naive.Forward(input, naiveOutput);
+  im2col.Forward(input, im2colOutput);
+  winograd.Forward(input, winogradOutput);
+
+  CheckMatrices(naiveOutput, im2colOutput);
+  CheckMatrices(naiveOutput, winogradOutput);
 }
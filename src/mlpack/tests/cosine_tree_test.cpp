@@ -162,6 +162,32 @@ BOOST_AUTO_TEST_CASE(CosineNodeCosineSplit)
   }
 }
 
+/**
+ * Checks that the centroids of the children of a large node, which are summed
+ * in parallel, are the means of their columns.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeChildCentroids)
+{
+  arma::mat data = arma::randu(20, 10000);
+  CosineTree root(data);
+  BOOST_REQUIRE_SMALL(arma::norm(root.Centroid() - arma::mean(data, 1)),
+      1e-10);
+
+  root.CosineNodeSplit();
+  BOOST_REQUIRE(root.Left() != NULL);
+  BOOST_REQUIRE(root.Right() != NULL);
+
+  for (CosineTree* child : { root.Left(), root.Right() })
+  {
+    const arma::uvec indices = arma::conv_to<arma::uvec>::from(
+        child->VectorIndices());
+    const arma::vec centroid = arma::mean(data.cols(indices), 1);
+    BOOST_REQUIRE_SMALL(arma::norm(child->Centroid() - centroid), 1e-10);
+    BOOST_REQUIRE_CLOSE(child->FrobNormSquared(),
+        arma::accu(arma::square(data.cols(indices))), 1e-8);
+  }
+}
+
 /**
  * Checks CosineTree::ModifiedGramSchmidt() by creating a random basis for the
  * vector subspace and checking if all the vectors are orthogonal to each other.
@@ -27,17 +27,20 @@
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
+#include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/lars/lars.hpp>
 #include <mlpack/methods/linear_regression/linear_regression.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 #include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
 #include <mlpack/methods/softmax_regression/softmax_regression.hpp>
 #include <mlpack/core/data/confusion_matrix.hpp>
 #include <ensmallen.hpp>
 
 #include "catch.hpp"
 #include "mock_categorical_data.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -484,6 +487,37 @@ TEST_CASE("KFoldCVMSETest", "[CVTest]")
   REQUIRE_NOTHROW(cv.Model());
 }
 
+/**
+ * Test that cross-validation trains on the requested fraction of the training
+ * data.
+ */
+TEST_CASE("CVTrainingFractionTest", "[CVTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 40);
+  arma::rowvec responses = arma::randu<arma::rowvec>(3) * data +
+      0.1 * arma::randn<arma::rowvec>(40);
+
+  // The first 20 points are the training set, so half of it is the first 10
+  // points.
+  SimpleCV<LinearRegression, MSE> cv(0.5, data, responses);
+  cv.TrainingFraction() = 0.5;
+  const double simpleMSE = cv.Evaluate();
+
+  LinearRegression lr(data.cols(0, 9), responses.cols(0, 9));
+  REQUIRE(simpleMSE == Approx(MSE::Evaluate(lr, data.cols(20, 39),
+      responses.cols(20, 39))).epsilon(1e-7));
+  CheckMatrices(cv.Model().Parameters(), lr.Parameters());
+
+  // The second fold of 2-fold cross-validation trains on the second half of
+  // the data.
+  KFoldCV<LinearRegression, MSE> kfoldcv(2, data, responses, false);
+  kfoldcv.TrainingFraction() = 0.5;
+  kfoldcv.Evaluate();
+
+  LinearRegression lr2(data.cols(20, 29), responses.cols(20, 29));
+  CheckMatrices(kfoldcv.Model().Parameters(), lr2.Parameters());
+}
+
 /**
  * Test k-fold cross-validation with the Accuracy metric.
  */
@@ -744,6 +778,33 @@ TEST_CASE("KFoldCVWithDTTestUnevenBinsWeighted", "[CVTest]")
   REQUIRE(accuracy > 0.7);
 }
 
+/**
+ * Make sure that k-fold cross-validation of a random forest gives the same
+ * score for the same random seed, whether or not the folds are trained in
+ * parallel.
+ */
+TEST_CASE("KFoldCVRandomForestReproducibleTest", "[CVTest]")
+{
+  arma::mat data(4, 400, arma::fill::randu);
+  arma::Row<size_t> labels =
+      arma::conv_to<arma::Row<size_t>>::from(data.row(0) + data.row(1) > 1.0);
+
+  // Two serial runs, then two parallel runs.
+  arma::vec scores(4);
+  for (size_t run = 0; run < 4; ++run)
+  {
+    math::RandomSeed(42);
+    KFoldCV<RandomForest<GiniGain, RandomDimensionSelect>, Accuracy> cv(5,
+        data, labels, 2);
+    cv.Parallel() = (run >= 2);
+    scores[run] = cv.Evaluate(10 /* numTrees */, 3 /* minimumLeafSize */);
+  }
+
+  REQUIRE(scores[0] > 0.7);
+  for (size_t run = 1; run < 4; ++run)
+    REQUIRE(scores[run] == scores[0]);
+}
+
 /**
  * Test Silhouette Score
  */
@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/dbscan/dbscan.hpp>
 #include <mlpack/methods/dbscan/random_point_selection.hpp>
+#include <mlpack/methods/dbscan/hdbscan.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -309,4 +310,111 @@ BOOST_AUTO_TEST_CASE(RandomPointSelectionTest)
   BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
 }
 
+/**
+ * Check that the parallel mode finds the same clusters as the batch mode, up to
+ * the numbering of the clusters.
+ */
+BOOST_AUTO_TEST_CASE(ParallelClusterTest)
+{
+  arma::mat points(3, 3000);
+  GaussianDistribution g1("0.0 0.0 0.0", arma::eye<arma::mat>(3, 3)),
+                       g2("6.0 6.0 8.0", arma::eye<arma::mat>(3, 3)),
+                       g3("-6.0 1.0 -7.0", arma::eye<arma::mat>(3, 3));
+  for (size_t i = 0; i < 1000; ++i)
+    points.col(i) = g1.Random();
+  for (size_t i = 1000; i < 2000; ++i)
+    points.col(i) = g2.Random();
+  for (size_t i = 2000; i < 3000; ++i)
+    points.col(i) = g3.Random();
+
+  DBSCAN<> d(0.5, 5);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  RangeSearch<> rs(false, true);
+  rs.ParallelQueries() = true;
+  DBSCAN<> pd(0.5, 5, true, rs, OrderedPointSelection(), true);
+  arma::Row<size_t> parallelAssignments;
+  const size_t parallelClusters = pd.Cluster(points, parallelAssignments);
+
+  BOOST_REQUIRE_EQUAL(parallelClusters, clusters);
+  BOOST_REQUIRE_EQUAL(parallelAssignments.n_elem, points.n_cols);
+
+  // Each cluster must map to exactly one cluster of the other clustering.
+  arma::Col<size_t> map(clusters), reverseMap(clusters);
+  map.fill(SIZE_MAX);
+  reverseMap.fill(SIZE_MAX);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    if (assignments[i] == SIZE_MAX)
+    {
+      BOOST_REQUIRE_EQUAL(parallelAssignments[i], SIZE_MAX);
+      continue;
+    }
+
+    BOOST_REQUIRE_NE(parallelAssignments[i], SIZE_MAX);
+    if (map[assignments[i]] == SIZE_MAX)
+      map[assignments[i]] = parallelAssignments[i];
+    if (reverseMap[parallelAssignments[i]] == SIZE_MAX)
+      reverseMap[parallelAssignments[i]] = assignments[i];
+
+    BOOST_REQUIRE_EQUAL(map[assignments[i]], parallelAssignments[i]);
+    BOOST_REQUIRE_EQUAL(reverseMap[parallelAssignments[i]], assignments[i]);
+  }
+}
+
+/**
+ * Make sure that HDBSCAN* finds three well-separated Gaussians in uniform
+ * noise, without any radius parameter.
+ */
+BOOST_AUTO_TEST_CASE(HDBSCANGaussiansTest)
+{
+  arma::mat points(3, 930);
+  GaussianDistribution g1("0.0 0.0 0.0", arma::eye<arma::mat>(3, 3)),
+                       g2("10.0 10.0 12.0", arma::eye<arma::mat>(3, 3)),
+                       g3("-10.0 2.0 -11.0", arma::eye<arma::mat>(3, 3));
+  for (size_t i = 0; i < 300; ++i)
+    points.col(i) = g1.Random();
+  for (size_t i = 300; i < 600; ++i)
+    points.col(i) = g2.Random();
+  for (size_t i = 600; i < 900; ++i)
+    points.col(i) = g3.Random();
+  // Sparse noise in a large box.
+  points.cols(900, 929) = 60.0 * arma::randu<arma::mat>(3, 30) - 30.0;
+
+  HDBSCAN<> h(5, 20);
+  arma::Row<size_t> assignments;
+  const size_t clusters = h.Cluster(points, assignments);
+
+  BOOST_REQUIRE_EQUAL(clusters, 3);
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
+
+  // Each Gaussian must be mostly in its own cluster; the other points of the
+  // Gaussian can only be noise.
+  arma::Row<size_t> matches(3);
+  for (size_t g = 0; g < 3; ++g)
+  {
+    arma::Col<size_t> counts(clusters, arma::fill::zeros);
+    for (size_t i = 300 * g; i < 300 * (g + 1); ++i)
+      if (assignments[i] != SIZE_MAX)
+        counts[assignments[i]]++;
+
+    matches[g] = counts.index_max();
+    BOOST_REQUIRE_GT(counts[matches[g]], 250);
+    for (size_t i = 300 * g; i < 300 * (g + 1); ++i)
+    {
+      BOOST_REQUIRE(assignments[i] == matches[g] ||
+          assignments[i] == SIZE_MAX);
+    }
+  }
+
+  BOOST_REQUIRE_NE(matches[0], matches[1]);
+  BOOST_REQUIRE_NE(matches[1], matches[2]);
+  BOOST_REQUIRE_NE(matches[2], matches[0]);
+
+  // The condensed tree has one edge per point and per non-root cluster.
+  BOOST_REQUIRE_EQUAL(h.CondensedTree().n_rows, 4);
+  BOOST_REQUIRE_GE(h.CondensedTree().n_cols, points.n_cols + 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
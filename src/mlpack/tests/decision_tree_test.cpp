@@ -1251,3 +1251,276 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Check that two trees have the same structure and the same splits.
+ */
+template<typename TreeType1, typename TreeType2>
+void CheckSameTree(const TreeType1& t1, const TreeType2& t2)
+{
+  REQUIRE(t1.NumChildren() == t2.NumChildren());
+  if (t1.NumChildren() == 0)
+    return;
+
+  REQUIRE(t1.SplitDimension() == t2.SplitDimension());
+  for (size_t i = 0; i < t1.NumChildren(); ++i)
+    CheckSameTree(t1.Child(i), t2.Child(i));
+}
+
+/**
+ * Make sure that the PresortedBinaryNumericSplit builds the same trees as the
+ * BestBinaryNumericSplit, with and without weights, including with many ties.
+ */
+TEST_CASE("PresortedBinaryNumericSplitTest", "[DecisionTreeTest]")
+{
+  arma::mat data(5, 1000, arma::fill::randn);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    labels[i] = i % 3;
+    data.col(i) += 1.5 * labels[i];
+  }
+  // Round two dimensions, so that there are many equal values.
+  data.row(1) = arma::round(data.row(1));
+  data.row(3) = arma::round(2 * data.row(3));
+  const arma::rowvec weights(1000, arma::fill::randu);
+
+  DecisionTree<> tree(data, labels, 3, 5);
+  DecisionTree<GiniGain, PresortedBinaryNumericSplit> presortedTree(data,
+      labels, 3, 5);
+  CheckSameTree(tree, presortedTree);
+
+  arma::Row<size_t> predictions, presortedPredictions;
+  tree.Classify(data, predictions);
+  presortedTree.Classify(data, presortedPredictions);
+  REQUIRE(arma::accu(predictions != presortedPredictions) == 0);
+
+  DecisionTree<InformationGain> weightedTree(data, labels, 3, weights, 10);
+  DecisionTree<InformationGain, PresortedBinaryNumericSplit>
+      presortedWeightedTree(data, labels, 3, weights, 10);
+  CheckSameTree(weightedTree, presortedWeightedTree);
+
+  weightedTree.Classify(data, predictions);
+  presortedWeightedTree.Classify(data, presortedPredictions);
+  REQUIRE(arma::accu(predictions != presortedPredictions) == 0);
+}
+
+/**
+ * Make sure that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when each distinct value gets its own bin.
+ */
+TEST_CASE("HistogramNumericSplitSameAsBestTest", "[DecisionTreeTest]")
+{
+  arma::vec values(1000);
+  arma::Row<size_t> labels(1000);
+  arma::rowvec weights(1000, arma::fill::randu);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    values[i] = math::RandInt(100);
+    labels[i] = (values[i] + math::RandInt(30) > 60) ? 1 : 0;
+  }
+
+  arma::vec classProbabilities, histogramClassProbabilities;
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo<double> aux;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo<double> histogramAux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, histogramClassProbabilities, histogramAux);
+
+  REQUIRE(gain > bestGain);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramClassProbabilities.n_elem == 1);
+  REQUIRE(histogramClassProbabilities[0] == Approx(classProbabilities[0]));
+
+  const double bestWeightedGain = GiniGain::Evaluate<true>(labels, 2, weights);
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(bestWeightedGain,
+      values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double histogramWeightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestWeightedGain,
+      values, labels, 2, weights, 3, 1e-7, histogramClassProbabilities,
+      histogramAux);
+
+  REQUIRE(histogramWeightedGain == Approx(weightedGain).epsilon(1e-7));
+  REQUIRE(histogramClassProbabilities[0] == Approx(classProbabilities[0]));
+}
+
+/**
+ * Make sure that a DecisionTree with the HistogramNumericSplit fits separable
+ * data about as well as with the BestBinaryNumericSplit.
+ */
+TEST_CASE("HistogramNumericSplitTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat data(4, 2000, arma::fill::randn);
+  arma::Row<size_t> labels(2000);
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    labels[i] = i % 4;
+    data(labels[i], i) += 4.0;
+  }
+
+  DecisionTree<GiniGain, HistogramNumericSplit> tree(data, labels, 4, 10);
+  arma::Row<size_t> predictions;
+  tree.Classify(data, predictions);
+
+  const double accuracy = arma::accu(predictions == labels) / 2000.0;
+  REQUIRE(accuracy > 0.95);
+
+  // Training with type information uses the histogram split too.
+  data::DatasetInfo info(4);
+  DecisionTree<GiniGain, HistogramNumericSplit> infoTree(data, info, labels, 4,
+      10);
+  infoTree.Classify(data, predictions);
+  REQUIRE(arma::accu(predictions == labels) / 2000.0 > 0.95);
+}
+
+/**
+ * Make sure that the bins of a dataset hold about the same number of points
+ * each, and that the histograms of a part of the dataset can be computed by
+ * subtraction.
+ */
+TEST_CASE("HistogramBinsTest", "[DecisionTreeTest]")
+{
+  arma::mat data(3, 10000, arma::fill::randn);
+  // The second dimension has few distinct values, which get a bin each.
+  data.row(1) = arma::round(4 * data.row(1));
+  arma::Row<size_t> labels(10000);
+  for (size_t i = 0; i < 10000; ++i)
+    labels[i] = i % 2;
+  const arma::rowvec weights(10000, arma::fill::randu);
+
+  HistogramBins<double> bins;
+  bins.Quantize(data, 0, 10000, 256);
+  const arma::uvec distinct = arma::find_unique(data.row(1));
+  for (size_t d = 0; d < 3; ++d)
+  {
+    for (size_t i = 0; i < 10000; ++i)
+    {
+      const size_t bin = bins.Bins()(d, i);
+      REQUIRE(data(d, i) >= bins.BinMin()(bin, d));
+      REQUIRE(data(d, i) <= bins.BinMax()(bin, d));
+    }
+  }
+
+  arma::cube histograms;
+  bins.Histograms<false>(labels, 2, weights, 0, 10000, histograms);
+  REQUIRE(histograms.n_rows == 3);
+  REQUIRE(histograms.n_cols == 256);
+  REQUIRE(histograms.n_slices == 3);
+  REQUIRE(arma::accu(histograms.slice(1).row(2) > 0) == distinct.n_elem);
+  // No bin of a continuous dimension holds much more than its share.
+  REQUIRE(arma::max(histograms.slice(0).row(2)) <= 2 * 10000 / 256);
+
+  arma::cube left, right;
+  bins.Histograms<true>(labels, 2, weights, 0, 10000, histograms);
+  bins.Histograms<true>(labels, 2, weights, 0, 3000, left);
+  bins.Histograms<true>(labels, 2, weights, 3000, 7000, right);
+  REQUIRE(arma::approx_equal(histograms - left, right, "absdiff", 1e-8));
+}
+
+/**
+ * Make sure that a DecisionTree with the HistogramNumericSplit, which
+ * quantizes the whole dataset, builds the same tree as with the
+ * BestBinaryNumericSplit when each dimension has at most 256 distinct values.
+ */
+TEST_CASE("HistogramNumericSplitSameTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat data(4, 5000, arma::fill::randn);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    labels[i] = i % 3;
+    data.col(i) += 1.5 * labels[i];
+  }
+  data = arma::round(10 * data);
+
+  DecisionTree<> tree(data, labels, 3, 5);
+  DecisionTree<GiniGain, HistogramNumericSplit> histogramTree(data, labels, 3,
+      5);
+  CheckSameTree(tree, histogramTree);
+
+  arma::Row<size_t> predictions, histogramPredictions;
+  tree.Classify(data, predictions);
+  histogramTree.Classify(data, histogramPredictions);
+  REQUIRE(arma::accu(predictions != histogramPredictions) == 0);
+
+  // With weights, the histograms of the children are subtracted in floating
+  // point, so only check that the trees are about as good.
+  const arma::rowvec weights(5000, arma::fill::randu);
+  DecisionTree<InformationGain> weightedTree(data, labels, 3, weights, 10);
+  DecisionTree<InformationGain, HistogramNumericSplit>
+      histogramWeightedTree(data, labels, 3, weights, 10);
+  weightedTree.Classify(data, predictions);
+  histogramWeightedTree.Classify(data, histogramPredictions);
+  const double accuracy = arma::accu(predictions == labels) / 5000.0;
+  const double histogramAccuracy =
+      arma::accu(histogramPredictions == labels) / 5000.0;
+  REQUIRE(histogramAccuracy == Approx(accuracy).epsilon(0.02));
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that building the nodes of a large tree in parallel gives the same
+ * tree as building them with one thread, with and without type information.
+ */
+TEST_CASE("ParallelDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat data(5, 20000, arma::fill::randn);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    labels[i] = i % 3;
+    data(labels[i], i) += 1.5;
+  }
+  data::DatasetInfo info(5);
+
+  DecisionTree<> tree(data, labels, 3, 5);
+  DecisionTree<> infoTree(data, info, labels, 3, 5);
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  DecisionTree<> sequentialTree(data, labels, 3, 5);
+  DecisionTree<> sequentialInfoTree(data, info, labels, 3, 5);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckSameTree(tree, sequentialTree);
+  CheckSameTree(infoTree, sequentialInfoTree);
+}
+#endif
+
+/**
+ * Make sure that the FlatDecisionTree classifies like the DecisionTree it packs,
+ * with numeric and categorical splits.
+ */
+TEST_CASE("FlatDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  DecisionTree<> tree(d, di, l, 5, 10);
+  FlatDecisionTree flatTree(tree);
+  REQUIRE(flatTree.NumClasses() == 5);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  tree.Classify(d, predictions, probabilities);
+  flatTree.Classify(d, flatPredictions, flatProbabilities);
+
+  REQUIRE(arma::accu(predictions != flatPredictions) == 0);
+  REQUIRE(arma::accu(probabilities != flatProbabilities) == 0);
+  for (size_t i = 0; i < d.n_cols; ++i)
+    REQUIRE(flatTree.Classify(d.col(i)) == predictions[i]);
+
+  // A tree that is only a leaf gives one node.
+  DecisionTree<> leaf(d, di, l, 5, d.n_cols);
+  FlatDecisionTree flatLeaf(leaf);
+  REQUIRE(flatLeaf.Nodes().size() == 1);
+  REQUIRE(flatLeaf.NumLeaves() == 1);
+  REQUIRE(flatLeaf.Classify(d.col(0)) == leaf.Classify(d.col(0)));
+}
@@ -349,6 +349,42 @@ BOOST_AUTO_TEST_CASE(TestComputeValue)
   BOOST_REQUIRE_CLOSE(0.0, testDTree.ComputeValue(q4), 1e-10);
 }
 
+// Grow a tree large enough to be grown in parallel, and make sure the points
+// are still mapped to their original indices and that the batched density
+// estimates are the same as the density estimates of each point.
+BOOST_AUTO_TEST_CASE(TestLargeGrowAndComputeValues)
+{
+  arma::mat dataset(3, 20000, arma::fill::randn);
+  arma::mat testData(dataset);
+
+  arma::Col<size_t> oTest(testData.n_cols);
+  for (size_t i = 0; i < oTest.n_elem; ++i)
+    oTest[i] = i;
+
+  DTree<arma::mat> testDTree(testData);
+  testDTree.Grow(testData, oTest, false, 10, 5);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    for (size_t d = 0; d < testData.n_rows; ++d)
+      BOOST_REQUIRE_EQUAL(testData(d, i), dataset(d, oTest[i]));
+  }
+
+  // Include some points outside of the range of the tree.
+  arma::mat queries(3, 3000, arma::fill::randn);
+  queries *= 3.0;
+
+  arma::vec values;
+  testDTree.ComputeValue(queries, values);
+
+  BOOST_REQUIRE_EQUAL(values.n_elem, queries.n_cols);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.col(i);
+    BOOST_REQUIRE_CLOSE(values[i], testDTree.ComputeValue(query), 1e-10);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestVariableImportance)
 {
   arma::mat testData(3, 5);
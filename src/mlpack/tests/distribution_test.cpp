@@ -443,6 +443,30 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
   BOOST_REQUIRE_CLOSE(phis(5), -14.900192463287908, 1e-5);
 }
 
+/**
+ * Make sure the batched log-probabilities and probabilities match the ones
+ * computed one point at a time, for a larger random Gaussian.
+ */
+BOOST_AUTO_TEST_CASE(GaussianBatchedProbabilityTest)
+{
+  arma::mat cov = arma::randu<arma::mat>(10, 10);
+  cov = cov * cov.t() + 0.5 * arma::eye<arma::mat>(10, 10);
+  GaussianDistribution g(arma::randu<arma::vec>(10), cov);
+
+  arma::mat points = 2.0 * arma::randn<arma::mat>(10, 1000);
+  arma::vec logProbs, probs;
+  g.LogProbability(points, logProbs);
+  g.Probability(points, probs);
+
+  BOOST_REQUIRE_EQUAL(logProbs.n_elem, 1000);
+  BOOST_REQUIRE_EQUAL(probs.n_elem, 1000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbs[i], g.LogProbability(points.col(i)), 1e-5);
+    BOOST_REQUIRE_CLOSE(probs[i], g.Probability(points.col(i)), 1e-5);
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
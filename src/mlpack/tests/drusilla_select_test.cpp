@@ -167,4 +167,27 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
 }
 
+// Make sure DrusillaSelect gives the same results with single-precision data as
+// with double-precision data.
+BOOST_AUTO_TEST_CASE(FloatTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 100);
+  arma::fmat floatDataset = arma::conv_to<arma::fmat>::from(dataset);
+
+  // With one point in each projection, every point is a candidate.
+  DrusillaSelect<> ds(dataset, 100, 1);
+  DrusillaSelect<arma::fmat> floatDs(floatDataset, 100, 1);
+
+  arma::mat distances, floatDistances;
+  arma::Mat<size_t> neighbors, floatNeighbors;
+  ds.Search(dataset, 3, neighbors, distances);
+  floatDs.Search(floatDataset, 3, floatNeighbors, floatDistances);
+
+  BOOST_REQUIRE_EQUAL(floatNeighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(floatNeighbors.n_cols, 100);
+
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(floatDistances[i], distances[i], 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
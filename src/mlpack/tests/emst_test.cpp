@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/single_linkage.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -278,4 +279,214 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Make sure that parallel Boruvka rounds give the same MST as the serial
+ * algorithm, with trees and in naive mode.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  DualTreeBoruvka<> dtbNaive(inputData, true);
+  arma::mat naiveResults;
+  dtbNaive.ComputeMST(naiveResults);
+
+  DualTreeBoruvka<> dtb(inputData);
+  dtb.Parallel() = true;
+  arma::mat dualResults;
+  dtb.ComputeMST(dualResults);
+
+  DualTreeBoruvka<> dtbParallelNaive(inputData, true);
+  dtbParallelNaive.Parallel() = true;
+  arma::mat parallelNaiveResults;
+  dtbParallelNaive.ComputeMST(parallelNaiveResults);
+
+  DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+      ct(inputData);
+  ct.Parallel() = true;
+  arma::mat coverResults;
+  ct.ComputeMST(coverResults);
+
+  BOOST_REQUIRE_EQUAL(dualResults.n_cols, naiveResults.n_cols);
+  BOOST_REQUIRE_EQUAL(parallelNaiveResults.n_cols, naiveResults.n_cols);
+  BOOST_REQUIRE_EQUAL(coverResults.n_cols, naiveResults.n_cols);
+  for (size_t i = 0; i < naiveResults.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(dualResults(0, i), naiveResults(0, i));
+    BOOST_REQUIRE_EQUAL(dualResults(1, i), naiveResults(1, i));
+    BOOST_REQUIRE_CLOSE(dualResults(2, i), naiveResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(parallelNaiveResults(0, i), naiveResults(0, i));
+    BOOST_REQUIRE_EQUAL(parallelNaiveResults(1, i), naiveResults(1, i));
+    BOOST_REQUIRE_CLOSE(parallelNaiveResults(2, i), naiveResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(coverResults(0, i), naiveResults(0, i));
+    BOOST_REQUIRE_EQUAL(coverResults(1, i), naiveResults(1, i));
+    BOOST_REQUIRE_CLOSE(coverResults(2, i), naiveResults(2, i), 1e-5);
+  }
+}
+
+/**
+ * Make sure that the parallel dual-tree traverser of the kd-tree can run a
+ * Boruvka round: in the first round, the candidate edge of each point is its
+ * nearest neighbor.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeTraverserRoundTest)
+{
+  arma::mat inputData = arma::randu<arma::mat>(3, 1000);
+
+  typedef KDTree<EuclideanDistance, DTBStat, arma::mat> TreeType;
+  typedef ParallelDTBRules<EuclideanDistance, TreeType> RuleType;
+
+  TreeType tree(inputData, 5);
+  const arma::mat& data = tree.Dataset();
+  const size_t n = data.n_cols;
+
+  arma::Col<size_t> components(n);
+  for (size_t i = 0; i < n; ++i)
+    components[i] = i;
+  std::vector<std::atomic<double>> componentBounds(n);
+  for (size_t i = 0; i < n; ++i)
+    componentBounds[i].store(DBL_MAX);
+  arma::vec pointDistances(n);
+  pointDistances.fill(DBL_MAX);
+  arma::Col<size_t> pointNeighbors(n);
+  EuclideanDistance metric;
+  const arma::vec coreDistances;
+
+  RuleType rules(data, components, componentBounds, pointDistances,
+      pointNeighbors, metric, coreDistances);
+  TreeType::ParallelDualTreeTraverser<RuleType> traverser(rules, 4);
+  traverser.Traverse(tree, tree);
+
+  BOOST_REQUIRE_GT(rules.BaseCases(), 0);
+  for (size_t i = 0; i < n; ++i)
+  {
+    double nearest = DBL_MAX;
+    for (size_t j = 0; j < n; ++j)
+    {
+      if (j != i)
+        nearest = std::min(nearest, metric.Evaluate(data.col(i), data.col(j)));
+    }
+
+    BOOST_REQUIRE_CLOSE(pointDistances[i], nearest, 1e-5);
+    BOOST_REQUIRE_CLOSE(metric.Evaluate(data.col(i),
+        data.col(pointNeighbors[i])), nearest, 1e-5);
+  }
+}
+
+/**
+ * Check the single-linkage clustering of a small one-dimensional dataset.
+ */
+BOOST_AUTO_TEST_CASE(SingleLinkageTest)
+{
+  // The points 0, 1, 3 and 7, in a different order.
+  arma::mat inputData("3 0 7 1");
+
+  DualTreeBoruvka<> dtb(inputData);
+  arma::mat mst;
+  dtb.ComputeMST(mst);
+
+  arma::mat linkage;
+  SingleLinkage(mst, linkage);
+
+  BOOST_REQUIRE_EQUAL(linkage.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(linkage.n_cols, 3);
+
+  // Points 1 and 3 (0 and 1) merge first into cluster 4.
+  BOOST_REQUIRE_EQUAL(linkage(0, 0), 1);
+  BOOST_REQUIRE_EQUAL(linkage(1, 0), 3);
+  BOOST_REQUIRE_CLOSE(linkage(2, 0), 1.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 0), 2);
+
+  // Then point 0 (3) joins cluster 4, to make cluster 5.
+  BOOST_REQUIRE_EQUAL(linkage(0, 1), 0);
+  BOOST_REQUIRE_EQUAL(linkage(1, 1), 4);
+  BOOST_REQUIRE_CLOSE(linkage(2, 1), 2.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 1), 3);
+
+  // Finally point 2 (7) joins cluster 5.
+  BOOST_REQUIRE_EQUAL(linkage(0, 2), 2);
+  BOOST_REQUIRE_EQUAL(linkage(1, 2), 5);
+  BOOST_REQUIRE_CLOSE(linkage(2, 2), 4.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 2), 4);
+
+  // A set of edges with a cycle is not a spanning tree.
+  arma::mat cycle("0 1 0; 1 2 2; 1.0 1.0 2.0");
+  BOOST_REQUIRE_THROW(SingleLinkage(cycle, linkage), std::invalid_argument);
+}
+
+/**
+ * Make sure that the mutual reachability spanning tree computed with trees has
+ * the same length as the one computed in naive mode, and that its edges have
+ * the mutual reachability distance.
+ */
+BOOST_AUTO_TEST_CASE(MutualReachabilityTest)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  // Use the distance to the fifth nearest neighbor as core distance.
+  arma::vec coreDistances(inputData.n_cols);
+  for (size_t i = 0; i < inputData.n_cols; ++i)
+  {
+    arma::vec distances(inputData.n_cols);
+    for (size_t j = 0; j < inputData.n_cols; ++j)
+    {
+      distances[j] = EuclideanDistance::Evaluate(inputData.col(i),
+          inputData.col(j));
+    }
+    coreDistances[i] = arma::sort(distances)[5];
+  }
+
+  DualTreeBoruvka<> dtbNaive(inputData, true);
+  arma::mat naiveResults;
+  dtbNaive.ComputeMST(naiveResults, coreDistances);
+
+  DualTreeBoruvka<> dtb(inputData);
+  arma::mat dualResults;
+  dtb.ComputeMST(dualResults, coreDistances);
+
+  DualTreeBoruvka<> dtbParallel(inputData);
+  dtbParallel.Parallel() = true;
+  arma::mat parallelResults;
+  dtbParallel.ComputeMST(parallelResults, coreDistances);
+
+  DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+      ct(inputData);
+  arma::mat coverResults;
+  ct.ComputeMST(coverResults, coreDistances);
+
+  // Many edges have the same length (a core distance), so only the total
+  // lengths can be compared.
+  const double naiveLength = arma::accu(naiveResults.row(2));
+  BOOST_REQUIRE_CLOSE(arma::accu(dualResults.row(2)), naiveLength, 1e-5);
+  BOOST_REQUIRE_CLOSE(arma::accu(parallelResults.row(2)), naiveLength, 1e-5);
+  BOOST_REQUIRE_CLOSE(arma::accu(coverResults.row(2)), naiveLength, 1e-5);
+
+  // The MST of the metric is shorter.
+  DualTreeBoruvka<> euclideanDtb(inputData);
+  arma::mat euclideanResults;
+  euclideanDtb.ComputeMST(euclideanResults);
+  BOOST_REQUIRE_LT(arma::accu(euclideanResults.row(2)), naiveLength);
+
+  for (size_t i = 0; i < dualResults.n_cols; ++i)
+  {
+    const size_t a = (size_t) dualResults(0, i);
+    const size_t b = (size_t) dualResults(1, i);
+    const double distance = std::max(EuclideanDistance::Evaluate(
+        inputData.col(a), inputData.col(b)),
+        std::max(coreDistances[a], coreDistances[b]));
+    BOOST_REQUIRE_CLOSE(dualResults(2, i), distance, 1e-5);
+  }
+
+  // The number of core distances must match the number of points.
+  arma::vec wrongCoreDistances(10, arma::fill::ones);
+  BOOST_REQUIRE_THROW(dtbNaive.ComputeMST(naiveResults, wrongCoreDistances),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
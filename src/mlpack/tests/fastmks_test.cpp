@@ -127,6 +127,52 @@ BOOST_AUTO_TEST_CASE(DualTreeVsSingleTree)
   }
 }
 
+/**
+ * Compare parallel naive and dual-tree search (with the batched kernel
+ * evaluations of naive search) with serial single-tree search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelQueriesTest)
+{
+  // First create random datasets.
+  arma::mat referenceData, queryData;
+  referenceData.randu(8, 5000);
+  queryData.randu(8, 700);
+  PolynomialKernel pk(3.0, 1.5);
+
+  FastMKS<PolynomialKernel> single(referenceData, pk, true);
+
+  arma::Mat<size_t> singleIndices;
+  arma::mat singleProducts;
+  single.Search(queryData, 10, singleIndices, singleProducts);
+
+  // Now run it in parallel naive mode.
+  FastMKS<PolynomialKernel> naive(referenceData, pk, false, true);
+  naive.ParallelQueries() = true;
+
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveProducts;
+  naive.Search(queryData, 10, naiveIndices, naiveProducts);
+
+  // And in parallel dual-tree mode.
+  FastMKS<PolynomialKernel> tree(referenceData, pk);
+  tree.ParallelQueries() = true;
+
+  arma::Mat<size_t> treeIndices;
+  arma::mat treeProducts;
+  tree.Search(queryData, 10, treeIndices, treeProducts);
+
+  for (size_t q = 0; q < singleIndices.n_cols; ++q)
+  {
+    for (size_t r = 0; r < singleIndices.n_rows; ++r)
+    {
+      BOOST_REQUIRE_EQUAL(naiveIndices(r, q), singleIndices(r, q));
+      BOOST_REQUIRE_CLOSE(naiveProducts(r, q), singleProducts(r, q), 1e-5);
+      BOOST_REQUIRE_EQUAL(treeIndices(r, q), singleIndices(r, q));
+      BOOST_REQUIRE_CLOSE(treeProducts(r, q), singleProducts(r, q), 1e-5);
+    }
+  }
+}
+
 /**
  * Test sparse FastMKS (how useful is this, I'm not sure).
  */
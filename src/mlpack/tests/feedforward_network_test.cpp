@@ -14,7 +14,13 @@
 
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/ann/loss_functions/softmax_cross_entropy.hpp>
+#include <mlpack/methods/ann/save_checkpoint.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
+#include <mlpack/methods/ann/onnx/onnx.hpp>
+#include <mlpack/methods/ann/distributed/distributed_optimizer.hpp>
+#include <mlpack/methods/ann/quantization/quantized_ffn.hpp>
 #include <mlpack/methods/kmeans/kmeans.hpp>
 
 #include <ensmallen.hpp>
@@ -700,3 +706,1125 @@ TEST_CASE("RBFNetworkTest", "[FeedForwardNetworkTest]")
   // RBFN neural net with MeanSquaredError.
   TestNetwork<>(model1, dataset, labels1, dataset, labels, 10, 0.1);
 }
+
+/**
+ * Make sure that batched predictions match the predictions of one point at a
+ * time, and that the results buffer is reused when it has the right size.
+ */
+TEST_CASE("FFBatchPredictTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 103);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  REQUIRE(predictions.n_rows == 3);
+  REQUIRE(predictions.n_cols == 103);
+
+  arma::mat batchPredictions(3, 103);
+  const double* memory = batchPredictions.memptr();
+  model.Predict(data, batchPredictions, 16);
+  REQUIRE(batchPredictions.memptr() == memory);
+  CheckMatrices(predictions, batchPredictions);
+
+  // A batch larger than the dataset, on an aliased view of the data.
+  const arma::mat view(data.memptr(), data.n_rows, data.n_cols, false, true);
+  model.Predict(view, batchPredictions, 500);
+  CheckMatrices(predictions, batchPredictions);
+
+  REQUIRE_THROWS_AS(model.Predict(data, batchPredictions, 0),
+      std::invalid_argument);
+}
+
+/**
+ * Train a network with the layers fixed at compile time on the thyroid
+ * dataset.
+ */
+TEST_CASE("StaticFFNVanillaNetworkTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > model(
+      Linear<>(trainData.n_rows, 8), SigmoidLayer<>(), Linear<>(8, 3),
+      LogSoftMax<>());
+
+  TestNetwork<>(model, trainData, trainLabels, testData, testLabels, 10, 0.1);
+}
+
+/**
+ * Make sure that a StaticFFN and an FFN with the same layers and weights give
+ * the same predictions, and that copies of a StaticFFN own their weights.
+ */
+TEST_CASE("StaticFFNMatchesFFNTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 50) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Dropout<>, Linear<>, LogSoftMax<> > staticModel(
+      Linear<>(10, 8), SigmoidLayer<>(), Dropout<>(), Linear<>(8, 3),
+      LogSoftMax<>());
+  staticModel.ResetParameters();
+  REQUIRE(staticModel.Parameters().n_elem == model.Parameters().n_elem);
+  REQUIRE(staticModel.Offset(3) == 88);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat staticPredictions;
+  staticModel.Predict(data, staticPredictions, 16);
+  CheckMatrices(predictions, staticPredictions);
+  REQUIRE(staticModel.Evaluate(data, labels) ==
+      Approx(model.Evaluate(data, labels)).epsilon(1e-7));
+
+  // The copy must not change when the original is changed.
+  StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Dropout<>, Linear<>, LogSoftMax<> > copy(staticModel);
+  staticModel.Parameters().zeros();
+
+  arma::mat copyPredictions;
+  copy.Predict(data, copyPredictions);
+  CheckMatrices(predictions, copyPredictions);
+}
+
+/**
+ * Make sure that a network with the SoftmaxCrossEntropy output layer has the
+ * objective and the gradient of the same network with a LogSoftMax layer and
+ * the NegativeLogLikelihood output layer, and that a StaticFFN can be trained
+ * with it.
+ */
+TEST_CASE("FFNSoftmaxCrossEntropyTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 50) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  FFN<SoftmaxCrossEntropy<> > fusedModel;
+  fusedModel.Add<Linear<> >(10, 8);
+  fusedModel.Add<SigmoidLayer<> >();
+  fusedModel.Add<Linear<> >(8, 3);
+  fusedModel.Predictors() = data;
+  fusedModel.Responses() = labels;
+  fusedModel.ResetParameters();
+  fusedModel.Parameters() = model.Parameters();
+
+  // LogSoftMax approximates the exponential function.
+  arma::mat gradient, fusedGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 50);
+  const double fusedObjective = fusedModel.EvaluateWithGradient(
+      fusedModel.Parameters(), 0, fusedGradient, 50);
+  REQUIRE(fusedObjective == Approx(objective).epsilon(1e-4));
+  REQUIRE(arma::abs(gradient - fusedGradient).max() <= 1e-3);
+
+  // Train on the thyroid dataset.
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  StaticFFN<SoftmaxCrossEntropy<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<> > staticModel(Linear<>(trainData.n_rows, 8),
+      SigmoidLayer<>(), Linear<>(8, 3));
+  TestNetwork<>(staticModel, trainData, trainLabels, testData, testLabels, 10,
+      0.1);
+}
+
+/**
+ * Make sure that the SaveCheckpoint callback saves a network that can be
+ * loaded, and gives the training data back to the network.
+ */
+TEST_CASE("FFNSaveCheckpointTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat trainData = arma::randu<arma::mat>(10, 100);
+  arma::mat trainLabels = arma::floor(arma::randu<arma::mat>(1, 100) * 2) + 1;
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 2);
+  model.Add<LogSoftMax<> >();
+
+  ens::StandardSGD opt(0.01, 10, 5 * trainData.n_cols);
+  model.Train(trainData, trainLabels, opt,
+      SaveCheckpoint<FFN<NegativeLogLikelihood<> > >(model,
+      "ffn_checkpoint.mlb", 2));
+
+  // The points may have been shuffled.
+  REQUIRE(model.Predictors().n_cols == trainData.n_cols);
+  REQUIRE(arma::accu(model.Predictors()) ==
+      Approx(arma::accu(trainData)).epsilon(1e-10));
+  REQUIRE(arma::accu(model.Responses()) == arma::accu(trainLabels));
+
+  FFN<NegativeLogLikelihood<> > loaded;
+  REQUIRE(data::Load("ffn_checkpoint.mlb", "model", loaded, false) == true);
+  REQUIRE(loaded.Parameters().n_elem == model.Parameters().n_elem);
+
+  arma::mat predictions;
+  loaded.Predict(trainData, predictions);
+  REQUIRE(predictions.n_rows == 2);
+  REQUIRE(predictions.n_cols == trainData.n_cols);
+
+  remove("ffn_checkpoint.mlb");
+}
+
+/**
+ * Make sure that splitting a batch across threads gives the same objective and
+ * gradient as evaluating it at once, and that a network can be trained that
+ * way.
+ */
+TEST_CASE("FFParallelEvaluateWithGradientTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+  arma::mat labels = arma::ones<arma::mat>(1, 50);
+  labels.cols(25, 49).fill(2);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 2);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  arma::mat gradient, parallelGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 3,
+      gradient, 41);
+
+  model.Parallel() = true;
+  const double parallelObjective = model.EvaluateWithGradient(
+      model.Parameters(), 3, parallelGradient, 41);
+
+  REQUIRE(parallelObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(gradient, parallelGradient);
+
+  // The workers must follow changes of the parameters.
+  model.Parameters() *= 2;
+  model.Parallel() = false;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 50);
+  model.Parallel() = true;
+  model.EvaluateWithGradient(model.Parameters(), 0, parallelGradient, 50);
+  CheckMatrices(gradient, parallelGradient);
+
+  // The loss of MeanSquaredError is averaged over the points, so it must not
+  // be summed over the parts of the batch.
+  FFN<MeanSquaredError<> > mseModel;
+  mseModel.Add<Linear<> >(10, 8);
+  mseModel.Add<SigmoidLayer<> >();
+  mseModel.Add<Linear<> >(8, 1);
+
+  mseModel.Predictors() = data;
+  mseModel.Responses() = labels;
+  mseModel.ResetParameters();
+
+  const double mseObjective = mseModel.EvaluateWithGradient(
+      mseModel.Parameters(), 3, gradient, 41);
+  mseModel.Parallel() = true;
+  const double parallelMSEObjective = mseModel.EvaluateWithGradient(
+      mseModel.Parameters(), 3, parallelGradient, 41);
+
+  REQUIRE(parallelMSEObjective == Approx(mseObjective).epsilon(1e-7));
+  CheckMatrices(gradient, parallelGradient);
+
+  // Train a network in parallel mode on the thyroid dataset.
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  FFN<NegativeLogLikelihood<> > thyroidModel;
+  thyroidModel.Add<Linear<> >(trainData.n_rows, 8);
+  thyroidModel.Add<SigmoidLayer<> >();
+  thyroidModel.Add<Linear<> >(8, 3);
+  thyroidModel.Add<LogSoftMax<> >();
+  thyroidModel.Parallel() = true;
+
+  TestNetwork<>(thyroidModel, trainData, trainLabels, testData, testLabels, 10,
+      0.1);
+}
+
+/**
+ * Train a StaticFFN in single precision on the thyroid dataset, and make sure
+ * that it predicts like the same network in double precision.
+ */
+TEST_CASE("StaticFFNFloatTest", "[FeedForwardNetworkTest]")
+{
+  arma::fmat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::fmat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::fmat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::fmat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  typedef StaticFFN<NegativeLogLikelihood<arma::fmat, arma::fmat>,
+      RandomInitialization, Linear<arma::fmat, arma::fmat>,
+      SigmoidLayer<arma::fmat, arma::fmat>, Linear<arma::fmat, arma::fmat>,
+      LogSoftMax<arma::fmat, arma::fmat> > FloatNetwork;
+  static_assert(std::is_same<FloatNetwork::ElemType, float>::value,
+      "The element type of the network must be float.");
+
+  FloatNetwork model(Linear<arma::fmat, arma::fmat>(trainData.n_rows, 8),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(8, 3),
+      LogSoftMax<arma::fmat, arma::fmat>());
+
+  TestNetwork<arma::fmat>(model, trainData, trainLabels, testData, testLabels,
+      10, 0.1);
+
+  // The same weights in double precision.
+  StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > doubleModel(
+      Linear<>(trainData.n_rows, 8), SigmoidLayer<>(), Linear<>(8, 3),
+      LogSoftMax<>());
+  doubleModel.ResetParameters();
+  doubleModel.Parameters() = arma::conv_to<arma::mat>::from(
+      model.Parameters());
+
+  arma::fmat predictions;
+  arma::mat doublePredictions;
+  model.Predict(testData, predictions);
+  doubleModel.Predict(arma::conv_to<arma::mat>::from(testData),
+      doublePredictions);
+
+  REQUIRE(arma::approx_equal(arma::conv_to<arma::mat>::from(predictions),
+      doublePredictions, "absdiff", 1e-3));
+}
+
+/**
+ * Train a StaticFFN in single precision with double-precision master weights
+ * and dynamic loss scaling, and make sure that the loss scale is unscaled from
+ * the gradient and lowered when the gradient overflows.
+ */
+TEST_CASE("StaticFFNMasterWeightsTest", "[FeedForwardNetworkTest]")
+{
+  arma::fmat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::fmat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::fmat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::fmat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  typedef StaticFFN<NegativeLogLikelihood<arma::fmat, arma::fmat>,
+      RandomInitialization, Linear<arma::fmat, arma::fmat>,
+      SigmoidLayer<arma::fmat, arma::fmat>, Linear<arma::fmat, arma::fmat>,
+      LogSoftMax<arma::fmat, arma::fmat> > FloatNetwork;
+
+  FloatNetwork model(Linear<arma::fmat, arma::fmat>(trainData.n_rows, 8),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(8, 3),
+      LogSoftMax<arma::fmat, arma::fmat>());
+
+  ens::RMSProp opt(0.01, 32, 0.88, 1e-8, 10 * trainData.n_cols, -1);
+  model.TrainWithMasterWeights(trainData, trainLabels, opt, 1024.0, 100);
+  REQUIRE(model.LossScale() == 1.0);
+
+  arma::fmat predictionTemp;
+  model.Predict(testData, predictionTemp);
+  arma::fmat prediction = arma::zeros<arma::fmat>(1, predictionTemp.n_cols);
+  for (size_t i = 0; i < predictionTemp.n_cols; ++i)
+  {
+    prediction(i) = arma::as_scalar(arma::find(
+        arma::max(predictionTemp.col(i)) == predictionTemp.col(i), 1)) + 1;
+  }
+
+  const size_t correct = arma::accu(prediction == testLabels);
+  REQUIRE(1 - double(correct) / testData.n_cols <= 0.1);
+
+  // The gradient with a loss scale is the same as without.
+  const arma::mat master = arma::conv_to<arma::mat>::from(model.Parameters());
+  arma::mat gradient, scaledGradient;
+  MasterWeightsFunction<FloatNetwork> function(model);
+  const double objective = function.EvaluateWithGradient(master, 0, gradient,
+      32);
+
+  MasterWeightsFunction<FloatNetwork> scaledFunction(model, 1024.0, 100);
+  const double scaledObjective = scaledFunction.EvaluateWithGradient(master, 0,
+      scaledGradient, 32);
+  REQUIRE(scaledObjective == Approx(objective).epsilon(1e-5));
+  REQUIRE(arma::approx_equal(gradient, scaledGradient, "reldiff", 1e-4));
+  REQUIRE(scaledFunction.SkippedSteps() == 0);
+
+  // A loss scale that overflows the gradient is halved, and the step is
+  // skipped.
+  MasterWeightsFunction<FloatNetwork> overflowFunction(model, 3e38, 100);
+  overflowFunction.EvaluateWithGradient(master, 0, gradient, 32);
+  REQUIRE(overflowFunction.SkippedSteps() == 1);
+  REQUIRE(overflowFunction.LossScale() == Approx(1.5e38));
+  REQUIRE(arma::all(arma::vectorise(gradient) == 0.0));
+}
+
+/**
+ * Make sure that a StaticFFN regression network of the layers that accept any
+ * matrix type with the Armadillo API gives the same results as an FFN.
+ */
+TEST_CASE("StaticFFNRegressionMatchesFFNTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(6, 40);
+  arma::mat responses = arma::randu<arma::mat>(2, 40);
+
+  FFN<MeanSquaredError<> > model;
+  model.Add<Linear<> >(6, 8);
+  model.Add<TanHLayer<> >();
+  model.Add<Linear<> >(8, 8);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(8, 2);
+  model.Add<IdentityLayer<> >();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  StaticFFN<MeanSquaredError<>, RandomInitialization, Linear<>, TanHLayer<>,
+      Linear<>, ReLULayer<>, Linear<>, IdentityLayer<> > staticModel(
+      Linear<>(6, 8), TanHLayer<>(), Linear<>(8, 8), ReLULayer<>(),
+      Linear<>(8, 2), IdentityLayer<>());
+  staticModel.ResetParameters();
+  REQUIRE(staticModel.Parameters().n_elem == model.Parameters().n_elem);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat staticPredictions;
+  staticModel.Predict(data, staticPredictions, 16);
+  CheckMatrices(predictions, staticPredictions);
+  REQUIRE(staticModel.Evaluate(data, responses) ==
+      Approx(model.Evaluate(data, responses)).epsilon(1e-7));
+
+  // Training must reduce the error.
+  const double before = staticModel.Evaluate(data, responses);
+  ens::StandardSGD opt(0.05, 8, 40 * 50);
+  staticModel.Train(data, responses, opt);
+  REQUIRE(staticModel.Evaluate(data, responses) < before);
+}
+
+#ifdef HAS_BANDICOOT
+/**
+ * Make sure that the LogSoftMax layer and the classification loss functions
+ * give the same results on Bandicoot matrices as on Armadillo matrices.
+ */
+TEST_CASE("BandicootLogSoftMaxLossTest", "[FeedForwardNetworkTest]")
+{
+  const arma::mat input = arma::randn<arma::mat>(5, 20);
+  arma::mat labels(1, 20);
+  for (size_t i = 0; i < 20; ++i)
+    labels[i] = math::RandInt(1, 6);
+
+  LogSoftMax<> layer;
+  LogSoftMax<coot::mat, coot::mat> cootLayer;
+  arma::mat output;
+  coot::mat cootOutput;
+  layer.Forward(input, output);
+  cootLayer.Forward(coot::mat(input), cootOutput);
+  // The Armadillo version approximates exp().
+  REQUIRE(arma::approx_equal(arma::mat(cootOutput), output, "absdiff", 1e-4));
+
+  NegativeLogLikelihood<> loss;
+  NegativeLogLikelihood<coot::mat, coot::mat> cootLoss;
+  const coot::mat cootLabels(labels);
+  REQUIRE(cootLoss.Forward(coot::mat(output), cootLabels) ==
+      Approx(loss.Forward(output, labels)).epsilon(1e-7));
+
+  arma::mat error;
+  coot::mat cootError;
+  loss.Backward(output, labels, error);
+  cootLoss.Backward(coot::mat(output), cootLabels, cootError);
+  CheckMatrices(arma::mat(cootError), error);
+
+  const arma::mat probabilities = arma::randu<arma::mat>(5, 20);
+  const arma::mat targets = arma::round(arma::randu<arma::mat>(5, 20));
+  CrossEntropyError<> crossEntropy;
+  CrossEntropyError<coot::mat, coot::mat> cootCrossEntropy;
+  REQUIRE(cootCrossEntropy.Forward(coot::mat(probabilities),
+      coot::mat(targets)) ==
+      Approx(crossEntropy.Forward(probabilities, targets)).epsilon(1e-7));
+}
+#endif
+
+/**
+ * Make sure that the int8 quantization of a network of Linear layers predicts
+ * like the network, and that it can be serialized.
+ */
+TEST_CASE("QuantizedFFNLinearTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randn<arma::mat>(10, 200);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 16);
+  model.Add<ReLULayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<LinearNoBias<> >(16, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  QuantizedFFN<> quantizedModel(model, data.cols(0, 99));
+  REQUIRE(quantizedModel.NumLayers() == 7);
+  REQUIRE(quantizedModel.QuantizedLayers().size() == 3);
+
+  arma::mat quantizedPredictions;
+  quantizedModel.Predict(data, quantizedPredictions, 64);
+  REQUIRE(quantizedPredictions.n_rows == 3);
+  REQUIRE(quantizedPredictions.n_cols == 200);
+  REQUIRE(arma::abs(quantizedPredictions - predictions).max() <
+      0.05 * arma::abs(predictions).max());
+
+  QuantizedFFN<> xmlModel, textModel, binaryModel;
+  SerializeObjectAll(quantizedModel, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(quantizedPredictions, xmlPredictions);
+  CheckMatrices(quantizedPredictions, textPredictions);
+  CheckMatrices(quantizedPredictions, binaryPredictions);
+}
+
+/**
+ * Make sure that the int8 quantization of a convolutional network predicts
+ * like the network, and that layers with other weights are rejected.
+ */
+TEST_CASE("QuantizedFFNConvolutionTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(2 * 8 * 8, 50);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Convolution<> >(2, 4, 3, 3, 1, 1, 1, 1, 8, 8);
+  model.Add<ReLULayer<> >();
+  model.Add<MaxPooling<> >(2, 2, 2, 2);
+  model.Add<Convolution<> >(4, 2, 2, 2, 2, 2, 0, 0, 4, 4);
+  model.Add<Linear<> >(2 * 2 * 2, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  QuantizedFFN<> quantizedModel(model, data);
+  REQUIRE(quantizedModel.QuantizedLayers().size() == 3);
+
+  arma::mat quantizedPredictions;
+  quantizedModel.Predict(data, quantizedPredictions);
+  REQUIRE(arma::abs(quantizedPredictions - predictions).max() <
+      0.05 * arma::abs(predictions).max());
+
+  FFN<NegativeLogLikelihood<> > batchNormModel;
+  batchNormModel.Add<Linear<> >(10, 4);
+  batchNormModel.Add<BatchNorm<> >(4);
+  batchNormModel.Add<LogSoftMax<> >();
+  REQUIRE_THROWS_AS(QuantizedFFN<>(batchNormModel, arma::randu(10, 5)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that fusing the layers of a network with BatchNorm layers and
+ * activations doesn't change its predictions.
+ */
+TEST_CASE("FFNFuseLayersTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(2 * 8 * 8, 30);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Convolution<> >(2, 3, 3, 3, 1, 1, 1, 1, 8, 8);
+  model.Add<BatchNorm<> >(3);
+  model.Add<ReLULayer<> >();
+  model.Add<MeanPooling<> >(2, 2, 2, 2);
+  model.Add<Linear<> >(4 * 4 * 3, 10);
+  model.Add<BatchNorm<> >(10);
+  model.Add<TanHLayer<> >();
+  model.Add<Linear<> >(10, 6);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+
+  // Use random scales and shifts, and random running statistics, for the
+  // BatchNorm layers.
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  model.Parameters() = arma::randu<arma::mat>(model.Parameters().n_elem, 1) -
+      0.5;
+  for (size_t i : { 1, 5 })
+  {
+    BatchNorm<>* batchNorm = boost::get<BatchNorm<>*>(model.Model()[i]);
+    batchNorm->TrainingMean().randu();
+    batchNorm->TrainingVariance().randu();
+    batchNorm->TrainingVariance() += 0.5;
+  }
+  model.Predict(data, predictions);
+
+  model.Fuse();
+  REQUIRE(model.Model().size() == 7);
+  REQUIRE(model.Parameters().n_elem == (3 * 2 * 3 * 3 + 3) +
+      (10 * 48 + 10) + (6 * 10 + 6) + (3 * 6 + 3));
+  REQUIRE(boost::get<FusedLinear<TanhFunction>*>(&model.Model()[3]) != NULL);
+  REQUIRE(boost::get<FusedLinear<LogisticFunction>*>(&model.Model()[4]) !=
+      NULL);
+
+  arma::mat fusedPredictions;
+  model.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions);
+
+  // The fused network can still be trained; check that the gradient of the
+  // fused layers is correct.
+  FFN<NegativeLogLikelihood<> > fusedModel;
+  fusedModel.Add<FusedLinear<RectifierFunction> >(5, 4);
+  fusedModel.Add<FusedLinear<TanhFunction> >(4, 4);
+  fusedModel.Add<Linear<> >(4, 3);
+  fusedModel.Add<LogSoftMax<> >();
+
+  FFN<NegativeLogLikelihood<> > unfusedModel;
+  unfusedModel.Add<Linear<> >(5, 4);
+  unfusedModel.Add<ReLULayer<> >();
+  unfusedModel.Add<Linear<> >(4, 4);
+  unfusedModel.Add<TanHLayer<> >();
+  unfusedModel.Add<Linear<> >(4, 3);
+  unfusedModel.Add<LogSoftMax<> >();
+
+  fusedModel.Predictors() = arma::randn<arma::mat>(5, 10);
+  fusedModel.Responses() = arma::randi<arma::mat>(1, 10,
+      arma::distr_param(1, 3));
+  fusedModel.ResetParameters();
+  unfusedModel.Predictors() = fusedModel.Predictors();
+  unfusedModel.Responses() = fusedModel.Responses();
+  unfusedModel.ResetParameters();
+  unfusedModel.Parameters() = fusedModel.Parameters();
+
+  arma::mat fusedGradient, unfusedGradient;
+  const double fusedObjective = fusedModel.EvaluateWithGradient(
+      fusedModel.Parameters(), 0, fusedGradient, 10);
+  const double unfusedObjective = unfusedModel.EvaluateWithGradient(
+      unfusedModel.Parameters(), 0, unfusedGradient, 10);
+  REQUIRE(fusedObjective == Approx(unfusedObjective).epsilon(1e-7));
+  CheckMatrices(fusedGradient, unfusedGradient);
+}
+
+/**
+ * Make sure that pruning a network zeroes the right fraction of the weights of
+ * its Linear layers, that retraining keeps them at zero, and that replacing the
+ * pruned layers with sparse layers doesn't change the predictions.
+ */
+TEST_CASE("FFNMagnitudePruningTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 40);
+  arma::mat labels = arma::randi<arma::mat>(1, 40, arma::distr_param(1, 3));
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(20, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat mask;
+  REQUIRE_THROWS_AS(model.Prune(1.0, mask), std::invalid_argument);
+
+  const arma::mat originalParameters = model.Parameters();
+  model.Prune(0.75, mask);
+  REQUIRE(mask.n_elem == model.Parameters().n_elem);
+
+  // 150 of the 200 weights of the first layer and 45 of the 60 weights of the
+  // second layer are pruned; the biases are kept.
+  const arma::mat& parameters = model.Parameters();
+  REQUIRE(arma::accu(mask == 0.0) == 150 + 45);
+  REQUIRE(arma::accu(mask.rows(200, 219) == 0.0) == 0);
+  REQUIRE(arma::accu(mask.rows(220, 279) == 0.0) == 45);
+  REQUIRE(arma::accu(parameters % (1 - mask) != 0.0) == 0);
+  CheckMatrices(parameters, originalParameters % mask);
+
+  // The pruned weights are the ones with the smallest magnitude.
+  const arma::vec weights = arma::abs(originalParameters.rows(0, 199));
+  const arma::vec weightMask = mask.rows(0, 199);
+  REQUIRE(arma::max(weights(arma::find(weightMask == 0.0))) <=
+      arma::min(weights(arma::find(weightMask == 1.0))));
+
+  // Retrain the network; the pruned weights must stay zero.
+  ens::StandardSGD opt(0.01, 8, 5 * data.n_cols);
+  model.Train(data, labels, opt, KeepPruned(mask));
+  REQUIRE(arma::accu(model.Parameters() % (1 - mask) != 0.0) == 0);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  // Neither layer is sparse enough to be replaced.
+  model.Sparsify(0.8);
+  REQUIRE(model.Model().size() == 4);
+  REQUIRE(boost::get<Linear<>*>(&model.Model()[0]) != NULL);
+  REQUIRE(boost::get<Linear<>*>(&model.Model()[2]) != NULL);
+
+  model.Sparsify(0.7);
+  REQUIRE(model.Parameters().n_elem == 0);
+  SparseLinear<>* sparse = boost::get<SparseLinear<>*>(model.Model()[0]);
+  REQUIRE(sparse->NonZeros() <= 50);
+  REQUIRE(boost::get<SparseLinear<>*>(&model.Model()[2]) != NULL);
+
+  arma::mat sparsePredictions;
+  model.Predict(data, sparsePredictions);
+  CheckMatrices(predictions, sparsePredictions);
+
+  // A single point goes through the other path of the sparse layers.
+  arma::mat point = data.col(3);
+  arma::mat pointPrediction;
+  model.Predict(point, pointPrediction);
+  CheckMatrices(predictions.col(3), pointPrediction);
+}
+
+/**
+ * Make sure that the outputs and the deltas of the layers are moved into the
+ * arena during training, and that the gradient is unchanged.
+ */
+TEST_CASE("FFNActivationArenaTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 30);
+  arma::mat labels = arma::randi<arma::mat>(1, 30, arma::distr_param(1, 3));
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  // A copy of the network doesn't share the arena.
+  FFN<NegativeLogLikelihood<> > copy(model);
+
+  arma::mat gradient, copyGradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 10);
+
+  OutputParameterVisitor outputParameterVisitor;
+  DeltaVisitor deltaVisitor;
+  std::vector<const double*> outputs, deltas;
+  for (size_t i = 0; i < model.Model().size(); ++i)
+  {
+    outputs.push_back(boost::apply_visitor(outputParameterVisitor,
+        model.Model()[i]).memptr());
+    deltas.push_back(boost::apply_visitor(deltaVisitor,
+        model.Model()[i]).memptr());
+  }
+
+  // The next batch of the same size uses the same memory.
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 10,
+      gradient, 10);
+  for (size_t i = 0; i < model.Model().size(); ++i)
+  {
+    REQUIRE(boost::apply_visitor(outputParameterVisitor,
+        model.Model()[i]).memptr() == outputs[i]);
+    REQUIRE(boost::apply_visitor(deltaVisitor, model.Model()[i]).memptr() ==
+        deltas[i]);
+  }
+
+  const double copyObjective = copy.EvaluateWithGradient(copy.Parameters(),
+      10, copyGradient, 10);
+  REQUIRE(objective == Approx(copyObjective).epsilon(1e-7));
+  CheckMatrices(gradient, copyGradient);
+
+  // A batch of another size is still computed correctly.
+  model.EvaluateWithGradient(model.Parameters(), 20, gradient, 7);
+  copy.EvaluateWithGradient(copy.Parameters(), 20, copyGradient, 7);
+  CheckMatrices(gradient, copyGradient);
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 10);
+  copy.EvaluateWithGradient(copy.Parameters(), 0, copyGradient, 10);
+  CheckMatrices(gradient, copyGradient);
+}
+
+/**
+ * Export fully connected and convolutional networks to ONNX, import them back,
+ * and make sure the imported networks give the same predictions (up to the
+ * float precision of the stored weights).
+ */
+TEST_CASE("FFNONNXRoundTripTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<TanHLayer<> >();
+  model.Add<LinearNoBias<> >(8, 6);
+  model.Add<LeakyReLU<> >(0.2);
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  BatchNorm<>* batchNorm = boost::get<BatchNorm<>*>(model.Model()[1]);
+  batchNorm->TrainingMean().randu();
+  batchNorm->TrainingVariance() = 0.5 + arma::randu(8, 1);
+
+  arma::mat data = arma::randu(10, 20);
+  arma::mat output, importedOutput;
+  model.Predict(data, output);
+
+  onnx::Export(model, "test_model.onnx");
+  FFN<NegativeLogLikelihood<> > imported;
+  onnx::Import("test_model.onnx", imported);
+  remove("test_model.onnx");
+
+  // The Dropout layer isn't exported.
+  REQUIRE(imported.Model().size() == 7);
+  imported.Predict(data, importedOutput);
+  CheckMatrices(output, importedOutput, 1e-3);
+
+  // Use a non-square input, so that the width and the height can't be
+  // swapped.
+  FFN<NegativeLogLikelihood<> > convModel;
+  convModel.Add<Convolution<> >(1, 3, 3, 3, 1, 1, 1, 1, 8, 6);
+  convModel.Add<BatchNorm<> >(3);
+  convModel.Add<ReLULayer<> >();
+  convModel.Add<MaxPooling<> >(2, 2, 2, 2, true);
+  convModel.Add<Convolution<> >(3, 2, 2, 2, 1, 1, 0, 0, 4, 3);
+  convModel.Add<MeanPooling<> >(2, 2, 1, 1, true);
+  convModel.Add<Linear<> >(4, 3);
+  convModel.Add<Softmax<> >();
+  convModel.ResetParameters();
+
+  batchNorm = boost::get<BatchNorm<>*>(convModel.Model()[1]);
+  batchNorm->TrainingMean().randu();
+  batchNorm->TrainingVariance() = 0.5 + arma::randu(3, 1);
+
+  data = arma::randu(48, 5);
+  convModel.Predict(data, output);
+
+  onnx::Export(convModel, "test_model.onnx");
+  FFN<NegativeLogLikelihood<> > importedConv;
+  onnx::Import("test_model.onnx", importedConv);
+  remove("test_model.onnx");
+
+  REQUIRE(importedConv.Model().size() == convModel.Model().size());
+  importedConv.Predict(data, importedOutput);
+  CheckMatrices(output, importedOutput, 1e-3);
+}
+
+/**
+ * Make sure that the PrefetchLoader gives every point of the source once per
+ * epoch, with the responses still matching the predictors, and that it
+ * rethrows the exceptions of the source.
+ */
+TEST_CASE("FFNPrefetchLoaderTest", "[FeedForwardNetworkTest]")
+{
+  // Five chunks of 7 points; the response of each point is its index.
+  size_t chunk = 0;
+  CallbackSource<> source(
+      [&](arma::mat& x, arma::mat& y)
+      {
+        if (chunk == 5)
+          return false;
+
+        y = arma::regspace<arma::rowvec>(7 * chunk, 7 * chunk + 6);
+        x = arma::repmat(y, 3, 1);
+        ++chunk;
+        return true;
+      },
+      [&](const bool) { chunk = 0; });
+  PrefetchLoader<CallbackSource<> > loader(std::move(source), 2, true);
+
+  arma::mat x, y;
+  for (size_t epoch = 0; epoch < 3; ++epoch)
+  {
+    arma::rowvec seen;
+    while (loader.Next(x, y))
+    {
+      REQUIRE(x.n_cols == 7);
+      CheckMatrices(x.row(2), y);
+      seen = arma::join_rows(seen, y);
+    }
+
+    REQUIRE(seen.n_elem == 35);
+    CheckMatrices(arma::sort(seen), arma::regspace<arma::rowvec>(0, 34));
+  }
+
+  // Reset() starts a new epoch.
+  loader.Next(x, y);
+  loader.Reset();
+  size_t chunks = 0;
+  while (loader.Next(x, y))
+    ++chunks;
+  REQUIRE(chunks == 5);
+
+  CallbackSource<> failingSource([](arma::mat&, arma::mat&) -> bool
+      { throw std::runtime_error("read error"); });
+  PrefetchLoader<CallbackSource<> > failingLoader(std::move(failingSource));
+  REQUIRE_THROWS_AS(failingLoader.Next(x, y), std::runtime_error);
+}
+
+/**
+ * Train a network on a dataset that is stored in chunks, and make sure it
+ * reaches about the same error as when it is trained on the whole dataset.
+ */
+TEST_CASE("FFNChunkedFileTrainTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  // Split the training set over four pairs of files.
+  std::vector<std::string> predictorFiles, responseFiles;
+  const size_t chunks = 4;
+  for (size_t i = 0; i < chunks; ++i)
+  {
+    const size_t first = i * trainData.n_cols / chunks;
+    const size_t last = (i + 1) * trainData.n_cols / chunks - 1;
+    predictorFiles.push_back("ffn_chunk_x" + std::to_string(i) + ".bin");
+    responseFiles.push_back("ffn_chunk_y" + std::to_string(i) + ".bin");
+    data::Save(predictorFiles.back(), arma::mat(trainData.cols(first, last)));
+    data::Save(responseFiles.back(), arma::mat(trainLabels.cols(first, last)));
+  }
+
+  PrefetchLoader<ChunkedFileSource> loader(ChunkedFileSource(predictorFiles,
+      responseFiles));
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(trainData.n_rows, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  ens::Adam opt(0.01, 32);
+  const double objective = model.Train(loader, opt, 10);
+  REQUIRE(std::isfinite(objective));
+
+  // The options of the optimizer are restored.
+  REQUIRE(opt.MaxIterations() == 100000);
+  REQUIRE(opt.ResetPolicy() == true);
+
+  for (size_t i = 0; i < chunks; ++i)
+  {
+    remove(predictorFiles[i].c_str());
+    remove(responseFiles[i].c_str());
+  }
+
+  arma::mat predictionTemp;
+  model.Predict(testData, predictionTemp);
+  arma::mat prediction = arma::zeros<arma::mat>(1, predictionTemp.n_cols);
+  for (size_t i = 0; i < predictionTemp.n_cols; ++i)
+  {
+    prediction(i) = arma::as_scalar(arma::find(
+        arma::max(predictionTemp.col(i)) == predictionTemp.col(i), 1)) + 1;
+  }
+
+  const size_t correct = arma::accu(prediction == testLabels);
+  const double classificationError = 1 - double(correct) / testData.n_cols;
+  REQUIRE(classificationError <= 0.1);
+}
+
+/**
+ * Train a network on sparse bag-of-words features, and make sure that it
+ * learns them, and that its sparse and dense predictions match.
+ */
+TEST_CASE("FFNSparseInputTest", "[FeedForwardNetworkTest]")
+{
+  // Each point has a few words out of 2000; points of the first class have
+  // words in [0, 1000) and points of the second class words in [1000, 2000).
+  const size_t points = 400;
+  arma::umat locations(2, 5 * points);
+  arma::vec values(5 * points);
+  arma::mat labels(1, points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = (i % 2) + 1;
+    for (size_t j = 0; j < 5; ++j)
+    {
+      locations(0, 5 * i + j) = 1000 * (i % 2) + 200 * j +
+          math::RandInt(0, 200);
+      locations(1, 5 * i + j) = i;
+      values[5 * i + j] = 1.0;
+    }
+  }
+  arma::sp_mat data(true, locations, values, 2000, points, true);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(2000, 10);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(10, 2);
+  model.Add<LogSoftMax<> >();
+
+  ens::Adam opt(0.01, 16, 0.9, 0.999, 1e-8, 10 * points);
+  model.Train(data, labels, opt);
+  REQUIRE(model.SparsePredictors().n_cols == points);
+
+  arma::mat predictions, densePredictions;
+  model.Predict(data, predictions, 32);
+  model.Predict(arma::mat(data), densePredictions, 32);
+  CheckMatrices(predictions, densePredictions, 1e-8);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < points; ++i)
+  {
+    const size_t label = predictions.col(i).index_max() + 1;
+    if (label == labels[i])
+      ++correct;
+  }
+  REQUIRE(correct >= 0.95 * points);
+}
+
+/**
+ * Make sure that the profiler records the passes of each layer of an FFN, and
+ * times them with the mlpack timers.
+ */
+TEST_CASE("FFNLayerProfilerTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu(5, 64);
+  arma::mat labels = arma::ones(1, 64);
+  labels.cols(32, 63).fill(2);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(5, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 2);
+  model.Add<LogSoftMax<> >();
+
+  // Nothing is recorded by default.
+  ens::Adam opt(0.01, 16, 0.9, 0.999, 1e-8, 64);
+  model.Train(data, labels, opt);
+  REQUIRE(model.Profiler().NumLayers() == 0);
+
+  Timer::EnableTiming();
+  model.Profiler().Enabled() = true;
+  std::ostringstream report;
+  model.Train(data, labels, opt, ProfilerReport(model.Profiler(), report, 1));
+  model.Profiler().Enabled() = false;
+  Timer::DisableTiming();
+
+  REQUIRE(model.Profiler().NumLayers() == 4);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const LayerProfiler::Record& forward =
+        model.Profiler().Get(i, LayerProfiler::FORWARD);
+    REQUIRE(forward.calls >= 4);
+    REQUIRE(forward.time.count() > 0);
+    REQUIRE(forward.flops > 0);
+    REQUIRE(forward.bytes > 0);
+    REQUIRE(model.Profiler().Get(i, LayerProfiler::GRADIENT).calls >= 4);
+  }
+
+  // The first layer has no backward pass.
+  REQUIRE(model.Profiler().Get(0, LayerProfiler::BACKWARD).calls == 0);
+  REQUIRE(model.Profiler().Get(1, LayerProfiler::BACKWARD).calls >= 4);
+
+  // A linear layer is counted as a product with its weights.
+  const LayerProfiler::Record& linear =
+      model.Profiler().Get(2, LayerProfiler::FORWARD);
+  REQUIRE(linear.flops == Approx(2.0 * 18 * 16 * linear.calls));
+
+  REQUIRE(report.str().find("forward") != std::string::npos);
+  REQUIRE(IO::GetSingleton().timer.GetAllTimers().count(
+      "ffn_layer2_gradient") == 1);
+
+  model.Profiler().Reset();
+  REQUIRE(model.Profiler().NumLayers() == 0);
+}
+
+#ifdef HAS_MPI
+/**
+ * Make sure that training with the DistributedOptimizer in a single process
+ * gives the same model as training with the optimizer it wraps.
+ */
+TEST_CASE("FFNDistributedOptimizerTest", "[FeedForwardNetworkTest]")
+{
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if (!initialized)
+  {
+    MPI_Init(NULL, NULL);
+    std::atexit([]() { MPI_Finalize(); });
+  }
+
+  arma::mat data = arma::randu(5, 64);
+  arma::mat labels = arma::ones(1, 64);
+  labels.cols(32, 63).fill(2);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(5, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 2);
+  model.Add<LogSoftMax<> >();
+  FFN<NegativeLogLikelihood<> > distributedModel(model);
+
+  // Both models are initialized from the same seed when they are trained.
+  ens::Adam opt(0.01, 16, 0.9, 0.999, 1e-8, 64 * 5);
+  math::RandomSeed(7);
+  model.Train(data, labels, opt);
+
+  DistributedOptimizer<ens::Adam> distributedOpt(
+      ens::Adam(0.01, 16, 0.9, 0.999, 1e-8, 64 * 5), MPI_COMM_WORLD, 7);
+  REQUIRE(distributedOpt.Processes() == 1);
+  math::RandomSeed(7);
+  distributedModel.Train(data, labels, distributedOpt);
+
+  CheckMatrices(model.Parameters(), distributedModel.Parameters(), 1e-8);
+
+  // The ring allreduce of a single process leaves the buffer as it is.
+  arma::vec buffer = arma::randu(20);
+  const arma::vec original = buffer;
+  std::vector<double> receive;
+  RingAllReduce(buffer.memptr(), buffer.n_elem, MPI_COMM_WORLD, 3, receive);
+  CheckMatrices(buffer, original);
+}
+#endif
@@ -348,4 +348,55 @@ BOOST_AUTO_TEST_CASE(GANMemorySharingTest)
       trainData);
 }
 
+/*
+ * Make sure that evaluating the real and the generated points of a batch in
+ * parallel gives the same objective and gradient as evaluating them one after
+ * the other.
+ */
+BOOST_AUTO_TEST_CASE(GANParallelEvaluationTest)
+{
+  size_t hiddenLayerSize = 8;
+  size_t batchSize = 8;
+  size_t noiseDim = 2;
+
+  arma::mat trainData(1, 64);
+  trainData.imbue( [&]() { return arma::as_scalar(RandNormal(4, 0.5));});
+
+  // Create the Discriminator network.
+  FFN<SigmoidCrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(1, hiddenLayerSize);
+  discriminator.Add<ReLULayer<> >();
+  discriminator.Add<Linear<> >(hiddenLayerSize, 1);
+
+  // Create the Generator network.
+  FFN<SigmoidCrossEntropyError<> > generator;
+  generator.Add<Linear<> >(noiseDim, hiddenLayerSize);
+  generator.Add<SoftPlusLayer<> >();
+  generator.Add<Linear<> >(hiddenLayerSize, 1);
+
+  // Create GAN, and train it for a single step to set it up.
+  GaussianInitialization gaussian(0, 0.1);
+  ens::Adam optimizer(0.0003, batchSize, 0.9, 0.999, 1e-8, 1, 1e-5, false);
+  std::function<double ()> noiseFunction = [](){ return math::Random(-8, 8); };
+  GAN<FFN<SigmoidCrossEntropyError<> >,
+      GaussianInitialization,
+      std::function<double()> >
+  gan(generator, discriminator, gaussian, noiseFunction, noiseDim, batchSize,
+      1, 0, 1);
+  gan.Train(trainData, optimizer);
+
+  arma::mat sequentialGradient, parallelGradient;
+  math::RandomSeed(7);
+  const double sequentialObjective = gan.EvaluateWithGradient(
+      gan.Parameters(), 0, sequentialGradient, batchSize);
+
+  gan.Parallel() = true;
+  math::RandomSeed(7);
+  const double parallelObjective = gan.EvaluateWithGradient(
+      gan.Parameters(), 0, parallelGradient, batchSize);
+
+  BOOST_REQUIRE_CLOSE(sequentialObjective, parallelObjective, 1e-5);
+  CheckMatrices(sequentialGradient, parallelGradient, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/gmm/gmm.hpp>
 #include <mlpack/methods/gmm/diagonal_gmm.hpp>
+#include <mlpack/methods/gmm/streaming_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -798,6 +799,194 @@ BOOST_AUTO_TEST_CASE(UseExistingModelTest)
   }
 }
 
+/**
+ * Build a GMM with 16 unit-covariance Gaussians on a 4x4 grid, far enough apart
+ * that each point has a negligible probability of being from any Gaussian but
+ * its own, and sample a dataset from it.  The returned GMM is perturbed a
+ * little, to be used as the initial model for training.
+ */
+GMM GridGMM(arma::mat& data)
+{
+  GMM gmm(16, 2);
+  for (size_t i = 0; i < 16; ++i)
+  {
+    arma::vec mean(2);
+    mean[0] = 20.0 * (i % 4);
+    mean[1] = 20.0 * (i / 4);
+    gmm.Component(i) = distribution::GaussianDistribution(mean,
+        arma::eye<arma::mat>(2, 2));
+  }
+  gmm.Weights().fill(1.0 / 16);
+
+  data.set_size(2, 8000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) = gmm.Component(i % 16).Random();
+
+  for (size_t i = 0; i < 16; ++i)
+    gmm.Component(i).Mean() += 0.5 * arma::randu<arma::vec>(2);
+
+  return gmm;
+}
+
+/**
+ * Make sure that the pruned E-step gives the same model as the exact E-step
+ * when the Gaussians it skips are negligible.
+ */
+BOOST_AUTO_TEST_CASE(PrunedEStepTest)
+{
+  arma::mat data;
+  GMM gmm = GridGMM(data);
+  GMM prunedGMM(gmm);
+
+  EMFit<> fitter(20, 1e-10);
+  EMFit<> prunedFitter(20, 1e-10, kmeans::KMeans<>(),
+      PositiveDefiniteConstraint(), 1e-12);
+  BOOST_REQUIRE_EQUAL(prunedFitter.PruneThreshold(), 1e-12);
+
+  const double likelihood = gmm.Train(data, 1, true, fitter);
+  const double prunedLikelihood = prunedGMM.Train(data, 1, true,
+      prunedFitter);
+
+  BOOST_REQUIRE_CLOSE(prunedLikelihood, likelihood, 1e-5);
+  for (size_t i = 0; i < gmm.Gaussians(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(prunedGMM.Weights()[i], gmm.Weights()[i], 1e-5);
+    for (size_t j = 0; j < gmm.Dimensionality(); ++j)
+    {
+      BOOST_REQUIRE_CLOSE(prunedGMM.Component(i).Mean()[j],
+          gmm.Component(i).Mean()[j], 1e-5);
+      for (size_t k = 0; k < gmm.Dimensionality(); ++k)
+      {
+        BOOST_REQUIRE_CLOSE(prunedGMM.Component(i).Covariance()(j, k),
+            gmm.Component(i).Covariance()(j, k), 1e-3);
+      }
+    }
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that EM gives the same model with one thread and with many
+ * threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelEMFitTest)
+{
+  arma::mat data;
+  GMM gmm = GridGMM(data);
+  GMM sequentialGMM(gmm);
+
+  EMFit<> fitter(20, 1e-10);
+  gmm.Train(data, 1, true, fitter);
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  sequentialGMM.Train(data, 1, true, fitter);
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < gmm.Gaussians(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(gmm.Weights()[i], sequentialGMM.Weights()[i], 1e-7);
+    for (size_t j = 0; j < gmm.Dimensionality(); ++j)
+    {
+      BOOST_REQUIRE_CLOSE(gmm.Component(i).Mean()[j],
+          sequentialGMM.Component(i).Mean()[j], 1e-7);
+      for (size_t k = 0; k < gmm.Dimensionality(); ++k)
+      {
+        BOOST_REQUIRE_CLOSE(gmm.Component(i).Covariance()(j, k),
+            sequentialGMM.Component(i).Covariance()(j, k), 1e-5);
+      }
+    }
+  }
+}
+#endif
+
+/**
+ * Make sure that StreamingEMFit on chunks of the data gives the same model as
+ * EMFit on the whole data.
+ */
+BOOST_AUTO_TEST_CASE(StreamingEMFitTest)
+{
+  arma::mat data;
+  GMM gmm = GridGMM(data);
+
+  std::vector<distribution::GaussianDistribution> dists(gmm.Gaussians());
+  for (size_t i = 0; i < gmm.Gaussians(); ++i)
+    dists[i] = gmm.Component(i);
+  arma::vec weights = gmm.Weights();
+
+  EMFit<> fitter(20, 1e-10);
+  gmm.Train(data, 1, true, fitter);
+
+  auto chunks = [&data](const size_t chunk, arma::mat& observations)
+  {
+    if (chunk * 1000 >= data.n_cols)
+      return false;
+    observations = data.cols(chunk * 1000, std::min((chunk + 1) * 1000,
+        (size_t) data.n_cols) - 1);
+    return true;
+  };
+
+  StreamingEMFit<> streamingFitter(20, 1e-10);
+  streamingFitter.Estimate(chunks, dists, weights, true);
+
+  for (size_t i = 0; i < gmm.Gaussians(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(weights[i], gmm.Weights()[i], 1e-5);
+    for (size_t j = 0; j < gmm.Dimensionality(); ++j)
+    {
+      BOOST_REQUIRE_CLOSE(dists[i].Mean()[j], gmm.Component(i).Mean()[j],
+          1e-5);
+      for (size_t k = 0; k < gmm.Dimensionality(); ++k)
+      {
+        BOOST_REQUIRE_CLOSE(dists[i].Covariance()(j, k),
+            gmm.Component(i).Covariance()(j, k), 1e-3);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that merging the sufficient statistics of two shards gives the
+ * same statistics as accumulating all the points at once.
+ */
+BOOST_AUTO_TEST_CASE(EMSufficientStatisticsMergeTest)
+{
+  arma::mat data;
+  GMM gmm = GridGMM(data);
+
+  std::vector<distribution::GaussianDistribution> dists(gmm.Gaussians());
+  for (size_t i = 0; i < gmm.Gaussians(); ++i)
+    dists[i] = gmm.Component(i);
+
+  EMSufficientStatistics<> all(2, 16), first(2, 16), second(2, 16);
+  const double logLikelihood = all.Accumulate(data, dists, gmm.Weights());
+  first.Accumulate(data.cols(0, 2999), dists, gmm.Weights());
+  second.Accumulate(data.cols(3000, data.n_cols - 1), dists, gmm.Weights());
+  first.Merge(second);
+
+  BOOST_REQUIRE_EQUAL(first.Points(), data.n_cols);
+  BOOST_REQUIRE_CLOSE(first.LogLikelihood(), logLikelihood, 1e-8);
+
+  double expectedLogLikelihood = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    expectedLogLikelihood += std::log(gmm.Probability(data.col(i)));
+  BOOST_REQUIRE_CLOSE(all.LogLikelihood(), expectedLogLikelihood, 1e-8);
+  for (size_t i = 0; i < 16; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(first.Responsibilities()[i],
+        all.Responsibilities()[i], 1e-8);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(first.Means()(j, i), all.Means()(j, i), 1e-8);
+      for (size_t k = 0; k < 2; ++k)
+      {
+        BOOST_REQUIRE_CLOSE(first.Scatters()[i](j, k),
+            all.Scatters()[i](j, k), 1e-6);
+      }
+    }
+  }
+}
+
 /********************************************************/
 /** Diagonal Gaussian Mixture Model(DiagonalGMM) Tests **/
 /********************************************************/
@@ -0,0 +1,161 @@
+/**
+ * @file tests/gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting and GradientBoostingTree classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(GradientBoostingTest);
+
+/**
+ * Make sure that a single tree fitted to the gradients of a step function finds
+ * the step, with Newton leaf values.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingTreeStepTest)
+{
+  // One dimension with values 0 to 9; the points from 5 on have gradient -1,
+  // the others +1.
+  arma::Mat<unsigned char> bins(1, 10);
+  arma::vec gradients(10), hessians(10, arma::fill::ones);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    bins(0, i) = (unsigned char) i;
+    gradients[i] = (i < 5) ? 1.0 : -1.0;
+  }
+  std::vector<arma::vec> cuts(1, arma::regspace<arma::vec>(0.5, 8.5));
+
+  GradientBoostingTree tree;
+  tree.Train(bins, cuts, gradients, hessians, arma::regspace<arma::uvec>(0, 9),
+      arma::uvec({ 0 }), 0, 1, 1.0, 0.0, 0.5);
+
+  // The step is the only useful split.
+  BOOST_REQUIRE_EQUAL(tree.NumLeaves(), 2);
+  BOOST_REQUIRE_CLOSE(tree.Predict(arma::vec({ 2.0 })), -0.5 * 5.0 / 6.0,
+      1e-5);
+  BOOST_REQUIRE_CLOSE(tree.Predict(arma::vec({ 7.0 })), 0.5 * 5.0 / 6.0,
+      1e-5);
+  BOOST_REQUIRE_CLOSE(tree.Predict(arma::vec({ 4.5 })), -0.5 * 5.0 / 6.0,
+      1e-5);
+
+  // A depth of 0 has no limit, but a minimum leaf size of 6 forbids the split.
+  tree.Train(bins, cuts, gradients, hessians, arma::regspace<arma::uvec>(0, 9),
+      arma::uvec({ 0 }), 0, 6, 1.0, 0.0, 0.5);
+  BOOST_REQUIRE_EQUAL(tree.NumLeaves(), 1);
+  BOOST_REQUIRE_SMALL(tree.Predict(arma::vec({ 2.0 })), 1e-10);
+}
+
+/**
+ * Make sure that gradient boosting learns a nonlinear multiclass problem, with
+ * and without subsampling, and that the training loss decreases with the
+ * number of rounds.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingLearningTest)
+{
+  arma::mat data(4, 1200, arma::fill::randu);
+  arma::Row<size_t> labels(1200);
+  for (size_t i = 0; i < 1200; ++i)
+  {
+    // Three classes given by the quadrant of the first two dimensions.
+    labels[i] = (data(0, i) < 0.5) ? ((data(1, i) < 0.5) ? 0 : 1) :
+        ((data(1, i) < 0.5) ? 1 : 2);
+  }
+
+  arma::mat trainData = data.cols(0, 799);
+  arma::Row<size_t> trainLabels = labels.subvec(0, 799);
+  arma::mat testData = data.cols(800, 1199);
+  arma::Row<size_t> testLabels = labels.subvec(800, 1199);
+
+  GradientBoosting shortModel;
+  const double shortLoss = shortModel.Train(trainData, trainLabels, 3, 5);
+  GradientBoosting model;
+  const double loss = model.Train(trainData, trainLabels, 3, 50);
+  BOOST_REQUIRE_LT(loss, shortLoss);
+  BOOST_REQUIRE_EQUAL(model.NumRounds(), 50);
+  BOOST_REQUIRE_EQUAL(model.NumClasses(), 3);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  model.Classify(testData, predictions, probabilities);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, 400);
+  for (size_t i = 0; i < 400; ++i)
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+  BOOST_REQUIRE_GE(arma::accu(predictions == testLabels), 380);
+
+  // The single point overload gives the same predictions.
+  for (size_t i = 0; i < 20; ++i)
+    BOOST_REQUIRE_EQUAL(model.Classify(testData.col(i)), predictions[i]);
+
+  // Subsampling the points and the dimensions still learns the problem.
+  GradientBoosting subsampledModel(trainData, trainLabels, 3, 100, 0.1, 4, 1,
+      1.0, 0.0, 0.7, 0.75, 64);
+  subsampledModel.Classify(testData, predictions);
+  BOOST_REQUIRE_GE(arma::accu(predictions == testLabels), 360);
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingInvalidParametersTest)
+{
+  arma::mat data(2, 10, arma::fill::randu);
+  arma::Row<size_t> labels(10, arma::fill::zeros);
+  labels.subvec(5, 9).fill(1);
+
+  GradientBoosting model;
+  BOOST_REQUIRE_THROW(model.Classify(data.col(0)), std::invalid_argument);
+  BOOST_REQUIRE_THROW(model.Train(data, labels, 1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(model.Train(data, labels.subvec(0, 8), 2),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(model.Train(data, labels, 2, 10, 0.1, 6, 1, 1.0, 0.0,
+      0.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(model.Train(data, labels, 2, 10, 0.1, 6, 1, 1.0, 0.0,
+      1.0, 1.0, 512), std::invalid_argument);
+}
+
+/**
+ * Make sure we can serialize a gradient boosting model.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingSerializationTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  GradientBoosting model(dataset, labels, 3, 10);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  model.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  GradientBoosting xmlModel, textModel, binaryModel;
+  binaryModel.Train(dataset, labels, 3, 2);
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+  xmlModel.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textModel.Classify(dataset, textPredictions, textProbabilities);
+  binaryModel.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -1855,4 +1855,137 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMHMMLoadSaveTest)
   }
 }
 
+/**
+ * Make sure that the batched emission probabilities, forward algorithm and
+ * Viterbi algorithm give the same results as a direct computation.
+ */
+BOOST_AUTO_TEST_CASE(GMMHMMBatchedLogLikelihoodPredictTest)
+{
+  // Build an HMM with three states and GMM emissions of two components.
+  std::vector<GMM> gmms(3, GMM(2, 2));
+  for (size_t j = 0; j < gmms.size(); ++j)
+  {
+    gmms[j].Weights() = arma::vec("0.3 0.7");
+    for (size_t i = 0; i < 2; ++i)
+    {
+      gmms[j].Component(i).Mean() = 3.0 * j + arma::randu<arma::vec>(2);
+      gmms[j].Component(i).Covariance(arma::mat("1.0 0.2; 0.2 1.5"));
+    }
+  }
+
+  arma::mat transition("0.8 0.1 0.2; 0.1 0.7 0.3; 0.1 0.2 0.5");
+  arma::vec initial("0.5 0.3 0.2");
+  HMM<GMM> hmm(initial, transition, gmms);
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(200, observations, states);
+
+  // The batched GMM log-probabilities should match the ones of each point.
+  arma::vec logProbs;
+  gmms[1].LogProbability(observations, logProbs);
+  BOOST_REQUIRE_EQUAL(logProbs.n_elem, observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbs[i],
+        gmms[1].LogProbability(observations.col(i)), 1e-5);
+  }
+
+  // Compute the log-likelihood and the most probable state sequence directly.
+  arma::mat emissionLogProb(3, observations.n_cols);
+  for (size_t t = 0; t < observations.n_cols; ++t)
+    for (size_t j = 0; j < 3; ++j)
+      emissionLogProb(j, t) = gmms[j].LogProbability(observations.col(t));
+
+  arma::vec forward = arma::log(initial) + emissionLogProb.col(0);
+  arma::mat viterbi(3, observations.n_cols);
+  arma::Mat<size_t> back(3, observations.n_cols);
+  viterbi.col(0) = forward;
+  for (size_t t = 1; t < observations.n_cols; ++t)
+  {
+    arma::vec next(3);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      arma::vec terms = forward + arma::log(transition.row(j).t());
+      next[j] = math::AccuLog(terms) + emissionLogProb(j, t);
+
+      terms = viterbi.col(t - 1) + arma::log(transition.row(j).t());
+      arma::uword index;
+      viterbi(j, t) = terms.max(index) + emissionLogProb(j, t);
+      back(j, t) = index;
+    }
+    forward = next;
+  }
+
+  BOOST_REQUIRE_CLOSE(hmm.LogLikelihood(observations), math::AccuLog(forward),
+      1e-5);
+
+  arma::Row<size_t> expectedStates(observations.n_cols);
+  arma::uword index;
+  const double expectedLogLikelihood =
+      viterbi.col(observations.n_cols - 1).max(index);
+  expectedStates[observations.n_cols - 1] = index;
+  for (size_t t = observations.n_cols - 1; t > 0; --t)
+    expectedStates[t - 1] = back(expectedStates[t], t);
+
+  arma::Row<size_t> predictedStates;
+  BOOST_REQUIRE_CLOSE(hmm.Predict(observations, predictedStates),
+      expectedLogLikelihood, 1e-5);
+  for (size_t t = 0; t < observations.n_cols; ++t)
+    BOOST_REQUIRE_EQUAL(predictedStates[t], expectedStates[t]);
+}
+
+/**
+ * Training on many sequences (in parallel, when OpenMP is available) should be
+ * deterministic, since the statistics of the threads are merged in order.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteHMMManySequencesTrainingTest)
+{
+  arma::mat transition("0.6 0.3; 0.4 0.7");
+  std::vector<DiscreteDistribution> emission(2, DiscreteDistribution(3));
+  emission[0].Probabilities() = arma::vec("0.7 0.2 0.1");
+  emission[1].Probabilities() = arma::vec("0.1 0.3 0.6");
+  HMM<DiscreteDistribution> hmm(arma::vec("0.5 0.5"), transition, emission);
+
+  std::vector<arma::mat> sequences(100);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < sequences.size(); ++i)
+    hmm.Generate(50 + i, sequences[i], states);
+
+  // Train from the same starting point twice.
+  std::vector<DiscreteDistribution> startEmission(2, DiscreteDistribution(3));
+  startEmission[0].Probabilities() = arma::vec("0.4 0.3 0.3");
+  startEmission[1].Probabilities() = arma::vec("0.3 0.3 0.4");
+  HMM<DiscreteDistribution> hmm1(arma::vec("0.5 0.5"),
+      arma::mat("0.5 0.5; 0.5 0.5"), startEmission);
+  HMM<DiscreteDistribution> hmm2(hmm1);
+
+  const double loglik1 = hmm1.Train(sequences);
+  const double loglik2 = hmm2.Train(sequences);
+
+  BOOST_REQUIRE(std::isfinite(loglik1));
+  BOOST_REQUIRE_CLOSE(loglik1, loglik2, 1e-5);
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_REQUIRE_CLOSE(hmm1.Transition()[i], hmm2.Transition()[i], 1e-5);
+  for (size_t j = 0; j < 2; ++j)
+  {
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(hmm1.Emission()[j].Probabilities()[i],
+          hmm2.Emission()[j].Probabilities()[i], 1e-5);
+    }
+  }
+
+  // The trained model should be at least as good as the starting model.
+  HMM<DiscreteDistribution> start(arma::vec("0.5 0.5"),
+      arma::mat("0.5 0.5; 0.5 0.5"), startEmission);
+  double startLoglik = 0, trainedLoglik = 0;
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    startLoglik += start.LogLikelihood(sequences[i]);
+    trainedLoglik += hmm1.LogLikelihood(sequences[i]);
+  }
+  BOOST_REQUIRE_GE(trainedLoglik, startLoglik);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,209 @@
+/**
+ * @file tests/hnsw_test.cpp
+ *
+ * Tests for the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/ip_metric.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "serialization_catch.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Compute the fraction of the true neighbors that were found.
+ */
+double HNSWRecall(const arma::Mat<size_t>& neighbors,
+                  const arma::Mat<size_t>& trueNeighbors)
+{
+  size_t found = 0;
+  for (size_t q = 0; q < neighbors.n_cols; ++q)
+    for (size_t i = 0; i < neighbors.n_rows; ++i)
+      for (size_t j = 0; j < trueNeighbors.n_rows; ++j)
+        if (neighbors(i, q) == trueNeighbors(j, q))
+          ++found;
+
+  return double(found) / trueNeighbors.n_elem;
+}
+
+/**
+ * Make sure the graph is well-formed: each node has no more links than allowed,
+ * and links only to other nodes of the same level or above.
+ */
+TEST_CASE("HNSWGraphTest", "[HNSWTest]")
+{
+  arma::mat data(10, 2000, arma::fill::randu);
+  HNSWSearch<> hnsw(data, 8, 50);
+
+  REQUIRE(hnsw.Levels().size() == 2000);
+  REQUIRE(hnsw.MaxLevel() > 0);
+
+  size_t totalLinks = 0;
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    for (size_t level = 0; level <= hnsw.Levels()[i]; ++level)
+    {
+      const std::vector<size_t> links = hnsw.Links(i, level);
+      REQUIRE(links.size() <= ((level == 0) ? 16 : 8));
+      for (size_t j = 0; j < links.size(); ++j)
+      {
+        REQUIRE(links[j] < 2000);
+        REQUIRE(links[j] != i);
+        REQUIRE(hnsw.Levels()[links[j]] >= level);
+      }
+
+      if (level == 0)
+        totalLinks += links.size();
+    }
+  }
+
+  // Every node should be linked to some other node.
+  REQUIRE(totalLinks >= 2000);
+}
+
+/**
+ * Make sure that most of the true nearest neighbors are found, for both
+ * monochromatic and bichromatic search.
+ */
+TEST_CASE("HNSWRecallTest", "[HNSWTest]")
+{
+  arma::mat data(32, 3000, arma::fill::randu);
+  arma::mat queries(32, 200, arma::fill::randu);
+
+  KNN knn(data);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+
+  HNSWSearch<> hnsw(data, 16, 100, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  knn.Search(queries, 10, trueNeighbors, trueDistances);
+  hnsw.Search(queries, 10, neighbors, distances);
+  REQUIRE(HNSWRecall(neighbors, trueNeighbors) >= 0.9);
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    // The distances are exact.
+    for (size_t i = 0; i < 10; ++i)
+    {
+      REQUIRE(distances(i, q) == Approx(arma::norm(queries.col(q) -
+          data.col(neighbors(i, q)))).epsilon(1e-7));
+    }
+  }
+
+  knn.Search(10, trueNeighbors, trueDistances);
+  hnsw.Search(10, neighbors, distances);
+  REQUIRE(HNSWRecall(neighbors, trueNeighbors) >= 0.9);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    for (size_t j = 0; j < 10; ++j)
+      REQUIRE(neighbors(j, i) != i);
+}
+
+/**
+ * Search with a kernel-induced metric.  The distance induced by the Gaussian
+ * kernel increases with the Euclidean distance, so the neighbors are the same.
+ */
+TEST_CASE("HNSWIPMetricTest", "[HNSWTest]")
+{
+  arma::mat data(8, 2000, arma::fill::randu);
+  arma::mat queries(8, 100, arma::fill::randu);
+
+  typedef metric::IPMetric<kernel::GaussianKernel> MetricType;
+  HNSWSearch<MetricType> hnsw(data, 16, 100, 100,
+      MetricType(kernel::GaussianKernel(2.0)));
+
+  KNN knn(data);
+  arma::Mat<size_t> trueNeighbors, neighbors;
+  arma::mat trueDistances, distances;
+  knn.Search(queries, 5, trueNeighbors, trueDistances);
+  hnsw.Search(queries, 5, neighbors, distances);
+
+  REQUIRE(HNSWRecall(neighbors, trueNeighbors) >= 0.9);
+}
+
+/**
+ * If there are fewer reference points than k, the remaining neighbors should
+ * be left empty.
+ */
+TEST_CASE("HNSWSmallReferenceSetTest", "[HNSWTest]")
+{
+  arma::mat data(4, 6, arma::fill::randu);
+  HNSWSearch<> hnsw(data);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(data, 8, neighbors, distances);
+
+  for (size_t q = 0; q < 6; ++q)
+  {
+    REQUIRE(neighbors(0, q) == q);
+    REQUIRE(neighbors(6, q) == SIZE_MAX);
+    REQUIRE(distances(7, q) == DBL_MAX);
+  }
+
+  HNSWSearch<> untrained;
+  REQUIRE_THROWS_AS(untrained.Search(data, 2, neighbors, distances),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(HNSWSearch<>(data, 1), std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized model gives the same results, with and without
+ * memory-mapped matrices.
+ */
+TEST_CASE("HNSWSerializationTest", "[HNSWTest]")
+{
+  arma::mat data(6, 1000, arma::fill::randu);
+  arma::mat queries(6, 50, arma::fill::randu);
+  HNSWSearch<> hnsw(data, 8, 50);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queries, 5, neighbors, distances);
+
+  for (size_t mapped = 0; mapped < 2; ++mapped)
+  {
+    if (mapped)
+    {
+      hnsw.MapReferenceSet("hnsw_test_reference.bin");
+      hnsw.MapGraph("hnsw_test_graph.bin");
+      REQUIRE(hnsw.ReferenceMapFile() == "hnsw_test_reference.bin");
+    }
+
+    HNSWSearch<> xmlHnsw, textHnsw, binaryHnsw;
+    SerializeObjectAll(hnsw, xmlHnsw, textHnsw, binaryHnsw);
+
+    arma::Mat<size_t> xmlNeighbors, textNeighbors, binaryNeighbors;
+    arma::mat xmlDistances, textDistances, binaryDistances;
+    xmlHnsw.Search(queries, 5, xmlNeighbors, xmlDistances);
+    textHnsw.Search(queries, 5, textNeighbors, textDistances);
+    binaryHnsw.Search(queries, 5, binaryNeighbors, binaryDistances);
+
+    CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+    CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+
+    // Copies share the mapping.
+    HNSWSearch<> copy(hnsw);
+    arma::Mat<size_t> copyNeighbors;
+    arma::mat copyDistances;
+    copy.Search(queries, 5, copyNeighbors, copyDistances);
+    CheckMatrices(neighbors, copyNeighbors);
+  }
+
+  // Training again drops the mappings, so the files can be removed.
+  hnsw.Train(data);
+  REQUIRE(hnsw.ReferenceMapFile().empty());
+  REQUIRE(hnsw.GraphMapFile().empty());
+  remove("hnsw_test_reference.bin");
+  remove("hnsw_test_graph.bin");
+}
@@ -15,7 +15,9 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
+#include <mlpack/methods/hoeffding_trees/quantile_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
+#include <mlpack/methods/hoeffding_trees/hoeffding_forest.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -1463,4 +1465,468 @@ BOOST_AUTO_TEST_CASE(HoeffdingTreeModelSerializationTest)
   }
 }
 
+/**
+ * Make sure that merging two HoeffdingCategoricalSplits gives the same
+ * statistics as training one split on all the points.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingCategoricalSplitMergeTest)
+{
+  HoeffdingCategoricalSplit<GiniImpurity> split(5, 3);
+  HoeffdingCategoricalSplit<GiniImpurity> split1(5, 3);
+  HoeffdingCategoricalSplit<GiniImpurity> split2(5, 3);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    const size_t value = mlpack::math::RandInt(5);
+    const size_t label = (value + mlpack::math::RandInt(2)) % 3;
+    split.Train(value, label);
+    if (i % 2 == 0)
+      split1.Train(value, label);
+    else
+      split2.Train(value, label);
+  }
+
+  split1.Merge(split2);
+
+  double bestGain, secondBestGain, mergedBestGain, mergedSecondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  split1.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  BOOST_REQUIRE_CLOSE(bestGain, mergedBestGain, 1e-5);
+  BOOST_REQUIRE_EQUAL(split.MajorityClass(), split1.MajorityClass());
+  BOOST_REQUIRE_CLOSE(split.MajorityProbability(), split1.MajorityProbability(),
+      1e-5);
+
+  // After a reset, the merge should not change anything.
+  split2.Reset();
+  split1.Merge(split2);
+  split1.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  BOOST_REQUIRE_CLOSE(bestGain, mergedBestGain, 1e-5);
+}
+
+/**
+ * Make sure that merging an unbinned HoeffdingNumericSplit into a binned one,
+ * and the other way around, gives the same statistics as training one split on
+ * all the points.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingNumericSplitMergeTest)
+{
+  arma::vec values(190, arma::fill::randu);
+  arma::Col<size_t> labels(190);
+  for (size_t i = 0; i < 190; ++i)
+    labels[i] = (values[i] > 0.4) ? 1 : 0;
+
+  HoeffdingNumericSplit<GiniImpurity> split(2, 10, 100);
+  HoeffdingNumericSplit<GiniImpurity> binnedSplit(2, 10, 100);
+  HoeffdingNumericSplit<GiniImpurity> unbinnedSplit(2, 10, 100);
+  for (size_t i = 0; i < 190; ++i)
+  {
+    split.Train(values[i], labels[i]);
+    if (i < 150)
+      binnedSplit.Train(values[i], labels[i]);
+    else
+      unbinnedSplit.Train(values[i], labels[i]);
+  }
+
+  HoeffdingNumericSplit<GiniImpurity> otherSplit(unbinnedSplit);
+  binnedSplit.Merge(unbinnedSplit);
+  otherSplit.Merge(binnedSplit);
+
+  double bestGain, secondBestGain, mergedBestGain, mergedSecondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  binnedSplit.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  BOOST_REQUIRE_GT(bestGain, 0.0);
+  BOOST_REQUIRE_CLOSE(bestGain, mergedBestGain, 1e-5);
+  BOOST_REQUIRE_EQUAL(split.MajorityClass(), binnedSplit.MajorityClass());
+
+  // The unbinned split takes the bins of the binned split, which are the same
+  // as the bins of the split trained on all the points.
+  arma::Col<size_t> childMajorities, mergedChildMajorities;
+  NumericSplitInfo<> info, mergedInfo;
+  split.Split(childMajorities, info);
+  otherSplit.Split(mergedChildMajorities, mergedInfo);
+  BOOST_REQUIRE_EQUAL(childMajorities.n_elem, mergedChildMajorities.n_elem);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const double value = mlpack::math::Random();
+    BOOST_REQUIRE_EQUAL(info.CalculateDirection(value),
+        mergedInfo.CalculateDirection(value));
+  }
+
+  // A reset split keeps its bins, and merging it changes nothing.
+  unbinnedSplit = binnedSplit;
+  unbinnedSplit.Reset();
+  binnedSplit.Merge(unbinnedSplit);
+  binnedSplit.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  BOOST_REQUIRE_CLOSE(bestGain, mergedBestGain, 1e-5);
+}
+
+/**
+ * Make sure that merging two BinaryNumericSplits gives the same split as
+ * training one split on all the points.
+ */
+BOOST_AUTO_TEST_CASE(BinaryNumericSplitMergeTest)
+{
+  BinaryNumericSplit<GiniImpurity> split(2);
+  BinaryNumericSplit<GiniImpurity> split1(2);
+  BinaryNumericSplit<GiniImpurity> split2(2);
+  for (size_t i = 0; i < 300; ++i)
+  {
+    const double value = mlpack::math::Random();
+    const size_t label = (value > 0.6) ? 1 : 0;
+    split.Train(value, label);
+    if (i % 3 == 0)
+      split1.Train(value, label);
+    else
+      split2.Train(value, label);
+  }
+
+  split1.Merge(split2);
+
+  double bestGain, secondBestGain, mergedBestGain, mergedSecondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  split1.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  BOOST_REQUIRE_CLOSE(bestGain, mergedBestGain, 1e-5);
+  BOOST_REQUIRE_EQUAL(split.MajorityClass(), split1.MajorityClass());
+
+  arma::Col<size_t> childMajorities, mergedChildMajorities;
+  BinaryNumericSplitInfo<> info, mergedInfo;
+  split.Split(childMajorities, info);
+  split1.Split(mergedChildMajorities, mergedInfo);
+  BOOST_REQUIRE_EQUAL(childMajorities[0], mergedChildMajorities[0]);
+  BOOST_REQUIRE_EQUAL(childMajorities[1], mergedChildMajorities[1]);
+}
+
+/**
+ * With a block size of 1, ParallelTrain() should build the same tree as
+ * streaming training.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeParallelTrainBlockSizeOneTest)
+{
+  arma::mat dataset(3, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < 5000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) ? ((dataset(1, i) > 0.3) ? 1 : 2) : 0;
+
+  DatasetInfo info(3);
+  HoeffdingTree<> streamTree(info, 3);
+  HoeffdingTree<> parallelTree(info, 3);
+  streamTree.Train(dataset, labels, false);
+  parallelTree.ParallelTrain(dataset, labels, 1);
+
+  BOOST_REQUIRE_GT(streamTree.NumDescendants(), 0);
+  BOOST_REQUIRE_EQUAL(streamTree.NumDescendants(),
+      parallelTree.NumDescendants());
+
+  arma::Row<size_t> streamPredictions, parallelPredictions;
+  arma::rowvec streamProbabilities, parallelProbabilities;
+  streamTree.Classify(dataset, streamPredictions, streamProbabilities);
+  parallelTree.Classify(dataset, parallelPredictions, parallelProbabilities);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(streamPredictions[i], parallelPredictions[i]);
+    BOOST_REQUIRE_CLOSE(streamProbabilities[i], parallelProbabilities[i],
+        1e-5);
+  }
+}
+
+/**
+ * Make sure that ParallelTrain() with the default blocks learns an easy
+ * dataset with categorical and numeric dimensions.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeParallelTrainTest)
+{
+  DatasetInfo info(3);
+  info.MapString<double>("cat0", 1);
+  info.MapString<double>("cat1", 1);
+  info.MapString<double>("cat2", 1);
+
+  arma::mat dataset(3, 20000);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::RandInt(3);
+    dataset(2, i) = mlpack::math::Random();
+    labels[i] = (size_t) dataset(1, i);
+  }
+
+  HoeffdingTree<> tree(info, 3);
+  tree.ParallelTrain(dataset, labels);
+
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), 1);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+  BOOST_REQUIRE_GT(double(correct) / 20000.0, 0.95);
+}
+
+/**
+ * Make sure that a QuantileSketch holds a bounded number of values, keeps the
+ * total weight, and estimates ranks well.
+ */
+BOOST_AUTO_TEST_CASE(QuantileSketchRankTest)
+{
+  QuantileSketch<> sketch(100);
+  for (size_t i = 0; i < 100000; ++i)
+  {
+    sketch.Insert(mlpack::math::Random());
+    BOOST_REQUIRE_LE(sketch.NumRetained(), 400);
+  }
+
+  BOOST_REQUIRE_EQUAL(sketch.Count(), 100000);
+
+  std::vector<double> values;
+  std::vector<size_t> weights;
+  sketch.WeightedValues(values, weights);
+  BOOST_REQUIRE_EQUAL(values.size(), sketch.NumRetained());
+
+  size_t total = 0;
+  arma::vec ranks(3, arma::fill::zeros);
+  const arma::vec quantiles("0.1 0.5 0.9");
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    total += weights[i];
+    for (size_t q = 0; q < 3; ++q)
+      if (values[i] < quantiles[q])
+        ranks[q] += weights[i];
+  }
+
+  BOOST_REQUIRE_EQUAL(total, 100000);
+  for (size_t q = 0; q < 3; ++q)
+    BOOST_REQUIRE_SMALL(ranks[q] / 100000.0 - quantiles[q], 0.05);
+}
+
+/**
+ * Merging two QuantileSketches should give a sketch of both streams.
+ */
+BOOST_AUTO_TEST_CASE(QuantileSketchMergeTest)
+{
+  QuantileSketch<> sketch1(100), sketch2(100);
+  for (size_t i = 0; i < 50000; ++i)
+  {
+    sketch1.Insert(mlpack::math::Random());
+    sketch2.Insert(mlpack::math::Random() + 1.0);
+  }
+
+  sketch1.Merge(sketch2);
+  BOOST_REQUIRE_EQUAL(sketch1.Count(), 100000);
+  BOOST_REQUIRE_LE(sketch1.NumRetained(), 400);
+
+  std::vector<double> values;
+  std::vector<size_t> weights;
+  sketch1.WeightedValues(values, weights);
+
+  size_t total = 0;
+  size_t below = 0;
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    total += weights[i];
+    if (values[i] < 1.0)
+      below += weights[i];
+  }
+
+  BOOST_REQUIRE_EQUAL(total, 100000);
+  BOOST_REQUIRE_SMALL(below / 100000.0 - 0.5, 0.05);
+
+  sketch1.Reset();
+  BOOST_REQUIRE_EQUAL(sketch1.Count(), 0);
+  BOOST_REQUIRE_EQUAL(sketch1.NumRetained(), 0);
+}
+
+/**
+ * Create a QuantileNumericSplit object, feed it a bunch of samples where
+ * anything less than 1.0 is class 0 and anything greater is class 1.  Then make
+ * sure it can perform a perfect split, without keeping all the samples.
+ */
+BOOST_AUTO_TEST_CASE(QuantileNumericSplitSimpleSplitTest)
+{
+  QuantileNumericSplit<GiniImpurity> split(2, 50); // 2 classes.
+
+  // Feed it samples.
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    split.Train(mlpack::math::Random(), 0);
+    split.Train(mlpack::math::Random() + 1.0, 1);
+  }
+
+  BOOST_REQUIRE_LE(split.NumRetained(), 2 * 200);
+  BOOST_REQUIRE_EQUAL(split.MajorityProbability(), 0.5);
+
+  // The Gini impurity for the unsplit node is 2 * (0.5^2) = 0.5, and the Gini
+  // impurity for the children is 0.
+  double bestGain, secondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  BOOST_REQUIRE_CLOSE(bestGain, 0.5, 1e-5);
+  BOOST_REQUIRE_GT(bestGain, secondBestGain);
+
+  // Now, when we ask it to split, ensure that the split value is reasonable.
+  arma::Col<size_t> childMajorities;
+  BinaryNumericSplitInfo<> splitInfo;
+  split.Split(childMajorities, splitInfo);
+
+  BOOST_REQUIRE_EQUAL(childMajorities[0], 0);
+  BOOST_REQUIRE_EQUAL(childMajorities[1], 1);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(0.5), 0);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(1.5), 1);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(-1.0), 0);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(0.9), 0);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(1.1), 1);
+}
+
+/**
+ * Make sure a HoeffdingTree with the QuantileNumericSplit learns a simple
+ * numeric dataset, and that it survives serialization.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeQuantileNumericSplitTest)
+{
+  arma::mat dataset(2, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) ? 1 : 0;
+
+  DatasetInfo info(2);
+  typedef HoeffdingTree<GiniImpurity, QuantileDoubleNumericSplit,
+      HoeffdingCategoricalSplit> TreeType;
+  TreeType tree(dataset, info, labels, 2, false);
+
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), 0);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+  BOOST_REQUIRE_GT(double(correct) / 20000.0, 0.95);
+
+  TreeType xmlTree(info, 2), textTree(info, 2), binaryTree(info, 2);
+  SerializeObjectAll(tree, xmlTree, textTree, binaryTree);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  xmlTree.Classify(dataset, xmlPredictions);
+  textTree.Classify(dataset, textPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], xmlPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], textPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], binaryPredictions[i]);
+  }
+}
+
+/**
+ * Make sure that a HoeffdingForest trained on a stream of batches learns a
+ * simple concept at least as well as a single streaming tree.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestStreamingTest)
+{
+  arma::mat dataset(3, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+    labels[i] = (dataset(0, i) + dataset(1, i) > 1.0) ? 1 : 0;
+
+  DatasetInfo info(3);
+  HoeffdingForest<> forest(info, 2, 10);
+  HoeffdingTree<> tree(info, 2);
+  for (size_t i = 0; i < 20000; i += 1000)
+  {
+    forest.Train(dataset.cols(i, i + 999), labels.cols(i, i + 999));
+    tree.Train(dataset.cols(i, i + 999), labels.cols(i, i + 999), false);
+  }
+
+  BOOST_REQUIRE_EQUAL(forest.NumTrees(), 10);
+  for (size_t t = 0; t < forest.NumTrees(); ++t)
+    BOOST_REQUIRE_GT(forest.Tree(t).NumChildren(), 0);
+
+  arma::mat testData(3, 5000, arma::fill::randu);
+  arma::Row<size_t> testLabels(5000);
+  for (size_t i = 0; i < 5000; ++i)
+    testLabels[i] = (testData(0, i) + testData(1, i) > 1.0) ? 1 : 0;
+
+  arma::Row<size_t> predictions, treePredictions;
+  arma::rowvec probabilities;
+  forest.Classify(testData, predictions, probabilities);
+  tree.Classify(testData, treePredictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 5000);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, 5000);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], forest.Classify(testData.col(i)));
+    BOOST_REQUIRE_GE(probabilities[i], 0.5);
+    BOOST_REQUIRE_LE(probabilities[i], 1.0);
+  }
+
+  const double accuracy = arma::accu(predictions == testLabels) / 5000.0;
+  const double treeAccuracy = arma::accu(treePredictions == testLabels) /
+      5000.0;
+  BOOST_REQUIRE_GT(accuracy, 0.85);
+  BOOST_REQUIRE_GT(accuracy, treeAccuracy - 0.05);
+}
+
+/**
+ * Make sure that the Poisson weights of a HoeffdingForest only depend on the
+ * random seed.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestReproducibilityTest)
+{
+  arma::mat dataset(2, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < 5000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) ? 1 : 0;
+
+  DatasetInfo info(2);
+  math::RandomSeed(17);
+  HoeffdingForest<> forest1(dataset, info, labels, 2, 5);
+  math::RandomSeed(17);
+  HoeffdingForest<> forest2(dataset, info, labels, 2, 5);
+
+  for (size_t t = 0; t < 5; ++t)
+  {
+    BOOST_REQUIRE_EQUAL(forest1.Tree(t).NumDescendants(),
+        forest2.Tree(t).NumDescendants());
+  }
+
+  arma::Row<size_t> predictions1, predictions2;
+  forest1.Classify(dataset, predictions1);
+  forest2.Classify(dataset, predictions2);
+  for (size_t i = 0; i < 5000; ++i)
+    BOOST_REQUIRE_EQUAL(predictions1[i], predictions2[i]);
+}
+
+/**
+ * Make sure that a HoeffdingForest can be serialized, and copied.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestSerializationTest)
+{
+  arma::mat dataset(2, 10000, arma::fill::randu);
+  arma::Row<size_t> labels(10000);
+  for (size_t i = 0; i < 10000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) ? 1 : 0;
+
+  DatasetInfo info(2);
+  HoeffdingForest<> forest(dataset, info, labels, 2, 4);
+
+  HoeffdingForest<> xmlForest(info, 2, 1), textForest, binaryForest;
+  SerializeObjectAll(forest, xmlForest, textForest, binaryForest);
+  HoeffdingForest<> copiedForest(forest);
+
+  BOOST_REQUIRE_EQUAL(xmlForest.NumTrees(), 4);
+  BOOST_REQUIRE_EQUAL(textForest.NumTrees(), 4);
+  BOOST_REQUIRE_EQUAL(binaryForest.NumTrees(), 4);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions, copiedPredictions;
+  forest.Classify(dataset, predictions);
+  xmlForest.Classify(dataset, xmlPredictions);
+  textForest.Classify(dataset, textPredictions);
+  binaryForest.Classify(dataset, binaryPredictions);
+  copiedForest.Classify(dataset, copiedPredictions);
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], xmlPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], textPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], binaryPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], copiedPredictions[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -326,6 +326,86 @@ BOOST_AUTO_TEST_CASE(HPTTest)
   BOOST_REQUIRE_CLOSE(expectedObjective, objective, 1e-5);
 }
 
+/**
+ * Test that HyperParameterTuner with SuccessiveHalving and a minimum budget of
+ * 1 is the same as grid search.
+ */
+BOOST_AUTO_TEST_CASE(HPTSuccessiveHalvingFullBudgetTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, SuccessiveHalving>
+      hpt(validationSize, xs, ys);
+  hpt.Optimizer().MinBudget() = 1.0;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE_CLOSE(expectedObjective, hpt.BestObjective(), 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda1, actualLambda1, 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda2, actualLambda2, 1e-5);
+}
+
+/**
+ * Test that HyperParameterTuner with SuccessiveHalving returns a configuration
+ * of the grid, with its objective and model for the full training set.
+ */
+BOOST_AUTO_TEST_CASE(HPTSuccessiveHalvingTest)
+{
+  arma::mat xs = arma::randn(5, 200);
+  arma::vec beta = arma::randn(5, 1);
+  arma::rowvec ys = beta.t() * xs + 0.1 * arma::randn<arma::rowvec>(200);
+  const double validationSize = 0.3;
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, bestObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      bestObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, SuccessiveHalving>
+      hpt(validationSize, xs, ys);
+  hpt.Optimizer().MinBudget() = 0.25;
+  hpt.Optimizer().Eta() = 2.0;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE(arma::any(lambda1Set == actualLambda1));
+  BOOST_REQUIRE(arma::any(lambda2Set == actualLambda2));
+
+  // The objective must be the one with the full training set, and can't be
+  // better than the best one of the grid.
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  const double objective = cv.Evaluate(transposeData, useCholesky,
+      actualLambda1, actualLambda2);
+  BOOST_REQUIRE_CLOSE(objective, hpt.BestObjective(), 1e-5);
+  BOOST_REQUIRE_GE(hpt.BestObjective(), bestObjective * (1 - 1e-7));
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  BOOST_REQUIRE_CLOSE(MSE::Evaluate(hpt.BestModel(), validationXs,
+      validationYs), objective, 1e-5);
+}
+
 /**
  * Test HyperParamterTuner maximizes Accuracy rather than minimizes it.
  */
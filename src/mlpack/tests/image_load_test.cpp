@@ -132,6 +132,81 @@ TEST_CASE("SaveImageMatAPITest", "[ImageLoadTest]")
   remove("APITest.bmp");
 }
 
+/**
+ * Test that LoadImageBatch() gives the same images as Load(), normalized.
+ */
+TEST_CASE("LoadImageBatchTest", "[ImageLoadTest]")
+{
+  std::vector<std::string> files = { "test_image.png", "test_image.png",
+      "test_image.png" };
+  arma::Mat<unsigned char> images;
+  data::ImageInfo info;
+  REQUIRE(data::Load(files, images, info, false) == true);
+
+  arma::mat batch;
+  data::ImageInfo batchInfo(0, 0, 3);
+  arma::vec mean("10 20 30");
+  arma::vec stddev("2 4 8");
+  REQUIRE(data::LoadImageBatch(files, batch, batchInfo, data::NoResize,
+      0.5, mean, stddev) == true);
+
+  REQUIRE(batchInfo.Width() == 50);
+  REQUIRE(batchInfo.Height() == 50);
+  REQUIRE(batch.n_rows == images.n_rows);
+  REQUIRE(batch.n_cols == 3);
+  for (size_t i = 0; i < batch.n_elem; ++i)
+  {
+    const size_t c = (i % batch.n_rows) % 3;
+    REQUIRE(batch[i] == Approx((0.5 * images[i] - mean[c]) / stddev[c])
+        .epsilon(1e-7));
+  }
+
+  // Images can be loaded in grayscale.
+  arma::Mat<unsigned char> gray;
+  data::ImageInfo grayInfo(0, 0, 1);
+  REQUIRE(data::LoadImageBatch(files, gray, grayInfo) == true);
+  REQUIRE(gray.n_rows == 50 * 50);
+  REQUIRE(gray.n_cols == 3);
+}
+
+/**
+ * Test that LoadImageBatch() resizes and crops images of other sizes.
+ */
+TEST_CASE("LoadImageBatchResizeTest", "[ImageLoadTest]")
+{
+  // A uniform image stays uniform when it is resized.
+  data::ImageInfo info(8, 6, 3);
+  arma::Mat<unsigned char> uniform(8 * 6 * 3, 1);
+  uniform.fill(77);
+  REQUIRE(data::Save("batch_uniform.bmp", uniform, info, false) == true);
+
+  std::vector<std::string> files = { "test_image.png", "batch_uniform.bmp" };
+
+  // Without resizing, the sizes must match.
+  arma::Mat<unsigned char> images;
+  data::ImageInfo noResizeInfo(0, 0, 3);
+  REQUIRE(data::LoadImageBatch(files, images, noResizeInfo) == false);
+
+  data::ImageInfo stretchInfo(20, 10, 3);
+  REQUIRE(data::LoadImageBatch(files, images, stretchInfo,
+      data::StretchResize) == true);
+  REQUIRE(images.n_rows == 20 * 10 * 3);
+  REQUIRE(images.n_cols == 2);
+  REQUIRE(arma::all(images.col(1) == 77));
+
+  data::ImageInfo cropInfo(5, 9, 3);
+  REQUIRE(data::LoadImageBatch(files, images, cropInfo,
+      data::CenterCropResize) == true);
+  REQUIRE(images.n_rows == 5 * 9 * 3);
+  REQUIRE(arma::all(images.col(1) == 77));
+
+  // Invalid numbers of channels are errors.
+  data::ImageInfo badInfo(0, 0, 5);
+  REQUIRE(data::LoadImageBatch(files, images, badInfo) == false);
+
+  remove("batch_uniform.bmp");
+}
+
 /**
  * Serialization test for the ImageInfo class.
  */
@@ -266,6 +266,94 @@ TEST_CASE("ListwiseDeletionTest", "[ImputationTest]")
   REQUIRE(rowWiseInput(1, 3) == Approx(8.0).epsilon(1e-7));
 }
 
+/**
+ * Impute the given dimensions of the given matrix at once, and one dimension at
+ * a time, and make sure the results are the same.
+ */
+template<typename StrategyType>
+void CheckMultipleDimensionImputation(StrategyType& strategy,
+                                      const arma::mat& input,
+                                      const std::vector<size_t>& dimensions,
+                                      const bool columnMajor)
+{
+  arma::mat once(input);
+  arma::mat separately(input);
+  std::vector<double> mappedValues(dimensions.size(), 0.0);
+
+  strategy.Impute(once, mappedValues, dimensions, columnMajor);
+  for (size_t d = 0; d < dimensions.size(); ++d)
+    strategy.Impute(separately, 0.0, dimensions[d], columnMajor);
+
+  REQUIRE(once.n_rows == separately.n_rows);
+  REQUIRE(once.n_cols == separately.n_cols);
+  CheckMatrices(once, separately);
+}
+
+/**
+ * Make sure that imputing several dimensions at once gives the same results as
+ * imputing them one at a time, for each strategy.
+ */
+TEST_CASE("MultipleDimensionImputationTest", "[ImputationTest]")
+{
+  // Use small integers so that many values are missing (0 or NaN).
+  arma::mat input = arma::randi<arma::mat>(8, 1000, arma::distr_param(0, 6));
+  for (size_t i = 0; i < input.n_elem; i += 37)
+    input[i] = std::numeric_limits<double>::quiet_NaN();
+  // Keep the last dimension free of missing values.
+  input.row(7).ones();
+
+  const std::vector<size_t> dimensions = { 0, 2, 3, 6, 7 };
+  const std::vector<size_t> rowDimensions = { 1, 500, 999 };
+
+  MeanImputation<double> mean;
+  CheckMultipleDimensionImputation(mean, input, dimensions, true);
+  CheckMultipleDimensionImputation(mean, input, rowDimensions, false);
+
+  MedianImputation<double> median;
+  CheckMultipleDimensionImputation(median, input, dimensions, true);
+  CheckMultipleDimensionImputation(median, input, rowDimensions, false);
+
+  CustomImputation<double> custom(-1.0);
+  CheckMultipleDimensionImputation(custom, input, dimensions, true);
+  CheckMultipleDimensionImputation(custom, input, rowDimensions, false);
+
+  ListwiseDeletion<double> listwise;
+  CheckMultipleDimensionImputation(listwise, input, { 3, 7 }, true);
+  CheckMultipleDimensionImputation(listwise, input.t(), { 3, 7 }, false);
+}
+
+/**
+ * Make sure that invalid dimensions are rejected when imputing several
+ * dimensions at once, and that the Imputer can impute several dimensions.
+ */
+TEST_CASE("MultipleDimensionImputerTest", "[ImputationTest]")
+{
+  arma::mat input("3.0 0.0 2.0 0.0;"
+                  "5.0 6.0 0.0 6.0;"
+                  "9.0 8.0 4.0 8.0;");
+
+  MeanImputation<double> mean;
+  REQUIRE_THROWS_AS(mean.Impute(input, std::vector<double>(2, 0.0),
+      std::vector<size_t>({ 0, 3 }), true), std::invalid_argument);
+  REQUIRE_THROWS_AS(mean.Impute(input, std::vector<double>(2, 0.0),
+      std::vector<size_t>({ 1, 1 }), true), std::invalid_argument);
+  REQUIRE_THROWS_AS(mean.Impute(input, std::vector<double>(1, 0.0),
+      std::vector<size_t>({ 0, 1 }), true), std::invalid_argument);
+
+  // Map the missing value to 0 in the first two dimensions.
+  DatasetMapper<IncrementPolicy> info(3);
+  REQUIRE(info.MapString<double>("a", 0) == 0.0);
+  REQUIRE(info.MapString<double>("a", 1) == 0.0);
+  Imputer<double, DatasetMapper<IncrementPolicy>, MeanImputation<double>>
+      imputer(info);
+  imputer.Impute(input, "a", { 0, 1 });
+
+  REQUIRE(input(0, 1) == Approx(2.5).epsilon(1e-7));
+  REQUIRE(input(0, 3) == Approx(2.5).epsilon(1e-7));
+  REQUIRE(input(1, 2) == Approx(17.0 / 3.0).epsilon(1e-7));
+  REQUIRE(input(2, 2) == Approx(4.0).epsilon(1e-7));
+}
+
 /**
  * Make sure we can map non-strings.
  */
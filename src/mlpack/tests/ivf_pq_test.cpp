@@ -0,0 +1,180 @@
+/**
+ * @file tests/ivf_pq_test.cpp
+ *
+ * Tests for the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ivf_pq/ivf_pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "serialization_catch.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Generate points around the given number of random centers.
+ */
+arma::mat GetIVFPQClusters(const size_t dims,
+                           const size_t points,
+                           const size_t clusters)
+{
+  const arma::mat centers = 10 * arma::randu<arma::mat>(dims, clusters);
+  arma::mat data = 0.5 * arma::randn<arma::mat>(dims, points);
+  for (size_t i = 0; i < points; ++i)
+    data.col(i) += centers.col(i % clusters);
+
+  return data;
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+TEST_CASE("IVFPQInvalidParametersTest", "[IVFPQTest]")
+{
+  arma::mat data(8, 300, arma::fill::randu);
+
+  REQUIRE_THROWS_AS(IVFPQSearch<>(data, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch<>(data, 10, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch<>(data, 10, 9), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch<>(data, 10, 4, 257), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch<>(data, 400, 4, 16), std::invalid_argument);
+
+  // Searching before training, or with the wrong dimensionality.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  IVFPQSearch<> untrained(10, 4, 16);
+  REQUIRE_THROWS_AS(untrained.Search(data, 5, neighbors, distances),
+      std::runtime_error);
+
+  IVFPQSearch<> ivfpq(data, 10, 4, 16);
+  arma::mat queries(7, 10, arma::fill::randu);
+  REQUIRE_THROWS_AS(ivfpq.Search(queries, 5, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the index is well-formed: every reference point is in exactly
+ * one list, and has one byte per subspace.
+ */
+TEST_CASE("IVFPQIndexTest", "[IVFPQTest]")
+{
+  arma::mat data = GetIVFPQClusters(10, 1000, 10);
+  IVFPQSearch<> ivfpq(data, 10, 3, 32);
+
+  REQUIRE(ivfpq.CoarseCentroids().n_cols == 10);
+  REQUIRE(ivfpq.Codebooks().size() == 3);
+  REQUIRE(ivfpq.Codebooks()[0].n_rows + ivfpq.Codebooks()[1].n_rows +
+      ivfpq.Codebooks()[2].n_rows == 10);
+  REQUIRE(ivfpq.Codes().n_rows == 3);
+  REQUIRE(ivfpq.Codes().n_cols == 1000);
+  REQUIRE(ivfpq.ListOffsets().size() == 11);
+  REQUIRE(ivfpq.ListOffsets()[10] == 1000);
+  REQUIRE(arma::max(arma::vectorise(ivfpq.Codes())) < 32);
+
+  std::vector<size_t> seen(1000, 0);
+  for (size_t i = 0; i < ivfpq.ListIndices().size(); ++i)
+    ++seen[ivfpq.ListIndices()[i]];
+  for (size_t i = 0; i < seen.size(); ++i)
+    REQUIRE(seen[i] == 1);
+}
+
+/**
+ * When every list is visited, each reference point should be found as its own
+ * nearest neighbor (its quantization error is much smaller than the distances
+ * between points), and most of the true nearest neighbors should be found.
+ */
+TEST_CASE("IVFPQRecallTest", "[IVFPQTest]")
+{
+  arma::mat data = GetIVFPQClusters(16, 3000, 20);
+  IVFPQSearch<> ivfpq(data, 20, 8, 64, 20);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(data, 1, neighbors, distances);
+
+  size_t self = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    if (neighbors(0, i) == i)
+      ++self;
+  REQUIRE(self >= size_t(0.9 * data.n_cols));
+
+  // Compare with the exact neighbors of new points.
+  arma::mat queries = data.cols(0, 199) +
+      0.3 * arma::randn<arma::mat>(16, 200);
+  KNN knn(data);
+  arma::Mat<size_t> exactNeighbors;
+  arma::mat exactDistances;
+  knn.Search(queries, 10, exactNeighbors, exactDistances);
+  ivfpq.Search(queries, 10, neighbors, distances);
+
+  size_t found = 0;
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    for (size_t i = 0; i < 10; ++i)
+    {
+      REQUIRE(neighbors(i, q) < data.n_cols);
+      if (i > 0)
+        REQUIRE(distances(i, q) >= distances(i - 1, q));
+      for (size_t j = 0; j < 10; ++j)
+        if (neighbors(i, q) == exactNeighbors(j, q))
+          ++found;
+    }
+  }
+  REQUIRE(found >= size_t(0.4 * exactNeighbors.n_elem));
+}
+
+/**
+ * If the visited lists hold fewer than k points, the remaining neighbors should
+ * be left empty.
+ */
+TEST_CASE("IVFPQFewCandidatesTest", "[IVFPQTest]")
+{
+  arma::mat data = GetIVFPQClusters(6, 600, 6);
+  IVFPQSearch<> ivfpq(data, 6, 3, 16);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(data.cols(0, 9), 600, neighbors, distances, 1);
+
+  const std::vector<size_t>& offsets = ivfpq.ListOffsets();
+  size_t largestList = 0;
+  for (size_t l = 0; l < 6; ++l)
+    largestList = std::max(largestList, offsets[l + 1] - offsets[l]);
+
+  for (size_t q = 0; q < 10; ++q)
+  {
+    REQUIRE(neighbors(largestList, q) == SIZE_MAX);
+    REQUIRE(distances(largestList, q) == DBL_MAX);
+    REQUIRE(neighbors(0, q) != SIZE_MAX);
+  }
+}
+
+/**
+ * Make sure that a serialized index gives the same results.
+ */
+TEST_CASE("IVFPQSerializationTest", "[IVFPQTest]")
+{
+  arma::mat data = GetIVFPQClusters(8, 1000, 10);
+  IVFPQSearch<> ivfpq(data, 10, 4, 32, 3);
+
+  IVFPQSearch<> xmlIvfpq, textIvfpq, binaryIvfpq;
+  SerializeObjectAll(ivfpq, xmlIvfpq, textIvfpq, binaryIvfpq);
+
+  arma::mat queries = GetIVFPQClusters(8, 50, 10);
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  ivfpq.Search(queries, 5, neighbors, distances);
+  xmlIvfpq.Search(queries, 5, xmlNeighbors, xmlDistances);
+  textIvfpq.Search(queries, 5, textNeighbors, textDistances);
+  binaryIvfpq.Search(queries, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
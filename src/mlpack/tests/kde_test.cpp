@@ -1301,4 +1301,303 @@ BOOST_AUTO_TEST_CASE(GaussianBreadthDualKDTreeMonteCarloKDE)
   BOOST_REQUIRE_GT(correctResults, 70);
 }
 
+/**
+ * Test single-precision single-tree and dual-tree KDE against double-precision
+ * brute force results, and make sure single-precision models can be
+ * serialized.
+ */
+BOOST_AUTO_TEST_CASE(FloatKDETest)
+{
+  arma::fmat reference = arma::randu<arma::fmat>(2, 400);
+  arma::fmat query = arma::randu<arma::fmat>(2, 80);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.15;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(arma::conv_to<arma::mat>::from(reference),
+                                arma::conv_to<arma::mat>::from(query),
+                                bfEstimations,
+                                kernel);
+
+  typedef KDE<GaussianKernel,
+              metric::EuclideanDistance,
+              arma::fmat,
+              tree::KDTree> FloatKDE;
+
+  const KDEMode modes[] = { KDEMode::SINGLE_TREE_MODE,
+                            KDEMode::DUAL_TREE_MODE };
+  for (const KDEMode mode : modes)
+  {
+    metric::EuclideanDistance metric;
+    FloatKDE kde(relError, 0.0, kernel, mode, metric);
+    kde.Train(reference);
+
+    arma::vec treeEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+    kde.Evaluate(query, treeEstimations);
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError * 100);
+
+    FloatKDE kdeXml, kdeText, kdeBinary;
+    SerializeObjectAll(kde, kdeXml, kdeText, kdeBinary);
+
+    arma::vec xmlEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+    arma::vec textEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+    arma::vec binaryEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+    kdeXml.Evaluate(query, xmlEstimations);
+    kdeText.Evaluate(query, textEstimations);
+    kdeBinary.Evaluate(query, binaryEstimations);
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(treeEstimations[i], xmlEstimations[i],
+          relError * 100);
+      BOOST_REQUIRE_CLOSE(treeEstimations[i], textEstimations[i],
+          relError * 100);
+      BOOST_REQUIRE_CLOSE(treeEstimations[i], binaryEstimations[i],
+          relError * 100);
+    }
+  }
+}
+
+/**
+ * Test that evaluating queries in parallel gives results within the error
+ * tolerance of brute force, for both modes, with and without a query set.
+ */
+BOOST_AUTO_TEST_CASE(ParallelQueriesKDETest)
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 500);
+  const double kernelBandwidth = 0.3;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  EpanechnikovKernel kernel(kernelBandwidth);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<EpanechnikovKernel>(reference, query, bfEstimations, kernel);
+  arma::vec bfMonoEstimations = arma::vec(reference.n_cols,
+      arma::fill::zeros);
+  BruteForceKDE<EpanechnikovKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+
+  const KDEMode modes[] = { KDEMode::SINGLE_TREE_MODE,
+                            KDEMode::DUAL_TREE_MODE };
+  for (const KDEMode mode : modes)
+  {
+    metric::EuclideanDistance metric;
+    KDE<EpanechnikovKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+        kde(relError, 0.0, kernel, mode, metric);
+    kde.ParallelQueries() = true;
+    kde.Train(reference);
+
+    arma::vec treeEstimations;
+    kde.Evaluate(query, treeEstimations);
+    BOOST_REQUIRE_EQUAL(treeEstimations.n_elem, query.n_cols);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError * 100);
+
+    // The brute force estimations include each point with itself.
+    arma::vec monoEstimations;
+    kde.Evaluate(monoEstimations);
+    BOOST_REQUIRE_EQUAL(monoEstimations.n_elem, reference.n_cols);
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      const double selfEstimation = kernel.Evaluate(0.0) / reference.n_cols;
+      BOOST_REQUIRE_CLOSE(bfMonoEstimations[i] - selfEstimation,
+          monoEstimations[i], relError * 100);
+    }
+  }
+}
+
+/**
+ * Test that Monte Carlo estimations are still accurate when the queries are
+ * evaluated in parallel.
+ */
+BOOST_AUTO_TEST_CASE(ParallelQueriesMonteCarloKDETest)
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 200);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.4;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  const KDEMode modes[] = { KDEMode::SINGLE_TREE_MODE,
+                            KDEMode::DUAL_TREE_MODE };
+  for (const KDEMode mode : modes)
+  {
+    metric::EuclideanDistance metric;
+    KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+        kde(relError, 0.0, kernel, mode, metric, true, 0.95, 100, 3, 0.8);
+    kde.ParallelQueries() = true;
+    kde.Train(reference);
+
+    arma::vec treeEstimations;
+    kde.Evaluate(query, treeEstimations);
+
+    // The Monte Carlo estimation has a random component so it can fail.
+    // Therefore we require a reasonable amount of results to be right.
+    size_t correctResults = 0;
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      const double resultRelativeError =
+          std::abs((bfEstimations[i] - treeEstimations[i]) / bfEstimations[i]);
+      if (resultRelativeError < relError)
+        ++correctResults;
+    }
+
+    BOOST_REQUIRE_GT(correctResults, 70);
+  }
+}
+
+/**
+ * Test that the Hermite series expansions of the Gaussian kernel keep the
+ * results within the relative error tolerance, in both modes.
+ */
+BOOST_AUTO_TEST_CASE(SeriesExpansionKDETest)
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 200);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.3;
+  const double relError = 0.01;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  const KDEMode modes[] = { KDEMode::SINGLE_TREE_MODE,
+                            KDEMode::DUAL_TREE_MODE };
+  for (const KDEMode mode : modes)
+  {
+    metric::EuclideanDistance metric;
+    KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+        kde(relError, 0.0, kernel, mode, metric, false, 0.95, 100, 3, 0.4,
+        true, 4);
+    kde.Train(reference);
+
+    arma::vec treeEstimations;
+    kde.Evaluate(query, treeEstimations);
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i],
+          relError * 100);
+  }
+}
+
+/**
+ * Test monochromatic KDE with series expansions, where the expansion of a node
+ * must never be used for its own points.
+ */
+BOOST_AUTO_TEST_CASE(SeriesExpansionMonochromaticKDETest)
+{
+  arma::mat reference = arma::randu(2, 2000);
+  arma::vec bfEstimations = arma::vec(reference.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.3;
+  const double relError = 0.01;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfEstimations, kernel);
+
+  KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+      kde(relError, 0.0, kernel);
+  kde.SeriesExpansion() = true;
+  kde.SeriesOrder(4);
+  kde.Train(reference);
+
+  arma::vec treeEstimations;
+  kde.Evaluate(treeEstimations);
+
+  // The brute force estimations include each point with itself.
+  const double selfEstimation = kernel.Evaluate(0.0) / reference.n_cols;
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(bfEstimations[i] - selfEstimation, treeEstimations[i],
+        relError * 100);
+  }
+}
+
+/**
+ * Test that an order of 0 for the series expansions is rejected.
+ */
+BOOST_AUTO_TEST_CASE(SeriesOrderZeroTest)
+{
+  KDE<> kde;
+  BOOST_REQUIRE_THROW(kde.SeriesOrder(0), std::invalid_argument);
+}
+
+/**
+ * Test that binned KDE is close to the brute force estimations in 1, 2 and 3
+ * dimensions, for the Gaussian and Epanechnikov kernels.
+ */
+BOOST_AUTO_TEST_CASE(BinnedKDETest)
+{
+  for (size_t dim = 1; dim <= 3; ++dim)
+  {
+    arma::mat reference = arma::randu(dim, 2000);
+    arma::mat query = arma::randu(dim, 200);
+    const double kernelBandwidth = 0.3;
+    const size_t gridSize = (dim == 3) ? 64 : 128;
+
+    GaussianKernel gaussian(kernelBandwidth);
+    arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+    BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, gaussian);
+
+    KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+        kde(0.0, 0.0, gaussian, KDEMode::BINNED_MODE);
+    kde.GridSize(gridSize);
+    kde.Train(reference);
+
+    arma::vec binnedEstimations;
+    kde.Evaluate(query, binnedEstimations);
+    BOOST_REQUIRE_EQUAL(binnedEstimations.n_elem, query.n_cols);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], binnedEstimations[i], 1.0);
+
+    EpanechnikovKernel epanechnikov(kernelBandwidth);
+    bfEstimations.zeros();
+    BruteForceKDE<EpanechnikovKernel>(reference, query, bfEstimations,
+        epanechnikov);
+
+    KDE<EpanechnikovKernel, metric::EuclideanDistance, arma::mat,
+        tree::KDTree> ekde(0.0, 0.0, epanechnikov, KDEMode::BINNED_MODE);
+    ekde.GridSize(gridSize);
+    ekde.Train(reference);
+
+    ekde.Evaluate(query, binnedEstimations);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], binnedEstimations[i], 2.0);
+  }
+}
+
+/**
+ * Test that binned KDE rejects unsupported kernels and dimensions.
+ */
+BOOST_AUTO_TEST_CASE(BinnedKDEUnsupportedTest)
+{
+  arma::mat reference = arma::randu(4, 100);
+  arma::vec estimations;
+
+  KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+      kde(0.0, 0.0, GaussianKernel(), KDEMode::BINNED_MODE);
+  kde.Train(reference);
+  BOOST_REQUIRE_THROW(kde.Evaluate(reference, estimations),
+      std::invalid_argument);
+
+  reference = arma::randu(2, 100);
+  KDE<LaplacianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+      lkde(0.0, 0.0, LaplacianKernel(), KDEMode::BINNED_MODE);
+  lkde.Train(reference);
+  BOOST_REQUIRE_THROW(lkde.Evaluate(reference, estimations),
+      std::invalid_argument);
+
+  BOOST_REQUIRE_THROW(kde.GridSize(1), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_pca.hpp>
 
 #include "catch.hpp"
@@ -147,3 +148,40 @@ TEST_CASE("CircleTransformationTestNystroem", "[KernelPCATest]")
   REQUIRE(ranges[0].Contains(ranges[2]) == false);
   REQUIRE(ranges[1].Contains(ranges[2]) == false);
 }
+
+/**
+ * The leading eigenvalues of the kernel matrix approximated with random Fourier
+ * features should be close to the eigenvalues of the exact kernel matrix.
+ */
+template<typename KernelType>
+void RandomFourierEigenvalues(const KernelType& kernel)
+{
+  arma::mat dataset = arma::randn<arma::mat>(3, 200);
+
+  arma::mat transformed, eigvec, approxTransformed, approxEigvec;
+  arma::vec eigval, approxEigval;
+
+  KernelPCA<KernelType> p(kernel);
+  p.Apply(dataset, transformed, eigval, eigvec);
+
+  KernelPCA<KernelType, RandomFourierKernelRule<KernelType, 1000>> q(kernel);
+  q.Apply(dataset, approxTransformed, approxEigval, approxEigvec);
+
+  REQUIRE(approxEigval.n_elem == 1000);
+  REQUIRE(approxTransformed.n_rows == 1000);
+  REQUIRE(approxTransformed.n_cols == dataset.n_cols);
+
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(approxEigval[i] == Approx(eigval[i]).epsilon(0.15));
+}
+
+TEST_CASE("RandomFourierGaussianEigenvaluesTest", "[KernelPCATest]")
+{
+  RandomFourierEigenvalues(GaussianKernel(1.5));
+}
+
+TEST_CASE("RandomFourierLaplacianEigenvaluesTest", "[KernelPCATest]")
+{
+  RandomFourierEigenvalues(LaplacianKernel(1.5));
+}
+
@@ -20,6 +20,8 @@
 #include <mlpack/core/kernels/spherical_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 
@@ -195,6 +197,47 @@ TEST_CASE("MDDiagonalCovarianceTest", "[KernelTest]")
   REQUIRE(md.Evaluate(b, a) == Approx(52.0).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the Euclidean distance between points transformed by the
+ * Mahalanobis distance is the Mahalanobis distance, for a positive definite and
+ * for a singular covariance matrix.
+ */
+TEST_CASE("MDTransformTest", "[KernelTest]")
+{
+  arma::mat l = arma::randu<arma::mat>(5, 5);
+  arma::mat singular = arma::randu<arma::mat>(3, 5);
+  const arma::mat covariances[2] = { l.t() * l + 0.1 * arma::eye(5, 5),
+                                     singular.t() * singular };
+
+  arma::mat points = arma::randu<arma::mat>(5, 20);
+  for (size_t c = 0; c < 2; ++c)
+  {
+    MahalanobisDistance<true> md(covariances[c]);
+    MahalanobisDistance<false> squaredMd(covariances[c]);
+
+    arma::mat factor;
+    md.Factor(factor);
+    CheckMatrices(factor.t() * factor, covariances[c], 1e-5);
+
+    arma::mat transformed;
+    md.Transform(points, transformed);
+    REQUIRE(transformed.n_cols == points.n_cols);
+
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      for (size_t j = 0; j < points.n_cols; ++j)
+      {
+        const double distance = md.Evaluate(points.col(i), points.col(j));
+        REQUIRE(EuclideanDistance::Evaluate(transformed.col(i),
+            transformed.col(j)) == Approx(distance).margin(1e-7));
+        REQUIRE(SquaredEuclideanDistance::Evaluate(transformed.col(i),
+            transformed.col(j)) == Approx(squaredMd.Evaluate(points.col(i),
+            points.col(j))).margin(1e-7));
+      }
+    }
+  }
+}
+
 /**
  * More specific case with more difficult covariance matrix.
  */
@@ -620,6 +663,65 @@ TEST_CASE("PSpectrumStringEvaluateTest", "[KernelTest]")
   REQUIRE(p.Evaluate(b, a) == Approx(11.0).epsilon(1e-7));
 }
 
+/**
+ * Make sure the kernel matrix of DNA sequences computed with the codes of the
+ * substrings matches the counts of substrings, for short substrings (which
+ * have exact codes) and long substrings (which are hashed).
+ */
+TEST_CASE("PSpectrumStringKernelMatrixTest", "[KernelTest]")
+{
+  std::vector<std::vector<std::string> > dataset(1);
+  const char bases[] = "ACGT";
+  for (size_t i = 0; i < 30; ++i)
+  {
+    // Repeat a short random motif, so long substrings are shared.
+    std::string motif;
+    for (size_t j = 0; j < 3 + i % 5; ++j)
+      motif += bases[math::RandInt(4)];
+    std::string sequence;
+    while (sequence.size() < 100)
+    {
+      sequence += (math::Random() < 0.8) ? motif :
+          std::string(1, bases[math::RandInt(4)]);
+    }
+    dataset[0].push_back(sequence);
+  }
+
+  arma::mat indices(2, dataset[0].size());
+  indices.row(0).zeros();
+  indices.row(1) = arma::linspace<arma::rowvec>(0, dataset[0].size() - 1,
+      dataset[0].size());
+
+  const size_t lengths[] = { 4, 15 };
+  for (const size_t length : lengths)
+  {
+    PSpectrumStringKernel p(dataset, length);
+
+    arma::mat kernelMatrix;
+    KernelMatrix(p, indices, kernelMatrix);
+
+    REQUIRE(kernelMatrix.n_rows == dataset[0].size());
+    REQUIRE(kernelMatrix.n_cols == dataset[0].size());
+    for (size_t i = 0; i < dataset[0].size(); ++i)
+    {
+      for (size_t j = 0; j < dataset[0].size(); ++j)
+      {
+        double expected = 0.0;
+        for (const std::pair<const std::string, int>& count :
+             p.Counts()[0][i])
+        {
+          std::map<std::string, int>::const_iterator it =
+              p.Counts()[0][j].find(count.first);
+          if (it != p.Counts()[0][j].end())
+            expected += count.second * it->second;
+        }
+
+        REQUIRE(kernelMatrix(i, j) == Approx(expected).epsilon(1e-10));
+      }
+    }
+  }
+}
+
 /**
  * Cauchy Kernel test.
  */
@@ -632,3 +734,60 @@ TEST_CASE("CauchyKernelTest", "[KernelTest]")
   REQUIRE(ck.Evaluate(a, b) == Approx(0.92592588).epsilon(1e-7));
   REQUIRE(ck.Evaluate(b, a) == Approx(0.92592588).epsilon(1e-7));
 }
+
+/**
+ * Check that the kernel matrix computed by KernelMatrix() is the same as the
+ * kernel evaluated on each pair of points.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(const KernelType& kernel)
+{
+  arma::mat a = arma::randu<arma::mat>(5, 40);
+  arma::mat b = arma::randu<arma::mat>(5, 30);
+
+  arma::mat output;
+  KernelMatrix(kernel, a, b, output);
+  REQUIRE(output.n_rows == 40);
+  REQUIRE(output.n_cols == 30);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      REQUIRE(output(i, j) ==
+          Approx(kernel.Evaluate(a.col(i), b.col(j))).epsilon(1e-5).margin(
+          1e-7));
+    }
+  }
+
+  // The kernel matrix of a set of points with itself.
+  KernelMatrix(kernel, a, output);
+  REQUIRE(output.n_rows == 40);
+  REQUIRE(output.n_cols == 40);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < a.n_cols; ++j)
+    {
+      REQUIRE(output(i, j) ==
+          Approx(kernel.Evaluate(a.col(i), a.col(j))).epsilon(1e-5).margin(
+          1e-7));
+    }
+  }
+}
+
+/**
+ * Test KernelMatrix() for kernels that depend on the dot product, on the
+ * distance, and for other kernels.
+ */
+TEST_CASE("KernelMatrixTest", "[KernelTest]")
+{
+  CheckKernelMatrix(LinearKernel());
+  CheckKernelMatrix(PolynomialKernel(3.0, 1.0));
+  CheckKernelMatrix(HyperbolicTangentKernel(0.5, 1.0));
+  CheckKernelMatrix(GaussianKernel(0.7));
+  CheckKernelMatrix(LaplacianKernel(0.7));
+  CheckKernelMatrix(EpanechnikovKernel(1.0));
+  CheckKernelMatrix(TriangularKernel(1.5));
+  CheckKernelMatrix(SphericalKernel(0.9));
+  CheckKernelMatrix(CauchyKernel(0.7));
+  CheckKernelMatrix(CosineDistance());
+}
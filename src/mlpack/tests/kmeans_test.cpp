@@ -12,10 +12,15 @@
 #include <mlpack/methods/kmeans/kmeans.hpp>
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
+#include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/yinyang_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+#include <mlpack/methods/kmeans/spherical_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
 
@@ -531,6 +536,67 @@ TEST_CASE("SparseKMeansTest", "[KMeansTest]")
   REQUIRE(assignments[11] == clusterTwo);
 }
 
+/**
+ * Make sure spherical k-means separates sparse documents made of the words of
+ * three different topics, and gives the same clusters with dense data.
+ */
+TEST_CASE("SphericalKMeansSparseTest", "[KMeansTest]")
+{
+  // Document i has 10 distinct words of topic i % 3; each topic has 1000
+  // words.
+  const size_t numDocuments = 300;
+  arma::umat locations(2, 10 * numDocuments);
+  arma::vec values(10 * numDocuments);
+  for (size_t i = 0; i < numDocuments; ++i)
+  {
+    const arma::uvec words = arma::randperm(1000, 10) + 1000 * (i % 3);
+    arma::vec weights = arma::randu<arma::vec>(10) + 0.1;
+    weights /= arma::norm(weights);
+    for (size_t j = 0; j < 10; ++j)
+    {
+      locations(0, 10 * i + j) = words[j];
+      locations(1, 10 * i + j) = i;
+      values[10 * i + j] = weights[j];
+    }
+  }
+  arma::sp_mat data(locations, values, 3000, numDocuments);
+
+  // Start from the first document of each topic.
+  arma::mat initialCentroids(data.cols(0, 2));
+
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, SphericalKMeans, arma::sp_mat> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat centroids(initialCentroids);
+  kmeans.Cluster(data, 3, assignments, centroids, false, true);
+
+  REQUIRE(assignments[0] != assignments[1]);
+  REQUIRE(assignments[0] != assignments[2]);
+  REQUIRE(assignments[1] != assignments[2]);
+  for (size_t i = 0; i < numDocuments; ++i)
+    REQUIRE(assignments[i] == assignments[i % 3]);
+
+  for (size_t c = 0; c < 3; ++c)
+    REQUIRE(arma::norm(centroids.col(c)) == Approx(1.0).epsilon(1e-7));
+
+  // The dense version should give the same result.
+  arma::mat denseData(data);
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, SphericalKMeans> denseKMeans;
+  arma::Row<size_t> denseAssignments;
+  arma::mat denseCentroids(initialCentroids);
+  denseKMeans.Cluster(denseData, 3, denseAssignments, denseCentroids, false,
+      true);
+
+  for (size_t i = 0; i < numDocuments; ++i)
+    REQUIRE(assignments[i] == denseAssignments[i]);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(centroids[i] ==
+        Approx(denseCentroids[i]).epsilon(1e-7).margin(1e-10));
+  }
+}
+
 #endif // ARMA_HAS_SPMAT
 
 TEST_CASE("ElkanTest", "[KMeansTest]")
@@ -602,6 +668,121 @@ TEST_CASE("HamerlyTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure Yinyang k-means gives the same clusters as the naive method, with
+ * several groups of centroids.
+ */
+TEST_CASE("YinyangTest", "[KMeansTest]")
+{
+  const size_t trials = 5;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    arma::mat dataset(10, 1000);
+    dataset.randu();
+
+    const size_t k = 15 * (t + 1);
+    arma::mat centroids(10, k);
+    centroids.randu();
+
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        YinyangKMeans> yinyang;
+    arma::Row<size_t> yinyangAssignments;
+    arma::mat yinyangCentroids(centroids);
+    yinyang.Cluster(dataset, k, yinyangAssignments, yinyangCentroids, false,
+        true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      REQUIRE(assignments[i] == yinyangAssignments[i]);
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      REQUIRE(naiveCentroids[i] == Approx(yinyangCentroids[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that the bounds of Yinyang k-means prune most of the distance
+ * calculations on well-separated clusters.
+ */
+TEST_CASE("YinyangPruningTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 10000);
+  arma::mat centers(5, 50, arma::fill::randu);
+  centers *= 100.0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = centers.col(i % 50) + arma::randn<arma::vec>(5);
+
+  metric::EuclideanDistance metric;
+  arma::mat centroids = centers + arma::randn<arma::mat>(5, 50);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+
+  YinyangKMeans<metric::EuclideanDistance, arma::mat> yinyang(dataset, metric);
+  for (size_t iteration = 0; iteration < 10; ++iteration)
+  {
+    yinyang.Iterate(centroids, newCentroids, counts);
+    centroids = newCentroids;
+  }
+
+  // The first iteration computes all the distances; the others should need
+  // far fewer than the 9 * 10000 * 50 of the naive method.
+  REQUIRE(yinyang.DistanceCalculations() < 10000 * 50 + 9 * 10000 * 10);
+  REQUIRE(arma::accu(counts) == 10000);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that running Elkan's and Hamerly's algorithms with many threads
+ * gives the same clusters as running them with one thread.
+ */
+TEST_CASE("ParallelElkanHamerlyTest", "[KMeansTest]")
+{
+  arma::mat dataset(10, 5000, arma::fill::randu);
+  arma::mat centroids(10, 20, arma::fill::randu);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      ElkanKMeans> elkan;
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      HamerlyKMeans> hamerly;
+
+  arma::Row<size_t> elkanAssignments, hamerlyAssignments;
+  arma::mat elkanCentroids(centroids), hamerlyCentroids(centroids);
+  elkan.Cluster(dataset, 20, elkanAssignments, elkanCentroids, false, true);
+  hamerly.Cluster(dataset, 20, hamerlyAssignments, hamerlyCentroids, false,
+      true);
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  arma::Row<size_t> sequentialElkanAssignments, sequentialHamerlyAssignments;
+  arma::mat sequentialElkanCentroids(centroids);
+  arma::mat sequentialHamerlyCentroids(centroids);
+  elkan.Cluster(dataset, 20, sequentialElkanAssignments,
+      sequentialElkanCentroids, false, true);
+  hamerly.Cluster(dataset, 20, sequentialHamerlyAssignments,
+      sequentialHamerlyCentroids, false, true);
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(elkanAssignments[i] == sequentialElkanAssignments[i]);
+    REQUIRE(hamerlyAssignments[i] == sequentialHamerlyAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(elkanCentroids[i] ==
+        Approx(sequentialElkanCentroids[i]).epsilon(1e-7));
+    REQUIRE(hamerlyCentroids[i] ==
+        Approx(sequentialHamerlyCentroids[i]).epsilon(1e-7));
+  }
+}
+#endif
+
 TEST_CASE("PellegMooreTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -668,6 +849,36 @@ TEST_CASE("DTNNTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Run the dual-tree k-means on a dataset that is large enough for the tree to
+ * be updated in parallel, with many clusters, so that the centroid tree is
+ * refit in the last iterations instead of rebuilt, and make sure the results
+ * are the same as with the naive k-means.
+ */
+TEST_CASE("DTNNLargeTest", "[KMeansTest]")
+{
+  arma::mat dataset(3, 15000, arma::fill::randu);
+  const size_t k = 50;
+  arma::mat centroids = dataset.cols(0, k - 1);
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      DefaultDualTreeKMeans> dtnn;
+  arma::Row<size_t> dtnnAssignments;
+  arma::mat dtnnCentroids(centroids);
+  dtnn.Cluster(dataset, k, dtnnAssignments, dtnnCentroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(assignments[i] == dtnnAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(naiveCentroids[i] == Approx(dtnnCentroids[i]).epsilon(1e-7));
+}
+
 TEST_CASE("DTNNCoverTreeTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -733,3 +944,269 @@ TEST_CASE("SampleInitializationTest", "[KMeansTest]")
     REQUIRE(j < dataset.n_cols);
   }
 }
+
+/**
+ * Generate four well-separated Gaussian blobs of 2-dimensional points, with the
+ * points of blob i in columns [i * pointsPerBlob, (i + 1) * pointsPerBlob).
+ */
+arma::mat MiniBatchBlobs(const size_t pointsPerBlob, arma::mat& centers)
+{
+  centers = { { 0.0, 10.0, 0.0, 10.0 },
+              { 0.0, 0.0, 10.0, 10.0 } };
+
+  arma::mat data(2, 4 * pointsPerBlob);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    data.cols(i * pointsPerBlob, (i + 1) * pointsPerBlob - 1) =
+        0.5 * arma::randn<arma::mat>(2, pointsPerBlob);
+    data.cols(i * pointsPerBlob, (i + 1) * pointsPerBlob - 1).each_col() +=
+        centers.col(i);
+  }
+
+  return data;
+}
+
+/**
+ * Make sure that mini-batch k-means finds four well-separated clusters.
+ */
+TEST_CASE("MiniBatchKMeansTest", "[KMeansTest]")
+{
+  const size_t pointsPerBlob = 5000;
+  arma::mat centers;
+  arma::mat data = MiniBatchBlobs(pointsPerBlob, centers);
+
+  // Start from one point of each blob, so that there is no bad local minimum.
+  arma::mat centroids(2, 4);
+  for (size_t i = 0; i < 4; ++i)
+    centroids.col(i) = data.col(i * pointsPerBlob);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(200);
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 4, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    REQUIRE(arma::norm(centroids.col(i) - centers.col(i)) < 0.1);
+    for (size_t j = i * pointsPerBlob; j < (i + 1) * pointsPerBlob; ++j)
+      REQUIRE(assignments[j] == i);
+  }
+}
+
+/**
+ * Feed the dataset to MiniBatchKMeans::Update() one chunk at a time.  Since
+ * every point is assigned to the centroid of its blob, each centroid must end
+ * up at the mean of its blob.
+ */
+TEST_CASE("MiniBatchKMeansUpdateTest", "[KMeansTest]")
+{
+  const size_t pointsPerBlob = 2000;
+  arma::mat centers;
+  arma::mat data = MiniBatchBlobs(pointsPerBlob, centers);
+
+  // Shuffle the points, and remember the blob of each of them.
+  const arma::uvec order = arma::randperm(data.n_cols);
+  data = data.cols(order);
+
+  arma::mat centroids(centers);
+  arma::mat emptyDataset;
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat> step(emptyDataset, metric);
+
+  const size_t chunkSize = 700;
+  for (size_t begin = 0; begin < data.n_cols; begin += chunkSize)
+  {
+    const size_t end = std::min(begin + chunkSize, (size_t) data.n_cols) - 1;
+    step.Update(data.cols(begin, end), centroids);
+  }
+
+  arma::mat means(2, 4, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    means.col(order[i] / pointsPerBlob) += data.col(i);
+  means /= pointsPerBlob;
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    REQUIRE(step.ClusterCounts()[i] == pointsPerBlob);
+    REQUIRE(centroids(0, i) == Approx(means(0, i)).epsilon(1e-7));
+    REQUIRE(centroids(1, i) == Approx(means(1, i)).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that k-means++ chooses one point of each of four far-apart blobs,
+ * with and without weights.
+ */
+TEST_CASE("KMeansPlusPlusInitializationTest", "[KMeansTest]")
+{
+  const size_t pointsPerBlob = 500;
+  arma::mat centers;
+  arma::mat data = MiniBatchBlobs(pointsPerBlob, centers);
+  // Spread the blobs further apart so that a blob is almost never seeded
+  // twice.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    data.cols(i * pointsPerBlob, (i + 1) * pointsPerBlob - 1).each_col() +=
+        99.0 * centers.col(i);
+  }
+
+  // With the weights, the points with zero weight must never be chosen.
+  arma::vec weights(data.n_cols, arma::fill::ones);
+  weights.subvec(0, 9).zeros();
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::mat centroids;
+    if (trial == 0)
+      KMeansPlusPlusInitialization::Cluster(data, 4, centroids);
+    else
+      KMeansPlusPlusInitialization::Cluster(data, weights, 4, centroids);
+
+    REQUIRE(centroids.n_rows == 2);
+    REQUIRE(centroids.n_cols == 4);
+
+    arma::uvec seeded(4, arma::fill::zeros);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      // Each centroid must be a point of the dataset.
+      size_t j;
+      for (j = 0; j < data.n_cols; ++j)
+      {
+        if (EuclideanDistance::Evaluate(centroids.col(i), data.col(j)) < 1e-10)
+          break;
+      }
+
+      REQUIRE(j < data.n_cols);
+      if (trial == 1)
+        REQUIRE(j >= 10);
+      seeded[j / pointsPerBlob]++;
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+      REQUIRE(seeded[i] == 1);
+  }
+}
+
+/**
+ * Make sure that k-means started with k-means|| finds four well-separated
+ * clusters.
+ */
+TEST_CASE("KMeansParallelInitializationTest", "[KMeansTest]")
+{
+  const size_t pointsPerBlob = 2000;
+  arma::mat centers;
+  arma::mat data = MiniBatchBlobs(pointsPerBlob, centers);
+
+  KMeansParallelInitialization init;
+  arma::mat initialCentroids;
+  init.Cluster(data, 4, initialCentroids);
+  REQUIRE(initialCentroids.n_rows == 2);
+  REQUIRE(initialCentroids.n_cols == 4);
+
+  KMeans<EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  kmeans.Cluster(data, 4, assignments, centroids);
+
+  // Every blob must be one cluster, whatever the order of the clusters.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const size_t cluster = assignments[i * pointsPerBlob];
+    REQUIRE(arma::norm(centroids.col(cluster) - centers.col(i)) < 0.1);
+    for (size_t j = i * pointsPerBlob; j < (i + 1) * pointsPerBlob; ++j)
+      REQUIRE(assignments[j] == cluster);
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that k-means|| chooses the same centroids with one thread and with
+ * many threads.
+ */
+TEST_CASE("KMeansParallelInitializationThreadsTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 20000, arma::fill::randu);
+  KMeansParallelInitialization init(3, 2.0);
+
+  math::RandomSeed(42);
+  arma::mat centroids;
+  init.Cluster(dataset, 50, centroids);
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  math::RandomSeed(42);
+  arma::mat sequentialCentroids;
+  init.Cluster(dataset, 50, sequentialCentroids);
+  omp_set_num_threads(prevNumThreads);
+
+  REQUIRE(centroids.n_cols == 50);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(centroids[i] == Approx(sequentialCentroids[i]).epsilon(1e-12));
+}
+#endif
+
+/**
+ * Make sure that single-precision k-means finds the three classes of the simple
+ * test dataset, and that the naive, Elkan and Hamerly Lloyd steps agree on
+ * single-precision data.
+ */
+TEST_CASE("FloatKMeansTest", "[KMeansTest]")
+{
+  arma::fmat data = arma::conv_to<arma::fmat>::from(trans(kMeansData));
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      NaiveKMeans, arma::fmat> kmeans;
+
+  arma::Row<size_t> assignments;
+  arma::fmat centroids;
+  kmeans.Cluster(data, 3, assignments, centroids);
+
+  REQUIRE(centroids.n_rows == 2);
+  REQUIRE(centroids.n_cols == 3);
+
+  const size_t firstClass = assignments(0);
+  const size_t secondClass = assignments(13);
+  const size_t thirdClass = assignments(20);
+  REQUIRE(firstClass != secondClass);
+  REQUIRE(firstClass != thirdClass);
+  REQUIRE(secondClass != thirdClass);
+
+  for (size_t i = 0; i < 30; ++i)
+  {
+    const size_t expected = (i < 13) ? firstClass :
+        ((i < 20) ? secondClass : thirdClass);
+    REQUIRE(assignments(i) == expected);
+  }
+
+  arma::fmat dataset = arma::randu<arma::fmat>(10, 1000);
+  arma::fmat initialCentroids = arma::randu<arma::fmat>(10, 5);
+
+  arma::fmat naiveCentroids(initialCentroids);
+  arma::Row<size_t> naiveAssignments;
+  kmeans.Cluster(dataset, 5, naiveAssignments, naiveCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      ElkanKMeans, arma::fmat> elkan;
+  arma::fmat elkanCentroids(initialCentroids);
+  arma::Row<size_t> elkanAssignments;
+  elkan.Cluster(dataset, 5, elkanAssignments, elkanCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      HamerlyKMeans, arma::fmat> hamerly;
+  arma::fmat hamerlyCentroids(initialCentroids);
+  arma::Row<size_t> hamerlyAssignments;
+  hamerly.Cluster(dataset, 5, hamerlyAssignments, hamerlyCentroids, false,
+      true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(naiveAssignments[i] == elkanAssignments[i]);
+    REQUIRE(naiveAssignments[i] == hamerlyAssignments[i]);
+  }
+
+  for (size_t i = 0; i < naiveCentroids.n_elem; ++i)
+  {
+    REQUIRE(naiveCentroids[i] == Approx(elkanCentroids[i]).epsilon(1e-5));
+    REQUIRE(naiveCentroids[i] == Approx(hamerlyCentroids[i]).epsilon(1e-5));
+  }
+}
@@ -12,8 +12,11 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/gpu_neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
+#include <mlpack/core/tree/tree_cache.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
 
@@ -718,6 +721,226 @@ TEST_CASE("KNNDualTreeVsNaive2", "[KNNTest]")
   }
 }
 
+/**
+ * Test the parallel dual-tree nearest-neighbors method with the naive method,
+ * both with a query set and in the monochromatic setting.
+ */
+TEST_CASE("KNNParallelDualTreeVsNaive", "[KNNTest]")
+{
+  arma::mat dataset;
+
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  ParallelKNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  knn.Search(dataset, 15, neighborsTree, distancesTree);
+  naive.Search(dataset, 15, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+
+  knn.Search(15, neighborsTree, distancesTree);
+  naive.Search(15, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Test that naive, single-tree and greedy searches over parallel query blocks
+ * give the same results as the serial searches.
+ */
+TEST_CASE("KNNParallelQueriesTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::mat queries = arma::randu<arma::mat>(4, 300);
+
+  const NeighborSearchMode modes[] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      GREEDY_SINGLE_TREE_MODE };
+  for (const NeighborSearchMode mode : modes)
+  {
+    KNN serial(dataset, mode);
+    KNN parallel(dataset, mode);
+    parallel.ParallelQueries() = true;
+    REQUIRE(parallel.ParallelQueries() == true);
+
+    arma::Mat<size_t> serialNeighbors, parallelNeighbors;
+    arma::mat serialDistances, parallelDistances;
+
+    serial.Search(queries, 5, serialNeighbors, serialDistances);
+    parallel.Search(queries, 5, parallelNeighbors, parallelDistances);
+
+    REQUIRE(parallel.BaseCases() == serial.BaseCases());
+    CheckMatrices(parallelNeighbors, serialNeighbors);
+    CheckMatrices(parallelDistances, serialDistances);
+
+    serial.Search(5, serialNeighbors, serialDistances);
+    parallel.Search(5, parallelNeighbors, parallelDistances);
+
+    REQUIRE(parallel.BaseCases() == serial.BaseCases());
+    CheckMatrices(parallelNeighbors, serialNeighbors);
+    CheckMatrices(parallelDistances, serialDistances);
+  }
+}
+
+/**
+ * Make sure that the parallel dual-tree traverser gives the same results as the
+ * serial traverser for a number of different task depths.
+ */
+TEST_CASE("KNNParallelDualTreeTaskDepthTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RuleType;
+
+  EuclideanDistance metric;
+  arma::Mat<size_t> serialNeighbors;
+  arma::mat serialDistances;
+  {
+    TreeType tree(dataset, 5);
+    RuleType rules(tree.Dataset(), tree.Dataset(), 5, metric, 0, true);
+    TreeType::DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(tree, tree);
+    rules.GetResults(serialNeighbors, serialDistances);
+  }
+
+  for (size_t depth = 1; depth < 8; ++depth)
+  {
+    TreeType tree(dataset, 5);
+    RuleType rules(tree.Dataset(), tree.Dataset(), 5, metric, 0, true);
+    TreeType::ParallelDualTreeTraverser<RuleType> traverser(rules, depth);
+    REQUIRE(traverser.TaskDepth() == depth);
+    traverser.Traverse(tree, tree);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    rules.GetResults(neighbors, distances);
+
+    REQUIRE(rules.BaseCases() > 0);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == serialNeighbors[i]);
+      REQUIRE(distances[i] == Approx(serialDistances[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that the parallel dual-tree traverser of the octree gives the same
+ * results as the serial traverser, with automatic and given task depths.
+ */
+TEST_CASE("KNNOctreeParallelDualTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+
+  typedef Octree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RuleType;
+
+  EuclideanDistance metric;
+  arma::Mat<size_t> serialNeighbors;
+  arma::mat serialDistances;
+  {
+    TreeType tree(dataset, 5);
+    RuleType rules(tree.Dataset(), tree.Dataset(), 5, metric, 0, true);
+    TreeType::DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(tree, tree);
+    rules.GetResults(serialNeighbors, serialDistances);
+  }
+
+  for (size_t depth = 0; depth < 4; ++depth)
+  {
+    TreeType tree(dataset, 5);
+    RuleType rules(tree.Dataset(), tree.Dataset(), 5, metric, 0, true);
+    TreeType::ParallelDualTreeTraverser<RuleType> traverser(rules, depth);
+    traverser.Traverse(tree, tree);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    rules.GetResults(neighbors, distances);
+
+    REQUIRE(rules.BaseCases() > 0);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == serialNeighbors[i]);
+      REQUIRE(distances[i] == Approx(serialDistances[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that the traversal statistics collected by the dual-tree and
+ * single-tree traversers agree with the counters of the traversers.
+ */
+TEST_CASE("KNNTraversalStatisticsTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RuleType;
+
+  EuclideanDistance metric;
+  {
+    TreeType tree(dataset, 10);
+    RuleType rules(tree.Dataset(), tree.Dataset(), 5, metric, 0, true);
+    TreeType::DualTreeTraverser<RuleType> traverser(rules);
+    TraversalStatistics statistics;
+    traverser.Statistics() = &statistics;
+    traverser.Traverse(tree, tree);
+
+    REQUIRE(statistics.NumVisited().size() > 1);
+    REQUIRE(statistics.NumVisited()[0] == 1);
+    size_t numVisited = 0;
+    for (size_t i = 0; i < statistics.NumVisited().size(); ++i)
+      numVisited += statistics.NumVisited()[i];
+    REQUIRE(numVisited == traverser.NumVisited());
+    REQUIRE(statistics.NumScores() == traverser.NumScores() + 1);
+    REQUIRE(statistics.NumPrunes() == traverser.NumPrunes());
+    REQUIRE(statistics.NumBaseCases() == traverser.NumBaseCases());
+    REQUIRE(statistics.NumLeafCombinations() > 0);
+    REQUIRE(statistics.AverageQueryLeafSize() <= 10.0);
+    REQUIRE(statistics.AverageReferenceLeafSize() <= 10.0);
+    REQUIRE(statistics.PruneRate() > 0.0);
+    REQUIRE(statistics.BoundTightness() > 0.0);
+    REQUIRE(statistics.BoundTightness() <= 1.0);
+  }
+
+  {
+    TreeType tree(dataset, 10);
+    RuleType rules(tree.Dataset(), tree.Dataset(), 5, metric, 0, true);
+    TreeType::SingleTreeTraverser<RuleType> traverser(rules);
+    TraversalStatistics statistics;
+    traverser.Statistics() = &statistics;
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      traverser.Traverse(i, tree);
+
+    // Each traversal starts at the root.
+    REQUIRE(statistics.NumVisited()[0] == dataset.n_cols);
+    REQUIRE(statistics.NumPrunes() == traverser.NumPrunes());
+    // The rules don't count the base cases of a point with itself.
+    REQUIRE(statistics.NumBaseCases() >= rules.BaseCases());
+    REQUIRE(statistics.AverageQueryLeafSize() == 1.0);
+    REQUIRE(statistics.BoundTightness() == 1.0);
+  }
+}
+
 /**
  * Test the single-tree nearest-neighbors method with the naive method.  This
  * uses only a reference dataset.
@@ -753,6 +976,51 @@ TEST_CASE("KNNSingleTreeVsNaive", "[KNNTest]")
   }
 }
 
+/**
+ * Test the naive method on high-dimensional data (where the k'th best distance
+ * of each block is selected before the candidate lists are updated) against
+ * the single-tree method, for both nearest and furthest neighbor search.
+ */
+TEST_CASE("KNNHighDimensionalNaiveTest", "[KNNTest]")
+{
+  arma::mat dataset(512, 1500, arma::fill::randu);
+  arma::mat querySet(512, 300, arma::fill::randu);
+
+  KNN naive(dataset, NAIVE_MODE);
+  KNN knn(dataset, SINGLE_TREE_MODE);
+  KFN naiveKFN(dataset, NAIVE_MODE);
+  KFN kfn(dataset, SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> neighborsNaive, neighborsTree;
+  arma::mat distancesNaive, distancesTree;
+
+  // Monochromatic search.
+  naive.Search(10, neighborsNaive, distancesNaive);
+  knn.Search(10, neighborsTree, distancesTree);
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+
+  // Bichromatic search, with k larger than the reference block.
+  naive.Search(querySet, 1200, neighborsNaive, distancesNaive);
+  knn.Search(querySet, 1200, neighborsTree, distancesTree);
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+
+  naiveKFN.Search(querySet, 10, neighborsNaive, distancesNaive);
+  kfn.Search(querySet, 10, neighborsTree, distancesTree);
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+}
+
 /**
  * Test the cover tree single-tree nearest-neighbors method against the naive
  * method.  This uses only a random reference dataset.
@@ -932,6 +1200,73 @@ TEST_CASE("KNNHybridSpillSearchTest", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure that traversing a spill tree with a batch of query points gives the
+ * same results as traversing it with one query point at a time, both for a
+ * metric tree (tau = 0) and for a hybrid spill tree, and that the (parallel)
+ * single-tree search of SpillKNN gives the same results too.
+ */
+TEST_CASE("KNNBatchedSpillSearchTest", "[KNNTest]")
+{
+  arma::mat dataset(10, 1000, arma::fill::randu);
+  arma::mat querySet(10, 300, arma::fill::randu);
+  const size_t k = 5;
+
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      SpillKNN::Tree> RuleType;
+
+  for (size_t test = 0; test < 2; ++test)
+  {
+    const double tau = test * 0.1;
+    SpillKNN::Tree referenceTree(dataset, tau, 10);
+    EuclideanDistance metric;
+
+    // Traverse with one query point at a time.
+    RuleType rules(referenceTree.Dataset(), querySet, k, metric);
+    SpillKNN::Tree::DefeatistSingleTreeTraverser<RuleType> traverser(rules);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, referenceTree);
+
+    // Now traverse with all the query points at once.
+    RuleType batchRules(referenceTree.Dataset(), querySet, k, metric);
+    SpillKNN::Tree::DefeatistSingleTreeTraverser<RuleType>
+        batchTraverser(batchRules);
+    std::vector<size_t> queryIndices(querySet.n_cols);
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+      queryIndices[i] = i;
+    batchTraverser.Traverse(queryIndices, referenceTree);
+
+    REQUIRE(batchTraverser.NumPrunes() == traverser.NumPrunes());
+
+    arma::Mat<size_t> neighbors, batchNeighbors;
+    arma::mat distances, batchDistances;
+    rules.GetResults(neighbors, distances);
+    batchRules.GetResults(batchNeighbors, batchDistances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(batchNeighbors[i] == neighbors[i]);
+      REQUIRE(batchDistances[i] == Approx(distances[i]).epsilon(1e-7));
+    }
+
+    // The single-tree search of SpillKNN uses the batched traversal for each
+    // block of query points.
+    SpillKNN spTreeSearch(SINGLE_TREE_MODE);
+    spTreeSearch.Train(SpillKNN::Tree(dataset, tau, 10));
+    spTreeSearch.ParallelQueries() = true;
+
+    arma::Mat<size_t> searchNeighbors;
+    arma::mat searchDistances;
+    spTreeSearch.Search(querySet, k, searchNeighbors, searchDistances);
+
+    for (size_t i = 0; i < searchDistances.n_elem; ++i)
+    {
+      REQUIRE(searchNeighbors[i] == neighbors[i]);
+      REQUIRE(searchDistances[i] == Approx(distances[i]).epsilon(1e-7));
+    }
+  }
+}
+
 /**
  * Test hybrid sp-tree search doesn't repeat points.
  * This uses only a random reference dataset.
@@ -1020,6 +1355,91 @@ TEST_CASE("SparseKNNKDTreeTest", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure the naive search on sparse data (which compares blocks of points
+ * with sparse matrix products) gives the same results as on dense data, for
+ * both bichromatic and monochromatic search.
+ */
+TEST_CASE("SparseKNNNaiveTest", "[KNNTest]")
+{
+  arma::sp_mat queryDataset;
+  queryDataset.sprandu(300, 400, 0.05);
+  arma::sp_mat referenceDataset;
+  referenceDataset.sprandu(300, 1500, 0.05);
+  arma::mat denseQuery(queryDataset);
+  arma::mat denseReference(referenceDataset);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::sp_mat,
+      KDTree> SparseKNN;
+
+  SparseKNN sparseNaive(referenceDataset, NAIVE_MODE);
+  KNN naive(denseReference, NAIVE_MODE);
+
+  for (size_t mono = 0; mono < 2; ++mono)
+  {
+    arma::mat sparseDistances, naiveDistances;
+    arma::Mat<size_t> sparseNeighbors, naiveNeighbors;
+    if (mono)
+    {
+      sparseNaive.Search(5, sparseNeighbors, sparseDistances);
+      naive.Search(5, naiveNeighbors, naiveDistances);
+    }
+    else
+    {
+      sparseNaive.Search(queryDataset, 5, sparseNeighbors, sparseDistances);
+      naive.Search(denseQuery, 5, naiveNeighbors, naiveDistances);
+    }
+
+    for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+    {
+      REQUIRE(sparseNeighbors[i] == naiveNeighbors[i]);
+      REQUIRE(sparseDistances[i] ==
+          Approx(naiveDistances[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure single-precision nearest neighbor search with kd-trees gives the
+ * same results as single-precision naive search, and nearly the same results as
+ * double-precision search.
+ */
+TEST_CASE("FloatKNNKDTreeTest", "[KNNTest]")
+{
+  arma::fmat referenceDataset = arma::randu<arma::fmat>(5, 1000);
+  arma::fmat queryDataset = arma::randu<arma::fmat>(5, 200);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      KDTree> FloatKNN;
+
+  FloatKNN naive(referenceDataset, NAIVE_MODE);
+  KNN doubleNaive(arma::conv_to<arma::mat>::from(referenceDataset),
+      NAIVE_MODE);
+
+  arma::Mat<size_t> naiveNeighbors, doubleNeighbors;
+  arma::mat naiveDistances, doubleDistances;
+  naive.Search(queryDataset, 10, naiveNeighbors, naiveDistances);
+  doubleNaive.Search(arma::conv_to<arma::mat>::from(queryDataset), 10,
+      doubleNeighbors, doubleDistances);
+
+  for (size_t i = 0; i < naiveDistances.n_elem; ++i)
+    REQUIRE(naiveDistances[i] == Approx(doubleDistances[i]).epsilon(1e-5));
+
+  const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+  for (const NeighborSearchMode mode : modes)
+  {
+    FloatKNN knn(referenceDataset, mode);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(queryDataset, 10, neighbors, distances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    for (size_t i = 0; i < distances.n_elem; ++i)
+      REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+  }
+}
+
 /*
 TEST_CASE("SparseKNNCoverTreeTest", "[KNNTest]")
 {
@@ -1059,6 +1479,205 @@ TEST_CASE("SparseKNNCoverTreeTest", "[KNNTest]")
 }
 */
 
+/**
+ * Make sure that an NSModel whose reference set is memory-mapped gives the same
+ * results, and that it can be saved and loaded without the reference set.
+ */
+TEST_CASE("KNNModelMapReferenceSetTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat queryData = arma::randu<arma::mat>(5, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::TreeTypes::KD_TREE,
+      KNNModel::TreeTypes::COVER_TREE, KNNModel::TreeTypes::R_TREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, NAIVE_MODE };
+
+  for (const KNNModel::TreeTypes treeType : treeTypes)
+  {
+    for (const NeighborSearchMode mode : modes)
+    {
+      KNNModel model(treeType, false);
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(std::move(referenceCopy), 20, mode);
+
+      arma::Mat<size_t> baselineNeighbors, neighbors;
+      arma::mat baselineDistances, distances;
+      arma::mat queryCopy(queryData);
+      model.Search(std::move(queryCopy), 3, baselineNeighbors,
+          baselineDistances);
+      const arma::mat baselineDataset(model.Dataset());
+
+      model.MapReferenceSet("knn_reference_map.bin");
+      REQUIRE(model.ReferenceMapFile() == "knn_reference_map.bin");
+      CheckMatrices(model.Dataset(), baselineDataset);
+
+      queryCopy = queryData;
+      model.Search(std::move(queryCopy), 3, neighbors, distances);
+      CheckMatrices(neighbors, baselineNeighbors);
+      CheckMatrices(distances, baselineDistances);
+
+      // Saving the model must leave the mapped reference set in place.
+      REQUIRE(data::Save("knn_mapped_model.bin", "knn_model", model, true));
+      CheckMatrices(model.Dataset(), baselineDataset);
+
+      KNNModel loadedModel;
+      REQUIRE(data::Load("knn_mapped_model.bin", "knn_model", loadedModel,
+          true));
+      REQUIRE(loadedModel.ReferenceMapFile() == "knn_reference_map.bin");
+      CheckMatrices(loadedModel.Dataset(), baselineDataset);
+
+      queryCopy = queryData;
+      loadedModel.Search(std::move(queryCopy), 3, neighbors, distances);
+      CheckMatrices(neighbors, baselineNeighbors);
+      CheckMatrices(distances, baselineDistances);
+    }
+  }
+
+  remove("knn_reference_map.bin");
+  remove("knn_mapped_model.bin");
+}
+
+/**
+ * Make sure that inserting and removing reference points of a kd-tree search
+ * gives the same results as a search on the modified reference set.
+ */
+TEST_CASE("KNNInsertDeleteTest", "[KNNTest]")
+{
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat newData = arma::randu<arma::mat>(3, 300);
+
+  // Remove every fifth point of the extended reference set.
+  std::vector<size_t> removed;
+  arma::uvec kept(1300 - 260);
+  for (size_t i = 0, k = 0; i < 1300; ++i)
+  {
+    if (i % 5 == 0)
+      removed.push_back(i);
+    else
+      kept[k++] = i;
+  }
+
+  const arma::mat insertedData = arma::join_rows(referenceData, newData);
+  const arma::mat remainingData = insertedData.cols(kept);
+
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE,
+      NAIVE_MODE };
+  for (const NeighborSearchMode mode : modes)
+  {
+    KNN knn(referenceData, mode);
+
+    arma::Mat<size_t> neighbors, baselineNeighbors;
+    arma::mat distances, baselineDistances;
+
+    knn.Insert(newData, 10);
+    REQUIRE(knn.ReferenceSet().n_cols == 1300);
+    KNN insertedKnn(insertedData, NAIVE_MODE);
+    knn.Search(queryData, 5, neighbors, distances);
+    insertedKnn.Search(queryData, 5, baselineNeighbors, baselineDistances);
+    CheckMatrices(neighbors, baselineNeighbors);
+    CheckMatrices(distances, baselineDistances);
+
+    knn.Delete(removed, 10);
+    REQUIRE(knn.ReferenceSet().n_cols == 1040);
+    KNN remainingKnn(remainingData, NAIVE_MODE);
+    knn.Search(queryData, 5, neighbors, distances);
+    remainingKnn.Search(queryData, 5, baselineNeighbors, baselineDistances);
+    CheckMatrices(neighbors, baselineNeighbors);
+    CheckMatrices(distances, baselineDistances);
+
+    // Monochromatic search uses the reference tree as the query tree.
+    knn.Search(5, neighbors, distances);
+    remainingKnn.Search(5, baselineNeighbors, baselineDistances);
+    CheckMatrices(neighbors, baselineNeighbors);
+    CheckMatrices(distances, baselineDistances);
+  }
+
+  KNN knn(referenceData);
+  REQUIRE_THROWS_AS(knn.Insert(arma::randu<arma::mat>(4, 10)),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(knn.Delete(std::vector<size_t>(1, 1000)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that NSModel gives the same results after reference points are
+ * inserted and removed as a model built on the modified reference set, both
+ * for trees that are updated in place and for trees that are rebuilt.
+ */
+TEST_CASE("KNNModelInsertDeleteTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(4, 400);
+  arma::mat newData = arma::randu<arma::mat>(4, 100);
+
+  std::vector<size_t> removed;
+  arma::uvec kept(500 - 167);
+  for (size_t i = 0, k = 0; i < 500; ++i)
+  {
+    if (i % 3 == 0)
+      removed.push_back(i);
+    else
+      kept[k++] = i;
+  }
+
+  const arma::mat remainingData =
+      arma::mat(arma::join_rows(referenceData, newData)).cols(kept);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::TreeTypes::KD_TREE,
+      KNNModel::TreeTypes::BALL_TREE, KNNModel::TreeTypes::UB_TREE,
+      KNNModel::TreeTypes::COVER_TREE, KNNModel::TreeTypes::SPILL_TREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, NAIVE_MODE };
+
+  for (const KNNModel::TreeTypes treeType : treeTypes)
+  {
+    for (const NeighborSearchMode mode : modes)
+    {
+      KNNModel model(treeType, false);
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(std::move(referenceCopy), 15, mode);
+
+      model.Insert(newData);
+      model.Delete(removed);
+      REQUIRE(model.Dataset().n_cols == remainingData.n_cols);
+
+      KNNModel baselineModel(treeType, false);
+      arma::mat remainingCopy(remainingData);
+      baselineModel.BuildModel(std::move(remainingCopy), 15, mode);
+
+      arma::Mat<size_t> neighbors, baselineNeighbors;
+      arma::mat distances, baselineDistances;
+      arma::mat queryCopy(queryData);
+      model.Search(std::move(queryCopy), 3, neighbors, distances);
+      queryCopy = queryData;
+      baselineModel.Search(std::move(queryCopy), 3, baselineNeighbors,
+          baselineDistances);
+
+      // Spill trees are approximate, so only the exact trees are compared.
+      if (treeType != KNNModel::TreeTypes::SPILL_TREE || mode == NAIVE_MODE)
+      {
+        CheckMatrices(neighbors, baselineNeighbors);
+        CheckMatrices(distances, baselineDistances);
+      }
+    }
+  }
+
+  // A memory-mapped reference set is copied back to memory.
+  KNNModel model(KNNModel::TreeTypes::KD_TREE, false);
+  arma::mat referenceCopy(referenceData);
+  model.BuildModel(std::move(referenceCopy), 15, DUAL_TREE_MODE);
+  model.MapReferenceSet("knn_insert_map.bin");
+  model.Insert(newData);
+  REQUIRE(model.ReferenceMapFile().empty());
+  REQUIRE(model.Dataset().n_cols == 500);
+
+  remove("knn_insert_map.bin");
+}
+
 TEST_CASE("KNNModelTest", "[KNNTest]")
 {
   // Ensure that we can build an NSModel<NearestNeighborSearch> and get correct
@@ -1814,3 +2433,244 @@ TEST_CASE("KNNSpillTreeSearchEnoughResults", "[KNNTest]")
   REQUIRE(arma::accu(distancesGreedy < 0.0 || distancesGreedy > std::sqrt(3.0))
       == 0);
 }
+
+/**
+ * Make sure that the results given block by block to a callback are the same
+ * as the results of the whole search, for both the bichromatic and the
+ * monochromatic searches, in every search mode.
+ */
+TEST_CASE("KNNCallbackSearchTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat queries = arma::randu<arma::mat>(3, 230);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    const NeighborSearchMode searchMode = (mode == 0) ? NAIVE_MODE :
+        (mode == 1) ? SINGLE_TREE_MODE : DUAL_TREE_MODE;
+    KNN knn(dataset, searchMode);
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      arma::Mat<size_t> neighbors, blockNeighbors;
+      arma::mat distances, blockDistances;
+      if (mono == 1)
+        knn.Search(4, neighbors, distances);
+      else
+        knn.Search(queries, 4, neighbors, distances);
+
+      blockNeighbors.zeros(neighbors.n_rows, neighbors.n_cols);
+      blockDistances.zeros(distances.n_rows, distances.n_cols);
+      size_t numBlocks = 0;
+      size_t nextBegin = 0;
+      auto callback = [&](const size_t begin,
+                          const arma::Mat<size_t>& n,
+                          const arma::mat& d)
+      {
+        // The blocks are given in order.
+        REQUIRE(begin == nextBegin);
+        REQUIRE(n.n_rows == 4);
+        REQUIRE(d.n_cols == n.n_cols);
+        blockNeighbors.cols(begin, begin + n.n_cols - 1) = n;
+        blockDistances.cols(begin, begin + d.n_cols - 1) = d;
+        nextBegin += n.n_cols;
+        ++numBlocks;
+      };
+
+      if (mono == 1)
+        knn.Search(4, callback, 64);
+      else
+        knn.Search(queries, 4, callback, 64);
+
+      REQUIRE(nextBegin == neighbors.n_cols);
+      REQUIRE(numBlocks == (neighbors.n_cols + 63) / 64);
+      for (size_t i = 0; i < distances.n_elem; ++i)
+        REQUIRE(blockDistances[i] == Approx(distances[i]).epsilon(1e-7));
+      REQUIRE(arma::accu(blockNeighbors != neighbors) == 0);
+    }
+  }
+}
+
+/**
+ * Make sure the intrinsic dimensionality of points on a plane embedded in ten
+ * dimensions is estimated close to 2, and that the engine chosen by
+ * SelectEngine() gives the exact neighbors.
+ */
+TEST_CASE("KNNModelSelectEngineTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat basis = arma::randn<arma::mat>(10, 2);
+  arma::mat referenceData = basis * arma::randu<arma::mat>(2, 3000);
+  arma::mat queryData = basis * arma::randu<arma::mat>(2, 300);
+
+  const double dimensionality =
+      KNNModel::IntrinsicDimensionality(referenceData.cols(0, 999));
+  REQUIRE(dimensionality > 1.5);
+  REQUIRE(dimensionality < 2.5);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  naive.Search(queryData, 5, baselineNeighbors, baselineDistances);
+
+  // Choose everything.
+  KNNModel model;
+  NeighborSearchMode mode = model.SelectEngine(referenceData, queryData, 5, 0,
+      DUAL_TREE_MODE, KNNModel::SELECT_ALL, 1000);
+  REQUIRE((model.LeafSize() == 10 || model.LeafSize() == 20 ||
+      model.LeafSize() == 40));
+
+  arma::mat referenceCopy(referenceData);
+  arma::mat queryCopy(queryData);
+  model.BuildModel(std::move(referenceCopy), model.LeafSize(), mode);
+  REQUIRE(model.SearchMode() == mode);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  model.Search(std::move(queryCopy), 5, neighbors, distances);
+  CheckMatrices(neighbors, baselineNeighbors);
+  CheckMatrices(distances, baselineDistances);
+
+  // Choose only the search mode of a cover tree.
+  KNNModel coverModel(KNNModel::TreeTypes::COVER_TREE, false);
+  mode = coverModel.SelectEngine(referenceData, arma::mat(), 5, 0,
+      DUAL_TREE_MODE, KNNModel::SELECT_SEARCH_MODE, 1000);
+  REQUIRE(coverModel.TreeType() == KNNModel::TreeTypes::COVER_TREE);
+  REQUIRE(coverModel.LeafSize() == 20);
+
+  // A fixed search mode is kept.
+  mode = coverModel.SelectEngine(referenceData, queryData, 5, 0,
+      SINGLE_TREE_MODE, KNNModel::SELECT_TREE_TYPE, 1000);
+  REQUIRE(mode == SINGLE_TREE_MODE);
+}
+
+/**
+ * Make sure the tiled GPU brute-force search gives the same results as naive
+ * search, even for points far from the origin, when the reference set is split
+ * into many tiles.  (Without Bandicoot, the tiles are Armadillo matrices.)
+ */
+TEST_CASE("KNNGPUSearchTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(40, 700) + 1000.0;
+  arma::mat queryData = arma::randu<arma::mat>(40, 300) + 1000.0;
+
+  KNN naive(referenceData, NAIVE_MODE);
+  GPUNeighborSearch<NearestNeighborSort, arma::fmat> gpu(256, 64);
+
+  arma::Mat<size_t> neighbors, gpuNeighbors;
+  arma::mat distances, gpuDistances;
+
+  naive.Search(queryData, 10, neighbors, distances);
+  gpu.Search(referenceData, queryData, 10, gpuNeighbors, gpuDistances);
+  CheckMatrices(neighbors, gpuNeighbors);
+  CheckMatrices(distances, gpuDistances);
+
+  naive.Search(10, neighbors, distances);
+  gpu.Search(referenceData, 10, gpuNeighbors, gpuDistances);
+  CheckMatrices(neighbors, gpuNeighbors);
+  CheckMatrices(distances, gpuDistances);
+
+  // Furthest neighbor search works the same way.
+  KFN naiveKFN(referenceData, NAIVE_MODE);
+  GPUNeighborSearch<FurthestNeighborSort, arma::fmat> gpuKFN(256, 64);
+  naiveKFN.Search(queryData, 5, neighbors, distances);
+  gpuKFN.Search(referenceData, queryData, 5, gpuNeighbors, gpuDistances);
+  CheckMatrices(neighbors, gpuNeighbors);
+  CheckMatrices(distances, gpuDistances);
+
+  // k can't be larger than the number of other points.
+  REQUIRE_THROWS_AS(gpu.Search(referenceData, 700, gpuNeighbors,
+      gpuDistances), std::invalid_argument);
+}
+
+/**
+ * Make sure an NSModel built for naive search can search with the GPU engine,
+ * and that one built with a tree refuses to.
+ */
+TEST_CASE("KNNModelGPUSearchTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceData = arma::randu<arma::mat>(10, 500);
+  arma::mat queryData = arma::randu<arma::mat>(10, 100);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, gpuNeighbors;
+  arma::mat distances, gpuDistances;
+  naive.Search(queryData, 3, neighbors, distances);
+
+  KNNModel model;
+  model.BuildModel(arma::mat(referenceData), 20, NAIVE_MODE);
+  model.GPUSearch() = true;
+  model.GPUTileSize() = 128;
+  model.Search(arma::mat(queryData), 3, gpuNeighbors, gpuDistances);
+  CheckMatrices(neighbors, gpuNeighbors);
+  CheckMatrices(distances, gpuDistances);
+
+  KNNModel treeModel;
+  treeModel.BuildModel(arma::mat(referenceData), 20, DUAL_TREE_MODE);
+  treeModel.GPUSearch() = true;
+  REQUIRE_THROWS_AS(treeModel.Search(arma::mat(queryData), 3, gpuNeighbors,
+      gpuDistances), std::invalid_argument);
+}
+
+/**
+ * Make sure that KNN and RangeSearch give the same results with a tree shared
+ * through a TreeCache as with their own trees.
+ */
+TEST_CASE("KNNSharedTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  tree::TreeCache cache;
+  std::vector<size_t> oldFromNew;
+  std::shared_ptr<KNN::Tree> knnTree = cache.Get<KNN::Tree>(dataset,
+      oldFromNew);
+  typedef range::RangeSearch<>::Tree RangeSearchTree;
+  std::shared_ptr<RangeSearchTree> rangeSearchTree =
+      cache.Get<RangeSearchTree>(dataset, oldFromNew);
+  REQUIRE(cache.Size() == 1);
+
+  KNN knn(dataset);
+  KNN sharedKnn;
+  sharedKnn.Train(knnTree.get(), oldFromNew);
+
+  arma::Mat<size_t> neighbors, sharedNeighbors;
+  arma::mat distances, sharedDistances;
+  knn.Search(querySet, 5, neighbors, distances);
+  sharedKnn.Search(querySet, 5, sharedNeighbors, sharedDistances);
+  CheckMatrices(neighbors, sharedNeighbors);
+  CheckMatrices(distances, sharedDistances);
+
+  // The monochromatic search is done twice, to make sure the statistics of the
+  // shared tree are reset.
+  knn.Search(5, neighbors, distances);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    sharedKnn.Search(5, sharedNeighbors, sharedDistances);
+    CheckMatrices(neighbors, sharedNeighbors);
+    CheckMatrices(distances, sharedDistances);
+  }
+
+  range::RangeSearch<> rs(dataset);
+  range::RangeSearch<> sharedRs;
+  sharedRs.Train(rangeSearchTree.get(), oldFromNew);
+
+  std::vector<std::vector<size_t>> rsNeighbors, sharedRsNeighbors;
+  std::vector<std::vector<double>> rsDistances, sharedRsDistances;
+  rs.Search(querySet, math::Range(0.0, 0.1), rsNeighbors, rsDistances);
+  sharedRs.Search(querySet, math::Range(0.0, 0.1), sharedRsNeighbors,
+      sharedRsDistances);
+  REQUIRE(rsNeighbors.size() == sharedRsNeighbors.size());
+  for (size_t i = 0; i < rsNeighbors.size(); ++i)
+  {
+    std::sort(rsNeighbors[i].begin(), rsNeighbors[i].end());
+    std::sort(sharedRsNeighbors[i].begin(), sharedRsNeighbors[i].end());
+    REQUIRE(rsNeighbors[i] == sharedRsNeighbors[i]);
+  }
+
+  // The shared tree is not modified by the algorithms.
+  REQUIRE(arma::accu(knnTree->Dataset() != rangeSearchTree->Dataset()) == 0);
+}
@@ -252,6 +252,69 @@ BOOST_AUTO_TEST_CASE(SingleDatasetSingleSearch)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 2500);
 }
 
+// Test parallel single-tree rank-approximate search, with both a query set and
+// a single dataset.  These tests just ensure that the method runs okay and
+// returns valid neighbors.
+BOOST_AUTO_TEST_CASE(ParallelQueriesSingleSearch)
+{
+  arma::mat dataset(5, 2500);
+  dataset.randn();
+  arma::mat queries(5, 300);
+  queries.randn();
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  RASearch<> single(dataset, false, true);
+  single.ParallelQueries() = true;
+
+  single.Search(queries, 3, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 300);
+  BOOST_REQUIRE_EQUAL(arma::accu(neighbors >= 2500), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(distances == DBL_MAX), 0);
+
+  single.Search(1, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 2500);
+  BOOST_REQUIRE_EQUAL(arma::accu(neighbors >= 2500), 0);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    BOOST_REQUIRE_NE(neighbors(0, i), i);
+}
+
+// Make sure that the samples do not depend on the number of threads: with the
+// same seed, parallel and serial naive and single-tree searches must give the
+// same results.
+BOOST_AUTO_TEST_CASE(ParallelQueriesSameResults)
+{
+  arma::mat dataset(5, 2000);
+  dataset.randn();
+  arma::mat queries(5, 500);
+  queries.randn();
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    const bool naive = (mode == 0);
+    RASearch<> serial(dataset, naive, !naive);
+    RASearch<> parallel(dataset, naive, !naive);
+    parallel.ParallelQueries() = true;
+
+    arma::Mat<size_t> serialNeighbors, parallelNeighbors;
+    arma::mat serialDistances, parallelDistances;
+
+    math::RandomSeed(42);
+    serial.Search(queries, 3, serialNeighbors, serialDistances);
+    math::RandomSeed(42);
+    parallel.Search(queries, 3, parallelNeighbors, parallelDistances);
+
+    BOOST_REQUIRE_EQUAL(arma::accu(serialNeighbors != parallelNeighbors), 0);
+    for (size_t i = 0; i < serialDistances.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(serialDistances[i], parallelDistances[i], 1e-5);
+  }
+}
+
 // Test rank-approximate search with just a single dataset in dual-tree mode.
 // These tests just ensure that the method runs okay.
 BOOST_AUTO_TEST_CASE(SingleDatasetSearch)
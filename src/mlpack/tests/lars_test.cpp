@@ -463,4 +463,38 @@ BOOST_AUTO_TEST_CASE(LARSCopyConstructorTest)
   CheckMatrices(predictions, predictionsFromCopiedModel);
 }
 
+/**
+ * Make sure that LARS with the Cholesky factorization gives the same solution
+ * whether the full Gram matrix is given or only its needed entries are
+ * computed.
+ */
+BOOST_AUTO_TEST_CASE(LARSCholeskyGramColumnsTest)
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 100, 20);
+  const arma::mat gram = X * X.t();
+
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    const double lambda1 = (trial == 0) ? 0.0 : 0.5;
+    const double lambda2 = (trial == 2) ? 0.1 : 0.0;
+
+    LARS lars(true, lambda1, lambda2);
+    LARS gramLars(true, gram, lambda1, lambda2);
+    arma::vec beta, gramBeta;
+    lars.Train(X, y, beta);
+    gramLars.Train(X, y, gramBeta);
+
+    BOOST_REQUIRE_EQUAL(lars.ActiveSet().size(), gramLars.ActiveSet().size());
+    for (size_t i = 0; i < beta.n_elem; ++i)
+    {
+      if (std::abs(gramBeta[i]) < 1e-8)
+        BOOST_REQUIRE_SMALL(beta[i], 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(beta[i], gramBeta[i], 1e-6);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -258,4 +258,47 @@ BOOST_AUTO_TEST_CASE(TestSymKronId)
   }
 }
 
+/**
+ * Make sure that SparseMultiply() and SparseTransMultiply() give the same
+ * results as the Armadillo products.
+ */
+BOOST_AUTO_TEST_CASE(TestSparseMultiply)
+{
+  arma::sp_mat a;
+  a.sprandu(80, 50, 0.1);
+  const arma::mat b = arma::randu<arma::mat>(50, 7);
+  const arma::mat c = arma::randu<arma::mat>(80, 7);
+
+  arma::mat ab, atc;
+  SparseMultiply(a, b, ab);
+  SparseTransMultiply(a, c, atc);
+
+  const arma::mat abExpected = a * b;
+  const arma::mat atcExpected = a.t() * c;
+
+  BOOST_REQUIRE_EQUAL(ab.n_rows, abExpected.n_rows);
+  BOOST_REQUIRE_EQUAL(ab.n_cols, abExpected.n_cols);
+  for (size_t i = 0; i < ab.n_elem; ++i)
+  {
+    if (std::abs(abExpected[i]) < 1e-10)
+      BOOST_REQUIRE_SMALL(ab[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(ab[i], abExpected[i], 1e-8);
+  }
+
+  BOOST_REQUIRE_EQUAL(atc.n_rows, atcExpected.n_rows);
+  BOOST_REQUIRE_EQUAL(atc.n_cols, atcExpected.n_cols);
+  for (size_t i = 0; i < atc.n_elem; ++i)
+  {
+    if (std::abs(atcExpected[i]) < 1e-10)
+      BOOST_REQUIRE_SMALL(atc[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(atc[i], atcExpected[i], 1e-8);
+  }
+
+  // Incompatible dimensions.
+  BOOST_REQUIRE_THROW(SparseMultiply(a, c, ab), std::invalid_argument);
+  BOOST_REQUIRE_THROW(SparseTransMultiply(a, b, atc), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
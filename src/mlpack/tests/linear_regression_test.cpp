@@ -266,3 +266,90 @@ TEST_CASE("LinearRegressionTrainReturnObjective", "[LinearRegressionTest]")
 
   REQUIRE(std::isfinite(error) == true);
 }
+
+/**
+ * Test that the normal equations accumulated over blocks of points give the
+ * solution of the normal equations computed directly, with and without
+ * weights.
+ */
+TEST_CASE("LinearRegressionBlockedNormalEquationsTest",
+          "[LinearRegressionTest]")
+{
+  // Use enough points for several blocks, and a partial last block.
+  arma::mat predictors(5, 10000, arma::fill::randn);
+  arma::rowvec responses = arma::randn<arma::rowvec>(10000) +
+      arma::rowvec(arma::randu<arma::vec>(5).t() * predictors);
+  arma::rowvec weights = arma::randu<arma::rowvec>(10000);
+
+  arma::mat p = arma::join_cols(arma::ones<arma::rowvec>(10000), predictors);
+  arma::mat pw = p.each_row() % weights;
+  arma::vec expected = arma::solve(pw * p.t() + 0.5 * arma::eye(6, 6),
+      pw * responses.t());
+
+  LinearRegression lr(predictors, responses, weights, 0.5);
+  REQUIRE(lr.Parameters().n_elem == 6);
+  for (size_t i = 0; i < 6; ++i)
+    REQUIRE(lr.Parameters()[i] == Approx(expected[i]).epsilon(1e-7));
+
+  expected = arma::solve(predictors * predictors.t(),
+      predictors * responses.t());
+  lr.Lambda() = 0.0;
+  lr.Train(predictors, responses, false);
+  REQUIRE(lr.Parameters().n_elem == 5);
+  for (size_t i = 0; i < 5; ++i)
+    REQUIRE(lr.Parameters()[i] == Approx(expected[i]).epsilon(1e-7));
+}
+
+/**
+ * Test that training on sparse data with the conjugate gradient method gives
+ * the same model as training on the same dense data.
+ */
+TEST_CASE("LinearRegressionSparseTest", "[LinearRegressionTest]")
+{
+  arma::sp_mat predictors;
+  predictors.sprandu(30, 2000, 0.1);
+  const arma::vec coeffs = arma::randn<arma::vec>(30);
+  const arma::rowvec responses = arma::rowvec(coeffs.t() * predictors) +
+      3.0 + 0.01 * arma::randn<arma::rowvec>(2000);
+  const arma::rowvec weights = arma::randu<arma::rowvec>(2000) + 0.5;
+  const arma::mat densePredictors(predictors);
+
+  // Try with and without an intercept, regularization, and weights.
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    const bool intercept = (trial % 2 == 0);
+    const double lambda = (trial < 2) ? 0.0 : 0.1;
+
+    LinearRegression dense, sparse;
+    dense.Lambda() = lambda;
+    sparse.Lambda() = lambda;
+
+    double denseError, sparseError;
+    if (trial == 3)
+    {
+      denseError = dense.Train(densePredictors, responses, weights, intercept);
+      sparseError = sparse.Train(predictors, responses, weights, intercept);
+    }
+    else
+    {
+      denseError = dense.Train(densePredictors, responses, intercept);
+      sparseError = sparse.Train(predictors, responses, intercept);
+    }
+
+    REQUIRE(sparse.Intercept() == intercept);
+    REQUIRE(sparse.Parameters().n_elem == dense.Parameters().n_elem);
+    for (size_t i = 0; i < dense.Parameters().n_elem; ++i)
+    {
+      REQUIRE(sparse.Parameters()[i] ==
+          Approx(dense.Parameters()[i]).epsilon(1e-5).margin(1e-8));
+    }
+    REQUIRE(sparseError == Approx(denseError).epsilon(1e-5));
+
+    // The sparse and dense predictions must be the same too.
+    arma::rowvec densePredictions, sparsePredictions;
+    dense.Predict(densePredictors, densePredictions);
+    sparse.Predict(predictors, sparsePredictions);
+    REQUIRE(arma::approx_equal(densePredictions, sparsePredictions, "absdiff",
+        1e-4));
+  }
+}
@@ -1180,4 +1180,60 @@ BOOST_AUTO_TEST_CASE(LinearSVMCallbackTest)
   BOOST_REQUIRE(cb.calledEndOptimization == true);
 }
 
+/**
+ * Train a linear SVM on a dataset streamed in chunks, and make sure that it
+ * learns the dataset, and that the options of the optimizer are restored.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMStreamingTrainTest)
+{
+  // Generate a two-Gaussian dataset, four chunks at a time.
+  GaussianDistribution g1(arma::vec("-2.0 -2.0 -2.0"),
+      arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("2.0 2.0 2.0"),
+      arma::eye<arma::mat>(3, 3));
+
+  size_t chunk = 0;
+  size_t chunksRead = 0;
+  auto generate = [&](arma::mat& x, arma::mat& y)
+  {
+    if (chunk == 4)
+      return false;
+
+    ++chunk;
+    ++chunksRead;
+    x.set_size(3, 250);
+    y.set_size(1, 250);
+    for (size_t i = 0; i < 250; ++i)
+    {
+      y[i] = (i % 2);
+      x.col(i) = (i % 2 == 0) ? g1.Random() : g2.Random();
+    }
+    return true;
+  };
+  ann::PrefetchLoader<ann::CallbackSource<> > loader(
+      ann::CallbackSource<>(generate, [&](const bool) { chunk = 0; }));
+
+  ens::StandardSGD optimizer(0.01, 10);
+  LinearSVM<> lsvm(3, 2, 0.0001, 1.0, false);
+  const double objective = lsvm.Train(loader, 2, optimizer, 3);
+  BOOST_REQUIRE(std::isfinite(objective));
+
+  // Each epoch reads all of the chunks again.
+  BOOST_REQUIRE_GE(chunksRead, 12);
+
+  // The options of the optimizer are restored.
+  BOOST_REQUIRE_EQUAL(optimizer.MaxIterations(), 100000);
+
+  arma::mat testData(3, 500);
+  arma::Row<size_t> testLabels(500);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    testLabels[i] = (i % 2);
+    testData.col(i) = (i % 2 == 0) ? g1.Random() : g2.Random();
+  }
+
+  const double acc = lsvm.ComputeAccuracy(testData, testLabels);
+  BOOST_REQUIRE_GE(acc, 0.97);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
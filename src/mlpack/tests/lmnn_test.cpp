@@ -732,4 +732,39 @@ BOOST_AUTO_TEST_CASE(LMNNFunctionGradientTest4)
   }
 }
 
+/**
+ * The objective and gradient computed over one batch holding every point
+ * should match the ones computed over the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(LMNNBatchMatchesFullEvaluateWithGradientTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::Load("iris.csv", dataset);
+  data::Load("iris_labels.txt", labels);
+
+  LMNNFunction<> fullFn(dataset, labels, 3, 0.5, 1);
+  LMNNFunction<> batchFn(dataset, labels, 3, 0.5, 1);
+
+  arma::mat coordinates(dataset.n_rows, dataset.n_rows, arma::fill::randu);
+  coordinates += arma::eye<arma::mat>(dataset.n_rows, dataset.n_rows);
+
+  arma::mat fullGradient, batchGradient;
+  const double fullObjective = fullFn.EvaluateWithGradient(coordinates,
+      fullGradient);
+  const double batchObjective = batchFn.EvaluateWithGradient(coordinates, 0,
+      batchGradient, dataset.n_cols);
+
+  BOOST_REQUIRE_CLOSE(fullObjective, batchObjective, 1e-5);
+  BOOST_REQUIRE_EQUAL(fullGradient.n_rows, batchGradient.n_rows);
+  BOOST_REQUIRE_EQUAL(fullGradient.n_cols, batchGradient.n_cols);
+  for (size_t i = 0; i < fullGradient.n_elem; ++i)
+  {
+    if (std::abs(fullGradient[i]) < 1e-8)
+      BOOST_REQUIRE_SMALL(batchGradient[i], 1e-8);
+    else
+      BOOST_REQUIRE_CLOSE(fullGradient[i], batchGradient[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,8 +13,13 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/load_arff.hpp>
+#include <mlpack/core/data/chunked_loader.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
+#ifdef HAS_ARROW
+  #include <parquet/arrow/writer.h>
+#endif
 #include "catch.hpp"
+#include "serialization_catch.hpp"
 #include "test_catch_tools.hpp"
 
 using namespace mlpack;
@@ -1246,6 +1251,109 @@ TEST_CASE("LoadTextTest", "[LoadSaveTest]")
   REQUIRE(y.inb.s == x.inb.s);
 }
 
+/**
+ * Make sure we can load and save in the fast binary format.
+ */
+TEST_CASE("LoadFastBinaryTest", "[LoadSaveTest]")
+{
+  Test x(10, 12);
+
+  REQUIRE(data::Save("test.mlb", "x", x, false) == true);
+
+  // Now reload.
+  Test y(11, 14);
+
+  REQUIRE(data::Load("test.mlb", "x", y, false) == true);
+
+  REQUIRE(y.x == x.x);
+  REQUIRE(y.y == x.y);
+  REQUIRE(y.ina.c == x.ina.c);
+  REQUIRE(y.ina.s == x.ina.s);
+  REQUIRE(y.inb.c == x.inb.c);
+  REQUIRE(y.inb.s == x.inb.s);
+
+  remove("test.mlb");
+}
+
+/**
+ * Make sure that matrices larger than the buffers of the fast binary formats
+ * are kept, with and without compression.
+ */
+TEST_CASE("LoadFastBinaryMatrixTest", "[LoadSaveTest]")
+{
+  arma::mat x(100, 5000, arma::fill::randu);
+  x.col(7).zeros();
+
+  arma::mat y;
+  REQUIRE(data::Save("test.mlb", "x", x, false, format::fast_binary) == true);
+  REQUIRE(data::Load("test.mlb", "x", y, false, format::fast_binary) == true);
+  CheckMatrices(x, y);
+
+  // The extension doesn't tell whether the file is compressed.
+  #ifdef HAS_ZSTD
+  y.clear();
+  REQUIRE(data::Save("test.mlbz", "x", x, false,
+      format::compressed_binary) == true);
+  REQUIRE(data::Load("test.mlbz", "x", y, false,
+      format::fast_binary) == true);
+  CheckMatrices(x, y);
+  remove("test.mlbz");
+  #else
+  REQUIRE(data::Save("test.mlbz", "x", x, false,
+      format::compressed_binary) == false);
+  #endif
+
+  remove("test.mlb");
+}
+
+/**
+ * Make sure that the CheckpointWriter writes the snapshot it was given, even if
+ * the model changes while it is written, and that its errors are rethrown.
+ */
+TEST_CASE("CheckpointWriterTest", "[LoadSaveTest]")
+{
+  arma::mat x(100, 5000, arma::fill::randu);
+  const arma::mat original = x;
+
+  data::CheckpointWriter writer;
+  writer.Save("test_checkpoint.mlb", "x", x);
+  x.zeros();
+  writer.Wait();
+
+  arma::mat y;
+  REQUIRE(data::Load("test_checkpoint.mlb", "x", y, false) == true);
+  CheckMatrices(original, y);
+
+  // The next checkpoint replaces the first one, and no temporary file is left.
+  writer.Save("test_checkpoint.mlb", "x", x);
+  writer.Wait();
+  REQUIRE(data::Load("test_checkpoint.mlb", "x", y, false) == true);
+  CheckMatrices(x, y);
+  REQUIRE(!std::ifstream("test_checkpoint.partial.mlb").good());
+  remove("test_checkpoint.mlb");
+
+  // The format of this file can't be detected.
+  writer.Save("test_checkpoint.unknown", "x", x);
+  REQUIRE_THROWS_AS(writer.Wait(), std::runtime_error);
+}
+
+/**
+ * Make sure that loading a file that is not in the fast binary format fails.
+ */
+TEST_CASE("LoadFastBinaryInvalidTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test.mlb", fstream::out);
+  f << "this is not a model" << endl;
+  f.close();
+
+  Test y(11, 14);
+  REQUIRE(data::Load("test.mlb", "x", y, false) == false);
+  REQUIRE_THROWS_AS(data::Load("test.mlb", "x", y, true), std::runtime_error);
+
+  remove("test.mlb");
+}
+
 /**
  * Test DatasetInfo by making a map for a dimension.
  */
@@ -2364,3 +2472,673 @@ TEST_CASE("DatasetMapperNonUniqueTest", "[LoadSaveTest]")
   REQUIRE(dm.UnmapString(nan, 0, 1) == "goodbye");
   REQUIRE(dm.UnmapString(nan, 0, 2) == "cheese");
 }
+
+/**
+ * Make sure that the parallel CSV parser gives the same matrix and mappings as
+ * the boost::spirit parser, for numeric and categorical values, with and
+ * without transposing.
+ */
+TEST_CASE("ParallelLoadCSVTest", "[LoadSaveTest]")
+{
+  const char* extensions[] = { "csv", "tsv", "txt" };
+  const char delimiters[] = { ',', '\t', ' ' };
+  for (size_t e = 0; e < 3; ++e)
+  {
+    const std::string filename = std::string("test_parallel.") + extensions[e];
+    fstream f;
+    f.open(filename, fstream::out);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      f << (i * 0.37 - 20.5) << delimiters[e];
+      f << "cat" << (i * 7 % 13) << delimiters[e];
+      f << (i % 5) << "e-3" << delimiters[e];
+      // This dimension is categorical only because of its last value.
+      if (i == 999)
+        f << "end";
+      else
+        f << -(double) i;
+      f << endl;
+    }
+    f.close();
+
+    for (size_t t = 0; t < 2; ++t)
+    {
+      const bool transpose = (t == 0);
+      arma::mat parallel, serial;
+      DatasetInfo parallelInfo, serialInfo;
+
+      data::LoadCSV parallelLoader(filename);
+      parallelLoader.Load(parallel, parallelInfo, transpose, true);
+      data::LoadCSV serialLoader(filename);
+      serialLoader.Load(serial, serialInfo, transpose, false);
+
+      REQUIRE(parallel.n_rows == serial.n_rows);
+      REQUIRE(parallel.n_cols == serial.n_cols);
+      for (size_t i = 0; i < serial.n_elem; ++i)
+        REQUIRE(parallel[i] == serial[i]);
+
+      REQUIRE(parallelInfo.Dimensionality() == serialInfo.Dimensionality());
+      for (size_t d = 0; d < serialInfo.Dimensionality(); ++d)
+      {
+        REQUIRE(parallelInfo.Type(d) == serialInfo.Type(d));
+        REQUIRE(parallelInfo.NumMappings(d) == serialInfo.NumMappings(d));
+        for (size_t m = 0; m < serialInfo.NumMappings(d); ++m)
+        {
+          REQUIRE(parallelInfo.UnmapString(m, d) ==
+              serialInfo.UnmapString(m, d));
+        }
+      }
+    }
+
+    remove(filename.c_str());
+  }
+}
+
+/**
+ * Make sure that files the parallel parser does not handle are still loaded,
+ * and that malformed files still fail.
+ */
+TEST_CASE("ParallelLoadCSVFallbackTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_quoted.csv", fstream::out);
+  f << "1, \"a, b\", 3" << endl;
+  f << "4, 'c', 6" << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  REQUIRE(data::Load("test_quoted.csv", dataset, info, false, false));
+  REQUIRE(dataset.n_rows == 2);
+  REQUIRE(dataset.n_cols == 3);
+  REQUIRE(info.Type(1) == Datatype::categorical);
+  REQUIRE(info.NumMappings(1) == 2);
+
+  remove("test_quoted.csv");
+
+  f.open("test_malformed.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f << "4, 5" << endl;
+  f.close();
+
+  REQUIRE(!data::Load("test_malformed.csv", dataset, info, false, true));
+  REQUIRE(!data::Load("test_malformed.csv", dataset, info, false, false));
+
+  remove("test_malformed.csv");
+}
+
+/**
+ * Make sure that a CompactDatasetInfo gives the same matrix and mappings as a
+ * DatasetInfo, with both CSV parsers.
+ */
+TEST_CASE("CompactDatasetInfoLoadCSVTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_compact.csv", fstream::out);
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    f << (i * 0.37 - 20.5) << ", id" << (i * 7919 % 1500) << ", "
+        << (i % 3 == 0 ? "a" : "b") << ", " << (i == 1999 ? "end" : "7")
+        << endl;
+  }
+  f.close();
+
+  for (size_t p = 0; p < 2; ++p)
+  {
+    for (size_t t = 0; t < 2; ++t)
+    {
+      const bool transpose = (t == 0);
+      arma::mat compact, regular;
+      data::CompactDatasetInfo compactInfo;
+      data::DatasetInfo info;
+
+      data::LoadCSV compactLoader("test_compact.csv");
+      compactLoader.Load(compact, compactInfo, transpose, p == 0);
+      data::LoadCSV loader("test_compact.csv");
+      loader.Load(regular, info, transpose, p == 0);
+
+      REQUIRE(compact.n_rows == regular.n_rows);
+      REQUIRE(compact.n_cols == regular.n_cols);
+      for (size_t i = 0; i < regular.n_elem; ++i)
+        REQUIRE(compact[i] == regular[i]);
+
+      REQUIRE(compactInfo.Dimensionality() == info.Dimensionality());
+      for (size_t d = 0; d < info.Dimensionality(); ++d)
+      {
+        REQUIRE(compactInfo.Type(d) == info.Type(d));
+        REQUIRE(compactInfo.NumMappings(d) == info.NumMappings(d));
+        for (size_t m = 0; m < info.NumMappings(d); ++m)
+        {
+          REQUIRE(compactInfo.UnmapString(m, d) == info.UnmapString(m, d));
+          REQUIRE(compactInfo.UnmapValue(info.UnmapString(m, d), d) == m);
+        }
+      }
+    }
+  }
+
+  remove("test_compact.csv");
+}
+
+/**
+ * Test the mappings of a CompactDatasetInfo, and their serialization.
+ */
+TEST_CASE("CompactDatasetInfoTest", "[LoadSaveTest]")
+{
+  data::CompactDatasetInfo info(3);
+  REQUIRE(info.MapString<double>("1.5", 0) == 1.5);
+  REQUIRE(info.Type(0) == data::Datatype::numeric);
+  REQUIRE(info.NumMappings(0) == 0);
+
+  // Many distinct values, each seen twice.
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    const std::string id = "user" + std::to_string(i);
+    REQUIRE(info.MapString<double>(id, 1) == (double) i);
+  }
+  for (size_t i = 0; i < 20000; i += 7)
+  {
+    const std::string id = "user" + std::to_string(i);
+    REQUIRE(info.MapString<double>(id, 1) == (double) i);
+  }
+  REQUIRE(info.Type(1) == data::Datatype::categorical);
+  REQUIRE(info.NumMappings(1) == 20000);
+  REQUIRE(info.MapString<double>("", 2) == 0.0);
+  REQUIRE(info.NumMappings(2) == 1);
+
+  REQUIRE(info.UnmapString(1234, 1) == "user1234");
+  REQUIRE(info.UnmapValue("user19999", 1) == 19999);
+  REQUIRE(info.NumUnmappings(5.0, 1) == 1);
+  REQUIRE(info.NumUnmappings(20000.0, 1) == 0);
+  REQUIRE_THROWS_AS(info.UnmapString(20000, 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(info.UnmapString(0.5, 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(info.UnmapString(0, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(info.UnmapString(1, 1, 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(info.UnmapValue("user20000", 1), std::invalid_argument);
+
+  data::CompactDatasetInfo xmlInfo, textInfo, binaryInfo;
+  SerializeObjectAll(info, xmlInfo, textInfo, binaryInfo);
+  data::CompactDatasetInfo* infos[] = { &xmlInfo, &textInfo, &binaryInfo };
+  for (size_t j = 0; j < 3; ++j)
+  {
+    REQUIRE(infos[j]->Dimensionality() == 3);
+    REQUIRE(infos[j]->Type(0) == data::Datatype::numeric);
+    REQUIRE(infos[j]->Type(1) == data::Datatype::categorical);
+    REQUIRE(infos[j]->NumMappings(1) == 20000);
+    REQUIRE(infos[j]->NumMappings(2) == 1);
+    for (size_t i = 0; i < 20000; i += 97)
+    {
+      REQUIRE(infos[j]->UnmapValue("user" + std::to_string(i), 1) == i);
+      REQUIRE(infos[j]->UnmapString(i, 1) == "user" + std::to_string(i));
+    }
+    REQUIRE(infos[j]->UnmapString(0, 2) == "");
+
+    // New values still get the next codes.
+    REQUIRE(infos[j]->MapString<double>("user5", 1) == 5.0);
+    REQUIRE(infos[j]->MapString<double>("newuser", 1) == 20000.0);
+  }
+}
+
+/**
+ * Make sure that the chunks of a CSV file with categorical dimensions make up
+ * the matrix and the mappings given by data::Load().
+ */
+TEST_CASE("ChunkedLoaderCSVTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_chunked.csv", fstream::out);
+  for (size_t i = 0; i < 103; ++i)
+  {
+    f << (i * 1.5) << ", c" << (i * 11 % 7) << ", " << (i % 3);
+    // The last dimension is only categorical because of the last point.
+    f << ", " << ((i == 102) ? std::string("x") : std::to_string(i)) << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  REQUIRE(data::Load("test_chunked.csv", dataset, info));
+
+  data::ChunkedLoader<double> loader("test_chunked.csv", 10);
+  REQUIRE(loader.NumPoints() == 103);
+  REQUIRE(loader.Dimensionality() == 4);
+
+  // Read the file twice; the second epoch must give the same chunks.
+  for (size_t epoch = 0; epoch < 2; ++epoch)
+  {
+    arma::mat chunk;
+    size_t points = 0;
+    while (loader.Next(chunk))
+    {
+      REQUIRE(chunk.n_rows == 4);
+      REQUIRE(chunk.n_cols == std::min((size_t) 10, 103 - points));
+      CheckMatrices(chunk,
+        arma::mat(dataset.cols(points, points + chunk.n_cols - 1)));
+      points += chunk.n_cols;
+    }
+    REQUIRE(points == 103);
+    REQUIRE(chunk.n_elem == 0);
+
+    for (size_t d = 0; d < 4; ++d)
+    {
+      REQUIRE(loader.Info().Type(d) == info.Type(d));
+      REQUIRE(loader.Info().NumMappings(d) == info.NumMappings(d));
+    }
+
+    loader.Reset();
+  }
+
+  remove("test_chunked.csv");
+}
+
+/**
+ * Make sure that a ChunkedLoader given a DatasetInfo keeps its mappings, adds
+ * the new categories, and rejects non-numbers in numeric dimensions.
+ */
+TEST_CASE("ChunkedLoaderGivenInfoTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_chunked_train.csv", fstream::out);
+  f << "1, a" << endl;
+  f << "2, b" << endl;
+  f.close();
+
+  f.open("test_chunked_test.csv", fstream::out);
+  f << "3, b" << endl;
+  f << "4, c" << endl;
+  f << "5, a" << endl;
+  f.close();
+
+  f.open("test_chunked_bad.csv", fstream::out);
+  f << "3, b" << endl;
+  f << "x, c" << endl;
+  f.close();
+
+  arma::mat train;
+  DatasetInfo info;
+  REQUIRE(data::Load("test_chunked_train.csv", train, info));
+
+  data::ChunkedLoader<double> loader("test_chunked_test.csv", info, 2);
+  arma::mat chunk;
+  REQUIRE(loader.Next(chunk));
+  REQUIRE(chunk.n_cols == 2);
+  REQUIRE(chunk(0, 0) == 3.0);
+  REQUIRE(chunk(1, 0) == train(1, 1));
+  REQUIRE(chunk(0, 1) == 4.0);
+  REQUIRE(chunk(1, 1) == 2.0);
+  REQUIRE(loader.Next(chunk));
+  REQUIRE(chunk.n_cols == 1);
+  REQUIRE(chunk(1, 0) == train(1, 0));
+  REQUIRE(!loader.Next(chunk));
+  REQUIRE(loader.Info().NumMappings(1) == 3);
+
+  data::ChunkedLoader<double> badLoader("test_chunked_bad.csv", info, 1);
+  REQUIRE(badLoader.Next(chunk));
+  REQUIRE_THROWS_AS(badLoader.Next(chunk), std::runtime_error);
+
+  remove("test_chunked_train.csv");
+  remove("test_chunked_test.csv");
+  remove("test_chunked_bad.csv");
+}
+
+/**
+ * Make sure that the chunks of an ARFF file make up the matrix given by
+ * data::Load().
+ */
+TEST_CASE("ChunkedLoaderARFFTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_chunked.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one STRING" << endl;
+  f << "@attribute two REAL" << endl;
+  f << "@attribute three {moo, goodbye}" << endl;
+  f << "@data" << endl;
+  f << "hello, 1, moo" << endl;
+  f << "cheese, 2.34, goodbye" << endl;
+  f << "seven, 1.03e+5, moo" << endl;
+  f << "hello, -1.3, goodbye" << endl;
+  f << "seven, 4, goodbye" << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  REQUIRE(data::Load("test_chunked.arff", dataset, info));
+
+  data::ChunkedLoader<double> loader("test_chunked.arff", 2);
+  REQUIRE(loader.NumPoints() == 5);
+  arma::mat chunk;
+  size_t points = 0;
+  while (loader.Next(chunk))
+  {
+    CheckMatrices(chunk,
+        arma::mat(dataset.cols(points, points + chunk.n_cols - 1)));
+    points += chunk.n_cols;
+  }
+  REQUIRE(points == 5);
+
+  for (size_t d = 0; d < 3; ++d)
+  {
+    REQUIRE(loader.Info().Type(d) == info.Type(d));
+    REQUIRE(loader.Info().NumMappings(d) == info.NumMappings(d));
+  }
+
+  remove("test_chunked.arff");
+}
+
+/**
+ * Make sure that the chunks of an Armadillo binary file are the right blocks of
+ * the matrix, with and without transposing.
+ */
+TEST_CASE("ChunkedLoaderBinaryTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(5, 37, arma::fill::randu);
+
+  // data::Save() transposes the matrix, so the points of the file are rows.
+  REQUIRE(data::Save("test_chunked.bin", dataset));
+  data::ChunkedLoader<double> loader("test_chunked.bin", 8);
+  REQUIRE(loader.Dimensionality() == 5);
+  REQUIRE(loader.NumPoints() == 37);
+
+  arma::mat chunk;
+  size_t points = 0;
+  while (loader.Next(chunk))
+  {
+    REQUIRE(chunk.n_cols == std::min((size_t) 8, 37 - points));
+    CheckMatrices(chunk,
+        arma::mat(dataset.cols(points, points + chunk.n_cols - 1)));
+    points += chunk.n_cols;
+  }
+  REQUIRE(points == 37);
+
+  // Now the points are the columns of the file.
+  REQUIRE(dataset.save("test_chunked.bin", arma::arma_binary));
+  data::ChunkedLoader<double> columnLoader("test_chunked.bin", 8, false);
+  REQUIRE(columnLoader.Dimensionality() == 5);
+  REQUIRE(columnLoader.NumPoints() == 37);
+
+  points = 0;
+  while (columnLoader.Next(chunk))
+  {
+    CheckMatrices(chunk,
+        arma::mat(dataset.cols(points, points + chunk.n_cols - 1)));
+    points += chunk.n_cols;
+  }
+  REQUIRE(points == 37);
+
+  // The element type must match.
+  REQUIRE_THROWS_AS(data::ChunkedLoader<float>("test_chunked.bin", 8, false),
+      std::runtime_error);
+
+  remove("test_chunked.bin");
+}
+
+#ifndef _WIN32
+/**
+ * Make sure that a .mlpk file saved by data::Save() is memory-mapped by
+ * data::Load(), and that the mapping is released by data::ReleaseMapped().
+ */
+TEST_CASE("LoadSaveMappedMatrixTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(7, 23, arma::fill::randu);
+  REQUIRE(data::Save("test_mapped.mlpk", dataset, true));
+
+  // The matrix is never transposed.
+  arma::mat loaded;
+  REQUIRE(data::Load("test_mapped.mlpk", loaded, true));
+  REQUIRE(loaded.n_rows == 7);
+  REQUIRE(loaded.n_cols == 23);
+  CheckMatrices(loaded, dataset);
+
+  // The elements start on a page boundary.
+  REQUIRE(((size_t) loaded.memptr()) % 4096 == 0);
+
+  REQUIRE(data::ReleaseMapped(loaded));
+  REQUIRE(loaded.n_elem == 0);
+  REQUIRE(!data::ReleaseMapped(loaded));
+
+  // A matrix with another element type can't be mapped.
+  arma::fmat floats;
+  REQUIRE_THROWS_AS(data::LoadMapped("test_mapped.mlpk", floats),
+      std::runtime_error);
+  REQUIRE(!data::Load("test_mapped.mlpk", floats, false));
+
+  remove("test_mapped.mlpk");
+}
+
+/**
+ * Make sure that the mappings of a DatasetInfo saved with a mapped matrix are
+ * restored by data::Load().
+ */
+TEST_CASE("LoadSaveMappedMatrixInfoTest", "[LoadSaveTest]")
+{
+  data::DatasetInfo info(3);
+  info.Type(1) = data::Datatype::categorical;
+  info.MapString<double>("red", 1);
+  info.MapString<double>("green", 1);
+  info.MapString<double>("blue", 1);
+
+  arma::mat dataset(3, 10, arma::fill::randu);
+  dataset.row(1) = arma::floor(3 * dataset.row(1));
+  data::MappedMatrix<double>::Save("test_mapped.mlpk", dataset, info);
+
+  arma::mat loaded;
+  data::DatasetInfo loadedInfo;
+  REQUIRE(data::Load("test_mapped.mlpk", loaded, loadedInfo, true));
+  CheckMatrices(loaded, dataset);
+
+  REQUIRE(loadedInfo.Dimensionality() == 3);
+  REQUIRE(loadedInfo.Type(0) == data::Datatype::numeric);
+  REQUIRE(loadedInfo.Type(1) == data::Datatype::categorical);
+  REQUIRE(loadedInfo.Type(2) == data::Datatype::numeric);
+  REQUIRE(loadedInfo.NumMappings(1) == 3);
+  REQUIRE(loadedInfo.UnmapString(0, 1) == "red");
+  REQUIRE(loadedInfo.UnmapString(1, 1) == "green");
+  REQUIRE(loadedInfo.UnmapString(2, 1) == "blue");
+
+  REQUIRE(data::ReleaseMapped(loaded));
+  remove("test_mapped.mlpk");
+}
+#endif
+
+/**
+ * Make sure that the components of a model archive can be loaded one at a
+ * time, and that matrices are used in place.
+ */
+TEST_CASE("ModelArchiveTest", "[LoadSaveTest]")
+{
+  data::DatasetInfo info(3);
+  info.Type(1) = data::Datatype::categorical;
+  info.MapString<double>("red", 1);
+  arma::mat centroids(4, 9, arma::fill::randu);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(17,
+      arma::distr_param(0, 5));
+
+  data::ModelArchiveWriter writer("test_archive.mla");
+  writer.Add("info", info);
+  writer.AddMatrix("centroids", centroids);
+  writer.Add("labels", labels);
+  REQUIRE_THROWS_AS(writer.Add("info", info), std::invalid_argument);
+  writer.Finish();
+  REQUIRE_THROWS_AS(writer.Add("more", labels), std::invalid_argument);
+
+  data::ModelArchive archive("test_archive.mla");
+  REQUIRE(archive.Entries().size() == 3);
+  REQUIRE(archive.Contains("labels"));
+  REQUIRE(!archive.Contains("more"));
+
+  // The components can be loaded in any order.
+  arma::Row<size_t> loadedLabels;
+  archive.Load("labels", loadedLabels);
+  REQUIRE(arma::all(loadedLabels == labels));
+
+  data::DatasetInfo loadedInfo;
+  archive.Load("info", loadedInfo);
+  REQUIRE(loadedInfo.Dimensionality() == 3);
+  REQUIRE(loadedInfo.Type(1) == data::Datatype::categorical);
+  REQUIRE(loadedInfo.UnmapString(0, 1) == "red");
+
+  arma::mat loadedCentroids;
+  archive.LoadMatrix("centroids", loadedCentroids);
+  CheckMatrices(loadedCentroids, centroids);
+  REQUIRE(((size_t) loadedCentroids.memptr()) % 64 == 0);
+
+  // The kinds and types of the components are checked.
+  arma::fmat floats;
+  REQUIRE_THROWS_AS(archive.LoadMatrix("centroids", floats),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(archive.Load("centroids", loadedLabels),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(archive.Load("missing", loadedLabels),
+      std::invalid_argument);
+
+  // An unfinished archive can't be opened.
+  {
+    data::ModelArchiveWriter unfinished("test_unfinished.mla");
+    unfinished.Add("labels", labels);
+  }
+  REQUIRE_THROWS_AS(data::ModelArchive("test_unfinished.mla"),
+      std::runtime_error);
+
+  remove("test_archive.mla");
+  remove("test_unfinished.mla");
+}
+
+#ifdef HAS_ARROW
+/**
+ * Write a small Parquet file with a double, an integer and a string column,
+ * in row groups of four rows.
+ */
+static void WriteParquetTestFile(const std::string& filename)
+{
+  arrow::DoubleBuilder xBuilder;
+  arrow::Int32Builder nBuilder;
+  arrow::StringBuilder colorBuilder;
+  const char* colors[] = { "red", "green", "blue" };
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(xBuilder.Append(0.5 * i).ok());
+    if (i == 3)
+      REQUIRE(nBuilder.AppendNull().ok());
+    else
+      REQUIRE(nBuilder.Append((int) (i * i)).ok());
+    REQUIRE(colorBuilder.Append(colors[(i * 2) % 3]).ok());
+  }
+
+  std::shared_ptr<arrow::Array> x, n, color;
+  REQUIRE(xBuilder.Finish(&x).ok());
+  REQUIRE(nBuilder.Finish(&n).ok());
+  REQUIRE(colorBuilder.Finish(&color).ok());
+
+  std::shared_ptr<arrow::Schema> schema = arrow::schema({
+      arrow::field("x", arrow::float64()),
+      arrow::field("n", arrow::int32()),
+      arrow::field("color", arrow::utf8()) });
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(schema,
+      { x, n, color });
+
+  arrow::Result<std::shared_ptr<arrow::io::FileOutputStream>> output =
+      arrow::io::FileOutputStream::Open(filename);
+  REQUIRE(output.ok());
+  REQUIRE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(),
+      *output, 4).ok());
+  REQUIRE((*output)->Close().ok());
+}
+
+/**
+ * Make sure that data::Load() loads Parquet files, mapping the string columns.
+ */
+TEST_CASE("LoadParquetTest", "[LoadSaveTest]")
+{
+  WriteParquetTestFile("test.parquet");
+  REQUIRE(data::ParquetNumRowGroups("test.parquet") == 3);
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test.parquet", dataset, info, true));
+
+  REQUIRE(dataset.n_rows == 3);
+  REQUIRE(dataset.n_cols == 10);
+  REQUIRE(info.Type(0) == data::Datatype::numeric);
+  REQUIRE(info.Type(1) == data::Datatype::numeric);
+  REQUIRE(info.Type(2) == data::Datatype::categorical);
+  REQUIRE(info.NumMappings(2) == 3);
+
+  // The colors appear in the order red, blue, green.
+  const size_t mappings[] = { 0, 2, 1 };
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(dataset(0, i) == Approx(0.5 * i).epsilon(1e-7));
+    if (i == 3)
+      REQUIRE(std::isnan(dataset(1, i)));
+    else
+      REQUIRE(dataset(1, i) == Approx(i * i).epsilon(1e-7));
+    REQUIRE(dataset(2, i) == mappings[(i * 2) % 3]);
+  }
+
+  // Without a DatasetInfo, the string column can't be loaded.
+  arma::mat numeric;
+  REQUIRE(!data::Load("test.parquet", numeric, false));
+  REQUIRE_THROWS_AS(data::LoadParquet("test.parquet", numeric),
+      std::runtime_error);
+
+  remove("test.parquet");
+}
+
+/**
+ * Make sure that LoadParquet() reads only the given columns and row groups,
+ * and keeps the mappings from one call to the next.
+ */
+TEST_CASE("LoadParquetColumnsTest", "[LoadSaveTest]")
+{
+  WriteParquetTestFile("test.parquet");
+
+  arma::mat numeric;
+  data::LoadParquet("test.parquet", numeric, { "n", "x" });
+  REQUIRE(numeric.n_rows == 2);
+  REQUIRE(numeric.n_cols == 10);
+  REQUIRE(numeric(0, 2) == Approx(4.0).epsilon(1e-7));
+  REQUIRE(numeric(1, 2) == Approx(1.0).epsilon(1e-7));
+
+  REQUIRE_THROWS_AS(data::LoadParquet("test.parquet", numeric, { "y" }),
+      std::runtime_error);
+
+  // Stream the row groups, one at a time.
+  data::DatasetInfo info;
+  arma::mat full;
+  for (size_t g = 0; g < 3; ++g)
+  {
+    arma::mat group;
+    data::LoadParquet("test.parquet", group, info, { "color", "x" }, g, 1);
+    REQUIRE(group.n_rows == 2);
+    REQUIRE(group.n_cols == (g < 2 ? 4 : 2));
+    full = arma::join_rows(full, group);
+  }
+
+  arma::mat dataset;
+  data::DatasetInfo fullInfo;
+  data::LoadParquet("test.parquet", dataset, fullInfo, { "color", "x" });
+  CheckMatrices(full, dataset);
+  REQUIRE(info.NumMappings(0) == fullInfo.NumMappings(0));
+  for (size_t i = 0; i < fullInfo.NumMappings(0); ++i)
+    REQUIRE(info.UnmapString(i, 0) == fullInfo.UnmapString(i, 0));
+
+  remove("test.parquet");
+}
+#else
+/**
+ * Without Arrow support, loading a Parquet file fails.
+ */
+TEST_CASE("LoadParquetUnsupportedTest", "[LoadSaveTest]")
+{
+  std::fstream f("test.parquet", std::fstream::out);
+  f << "PAR1";
+  f.close();
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  REQUIRE(!data::Load("test.parquet", dataset, false));
+  REQUIRE(!data::Load("test.parquet", dataset, info, false));
+
+  remove("test.parquet");
+}
+#endif
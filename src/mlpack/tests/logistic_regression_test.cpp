@@ -180,6 +180,64 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionGradient)
   BOOST_REQUIRE_GE(gradient[0], 0.0);
 }
 
+/**
+ * Make sure that the objective and gradient are the same for sparse and dense
+ * predictors, for batches large enough to be split over several threads.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionSparseDenseTest)
+{
+  const size_t points = 3 * LogisticRegressionFunction<>::MinChunkSize + 17;
+  arma::sp_mat sparseData;
+  sparseData.sprandu(20, points, 0.05);
+  arma::mat denseData(sparseData);
+
+  arma::Row<size_t> responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = (arma::accu(denseData.col(i)) > 0.5) ? 1 : 0;
+
+  LogisticRegressionFunction<arma::mat> lrfDense(denseData, responses, 0.5);
+  LogisticRegressionFunction<arma::sp_mat> lrfSparse(sparseData, responses,
+      0.5);
+
+  arma::rowvec parameters(21, arma::fill::randn);
+
+  BOOST_REQUIRE_CLOSE(lrfDense.Evaluate(parameters),
+      lrfSparse.Evaluate(parameters), 1e-5);
+
+  arma::mat denseGradient, sparseGradient;
+  lrfDense.Gradient(parameters, denseGradient);
+  lrfSparse.Gradient(parameters, sparseGradient);
+  CheckMatrices(denseGradient, sparseGradient, 1e-5);
+
+  // The fused objective and gradient must match the separate computations.
+  arma::mat fusedGradient;
+  const double fused = lrfSparse.EvaluateWithGradient(parameters,
+      fusedGradient);
+  BOOST_REQUIRE_CLOSE(fused, lrfDense.Evaluate(parameters), 1e-5);
+  CheckMatrices(denseGradient, fusedGradient, 1e-5);
+
+  // Now check a large batch and a small batch.
+  const size_t batchSizes[] = { 2 * LogisticRegressionFunction<>::MinChunkSize,
+                                10 };
+  for (const size_t batchSize : batchSizes)
+  {
+    arma::mat denseBatchGradient, sparseBatchGradient;
+    const double denseObjective = lrfDense.EvaluateWithGradient(parameters,
+        13, denseBatchGradient, batchSize);
+    const double sparseObjective = lrfSparse.EvaluateWithGradient(parameters,
+        13, sparseBatchGradient, batchSize);
+
+    BOOST_REQUIRE_CLOSE(denseObjective, sparseObjective, 1e-5);
+    BOOST_REQUIRE_CLOSE(denseObjective, lrfDense.Evaluate(parameters, 13,
+        batchSize), 1e-5);
+    CheckMatrices(denseBatchGradient, sparseBatchGradient, 1e-5);
+
+    arma::mat batchGradient;
+    lrfSparse.Gradient(parameters, 13, batchGradient, batchSize);
+    CheckMatrices(denseBatchGradient, batchGradient, 1e-5);
+  }
+}
+
 /**
  * Test individual Evaluate() functions for SGD.
  */
@@ -21,6 +21,7 @@
 #include <mlpack/methods/ann/loss_functions/earth_mover_distance.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/loss_functions/sigmoid_cross_entropy_error.hpp>
+#include <mlpack/methods/ann/loss_functions/softmax_cross_entropy.hpp>
 #include <mlpack/methods/ann/loss_functions/cross_entropy_error.hpp>
 #include <mlpack/methods/ann/loss_functions/reconstruction_loss.hpp>
 #include <mlpack/methods/ann/loss_functions/margin_ranking_loss.hpp>
@@ -370,6 +371,66 @@ BOOST_AUTO_TEST_CASE(SimpleSigmoidCrossEntropyErrorTest)
   BOOST_REQUIRE_EQUAL(output.n_cols, input3.n_cols);
 }
 
+/**
+ * Make sure that the fused ForwardBackward() of SigmoidCrossEntropyError gives
+ * the results of Forward() and Backward().
+ */
+BOOST_AUTO_TEST_CASE(SigmoidCrossEntropyErrorForwardBackwardTest)
+{
+  arma::mat input = 10 * arma::randn<arma::mat>(3, 20);
+  arma::mat target = arma::round(arma::randu<arma::mat>(3, 20));
+  SigmoidCrossEntropyError<> module;
+
+  arma::mat output, fusedOutput;
+  const double error = module.Forward(input, target);
+  module.Backward(input, target, output);
+  const double fusedError = module.ForwardBackward(input, target, fusedOutput);
+
+  BOOST_REQUIRE_CLOSE(fusedError, error, 1e-8);
+  CheckMatrices(output, fusedOutput);
+}
+
+/**
+ * Make sure that SoftmaxCrossEntropy gives the loss and the error of a
+ * LogSoftMax layer followed by NegativeLogLikelihood, and that it does not
+ * overflow with large logits.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxCrossEntropyTest)
+{
+  arma::mat input = arma::randn<arma::mat>(5, 30);
+  arma::mat target = arma::floor(arma::randu<arma::mat>(1, 30) * 5) + 1;
+
+  LogSoftMax<> logSoftMax;
+  NegativeLogLikelihood<> nll;
+  arma::mat logProbabilities, nllError, expectedError;
+  logSoftMax.Forward(input, logProbabilities);
+  const double expectedLoss = nll.Forward(logProbabilities, target);
+  nll.Backward(logProbabilities, target, nllError);
+  logSoftMax.Backward(logProbabilities, nllError, expectedError);
+
+  // LogSoftMax approximates the exponential function.
+  SoftmaxCrossEntropy<> module;
+  arma::mat error, fusedError;
+  const double loss = module.Forward(input, target);
+  module.Backward(input, target, error);
+  const double fusedLoss = module.ForwardBackward(input, target, fusedError);
+
+  BOOST_REQUIRE_CLOSE(loss, expectedLoss, 1e-2);
+  BOOST_REQUIRE_LE(arma::abs(error - expectedError).max(), 1e-4);
+  BOOST_REQUIRE_CLOSE(fusedLoss, loss, 1e-10);
+  CheckMatrices(fusedError, error);
+
+  // The error of each point sums to zero.
+  for (size_t i = 0; i < error.n_cols; ++i)
+    BOOST_REQUIRE_SMALL(arma::accu(error.col(i)), 1e-10);
+
+  // Large logits must not overflow.
+  input *= 1000;
+  const double largeLoss = module.ForwardBackward(input, target, error);
+  BOOST_REQUIRE(std::isfinite(largeLoss));
+  BOOST_REQUIRE(error.is_finite());
+}
+
 /**
  * Simple test for the Earth Mover Distance Layer.
  */
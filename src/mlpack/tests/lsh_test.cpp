@@ -846,6 +846,53 @@ BOOST_AUTO_TEST_CASE(ParallelMonochromatic)
 }
 #endif
 
+/**
+ * Test: queries are hashed in blocks.  Make sure that searching a large query
+ * set at once (with multiprobe) gives the same results as searching each query
+ * on its own.
+ */
+BOOST_AUTO_TEST_CASE(BatchedQueryHashingTest)
+{
+  const size_t k = 3;
+  const size_t numTables = 8;
+  const size_t numProj = 4;
+  const size_t T = 5;
+
+  arma::mat rdata(5, 1000, arma::fill::randu);
+  arma::mat qdata(5, 5000, arma::fill::randu);
+
+  LSHSearch<> lshTest(rdata, numProj, numTables, 0.5);
+
+  arma::Mat<size_t> batchNeighbors;
+  arma::mat batchDistances;
+  lshTest.Search(qdata, k, batchNeighbors, batchDistances, 0, T);
+
+  for (size_t i = 0; i < qdata.n_cols; ++i)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    lshTest.Search(qdata.col(i), k, neighbors, distances, 0, T);
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, 0), batchNeighbors(j, i));
+      BOOST_REQUIRE_CLOSE(distances(j, 0), batchDistances(j, i), 1e-5);
+    }
+  }
+
+  // Searching only some of the tables must also work in blocks.
+  lshTest.Search(qdata, k, batchNeighbors, batchDistances, 3, T);
+  for (size_t i = 0; i < qdata.n_cols; i += 100)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    lshTest.Search(qdata.col(i), k, neighbors, distances, 3, T);
+
+    for (size_t j = 0; j < k; ++j)
+      BOOST_REQUIRE_EQUAL(neighbors(j, 0), batchNeighbors(j, i));
+  }
+}
+
 // Test the copy constructor and the copy operator.
 BOOST_AUTO_TEST_CASE(CopyConstructorAndOperatorTest)
 {
@@ -985,4 +1032,74 @@ BOOST_AUTO_TEST_CASE(SparseLSHTest)
   }
 }
 
+/**
+ * Make sure that the compressed buckets hold every point of every table once
+ * (when the buckets are not full), and that memory-mapping them and loading a
+ * model with mapped buckets gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(MapHashTableTest)
+{
+  const size_t k = 4;
+  const size_t numTables = 6;
+
+  arma::mat rdata(4, 2000, arma::fill::randu);
+  arma::mat qdata(4, 100, arma::fill::randu);
+
+  // A bucket size of 0 means no limit, so no point is dropped.
+  LSHSearch<> lsh(rdata, 3, numTables, 0.3, 99901, 0);
+
+  const std::vector<arma::Col<size_t>> buckets = lsh.SecondHashTable();
+  size_t totalPoints = 0;
+  for (size_t i = 0; i < buckets.size(); ++i)
+  {
+    for (size_t j = 1; j < buckets[i].n_elem; ++j)
+      BOOST_REQUIRE_LE(buckets[i][j - 1], buckets[i][j]);
+    for (size_t j = 0; j < buckets[i].n_elem; ++j)
+      BOOST_REQUIRE_LT(buckets[i][j], rdata.n_cols);
+    totalPoints += buckets[i].n_elem;
+  }
+  BOOST_REQUIRE_EQUAL(totalPoints, numTables * rdata.n_cols);
+
+  arma::Mat<size_t> baselineNeighbors, neighbors;
+  arma::mat baselineDistances, distances;
+  lsh.Search(qdata, k, baselineNeighbors, baselineDistances, 0, 2);
+
+  lsh.MapHashTable("lsh_hash_table_map.bin");
+  BOOST_REQUIRE_EQUAL(lsh.HashTableMapFile(), "lsh_hash_table_map.bin");
+
+  lsh.Search(qdata, k, neighbors, distances, 0, 2);
+  CheckMatrices(neighbors, baselineNeighbors);
+  CheckMatrices(distances, baselineDistances);
+
+  // Copies share the mapping.
+  LSHSearch<> copy(lsh);
+  BOOST_REQUIRE_EQUAL(copy.HashTableMapFile(), "lsh_hash_table_map.bin");
+  copy.Search(qdata, k, neighbors, distances, 0, 2);
+  CheckMatrices(neighbors, baselineNeighbors);
+
+  // The saved model only refers to the file.
+  BOOST_REQUIRE(data::Save("lsh_mapped_model.bin", "lsh_model", lsh, true));
+
+  LSHSearch<> loaded;
+  BOOST_REQUIRE(data::Load("lsh_mapped_model.bin", "lsh_model", loaded,
+      true));
+  BOOST_REQUIRE_EQUAL(loaded.HashTableMapFile(), "lsh_hash_table_map.bin");
+
+  const std::vector<arma::Col<size_t>> loadedBuckets = loaded.SecondHashTable();
+  BOOST_REQUIRE_EQUAL(loadedBuckets.size(), buckets.size());
+  for (size_t i = 0; i < buckets.size(); ++i)
+    CheckMatrices(loadedBuckets[i], buckets[i]);
+
+  loaded.Search(qdata, k, neighbors, distances, 0, 2);
+  CheckMatrices(neighbors, baselineNeighbors);
+  CheckMatrices(distances, baselineDistances);
+
+  // Training again drops the mapping.
+  loaded.Train(rdata, 3, numTables, 0.3, 99901, 0);
+  BOOST_REQUIRE_EQUAL(loaded.HashTableMapFile(), "");
+
+  remove("lsh_mapped_model.bin");
+  remove("lsh_hash_table_map.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
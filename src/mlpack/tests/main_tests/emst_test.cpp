@@ -129,4 +129,29 @@ BOOST_AUTO_TEST_CASE(EMSTFirstTwoOutputRowsIntegerTest)
   }
 }
 
+/**
+ * Make sure that the linkage output has one merge for each edge, and that the
+ * last merge contains all the points.
+ */
+BOOST_AUTO_TEST_CASE(EMSTLinkageTest)
+{
+  arma::mat x;
+  if (!data::Load("test_data_3_1000.csv", x))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("parallel", true);
+
+  mlpackMain();
+
+  const arma::mat& linkage = IO::GetParam<arma::mat>("linkage");
+  BOOST_REQUIRE_EQUAL(linkage.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(linkage.n_cols, 999);
+  BOOST_REQUIRE_EQUAL(linkage(3, 998), 1000);
+
+  // The merges must be in order of increasing distance.
+  for (size_t i = 1; i < linkage.n_cols; ++i)
+    BOOST_REQUIRE_LE(linkage(2, i - 1), linkage(2, i));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
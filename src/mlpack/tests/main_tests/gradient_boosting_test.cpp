@@ -0,0 +1,159 @@
+/**
+ * @file tests/main_tests/gradient_boosting_test.cpp
+ *
+ * Test mlpackMain() of gradient_boosting_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+static const std::string testName = "GradientBoosting";
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting_main.cpp>
+#include "test_helper.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct GradientBoostingTestFixture
+{
+ public:
+  GradientBoostingTestFixture()
+  {
+    // Cache in the options for this program.
+    IO::RestoreSettings(testName);
+  }
+
+  ~GradientBoostingTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    IO::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(GradientBoostingMainTest,
+                         GradientBoostingTestFixture);
+
+/**
+ * Check that the number of output points is the number of input points, and
+ * that there is one probability per class.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingOutputDimensionTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  size_t testSize = testData.n_cols;
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("test", std::move(testData));
+  SetInputParam("num_rounds", (int) 10);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(IO::GetParam<arma::Row<size_t>>("predictions").n_cols,
+                      testSize);
+  BOOST_REQUIRE_EQUAL(IO::GetParam<arma::mat>("probabilities").n_cols,
+                      testSize);
+  BOOST_REQUIRE_EQUAL(IO::GetParam<arma::Row<size_t>>("predictions").n_rows,
+                      1);
+  BOOST_REQUIRE_EQUAL(IO::GetParam<arma::mat>("probabilities").n_rows, 3);
+}
+
+/**
+ * Ensure that a saved model gives the same predictions again.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingModelReuseTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("test", testData);
+  SetInputParam("num_rounds", (int) 10);
+
+  mlpackMain();
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  predictions = std::move(IO::GetParam<arma::Row<size_t>>("predictions"));
+  probabilities = std::move(IO::GetParam<arma::mat>("probabilities"));
+
+  // Reset passed parameters.
+  IO::GetSingleton().Parameters()["training"].wasPassed = false;
+  IO::GetSingleton().Parameters()["labels"].wasPassed = false;
+  IO::GetSingleton().Parameters()["test"].wasPassed = false;
+
+  // Input trained model.
+  SetInputParam("test", std::move(testData));
+  SetInputParam("input_model",
+                IO::GetParam<GradientBoosting*>("output_model"));
+
+  mlpackMain();
+
+  CheckMatrices(predictions, IO::GetParam<arma::Row<size_t>>("predictions"));
+  CheckMatrices(probabilities, IO::GetParam<arma::mat>("probabilities"));
+}
+
+/**
+ * Make sure that invalid training parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingInvalidParametersTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("print_training_accuracy", true);
+
+  Log::Fatal.ignoreInput = true;
+
+  SetInputParam("num_rounds", (int) 0);
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  SetInputParam("num_rounds", (int) 10);
+
+  SetInputParam("row_subsample", 1.5);
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  SetInputParam("row_subsample", 1.0);
+
+  SetInputParam("max_bins", (int) 1000);
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,113 @@
+/**
+ * @file tests/main_tests/hnsw_test.cpp
+ *
+ * Test mlpackMain() of hnsw_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "HNSW";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/hnsw/hnsw_main.cpp>
+
+#include "../catch.hpp"
+#include "../test_catch_tools.hpp"
+
+using namespace mlpack;
+
+struct HNSWTestFixture
+{
+ public:
+  HNSWTestFixture()
+  {
+    // Cache in the options for this program.
+    IO::RestoreSettings(testName);
+  }
+
+  ~HNSWTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    IO::ClearSettings();
+  }
+};
+
+/**
+ * Check that the output neighbors and distances have the right dimensions.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWOutputDimensionTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 300);
+  arma::mat query = arma::randu<arma::mat>(5, 40);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", std::move(query));
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  REQUIRE(IO::GetParam<arma::Mat<size_t>>("neighbors").n_rows == 6);
+  REQUIRE(IO::GetParam<arma::Mat<size_t>>("neighbors").n_cols == 40);
+  REQUIRE(IO::GetParam<arma::mat>("distances").n_rows == 6);
+  REQUIRE(IO::GetParam<arma::mat>("distances").n_cols == 40);
+}
+
+/**
+ * Check that an invalid number of links is rejected.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWInvalidLinksTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 5);
+  SetInputParam("links", (int) 1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Check that a saved model gives the same results.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWModelReuseTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 300);
+  arma::mat query = arma::randu<arma::mat>(5, 40);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 5);
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors =
+      std::move(IO::GetParam<arma::Mat<size_t>>("neighbors"));
+  arma::mat distances = std::move(IO::GetParam<arma::mat>("distances"));
+  HNSWSearch<>* outputModel =
+      std::move(IO::GetParam<HNSWSearch<>*>("output_model"));
+
+  // Reset passed parameters.
+  IO::GetSingleton().Parameters()["reference"].wasPassed = false;
+  IO::GetSingleton().Parameters()["query"].wasPassed = false;
+
+  SetInputParam("input_model", outputModel);
+  SetInputParam("query", query);
+
+  mlpackMain();
+
+  CheckMatrices(neighbors, IO::GetParam<arma::Mat<size_t>>("neighbors"));
+  CheckMatrices(distances, IO::GetParam<arma::mat>("distances"));
+}
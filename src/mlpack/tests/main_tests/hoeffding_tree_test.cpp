@@ -659,6 +659,45 @@ BOOST_AUTO_TEST_CASE(HoeffdingBinarySplittingStrategyTest)
       (IO::GetParam<HoeffdingTreeModel*>("output_model"))->NumNodes()-1, 2);
 }
 
+/**
+ * Ensure that the root node has 2 children when splitting strategy is
+ * quantile.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingQuantileSplittingStrategyTest)
+{
+  arma::mat inputData;
+  DatasetInfo info;
+  if (!data::Load("vc2.csv", inputData, info))
+    BOOST_FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData, info))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  // Input training data.
+  SetInputParam("training", std::make_tuple(info, inputData));
+  SetInputParam("labels", std::move(labels));
+
+  // Input test data.
+  SetInputParam("test", std::make_tuple(info, testData));
+
+  SetInputParam("numeric_split_strategy", (string) "quantile");
+  SetInputParam("sketch_size", 50);
+  SetInputParam("max_samples", 50);
+
+  SetInputParam("confidence", 0.25);
+
+  mlpackMain();
+
+  // Check that number of children is 2.
+  BOOST_REQUIRE_EQUAL(
+      (IO::GetParam<HoeffdingTreeModel*>("output_model"))->NumNodes()-1, 2);
+}
+
 /**
  * Ensure that the number of children varies with varying 'bins' in domingos.
  */
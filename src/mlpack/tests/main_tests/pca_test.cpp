@@ -61,6 +61,24 @@ BOOST_AUTO_TEST_CASE(PCADimensionTest)
   BOOST_REQUIRE_EQUAL(IO::GetParam<arma::mat>("output").n_cols, 5);
 }
 
+/**
+ * Make sure that the covariance decomposition method reduces the dimensionality
+ * too.
+ */
+BOOST_AUTO_TEST_CASE(PCACovarianceDimensionTest)
+{
+  arma::mat x = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("new_dimensionality", (int) 3);
+  SetInputParam("decomposition_method", std::string("covariance"));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(IO::GetParam<arma::mat>("output").n_rows, 3);
+  BOOST_REQUIRE_EQUAL(IO::GetParam<arma::mat>("output").n_cols, 100);
+}
+
 /**
  * Ensure that if we retain all variance, we get back a matrix with the same
  * dimensionality.
@@ -175,3 +175,42 @@ TEST_CASE_METHOD(
   REQUIRE(dataset.n_rows == output.n_rows);
   CheckMatrices(output, dataset);
 }
+
+/**
+ * Test that the encoded matrix can be saved as a sparse matrix.
+ */
+TEST_CASE_METHOD(
+    PreprocessOneHotEncodingTestFixture, "SparseOutputFileTest",
+    "[PreprocessOneHotEncodingMainTest][BindingTests]")
+{
+  arma::mat dataset;
+  dataset = "1 1 -1 -1 -1 -1 1 1;"
+            "-1 1 -1 -1 -1 -1 1 -1;"
+            "1 1 -1 -1 -1 -1 1 1;"
+            "-1 1 -1 -1 -1 -1 1 -1;"
+            "1 1 -1 -1 -1 -1 1 1;";
+
+  arma::mat matrix;
+  matrix = "1 1 -1 -1 -1 -1 1 1;"
+           "1 0 1 1 1 1 0 1;"
+           "0 1 0 0 0 0 1 0;"
+           "1 1 -1 -1 -1 -1 1 1;"
+           "1 0 1 1 1 1 0 1;"
+           "0 1 0 0 0 0 1 0;"
+           "1 1 -1 -1 -1 -1 1 1;";
+
+  SetInputParam("input", dataset);
+  SetInputParam<vector<int>>("dimensions", {1, 3});
+  SetInputParam<string>("sparse_output_file", "one_hot_sparse.txt");
+  mlpackMain();
+
+  arma::sp_mat output;
+  REQUIRE(data::Load("one_hot_sparse.txt", output) == true);
+  remove("one_hot_sparse.txt");
+
+  // The last row and column are nonzero, so the sizes are kept by the
+  // coordinate list format.
+  REQUIRE(matrix.n_cols == output.n_cols);
+  REQUIRE(matrix.n_rows == output.n_rows);
+  CheckMatrices(arma::mat(output), matrix);
+}
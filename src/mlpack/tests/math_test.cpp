@@ -12,6 +12,7 @@
 #include <mlpack/core/math/clamp.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
+#include <mlpack/core/math/streaming_statistics.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -832,6 +833,53 @@ BOOST_AUTO_TEST_CASE(InplaceShuffleTest)
     BOOST_REQUIRE_EQUAL(counts[i], 1);
 }
 
+/**
+ * Make sure PermuteColumns() reorders the columns in place like cols() does,
+ * and rejects orderings that are not permutations.
+ */
+BOOST_AUTO_TEST_CASE(PermuteColumnsTest)
+{
+  arma::mat data(4, 100, arma::fill::randu);
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0, 99,
+      100));
+
+  arma::mat permuted(data);
+  PermuteColumns(permuted, ordering);
+  CheckMatrices(permuted, data.cols(ordering));
+
+  arma::uvec invalid(ordering);
+  invalid[3] = invalid[4];
+  BOOST_REQUIRE_THROW(PermuteColumns(permuted, invalid),
+      std::invalid_argument);
+  // The matrix is left as it was.
+  CheckMatrices(permuted, data.cols(ordering));
+
+  BOOST_REQUIRE_THROW(PermuteColumns(permuted, arma::uvec("0 1 2")),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure GatherColumns() gives the same result as cols(), also when the
+ * output is the input.
+ */
+BOOST_AUTO_TEST_CASE(GatherColumnsTest)
+{
+  arma::mat data(5, 1000, arma::fill::randu);
+  const arma::uvec indices = arma::randi<arma::uvec>(300,
+      arma::distr_param(0, 999));
+
+  arma::mat gathered;
+  GatherColumns(data, indices, gathered);
+  CheckMatrices(gathered, data.cols(indices));
+
+  arma::mat inPlace(data);
+  GatherColumns(inPlace, indices, inPlace);
+  CheckMatrices(inPlace, data.cols(indices));
+
+  BOOST_REQUIRE_THROW(GatherColumns(data, arma::uvec("1000"), gathered),
+      std::invalid_argument);
+}
+
 /**
  * Make sure shuffling sparse data works when the input and output matrices are
  * the same.
@@ -1009,4 +1057,99 @@ BOOST_AUTO_TEST_CASE(InplaceSparseShuffleWeightsTest)
   }
 }
 
+/**
+ * Make sure that QuantileSketch is exact for few values, and close for many.
+ */
+BOOST_AUTO_TEST_CASE(QuantileSketchTest)
+{
+  arma::vec values = arma::randn<arma::vec>(101);
+  QuantileSketch exact(128);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    exact.Insert(values[i]);
+  BOOST_REQUIRE_EQUAL(exact.Count(), 101);
+  BOOST_REQUIRE_CLOSE(exact.Median(), arma::median(values), 1e-10);
+  BOOST_REQUIRE_EQUAL(exact.Quantile(0.0), arma::min(values));
+  BOOST_REQUIRE_EQUAL(exact.Quantile(1.0), arma::max(values));
+
+  // Sketch two halves of many values separately, and merge them.
+  values = arma::randu<arma::vec>(100000);
+  QuantileSketch first(256), second(256);
+  for (size_t i = 0; i < 50000; ++i)
+    first.Insert(values[i]);
+  for (size_t i = 50000; i < values.n_elem; ++i)
+    second.Insert(values[i]);
+  first.Merge(second);
+  BOOST_REQUIRE_EQUAL(first.Count(), 100000);
+  BOOST_REQUIRE_LT(first.Size(), 5000);
+
+  // The values are uniform, so the rank of a value is close to the value.
+  const arma::vec sorted = arma::sort(values);
+  for (const double q : { 0.1, 0.5, 0.9 })
+  {
+    const double quantile = first.Quantile(q);
+    const double rank = (double) (std::lower_bound(sorted.begin(),
+        sorted.end(), quantile) - sorted.begin()) / sorted.n_elem;
+    BOOST_REQUIRE_SMALL(rank - q, 0.02);
+  }
+
+  BOOST_REQUIRE_THROW(QuantileSketch(1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(QuantileSketch().Median(), std::invalid_argument);
+  BOOST_REQUIRE_THROW(first.Merge(QuantileSketch(128)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that StreamingStatistics gives the same moments as a direct
+ * computation, whether the points are given at once or in chunks.
+ */
+BOOST_AUTO_TEST_CASE(StreamingStatisticsTest)
+{
+  // Use more points than one block, and an offset that would hurt a naive
+  // sum of powers.
+  arma::mat data = arma::randu<arma::mat>(3, 2 * StreamingStatistics::BlockSize
+      + 1000);
+  data.row(1) = arma::square(data.row(1));
+  data.row(2) += 1e6;
+
+  StreamingStatistics stats(3, 4096), chunks(3, 4096), merged(3, 4096);
+  stats.Update(data);
+  for (size_t i = 0; i < data.n_cols; i += 10000)
+    chunks.Update(data.cols(i, std::min(i + 9999, (size_t) data.n_cols - 1)));
+  StreamingStatistics other(3, 4096);
+  merged.Update(data.cols(0, 99));
+  other.Update(data.cols(100, data.n_cols - 1));
+  merged.Merge(other);
+
+  BOOST_REQUIRE_THROW(stats.Update(arma::mat(2, 10)), std::invalid_argument);
+
+  for (const StreamingStatistics* s : { &stats, &chunks, &merged })
+  {
+    BOOST_REQUIRE_EQUAL(s->Count(), data.n_cols);
+    for (size_t d = 0; d < 3; ++d)
+    {
+      const arma::rowvec row = data.row(d);
+      const double mean = arma::mean(row);
+      const arma::rowvec deviations = row - mean;
+      const double m2 = arma::accu(arma::pow(deviations, 2));
+      const double m3 = arma::accu(arma::pow(deviations, 3));
+      const double m4 = arma::accu(arma::pow(deviations, 4));
+      const double n = row.n_elem;
+
+      BOOST_REQUIRE_CLOSE(s->Mean(d), mean, 1e-8);
+      BOOST_REQUIRE_EQUAL(s->Min(d), arma::min(row));
+      BOOST_REQUIRE_EQUAL(s->Max(d), arma::max(row));
+      BOOST_REQUIRE_CLOSE(s->Variance(d), arma::var(row), 1e-6);
+      BOOST_REQUIRE_CLOSE(s->Variance(d, true), arma::var(row, 1), 1e-6);
+      BOOST_REQUIRE_CLOSE(s->Skewness(d, true) + 10.0,
+          m3 / (n * std::pow(m2 / n, 1.5)) + 10.0, 1e-5);
+      BOOST_REQUIRE_CLOSE(s->Kurtosis(d, true), n * m4 / (m2 * m2) - 3,
+          1e-5);
+
+      // The medians are approximate.
+      BOOST_REQUIRE_SMALL(s->Median(d) - arma::median(row),
+          0.02 * (arma::max(row) - arma::min(row)));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
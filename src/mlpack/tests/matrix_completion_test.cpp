@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/matrix_completion/matrix_completion.hpp>
+#include <mlpack/methods/matrix_completion/als_completion.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -64,4 +65,47 @@ BOOST_AUTO_TEST_CASE(UniformMatrixCompletionSDP)
   }
 }
 
+/**
+ * Make sure that ALSCompletion recovers a random low rank matrix from a random
+ * half of its entries.
+ */
+BOOST_AUTO_TEST_CASE(LowRankMatrixCompletionALS)
+{
+  const size_t m = 60, n = 80, r = 3;
+  const arma::mat Xorig = arma::randu<arma::mat>(m, r) *
+      arma::randu<arma::mat>(r, n);
+
+  // Take about half of the entries.
+  const arma::uvec known = arma::find(arma::randu<arma::mat>(m, n) < 0.5);
+  arma::umat indices(2, known.n_elem);
+  arma::vec values(known.n_elem);
+  for (size_t i = 0; i < known.n_elem; ++i)
+  {
+    indices(0, i) = known[i] % m;
+    indices(1, i) = known[i] / m;
+    values(i) = Xorig(indices(0, i), indices(1, i));
+  }
+
+  arma::mat recovered;
+  ALSCompletion mc(m, n, indices, values, r, 1e-10, 1000, 1e-10);
+  mc.Recover(recovered);
+
+  BOOST_REQUIRE_EQUAL(recovered.n_rows, m);
+  BOOST_REQUIRE_EQUAL(recovered.n_cols, n);
+  BOOST_REQUIRE_SMALL(mc.RMSE(), 1e-3);
+
+  const double err =
+    arma::norm(Xorig - recovered, "fro") /
+    arma::norm(Xorig, "fro");
+  BOOST_REQUIRE_SMALL(err, 1e-2);
+
+  // The factors give the same matrix.
+  arma::mat w, h;
+  mc.Recover(w, h);
+  BOOST_REQUIRE_EQUAL(w.n_cols, r);
+  BOOST_REQUIRE_EQUAL(h.n_rows, r);
+  BOOST_REQUIRE_SMALL(arma::norm(Xorig - w * h, "fro") /
+      arma::norm(Xorig, "fro"), 1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
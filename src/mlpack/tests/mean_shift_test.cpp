@@ -165,4 +165,57 @@ BOOST_AUTO_TEST_CASE(GaussianClustering)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Make sure that many well-separated clusters are all found, so that each
+ * converged centroid is compared against the centroids in neighboring bins
+ * only.
+ */
+BOOST_AUTO_TEST_CASE(ManyClustersTest)
+{
+  // A 5x5 grid of small clusters.
+  arma::mat dataset(2, 25 * 100);
+  arma::mat means(2, 25);
+  for (size_t c = 0; c < 25; ++c)
+  {
+    means(0, c) = 10.0 * (c % 5);
+    means(1, c) = 10.0 * (c / 5);
+    for (size_t i = 0; i < 100; ++i)
+      dataset.col(100 * c + i) = means.col(c) + 0.1 * arma::randn<arma::vec>(2);
+  }
+
+  MeanShift<> meanShift(1.0);
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster(dataset, assignments, centroids);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 25);
+
+  // Each centroid must be near a different mean, and each point must be
+  // assigned to the centroid of its cluster.
+  arma::Col<size_t> clusterOfMean(25);
+  clusterOfMean.fill(25);
+  for (size_t i = 0; i < 25; ++i)
+  {
+    size_t closest = 0;
+    double closestDistance = DBL_MAX;
+    for (size_t c = 0; c < 25; ++c)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          centroids.col(i), means.col(c));
+      if (distance < closestDistance)
+      {
+        closest = c;
+        closestDistance = distance;
+      }
+    }
+
+    BOOST_REQUIRE_LT(closestDistance, 0.5);
+    BOOST_REQUIRE_EQUAL(clusterOfMean[closest], 25);
+    clusterOfMean[closest] = i;
+  }
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], clusterOfMean[i / 100]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -14,6 +14,7 @@
 #include <mlpack/core/metrics/iou_metric.hpp>
 #include <mlpack/core/metrics/non_maximal_supression.hpp>
 #include <mlpack/core/metrics/bleu.hpp>
+#include <mlpack/core/metrics/squared_distance_block.hpp>
 #include "test_tools.hpp"
 
 using namespace std;
@@ -21,6 +22,90 @@ using namespace mlpack::metric;
 
 BOOST_AUTO_TEST_SUITE(MetricTest);
 
+/**
+ * Make sure that SquaredDistanceBlock() computes every squared distance within
+ * the returned error bound, even for points far from the origin.
+ */
+BOOST_AUTO_TEST_CASE(SquaredDistanceBlockTest)
+{
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::mat a = arma::randu<arma::mat>(10, 30);
+    arma::mat b = arma::randu<arma::mat>(10, 20);
+    if (trial == 1)
+    {
+      a += 1e4;
+      b += 1e4;
+    }
+    // Make one pair identical.
+    a.col(3) = b.col(7);
+
+    arma::mat distances;
+    const double error = SquaredDistanceBlock(a, b, distances);
+
+    BOOST_REQUIRE_EQUAL(distances.n_rows, 30);
+    BOOST_REQUIRE_EQUAL(distances.n_cols, 20);
+    BOOST_REQUIRE_GE(error, 0.0);
+    BOOST_REQUIRE_LT(error, 1e-6);
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      for (size_t j = 0; j < b.n_cols; ++j)
+      {
+        const double exact = SquaredEuclideanDistance::Evaluate(a.col(i),
+            b.col(j));
+        BOOST_REQUIRE_LE(std::abs(distances(i, j) - exact), error);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that SquaredDistanceBlock() computes the squared distances between
+ * the columns of sparse matrices within the returned error bound, and that
+ * GatherColumns() takes the right columns of a sparse matrix.
+ */
+BOOST_AUTO_TEST_CASE(SparseSquaredDistanceBlockTest)
+{
+  arma::sp_mat data;
+  data.sprandu(100, 60, 0.1);
+  // Make one point empty.
+  data.col(5).zeros();
+
+  std::vector<size_t> aIndices, bIndices;
+  for (size_t i = 0; i < 60; i += 2)
+    aIndices.push_back(i);
+  for (size_t i = 59; i > 20; i -= 3)
+    bIndices.push_back(i);
+  // Make one pair identical.
+  bIndices.push_back(4);
+
+  const arma::sp_mat a = GatherColumns(data, aIndices);
+  const arma::sp_mat b = GatherColumns(data, bIndices);
+  BOOST_REQUIRE_EQUAL(a.n_cols, aIndices.size());
+  BOOST_REQUIRE_EQUAL(b.n_cols, bIndices.size());
+  for (size_t i = 0; i < aIndices.size(); ++i)
+    BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(a.col(i) -
+        data.col(aIndices[i]))), 0.0);
+
+  arma::mat distances;
+  const double error = SquaredDistanceBlock(a, b, distances);
+
+  BOOST_REQUIRE_EQUAL(distances.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, b.n_cols);
+  BOOST_REQUIRE_GE(error, 0.0);
+  BOOST_REQUIRE_LT(error, 1e-6);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      const double exact = SquaredEuclideanDistance::Evaluate(
+          arma::vec(arma::mat(data.col(aIndices[i]))),
+          arma::vec(arma::mat(data.col(bIndices[j]))));
+      BOOST_REQUIRE_LE(std::abs(distances(i, j) - exact), error);
+    }
+  }
+}
+
 /**
  * Simple test for L-1 metric.
  */
@@ -99,6 +184,42 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+/**
+ * Make sure that the generic L-p metric (here, p = 3 and p = 4) gives the
+ * right distances, with and without the root.
+ */
+BOOST_AUTO_TEST_CASE(LPMetricTest)
+{
+  arma::vec a1(5);
+  a1.randn();
+
+  arma::vec b1(5);
+  b1.randn();
+
+  arma::Col<size_t> a2(5);
+  a2 << 1 << 2 << 1 << 0 << 5;
+
+  arma::Col<size_t> b2(5);
+  b2 << 2 << 5 << 2 << 0 << 1;
+
+  const double l3 = arma::accu(arma::pow(arma::abs(a1 - b1), 3.0));
+  const double l4 = arma::accu(arma::pow(a1 - b1, 4.0));
+
+  BOOST_REQUIRE_CLOSE(l3, (LMetric<3, false>::Evaluate(a1, b1)), 1e-5);
+  BOOST_REQUIRE_CLOSE(std::pow(l3, 1.0 / 3.0),
+      (LMetric<3, true>::Evaluate(a1, b1)), 1e-5);
+  BOOST_REQUIRE_CLOSE(l4, (LMetric<4, false>::Evaluate(a1, b1)), 1e-5);
+  BOOST_REQUIRE_CLOSE(std::pow(l4, 0.25),
+      (LMetric<4, true>::Evaluate(a1, b1)), 1e-5);
+
+  // |1 - 2|^3 + |2 - 5|^3 + |1 - 2|^3 + |5 - 1|^3 = 93.
+  BOOST_REQUIRE_EQUAL((LMetric<3, false>::Evaluate(a2, b2)), 93);
+
+  // The root doesn't matter for the L-infinity metric.
+  BOOST_REQUIRE_CLOSE((LMetric<INT_MAX, true>::Evaluate(a1, b1)),
+      (LMetric<INT_MAX, false>::Evaluate(a1, b1)), 1e-5);
+}
+
 /**
  * Simple test for IoU metric.
  */
@@ -302,6 +423,110 @@ BOOST_AUTO_TEST_CASE(NMSMetricTest)
   CheckMatrices(desiredBoundingBox, selectedBoundingBox);
 }
 
+/**
+ * Make sure that the IoU matrix of two sets of bounding boxes holds the IoU of
+ * each pair.
+ */
+BOOST_AUTO_TEST_CASE(IoUMatrixTest)
+{
+  arma::mat a(4, 30), b(4, 20);
+  a.rows(0, 1) = 100 * arma::randu<arma::mat>(2, 30);
+  a.rows(2, 3) = 1 + 50 * arma::randu<arma::mat>(2, 30);
+  b.rows(0, 1) = 100 * arma::randu<arma::mat>(2, 20);
+  b.rows(2, 3) = 1 + 50 * arma::randu<arma::mat>(2, 20);
+
+  arma::mat ious;
+  IoU<>::Evaluate(a, b, ious);
+  BOOST_REQUIRE_EQUAL(ious.n_rows, 30);
+  BOOST_REQUIRE_EQUAL(ious.n_cols, 20);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      const double iou = IoU<>::Evaluate(arma::vec(a.col(i)),
+          arma::vec(b.col(j)));
+      if (iou < 1e-10)
+        BOOST_REQUIRE_SMALL(ious(i, j), 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(ious(i, j), iou, 1e-8);
+    }
+  }
+
+  // The same boxes in the coordinate representation give the same IoUs.
+  a.rows(2, 3) += a.rows(0, 1);
+  b.rows(2, 3) += b.rows(0, 1);
+  arma::mat coordinateIous;
+  IoU<true>::Evaluate(a, b, coordinateIous);
+  CheckMatrices(ious, coordinateIous, 1e-8);
+}
+
+/**
+ * Compare NMS on many random bounding boxes (more than one word of the
+ * suppression masks) with a simple greedy implementation, and make sure that
+ * the batched version gives the same results for each image.
+ */
+BOOST_AUTO_TEST_CASE(NMSManyBoxesTest)
+{
+  const size_t images = 4;
+  std::vector<arma::mat> boxes(images);
+  std::vector<arma::vec> scores(images);
+  std::vector<arma::uvec> batchSelected;
+  for (size_t image = 0; image < images; ++image)
+  {
+    boxes[image].set_size(4, 150 + 10 * image);
+    boxes[image].rows(0, 1) = 200 * arma::randu<arma::mat>(2,
+        boxes[image].n_cols);
+    boxes[image].rows(2, 3) = 10 + 40 * arma::randu<arma::mat>(2,
+        boxes[image].n_cols);
+    scores[image] = arma::randu<arma::vec>(boxes[image].n_cols);
+  }
+
+  NMS<>::Evaluate(boxes, scores, batchSelected, 0.3);
+  BOOST_REQUIRE_EQUAL(batchSelected.size(), images);
+
+  for (size_t image = 0; image < images; ++image)
+  {
+    const arma::mat& bbox = boxes[image];
+
+    // Greedy reference: go through the boxes by decreasing score, and keep a
+    // box if it does not overlap a kept box too much.
+    const arma::uvec order = arma::sort_index(scores[image], "descend");
+    std::vector<size_t> expected;
+    for (size_t k = 0; k < order.n_elem; ++k)
+    {
+      const size_t i = order[k];
+      bool keep = true;
+      for (size_t j : expected)
+      {
+        const double w = std::min(bbox(0, i) + bbox(2, i), bbox(0, j) +
+            bbox(2, j)) - std::max(bbox(0, i), bbox(0, j));
+        const double h = std::min(bbox(1, i) + bbox(3, i), bbox(1, j) +
+            bbox(3, j)) - std::max(bbox(1, i), bbox(1, j));
+        const double intersection = std::max(0.0, w) * std::max(0.0, h);
+        const double iou = intersection / (bbox(2, i) * bbox(3, i) +
+            bbox(2, j) * bbox(3, j) - intersection);
+        if (iou > 0.3)
+        {
+          keep = false;
+          break;
+        }
+      }
+      if (keep)
+        expected.push_back(i);
+    }
+
+    arma::uvec selected;
+    NMS<>::Evaluate(bbox, scores[image], selected, 0.3);
+    BOOST_REQUIRE_EQUAL(selected.n_elem, expected.size());
+    BOOST_REQUIRE_EQUAL(batchSelected[image].n_elem, expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(selected[i], expected[i]);
+      BOOST_REQUIRE_EQUAL(batchSelected[image][i], expected[i]);
+    }
+  }
+}
+
 /**
  *
  */
@@ -360,4 +585,63 @@ BOOST_AUTO_TEST_CASE(BLEUScoreTest)
   }
 }
 
+/**
+ * Make sure that the BLEU score of a large corpus, whose paragraphs are split
+ * across threads, is the same as the score of the corpus it repeats.
+ */
+BOOST_AUTO_TEST_CASE(BLEUScoreLargeCorpusTest)
+{
+  typedef typename std::vector<std::string> WordVector;
+  std::vector<std::vector<WordVector>> referenceCorpus
+      = {{{"the", "cat", "is", "on", "the", "mat"},
+          {"there", "is", "a", "cat", "on", "the", "mat"}},
+
+         {{"he", "read", "the", "book", "because", "he", "was", "interested"},
+          {"he", "was", "interested", "so", "he", "read", "the", "book"}},
+
+         {{"this", "is", "my", "table"}},
+         {}};
+
+  std::vector<WordVector> translationCorpus
+      = {{"the", "the", "the", "cat", "on", "the", "mat"},
+         {"he", "read", "the", "book", "because", "he", "was", "interested"},
+         {"this", "is", "your", "table", "and", "chair"},
+         {"nothing", "to", "compare"}};
+
+  std::vector<std::vector<WordVector>> largeReferenceCorpus;
+  std::vector<WordVector> largeTranslationCorpus;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    largeReferenceCorpus.insert(largeReferenceCorpus.end(),
+        referenceCorpus.begin(), referenceCorpus.end());
+    largeTranslationCorpus.insert(largeTranslationCorpus.end(),
+        translationCorpus.begin(), translationCorpus.end());
+  }
+
+  for (const bool smooth : { false, true })
+  {
+    BLEU<double> bleu(4), largeBLEU(4);
+    bleu.Evaluate(referenceCorpus, translationCorpus, smooth);
+    largeBLEU.Evaluate(largeReferenceCorpus, largeTranslationCorpus, smooth);
+
+    BOOST_REQUIRE_EQUAL(largeBLEU.TranslationLength(),
+        1000 * bleu.TranslationLength());
+    BOOST_REQUIRE_EQUAL(largeBLEU.ReferenceLength(),
+        1000 * bleu.ReferenceLength());
+    BOOST_REQUIRE_GT(bleu.BLEUScore(), 0.0);
+
+    // Without smoothing, the precisions are ratios of counts that all scale
+    // by 1000, so the score does not change.
+    if (!smooth)
+    {
+      BOOST_REQUIRE_CLOSE(largeBLEU.BLEUScore(), bleu.BLEUScore(), 1e-5);
+      for (size_t i = 0; i < bleu.Precisions().size(); ++i)
+      {
+        BOOST_REQUIRE_CLOSE(largeBLEU.Precisions()[i], bleu.Precisions()[i],
+            1e-5);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -355,4 +355,74 @@ BOOST_AUTO_TEST_CASE(NaiveBayesClassifierHighDimensionsTest)
     BOOST_REQUIRE_EQUAL(calcVec(i), testLabels(i));
 }
 
+/**
+ * Ensure that training incrementally on chunks of the dataset gives the same
+ * model as training on the whole dataset at once.
+ */
+BOOST_AUTO_TEST_CASE(ChunkedIncrementalTrainTest)
+{
+  const char* trainFilename = "trainSet.csv";
+  size_t classes = 2;
+
+  arma::mat trainData;
+  data::Load(trainFilename, trainData, true);
+
+  // Get the labels out.
+  arma::Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  NaiveBayesClassifier<> nbc(trainData, labels, classes, false);
+
+  // Train on three chunks of different sizes.
+  const size_t first = trainData.n_cols / 5;
+  const size_t second = 3 * trainData.n_cols / 4;
+  NaiveBayesClassifier<> nbcTrain(trainData.n_rows, classes);
+  nbcTrain.Train(trainData.cols(0, first - 1), labels.subvec(0, first - 1),
+      classes, true);
+  nbcTrain.Train(trainData.cols(first, second - 1),
+      labels.subvec(first, second - 1), classes, true);
+  nbcTrain.Train(trainData.cols(second, trainData.n_cols - 1),
+      labels.subvec(second, trainData.n_cols - 1), classes, true);
+
+  CheckMatrices(nbc.Means(), nbcTrain.Means(), 1e-5);
+  CheckMatrices(nbc.Variances(), nbcTrain.Variances(), 1e-5);
+  CheckMatrices(nbc.Probabilities(), nbcTrain.Probabilities(), 1e-5);
+}
+
+/**
+ * Ensure that training on a sparse dataset gives the same model as training on
+ * the same dataset as a dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(SparseTrainTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(50, 1000, 0.1);
+  arma::mat denseData(sparseData);
+
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (denseData(0, i) > 0.0) ? 1 : (i % 3 == 0 ? 2 : 0);
+
+  NaiveBayesClassifier<> nbcDense(denseData, labels, 3, false);
+  NaiveBayesClassifier<> nbcSparse(sparseData, labels, 3, false);
+
+  CheckMatrices(nbcDense.Means(), nbcSparse.Means(), 1e-5);
+  CheckMatrices(nbcDense.Variances(), nbcSparse.Variances(), 1e-5);
+  CheckMatrices(nbcDense.Probabilities(), nbcSparse.Probabilities(), 1e-5);
+
+  // Now train incrementally on each half of the sparse dataset.
+  arma::sp_mat firstHalf = sparseData.cols(0, 499);
+  arma::sp_mat secondHalf = sparseData.cols(500, 999);
+  NaiveBayesClassifier<> nbcIncremental(firstHalf, labels.subvec(0, 499), 3,
+      true);
+  nbcIncremental.Train(secondHalf, labels.subvec(500, 999), 3, true);
+
+  CheckMatrices(nbcDense.Means(), nbcIncremental.Means(), 1e-5);
+  CheckMatrices(nbcDense.Variances(), nbcIncremental.Variances(), 1e-5);
+  CheckMatrices(nbcDense.Probabilities(), nbcIncremental.Probabilities(),
+      1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -246,6 +246,80 @@ TEST_CASE("SoftmaxSeparableGradient", "[NCATesT]")
   REQUIRE(gradient(1, 1) == Approx(-2.0 * -0.1435886).epsilon(0.0001));
 }
 
+/**
+ * The separable gradient over all the points, computed in several batches,
+ * should be the same as the non-separable gradient.
+ */
+TEST_CASE("SoftmaxBatchGradientMatchesFullGradient", "[NCATesT]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 200);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(200, arma::distr_param(0, 2));
+  const arma::mat coordinates = arma::randu<arma::mat>(3, 3) + 0.5 *
+      arma::eye<arma::mat>(3, 3);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  arma::mat fullGradient, batchGradient, gradient;
+  sef.Gradient(coordinates, fullGradient);
+
+  double objective = 0.0;
+  batchGradient.zeros(3, 3);
+  for (size_t begin = 0; begin < 200; begin += 30)
+  {
+    const size_t batchSize = std::min((size_t) 30, 200 - begin);
+    objective += sef.Evaluate(coordinates, begin, batchSize);
+    sef.Gradient(coordinates, begin, gradient, batchSize);
+    batchGradient += gradient;
+  }
+
+  REQUIRE(objective == Approx(sef.Evaluate(coordinates)).epsilon(1e-7));
+  for (size_t i = 0; i < fullGradient.n_elem; ++i)
+  {
+    REQUIRE(batchGradient[i] ==
+        Approx(fullGradient[i]).epsilon(1e-7).margin(1e-10));
+  }
+}
+
+/**
+ * Truncating the softmax sums to the n - 1 nearest neighbors of each point
+ * uses all the points, so the results should be the same as the exact ones;
+ * with few neighbors, the results should still be close when the classes are
+ * well separated.
+ */
+TEST_CASE("SoftmaxTruncatedNeighborsTest", "[NCATesT]")
+{
+  arma::mat data = arma::randu<arma::mat>(2, 100);
+  data.cols(50, 99) += 10.0;
+  arma::Row<size_t> labels(100);
+  labels.subvec(0, 49).zeros();
+  labels.subvec(50, 99).ones();
+  const arma::mat coordinates = 3.0 * arma::eye<arma::mat>(2, 2);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> allSef(data, labels,
+      SquaredEuclideanDistance(), 99);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> fewSef(data, labels,
+      SquaredEuclideanDistance(), 10);
+  REQUIRE(fewSef.NumNeighbors() == 10);
+
+  const double objective = sef.Evaluate(coordinates);
+  arma::mat gradient, allGradient, fewGradient;
+  sef.Gradient(coordinates, gradient);
+  allSef.Gradient(coordinates, allGradient);
+  fewSef.Gradient(coordinates, fewGradient);
+
+  REQUIRE(allSef.Evaluate(coordinates) == Approx(objective).epsilon(1e-7));
+  REQUIRE(allSef.Evaluate(coordinates, 0, 100) ==
+      Approx(objective).epsilon(1e-7));
+  REQUIRE(fewSef.Evaluate(coordinates) == Approx(objective).epsilon(1e-3));
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    REQUIRE(allGradient[i] == Approx(gradient[i]).epsilon(1e-7).margin(1e-10));
+    REQUIRE(fewGradient[i] == Approx(gradient[i]).epsilon(0.1).margin(1e-3));
+  }
+}
+
 //
 // Tests for the NCA algorithm.
 //
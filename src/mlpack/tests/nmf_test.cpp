@@ -16,6 +16,7 @@
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -131,6 +132,83 @@ BOOST_AUTO_TEST_CASE(NMFALSTest)
       0.09);
 }
 
+/**
+ * Check that the weighted alternating least squares update rule fits the
+ * observed ratings of a sparse low-rank matrix, and that it recovers the
+ * ratings that were not observed.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSTest)
+{
+  // Alternating least squares sometimes stalls from a bad initialization, so
+  // allow a few trials.
+  bool success = false;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    mat w = randu<mat>(50, 3);
+    mat h = randu<mat>(3, 40);
+    const mat v = w * h;
+
+    // Observe about half of the ratings.
+    const mat mask = conv_to<mat>::from(randu<mat>(50, 40) < 0.5);
+    const sp_mat observed(v % mask);
+
+    MaxIterationTermination mit(100);
+    AMF<MaxIterationTermination, RandomInitialization, WeightedALSUpdate> als(
+        mit, RandomInitialization(), WeightedALSUpdate(1e-6));
+    als.Apply(observed, 3, w, h);
+
+    const mat wh = w * h;
+    const double observedError = arma::norm((v - wh) % mask, "fro") /
+        arma::norm(v % mask, "fro");
+    const double missingError = arma::norm((v - wh) % (1 - mask), "fro") /
+        arma::norm(v % (1 - mask), "fro");
+    if (observedError < 0.01 && missingError < 0.05)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(success, true);
+}
+
+/**
+ * Check that the implicit feedback variant of the weighted alternating least
+ * squares update rule predicts higher preferences for the observed elements.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSImplicitTest)
+{
+  // Two groups of users, who each use one half of the items.
+  sp_mat v(40, 30);
+  for (size_t j = 0; j < v.n_cols; ++j)
+  {
+    const size_t begin = (j < 15) ? 0 : 20;
+    for (size_t i = begin; i < begin + 20; ++i)
+    {
+      if (randu() < 0.6)
+        v(i, j) = 1.0 + std::floor(5.0 * randu());
+    }
+  }
+
+  mat w, h;
+  MaxIterationTermination mit(20);
+  AMF<MaxIterationTermination, RandomInitialization, WeightedALSUpdate> als(
+      mit, RandomInitialization(), WeightedALSUpdate(0.1, true, 10.0));
+  als.Apply(v, 2, w, h);
+
+  // The preferences of each group must be higher on its own items.
+  const mat wh = w * h;
+  for (size_t j = 0; j < v.n_cols; ++j)
+  {
+    const double first = arma::mean(wh.submat(0, j, 19, j));
+    const double second = arma::mean(wh.submat(20, j, 39, j));
+    if (j < 15)
+      BOOST_REQUIRE_GT(first, second + 0.3);
+    else
+      BOOST_REQUIRE_GT(second, first + 0.3);
+  }
+}
+
 /**
  * Check the if the product of the calculated factorization is close to the
  * input matrix, with a sparse input matrix. Random Acol initialization,
@@ -243,6 +321,44 @@ BOOST_AUTO_TEST_CASE(SparseNMFALSTest)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Check that the sparse overloads of the multiplicative update rules, which
+ * only evaluate W * H at the nonzero elements of V, give the same updates as
+ * the dense update rules.
+ */
+BOOST_AUTO_TEST_CASE(SparseMultiplicativeUpdateTest)
+{
+  sp_mat v;
+  v.sprandu(40, 30, 0.2);
+  const mat denseV(v);
+
+  const mat w = randu<mat>(40, 5) + 0.1;
+  const mat h = randu<mat>(5, 30) + 0.1;
+
+  mat w1 = w, w2 = w, h1 = h, h2 = h;
+  NMFMultiplicativeDistanceUpdate::WUpdate(denseV, w1, h);
+  NMFMultiplicativeDistanceUpdate::WUpdate(v, w2, h);
+  NMFMultiplicativeDistanceUpdate::HUpdate(denseV, w, h1);
+  NMFMultiplicativeDistanceUpdate::HUpdate(v, w, h2);
+
+  for (size_t i = 0; i < w1.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(w1[i], w2[i], 1e-8);
+  for (size_t i = 0; i < h1.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(h1[i], h2[i], 1e-8);
+
+  w1 = w2 = w;
+  h1 = h2 = h;
+  NMFMultiplicativeDivergenceUpdate::WUpdate(denseV, w1, h);
+  NMFMultiplicativeDivergenceUpdate::WUpdate(v, w2, h);
+  NMFMultiplicativeDivergenceUpdate::HUpdate(denseV, w, h1);
+  NMFMultiplicativeDivergenceUpdate::HUpdate(v, w, h2);
+
+  for (size_t i = 0; i < w1.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(w1[i], w2[i], 1e-8);
+  for (size_t i = 0; i < h1.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(h1[i], h2[i], 1e-8);
+}
+
 /**
  * Check if all elements in W and H are non-negative.
  * Default Case.
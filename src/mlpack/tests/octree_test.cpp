@@ -167,6 +167,57 @@ void CheckOverlap(TreeType& node)
     CheckOverlap(node.Child(i));
 }
 
+/**
+ * Make sure that the children of each node hold its points, and that two trees
+ * have the same structure.
+ */
+template<typename TreeType>
+void CheckSameStructure(TreeType& node1, TreeType& node2)
+{
+  BOOST_REQUIRE_EQUAL(node1.NumChildren(), node2.NumChildren());
+  BOOST_REQUIRE_EQUAL(node1.NumDescendants(), node2.NumDescendants());
+
+  size_t childDescendants = 0;
+  for (size_t i = 0; i < node1.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(node1.Child(i).Parent(), &node1);
+    BOOST_REQUIRE_EQUAL(node1.Child(i).Descendant(0),
+        node1.Descendant(childDescendants));
+    childDescendants += node1.Child(i).NumDescendants();
+    CheckSameStructure(node1.Child(i), node2.Child(i));
+  }
+
+  if (node1.NumChildren() > 0)
+    BOOST_REQUIRE_EQUAL(childDescendants, node1.NumDescendants());
+}
+
+/**
+ * Build trees large enough for their nodes to be split and their children to
+ * be built in parallel, and make sure they are valid and the same with both
+ * constructors.
+ */
+BOOST_AUTO_TEST_CASE(LargeOctreeBuildTest)
+{
+  arma::mat dataset(3, 100000, arma::fill::randu);
+  arma::mat datacopy(dataset);
+  std::vector<size_t> oldFromNewCopy, oldFromNewMove;
+
+  Octree<> t1(dataset, oldFromNewCopy, 10);
+  Octree<> t2(std::move(dataset), oldFromNewMove, 10);
+
+  CheckOverlap(t1);
+  CheckSameStructure(t1, t2);
+
+  // The points are reordered the same way by both constructors.
+  BOOST_REQUIRE_EQUAL(arma::accu(t1.Dataset() != t2.Dataset()), 0);
+  for (size_t i = 0; i < oldFromNewCopy.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(oldFromNewCopy[i], oldFromNewMove[i]);
+    BOOST_REQUIRE_EQUAL(arma::accu(datacopy.col(oldFromNewCopy[i]) !=
+        t1.Dataset().col(i)), 0);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(OverlapTest)
 {
   // Test with both constructors.
@@ -229,3 +229,67 @@ TEST_CASE("OneHotEncodingDatasetinfoTest", "[OneHotEncodingTest]")
 
   remove("test.csv");
 }
+
+/**
+ * Make sure that a sparse matrix output holds the same encoding as a dense
+ * matrix output, including for zero values in the dimensions that are not
+ * encoded.
+ */
+TEST_CASE("OneHotEncodingSparseOutputTest", "[OneHotEncodingTest]")
+{
+  arma::mat input = arma::randi<arma::mat>(6, 500, arma::distr_param(-2, 2));
+  // Make the first dimension have many categories.
+  input.row(0) = arma::conv_to<arma::rowvec>::from(
+      arma::randi<arma::irowvec>(500, arma::distr_param(0, 200)));
+  arma::Col<size_t> indices("0 3 4");
+
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  data::OneHotEncoding(input, indices, output);
+  data::OneHotEncoding(input, indices, sparseOutput);
+
+  REQUIRE(sparseOutput.n_rows == output.n_rows);
+  REQUIRE(sparseOutput.n_cols == output.n_cols);
+  REQUIRE(sparseOutput.n_nonzero == (size_t) arma::accu(output != 0.0));
+  CheckMatrices(arma::mat(sparseOutput), output);
+
+  // With no dimensions to encode, the input is kept.
+  data::OneHotEncoding(input, arma::Col<size_t>(), sparseOutput);
+  CheckMatrices(arma::mat(sparseOutput), input);
+}
+
+/**
+ * Test sparse one hot encoding using DatasetInfo object.
+ */
+TEST_CASE("OneHotEncodingSparseDatasetinfoTest", "[OneHotEncodingTest]")
+{
+  arma::mat input("1 3 5 7;"
+                  "0 1 2 1;"
+                  "0 0 4 0");
+  DatasetInfo info(3);
+  info.Type(1) = Datatype::categorical;
+
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  data::OneHotEncoding(input, output, info);
+  data::OneHotEncoding(input, sparseOutput, info);
+
+  REQUIRE(sparseOutput.n_rows == 5);
+  REQUIRE(sparseOutput.n_cols == 4);
+  CheckMatrices(arma::mat(sparseOutput), output);
+}
+
+/**
+ * Make sure that an exception is thrown for a dimension that does not exist.
+ */
+TEST_CASE("OneHotEncodingInvalidDimensionTest", "[OneHotEncodingTest]")
+{
+  arma::mat input(3, 10, arma::fill::randu);
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+
+  REQUIRE_THROWS_AS(data::OneHotEncoding(input, arma::Col<size_t>("1 3"),
+      output), std::invalid_argument);
+  REQUIRE_THROWS_AS(data::OneHotEncoding(input, arma::Col<size_t>("3"),
+      sparseOutput), std::invalid_argument);
+}
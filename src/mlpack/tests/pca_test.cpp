@@ -12,7 +12,9 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
+#include <mlpack/methods/pca/decomposition_policies/covariance_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -207,6 +209,25 @@ BOOST_AUTO_TEST_CASE(ArmaComparisonRandomizedPCATest)
   ArmaComparisonPCA<RandomizedSVDPolicy>();
 }
 
+/**
+ * Compare the output of our covariance PCA implementation with Armadillo's.
+ */
+BOOST_AUTO_TEST_CASE(ArmaComparisonCovariancePCATest)
+{
+  // Use small blocks, so that the covariance is accumulated over many blocks.
+  CovariancePolicy decomposition(7);
+  ArmaComparisonPCA<CovariancePolicy>(false, decomposition);
+}
+
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's.
+ */
+BOOST_AUTO_TEST_CASE(ArmaComparisonIncrementalPCATest)
+{
+  IncrementalPCAPolicy decomposition(64);
+  ArmaComparisonPCA<IncrementalPCAPolicy>(false, decomposition);
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -236,6 +257,69 @@ BOOST_AUTO_TEST_CASE(RandomizedPCADimensionalityReductionTest)
   PCADimensionalityReduction<RandomizedSVDPolicy>();
 }
 
+/**
+ * Test that dimensionality reduction with covariance PCA works the same way
+ * MATLAB does (which should be correct!).
+ */
+BOOST_AUTO_TEST_CASE(CovariancePCADimensionalityReductionTest)
+{
+  CovariancePolicy decomposition(2);
+  PCADimensionalityReduction<CovariancePolicy>(false, decomposition);
+}
+
+/**
+ * Test that dimensionality reduction with incremental PCA works the same way
+ * MATLAB does (which should be correct!).
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCADimensionalityReductionTest)
+{
+  IncrementalPCAPolicy decomposition(2);
+  PCADimensionalityReduction<IncrementalPCAPolicy>(false, decomposition);
+}
+
+/**
+ * Make sure that the components and the mean found by giving the batches to
+ * IncrementalPCAPolicy::Update() one at a time match the exact PCA of all the
+ * points.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAUpdateTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 300);
+  data.row(1) *= 4.0;
+  data.row(3) += 2.0 * data.row(0);
+
+  IncrementalPCAPolicy ipca;
+  ipca.Reset(3);
+  for (size_t begin = 0; begin < data.n_cols; begin += 50)
+    ipca.Update(data.cols(begin, begin + 49));
+
+  BOOST_REQUIRE_EQUAL(ipca.NumPoints(), 300);
+  BOOST_REQUIRE_EQUAL(ipca.Components().n_cols, 3);
+
+  const arma::vec mean = arma::mean(data, 1);
+  for (size_t i = 0; i < mean.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(ipca.Mean()[i], mean[i], 1e-8);
+
+  arma::mat centeredData;
+  math::Center(data, centeredData);
+  arma::mat u, v;
+  arma::vec s;
+  arma::svd_econ(u, s, v, centeredData, 'l');
+
+  // The leading singular values are not exact, since the components that are
+  // dropped after each batch are lost, but they should be close.
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(ipca.SingularValues()[i], s[i], 2.0);
+    BOOST_REQUIRE_GT(std::abs(arma::dot(ipca.Components().col(i), u.col(i))),
+        0.95);
+  }
+
+  // Batches of a different dimensionality are rejected.
+  BOOST_REQUIRE_THROW(ipca.Update(arma::randu<arma::mat>(4, 10)),
+      std::invalid_argument);
+}
+
 /**
  * Test that dimensionality reduction with QUIC-SVD PCA works the same way
  * as the Exact-SVD PCA method.
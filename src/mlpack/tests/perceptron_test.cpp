@@ -255,4 +255,37 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Train the perceptron on blocks of points on well-separated Gaussians, and
+ * make sure the averaged weights classify nearly all the points correctly.
+ */
+BOOST_AUTO_TEST_CASE(BatchTraining)
+{
+  const mat centers("0 10 0;"
+                    "0 0 10;"
+                    "0 5 5");
+  mat trainData = randn<mat>(3, 3000);
+  Row<size_t> labels(3000);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+  {
+    labels[i] = i % 3;
+    trainData.col(i) += centers.col(i % 3);
+  }
+
+  Perceptron<> p(3, 3, 100);
+  p.BatchSize() = 64;
+  p.Train(trainData, labels, 3);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+  BOOST_REQUIRE_GE(accu(predictedLabels == labels), 2950);
+
+  // The block size is kept when a perceptron is built from another one, with
+  // instance weights (as in AdaBoost).
+  Perceptron<> q(p, trainData, labels, 3, ones<rowvec>(3000));
+  BOOST_REQUIRE_EQUAL(q.BatchSize(), 64);
+  q.Classify(trainData, predictedLabels);
+  BOOST_REQUIRE_GE(accu(predictedLabels == labels), 2950);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -239,4 +239,121 @@ BOOST_AUTO_TEST_CASE(TestArmaCustomPrecision)
       BASH_GREEN "[INFO ] " BASH_CLEAR "   4.0000   4.5000   5.0000\n");
 }
 
+/**
+ * A type that counts how many times it was printed.
+ */
+struct CountedOutput
+{
+  mutable size_t count = 0;
+};
+
+std::ostream& operator<<(std::ostream& stream, const CountedOutput& c)
+{
+  ++c.count;
+  return stream << "counted";
+}
+
+/**
+ * Make sure that a stream that ignores its input does not format it.
+ */
+BOOST_AUTO_TEST_CASE(TestIgnoredPrefixedOutStreamDoesNotFormat)
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, BASH_GREEN "[INFO ] " BASH_CLEAR, true);
+
+  CountedOutput c;
+  arma::mat m(10, 10, arma::fill::randu);
+  pss << c << " and " << m << std::endl;
+  BOOST_REQUIRE_EQUAL(c.count, 0);
+  BOOST_REQUIRE_EQUAL(ss.str(), "");
+
+  pss.ignoreInput = false;
+  pss << c << std::endl;
+  BOOST_REQUIRE_EQUAL(c.count, 1);
+  BOOST_REQUIRE_EQUAL(ss.str(), BASH_GREEN "[INFO ] " BASH_CLEAR "counted\n");
+}
+
+/**
+ * Make sure that a stream that ignores its input still knows where its lines
+ * end, so that the prefix is written when it stops ignoring its input.
+ */
+BOOST_AUTO_TEST_CASE(TestIgnoredPrefixedOutStreamNewlines)
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, BASH_GREEN "[INFO ] " BASH_CLEAR);
+
+  pss << "Start of a line; ";
+  pss.ignoreInput = true;
+  pss << "hidden end of the line." << std::endl;
+  pss.ignoreInput = false;
+  pss << "New line." << std::endl;
+
+  pss.ignoreInput = true;
+  pss << "Hidden start of a line";
+  pss.ignoreInput = false;
+  pss << ", continued." << std::endl;
+
+  BOOST_REQUIRE_EQUAL(ss.str(),
+      BASH_GREEN "[INFO ] " BASH_CLEAR "Start of a line; "
+      BASH_GREEN "[INFO ] " BASH_CLEAR "New line.\n"
+      ", continued.\n");
+}
+
+/**
+ * Make sure that the output written through an AsyncLogSink is the same as the
+ * direct output, for two streams sharing the sink.
+ */
+BOOST_AUTO_TEST_CASE(TestAsyncLogSink)
+{
+  std::stringstream ss1, ss2, expected1, expected2;
+  AsyncLogSink sink;
+  PrefixedOutStream pss1(ss1, BASH_GREEN "[INFO ] " BASH_CLEAR, false, false,
+      true, &sink);
+  PrefixedOutStream pss2(ss2, BASH_YELLOW "[WARN ] " BASH_CLEAR, false, false,
+      true, &sink);
+  PrefixedOutStream direct1(expected1, BASH_GREEN "[INFO ] " BASH_CLEAR);
+  PrefixedOutStream direct2(expected2, BASH_YELLOW "[WARN ] " BASH_CLEAR);
+
+  // Before Start(), the output is written directly.
+  pss1 << "Before starting." << std::endl;
+  BOOST_REQUIRE_EQUAL(ss1.str(),
+      BASH_GREEN "[INFO ] " BASH_CLEAR "Before starting.\n");
+  direct1 << "Before starting." << std::endl;
+
+  // A small buffer, so that the writers have to wait for the background
+  // thread.
+  sink.Start(10, 256);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    pss1 << "Iteration " << i << ", objective " << std::setprecision(4)
+        << (1.0 / (i + 1)) << "." << std::endl;
+    direct1 << "Iteration " << i << ", objective " << std::setprecision(4)
+        << (1.0 / (i + 1)) << "." << std::endl;
+    if (i % 10 == 0)
+    {
+      pss2 << "Warning " << std::setw(4) << std::setfill('0') << i << "\n";
+      direct2 << "Warning " << std::setw(4) << std::setfill('0') << i << "\n";
+    }
+  }
+  sink.Flush();
+
+  BOOST_REQUIRE_EQUAL(ss1.str(), expected1.str());
+  BOOST_REQUIRE_EQUAL(ss2.str(), expected2.str());
+
+  // Manipulators change the formatting of the following output, and
+  // std::flush writes the buffered text.
+  pss1 << "Fixed " << std::fixed << 0.5 << std::flush;
+  direct1 << "Fixed " << std::fixed << 0.5 << std::flush;
+  BOOST_REQUIRE_EQUAL(ss1.str(), expected1.str());
+  pss1 << std::endl;
+  direct1 << std::endl;
+
+  // After Stop(), the output is written directly again.
+  sink.Stop();
+  BOOST_REQUIRE(!sink.Running());
+  pss1 << "After stopping." << std::endl;
+  direct1 << "After stopping." << std::endl;
+  BOOST_REQUIRE_EQUAL(ss1.str(), expected1.str());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/loss_functions/empty_loss.hpp>
 #include <mlpack/methods/reinforcement_learning/q_learning.hpp>
+#include <mlpack/methods/reinforcement_learning/apex.hpp>
 #include <mlpack/methods/reinforcement_learning/sac.hpp>
 #include <mlpack/methods/reinforcement_learning/q_networks/simple_dqn.hpp>
 #include <mlpack/methods/reinforcement_learning/q_networks/dueling_dqn.hpp>
@@ -149,6 +150,141 @@ BOOST_AUTO_TEST_CASE(CartPoleWithDQNPrioritizedReplay)
   BOOST_REQUIRE(converged);
 }
 
+//! Test DQN in Cart Pole task, stepping several copies of the task at once.
+BOOST_AUTO_TEST_CASE(CartPoleWithVectorDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of steps using random weights.
+  bool converged = false;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    // Set up the network.
+    SimpleDQN<> network(4, 128, 128, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+    RandomReplay<CartPole> replayMethod(32, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 96;
+    config.ExplorationSteps() = 96;
+
+    // Set up DQN agent.
+    QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+        agent(config, network, policy, replayMethod);
+
+    VectorEnvironment<CartPole> environments(8, CartPole(200));
+
+    std::vector<double> returnList;
+    for (size_t step = 0; step < 5000 && !converged; ++step)
+    {
+      agent.VectorStep(environments);
+      BOOST_REQUIRE_EQUAL(agent.TotalSteps(), 8 * (step + 1));
+
+      for (double episodeReturn : environments.FinishedReturns())
+      {
+        returnList.push_back(episodeReturn);
+        if (returnList.size() > 50)
+          returnList.erase(returnList.begin());
+      }
+
+      const double averageReturn = std::accumulate(returnList.begin(),
+          returnList.end(), 0.0) / returnList.size();
+      converged = (returnList.size() >= 50 && averageReturn > 40);
+    }
+
+    if (converged)
+      break;
+  }
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN trained by Ape-X style actors and learner in Cart Pole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithApeX)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of episodes using random weights.
+  bool converged = false;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    // Set up the network.
+    SimpleDQN<> network(4, 64, 64, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+    PrioritizedReplay<CartPole> replayMethod(32, 10000, 0.6);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+
+    ApeX<CartPole, decltype(network), AdamUpdate, decltype(policy)> agent(
+        config, network, policy, replayMethod, 2, 20, 50, AdamUpdate(),
+        CartPole(200));
+
+    std::vector<double> returnList;
+    size_t episodes = 0;
+    auto measure = [&](const double episodeReturn)
+    {
+      returnList.push_back(episodeReturn);
+      if (returnList.size() > 50)
+        returnList.erase(returnList.begin());
+
+      const double averageReturn = std::accumulate(returnList.begin(),
+          returnList.end(), 0.0) / returnList.size();
+      converged = (returnList.size() >= 50 && averageReturn > 40);
+      return converged || ++episodes >= 3000;
+    };
+
+    agent.Train(measure);
+    BOOST_REQUIRE_GT(agent.ActorSteps(), 0);
+    BOOST_REQUIRE_GT(agent.LearnerSteps(), 0);
+
+    if (converged)
+      break;
+  }
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN with soft target network updates in Cart Pole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithSoftTargetDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights.
+  bool converged = false;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    // Set up the network.
+    SimpleDQN<> network(4, 64, 64, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+    RandomReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 1;
+    config.SoftTargetUpdate() = true;
+    config.Rho() = 0.01;
+    config.ExplorationSteps() = 100;
+    config.StepLimit() = 200;
+
+    // Set up DQN agent.
+    QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+        agent(config, network, policy, replayMethod);
+
+    converged = testAgent<decltype(agent)>(agent, 40, 1000);
+    if (converged)
+      break;
+  }
+  BOOST_REQUIRE(converged);
+}
+
 //! Test Double DQN in Cart Pole task.
 BOOST_AUTO_TEST_CASE(CartPoleWithDoubleDQN)
 {
@@ -507,6 +643,91 @@ BOOST_AUTO_TEST_CASE(CartPoleWithCategoricalDQN)
   BOOST_REQUIRE(converged);
 }
 
+//! Make sure that the projection of categorical DQN matches a direct
+//! computation, and that no probability is lost.
+BOOST_AUTO_TEST_CASE(CategoricalProjectionTest)
+{
+  const size_t atomSize = 51;
+  const size_t batchSize = 40;
+  const double vMin = -10.0, vMax = 10.0, discount = 0.9;
+  const double deltaZ = (vMax - vMin) / (atomSize - 1);
+
+  arma::mat nextDist = arma::randu<arma::mat>(atomSize, batchSize);
+  nextDist.each_row() /= arma::sum(nextDist, 0);
+  arma::rowvec rewards = 4 * arma::randn<arma::rowvec>(batchSize);
+  arma::irowvec isTerminal = arma::randi<arma::irowvec>(batchSize,
+      arma::distr_param(0, 1));
+  // Some rewards land exactly on atoms, and some atoms are clamped.
+  rewards[0] = vMin + 2 * deltaZ;
+  isTerminal[0] = 1;
+  rewards[1] = 25.0;
+
+  arma::mat projDist;
+  ProjectDistribution(nextDist, rewards, isTerminal, discount, vMin, vMax,
+      projDist);
+
+  arma::mat expected(atomSize, batchSize, arma::fill::zeros);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    for (size_t j = 0; j < atomSize; ++j)
+    {
+      const double z = vMin + j * deltaZ;
+      const double tz = std::min(vMax, std::max(vMin, rewards[i] +
+          (isTerminal[i] ? 0.0 : discount * z)));
+      const double b = (tz - vMin) / deltaZ;
+      const size_t l = (size_t) std::floor(b);
+      const size_t u = (size_t) std::ceil(b);
+      if (l == u)
+      {
+        expected(l, i) += nextDist(j, i);
+      }
+      else
+      {
+        expected(l, i) += nextDist(j, i) * (u - b);
+        expected(u, i) += nextDist(j, i) * (b - l);
+      }
+    }
+  }
+
+  CheckMatrices(projDist, expected);
+  for (size_t i = 0; i < batchSize; ++i)
+    BOOST_REQUIRE_CLOSE(arma::accu(projDist.col(i)), 1.0, 1e-8);
+  BOOST_REQUIRE_CLOSE(projDist(2, 0), 1.0, 1e-8);
+
+  // The gradient only involves the atoms of the actions taken.
+  arma::mat dists = arma::randu<arma::mat>(2 * atomSize, batchSize);
+  std::vector<CartPole::Action> actions(batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+    actions[i].action = (i % 3 == 0) ? CartPole::Action::forward :
+        CartPole::Action::backward;
+
+  arma::mat gradients;
+  const double loss = CategoricalCrossEntropy(dists, actions, projDist,
+      gradients);
+  BOOST_REQUIRE_EQUAL(gradients.n_rows, dists.n_rows);
+  BOOST_REQUIRE_EQUAL(gradients.n_cols, dists.n_cols);
+
+  double expectedLoss = 0.0;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t offset = actions[i].action * atomSize;
+    for (size_t j = 0; j < 2 * atomSize; ++j)
+    {
+      if (j < offset || j >= offset + atomSize)
+      {
+        BOOST_REQUIRE_EQUAL(gradients(j, i), 0.0);
+        continue;
+      }
+
+      const double p = 1e-10 + dists(j, i);
+      expectedLoss -= projDist(j - offset, i) * std::log(p);
+      BOOST_REQUIRE_CLOSE(gradients(j, i) - 1.0,
+          -projDist(j - offset, i) / p - 1.0, 1e-8);
+    }
+  }
+  BOOST_REQUIRE_CLOSE(loss, expectedLoss, 1e-8);
+}
+
 //! Test SAC on Pendulum task.
 BOOST_AUTO_TEST_CASE(PendulumWithSAC)
 {
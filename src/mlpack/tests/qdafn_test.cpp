@@ -245,4 +245,36 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 1000);
 }
 
+// Make sure QDAFN works with single-precision data, and that the distances it
+// returns are the distances to the returned neighbors.
+BOOST_AUTO_TEST_CASE(FloatTest)
+{
+  arma::fmat dataset(10, 1000, arma::fill::randu);
+  arma::fmat queries(10, 300, arma::fill::randu);
+
+  QDAFN<arma::fmat> qdafn(dataset, 10, 30);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(queries, 3, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 300);
+  BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, 300);
+
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE_LT(neighbors(i, q), 1000);
+      const double dist = metric::EuclideanDistance::Evaluate(queries.col(q),
+          dataset.col(neighbors(i, q)));
+      BOOST_REQUIRE_CLOSE(distances(i, q), dist, 1e-3);
+      if (i > 0)
+        BOOST_REQUIRE_LE(distances(i, q), distances(i - 1, q));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
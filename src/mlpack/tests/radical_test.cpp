@@ -58,4 +58,26 @@ BOOST_AUTO_TEST_CASE(Radical_Test_Radical3D)
   BOOST_REQUIRE_CLOSE(valBest, valEst, 2.0);
 }
 
+/**
+ * Make sure that the unmixing matrix gives the estimated independent
+ * components when several pairs of dimensions are rotated in each round.
+ */
+BOOST_AUTO_TEST_CASE(Radical_Test_UnmixingMatrix)
+{
+  // Mix 5 independent uniform sources.
+  mat matS = randu<mat>(5, 500);
+  mat matA = randu<mat>(5, 5) + 5 * eye<mat>(5, 5);
+  mat matX = matA * matS;
+
+  Radical rad(0.175, 5, 50, 2);
+
+  mat matY;
+  mat matW;
+  rad.DoRadical(matX, matY, matW);
+
+  BOOST_REQUIRE_EQUAL(matW.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(matW.n_cols, 5);
+  CheckMatrices(matY, matW * matX, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_random_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -487,4 +488,245 @@ BOOST_AUTO_TEST_CASE(DifferentTreesTest)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Make sure that the FlatRandomForest gives the same predictions and
+ * probabilities as the RandomForest it packs, with and without bitvectors.
+ */
+BOOST_AUTO_TEST_CASE(FlatRandomForestTest)
+{
+  arma::mat data(6, 1500, arma::fill::randn);
+  arma::Row<size_t> labels(1500);
+  for (size_t i = 0; i < 1500; ++i)
+  {
+    labels[i] = i % 3;
+    data(labels[i], i) += 1.0;
+  }
+
+  RandomForest<> rf(data, labels, 3, 20 /* 20 trees */, 5);
+  FlatRandomForest flatForest(rf);
+  FlatRandomForest bitvectorForest(rf, true);
+
+  // Use a test set with some NaN values, which go right at every node, and
+  // more points than one block.
+  arma::mat testData(6, 300, arma::fill::randn);
+  testData(2, 7) = std::numeric_limits<double>::quiet_NaN();
+  testData(0, 11) = std::numeric_limits<double>::quiet_NaN();
+
+  arma::Row<size_t> predictions, flatPredictions, bitvectorPredictions;
+  arma::mat probabilities, flatProbabilities, bitvectorProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  flatForest.Classify(testData, flatPredictions, flatProbabilities);
+  bitvectorForest.Classify(testData, bitvectorPredictions,
+      bitvectorProbabilities);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], flatPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], bitvectorPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], flatForest.Classify(testData.col(i)));
+    BOOST_REQUIRE_EQUAL(predictions[i],
+        bitvectorForest.Classify(testData.col(i)));
+  }
+
+  CheckMatrices(probabilities, flatProbabilities);
+  CheckMatrices(probabilities, bitvectorProbabilities);
+}
+
+/**
+ * Make sure that the batch classification, which goes through the trees one
+ * block of points at a time, gives the same results as classifying each point
+ * on its own, and that probabilities can be accumulated in single precision.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestBatchClassifyTest)
+{
+  arma::mat data(5, 1000, arma::fill::randn);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    labels[i] = i % 4;
+    data(labels[i], i) += 1.0;
+  }
+
+  RandomForest<> rf(data, labels, 4, 30 /* 30 trees */, 3);
+
+  // Use more points than one block, with a partial last block.
+  arma::mat testData(5, 3 * RandomForest<>::BlockSize + 17, arma::fill::randn);
+
+  arma::Row<size_t> predictions, floatPredictions, onlyPredictions;
+  arma::mat probabilities;
+  arma::fmat floatProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  rf.Classify(testData, floatPredictions, floatProbabilities);
+  rf.Classify(testData, onlyPredictions);
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, testData.n_cols);
+  BOOST_REQUIRE_EQUAL(floatProbabilities.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(floatProbabilities.n_cols, testData.n_cols);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    rf.Classify(testData.col(i), prediction, pointProbabilities);
+
+    BOOST_REQUIRE_EQUAL(predictions[i], prediction);
+    BOOST_REQUIRE_EQUAL(onlyPredictions[i], prediction);
+    for (size_t c = 0; c < 4; ++c)
+    {
+      BOOST_REQUIRE_CLOSE(probabilities(c, i) + 1.0,
+          pointProbabilities[c] + 1.0, 1e-10);
+      BOOST_REQUIRE_CLOSE(floatProbabilities(c, i) + 1.0,
+          pointProbabilities[c] + 1.0, 1e-4);
+    }
+  }
+}
+
+/**
+ * Make sure that a random forest written to a model archive can be loaded as a
+ * whole or one tree at a time.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestModelArchiveTest)
+{
+  arma::mat data(5, 500, arma::fill::randn);
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    labels[i] = i % 3;
+    data(labels[i], i) += 1.0;
+  }
+
+  RandomForest<> rf(data, labels, 3, 12 /* 12 trees */, 3);
+  {
+    data::ModelArchiveWriter writer("test_forest.mla");
+    rf.Save(writer, "forest");
+    writer.Finish();
+  }
+
+  data::ModelArchive archive("test_forest.mla");
+  BOOST_REQUIRE_EQUAL(RandomForest<>::NumTrees(archive, "forest"), 12);
+
+  RandomForest<> loaded;
+  loaded.Load(archive, "forest");
+  BOOST_REQUIRE_EQUAL(loaded.NumTrees(), 12);
+
+  arma::Row<size_t> predictions, loadedPredictions;
+  arma::mat probabilities, loadedProbabilities;
+  rf.Classify(data, predictions, probabilities);
+  loaded.Classify(data, loadedPredictions, loadedProbabilities);
+  BOOST_REQUIRE(arma::all(predictions == loadedPredictions));
+  CheckMatrices(probabilities, loadedProbabilities);
+
+  // A single tree can be loaded on its own.
+  RandomForest<>::DecisionTreeType tree;
+  RandomForest<>::LoadTree(archive, "forest", 7, tree);
+  arma::Row<size_t> treePredictions, loadedTreePredictions;
+  rf.Tree(7).Classify(data, treePredictions);
+  tree.Classify(data, loadedTreePredictions);
+  BOOST_REQUIRE(arma::all(treePredictions == loadedTreePredictions));
+
+  BOOST_REQUIRE_THROW(RandomForest<>::LoadTree(archive, "forest", 12, tree),
+      std::invalid_argument);
+
+  remove("test_forest.mla");
+}
+
+/**
+ * Make sure that the FlatRandomForest classifies categorical data like the
+ * RandomForest, and refuses to use bitvectors for it.
+ */
+BOOST_AUTO_TEST_CASE(FlatRandomForestCategoricalTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  RandomForest<> rf(d, di, l, 5, 10 /* 10 trees */, 1, 1e-7, 0,
+      MultipleRandomDimensionSelect(4));
+  FlatRandomForest flatForest(rf);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  rf.Classify(d, predictions);
+  flatForest.Classify(d, flatPredictions);
+  for (size_t i = 0; i < d.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], flatPredictions[i]);
+
+  BOOST_REQUIRE_THROW(FlatRandomForest(rf, true), std::invalid_argument);
+}
+
+/**
+ * Make sure that the out-of-bag error of a random forest is a sensible estimate
+ * of its test error, and that the permutation importances find the dimensions
+ * the labels depend on.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestOOBErrorTest)
+{
+  // Only the first three dimensions hold information about the labels.
+  arma::mat data(6, 1200, arma::fill::randn);
+  arma::Row<size_t> labels(1200);
+  for (size_t i = 0; i < 1200; ++i)
+  {
+    labels[i] = i % 3;
+    data(labels[i], i) += 2.0;
+  }
+
+  RandomForest<> rf(data, labels, 3, 25 /* 25 trees */, 3);
+
+  // About a third of the points are out of the bag of each tree.
+  for (size_t t = 0; t < rf.NumTrees(); ++t)
+  {
+    const std::vector<bool>& outOfBag = rf.OutOfBag(t);
+    BOOST_REQUIRE_EQUAL(outOfBag.size(), 1200);
+    const size_t numOutOfBag = std::count(outOfBag.begin(), outOfBag.end(),
+        true);
+    BOOST_REQUIRE_GT(numOutOfBag, 300);
+    BOOST_REQUIRE_LT(numOutOfBag, 600);
+  }
+
+  // The out-of-bag error should be close to the error on new points.
+  arma::mat testData(6, 1200, arma::fill::randn);
+  arma::Row<size_t> testLabels(1200);
+  for (size_t i = 0; i < 1200; ++i)
+  {
+    testLabels[i] = i % 3;
+    testData(testLabels[i], i) += 2.0;
+  }
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testData, predictions);
+  const double testError = arma::accu(predictions != testLabels) / 1200.0;
+  const double oobError = rf.OOBError(data, labels);
+  BOOST_REQUIRE_GT(oobError, 0.0);
+  BOOST_REQUIRE_SMALL(oobError - testError, 0.08);
+
+  arma::vec importances;
+  rf.PermutationImportance(data, labels, importances);
+  BOOST_REQUIRE_EQUAL(importances.n_elem, 6);
+  for (size_t d = 0; d < 3; ++d)
+  {
+    BOOST_REQUIRE_GT(importances[d], 0.05);
+    for (size_t e = 3; e < 6; ++e)
+      BOOST_REQUIRE_GT(importances[d], importances[e] + 0.03);
+  }
+
+  // The importances only depend on the random seed.
+  arma::vec seededImportances, repeatedImportances;
+  math::RandomSeed(7);
+  rf.PermutationImportance(data, labels, seededImportances);
+  math::RandomSeed(7);
+  rf.PermutationImportance(data, labels, repeatedImportances);
+  for (size_t d = 0; d < 6; ++d)
+    BOOST_REQUIRE_EQUAL(seededImportances[d], repeatedImportances[d]);
+
+  // The dataset must be the training set.
+  BOOST_REQUIRE_THROW(rf.OOBError(testData.cols(0, 99), labels.cols(0, 99)),
+      std::invalid_argument);
+
+  // The out-of-bag points are not serialized.
+  RandomForest<> xmlRf, textRf, binaryRf;
+  SerializeObjectAll(rf, xmlRf, textRf, binaryRf);
+  BOOST_REQUIRE_THROW(xmlRf.OOBError(data, labels), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -97,4 +97,88 @@ BOOST_AUTO_TEST_CASE(WeightedRandomTest)
   }
 }
 
+// Test the Philox generator against the known-answer vectors of the reference
+// implementation (Random123).
+BOOST_AUTO_TEST_CASE(PhiloxKnownAnswerTest)
+{
+  Philox generator(0, 0);
+  BOOST_REQUIRE_EQUAL(generator(), 0x6627e8d5);
+  BOOST_REQUIRE_EQUAL(generator(), 0xe169c58d);
+  BOOST_REQUIRE_EQUAL(generator(), 0xbc57ac4c);
+  BOOST_REQUIRE_EQUAL(generator(), 0x9b00dbd8);
+
+  // Skipping numbers must give the same numbers as drawing them.
+  Philox first(42, 3), second(42, 3);
+  for (size_t i = 0; i < 11; ++i)
+    first();
+  second.Discard(11);
+  for (size_t i = 0; i < 10; ++i)
+    BOOST_REQUIRE_EQUAL(first(), second());
+
+  // Different streams must give different numbers.
+  Philox other(42, 4);
+  second.Seed(42, 3);
+  BOOST_REQUIRE_NE(second(), other());
+}
+
+// Make sure the per-thread random objects are reseeded by RandomSeed(), and
+// that the numbers drawn in parallel regions are reproducible.
+BOOST_AUTO_TEST_CASE(ThreadRandGenReproducibleTest)
+{
+  arma::vec a(1000), b(1000);
+  RandomSeed(7);
+  RandVector(a);
+  RandomSeed(7);
+  RandVector(b);
+  CheckMatrices(a, b);
+  BOOST_REQUIRE_GE(a.min(), 0.0);
+  BOOST_REQUIRE_LT(a.max(), 1.0);
+
+  RandomSeed(11);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) a.n_elem; ++i)
+    a[i] = Random();
+  RandomSeed(11);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) b.n_elem; ++i)
+    b[i] = Random();
+  CheckMatrices(a, b);
+}
+
+// Check the moments of RandVector() and RandNormalVector().
+BOOST_AUTO_TEST_CASE(RandVectorTest)
+{
+  Philox generator(5, 0);
+
+  arma::vec v(100000);
+  RandVector(v, generator, -2.0, 4.0);
+  BOOST_REQUIRE_GE(v.min(), -2.0);
+  BOOST_REQUIRE_LT(v.max(), 4.0);
+  BOOST_REQUIRE_SMALL(arma::mean(v) - 1.0, 0.05);
+
+  RandNormalVector(v, generator, 3.0, 2.0);
+  BOOST_REQUIRE_SMALL(arma::mean(v) - 3.0, 0.05);
+  BOOST_REQUIRE_SMALL(arma::stddev(v) - 2.0, 0.05);
+}
+
+// Make sure RandMask() keeps each element with the right probability, and that
+// the mask only depends on the seed.
+BOOST_AUTO_TEST_CASE(RandMaskTest)
+{
+  arma::mat a(300, 500), b(300, 500);
+  RandomSeed(3);
+  RandMask(a, 0.3, 2.0);
+  RandomSeed(3);
+  RandMask(b, 0.3, 2.0);
+  CheckMatrices(a, b);
+
+  BOOST_REQUIRE_EQUAL(arma::accu((a != 0.0) % (a != 2.0)), 0);
+  BOOST_REQUIRE_SMALL(arma::accu(a == 0.0) / (double) a.n_elem - 0.3, 0.01);
+
+  RandMask(a, 0.0, 2.0);
+  BOOST_REQUIRE_EQUAL(arma::accu(a == 2.0), a.n_elem);
+  RandMask(a, 1.0);
+  BOOST_REQUIRE_EQUAL(arma::accu(a == 0.0), a.n_elem);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
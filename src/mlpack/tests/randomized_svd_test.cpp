@@ -60,3 +60,38 @@ TEST_CASE("RandomizedSVDReconstructionError", "[RandomizedSVDTest]")
       arma::norm(centeredData, "frob");
   REQUIRE(error == Approx(0.0).margin(1e-5));
 }
+
+/**
+ * The singular values obtained from sparse data should match the singular
+ * values of the centered dense data.
+ */
+TEST_CASE("RandomizedSVDSparseTest", "[RandomizedSVDTest]")
+{
+  // Sparse data of rank 3; the centered data has rank at most 4.
+  arma::sp_mat left, right;
+  left.sprandu(40, 3, 0.5);
+  right.sprandu(3, 120, 0.3);
+  arma::sp_mat data = left * right;
+
+  arma::mat centeredData;
+  math::Center(arma::mat(data), centeredData);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  svd::RandomizedSVD rSVD(0, 4);
+  rSVD.Apply(data, U2, s2, V2, 4);
+
+  REQUIRE(s2.n_elem >= 3);
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(s2[i] == Approx(s1[i]).epsilon(1e-5));
+
+  // The relative reconstruction error should be small.
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  const double error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+}
+
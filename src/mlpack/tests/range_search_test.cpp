@@ -1247,6 +1247,58 @@ BOOST_AUTO_TEST_CASE(MoveTrainTest)
   }
 }
 
+/**
+ * Make sure that an RSModel whose reference set is memory-mapped gives the same
+ * results, and that it can be saved and loaded without the reference set.
+ */
+BOOST_AUTO_TEST_CASE(RSModelMapReferenceSetTest)
+{
+  arma::mat queryData = arma::randu<arma::mat>(5, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+  const math::Range range(0.25, 0.5);
+
+  for (size_t naive = 0; naive < 2; ++naive)
+  {
+    RSModel model(RSModel::TreeTypes::KD_TREE, false);
+    arma::mat referenceCopy(referenceData);
+    model.BuildModel(std::move(referenceCopy), 10, naive == 1, false);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    vector<vector<pair<double, size_t>>> baselineSorted, sorted;
+    arma::mat queryCopy(queryData);
+    model.Search(std::move(queryCopy), range, neighbors, distances);
+    SortResults(neighbors, distances, baselineSorted);
+    const arma::mat baselineDataset(model.Dataset());
+
+    model.MapReferenceSet("rs_reference_map.bin");
+    BOOST_REQUIRE_EQUAL(model.ReferenceMapFile(), "rs_reference_map.bin");
+    CheckMatrices(model.Dataset(), baselineDataset);
+
+    queryCopy = queryData;
+    model.Search(std::move(queryCopy), range, neighbors, distances);
+    SortResults(neighbors, distances, sorted);
+    BOOST_REQUIRE(sorted == baselineSorted);
+
+    BOOST_REQUIRE(data::Save("rs_mapped_model.bin", "rs_model", model, true));
+    CheckMatrices(model.Dataset(), baselineDataset);
+
+    RSModel loadedModel;
+    BOOST_REQUIRE(data::Load("rs_mapped_model.bin", "rs_model", loadedModel,
+        true));
+    BOOST_REQUIRE_EQUAL(loadedModel.ReferenceMapFile(), "rs_reference_map.bin");
+    CheckMatrices(loadedModel.Dataset(), baselineDataset);
+
+    queryCopy = queryData;
+    loadedModel.Search(std::move(queryCopy), range, neighbors, distances);
+    SortResults(neighbors, distances, sorted);
+    BOOST_REQUIRE(sorted == baselineSorted);
+  }
+
+  remove("rs_reference_map.bin");
+  remove("rs_mapped_model.bin");
+}
+
 BOOST_AUTO_TEST_CASE(RSModelTest)
 {
   // Ensure that we can build an RSModel and get correct results.
@@ -1696,4 +1748,232 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * Make sure that naive and single-tree searches over parallel query blocks give
+ * the same results as the serial searches.
+ */
+BOOST_AUTO_TEST_CASE(ParallelQueriesTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 800);
+  arma::mat queries = arma::randu<arma::mat>(3, 200);
+  const Range range(0.05, 0.2);
+
+  for (size_t naive = 0; naive < 2; ++naive)
+  {
+    RangeSearch<> serial(dataset, naive == 1, true);
+    RangeSearch<> parallel(dataset, naive == 1, true);
+    parallel.ParallelQueries() = true;
+
+    vector<vector<size_t>> serialNeighbors, parallelNeighbors;
+    vector<vector<double>> serialDistances, parallelDistances;
+    vector<vector<pair<double, size_t>>> sortedSerial, sortedParallel;
+
+    serial.Search(queries, range, serialNeighbors, serialDistances);
+    parallel.Search(queries, range, parallelNeighbors, parallelDistances);
+    BOOST_REQUIRE_EQUAL(parallel.BaseCases(), serial.BaseCases());
+
+    SortResults(serialNeighbors, serialDistances, sortedSerial);
+    SortResults(parallelNeighbors, parallelDistances, sortedParallel);
+    BOOST_REQUIRE(sortedParallel == sortedSerial);
+
+    serial.Search(range, serialNeighbors, serialDistances);
+    parallel.Search(range, parallelNeighbors, parallelDistances);
+    BOOST_REQUIRE_EQUAL(parallel.BaseCases(), serial.BaseCases());
+
+    SortResults(serialNeighbors, serialDistances, sortedSerial);
+    SortResults(parallelNeighbors, parallelDistances, sortedParallel);
+    BOOST_REQUIRE(sortedParallel == sortedSerial);
+  }
+}
+
+/**
+ * Make sure that the parallel dual-tree traverser gives the same results as the
+ * serial dual-tree traverser for range search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeTraverserTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 800);
+
+  typedef KDTree<EuclideanDistance, RangeSearchStat, arma::mat> TreeType;
+  typedef RangeSearchRules<EuclideanDistance, TreeType> RuleType;
+
+  EuclideanDistance metric;
+  const Range range(0.05, 0.2);
+
+  TreeType serialTree(dataset, 10);
+  vector<vector<size_t>> serialNeighbors(dataset.n_cols);
+  vector<vector<double>> serialDistances(dataset.n_cols);
+  RuleType serialRules(serialTree.Dataset(), serialTree.Dataset(), range,
+      serialNeighbors, serialDistances, metric, true);
+  TreeType::DualTreeTraverser<RuleType> serialTraverser(serialRules);
+  serialTraverser.Traverse(serialTree, serialTree);
+
+  TreeType tree(dataset, 10);
+  vector<vector<size_t>> neighbors(dataset.n_cols);
+  vector<vector<double>> distances(dataset.n_cols);
+  RuleType rules(tree.Dataset(), tree.Dataset(), range, neighbors, distances,
+      metric, true);
+  TreeType::ParallelDualTreeTraverser<RuleType> traverser(rules, 4);
+  traverser.Traverse(tree, tree);
+
+  vector<vector<pair<double, size_t>>> sortedSerial, sorted;
+  SortResults(serialNeighbors, serialDistances, sortedSerial);
+  SortResults(neighbors, distances, sorted);
+
+  BOOST_REQUIRE_GT(rules.BaseCases(), 0);
+  for (size_t i = 0; i < sorted.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sorted[i].size(), sortedSerial[i].size());
+
+    for (size_t j = 0; j < sorted[i].size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(sorted[i][j].second, sortedSerial[i][j].second);
+      BOOST_REQUIRE_CLOSE(sorted[i][j].first, sortedSerial[i][j].first, 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that single-precision range search with kd-trees returns the same
+ * results as single-precision naive range search, in both the single-tree and
+ * the dual-tree case.
+ */
+BOOST_AUTO_TEST_CASE(FloatRangeSearchTest)
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(3, 800);
+  arma::fmat queries = arma::randu<arma::fmat>(3, 200);
+  const Range range(0.05, 0.2);
+
+  typedef RangeSearch<EuclideanDistance, arma::fmat, KDTree> FloatRangeSearch;
+
+  FloatRangeSearch naive(dataset, true);
+  vector<vector<size_t>> naiveNeighbors;
+  vector<vector<double>> naiveDistances;
+  naive.Search(queries, range, naiveNeighbors, naiveDistances);
+  vector<vector<pair<double, size_t>>> sortedNaive;
+  SortResults(naiveNeighbors, naiveDistances, sortedNaive);
+
+  for (size_t singleMode = 0; singleMode < 2; ++singleMode)
+  {
+    FloatRangeSearch rs(dataset, false, singleMode == 1);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    rs.Search(queries, range, neighbors, distances);
+    vector<vector<pair<double, size_t>>> sorted;
+    SortResults(neighbors, distances, sorted);
+
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(sorted[i].size(), sortedNaive[i].size());
+
+      for (size_t j = 0; j < sorted[i].size(); ++j)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[i][j].second, sortedNaive[i][j].second);
+        BOOST_REQUIRE_CLOSE(sorted[i][j].first, sortedNaive[i][j].first,
+            1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the compressed results of each kind of search hold the same
+ * results as the vectors of neighbors and distances, in the same order.
+ */
+BOOST_AUTO_TEST_CASE(CompressedResultsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 600);
+  arma::mat queries = arma::randu<arma::mat>(3, 150);
+  const Range range(0.05, 0.25);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(dataset, mode == 0, mode == 1);
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      RangeSearchResults results;
+      if (mono == 1)
+      {
+        rs.Search(range, neighbors, distances);
+        rs.Search(range, results);
+      }
+      else
+      {
+        rs.Search(queries, range, neighbors, distances);
+        rs.Search(queries, range, results);
+      }
+
+      BOOST_REQUIRE_EQUAL(results.NumQueries(), neighbors.size());
+      BOOST_REQUIRE_EQUAL(results.Offsets().size(), neighbors.size() + 1);
+      size_t numResults = 0;
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        BOOST_REQUIRE_EQUAL(results.NumResults(i), neighbors[i].size());
+        for (size_t j = 0; j < neighbors[i].size(); ++j)
+        {
+          BOOST_REQUIRE_EQUAL(results.Neighbors(i)[j], neighbors[i][j]);
+          BOOST_REQUIRE_EQUAL(results.Distances(i)[j], distances[i][j]);
+        }
+        numResults += neighbors[i].size();
+      }
+      BOOST_REQUIRE_EQUAL(results.NumResults(), numResults);
+      BOOST_REQUIRE_GT(numResults, 0);
+    }
+  }
+}
+
+/**
+ * Make sure that RangeSearchResults gathers the results of several buffers and
+ * maps the query and reference indices correctly.
+ */
+BOOST_AUTO_TEST_CASE(CompressedResultsBuildTest)
+{
+  vector<RangeSearchBuffer> buffers(2);
+  // Query 2 has neighbors 0 and 1 in the first buffer and 3 in the second one;
+  // query 0 has neighbor 2 in the second buffer; query 1 has no neighbors.
+  buffers[0].queries = { 2, 2 };
+  buffers[0].neighbors = { 0, 1 };
+  buffers[0].distances = { 0.5, 1.5 };
+  buffers[1].queries = { 0, 2 };
+  buffers[1].neighbors = { 2, 3 };
+  buffers[1].distances = { 2.5, 3.5 };
+
+  RangeSearchResults results;
+  results.Build(3, buffers);
+  BOOST_REQUIRE_EQUAL(results.NumQueries(), 3);
+  BOOST_REQUIRE_EQUAL(results.NumResults(), 4);
+  BOOST_REQUIRE_EQUAL(results.NumResults(0), 1);
+  BOOST_REQUIRE_EQUAL(results.NumResults(1), 0);
+  BOOST_REQUIRE_EQUAL(results.NumResults(2), 3);
+  BOOST_REQUIRE_EQUAL(results.Neighbors(0)[0], 2);
+  BOOST_REQUIRE_EQUAL(results.Neighbors(2)[0], 0);
+  BOOST_REQUIRE_EQUAL(results.Neighbors(2)[1], 1);
+  BOOST_REQUIRE_EQUAL(results.Neighbors(2)[2], 3);
+  BOOST_REQUIRE_EQUAL(results.Distances(2)[2], 3.5);
+
+  // Now map the queries and the references.
+  const vector<size_t> queryMapping = { 1, 2, 0 };
+  const vector<size_t> referenceMapping = { 3, 2, 1, 0 };
+  results.Build(3, buffers, &queryMapping, &referenceMapping);
+  BOOST_REQUIRE_EQUAL(results.NumResults(0), 3);
+  BOOST_REQUIRE_EQUAL(results.NumResults(1), 1);
+  BOOST_REQUIRE_EQUAL(results.NumResults(2), 0);
+  BOOST_REQUIRE_EQUAL(results.Neighbors(0)[0], 3);
+  BOOST_REQUIRE_EQUAL(results.Neighbors(0)[2], 0);
+  BOOST_REQUIRE_EQUAL(results.Neighbors(1)[0], 1);
+  BOOST_REQUIRE_EQUAL(results.Distances(1)[0], 2.5);
+
+  // Mapping the queries afterwards moves the results of each query.
+  results.MapQueries(queryMapping);
+  BOOST_REQUIRE_EQUAL(results.NumResults(0), 0);
+  BOOST_REQUIRE_EQUAL(results.NumResults(1), 3);
+  BOOST_REQUIRE_EQUAL(results.NumResults(2), 1);
+  BOOST_REQUIRE_EQUAL(results.Neighbors(1)[0], 3);
+  BOOST_REQUIRE_EQUAL(results.Distances(2)[0], 2.5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -251,3 +251,32 @@ TEST_CASE("MiscTest", "[RBMNetworkTest]")
   X = X.t();
   BuildVanillaNetwork<arma::Mat<float>>(X, 2);
 }
+
+/**
+ * Make sure that the pool of persistent chains keeps its size across batches,
+ * and holds binary samples.
+ */
+TEST_CASE("BinaryRBMPersistentChainsTest", "[RBMNetworkTest]")
+{
+  arma::mat trainData = arma::conv_to<arma::mat>::from(
+      arma::randu<arma::mat>(20, 10) < 0.5);
+
+  GaussianInitialization gaussian(0, 0.1);
+  RBM<GaussianInitialization> model(trainData, gaussian, trainData.n_rows, 8,
+      4, 2, 1, 2, 8, 1, true);
+  model.NumChains() = 6;
+  model.Reset();
+
+  arma::mat gradient;
+  model.Gradient(model.Parameters(), 0, gradient, 4);
+  REQUIRE(model.Chains().n_rows == 20);
+  REQUIRE(model.Chains().n_cols == 6);
+  REQUIRE(arma::all(arma::vectorise(model.Chains() == 0 ||
+      model.Chains() == 1)));
+
+  // A smaller last batch doesn't restart the chains.
+  model.Gradient(model.Parameters(), 8, gradient, 2);
+  REQUIRE(model.Chains().n_cols == 6);
+  REQUIRE(gradient.n_elem == model.Parameters().n_elem);
+  REQUIRE(gradient.is_finite());
+}
@@ -1384,4 +1384,87 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Build a tree of the given type with bulk loading, check that it is valid,
+ * and check that it gives the same nearest neighbors as a naive search.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoadedTree(const arma::mat& dataset)
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, 20, 6, 5, 2, 0, true);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), dataset.n_cols);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), GetMinLevel(tree));
+
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn1(std::move(tree), DUAL_TREE_MODE);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+// Make sure that bulk loading gives valid trees for every RectangleTree type.
+BOOST_AUTO_TEST_CASE(RectangleTreeBulkLoadTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  CheckBulkLoadedTree<RTree>(dataset);
+  CheckBulkLoadedTree<RStarTree>(dataset);
+  CheckBulkLoadedTree<XTree>(dataset);
+  CheckBulkLoadedTree<RPlusTree>(dataset);
+  CheckBulkLoadedTree<HilbertRTree>(dataset);
+  CheckBulkLoadedTree<RPlusPlusTree>(dataset);
+}
+
+// Packed trees should have full nodes and be no deeper than trees built by
+// insertion, and the children of a node should not overlap.
+BOOST_AUTO_TEST_CASE(RectangleTreeBulkLoadPackingTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType insertedTree(dataset, 20, 6, 5, 2, 0);
+  TreeType packedTree(dataset, 20, 6, 5, 2, 0, true);
+
+  CheckFills(packedTree);
+  BOOST_REQUIRE_LE(packedTree.TreeDepth(), insertedTree.TreeDepth());
+
+  // With 20 points per leaf and 5 children per node, 1000 points fit exactly
+  // in 50 full leaves.
+  BOOST_REQUIRE_EQUAL(packedTree.TreeDepth(), 4);
+  BOOST_REQUIRE_EQUAL(packedTree.NumChildren(), 2);
+
+  typedef RPlusTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      RPlusTreeType;
+  RPlusTreeType rPlusTree(dataset, 20, 6, 5, 2, 0, true);
+  CheckFills(rPlusTree);
+  CheckOverlap(rPlusTree);
+
+  // The bulk loaded Hilbert R tree should keep its points in Hilbert order.
+  typedef HilbertRTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      HilbertRTreeType;
+  HilbertRTreeType hilbertRTree(dataset, 20, 6, 5, 2, 0, true);
+  CheckHilbertOrdering(hilbertRTree);
+  CheckDiscreteHilbertValueSync(hilbertRTree);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
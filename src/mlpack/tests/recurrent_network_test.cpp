@@ -1472,3 +1472,239 @@ TEST_CASE("LargeRhoValueRnnTest", "[RecurrentNetworkTest]")
   model.Train(inputs[0], targets[0], opt);
   INFO("Training over");
 }
+
+/**
+ * Make sure that truncated BPTT windows carry the state of the recurrent layers
+ * from one window to the next, and only cut the backward pass.
+ */
+TEST_CASE("RNNTruncatedBPTTTest", "[RecurrentNetworkTest]")
+{
+  arma::cube predictors = arma::randu<arma::cube>(3, 5, 6);
+  arma::cube responses = arma::randu<arma::cube>(2, 5, 6);
+
+  RNN<MeanSquaredError<> > model(6);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(3, 4, 6);
+  model.Add<Linear<> >(4, 2);
+  model.Predictors() = predictors;
+  model.Responses() = responses;
+  model.ResetParameters();
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 5);
+
+  // A window as long as the sequence is full BPTT.
+  model.BPTTWindow() = 6;
+  arma::mat windowGradient;
+  double windowObjective = model.EvaluateWithGradient(model.Parameters(), 0,
+      windowGradient, 5);
+  REQUIRE(windowObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(gradient, windowGradient);
+
+  // With shorter windows the forward pass does not change, since the state is
+  // carried across the windows.
+  model.BPTTWindow() = 3;
+  windowObjective = model.EvaluateWithGradient(model.Parameters(), 0,
+      windowGradient, 5);
+  REQUIRE(windowObjective == Approx(objective).epsilon(1e-7));
+
+  // The first window starts from the initial state, so its gradient is the
+  // gradient of a sequence made of that window only.
+  RNN<MeanSquaredError<> > windowModel(3);
+  windowModel.Add<IdentityLayer<> >();
+  windowModel.Add<LSTM<> >(3, 4, 6);
+  windowModel.Add<Linear<> >(4, 2);
+  windowModel.Predictors() = predictors.slices(0, 2);
+  windowModel.Responses() = responses.slices(0, 2);
+  windowModel.ResetParameters();
+  windowModel.Parameters() = model.Parameters();
+
+  arma::mat firstGradient, secondGradient;
+  windowModel.EvaluateWithGradient(windowModel.Parameters(), 0, firstGradient,
+      5);
+
+  // The second window starts from the state at the end of the first one, not
+  // from the initial state.
+  windowModel.Predictors() = predictors.slices(3, 5);
+  windowModel.Responses() = responses.slices(3, 5);
+  windowModel.EvaluateWithGradient(windowModel.Parameters(), 0,
+      secondGradient, 5);
+
+  const arma::mat lastWindowGradient = windowGradient - firstGradient;
+  REQUIRE(arma::abs(lastWindowGradient - secondGradient).max() > 1e-5);
+  REQUIRE(arma::abs(windowGradient - gradient).max() > 1e-5);
+}
+
+/**
+ * Make sure that recomputing the outputs of the non-recurrent layers gives the
+ * same gradient as storing them.
+ */
+TEST_CASE("RNNCheckpointActivationsTest", "[RecurrentNetworkTest]")
+{
+  arma::cube predictors = arma::randu<arma::cube>(3, 5, 6);
+  arma::cube responses = arma::randu<arma::cube>(2, 5, 6);
+
+  RNN<MeanSquaredError<> > model(6);
+  model.Add<Linear<> >(3, 4);
+  model.Add<FastLSTM<> >(4, 4, 6);
+  model.Add<Linear<> >(4, 2);
+  model.Add<SigmoidLayer<> >();
+  model.Predictors() = predictors;
+  model.Responses() = responses;
+  model.ResetParameters();
+
+  for (size_t window = 0; window < 3; window += 2)
+  {
+    model.BPTTWindow() = window;
+    model.CheckpointActivations() = false;
+    arma::mat gradient, checkpointGradient;
+    const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+        gradient, 5);
+
+    model.CheckpointActivations() = true;
+    const double checkpointObjective = model.EvaluateWithGradient(
+        model.Parameters(), 0, checkpointGradient, 5);
+
+    REQUIRE(checkpointObjective == Approx(objective).epsilon(1e-7));
+    CheckMatrices(gradient, checkpointGradient);
+  }
+}
+
+/**
+ * Make sure that the truncated BPTT windows and the recomputation of the
+ * outputs of the non-recurrent layers work with BRNN.
+ */
+TEST_CASE("BRNNTruncatedBPTTTest", "[RecurrentNetworkTest]")
+{
+  arma::cube predictors = arma::randu<arma::cube>(3, 5, 6);
+  arma::cube responses = arma::randu<arma::cube>(2, 5, 6);
+
+  BRNN<MeanSquaredError<>, AddMerge<>, SigmoidLayer<> > model(6);
+  model.Add<Linear<> >(3, 4);
+  model.Add<LSTM<> >(4, 4, 6);
+  model.Add<Linear<> >(4, 2);
+  model.Predictors() = predictors;
+  model.Responses() = responses;
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 5);
+
+  // A window as long as the sequence is full BPTT.
+  model.BPTTWindow() = 6;
+  arma::mat windowGradient;
+  double windowObjective = model.EvaluateWithGradient(model.Parameters(), 0,
+      windowGradient, 5);
+  REQUIRE(windowObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(gradient, windowGradient);
+
+  // Shorter windows only change the gradient.
+  model.BPTTWindow() = 2;
+  windowObjective = model.EvaluateWithGradient(model.Parameters(), 0,
+      windowGradient, 5);
+  REQUIRE(windowObjective == Approx(objective).epsilon(1e-7));
+  REQUIRE(arma::abs(windowGradient - gradient).max() > 1e-5);
+
+  model.CheckpointActivations() = true;
+  arma::mat checkpointGradient;
+  const double checkpointObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, checkpointGradient, 5);
+  REQUIRE(checkpointObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(windowGradient, checkpointGradient);
+}
+
+/**
+ * Make sure that the steps after the end of each sequence do not change the
+ * objective or the gradient, and that sequences that all have every step give
+ * the same results as sequences without lengths.
+ */
+TEST_CASE("RNNVariableLengthTest", "[RecurrentNetworkTest]")
+{
+  arma::cube predictors = arma::randu<arma::cube>(3, 5, 6);
+  arma::cube responses = arma::randu<arma::cube>(2, 5, 6);
+  const arma::Row<size_t> lengths = { 6, 2, 4, 1, 3 };
+
+  RNN<MeanSquaredError<> > model(6);
+  model.Add<IdentityLayer<> >();
+  model.Add<FastLSTM<> >(3, 4, 6);
+  model.Add<Linear<> >(4, 2);
+  model.Predictors() = predictors;
+  model.Responses() = responses;
+  model.SequenceLengths() = lengths;
+  model.ResetParameters();
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 5);
+  REQUIRE(model.Evaluate(model.Parameters(), 0, 5) ==
+      Approx(objective).epsilon(1e-7));
+
+  // Change the padding.
+  for (size_t i = 0; i < lengths.n_elem; ++i)
+  {
+    for (size_t s = lengths[i]; s < predictors.n_slices; ++s)
+    {
+      model.Predictors().slice(s).col(i).randu();
+      model.Responses().slice(s).col(i).randu();
+    }
+  }
+
+  arma::mat paddedGradient;
+  const double paddedObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, paddedGradient, 5);
+  REQUIRE(paddedObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(gradient, paddedGradient);
+
+  // With full lengths, the results are those of the whole sequences.
+  model.Predictors() = predictors;
+  model.Responses() = responses;
+  model.SequenceLengths().fill(6);
+  arma::mat fullGradient;
+  const double fullObjective = model.EvaluateWithGradient(model.Parameters(),
+      0, fullGradient, 5);
+
+  model.SequenceLengths().reset();
+  arma::mat plainGradient;
+  const double plainObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, plainGradient, 5);
+  REQUIRE(fullObjective == Approx(plainObjective).epsilon(1e-7));
+  CheckMatrices(fullGradient, plainGradient);
+
+  // Training on sequences of different lengths works.
+  ens::StandardSGD opt(0.01, 2, 20);
+  const double trainObjective = model.Train(predictors, responses, lengths,
+      opt);
+  REQUIRE(std::isfinite(trainObjective));
+  REQUIRE(model.SequenceLengths().n_elem == lengths.n_elem);
+  REQUIRE(arma::accu(model.SequenceLengths()) == arma::accu(lengths));
+
+  REQUIRE_THROWS_AS(model.Train(predictors, responses,
+      arma::Row<size_t>({ 6, 2 }), opt), std::invalid_argument);
+  REQUIRE_THROWS_AS(model.Train(predictors, responses,
+      arma::Row<size_t>({ 6, 2, 7, 1, 3 }), opt), std::invalid_argument);
+}
+
+/**
+ * Make sure that BucketOrdering() gives a permutation where the sequences of
+ * each bucket are sorted by decreasing length.
+ */
+TEST_CASE("BucketOrderingTest", "[RecurrentNetworkTest]")
+{
+  arma::Row<size_t> lengths(100);
+  for (size_t i = 0; i < lengths.n_elem; ++i)
+    lengths[i] = math::RandInt(1, 20);
+
+  const arma::uvec ordering = BucketOrdering(lengths, 16);
+  REQUIRE(ordering.n_elem == lengths.n_elem);
+
+  const arma::uvec sorted = arma::sort(ordering);
+  for (size_t i = 0; i < sorted.n_elem; ++i)
+    REQUIRE(sorted[i] == i);
+
+  for (size_t i = 1; i < ordering.n_elem; ++i)
+  {
+    if (i % 16 != 0)
+      REQUIRE(lengths[ordering[i - 1]] >= lengths[ordering[i]]);
+  }
+}
@@ -0,0 +1,142 @@
+/**
+ * @file tests/reorder_test.cpp
+ *
+ * Tests for data::Reorder() and the space-filling curve orders.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/reorder.hpp>
+
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+/**
+ * Make sure that the Hilbert order of the cells of a grid visits neighboring
+ * cells one after another, and that the Morton order is the order of the
+ * interleaved bits.
+ */
+TEST_CASE("CurveOrderGridTest", "[ReorderTest]")
+{
+  // All the points of a 16 x 16 grid, in random order.
+  arma::mat grid(2, 256);
+  for (size_t i = 0; i < 256; ++i)
+  {
+    grid(0, i) = i % 16;
+    grid(1, i) = i / 16;
+  }
+  grid = grid.cols(arma::shuffle(arma::regspace<arma::uvec>(0, 255)));
+
+  // Each dimension gets 32 bits, so the cells of the grid are 2^32 / 15 apart.
+  const arma::uvec hilbert = CurveOrder(grid, HILBERT);
+  REQUIRE(hilbert.n_elem == 256);
+  for (size_t i = 1; i < 256; ++i)
+  {
+    const double distance = arma::accu(arma::abs(grid.col(hilbert[i]) -
+        grid.col(hilbert[i - 1])));
+    REQUIRE(distance == Approx(1.0));
+  }
+
+  const arma::uvec morton = CurveOrder(grid, MORTON);
+  for (size_t i = 1; i < 256; ++i)
+  {
+    // In the Morton order, the cells are sorted by the interleaved bits of
+    // their coordinates, x first.
+    const size_t a = (size_t) grid(0, morton[i - 1]);
+    const size_t b = (size_t) grid(1, morton[i - 1]);
+    const size_t c = (size_t) grid(0, morton[i]);
+    const size_t d = (size_t) grid(1, morton[i]);
+    size_t previous = 0, current = 0;
+    for (size_t bit = 4; bit > 0; --bit)
+    {
+      previous = (previous << 2) | (((a >> (bit - 1)) & 1) << 1) |
+          ((b >> (bit - 1)) & 1);
+      current = (current << 2) | (((c >> (bit - 1)) & 1) << 1) |
+          ((d >> (bit - 1)) & 1);
+    }
+    REQUIRE(previous < current);
+  }
+}
+
+/**
+ * Make sure that Reorder() permutes the points and the labels together, and
+ * that the permutation can be used to go back to the original order.
+ */
+TEST_CASE("ReorderLabelsTest", "[ReorderTest]")
+{
+  arma::mat dataset(5, 1000, arma::fill::randu);
+  dataset.row(3) *= -100.0;
+  dataset.row(4).fill(2.0); // A constant dimension.
+  arma::Row<size_t> labels = arma::regspace<arma::Row<size_t>>(0, 999);
+  const arma::mat original = dataset;
+
+  const CurveType curves[] = { MORTON, HILBERT };
+  for (size_t c = 0; c < 2; ++c)
+  {
+    arma::mat reordered = original;
+    arma::Row<size_t> reorderedLabels = labels;
+    const arma::uvec permutation = Reorder(reordered, reorderedLabels,
+        curves[c]);
+
+    REQUIRE(permutation.n_elem == 1000);
+    REQUIRE(arma::all(arma::sort(permutation) ==
+        arma::regspace<arma::uvec>(0, 999)));
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      REQUIRE(reorderedLabels[i] == permutation[i]);
+      REQUIRE(arma::approx_equal(reordered.col(i),
+          original.col(permutation[i]), "absdiff", 0.0));
+    }
+
+    // Undo the permutation.
+    arma::mat unmapped(arma::size(reordered));
+    unmapped.cols(permutation) = reordered;
+    REQUIRE(arma::approx_equal(unmapped, original, "absdiff", 0.0));
+  }
+
+  arma::Row<size_t> wrongLabels(999);
+  REQUIRE_THROWS_AS(Reorder(dataset, wrongLabels), std::invalid_argument);
+}
+
+/**
+ * Make sure that reordering along the Hilbert curve puts consecutive points
+ * much closer together than in a random order.
+ */
+TEST_CASE("ReorderLocalityTest", "[ReorderTest]")
+{
+  arma::mat dataset(3, 5000, arma::fill::randu);
+  const arma::mat original = dataset;
+  Reorder(dataset, HILBERT);
+
+  double randomDistance = 0.0, curveDistance = 0.0;
+  for (size_t i = 1; i < dataset.n_cols; ++i)
+  {
+    randomDistance += arma::norm(original.col(i) - original.col(i - 1));
+    curveDistance += arma::norm(dataset.col(i) - dataset.col(i - 1));
+  }
+
+  REQUIRE(curveDistance < 0.25 * randomDistance);
+}
+
+/**
+ * Make sure that empty datasets and single dimensions are handled.
+ */
+TEST_CASE("ReorderDegenerateTest", "[ReorderTest]")
+{
+  arma::mat empty;
+  REQUIRE(Reorder(empty).n_elem == 0);
+
+  arma::mat line("3.0 1.0 2.0 -1.0");
+  const arma::uvec permutation = Reorder(line, HILBERT);
+  REQUIRE(permutation[0] == 3);
+  REQUIRE(permutation[1] == 1);
+  REQUIRE(permutation[2] == 2);
+  REQUIRE(permutation[3] == 0);
+  REQUIRE(arma::is_sorted(line));
+}
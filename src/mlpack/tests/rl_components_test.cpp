@@ -20,8 +20,12 @@
 #include <mlpack/methods/reinforcement_learning/environment/continuous_double_pole_cart.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vector_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/frame_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
+#include <mlpack/methods/reinforcement_learning/worker/hogwild_update.hpp>
+#include <mlpack/methods/reinforcement_learning/target_update.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -172,6 +176,197 @@ BOOST_AUTO_TEST_CASE(SimpleCartPoleTest)
   BOOST_REQUIRE_EQUAL(2, static_cast<size_t>(CartPole::Action::size));
 }
 
+/**
+ * Step several copies of CartPole in lockstep, and make sure that the finished
+ * episodes are restarted.
+ */
+BOOST_AUTO_TEST_CASE(VectorEnvironmentTest)
+{
+  VectorEnvironment<CartPole> environments(3, CartPole(5));
+  BOOST_REQUIRE_EQUAL(environments.Size(), 3);
+  BOOST_REQUIRE_EQUAL(environments.Encode().n_rows, 4);
+  BOOST_REQUIRE_EQUAL(environments.Encode().n_cols, 3);
+
+  std::vector<CartPole::Action> actions(3);
+  for (size_t i = 0; i < 3; ++i)
+    actions[i].action = CartPole::Action::actions::backward;
+
+  std::vector<CartPole::State> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+  for (size_t step = 0; step < 4; ++step)
+  {
+    const arma::mat states = environments.Encode();
+    environments.Step(actions, nextStates, rewards, isTerminal);
+
+    BOOST_REQUIRE_EQUAL(nextStates.size(), 3);
+    BOOST_REQUIRE_EQUAL(arma::accu(rewards), 3.0);
+    BOOST_REQUIRE_EQUAL(arma::accu(isTerminal), 0);
+    BOOST_REQUIRE(environments.FinishedReturns().empty());
+
+    // Each copy should follow the dynamics of CartPole.
+    for (size_t i = 0; i < 3; ++i)
+    {
+      CartPole task;
+      CartPole::State expected;
+      task.Sample(CartPole::State(states.col(i)), actions[i], expected);
+      CheckMatrices(nextStates[i].Encode(), expected.Encode());
+      CheckMatrices(environments.States()[i].Encode(), expected.Encode());
+    }
+  }
+
+  // The fifth step reaches the maximum number of steps of all the copies.
+  environments.Step(actions, nextStates, rewards, isTerminal);
+  BOOST_REQUIRE_EQUAL(arma::accu(isTerminal), 3);
+  BOOST_REQUIRE_EQUAL(environments.FinishedReturns().size(), 3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(environments.FinishedReturns()[i], 5.0, 1e-5);
+    BOOST_REQUIRE_EQUAL(environments.Environments()[i].StepsPerformed(), 0);
+  }
+
+  // Giving the wrong number of actions should throw.
+  actions.pop_back();
+  BOOST_REQUIRE_THROW(environments.Step(actions, nextStates, rewards,
+      isTerminal), std::invalid_argument);
+}
+
+/**
+ * Advance a batch of initial states with SampleBatch(), and make sure that
+ * each state follows the dynamics of Sample() and IsTerminal().
+ */
+template<typename EnvironmentType>
+void CheckSampleBatch(
+    EnvironmentType& task,
+    const std::vector<typename EnvironmentType::Action>& actions)
+{
+  using StateType = typename EnvironmentType::State;
+
+  std::vector<StateType> states(actions.size());
+  arma::mat batchStates(actions.size(), StateType::dimension);
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    states[i] = task.InitialSample();
+    batchStates.row(i) = states[i].Encode().t();
+  }
+
+  // The same random numbers are drawn by both (for the noise of Acrobot).
+  arma::Row<size_t> steps(actions.size(), arma::fill::zeros);
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+  math::RandomSeed(7);
+  task.SampleBatch(batchStates, actions, steps, rewards, isTerminal);
+
+  BOOST_REQUIRE_EQUAL(rewards.n_elem, actions.size());
+  BOOST_REQUIRE_EQUAL(isTerminal.n_elem, actions.size());
+  math::RandomSeed(7);
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(steps[i], 1);
+
+    StateType nextState;
+    const double reward = task.Sample(states[i], actions[i], nextState);
+    BOOST_REQUIRE_CLOSE(rewards[i] + 1.0, reward + 1.0, 1e-5);
+    BOOST_REQUIRE_EQUAL(isTerminal[i], task.IsTerminal(nextState) ? 1 : 0);
+    CheckMatrices(batchStates.row(i).t(), nextState.Encode());
+  }
+}
+
+/**
+ * SampleBatch() gives the same states and rewards as Sample() for all the
+ * environments that have it.
+ */
+BOOST_AUTO_TEST_CASE(SampleBatchTest)
+{
+  const size_t n = 20;
+
+  MountainCar mountainCar;
+  std::vector<MountainCar::Action> mountainCarActions(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    mountainCarActions[i].action =
+        (MountainCar::Action::actions) (i % MountainCar::Action::size);
+  }
+  CheckSampleBatch(mountainCar, mountainCarActions);
+
+  ContinuousMountainCar continuousMountainCar;
+  std::vector<ContinuousMountainCar::Action> continuousMountainCarActions(n);
+  for (size_t i = 0; i < n; ++i)
+    continuousMountainCarActions[i].action[0] = math::Random(-1.5, 1.5);
+  CheckSampleBatch(continuousMountainCar, continuousMountainCarActions);
+
+  Pendulum pendulum;
+  std::vector<Pendulum::Action> pendulumActions(n);
+  for (size_t i = 0; i < n; ++i)
+    pendulumActions[i].action[0] = math::Random(-3.0, 3.0);
+  CheckSampleBatch(pendulum, pendulumActions);
+
+  DoublePoleCart doublePoleCart;
+  std::vector<DoublePoleCart::Action> doublePoleCartActions(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    doublePoleCartActions[i].action =
+        (DoublePoleCart::Action::actions) (i % DoublePoleCart::Action::size);
+  }
+  CheckSampleBatch(doublePoleCart, doublePoleCartActions);
+
+  Acrobot acrobot;
+  std::vector<Acrobot::Action> acrobotActions(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    acrobotActions[i].action =
+        (Acrobot::Action::actions) (i % Acrobot::Action::size);
+  }
+  CheckSampleBatch(acrobot, acrobotActions);
+}
+
+/**
+ * The copies of an environment with SampleBatch() are advanced in a batch, and
+ * the episodes still end after the maximum number of steps.
+ */
+BOOST_AUTO_TEST_CASE(VectorEnvironmentSampleBatchTest)
+{
+  BOOST_REQUIRE(HasSampleBatch<MountainCar>::value);
+  BOOST_REQUIRE(HasSampleBatch<Acrobot>::value);
+  BOOST_REQUIRE(!HasSampleBatch<CartPole>::value);
+
+  VectorEnvironment<MountainCar> environments(4, MountainCar(5));
+  std::vector<MountainCar::Action> actions(4);
+  for (size_t i = 0; i < 4; ++i)
+    actions[i].action = MountainCar::Action::actions::forward;
+
+  std::vector<MountainCar::State> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+  for (size_t step = 0; step < 4; ++step)
+  {
+    const std::vector<MountainCar::State> states = environments.States();
+    environments.Step(actions, nextStates, rewards, isTerminal);
+
+    BOOST_REQUIRE_EQUAL(arma::accu(rewards), -4.0);
+    BOOST_REQUIRE_EQUAL(arma::accu(isTerminal), 0);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      MountainCar task;
+      MountainCar::State expected;
+      task.Sample(states[i], actions[i], expected);
+      CheckMatrices(nextStates[i].Encode(), expected.Encode());
+      CheckMatrices(environments.States()[i].Encode(), expected.Encode());
+    }
+  }
+
+  // The fifth step reaches the maximum number of steps, without reward.
+  environments.Step(actions, nextStates, rewards, isTerminal);
+  BOOST_REQUIRE_EQUAL(arma::accu(isTerminal), 4);
+  BOOST_REQUIRE_EQUAL(environments.FinishedReturns().size(), 4);
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_REQUIRE_CLOSE(environments.FinishedReturns()[i], -4.0, 1e-5);
+
+  // The new episodes start from the first step.
+  environments.Step(actions, nextStates, rewards, isTerminal);
+  BOOST_REQUIRE_EQUAL(arma::accu(isTerminal), 0);
+}
+
 /**
  * Constructs a DoublePoleCart instance and check if the main routine works as
  * it should be.
@@ -273,6 +468,96 @@ BOOST_AUTO_TEST_CASE(RandomReplayTest)
   }
 }
 
+/**
+ * Store episodes of stacked frames in a FrameReplay, and make sure that the
+ * sampled states and next states are rebuilt correctly.
+ */
+template<typename ElemType>
+void FrameReplayTest()
+{
+  // The states of CartPole are seen as two stacked frames of dimension 2, and
+  // the frame of step k of an episode is filled with base + k.
+  FrameReplay<CartPole, ElemType> replay(4, 20, 2);
+  CartPole::Action action;
+  action.action = CartPole::Action::actions::forward;
+
+  const size_t lengths[2] = { 5, 3 };
+  for (size_t e = 0; e < 2; ++e)
+  {
+    const double base = 10.0 * (e + 1);
+    arma::colvec state = { base, base, base, base };
+    for (size_t k = 0; k < lengths[e]; ++k)
+    {
+      arma::colvec nextState(4);
+      nextState.head(2) = state.tail(2);
+      nextState.tail(2).fill(base + k + 1);
+      replay.Store(CartPole::State(state), action, k, CartPole::State(
+          nextState), k == lengths[e] - 1, 0.9);
+      state = nextState;
+    }
+  }
+  BOOST_REQUIRE_EQUAL(replay.Size(), 8);
+
+  arma::mat sampledStates, sampledNextStates;
+  std::vector<CartPole::Action> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::irowvec isTerminal;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    replay.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, isTerminal);
+    BOOST_REQUIRE_EQUAL(sampledStates.n_rows, 4);
+    BOOST_REQUIRE_EQUAL(sampledActions.size(), 4);
+
+    for (size_t t = 0; t < 4; ++t)
+    {
+      // The reward is the step of the transition.
+      const double k = sampledRewards(t);
+      const double base = sampledStates(2, t) - k;
+      BOOST_REQUIRE(base == 10.0 || base == 20.0);
+      BOOST_REQUIRE_CLOSE(sampledStates(0, t), (k == 0) ? base : base + k - 1,
+          1e-5);
+      BOOST_REQUIRE_CLOSE(sampledNextStates(0, t), base + k, 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledNextStates(2, t), base + k + 1, 1e-5);
+      const bool terminal = (base == 10.0) ? (k == 4) : (k == 2);
+      BOOST_REQUIRE_EQUAL(isTerminal(t), (int) terminal);
+    }
+  }
+
+  // With a small buffer, the oldest transitions are dropped as their frames
+  // are overwritten.
+  FrameReplay<CartPole, ElemType> smallReplay(1, 5, 2);
+  arma::colvec state(4, arma::fill::zeros);
+  for (size_t k = 0; k < 10; ++k)
+  {
+    arma::colvec nextState(4);
+    nextState.head(2) = state.tail(2);
+    nextState.tail(2).fill(k + 1);
+    smallReplay.Store(CartPole::State(state), action, k,
+        CartPole::State(nextState), false, 0.9);
+    state = nextState;
+  }
+  BOOST_REQUIRE_EQUAL(smallReplay.Size(), 3);
+
+  for (size_t i = 0; i < 20; ++i)
+  {
+    smallReplay.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, isTerminal);
+    BOOST_REQUIRE_GE(sampledRewards(0), 6.0);
+    BOOST_REQUIRE_CLOSE(sampledNextStates(2, 0), sampledRewards(0) + 1, 1e-5);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(FrameReplayDoubleTest)
+{
+  FrameReplayTest<double>();
+}
+
+BOOST_AUTO_TEST_CASE(FrameReplayUCharTest)
+{
+  FrameReplayTest<unsigned char>();
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -288,4 +573,57 @@ BOOST_AUTO_TEST_CASE(GreedyPolicyTest)
   BOOST_REQUIRE_CLOSE(actionValue[action.action], actionValue.max(), 1e-5);
 }
 
+/**
+ * Make sure that concurrent Hogwild updates of shared parameters are not lost,
+ * and that reading them keeps the memory of the local copy.
+ */
+BOOST_AUTO_TEST_CASE(HogwildUpdateTest)
+{
+  arma::mat shared(10, 3, arma::fill::zeros);
+  const arma::mat step(10, 3, arma::fill::ones);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < 400; ++i)
+    HogwildUpdate(shared, step);
+
+  BOOST_REQUIRE_EQUAL(arma::accu(shared == 400.0), 30);
+
+  arma::mat local(10, 3, arma::fill::zeros);
+  const double* memory = local.memptr();
+  HogwildRead(shared, local);
+  BOOST_REQUIRE_EQUAL(local.memptr(), memory);
+  CheckMatrices(local, shared);
+}
+
+/**
+ * Make sure that the soft and hard target updates give the expected
+ * parameters and keep the memory of the target parameters.
+ */
+BOOST_AUTO_TEST_CASE(TargetUpdateTest)
+{
+  const arma::mat source(20, 5, arma::fill::randu);
+  const arma::mat original(20, 5, arma::fill::randu);
+  arma::mat target = original;
+  const double* memory = target.memptr();
+
+  SoftTargetUpdate(target, source, 0.1);
+  BOOST_REQUIRE_EQUAL(target.memptr(), memory);
+  CheckMatrices(target, 0.9 * original + 0.1 * source);
+
+  // With a rate of one, the soft update is a copy.
+  SoftTargetUpdate(target, source, 1.0);
+  CheckMatrices(target, source);
+
+  target = original;
+  HardTargetUpdate(target, source);
+  BOOST_REQUIRE_EQUAL(target.memptr(), memory);
+  CheckMatrices(target, source);
+
+  arma::mat wrongSize(10, 5);
+  BOOST_REQUIRE_THROW(HardTargetUpdate(wrongSize, source),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(SoftTargetUpdate(wrongSize, source, 0.1),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
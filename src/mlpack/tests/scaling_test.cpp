@@ -172,3 +172,75 @@ TEST_CASE("ZCAWhiteningTest", "[ScalingTest]")
   scale.InverseTransform(output, temp);
   CheckMatrices(dataset, temp);
 }
+
+/**
+ * Make sure that ScalingStatistics gives the same statistics as Armadillo, when
+ * the points are split into many blocks and chunks.
+ */
+TEST_CASE("ScalingStatisticsTest", "[ScalingTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 50000);
+  data.row(1) *= 100.0;
+  data.row(2) += 1e6;
+
+  data::ScalingStatistics statistics(true);
+  statistics.Update(data.cols(0, 12344));
+  statistics.Update(data.cols(12345, 49999));
+
+  REQUIRE(statistics.Count() == 50000);
+  CheckMatrices(statistics.Mean(), arma::mean(data, 1));
+  CheckMatrices(statistics.Min(), arma::min(data, 1));
+  CheckMatrices(statistics.Max(), arma::max(data, 1));
+  CheckMatrices(statistics.Variance(), arma::var(data, 1, 1));
+  CheckMatrices(statistics.Variance(true), arma::var(data, 0, 1));
+  CheckMatrices(statistics.Covariance(true),
+      mlpack::math::ColumnCovariance(data));
+
+  // Points with another dimensionality can't be added.
+  REQUIRE_THROWS_AS(statistics.Update(arma::mat(4, 10, arma::fill::randu)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that fitting the scalers one chunk at a time gives the same result
+ * as fitting them on the whole dataset.
+ */
+template<typename ScalerType>
+void CheckPartialFit(ScalerType full,
+                     ScalerType partial,
+                     const bool signInvariant = false)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 3000);
+  data.row(0) *= 10.0;
+  data.row(3) -= 3.0;
+
+  full.Fit(data);
+  partial.Fit(data.cols(0, 999));
+  partial.PartialFit(data.cols(1000, 2499));
+  partial.PartialFit(data.cols(2500, 2999));
+
+  arma::mat fullOutput, partialOutput;
+  full.Transform(data, fullOutput);
+  partial.Transform(data, partialOutput);
+  // The signs of the eigenvectors (and so of the PCA whitened dimensions) may
+  // differ.
+  if (signInvariant)
+    CheckMatrices(arma::abs(fullOutput), arma::abs(partialOutput));
+  else
+    CheckMatrices(fullOutput, partialOutput);
+
+  // Transforming in place gives the same result.
+  arma::mat inPlace(data);
+  full.Transform(inPlace, inPlace);
+  CheckMatrices(fullOutput, inPlace);
+}
+
+TEST_CASE("ScalerPartialFitTest", "[ScalingTest]")
+{
+  CheckPartialFit(data::MinMaxScaler(), data::MinMaxScaler());
+  CheckPartialFit(data::MaxAbsScaler(), data::MaxAbsScaler());
+  CheckPartialFit(data::StandardScaler(), data::StandardScaler());
+  CheckPartialFit(data::MeanNormalization(), data::MeanNormalization());
+  CheckPartialFit(data::PCAWhitening(), data::PCAWhitening(), true);
+  CheckPartialFit(data::ZCAWhitening(), data::ZCAWhitening());
+}
@@ -657,6 +657,33 @@ BOOST_AUTO_TEST_CASE(KNNTest)
   CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
 }
 
+BOOST_AUTO_TEST_CASE(FloatKNNTest)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      KDTree> FloatKNN;
+  arma::fmat dataset = arma::randu<arma::fmat>(5, 2000);
+
+  FloatKNN knn(dataset, DUAL_TREE_MODE);
+
+  FloatKNN knnXml, knnText, knnBinary;
+
+  SerializeObjectAll(knn, knnXml, knnText, knnBinary);
+
+  // Now run nearest neighbor and make sure the results are the same.
+  arma::fmat querySet = arma::randu<arma::fmat>(5, 1000);
+
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+
+  knn.Search(querySet, 5, neighbors, distances);
+  knnXml.Search(querySet, 5, xmlNeighbors, xmlDistances);
+  knnText.Search(querySet, 5, textNeighbors, textDistances);
+  knnBinary.Search(querySet, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTest)
 {
   using regression::SoftmaxRegression;
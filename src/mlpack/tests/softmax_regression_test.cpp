@@ -674,3 +674,53 @@ TEST_CASE("SoftmaxRegressionComputeProbabilitiesAndLabelsTest",
     REQUIRE(testLabels(i) == labels(i));
   }
 }
+
+/**
+ * Train softmax regression on a dataset streamed in chunks, and make sure that
+ * it learns the dataset.
+ */
+TEST_CASE("SoftmaxRegressionStreamingTrainTest", "[SoftmaxRegressionTest]")
+{
+  // Generate a three-Gaussian dataset, five chunks at a time.
+  GaussianDistribution g1(arma::vec("1.0 9.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("4.0 3.0 4.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g3(arma::vec("9.0 1.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  size_t chunk = 0;
+  auto generate = [&](arma::mat& x, arma::mat& y)
+  {
+    if (chunk == 5)
+      return false;
+
+    ++chunk;
+    x.set_size(3, 300);
+    y.set_size(1, 300);
+    for (size_t i = 0; i < 300; ++i)
+    {
+      y[i] = (i % 3);
+      x.col(i) = (i % 3 == 0) ? g1.Random() :
+          ((i % 3 == 1) ? g2.Random() : g3.Random());
+    }
+    return true;
+  };
+  ann::PrefetchLoader<ann::CallbackSource<> > loader(
+      ann::CallbackSource<>(generate, [&](const bool) { chunk = 0; }));
+
+  ens::StandardSGD optimizer(0.05, 10);
+  SoftmaxRegression sr(3, 3, true);
+  const double objective = sr.Train(loader, 3, optimizer, 5);
+  REQUIRE(std::isfinite(objective));
+  REQUIRE(optimizer.MaxIterations() == 100000);
+
+  arma::mat testData(3, 600);
+  arma::Row<size_t> testLabels(600);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    testLabels[i] = (i % 3);
+    testData.col(i) = (i % 3 == 0) ? g1.Random() :
+        ((i % 3 == 1) ? g2.Random() : g3.Random());
+  }
+
+  const double acc = sr.ComputeAccuracy(testData, testLabels);
+  REQUIRE(acc >= 95.0);
+}
@@ -274,3 +274,49 @@ TEST_CASE("SparseAutoencoderFunctionGradient", "[SparseAutoencoderTest]")
     }
   }
 }
+
+TEST_CASE("SparseAutoencoderFunctionBatches", "[SparseAutoencoderTest]")
+{
+  const size_t points = 1000;
+  const size_t vSize = 20;
+  const size_t hSize = 10;
+
+  arma::mat data;
+  data.randu(vSize, points);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.01, 3, 0.05);
+  const arma::mat parameters = saf.GetInitialPoint();
+  REQUIRE(saf.NumFunctions() == points);
+
+  // The objective and gradient of a batch are those of a function on the
+  // points of the batch only.
+  const size_t begin = 300, batchSize = 600;
+  arma::mat batch = data.cols(begin, begin + batchSize - 1);
+  SparseAutoencoderFunction batchSaf(batch, vSize, hSize, 0.01, 3, 0.05);
+
+  arma::mat gradient, batchGradient, fusedGradient;
+  batchSaf.Gradient(parameters, batchGradient);
+  saf.Gradient(parameters, begin, gradient, batchSize);
+  const double objective = saf.EvaluateWithGradient(parameters, begin,
+      fusedGradient, batchSize);
+
+  REQUIRE(saf.Evaluate(parameters, begin, batchSize) ==
+      Approx(batchSaf.Evaluate(parameters)).epsilon(1e-10));
+  REQUIRE(objective == Approx(batchSaf.Evaluate(parameters)).epsilon(1e-10));
+  CheckMatrices(gradient, batchGradient, 1e-8);
+  CheckMatrices(fusedGradient, batchGradient, 1e-8);
+
+  // The full objective is the objective of the batch of all points.
+  arma::mat fullGradient;
+  REQUIRE(saf.EvaluateWithGradient(parameters, fullGradient) ==
+      Approx(saf.Evaluate(parameters, 0, points)).epsilon(1e-10));
+  saf.Gradient(parameters, gradient);
+  CheckMatrices(fullGradient, gradient, 1e-8);
+
+  // An SGD-type optimizer can train the autoencoder on minibatches (shuffling
+  // the points does not change the full objective).
+  ens::StandardSGD optimizer(0.1, 10, 20 * points);
+  arma::mat coordinates = parameters;
+  optimizer.Optimize(saf, coordinates);
+  REQUIRE(saf.Evaluate(coordinates) < saf.Evaluate(parameters));
+}
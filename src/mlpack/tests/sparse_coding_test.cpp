@@ -109,6 +109,69 @@ TEST_CASE("SparseCodingTestCodingStepElasticNet", "[SparseCodingTest]")
   }
 }
 
+TEST_CASE("SparseCodingTestCodingStepOMP", "[SparseCodingTest]")
+{
+  uword nAtoms = 25;
+
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  uword nPoints = X.n_cols;
+
+  // Normalize each point since these are images.
+  for (uword i = 0; i < nPoints; ++i)
+  {
+    X.col(i) /= norm(X.col(i), 2);
+  }
+
+  SparseCoding sc(nAtoms, 0.0);
+  sc.MaxNonzeros() = 5;
+  mat Z;
+  DataDependentRandomInitializer::Initialize(X, 25, sc.Dictionary());
+  sc.Encode(X, Z);
+
+  mat D = sc.Dictionary();
+
+  // Each code has at most 5 nonzero coefficients, which solve the
+  // least-squares problem of their atoms: the residual is orthogonal to them.
+  for (uword i = 0; i < nPoints; ++i)
+  {
+    uvec support = find(Z.unsafe_col(i));
+    REQUIRE(support.n_elem <= 5);
+    REQUIRE(support.n_elem > 0);
+
+    vec errCorr = trans(D) * (D * Z.unsafe_col(i) - X.unsafe_col(i));
+    for (uword j = 0; j < support.n_elem; ++j)
+      REQUIRE(errCorr(support[j]) == Approx(0.0).margin(1e-8));
+  }
+}
+
+TEST_CASE("SparseCodingTestOMPRecovery", "[SparseCodingTest]")
+{
+  // With an orthonormal dictionary, orthogonal matching pursuit recovers codes
+  // that are sparse enough exactly.
+  mat Q, R;
+  qr_econ(Q, R, randn<mat>(40, 20));
+
+  mat codes(20, 100, fill::zeros);
+  for (uword i = 0; i < codes.n_cols; ++i)
+  {
+    uvec atoms = randperm(20, 3);
+    codes.submat(atoms, uvec({ i })) = 1.0 + randu<vec>(3);
+  }
+  mat X = Q * codes;
+
+  SparseCoding sc(20, 0.0);
+  sc.Dictionary() = Q;
+  sc.MaxNonzeros() = 3;
+  mat Z;
+  sc.Encode(X, Z);
+
+  REQUIRE(Z.n_rows == 20);
+  REQUIRE(Z.n_cols == 100);
+  for (uword i = 0; i < Z.n_elem; ++i)
+    REQUIRE(Z[i] == Approx(codes[i]).margin(1e-8));
+}
+
 TEST_CASE("SparseCodingTestDictionaryStep", "[SparseCodingTest]")
 {
   const double tol = 1e-6;
@@ -212,3 +212,54 @@ TEST_CASE("SplitLabeledDataLargerTest", "[SplitDataTest]")
 
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
+
+/**
+ * Make sure SplitIndices() gives the same split as Split() with the same seed.
+ */
+TEST_CASE("SplitIndicesTest", "[SplitDataTest]")
+{
+  mat input(3, 97, arma::fill::randu);
+
+  mlpack::math::RandomSeed(7);
+  mat trainData, testData;
+  Split(input, trainData, testData, 0.25);
+
+  mlpack::math::RandomSeed(7);
+  arma::uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, 0.25);
+
+  REQUIRE(trainIndices.n_elem == 97 - size_t(0.25 * 97));
+  REQUIRE(testIndices.n_elem == size_t(0.25 * 97));
+  CheckMatrices(trainData, input.cols(trainIndices));
+  CheckMatrices(testData, input.cols(testIndices));
+
+  // Without shuffling, the indices are in order.
+  SplitIndices(input.n_cols, trainIndices, testIndices, 0.25, false);
+  for (size_t i = 0; i < trainIndices.n_elem; ++i)
+    REQUIRE(trainIndices[i] == i);
+  for (size_t i = 0; i < testIndices.n_elem; ++i)
+    REQUIRE(testIndices[i] == trainIndices.n_elem + i);
+}
+
+/**
+ * Make sure SplitInPlace() keeps each point with its label.
+ */
+TEST_CASE("SplitInPlaceTest", "[SplitDataTest]")
+{
+  const mat input(10, 497, arma::fill::randu);
+  const Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  mat data(input);
+  Row<size_t> dataLabels(labels);
+  const size_t trainSize = SplitInPlace(data, dataLabels, 0.3);
+  REQUIRE(trainSize == 497 - size_t(0.3 * 497));
+  REQUIRE(data.n_cols == 497);
+
+  CompareData(input, data.cols(0, trainSize - 1),
+      dataLabels.subvec(0, trainSize - 1));
+  CompareData(input, data.cols(trainSize, data.n_cols - 1),
+      dataLabels.subvec(trainSize, data.n_cols - 1));
+  CheckDuplication(dataLabels.subvec(0, trainSize - 1),
+      dataLabels.subvec(trainSize, data.n_cols - 1));
+}
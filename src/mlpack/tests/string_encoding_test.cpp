@@ -18,6 +18,7 @@
 #include <mlpack/core/data/string_encoding_policies/dictionary_encoding_policy.hpp>
 #include <mlpack/core/data/string_encoding_policies/bag_of_words_encoding_policy.hpp>
 #include <mlpack/core/data/string_encoding_policies/tf_idf_encoding_policy.hpp>
+#include <mlpack/core/data/string_encoding_policies/hashing_encoding_policy.hpp>
 #include <boost/test/unit_test.hpp>
 #include <memory>
 #include "test_tools.hpp"
@@ -541,6 +542,121 @@ BOOST_AUTO_TEST_CASE(CharExtractDictionaryEncodingSerialization)
   CheckMatrices(output, xmlOutput, textOutput, binaryOutput);
 }
 
+/**
+ * Test that the labels don't depend on the way the strings are split between
+ * the threads, by comparing to a dictionary built one string at a time.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDictionaryEncodingTest)
+{
+  using DictionaryType = StringEncodingDictionary<boost::string_view>;
+
+  // Make a corpus big enough to be split over several threads, with tokens
+  // that first appear in all the parts of the corpus.
+  vector<string> input(1000);
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    const size_t numTokens = math::RandInt(1, 30);
+    for (size_t j = 0; j < numTokens; ++j)
+      input[i] += "token" + std::to_string(math::RandInt(3 * i + 10)) + " ";
+  }
+
+  SplitByAnyOf tokenizer(" ");
+  DictionaryEncoding<SplitByAnyOf::TokenType> encoder;
+  arma::mat output;
+  encoder.Encode(input, output, tokenizer);
+
+  DictionaryEncoding<SplitByAnyOf::TokenType> expectedEncoder;
+  for (size_t i = 0; i < input.size(); ++i)
+    expectedEncoder.CreateMap(input[i], tokenizer);
+
+  const DictionaryType& expected = expectedEncoder.Dictionary();
+  CheckDictionaries(expected, encoder.Dictionary());
+
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    boost::string_view strView(input[i]);
+    boost::string_view token = tokenizer(strView);
+    size_t j = 0;
+    while (!tokenizer.IsTokenEmpty(token))
+    {
+      BOOST_REQUIRE_EQUAL((size_t) output(j, i), expected.Value(token));
+      token = tokenizer(strView);
+      ++j;
+    }
+
+    // The rest of the column is padded with zeros.
+    for (; j < output.n_rows; ++j)
+      BOOST_REQUIRE_EQUAL(output(j, i), 0.0);
+  }
+
+  // The one pass encoding must give the same labels.
+  DictionaryEncoding<SplitByAnyOf::TokenType> onePassEncoder;
+  vector<vector<size_t>> onePassOutput;
+  onePassEncoder.Encode(input, onePassOutput, tokenizer);
+
+  CheckDictionaries(expected, onePassEncoder.Dictionary());
+  BOOST_REQUIRE_EQUAL(onePassOutput.size(), input.size());
+  for (size_t i = 0; i < input.size(); ++i)
+    for (size_t j = 0; j < onePassOutput[i].size(); ++j)
+      BOOST_REQUIRE_EQUAL(onePassOutput[i][j], (size_t) output(j, i));
+}
+
+/**
+ * Test that the views of the tokens of the string_view dictionary match the
+ * strings given by Tokens(), also after new tokens are added.
+ */
+BOOST_AUTO_TEST_CASE(DictionaryTokenViewsTest)
+{
+  StringEncodingDictionary<boost::string_view> dictionary;
+  dictionary.AddToken("first");
+  dictionary.AddToken("second");
+  BOOST_REQUIRE_EQUAL(dictionary.Tokens().size(), 2);
+
+  dictionary.AddToken("third");
+
+  const std::deque<std::string>& tokens = dictionary.Tokens();
+  const std::deque<boost::string_view>& views = dictionary.TokenViews();
+  BOOST_REQUIRE_EQUAL(tokens.size(), 3);
+  BOOST_REQUIRE_EQUAL(views.size(), 3);
+  for (size_t i = 0; i < tokens.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(views[i], boost::string_view(tokens[i]));
+    BOOST_REQUIRE_EQUAL(dictionary.Value(views[i]), i + 1);
+  }
+
+  dictionary.Clear();
+  BOOST_REQUIRE_EQUAL(dictionary.Tokens().size(), 0);
+  BOOST_REQUIRE_EQUAL(dictionary.TokenViews().size(), 0);
+}
+
+/**
+ * Test that the strings of a StringArena are stored correctly, in the blocks
+ * of the arena or in blocks of their own, and survive moving the arena.
+ */
+BOOST_AUTO_TEST_CASE(StringArenaTest)
+{
+  StringArena arena(16);
+
+  vector<string> strings;
+  vector<boost::string_view> views;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    strings.push_back(string(i % 40 + 1, (char) ('a' + i % 26)));
+    views.push_back(arena.Add(strings.back()));
+  }
+
+  // Strings of up to 16 characters share blocks.
+  BOOST_REQUIRE_LT(arena.NumBlocks(), strings.size());
+
+  StringArena movedArena(std::move(arena));
+  BOOST_REQUIRE_EQUAL(arena.NumBlocks(), 0);
+  for (size_t i = 0; i < strings.size(); ++i)
+    BOOST_REQUIRE_EQUAL(views[i], boost::string_view(strings[i]));
+
+  movedArena.Clear();
+  BOOST_REQUIRE_EQUAL(movedArena.NumBlocks(), 0);
+}
+
 /**
  * Test the Bag of Words encoding algorithm.
  */ 
@@ -1425,5 +1541,129 @@ BOOST_AUTO_TEST_CASE(SplitByAnyOfTfIdfEncodingSerialization)
   CheckMatrices(output, xmlOutput, textOutput, binaryOutput);
 }
 
+/**
+ * Test that unsigned feature hashing gives the bag of words encoding, up to a
+ * permutation of the rows, when there are no collisions.
+ */
+BOOST_AUTO_TEST_CASE(HashingEncodingTest)
+{
+  using DictionaryType = StringEncodingDictionary<boost::string_view>;
+
+  SplitByAnyOf tokenizer(" ,.\"");
+
+  arma::mat bowOutput;
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> bowEncoder;
+  bowEncoder.Encode(stringEncodingInput, bowOutput, tokenizer);
+  const DictionaryType& dictionary = bowEncoder.Dictionary();
+
+  HashingEncoding<SplitByAnyOf::TokenType> encoder(1 << 20, false);
+  arma::sp_mat output;
+  encoder.Encode(stringEncodingInput, output, tokenizer);
+
+  // No dictionary is built.
+  BOOST_REQUIRE_EQUAL(encoder.Dictionary().Size(), 0);
+  BOOST_REQUIRE_EQUAL(output.n_rows, 1 << 20);
+  BOOST_REQUIRE_EQUAL(output.n_cols, stringEncodingInput.size());
+
+  // Each token of the dictionary must have the same counts as in the bag of
+  // words encoding, in the row given by its hash.
+  size_t row;
+  double value;
+  for (const auto& keyValue : dictionary.Mapping())
+  {
+    encoder.EncodingPolicy().Encode(keyValue.first, row, value);
+    BOOST_REQUIRE_EQUAL(value, 1.0);
+    for (size_t i = 0; i < output.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(output(row, i), bowOutput(keyValue.second - 1, i),
+          1e-5);
+    }
+  }
+
+  // The total counts must match too, so there are no other entries.
+  const arma::rowvec counts = arma::sum(bowOutput, 0);
+  for (size_t i = 0; i < output.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(arma::accu(output.col(i)), counts[i], 1e-5);
+}
+
+/**
+ * Test that the sparse and dense outputs of feature hashing are the same, with
+ * signed hashing and many collisions.
+ */
+BOOST_AUTO_TEST_CASE(HashingEncodingSignedDenseSparseTest)
+{
+  // Repeat the input, so that it is encoded over several threads.
+  vector<string> input;
+  for (size_t i = 0; i < 100; ++i)
+    input.insert(input.end(), stringEncodingInput.begin(),
+        stringEncodingInput.end());
+
+  SplitByAnyOf tokenizer(" ,.\"");
+  HashingEncoding<SplitByAnyOf::TokenType> encoder(16, true, 42);
+
+  arma::mat denseOutput;
+  arma::sp_mat sparseOutput;
+  encoder.Encode(input, denseOutput, tokenizer);
+  encoder.Encode(input, sparseOutput, tokenizer);
+
+  BOOST_REQUIRE_EQUAL(denseOutput.n_rows, 16);
+  BOOST_REQUIRE_EQUAL(sparseOutput.n_rows, 16);
+  CheckMatrices(denseOutput, arma::mat(sparseOutput));
+
+  // The repeated strings must be encoded the same way.
+  for (size_t i = 3; i < input.size(); ++i)
+  {
+    CheckMatrices(arma::mat(denseOutput.col(i)),
+        arma::mat(denseOutput.col(i % 3)));
+  }
+
+  // Signed hashing gives some negative values.
+  BOOST_REQUIRE_LT(denseOutput.min(), 0.0);
+}
+
+/**
+ * Test feature hashing of individual characters.
+ */
+BOOST_AUTO_TEST_CASE(HashingEncodingIndividualCharactersTest)
+{
+  vector<string> input = { "abc", "aaabbbccc", "cab" };
+
+  HashingEncoding<CharExtract::TokenType> encoder(1 << 16, false);
+  arma::sp_mat output;
+  encoder.Encode(input, output, CharExtract());
+
+  CheckMatrices(3 * arma::mat(output.col(0)), arma::mat(output.col(1)));
+  CheckMatrices(arma::mat(output.col(0)), arma::mat(output.col(2)));
+  BOOST_REQUIRE_EQUAL(output.n_nonzero, 9);
+}
+
+/**
+ * Test that the hashing encoding policy is serialized.
+ */
+BOOST_AUTO_TEST_CASE(HashingEncodingSerialization)
+{
+  using EncoderType = HashingEncoding<SplitByAnyOf::TokenType>;
+
+  EncoderType encoder(1000, true, 7);
+  SplitByAnyOf tokenizer(" ,.\"");
+  arma::mat output;
+
+  encoder.Encode(stringEncodingInput, output, tokenizer);
+
+  EncoderType xmlEncoder, textEncoder, binaryEncoder;
+  arma::mat xmlOutput, textOutput, binaryOutput;
+
+  SerializeObjectAll(encoder, xmlEncoder, textEncoder, binaryEncoder);
+
+  BOOST_REQUIRE_EQUAL(xmlEncoder.EncodingPolicy().NumFeatures(), 1000);
+  BOOST_REQUIRE_EQUAL(textEncoder.EncodingPolicy().Seed(), 7);
+
+  xmlEncoder.Encode(stringEncodingInput, xmlOutput, tokenizer);
+  textEncoder.Encode(stringEncodingInput, textOutput, tokenizer);
+  binaryEncoder.Encode(stringEncodingInput, binaryOutput, tokenizer);
+
+  CheckMatrices(output, xmlOutput, textOutput, binaryOutput);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
@@ -91,4 +91,65 @@ BOOST_AUTO_TEST_CASE(BatchUpdate)
   BOOST_CHECK_EQUAL(sumtree.FindPrefixSum(3.0), 3);
 }
 
+/**
+ * Compare the sums and the prefix sum searches of a large tree with the given
+ * fanout against a direct computation, after single and batched updates.
+ */
+template<size_t Fanout>
+void SumTreeFanoutTest()
+{
+  const size_t capacity = 1000;
+  SumTree<double, Fanout> sumtree(capacity);
+  arma::colvec data = arma::randu<arma::colvec>(capacity);
+  for (size_t i = 0; i < capacity; ++i)
+    sumtree.Set(i, data[i]);
+
+  // Change some of the data, with repeated indices.
+  arma::ucolvec indices = arma::randi<arma::ucolvec>(300,
+      arma::distr_param(0, capacity - 1));
+  arma::colvec values = arma::randu<arma::colvec>(300);
+  sumtree.BatchUpdate(indices, values);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    data[indices[i]] = values[i];
+
+  BOOST_REQUIRE_CLOSE(sumtree.Sum(), arma::accu(data), 1e-8);
+  for (size_t trial = 0; trial < 50; ++trial)
+  {
+    const size_t start = math::RandInt(capacity);
+    const size_t end = start + 1 + math::RandInt(capacity - start);
+    BOOST_REQUIRE_CLOSE(sumtree.Sum(start, end),
+        arma::accu(data.subvec(start, end - 1)), 1e-6);
+  }
+
+  const arma::colvec cumulative = arma::cumsum(data);
+  const arma::colvec masses = arma::randu<arma::colvec>(200) * arma::accu(data);
+  const arma::ucolvec found = sumtree.BatchFindPrefixSum(masses);
+  for (size_t i = 0; i < masses.n_elem; ++i)
+  {
+    const size_t expected = arma::as_scalar(arma::find(cumulative > masses[i],
+        1));
+    BOOST_REQUIRE_EQUAL(sumtree.FindPrefixSum(masses[i]), expected);
+    BOOST_REQUIRE_EQUAL(found[i], expected);
+  }
+
+  // Masses past the total give the last index.
+  BOOST_REQUIRE_EQUAL(sumtree.FindPrefixSum(2 * arma::accu(data)),
+      capacity - 1);
+}
+
+BOOST_AUTO_TEST_CASE(SumTreeFanoutTwoTest)
+{
+  SumTreeFanoutTest<2>();
+}
+
+BOOST_AUTO_TEST_CASE(SumTreeFanoutFourTest)
+{
+  SumTreeFanoutTest<4>();
+}
+
+BOOST_AUTO_TEST_CASE(SumTreeFanoutEightTest)
+{
+  SumTreeFanoutTest<8>();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
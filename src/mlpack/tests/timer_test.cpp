@@ -147,4 +147,149 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * Make sure the number of runs, the minimum and maximum, and the percentiles of
+ * a timer are right.
+ */
+BOOST_AUTO_TEST_CASE(TimerStatsTest)
+{
+  TimerStats stats;
+  uint64_t state = 1;
+  for (size_t i = 1; i <= 100; ++i)
+    stats.Add(std::chrono::microseconds(i), state);
+
+  BOOST_REQUIRE_EQUAL(stats.count, 100);
+  BOOST_REQUIRE_EQUAL(stats.total.count(), 5050);
+  BOOST_REQUIRE_EQUAL(stats.min.count(), 1);
+  BOOST_REQUIRE_EQUAL(stats.max.count(), 100);
+  BOOST_REQUIRE_EQUAL(stats.Percentile(50).count(), 50);
+  BOOST_REQUIRE_EQUAL(stats.Percentile(90).count(), 90);
+  BOOST_REQUIRE_EQUAL(stats.Percentile(100).count(), 100);
+
+  // Runs beyond the size of the sample still count.
+  for (size_t i = 0; i < 2 * TimerStats::MaxSamples; ++i)
+    stats.Add(std::chrono::microseconds(1000), state);
+
+  BOOST_REQUIRE_EQUAL(stats.count, 100 + 2 * TimerStats::MaxSamples);
+  BOOST_REQUIRE_EQUAL(stats.samples.size(), TimerStats::MaxSamples);
+  BOOST_REQUIRE_EQUAL(stats.max.count(), 1000);
+  BOOST_REQUIRE_EQUAL(stats.Percentile(99).count(), 1000);
+}
+
+/**
+ * Timers started while others are running should be counted under their path,
+ * and exported to JSON and to the trace event format.
+ */
+BOOST_AUTO_TEST_CASE(HierarchicalTimerTest)
+{
+  Timers timers;
+  timers.Enabled() = true;
+  timers.Tracing() = true;
+  const std::thread::id id = std::this_thread::get_id();
+
+  timers.StartTimer("outer", id);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    timers.StartTimer("inner", id);
+    timers.StopTimer("inner", id);
+  }
+  timers.StopTimer("outer", id);
+  timers.StartTimer("inner", id);
+  timers.StopTimer("inner", id);
+
+  BOOST_REQUIRE_EQUAL(timers.GetStats("inner").count, 4);
+  BOOST_REQUIRE_EQUAL(timers.GetStats("outer").count, 1);
+
+  std::map<std::string, TimerStats> paths = timers.GetPathStats();
+  BOOST_REQUIRE_EQUAL(paths.size(), 3);
+  BOOST_REQUIRE_EQUAL(paths["outer"].count, 1);
+  BOOST_REQUIRE_EQUAL(paths["outer/inner"].count, 3);
+  BOOST_REQUIRE_EQUAL(paths["inner"].count, 1);
+
+  std::ostringstream json;
+  timers.WriteJSON(json);
+  BOOST_REQUIRE_NE(json.str().find("\"outer/inner\": {\"total\": "),
+      std::string::npos);
+  BOOST_REQUIRE_NE(json.str().find("\"count\": 4"), std::string::npos);
+
+  std::ostringstream trace;
+  timers.WriteTrace(trace);
+  size_t events = 0;
+  for (size_t pos = trace.str().find("\"ph\": \"X\""); pos != std::string::npos;
+       pos = trace.str().find("\"ph\": \"X\"", pos + 1))
+    ++events;
+  BOOST_REQUIRE_EQUAL(events, 5);
+}
+
+/**
+ * A scoped timer should be stopped when it goes out of scope.
+ */
+BOOST_AUTO_TEST_CASE(ScopedTimerTest)
+{
+  Timer::EnableTiming();
+  {
+    ScopedTimer t("scoped_timer");
+    BOOST_REQUIRE(IO::GetSingleton().timer.GetState("scoped_timer",
+        std::this_thread::get_id()));
+  }
+  BOOST_REQUIRE(!IO::GetSingleton().timer.GetState("scoped_timer",
+      std::this_thread::get_id()));
+  BOOST_REQUIRE_EQUAL(IO::GetSingleton().timer.GetStats("scoped_timer").count,
+      1);
+  Timer::DisableTiming();
+}
+
+/**
+ * The memory tracker should count the bytes in use and the peak of each scope;
+ * if memory tracking is enabled, the timers should report the memory allocated
+ * by Armadillo during their runs.
+ */
+BOOST_AUTO_TEST_CASE(MemoryTrackerTest)
+{
+  const size_t start = MemoryTracker::Current();
+  const size_t outer = MemoryTracker::BeginScope();
+  void* memory = MemoryTracker::Allocate(4000);
+  BOOST_REQUIRE(memory != NULL);
+  BOOST_REQUIRE_EQUAL(MemoryTracker::Current(), start + 4000);
+
+  const size_t inner = MemoryTracker::BeginScope();
+  BOOST_REQUIRE_NE(inner, outer);
+  MemoryTracker::Record(100);
+  MemoryTracker::Free(memory);
+  MemoryTracker::Release(100);
+  BOOST_REQUIRE_EQUAL(MemoryTracker::Current(), start);
+  BOOST_REQUIRE_EQUAL(MemoryTracker::EndScope(inner), start + 4100);
+
+  // The slot of the inner scope is reused.
+  BOOST_REQUIRE_EQUAL(MemoryTracker::BeginScope(), inner);
+  BOOST_REQUIRE_EQUAL(MemoryTracker::EndScope(inner), start);
+  BOOST_REQUIRE_EQUAL(MemoryTracker::EndScope(outer), start + 4100);
+  BOOST_REQUIRE_GE(MemoryTracker::Peak(), start + 4100);
+
+#ifdef MLPACK_TRACK_MEMORY
+  Timers timers;
+  timers.Enabled() = true;
+  const std::thread::id id = std::this_thread::get_id();
+
+  arma::mat kept;
+  timers.StartTimer("allocate", id);
+  {
+    arma::mat temporary(1000, 100, arma::fill::ones);
+    kept.zeros(100, 100);
+  }
+  timers.StopTimer("allocate", id);
+
+  const TimerStats stats = timers.GetStats("allocate");
+  BOOST_REQUIRE_GE(stats.peakBytes, MemoryTracker::Current() + 800000);
+  BOOST_REQUIRE_EQUAL(stats.retainedBytes, 80000);
+
+  std::ostringstream json;
+  timers.WriteJSON(json);
+  BOOST_REQUIRE_NE(json.str().find("\"retained_bytes\": 80000"),
+      std::string::npos);
+  BOOST_REQUIRE_NE(json.str().find("\"memory\": {\"current_bytes\": "),
+      std::string::npos);
+#endif
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,6 +15,7 @@
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/tree_cache.hpp>
 
 #include <queue>
 #include <stack>
@@ -2169,6 +2170,310 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeCopyConstructor)
   delete &b.Right()->Dataset();
 }
 
+//! Make sure that the two given subtrees are the same, and (if compact is true)
+//! that the nodes of the second are laid out in depth-first order.
+template<typename TreeType>
+void CheckCompactNode(const TreeType& node,
+                      const TreeType& compactNode,
+                      const bool compact = true)
+{
+  BOOST_REQUIRE_EQUAL(node.Begin(), compactNode.Begin());
+  BOOST_REQUIRE_EQUAL(node.Count(), compactNode.Count());
+  BOOST_REQUIRE_EQUAL(node.NumChildren(), compactNode.NumChildren());
+  BOOST_REQUIRE_CLOSE(node.FurthestDescendantDistance(),
+      compactNode.FurthestDescendantDistance(), 1e-5);
+  for (size_t d = 0; d < node.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Lo(), compactNode.Bound()[d].Lo());
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Hi(), compactNode.Bound()[d].Hi());
+  }
+
+  if (compactNode.NumChildren() == 0)
+    return;
+
+  BOOST_REQUIRE_EQUAL(compactNode.Left()->Parent(), &compactNode);
+  BOOST_REQUIRE_EQUAL(compactNode.Right()->Parent(), &compactNode);
+  BOOST_REQUIRE_EQUAL(&compactNode.Left()->Dataset(), &compactNode.Dataset());
+
+  // The left child directly follows its parent in depth-first order.
+  if (compact && compactNode.Parent() != NULL)
+    BOOST_REQUIRE_EQUAL(compactNode.Left(), &compactNode + 1);
+
+  CheckCompactNode(*node.Left(), *compactNode.Left(), compact);
+  CheckCompactNode(*node.Right(), *compactNode.Right(), compact);
+}
+
+/**
+ * Make sure that compacting a binary space tree keeps the tree the same, and
+ * that a compacted tree can be moved and destroyed.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeCompactTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 1000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data, 10);
+
+  TreeType compactTree(tree);
+  BOOST_REQUIRE(!compactTree.IsCompact());
+  compactTree.Compact();
+  BOOST_REQUIRE(compactTree.IsCompact());
+  CheckCompactNode(tree, compactTree);
+
+  // Compacting again does nothing.
+  compactTree.Compact();
+  CheckCompactNode(tree, compactTree);
+
+  // Only the root can be compacted.
+  BOOST_REQUIRE_THROW(compactTree.Left()->Compact(), std::invalid_argument);
+
+  // The block of nodes moves with the root.
+  TreeType movedTree(std::move(compactTree));
+  BOOST_REQUIRE(movedTree.IsCompact());
+  BOOST_REQUIRE(!compactTree.IsCompact());
+  CheckCompactNode(tree, movedTree);
+
+  // A copy of a compacted tree is a regular tree.
+  TreeType copiedTree(movedTree);
+  BOOST_REQUIRE(!copiedTree.IsCompact());
+  CheckCompactNode(tree, copiedTree, false);
+
+  copiedTree = std::move(movedTree);
+  BOOST_REQUIRE(copiedTree.IsCompact());
+  CheckCompactNode(tree, copiedTree);
+}
+
+//! Check that the children of each node split its points between them.
+template<typename TreeType>
+void CheckChildRanges(const TreeType& node)
+{
+  if (node.NumChildren() == 0)
+    return;
+
+  BOOST_REQUIRE_EQUAL(node.Left()->Begin(), node.Begin());
+  BOOST_REQUIRE_EQUAL(node.Right()->Begin(),
+      node.Left()->Begin() + node.Left()->Count());
+  BOOST_REQUIRE_EQUAL(node.Left()->Count() + node.Right()->Count(),
+      node.Count());
+
+  CheckChildRanges(*node.Left());
+  CheckChildRanges(*node.Right());
+}
+
+/**
+ * Build a tree that is large enough to be built in parallel, and make sure it
+ * is valid, that it is the serial tree when built with one thread, and that it
+ * does not depend on the number of threads otherwise.
+ */
+template<typename TreeType>
+void CheckParallelBuild()
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200000);
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew);
+
+  BOOST_REQUIRE_EQUAL(tree.Count(), dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+      BOOST_REQUIRE_EQUAL(tree.Dataset()(j, i), dataset(j, oldFromNew[i]));
+  }
+
+  BOOST_REQUIRE(CheckPointBounds(tree));
+  CheckChildRanges(tree);
+
+#ifdef HAS_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  std::vector<size_t> serialOldFromNew;
+  TreeType serialTree(dataset, serialOldFromNew);
+  omp_set_num_threads(2);
+  std::vector<size_t> twoThreadOldFromNew;
+  TreeType twoThreadTree(dataset, twoThreadOldFromNew);
+  omp_set_num_threads(threads);
+
+  BOOST_REQUIRE(CheckPointBounds(serialTree));
+  CheckChildRanges(serialTree);
+  BOOST_REQUIRE_EQUAL(twoThreadTree.NumDescendants(), tree.NumDescendants());
+  if (threads > 1)
+    BOOST_REQUIRE(twoThreadOldFromNew == oldFromNew);
+  else
+    BOOST_REQUIRE(serialOldFromNew == oldFromNew);
+#endif
+}
+
+/**
+ * Make sure that ParallelPerformSplit() keeps the order of PerformSplit() when
+ * it is not called in a parallel region.
+ */
+BOOST_AUTO_TEST_CASE(ParallelPerformSplitSerialOrderTest)
+{
+  typedef MidpointSplit<HRectBound<EuclideanDistance>, arma::mat> SplitType;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 100000);
+  SplitType::SplitInfo splitInfo;
+  splitInfo.splitDimension = 1;
+  splitInfo.splitVal = 0.4;
+
+  arma::mat serialData(dataset);
+  std::vector<size_t> serialOldFromNew(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    serialOldFromNew[i] = i;
+  std::vector<size_t> oldFromNew(serialOldFromNew);
+
+  const size_t serialSplitCol = split::PerformSplit<arma::mat, SplitType>(
+      serialData, 0, serialData.n_cols, splitInfo, serialOldFromNew);
+  const size_t splitCol = split::ParallelPerformSplit<arma::mat, SplitType>(
+      dataset, 0, dataset.n_cols, splitInfo, oldFromNew);
+
+  BOOST_REQUIRE_EQUAL(splitCol, serialSplitCol);
+  BOOST_REQUIRE(oldFromNew == serialOldFromNew);
+  CheckMatrices(dataset, serialData);
+}
+
+/**
+ * Make sure that large kd-trees (which are built in parallel, with the
+ * partition of the largest nodes done block by block) are valid.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKDTreeBuildTest)
+{
+  CheckParallelBuild<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckParallelBuild<MeanSplitKDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>();
+  CheckParallelBuild<BallTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+}
+
+//! Check that no leaf under this node holds more than maxLeafSize points.
+template<typename TreeType>
+void CheckLeafSizes(const TreeType& node, const size_t maxLeafSize)
+{
+  if (node.IsLeaf())
+    BOOST_REQUIRE_LE(node.Count(), maxLeafSize);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    CheckLeafSizes(node.Child(i), maxLeafSize);
+}
+
+/**
+ * Insert points into a tree and remove points from it, and make sure that the
+ * tree and the mapping stay valid.
+ */
+template<typename TreeType>
+void CheckInsertDelete()
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat newPoints = arma::randu<arma::mat>(3, 600);
+  // Some of the new points lie outside of the bounds of the tree.
+  newPoints.cols(0, 99) *= 2;
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew, 10);
+
+  tree.Insert(newPoints, oldFromNew, 10);
+  const arma::mat insertedDataset = arma::join_rows(dataset, newPoints);
+
+  BOOST_REQUIRE_EQUAL(tree.Count(), 1600);
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), 1600);
+  for (size_t i = 0; i < tree.Count(); ++i)
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_EQUAL(tree.Dataset()(j, i),
+          insertedDataset(j, oldFromNew[i]));
+
+  BOOST_REQUIRE(CheckPointBounds(tree));
+  CheckChildRanges(tree);
+  CheckLeafSizes(tree, 10);
+
+  // Remove the points in every second column of the dataset of the tree.
+  std::vector<size_t> removed;
+  std::vector<bool> removedOld(1600, false);
+  for (size_t i = 0; i < 1600; i += 2)
+  {
+    removed.push_back(i);
+    removedOld[oldFromNew[i]] = true;
+  }
+
+  std::vector<arma::uword> kept;
+  for (size_t i = 0; i < 1600; ++i)
+    if (!removedOld[i])
+      kept.push_back(i);
+  const arma::mat remainingDataset = insertedDataset.cols(arma::uvec(kept));
+
+  tree.Delete(removed, oldFromNew, 10);
+
+  BOOST_REQUIRE_EQUAL(tree.Count(), 800);
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), 800);
+  for (size_t i = 0; i < tree.Count(); ++i)
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_EQUAL(tree.Dataset()(j, i),
+          remainingDataset(j, oldFromNew[i]));
+
+  BOOST_REQUIRE(CheckPointBounds(tree));
+  CheckChildRanges(tree);
+  CheckLeafSizes(tree, 10);
+
+  // Only the root can be modified.
+  BOOST_REQUIRE_THROW(tree.Left()->Insert(newPoints), std::invalid_argument);
+  BOOST_REQUIRE_THROW(tree.Delete(std::vector<size_t>(1, 800)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that points can be inserted into and removed from binary space
+ * trees.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeInsertDeleteTest)
+{
+  CheckInsertDelete<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckInsertDelete<BallTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckInsertDelete<VPTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckInsertDelete<UBTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+}
+
+/**
+ * Move some points of the dataset of a tree, refit the tree, and make sure that
+ * the bounds hold the points again while the structure is kept.
+ */
+template<typename TreeType>
+void CheckRefit()
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  TreeType tree(dataset, 10);
+  const size_t numDescendants = tree.NumDescendants();
+  const size_t leftCount = tree.Left()->Count();
+
+  // Move some points, some of them outside of the bounds of the tree.
+  std::vector<size_t> moved;
+  for (size_t i = 0; i < 1000; i += 7)
+  {
+    tree.Dataset().col(i) = 2 * arma::randu<arma::vec>(3) - 0.5;
+    moved.push_back(i);
+  }
+
+  tree.Refit(moved);
+
+  BOOST_REQUIRE(CheckPointBounds(tree));
+  CheckChildRanges(tree);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), numDescendants);
+  BOOST_REQUIRE_EQUAL(tree.Left()->Count(), leftCount);
+  BOOST_REQUIRE_CLOSE(tree.FurthestDescendantDistance(),
+      0.5 * tree.Bound().Diameter(), 1e-5);
+
+  // Only the root can be refit.
+  BOOST_REQUIRE_THROW(tree.Left()->Refit(moved), std::invalid_argument);
+  BOOST_REQUIRE_THROW(tree.Refit(std::vector<size_t>(1, 1000)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that binary space trees can be refit after their points moved.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeRefitTest)
+{
+  CheckRefit<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckRefit<BallTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckRefit<VPTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckRefit<UBTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+}
+
 //! Count the number of leaves under this node.
 template<typename TreeType>
 size_t NumLeaves(TreeType* node)
@@ -2285,4 +2590,85 @@ BOOST_AUTO_TEST_CASE(CoverTreeDescendantTest)
   CheckDescendants(&tree);
 }
 
+/**
+ * A statistic holding the number of descendants of the node, to check that the
+ * statistics of the trees of a TreeCache are computed.
+ */
+class CountStatistic
+{
+ public:
+  CountStatistic() : numDescendants(0) { }
+
+  template<typename TreeType>
+  CountStatistic(TreeType& node) : numDescendants(node.NumDescendants()) { }
+
+  size_t NumDescendants() const { return numDescendants; }
+
+ private:
+  size_t numDescendants;
+};
+
+/**
+ * Make sure that a TreeCache builds the structure of a kd-tree once, and that
+ * the trees with other statistic types are copies of it.
+ */
+BOOST_AUTO_TEST_CASE(TreeCacheTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> EmptyTree;
+  typedef KDTree<EuclideanDistance, CountStatistic, arma::mat> OtherTree;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  TreeCache cache;
+  std::vector<size_t> oldFromNew1, oldFromNew2;
+
+  std::shared_ptr<OtherTree> tree = cache.Get<OtherTree>(dataset, oldFromNew1,
+      10);
+  std::shared_ptr<EmptyTree> emptyTree = cache.Get<EmptyTree>(dataset,
+      oldFromNew2, 10);
+  BOOST_REQUIRE_EQUAL(cache.Size(), 1);
+  BOOST_REQUIRE(cache.Get<OtherTree>(dataset, oldFromNew2, 10) == tree);
+
+  // The trees have the same structure and the same mapping.
+  BOOST_REQUIRE(oldFromNew1 == oldFromNew2);
+  std::stack<OtherTree*> nodes;
+  std::stack<EmptyTree*> emptyNodes;
+  nodes.push(tree.get());
+  emptyNodes.push(emptyTree.get());
+  while (!nodes.empty())
+  {
+    OtherTree* node = nodes.top();
+    EmptyTree* emptyNode = emptyNodes.top();
+    nodes.pop();
+    emptyNodes.pop();
+
+    BOOST_REQUIRE_EQUAL(node->Begin(), emptyNode->Begin());
+    BOOST_REQUIRE_EQUAL(node->Count(), emptyNode->Count());
+    BOOST_REQUIRE_EQUAL(node->NumChildren(), emptyNode->NumChildren());
+    BOOST_REQUIRE(&node->Dataset() == &tree->Dataset());
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+    {
+      nodes.push(&node->Child(i));
+      emptyNodes.push(&emptyNode->Child(i));
+    }
+
+    // The statistics were computed for the new tree.
+    BOOST_REQUIRE_EQUAL(node->Stat().NumDescendants(), node->NumDescendants());
+  }
+  BOOST_REQUIRE_EQUAL(arma::accu(tree->Dataset() != emptyTree->Dataset()), 0);
+  for (size_t i = 0; i < oldFromNew1.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(arma::accu(tree->Dataset().col(i) !=
+        dataset.col(oldFromNew1[i])), 0);
+  }
+
+  // Another leaf size gives another tree.
+  cache.Get<EmptyTree>(dataset, oldFromNew2, 20);
+  BOOST_REQUIRE_EQUAL(cache.Size(), 2);
+
+  // The handles stay valid when the trees are dropped.
+  cache.Erase(dataset);
+  BOOST_REQUIRE_EQUAL(cache.Size(), 0);
+  BOOST_REQUIRE_EQUAL(tree->NumDescendants(), 500);
+}
+
 BOOST_AUTO_TEST_SUITE_END();